@@ -113,6 +113,20 @@ public:
                              const Http::HeaderMap& response_headers,
                              const Http::HeaderMap& response_trailers,
                              const StreamInfo::StreamInfo& stream_info) const PURE;
+
+  /**
+   * Append a formatted access log line to the output, as returned by format(). Unlike format(),
+   * this lets the caller reuse the output buffer across log lines.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the string to append the log line to.
+   */
+  virtual void formatTo(const Http::HeaderMap& request_headers,
+                        const Http::HeaderMap& response_headers,
+                        const Http::HeaderMap& response_trailers,
+                        const StreamInfo::StreamInfo& stream_info, std::string& output) const PURE;
 };
 
 using FormatterPtr = std::unique_ptr<Formatter>;
@@ -137,6 +151,19 @@ public:
                              const Http::HeaderMap& response_headers,
                              const Http::HeaderMap& response_trailers,
                              const StreamInfo::StreamInfo& stream_info) const PURE;
+  /**
+   * Append a value extracted from the provided headers/trailers/stream to the output, as returned
+   * by format(), without building a temporary string where the value allows it.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the string to append the value to.
+   */
+  virtual void formatTo(const Http::HeaderMap& request_headers,
+                        const Http::HeaderMap& response_headers,
+                        const Http::HeaderMap& response_trailers,
+                        const StreamInfo::StreamInfo& stream_info, std::string& output) const PURE;
   /**
    * Extract a value from the provided headers/trailers/stream, preserving the value's type.
    * @param request_headers supplies the request headers.
@@ -51,6 +51,23 @@ public:
    */
   virtual SysCallSizeResult recvmsg(int sockfd, struct msghdr* msg, int flags) PURE;
 
+  /**
+   * @see recvmmsg (man 2 recvmmsg)
+   */
+  virtual SysCallIntResult recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags, struct timespec* timeout) PURE;
+
+  /**
+   * @see sendmmsg (man 2 sendmmsg)
+   */
+  virtual SysCallIntResult sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
+  /**
+   * @return true if the OS supports recvmmsg() and sendmmsg().
+   */
+  virtual bool supportsMmsg() const PURE;
+
   /**
    * Release all resources allocated for fd.
    * @return zero on success, -1 returned otherwise.
@@ -4,6 +4,7 @@
 #error "Linux platform file is part of non-Linux build."
 #endif
 
+#include <linux/bpf.h>
 #include <sched.h>
 
 #include "envoy/api/os_sys_calls_common.h"
@@ -20,6 +21,17 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see sched_setaffinity (man 2 sched_setaffinity)
+   */
+  virtual SysCallIntResult sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                             const cpu_set_t* mask) PURE;
+
+  /**
+   * @see bpf (man 2 bpf)
+   */
+  virtual SysCallIntResult bpf(int cmd, union bpf_attr* attr, unsigned int size) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
@@ -358,6 +358,20 @@ public:
 
 using InstancePtr = std::unique_ptr<Instance>;
 
+/**
+ * The classes of buffer memory charged to the memory budget of a worker.
+ */
+enum class MemoryClass {
+  // The write buffers of the downstream connections.
+  DownstreamConnection,
+  // The write buffers of the upstream connections.
+  UpstreamConnection,
+  // The request bodies buffered by the router for retries and shadowing.
+  UpstreamRequest,
+  // The request and response bodies buffered by the HTTP filters.
+  FilterBody,
+};
+
 /**
  * A factory for creating buffers which call callbacks when reaching high and low watermarks.
  */
@@ -375,6 +389,16 @@ public:
    */
   virtual InstancePtr create(std::function<void()> below_low_watermark,
                              std::function<void()> above_high_watermark) PURE;
+
+  /**
+   * Like create(), but the length of the buffer is also charged to a new memory account on the
+   * budget of the calling worker, if the worker buffer budget is enabled.
+   * @param memory_class supplies the class of the memory of the account.
+   * @return a newly created InstancePtr.
+   */
+  virtual InstancePtr create(std::function<void()> below_low_watermark,
+                             std::function<void()> above_high_watermark,
+                             MemoryClass memory_class) PURE;
 };
 
 using WatermarkFactoryPtr = std::unique_ptr<WatermarkFactory>;
@@ -56,6 +56,18 @@ typedef unsigned int sa_family_t;
 #include <linux/netfilter_ipv4.h>
 #endif
 
+#if defined(__linux__)
+#define ENVOY_MMSG_MORE 1
+#else
+#define ENVOY_MMSG_MORE 0
+// Declared so that the recvmmsg() and sendmmsg() system call wrappers can be declared on all
+// platforms.
+struct mmsghdr {
+  struct msghdr msg_hdr;
+  unsigned int msg_len;
+};
+#endif
+
 #define PACKED_STRUCT(definition, ...) definition, ##__VA_ARGS__ __attribute__((packed))
 
 #ifndef IP6T_SO_ORIGINAL_DST
@@ -30,7 +30,10 @@ namespace Event {
  */
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
-  HISTOGRAM(poll_delay_us, Microseconds)
+  HISTOGRAM(poll_delay_us, Microseconds)                                                           \
+  HISTOGRAM(poll_duration_us, Microseconds)                                                        \
+  HISTOGRAM(post_latency_us, Microseconds)                                                         \
+  HISTOGRAM(post_queue_depth, Unspecified)
 
 /**
  * Struct definition for all dispatcher stats. @see stats_macros.h
@@ -102,13 +105,13 @@ public:
    * dispatcher.
    * @param resolvers supplies the addresses of DNS resolvers that this resolver should use. If left
    * empty, it will not use any specific resolvers, but use defaults (/etc/resolv.conf)
-   * @param use_tcp_for_dns_lookups if set to true, tcp will be used to perform dns lookups.
-   * Otherwise, udp is used.
+   * @param options supplies the options of the resolver, such as whether tcp rather than udp is
+   * used to perform dns lookups.
    * @return Network::DnsResolverSharedPtr that is owned by the caller.
    */
   virtual Network::DnsResolverSharedPtr
   createDnsResolver(const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers,
-                    bool use_tcp_for_dns_lookups) PURE;
+                    const Network::DnsResolverOptions& options) PURE;
 
   /**
    * Creates a file event that will signal when a file is readable or writable. On UNIX systems this
@@ -152,6 +155,15 @@ public:
    */
   virtual Event::TimerPtr createTimer(TimerCb cb) PURE;
 
+  /**
+   * Allocates a coarse timer, run by a timer wheel of the dispatcher with a tick of 1ms. A coarse
+   * timer fires at the first tick boundary at or after it is due, and is cheaper to create, reset
+   * and disable than a timer from createTimer(), which suits the many idle and request timeouts
+   * of connections and streams. @see Timer for docs on how to use the timer.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  virtual Event::TimerPtr createCoarseTimer(TimerCb cb) PURE;
+
   /**
    * Submits an item for deferred delete. @see DeferredDeletable.
    */
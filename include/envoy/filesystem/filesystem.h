@@ -14,7 +14,7 @@
 namespace Envoy {
 namespace Filesystem {
 
-using FlagSet = std::bitset<4>;
+using FlagSet = std::bitset<5>;
 
 /**
  * Abstraction for a basic file on disk.
@@ -28,6 +28,7 @@ public:
     Write,
     Create,
     Append,
+    Truncate,
   };
 
   /**
@@ -102,6 +103,14 @@ public:
    */
   virtual std::string fileReadToEnd(const std::string& path) PURE;
 
+  /**
+   * Rename a file, replacing the file at the new path if there is one.
+   * @param old_path supplies the path of the file.
+   * @param new_path supplies the path to rename it to.
+   * @return bool whether the rename succeeded.
+   */
+  virtual bool renameFile(const std::string& old_path, const std::string& new_path) PURE;
+
   /**
    * Determine if the path is on a list of paths Envoy will refuse to access. This
    * is a basic sanity check for users, blacklisting some clearly bad paths. Paths
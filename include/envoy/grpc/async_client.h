@@ -58,6 +58,12 @@ public:
    * stream object and no further callbacks will be invoked.
    */
   virtual void resetStream() PURE;
+
+  /**
+   * @return true if the messages sent on the stream are backed up above the high watermark of the
+   *         stream, false otherwise. Callers may hold off sending more messages until it drains.
+   */
+  virtual bool isAboveWriteBufferHighWatermark() const PURE;
 };
 
 class RawAsyncRequestCallbacks {
@@ -138,6 +138,12 @@ public:
      * Reset the stream.
      */
     virtual void reset() PURE;
+
+    /***
+     * @return true if the data sent on the stream is backed up above the high watermark of the
+     *         upstream connection, false otherwise.
+     */
+    virtual bool isAboveWriteBufferHighWatermark() const PURE;
   };
 
   virtual ~AsyncClient() = default;
@@ -205,6 +205,12 @@ public:
    */
   virtual uint32_t bufferLimit() PURE;
 
+  /**
+   * @return uint64_t the number of bytes of the stream the codec holds in its own buffers, which is
+   *         0 for codecs which only buffer the data of their streams per connection.
+   */
+  virtual uint64_t bufferedBytes() { return 0; }
+
   /*
    * @return string_view optionally return the reason behind codec level errors.
    *
@@ -263,6 +269,14 @@ struct Http1Settings {
 
   // How header keys should be formatted when serializing HTTP/1.1 headers.
   HeaderKeyFormat header_key_format_{HeaderKeyFormat::Default};
+
+  // Ratio of upstream connections to keep established, relative to the number of active and
+  // pending requests. A ratio of 1 disables prefetching.
+  double prefetch_ratio_{1.0};
+
+  // Maximum number of requests in flight on an upstream connection. A maximum of 1 disables
+  // pipelining.
+  uint32_t max_pipelined_requests_{1};
 };
 
 /**
@@ -284,6 +298,8 @@ struct Http2Settings {
   uint32_t max_inbound_priority_frames_per_stream_{DEFAULT_MAX_INBOUND_PRIORITY_FRAMES_PER_STREAM};
   uint32_t max_inbound_window_update_frames_per_data_frame_sent_{
       DEFAULT_MAX_INBOUND_WINDOW_UPDATE_FRAMES_PER_DATA_FRAME_SENT};
+  uint32_t connections_per_host_{DEFAULT_CONNECTIONS_PER_HOST};
+  uint32_t max_auto_tuned_window_size_{DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE};
 
   // disable HPACK compression
   static const uint32_t MIN_HPACK_TABLE_SIZE = 0;
@@ -323,6 +339,10 @@ struct Http2Settings {
   static const bool DEFAULT_ALLOW_METADATA = false;
   // By default Envoy does not allow invalid headers.
   static const bool DEFAULT_STREAM_ERROR_ON_INVALID_HTTP_MESSAGING = false;
+  // By default the upstream connection pool uses a single connection per host.
+  static const uint32_t DEFAULT_CONNECTIONS_PER_HOST = 1;
+  // By default the flow-control windows aren't auto-tuned.
+  static const uint32_t DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE = 0;
 
   // Default limit on the number of outbound frames of all types.
   static const uint32_t DEFAULT_MAX_OUTBOUND_FRAMES = 10000;
@@ -488,6 +488,13 @@ public:
    * onDestroy() invoked.
    */
   virtual void onDestroy() PURE;
+
+  /**
+   * @return uint64_t the number of bytes of the stream the filter holds in its own buffers. The
+   *         data buffered through the filter callbacks is accounted by the connection manager and
+   *         isn't included.
+   */
+  virtual uint64_t bufferedBytes() const { return 0; }
 };
 
 /**
@@ -779,6 +786,13 @@ public:
    * @param handler supplies the handler to add.
    */
   virtual void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) PURE;
+
+  /**
+   * Name the filters added next, until another name is set. The connection manager uses the name
+   * to time the filters of a sample of the streams.
+   * @param name supplies the name, which must outlive the stream.
+   */
+  virtual void setFilterName(absl::string_view name) PURE;
 };
 
 /**
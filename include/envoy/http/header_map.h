@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -557,6 +558,13 @@ public:
    */
   virtual void removePrefix(const LowerCaseString& prefix) PURE;
 
+  /**
+   * Remove all instances of the headers whose key is one of the supplied keys. The map is
+   * traversed once, rather than once per key as with remove().
+   * @param keys supplies the header keys to remove.
+   */
+  virtual void removeKeys(const std::list<LowerCaseString>& keys) PURE;
+
   /**
    * @return the number of headers in the map.
    */
@@ -91,6 +91,9 @@ public:
     Stats::Counter* bind_errors_;
     // Optional counter. Delayed close timeouts will not be tracked if this is nullptr.
     Stats::Counter* delayed_close_timeouts_;
+    // Optional histogram of the number of socket reads done per read event. Not tracked if this is
+    // nullptr.
+    Stats::Histogram* reads_per_event_;
   };
 
   ~Connection() override = default;
@@ -66,6 +66,7 @@ public:
 };
 
 using ConnectionBalancerPtr = std::unique_ptr<ConnectionBalancer>;
+using ConnectionBalancerSharedPtr = std::shared_ptr<ConnectionBalancer>;
 
 } // namespace Network
 } // namespace Envoy
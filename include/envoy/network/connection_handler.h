@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <list>
 #include <memory>
 
 #include "envoy/network/connection.h"
@@ -38,7 +40,9 @@ public:
   virtual void decNumConnections() PURE;
 
   /**
-   * Adds a listener to the handler.
+   * Adds a listener to the handler. If a TCP listener with the same tag already exists, its
+   * configuration is replaced in place instead: the listen socket and the existing connections are
+   * kept. This is used for in place filter chain updates.
    * @param config listener configuration options.
    */
   virtual void addListener(ListenerConfig& config) PURE;
@@ -50,6 +54,19 @@ public:
    */
   virtual void removeListeners(uint64_t listener_tag) PURE;
 
+  /**
+   * Remove the filter chains and the connections in the listener by listener tag. All connections
+   * owned by the filter chains will be closed. Once all the connections are destroyed, the
+   * completion is invoked.
+   * @param listener_tag supplies the tag passed to addListener().
+   * @param filter_chains supplies the filter chains to be removed.
+   * @param completion supplies the callback invoked on the worker thread once the connections are
+   *        destroyed. It is also invoked if the listener does not exist anymore.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::list<const FilterChain*>& filter_chains,
+                                  std::function<void()> completion) PURE;
+
   /**
    * Stop listeners using the listener tag as a key. This will not close any connections and is used
    * for draining.
@@ -131,6 +148,14 @@ public:
    * @return true if the UDP passing through listener doesn't form stateful connections.
    */
   virtual bool isTransportConnectionless() const PURE;
+
+  /**
+   * @param concurrency supplies the number of workers, each with its own socket in the
+   *        SO_REUSEPORT group of the listener.
+   * @return Socket::OptionsSharedPtr the options steering the datagrams to the sockets of the
+   *         group, or nullptr to leave them to the kernel's hash of the addresses.
+   */
+  virtual Socket::OptionsSharedPtr reusePortSteeringOptions(uint32_t concurrency) const PURE;
 };
 
 using ActiveUdpListenerFactoryPtr = std::unique_ptr<ActiveUdpListenerFactory>;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
@@ -38,6 +39,18 @@ struct DnsResponse {
 
 enum class DnsLookupFamily { V4Only, V6Only, Auto };
 
+/**
+ * Options of a DNS resolver.
+ */
+struct DnsResolverOptions {
+  // Use TCP rather than UDP queries.
+  bool use_tcp_for_dns_lookups_{};
+  // How long failed resolutions are cached for, if not zero.
+  std::chrono::milliseconds negative_cache_ttl_{};
+  // The number of channels the resolutions are spread over.
+  uint32_t channels_{1};
+};
+
 /**
  * An asynchronous DNS resolver.
  */
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "envoy/api/io_error.h"
 #include "envoy/common/platform.h"
 #include "envoy/common/pure.h"
@@ -104,6 +107,53 @@ public:
    */
   virtual Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                           uint32_t self_port, RecvMsgOutput& output) PURE;
+
+  struct RecvMsgPerPacketInfo {
+    // The destination address from transport header.
+    std::shared_ptr<const Address::Instance> local_address_;
+    // The the source address from transport header.
+    std::shared_ptr<const Address::Instance> peer_address_;
+    // The length of the packet's payload.
+    uint64_t msg_len_{0};
+  };
+
+  struct RecvMmsgOutput {
+    /*
+     * @param num_packets is the maximum number of packets to receive.
+     * @param dropped_packets points to a variable to store how many packets are
+     * dropped so far. If nullptr, recvmmsg() won't try to get this information
+     * from transport header.
+     */
+    RecvMmsgOutput(uint64_t num_packets, uint32_t* dropped_packets)
+        : dropped_packets_(dropped_packets), msg_(num_packets) {}
+
+    // If not nullptr, its value is the total number of packets dropped. recvmmsg() will update it
+    // when more packets are dropped.
+    uint32_t* dropped_packets_;
+    // The information of each received packet. Only the first rc_ entries are filled in.
+    std::vector<RecvMsgPerPacketInfo> msg_;
+  };
+
+  /**
+   * Receive multiple messages, each into one of the given slices, and output overflow,
+   * source/destination addresses and lengths of the messages via passed-in parameters upon
+   * success.
+   * @param slices points to one receiving buffer per message.
+   * @param num_packets indicates the number of slices |slices| contains, which is also the
+   * maximum number of messages to receive. |output| must have room for as many messages.
+   * @param self_port the port this handle is assigned to. This is used to populate
+   * local_address because local port can't be retrieved from control message.
+   * @param output modified upon each call to return fields requested in it.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages received for success.
+   */
+  virtual Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                           uint32_t self_port, RecvMmsgOutput& output) PURE;
+
+  /**
+   * @return true if recvmmsg() is supported by this handle.
+   */
+  virtual bool supportsMmsg() const PURE;
 };
 
 using IoHandlePtr = std::unique_ptr<IoHandle>;
@@ -221,6 +221,14 @@ public:
    */
   virtual void onReadReady() PURE;
 
+  /**
+   * Called after each receive system call that returned packets, before onData() is called for
+   * them.
+   *
+   * @param num_packets the number of packets returned by the system call.
+   */
+  virtual void onPacketsRead(uint64_t num_packets) PURE;
+
   /**
    * Called when the underlying socket is ready for write.
    *
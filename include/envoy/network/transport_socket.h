@@ -83,6 +83,12 @@ public:
    * @param event supplies the connection event
    */
   virtual void raiseEvent(ConnectionEvent event) PURE;
+
+  /**
+   * Report the number of reads done on the underlying socket while handling a single read event.
+   * @param num_reads supplies the number of reads.
+   */
+  virtual void recordReadsPerEvent(uint32_t num_reads) PURE;
 };
 
 /**
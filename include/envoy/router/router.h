@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/common/matchers.h"
@@ -108,6 +109,13 @@ public:
    */
   virtual const std::vector<Matchers::StringMatcherPtr>& allowOrigins() const PURE;
 
+  /**
+   * @param origin supplies the origin of a request.
+   * @return bool whether the origin matches any of the access-control-allow-origin matchers, or
+   *         any of them matches "*".
+   */
+  virtual bool allowsOrigin(absl::string_view origin) const PURE;
+
   /**
    * @return std::string access-control-allow-methods value.
    */
@@ -451,6 +459,42 @@ public:
   virtual uint32_t retryShadowBufferLimit() const PURE;
 };
 
+/**
+ * Hedging of the upstream requests which are slower than the per try latencies observed for a
+ * route. It is shared by all the worker threads, so implementations must be thread safe.
+ */
+class LatencyHedgePolicy {
+public:
+  virtual ~LatencyHedgePolicy() = default;
+
+  /**
+   * @return the time after which an outstanding upstream request should be hedged, or nullopt if
+   *         not enough per try latencies have been observed yet.
+   */
+  virtual absl::optional<std::chrono::milliseconds> hedgeDelay() const PURE;
+
+  /**
+   * Record the latency of an upstream request, up to its response headers.
+   * @param latency supplies the latency of the upstream request.
+   */
+  virtual void recordLatency(std::chrono::milliseconds latency) const PURE;
+
+  /**
+   * Count a downstream request routed with this policy against the hedge budget.
+   */
+  virtual void onRequest() const PURE;
+
+  /**
+   * @return true if the hedge budget allows one more hedged request, false otherwise.
+   */
+  virtual bool canHedge() const PURE;
+
+  /**
+   * Charge a hedged request to the hedge budget, once it is sent.
+   */
+  virtual void onHedge() const PURE;
+};
+
 /**
  * Route level hedging policy.
  */
@@ -475,6 +519,37 @@ public:
    * will be canceled immediately.
    */
   virtual bool hedgeOnPerTryTimeout() const PURE;
+
+  /**
+   * @return const LatencyHedgePolicy* the latency based hedging of the route, or nullptr if
+   *         requests are not hedged on latency.
+   */
+  virtual const LatencyHedgePolicy* latencyHedgePolicy() const PURE;
+};
+
+/**
+ * Route level policy for collapsing identical in-flight requests into a single upstream request.
+ */
+class RequestCollapsingPolicy {
+public:
+  virtual ~RequestCollapsingPolicy() = default;
+
+  /**
+   * @return the request headers which, in addition to the method, authority and path, tell
+   *         whether two requests are identical.
+   */
+  virtual const std::vector<Http::LowerCaseString>& headers() const PURE;
+
+  /**
+   * @return true if requests are collapsed across all the worker threads, false if they are only
+   *         collapsed with the requests of the same worker thread.
+   */
+  virtual bool perProcess() const PURE;
+
+  /**
+   * @return the maximum size of a response shared with the collapsed requests, in bytes.
+   */
+  virtual uint64_t maxResponseBytes() const PURE;
 };
 
 class MetadataMatchCriterion {
@@ -726,6 +801,12 @@ public:
    */
   virtual const TlsContextMatchCriteria* tlsContextMatchCriteria() const PURE;
 
+  /**
+   * @return const RequestCollapsingPolicy* the request collapsing policy for this route. If
+   * requests are not collapsed, nullptr is returned.
+   */
+  virtual const RequestCollapsingPolicy* requestCollapsingPolicy() const PURE;
+
   /**
    * @return const PathMatchCriterion& the match criterion for this route.
    */
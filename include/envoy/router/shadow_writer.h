@@ -4,15 +4,48 @@
 #include <memory>
 #include <string>
 
+#include "envoy/buffer/buffer.h"
+#include "envoy/http/header_map.h"
 #include "envoy/http/message.h"
 
 namespace Envoy {
 namespace Router {
 
 /**
- * Interface used to shadow complete requests to an alternate upstream cluster in a "fire and
- * forget" fashion. Right now this interface takes a fully buffered request and cannot be used for
- * streaming. This is sufficient for current use cases.
+ * A request shadowed while it is streamed to the primary upstream.
+ */
+class ShadowStream {
+public:
+  virtual ~ShadowStream() = default;
+
+  /**
+   * Send request body data to the shadow.
+   * @param data supplies the data to send, which is drained.
+   * @param end_stream supplies whether this is the last data of the request.
+   * @return bool whether the shadow is still going on. A shadow is abandoned when its upstream
+   *         request is reset, or when it would exceed the budget of the streamed shadows. Sending
+   *         on an abandoned shadow does nothing.
+   */
+  virtual bool sendData(Buffer::Instance& data, bool end_stream) PURE;
+
+  /**
+   * Send the request trailers to the shadow, ending the request.
+   * @param trailers supplies the trailers to send, which are copied.
+   * @return bool whether the shadow is still going on.
+   */
+  virtual bool sendTrailers(const Http::HeaderMap& trailers) PURE;
+
+  /**
+   * Hand the shadow over to the shadow writer once the primary request is done with it. A shadow
+   * whose request was sent in full runs until its response is received, and is reset otherwise.
+   * The stream must not be used afterwards.
+   */
+  virtual void release() PURE;
+};
+
+/**
+ * Interface used to shadow requests to an alternate upstream cluster in a "fire and forget"
+ * fashion, either once they are fully buffered or while they are streamed.
  */
 class ShadowWriter {
 public:
@@ -26,6 +59,17 @@ public:
    */
   virtual void shadow(const std::string& cluster, Http::MessagePtr&& request,
                       std::chrono::milliseconds timeout) PURE;
+
+  /**
+   * Start shadowing a request whose body and trailers are sent as they are received.
+   * @param cluster supplies the cluster name to shadow to.
+   * @param headers supplies the request headers.
+   * @param timeout supplies the shadowed request timeout.
+   * @return ShadowStream* the stream to send the rest of the request on, which must be released
+   *         once done, or nullptr if the request cannot be shadowed.
+   */
+  virtual ShadowStream* streamingShadow(const std::string& cluster, Http::HeaderMapPtr&& headers,
+                                        std::chrono::milliseconds timeout) PURE;
 };
 
 using ShadowWriterPtr = std::unique_ptr<ShadowWriter>;
@@ -14,6 +14,7 @@
 #include "common/singleton/threadsafe_singleton.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -65,6 +66,38 @@ public:
 
 using RandomGeneratorPtr = std::unique_ptr<RandomGenerator>;
 
+/**
+ * A handle of a runtime key, for lookups which don't hash the key on the hot path. Keys are
+ * registered process wide when constructed, typically at namespace scope so that they are
+ * registered before the first snapshot is built, and each name is given a stable index. Snapshots
+ * resolve the keys registered before they were built into a dense array, so that looking up such a
+ * key is an indexed load; keys registered later are looked up by name. The registry lives in
+ * //source/common/runtime:runtime_key_lib, which users of Key depend on.
+ */
+class Key {
+public:
+  explicit Key(absl::string_view name);
+
+  /**
+   * @return const std::string& the name of the key.
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * @return uint32_t the index of the key, shared by all the keys of the same name.
+   */
+  uint32_t index() const { return index_; }
+
+  /**
+   * @return std::vector<std::string> the names of the registered keys, by index.
+   */
+  static std::vector<std::string> registeredNames();
+
+private:
+  const std::string name_;
+  const uint32_t index_;
+};
+
 /**
  * A snapshot of runtime data.
  */
@@ -101,7 +134,8 @@ public:
     virtual const std::string& name() const PURE;
   };
 
-  using OverrideLayerConstPtr = std::unique_ptr<const OverrideLayer>;
+  // Layers are shared by the snapshots built while they are unchanged.
+  using OverrideLayerConstSharedPtr = std::shared_ptr<const OverrideLayer>;
 
   /**
    * Returns true if a deprecated feature is allowed.
@@ -137,6 +171,17 @@ public:
    */
   virtual bool featureEnabled(const std::string& key, uint64_t default_value) const PURE;
 
+  /**
+   * Same as featureEnabled(const std::string&, uint64_t), for a registered key.
+   * @param key supplies the feature key to lookup.
+   * @param default_value supplies the default value that will be used if either the feature key
+   *        does not exist or it is not an integer.
+   * @return true if the feature is enabled.
+   */
+  virtual bool featureEnabled(const Key& key, uint64_t default_value) const {
+    return featureEnabled(key.name(), default_value);
+  }
+
   /**
    * Test if a feature is enabled using a supplied stable random value. This variant is used if
    * the caller wants a stable result over multiple calls.
@@ -230,6 +275,17 @@ public:
    */
   virtual uint64_t getInteger(const std::string& key, uint64_t default_value) const PURE;
 
+  /**
+   * Same as getInteger(const std::string&, uint64_t), for a registered key.
+   * @param key supplies the key to fetch.
+   * @param default_value supplies the value to return if the key does not exist or it does not
+   *        contain an integer.
+   * @return uint64_t the runtime value or the default value.
+   */
+  virtual uint64_t getInteger(const Key& key, uint64_t default_value) const {
+    return getInteger(key.name(), default_value);
+  }
+
   /**
    * Fetch a double runtime key.
    * @param key supplies the key to fetch.
@@ -253,9 +309,16 @@ public:
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
    * Any layer can add a key in addition to overriding keys in layers below. The layer vector is
    * safe only for the lifetime of the Snapshot.
-   * @return const std::vector<OverrideLayerConstPtr>& the raw map of loaded values.
+   * @return const std::vector<OverrideLayerConstSharedPtr>& the raw map of loaded values.
+   */
+  virtual const std::vector<OverrideLayerConstSharedPtr>& getLayers() const PURE;
+
+  /**
+   * @return uint64_t an identifier of the snapshot, unique in the process and increasing with each
+   *         snapshot built, so that values derived from a snapshot can be cached until it changes.
+   *         0 if the snapshot has no identifier, in which case such values must not be cached.
    */
-  virtual const std::vector<OverrideLayerConstPtr>& getLayers() const PURE;
+  virtual uint64_t generation() const { return 0; }
 };
 
 /**
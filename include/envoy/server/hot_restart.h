@@ -5,10 +5,14 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/network/address.h"
+#include "envoy/network/listener.h"
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/store.h"
 #include "envoy/thread/thread.h"
 
+#include "common/singleton/threadsafe_singleton.h"
+
 #include "source/server/hot_restart.pb.h"
 
 namespace Envoy {
@@ -96,5 +100,68 @@ public:
   virtual Thread::BasicLockable& accessLogLock() PURE;
 };
 
+/**
+ * Forwarding of UDP packets between the processes of a hot restart. While the parent drains, its
+ * connectionless listeners, such as QUIC ones, still own connections whose packets the kernel may
+ * deliver to the child, which shares the listen sockets. The child hands the packets it does not
+ * know what to do with to the parent, which delivers them to its listener of the same address.
+ */
+class HotRestartUdpForwarding {
+public:
+  /**
+   * A listener of the parent that packets forwarded by the child are delivered to.
+   */
+  class Listener {
+  public:
+    virtual ~Listener() = default;
+
+    /**
+     * Called on the thread of the dispatcher the listener was added with.
+     * @param data supplies a packet forwarded by the child.
+     */
+    virtual void onForwardedPacket(Network::UdpRecvData& data) PURE;
+  };
+
+  virtual ~HotRestartUdpForwarding() = default;
+
+  /**
+   * @return whether there is a parent to forward packets to. May be called from any thread.
+   */
+  virtual bool forwardingToParent() const PURE;
+
+  /**
+   * Forward a packet to the parent, which delivers it to its listener of the same listen address.
+   * Does nothing if there is no parent to forward to. May be called from any thread.
+   * @param listen_address supplies the address of the listener that received the packet.
+   * @param data supplies the packet.
+   */
+  virtual void forwardToParent(const Network::Address::Instance& listen_address,
+                               const Network::UdpRecvData& data) PURE;
+
+  /**
+   * Add a listener that the packets forwarded by a child to the given listen address are
+   * delivered to. May be called from any thread.
+   * @param listen_address supplies the listen address of the listener.
+   * @param dispatcher supplies the dispatcher of the thread the listener runs on.
+   * @param listener supplies the listener, which must be removed before it is destroyed.
+   * @return uint64_t an id to remove the listener with.
+   */
+  virtual uint64_t addListener(const Network::Address::Instance& listen_address,
+                               Event::Dispatcher& dispatcher, Listener& listener) PURE;
+
+  /**
+   * Remove a listener. Must be called from the thread of its dispatcher, after which no packet is
+   * delivered to it.
+   * @param id supplies the id returned by addListener().
+   */
+  virtual void removeListener(uint64_t id) PURE;
+};
+
+/**
+ * The UDP forwarding of the hot restart of the process, if any. Listeners are not created by the
+ * server itself, so they reach it through this singleton rather than through the server.
+ */
+using HotRestartUdpForwardingSingleton = InjectableSingleton<HotRestartUdpForwarding>;
+
 } // namespace Server
 } // namespace Envoy
@@ -174,6 +174,12 @@ public:
    */
   virtual bool hotRestartDisabled() const PURE;
 
+  /**
+   * @return bool indicating whether the stats of the hot restart parent are received in a shared
+   *         memory region rather than over the hot restart domain socket.
+   */
+  virtual bool hotRestartSharedStats() const PURE;
+
   /**
    * @return bool indicating whether system signal listeners are enabled.
    */
@@ -194,6 +200,12 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return bool indicating whether each worker thread is pinned to a CPU of the process affinity
+   *         mask.
+   */
+  virtual bool workerCpuAffinityEnabled() const PURE;
+
   /**
    * @return the names of extensions to disable.
    */
@@ -12,19 +12,53 @@
 namespace Envoy {
 namespace Server {
 
-enum class OverloadActionState {
+/**
+ * The state of an overload action, scaled between 0, when none of its triggers fire, and 1, when
+ * it is saturated. Binary triggers only ever move an action between these two. Scaled triggers also
+ * move it in between, so that the action can shed load gradually, in proportion to the pressure on
+ * the resources, rather than all at once.
+ */
+class OverloadActionState {
+public:
+  /**
+   * @return the state of an action none of whose triggers fire.
+   */
+  static constexpr OverloadActionState inactive() { return OverloadActionState(0); }
+
+  /**
+   * @return the state of an action which is fully in effect.
+   */
+  static constexpr OverloadActionState saturated() { return OverloadActionState(1); }
+
   /**
-   * Indicates that an overload action is active because at least one of its triggers has fired.
+   * @param value supplies the scale of the action, clamped to [0, 1].
    */
-  Active,
+  explicit constexpr OverloadActionState(double value)
+      : value_(value < 0 ? 0 : (value > 1 ? 1 : value)) {}
+
   /**
-   * Indicates that an overload action is inactive because none of its triggers have fired.
+   * @return double the scale of the action, in [0, 1].
    */
-  Inactive
+  constexpr double value() const { return value_; }
+
+  /**
+   * @return bool whether the action is fully in effect. Actions which can't be scaled only take
+   *         effect once saturated.
+   */
+  constexpr bool isSaturated() const { return value_ == 1; }
+
+  constexpr bool operator==(const OverloadActionState& other) const {
+    return value_ == other.value_;
+  }
+  constexpr bool operator!=(const OverloadActionState& other) const { return !(*this == other); }
+
+private:
+  double value_;
 };
 
 /**
- * Callback invoked when an overload action changes state.
+ * Callback invoked when an overload action changes state, including when a scaled action changes
+ * scale.
  */
 using OverloadActionCb = std::function<void(OverloadActionState)>;
 
@@ -36,7 +70,7 @@ public:
   const OverloadActionState& getState(const std::string& action) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      it = actions_.insert(std::make_pair(action, OverloadActionState::Inactive)).first;
+      it = actions_.insert(std::make_pair(action, OverloadActionState::inactive())).first;
     }
     return it->second;
   }
@@ -44,7 +78,7 @@ public:
   void setState(const std::string& action, OverloadActionState state) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      actions_[action] = state;
+      actions_.insert(std::make_pair(action, state));
     } else {
       it->second = state;
     }
@@ -59,7 +93,8 @@ private:
  */
 class OverloadActionNameValues {
 public:
-  // Overload action to stop accepting new HTTP requests.
+  // Overload action to stop accepting new HTTP requests. While scaled, the fraction of the new
+  // requests it rejects is the scale of the action.
   const std::string StopAcceptingRequests = "envoy.overload_actions.stop_accepting_requests";
 
   // Overload action to disable http keepalive (for HTTP1.x).
@@ -70,6 +105,10 @@ public:
 
   // Overload action to try to shrink the heap by releasing free memory.
   const std::string ShrinkHeap = "envoy.overload_actions.shrink_heap";
+
+  // Overload action to reset the HTTP streams holding the most buffered memory. While scaled, the
+  // streams reset hold about the scale of the action as a fraction of the buffered memory.
+  const std::string ResetHighMemoryStreams = "envoy.overload_actions.reset_high_memory_streams";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
@@ -115,7 +154,7 @@ public:
    * is disabled).
    */
   static const OverloadActionState& getInactiveState() {
-    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::Inactive);
+    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::inactive());
   }
 };
 
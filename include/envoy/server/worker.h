@@ -1,7 +1,9 @@
 #pragma once
 
 #include <functional>
+#include <list>
 
+#include "envoy/network/filter.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload_manager.h"
 
@@ -65,6 +67,19 @@ public:
   virtual void removeListener(Network::ListenerConfig& listener,
                               std::function<void()> completion) PURE;
 
+  /**
+   * Remove the stale filter chains of the active listener from the worker, closing their
+   * connections. This is used for in place filter chain updates.
+   * @param listener_tag supplies the tag of the active listener owning the filter chains.
+   * @param filter_chains supplies the filter chains to remove.
+   * @param completion supplies the completion to be called when the connections of the filter
+   *        chains have been closed. This completion is called on the worker thread. No locking is
+   *        performed by the worker.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::list<const Network::FilterChain*>& filter_chains,
+                                  std::function<void()> completion) PURE;
+
   /**
    * Stop a listener from accepting new connections. This is used for server draining.
    * @param listener supplies the listener to stop.
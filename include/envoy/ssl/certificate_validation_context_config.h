@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -7,6 +9,8 @@
 #include "envoy/common/pure.h"
 #include "envoy/type/matcher/v3alpha/string.pb.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Ssl {
 
@@ -61,6 +65,17 @@ public:
    * @return whether to ignore expired certificates (both too new and too old).
    */
   virtual bool allowExpiredCertificate() const PURE;
+
+  /**
+   * @return how long the successful verifications of peer certificate chains are cached, or
+   *         absl::nullopt if they aren't cached.
+   */
+  virtual absl::optional<std::chrono::milliseconds> verificationCacheTtl() const PURE;
+
+  /**
+   * @return the maximum number of peer certificate chains whose verification is cached.
+   */
+  virtual uint32_t verificationCacheMaxEntries() const PURE;
 };
 
 using CertificateValidationContextConfigPtr = std::unique_ptr<CertificateValidationContextConfig>;
@@ -57,6 +57,13 @@ public:
    * @param value the value of the sample.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return whether flush() may be called on the stats flush thread rather than on the main thread.
+   * The stats flush thread is registered for thread local updates like the workers, so the sinks
+   * supporting it may use thread local state, but not objects owned by the main thread.
+   */
+  virtual bool flushOffMainThread() const { return false; }
 };
 
 using SinkPtr = std::unique_ptr<Sink>;
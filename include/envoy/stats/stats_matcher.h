@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/stats/symbol_table.h"
 
 namespace Envoy {
 namespace Stats {
@@ -20,6 +21,16 @@ public:
    */
   virtual bool rejects(const std::string& name) const PURE;
 
+  /**
+   * Take a metric name in StatName form and report whether or not it should be
+   * instantiated. Implementations may test some patterns against the tokens of
+   * the name, avoiding its elaboration into a string.
+   * @param name the name of a Stats::Metric.
+   * @param symbol_table the symbol table the name is encoded with.
+   * @return bool true if that stat should not be instantiated.
+   */
+  virtual bool rejects(StatName name, const SymbolTable& symbol_table) const PURE;
+
   /**
    * Helps determine whether the matcher needs to be called. This can be used
    * to short-circuit elaboration of stats names.
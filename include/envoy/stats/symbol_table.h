@@ -90,6 +90,17 @@ public:
    */
   virtual bool lessThan(const StatName& a, const StatName& b) const PURE;
 
+  /**
+   * Determines whether the tokens of a StatName start with all the tokens of
+   * another. For example, "a.b.c" starts with "a.b", but not with "a.bc" nor
+   * "a.b.c.d". Neither name is decoded, and the SymbolTable lock is not taken.
+   *
+   * @param name the stat name.
+   * @param prefix the tokens name is tested against.
+   * @return bool true if the tokens of name start with those of prefix.
+   */
+  virtual bool startsWith(const StatName& name, const StatName& prefix) const PURE;
+
   /**
    * Joins two or more StatNames. For example if we have StatNames for {"a.b",
    * "c.d", "e.f"} then the joined stat-name matches "a.b.c.d.e.f". The
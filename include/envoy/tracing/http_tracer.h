@@ -158,6 +158,12 @@ public:
    * @param sampled whether the span and any subsequent child spans should be sampled
    */
   virtual void setSampled(bool sampled) PURE;
+
+  /**
+   * @return whether the span is recorded and reported to the tracing system. Tags and logs set on
+   *         a span that is not recorded are discarded, so callers may skip building them.
+   */
+  virtual bool isRecording() const PURE;
 };
 
 /**
@@ -63,6 +63,12 @@ public:
    */
   virtual Event::Dispatcher& dispatcher() PURE;
 
+  /**
+   * @return Event::Dispatcher* the dispatcher of the dedicated health check thread, or nullptr if
+   *         health checks run on the main thread.
+   */
+  virtual Event::Dispatcher* healthCheckDispatcher() PURE;
+
   /**
    * @return Network::DnsResolverSharedPtr the dns resolver for the server.
    */
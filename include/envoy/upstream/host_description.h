@@ -1,9 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/config/core/v3alpha/base.pb.h"
 #include "envoy/network/address.h"
 #include "envoy/network/transport_socket.h"
@@ -53,6 +55,30 @@ struct HostStats {
 
 class ClusterInfo;
 
+/**
+ * Peak EWMA of the latencies of the requests to an upstream host, used by latency aware load
+ * balancing. A latency above the average replaces it, otherwise the latencies are averaged with a
+ * weight which decays over time. It is updated and read by all the worker threads, so
+ * implementations must be thread safe.
+ */
+class HostLatency {
+public:
+  virtual ~HostLatency() = default;
+
+  /**
+   * Record the latency of a request to the host.
+   * @param latency supplies the latency of the request.
+   * @param now supplies the current time.
+   */
+  virtual void recordLatency(std::chrono::microseconds latency, MonotonicTime now) PURE;
+
+  /**
+   * @param now supplies the current time.
+   * @return the peak EWMA of the latencies, in microseconds, decayed up to now.
+   */
+  virtual double peakEwma(MonotonicTime now) const PURE;
+};
+
 /**
  * A description of an upstream host.
  */
@@ -71,9 +97,10 @@ public:
   virtual void canary(bool is_canary) PURE;
 
   /**
-   * @return the metadata associated with this host
+   * @return the metadata associated with this host, which may be shared with other hosts.
    */
-  virtual const std::shared_ptr<envoy::config::core::v3alpha::Metadata> metadata() const PURE;
+  virtual const std::shared_ptr<const envoy::config::core::v3alpha::Metadata>
+  metadata() const PURE;
 
   /**
    * Set the current metadata.
@@ -116,6 +143,11 @@ public:
    */
   virtual HostStats& stats() const PURE;
 
+  /**
+   * @return the latency of the requests to the host.
+   */
+  virtual HostLatency& latency() const PURE;
+
   /**
    * @return the locality of the host (deployment specific). This will be the default instance if
    *         unknown.
@@ -33,6 +33,13 @@ public:
    */
   virtual void inc() PURE;
 
+  /**
+   * Increment the resource count if the resource can be created. Unlike canCreate() followed by
+   * inc(), the check and the increment are atomic with respect to the other threads.
+   * @return true if the resource count was incremented.
+   */
+  virtual bool tryInc() PURE;
+
   /**
    * Decrement the resource count.
    */
@@ -557,6 +557,7 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_prefetch_total)                                                              \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -569,11 +570,16 @@ public:
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_latency_hedge)                                                               \
+  COUNTER(upstream_rq_latency_hedge_budget_exceeded)                                               \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(upstream_rq_pending_failure_eject)                                                       \
   COUNTER(upstream_rq_pending_overflow)                                                            \
   COUNTER(upstream_rq_pending_total)                                                               \
   COUNTER(upstream_rq_per_try_timeout)                                                             \
+  COUNTER(upstream_rq_pipelined)                                                                   \
+  COUNTER(upstream_rq_prefetch_hit)                                                                \
+  COUNTER(upstream_rq_prefetch_miss)                                                               \
   COUNTER(upstream_rq_retry)                                                                       \
   COUNTER(upstream_rq_retry_overflow)                                                              \
   COUNTER(upstream_rq_retry_success)                                                               \
@@ -765,6 +771,12 @@ public:
   virtual const absl::optional<envoy::config::cluster::v3alpha::Cluster::LeastRequestLbConfig>&
   lbLeastRequestConfig() const PURE;
 
+  /**
+   * @return configuration for peak EWMA load balancing, only used if LB type is peak EWMA.
+   */
+  virtual const absl::optional<envoy::config::cluster::v3alpha::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const PURE;
+
   /**
    * @return configuration for ring hash load balancing, only used if type is set to ring_hash_lb.
    */
@@ -794,6 +806,12 @@ public:
    */
   virtual uint64_t maxRequestsPerConnection() const PURE;
 
+  /**
+   * @return uint32_t the number of connected idle connections the TCP connection pool of each host
+   *         keeps ready ahead of demand. 0 disables prefetching.
+   */
+  virtual uint32_t tcpPrefetchConnections() const PURE;
+
   /**
    * @return uint32_t the maximum number of response headers. The default value is 100. Results in a
    * reset if the number of headers exceeds this value.
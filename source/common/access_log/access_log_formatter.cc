@@ -39,6 +39,12 @@ void truncate(std::string& str, absl::optional<uint32_t> max_length) {
   str = str.substr(0, max_length.value());
 }
 
+// Appends a number without a temporary string.
+void appendInt(uint64_t value, std::string& output) {
+  const fmt::format_int formatted(value);
+  output.append(formatted.data(), formatted.size());
+}
+
 // Matches newline pattern in a StartTimeFormatter format string.
 const std::regex& getStartTimeNewlinePattern() {
   CONSTRUCT_ON_FIRST_USE(std::regex, "%[-_0^#]*[1-9]*n");
@@ -76,12 +82,17 @@ std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info) const {
   std::string log_line;
   log_line.reserve(256);
+  formatTo(request_headers, response_headers, response_trailers, stream_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::formatTo(const Http::HeaderMap& request_headers,
+                             const Http::HeaderMap& response_headers,
+                             const Http::HeaderMap& response_trailers,
+                             const StreamInfo::StreamInfo& stream_info, std::string& output) const {
   for (const FormatterProviderPtr& provider : providers_) {
-    log_line += provider->format(request_headers, response_headers, response_trailers, stream_info);
+    provider->formatTo(request_headers, response_headers, response_trailers, stream_info, output);
   }
-
-  return log_line;
 }
 
 JsonFormatterImpl::JsonFormatterImpl(std::unordered_map<std::string, std::string>& format_mapping,
@@ -103,6 +114,14 @@ std::string JsonFormatterImpl::format(const Http::HeaderMap& request_headers,
   return absl::StrCat(log_line, "\n");
 }
 
+void JsonFormatterImpl::formatTo(const Http::HeaderMap& request_headers,
+                                 const Http::HeaderMap& response_headers,
+                                 const Http::HeaderMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+  output += format(request_headers, response_headers, response_trailers, stream_info);
+}
+
 ProtobufWkt::Struct JsonFormatterImpl::toStruct(const Http::HeaderMap& request_headers,
                                                 const Http::HeaderMap& response_headers,
                                                 const Http::HeaderMap& response_trailers,
@@ -126,7 +145,7 @@ ProtobufWkt::Struct JsonFormatterImpl::toStruct(const Http::HeaderMap& request_h
       // Multiple providers forces string output.
       std::string str;
       for (const auto& provider : providers) {
-        str += provider->format(request_headers, response_headers, response_trailers, stream_info);
+        provider->formatTo(request_headers, response_headers, response_trailers, stream_info, str);
       }
       (*fields)[pair.first] = ValueUtil::stringValue(str);
     }
@@ -369,6 +388,15 @@ public:
 
     return fmt::format_int(millis.value()).str();
   }
+  void extractTo(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    const auto millis = extractMillis(stream_info);
+    if (!millis) {
+      output += UnspecifiedValueString;
+      return;
+    }
+
+    appendInt(millis.value(), output);
+  }
   ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo& stream_info) const override {
     const auto millis = extractMillis(stream_info);
     if (!millis) {
@@ -401,6 +429,9 @@ public:
   std::string extract(const StreamInfo::StreamInfo& stream_info) const override {
     return fmt::format_int(field_extractor_(stream_info)).str();
   }
+  void extractTo(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    appendInt(field_extractor_(stream_info), output);
+  }
   ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo& stream_info) const override {
     return ValueUtil::numberValue(field_extractor_(stream_info));
   }
@@ -707,6 +738,13 @@ std::string StreamInfoFormatter::format(const Http::HeaderMap&, const Http::Head
   return field_extractor_->extract(stream_info);
 }
 
+void StreamInfoFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                   const Http::HeaderMap&,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   std::string& output) const {
+  field_extractor_->extractTo(stream_info, output);
+}
+
 ProtobufWkt::Value
 StreamInfoFormatter::formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
@@ -722,6 +760,12 @@ std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::Hea
   return str_.string_value();
 }
 
+void PlainStringFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                    const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                                    std::string& output) const {
+  output += str_.string_value();
+}
+
 ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                                      const Http::HeaderMap&,
                                                      const StreamInfo::StreamInfo&) const {
@@ -754,6 +798,20 @@ std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
   return val;
 }
 
+void HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    output += UnspecifiedValueString;
+    return;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+}
+
 ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers) const {
   const Http::HeaderEntry* header = findHeader(headers);
   if (!header) {
@@ -777,6 +835,13 @@ std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
   return HeaderFormatter::format(response_headers);
 }
 
+void ResponseHeaderFormatter::formatTo(const Http::HeaderMap&,
+                                       const Http::HeaderMap& response_headers,
+                                       const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                                       std::string& output) const {
+  HeaderFormatter::formatTo(response_headers, output);
+}
+
 ProtobufWkt::Value ResponseHeaderFormatter::formatValue(const Http::HeaderMap&,
                                                         const Http::HeaderMap& response_headers,
                                                         const Http::HeaderMap&,
@@ -795,6 +860,12 @@ std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_header
   return HeaderFormatter::format(request_headers);
 }
 
+void RequestHeaderFormatter::formatTo(const Http::HeaderMap& request_headers,
+                                      const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(request_headers, output);
+}
+
 ProtobufWkt::Value RequestHeaderFormatter::formatValue(const Http::HeaderMap& request_headers,
                                                        const Http::HeaderMap&,
                                                        const Http::HeaderMap&,
@@ -813,6 +884,12 @@ std::string ResponseTrailerFormatter::format(const Http::HeaderMap&, const Http:
   return HeaderFormatter::format(response_trailers);
 }
 
+void ResponseTrailerFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                        const Http::HeaderMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(response_trailers, output);
+}
+
 ProtobufWkt::Value ResponseTrailerFormatter::formatValue(const Http::HeaderMap&,
                                                          const Http::HeaderMap&,
                                                          const Http::HeaderMap& response_trailers,
@@ -870,6 +947,13 @@ std::string DynamicMetadataFormatter::format(const Http::HeaderMap&, const Http:
   return MetadataFormatter::formatMetadata(stream_info.dynamicMetadata());
 }
 
+void DynamicMetadataFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                        const Http::HeaderMap&,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        std::string& output) const {
+  output += MetadataFormatter::formatMetadata(stream_info.dynamicMetadata());
+}
+
 ProtobufWkt::Value
 DynamicMetadataFormatter::formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                       const Http::HeaderMap&,
@@ -912,6 +996,14 @@ std::string FilterStateFormatter::format(const Http::HeaderMap&, const Http::Hea
   return value;
 }
 
+void FilterStateFormatter::formatTo(const Http::HeaderMap& request_headers,
+                                    const Http::HeaderMap& response_headers,
+                                    const Http::HeaderMap& response_trailers,
+                                    const StreamInfo::StreamInfo& stream_info,
+                                    std::string& output) const {
+  output += format(request_headers, response_headers, response_trailers, stream_info);
+}
+
 ProtobufWkt::Value
 FilterStateFormatter::formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                   const Http::HeaderMap&,
@@ -942,6 +1034,17 @@ std::string StartTimeFormatter::format(const Http::HeaderMap&, const Http::Heade
   }
 }
 
+void StartTimeFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                  const Http::HeaderMap&, const StreamInfo::StreamInfo& stream_info,
+                                  std::string& output) const {
+  if (date_formatter_.formatString().empty()) {
+    // The formatted seconds are cached per thread, only the milliseconds are written per line.
+    AccessLogDateTimeFormatter::appendTime(stream_info.startTime(), output);
+  } else {
+    output += date_formatter_.fromTime(stream_info.startTime());
+  }
+}
+
 ProtobufWkt::Value StartTimeFormatter::formatValue(
     const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
     const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info) const {
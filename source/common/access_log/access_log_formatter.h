@@ -93,6 +93,9 @@ public:
                      const Http::HeaderMap& response_headers,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
 
 private:
   std::vector<FormatterProviderPtr> providers_;
@@ -108,6 +111,9 @@ public:
                      const Http::HeaderMap& response_headers,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
 
 private:
   const bool preserve_types_;
@@ -130,6 +136,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -148,6 +157,7 @@ public:
 
 protected:
   std::string format(const Http::HeaderMap& headers) const;
+  void formatTo(const Http::HeaderMap& headers, std::string& output) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
 
 private:
@@ -169,6 +179,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
                      const Http::HeaderMap&, const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -185,6 +198,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
                      const Http::HeaderMap&, const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -202,6 +218,9 @@ public:
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -217,6 +236,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -226,6 +248,10 @@ public:
     virtual ~FieldExtractor() = default;
 
     virtual std::string extract(const StreamInfo::StreamInfo&) const PURE;
+    // Appends the value returned by extract() to the output.
+    virtual void extractTo(const StreamInfo::StreamInfo& stream_info, std::string& output) const {
+      output += extract(stream_info);
+    }
     virtual ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo&) const PURE;
   };
   using FieldExtractorPtr = std::unique_ptr<FieldExtractor>;
@@ -264,6 +290,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -279,6 +308,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -300,6 +332,9 @@ public:
   // FormatterProvider
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::HeaderMap&, const Http::HeaderMap&,
                                  const Http::HeaderMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -7,9 +7,15 @@
 #include "common/common/lock_guard.h"
 #include "common/common/stack_array.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace AccessLog {
 
+namespace {
+std::atomic<uint64_t> next_file_id{};
+} // namespace
+
 void AccessLogManagerImpl::reopen() {
   for (auto& access_log : access_logs_) {
     access_log.second->reopen();
@@ -42,7 +48,7 @@ AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatch
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
                                      Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
+    : id_(next_file_id++), file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
         flush_event_.notifyOne();
@@ -83,8 +89,9 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    collectThreadBuffers();
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
 
     const Api::IoCallBoolResult result = file_->close();
@@ -124,6 +131,30 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
+AccessLogFileImpl::ThreadBuffer& AccessLogFileImpl::threadBuffer() {
+  // The buffers of the thread by file. The buffer of a destroyed file lingers until the thread
+  // exits, which is cheap as files are rarely destroyed.
+  static thread_local absl::flat_hash_map<uint64_t, ThreadBufferSharedPtr> buffers;
+
+  ThreadBufferSharedPtr& buffer = buffers[id_];
+  if (buffer == nullptr) {
+    buffer = std::make_shared<ThreadBuffer>();
+    Thread::LockGuard lock(thread_buffers_lock_);
+    thread_buffers_.push_back(buffer);
+  }
+  return *buffer;
+}
+
+void AccessLogFileImpl::collectThreadBuffers() {
+  Thread::LockGuard lock(thread_buffers_lock_);
+  for (const ThreadBufferSharedPtr& thread_buffer : thread_buffers_) {
+    Thread::LockGuard buffer_lock(thread_buffer->lock_);
+    ASSERT(buffered_bytes_ >= thread_buffer->buffer_.length());
+    buffered_bytes_ -= thread_buffer->buffer_.length();
+    about_to_write_buffer_.move(thread_buffer->buffer_);
+  }
+}
+
 void AccessLogFileImpl::flushThreadFunc() {
 
   while (true) {
@@ -132,9 +163,9 @@ void AccessLogFileImpl::flushThreadFunc() {
     {
       Thread::LockGuard write_lock(write_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      // flush_event_ can be woken up either by large enough thread buffers or by timer.
+      // In case it was timer, the thread buffers can be empty.
+      while (buffered_bytes_ == 0 && !flush_thread_exit_ && !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
         flush_event_.wait(write_lock_);
       }
@@ -144,10 +175,10 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
 
       flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
     }
 
+    collectThreadBuffers();
+
     // if we failed to open file before, then simply ignore
     if (file_->isOpen()) {
       try {
@@ -168,40 +199,52 @@ void AccessLogFileImpl::flushThreadFunc() {
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-
-    if (flush_buffer_.length() == 0) {
-      return;
-    }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+  // flush_lock_ must be held while collecting the thread buffers or else it is
+  // possible that flushThreadFunc() has already moved data from them to
+  // about_to_write_buffer_, but has not yet completed doWrite(). This would
+  // allow flush() to return before the pending data has actually been written
+  // to disk.
+  Thread::LockGuard flush_lock(flush_lock_);
+
+  collectThreadBuffers();
+  if (about_to_write_buffer_.length() == 0) {
+    return;
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
-
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  ThreadBuffer& thread_buffer = threadBuffer();
+  uint64_t buffered_bytes;
+  {
+    Thread::LockGuard lock(thread_buffer.lock_);
+    if (thread_buffer.buffer_.length() + data.size() > MAX_THREAD_BUFFER_SIZE) {
+      // The flush thread is not keeping up, drop the data rather than buffering more.
+      stats_.write_dropped_.inc();
+      return;
+    }
+    thread_buffer.buffer_.add(data.data(), data.size());
+    // Counted under the lock of the thread buffer, which collectThreadBuffers() subtracts the
+    // data under, so that the data is never subtracted before it was counted.
+    buffered_bytes = buffered_bytes_ += data.size();
   }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
+
+  // The flush thread is started once the data is buffered, so that it flushes it on its first
+  // loop.
+  if (!flush_thread_started_) {
+    Thread::LockGuard lock(write_lock_);
+    if (flush_thread_ == nullptr) {
+      createFlushStructures();
+    }
+  }
+
+  // Only the write reaching the flush size wakes the flush thread up.
+  if (buffered_bytes > MIN_FLUSH_SIZE && buffered_bytes - data.size() <= MIN_FLUSH_SIZE) {
+    Thread::LockGuard lock(write_lock_);
     flush_event_.notifyOne();
   }
 }
@@ -209,6 +252,7 @@ void AccessLogFileImpl::write(absl::string_view data) {
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
   flush_timer_->enableTimer(flush_interval_msec_);
+  flush_thread_started_ = true;
 }
 
 } // namespace AccessLog
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -20,6 +23,7 @@ namespace Envoy {
   COUNTER(reopen_failed)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -58,6 +62,10 @@ private:
  * This implementation uses a flush thread per file, with the idea there aren't that many
  * files. If this turns out to be a good implementation we can potentially have a single flush
  * thread that flushes all files, but we will start with this.
+ *
+ * Each thread writing to the file appends to its own buffer, so that writers only contend with the
+ * flush thread collecting their buffers, not with each other. A thread whose buffer is full, as
+ * the flush thread can't keep up with the writes, drops its writes rather than buffering more.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
@@ -79,6 +87,16 @@ public:
   void flush() override;
 
 private:
+  // The buffer of a thread writing to the file.
+  struct ThreadBuffer {
+    Thread::MutexBasicLockable lock_; // Only contended by the flush thread collecting the buffer.
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+  using ThreadBufferSharedPtr = std::shared_ptr<ThreadBuffer>;
+
+  ThreadBuffer& threadBuffer();
+  // Move the data of all the thread buffers to about_to_write_buffer_, with flush_lock_ held.
+  void collectThreadBuffers();
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void open();
@@ -89,13 +107,20 @@ private:
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Maximum size of the buffer of a thread, above which its writes are dropped.
+  static const uint64_t MAX_THREAD_BUFFER_SIZE = MIN_FLUSH_SIZE * 64;
+
+  // Identifies the file in the thread buffer map of each thread.
+  const uint64_t id_;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) thread_buffers_lock_
+  //    4) ThreadBuffer::lock_
+  //    5) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -105,26 +130,30 @@ private:
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+  Thread::MutexBasicLockable write_lock_; // The lock is used to start the flush thread and to wake
+                                          // it up. Writers only take it when the buffered data
+                                          // reaches the flush size. It is always local to the
+                                          // process.
   Thread::ThreadPtr flush_thread_;
+  std::atomic<bool> flush_thread_started_{};
   Thread::CondVar flush_event_;
   std::atomic<bool> flush_thread_exit_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+  Thread::MutexBasicLockable thread_buffers_lock_;
+  // The buffers of the threads which wrote to the file. They get filled and then flushed either
+  // when the total buffered size is reached or when a timer fires.
+  std::vector<ThreadBufferSharedPtr> thread_buffers_ ABSL_GUARDED_BY(thread_buffers_lock_);
+  // The total size of the data in the thread buffers. It is updated under the lock of the thread
+  // buffer the data is added to or taken from, so that it never goes below zero.
+  std::atomic<uint64_t> buffered_bytes_{};
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+                                            // is moved from each thread buffer under its lock, and
+                                            // then the lock is released so that the thread buffer
+                                            // can continue to fill. This buffer is then used for
+                                            // the final write to disk.
   Event::TimerPtr flush_timer_;
   Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
@@ -7,6 +7,9 @@
 #include <cerrno>
 #include <string>
 
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -50,6 +53,43 @@ SysCallSizeResult OsSysCallsImpl::recvmsg(int sockfd, struct msghdr* msg, int fl
   return {rc, errno};
 }
 
+SysCallIntResult OsSysCallsImpl::recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags, struct timespec* timeout) {
+#if ENVOY_MMSG_MORE
+  const int rc = ::recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  UNREFERENCED_PARAMETER(timeout);
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+#endif
+}
+
+SysCallIntResult OsSysCallsImpl::sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#if ENVOY_MMSG_MORE
+  const int rc = ::sendmmsg(sockfd, msgvec, vlen, flags);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+#endif
+}
+
+bool OsSysCallsImpl::supportsMmsg() const {
+#if ENVOY_MMSG_MORE
+  return true;
+#else
+  return false;
+#endif
+}
+
 SysCallIntResult OsSysCallsImpl::ftruncate(int fd, off_t length) {
   const int rc = ::ftruncate(fd, length);
   return {rc, errno};
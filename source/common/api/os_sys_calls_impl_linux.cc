@@ -5,6 +5,8 @@
 #include "common/api/os_sys_calls_impl_linux.h"
 
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include <cerrno>
 
@@ -17,5 +19,17 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallIntResult LinuxOsSysCallsImpl::sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                                        const cpu_set_t* mask) {
+  const int rc = ::sched_setaffinity(pid, cpusetsize, mask);
+  return {rc, errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::bpf(int cmd, union bpf_attr* attr, unsigned int size) {
+  // glibc has no wrapper for bpf(2).
+  const int rc = ::syscall(__NR_bpf, cmd, attr, size);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
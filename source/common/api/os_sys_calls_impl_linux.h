@@ -15,6 +15,8 @@ class LinuxOsSysCallsImpl : public LinuxOsSysCalls {
 public:
   // Api::LinuxOsSysCalls
   SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) override;
+  SysCallIntResult sched_setaffinity(pid_t pid, size_t cpusetsize, const cpu_set_t* mask) override;
+  SysCallIntResult bpf(int cmd, union bpf_attr* attr, unsigned int size) override;
 };
 
 using LinuxOsSysCallsSingleton = ThreadSafeSingleton<LinuxOsSysCallsImpl>;
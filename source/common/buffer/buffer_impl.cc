@@ -1,5 +1,6 @@
 #include "common/buffer/buffer_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -11,12 +12,32 @@
 namespace Envoy {
 namespace Buffer {
 
+constexpr uint64_t OwnedImpl::MaxSlicesPerWrite;
+
+namespace {
+
+// The capacity of the data of a large slice, whose memory fills a large block of the slice pool.
+constexpr uint64_t LargeSliceCapacity =
+    SlicePool::LargeBlockSize - SlicePool::HeaderSize - sizeof(OwnedSlice);
+
+// Compute the capacity of a new slice at the end of a buffer of the specified length. Once a
+// buffer holds a large block worth of data it is likely carrying a bulk transfer, so when huge
+// pages are enabled it grows by large slices, which take fewer iovecs per write.
+uint64_t newSliceCapacity(uint64_t buffer_length, uint64_t size) {
+  if (buffer_length >= SlicePool::LargeBlockSize && SlicePool::hugePages()) {
+    return std::max(size, LargeSliceCapacity);
+  }
+  return size;
+}
+
+} // namespace
+
 void OwnedImpl::add(const void* data, uint64_t size) {
   const char* src = static_cast<const char*>(data);
   bool new_slice_needed = slices_.empty();
   while (size != 0) {
     if (new_slice_needed) {
-      slices_.emplace_back(OwnedSlice::create(size));
+      slices_.emplace_back(OwnedSlice::create(newSliceCapacity(length_, size)));
     }
     uint64_t copy_size = slices_.back()->append(src, size);
     src += copy_size;
@@ -43,9 +64,35 @@ void OwnedImpl::add(const Instance& data) {
   }
 }
 
+void OwnedImpl::addShared(Instance& data) {
+  ASSERT(&data != this);
+  // See move() for why we do the static cast.
+  OwnedImpl& other = static_cast<OwnedImpl&>(data);
+  for (size_t i = 0; i < other.slices_.size(); i++) {
+    SlicePtr& slice = other.slices_[i];
+    const uint64_t size = slice->dataSize();
+    if (size == 0) {
+      continue;
+    }
+    const uint8_t* content = slice->data();
+    std::shared_ptr<const Slice> shared;
+    const auto* shared_slice = dynamic_cast<const SharedSlice*>(slice.get());
+    if (shared_slice != nullptr) {
+      shared = shared_slice->shared();
+    } else {
+      shared = std::move(slice);
+      slice = std::make_unique<SharedSlice>(shared, content, size);
+    }
+    slices_.emplace_back(std::make_unique<SharedSlice>(std::move(shared), content, size));
+    length_ += size;
+  }
+}
+
 void OwnedImpl::prepend(absl::string_view data) {
   uint64_t size = data.size();
-  bool new_slice_needed = slices_.empty();
+  // The space in front of a shared slice is part of the content of the other buffers sharing it.
+  bool new_slice_needed =
+      slices_.empty() || dynamic_cast<const SharedSlice*>(slices_.front().get()) != nullptr;
   while (size != 0) {
     if (new_slice_needed) {
       slices_.emplace_front(OwnedSlice::create(size));
@@ -318,7 +365,7 @@ uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iove
 
   // If needed, allocate one more slice at the end to provide the remainder of the reservation.
   if (bytes_remaining != 0) {
-    slices_.emplace_back(OwnedSlice::create(bytes_remaining));
+    slices_.emplace_back(OwnedSlice::create(newSliceCapacity(length_, bytes_remaining)));
     iovecs[num_slices_used] = slices_.back()->reserve(bytes_remaining);
     bytes_remaining -= iovecs[num_slices_used].len_;
     num_slices_used++;
@@ -330,10 +377,10 @@ uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iove
 }
 
 ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start) const {
-  // This implementation uses the same search algorithm as evbuffer_search(), a naive
-  // scan that requires O(M*N) comparisons in the worst case.
-  // TODO(brian-pane): replace this with a more efficient search if it shows up
-  // prominently in CPU profiling.
+  // The candidates within a slice are found with memchr() on the first byte of the needle and
+  // checked with memcmp() on the rest of it, which the C library vectorizes. Only the candidates
+  // less than size bytes from the end of their slice are compared byte by byte against the next
+  // slices. The worst case still requires O(M*N) comparisons.
   if (size == 0) {
     return (start <= length_) ? start : -1;
   }
@@ -358,9 +405,17 @@ ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start) const {
       if (first_byte_match == nullptr) {
         break;
       }
-      // After finding a match for the first byte of the needle, check whether the following
-      // bytes in the buffer match the remainder of the needle. Note that the match can span
-      // two or more slices.
+      if (static_cast<uint64_t>(haystack_end - first_byte_match) >= size) {
+        // The candidate lies within this slice.
+        if (memcmp(first_byte_match + 1, needle + 1, size - 1) == 0) {
+          return offset + (first_byte_match - slice_start);
+        }
+        haystack = first_byte_match + 1;
+        continue;
+      }
+      // After finding a match for the first byte of the needle near the end of the slice, check
+      // whether the following bytes in the buffer match the remainder of the needle, in this
+      // slice and the next ones.
       size_t i = 1;
       size_t match_index = slice_index;
       const uint8_t* match_next = first_byte_match + 1;
@@ -370,8 +425,8 @@ ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start) const {
           // We've hit the end of this slice, so continue checking against the next slice.
           match_index++;
           if (match_index == slices_.size()) {
-            // We've hit the end of the entire buffer.
-            break;
+            // We've hit the end of the entire buffer, so no later candidate can match either.
+            return -1;
           }
           const auto& match_slice = slices_[match_index];
           match_next = match_slice->data();
@@ -432,9 +487,8 @@ bool OwnedImpl::startsWith(absl::string_view data) const {
 }
 
 Api::IoCallUint64Result OwnedImpl::write(Network::IoHandle& io_handle) {
-  constexpr uint64_t MaxSlices = 16;
-  RawSlice slices[MaxSlices];
-  const uint64_t num_slices = std::min(getRawSlices(slices, MaxSlices), MaxSlices);
+  RawSlice slices[MaxSlicesPerWrite];
+  const uint64_t num_slices = std::min(getRawSlices(slices, MaxSlicesPerWrite), MaxSlicesPerWrite);
   Api::IoCallUint64Result result = io_handle.writev(slices, num_slices);
   if (result.ok() && result.rc_ > 0) {
     drain(static_cast<uint64_t>(result.rc_));
@@ -467,6 +521,15 @@ std::string OwnedImpl::toString() const {
   return output;
 }
 
+uint64_t OwnedImpl::releaseEmptySlices() {
+  uint64_t num_released = 0;
+  while (!slices_.empty() && slices_.back()->dataSize() == 0) {
+    slices_.pop_back();
+    num_released++;
+  }
+  return num_released;
+}
+
 void OwnedImpl::postProcess() {}
 
 void OwnedImpl::appendSliceForTest(const void* data, uint64_t size) {
@@ -8,6 +8,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/io_handle.h"
 
+#include "common/buffer/slice_pool.h"
 #include "common/common/assert.h"
 #include "common/common/non_copyable.h"
 #include "common/common/utility.h"
@@ -221,18 +222,28 @@ public:
     return slice;
   }
 
+  // The slices are allocated from the slice pool of the thread, which recycles the memory of the
+  // slices of the common sizes.
+  static void operator delete(void* address) { SlicePool::free(address); }
+
 private:
   OwnedSlice(uint64_t size) : Slice(0, 0, size) { base_ = storage_; }
 
+  static void* operator new(size_t object_size, size_t data_size_bytes) {
+    return SlicePool::allocate(object_size + data_size_bytes);
+  }
+
   /**
    * Compute a slice size big enough to hold a specified amount of data.
    * @param data_size the minimum amount of data the slice must be able to store, in bytes.
-   * @return a recommended slice size, in bytes.
+   * @return a recommended slice size, in bytes, such that the memory allocated for the slice,
+   *         including the header of the slice pool, is a whole number of pages.
    */
   static uint64_t sliceSize(uint64_t data_size) {
     static constexpr uint64_t PageSize = 4096;
-    const uint64_t num_pages = (sizeof(OwnedSlice) + data_size + PageSize - 1) / PageSize;
-    return num_pages * PageSize - sizeof(OwnedSlice);
+    const uint64_t overhead = SlicePool::HeaderSize + sizeof(OwnedSlice);
+    const uint64_t num_pages = (overhead + data_size + PageSize - 1) / PageSize;
+    return num_pages * PageSize - overhead;
   }
 
   uint8_t storage_[];
@@ -405,6 +416,23 @@ private:
   BufferFragment& fragment_;
 };
 
+/**
+ * A read-only slice referencing part of the content of another slice, which is shared by several
+ * buffers and released along with the last slice referencing it.
+ */
+class SharedSlice : public Slice {
+public:
+  SharedSlice(std::shared_ptr<const Slice> shared, const uint8_t* data, uint64_t size)
+      : Slice(0, size, size), shared_(std::move(shared)) {
+    base_ = const_cast<uint8_t*>(data);
+  }
+
+  const std::shared_ptr<const Slice>& shared() const { return shared_; }
+
+private:
+  const std::shared_ptr<const Slice> shared_;
+};
+
 /**
  * An implementation of BufferFragment where a releasor callback is called when the data is
  * no longer needed.
@@ -478,6 +506,9 @@ private:
  */
 class OwnedImpl : public LibEventInstance {
 public:
+  // Maximum number of slices handed to a single writev() by write().
+  static constexpr uint64_t MaxSlicesPerWrite = 16;
+
   OwnedImpl();
   OwnedImpl(absl::string_view data);
   OwnedImpl(const Instance& data);
@@ -508,6 +539,23 @@ public:
   // LibEventInstance
   void postProcess() override;
 
+  /**
+   * Add the content of another buffer without copying nor draining it. The slices of the other
+   * buffer are turned into read-only slices sharing their content with the slices added to this
+   * buffer, so that the content is released once both buffers are done with it. The other buffer
+   * can still be added to, into new slices.
+   * @param data supplies the buffer whose content is added.
+   */
+  void addShared(Instance& data);
+
+  /**
+   * Release the slices at the end of the buffer which hold no content, such as the space left
+   * reserved by a read which didn't fill it, so that an idle buffer doesn't hold on to memory.
+   * Any pending reservation in these slices can't be committed afterwards.
+   * @return uint64_t the number of slices released.
+   */
+  uint64_t releaseEmptySlices();
+
   /**
    * Create a new slice at the end of the buffer, and copy the supplied content into it.
    * @param data start of the content to copy.
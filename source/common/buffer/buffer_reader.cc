@@ -0,0 +1,85 @@
+#include "common/buffer/buffer_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+Reader::Reader(const Instance& buffer) : length_(buffer.length()) {
+  slices_.resize(buffer.getRawSlices(nullptr, 0));
+  buffer.getRawSlices(slices_.data(), slices_.size());
+  // Empty slices are dropped, so that the cursor is always within a slice while bytes remain.
+  slices_.erase(std::remove_if(slices_.begin(), slices_.end(),
+                               [](const RawSlice& slice) { return slice.len_ == 0; }),
+                slices_.end());
+}
+
+absl::string_view Reader::contiguous() const {
+  if (slice_index_ == slices_.size()) {
+    return {};
+  }
+  const RawSlice& slice = slices_[slice_index_];
+  return {static_cast<const char*>(slice.mem_) + slice_offset_, slice.len_ - slice_offset_};
+}
+
+bool Reader::skip(uint64_t size) {
+  if (size > remaining()) {
+    return false;
+  }
+  advance(size);
+  return true;
+}
+
+bool Reader::read(void* data, uint64_t size) {
+  if (size > remaining()) {
+    return false;
+  }
+  uint8_t* dest = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    const absl::string_view bytes = contiguous();
+    const uint64_t copy_size = std::min<uint64_t>(size, bytes.size());
+    memcpy(dest, bytes.data(), copy_size);
+    dest += copy_size;
+    size -= copy_size;
+    advance(copy_size);
+  }
+  return true;
+}
+
+ssize_t Reader::find(uint8_t byte) const {
+  uint64_t offset = position_;
+  uint64_t slice_offset = slice_offset_;
+  for (size_t index = slice_index_; index < slices_.size(); index++) {
+    const RawSlice& slice = slices_[index];
+    const uint8_t* start = static_cast<const uint8_t*>(slice.mem_) + slice_offset;
+    const uint64_t size = slice.len_ - slice_offset;
+    const void* match = memchr(start, byte, size);
+    if (match != nullptr) {
+      return offset + (static_cast<const uint8_t*>(match) - start);
+    }
+    offset += size;
+    slice_offset = 0;
+  }
+  return -1;
+}
+
+void Reader::advance(uint64_t size) {
+  ASSERT(size <= remaining());
+  position_ += size;
+  while (size > 0) {
+    const uint64_t slice_remaining = slices_[slice_index_].len_ - slice_offset_;
+    if (size < slice_remaining) {
+      slice_offset_ += size;
+      return;
+    }
+    size -= slice_remaining;
+    slice_index_++;
+    slice_offset_ = 0;
+  }
+}
+
+} // namespace Buffer
+} // namespace Envoy
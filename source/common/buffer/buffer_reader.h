@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+
+#include "common/common/byte_order.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * A forward cursor over the data of a buffer, which reads the data in place slice by slice. Unlike
+ * linearize(), it does not copy the data to make it contiguous, and unlike copyOut() and
+ * peekInt(), it does not walk the slices from the front of the buffer on every read.
+ *
+ * The buffer must not be modified while the reader is in use.
+ */
+class Reader {
+public:
+  explicit Reader(const Instance& buffer);
+
+  /**
+   * @return uint64_t the offset of the cursor in the buffer.
+   */
+  uint64_t position() const { return position_; }
+
+  /**
+   * @return uint64_t the number of bytes after the cursor.
+   */
+  uint64_t remaining() const { return length_ - position_; }
+
+  /**
+   * @return absl::string_view the bytes from the cursor to the end of its slice, which are empty
+   *         only when no bytes remain.
+   */
+  absl::string_view contiguous() const;
+
+  /**
+   * Advance the cursor.
+   * @param size supplies the number of bytes to advance by.
+   * @return bool false, with the cursor unchanged, if fewer bytes remain.
+   */
+  bool skip(uint64_t size);
+
+  /**
+   * Copy bytes out of the buffer and advance the cursor past them.
+   * @param data supplies the output buffer to fill.
+   * @param size supplies the number of bytes to copy.
+   * @return bool false, with the cursor unchanged, if fewer bytes remain.
+   */
+  bool read(void* data, uint64_t size);
+
+  /**
+   * Read an integer and advance the cursor past it.
+   * @param value supplies the integer to set.
+   * @return bool false, with the cursor unchanged, if fewer bytes remain.
+   */
+  template <typename T, ByteOrder Endianness = ByteOrder::Host> bool readInt(T& value) {
+    static_assert(std::is_integral<T>::value, "readInt requires an integer type");
+    T result;
+    if (!read(&result, sizeof(T))) {
+      return false;
+    }
+    value = fromEndianness<Endianness>(result);
+    return true;
+  }
+
+  template <typename T> bool readBEInt(T& value) {
+    return readInt<T, ByteOrder::BigEndian>(value);
+  }
+
+  template <typename T> bool readLEInt(T& value) {
+    return readInt<T, ByteOrder::LittleEndian>(value);
+  }
+
+  /**
+   * Find the next occurrence of a byte, without advancing the cursor.
+   * @param byte supplies the byte to search for.
+   * @return ssize_t the offset of the byte in the buffer, or -1 if it does not occur after the
+   *         cursor.
+   */
+  ssize_t find(uint8_t byte) const;
+
+private:
+  void advance(uint64_t size);
+
+  absl::InlinedVector<RawSlice, 16> slices_;
+  const uint64_t length_;
+  uint64_t position_{};
+  // The slice of the cursor, and the offset of the cursor within it.
+  size_t slice_index_{};
+  uint64_t slice_offset_{};
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,166 @@
+#include "common/buffer/memory_account.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+namespace {
+
+std::atomic<uint64_t> worker_limit{0};
+std::atomic<uint64_t> throttled_accounts{0};
+
+} // namespace
+
+MemoryAccount::~MemoryAccount() {
+  ASSERT(bytes_ == 0 && callbacks_.empty());
+  budget_.remove(*this);
+}
+
+MemoryAccountSharedPtr MemoryAccount::create(MemoryClass memory_class) {
+  if (MemoryBudget::workerLimit() == 0) {
+    return nullptr;
+  }
+  return MemoryAccountSharedPtr{new MemoryAccount(MemoryBudget::threadBudget(), memory_class)};
+}
+
+void MemoryAccount::charge(uint64_t size) {
+  if (size != 0) {
+    budget_.charge(*this, size);
+  }
+}
+
+void MemoryAccount::credit(uint64_t size) {
+  if (size != 0) {
+    budget_.credit(*this, size);
+  }
+}
+
+void MemoryAccount::addCallbacks(MemoryAccountCallbacks& callbacks) {
+  callbacks_.push_back(&callbacks);
+}
+
+void MemoryAccount::removeCallbacks(MemoryAccountCallbacks& callbacks) {
+  callbacks_.erase(std::remove(callbacks_.begin(), callbacks_.end(), &callbacks),
+                   callbacks_.end());
+}
+
+void MemoryBudget::setWorkerLimit(uint64_t bytes) {
+  worker_limit.store(bytes, std::memory_order_relaxed);
+}
+
+uint64_t MemoryBudget::workerLimit() { return worker_limit.load(std::memory_order_relaxed); }
+
+uint64_t MemoryBudget::throttledAccounts() {
+  return throttled_accounts.load(std::memory_order_relaxed);
+}
+
+MemoryBudget& MemoryBudget::threadBudget() {
+  static thread_local MemoryBudget budget;
+  return budget;
+}
+
+void MemoryBudget::charge(MemoryAccount& account, uint64_t size) {
+  if (account.bytes_ == 0) {
+    active_accounts_.insert(&account);
+  }
+  account.bytes_ += size;
+  bytes_ += size;
+  class_bytes_[static_cast<size_t>(account.memory_class_)] += size;
+
+  const uint64_t limit = workerLimit();
+  if (limit != 0 && bytes_ > limit && !enforcing_) {
+    throttleLargest(bytes_ - limit);
+  }
+}
+
+void MemoryBudget::credit(MemoryAccount& account, uint64_t size) {
+  ASSERT(account.bytes_ >= size);
+  account.bytes_ -= size;
+  bytes_ -= size;
+  class_bytes_[static_cast<size_t>(account.memory_class_)] -= size;
+  if (account.bytes_ == 0) {
+    active_accounts_.erase(&account);
+  }
+
+  if (enforcing_ || throttled_accounts_.empty()) {
+    return;
+  }
+  if (bytes_ <= workerLimit() / 2) {
+    const std::vector<MemoryAccount*> accounts(throttled_accounts_.begin(),
+                                               throttled_accounts_.end());
+    for (MemoryAccount* throttled : accounts) {
+      // The callbacks of an account may have destroyed the next accounts.
+      if (throttled_accounts_.count(throttled) != 0) {
+        release(*throttled);
+      }
+    }
+  } else if (account.bytes_ == 0 && account.throttled_) {
+    release(account);
+  }
+}
+
+void MemoryBudget::remove(MemoryAccount& account) {
+  active_accounts_.erase(&account);
+  throttled_accounts_.erase(&account);
+}
+
+void MemoryBudget::throttleLargest(uint64_t excess) {
+  uint64_t throttled_bytes = 0;
+  for (const MemoryAccount* account : throttled_accounts_) {
+    throttled_bytes += account->bytes_;
+  }
+  // The accounts are scanned linearly, which is only done while the worker is over its budget.
+  while (throttled_bytes < excess) {
+    MemoryAccount* largest = nullptr;
+    for (MemoryAccount* account : active_accounts_) {
+      if (!account->throttled_ && (largest == nullptr || account->bytes_ > largest->bytes_)) {
+        largest = account;
+      }
+    }
+    if (largest == nullptr) {
+      return;
+    }
+    throttled_bytes += largest->bytes_;
+    throttle(*largest);
+  }
+}
+
+void MemoryBudget::throttle(MemoryAccount& account) {
+  account.throttled_ = true;
+  throttled_accounts_.insert(&account);
+  throttled_accounts.fetch_add(1, std::memory_order_relaxed);
+
+  enforcing_ = true;
+  const std::vector<MemoryAccountCallbacks*> callbacks = account.callbacks_;
+  for (MemoryAccountCallbacks* buffer : callbacks) {
+    // The callbacks of a buffer may have destroyed the next ones.
+    if (std::find(account.callbacks_.begin(), account.callbacks_.end(), buffer) !=
+        account.callbacks_.end()) {
+      buffer->onAboveBudget();
+    }
+  }
+  enforcing_ = false;
+}
+
+void MemoryBudget::release(MemoryAccount& account) {
+  account.throttled_ = false;
+  throttled_accounts_.erase(&account);
+
+  enforcing_ = true;
+  const std::vector<MemoryAccountCallbacks*> callbacks = account.callbacks_;
+  for (MemoryAccountCallbacks* buffer : callbacks) {
+    // The callbacks of a buffer may have destroyed the next ones.
+    if (std::find(account.callbacks_.begin(), account.callbacks_.end(), buffer) !=
+        account.callbacks_.end()) {
+      buffer->onBelowBudget();
+    }
+  }
+  enforcing_ = false;
+}
+
+} // namespace Buffer
+} // namespace Envoy
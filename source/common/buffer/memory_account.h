@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/pure.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Callbacks invoked on the buffers charged to an account when the budget of the worker throttles
+ * or releases the account.
+ */
+class MemoryAccountCallbacks {
+public:
+  virtual ~MemoryAccountCallbacks() = default;
+
+  /**
+   * Called when the account is throttled, as it is one of the largest consumers of a worker over
+   * its budget. The buffer should apply backpressure as if it were above its high watermark.
+   */
+  virtual void onAboveBudget() PURE;
+
+  /**
+   * Called when the account is released, as it has drained or the worker is back within its
+   * budget.
+   */
+  virtual void onBelowBudget() PURE;
+};
+
+class MemoryAccount;
+class MemoryBudget;
+using MemoryAccountSharedPtr = std::shared_ptr<MemoryAccount>;
+
+/**
+ * The memory held by the buffers of one consumer, such as a connection, charged to the budget of
+ * the worker it runs on. An account and its buffers must only be used by the thread which created
+ * the account.
+ */
+class MemoryAccount : NonCopyable {
+public:
+  ~MemoryAccount();
+
+  /**
+   * Create an account charged to the budget of the calling thread.
+   * @param memory_class supplies the class of the memory of the account.
+   * @return MemoryAccountSharedPtr the account, or nullptr if the worker budget is disabled.
+   */
+  static MemoryAccountSharedPtr create(MemoryClass memory_class);
+
+  MemoryClass memoryClass() const { return memory_class_; }
+  uint64_t bytes() const { return bytes_; }
+  bool throttled() const { return throttled_; }
+
+  /**
+   * Charge or credit the account when its buffers grow or shrink.
+   * @param size supplies the number of bytes.
+   */
+  void charge(uint64_t size);
+  void credit(uint64_t size);
+
+  /**
+   * Register the callbacks of a buffer charged to the account.
+   * @param callbacks supplies the callbacks, which must be removed before they are destroyed.
+   */
+  void addCallbacks(MemoryAccountCallbacks& callbacks);
+  void removeCallbacks(MemoryAccountCallbacks& callbacks);
+
+private:
+  friend class MemoryBudget;
+
+  MemoryAccount(MemoryBudget& budget, MemoryClass memory_class)
+      : budget_(budget), memory_class_(memory_class) {}
+
+  MemoryBudget& budget_;
+  const MemoryClass memory_class_;
+  uint64_t bytes_{};
+  bool throttled_{};
+  std::vector<MemoryAccountCallbacks*> callbacks_;
+};
+
+/**
+ * The budget of the buffer memory of a worker. When the accounts of a worker hold more than the
+ * limit, the largest accounts are throttled until they hold at least the excess, so that
+ * backpressure is applied to the largest consumers first. A throttled account is released once it
+ * has drained, and all the accounts are released once the worker is back under half the limit.
+ */
+class MemoryBudget : NonCopyable {
+public:
+  /**
+   * Set the limit of the buffer memory of each worker. This is meant to be set once at startup,
+   * before the workers create their connections.
+   * @param bytes supplies the limit, or 0 to disable the budget.
+   */
+  static void setWorkerLimit(uint64_t bytes);
+  static uint64_t workerLimit();
+
+  /**
+   * @return uint64_t the number of times accounts were throttled, across all the workers.
+   */
+  static uint64_t throttledAccounts();
+
+  /**
+   * @return MemoryBudget& the budget of the calling thread.
+   */
+  static MemoryBudget& threadBudget();
+
+  /**
+   * @return uint64_t the bytes charged to the accounts of the worker.
+   */
+  uint64_t bytes() const { return bytes_; }
+
+  /**
+   * @return uint64_t the bytes charged to the accounts of a class.
+   */
+  uint64_t bytes(MemoryClass memory_class) const {
+    return class_bytes_[static_cast<size_t>(memory_class)];
+  }
+
+private:
+  friend class MemoryAccount;
+
+  MemoryBudget() = default;
+
+  void charge(MemoryAccount& account, uint64_t size);
+  void credit(MemoryAccount& account, uint64_t size);
+  void remove(MemoryAccount& account);
+  void throttleLargest(uint64_t excess);
+  void throttle(MemoryAccount& account);
+  void release(MemoryAccount& account);
+
+  uint64_t bytes_{};
+  uint64_t class_bytes_[static_cast<size_t>(MemoryClass::FilterBody) + 1]{};
+  // The accounts holding memory, among which the largest are throttled.
+  absl::flat_hash_set<MemoryAccount*> active_accounts_;
+  absl::flat_hash_set<MemoryAccount*> throttled_accounts_;
+  // Set while the callbacks of accounts run, as they may change the buffers of other accounts.
+  bool enforcing_{};
+};
+
+} // namespace Buffer
+} // namespace Envoy
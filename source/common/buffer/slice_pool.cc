@@ -0,0 +1,300 @@
+#include "common/buffer/slice_pool.h"
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Buffer {
+
+namespace {
+
+constexpr size_t PooledSizes[] = {4096, 16384, 65536, SlicePool::LargeBlockSize};
+constexpr size_t NumPooledSizes = sizeof(PooledSizes) / sizeof(PooledSizes[0]);
+
+// The size of the huge page regions, which is the size of a huge page on x86-64 and arm64.
+constexpr size_t RegionSize = 2 * 1024 * 1024;
+constexpr size_t BlocksPerRegion = RegionSize / SlicePool::LargeBlockSize;
+
+std::atomic<bool> huge_pages_enabled{false};
+std::atomic<uint64_t> huge_page_bytes{0};
+
+int pooledSizeIndex(size_t block_size) {
+  for (size_t i = 0; i < NumPooledSizes; ++i) {
+    if (PooledSizes[i] == block_size) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+// A region mapped with transparent huge pages, carved into large blocks by a thread. It is
+// referenced by its blocks, which may be freed by other threads, and by the thread carving it.
+class HugePageRegion {
+public:
+  static HugePageRegion* create() {
+    // Twice the size is mapped, so that the region can be aligned on a huge page boundary.
+    void* mapping =
+        mmap(nullptr, 2 * RegionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+      return nullptr;
+    }
+    uint8_t* start = static_cast<uint8_t*>(mapping);
+    uint8_t* base = reinterpret_cast<uint8_t*>(
+        (reinterpret_cast<uintptr_t>(start) + RegionSize - 1) & ~(RegionSize - 1));
+    if (base > start) {
+      munmap(start, base - start);
+    }
+    if (base + RegionSize < start + 2 * RegionSize) {
+      munmap(base + RegionSize, start + 2 * RegionSize - (base + RegionSize));
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(base, RegionSize, MADV_HUGEPAGE);
+#endif
+    huge_page_bytes.fetch_add(RegionSize, std::memory_order_relaxed);
+    return new HugePageRegion(base);
+  }
+
+  uint8_t* block(size_t index) { return base_ + index * SlicePool::LargeBlockSize; }
+  void reference() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      munmap(base_, RegionSize);
+      huge_page_bytes.fetch_sub(RegionSize, std::memory_order_relaxed);
+      delete this;
+    }
+  }
+
+private:
+  HugePageRegion(uint8_t* base) : base_(base) {}
+
+  uint8_t* const base_;
+  // Starts with the reference of the thread carving the region.
+  std::atomic<uint32_t> refs_{1};
+};
+
+// The header preceding the memory handed out.
+struct BlockHeader {
+  size_t size_;
+  // The region of the block, or nullptr if it was allocated by operator new.
+  HugePageRegion* region_;
+};
+static_assert(sizeof(BlockHeader) <= SlicePool::HeaderSize, "slice pool header too small");
+
+BlockHeader& header(void* block) { return *static_cast<BlockHeader*>(block); }
+
+// Return a block to the allocator or to its region.
+void releaseBlock(void* block) {
+  HugePageRegion* region = header(block).region_;
+  if (region != nullptr) {
+    region->release();
+  } else {
+    ::operator delete(block);
+  }
+}
+
+class ThreadSlicePool;
+
+// The pools of the live threads, and the counts of the pools of the exited threads, read by the
+// stats.
+struct Registry {
+  absl::Mutex mutex_;
+  absl::flat_hash_set<const ThreadSlicePool*> pools_ ABSL_GUARDED_BY(mutex_);
+  uint64_t exited_hits_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t exited_misses_ ABSL_GUARDED_BY(mutex_){};
+};
+
+Registry& registry() {
+  // Never destroyed, as threads may exit during static destruction.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// Set once the pool of the thread is destroyed, so that the slices freed later by the destructors
+// of other thread locals go to the allocator.
+thread_local bool thread_pool_destroyed = false;
+
+// The counters are only written by the thread owning the pool, and read by the stats.
+void increment(std::atomic<uint64_t>& counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+class ThreadSlicePool {
+public:
+  ThreadSlicePool() {
+    Registry& r = registry();
+    absl::MutexLock lock(&r.mutex_);
+    r.pools_.insert(this);
+  }
+
+  ~ThreadSlicePool() {
+    for (const std::vector<void*>& free_list : free_lists_) {
+      for (void* block : free_list) {
+        releaseBlock(block);
+      }
+    }
+    if (region_ != nullptr) {
+      region_->release();
+    }
+    thread_pool_destroyed = true;
+
+    Registry& r = registry();
+    absl::MutexLock lock(&r.mutex_);
+    r.pools_.erase(this);
+    r.exited_hits_ += hits_.load(std::memory_order_relaxed);
+    r.exited_misses_ += misses_.load(std::memory_order_relaxed);
+  }
+
+  void* allocate(size_t block_size) {
+    const int index = pooledSizeIndex(block_size);
+    if (index < 0) {
+      return allocateBlock(block_size);
+    }
+
+    std::vector<void*>& free_list = free_lists_[index];
+    if (free_list.empty()) {
+      increment(misses_);
+      return allocateBlock(block_size);
+    }
+    increment(hits_);
+    void* block = free_list.back();
+    free_list.pop_back();
+    bytes_.store(bytes_.load(std::memory_order_relaxed) - block_size, std::memory_order_relaxed);
+    return block;
+  }
+
+  void free(void* block) {
+    const size_t block_size = header(block).size_;
+    const int index = pooledSizeIndex(block_size);
+    const uint64_t bytes = bytes_.load(std::memory_order_relaxed);
+    if (index < 0 || bytes + block_size > SlicePool::MaxPooledBytes) {
+      releaseBlock(block);
+      return;
+    }
+    free_lists_[index].push_back(block);
+    bytes_.store(bytes + block_size, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> bytes_{};
+  std::atomic<uint64_t> hits_{};
+  std::atomic<uint64_t> misses_{};
+
+private:
+  void* allocateBlock(size_t block_size) {
+    if (block_size == SlicePool::LargeBlockSize && SlicePool::hugePages()) {
+      void* block = carveBlock();
+      if (block != nullptr) {
+        return block;
+      }
+    }
+    void* block = ::operator new(block_size);
+    header(block).region_ = nullptr;
+    return block;
+  }
+
+  // Carve the next block of the region of the thread, mapping a new region if needed.
+  void* carveBlock() {
+    if (region_ == nullptr) {
+      region_ = HugePageRegion::create();
+      if (region_ == nullptr) {
+        return nullptr;
+      }
+      next_block_ = 0;
+    }
+    void* block = region_->block(next_block_);
+    region_->reference();
+    header(block).region_ = region_;
+    if (++next_block_ == BlocksPerRegion) {
+      region_->release();
+      region_ = nullptr;
+    }
+    return block;
+  }
+
+  std::vector<void*> free_lists_[NumPooledSizes];
+  HugePageRegion* region_{};
+  size_t next_block_{};
+};
+
+ThreadSlicePool* threadPool() {
+  if (thread_pool_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadSlicePool pool;
+  return &pool;
+}
+
+} // namespace
+
+void* SlicePool::allocate(size_t size) {
+  const size_t block_size = HeaderSize + size;
+  ThreadSlicePool* pool = threadPool();
+  void* block;
+  if (pool != nullptr) {
+    block = pool->allocate(block_size);
+  } else {
+    block = ::operator new(block_size);
+    header(block).region_ = nullptr;
+  }
+  header(block).size_ = block_size;
+  return static_cast<uint8_t*>(block) + HeaderSize;
+}
+
+void SlicePool::free(void* memory) {
+  if (memory == nullptr) {
+    return;
+  }
+  void* block = static_cast<uint8_t*>(memory) - HeaderSize;
+  ThreadSlicePool* pool = threadPool();
+  if (pool == nullptr) {
+    releaseBlock(block);
+    return;
+  }
+  pool->free(block);
+}
+
+void SlicePool::setHugePages(bool enabled) {
+  huge_pages_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool SlicePool::hugePages() { return huge_pages_enabled.load(std::memory_order_relaxed); }
+
+uint64_t SlicePool::pooledBytes() {
+  Registry& r = registry();
+  absl::MutexLock lock(&r.mutex_);
+  uint64_t bytes = 0;
+  for (const ThreadSlicePool* pool : r.pools_) {
+    bytes += pool->bytes_.load(std::memory_order_relaxed);
+  }
+  return bytes;
+}
+
+uint64_t SlicePool::hits() {
+  Registry& r = registry();
+  absl::MutexLock lock(&r.mutex_);
+  uint64_t hits = r.exited_hits_;
+  for (const ThreadSlicePool* pool : r.pools_) {
+    hits += pool->hits_.load(std::memory_order_relaxed);
+  }
+  return hits;
+}
+
+uint64_t SlicePool::misses() {
+  Registry& r = registry();
+  absl::MutexLock lock(&r.mutex_);
+  uint64_t misses = r.exited_misses_;
+  for (const ThreadSlicePool* pool : r.pools_) {
+    misses += pool->misses_.load(std::memory_order_relaxed);
+  }
+  return misses;
+}
+
+uint64_t SlicePool::hugePageBytes() { return huge_page_bytes.load(std::memory_order_relaxed); }
+
+} // namespace Buffer
+} // namespace Envoy
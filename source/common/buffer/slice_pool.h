@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Per-thread free lists of the memory of owned slices, for the common slice sizes of 4KiB, 16KiB
+ * and 64KiB, and for the large slices of LargeBlockSize. The memory of slices of these sizes is
+ * kept by the thread freeing it for its next slices instead of being returned to the allocator, up
+ * to MaxPooledBytes per thread, so that the slices created by the reads and reservations of a
+ * worker mostly reuse the memory of the slices it has drained.
+ *
+ * When huge pages are enabled, the buffers holding at least LargeBlockSize bytes grow by large
+ * slices, whose memory is carved out of 2MiB regions mapped with transparent huge pages where
+ * supported. A region is unmapped once all its blocks are freed, rather than releasing the pages
+ * of its free blocks, which would split its huge pages. A region is thereby kept whole by any
+ * live or pooled block, so the memory mapped for large slices is bounded by eight times their
+ * memory (a single 256KiB slice holds a 2MiB region), plus the region each thread is carving.
+ *
+ * The memory is preceded by a header holding its size and region, so that it can be freed without
+ * the size being supplied.
+ */
+class SlicePool {
+public:
+  /**
+   * Allocate memory.
+   * @param size supplies the size of the memory, which is pooled when HeaderSize + size is one of
+   *        the pooled sizes.
+   * @return void* the memory, aligned like the memory returned by operator new.
+   */
+  static void* allocate(size_t size);
+
+  /**
+   * Free memory returned by allocate(), to the free list of the calling thread if it has room for
+   * it.
+   * @param memory supplies the memory.
+   */
+  static void free(void* memory);
+
+  /**
+   * Enable the large slices backed by huge page regions. This is meant to be set once at startup,
+   * before the buffers of the workers are created.
+   * @param enabled supplies whether the large slices are enabled.
+   */
+  static void setHugePages(bool enabled);
+
+  /**
+   * @return bool whether the buffers holding at least LargeBlockSize bytes grow by large slices.
+   */
+  static bool hugePages();
+
+  /**
+   * @return uint64_t the number of bytes held by the free lists of all the threads.
+   */
+  static uint64_t pooledBytes();
+
+  /**
+   * @return uint64_t the number of allocations of a pooled size served by a free list.
+   */
+  static uint64_t hits();
+
+  /**
+   * @return uint64_t the number of allocations of a pooled size served by the allocator, as the
+   *         free list of the thread was empty.
+   */
+  static uint64_t misses();
+
+  /**
+   * @return uint64_t the number of bytes of the huge page regions currently mapped, which includes
+   *         the free blocks of the regions that still have a live block.
+   */
+  static uint64_t hugePageBytes();
+
+  // The size of the header preceding the memory, which keeps its alignment.
+  static constexpr size_t HeaderSize = 16;
+  // The number of bytes a thread keeps in its free lists.
+  static constexpr uint64_t MaxPooledBytes = 1024 * 1024;
+  // The size of the memory of the large slices, header included.
+  static constexpr size_t LargeBlockSize = 256 * 1024;
+};
+
+} // namespace Buffer
+} // namespace Envoy
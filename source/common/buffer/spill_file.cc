@@ -0,0 +1,91 @@
+#include "common/buffer/spill_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+
+namespace Envoy {
+namespace Buffer {
+
+// A fragment referencing data of a chunk, which keeps the chunk mapped until the buffer it is added
+// to is done with it.
+class SpillFile::ChunkFragment : public BufferFragment {
+public:
+  ChunkFragment(ChunkSharedPtr chunk, const uint8_t* data, size_t size)
+      : chunk_(std::move(chunk)), data_(data), size_(size) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override { delete this; }
+
+private:
+  const ChunkSharedPtr chunk_;
+  const uint8_t* const data_;
+  const size_t size_;
+};
+
+SpillFile::Chunk::~Chunk() { munmap(base_, ChunkSize); }
+
+SpillFile::~SpillFile() { Api::OsSysCallsSingleton::get().close(fd_); }
+
+std::unique_ptr<SpillFile> SpillFile::create(const std::string& directory) {
+  std::string path = directory + "/envoy_spill_XXXXXX";
+  const int fd = mkstemp(&path[0]);
+  if (fd == -1) {
+    return nullptr;
+  }
+  // The file is only reached through its descriptor and mappings, and is removed once they are
+  // closed, including when the process exits.
+  unlink(path.c_str());
+  return std::unique_ptr<SpillFile>(new SpillFile(fd));
+}
+
+bool SpillFile::addChunk() {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const uint64_t chunk_size = ChunkSize;
+  // The blocks are allocated up front where supported, as writing to the mapping of a sparse file
+  // on a full file system raises SIGBUS.
+#ifdef __linux__
+  if (posix_fallocate(fd_, file_size_, chunk_size) != 0) {
+    return false;
+  }
+#else
+  if (os_sys_calls.ftruncate(fd_, file_size_ + chunk_size).rc_ != 0) {
+    return false;
+  }
+#endif
+  const Api::SysCallPtrResult result =
+      os_sys_calls.mmap(nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, file_size_);
+  if (result.rc_ == MAP_FAILED) {
+    return false;
+  }
+  file_size_ += chunk_size;
+  current_chunk_ = std::make_shared<Chunk>(static_cast<uint8_t*>(result.rc_));
+  return true;
+}
+
+uint64_t SpillFile::append(const void* data, uint64_t size, Instance& buffer) {
+  const uint8_t* cursor = static_cast<const uint8_t*>(data);
+  uint64_t appended = 0;
+  while (appended < size) {
+    if ((current_chunk_ == nullptr || current_chunk_->used_ == ChunkSize) && !addChunk()) {
+      break;
+    }
+    const uint64_t fragment_size = std::min(size - appended, ChunkSize - current_chunk_->used_);
+    uint8_t* fragment_data = current_chunk_->base_ + current_chunk_->used_;
+    memcpy(fragment_data, cursor + appended, fragment_size);
+    current_chunk_->used_ += fragment_size;
+    appended += fragment_size;
+    buffer.addBufferFragment(*new ChunkFragment(current_chunk_, fragment_data, fragment_size));
+  }
+  return appended;
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * An unlinked temporary file to which buffers move their data, so that large bodies are backed by
+ * the page cache rather than by the heap. The file is grown and memory-mapped one chunk at a time,
+ * and the data appended to it is added to the buffers as fragments referencing the mappings. The
+ * kernel can write the pages back to the file and evict them under memory pressure, and read them
+ * back when the buffers are written out.
+ *
+ * A chunk stays mapped as long as any fragment referencing it is alive, so the data moved to
+ * other buffers outlives the file.
+ */
+class SpillFile : NonCopyable {
+public:
+  ~SpillFile();
+
+  /**
+   * Create a spill file.
+   * @param directory supplies the directory in which the file is created and unlinked.
+   * @return the file, or nullptr if it could not be created.
+   */
+  static std::unique_ptr<SpillFile> create(const std::string& directory);
+
+  /**
+   * Copy data to the file, and add it to a buffer as fragments referencing the file.
+   * @param data supplies the data to copy.
+   * @param size supplies the size of the data.
+   * @param buffer supplies the buffer to add the data to.
+   * @return uint64_t the number of bytes copied, which is less than size when the file could not
+   *         be grown. The rest of the data is left to the caller.
+   */
+  uint64_t append(const void* data, uint64_t size, Instance& buffer);
+
+  // The size by which the file is grown and mapped.
+  static constexpr uint64_t ChunkSize = 1024 * 1024;
+
+private:
+  struct Chunk : NonCopyable {
+    Chunk(uint8_t* base) : base_(base) {}
+    ~Chunk();
+
+    uint8_t* const base_;
+    uint64_t used_{};
+  };
+  using ChunkSharedPtr = std::shared_ptr<Chunk>;
+
+  class ChunkFragment;
+
+  SpillFile(int fd) : fd_(fd) {}
+
+  bool addChunk();
+
+  const int fd_;
+  uint64_t file_size_{};
+  // The chunk data is appended to.
+  ChunkSharedPtr current_chunk_;
+};
+
+using SpillFilePtr = std::unique_ptr<SpillFile>;
+
+} // namespace Buffer
+} // namespace Envoy
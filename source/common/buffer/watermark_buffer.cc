@@ -1,22 +1,44 @@
 #include "common/buffer/watermark_buffer.h"
 
+#include <vector>
+
 #include "common/common/assert.h"
 
 namespace Envoy {
 namespace Buffer {
 
+WatermarkBuffer::~WatermarkBuffer() {
+  // The watermark callbacks are not called, as their owner is likely being destroyed.
+  if (account_ != nullptr) {
+    account_->removeCallbacks(*this);
+    account_->credit(charged_length_);
+  }
+}
+
 void WatermarkBuffer::add(const void* data, uint64_t size) {
-  OwnedImpl::add(data, size);
+  if (shouldSpill(size)) {
+    addSpilling(data, size);
+  } else {
+    OwnedImpl::add(data, size);
+  }
   checkHighWatermark();
 }
 
 void WatermarkBuffer::add(absl::string_view data) {
-  OwnedImpl::add(data);
+  if (shouldSpill(data.size())) {
+    addSpilling(data.data(), data.size());
+  } else {
+    OwnedImpl::add(data);
+  }
   checkHighWatermark();
 }
 
 void WatermarkBuffer::add(const Instance& data) {
-  OwnedImpl::add(data);
+  if (shouldSpill(data.length())) {
+    addSpilling(data, data.length());
+  } else {
+    OwnedImpl::add(data);
+  }
   checkHighWatermark();
 }
 
@@ -41,12 +63,22 @@ void WatermarkBuffer::drain(uint64_t size) {
 }
 
 void WatermarkBuffer::move(Instance& rhs) {
-  OwnedImpl::move(rhs);
+  if (shouldSpill(rhs.length())) {
+    addSpilling(rhs, rhs.length());
+    rhs.drain(rhs.length());
+  } else {
+    OwnedImpl::move(rhs);
+  }
   checkHighWatermark();
 }
 
 void WatermarkBuffer::move(Instance& rhs, uint64_t length) {
-  OwnedImpl::move(rhs, length);
+  if (shouldSpill(length)) {
+    addSpilling(rhs, length);
+    rhs.drain(length);
+  } else {
+    OwnedImpl::move(rhs, length);
+  }
   checkHighWatermark();
 }
 
@@ -68,6 +100,97 @@ Api::IoCallUint64Result WatermarkBuffer::write(Network::IoHandle& io_handle) {
   return result;
 }
 
+void WatermarkBuffer::setSpillToFile(uint64_t threshold, const std::string& directory) {
+  spill_threshold_ = threshold;
+  spill_directory_ = directory;
+}
+
+void WatermarkBuffer::addSpilling(const void* data, uint64_t size) {
+  // The bytes up to the threshold are kept in memory.
+  const uint64_t in_memory = length() >= spill_threshold_
+                                 ? 0
+                                 : std::min<uint64_t>(size, spill_threshold_ - length());
+  if (in_memory > 0) {
+    OwnedImpl::add(data, in_memory);
+  }
+  if (spill_file_ == nullptr) {
+    spill_file_ = SpillFile::create(spill_directory_);
+    if (spill_file_ == nullptr) {
+      // Keep the data in memory from now on rather than trying to create a file for each add.
+      spill_directory_.clear();
+    }
+  }
+  const uint8_t* rest = static_cast<const uint8_t*>(data) + in_memory;
+  uint64_t rest_size = size - in_memory;
+  if (spill_file_ != nullptr) {
+    const uint64_t spilled = spill_file_->append(rest, rest_size, *this);
+    rest += spilled;
+    rest_size -= spilled;
+  }
+  if (rest_size > 0) {
+    OwnedImpl::add(rest, rest_size);
+  }
+}
+
+void WatermarkBuffer::addSpilling(const Instance& data, uint64_t length) {
+  const uint64_t num_slices = data.getRawSlices(nullptr, 0);
+  std::vector<RawSlice> slices(num_slices);
+  data.getRawSlices(slices.data(), num_slices);
+  for (const RawSlice& slice : slices) {
+    if (length == 0) {
+      break;
+    }
+    const uint64_t size = std::min<uint64_t>(slice.len_, length);
+    addSpilling(slice.mem_, size);
+    length -= size;
+  }
+}
+
+void WatermarkBuffer::setMemoryAccount(const MemoryAccountSharedPtr& account) {
+  if (account == account_) {
+    return;
+  }
+  if (account_ != nullptr) {
+    account_->removeCallbacks(*this);
+    account_->credit(charged_length_);
+    charged_length_ = 0;
+    above_budget_ = false;
+  }
+  account_ = account;
+  if (account_ != nullptr) {
+    account_->addCallbacks(*this);
+    above_budget_ = account_->throttled();
+  }
+  checkHighWatermark();
+  checkLowWatermark();
+}
+
+void WatermarkBuffer::onAboveBudget() {
+  above_budget_ = true;
+  checkHighWatermark();
+}
+
+void WatermarkBuffer::onBelowBudget() {
+  above_budget_ = false;
+  checkLowWatermark();
+}
+
+void WatermarkBuffer::updateAccount() {
+  if (account_ == nullptr) {
+    return;
+  }
+  const uint64_t length = OwnedImpl::length();
+  if (length > charged_length_) {
+    const uint64_t size = length - charged_length_;
+    charged_length_ = length;
+    account_->charge(size);
+  } else if (length < charged_length_) {
+    const uint64_t size = charged_length_ - length;
+    charged_length_ = length;
+    account_->credit(size);
+  }
+}
+
 void WatermarkBuffer::setWatermarks(uint32_t low_watermark, uint32_t high_watermark) {
   ASSERT(low_watermark < high_watermark || (high_watermark == 0 && low_watermark == 0));
   low_watermark_ = low_watermark;
@@ -77,7 +200,8 @@ void WatermarkBuffer::setWatermarks(uint32_t low_watermark, uint32_t high_waterm
 }
 
 void WatermarkBuffer::checkLowWatermark() {
-  if (!above_high_watermark_called_ ||
+  updateAccount();
+  if (!above_high_watermark_called_ || above_budget_ ||
       (high_watermark_ != 0 && OwnedImpl::length() > low_watermark_)) {
     return;
   }
@@ -87,8 +211,9 @@ void WatermarkBuffer::checkLowWatermark() {
 }
 
 void WatermarkBuffer::checkHighWatermark() {
-  if (above_high_watermark_called_ || high_watermark_ == 0 ||
-      OwnedImpl::length() <= high_watermark_) {
+  updateAccount();
+  if (above_high_watermark_called_ ||
+      (!above_budget_ && (high_watermark_ == 0 || OwnedImpl::length() <= high_watermark_))) {
     return;
   }
 
@@ -4,6 +4,8 @@
 #include <string>
 
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/memory_account.h"
+#include "common/buffer/spill_file.h"
 
 namespace Envoy {
 namespace Buffer {
@@ -13,11 +15,15 @@ namespace Buffer {
 // buffer size transitions from under the low watermark to above the high watermark, the
 // above_high_watermark function is called one time. It will not be called again until the buffer
 // is drained below the low watermark, at which point the below_low_watermark function is called.
-class WatermarkBuffer : public OwnedImpl {
+//
+// The buffer may also be charged to a memory account, in which case it behaves as if it were above
+// its high watermark while the budget of the worker throttles the account.
+class WatermarkBuffer : public OwnedImpl, public MemoryAccountCallbacks {
 public:
   WatermarkBuffer(std::function<void()> below_low_watermark,
                   std::function<void()> above_high_watermark)
       : below_low_watermark_(below_low_watermark), above_high_watermark_(above_high_watermark) {}
+  ~WatermarkBuffer() override;
 
   // Override all functions from Instance which can result in changing the size
   // of the underlying buffer.
@@ -39,9 +45,40 @@ public:
   void setWatermarks(uint32_t low_watermark, uint32_t high_watermark);
   uint32_t highWatermark() const { return high_watermark_; }
 
+  /**
+   * Move the data added past a threshold to a temporary file rather than keeping it in memory.
+   * The file is created on the first data past the threshold, and the data is kept in memory if it
+   * cannot be created or grown. The spilled data still counts towards the watermarks.
+   * @param threshold supplies the number of bytes kept in memory.
+   * @param directory supplies the directory the temporary file is created in.
+   */
+  void setSpillToFile(uint64_t threshold, const std::string& directory);
+
+  /**
+   * Charge the length of the buffer to a memory account, which may be shared with other buffers.
+   * @param account supplies the account, or nullptr to stop charging the buffer to an account.
+   */
+  void setMemoryAccount(const MemoryAccountSharedPtr& account);
+
+  /**
+   * @return bool whether the memory account of the buffer is throttled, in which case the buffer
+   *         is above its high watermark regardless of its length.
+   */
+  bool aboveBudget() const { return above_budget_; }
+
+  // Buffer::MemoryAccountCallbacks
+  void onAboveBudget() override;
+  void onBelowBudget() override;
+
 private:
   void checkHighWatermark();
   void checkLowWatermark();
+  void updateAccount();
+  bool shouldSpill(uint64_t size) const {
+    return !spill_directory_.empty() && length() + size > spill_threshold_;
+  }
+  void addSpilling(const void* data, uint64_t size);
+  void addSpilling(const Instance& data, uint64_t length);
 
   std::function<void()> below_low_watermark_;
   std::function<void()> above_high_watermark_;
@@ -54,6 +91,17 @@ private:
   // True between the time above_high_watermark_ has been called until above_high_watermark_ has
   // been called.
   bool above_high_watermark_called_{false};
+
+  // Spilling to a file (off by default). Enabled by a call to setSpillToFile().
+  uint64_t spill_threshold_{0};
+  std::string spill_directory_;
+  SpillFilePtr spill_file_;
+
+  // The memory account (none by default), and the length charged to it.
+  MemoryAccountSharedPtr account_;
+  uint64_t charged_length_{0};
+  // True while the account is throttled by the budget of the worker.
+  bool above_budget_{false};
 };
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
@@ -65,6 +113,14 @@ public:
                      std::function<void()> above_high_watermark) override {
     return InstancePtr{new WatermarkBuffer(below_low_watermark, above_high_watermark)};
   }
+  InstancePtr create(std::function<void()> below_low_watermark,
+                     std::function<void()> above_high_watermark,
+                     MemoryClass memory_class) override {
+    auto buffer = std::make_unique<WatermarkBuffer>(below_low_watermark, above_high_watermark);
+    // A new account is never throttled, so this does not call the watermark callbacks.
+    buffer->setMemoryAccount(MemoryAccount::create(memory_class));
+    return buffer;
+  }
 };
 
 } // namespace Buffer
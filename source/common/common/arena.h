@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+// Bump pointer allocator that hands out memory from fixed size blocks and releases everything it
+// handed out at once when it is destroyed. Individual allocations are never freed, so the arena is
+// meant for objects that share the lifetime of a single owner, such as the per-stream state of an
+// HTTP request. Objects placed in the arena must be destroyed before the arena is.
+//
+// Allocations larger than the block size get a dedicated block. The arena is not thread safe.
+class Arena : NonCopyable {
+public:
+  /**
+   * @param block_size the size in bytes of each block requested from the global heap.
+   */
+  explicit Arena(uint32_t block_size) : block_size_(block_size) { ASSERT(block_size > 0); }
+
+  ~Arena() {
+    for (void* block : blocks_) {
+      ::operator delete(block);
+    }
+  }
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @return void* memory aligned to alignof(std::max_align_t). It remains valid until the arena is
+   *         destroyed.
+   */
+  void* allocate(size_t size) {
+    size = roundUp(std::max<size_t>(size, 1));
+    bytes_allocated_ += size;
+    if (size > static_cast<size_t>(cursor_end_ - cursor_)) {
+      if (size > block_size_) {
+        return newBlock(size);
+      }
+      cursor_ = newBlock(block_size_);
+      cursor_end_ = cursor_ + block_size_;
+    }
+    char* memory = cursor_;
+    cursor_ += size;
+    return memory;
+  }
+
+  /**
+   * @return uint64_t the number of bytes handed out by allocate(), including alignment padding.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return uint64_t the number of bytes requested from the global heap.
+   */
+  uint64_t bytesReserved() const { return bytes_reserved_; }
+
+private:
+  static size_t roundUp(size_t size) {
+    constexpr size_t alignment = alignof(std::max_align_t);
+    return (size + alignment - 1) & ~(alignment - 1);
+  }
+
+  char* newBlock(size_t size) {
+    char* block = static_cast<char*>(::operator new(size));
+    blocks_.push_back(block);
+    bytes_reserved_ += size;
+    return block;
+  }
+
+  const size_t block_size_;
+  char* cursor_{};
+  char* cursor_end_{};
+  uint64_t bytes_allocated_{};
+  uint64_t bytes_reserved_{};
+  std::vector<void*> blocks_;
+};
+
+using ArenaPtr = std::unique_ptr<Arena>;
+
+} // namespace Envoy
@@ -1,6 +1,8 @@
 #include "common/common/base64.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "common/common/empty_string.h"
@@ -138,6 +140,84 @@ inline void encodeLast(uint64_t pos, uint8_t last_char, std::string& ret,
   }
 }
 
+// Encodes a group of 3 bytes into 4 characters.
+inline void encodeGroup(const uint8_t* group, uint8_t* out) {
+  const uint32_t bits = (static_cast<uint32_t>(group[0]) << 16) |
+                        (static_cast<uint32_t>(group[1]) << 8) | static_cast<uint32_t>(group[2]);
+  out[0] = CHAR_TABLE[bits >> 18];
+  out[1] = CHAR_TABLE[(bits >> 12) & 0x3f];
+  out[2] = CHAR_TABLE[(bits >> 6) & 0x3f];
+  out[3] = CHAR_TABLE[bits & 0x3f];
+}
+
+// Encodes the last 1 or 2 bytes of an encoding into the characters they take, followed by padding
+// if add_padding is set. Returns the number of characters.
+inline uint64_t encodeTail(const uint8_t* tail, uint64_t size, uint8_t* out, bool add_padding) {
+  ASSERT(size > 0 && size < 3);
+  uint8_t group[3] = {0, 0, 0};
+  memcpy(group, tail, size);
+  encodeGroup(group, out);
+  // A single byte takes 2 characters and 2 bytes take 3, the rest being padding.
+  if (!add_padding) {
+    return size + 1;
+  }
+  for (uint64_t i = size + 1; i < 4; ++i) {
+    out[i] = '=';
+  }
+  return 4;
+}
+
+// Decodes a group of 4 characters without padding into 3 bytes. Returns false if the group isn't
+// valid.
+inline bool decodeFullGroup(const uint8_t* group, uint8_t* out) {
+  const uint32_t c0 = REVERSE_LOOKUP_TABLE[group[0]];
+  const uint32_t c1 = REVERSE_LOOKUP_TABLE[group[1]];
+  const uint32_t c2 = REVERSE_LOOKUP_TABLE[group[2]];
+  const uint32_t c3 = REVERSE_LOOKUP_TABLE[group[3]];
+  // Invalid characters are looked up as 64, the only value with that bit set, so that a single
+  // test covers the whole group.
+  if (((c0 | c1 | c2 | c3) & 64) != 0) {
+    return false;
+  }
+  const uint32_t bits = (c0 << 18) | (c1 << 12) | (c2 << 6) | c3;
+  out[0] = bits >> 16;
+  out[1] = bits >> 8;
+  out[2] = bits;
+  return true;
+}
+
+// Decodes the last 2 or 3 characters of an encoding without padding into the bytes they encode.
+// Returns the number of bytes, or -1 if the characters aren't valid.
+inline int decodeTail(const uint8_t* tail, uint64_t size, uint8_t* out) {
+  if (size < 2) {
+    return -1;
+  }
+  const uint32_t c0 = REVERSE_LOOKUP_TABLE[tail[0]];
+  const uint32_t c1 = REVERSE_LOOKUP_TABLE[tail[1]];
+  if (c0 == 64 || c1 == 64) {
+    return -1;
+  }
+  out[0] = (c0 << 2) | (c1 >> 4);
+  if (size == 2) {
+    return (c1 & 0b1111) == 0 ? 1 : -1;
+  }
+  const uint32_t c2 = REVERSE_LOOKUP_TABLE[tail[2]];
+  if (c2 == 64 || (c2 & 0b11) != 0) {
+    return -1;
+  }
+  out[1] = ((c1 & 0b1111) << 4) | (c2 >> 2);
+  return 2;
+}
+
+// Decodes a group of 4 characters, the last two of which may be padding, into the bytes they
+// encode. Returns the number of bytes, or -1 if the group isn't valid.
+inline int decodeGroup(const uint8_t* group, uint8_t* out) {
+  if (group[3] != '=') {
+    return decodeFullGroup(group, out) ? 3 : -1;
+  }
+  return decodeTail(group, group[2] == '=' ? 2 : 3, out);
+}
+
 } // namespace
 
 std::string Base64::decode(const std::string& input) {
@@ -148,69 +228,85 @@ std::string Base64::decode(const std::string& input) {
 }
 
 std::string Base64::decodeWithoutPadding(absl::string_view input) {
-  if (input.empty()) {
-    return EMPTY_STRING;
-  }
-
   // At most last two chars can be '='.
   size_t n = input.length();
-  if (input[n - 1] == '=') {
+  if (n > 0 && input[n - 1] == '=') {
     n--;
     if (n > 0 && input[n - 1] == '=') {
       n--;
     }
   }
-  // Last position before "valid" padding character.
-  uint64_t last = n - 1;
-  // Determine output length.
-  size_t max_length = (n + 3) / 4 * 3;
-  if (n % 4 == 3) {
-    max_length -= 1;
-  }
-  if (n % 4 == 2) {
-    max_length -= 2;
+  if (n == 0) {
+    return EMPTY_STRING;
   }
 
+  // The output is written in place, a whole group at a time, rather than a character at a time.
   std::string ret;
-  ret.reserve(max_length);
-  for (uint64_t i = 0; i < last; ++i) {
-    if (!decodeBase(input[i], i, ret, REVERSE_LOOKUP_TABLE)) {
+  ret.resize(n / 4 * 3 + 2);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+  const uint8_t* const end = data + n / 4 * 4;
+  uint8_t* const begin = reinterpret_cast<uint8_t*>(&ret[0]);
+  uint8_t* out = begin;
+  for (; data != end; data += 4, out += 3) {
+    if (!decodeFullGroup(data, out)) {
       return EMPTY_STRING;
     }
   }
-
-  if (!decodeLast(input[last], last, ret, REVERSE_LOOKUP_TABLE)) {
-    return EMPTY_STRING;
+  if (n % 4 != 0) {
+    const int decoded = decodeTail(data, n % 4, out);
+    if (decoded < 0) {
+      return EMPTY_STRING;
+    }
+    out += decoded;
   }
 
-  ASSERT(ret.size() == max_length);
+  ret.resize(out - begin);
   return ret;
 }
 
 std::string Base64::encode(const Buffer::Instance& buffer, uint64_t length) {
-  uint64_t output_length = (std::min(length, buffer.length()) + 2) / 3 * 4;
+  length = std::min(length, buffer.length());
   std::string ret;
-  ret.reserve(output_length);
+  ret.resize((length + 2) / 3 * 4);
+  uint8_t* out = reinterpret_cast<uint8_t*>(&ret[0]);
 
   uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
   STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
   buffer.getRawSlices(slices.begin(), num_slices);
 
-  uint64_t j = 0;
-  uint8_t next_c = 0;
+  // The groups within a slice are encoded in place, while a group straddling two slices is
+  // gathered first.
+  uint8_t pending[3];
+  uint64_t pending_size = 0;
   for (const Buffer::RawSlice& slice : slices) {
-    const uint8_t* slice_mem = static_cast<const uint8_t*>(slice.mem_);
-
-    for (uint64_t i = 0; i < slice.len_ && j < length; ++i, ++j) {
-      encodeBase(slice_mem[i], j, next_c, ret, CHAR_TABLE);
-    }
-
-    if (j == length) {
+    if (length == 0) {
       break;
     }
+    const uint8_t* data = static_cast<const uint8_t*>(slice.mem_);
+    uint64_t slice_length = std::min<uint64_t>(slice.len_, length);
+    length -= slice_length;
+    if (pending_size > 0) {
+      const uint64_t taken = std::min<uint64_t>(3 - pending_size, slice_length);
+      memcpy(pending + pending_size, data, taken);
+      pending_size += taken;
+      data += taken;
+      slice_length -= taken;
+      if (pending_size < 3) {
+        continue;
+      }
+      encodeGroup(pending, out);
+      out += 4;
+    }
+    const uint8_t* const end = data + slice_length / 3 * 3;
+    for (; data != end; data += 3, out += 4) {
+      encodeGroup(data, out);
+    }
+    pending_size = slice_length % 3;
+    memcpy(pending, data, pending_size);
+  }
+  if (pending_size > 0) {
+    encodeTail(pending, pending_size, out, true);
   }
-
-  encodeLast(j, next_c, ret, CHAR_TABLE, true);
 
   return ret;
 }
@@ -220,20 +316,122 @@ std::string Base64::encode(const char* input, uint64_t length) {
 }
 
 std::string Base64::encode(const char* input, uint64_t length, bool add_padding) {
-  uint64_t output_length = (length + 2) / 3 * 4;
+  // The output is written in place, a whole group at a time, rather than a character at a time.
   std::string ret;
-  ret.reserve(output_length);
+  ret.resize((length + 2) / 3 * 4);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(input);
+  const uint8_t* const end = data + length / 3 * 3;
+  uint8_t* out = reinterpret_cast<uint8_t*>(&ret[0]);
+  for (; data != end; data += 3, out += 4) {
+    encodeGroup(data, out);
+  }
+  if (length % 3 != 0) {
+    ret.resize(ret.size() - 4 + encodeTail(data, length % 3, out, add_padding));
+  }
 
-  uint64_t pos = 0;
-  uint8_t next_c = 0;
+  return ret;
+}
 
-  for (uint64_t i = 0; i < length; ++i) {
-    encodeBase(input[i], pos++, next_c, ret, CHAR_TABLE);
+void Base64StreamEncoder::encode(const uint8_t* data, uint64_t length, Buffer::Instance& output) {
+  if (pending_size_ + length < 3) {
+    memcpy(pending_ + pending_size_, data, length);
+    pending_size_ += length;
+    return;
   }
 
-  encodeLast(pos, next_c, ret, CHAR_TABLE, add_padding);
+  // The output is written in place, in a single reservation.
+  Buffer::RawSlice iovec;
+  output.reserve((pending_size_ + length) / 3 * 4, &iovec, 1);
+  uint8_t* out = static_cast<uint8_t*>(iovec.mem_);
+  if (pending_size_ > 0) {
+    uint8_t group[3];
+    memcpy(group, pending_, pending_size_);
+    const uint64_t taken = 3 - pending_size_;
+    memcpy(group + pending_size_, data, taken);
+    encodeGroup(group, out);
+    out += 4;
+    data += taken;
+    length -= taken;
+  }
+  const uint8_t* const end = data + length / 3 * 3;
+  for (; data != end; data += 3, out += 4) {
+    encodeGroup(data, out);
+  }
+  pending_size_ = length % 3;
+  memcpy(pending_, data, pending_size_);
+  iovec.len_ = out - static_cast<uint8_t*>(iovec.mem_);
+  output.commit(&iovec, 1);
+}
 
-  return ret;
+void Base64StreamEncoder::flush(Buffer::Instance& output) {
+  if (pending_size_ == 0) {
+    return;
+  }
+  uint8_t out[4];
+  output.add(out, encodeTail(pending_, pending_size_, out, true));
+  pending_size_ = 0;
+}
+
+bool Base64StreamDecoder::decode(const Buffer::Instance& input, Buffer::Instance& output) {
+  const uint64_t max_length = (pending_size_ + input.length()) / 4 * 3;
+  if (max_length == 0) {
+    uint64_t num_slices = input.getRawSlices(nullptr, 0);
+    STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+    input.getRawSlices(slices.begin(), num_slices);
+    for (const Buffer::RawSlice& slice : slices) {
+      memcpy(pending_ + pending_size_, slice.mem_, slice.len_);
+      pending_size_ += slice.len_;
+    }
+    return true;
+  }
+
+  // The output is written in place, in a single reservation.
+  Buffer::RawSlice iovec;
+  output.reserve(max_length, &iovec, 1);
+  uint8_t* out = static_cast<uint8_t*>(iovec.mem_);
+  uint64_t num_slices = input.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  input.getRawSlices(slices.begin(), num_slices);
+  bool valid = true;
+  for (const Buffer::RawSlice& slice : slices) {
+    const uint8_t* data = static_cast<const uint8_t*>(slice.mem_);
+    uint64_t length = slice.len_;
+    if (pending_size_ > 0) {
+      const uint64_t taken = std::min<uint64_t>(4 - pending_size_, length);
+      memcpy(pending_ + pending_size_, data, taken);
+      pending_size_ += taken;
+      data += taken;
+      length -= taken;
+      if (pending_size_ < 4) {
+        continue;
+      }
+      const int decoded = decodeGroup(pending_, out);
+      pending_size_ = 0;
+      if (decoded < 0) {
+        valid = false;
+        break;
+      }
+      out += decoded;
+    }
+    const uint8_t* const end = data + length / 4 * 4;
+    for (; data != end; data += 4) {
+      const int decoded = decodeGroup(data, out);
+      if (decoded < 0) {
+        valid = false;
+        break;
+      }
+      out += decoded;
+    }
+    if (!valid) {
+      break;
+    }
+    pending_size_ = length % 4;
+    memcpy(pending_, data, pending_size_);
+  }
+
+  iovec.len_ = out - static_cast<uint8_t*>(iovec.mem_);
+  output.commit(&iovec, 1);
+  return valid;
 }
 
 std::string Base64Url::decode(const std::string& input) {
@@ -56,6 +56,59 @@ public:
   static std::string decodeWithoutPadding(absl::string_view input);
 };
 
+/**
+ * A base64 encoder of a stream of bytes, which encodes the bytes as they come: every complete
+ * group of 3 bytes is encoded right away, while the bytes of an incomplete group are kept until
+ * more bytes come or the encoder is flushed.
+ */
+class Base64StreamEncoder {
+public:
+  /**
+   * Encode bytes of the stream.
+   * @param data supplies the bytes to encode.
+   * @param length supplies the number of bytes.
+   * @param output supplies the buffer the encoded groups are appended to.
+   */
+  void encode(const uint8_t* data, uint64_t length, Buffer::Instance& output);
+
+  /**
+   * Encode the bytes kept, with padding, ending the current encoding. Bytes encoded afterwards
+   * start a new encoding, which the base64 decoders of padded chunks accept.
+   * @param output supplies the buffer the encoded group is appended to.
+   */
+  void flush(Buffer::Instance& output);
+
+private:
+  uint8_t pending_[2];
+  uint64_t pending_size_{};
+};
+
+/**
+ * A base64 decoder of a stream of text, which decodes the text as it comes: every complete group
+ * of 4 characters is decoded right away, while the characters of an incomplete group are kept until
+ * more characters come. Every group may be padded, so that the text may be made of several padded
+ * encodings.
+ */
+class Base64StreamDecoder {
+public:
+  /**
+   * Decode text of the stream.
+   * @param input supplies the text to decode, which is not drained.
+   * @param output supplies the buffer the decoded bytes are appended to.
+   * @return bool false if the text is not valid base64.
+   */
+  bool decode(const Buffer::Instance& input, Buffer::Instance& output);
+
+  /**
+   * @return uint64_t the number of characters kept, of the current incomplete group.
+   */
+  uint64_t pending() const { return pending_size_; }
+
+private:
+  uint8_t pending_[4];
+  uint64_t pending_size_{};
+};
+
 /**
  * A utility class to support base64url encoding, which is defined in RFC4648 Section 5.
  * See https://tools.ietf.org/html/rfc4648#section-5
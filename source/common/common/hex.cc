@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -11,35 +12,60 @@
 #include "common/common/utility.h"
 
 namespace Envoy {
+namespace {
+
+// The value of each hex digit, lowercase or uppercase, and 16 for every other character.
+struct HexDigitTable {
+  HexDigitTable() {
+    memset(values_, 16, sizeof(values_));
+    for (uint8_t i = 0; i < 10; i++) {
+      values_['0' + i] = i;
+    }
+    for (uint8_t i = 0; i < 6; i++) {
+      values_['a' + i] = 10 + i;
+      values_['A' + i] = 10 + i;
+    }
+  }
+
+  uint8_t values_[256];
+};
+
+} // namespace
+
 std::string Hex::encode(const uint8_t* data, size_t length) {
   static const char* const digits = "0123456789abcdef";
 
+  // The output is written in place rather than appended a digit at a time.
   std::string ret;
-  ret.reserve(length * 2);
+  ret.resize(length * 2);
+  char* out = &ret[0];
 
   for (size_t i = 0; i < length; i++) {
     uint8_t d = data[i];
-    ret.push_back(digits[d >> 4]);
-    ret.push_back(digits[d & 0xf]);
+    out[2 * i] = digits[d >> 4];
+    out[2 * i + 1] = digits[d & 0xf];
   }
 
   return ret;
 }
 
 std::vector<uint8_t> Hex::decode(const std::string& hex_string) {
+  static const HexDigitTable table;
+
   if (hex_string.empty() || hex_string.size() % 2 != 0) {
     return {};
   }
 
-  std::vector<uint8_t> segment;
-  for (size_t i = 0; i < hex_string.size(); i += 2) {
-    std::string hex_byte = hex_string.substr(i, 2);
-    uint64_t out;
-    if (!StringUtil::atoull(hex_byte.c_str(), out, 16)) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(hex_string.data());
+  std::vector<uint8_t> segment(hex_string.size() / 2);
+  for (size_t i = 0; i < segment.size(); i++) {
+    const uint8_t high = table.values_[data[2 * i]];
+    const uint8_t low = table.values_[data[2 * i + 1]];
+    // Non digits are looked up as 16, the only value with that bit set.
+    if (((high | low) & 16) != 0) {
       return {};
     }
-
-    segment.push_back(out);
+    segment[i] = (high << 4) | low;
   }
 
   return segment;
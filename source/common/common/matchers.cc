@@ -98,6 +98,74 @@ bool StringMatcherImpl::match(const absl::string_view value) const {
   }
 }
 
+StringMatcherListImpl::StringMatcherListImpl(
+    const Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher>& matchers) {
+  std::vector<absl::string_view> regexes;
+  for (const auto& matcher : matchers) {
+    if (matcher.match_pattern_case() ==
+        envoy::type::matcher::v3alpha::StringMatcher::MatchPatternCase::kExact) {
+      exact_.insert(matcher.exact());
+    } else if (matcher.match_pattern_case() ==
+                   envoy::type::matcher::v3alpha::StringMatcher::MatchPatternCase::kSafeRegex &&
+               matcher.safe_regex().has_google_re2()) {
+      // The regex is compiled on its own first, which validates it and its program size.
+      regexes_.push_back(Regex::Utility::parseRegex(matcher.safe_regex()));
+      regexes.push_back(matcher.safe_regex().regex());
+    } else {
+      matchers_.push_back(std::make_unique<StringMatcherImpl>(matcher));
+    }
+  }
+
+  if (regexes.empty()) {
+    return;
+  }
+  re2::RE2::Options options;
+  options.set_log_errors(false);
+  regex_set_ = std::make_unique<re2::RE2::Set>(options, re2::RE2::ANCHOR_BOTH);
+  for (const absl::string_view regex : regexes) {
+    // Not expected to fail once the regex compiled on its own. Without a set, e.g. if it also ran
+    // out of memory, the regexes are still correctly evaluated one by one.
+    if (regex_set_->Add(re2::StringPiece(regex.data(), regex.size()), nullptr) < 0) {
+      regex_set_.reset();
+      return;
+    }
+  }
+  if (!regex_set_->Compile()) {
+    regex_set_.reset();
+  }
+}
+
+bool StringMatcherListImpl::match(const absl::string_view value) const {
+  if (exact_.contains(value) || (!regexes_.empty() && matchRegexes(value))) {
+    return true;
+  }
+  for (const auto& matcher : matchers_) {
+    if (matcher->match(value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StringMatcherListImpl::matchRegexes(const absl::string_view value) const {
+  if (regex_set_ != nullptr) {
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regex_set_->Match(re2::StringPiece(value.data(), value.size()), nullptr, &error_info)) {
+      return true;
+    }
+    if (error_info.kind == re2::RE2::Set::kNoError) {
+      return false;
+    }
+    // The match failed, e.g. as the DFA ran out of memory, so the regexes are evaluated one by one.
+  }
+  for (const auto& regex : regexes_) {
+    if (regex->match(value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool LowerCaseStringMatcher::match(const absl::string_view value) const {
   return matcher_.match(value);
 }
@@ -13,6 +13,10 @@
 #include "common/common/utility.h"
 #include "common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_set.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+
 namespace Envoy {
 namespace Matchers {
 
@@ -103,6 +107,31 @@ private:
 
 using LowerCaseStringMatcherPtr = std::unique_ptr<LowerCaseStringMatcher>;
 
+/**
+ * Matches a string if any of a list of string matchers does. The exact matchers are looked up in a
+ * hash set and the RE2 regex matchers are matched together by a single RE2::Set, so that only the
+ * other matchers are evaluated one by one.
+ */
+class StringMatcherListImpl : public StringMatcher {
+public:
+  explicit StringMatcherListImpl(
+      const Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher>& matchers);
+
+  // Matchers::StringMatcher
+  bool match(const absl::string_view value) const override;
+
+  bool empty() const { return exact_.empty() && regexes_.empty() && matchers_.empty(); }
+
+private:
+  bool matchRegexes(const absl::string_view value) const;
+
+  absl::flat_hash_set<std::string> exact_;
+  // The RE2 regex matchers, only evaluated one by one if the set cannot match them.
+  std::vector<Regex::CompiledMatcherPtr> regexes_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  std::vector<StringMatcherPtr> matchers_;
+};
+
 class ListMatcher : public ValueMatcher {
 public:
   ListMatcher(const envoy::type::matcher::v3alpha::ListMatcher& matcher);
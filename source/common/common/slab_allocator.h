@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+// Pool of fixed size memory blocks carved out of geometrically growing slabs. Freed blocks are
+// kept on an intrusive free list and reused by subsequent allocations; slab memory is only returned
+// to the system when the pool is destroyed.
+//
+// The pool is intended to back node based containers (e.g. std::list) that are owned by a single
+// short-lived object, such as a header map, so that populating the container does not pay one heap
+// allocation per element and the elements end up close to each other in memory. The block size is
+// latched on the first allocation; requests for a different size fall back to the global heap.
+//
+// The pool is not thread safe.
+class SlabPool : NonCopyable {
+public:
+  /**
+   * @param initial_slab_blocks the number of blocks in the first slab. Every subsequent slab
+   *        doubles in size until max_slab_blocks is reached.
+   * @param max_slab_blocks the maximum number of blocks in a single slab.
+   */
+  explicit SlabPool(uint32_t initial_slab_blocks = 4, uint32_t max_slab_blocks = 64)
+      : next_slab_blocks_(initial_slab_blocks), max_slab_blocks_(max_slab_blocks) {
+    ASSERT(initial_slab_blocks > 0 && initial_slab_blocks <= max_slab_blocks);
+  }
+
+  ~SlabPool() {
+    for (void* slab : slabs_) {
+      ::operator delete(slab);
+    }
+  }
+
+  /**
+   * Allocate a block of memory.
+   * @param size supplies the requested size in bytes.
+   * @return void* a block of at least size bytes aligned to alignof(std::max_align_t).
+   */
+  void* allocate(size_t size) {
+    if (block_size_ == 0) {
+      block_size_ = roundUp(std::max(size, sizeof(FreeBlock)));
+    }
+    if (roundUp(std::max(size, sizeof(FreeBlock))) != block_size_) {
+      return ::operator new(size);
+    }
+
+    if (free_list_ != nullptr) {
+      FreeBlock* block = free_list_;
+      free_list_ = block->next_;
+      return block;
+    }
+
+    if (slab_cursor_ == slab_end_) {
+      newSlab();
+    }
+    void* block = slab_cursor_;
+    slab_cursor_ += block_size_;
+    return block;
+  }
+
+  /**
+   * Release a block previously returned by allocate().
+   * @param block supplies the block to release.
+   * @param size supplies the size that was passed to allocate().
+   */
+  void deallocate(void* block, size_t size) {
+    if (roundUp(std::max(size, sizeof(FreeBlock))) != block_size_) {
+      ::operator delete(block);
+      return;
+    }
+    FreeBlock* free_block = static_cast<FreeBlock*>(block);
+    free_block->next_ = free_list_;
+    free_list_ = free_block;
+  }
+
+  /**
+   * @return uint64_t the number of bytes held in slabs, whether or not they are in use.
+   */
+  uint64_t bytesReserved() const { return bytes_reserved_; }
+
+  /**
+   * @return size_t the number of slabs allocated from the global heap.
+   */
+  size_t slabCount() const { return slabs_.size(); }
+
+private:
+  struct FreeBlock {
+    FreeBlock* next_;
+  };
+
+  static size_t roundUp(size_t size) {
+    constexpr size_t alignment = alignof(std::max_align_t);
+    return (size + alignment - 1) & ~(alignment - 1);
+  }
+
+  void newSlab() {
+    const size_t slab_bytes = static_cast<size_t>(next_slab_blocks_) * block_size_;
+    char* slab = static_cast<char*>(::operator new(slab_bytes));
+    slabs_.push_back(slab);
+    bytes_reserved_ += slab_bytes;
+    slab_cursor_ = slab;
+    slab_end_ = slab + slab_bytes;
+    next_slab_blocks_ = std::min(next_slab_blocks_ * 2, max_slab_blocks_);
+  }
+
+  size_t block_size_{};
+  uint32_t next_slab_blocks_;
+  const uint32_t max_slab_blocks_;
+  FreeBlock* free_list_{};
+  char* slab_cursor_{};
+  char* slab_end_{};
+  uint64_t bytes_reserved_{};
+  std::vector<void*> slabs_;
+};
+
+// Standard library compatible allocator that carves single objects out of a SlabPool. Requests
+// for more than one object at a time are served by the global heap. All copies (including rebound
+// copies) share the pool, which must outlive every container using the allocator.
+template <class T> class SlabAllocator {
+public:
+  using value_type = T;
+
+  explicit SlabAllocator(SlabPool& pool) : pool_(&pool) {}
+  template <class U> SlabAllocator(const SlabAllocator<U>& other) : pool_(other.pool_) {}
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(pool_->allocate(sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      ::operator delete(p);
+      return;
+    }
+    pool_->deallocate(p, sizeof(T));
+  }
+
+  template <class U> bool operator==(const SlabAllocator<U>& rhs) const {
+    return pool_ == rhs.pool_;
+  }
+  template <class U> bool operator!=(const SlabAllocator<U>& rhs) const {
+    return pool_ != rhs.pool_;
+  }
+
+private:
+  template <class U> friend class SlabAllocator;
+
+  SlabPool* pool_;
+};
+
+} // namespace Envoy
@@ -0,0 +1,71 @@
+#include "common/common/time_cache.h"
+
+#include <cstring>
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "absl/time/time.h"
+
+namespace Envoy {
+
+TimeCache& TimeCache::get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(TimeCache); }
+
+void TimeCache::update(SystemTime time) {
+  static const char* const FormatStrings[NumFormats] = {"%a, %d %b %Y %H:%M:%S GMT",
+                                                        "%Y-%m-%dT%H:%M:%S.000Z"};
+
+  const std::chrono::seconds epoch_time_seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch());
+  Thread::LockGuard lock(update_lock_);
+  if (epoch_time_seconds_ == epoch_time_seconds.count()) {
+    return;
+  }
+  epoch_time_seconds_ = epoch_time_seconds.count();
+
+  Entry entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.epoch_time_seconds_ = epoch_time_seconds.count();
+  const absl::Time second = absl::FromUnixSeconds(epoch_time_seconds.count());
+  for (size_t i = 0; i < NumFormats; i++) {
+    const std::string formatted = absl::FormatTime(FormatStrings[i], second, absl::UTCTimeZone());
+    ASSERT(formatted.size() < MaxFormattedSize);
+    entry.lengths_[i] = formatted.size();
+    memcpy(entry.formatted_[i], formatted.data(), formatted.size());
+  }
+  uint64_t words[NumWords];
+  memcpy(words, &entry, sizeof(entry));
+
+  const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < NumWords; i++) {
+    words_[i].store(words[i], std::memory_order_relaxed);
+  }
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+absl::string_view TimeCache::read(std::chrono::seconds epoch_time_seconds, Format format,
+                                  Buffer& buffer) const {
+  uint64_t words[NumWords];
+  uint64_t sequence;
+  do {
+    sequence = sequence_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < NumWords; i++) {
+      words[i] = words_[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((sequence & 1) != 0 || sequence != sequence_.load(std::memory_order_relaxed));
+
+  Entry entry;
+  memcpy(&entry, words, sizeof(entry));
+  if (entry.epoch_time_seconds_ != epoch_time_seconds.count()) {
+    return {};
+  }
+  const size_t index = static_cast<size_t>(format);
+  memcpy(buffer.data(), entry.formatted_[index], entry.lengths_[index]);
+  return {buffer.data(), entry.lengths_[index]};
+}
+
+} // namespace Envoy
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+
+#include "common/common/lock_guard.h"
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * A process wide cache of a second formatted in the formats used on hot paths, so that the threads
+ * needing the current time formatted copy it rather than each formatting it. The cache is updated
+ * by a single thread at a time, about once a second, and read by any thread without a lock: it is
+ * published with a sequence lock, whose sequence is odd while an update is in progress, and a
+ * reader copies the cache again if the sequence was odd or changed while it copied it.
+ */
+class TimeCache : NonCopyable {
+public:
+  enum class Format {
+    // As in the HTTP Date header, e.g. "Wed, 23 Jan 2019 04:00:00 GMT".
+    Rfc1123,
+    // As in the access logs, with no milliseconds, e.g. "2019-01-23T04:00:00.000Z".
+    Iso8601,
+  };
+
+  // Room for the second formatted in the longest format.
+  static constexpr size_t MaxFormattedSize = 32;
+  using Buffer = std::array<char, MaxFormattedSize>;
+
+  /**
+   * @return TimeCache& the cache of the process.
+   */
+  static TimeCache& get();
+
+  /**
+   * Update the cache to the second of a time, if it isn't already the cached second.
+   * @param time supplies the time.
+   */
+  void update(SystemTime time);
+
+  /**
+   * Copy a second formatted in a format, if it is the cached second.
+   * @param epoch_time_seconds supplies the second since the epoch.
+   * @param format supplies the format.
+   * @param buffer supplies the buffer the formatted second is copied to.
+   * @return absl::string_view the formatted second in the buffer, which is empty if the second
+   *         isn't the cached one.
+   */
+  absl::string_view read(std::chrono::seconds epoch_time_seconds, Format format,
+                         Buffer& buffer) const;
+
+private:
+  static constexpr size_t NumFormats = 2;
+
+  struct Entry {
+    int64_t epoch_time_seconds_;
+    uint8_t lengths_[sizeof(uint64_t)];
+    char formatted_[NumFormats][MaxFormattedSize];
+  };
+  static_assert(sizeof(Entry) % sizeof(uint64_t) == 0, "Entry must be made of whole words");
+  static constexpr size_t NumWords = sizeof(Entry) / sizeof(uint64_t);
+
+  TimeCache() = default;
+
+  // The entry is stored as atomic words, so that a reader copying it while it is updated doesn't
+  // race with the update, and then discards the copy as the sequence changed.
+  std::atomic<uint64_t> sequence_{0};
+  std::array<std::atomic<uint64_t>, NumWords> words_{};
+  Thread::MutexBasicLockable update_lock_;
+  int64_t epoch_time_seconds_ ABSL_GUARDED_BY(update_lock_){0};
+};
+
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/hash.h"
+#include "common/common/time_cache.h"
 #include "common/singleton/const_singleton.h"
 
 #include "absl/strings/ascii.h"
@@ -404,7 +405,15 @@ std::string StringUtil::escape(const std::string& source) {
   return ret;
 }
 
-std::string AccessLogDateTimeFormatter::fromTime(const SystemTime& system_time) {
+std::string AccessLogDateTimeFormatter::fromTime(const SystemTime& time) {
+  return cachedFromTime(time);
+}
+
+void AccessLogDateTimeFormatter::appendTime(const SystemTime& time, std::string& output) {
+  output += cachedFromTime(time);
+}
+
+const std::string& AccessLogDateTimeFormatter::cachedFromTime(const SystemTime& system_time) {
   static const std::string DefaultDateFormat = "%Y-%m-%dT%H:%M:%E3SZ";
 
   struct CachedTime {
@@ -420,22 +429,30 @@ std::string AccessLogDateTimeFormatter::fromTime(const SystemTime& system_time)
       std::chrono::duration_cast<std::chrono::seconds>(epoch_time_ms);
 
   if (cached_time.formatted_time.empty() || cached_time.epoch_time_seconds != epoch_time_seconds) {
-    cached_time.formatted_time =
-        absl::FormatTime(DefaultDateFormat, absl::FromChrono(system_time), absl::UTCTimeZone());
+    // The second is usually the current one, formatted once for the process in the time cache.
+    TimeCache::Buffer buffer;
+    const absl::string_view formatted =
+        TimeCache::get().read(epoch_time_seconds, TimeCache::Format::Iso8601, buffer);
+    if (!formatted.empty()) {
+      cached_time.formatted_time.assign(formatted.data(), formatted.size());
+    } else {
+      cached_time.formatted_time =
+          absl::FormatTime(DefaultDateFormat, absl::FromChrono(system_time), absl::UTCTimeZone());
+    }
     cached_time.epoch_time_seconds = epoch_time_seconds;
-  } else {
-    // Overwrite the digits in the ".000Z" at the end of the string with the
-    // millisecond count from the input time.
-    ASSERT(cached_time.formatted_time.length() == 24);
-    size_t offset = cached_time.formatted_time.length() - 4;
-    uint32_t msec = epoch_time_ms.count() % 1000;
-    cached_time.formatted_time[offset++] = ('0' + (msec / 100));
-    msec %= 100;
-    cached_time.formatted_time[offset++] = ('0' + (msec / 10));
-    msec %= 10;
-    cached_time.formatted_time[offset++] = ('0' + msec);
   }
 
+  // Overwrite the digits in the ".000Z" at the end of the string with the
+  // millisecond count from the input time.
+  ASSERT(cached_time.formatted_time.length() == 24);
+  size_t offset = cached_time.formatted_time.length() - 4;
+  uint32_t msec = epoch_time_ms.count() % 1000;
+  cached_time.formatted_time[offset++] = ('0' + (msec / 100));
+  msec %= 100;
+  cached_time.formatted_time[offset++] = ('0' + (msec / 10));
+  msec %= 10;
+  cached_time.formatted_time[offset++] = ('0' + msec);
+
   return cached_time.formatted_time;
 }
 
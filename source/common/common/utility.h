@@ -91,6 +91,15 @@ private:
 class AccessLogDateTimeFormatter {
 public:
   static std::string fromTime(const SystemTime& time);
+
+  /**
+   * Append the time as returned by fromTime() to the output, without a temporary string.
+   */
+  static void appendTime(const SystemTime& time, std::string& output);
+
+private:
+  // @return the time formatted in a cache of the calling thread, valid until its next call.
+  static const std::string& cachedFromTime(const SystemTime& time);
 };
 
 /**
@@ -34,6 +34,14 @@ void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy c
   initialized_ = true;
 }
 
+void ZlibCompressorImpl::reset() {
+  ASSERT(initialized_);
+  const int result = deflateReset(zstream_ptr_.get());
+  RELEASE_ASSERT(result == Z_OK, "");
+  zstream_ptr_->avail_out = chunk_size_;
+  zstream_ptr_->next_out = chunk_char_ptr_.get();
+}
+
 uint64_t ZlibCompressorImpl::checksum() { return zstream_ptr_->adler; }
 
 void ZlibCompressorImpl::compress(Buffer::Instance& buffer, State state) {
@@ -91,7 +99,7 @@ void ZlibCompressorImpl::updateOutput(Buffer::Instance& output_buffer) {
   if (n_output > 0) {
     output_buffer.add(static_cast<void*>(chunk_char_ptr_.get()), n_output);
   }
-  chunk_char_ptr_ = std::make_unique<unsigned char[]>(chunk_size_);
+  // The output has been copied to the buffer, so the chunk is reused rather than reallocated.
   zstream_ptr_->avail_out = chunk_size_;
   zstream_ptr_->next_out = chunk_char_ptr_.get();
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <memory>
+
 #include "envoy/compressor/compressor.h"
 
 #include "zlib.h"
@@ -64,6 +67,13 @@ public:
   void init(CompressionLevel level, CompressionStrategy strategy, int64_t window_bits,
             uint64_t memory_level);
 
+  /**
+   * Reset the compressor, so that it compresses a new stream with the parameters it has been
+   * initialized with. Unlike a new compressor, it reuses the memory allocated by init(), which
+   * saves allocating and clearing the zlib window and hash tables for each stream.
+   */
+  void reset();
+
   /**
    * It returns the checksum of all output produced so far. Compressor's checksum at the end of the
    * stream has to match decompressor's checksum produced at the end of the decompression.
@@ -87,5 +97,7 @@ private:
   std::unique_ptr<z_stream, std::function<void(z_stream*)>> zstream_ptr_;
 };
 
+using ZlibCompressorImplPtr = std::unique_ptr<ZlibCompressorImpl>;
+
 } // namespace Compressor
 } // namespace Envoy
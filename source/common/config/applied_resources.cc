@@ -0,0 +1,29 @@
+#include "common/config/applied_resources.h"
+
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Config {
+
+uint64_t AppliedResources::hash(const ProtobufWkt::Any& resource) {
+  // The serialized bytes are hashed as received, which is deterministic for a given management
+  // server and far cheaper than hashing the unpacked resource.
+  return HashUtil::xxHash64(resource.value());
+}
+
+bool AppliedResources::unchanged(const std::string& name, uint64_t hash,
+                                 const std::string& version) const {
+  const auto it = resources_.find(name);
+  if (it == resources_.end()) {
+    return false;
+  }
+  return (!version.empty() && version == it->second.version_) || hash == it->second.hash_;
+}
+
+void AppliedResources::applied(const std::string& name, uint64_t hash,
+                               const std::string& version) {
+  resources_[name] = {hash, version};
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/protobuf/protobuf.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Remembers the resources last applied by an xDS API, by the hash of their serialized form and
+ * their version, so that the unchanged resources of later updates can be skipped without being
+ * unpacked, validated and compared by their consumer.
+ */
+class AppliedResources {
+public:
+  /**
+   * @param resource the packed resource.
+   * @return uint64_t the hash of the serialized resource.
+   */
+  static uint64_t hash(const ProtobufWkt::Any& resource);
+
+  /**
+   * @param name the name of the resource.
+   * @param hash the hash of the serialized resource.
+   * @param version the version of the resource given by the management server, if any. Only
+   *        per-resource versions, as in delta xDS, may be given.
+   * @return bool whether the resource is the one last applied under that name, i.e. it has the
+   *         same non-empty version or the same hash.
+   */
+  bool unchanged(const std::string& name, uint64_t hash, const std::string& version) const;
+
+  /**
+   * Record that a resource was applied.
+   */
+  void applied(const std::string& name, uint64_t hash, const std::string& version);
+
+  /**
+   * Forget a resource that was removed, or failed to be applied.
+   */
+  void forget(const std::string& name) { resources_.erase(name); }
+
+private:
+  struct AppliedResource {
+    uint64_t hash_;
+    std::string version_;
+  };
+
+  absl::flat_hash_map<std::string, AppliedResource> resources_;
+};
+
+} // namespace Config
+} // namespace Envoy
@@ -4,6 +4,7 @@
 
 #include "common/common/assert.h"
 #include "common/common/hash.h"
+#include "common/config/watch_map.h"
 
 namespace Envoy {
 namespace Config {
@@ -27,6 +28,7 @@ DeltaSubscriptionState::DeltaSubscriptionState(std::string type_url,
 void DeltaSubscriptionState::updateSubscriptionInterest(const std::set<std::string>& cur_added,
                                                         const std::set<std::string>& cur_removed) {
   for (const auto& a : cur_added) {
+    collection_resource_names_.erase(a);
     setResourceWaitingForServer(a);
     // If interest in a resource is removed-then-added (all before a discovery request
     // can be sent), we must treat it as a "new" addition: our user may have forgotten its
@@ -35,6 +37,15 @@ void DeltaSubscriptionState::updateSubscriptionInterest(const std::set<std::stri
     names_added_.insert(a);
   }
   for (const auto& r : cur_removed) {
+    // The resources of a collection we lose interest in are implicitly unsubscribed from.
+    for (auto it = collection_resource_names_.begin(); it != collection_resource_names_.end();) {
+      if (WatchMap::collectionName(*it) == r) {
+        setLostInterestInResource(*it);
+        collection_resource_names_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
     setLostInterestInResource(r);
     // Ideally, when interest in a resource is added-then-removed in between requests,
     // we would avoid putting a superfluous "unsubscribe [resource that was never subscribed]"
@@ -95,6 +106,10 @@ void DeltaSubscriptionState::handleGoodResponse(
   callbacks_.onConfigUpdate(message.resources(), message.removed_resources(),
                             message.system_version_info());
   for (const auto& resource : message.resources()) {
+    if (resource_names_.count(resource.name()) == 0 &&
+        resource_names_.count(WatchMap::collectionName(resource.name())) != 0) {
+      collection_resource_names_.insert(resource.name());
+    }
     setResourceVersion(resource.name(), resource.version());
   }
   // If a resource is gone, there is no longer a meaningful version for it that makes sense to
@@ -106,7 +121,9 @@ void DeltaSubscriptionState::handleGoodResponse(
   // initial_resource_versions messages, but will remind us to explicitly tell the server "I'm
   // cancelling my subscription" when we lose interest.
   for (const auto& resource_name : message.removed_resources()) {
-    if (resource_names_.find(resource_name) != resource_names_.end()) {
+    if (collection_resource_names_.erase(resource_name) != 0) {
+      setLostInterestInResource(resource_name);
+    } else if (resource_names_.find(resource_name) != resource_names_.end()) {
       setResourceWaitingForServer(resource_name);
     }
   }
@@ -144,8 +161,11 @@ DeltaSubscriptionState::getNextRequestAckless() {
         (*request.mutable_initial_resource_versions())[resource.first] = resource.second.version();
       }
       // As mentioned above, fill resource_names_subscribe with everything, including names we
-      // have yet to receive any resource for.
-      names_added_.insert(resource.first);
+      // have yet to receive any resource for, but not the resources of collections, which are
+      // subscribed to through the collection.
+      if (collection_resource_names_.count(resource.first) == 0) {
+        names_added_.insert(resource.first);
+      }
     }
     names_removed_.clear();
   }
@@ -12,6 +12,8 @@
 #include "common/config/api_version.h"
 #include "common/config/pausable_ack_queue.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Config {
 
@@ -91,6 +93,10 @@ private:
   // The keys of resource_versions_. Only tracked separately because std::map does not provide an
   // iterator into just its keys, e.g. for use in std::set_difference.
   std::set<std::string> resource_names_;
+  // The resources we have a version of only because we are interested in their collection. They
+  // are forgotten when they are removed, rather than waited for again, and are not subscribed to
+  // individually.
+  absl::flat_hash_set<std::string> collection_resource_names_;
 
   const std::string type_url_;
   // callbacks_ is expected to be a WatchMap.
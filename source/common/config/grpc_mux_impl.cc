@@ -165,16 +165,28 @@ void GrpcMuxImpl::onDiscoveryResponse(
     // build a map here from resource name to resource and then walk watches_.
     // We have to walk all watches (and need an efficient map as a result) to
     // ensure we deliver empty config updates when a resource is dropped.
-    std::unordered_map<std::string, ProtobufWkt::Any> resources;
+    // The map refers to the resources of the message, along with the number of watches
+    // interested in them, rather than copying them.
+    std::unordered_map<std::string, std::pair<ProtobufWkt::Any*, uint32_t>> resources;
     GrpcMuxCallbacks& callbacks = api_state_[type_url].watches_.front()->callbacks_;
-    for (const auto& resource : message->resources()) {
+    for (auto& resource : *message->mutable_resources()) {
       if (type_url != resource.type_url()) {
         throw EnvoyException(
             fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
                         resource.type_url(), type_url, message->DebugString()));
       }
       const std::string resource_name = callbacks.resourceName(resource);
-      resources.emplace(resource_name, resource);
+      resources.emplace(resource_name, std::make_pair(&resource, 0));
+    }
+    bool wildcard_watched = false;
+    for (auto watch : api_state_[type_url].watches_) {
+      wildcard_watched |= watch->resources_.empty();
+      for (const auto& watched_resource_name : watch->resources_) {
+        auto it = resources.find(watched_resource_name);
+        if (it != resources.end()) {
+          it->second.second++;
+        }
+      }
     }
     for (auto watch : api_state_[type_url].watches_) {
       // onConfigUpdate should be called in all cases for single watch xDS (Cluster and
@@ -188,7 +200,13 @@ void GrpcMuxImpl::onDiscoveryResponse(
       for (const auto& watched_resource_name : watch->resources_) {
         auto it = resources.find(watched_resource_name);
         if (it != resources.end()) {
-          found_resources.Add()->MergeFrom(it->second);
+          // The last watch interested in a resource takes it over from the message, unless a
+          // wildcard watch is handed the whole message.
+          if (--it->second.second == 0 && !wildcard_watched) {
+            found_resources.Add()->Swap(it->second.first);
+          } else {
+            found_resources.Add()->CopyFrom(*it->second.first);
+          }
         }
       }
       // onConfigUpdate should be called only on watches(clusters/routes) that have
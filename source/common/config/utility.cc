@@ -24,11 +24,36 @@
 #include "common/stats/stats_matcher_impl.h"
 #include "common/stats/tag_producer_impl.h"
 
+#include "google/protobuf/wire_format_lite.h"
 #include "udpa/type/v1/typed_struct.pb.h"
 
 namespace Envoy {
 namespace Config {
 
+std::string Utility::anyStringField(const ProtobufWkt::Any& resource, uint32_t field_number) {
+  using Protobuf::internal::WireFormatLite;
+  const std::string& value = resource.value();
+  Protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(value.data()),
+                                       value.size());
+  const uint32_t field_tag =
+      WireFormatLite::MakeTag(field_number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  std::string field;
+  // The whole message is scanned as the last occurrence of a field wins, but the other fields are
+  // skipped over without being parsed.
+  bool read = true;
+  uint32_t tag;
+  while (read && (tag = input.ReadTag()) != 0) {
+    read = tag == field_tag ? WireFormatLite::ReadString(&input, &field)
+                            : WireFormatLite::SkipField(&input, tag);
+  }
+  // A tag of 0 is also read at a malformed tag, before the end of the message.
+  if (!read || input.CurrentPosition() != static_cast<int>(value.size())) {
+    throw EnvoyException(fmt::format("Unable to read field {} of {}", field_number,
+                                     resource.type_url()));
+  }
+  return field;
+}
+
 void Utility::translateApiConfigSource(
     const std::string& cluster, uint32_t refresh_delay_ms, const std::string& api_type,
     envoy::config::core::v3alpha::ApiConfigSource& api_config_source) {
@@ -212,8 +237,9 @@ Utility::createTagProducer(const envoy::config::bootstrap::v3alpha::Bootstrap& b
 }
 
 Stats::StatsMatcherPtr
-Utility::createStatsMatcher(const envoy::config::bootstrap::v3alpha::Bootstrap& bootstrap) {
-  return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config());
+Utility::createStatsMatcher(const envoy::config::bootstrap::v3alpha::Bootstrap& bootstrap,
+                            Stats::SymbolTable& symbol_table) {
+  return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config(), symbol_table);
 }
 
 Grpc::AsyncClientFactoryPtr Utility::factoryForGrpcApiConfigSource(
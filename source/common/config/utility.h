@@ -72,6 +72,16 @@ public:
     return std::make_pair("hash_" + Hex::uint64ToHex(hash), hash);
   }
 
+  /**
+   * Read a top level string field of the message packed in an Any, without unpacking the rest of
+   * the message. This is much cheaper than unpacking large resources only to get their name.
+   * @param resource the packed message.
+   * @param field_number the number of the string field.
+   * @return std::string the value of the field, or the empty string if it is not set.
+   * @throws EnvoyException if the packed message is malformed.
+   */
+  static std::string anyStringField(const ProtobufWkt::Any& resource, uint32_t field_number);
+
   /**
    * Extract refresh_delay as a std::chrono::milliseconds from
    * envoy::api::v2::core::ApiConfigSource.
@@ -259,9 +269,12 @@ public:
 
   /**
    * Create StatsMatcher instance.
+   * @param bootstrap bootstrap proto.
+   * @param symbol_table the symbol table of the stats the matcher is applied to.
    */
   static Stats::StatsMatcherPtr
-  createStatsMatcher(const envoy::config::bootstrap::v3alpha::Bootstrap& bootstrap);
+  createStatsMatcher(const envoy::config::bootstrap::v3alpha::Bootstrap& bootstrap,
+                     Stats::SymbolTable& symbol_table);
 
   /**
    * Obtain gRPC async client factory from a envoy::api::v2::core::ApiConfigSource.
@@ -2,6 +2,8 @@
 
 #include "envoy/service/discovery/v3alpha/discovery.pb.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Config {
 
@@ -42,6 +44,14 @@ AddedRemoved WatchMap::updateWatchInterest(Watch* watch,
                       findRemovals(newly_removed_from_watch, watch));
 }
 
+std::string WatchMap::collectionName(absl::string_view resource_name) {
+  const size_t separator = resource_name.rfind('/');
+  if (separator == absl::string_view::npos) {
+    return "";
+  }
+  return absl::StrCat(resource_name.substr(0, separator), "/*");
+}
+
 absl::flat_hash_set<Watch*> WatchMap::watchesInterestedIn(const std::string& resource_name) {
   absl::flat_hash_set<Watch*> ret = wildcard_watches_;
   const auto watches_interested = watch_interest_.find(resource_name);
@@ -50,6 +60,15 @@ absl::flat_hash_set<Watch*> WatchMap::watchesInterestedIn(const std::string& res
       ret.insert(watch);
     }
   }
+  const std::string collection_name = collectionName(resource_name);
+  if (!collection_name.empty() && collection_name != resource_name) {
+    const auto collection_watches_interested = watch_interest_.find(collection_name);
+    if (collection_watches_interested != watch_interest_.end()) {
+      for (const auto& watch : collection_watches_interested->second) {
+        ret.insert(watch);
+      }
+    }
+  }
   return ret;
 }
 
@@ -58,38 +77,49 @@ void WatchMap::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>
   if (watches_.empty()) {
     return;
   }
+  const bool map_is_single_wildcard = (watches_.size() == 1 && wildcard_watches_.size() == 1);
+  if (map_is_single_wildcard) {
+    // The single wildcard watch (i.e. Cluster or Listener) is interested in every resource, which
+    // it is handed without being copied or named.
+    Watch* watch = *watches_.begin();
+    watch->callbacks_.onConfigUpdate(resources, version_info);
+    watch->state_of_the_world_empty_ = resources.empty();
+    return;
+  }
   SubscriptionCallbacks& name_getter = (*watches_.begin())->callbacks_;
 
   // Build a map from watches, to the set of updated resources that each watch cares about. Each
   // entry in the map is then a nice little bundle that can be fed directly into the individual
-  // onConfigUpdate()s.
-  absl::flat_hash_map<Watch*, Protobuf::RepeatedPtrField<ProtobufWkt::Any>> per_watch_updates;
+  // onConfigUpdate()s. The copies of the resources are allocated on an arena released at once.
+  Protobuf::Arena arena;
+  absl::flat_hash_map<Watch*, Protobuf::RepeatedPtrField<ProtobufWkt::Any>*> per_watch_updates;
   for (const auto& r : resources) {
     const absl::flat_hash_set<Watch*>& interested_in_r =
         watchesInterestedIn(name_getter.resourceName(r));
     for (const auto& interested_watch : interested_in_r) {
-      per_watch_updates[interested_watch].Add()->CopyFrom(r);
+      auto& watch_updates = per_watch_updates[interested_watch];
+      if (watch_updates == nullptr) {
+        watch_updates =
+            Protobuf::Arena::CreateMessage<Protobuf::RepeatedPtrField<ProtobufWkt::Any>>(&arena);
+      }
+      watch_updates->Add()->CopyFrom(r);
     }
   }
 
-  const bool map_is_single_wildcard = (watches_.size() == 1 && wildcard_watches_.size() == 1);
   // We just bundled up the updates into nice per-watch packages. Now, deliver them.
   for (auto& watch : watches_) {
     const auto this_watch_updates = per_watch_updates.find(watch);
     if (this_watch_updates == per_watch_updates.end()) {
       // This update included no resources this watch cares about.
-      // 1) If there is only a single, wildcard watch (i.e. Cluster or Listener), always call
-      //    its onConfigUpdate even if just a no-op, to properly maintain state-of-the-world
-      //    semantics and the update_empty stat.
-      // 2) If this watch previously had some resources, it means this update is removing all
+      // 1) If this watch previously had some resources, it means this update is removing all
       //    of this watch's resources, so the watch must be informed with an onConfigUpdate.
-      // 3) Otherwise, we can skip onConfigUpdate for this watch.
-      if (map_is_single_wildcard || !watch->state_of_the_world_empty_) {
+      // 2) Otherwise, we can skip onConfigUpdate for this watch.
+      if (!watch->state_of_the_world_empty_) {
         watch->callbacks_.onConfigUpdate({}, version_info);
         watch->state_of_the_world_empty_ = true;
       }
     } else {
-      watch->callbacks_.onConfigUpdate(this_watch_updates->second, version_info);
+      watch->callbacks_.onConfigUpdate(*this_watch_updates->second, version_info);
       watch->state_of_the_world_empty_ = false;
     }
   }
@@ -128,13 +158,20 @@ void WatchMap::onConfigUpdate(
   // Build a pair of maps: from watches, to the set of resources {added,removed} that each watch
   // cares about. Each entry in the map-pair is then a nice little bundle that can be fed directly
   // into the individual onConfigUpdate()s.
+  // The copies of the added resources are allocated on an arena released at once.
+  Protobuf::Arena arena;
   absl::flat_hash_map<Watch*,
-                      Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>>
+                      Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>*>
       per_watch_added;
   for (const auto& r : added_resources) {
     const absl::flat_hash_set<Watch*>& interested_in_r = watchesInterestedIn(r.name());
     for (const auto& interested_watch : interested_in_r) {
-      per_watch_added[interested_watch].Add()->CopyFrom(r);
+      auto& watch_added = per_watch_added[interested_watch];
+      if (watch_added == nullptr) {
+        watch_added = Protobuf::Arena::CreateMessage<
+            Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>>(&arena);
+      }
+      watch_added->Add()->CopyFrom(r);
     }
   }
   absl::flat_hash_map<Watch*, Protobuf::RepeatedPtrField<std::string>> per_watch_removed;
@@ -151,10 +188,10 @@ void WatchMap::onConfigUpdate(
     const auto removed = per_watch_removed.find(cur_watch);
     if (removed == per_watch_removed.end()) {
       // additions only, no removals
-      cur_watch->callbacks_.onConfigUpdate(added.second, {}, system_version_info);
+      cur_watch->callbacks_.onConfigUpdate(*added.second, {}, system_version_info);
     } else {
       // both additions and removals
-      cur_watch->callbacks_.onConfigUpdate(added.second, removed->second, system_version_info);
+      cur_watch->callbacks_.onConfigUpdate(*added.second, removed->second, system_version_info);
       // Drop the removals now, so the final removals-only pass won't use them.
       per_watch_removed.erase(removed);
     }
@@ -12,6 +12,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Config {
@@ -94,6 +95,12 @@ public:
 
   std::string resourceName(const ProtobufWkt::Any&) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
 
+  // Returns the name of the collection that a resource named "<prefix>/<suffix>" belongs to, i.e.
+  // "<prefix>/*", or an empty string if the resource name has no '/'. A watch on the name of a
+  // collection is interested in all the resources of the collection, which is only meaningful for
+  // delta xDS, where the resources come and go individually.
+  static std::string collectionName(absl::string_view resource_name);
+
   WatchMap(const WatchMap&) = delete;
   WatchMap& operator=(const WatchMap&) = delete;
 
@@ -108,7 +115,8 @@ private:
   std::set<std::string> findRemovals(const std::vector<std::string>& newly_removed_from_watch,
                                      Watch* watch);
 
-  // Returns the union of watch_interest_[resource_name] and wildcard_watches_.
+  // Returns the union of watch_interest_[resource_name], watch_interest_ in the collection of the
+  // resource, and wildcard_watches_.
   absl::flat_hash_set<Watch*> watchesInterestedIn(const std::string& resource_name);
 
   absl::flat_hash_set<std::unique_ptr<Watch>> watches_;
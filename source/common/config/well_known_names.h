@@ -70,6 +70,17 @@ public:
     const std::string substr_;
   };
 
+  /**
+   * Represents a tag extraction done by matching the tokens of the stat name against a pattern
+   * rather than with a regex. See Stats::TagExtractorTokensImpl for the pattern syntax.
+   */
+  struct TokenizedDescriptor {
+    TokenizedDescriptor(const std::string& name, const std::string& pattern)
+        : name_(name), pattern_(pattern) {}
+    const std::string name_;
+    const std::string pattern_;
+  };
+
   // Cluster name tag
   const std::string CLUSTER_NAME = "envoy.cluster_name";
   // Listener port tag
@@ -127,11 +138,18 @@ public:
   // Returns the list of descriptors.
   const std::vector<Descriptor>& descriptorVec() const { return descriptor_vec_; }
 
+  // Returns the list of tokenized descriptors.
+  const std::vector<TokenizedDescriptor>& tokenizedDescriptorVec() const {
+    return tokenized_descriptor_vec_;
+  }
+
 private:
   void addRegex(const std::string& name, const std::string& regex, const std::string& substr = "");
+  void addTokenized(const std::string& name, const std::string& pattern);
 
   // Collection of tag descriptors.
   std::vector<Descriptor> descriptor_vec_;
+  std::vector<TokenizedDescriptor> tokenized_descriptor_vec_;
 };
 
 using TagNames = ConstSingleton<TagNameValues>;
@@ -63,6 +63,7 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& pre
     stats_ = std::make_unique<DispatcherStats>(
         DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
+    post_latency_enabled_.store(true, std::memory_order_relaxed);
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
@@ -119,10 +120,9 @@ DispatcherImpl::createClientConnection(Network::Address::InstanceConstSharedPtr
 
 Network::DnsResolverSharedPtr DispatcherImpl::createDnsResolver(
     const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers,
-    const bool use_tcp_for_dns_lookups) {
+    const Network::DnsResolverOptions& options) {
   ASSERT(isThreadSafe());
-  return Network::DnsResolverSharedPtr{
-      new Network::DnsResolverImpl(*this, resolvers, use_tcp_for_dns_lookups)};
+  return Network::DnsResolverSharedPtr{new Network::DnsResolverImpl(*this, resolvers, options)};
 }
 
 FileEventPtr DispatcherImpl::createFileEvent(int fd, FileReadyCb cb, FileTriggerType trigger,
@@ -151,6 +151,14 @@ Network::UdpListenerPtr DispatcherImpl::createUdpListener(Network::SocketSharedP
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) { return createTimerInternal(cb); }
 
+TimerPtr DispatcherImpl::createCoarseTimer(TimerCb cb) {
+  ASSERT(isThreadSafe());
+  if (coarse_timer_wheel_ == nullptr) {
+    coarse_timer_wheel_ = std::make_unique<TimerWheel>(*this, std::chrono::milliseconds(1));
+  }
+  return coarse_timer_wheel_->createTimer(cb);
+}
+
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
   ASSERT(isThreadSafe());
   return scheduler_->createTimer(cb, *this);
@@ -173,14 +181,10 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
-  }
-
-  if (do_post) {
+  const MonotonicTime posted = post_latency_enabled_.load(std::memory_order_relaxed)
+                                   ? timeSource().monotonicTime()
+                                   : MonotonicTime();
+  if (post_queue_.push(std::move(callback), posted)) {
     post_timer_->enableTimer(std::chrono::milliseconds(0));
   }
 }
@@ -205,24 +209,35 @@ void DispatcherImpl::updateApproximateMonotonicTime() {
 }
 
 void DispatcherImpl::runPostCallbacks() {
-  while (true) {
-    // It is important that this declaration is inside the body of the loop so that the callback is
-    // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
-    // for each iteration, the previous iteration's callback is destructed when callback is
-    // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
-    // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
-    // callstack calls post() on this dispatcher.
+  // Only the callbacks queued on entry are run, so that callbacks posted meanwhile, including by
+  // the callbacks themselves, wait for the next iteration of the loop rather than starving it.
+  const uint64_t queued = post_queue_.size();
+  if (stats_ != nullptr) {
+    // The callbacks posted since the last run, which waited for the loop to get to them.
+    stats_->post_queue_depth_.recordValue(queued);
+  }
+  uint64_t popped = 0;
+  while (popped < queued) {
+    // The callback is destroyed at the end of each iteration, before the next one is popped, so
+    // that the captures of a callback do not outlive its run.
     std::function<void()> callback;
-    {
-      Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
-        return;
-      }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
+    MonotonicTime posted;
+    if (!post_queue_.pop(callback, posted)) {
+      break;
+    }
+    popped++;
+    if (stats_ != nullptr && posted != MonotonicTime()) {
+      stats_->post_latency_us_.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                               timeSource().monotonicTime() - posted)
+                                               .count());
     }
     callback();
   }
+  // The callbacks left, or whose push was still in progress, are run by the next iteration of the
+  // loop.
+  if (post_queue_.release(popped)) {
+    post_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
 }
 
 } // namespace Event
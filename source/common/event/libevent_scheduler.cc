@@ -99,9 +99,11 @@ void LibeventScheduler::onCheckForStats(evwatch*, const evwatch_check_cb_info*,
   // from above to compute the actual polling duration, and store it for the next iteration of the
   // event loop to compute the loop duration.
   evutil_gettimeofday(&self->check_time_, nullptr);
+  timeval delta;
+  evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+  recordTimeval(self->stats_->poll_duration_us_, delta);
   if (self->timeout_set_) {
-    timeval delta, delay;
-    evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+    timeval delay;
     evutil_timersub(&delta, &self->timeout_, &delay);
 
     // Delay can be negative, meaning polling completed early. This happens in normal operation,
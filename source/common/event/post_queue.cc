@@ -0,0 +1,67 @@
+#include "common/event/post_queue.h"
+
+namespace Envoy {
+namespace Event {
+
+PostQueue::~PostQueue() {
+  // The callbacks never run are destroyed with their nodes.
+  std::function<void()> callback;
+  MonotonicTime posted;
+  while (pop(callback, posted)) {
+  }
+}
+
+bool PostQueue::push(std::function<void()> callback, MonotonicTime posted) {
+  Node* node = new Node();
+  node->callback_ = std::move(callback);
+  node->posted_ = posted;
+  // The node is counted before it is linked, so that the consumer never releases more nodes than
+  // were counted.
+  const bool was_empty = size_.fetch_add(1, std::memory_order_acq_rel) == 0;
+  pushNode(node);
+  return was_empty;
+}
+
+void PostQueue::pushNode(Node* node) {
+  node->next_.store(nullptr, std::memory_order_relaxed);
+  Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+  // Until this store, the consumer cannot reach the node nor the ones pushed after it.
+  previous->next_.store(node, std::memory_order_release);
+}
+
+bool PostQueue::pop(std::function<void()>& callback, MonotonicTime& posted) {
+  Node* tail = tail_;
+  Node* next = tail->next_.load(std::memory_order_acquire);
+  if (tail == &stub_) {
+    if (next == nullptr) {
+      return false;
+    }
+    tail_ = next;
+    tail = next;
+    next = next->next_.load(std::memory_order_acquire);
+  }
+  if (next == nullptr) {
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // A push is in progress.
+      return false;
+    }
+    // The tail is the last node, so the stub is pushed behind it before it is popped.
+    pushNode(&stub_);
+    next = tail->next_.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+  }
+  tail_ = next;
+  callback = std::move(tail->callback_);
+  posted = tail->posted_;
+  delete tail;
+  return true;
+}
+
+bool PostQueue::release(uint64_t popped) {
+  return size_.fetch_sub(popped, std::memory_order_acq_rel) != popped;
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "envoy/common/time.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * The queue of the callbacks posted to a dispatcher, with multiple producers and a single
+ * consumer. A producer pushes a callback with a single atomic exchange rather than under a lock,
+ * so that the threads posting to a dispatcher do not contend with each other nor with the
+ * dispatcher. The callbacks are moved into the nodes of the queue, which hold the small ones
+ * inline, so that a post allocates only its node.
+ *
+ * The queue counts the callbacks pushed and not yet released by the consumer, so that the consumer
+ * is only woken up by the push making the queue non-empty. A pop may transiently fail while an
+ * earlier push is in progress, in which case release() reports that callbacks remain and the
+ * consumer must run again.
+ */
+class PostQueue : NonCopyable {
+public:
+  PostQueue() = default;
+  ~PostQueue();
+
+  /**
+   * Push a callback. Called by any thread.
+   * @param callback supplies the callback.
+   * @param posted supplies the time of the post.
+   * @return bool whether the queue was empty, in which case the consumer must be woken up.
+   */
+  bool push(std::function<void()> callback, MonotonicTime posted);
+
+  /**
+   * Pop the oldest callback. Called by the consumer thread only.
+   * @param callback supplies the callback to set.
+   * @param posted supplies the time of the post to set.
+   * @return bool whether a callback was popped.
+   */
+  bool pop(std::function<void()>& callback, MonotonicTime& posted);
+
+  /**
+   * Release the callbacks run by the consumer. Called by the consumer thread only.
+   * @param popped supplies the number of callbacks popped since the last release.
+   * @return bool whether callbacks remain, in which case the consumer must run again.
+   */
+  bool release(uint64_t popped);
+
+  /**
+   * @return uint64_t the number of callbacks pushed and not yet released.
+   */
+  uint64_t size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+  struct Node {
+    std::atomic<Node*> next_{nullptr};
+    std::function<void()> callback_;
+    MonotonicTime posted_;
+  };
+
+  void pushNode(Node* node);
+
+  // The nodes are linked from the oldest, tail_, which is only accessed by the consumer, to the
+  // newest, head_. The stub node keeps the list non-empty.
+  Node stub_;
+  std::atomic<Node*> head_{&stub_};
+  Node* tail_{&stub_};
+  std::atomic<uint64_t> size_{0};
+};
+
+} // namespace Event
+} // namespace Envoy
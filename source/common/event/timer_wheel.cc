@@ -0,0 +1,199 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/scope_tracker.h"
+
+namespace Envoy {
+namespace Event {
+
+TimerWheel::TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds tick)
+    : dispatcher_(dispatcher),
+      tick_(std::max<std::chrono::microseconds>(tick, std::chrono::milliseconds(1))),
+      timer_(dispatcher.createTimer([this]() -> void { onTick(); })) {}
+
+TimerPtr TimerWheel::createTimer(TimerCb cb) { return std::make_unique<WheelTimer>(*this, cb); }
+
+void TimerWheel::WheelTimer::disableTimer() {
+  if (slot_ != nullptr) {
+    wheel_.remove(*this);
+  }
+}
+
+void TimerWheel::WheelTimer::enableTimer(const std::chrono::milliseconds& ms,
+                                         const ScopeTrackedObject* object) {
+  object_ = object;
+  wheel_.add(*this, ms);
+}
+
+void TimerWheel::WheelTimer::enableHRTimer(const std::chrono::microseconds& us,
+                                           const ScopeTrackedObject* object) {
+  object_ = object;
+  wheel_.add(*this, us);
+}
+
+uint64_t TimerWheel::currentTick() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             dispatcher_.timeSource().monotonicTime().time_since_epoch())
+             .count() /
+         tick_.count();
+}
+
+void TimerWheel::add(WheelTimer& timer, std::chrono::microseconds duration) {
+  if (timer.slot_ != nullptr) {
+    remove(timer);
+  }
+  const uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                           dispatcher_.timeSource().monotonicTime().time_since_epoch())
+                           .count();
+  if (num_enabled_ == 0) {
+    // The wheel does not turn while empty.
+    current_tick_ = now / tick_.count();
+  }
+  // The timer expires at the first tick boundary at or after it is due, but never in the current
+  // tick, which may already have been run.
+  const uint64_t due = now + std::max(duration, duration.zero()).count();
+  timer.expiry_ = std::max((due + tick_.count() - 1) / tick_.count(), now / tick_.count() + 1);
+  place(timer);
+  num_enabled_++;
+  scheduleTick(timer.slot_ >= near_ && timer.slot_ < near_ + NearSlots ? timer.expiry_
+                                                                        : nextTurn());
+}
+
+void TimerWheel::place(WheelTimer& timer) {
+  ASSERT(timer.expiry_ >= current_tick_);
+  const uint64_t delta = timer.expiry_ - current_tick_;
+  WheelTimer** slot;
+  if (delta < NearSlots) {
+    slot = &near_[timer.expiry_ & (NearSlots - 1)];
+    num_near_++;
+  } else {
+    // The later timers are held at the furthest tick of the wheel.
+    const uint64_t expiry = current_tick_ + std::min(delta, MaxTicks - 1);
+    uint64_t level = 0;
+    while ((expiry - current_tick_) >> (NearBits + (level + 1) * LevelBits) != 0) {
+      level++;
+    }
+    slot = &levels_[level][(expiry >> (NearBits + level * LevelBits)) & (LevelSlots - 1)];
+  }
+  timer.slot_ = slot;
+  timer.previous_ = nullptr;
+  timer.next_ = *slot;
+  if (*slot != nullptr) {
+    (*slot)->previous_ = &timer;
+  }
+  *slot = &timer;
+}
+
+void TimerWheel::remove(WheelTimer& timer) {
+  ASSERT(timer.slot_ != nullptr);
+  if (timer.previous_ != nullptr) {
+    timer.previous_->next_ = timer.next_;
+  } else {
+    *timer.slot_ = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->previous_ = timer.previous_;
+  }
+  if (timer.slot_ >= near_ && timer.slot_ < near_ + NearSlots) {
+    num_near_--;
+  }
+  // The wheel is not rescheduled, the next tick finds nothing to run at worst.
+  timer.slot_ = nullptr;
+  num_enabled_--;
+}
+
+void TimerWheel::onTick() {
+  scheduled_ = false;
+  advance(currentTick());
+  scheduleNextTick();
+}
+
+void TimerWheel::advance(uint64_t tick) {
+  while (current_tick_ < tick) {
+    if (num_enabled_ == 0) {
+      current_tick_ = tick;
+      return;
+    }
+    if (num_near_ == 0) {
+      // Skip to the end of the turn, where the coarser levels cascade.
+      const uint64_t last_of_turn = nextTurn() - 1;
+      if (last_of_turn >= tick) {
+        current_tick_ = tick;
+        return;
+      }
+      current_tick_ = last_of_turn;
+    }
+
+    current_tick_++;
+    if ((current_tick_ & (NearSlots - 1)) == 0) {
+      // Cascade the slots of the coarser levels reached by this turn, from the coarsest.
+      uint64_t level = 0;
+      while (level + 1 < NumLevels &&
+             ((current_tick_ >> (NearBits + level * LevelBits)) & (LevelSlots - 1)) == 0) {
+        level++;
+      }
+      for (uint64_t i = level + 1; i-- > 0;) {
+        cascade(levels_[i][(current_tick_ >> (NearBits + i * LevelBits)) & (LevelSlots - 1)]);
+      }
+    }
+
+    // The timers are run one at a time as their callbacks may enable, disable or destroy others.
+    WheelTimer*& slot = near_[current_tick_ & (NearSlots - 1)];
+    while (slot != nullptr) {
+      WheelTimer* timer = slot;
+      ASSERT(timer->expiry_ == current_tick_);
+      remove(*timer);
+      if (timer->object_ == nullptr) {
+        timer->cb_();
+        continue;
+      }
+      ScopeTrackerScopeState scope(timer->object_, dispatcher_);
+      timer->object_ = nullptr;
+      timer->cb_();
+    }
+  }
+}
+
+void TimerWheel::cascade(WheelTimer*& slot) {
+  while (slot != nullptr) {
+    WheelTimer* timer = slot;
+    remove(*timer);
+    place(*timer);
+    num_enabled_++;
+  }
+}
+
+void TimerWheel::scheduleTick(uint64_t tick) {
+  if (scheduled_ && scheduled_tick_ <= tick) {
+    return;
+  }
+  // Run at the start of the tick, rounded up to the millisecond.
+  const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+      dispatcher_.timeSource().monotonicTime().time_since_epoch());
+  const auto delay = std::max(std::chrono::microseconds(tick * tick_.count()) - now,
+                              std::chrono::microseconds::zero());
+  timer_->enableTimer(std::chrono::milliseconds((delay.count() + 999) / 1000));
+  scheduled_tick_ = tick;
+  scheduled_ = true;
+}
+
+void TimerWheel::scheduleNextTick() {
+  if (num_enabled_ == 0) {
+    return;
+  }
+  uint64_t next_tick = nextTurn();
+  if (num_near_ != 0) {
+    for (uint64_t tick = current_tick_ + 1; tick < current_tick_ + NearSlots; tick++) {
+      if (near_[tick & (NearSlots - 1)] != nullptr) {
+        next_tick = std::min(next_tick, tick);
+        break;
+      }
+    }
+  }
+  scheduleTick(next_tick);
+}
+
+} // namespace Event
+} // namespace Envoy
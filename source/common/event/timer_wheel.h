@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Batches many coarse timers of a dispatcher onto a single dispatcher timer. Timers expire at the
+ * first tick boundary at or after the time they are due, so that all the timers due in a tick are
+ * run by a single wakeup of the dispatcher, at most one tick later than requested. This bounds the
+ * wakeups to one per tick however many timers are enabled, which suits large numbers of timers
+ * whose precision does not matter, such as health check intervals and idle timeouts. Like the
+ * dispatcher timers, it must only be used from the thread of its dispatcher, and must outlive the
+ * timers it creates.
+ *
+ * The wheel is hierarchical: the timers due within NearSlots ticks are kept in the slot of their
+ * tick, and the later ones in the slots of coarser levels, which are cascaded down as the wheel
+ * turns. The slots are intrusive lists, so that enabling, resetting and disabling a timer take
+ * constant time and do not allocate.
+ */
+class TimerWheel {
+public:
+  TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds tick);
+
+  /**
+   * @return a timer run by the wheel.
+   */
+  TimerPtr createTimer(TimerCb cb);
+
+private:
+  class WheelTimer : public Timer {
+  public:
+    WheelTimer(TimerWheel& wheel, TimerCb cb) : wheel_(wheel), cb_(cb) {}
+    ~WheelTimer() override { disableTimer(); }
+
+    // Event::Timer
+    void disableTimer() override;
+    void enableTimer(const std::chrono::milliseconds& ms,
+                     const ScopeTrackedObject* object = nullptr) override;
+    void enableHRTimer(const std::chrono::microseconds& us,
+                       const ScopeTrackedObject* object = nullptr) override;
+    bool enabled() override { return slot_ != nullptr; }
+
+  private:
+    friend class TimerWheel;
+
+    TimerWheel& wheel_;
+    const TimerCb cb_;
+    const ScopeTrackedObject* object_{};
+    // The tick the timer expires at.
+    uint64_t expiry_{};
+    // The slot holding the timer, if enabled, and the neighbours of the timer in it.
+    WheelTimer** slot_{};
+    WheelTimer* previous_{};
+    WheelTimer* next_{};
+  };
+
+  // The number of slots of the first level, each holding the timers due at one tick.
+  static constexpr uint64_t NearBits = 8;
+  static constexpr uint64_t NearSlots = 1 << NearBits;
+  // The number of coarser levels, and of slots in each of them, each slot of a level spanning all
+  // the slots of the level below.
+  static constexpr uint64_t NumLevels = 3;
+  static constexpr uint64_t LevelBits = 6;
+  static constexpr uint64_t LevelSlots = 1 << LevelBits;
+  // The furthest expiry, in ticks, the wheel holds. Later timers are held there and placed again
+  // once cascaded.
+  static constexpr uint64_t MaxTicks = uint64_t(1) << (NearBits + NumLevels * LevelBits);
+
+  void add(WheelTimer& timer, std::chrono::microseconds duration);
+  void place(WheelTimer& timer);
+  void remove(WheelTimer& timer);
+  void onTick();
+  void advance(uint64_t tick);
+  void cascade(WheelTimer*& slot);
+  uint64_t currentTick() const;
+  // The first tick of the next turn of the first level, at which the coarser levels cascade.
+  uint64_t nextTurn() const { return (current_tick_ | (NearSlots - 1)) + 1; }
+  void scheduleTick(uint64_t tick);
+  void scheduleNextTick();
+
+  Dispatcher& dispatcher_;
+  const std::chrono::microseconds tick_;
+  // The last tick run.
+  uint64_t current_tick_{};
+  uint64_t num_enabled_{};
+  uint64_t num_near_{};
+  WheelTimer* near_[NearSlots]{};
+  WheelTimer* levels_[NumLevels][LevelSlots]{};
+  const TimerPtr timer_;
+  // The tick timer_ is enabled for, if any.
+  uint64_t scheduled_tick_{};
+  bool scheduled_{};
+};
+
+using TimerWheelPtr = std::unique_ptr<TimerWheel>;
+
+} // namespace Event
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
@@ -50,6 +51,10 @@ FileImplPosix::FlagsAndMode FileImplPosix::translateFlag(FlagSet in) {
     out |= O_APPEND;
   }
 
+  if (in.test(File::Operation::Truncate)) {
+    out |= O_TRUNC;
+  }
+
   if (in.test(File::Operation::Read) && in.test(File::Operation::Write)) {
     out |= O_RDWR;
   } else if (in.test(File::Operation::Read)) {
@@ -108,6 +113,10 @@ std::string InstanceImplPosix::fileReadToEnd(const std::string& path) {
   return file_string.str();
 }
 
+bool InstanceImplPosix::renameFile(const std::string& old_path, const std::string& new_path) {
+  return ::rename(old_path.c_str(), new_path.c_str()) == 0;
+}
+
 bool InstanceImplPosix::illegalPath(const std::string& path) {
   // Special case, allow /dev/fd/* access here so that config can be passed in a
   // file descriptor from a bootstrap script via exec. The reason we do this
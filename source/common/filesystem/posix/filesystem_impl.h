@@ -39,6 +39,7 @@ public:
   bool directoryExists(const std::string& path) override;
   ssize_t fileSize(const std::string& path) override;
   std::string fileReadToEnd(const std::string& path) override;
+  bool renameFile(const std::string& old_path, const std::string& new_path) override;
   bool illegalPath(const std::string& path) override;
 
 private:
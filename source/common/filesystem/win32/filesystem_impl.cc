@@ -44,6 +44,10 @@ FileImplWin32::FlagsAndMode FileImplWin32::translateFlag(FlagSet in) {
     out |= _O_APPEND;
   }
 
+  if (in.test(File::Operation::Truncate)) {
+    out |= _O_TRUNC;
+  }
+
   if (in.test(File::Operation::Read) && in.test(File::Operation::Write)) {
     out |= _O_RDWR;
   } else if (in.test(File::Operation::Read)) {
@@ -102,6 +106,10 @@ std::string InstanceImplWin32::fileReadToEnd(const std::string& path) {
   return file_string.str();
 }
 
+bool InstanceImplWin32::renameFile(const std::string& old_path, const std::string& new_path) {
+  return ::MoveFileEx(old_path.c_str(), new_path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
 bool InstanceImplWin32::illegalPath(const std::string& path) {
   // Currently, we don't know of any obviously illegal paths on Windows
   return false;
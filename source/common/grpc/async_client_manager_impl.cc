@@ -33,14 +33,25 @@ AsyncClientFactoryImpl::AsyncClientFactoryImpl(
 
 AsyncClientManagerImpl::AsyncClientManagerImpl(Upstream::ClusterManager& cm,
                                                ThreadLocal::Instance& tls, TimeSource& time_source,
-                                               Api::Api& api)
+                                               Api::Api& api,
+                                               uint32_t google_grpc_completion_threads)
     : cm_(cm), tls_(tls), time_source_(time_source), api_(api) {
 #ifdef ENVOY_GOOGLE_GRPC
+  if (google_grpc_completion_threads > 0) {
+    google_completion_queues_ =
+        std::make_shared<GoogleCompletionQueuePool>(api, google_grpc_completion_threads);
+  }
   google_tls_slot_ = tls.allocateSlot();
-  google_tls_slot_->set(
-      [&api](Event::Dispatcher&) { return std::make_shared<GoogleAsyncClientThreadLocal>(api); });
+  google_tls_slot_->set([&api, completion_queues = google_completion_queues_](
+                            Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    if (completion_queues != nullptr) {
+      return std::make_shared<GoogleAsyncClientThreadLocal>(completion_queues->next());
+    }
+    return std::make_shared<GoogleAsyncClientThreadLocal>(api);
+  });
 #else
   UNREFERENCED_PARAMETER(api_);
+  UNREFERENCED_PARAMETER(google_grpc_completion_threads);
 #endif
 }
 
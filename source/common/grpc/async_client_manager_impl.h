@@ -42,10 +42,17 @@ private:
   Api::Api& api_;
 };
 
+class GoogleCompletionQueuePool;
+
 class AsyncClientManagerImpl : public AsyncClientManager {
 public:
+  /**
+   * @param google_grpc_completion_threads supplies the number of completion queue threads shared
+   *        by the silos for the Google gRPC clients, or 0 for one completion queue thread per silo.
+   */
   AsyncClientManagerImpl(Upstream::ClusterManager& cm, ThreadLocal::Instance& tls,
-                         TimeSource& time_source, Api::Api& api);
+                         TimeSource& time_source, Api::Api& api,
+                         uint32_t google_grpc_completion_threads);
 
   // Grpc::AsyncClientManager
   AsyncClientFactoryPtr
@@ -55,6 +62,7 @@ public:
 private:
   Upstream::ClusterManager& cm_;
   ThreadLocal::Instance& tls_;
+  std::shared_ptr<GoogleCompletionQueuePool> google_completion_queues_;
   ThreadLocal::SlotPtr google_tls_slot_;
   TimeSource& time_source_;
   Api::Api& api_;
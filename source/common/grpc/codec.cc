@@ -22,17 +22,46 @@ void Encoder::newFrame(uint8_t flags, uint64_t length, std::array<uint8_t, 5>& o
 }
 
 bool Decoder::decode(Buffer::Instance& input, std::vector<Frame>& output) {
+  // The input is inspected first, recording where the data of each frame is, so that it is left
+  // unchanged on a decoding error. The data is then moved from the input to the frames, which takes
+  // the slices of the input that are wholly part of a frame rather than copying them, only the
+  // slices shared with a frame header or with another frame being copied.
   decoding_error_ = false;
   output_ = &output;
+  const size_t output_size = output.size();
+  header_bytes_ = headerBytesLeft();
   inspect(input);
   output_ = nullptr;
   if (decoding_error_) {
+    output.erase(output.begin() + output_size, output.end());
+    data_ranges_.clear();
     return false;
   }
+  for (const DataRange& range : data_ranges_) {
+    input.drain(range.header_bytes_);
+    range.data_->move(input, range.length_);
+  }
+  data_ranges_.clear();
+  // What is left is the headers after the last data, which have been decoded already.
   input.drain(input.length());
   return true;
 }
 
+uint64_t Decoder::headerBytesLeft() const {
+  switch (state_) {
+  case State::FhLen0:
+    return 4;
+  case State::FhLen1:
+    return 3;
+  case State::FhLen2:
+    return 2;
+  case State::FhLen3:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
 bool Decoder::frameStart(uint8_t flags) {
   // Unsupported flags.
   if (flags & ~GRPC_FH_COMPRESSED) {
@@ -40,6 +69,7 @@ bool Decoder::frameStart(uint8_t flags) {
     return false;
   }
   frame_.flags_ = flags;
+  header_bytes_ += GRPC_FRAME_HEADER_SIZE;
   return true;
 }
 
@@ -48,7 +78,11 @@ void Decoder::frameDataStart() {
   frame_.data_ = std::make_unique<Buffer::OwnedImpl>();
 }
 
-void Decoder::frameData(uint8_t* mem, uint64_t length) { frame_.data_->add(mem, length); }
+void Decoder::frameData(uint8_t*, uint64_t length) {
+  // The data is moved once the whole input has been inspected.
+  data_ranges_.push_back({header_bytes_, length, frame_.data_.get()});
+  header_bytes_ = 0;
+}
 
 void Decoder::frameDataEnd() {
   output_->push_back(std::move(frame_));
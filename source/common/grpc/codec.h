@@ -100,7 +100,8 @@ public:
   // Decodes the given buffer with GRPC data frame. Drains the input buffer when
   // decoding succeeded (returns true). If the input is not sufficient to make a
   // complete GRPC data frame, it will be buffered in the decoder. If a decoding
-  // error happened, the input buffer remains unchanged.
+  // error happened, the input buffer remains unchanged and no frame is output.
+  // The data of the frames is moved from the input buffer rather than copied.
   // @param input supplies the binary octets wrapped in a GRPC data frame.
   // @param output supplies the buffer to store the decoded data.
   // @return bool whether the decoding succeeded or not.
@@ -121,9 +122,23 @@ protected:
   void frameDataEnd() override;
 
 private:
+  // A range of the input holding frame data, preceded by frame header bytes.
+  struct DataRange {
+    uint64_t header_bytes_;
+    uint64_t length_;
+    Buffer::Instance* data_;
+  };
+
+  // Returns the number of bytes left of a frame header whose start has been decoded.
+  uint64_t headerBytesLeft() const;
+
   Frame frame_;
   std::vector<Frame>* output_{nullptr};
   bool decoding_error_{false};
+  // The ranges of frame data found while inspecting the input, moved once it is all inspected.
+  std::vector<DataRange> data_ranges_;
+  // The number of frame header bytes inspected since the last frame data.
+  uint64_t header_bytes_{0};
 };
 
 } // namespace Grpc
@@ -1,5 +1,7 @@
 #include "common/grpc/google_async_client_impl.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3alpha/grpc_service.pb.h"
 #include "envoy/stats/scope.h"
 
@@ -17,57 +19,120 @@
 namespace Envoy {
 namespace Grpc {
 
-GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api)
+GoogleCompletionQueue::GoogleCompletionQueue(Api::Api& api)
     : completion_thread_(api.threadFactory().createThread([this] { completionThread(); })) {}
 
-GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
-  // Force streams to shutdown and invoke TryCancel() to start the drain of
-  // pending op. If we don't do this, Shutdown() below can jam on pending ops.
-  // This is also required to satisfy the contract that once Shutdown is called,
-  // streams no longer queue any additional tags.
-  for (auto it = streams_.begin(); it != streams_.end();) {
-    // resetStream() may result in immediate unregisterStream() and erase(),
-    // which would invalidate the iterator for the current element, so make sure
-    // we point to the next one first.
-    (*it++)->resetStream();
-  }
+GoogleCompletionQueue::~GoogleCompletionQueue() {
   cq_.Shutdown();
   ENVOY_LOG(debug, "Joining completionThread");
   completion_thread_->join();
   ENVOY_LOG(debug, "Joined completionThread");
-  // Ensure that we have cleaned up all orphan streams, now that CQ is gone.
-  while (!streams_.empty()) {
-    (*streams_.begin())->onCompletedOps();
+}
+
+void GoogleCompletionQueue::waitUntil(const std::function<bool()>& condition) {
+  Thread::LockGuard lock(batch_lock_);
+  while (!condition()) {
+    batch_done_.wait(batch_lock_);
   }
 }
 
-void GoogleAsyncClientThreadLocal::completionThread() {
+void GoogleCompletionQueue::completionThread() {
   ENVOY_LOG(debug, "completionThread running");
   void* tag;
   bool ok;
+  // The streams to post to each dispatcher, for the batch being handed.
+  std::vector<std::pair<Event::Dispatcher*, std::vector<GoogleAsyncStreamImpl*>>> posts;
   while (cq_.Next(&tag, &ok)) {
-    const auto& google_async_tag = *reinterpret_cast<GoogleAsyncTag*>(tag);
-    const GoogleAsyncTag::Operation op = google_async_tag.op_;
-    GoogleAsyncStreamImpl& stream = google_async_tag.stream_;
-    ENVOY_LOG(trace, "completionThread CQ event {} {}", op, ok);
-    Thread::LockGuard lock(stream.completed_ops_lock_);
-
-    // It's an invariant that there must only be one pending post for arbitrary
-    // length completed_ops_, otherwise we can race in stream destruction, where
-    // we process multiple events in onCompletedOps() but have only partially
-    // consumed the posts on the dispatcher.
-    // TODO(htuch): This may result in unbounded processing on the silo thread
-    // in onCompletedOps() in extreme cases, when we emplace_back() in
-    // completionThread() at a high rate, consider bounding the length of such
-    // sequences if this behavior becomes an issue.
-    if (stream.completed_ops_.empty()) {
-      stream.dispatcher_.post([&stream] { stream.onCompletedOps(); });
+    Thread::LockGuard batch_lock(batch_lock_);
+    uint32_t batch_size = 0;
+    do {
+      const auto& google_async_tag = *reinterpret_cast<GoogleAsyncTag*>(tag);
+      const GoogleAsyncTag::Operation op = google_async_tag.op_;
+      GoogleAsyncStreamImpl& stream = google_async_tag.stream_;
+      ENVOY_LOG(trace, "completionThread CQ event {} {}", op, ok);
+      Thread::LockGuard lock(stream.completed_ops_lock_);
+
+      // It's an invariant that there must only be one pending post for arbitrary
+      // length completed_ops_, otherwise we can race in stream destruction, where
+      // we process multiple events in onCompletedOps() but have only partially
+      // consumed the posts on the dispatcher.
+      // TODO(htuch): This may result in unbounded processing on the silo thread
+      // in onCompletedOps() in extreme cases, when we emplace_back() in
+      // completionThread() at a high rate, consider bounding the length of such
+      // sequences if this behavior becomes an issue.
+      if (stream.completed_ops_.empty()) {
+        auto it = std::find_if(posts.begin(), posts.end(), [&stream](const auto& post) {
+          return post.first == &stream.dispatcher_;
+        });
+        if (it == posts.end()) {
+          it = posts.emplace(posts.end(), &stream.dispatcher_,
+                             std::vector<GoogleAsyncStreamImpl*>());
+        }
+        it->second.push_back(&stream);
+      }
+      stream.completed_ops_.emplace_back(op, ok);
+    } while (++batch_size < MaxBatchSize &&
+             cq_.AsyncNext(&tag, &ok, gpr_time_0(GPR_CLOCK_REALTIME)) ==
+                 grpc::CompletionQueue::GOT_EVENT);
+
+    for (auto& post : posts) {
+      post.first->post([streams = std::move(post.second)] {
+        for (GoogleAsyncStreamImpl* stream : streams) {
+          stream->onCompletedOps();
+        }
+      });
     }
-    stream.completed_ops_.emplace_back(op, ok);
+    posts.clear();
+    batch_done_.notifyAll();
   }
   ENVOY_LOG(debug, "completionThread exiting");
 }
 
+GoogleCompletionQueuePool::GoogleCompletionQueuePool(Api::Api& api, uint32_t num_queues) {
+  ASSERT(num_queues > 0);
+  queues_.reserve(num_queues);
+  for (uint32_t i = 0; i < num_queues; ++i) {
+    queues_.push_back(std::make_shared<GoogleCompletionQueue>(api));
+  }
+}
+
+GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api)
+    : GoogleAsyncClientThreadLocal(std::make_shared<GoogleCompletionQueue>(api)) {}
+
+GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(
+    GoogleCompletionQueueSharedPtr completion_queue)
+    : completion_queue_(std::move(completion_queue)) {}
+
+GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
+  // Force streams to shutdown and invoke TryCancel() to start the drain of
+  // pending op. If we don't do this, Shutdown() of the completion queue can jam
+  // on pending ops. This is also required to satisfy the contract that once
+  // Shutdown is called, streams no longer queue any additional tags.
+  for (auto it = streams_.begin(); it != streams_.end();) {
+    // resetStream() may result in immediate unregisterStream() and erase(),
+    // which would invalidate the iterator for the current element, so make sure
+    // we point to the next one first.
+    (*it++)->resetStream();
+  }
+  // The completion queue may be shared with other silos, so rather than shutting it down, wait for
+  // it to hand the cancelled ops to the streams.
+  ENVOY_LOG(debug, "Waiting for the completion of the ops of {} streams", streams_.size());
+  completion_queue_->waitUntil([this] { return undeliveredOps() == 0; });
+  // Ensure that we have cleaned up all orphan streams, now that their ops are completed.
+  while (!streams_.empty()) {
+    (*streams_.begin())->onCompletedOps();
+  }
+}
+
+uint64_t GoogleAsyncClientThreadLocal::undeliveredOps() {
+  uint64_t undelivered_ops = 0;
+  for (GoogleAsyncStreamImpl* stream : streams_) {
+    Thread::LockGuard lock(stream->completed_ops_lock_);
+    undelivered_ops += stream->inflight_tags_ - stream->completed_ops_.size();
+  }
+  return undelivered_ops;
+}
+
 GoogleAsyncClientImpl::GoogleAsyncClientImpl(
     Event::Dispatcher& dispatcher, GoogleAsyncClientThreadLocal& tls,
     GoogleStubFactory& stub_factory, Stats::ScopeSharedPtr scope,
@@ -207,6 +272,7 @@ void GoogleAsyncStreamImpl::sendMessageRaw(Buffer::InstancePtr&& request, bool e
   write_pending_queue_.emplace(std::move(request), end_stream);
   ENVOY_LOG(trace, "Queued message to write ({} bytes)",
             write_pending_queue_.back().buf_.value().Length());
+  bytes_in_write_pending_queue_ += write_pending_queue_.back().buf_.value().Length();
   writeQueued();
 }
 
@@ -309,6 +375,7 @@ void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, boo
   case GoogleAsyncTag::Operation::Write: {
     ASSERT(ok);
     write_pending_ = false;
+    bytes_in_write_pending_queue_ -= write_pending_queue_.front().buf_.value().Length();
     write_pending_queue_.pop();
     writeQueued();
     break;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <queue>
 
 #include "envoy/api/api.h"
@@ -66,28 +67,36 @@ struct GoogleAsyncTag {
   }
 };
 
-class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
-                                     Logger::Loggable<Logger::Id::grpc> {
+/**
+ * A completion queue for the in-flight operations of the Google gRPC clients, polled by a
+ * dedicated thread. The threading model for the Google gRPC C++ library is not directly compatible
+ * with Envoy's siloed model. We resolve this by issuing non-blocking asynchronous operations on the
+ * GoogleAsyncClientImpl silo thread, and then synchronously blocking on the completion queue on a
+ * distinct thread. When events are delivered, we cross-post to the silo dispatcher to continue the
+ * operation. The events ready together are handed to their streams as a batch, with a single post
+ * per dispatcher for all the streams of the batch. A completion queue may be shared by the silos.
+ */
+class GoogleCompletionQueue : Logger::Loggable<Logger::Id::grpc> {
 public:
-  GoogleAsyncClientThreadLocal(Api::Api& api);
-  ~GoogleAsyncClientThreadLocal() override;
+  explicit GoogleCompletionQueue(Api::Api& api);
+  ~GoogleCompletionQueue();
 
   grpc::CompletionQueue& completionQueue() { return cq_; }
 
-  void registerStream(GoogleAsyncStreamImpl* stream) {
-    ASSERT(streams_.find(stream) == streams_.end());
-    streams_.insert(stream);
-  }
-
-  void unregisterStream(GoogleAsyncStreamImpl* stream) {
-    auto it = streams_.find(stream);
-    ASSERT(it != streams_.end());
-    streams_.erase(it);
-  }
+  /**
+   * Block until a condition holds, checking it between the batches of events handed to the
+   * streams.
+   * @param condition supplies the condition to wait for.
+   */
+  void waitUntil(const std::function<bool()>& condition);
 
 private:
   void completionThread();
 
+  // The maximum number of events handed to the streams before posting to their dispatchers, so
+  // that the silos are not delayed by a steady flow of events.
+  static constexpr uint32_t MaxBatchSize = 64;
+
   // There is blanket google-grpc initialization in MainCommonBase, but that
   // doesn't cover unit tests. However, putting blanket coverage in ProcessWide
   // causes background threaded memory allocation in all unit tests making it
@@ -99,16 +108,63 @@ private:
   // The CompletionQueue for in-flight operations. This must precede completion_thread_ to ensure it
   // is constructed before the thread runs.
   grpc::CompletionQueue cq_;
-  // The threading model for the Google gRPC C++ library is not directly compatible with Envoy's
-  // siloed model. We resolve this by issuing non-blocking asynchronous
-  // operations on the GoogleAsyncClientImpl silo thread, and then synchronously
-  // blocking on a completion queue, cq_, on a distinct thread. When cq_ events
-  // are delivered, we cross-post to the silo dispatcher to continue the
-  // operation.
-  //
-  // We have an independent completion thread for each TLS silo (i.e. one per worker and
-  // also one for the main thread).
+  // Held by completionThread() while it hands a batch of events to the streams and posts them to
+  // their dispatchers.
+  Thread::MutexBasicLockable batch_lock_;
+  Thread::CondVar batch_done_;
   Thread::ThreadPtr completion_thread_;
+};
+
+using GoogleCompletionQueueSharedPtr = std::shared_ptr<GoogleCompletionQueue>;
+
+/**
+ * A fixed number of completion queues shared by the silos, handed out in turn, so that the number
+ * of completion threads does not grow with the number of workers.
+ */
+class GoogleCompletionQueuePool {
+public:
+  GoogleCompletionQueuePool(Api::Api& api, uint32_t num_queues);
+
+  /**
+   * @return GoogleCompletionQueueSharedPtr the completion queue for a silo.
+   */
+  GoogleCompletionQueueSharedPtr next() {
+    return queues_[next_.fetch_add(1, std::memory_order_relaxed) % queues_.size()];
+  }
+
+private:
+  std::vector<GoogleCompletionQueueSharedPtr> queues_;
+  std::atomic<uint32_t> next_{};
+};
+
+class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
+                                     Logger::Loggable<Logger::Id::grpc> {
+public:
+  // With a completion queue of its own.
+  GoogleAsyncClientThreadLocal(Api::Api& api);
+  // With a completion queue shared with other silos.
+  GoogleAsyncClientThreadLocal(GoogleCompletionQueueSharedPtr completion_queue);
+  ~GoogleAsyncClientThreadLocal() override;
+
+  grpc::CompletionQueue& completionQueue() { return completion_queue_->completionQueue(); }
+
+  void registerStream(GoogleAsyncStreamImpl* stream) {
+    ASSERT(streams_.find(stream) == streams_.end());
+    streams_.insert(stream);
+  }
+
+  void unregisterStream(GoogleAsyncStreamImpl* stream) {
+    auto it = streams_.find(stream);
+    ASSERT(it != streams_.end());
+    streams_.erase(it);
+  }
+
+private:
+  // @return uint64_t the number of in-flight operations of the streams whose completion has not
+  //         been handed to them yet.
+  uint64_t undeliveredOps();
+
+  GoogleCompletionQueueSharedPtr completion_queue_;
   // Track all streams that are currently using this CQ, so we can notify them
   // on shutdown.
   std::unordered_set<GoogleAsyncStreamImpl*> streams_;
@@ -220,6 +276,11 @@ public:
   void sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
+  // While the completion queue does not report flow control, the messages queued for writing are
+  // bounded like the buffers of the Envoy gRPC client.
+  bool isAboveWriteBufferHighWatermark() const override {
+    return bytes_in_write_pending_queue_ > WriteBufferHighWatermarkBytes;
+  }
 
 protected:
   bool call_failed() const { return call_failed_; }
@@ -229,7 +290,7 @@ private:
   // GoogleAsyncClient silo thread.
   void onCompletedOps();
   // Handle Operation completion on GoogleAsyncClient silo thread. This is posted by
-  // GoogleAsyncClientThreadLocal::completionThread() when a message is received on cq_.
+  // GoogleCompletionQueue::completionThread() when a message is received on its queue.
   void handleOpCompletion(GoogleAsyncTag::Operation op, bool ok);
   // Convert from Google gRPC client std::multimap metadata to Envoy Http::HeaderMap.
   void metadataTranslate(const std::multimap<grpc::string_ref, grpc::string_ref>& grpc_metadata,
@@ -245,6 +306,9 @@ private:
   // completions.
   void cleanup();
 
+  // The default buffer limit of the connections of the Envoy gRPC client.
+  static constexpr uint64_t WriteBufferHighWatermarkBytes = 1024 * 1024;
+
   // Pending serialized message on write queue. Only one Operation::Write is in-flight at any
   // point-in-time, so we queue pending writes here.
   struct PendingMessage {
@@ -280,6 +344,7 @@ private:
   grpc::ClientContext ctxt_;
   std::unique_ptr<grpc::GenericClientAsyncReaderWriter> rw_;
   std::queue<PendingMessage> write_pending_queue_;
+  uint64_t bytes_in_write_pending_queue_{};
   grpc::ByteBuffer read_buf_;
   grpc::Status status_;
   // Has Operation::Init completed?
@@ -304,6 +369,7 @@ private:
 
   friend class GoogleAsyncClientImpl;
   friend class GoogleAsyncClientThreadLocal;
+  friend class GoogleCompletionQueue;
 };
 
 class GoogleAsyncRequestImpl : public AsyncRequest,
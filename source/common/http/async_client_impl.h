@@ -94,6 +94,7 @@ public:
   void sendData(Buffer::Instance& data, bool end_stream) override;
   void sendTrailers(HeaderMap& trailers) override;
   void reset() override;
+  bool isAboveWriteBufferHighWatermark() const override { return high_watermark_calls_ > 0; }
 
 protected:
   bool remoteClosed() { return remote_closed_; }
@@ -110,6 +111,7 @@ private:
       return additional_request_chance_;
     }
     bool hedgeOnPerTryTimeout() const override { return false; }
+    const Router::LatencyHedgePolicy* latencyHedgePolicy() const override { return nullptr; }
 
     const envoy::type::v3alpha::FractionalPercent additional_request_chance_;
   };
@@ -251,6 +253,9 @@ private:
     const Router::TlsContextMatchCriteria* tlsContextMatchCriteria() const override {
       return nullptr;
     }
+    const Router::RequestCollapsingPolicy* requestCollapsingPolicy() const override {
+      return nullptr;
+    }
     const std::multimap<std::string, std::string>& opaqueConfig() const override {
       return opaque_config_;
     }
@@ -273,7 +278,7 @@ private:
       return Router::InternalRedirectAction::PassThrough;
     }
     uint32_t maxInternalRedirects() const override { return 1; }
-    const std::string& routeName() const override { return route_name_; }
+    const std::string& routeName() const override { return EMPTY_STRING; }
     std::unique_ptr<const HashPolicyImpl> hash_policy_;
     static const NullHedgePolicy hedge_policy_;
     static const NullRateLimitPolicy rate_limit_policy_;
@@ -285,11 +290,10 @@ private:
     // Async client doesn't require metadata.
     static const Config::TypedMetadataImpl<Config::TypedMetadataFactory> typed_metadata_;
     static const NullPathMatchCriterion path_match_criterion_;
+    static const Router::RouteEntry::UpgradeMap upgrade_map_;
 
-    Router::RouteEntry::UpgradeMap upgrade_map_;
     const std::string& cluster_name_;
     absl::optional<std::chrono::milliseconds> timeout_;
-    const std::string route_name_;
   };
 
   struct RouteImpl : public Router::Route {
@@ -319,7 +323,10 @@ private:
   const Network::Connection* connection() override { return nullptr; }
   Event::Dispatcher& dispatcher() override { return parent_.dispatcher_; }
   void resetStream() override;
-  Router::RouteConstSharedPtr route() override { return route_; }
+  Router::RouteConstSharedPtr route() override {
+    // The route is owned by the stream, which outlives the router filter holding it.
+    return Router::RouteConstSharedPtr(Router::RouteConstSharedPtr(), &route_);
+  }
   Upstream::ClusterInfoConstSharedPtr clusterInfo() override { return parent_.cluster_; }
   void clearRouteCache() override {}
   uint64_t streamId() override { return stream_id_; }
@@ -364,8 +371,11 @@ private:
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void encodeTrailers(HeaderMapPtr&& trailers) override;
   void encodeMetadata(MetadataMapPtr&&) override {}
-  void onDecoderFilterAboveWriteBufferHighWatermark() override {}
-  void onDecoderFilterBelowWriteBufferLowWatermark() override {}
+  void onDecoderFilterAboveWriteBufferHighWatermark() override { ++high_watermark_calls_; }
+  void onDecoderFilterBelowWriteBufferLowWatermark() override {
+    ASSERT(high_watermark_calls_ > 0);
+    --high_watermark_calls_;
+  }
   void addDownstreamWatermarkCallbacks(DownstreamWatermarkCallbacks&) override {}
   void removeDownstreamWatermarkCallbacks(DownstreamWatermarkCallbacks&) override {}
   void setDecoderBufferLimit(uint32_t) override {}
@@ -388,13 +398,16 @@ private:
   StreamInfo::StreamInfoImpl stream_info_;
   Tracing::NullSpan active_span_;
   const Tracing::Config& tracing_config_;
-  std::shared_ptr<RouteImpl> route_;
+  const RouteImpl route_;
   bool local_closed_{};
   bool remote_closed_{};
   Buffer::InstancePtr buffered_body_;
   bool is_grpc_request_{};
   bool is_head_request_{false};
   bool send_xff_{true};
+  // The number of times the router reported the upstream above its high watermark and not yet
+  // below its low watermark.
+  uint32_t high_watermark_calls_{};
 
   friend class AsyncClientImpl;
   friend class AsyncClientImplUnitTest;
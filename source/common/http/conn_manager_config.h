@@ -10,6 +10,8 @@
 #include "common/http/date_provider.h"
 #include "common/network/utility.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -51,6 +53,7 @@ namespace Http {
   COUNTER(downstream_rq_idle_timeout)                                                              \
   COUNTER(downstream_rq_non_relative_path)                                                         \
   COUNTER(downstream_rq_overload_close)                                                            \
+  COUNTER(downstream_rq_overload_reset)                                                            \
   COUNTER(downstream_rq_response_before_rq_complete)                                               \
   COUNTER(downstream_rq_rx_reset)                                                                  \
   COUNTER(downstream_rq_timeout)                                                                   \
@@ -69,6 +72,7 @@ namespace Http {
   GAUGE(downstream_cx_upgrades_active, Accumulate)                                                 \
   GAUGE(downstream_rq_active, Accumulate)                                                          \
   HISTOGRAM(downstream_cx_length_ms, Milliseconds)                                                 \
+  HISTOGRAM(downstream_cx_reads_per_event, Unspecified)                                            \
   HISTOGRAM(downstream_rq_time, Milliseconds)
 
 /**
@@ -127,6 +131,7 @@ using TracingConnectionManagerConfigPtr = std::unique_ptr<TracingConnectionManag
   COUNTER(downstream_rq_3xx)                                                                       \
   COUNTER(downstream_rq_4xx)                                                                       \
   COUNTER(downstream_rq_5xx)                                                                       \
+  COUNTER(downstream_rq_arena_bytes)                                                               \
   COUNTER(downstream_rq_completed)
 
 /**
@@ -172,6 +177,42 @@ public:
   }
 };
 
+/**
+ * Configuration for moving the request bodies buffered by the filters to temporary files.
+ */
+struct RequestBodySpillConfig {
+  // The directory the temporary files are created in.
+  std::string directory_;
+  // The number of bytes of each buffered body kept in memory.
+  uint64_t memory_threshold_bytes_;
+};
+
+/**
+ * Time spent by the sampled streams in an HTTP filter. @see stats_macros.h
+ */
+#define ALL_HTTP_FILTER_TIMING_STATS(HISTOGRAM)                                                    \
+  HISTOGRAM(decode_us, Microseconds)                                                               \
+  HISTOGRAM(decode_paused_us, Microseconds)                                                        \
+  HISTOGRAM(encode_us, Microseconds)                                                               \
+  HISTOGRAM(encode_paused_us, Microseconds)
+
+/**
+ * Wrapper struct for HTTP filter timing stats. @see stats_macros.h
+ */
+struct FilterTimingStats {
+  ALL_HTTP_FILTER_TIMING_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Configuration for timing the HTTP filters of a sample of the streams.
+ */
+struct FilterTimingConfig {
+  // The number of streams timed out of every 10000.
+  uint64_t sampling_;
+  // The stats of each filter, by filter name.
+  absl::flat_hash_map<std::string, FilterTimingStats> stats_;
+};
+
 /**
  * Abstract configuration for the connection manager.
  */
@@ -391,6 +432,24 @@ public:
    * one.
    */
   virtual bool shouldMergeSlashes() const PURE;
+
+  /**
+   * @return uint32_t the block size of the per-stream arena that filter chain wrappers are
+   *         allocated from, or 0 if the arena is disabled.
+   */
+  virtual uint32_t streamArenaBlockSize() const PURE;
+
+  /**
+   * @return the configuration moving the buffered request bodies past a threshold to temporary
+   *         files, or nullopt if they are kept in memory.
+   */
+  virtual const absl::optional<RequestBodySpillConfig>& requestBodySpill() const PURE;
+
+  /**
+   * @return the configuration timing the filters of a sample of the streams, or nullopt if the
+   *         filters are not timed.
+   */
+  virtual const absl::optional<FilterTimingConfig>& filterTiming() const PURE;
 };
 } // namespace Http
 } // namespace Envoy
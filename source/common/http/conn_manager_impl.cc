@@ -36,6 +36,7 @@
 #include "common/http/path_utility.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
+#include "common/protobuf/protobuf.h"
 #include "common/router/config_impl.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/stats/timespan_impl.h"
@@ -76,6 +77,34 @@ void recordLatestDataFilter(const typename FilterList<T>::iterator current_filte
   }
 }
 
+// The filter state exposing the time spent by a sampled stream in each filter to the access logs.
+constexpr absl::string_view FilterTimingStateName = "envoy.http.filter_timing";
+
+// The time spent by a stream in its filters, serialized as a struct of the times in microseconds
+// by filter name, e.g. {"envoy.router": {"decode_us": 12, "decode_paused_us": 0, ...}}.
+class FilterTimingState : public StreamInfo::FilterState::Object {
+public:
+  void add(absl::string_view name, bool encoder, std::chrono::microseconds spent,
+           std::chrono::microseconds paused) {
+    auto& fields = *(*times_.mutable_fields())[std::string(name)]
+                        .mutable_struct_value()
+                        ->mutable_fields();
+    // The times of the filters configured more than once are added up.
+    ProtobufWkt::Value& spent_value = fields[encoder ? "encode_us" : "decode_us"];
+    spent_value.set_number_value(spent_value.number_value() + spent.count());
+    ProtobufWkt::Value& paused_value = fields[encoder ? "encode_paused_us" : "decode_paused_us"];
+    paused_value.set_number_value(paused_value.number_value() + paused.count());
+  }
+
+  // StreamInfo::FilterState::Object
+  ProtobufTypes::MessagePtr serializeAsProto() const override {
+    return std::make_unique<ProtobufWkt::Struct>(times_);
+  }
+
+private:
+  ProtobufWkt::Struct times_;
+};
+
 } // namespace
 
 ConnectionManagerStats ConnectionManagerImpl::generateStats(const std::string& prefix,
@@ -119,7 +148,7 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_manager ? overload_manager->getThreadLocalOverloadState().getState(
                                  Server::OverloadActionNames::get().DisableHttpKeepAlive)
                            : Server::OverloadManager::getInactiveState()),
-      time_source_(time_source) {}
+      track_stream_memory_(overload_manager != nullptr), time_source_(time_source) {}
 
 const HeaderMapImpl& ConnectionManagerImpl::continueHeader() {
   CONSTRUCT_ON_FIRST_USE(HeaderMapImpl,
@@ -138,13 +167,13 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   read_callbacks_->connection().addConnectionCallbacks(*this);
 
   if (config_.idleTimeout()) {
-    connection_idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
+    connection_idle_timer_ = read_callbacks_->connection().dispatcher().createCoarseTimer(
         [this]() -> void { onIdleTimeout(); });
     connection_idle_timer_->enableTimer(config_.idleTimeout().value());
   }
 
   if (config_.maxConnectionDuration()) {
-    connection_duration_timer_ = read_callbacks_->connection().dispatcher().createTimer(
+    connection_duration_timer_ = read_callbacks_->connection().dispatcher().createCoarseTimer(
         [this]() -> void { onConnectionDurationTimeout(); });
     connection_duration_timer_->enableTimer(config_.maxConnectionDuration().value());
   }
@@ -154,7 +183,8 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   read_callbacks_->connection().setConnectionStats(
       {stats_.named_.downstream_cx_rx_bytes_total_, stats_.named_.downstream_cx_rx_bytes_buffered_,
        stats_.named_.downstream_cx_tx_bytes_total_, stats_.named_.downstream_cx_tx_bytes_buffered_,
-       nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_});
+       nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_,
+       &stats_.named_.downstream_cx_reads_per_event_});
 }
 
 ConnectionManagerImpl::~ConnectionManagerImpl() {
@@ -236,6 +266,9 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
   stream.disarmRequestTimeout();
 
   stream.state_.destroyed_ = true;
+  if (track_stream_memory_) {
+    StreamMemoryTracker::threadTracker().remove(stream);
+  }
   for (auto& filter : stream.decoder_filters_) {
     filter->handle_->onDestroy();
   }
@@ -270,6 +303,9 @@ StreamDecoder& ConnectionManagerImpl::newStream(StreamEncoder& response_encoder,
   // Both HTTP/1.x and HTTP/2 codecs handle this in StreamCallbackHelper::addCallbacks_.
   ASSERT(read_callbacks_->connection().aboveHighWatermark() == false ||
          new_stream->high_watermark_count_ > 0);
+  if (track_stream_memory_) {
+    StreamMemoryTracker::threadTracker().add(*new_stream);
+  }
   new_stream->moveIntoList(std::move(new_stream), streams_);
   return **streams_.begin();
 }
@@ -503,6 +539,15 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
       stream_info_(connection_manager_.codec_->protocol(), connection_manager_.timeSource(),
                    connection_manager.filterState()),
       upstream_options_(std::make_shared<Network::Socket::Options>()) {
+  if (connection_manager_.config_.streamArenaBlockSize() > 0) {
+    arena_ = std::make_unique<Arena>(connection_manager_.config_.streamArenaBlockSize());
+  }
+  const absl::optional<FilterTimingConfig>& filter_timing =
+      connection_manager_.config_.filterTiming();
+  if (filter_timing.has_value() &&
+      connection_manager_.random_generator_.random() % 10000 < filter_timing->sampling_) {
+    filter_timing_ = &filter_timing.value();
+  }
   ASSERT(!connection_manager.config_.isRoutable() ||
              ((connection_manager.config_.routeConfigProvider() == nullptr &&
                connection_manager.config_.scopedRouteConfigProvider() != nullptr) ||
@@ -547,15 +592,17 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.streamIdleTimeout().count()) {
     idle_timeout_ms_ = connection_manager_.config_.streamIdleTimeout();
-    stream_idle_timer_ = connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onIdleTimeout(); });
+    stream_idle_timer_ =
+        connection_manager_.read_callbacks_->connection().dispatcher().createCoarseTimer(
+            [this]() -> void { onIdleTimeout(); });
     resetIdleTimer();
   }
 
   if (connection_manager_.config_.requestTimeout().count()) {
     std::chrono::milliseconds request_timeout_ms_ = connection_manager_.config_.requestTimeout();
-    request_timer_ = connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onRequestTimeout(); });
+    request_timer_ =
+        connection_manager.read_callbacks_->connection().dispatcher().createCoarseTimer(
+            [this]() -> void { onRequestTimeout(); });
     request_timer_->enableTimer(request_timeout_ms_, this);
   }
 
@@ -564,6 +611,9 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 }
 
 ConnectionManagerImpl::ActiveStream::~ActiveStream() {
+  if (connection_manager_.track_stream_memory_) {
+    StreamMemoryTracker::threadTracker().remove(*this);
+  }
   stream_info_.onRequestComplete();
 
   // A downstream disconnect can be identified for HTTP requests when the upstream returns with a 0
@@ -573,6 +623,9 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
   }
 
   connection_manager_.stats_.named_.downstream_rq_active_.dec();
+  if (filter_timing_ != nullptr) {
+    recordFilterTiming();
+  }
   for (const AccessLog::InstanceSharedPtr& access_log : connection_manager_.config_.accessLogs()) {
     access_log->log(request_headers_.get(), response_headers_.get(), response_trailers_.get(),
                     stream_info_);
@@ -594,6 +647,9 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
   if (state_.successful_upgrade_) {
     connection_manager_.stats_.named_.downstream_cx_upgrades_active_.dec();
   }
+  if (arena_ != nullptr) {
+    connection_manager_.listener_stats_.downstream_rq_arena_bytes_.add(arena_->bytesAllocated());
+  }
 
   ASSERT(state_.filter_call_state_ == 0);
 }
@@ -607,6 +663,36 @@ void ConnectionManagerImpl::ActiveStream::resetIdleTimer() {
   }
 }
 
+uint64_t ConnectionManagerImpl::ActiveStream::bufferedBytes() {
+  uint64_t bytes = 0;
+  if (buffered_request_data_ != nullptr) {
+    bytes += buffered_request_data_->length();
+  }
+  if (buffered_response_data_ != nullptr) {
+    bytes += buffered_response_data_->length();
+  }
+  if (response_encoder_ != nullptr) {
+    bytes += response_encoder_->getStream().bufferedBytes();
+  }
+  for (const ActiveStreamDecoderFilterPtr& filter : decoder_filters_) {
+    bytes += filter->handle_->bufferedBytes();
+  }
+  for (const ActiveStreamEncoderFilterPtr& filter : encoder_filters_) {
+    // Dual filters were counted as decoder filters.
+    if (!filter->dual_filter_) {
+      bytes += filter->handle_->bufferedBytes();
+    }
+  }
+  return bytes;
+}
+
+void ConnectionManagerImpl::ActiveStream::resetForMemory() {
+  ENVOY_STREAM_LOG(debug, "resetting stream holding the most memory due to Envoy overload", *this);
+  connection_manager_.stats_.named_.downstream_rq_overload_reset_.inc();
+  stream_info_.setResponseFlag(StreamInfo::ResponseFlag::LocalReset);
+  connection_manager_.doEndStream(*this);
+}
+
 void ConnectionManagerImpl::ActiveStream::onIdleTimeout() {
   connection_manager_.stats_.named_.downstream_rq_idle_timeout_.inc();
   // If headers have not been sent to the user, send a 408.
@@ -632,18 +718,61 @@ void ConnectionManagerImpl::ActiveStream::onRequestTimeout() {
 
 void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
+  ActiveStreamDecoderFilterPtr wrapper(
+      new (arena_.get()) ActiveStreamDecoderFilter(*this, filter, dual_filter));
+  wrapper->timing_ = createFilterTiming(false);
   filter->setDecoderFilterCallbacks(*wrapper);
   wrapper->moveIntoListBack(std::move(wrapper), decoder_filters_);
 }
 
 void ConnectionManagerImpl::ActiveStream::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(*this, filter, dual_filter));
+  ActiveStreamEncoderFilterPtr wrapper(
+      new (arena_.get()) ActiveStreamEncoderFilter(*this, filter, dual_filter));
+  wrapper->timing_ = createFilterTiming(true);
   filter->setEncoderFilterCallbacks(*wrapper);
   wrapper->moveIntoList(std::move(wrapper), encoder_filters_);
 }
 
+std::unique_ptr<ConnectionManagerImpl::ActiveStreamFilterBase::FilterTiming>
+ConnectionManagerImpl::ActiveStream::createFilterTiming(bool encoder) {
+  if (filter_timing_ == nullptr) {
+    return nullptr;
+  }
+  // Filters added without a configured name, e.g. by tests, are not timed.
+  const auto it = filter_timing_->stats_.find(filter_name_);
+  if (it == filter_timing_->stats_.end()) {
+    return nullptr;
+  }
+  const FilterTimingStats& stats = it->second;
+  return std::make_unique<ActiveStreamFilterBase::FilterTiming>(
+      filter_name_, encoder, encoder ? stats.encode_us_ : stats.decode_us_,
+      encoder ? stats.encode_paused_us_ : stats.decode_paused_us_);
+}
+
+void ConnectionManagerImpl::ActiveStream::recordFilterTiming() {
+  auto state = std::make_shared<FilterTimingState>();
+  const auto record = [&state](const ActiveStreamFilterBase& filter) {
+    // The filters never called, e.g. after a local reply, and the time spent paused by those
+    // never continuing are left out.
+    if (filter.timing_ == nullptr || !filter.timing_->called_) {
+      return;
+    }
+    const ActiveStreamFilterBase::FilterTiming& timing = *filter.timing_;
+    timing.spent_histogram_.recordValue(timing.spent_.count());
+    timing.paused_histogram_.recordValue(timing.paused_.count());
+    state->add(timing.name_, timing.encoder_, timing.spent_, timing.paused_);
+  };
+  for (const ActiveStreamDecoderFilterPtr& filter : decoder_filters_) {
+    record(*filter);
+  }
+  for (const ActiveStreamEncoderFilterPtr& filter : encoder_filters_) {
+    record(*filter);
+  }
+  stream_info_.filterState().setData(FilterTimingStateName, state,
+                                     StreamInfo::FilterState::StateType::ReadOnly);
+}
+
 void ConnectionManagerImpl::ActiveStream::addAccessLogHandler(
     AccessLog::InstanceSharedPtr handler) {
   access_log_handlers_.push_back(handler);
@@ -724,9 +853,14 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(HeaderMapPtr&& headers,
   // called with end_stream=true.
   maybeEndDecode(end_stream);
 
-  // Drop new requests when overloaded as soon as we have decoded the headers.
-  if (connection_manager_.overload_stop_accepting_requests_ref_ ==
-      Server::OverloadActionState::Active) {
+  // Drop new requests when overloaded as soon as we have decoded the headers. While the action is
+  // scaled, drop the same fraction of them.
+  const Server::OverloadActionState& stop_accepting_requests =
+      connection_manager_.overload_stop_accepting_requests_ref_;
+  if (stop_accepting_requests.isSaturated() ||
+      (stop_accepting_requests != Server::OverloadActionState::inactive() &&
+       connection_manager_.random_generator_.random() % 10000 <
+           stop_accepting_requests.value() * 10000)) {
     // In this one special case, do not create the filter chain. If there is a risk of memory
     // overload it is more important to avoid unnecessary allocation than to create the filters.
     state_.created_filter_chain_ = true;
@@ -879,7 +1013,7 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(HeaderMapPtr&& headers,
         // If we have a route-level idle timeout but no global stream idle timeout, create a timer.
         if (stream_idle_timer_ == nullptr) {
           stream_idle_timer_ =
-              connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
+              connection_manager_.read_callbacks_->connection().dispatcher().createCoarseTimer(
                   [this]() -> void { onIdleTimeout(); });
         }
       } else if (stream_idle_timer_ != nullptr) {
@@ -966,7 +1100,9 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilte
     state_.filter_call_state_ |= FilterCallState::DecodeHeaders;
     (*entry)->end_stream_ =
         decoding_headers_only_ || (end_stream && continue_data_entry == decoder_filters_.end());
+    const absl::optional<MonotonicTime> callback_start = (*entry)->startCallbackTiming();
     FilterHeadersStatus status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    (*entry)->endCallbackTiming(callback_start, status);
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndEndStream && (*entry)->end_stream_));
     state_.filter_call_state_ &= ~FilterCallState::DecodeHeaders;
@@ -1101,10 +1237,12 @@ void ConnectionManagerImpl::ActiveStream::decodeData(
 
     state_.filter_call_state_ |= FilterCallState::DecodeData;
     (*entry)->end_stream_ = end_stream && !request_trailers_;
+    const absl::optional<MonotonicTime> callback_start = (*entry)->startCallbackTiming();
     FilterDataStatus status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
     if ((*entry)->end_stream_) {
       (*entry)->handle_->decodeComplete();
     }
+    (*entry)->endCallbackTiming(callback_start, status);
     state_.filter_call_state_ &= ~FilterCallState::DecodeData;
     if (end_stream) {
       state_.filter_call_state_ &= ~FilterCallState::LastDataFrame;
@@ -1209,8 +1347,10 @@ void ConnectionManagerImpl::ActiveStream::decodeTrailers(ActiveStreamDecoderFilt
 
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeTrailers));
     state_.filter_call_state_ |= FilterCallState::DecodeTrailers;
+    const absl::optional<MonotonicTime> callback_start = (*entry)->startCallbackTiming();
     FilterTrailersStatus status = (*entry)->handle_->decodeTrailers(trailers);
     (*entry)->handle_->decodeComplete();
+    (*entry)->endCallbackTiming(callback_start, status);
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::DecodeTrailers;
     ENVOY_STREAM_LOG(trace, "decode trailers called: filter={} status={}", *this,
@@ -1312,7 +1452,7 @@ void ConnectionManagerImpl::startDrainSequence() {
   ASSERT(drain_state_ == DrainState::NotDraining);
   drain_state_ = DrainState::Draining;
   codec_->shutdownNotice();
-  drain_timer_ = read_callbacks_->connection().dispatcher().createTimer(
+  drain_timer_ = read_callbacks_->connection().dispatcher().createCoarseTimer(
       [this]() -> void { onDrainTimeout(); });
   drain_timer_->enableTimer(config_.drainTimeout());
 }
@@ -1484,10 +1624,12 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilte
     state_.filter_call_state_ |= FilterCallState::EncodeHeaders;
     (*entry)->end_stream_ =
         encoding_headers_only_ || (end_stream && continue_data_entry == encoder_filters_.end());
+    const absl::optional<MonotonicTime> callback_start = (*entry)->startCallbackTiming();
     FilterHeadersStatus status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
     if ((*entry)->end_stream_) {
       (*entry)->handle_->encodeComplete();
     }
+    (*entry)->endCallbackTiming(callback_start, status);
     state_.filter_call_state_ &= ~FilterCallState::EncodeHeaders;
     ENVOY_STREAM_LOG(trace, "encode headers called: filter={} status={}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status));
@@ -1544,7 +1686,7 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilte
   }
 
   if (connection_manager_.drain_state_ == DrainState::NotDraining &&
-      connection_manager_.overload_disable_keepalive_ref_ == Server::OverloadActionState::Active) {
+      connection_manager_.overload_disable_keepalive_ref_.isSaturated()) {
     ENVOY_STREAM_LOG(debug, "disabling keepalive due to envoy overload", *this);
     connection_manager_.drain_state_ = DrainState::Closing;
     connection_manager_.stats_.named_.downstream_cx_overload_disable_keepalive_.inc();
@@ -1727,10 +1869,12 @@ void ConnectionManagerImpl::ActiveStream::encodeData(
     recordLatestDataFilter(entry, state_.latest_data_encoding_filter_, encoder_filters_);
 
     (*entry)->end_stream_ = end_stream && !response_trailers_;
+    const absl::optional<MonotonicTime> callback_start = (*entry)->startCallbackTiming();
     FilterDataStatus status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
     if ((*entry)->end_stream_) {
       (*entry)->handle_->encodeComplete();
     }
+    (*entry)->endCallbackTiming(callback_start, status);
     state_.filter_call_state_ &= ~FilterCallState::EncodeData;
     if (end_stream) {
       state_.filter_call_state_ &= ~FilterCallState::LastDataFrame;
@@ -1783,8 +1927,10 @@ void ConnectionManagerImpl::ActiveStream::encodeTrailers(ActiveStreamEncoderFilt
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
+    const absl::optional<MonotonicTime> callback_start = (*entry)->startCallbackTiming();
     FilterTrailersStatus status = (*entry)->handle_->encodeTrailers(trailers);
     (*entry)->handle_->encodeComplete();
+    (*entry)->endCallbackTiming(callback_start, status);
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::EncodeTrailers;
     ENVOY_STREAM_LOG(trace, "encode trailers called: filter={} status={}", *this,
@@ -1930,6 +2076,52 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
   return !upgrade_rejected;
 }
 
+namespace {
+// Wrapper allocations are prefixed with the arena they came from (or nullptr for the heap) so that
+// operator delete knows whether the memory must be released. The prefix keeps the object aligned.
+constexpr size_t FilterWrapperPrefixSize = alignof(std::max_align_t);
+static_assert(sizeof(Arena*) <= FilterWrapperPrefixSize, "prefix too small");
+} // namespace
+
+void* ConnectionManagerImpl::ActiveStreamFilterBase::operator new(size_t size, Arena* arena) {
+  const size_t total_size = size + FilterWrapperPrefixSize;
+  char* memory = static_cast<char*>(arena != nullptr ? arena->allocate(total_size)
+                                                     : ::operator new(total_size));
+  *reinterpret_cast<Arena**>(memory) = arena;
+  return memory + FilterWrapperPrefixSize;
+}
+
+void ConnectionManagerImpl::ActiveStreamFilterBase::operator delete(void* p, Arena*) {
+  operator delete(p);
+}
+
+void ConnectionManagerImpl::ActiveStreamFilterBase::operator delete(void* p) {
+  char* memory = static_cast<char*>(p) - FilterWrapperPrefixSize;
+  if (*reinterpret_cast<Arena**>(memory) == nullptr) {
+    ::operator delete(memory);
+  }
+}
+
+absl::optional<MonotonicTime> ConnectionManagerImpl::ActiveStreamFilterBase::startCallbackTiming() {
+  if (timing_ == nullptr) {
+    return absl::nullopt;
+  }
+  return parent_.connection_manager_.timeSource().monotonicTime();
+}
+
+void ConnectionManagerImpl::ActiveStreamFilterBase::endCallbackTiming(
+    const absl::optional<MonotonicTime>& start, bool stopped) {
+  if (!start.has_value()) {
+    return;
+  }
+  const MonotonicTime now = parent_.connection_manager_.timeSource().monotonicTime();
+  timing_->called_ = true;
+  timing_->spent_ += std::chrono::duration_cast<std::chrono::microseconds>(now - start.value());
+  if (stopped && !timing_->paused_since_.has_value()) {
+    timing_->paused_since_ = now;
+  }
+}
+
 void ConnectionManagerImpl::ActiveStreamFilterBase::commonContinue() {
   // TODO(mattklein123): Raise an error if this is called during a callback.
   if (!canContinue()) {
@@ -1941,6 +2133,11 @@ void ConnectionManagerImpl::ActiveStreamFilterBase::commonContinue() {
   ENVOY_STREAM_LOG(trace, "continuing filter chain: filter={}", parent_,
                    static_cast<const void*>(this));
   ASSERT(!canIterate());
+  if (timing_ != nullptr && timing_->paused_since_.has_value()) {
+    timing_->paused_ += std::chrono::duration_cast<std::chrono::microseconds>(
+        parent_.connection_manager_.timeSource().monotonicTime() - timing_->paused_since_.value());
+    timing_->paused_since_ = absl::nullopt;
+  }
   // If iteration has stopped for all frame types, set iterate_from_current_filter_ to true so the
   // filter iteration starts with the current filter instead of the next one.
   if (stoppedAll()) {
@@ -2143,6 +2340,11 @@ Buffer::WatermarkBufferPtr ConnectionManagerImpl::ActiveStreamDecoderFilter::cre
       std::make_unique<Buffer::WatermarkBuffer>([this]() -> void { this->requestDataDrained(); },
                                                 [this]() -> void { this->requestDataTooLarge(); });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->setMemoryAccount(Buffer::MemoryAccount::create(Buffer::MemoryClass::FilterBody));
+  const auto& spill = parent_.connection_manager_.config_.requestBodySpill();
+  if (spill.has_value()) {
+    buffer->setSpillToFile(spill->memory_threshold_bytes_, spill->directory_);
+  }
   return buffer;
 }
 
@@ -2222,6 +2424,8 @@ void ConnectionManagerImpl::ActiveStreamDecoderFilter::
 
 void ConnectionManagerImpl::ActiveStreamDecoderFilter::requestDataTooLarge() {
   ENVOY_STREAM_LOG(debug, "request data too large watermark exceeded", parent_);
+  // A body the filters buffer whole is also rejected when the memory budget of the worker throttles
+  // it, as the filters would wait for the rest of a body that is no longer read.
   if (parent_.state_.decoder_filters_streaming_) {
     onDecoderFilterAboveWriteBufferHighWatermark();
   } else {
@@ -28,10 +28,12 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
 #include "common/grpc/common.h"
 #include "common/http/conn_manager_config.h"
+#include "common/http/stream_memory_tracker.h"
 #include "common/http/user_agent.h"
 #include "common/http/utility.h"
 #include "common/stream_info/stream_info_impl.h"
@@ -106,6 +108,13 @@ private:
           continue_headers_continued_(false), end_stream_(false), dual_filter_(dual_filter),
           decode_headers_called_(false), encode_headers_called_(false) {}
 
+    // Filter wrappers are allocated from the stream arena when the arena is enabled, or from the
+    // heap when arena is nullptr. Memory placed in the arena is released with the arena, so
+    // deleting such a wrapper only runs its destructor.
+    static void* operator new(size_t size, Arena* arena);
+    static void operator delete(void* p, Arena* arena);
+    static void operator delete(void* p);
+
     // Functions in the following block are called after the filter finishes processing
     // corresponding data. Those functions handle state updates and data storage (if needed)
     // according to the status returned by filter's callback functions.
@@ -159,6 +168,24 @@ private:
       ASSERT(iteration_state_ != IterationState::Continue);
       iteration_state_ = IterationState::Continue;
     }
+    // Returns the time a callback of the filter starts, if the filter is timed.
+    absl::optional<MonotonicTime> startCallbackTiming();
+    // Adds the time spent in a callback that started at start, if the filter is timed. If the
+    // callback stopped iteration, the time until the filter continues is counted as paused.
+    void endCallbackTiming(const absl::optional<MonotonicTime>& start, bool stopped);
+    void endCallbackTiming(const absl::optional<MonotonicTime>& start, FilterHeadersStatus status) {
+      endCallbackTiming(start, status != FilterHeadersStatus::Continue &&
+                                   status != FilterHeadersStatus::ContinueAndEndStream);
+    }
+    void endCallbackTiming(const absl::optional<MonotonicTime>& start, FilterDataStatus) {
+      // Filters stopping on data are mostly buffering it rather than waiting for anything.
+      endCallbackTiming(start, false);
+    }
+    void endCallbackTiming(const absl::optional<MonotonicTime>& start,
+                           FilterTrailersStatus status) {
+      endCallbackTiming(start, status == FilterTrailersStatus::StopIteration);
+    }
+
     MetadataMapVector* getSavedRequestMetadata() {
       if (saved_request_metadata_ == nullptr) {
         saved_request_metadata_ = std::make_unique<MetadataMapVector>();
@@ -187,6 +214,23 @@ private:
       StopAllWatermark,    // Iteration has stopped for all frame types, and following data should
                            // be buffered until high watermark is reached.
     };
+    // The time spent by a sampled stream in the decoding or the encoding side of a filter.
+    struct FilterTiming {
+      FilterTiming(absl::string_view name, bool encoder, Stats::Histogram& spent_histogram,
+                   Stats::Histogram& paused_histogram)
+          : name_(name), encoder_(encoder), spent_histogram_(spent_histogram),
+            paused_histogram_(paused_histogram) {}
+
+      const absl::string_view name_;
+      const bool encoder_;
+      Stats::Histogram& spent_histogram_;
+      Stats::Histogram& paused_histogram_;
+      bool called_{};
+      std::chrono::microseconds spent_{};
+      std::chrono::microseconds paused_{};
+      absl::optional<MonotonicTime> paused_since_;
+    };
+
     ActiveStream& parent_;
     IterationState iteration_state_;
     // If the filter resumes iteration from a StopAllBuffer/Watermark state, the current filter
@@ -201,6 +245,8 @@ private:
     const bool dual_filter_ : 1;
     bool decode_headers_called_ : 1;
     bool encode_headers_called_ : 1;
+    // Only set for the named filters of the streams sampled for filter timing.
+    std::unique_ptr<FilterTiming> timing_;
   };
 
   /**
@@ -430,7 +476,8 @@ private:
                         public StreamDecoder,
                         public FilterChainFactoryCallbacks,
                         public Tracing::Config,
-                        public ScopeTrackedObject {
+                        public ScopeTrackedObject,
+                        public StreamMemoryTracker::Stream {
     ActiveStream(ConnectionManagerImpl& connection_manager);
     ~ActiveStream() override;
 
@@ -439,6 +486,10 @@ private:
 
     void addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr filter, bool dual_filter);
     void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter, bool dual_filter);
+    // Returns the timing of the filter being added, if the stream is sampled for filter timing.
+    std::unique_ptr<ActiveStreamFilterBase::FilterTiming> createFilterTiming(bool encoder);
+    // Records the time spent in the filters, and exposes it to the access logs.
+    void recordFilterTiming();
     void chargeStats(const HeaderMap& headers);
     // Returns the encoder filter to start iteration with.
     std::list<ActiveStreamEncoderFilterPtr>::iterator
@@ -511,6 +562,7 @@ private:
       addStreamEncoderFilterWorker(filter, true);
     }
     void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override;
+    void setFilterName(absl::string_view name) override { filter_name_ = name; }
 
     // Tracing::TracingConfig
     Tracing::OperationName operationName() const override;
@@ -518,6 +570,10 @@ private:
     bool verbose() const override;
     uint32_t maxPathTagLength() const override;
 
+    // Http::StreamMemoryTracker::Stream
+    uint64_t bufferedBytes() override;
+    void resetForMemory() override;
+
     // ScopeTrackedObject
     void dumpState(std::ostream& os, int indent_level = 0) const override {
       const char* spaces = spacesForLevel(indent_level);
@@ -651,9 +707,15 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
+    // Must be declared before the filter lists so that it outlives the filter wrappers.
+    ArenaPtr arena_;
     std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
     std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
     std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+    // Set when the stream is sampled for filter timing.
+    const FilterTimingConfig* filter_timing_{};
+    // The name of the filters being added to the chain.
+    absl::string_view filter_name_;
     Stats::TimespanPtr request_response_timespan_;
     // Per-stream idle timeout.
     Event::TimerPtr stream_idle_timer_;
@@ -742,6 +804,9 @@ private:
   // lookup in the hot path of processing each request.
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
+  // Whether the streams are tracked, for the overload manager to reset those holding the most
+  // memory.
+  const bool track_stream_memory_;
   TimeSource& time_source_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_;
 };
@@ -184,9 +184,7 @@ Network::Address::InstanceConstSharedPtr ConnectionManagerUtility::mutateRequest
     request_headers.removeEnvoyOriginalUrl();
     request_headers.removeEnvoyHedgeOnPerTryTimeout();
 
-    for (const LowerCaseString& header : route_config.internalOnlyHeaders()) {
-      request_headers.remove(header);
-    }
+    request_headers.removeKeys(route_config.internalOnlyHeaders());
   }
 
   if (config.userAgent()) {
@@ -3,30 +3,41 @@
 #include <chrono>
 #include <string>
 
+#include "common/common/time_cache.h"
+
 namespace Envoy {
 namespace Http {
 
 DateFormatter DateProviderImplBase::date_formatter_("%a, %d %b %Y %H:%M:%S GMT");
 
-TlsCachingDateProviderImpl::TlsCachingDateProviderImpl(Event::Dispatcher& dispatcher,
-                                                       ThreadLocal::SlotAllocator& tls)
-    : DateProviderImplBase(dispatcher.timeSource()), tls_(tls.allocateSlot()),
+CachingDateProviderImpl::CachingDateProviderImpl(Event::Dispatcher& dispatcher)
+    : DateProviderImplBase(dispatcher.timeSource()),
       refresh_timer_(dispatcher.createTimer([this]() -> void { onRefreshDate(); })) {
 
   onRefreshDate();
 }
 
-void TlsCachingDateProviderImpl::onRefreshDate() {
-  std::string new_date_string = date_formatter_.now(time_source_);
-  tls_->set([new_date_string](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::make_shared<ThreadLocalCachedDate>(new_date_string);
-  });
+void CachingDateProviderImpl::onRefreshDate() {
+  const SystemTime now = time_source_.systemTime();
+  TimeCache::get().update(now);
+  refresh_seconds_.store(
+      std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count(),
+      std::memory_order_relaxed);
 
   refresh_timer_->enableTimer(std::chrono::milliseconds(500));
 }
 
-void TlsCachingDateProviderImpl::setDateHeader(HeaderMap& headers) {
-  headers.setDate(tls_->getTyped<ThreadLocalCachedDate>().date_string_);
+void CachingDateProviderImpl::setDateHeader(HeaderMap& headers) {
+  const std::chrono::seconds refresh_seconds(refresh_seconds_.load(std::memory_order_relaxed));
+  TimeCache::Buffer buffer;
+  const absl::string_view date =
+      TimeCache::get().read(refresh_seconds, TimeCache::Format::Rfc1123, buffer);
+  if (!date.empty()) {
+    headers.setDate(date);
+    return;
+  }
+  // Another provider, with another time source, updated the time cache since the last refresh.
+  headers.setDate(date_formatter_.fromTime(SystemTime(refresh_seconds)));
 }
 
 void SlowDateProviderImpl::setDateHeader(HeaderMap& headers) {
@@ -1,11 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/singleton/instance.h"
-#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/utility.h"
 
@@ -27,27 +27,22 @@ protected:
 };
 
 /**
- * A caching thread local provider. This implementation updates the date string every 500ms and
- * caches on each thread.
+ * A caching provider. This implementation updates the date string in the process wide time cache
+ * every 500ms, and the workers copy it from the cache.
  */
-class TlsCachingDateProviderImpl : public DateProviderImplBase, public Singleton::Instance {
+class CachingDateProviderImpl : public DateProviderImplBase, public Singleton::Instance {
 public:
-  TlsCachingDateProviderImpl(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator& tls);
+  explicit CachingDateProviderImpl(Event::Dispatcher& dispatcher);
 
   // Http::DateProvider
   void setDateHeader(HeaderMap& headers) override;
 
 private:
-  struct ThreadLocalCachedDate : public ThreadLocal::ThreadLocalObject {
-    ThreadLocalCachedDate(const std::string& date_string) : date_string_(date_string) {}
-
-    const std::string date_string_;
-  };
-
   void onRefreshDate();
 
-  ThreadLocal::SlotPtr tls_;
   Event::TimerPtr refresh_timer_;
+  // The second of the last refresh, as a number of seconds since the epoch.
+  std::atomic<int64_t> refresh_seconds_;
 };
 
 /**
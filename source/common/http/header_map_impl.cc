@@ -1,9 +1,13 @@
 #include "common/http/header_map_impl.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstring>
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/common/assert.h"
 #include "common/common/dump_state_utils.h"
@@ -276,9 +280,12 @@ void HeaderMapImpl::HeaderEntryImpl::value(const HeaderEntry& header) {
 
 /**
  * This is the static lookup table that is used to determine whether a header is one of the O(1)
- * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+ * headers. It is a perfect hash table: the seed of the hash is chosen when the table is built so
+ * that no two inline headers share a slot, and a lookup hashes the key, reads a single slot and
+ * compares the key to the one header that may match. The names of the Envoy headers depend on the
+ * configured header prefix, so the table is built at runtime rather than at compile time.
  */
-struct HeaderMapImpl::StaticLookupTable : public TrieLookupTable<EntryCb> {
+struct HeaderMapImpl::StaticLookupTable {
   StaticLookupTable() {
     ALL_INLINE_HEADERS(INLINE_HEADER_STATIC_MAP_ENTRY)
 
@@ -286,7 +293,75 @@ struct HeaderMapImpl::StaticLookupTable : public TrieLookupTable<EntryCb> {
     add(Headers::get().HostLegacy.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {
       return {&h.inline_headers_.Host_, &Headers::get().Host};
     });
+
+    // Slot indexes are stored as one byte, 0 standing for an empty slot.
+    RELEASE_ASSERT(entries_.size() < 256, "too many inline headers for the lookup table");
+    for (uint64_t attempt = 0; attempt < MaxSeedAttempts; attempt++) {
+      seed_ = attempt * 0x9e3779b97f4a7c15;
+      if (buildSlots()) {
+        return;
+      }
+    }
+    RELEASE_ASSERT(false, "no perfect hash of the inline headers was found");
   }
+
+  EntryCb find(absl::string_view key) const {
+    const uint8_t index = slots_[hash(key, seed_) & (NumSlots - 1)];
+    if (index == 0) {
+      return nullptr;
+    }
+    const Entry& entry = entries_[index - 1];
+    return entry.key_ == key ? entry.cb_ : nullptr;
+  }
+
+private:
+  // With about 80 inline headers, a random seed gives a perfect hash in about half the attempts.
+  static constexpr size_t NumSlots = 4096;
+  static constexpr uint64_t MaxSeedAttempts = 1024;
+
+  struct Entry {
+    absl::string_view key_;
+    EntryCb cb_;
+  };
+
+  void add(absl::string_view key, EntryCb cb) { entries_.push_back({key, cb}); }
+
+  // Places the entries in the slots with the current seed, failing on a collision.
+  bool buildSlots() {
+    slots_.fill(0);
+    for (size_t i = 0; i < entries_.size(); i++) {
+      uint8_t& slot = slots_[hash(entries_[i].key_, seed_) & (NumSlots - 1)];
+      if (slot != 0) {
+        return false;
+      }
+      slot = static_cast<uint8_t>(i + 1);
+    }
+    return true;
+  }
+
+  // Hashes the key 8 bytes at a time.
+  static uint64_t hash(absl::string_view key, uint64_t seed) {
+    constexpr uint64_t multiplier = 0xff51afd7ed558ccd;
+    uint64_t hash = seed ^ key.size();
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= key.size(); offset += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, key.data() + offset, sizeof(word));
+      hash = (hash ^ word) * multiplier;
+      hash ^= hash >> 32;
+    }
+    if (offset < key.size()) {
+      uint64_t word = 0;
+      memcpy(&word, key.data() + offset, key.size() - offset);
+      hash = (hash ^ word) * multiplier;
+      hash ^= hash >> 32;
+    }
+    return hash;
+  }
+
+  std::vector<Entry> entries_;
+  std::array<uint8_t, NumSlots> slots_;
+  uint64_t seed_{};
 };
 
 uint64_t HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data,
@@ -379,7 +454,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     }
   } else {
     addSize(key.size() + value.size());
-    std::list<HeaderEntryImpl>::iterator i = headers_.insert(std::move(key), std::move(value));
+    HeaderEntryList::iterator i = headers_.insert(std::move(key), std::move(value));
     i->entry_ = i;
   }
 }
@@ -599,9 +674,9 @@ void HeaderMapImpl::remove(const LowerCaseString& key) {
   verifyByteSize();
 }
 
-void HeaderMapImpl::removePrefix(const LowerCaseString& prefix) {
-  headers_.remove_if([&prefix, this](const HeaderEntryImpl& entry) {
-    bool to_remove = absl::StartsWith(entry.key().getStringView(), prefix.get());
+template <class KeyPredicate> void HeaderMapImpl::removeIf(KeyPredicate predicate) {
+  headers_.remove_if([&predicate, this](const HeaderEntryImpl& entry) {
+    bool to_remove = predicate(entry.key().getStringView());
     if (to_remove) {
       // If this header should be removed, make sure any references in the
       // static lookup table are cleared as well.
@@ -623,6 +698,20 @@ void HeaderMapImpl::removePrefix(const LowerCaseString& prefix) {
   verifyByteSize();
 }
 
+void HeaderMapImpl::removePrefix(const LowerCaseString& prefix) {
+  removeIf([&prefix](absl::string_view key) { return absl::StartsWith(key, prefix.get()); });
+}
+
+void HeaderMapImpl::removeKeys(const std::list<LowerCaseString>& keys) {
+  if (keys.empty()) {
+    return;
+  }
+  removeIf([&keys](absl::string_view key) {
+    return std::any_of(keys.begin(), keys.end(),
+                       [key](const LowerCaseString& to_remove) { return to_remove.get() == key; });
+  });
+}
+
 void HeaderMapImpl::dumpState(std::ostream& os, int indent_level) const {
   using IterateData = std::pair<std::ostream*, const char*>;
   const char* spaces = spacesForLevel(indent_level);
@@ -644,7 +733,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size());
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key);
+  HeaderEntryList::iterator i = headers_.insert(key);
   i->entry_ = i;
   *entry = &(*i);
   return **entry;
@@ -659,7 +748,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size() + value.size());
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key, std::move(value));
+  HeaderEntryList::iterator i = headers_.insert(key, std::move(value));
   i->entry_ = i;
   *entry = &(*i);
   return **entry;
@@ -9,6 +9,7 @@
 #include "envoy/http/header_map.h"
 
 #include "common/common/non_copyable.h"
+#include "common/common/slab_allocator.h"
 #include "common/http/headers.h"
 
 namespace Envoy {
@@ -94,6 +95,7 @@ public:
   void clear() override;
   void remove(const LowerCaseString& key) override;
   void removePrefix(const LowerCaseString& key) override;
+  void removeKeys(const std::list<LowerCaseString>& keys) override;
   size_t size() const override { return headers_.size(); }
   bool empty() const override { return headers_.empty(); }
   void dumpState(std::ostream& os, int indent_level = 0) const override;
@@ -102,6 +104,9 @@ protected:
   // For tests only, unoptimized, they aren't intended for regular HeaderMapImpl users.
   void copyFrom(const HeaderMap& rhs);
 
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, SlabAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -117,7 +122,7 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
 
   struct StaticLookupResponse {
@@ -129,7 +134,7 @@ protected:
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers. This uses a perfect hash for a lookup reading a single slot.
    */
   struct StaticLookupTable; // Defined in header_map_impl.cc.
 
@@ -143,6 +148,11 @@ protected:
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
    * of the list (as required by nghttp2) and otherwise maintains insertion order.
    *
+   * List nodes are carved out of slabs owned by the list, so adding a header does not cost a heap
+   * allocation once the first slab is in place and entries of the same map sit close together in
+   * memory. Nodes freed by removal are reused by later insertions; slab memory is released when
+   * the map is destroyed.
+   *
    * Note: the internal iterators held in fields make this unsafe to copy and move, since the
    * reference to end() is not preserved across a move (see Notes in
    * https://en.cppreference.com/w/cpp/container/list/list). The NonCopyable will suppress both copy
@@ -152,16 +162,17 @@ protected:
    */
   class HeaderList : NonCopyable {
   public:
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList()
+        : headers_(SlabAllocator<HeaderEntryImpl>(pool_)), pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
     }
 
     template <class Key, class... Value>
-    std::list<HeaderEntryImpl>::iterator insert(Key&& key, Value&&... value) {
+    HeaderEntryList::iterator insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      std::list<HeaderEntryImpl>::iterator i =
+      HeaderEntryList::iterator i =
           headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
                            std::forward<Key>(key), std::forward<Value>(value)...);
       if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
@@ -170,7 +181,7 @@ protected:
       return i;
     }
 
-    std::list<HeaderEntryImpl>::iterator erase(std::list<HeaderEntryImpl>::iterator i) {
+    HeaderEntryList::iterator erase(HeaderEntryList::iterator i) {
       if (pseudo_headers_end_ == i) {
         pseudo_headers_end_++;
       }
@@ -189,12 +200,12 @@ protected:
       });
     }
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     size_t size() const { return headers_.size(); }
     bool empty() const { return headers_.empty(); }
     void clear() {
@@ -203,8 +214,10 @@ protected:
     }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
-    std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+    // Must be declared before headers_ so that it outlives all list nodes.
+    SlabPool pool_;
+    HeaderEntryList headers_;
+    HeaderEntryList::iterator pseudo_headers_end_;
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
@@ -217,6 +230,8 @@ protected:
   HeaderEntryImpl* getExistingInline(absl::string_view key);
 
   void removeInline(HeaderEntryImpl** entry);
+  // Removes the headers whose key matches the predicate, in a single pass over the map.
+  template <class KeyPredicate> void removeIf(KeyPredicate predicate);
   void updateSize(uint64_t from_size, uint64_t to_size);
   void addSize(uint64_t size);
   void subtractSize(uint64_t size);
@@ -93,12 +93,17 @@ void HeaderUtility::getAllOfHeader(const HeaderMap& headers, absl::string_view k
 
 bool HeaderUtility::matchHeaders(const HeaderMap& request_headers,
                                  const std::vector<HeaderDataPtr>& config_headers) {
-  // No headers to match is considered a match.
-  if (!config_headers.empty()) {
-    for (const HeaderDataPtr& cfg_header_data : config_headers) {
-      if (!matchHeaders(request_headers, *cfg_header_data)) {
-        return false;
-      }
+  // No headers to match is considered a match. Consecutive matchers of the same header share a
+  // single lookup of the header.
+  const HeaderData* previous = nullptr;
+  const HeaderEntry* header = nullptr;
+  for (const HeaderDataPtr& cfg_header_data : config_headers) {
+    if (previous == nullptr || previous->name_.get() != cfg_header_data->name_.get()) {
+      header = request_headers.get(cfg_header_data->name_);
+    }
+    previous = cfg_header_data.get();
+    if (!matchHeader(header, *cfg_header_data)) {
+      return false;
     }
   }
 
@@ -106,8 +111,10 @@ bool HeaderUtility::matchHeaders(const HeaderMap& request_headers,
 }
 
 bool HeaderUtility::matchHeaders(const HeaderMap& request_headers, const HeaderData& header_data) {
-  const HeaderEntry* header = request_headers.get(header_data.name_);
+  return matchHeader(request_headers.get(header_data.name_), header_data);
+}
 
+bool HeaderUtility::matchHeader(const HeaderEntry* header, const HeaderData& header_data) {
   if (header == nullptr) {
     return header_data.invert_match_ && header_data.header_match_type_ == HeaderMatchType::Present;
   }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "envoy/common/regex.h"
@@ -63,6 +64,11 @@ public:
     for (const auto& header_matcher : header_matchers) {
       ret.emplace_back(std::make_unique<HeaderUtility::HeaderData>(header_matcher));
     }
+    // The matchers of the same header are kept together, so that matchHeaders() looks it up once.
+    std::stable_sort(ret.begin(), ret.end(),
+                     [](const HeaderDataPtr& lhs, const HeaderDataPtr& rhs) {
+                       return lhs->name_.get() < rhs->name_.get();
+                     });
     return ret;
   }
 
@@ -91,6 +97,14 @@ public:
 
   static bool matchHeaders(const HeaderMap& request_headers, const HeaderData& config_header);
 
+  /**
+   * Match a header already looked up against a header matcher.
+   * @param header supplies the header named by the matcher, or nullptr if it is absent.
+   * @param config_header supplies the header matcher.
+   * @return bool whether the header matches.
+   */
+  static bool matchHeader(const HeaderEntry* header, const HeaderData& config_header);
+
   /**
    * Validates that a header value is valid, according to RFC 7230, section 3.2.
    * http://tools.ietf.org/html/rfc7230#section-3.2
@@ -285,6 +285,7 @@ public:
   } AcceptEncodingValues;
 
   struct {
+    const std::string Deflate{"deflate"};
     const std::string Gzip{"gzip"};
   } ContentEncodingValues;
 
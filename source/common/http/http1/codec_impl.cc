@@ -47,6 +47,13 @@ const StringUtil::CaseUnorderedSet& caseUnorderdSetContainingUpgradeAndHttp2Sett
                          Http::Headers::get().ConnectionValues.Http2Settings);
 }
 
+// Upper bound of the size of the serialized headers, each taking its key and value size plus 4
+// bytes for ": " and CRLF. Reserving this together with the first line lets all headers be written
+// into a single slice. The only header renamed on encoding, :authority, gets a shorter name.
+uint64_t encodedHeadersSizeBound(const HeaderMap& headers) {
+  return headers.byteSize() + 4 * headers.size();
+}
+
 HeaderKeyFormatterPtr formatter(const Http::Http1Settings& settings) {
   if (settings.header_key_format_ == Http1Settings::HeaderKeyFormat::ProperCase) {
     return std::make_unique<ProperCaseHeaderKeyFormatter>();
@@ -312,7 +319,8 @@ void ResponseStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end
   started_response_ = true;
   uint64_t numeric_status = Utility::getResponseStatus(headers);
 
-  connection_.reserveBuffer(4096);
+  // The headers are added to the room left for the status line and headers added by the codec.
+  connection_.reserveBuffer(4096 + encodedHeadersSizeBound(headers));
   if (connection_.protocol() == Protocol::Http10 && connection_.supports_http_10()) {
     connection_.copyToBuffer(HTTP_10_RESPONSE_PREFIX, sizeof(HTTP_10_RESPONSE_PREFIX) - 1);
   } else {
@@ -352,7 +360,8 @@ void RequestStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end_
     head_request_ = true;
   }
   connection_.onEncodeHeaders(headers);
-  connection_.reserveBuffer(path->value().size() + method->value().size() + 4096);
+  connection_.reserveBuffer(path->value().size() + method->value().size() + 4096 +
+                            encodedHeadersSizeBound(headers));
   connection_.copyToBuffer(method->value().getStringView().data(), method->value().size());
   connection_.addCharToBuffer(' ');
   connection_.copyToBuffer(path->value().getStringView().data(), path->value().size());
@@ -886,11 +895,16 @@ StreamEncoder& ClientConnectionImpl::newStream(StreamDecoder& response_decoder)
 
   // If reads were disabled due to flow control, we expect reads to always be enabled again before
   // reusing this connection. This is done when the final pipeline response is received.
-  ASSERT(connection_.readEnabled());
+  ASSERT(!pending_responses_.empty() || connection_.readEnabled());
 
-  request_encoder_ = std::make_unique<RequestStreamEncoderImpl>(*this, header_key_formatter_.get());
-  pending_responses_.emplace_back(&response_decoder);
-  return *request_encoder_;
+  auto encoder = std::make_unique<RequestStreamEncoderImpl>(*this, header_key_formatter_.get());
+  if (!pending_responses_.empty() && connection_.aboveHighWatermark()) {
+    // The request is pipelined behind requests whose streams were told the connection is above its
+    // high watermark, and is told as well so that it is told when the connection drains.
+    encoder->runHighWatermarkCallbacks();
+  }
+  pending_responses_.emplace_back(std::move(encoder), &response_decoder);
+  return *pending_responses_.back().encoder_;
 }
 
 void ClientConnectionImpl::onEncodeHeaders(const HeaderMap& headers) {
@@ -943,8 +957,9 @@ void ClientConnectionImpl::onMessageComplete(HeaderMapImplPtr&& trailers) {
   }
   if (!pending_responses_.empty()) {
     // After calling decodeData() with end stream set to true, we should no longer be able to reset.
-    PendingResponse response = pending_responses_.front();
+    PendingResponse response = std::move(pending_responses_.front());
     pending_responses_.pop_front();
+    completed_request_encoder_ = std::move(response.encoder_);
 
     // Streams are responsible for unwinding any outstanding readDisable(true)
     // calls done on the underlying connection as they are destroyed. As this is
@@ -971,31 +986,39 @@ void ClientConnectionImpl::onMessageComplete(HeaderMapImplPtr&& trailers) {
 }
 
 void ClientConnectionImpl::onResetStream(StreamResetReason reason) {
-  // Only raise reset if we did not already dispatch a complete response.
-  if (!pending_responses_.empty()) {
-    pending_responses_.clear();
-    request_encoder_->runResetCallbacks(reason);
+  // Only raise reset if we did not already dispatch a complete response. All the pipelined requests
+  // are reset, as the connection is.
+  std::list<PendingResponse> responses = std::move(pending_responses_);
+  pending_responses_.clear();
+  for (PendingResponse& response : responses) {
+    reset_request_encoders_.push_back(std::move(response.encoder_));
+    reset_request_encoders_.back()->runResetCallbacks(reason);
   }
 }
 
 void ClientConnectionImpl::sendProtocolError(absl::string_view details) {
-  if (request_encoder_) {
-    request_encoder_->setDetails(details);
+  // The protocol error is in the response to the oldest request.
+  if (!pending_responses_.empty()) {
+    pending_responses_.front().encoder_->setDetails(details);
+  } else if (completed_request_encoder_) {
+    completed_request_encoder_->setDetails(details);
   }
 }
 
 void ClientConnectionImpl::onAboveHighWatermark() {
   // This should never happen without an active stream/request.
   ASSERT(!pending_responses_.empty());
-  request_encoder_->runHighWatermarkCallbacks();
+  for (PendingResponse& response : pending_responses_) {
+    response.encoder_->runHighWatermarkCallbacks();
+  }
 }
 
 void ClientConnectionImpl::onBelowLowWatermark() {
   // This can get called without an active stream/request when upstream decides to do bad things
   // such as sending multiple responses to the same request, causing us to close the connection, but
   // in doing so go below low watermark.
-  if (!pending_responses_.empty()) {
-    request_encoder_->runLowWatermarkCallbacks();
+  for (PendingResponse& response : pending_responses_) {
+    response.encoder_->runLowWatermarkCallbacks();
   }
 }
 
@@ -389,8 +389,10 @@ public:
 
 private:
   struct PendingResponse {
-    PendingResponse(StreamDecoder* decoder) : decoder_(decoder) {}
+    PendingResponse(std::unique_ptr<RequestStreamEncoderImpl>&& encoder, StreamDecoder* decoder)
+        : encoder_(std::move(encoder)), decoder_(decoder) {}
 
+    std::unique_ptr<RequestStreamEncoderImpl> encoder_;
     StreamDecoder* decoder_;
     bool head_request_{};
   };
@@ -410,8 +412,13 @@ private:
   void onAboveHighWatermark() override;
   void onBelowLowWatermark() override;
 
-  std::unique_ptr<RequestStreamEncoderImpl> request_encoder_;
+  // The requests pipelined on the connection, in the order their responses are expected.
   std::list<PendingResponse> pending_responses_;
+  // The encoders of the requests whose response completed or which were reset, kept alive as their
+  // users may still reference them: the encoder of the last completed response until the next one
+  // completes, and the reset ones until the connection is destroyed.
+  std::unique_ptr<RequestStreamEncoderImpl> completed_request_encoder_;
+  std::list<std::unique_ptr<RequestStreamEncoderImpl>> reset_request_encoders_;
   // Set true between receiving 100-Continue headers and receiving the spurious onMessageComplete.
   bool ignore_message_complete_for_100_continue_{};
 
@@ -1,5 +1,7 @@
 #include "common/http/http1/conn_pool.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -14,6 +16,7 @@
 #include "common/http/codec_client.h"
 #include "common/http/codes.h"
 #include "common/http/headers.h"
+#include "common/http/utility.h"
 #include "common/network/utility.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/stats/timespan_impl.h"
@@ -25,6 +28,18 @@ namespace Envoy {
 namespace Http {
 namespace Http1 {
 
+namespace {
+
+bool isIdempotent(const HeaderString& method) {
+  const absl::string_view value = method.getStringView();
+  return value == Headers::get().MethodValues.Get || value == Headers::get().MethodValues.Head ||
+         value == Headers::get().MethodValues.Options ||
+         value == Headers::get().MethodValues.Trace || value == Headers::get().MethodValues.Put ||
+         value == Headers::get().MethodValues.Delete;
+}
+
+} // namespace
+
 ConnPoolImpl::ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSharedPtr host,
                            Upstream::ResourcePriority priority,
                            const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -44,6 +59,10 @@ ConnPoolImpl::~ConnPoolImpl() {
     busy_clients_.front()->codec_client_->close();
   }
 
+  while (!pipelining_clients_.empty()) {
+    pipelining_clients_.front()->codec_client_->close();
+  }
+
   // Make sure all clients are destroyed before we are destroyed.
   dispatcher_.clearDeferredDeleteList();
 }
@@ -53,10 +72,16 @@ void ConnPoolImpl::drainConnections() {
     ready_clients_.front()->codec_client_->close();
   }
 
-  // We drain busy clients by manually setting remaining requests to 1. Thus, when the next
-  // response completes the client will be destroyed.
+  // We drain busy clients by manually setting remaining requests to the number of requests in
+  // flight, or 1 for the ones still connecting. Thus, when the last response completes the client
+  // will be destroyed. Pipelining clients can no longer take a request and become busy.
+  while (!pipelining_clients_.empty()) {
+    ActiveClient& client = *pipelining_clients_.front();
+    client.remaining_requests_ = client.stream_wrappers_.size();
+    checkPipelining(client);
+  }
   for (const auto& client : busy_clients_) {
-    client->remaining_requests_ = 1;
+    client->remaining_requests_ = std::max<uint64_t>(1, client->stream_wrappers_.size());
   }
 }
 
@@ -66,21 +91,72 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 }
 
 bool ConnPoolImpl::hasActiveConnections() const {
-  return !pending_requests_.empty() || !busy_clients_.empty();
+  return !pending_requests_.empty() || !busy_clients_.empty() || !pipelining_clients_.empty();
 }
 
 void ConnPoolImpl::attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) {
-  ASSERT(!client.stream_wrapper_);
+  ASSERT(client.stream_wrappers_.empty() || client.pipelining_);
   host_->cluster().stats().upstream_rq_total_.inc();
   host_->stats().rq_total_.inc();
-  client.stream_wrapper_ = std::make_unique<StreamWrapper>(response_decoder, client);
-  callbacks.onPoolReady(*client.stream_wrapper_, client.real_host_description_,
+  if (!client.stream_wrappers_.empty()) {
+    host_->cluster().stats().upstream_rq_pipelined_.inc();
+  }
+  client.prefetched_ = false;
+  client.stream_wrappers_.push_back(std::make_unique<StreamWrapper>(response_decoder, client));
+  StreamWrapper& stream_wrapper = *client.stream_wrappers_.back();
+  // The request isn't sent yet, so no other request can be pipelined behind it.
+  checkPipelining(client);
+  callbacks.onPoolReady(stream_wrapper, client.real_host_description_,
                         client.codec_client_->streamInfo());
 }
 
+bool ConnPoolImpl::canPipeline(const ActiveClient& client) const {
+  // A request is only pipelined behind a request sent in full which could be retried safely, so
+  // that no request is ever queued behind one which could not be. The connection must also be
+  // able to serve the request before it is closed.
+  return !client.stream_wrappers_.empty() &&
+         client.stream_wrappers_.size() < settings_.max_pipelined_requests_ &&
+         client.stream_wrappers_.back()->encode_complete_ &&
+         client.stream_wrappers_.back()->allows_pipelining_ &&
+         !client.stream_wrappers_.front()->close_connection_ &&
+         !client.codec_client_->remoteClosed() &&
+         (client.remaining_requests_ == 0 ||
+          client.remaining_requests_ > client.stream_wrappers_.size());
+}
+
+bool ConnPoolImpl::shouldPipeline() const {
+  // A pipelined request waits for the responses of the requests ahead of it, so requests are only
+  // pipelined once the connection circuit breaker stops another connection from being created.
+  return !pipelining_clients_.empty() &&
+         !host_->cluster().resourceManager(priority_).connections().canCreate();
+}
+
+void ConnPoolImpl::checkPipelining(ActiveClient& client) {
+  const bool pipelining = canPipeline(client);
+  if (pipelining == client.pipelining_) {
+    return;
+  }
+
+  client.pipelining_ = pipelining;
+  if (!pipelining) {
+    client.moveBetweenLists(pipelining_clients_, busy_clients_);
+    return;
+  }
+
+  ENVOY_CONN_LOG(debug, "moving to pipelining", *client.codec_client_);
+  client.moveBetweenLists(busy_clients_, pipelining_clients_);
+  // Pending requests are attached in the next dispatcher loop, as this may be called while a
+  // request is being attached to the client.
+  if (!pending_requests_.empty() && !upstream_ready_enabled_) {
+    upstream_ready_enabled_ = true;
+    upstream_ready_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
 void ConnPoolImpl::checkForDrained() {
-  if (!drained_callbacks_.empty() && pending_requests_.empty() && busy_clients_.empty()) {
+  if (!drained_callbacks_.empty() && pending_requests_.empty() && busy_clients_.empty() &&
+      pipelining_clients_.empty()) {
     while (!ready_clients_.empty()) {
       ready_clients_.front()->codec_client_->close();
     }
@@ -99,10 +175,25 @@ void ConnPoolImpl::createNewConnection() {
 
 ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_decoder,
                                                      ConnectionPool::Callbacks& callbacks) {
+  const bool prefetch = settings_.prefetch_ratio_ > 1.0;
   if (!ready_clients_.empty()) {
     ready_clients_.front()->moveBetweenLists(ready_clients_, busy_clients_);
-    ENVOY_CONN_LOG(debug, "using existing connection", *busy_clients_.front()->codec_client_);
-    attachRequestToClient(*busy_clients_.front(), response_decoder, callbacks);
+    ActiveClient& client = *busy_clients_.front();
+    ENVOY_CONN_LOG(debug, "using existing connection", *client.codec_client_);
+    if (client.prefetched_) {
+      host_->cluster().stats().upstream_rq_prefetch_hit_.inc();
+    }
+    attachRequestToClient(client, response_decoder, callbacks);
+    if (prefetch) {
+      prefetchConnections();
+    }
+    return nullptr;
+  }
+
+  if (shouldPipeline()) {
+    ActiveClient& client = *pipelining_clients_.front();
+    ENVOY_CONN_LOG(debug, "pipelining on existing connection", *client.codec_client_);
+    attachRequestToClient(client, response_decoder, callbacks);
     return nullptr;
   }
 
@@ -114,11 +205,17 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_dec
     }
 
     // If we have no connections at all, make one no matter what so we don't starve.
-    if ((ready_clients_.empty() && busy_clients_.empty()) || can_create_connection) {
+    if ((ready_clients_.empty() && busy_clients_.empty() && pipelining_clients_.empty()) ||
+        can_create_connection) {
       createNewConnection();
     }
 
-    return newPendingRequest(response_decoder, callbacks);
+    ConnectionPool::Cancellable* pending = newPendingRequest(response_decoder, callbacks);
+    if (prefetch) {
+      host_->cluster().stats().upstream_rq_prefetch_miss_.inc();
+      prefetchConnections();
+    }
+    return pending;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, absl::string_view(),
@@ -138,15 +235,16 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
     ActiveClientPtr removed;
     bool check_for_drained = true;
-    if (client.stream_wrapper_) {
-      if (!client.stream_wrapper_->decode_complete_) {
+    if (!client.stream_wrappers_.empty()) {
+      if (std::any_of(client.stream_wrappers_.begin(), client.stream_wrappers_.end(),
+                      [](const StreamWrapperPtr& wrapper) { return !wrapper->decode_complete_; })) {
         Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
       }
 
-      // There is an active request attached to this client. The underlying codec client will
-      // already have "reset" the stream to fire the reset callback. All we do here is just
+      // There are active requests attached to this client. The underlying codec client will
+      // already have "reset" the streams to fire the reset callbacks. All we do here is just
       // destroy the client.
-      removed = client.removeFromList(busy_clients_);
+      removed = client.removeFromList(client.pipelining_ ? pipelining_clients_ : busy_clients_);
     } else if (client.connectionState() ==
                ConnPoolImplBase::ActiveClient::ConnectionState::Connected) {
       removed = client.removeFromList(ready_clients_);
@@ -171,7 +269,8 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
     dispatcher_.deferredDelete(std::move(removed));
 
     // If we have pending requests and we just lost a connection we should make a new one.
-    if (pending_requests_.size() > (ready_clients_.size() + busy_clients_.size())) {
+    if (pending_requests_.size() >
+        (ready_clients_.size() + busy_clients_.size() + pipelining_clients_.size())) {
       createNewConnection();
     }
 
@@ -199,10 +298,12 @@ void ConnPoolImpl::onDownstreamReset(ActiveClient& client) {
 
 void ConnPoolImpl::onResponseComplete(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "response complete", *client.codec_client_);
-  if (!client.stream_wrapper_->encode_complete_) {
+  // Responses complete in the order the requests were sent.
+  const StreamWrapper& stream_wrapper = *client.stream_wrappers_.front();
+  if (!stream_wrapper.encode_complete_) {
     ENVOY_CONN_LOG(debug, "response before request complete", *client.codec_client_);
     onDownstreamReset(client);
-  } else if (client.stream_wrapper_->close_connection_ || client.codec_client_->remoteClosed()) {
+  } else if (stream_wrapper.close_connection_ || client.codec_client_->remoteClosed()) {
     ENVOY_CONN_LOG(debug, "saw upstream close connection", *client.codec_client_);
     onDownstreamReset(client);
   } else if (client.remaining_requests_ > 0 && --client.remaining_requests_ == 0) {
@@ -210,29 +311,66 @@ void ConnPoolImpl::onResponseComplete(ActiveClient& client) {
     host_->cluster().stats().upstream_cx_max_requests_.inc();
     onDownstreamReset(client);
   } else {
-    // Upstream connection might be closed right after response is complete. Setting delay=true
-    // here to attach pending requests in next dispatcher loop to handle that case.
-    // https://github.com/envoyproxy/envoy/issues/2715
-    processIdleClient(client, true);
+    client.stream_wrappers_.pop_front();
+    checkPipelining(client);
+    if (client.stream_wrappers_.empty()) {
+      // Upstream connection might be closed right after response is complete. Setting delay=true
+      // here to attach pending requests in next dispatcher loop to handle that case.
+      // https://github.com/envoyproxy/envoy/issues/2715
+      processIdleClient(client, true);
+    }
   }
 }
 
 void ConnPoolImpl::onUpstreamReady() {
   upstream_ready_enabled_ = false;
-  while (!pending_requests_.empty() && !ready_clients_.empty()) {
-    ActiveClient& client = *ready_clients_.front();
-    ENVOY_CONN_LOG(debug, "attaching to next request", *client.codec_client_);
-    // There is work to do so bind a request to the client and move it to the busy list. Pending
-    // requests are pushed onto the front, so pull from the back.
-    attachRequestToClient(client, pending_requests_.back()->decoder_,
+  while (!pending_requests_.empty() && (!ready_clients_.empty() || shouldPipeline())) {
+    // Idle clients are preferred to pipelining behind requests in flight.
+    ActiveClient* client;
+    if (!ready_clients_.empty()) {
+      client = ready_clients_.front().get();
+      client->moveBetweenLists(ready_clients_, busy_clients_);
+    } else {
+      client = pipelining_clients_.front().get();
+    }
+    ENVOY_CONN_LOG(debug, "attaching to next request", *client->codec_client_);
+    // There is work to do so bind a request to the client. Pending requests are pushed onto the
+    // front, so pull from the back.
+    attachRequestToClient(*client, pending_requests_.back()->decoder_,
                           pending_requests_.back()->callbacks_);
     pending_requests_.pop_back();
-    client.moveBetweenLists(ready_clients_, busy_clients_);
+  }
+}
+
+void ConnPoolImpl::prefetchConnections() {
+  // The capacity to keep is the number of active and pending requests scaled by the prefetch
+  // ratio. Idle and connecting connections can each take a request, busy ones can take none
+  // beyond their own, and the ones requests can be pipelined on can carry up to the maximum
+  // number of pipelined requests.
+  uint64_t requests = pending_requests_.size();
+  uint64_t capacity = ready_clients_.size();
+  for (const ActiveClientPtr& client : busy_clients_) {
+    requests += client->stream_wrappers_.size();
+    capacity += std::max<uint64_t>(1, client->stream_wrappers_.size());
+  }
+  for (const ActiveClientPtr& client : pipelining_clients_) {
+    requests += client->stream_wrappers_.size();
+    capacity += settings_.max_pipelined_requests_;
+  }
+  const uint64_t anticipated_capacity =
+      static_cast<uint64_t>(std::ceil(requests * settings_.prefetch_ratio_));
+  while (capacity < anticipated_capacity &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "prefetching a connection");
+    host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+    createNewConnection();
+    busy_clients_.front()->prefetched_ = true;
+    capacity++;
   }
 }
 
 void ConnPoolImpl::processIdleClient(ActiveClient& client, bool delay) {
-  client.stream_wrapper_.reset();
+  ASSERT(client.stream_wrappers_.empty() && !client.pipelining_);
   if (pending_requests_.empty() || delay) {
     // There is nothing to service or delayed processing is requested, so just move the connection
     // into the ready list.
@@ -278,7 +416,16 @@ ConnPoolImpl::StreamWrapper::~StreamWrapper() {
   parent_.parent_.host_->cluster().resourceManager(parent_.parent_.priority_).requests().dec();
 }
 
-void ConnPoolImpl::StreamWrapper::onEncodeComplete() { encode_complete_ = true; }
+void ConnPoolImpl::StreamWrapper::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  allows_pipelining_ = headers.Method() != nullptr && isIdempotent(headers.Method()->value()) &&
+                       !Utility::isUpgrade(headers);
+  StreamEncoderWrapper::encodeHeaders(headers, end_stream);
+}
+
+void ConnPoolImpl::StreamWrapper::onEncodeComplete() {
+  encode_complete_ = true;
+  parent_.parent_.checkPipelining(parent_);
+}
 
 void ConnPoolImpl::StreamWrapper::decodeHeaders(HeaderMapPtr&& headers, bool end_stream) {
   // If Connection: close OR
@@ -328,7 +475,7 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
        parent_.host_->cluster().stats().upstream_cx_rx_bytes_buffered_,
        parent_.host_->cluster().stats().upstream_cx_tx_bytes_total_,
        parent_.host_->cluster().stats().upstream_cx_tx_bytes_buffered_,
-       &parent_.host_->cluster().stats().bind_errors_, nullptr});
+       &parent_.host_->cluster().stats().bind_errors_, nullptr, nullptr});
 }
 
 ConnPoolImpl::ActiveClient::~ActiveClient() {
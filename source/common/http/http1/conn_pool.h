@@ -61,6 +61,7 @@ protected:
     ~StreamWrapper() override;
 
     // StreamEncoderWrapper
+    void encodeHeaders(const HeaderMap& headers, bool end_stream) override;
     void onEncodeComplete() override;
 
     // StreamDecoderWrapper
@@ -79,6 +80,9 @@ protected:
     bool encode_complete_{};
     bool close_connection_{};
     bool decode_complete_{};
+    // Set if the request is idempotent and not an upgrade, so that another request may be pipelined
+    // behind it.
+    bool allows_pipelining_{};
   };
 
   using StreamWrapperPtr = std::unique_ptr<StreamWrapper>;
@@ -102,25 +106,37 @@ protected:
     ConnPoolImpl& parent_;
     CodecClientPtr codec_client_;
     Upstream::HostDescriptionConstSharedPtr real_host_description_;
-    StreamWrapperPtr stream_wrapper_;
+    // The requests in flight on the connection, in the order they were sent.
+    std::list<StreamWrapperPtr> stream_wrappers_;
     uint64_t remaining_requests_;
+    // Set if the connection was established ahead of demand and has not served a request yet.
+    bool prefetched_{};
+    // Set if the client is in the pipelining list.
+    bool pipelining_{};
   };
 
   using ActiveClientPtr = std::unique_ptr<ActiveClient>;
 
   void attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
                              ConnectionPool::Callbacks& callbacks);
+  bool canPipeline(const ActiveClient& client) const;
+  bool shouldPipeline() const;
+  void checkPipelining(ActiveClient& client);
   virtual CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
   void createNewConnection();
   void onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event);
   void onDownstreamReset(ActiveClient& client);
   void onResponseComplete(ActiveClient& client);
   void onUpstreamReady();
+  void prefetchConnections();
   void processIdleClient(ActiveClient& client, bool delay);
 
   Event::Dispatcher& dispatcher_;
   std::list<ActiveClientPtr> ready_clients_;
+  // Contains the clients with an attached request as well as the ones still connecting.
   std::list<ActiveClientPtr> busy_clients_;
+  // Contains the clients with attached requests which another request may be pipelined behind.
+  std::list<ActiveClientPtr> pipelining_clients_;
   std::list<DrainedCb> drained_callbacks_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
   const Network::TransportSocketOptionsSharedPtr transport_socket_options_;
@@ -1,6 +1,9 @@
 #include "common/http/http2/codec_impl.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -60,6 +63,19 @@ ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_l
   }
 }
 
+// Names and values nghttp2 decoded from the HPACK static table, e.g. ":method: GET" or
+// ":status: 200", live in static storage, so they are referenced instead of copied. Being
+// references, they are also not copied by nghttp2 when they are encoded again.
+static void setHeaderString(HeaderString& header_string, nghttp2_rcbuf* rcbuf) {
+  const nghttp2_vec buf = nghttp2_rcbuf_get_buf(rcbuf);
+  const absl::string_view view(reinterpret_cast<const char*>(buf.base), buf.len);
+  if (nghttp2_rcbuf_is_static(rcbuf)) {
+    header_string.setReference(view);
+  } else {
+    header_string.setCopy(view);
+  }
+}
+
 static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
   uint8_t flags = 0;
   if (header.key().type() == HeaderString::Type::Reference) {
@@ -254,15 +270,13 @@ int ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t
 
   parent_.outbound_data_frames_++;
 
-  Buffer::OwnedImpl output;
-  if (!parent_.addOutboundFrameFragment(output, framehd, FRAME_HEADER_SIZE)) {
+  if (!parent_.addOutboundFrame(framehd, FRAME_HEADER_SIZE)) {
     ENVOY_CONN_LOG(debug, "error sending data frame: Too many frames in the outbound queue",
                    parent_.connection_);
     return NGHTTP2_ERR_FLOODED;
   }
 
-  output.move(pending_send_data_, length);
-  parent_.connection_.write(output, false);
+  parent_.addOutboundDataPayload(pending_send_data_, length);
   return 0;
 }
 
@@ -363,6 +377,15 @@ const char MaxInboundWindowUpdateFramesPerDataFrameSentOverrideKey[] =
     "envoy.reloadable_features.http2_protocol_options."
     "max_inbound_window_update_frames_per_data_frame_sent";
 
+// The frames sent at once are batched up to about the size of a TLS record.
+constexpr size_t FrameBatchSize = 16384;
+// DATA payloads up to this size are copied into the frame batch rather than moved as slices of
+// their own.
+constexpr size_t MaxBatchedDataPayloadSize = 1024;
+
+// The opaque data of the PING frames estimating the bandwidth-delay product of a connection.
+const uint8_t BdpPingPayload[8] = {'e', 'n', 'v', 'o', 'y', 'b', 'd', 'p'};
+
 bool checkRuntimeOverride(bool config_value, const char* override_key) {
   return Runtime::runtimeFeatureEnabled(override_key) ? true : config_value;
 }
@@ -372,7 +395,9 @@ bool checkRuntimeOverride(bool config_value, const char* override_key) {
 ConnectionImpl::ConnectionImpl(Network::Connection& connection, Stats::Scope& stats,
                                const Http2Settings& http2_settings, const uint32_t max_headers_kb,
                                const uint32_t max_headers_count)
-    : stats_{ALL_HTTP2_CODEC_STATS(POOL_COUNTER_PREFIX(stats, "http2."))}, connection_(connection),
+    : stats_{ALL_HTTP2_CODEC_STATS(POOL_COUNTER_PREFIX(stats, "http2."),
+                                   POOL_HISTOGRAM_PREFIX(stats, "http2."))},
+      connection_(connection),
       max_headers_kb_(max_headers_kb), max_headers_count_(max_headers_count),
       per_stream_buffer_limit_(http2_settings.initial_stream_window_size_),
       stream_error_on_invalid_http_messaging_(checkRuntimeOverride(
@@ -380,9 +405,6 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, Stats::Scope& st
       flood_detected_(false),
       max_outbound_frames_(
           Runtime::getInteger(MaxOutboundFramesOverrideKey, http2_settings.max_outbound_frames_)),
-      frame_buffer_releasor_([this](const Buffer::OwnedBufferFragmentImpl* fragment) {
-        releaseOutboundFrame(fragment);
-      }),
       max_outbound_control_frames_(Runtime::getInteger(
           MaxOutboundControlFramesOverrideKey, http2_settings.max_outbound_control_frames_)),
       control_frame_buffer_releasor_([this](const Buffer::OwnedBufferFragmentImpl* fragment) {
@@ -397,6 +419,9 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, Stats::Scope& st
       max_inbound_window_update_frames_per_data_frame_sent_(Runtime::getInteger(
           MaxInboundWindowUpdateFramesPerDataFrameSentOverrideKey,
           http2_settings.max_inbound_window_update_frames_per_data_frame_sent_)),
+      max_auto_tuned_window_size_(http2_settings.max_auto_tuned_window_size_),
+      stream_window_size_(http2_settings.initial_stream_window_size_),
+      connection_window_size_(http2_settings.initial_connection_window_size_),
       dispatching_(false), raised_goaway_(false), pending_deferred_reset_(false) {}
 
 ConnectionImpl::~ConnectionImpl() { nghttp2_session_del(session_); }
@@ -444,9 +469,65 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   } else {
     stream->unconsumed_bytes_ += len;
   }
+  onBdpDataReceived(len);
   return 0;
 }
 
+void ConnectionImpl::onBdpDataReceived(size_t length) {
+  if (max_auto_tuned_window_size_ == 0) {
+    return;
+  }
+  bdp_bytes_received_ += length;
+  if (!bdp_ping_outstanding_) {
+    // The PING frame is sent once the received frames are dispatched, and the bytes are counted
+    // from then on.
+    int rc = nghttp2_submit_ping(session_, NGHTTP2_FLAG_NONE, BdpPingPayload);
+    ASSERT(rc == 0);
+    bdp_ping_outstanding_ = true;
+  }
+}
+
+void ConnectionImpl::onBdpPingAck() {
+  bdp_ping_outstanding_ = false;
+  const std::chrono::milliseconds rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
+      connection_.dispatcher().timeSource().monotonicTime() - bdp_ping_sent_time_);
+  stats_.bdp_ping_rtt_.recordValue(rtt.count());
+
+  // As in gRPC, the windows rather than the bandwidth limit the connection if the bytes received
+  // over a round trip come to two thirds of a window, and the windows then grow to twice the
+  // bandwidth-delay product estimated by those bytes.
+  const uint64_t window_limit = std::min(stream_window_size_, connection_window_size_);
+  if (3 * bdp_bytes_received_ < 2 * window_limit) {
+    return;
+  }
+  const uint32_t window_size = static_cast<uint32_t>(
+      std::min<uint64_t>(2 * bdp_bytes_received_, max_auto_tuned_window_size_));
+  if (window_size <= window_limit) {
+    return;
+  }
+
+  ENVOY_CONN_LOG(debug, "auto-tuning window size to {} for {} bytes received over a round trip",
+                 connection_, window_size, bdp_bytes_received_);
+  if (window_size > connection_window_size_) {
+    connection_window_size_ = window_size;
+    int rc = nghttp2_session_set_local_window_size(session_, NGHTTP2_FLAG_NONE, 0, window_size);
+    ASSERT(rc == 0);
+  }
+  if (window_size > stream_window_size_) {
+    // The new initial window size applies to the windows of the active streams as well.
+    stream_window_size_ = window_size;
+    nghttp2_settings_entry entry{NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, window_size};
+    int rc = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, &entry, 1);
+    ASSERT(rc == 0);
+    per_stream_buffer_limit_ = window_size;
+    for (auto& stream : active_streams_) {
+      stream->setWriteBufferWatermarks(window_size / 2, window_size);
+    }
+  }
+  stats_.window_auto_tunes_.inc();
+  stats_.auto_tuned_window_size_.recordValue(window_size);
+}
+
 void ConnectionImpl::goAway() {
   int rc = nghttp2_submit_goaway(session_, NGHTTP2_FLAG_NONE,
                                  nghttp2_session_get_last_proc_stream_id(session_),
@@ -493,6 +574,13 @@ int ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
     }
   }
 
+  if (frame->hd.type == NGHTTP2_PING && (frame->hd.flags & NGHTTP2_FLAG_ACK) &&
+      bdp_ping_outstanding_ &&
+      memcmp(frame->ping.opaque_data, BdpPingPayload, sizeof(BdpPingPayload)) == 0) {
+    onBdpPingAck();
+    return 0;
+  }
+
   // Only raise GOAWAY once, since we don't currently expose stream information. Shutdown
   // notifications are the same as a normal GOAWAY.
   if (frame->hd.type == NGHTTP2_GOAWAY && !raised_goaway_) {
@@ -617,6 +705,15 @@ int ConnectionImpl::onFrameSend(const nghttp2_frame* frame) {
     break;
   }
 
+  case NGHTTP2_PING: {
+    if (!(frame->hd.flags & NGHTTP2_FLAG_ACK) &&
+        memcmp(frame->ping.opaque_data, BdpPingPayload, sizeof(BdpPingPayload)) == 0) {
+      bdp_ping_sent_time_ = connection_.dispatcher().timeSource().monotonicTime();
+      bdp_bytes_received_ = 0;
+    }
+    break;
+  }
+
   case NGHTTP2_HEADERS:
   case NGHTTP2_DATA: {
     StreamImpl* stream = getStream(frame->hd.stream_id);
@@ -671,8 +768,7 @@ void ConnectionImpl::incrementOutboundFrameCount(bool is_outbound_flood_monitore
   checkOutboundQueueLimits();
 }
 
-bool ConnectionImpl::addOutboundFrameFragment(Buffer::OwnedImpl& output, const uint8_t* data,
-                                              size_t length) {
+bool ConnectionImpl::addOutboundFrame(const uint8_t* data, size_t length) {
   // Reset the outbound frame type (set in the onBeforeFrameSend callback) since the
   // onBeforeFrameSend callback is not called for DATA frames.
   bool is_outbound_flood_monitored_control_frame = false;
@@ -683,23 +779,107 @@ bool ConnectionImpl::addOutboundFrameFragment(Buffer::OwnedImpl& output, const u
     return false;
   }
 
+  if (!is_outbound_flood_monitored_control_frame) {
+    if (frame_batch_.empty()) {
+      // Each batch moves its storage to the connection when flushed, so a new batch is sized up
+      // front rather than grown frame by frame.
+      frame_batch_.reserve(FrameBatchSize);
+    }
+    frame_batch_.append(reinterpret_cast<const char*>(data), length);
+    frame_batch_frames_++;
+    if (frame_batch_.size() >= FrameBatchSize) {
+      flushFrameBatch();
+    }
+    return true;
+  }
+
+  // Flood monitored control frames keep a fragment of their own, so that they stop being counted
+  // as soon as they are written into the socket.
+  flushFrameBatch();
   auto fragment = Buffer::OwnedBufferFragmentImpl::create(
       absl::string_view(reinterpret_cast<const char*>(data), length),
-      is_outbound_flood_monitored_control_frame ? control_frame_buffer_releasor_
-                                                : frame_buffer_releasor_);
+      control_frame_buffer_releasor_);
 
-  // The Buffer::OwnedBufferFragmentImpl object will be deleted in the *frame_buffer_releasor_
-  // callback.
-  output.addBufferFragment(*fragment.release());
+  // The Buffer::OwnedBufferFragmentImpl object will be deleted in the
+  // *control_frame_buffer_releasor_ callback.
+  pending_output_.addBufferFragment(*fragment.release());
   return true;
 }
 
+void ConnectionImpl::addOutboundDataPayload(Buffer::Instance& data, size_t length) {
+  if (length > MaxBatchedDataPayloadSize) {
+    flushFrameBatch();
+    pending_output_.move(data, length);
+    return;
+  }
+  const size_t offset = frame_batch_.size();
+  frame_batch_.resize(offset + length);
+  data.copyOut(0, length, &frame_batch_[offset]);
+  data.drain(length);
+  if (frame_batch_.size() >= FrameBatchSize) {
+    flushFrameBatch();
+  }
+}
+
+class ConnectionImpl::FrameBatchFragment : public Buffer::BufferFragment {
+public:
+  FrameBatchFragment(ConnectionImpl& parent, std::string&& batch, uint32_t frames)
+      : parent_(parent), batch_(std::move(batch)), frames_(frames) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return batch_.data(); }
+  size_t size() const override { return batch_.size(); }
+  void done() override {
+    parent_.releaseOutboundFrameBatch(frames_);
+    delete this;
+  }
+
+private:
+  ConnectionImpl& parent_;
+  const std::string batch_;
+  const uint32_t frames_;
+};
+
+void ConnectionImpl::flushFrameBatch() {
+  if (frame_batch_.empty()) {
+    return;
+  }
+  // The batch storage moves into the fragment, so the frames are not copied again. The fragment
+  // deletes itself once the whole batch is written into the socket.
+  pending_output_.addBufferFragment(
+      *new FrameBatchFragment(*this, std::move(frame_batch_), frame_batch_frames_));
+  frame_batch_.clear();
+  frame_batch_frames_ = 0;
+}
+
+void ConnectionImpl::flushPendingOutput() {
+  flushFrameBatch();
+  if (pending_output_.length() == 0) {
+    return;
+  }
+
+  // The fragments of the output will be moved into the write_buffer_ of the underlying connection_
+  // by the write method below. This creates lifetime dependency between the write_buffer_ of the
+  // underlying connection and the codec object. Specifically the write_buffer_ MUST be either
+  // fully drained or deleted before the codec object is deleted. This is presently guaranteed by
+  // the destruction order of the Network::ConnectionImpl object where write_buffer_ is destroyed
+  // before the filter_manager_ which owns the codec through Http::ConnectionManagerImpl.
+  Buffer::OwnedImpl output;
+  output.move(pending_output_);
+  connection_.write(output, false);
+}
+
 void ConnectionImpl::releaseOutboundFrame(const Buffer::OwnedBufferFragmentImpl* fragment) {
   ASSERT(outbound_frames_ >= 1);
   --outbound_frames_;
   delete fragment;
 }
 
+void ConnectionImpl::releaseOutboundFrameBatch(uint32_t frames) {
+  ASSERT(outbound_frames_ >= frames);
+  outbound_frames_ -= frames;
+}
+
 void ConnectionImpl::releaseOutboundControlFrame(const Buffer::OwnedBufferFragmentImpl* fragment) {
   ASSERT(outbound_control_frames_ >= 1);
   --outbound_control_frames_;
@@ -708,21 +888,11 @@ void ConnectionImpl::releaseOutboundControlFrame(const Buffer::OwnedBufferFragme
 
 ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   ENVOY_CONN_LOG(trace, "send data: bytes={}", connection_, length);
-  Buffer::OwnedImpl buffer;
-  if (!addOutboundFrameFragment(buffer, data, length)) {
+  if (!addOutboundFrame(data, length)) {
     ENVOY_CONN_LOG(debug, "error sending frame: Too many frames in the outbound queue.",
                    connection_);
     return NGHTTP2_ERR_FLOODED;
   }
-
-  // While the buffer is transient the fragment it contains will be moved into the
-  // write_buffer_ of the underlying connection_ by the write method below.
-  // This creates lifetime dependency between the write_buffer_ of the underlying connection
-  // and the codec object. Specifically the write_buffer_ MUST be either fully drained or
-  // deleted before the codec object is deleted. This is presently guaranteed by the
-  // destruction order of the Network::ConnectionImpl object where write_buffer_ is
-  // destroyed before the filter_manager_ which owns the codec through Http::ConnectionManagerImpl.
-  connection_.write(buffer, false);
   return length;
 }
 
@@ -826,6 +996,8 @@ void ConnectionImpl::sendPendingFrames() {
   }
 
   const int rc = nghttp2_session_send(session_);
+  // The frames sent before any error are written, as they would have been frame by frame.
+  flushPendingOutput();
   if (rc != 0) {
     ASSERT(rc == NGHTTP2_ERR_CALLBACK_FAILURE);
     // For errors caused by the pending outbound frame flood the FrameFloodException has
@@ -948,15 +1120,15 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
         return static_cast<ConnectionImpl*>(user_data)->onBeginHeaders(frame);
       });
 
-  nghttp2_session_callbacks_set_on_header_callback(
+  nghttp2_session_callbacks_set_on_header_callback2(
       callbacks_,
-      [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
-         const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
-        // TODO PERF: Can reference count here to avoid copies.
+      [](nghttp2_session*, const nghttp2_frame* frame, nghttp2_rcbuf* raw_name,
+         nghttp2_rcbuf* raw_value, uint8_t, void* user_data) -> int {
+        // TODO PERF: Can reference count non static buffers here to avoid copies.
         HeaderString name;
-        name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
+        setHeaderString(name, raw_name);
         HeaderString value;
-        value.setCopy(reinterpret_cast<const char*>(raw_value), value_length);
+        setHeaderString(value, raw_value);
         return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, std::move(name),
                                                                  std::move(value));
       });
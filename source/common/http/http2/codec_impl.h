@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/http/codec.h"
 #include "envoy/network/connection.h"
@@ -39,7 +40,7 @@ const std::string CLIENT_MAGIC_PREFIX = "PRI * HTTP/2";
 /**
  * All stats for the HTTP/2 codec. @see stats_macros.h
  */
-#define ALL_HTTP2_CODEC_STATS(COUNTER)                                                             \
+#define ALL_HTTP2_CODEC_STATS(COUNTER, HISTOGRAM)                                                  \
   COUNTER(header_overflow)                                                                         \
   COUNTER(headers_cb_no_stream)                                                                    \
   COUNTER(inbound_empty_frames_flood)                                                              \
@@ -51,13 +52,16 @@ const std::string CLIENT_MAGIC_PREFIX = "PRI * HTTP/2";
   COUNTER(rx_reset)                                                                                \
   COUNTER(too_many_header_frames)                                                                  \
   COUNTER(trailers)                                                                                \
-  COUNTER(tx_reset)
+  COUNTER(tx_reset)                                                                                \
+  COUNTER(window_auto_tunes)                                                                       \
+  HISTOGRAM(auto_tuned_window_size, Bytes)                                                         \
+  HISTOGRAM(bdp_ping_rtt, Milliseconds)
 
 /**
  * Wrapper struct for the HTTP/2 codec stats. @see stats_macros.h
  */
 struct CodecStats {
-  ALL_HTTP2_CODEC_STATS(GENERATE_COUNTER_STRUCT)
+  ALL_HTTP2_CODEC_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 class Utility {
@@ -173,6 +177,9 @@ protected:
     void resetStream(StreamResetReason reason) override;
     void readDisable(bool disable) override;
     uint32_t bufferLimit() override { return pending_recv_data_.highWatermark(); }
+    uint64_t bufferedBytes() override {
+      return pending_recv_data_.length() + pending_send_data_.length();
+    }
     const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
       return parent_.connection_.localAddress();
     }
@@ -309,7 +316,6 @@ protected:
   // Maximum number of outbound frames. Initialized from corresponding http2_protocol_options.
   // Default value is 10000.
   const uint32_t max_outbound_frames_;
-  const Buffer::OwnedBufferFragmentImpl::Releasor frame_buffer_releasor_;
   // This counter keeps track of the number of outbound frames of types PING, SETTINGS and
   // RST_STREAM (these that were buffered in the underlying connection but not yet written into the
   // socket). If this counter exceeds the `max_outbound_control_frames_' value the connection is
@@ -354,7 +360,32 @@ protected:
   // from corresponding http2_protocol_options. Default value is 10.
   const uint32_t max_inbound_window_update_frames_per_data_frame_sent_;
 
+  // The flow-control windows advertised to the peer are auto-tuned up to this size, if it isn't 0.
+  // Initialized from corresponding http2_protocol_options.
+  const uint32_t max_auto_tuned_window_size_;
+  // The stream-level and connection-level windows currently advertised to the peer.
+  uint32_t stream_window_size_;
+  uint32_t connection_window_size_;
+  // Set while a PING frame estimating the bandwidth-delay product is awaiting its acknowledgement.
+  bool bdp_ping_outstanding_ = false;
+  // When the PING frame was sent, and the bytes of DATA received since.
+  MonotonicTime bdp_ping_sent_time_;
+  uint64_t bdp_bytes_received_ = 0;
+
+  // The frames sent by nghttp2, other than the flood monitored control frames, are serialized
+  // back to back into a batch, so that the many small frames sent at once don't each take a slice
+  // of the output. The frames of a batch are counted as outbound frames until the whole batch is
+  // written into the socket.
+  std::string frame_batch_;
+  uint32_t frame_batch_frames_ = 0;
+  // The batches, flood monitored control frames and large DATA payloads sent by nghttp2, written
+  // to the connection at once when nghttp2 is done sending.
+  Buffer::OwnedImpl pending_output_;
+
 private:
+  // A frame batch handed to the connection as one fragment that owns the batch storage.
+  class FrameBatchFragment;
+
   virtual ConnectionCallbacks& callbacks() PURE;
   virtual int onBeginHeaders(const nghttp2_frame* frame) PURE;
   int onData(int32_t stream_id, const uint8_t* data, size_t len);
@@ -364,6 +395,12 @@ private:
   int onFrameSend(const nghttp2_frame* frame);
   virtual int onHeader(const nghttp2_frame* frame, HeaderString&& name, HeaderString&& value) PURE;
   int onInvalidFrame(int32_t stream_id, int error_code);
+  // Sends a PING frame estimating the bandwidth-delay product if none is in flight, and counts the
+  // bytes of DATA received towards the estimate.
+  void onBdpDataReceived(size_t length);
+  // Grows the flow-control windows if the bytes received over the round trip of the PING frame
+  // come close to them.
+  void onBdpPingAck();
 
   // For the flood mitigation to work the onSend callback must be called once for each outbound
   // frame. This is what the nghttp2 library is doing, however this is not documented. The
@@ -376,15 +413,23 @@ private:
   int onMetadataFrameComplete(int32_t stream_id, bool end_metadata);
   ssize_t packMetadata(int32_t stream_id, uint8_t* buf, size_t len);
 
-  // Adds buffer fragment for a new outbound frame to the supplied Buffer::OwnedImpl.
-  // Returns true on success or false if outbound queue limits were exceeded.
-  bool addOutboundFrameFragment(Buffer::OwnedImpl& output, const uint8_t* data, size_t length);
+  // Adds a new outbound frame to the pending output, batched unless it is a flood monitored control
+  // frame. Returns true on success or false if outbound queue limits were exceeded.
+  bool addOutboundFrame(const uint8_t* data, size_t length);
+  // Adds the payload of the DATA frame whose header was just added to the pending output, copied
+  // into the batch if it is small and moved otherwise.
+  void addOutboundDataPayload(Buffer::Instance& data, size_t length);
+  // Moves the frame batch to the pending output.
+  void flushFrameBatch();
+  // Writes the pending output to the connection.
+  void flushPendingOutput();
   virtual void checkOutboundQueueLimits() PURE;
   void incrementOutboundFrameCount(bool is_outbound_flood_monitored_control_frame);
   virtual bool trackInboundFrames(const nghttp2_frame_hd* hd, uint32_t padding_length) PURE;
   virtual bool checkInboundFrameLimits() PURE;
 
   void releaseOutboundFrame(const Buffer::OwnedBufferFragmentImpl* fragment);
+  void releaseOutboundFrameBatch(uint32_t frames);
   void releaseOutboundControlFrame(const Buffer::OwnedBufferFragmentImpl* fragment);
 
   bool dispatching_ : 1;
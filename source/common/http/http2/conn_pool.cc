@@ -23,12 +23,12 @@ ConnPoolImpl::ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSha
       socket_options_(options), transport_socket_options_(transport_socket_options) {}
 
 ConnPoolImpl::~ConnPoolImpl() {
-  if (primary_client_) {
-    primary_client_->client_->close();
+  while (!primary_clients_.empty()) {
+    primary_clients_.front()->client_->close();
   }
 
-  if (draining_client_) {
-    draining_client_->client_->close();
+  while (!draining_clients_.empty()) {
+    draining_clients_.front()->client_->close();
   }
 
   // Make sure all clients are destroyed before we are destroyed.
@@ -36,8 +36,8 @@ ConnPoolImpl::~ConnPoolImpl() {
 }
 
 void ConnPoolImpl::ConnPoolImpl::drainConnections() {
-  if (primary_client_ != nullptr) {
-    movePrimaryClientToDraining();
+  while (!primary_clients_.empty()) {
+    movePrimaryClientToDraining(*primary_clients_.front());
   }
 }
 
@@ -47,12 +47,16 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 }
 
 bool ConnPoolImpl::hasActiveConnections() const {
-  if (primary_client_ && primary_client_->client_->numActiveRequests() > 0) {
-    return true;
+  for (const ActiveClientPtr& client : primary_clients_) {
+    if (client->client_->numActiveRequests() > 0) {
+      return true;
+    }
   }
 
-  if (draining_client_ && draining_client_->client_->numActiveRequests() > 0) {
-    return true;
+  for (const ActiveClientPtr& client : draining_clients_) {
+    if (client->client_->numActiveRequests() > 0) {
+      return true;
+    }
   }
 
   return !pending_requests_.empty();
@@ -64,18 +68,21 @@ void ConnPoolImpl::checkForDrained() {
   }
 
   bool drained = true;
-  if (primary_client_) {
-    if (primary_client_->client_->numActiveRequests() == 0) {
-      primary_client_->client_->close();
-      ASSERT(!primary_client_);
+  for (auto it = primary_clients_.begin(); it != primary_clients_.end();) {
+    // Closing the client removes it from the list, so advance the iterator first.
+    ActiveClient& client = **it++;
+    if (client.client_->numActiveRequests() == 0) {
+      client.client_->close();
     } else {
       drained = false;
     }
   }
 
-  ASSERT(!draining_client_ || (draining_client_->client_->numActiveRequests() > 0));
-  if (draining_client_ && draining_client_->client_->numActiveRequests() > 0) {
-    drained = false;
+  for (const ActiveClientPtr& client : draining_clients_) {
+    ASSERT(client->client_->numActiveRequests() > 0);
+    if (client->client_->numActiveRequests() > 0) {
+      drained = false;
+    }
   }
 
   if (drained) {
@@ -86,7 +93,7 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-void ConnPoolImpl::newClientStream(Http::StreamDecoder& response_decoder,
+void ConnPoolImpl::newClientStream(ActiveClient& client, Http::StreamDecoder& response_decoder,
                                    ConnectionPool::Callbacks& callbacks) {
   if (!host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max requests overflow");
@@ -94,16 +101,15 @@ void ConnPoolImpl::newClientStream(Http::StreamDecoder& response_decoder,
                             nullptr);
     host_->cluster().stats().upstream_rq_pending_overflow_.inc();
   } else {
-    ENVOY_CONN_LOG(debug, "creating stream", *primary_client_->client_);
-    primary_client_->total_streams_++;
+    ENVOY_CONN_LOG(debug, "creating stream", *client.client_);
+    client.total_streams_++;
     host_->stats().rq_total_.inc();
     host_->stats().rq_active_.inc();
     host_->cluster().stats().upstream_rq_total_.inc();
     host_->cluster().stats().upstream_rq_active_.inc();
     host_->cluster().resourceManager(priority_).requests().inc();
-    callbacks.onPoolReady(primary_client_->client_->newStream(response_decoder),
-                          primary_client_->real_host_description_,
-                          primary_client_->client_->streamInfo());
+    callbacks.onPoolReady(client.client_->newStream(response_decoder),
+                          client.real_host_description_, client.client_->streamInfo());
   }
 }
 
@@ -117,16 +123,23 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
     max_streams = maxTotalStreams();
   }
 
-  if (primary_client_ && primary_client_->total_streams_ >= max_streams) {
-    movePrimaryClientToDraining();
+  for (auto it = primary_clients_.begin(); it != primary_clients_.end();) {
+    ActiveClient& client = **it++;
+    if (client.total_streams_ >= max_streams) {
+      movePrimaryClientToDraining(client);
+    }
   }
 
-  if (!primary_client_) {
-    primary_client_ = std::make_unique<ActiveClient>(*this);
+  // Replace any missing primary clients, so that spare connections are established ahead of the
+  // streams that will need them.
+  while (primary_clients_.size() < connectionsPerHost()) {
+    ActiveClientPtr client = std::make_unique<ActiveClient>(*this);
+    client->moveIntoListBack(std::move(client), primary_clients_);
   }
 
-  // If the primary client is not connected yet, queue up the request.
-  if (!primary_client_->upstream_ready_) {
+  // If none of the primary clients is connected yet, queue up the request.
+  ActiveClient* client = readyClientWithFewestStreams();
+  if (client == nullptr) {
     // If we're not allowed to enqueue more requests, fail fast.
     if (!host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
       ENVOY_LOG(debug, "max pending requests overflow");
@@ -141,7 +154,7 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
 
   // We already have an active client that's connected to upstream, so attempt to establish a
   // new stream.
-  newClientStream(response_decoder, callbacks);
+  newClientStream(*client, response_decoder, callbacks);
   return nullptr;
 }
 
@@ -169,12 +182,12 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
                            client.client_->connectionFailureReason());
     }
 
-    if (&client == primary_client_.get()) {
+    if (!client.draining_) {
       ENVOY_CONN_LOG(debug, "destroying primary client", *client.client_);
-      dispatcher_.deferredDelete(std::move(primary_client_));
+      dispatcher_.deferredDelete(client.removeFromList(primary_clients_));
     } else {
       ENVOY_CONN_LOG(debug, "destroying draining client", *client.client_);
-      dispatcher_.deferredDelete(std::move(draining_client_));
+      dispatcher_.deferredDelete(client.removeFromList(draining_clients_));
     }
 
     if (client.closed_with_active_rq_) {
@@ -192,25 +205,28 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   client.disarmConnectTimeout();
 }
 
-void ConnPoolImpl::movePrimaryClientToDraining() {
-  ENVOY_CONN_LOG(debug, "moving primary to draining", *primary_client_->client_);
-  if (draining_client_) {
+uint32_t ConnPoolImpl::connectionsPerHost() const {
+  return host_->cluster().http2Settings().connections_per_host_;
+}
+
+void ConnPoolImpl::movePrimaryClientToDraining(ActiveClient& client) {
+  ENVOY_CONN_LOG(debug, "moving primary to draining", *client.client_);
+  ASSERT(!client.draining_);
+  if (draining_clients_.size() >= connectionsPerHost()) {
     // This should pretty much never happen, but is possible if we start draining and then get
-    // a goaway for example. In this case just kill the current draining connection. It's not
-    // worth keeping a list.
-    draining_client_->client_->close();
+    // a goaway for example. In this case just kill the oldest draining connection, so that we do
+    // not keep more draining connections than primary ones.
+    draining_clients_.front()->client_->close();
   }
 
-  ASSERT(!draining_client_);
-  if (primary_client_->client_->numActiveRequests() == 0) {
+  if (client.client_->numActiveRequests() == 0) {
     // If we are making a new connection and the primary does not have any active requests just
     // close it now.
-    primary_client_->client_->close();
+    client.client_->close();
   } else {
-    draining_client_ = std::move(primary_client_);
+    client.draining_ = true;
+    client.moveBetweenLists(primary_clients_, draining_clients_);
   }
-
-  ASSERT(!primary_client_);
 }
 
 void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
@@ -222,8 +238,8 @@ void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
 void ConnPoolImpl::onGoAway(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "remote goaway", *client.client_);
   host_->cluster().stats().upstream_cx_close_notify_.inc();
-  if (&client == primary_client_.get()) {
-    movePrimaryClientToDraining();
+  if (!client.draining_) {
+    movePrimaryClientToDraining(client);
   }
 }
 
@@ -233,7 +249,7 @@ void ConnPoolImpl::onStreamDestroy(ActiveClient& client) {
   host_->stats().rq_active_.dec();
   host_->cluster().stats().upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
-  if (&client == draining_client_.get() && client.client_->numActiveRequests() == 0) {
+  if (client.draining_ && client.client_->numActiveRequests() == 0) {
     // Close out the draining client if we no long have active requests.
     client.client_->close();
   }
@@ -261,11 +277,26 @@ void ConnPoolImpl::onStreamReset(ActiveClient& client, Http::StreamResetReason r
 void ConnPoolImpl::onUpstreamReady() {
   // Establishes new codec streams for each pending request.
   while (!pending_requests_.empty()) {
-    newClientStream(pending_requests_.back()->decoder_, pending_requests_.back()->callbacks_);
+    ActiveClient* client = readyClientWithFewestStreams();
+    ASSERT(client != nullptr);
+    newClientStream(*client, pending_requests_.back()->decoder_,
+                    pending_requests_.back()->callbacks_);
     pending_requests_.pop_back();
   }
 }
 
+ConnPoolImpl::ActiveClient* ConnPoolImpl::readyClientWithFewestStreams() const {
+  ActiveClient* ready_client = nullptr;
+  for (const ActiveClientPtr& client : primary_clients_) {
+    if (client->upstream_ready_ &&
+        (ready_client == nullptr ||
+         client->client_->numActiveRequests() < ready_client->client_->numActiveRequests())) {
+      ready_client = client.get();
+    }
+  }
+  return ready_client;
+}
+
 ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
     : ConnPoolImplBase::ActiveClient(parent.dispatcher_, parent.host_->cluster()), parent_(parent) {
   Upstream::Host::CreateConnectionData data = parent_.host_->createConnection(
@@ -286,7 +317,7 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
                                parent_.host_->cluster().stats().upstream_cx_rx_bytes_buffered_,
                                parent_.host_->cluster().stats().upstream_cx_tx_bytes_total_,
                                parent_.host_->cluster().stats().upstream_cx_tx_bytes_buffered_,
-                               &parent_.host_->cluster().stats().bind_errors_, nullptr});
+                               &parent_.host_->cluster().stats().bind_errors_, nullptr, nullptr});
 }
 
 ConnPoolImpl::ActiveClient::~ActiveClient() {
@@ -18,9 +18,10 @@ namespace Http {
 namespace Http2 {
 
 /**
- * Implementation of a "connection pool" for HTTP/2. This mainly handles stats as well as
- * shifting to a new connection if we reach max streams on the primary. This is a base class
- * used for both the prod implementation as well as the testing one.
+ * Implementation of a "connection pool" for HTTP/2. This mainly handles stats, spreading streams
+ * over the configured number of primary connections, as well as shifting to a new connection if
+ * a primary reaches max streams. This is a base class used for both the prod implementation as
+ * well as the testing one.
  */
 class ConnPoolImpl : public ConnectionPool::Instance, public ConnPoolImplBase {
 public:
@@ -41,6 +42,7 @@ public:
 
 protected:
   struct ActiveClient : ConnPoolImplBase::ActiveClient,
+                        LinkedObject<ActiveClient>,
                         public Network::ConnectionCallbacks,
                         public CodecClientCallbacks,
                         public Event::DeferredDeletable,
@@ -72,6 +74,7 @@ protected:
     uint64_t total_streams_{};
     bool upstream_ready_{};
     bool closed_with_active_rq_{};
+    bool draining_{};
   };
 
   using ActiveClientPtr = std::unique_ptr<ActiveClient>;
@@ -81,18 +84,21 @@ protected:
 
   virtual CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
   virtual uint32_t maxTotalStreams() PURE;
-  void movePrimaryClientToDraining();
+  uint32_t connectionsPerHost() const;
+  void movePrimaryClientToDraining(ActiveClient& client);
   void onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event);
   void onConnectTimeout(ActiveClient& client);
   void onGoAway(ActiveClient& client);
   void onStreamDestroy(ActiveClient& client);
   void onStreamReset(ActiveClient& client, Http::StreamResetReason reason);
-  void newClientStream(Http::StreamDecoder& response_decoder, ConnectionPool::Callbacks& callbacks);
+  void newClientStream(ActiveClient& client, Http::StreamDecoder& response_decoder,
+                       ConnectionPool::Callbacks& callbacks);
   void onUpstreamReady();
+  ActiveClient* readyClientWithFewestStreams() const;
 
   Event::Dispatcher& dispatcher_;
-  ActiveClientPtr primary_client_;
-  ActiveClientPtr draining_client_;
+  std::list<ActiveClientPtr> primary_clients_;
+  std::list<ActiveClientPtr> draining_clients_;
   std::list<DrainedCb> drained_callbacks_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
   const Network::TransportSocketOptionsSharedPtr transport_socket_options_;
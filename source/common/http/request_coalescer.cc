@@ -0,0 +1,90 @@
+#include "common/http/request_coalescer.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Http {
+
+uint64_t CoalescedResponse::byteSize() const {
+  return headers_->byteSize() + body_.size() + (trailers_ != nullptr ? trailers_->byteSize() : 0);
+}
+
+RequestCoalescer::RequestCoalescer(ThreadLocal::SlotAllocator& tls) : tls_(tls.allocateSlot()) {
+  tls_->set([](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalInFlight>();
+  });
+}
+
+bool RequestCoalescer::join(const std::string& key, const CoalescedRequestSharedPtr& request,
+                            Event::Dispatcher& dispatcher) {
+  if (tls_ != nullptr) {
+    return join(tls_->getTyped<ThreadLocalInFlight>().in_flight_, key, request, dispatcher);
+  }
+  Thread::LockGuard lock(lock_);
+  return join(in_flight_, key, request, dispatcher);
+}
+
+void RequestCoalescer::leave(const std::string& key, const CoalescedRequest& request) {
+  if (tls_ != nullptr) {
+    leave(tls_->getTyped<ThreadLocalInFlight>().in_flight_, key, request);
+    return;
+  }
+  Thread::LockGuard lock(lock_);
+  leave(in_flight_, key, request);
+}
+
+void RequestCoalescer::complete(const std::string& key, CoalescedResponseConstSharedPtr response) {
+  if (tls_ != nullptr) {
+    complete(tls_->getTyped<ThreadLocalInFlight>().in_flight_, key, response);
+    return;
+  }
+  // Posting while holding the lock guarantees that the dispatchers are still around: a coalesced
+  // request leaves on its worker thread before it, or its dispatcher, goes away.
+  Thread::LockGuard lock(lock_);
+  complete(in_flight_, key, response);
+}
+
+bool RequestCoalescer::join(InFlightMap& in_flight, const std::string& key,
+                            const CoalescedRequestSharedPtr& request,
+                            Event::Dispatcher& dispatcher) {
+  auto it = in_flight.find(key);
+  if (it == in_flight.end()) {
+    in_flight.emplace(key, std::list<Follower>());
+    return true;
+  }
+  it->second.push_back(Follower{request, dispatcher});
+  return false;
+}
+
+void RequestCoalescer::leave(InFlightMap& in_flight, const std::string& key,
+                             const CoalescedRequest& request) {
+  auto it = in_flight.find(key);
+  if (it == in_flight.end()) {
+    return;
+  }
+  it->second.remove_if([&request](const Follower& follower) {
+    const CoalescedRequestSharedPtr locked = follower.request_.lock();
+    return locked == nullptr || locked.get() == &request;
+  });
+}
+
+void RequestCoalescer::complete(InFlightMap& in_flight, const std::string& key,
+                                const CoalescedResponseConstSharedPtr& response) {
+  auto it = in_flight.find(key);
+  ASSERT(it != in_flight.end());
+  // The coalesced requests are notified from their dispatchers, rather than from the leader's
+  // completion, even on the same worker thread.
+  for (const Follower& follower : it->second) {
+    follower.dispatcher_.post([weak_request = follower.request_, response]() {
+      const CoalescedRequestSharedPtr locked = weak_request.lock();
+      if (locked != nullptr) {
+        locked->onLeaderComplete(response);
+      }
+    });
+  }
+  in_flight.erase(it);
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * A complete upstream response, shared by all the requests coalesced into the request which
+ * received it. It is immutable once shared.
+ */
+struct CoalescedResponse {
+  /**
+   * @return the size of the response, in bytes.
+   */
+  uint64_t byteSize() const;
+
+  HeaderMapPtr headers_;
+  std::string body_;
+  HeaderMapPtr trailers_;
+};
+
+using CoalescedResponseSharedPtr = std::shared_ptr<CoalescedResponse>;
+using CoalescedResponseConstSharedPtr = std::shared_ptr<const CoalescedResponse>;
+
+/**
+ * A request coalesced into an identical request which is in flight.
+ */
+class CoalescedRequest {
+public:
+  virtual ~CoalescedRequest() = default;
+
+  /**
+   * Called on the worker thread of the coalesced request once the request it is coalesced into,
+   * the leader, is over.
+   * @param response supplies the response of the leader, or nullptr if it is not shared, in which
+   *        case the coalesced request must be handled on its own.
+   */
+  virtual void onLeaderComplete(CoalescedResponseConstSharedPtr response) PURE;
+};
+
+using CoalescedRequestSharedPtr = std::shared_ptr<CoalescedRequest>;
+
+/**
+ * Coalesces identical in-flight requests, so that a single one of them, the leader, is forwarded
+ * upstream and the others wait for it to complete. The requests are either coalesced across all
+ * the worker threads, which takes a lock, or only with the requests of the same worker thread,
+ * which does not.
+ */
+class RequestCoalescer {
+public:
+  /**
+   * Coalesce the requests of all the worker threads.
+   */
+  RequestCoalescer() = default;
+
+  /**
+   * Coalesce the requests of each worker thread separately.
+   * @param tls supplies the allocator of the slot holding the in-flight requests of each worker.
+   */
+  explicit RequestCoalescer(ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * Join the in-flight request with the given key. If there is none the caller becomes the
+   * leader, and must call complete() once it is over. Otherwise the request is notified on the
+   * dispatcher once the leader completes, unless it is destroyed or leaves before.
+   * @param key supplies the key of the request.
+   * @param request supplies the request to notify. Only a weak reference to it is kept.
+   * @param dispatcher supplies the dispatcher of the worker thread of the request.
+   * @return true if the caller is the leader.
+   */
+  bool join(const std::string& key, const CoalescedRequestSharedPtr& request,
+            Event::Dispatcher& dispatcher);
+
+  /**
+   * Stop waiting for the leader. Once this returns the request is not notified anymore.
+   */
+  void leave(const std::string& key, const CoalescedRequest& request);
+
+  /**
+   * Complete the in-flight request with the given key, notifying the coalesced requests. Called
+   * by the leader.
+   * @param response supplies the response to share, or nullptr if it is not shared.
+   */
+  void complete(const std::string& key, CoalescedResponseConstSharedPtr response);
+
+private:
+  struct Follower {
+    std::weak_ptr<CoalescedRequest> request_;
+    Event::Dispatcher& dispatcher_;
+  };
+
+  // The requests coalesced into the in-flight requests, by key.
+  using InFlightMap = absl::flat_hash_map<std::string, std::list<Follower>>;
+
+  struct ThreadLocalInFlight : public ThreadLocal::ThreadLocalObject {
+    InFlightMap in_flight_;
+  };
+
+  static bool join(InFlightMap& in_flight, const std::string& key,
+                   const CoalescedRequestSharedPtr& request, Event::Dispatcher& dispatcher);
+  static void leave(InFlightMap& in_flight, const std::string& key,
+                    const CoalescedRequest& request);
+  static void complete(InFlightMap& in_flight, const std::string& key,
+                       const CoalescedResponseConstSharedPtr& response);
+
+  // Set when the requests are coalesced per worker thread, in which case in_flight_ is unused.
+  ThreadLocal::SlotPtr tls_;
+  Thread::MutexBasicLockable lock_;
+  InFlightMap in_flight_ ABSL_GUARDED_BY(lock_);
+};
+
+using RequestCoalescerPtr = std::unique_ptr<RequestCoalescer>;
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,63 @@
+#include "common/http/stream_memory_tracker.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+StreamMemoryTracker& StreamMemoryTracker::threadTracker() {
+  static thread_local StreamMemoryTracker tracker;
+  return tracker;
+}
+
+void StreamMemoryTracker::add(Stream& stream) {
+  const bool inserted = streams_.emplace(&stream, next_order_++).second;
+  ASSERT(inserted);
+}
+
+void StreamMemoryTracker::remove(Stream& stream) { streams_.erase(&stream); }
+
+uint64_t StreamMemoryTracker::resetLargest(double fraction) {
+  struct Candidate {
+    Stream* stream_;
+    uint64_t bytes_;
+    uint64_t order_;
+  };
+
+  // The streams are measured linearly, which is only done under memory pressure.
+  std::vector<Candidate> candidates;
+  uint64_t total_bytes = 0;
+  for (const auto& entry : streams_) {
+    const uint64_t bytes = entry.first->bufferedBytes();
+    if (bytes != 0) {
+      candidates.push_back({entry.first, bytes, entry.second});
+      total_bytes += bytes;
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+    return a.bytes_ != b.bytes_ ? a.bytes_ > b.bytes_ : a.order_ < b.order_;
+  });
+
+  const double target_bytes = fraction * total_bytes;
+  uint64_t reset_bytes = 0;
+  uint64_t reset_streams = 0;
+  for (const Candidate& candidate : candidates) {
+    if (reset_bytes >= target_bytes) {
+      break;
+    }
+    // Resetting a stream may have reset and removed the next ones, as when closing a connection.
+    if (streams_.count(candidate.stream_) == 0) {
+      continue;
+    }
+    reset_bytes += candidate.bytes_;
+    reset_streams++;
+    candidate.stream_->resetForMemory();
+  }
+  return reset_streams;
+}
+
+} // namespace Http
+} // namespace Envoy
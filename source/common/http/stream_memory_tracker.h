@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/common/pure.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * The HTTP streams of a thread, tracked so that those holding the most buffered memory can be reset
+ * first when the process runs out of memory. The memory of the streams is only measured when they
+ * are to be reset, so that tracking a stream costs nothing on its data path.
+ */
+class StreamMemoryTracker : NonCopyable {
+public:
+  /**
+   * A stream tracked by the tracker.
+   */
+  class Stream {
+  public:
+    virtual ~Stream() = default;
+
+    /**
+     * @return uint64_t the bytes of the stream held in buffers, across its codec, its filters and
+     *         its upstream requests.
+     */
+    virtual uint64_t bufferedBytes() PURE;
+
+    /**
+     * Reset the stream to release its memory. The stream may stop being tracked as a result.
+     */
+    virtual void resetForMemory() PURE;
+  };
+
+  /**
+   * @return StreamMemoryTracker& the tracker of the calling thread.
+   */
+  static StreamMemoryTracker& threadTracker();
+
+  /**
+   * Track a stream, which must be removed before it is destroyed.
+   * @param stream supplies the stream.
+   */
+  void add(Stream& stream);
+  void remove(Stream& stream);
+
+  /**
+   * @return size_t the number of streams tracked.
+   */
+  size_t size() const { return streams_.size(); }
+
+  /**
+   * Reset the streams holding the most memory, largest first and the oldest first among those
+   * holding as much memory, until the streams reset held a fraction of the memory of all the
+   * streams. Streams holding no memory are not reset.
+   * @param fraction supplies the fraction of the memory, in [0, 1].
+   * @return uint64_t the number of streams reset.
+   */
+  uint64_t resetLargest(double fraction);
+
+private:
+  StreamMemoryTracker() = default;
+
+  // The streams, with the order they were added in.
+  absl::flat_hash_map<Stream*, uint64_t> streams_;
+  uint64_t next_order_{};
+};
+
+} // namespace Http
+} // namespace Envoy
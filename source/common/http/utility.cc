@@ -266,6 +266,11 @@ Utility::parseHttp2Settings(const envoy::config::core::v3alpha::Http2ProtocolOpt
   ret.max_inbound_window_update_frames_per_data_frame_sent_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       config, max_inbound_window_update_frames_per_data_frame_sent,
       Http::Http2Settings::DEFAULT_MAX_INBOUND_WINDOW_UPDATE_FRAMES_PER_DATA_FRAME_SENT);
+  ret.connections_per_host_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, connections_per_host, Http::Http2Settings::DEFAULT_CONNECTIONS_PER_HOST);
+  ret.max_auto_tuned_window_size_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_auto_tuned_window_size,
+                                      Http::Http2Settings::DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE);
   ret.allow_connect_ = config.allow_connect();
   ret.allow_metadata_ = config.allow_metadata();
   ret.stream_error_on_invalid_http_messaging_ = config.stream_error_on_invalid_http_messaging();
@@ -279,6 +284,8 @@ Utility::parseHttp1Settings(const envoy::config::core::v3alpha::Http1ProtocolOpt
   ret.accept_http_10_ = config.accept_http_10();
   ret.default_host_for_http_10_ = config.default_host_for_http_10();
   ret.enable_trailers_ = config.enable_trailers();
+  ret.prefetch_ratio_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefetch_ratio, 1.0);
+  ret.max_pipelined_requests_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pipelined_requests, 1);
 
   if (config.header_key_format().has_proper_case_words()) {
     ret.header_key_format_ = Http1Settings::HeaderKeyFormat::ProperCase;
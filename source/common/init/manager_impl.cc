@@ -1,13 +1,29 @@
 #include "common/init/manager_impl.h"
 
+#include <algorithm>
+
 #include "common/common/assert.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
 namespace Envoy {
 namespace Init {
 
+namespace {
+
+// The number of slowest targets logged once a timed manager is initialized.
+constexpr size_t MaxLoggedTargets = 10;
+
+} // namespace
+
 ManagerImpl::ManagerImpl(absl::string_view name)
     : name_(fmt::format("init manager {}", name)), state_(State::Uninitialized), count_(0),
-      watcher_(name_, [this]() { onTargetReady(); }) {}
+      watcher_(name_, [this]() { onTargetReady(); }), time_source_(nullptr) {}
+
+ManagerImpl::ManagerImpl(absl::string_view name, TimeSource& time_source)
+    : name_(fmt::format("init manager {}", name)), state_(State::Uninitialized), count_(0),
+      watcher_(name_, [this]() { onTargetReady(); }), time_source_(&time_source) {}
 
 Manager::State ManagerImpl::state() const { return state_; }
 
@@ -18,14 +34,14 @@ void ManagerImpl::add(const Target& target) {
   case State::Uninitialized:
     // If the manager isn't initialized yet, save the target handle to be initialized later.
     ENVOY_LOG(debug, "added {} to {}", target.name(), name_);
-    target_handles_.push_back(std::move(target_handle));
+    target_handles_.emplace_back(std::string(target.name()), std::move(target_handle));
     return;
   case State::Initializing:
     // If the manager is already initializing, initialize the new target immediately. Note that
     // it's important in this case that count_ was incremented above before calling the target,
     // because if the target calls the init manager back immediately, count_ will be decremented
     // here (see the definition of watcher_ above).
-    target_handle->initialize(watcher_);
+    initializeTarget(std::string(target.name()), *target_handle);
     return;
   case State::Initialized:
     // If the manager has already completed initialization, consider this a programming error.
@@ -39,6 +55,9 @@ void ManagerImpl::initialize(const Watcher& watcher) {
 
   // Create a handle to notify when initialization is complete.
   watcher_handle_ = watcher.createHandle(name_);
+  if (time_source_ != nullptr) {
+    start_time_ = time_source_->monotonicTime();
+  }
 
   if (count_ == 0) {
     // If we have no targets, initialization trivially completes. This can happen, and is fine.
@@ -52,13 +71,27 @@ void ManagerImpl::initialize(const Watcher& watcher) {
     // Attempt to initialize each target. If a target is unavailable, treat it as though it
     // completed immediately.
     for (const auto& target_handle : target_handles_) {
-      if (!target_handle->initialize(watcher_)) {
+      if (!initializeTarget(target_handle.first, *target_handle.second)) {
         onTargetReady();
       }
     }
   }
 }
 
+bool ManagerImpl::initializeTarget(const std::string& name, const TargetHandle& target_handle) {
+  if (time_source_ == nullptr) {
+    return target_handle.initialize(watcher_);
+  }
+  // A timed target gets a watcher of its own, so that the manager knows which target is ready.
+  const MonotonicTime start_time = time_source_->monotonicTime();
+  target_watchers_.emplace_back(name_, [this, name, start_time]() {
+    target_durations_.emplace_back(name, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             time_source_->monotonicTime() - start_time));
+    onTargetReady();
+  });
+  return target_handle.initialize(target_watchers_.back());
+}
+
 void ManagerImpl::onTargetReady() {
   // If there are no remaining targets and one mysteriously calls us back, this manager is haunted.
   ASSERT(count_ != 0, fmt::format("{} called back by target after initialization complete"));
@@ -72,8 +105,28 @@ void ManagerImpl::onTargetReady() {
 
 void ManagerImpl::ready() {
   state_ = State::Initialized;
+  if (time_source_ != nullptr) {
+    logTargetDurations();
+  }
   watcher_handle_->ready();
 }
 
+void ManagerImpl::logTargetDurations() const {
+  std::vector<TargetDuration> slowest_targets(target_durations_);
+  const size_t num_logged = std::min(slowest_targets.size(), MaxLoggedTargets);
+  std::partial_sort(
+      slowest_targets.begin(), slowest_targets.begin() + num_logged, slowest_targets.end(),
+      [](const TargetDuration& lhs, const TargetDuration& rhs) { return lhs.second > rhs.second; });
+  slowest_targets.resize(num_logged);
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      time_source_->monotonicTime() - start_time_);
+  const std::string slowest = absl::StrJoin(
+      slowest_targets, ", ", [](std::string* out, const TargetDuration& target) {
+        absl::StrAppend(out, target.first, " (", target.second.count(), "ms)");
+      });
+  ENVOY_LOG(info, "{} initialized {} targets in {}ms, slowest: {}", name_, target_durations_.size(),
+            duration.count(), slowest);
+}
+
 } // namespace Init
 } // namespace Envoy
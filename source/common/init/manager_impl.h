@@ -1,7 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <list>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/init/manager.h"
 
 #include "common/common/logger.h"
@@ -22,6 +27,9 @@ namespace Init {
  *   - Initialization completed for each target and for the manager
  *   - Destruction of targets and watchers
  *   - Callbacks to "unavailable" (deleted) targets, manager, or watchers
+ *
+ * A manager given a time source also times the initialization of each target, and logs the time
+ * it took to initialize along with its slowest targets once it's initialized, to profile startup.
  */
 class ManagerImpl : public Manager, Logger::Loggable<Logger::Id::init> {
 public:
@@ -30,14 +38,25 @@ public:
    */
   ManagerImpl(absl::string_view name);
 
+  /**
+   * @param name a human-readable manager name, for logging / debugging.
+   * @param time_source supplies the time source used to time the initialization of the targets.
+   */
+  ManagerImpl(absl::string_view name, TimeSource& time_source);
+
   // Init::Manager
   State state() const override;
   void add(const Target& target) override;
   void initialize(const Watcher& watcher) override;
 
 private:
+  // The name of a target and the time it took to initialize
+  using TargetDuration = std::pair<std::string, std::chrono::milliseconds>;
+
+  bool initializeTarget(const std::string& name, const TargetHandle& target_handle);
   void onTargetReady();
   void ready();
+  void logTargetDurations() const;
 
   // Human-readable name for logging
   const std::string name_;
@@ -54,8 +73,20 @@ private:
   // Watcher to receive ready notifications from each target
   const WatcherImpl watcher_;
 
-  // All registered targets
-  std::list<TargetHandlePtr> target_handles_;
+  // All registered targets, along with their names
+  std::list<std::pair<std::string, TargetHandlePtr>> target_handles_;
+
+  // Time source timing the targets, or nullptr if they aren't timed
+  TimeSource* const time_source_;
+
+  // When `initialize` was called, if the targets are timed
+  MonotonicTime start_time_;
+
+  // Watchers to receive the ready notification of each timed target
+  std::list<WatcherImpl> target_watchers_;
+
+  // Name and initialization time of each timed target, in the order the targets initialized
+  std::vector<TargetDuration> target_durations_;
 };
 
 } // namespace Init
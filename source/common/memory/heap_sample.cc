@@ -0,0 +1,116 @@
+#include "common/memory/heap_sample.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+#include "common/common/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Memory {
+
+namespace {
+
+constexpr absl::string_view HeaderPrefix = "heap profile:";
+constexpr absl::string_view SampledHeaderLabel = "@ heap_v2/";
+constexpr absl::string_view MappedLibrariesLine = "MAPPED_LIBRARIES:";
+constexpr absl::string_view EnvoyNamespace = "Envoy::";
+constexpr absl::string_view OtherSubsystem = "other";
+
+// Returns the namespace of an Envoy function, keeping one more level for the extensions, or an
+// empty string for the functions of other namespaces.
+std::string subsystem(absl::string_view function) {
+  if (!absl::StartsWith(function, EnvoyNamespace)) {
+    return "";
+  }
+  const std::vector<absl::string_view> names = absl::StrSplit(function, "::");
+  // Envoy, the subsystem, and at least the name of the function.
+  if (names.size() < 3) {
+    return "";
+  }
+  const size_t depth = names[1] == "Extensions" && names.size() > 3 ? 3 : 2;
+  return absl::StrJoin(names.begin(), names.begin() + depth, "::");
+}
+
+} // namespace
+
+std::vector<std::pair<std::string, uint64_t>>
+HeapSample::bytesBySubsystem(absl::string_view heap_sample, const Symbolizer& symbolizer) {
+  uint64_t sample_period = 0;
+  absl::flat_hash_map<uint64_t, std::string> subsystems_by_address;
+  absl::flat_hash_map<std::string, double> bytes_by_subsystem;
+  for (absl::string_view line : absl::StrSplit(heap_sample, '\n')) {
+    line = StringUtil::trim(line);
+    if (absl::StartsWith(line, HeaderPrefix)) {
+      const size_t label = line.find(SampledHeaderLabel);
+      if (label != absl::string_view::npos) {
+        const std::string period(line.substr(label + SampledHeaderLabel.size()));
+        StringUtil::atoull(period.c_str(), sample_period);
+      }
+      continue;
+    }
+    if (line == MappedLibrariesLine) {
+      break;
+    }
+
+    // Lines are: <objects>: <bytes> [<objects>: <bytes>] @ <address>...
+    const size_t at = line.find('@');
+    uint64_t objects = 0;
+    uint64_t bytes = 0;
+    if (at == absl::string_view::npos ||
+        sscanf(std::string(line.substr(0, at)).c_str(), "%" SCNu64 ": %" SCNu64, &objects,
+               &bytes) != 2 ||
+        objects == 0) {
+      continue;
+    }
+    // Allocations are sampled once every sample period bytes on average, so that the chance of an
+    // allocation of n bytes to be sampled is 1 - exp(-n / period). Each sample stands for the
+    // allocations it was chosen among, as estimated by pprof.
+    double estimated_bytes = bytes;
+    if (sample_period > 0) {
+      const double average = static_cast<double>(bytes) / objects;
+      estimated_bytes /= 1 - std::exp(-average / sample_period);
+    }
+
+    std::string allocator;
+    for (absl::string_view frame :
+         absl::StrSplit(line.substr(at + 1), ' ', absl::SkipWhitespace())) {
+      uint64_t address;
+      if (!StringUtil::atoull(std::string(frame).c_str(), address, 16) || address == 0) {
+        continue;
+      }
+      auto it = subsystems_by_address.find(address);
+      if (it == subsystems_by_address.end()) {
+        // The frames are return addresses, which may be past the end of the calling function.
+        it = subsystems_by_address.emplace(address, subsystem(symbolizer(address - 1))).first;
+      }
+      if (!it->second.empty()) {
+        allocator = it->second;
+        break;
+      }
+    }
+    bytes_by_subsystem[allocator.empty() ? std::string(OtherSubsystem) : allocator] +=
+        estimated_bytes;
+  }
+
+  std::vector<std::pair<std::string, uint64_t>> result;
+  result.reserve(bytes_by_subsystem.size());
+  for (const auto& subsystem_bytes : bytes_by_subsystem) {
+    result.emplace_back(subsystem_bytes.first, std::llround(subsystem_bytes.second));
+  }
+  std::sort(result.begin(), result.end(),
+            [](const std::pair<std::string, uint64_t>& a,
+               const std::pair<std::string, uint64_t>& b) {
+              return a.second != b.second ? a.second > b.second : a.first < b.first;
+            });
+  return result;
+}
+
+} // namespace Memory
+} // namespace Envoy
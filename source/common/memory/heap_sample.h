@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * Attribution of the heap in use to the subsystems of Envoy, from a sample of the allocations.
+ */
+class HeapSample {
+public:
+  /**
+   * Returns the name of the function containing an address, or an empty string if unknown.
+   */
+  using Symbolizer = std::function<std::string(uint64_t address)>;
+
+  /**
+   * Estimates the bytes in use allocated by each subsystem. The subsystem of an allocation is the
+   * namespace of the innermost Envoy function of its stack, such as Envoy::Http or
+   * Envoy::Extensions::TransportSockets, or "other" if no Envoy function allocated it.
+   * @param heap_sample the sample of the allocations in use, in the heap profile format of
+   *        tcmalloc, as returned by Profiler::Heap::heapSample().
+   * @param symbolizer returns the demangled names of the functions of the stacks.
+   * @return the estimated bytes in use by subsystem, largest first.
+   */
+  static std::vector<std::pair<std::string, uint64_t>>
+  bytesBySubsystem(absl::string_view heap_sample, const Symbolizer& symbolizer);
+};
+
+} // namespace Memory
+} // namespace Envoy
@@ -9,19 +9,22 @@ namespace Envoy {
 namespace Memory {
 
 // TODO(eziskind): make this configurable
-constexpr std::chrono::milliseconds kTimerInterval = std::chrono::milliseconds(10000);
+constexpr std::chrono::milliseconds kTimerInterval = std::chrono::milliseconds(1000);
+// The free memory released per attempt, which bounds the time the page heap lock is held for.
+constexpr uint64_t kReleaseChunkBytes = 32 * 1024 * 1024;
 
 HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManager& overload_manager,
-                           Stats::Scope& stats)
+                           ThreadLocal::SlotAllocator& tls, Stats::Scope& stats)
     : active_(false) {
   const auto action_name = Server::OverloadActionNames::get().ShrinkHeap;
   if (overload_manager.registerForAction(action_name, dispatcher,
                                          [this](Server::OverloadActionState state) {
-                                           active_ = (state == Server::OverloadActionState::Active);
+                                           active_ = state.isSaturated();
                                          })) {
     Envoy::Stats::StatNameManagedStorage stat_name(
         absl::StrCat("overload.", action_name, ".shrink_count"), stats.symbolTable());
     shrink_counter_ = &stats.counterFromStatName(stat_name.statName());
+    slot_ = tls.allocateSlot();
     timer_ = dispatcher.createTimer([this] {
       shrinkHeap();
       timer_->enableTimer(kTimerInterval);
@@ -32,7 +35,10 @@ HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManage
 
 void HeapShrinker::shrinkHeap() {
   if (active_) {
-    Utils::releaseFreeMemory();
+    // The thread caches are flushed first so that their free memory can be released by the
+    // following attempts.
+    slot_->runOnAllThreads([]() -> void { Utils::flushThreadCache(); });
+    Utils::releaseFreeMemory(kReleaseChunkBytes);
     shrink_counter_->inc();
   }
 }
@@ -4,6 +4,7 @@
 #include "envoy/server/overload_manager.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats.h"
+#include "envoy/thread_local/thread_local.h"
 
 namespace Envoy {
 namespace Memory {
@@ -11,11 +12,14 @@ namespace Memory {
 /**
  * A utility class to periodically attempt to shrink the heap by releasing free memory
  * to the system if the "shrink heap" overload action has been configured and triggered.
+ * Each attempt flushes the thread caches of all the threads, on each thread in between its
+ * events, and releases a bounded chunk of the free memory, so that memory is returned gradually
+ * rather than in a single pause of the main thread.
  */
 class HeapShrinker {
 public:
   HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManager& overload_manager,
-               Envoy::Stats::Scope& stats);
+               ThreadLocal::SlotAllocator& tls, Envoy::Stats::Scope& stats);
 
 private:
   void shrinkHeap();
@@ -23,6 +27,7 @@ private:
   bool active_;
   Envoy::Stats::Counter* shrink_counter_;
   Envoy::Event::TimerPtr timer_;
+  ThreadLocal::SlotPtr slot_;
 };
 
 } // namespace Memory
@@ -1,5 +1,7 @@
 #include "common/memory/utils.h"
 
+#include "common/common/macros.h"
+
 #ifdef TCMALLOC
 #include "gperftools/malloc_extension.h"
 #endif
@@ -7,9 +9,17 @@
 namespace Envoy {
 namespace Memory {
 
-void Utils::releaseFreeMemory() {
+void Utils::releaseFreeMemory(uint64_t bytes) {
+#ifdef TCMALLOC
+  MallocExtension::instance()->ReleaseToSystem(bytes);
+#else
+  UNREFERENCED_PARAMETER(bytes);
+#endif
+}
+
+void Utils::flushThreadCache() {
 #ifdef TCMALLOC
-  MallocExtension::instance()->ReleaseFreeMemory();
+  MallocExtension::instance()->MarkThreadIdle();
 #endif
 }
 
@@ -1,11 +1,24 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Envoy {
 namespace Memory {
 
 class Utils {
 public:
-  static void releaseFreeMemory();
+  /**
+   * Release free memory of the page heap to the system, in the amount given if there is that
+   * much, so that the time spent holding the page heap lock is bounded.
+   * @param bytes the number of bytes to release.
+   */
+  static void releaseFreeMemory(uint64_t bytes);
+
+  /**
+   * Return the free memory cached by the calling thread to the page heap, from where it can be
+   * released. The thread cache is recreated on the next allocation of the thread.
+   */
+  static void flushThreadCache();
 };
 
 } // namespace Memory
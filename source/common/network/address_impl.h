@@ -10,6 +10,8 @@
 #include "envoy/network/address.h"
 #include "envoy/network/io_handle.h"
 
+#include "absl/base/call_once.h"
+
 namespace Envoy {
 namespace Network {
 namespace Address {
@@ -99,6 +101,8 @@ public:
   explicit Ipv4Instance(uint32_t port);
 
   // Network::Address::Instance
+  const std::string& asString() const override { return ip_.friendlyName(); }
+  absl::string_view asStringView() const override { return ip_.friendlyName(); }
   bool operator==(const Instance& rhs) const override;
   Api::SysCallIntResult bind(int fd) const override;
   Api::SysCallIntResult connect(int fd) const override;
@@ -126,8 +130,13 @@ private:
     sockaddr_in address_;
   };
 
+  // The address is formatted on first use when constructed from a socket address, as the addresses
+  // of the peers of the connections and datagrams are often never formatted.
   struct IpHelper : public Ip {
-    const std::string& addressAsString() const override { return friendly_address_; }
+    const std::string& addressAsString() const override {
+      format();
+      return friendly_address_;
+    }
     bool isAnyAddress() const override { return ipv4_.address_.sin_addr.s_addr == INADDR_ANY; }
     bool isUnicastAddress() const override {
       return !isAnyAddress() && (ipv4_.address_.sin_addr.s_addr != INADDR_BROADCAST) &&
@@ -139,8 +148,16 @@ private:
     uint32_t port() const override { return ntohs(ipv4_.address_.sin_port); }
     IpVersion version() const override { return IpVersion::v4; }
 
+    const std::string& friendlyName() const {
+      format();
+      return friendly_name_;
+    }
+    void format() const;
+
     Ipv4Helper ipv4_;
-    std::string friendly_address_;
+    mutable absl::once_flag formatted_;
+    mutable std::string friendly_address_;
+    mutable std::string friendly_name_;
   };
 
   IpHelper ip_;
@@ -173,6 +190,8 @@ public:
   explicit Ipv6Instance(uint32_t port);
 
   // Network::Address::Instance
+  const std::string& asString() const override { return ip_.friendlyName(); }
+  absl::string_view asStringView() const override { return ip_.friendlyName(); }
   bool operator==(const Instance& rhs) const override;
   Api::SysCallIntResult bind(int fd) const override;
   Api::SysCallIntResult connect(int fd) const override;
@@ -196,8 +215,12 @@ private:
     sockaddr_in6 address_;
   };
 
+  // As for IPv4, the address is formatted on first use when constructed from a socket address.
   struct IpHelper : public Ip {
-    const std::string& addressAsString() const override { return friendly_address_; }
+    const std::string& addressAsString() const override {
+      format();
+      return friendly_address_;
+    }
     bool isAnyAddress() const override {
       return 0 == memcmp(&ipv6_.address_.sin6_addr, &in6addr_any, sizeof(struct in6_addr));
     }
@@ -209,8 +232,16 @@ private:
     uint32_t port() const override { return ipv6_.port(); }
     IpVersion version() const override { return IpVersion::v6; }
 
+    const std::string& friendlyName() const {
+      format();
+      return friendly_name_;
+    }
+    void format() const;
+
     Ipv6Helper ipv6_;
-    std::string friendly_address_;
+    mutable absl::once_flag formatted_;
+    mutable std::string friendly_address_;
+    mutable std::string friendly_name_;
     // Is IPv4 compatibility (https://tools.ietf.org/html/rfc3493#page-11) disabled?
     // Default initialized to true to preserve extant Envoy behavior where we don't explicitly set
     // this in the constructor.
@@ -15,7 +15,25 @@ namespace Envoy {
 namespace Network {
 
 Address::InstanceConstSharedPtr BaseListenerImpl::getLocalAddress(int fd) {
-  return Address::addressFromFd(fd);
+  sockaddr_storage ss;
+  socklen_t ss_len = sizeof(ss);
+  if (::getsockname(fd, reinterpret_cast<sockaddr*>(&ss), &ss_len) != 0) {
+    throw EnvoyException(
+        fmt::format("getsockname failed for '{}': ({}) {}", fd, errno, strerror(errno)));
+  }
+  const absl::string_view key(reinterpret_cast<const char*>(&ss), ss_len);
+  const auto it = local_addresses_.find(key);
+  if (it != local_addresses_.end()) {
+    return it->second;
+  }
+
+  // The first connection to an address creates its instance, with the same IPv4-mapping as for any
+  // other socket.
+  Address::InstanceConstSharedPtr address = Address::addressFromFd(fd);
+  if (local_addresses_.size() < MaxInternedLocalAddresses) {
+    local_addresses_.emplace(std::string(key), address);
+  }
+  return address;
 }
 
 BaseListenerImpl::BaseListenerImpl(Event::DispatcherImpl& dispatcher, SocketSharedPtr socket)
@@ -6,6 +6,7 @@
 #include "common/event/libevent.h"
 #include "common/network/listen_socket_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "event2/event.h"
 
 namespace Envoy {
@@ -23,11 +24,26 @@ public:
   BaseListenerImpl(Event::DispatcherImpl& dispatcher, SocketSharedPtr socket);
 
 protected:
+  /**
+   * Get the local address of a socket accepted by a listener on the all hosts address. The
+   * addresses are interned, so that the connections to the same local address share its instance
+   * rather than each allocating and formatting it.
+   * @param fd supplies the accepted socket.
+   * @return Address::InstanceConstSharedPtr the local address of the socket.
+   */
   virtual Address::InstanceConstSharedPtr getLocalAddress(int fd);
 
   Address::InstanceConstSharedPtr local_address_;
   Event::DispatcherImpl& dispatcher_;
   const SocketSharedPtr socket_;
+
+private:
+  // A transparent listener can accept connections to any address, so only so many are interned.
+  static constexpr size_t MaxInternedLocalAddresses = 64;
+
+  // The interned local addresses, keyed by their socket address. The listener accepts on the thread
+  // of its dispatcher only, so this needs no lock.
+  absl::flat_hash_map<std::string, Address::InstanceConstSharedPtr> local_addresses_;
 };
 
 } // namespace Network
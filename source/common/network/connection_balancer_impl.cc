@@ -1,5 +1,10 @@
 #include "common/network/connection_balancer_impl.h"
 
+#include <thread>
+
+#include "common/common/assert.h"
+#include "common/thread_local/rcu_slot.h"
+
 namespace Envoy {
 namespace Network {
 
@@ -34,5 +39,79 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+PowerOfTwoChoicesConnectionBalancerImpl::PowerOfTwoChoicesConnectionBalancerImpl(
+    Runtime::RandomGenerator& random, uint32_t max_handlers)
+    : random_(random), handlers_(new Handlers(max_handlers)) {
+  ASSERT(max_handlers > 0);
+}
+
+PowerOfTwoChoicesConnectionBalancerImpl::~PowerOfTwoChoicesConnectionBalancerImpl() {
+  delete handlers_.load();
+}
+
+void PowerOfTwoChoicesConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&update_lock_);
+  auto handlers = std::make_unique<Handlers>(*handlers_.load());
+  for (BalancedConnectionHandler*& slot : *handlers) {
+    if (slot == nullptr) {
+      slot = &handler;
+      publish(std::move(handlers));
+      return;
+    }
+  }
+  // Every worker registers at most one handler per listener.
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void PowerOfTwoChoicesConnectionBalancerImpl::unregisterHandler(
+    BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&update_lock_);
+  auto handlers = std::make_unique<Handlers>(*handlers_.load());
+  for (BalancedConnectionHandler*& slot : *handlers) {
+    if (slot == &handler) {
+      slot = nullptr;
+      publish(std::move(handlers));
+      return;
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void PowerOfTwoChoicesConnectionBalancerImpl::publish(std::unique_ptr<const Handlers>&& handlers) {
+  const std::unique_ptr<const Handlers> previous(handlers_.exchange(handlers.release()));
+  const uint64_t epoch = ThreadLocal::RcuEpoch::retire();
+  // A pick only compares two connection counts, so the picks still reading the previous snapshot
+  // are over after a few yields. Registering and unregistering are rare, so waiting here keeps the
+  // accept path free of locks.
+  while (!ThreadLocal::RcuEpoch::quiescent(epoch)) {
+    std::this_thread::yield();
+  }
+}
+
+BalancedConnectionHandler&
+PowerOfTwoChoicesConnectionBalancerImpl::pickTargetHandler(
+    BalancedConnectionHandler& current_handler) {
+  // The accepting handler is always one of the two choices, so that a connection only moves to
+  // another worker when that worker has fewer connections.
+  const uint64_t random = random_.random();
+  BalancedConnectionHandler* target = &current_handler;
+  {
+    // Unregistering waits for this read to be over, so the other choice stays alive until its
+    // connection count has been incremented.
+    ThreadLocal::RcuReadScope scope;
+    const Handlers& handlers = *handlers_.load();
+    const size_t index = random % handlers.size();
+    BalancedConnectionHandler* other = handlers[index];
+    if (other == &current_handler) {
+      other = handlers[(index + 1) % handlers.size()];
+    }
+    if (other != nullptr && other->numConnections() < current_handler.numConnections()) {
+      target = other;
+    }
+    target->incNumConnections();
+  }
+  return *target;
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "envoy/network/connection_balancer.h"
+#include "envoy/runtime/runtime.h"
 
 #include "absl/synchronization/mutex.h"
 
@@ -27,6 +32,44 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ GUARDED_BY(lock_);
 };
 
+/**
+ * Implementation of connection balancer that uses the power of two choices. Each connection goes
+ * to the less loaded of the accepting handler and one other randomly picked handler. This keeps
+ * connection counts close to balanced without any lock on the accept path, so that handlers
+ * accepting in parallel do not wait on each other, at the cost of slightly less even counts than
+ * ExactConnectionBalancerImpl. The handlers are published as an immutable snapshot, which
+ * registering and unregistering replace, and picking a handler is an RCU read of the snapshot.
+ * Unregistering waits for the picks which may have read the previous snapshot, so a picked handler
+ * is not destroyed until its connection count has been incremented.
+ */
+class PowerOfTwoChoicesConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  /**
+   * @param random supplies the random generator used to pick the second handler.
+   * @param max_handlers supplies the maximum number of handlers registered at any time, i.e. the
+   *        number of workers.
+   */
+  PowerOfTwoChoicesConnectionBalancerImpl(Runtime::RandomGenerator& random, uint32_t max_handlers);
+  ~PowerOfTwoChoicesConnectionBalancerImpl() override;
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  using Handlers = std::vector<BalancedConnectionHandler*>;
+
+  // Replaces the snapshot, and returns once no pick may still be reading the previous one.
+  void publish(std::unique_ptr<const Handlers>&& handlers) EXCLUSIVE_LOCKS_REQUIRED(update_lock_);
+
+  Runtime::RandomGenerator& random_;
+  // Serializes registering and unregistering. Picking a handler does not take it.
+  absl::Mutex update_lock_;
+  // The snapshot of the handlers. Null entries are free slots, one per worker.
+  std::atomic<const Handlers*> handlers_;
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
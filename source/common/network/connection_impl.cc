@@ -9,6 +9,7 @@
 #include "envoy/config/core/v3alpha/base.pb.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
+#include "envoy/stats/histogram.h"
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
@@ -46,9 +47,13 @@ ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPt
     : ConnectionImplBase(dispatcher, next_global_id_++),
       transport_socket_(std::move(transport_socket)), socket_(std::move(socket)),
       filter_manager_(*this), stream_info_(dispatcher.timeSource()),
-      write_buffer_(
-          dispatcher.getWatermarkFactory().create([this]() -> void { this->onLowWatermark(); },
-                                                  [this]() -> void { this->onHighWatermark(); })),
+      // The server connections are the downstream ones, as the client connections are not
+      // connected on creation.
+      write_buffer_(dispatcher.getWatermarkFactory().create(
+          [this]() -> void { this->onLowWatermark(); },
+          [this]() -> void { this->onHighWatermark(); },
+          connected ? Buffer::MemoryClass::DownstreamConnection
+                    : Buffer::MemoryClass::UpstreamConnection)),
       read_enabled_(true), above_high_watermark_(false), detect_early_close_(true),
       enable_half_close_(false), read_end_stream_raised_(false), read_end_stream_(false),
       write_end_stream_(false), current_write_end_stream_(false), dispatch_buffered_data_(false) {
@@ -526,6 +531,12 @@ void ConnectionImpl::onReadReady() {
   }
   dispatch_buffered_data_ = false;
 
+  if (read_buffer_.length() == 0) {
+    // The last read leaves space reserved in the read buffer, which an idle connection would
+    // otherwise keep until it's read from again.
+    read_buffer_.releaseEmptySlices();
+  }
+
   // The read callback may have already closed the connection.
   if (result.action_ == PostIoAction::Close || bothSidesHalfClosed()) {
     ENVOY_CONN_LOG(debug, "remote close", *this);
@@ -636,6 +647,12 @@ void ConnectionImpl::updateWriteBufferStats(uint64_t num_written, uint64_t new_s
                                            connection_stats_->write_current_);
 }
 
+void ConnectionImpl::recordReadsPerEvent(uint32_t num_reads) {
+  if (connection_stats_ && connection_stats_->reads_per_event_) {
+    connection_stats_->reads_per_event_->recordValue(num_reads);
+  }
+}
+
 bool ConnectionImpl::bothSidesHalfClosed() {
   // If the write_buffer_ is not empty, then the end_stream has not been sent to the transport yet.
   return read_end_stream_ && write_end_stream_ && write_buffer_->length() == 0;
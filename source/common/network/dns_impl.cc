@@ -1,5 +1,6 @@
 #include "common/network/dns_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -22,26 +23,15 @@ namespace Network {
 DnsResolverImpl::DnsResolverImpl(
     Event::Dispatcher& dispatcher,
     const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers,
-    const bool use_tcp_for_dns_lookups)
-    : dispatcher_(dispatcher),
-      timer_(dispatcher.createTimer([this] { onEventCallback(ARES_SOCKET_BAD, 0); })) {
-  ares_options options{};
-  int optmask = 0;
-
-  if (use_tcp_for_dns_lookups) {
-    optmask |= ARES_OPT_FLAGS;
-    options.flags |= ARES_FLAG_USEVC;
-  }
-
-  initializeChannel(&options, optmask);
-
+    const DnsResolverOptions& options)
+    : dispatcher_(dispatcher), negative_cache_ttl_(options.negative_cache_ttl_) {
+  std::string resolvers_csv;
   if (!resolvers.empty()) {
     std::vector<std::string> resolver_addrs;
     resolver_addrs.reserve(resolvers.size());
     for (const auto& resolver : resolvers) {
       // This should be an IP address (i.e. not a pipe).
       if (resolver->ip() == nullptr) {
-        ares_destroy(channel_);
         throw EnvoyException(
             fmt::format("DNS resolver '{}' is not an IP address", resolver->asString()));
       }
@@ -54,20 +44,47 @@ DnsResolverImpl::DnsResolverImpl(
                                            resolver->ip()->addressAsString(),
                                            resolver->ip()->port()));
     }
-    const std::string resolvers_csv = absl::StrJoin(resolver_addrs, ",");
-    int result = ares_set_servers_ports_csv(channel_, resolvers_csv.c_str());
-    RELEASE_ASSERT(result == ARES_SUCCESS, "");
+    resolvers_csv = absl::StrJoin(resolver_addrs, ",");
+  }
+
+  for (uint32_t i = 0; i < std::max<uint32_t>(options.channels_, 1); i++) {
+    ares_options ares_opts{};
+    int optmask = 0;
+
+    if (options.use_tcp_for_dns_lookups_) {
+      optmask |= ARES_OPT_FLAGS;
+      ares_opts.flags |= ARES_FLAG_USEVC;
+    }
+
+    channels_.push_back(std::make_unique<Channel>(dispatcher, &ares_opts, optmask));
+    if (!resolvers_csv.empty()) {
+      int result = ares_set_servers_ports_csv(channels_.back()->channel_, resolvers_csv.c_str());
+      RELEASE_ASSERT(result == ARES_SUCCESS, "");
+    }
   }
 }
 
 DnsResolverImpl::~DnsResolverImpl() {
+  // The pending resolutions are deleted by the destruction of their channel, before the maps
+  // they may be in.
+  channels_.clear();
+}
+
+DnsResolverImpl::Channel::Channel(Event::Dispatcher& dispatcher, ares_options* options,
+                                  int optmask)
+    : dispatcher_(dispatcher),
+      timer_(dispatcher.createTimer([this] { onEventCallback(ARES_SOCKET_BAD, 0); })) {
+  initialize(options, optmask);
+}
+
+DnsResolverImpl::Channel::~Channel() {
   timer_->disableTimer();
   ares_destroy(channel_);
 }
 
-void DnsResolverImpl::initializeChannel(ares_options* options, int optmask) {
+void DnsResolverImpl::Channel::initialize(ares_options* options, int optmask) {
   options->sock_state_cb = [](void* arg, int fd, int read, int write) {
-    static_cast<DnsResolverImpl*>(arg)->onAresSocketStateChange(fd, read, write);
+    static_cast<Channel*>(arg)->onAresSocketStateChange(fd, read, write);
   };
   options->sock_state_cb_data = this;
   ares_init_options(&channel_, options, optmask | ARES_OPT_SOCK_STATE_CB);
@@ -127,20 +144,13 @@ void DnsResolverImpl::PendingResolution::onAresGetAddrInfoCallback(int status, i
   }
 
   if (completed_) {
-    if (!cancelled_) {
-      try {
-        callback_(std::move(address_list));
-      } catch (const EnvoyException& e) {
-        ENVOY_LOG(critical, "EnvoyException in c-ares callback");
-        dispatcher_.post([s = std::string(e.what())] { throw EnvoyException(s); });
-      } catch (const std::exception& e) {
-        ENVOY_LOG(critical, "std::exception in c-ares callback");
-        dispatcher_.post([s = std::string(e.what())] { throw EnvoyException(s); });
-      } catch (...) {
-        ENVOY_LOG(critical, "Unknown exception in c-ares callback");
-        dispatcher_.post([] { throw EnvoyException("unknown"); });
-      }
+    if (owned_) {
+      parent_.pending_resolutions_.erase(key_);
     }
+    if (address_list.empty() && parent_.negative_cache_ttl_.count() > 0) {
+      parent_.negativelyCache(key_);
+    }
+    runCallbacks(std::move(address_list));
     if (owned_) {
       delete this;
       return;
@@ -156,7 +166,36 @@ void DnsResolverImpl::PendingResolution::onAresGetAddrInfoCallback(int status, i
   }
 }
 
-void DnsResolverImpl::updateAresTimer() {
+void DnsResolverImpl::PendingCallback::cancel() {
+  // c-ares only supports channel-wide cancellation, so we just allow the
+  // network events to continue but don't invoke the callback on completion.
+  removeFromList(parent_.callbacks_);
+}
+
+void DnsResolverImpl::PendingResolution::runCallbacks(std::list<DnsResponse>&& address_list) {
+  // The callbacks are removed one at a time as they may cancel the others.
+  while (!callbacks_.empty()) {
+    PendingCallbackPtr callback = callbacks_.front()->removeFromList(callbacks_);
+    try {
+      if (callbacks_.empty()) {
+        callback->callback_(std::move(address_list));
+      } else {
+        callback->callback_(std::list<DnsResponse>(address_list));
+      }
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG(critical, "EnvoyException in c-ares callback");
+      parent_.dispatcher_.post([s = std::string(e.what())] { throw EnvoyException(s); });
+    } catch (const std::exception& e) {
+      ENVOY_LOG(critical, "std::exception in c-ares callback");
+      parent_.dispatcher_.post([s = std::string(e.what())] { throw EnvoyException(s); });
+    } catch (...) {
+      ENVOY_LOG(critical, "Unknown exception in c-ares callback");
+      parent_.dispatcher_.post([] { throw EnvoyException("unknown"); });
+    }
+  }
+}
+
+void DnsResolverImpl::Channel::updateAresTimer() {
   // Update the timeout for events.
   timeval timeout;
   timeval* timeout_result = ares_timeout(channel_, nullptr, &timeout);
@@ -170,14 +209,14 @@ void DnsResolverImpl::updateAresTimer() {
   }
 }
 
-void DnsResolverImpl::onEventCallback(int fd, uint32_t events) {
+void DnsResolverImpl::Channel::onEventCallback(int fd, uint32_t events) {
   const ares_socket_t read_fd = events & Event::FileReadyType::Read ? fd : ARES_SOCKET_BAD;
   const ares_socket_t write_fd = events & Event::FileReadyType::Write ? fd : ARES_SOCKET_BAD;
   ares_process_fd(channel_, read_fd, write_fd);
   updateAresTimer();
 }
 
-void DnsResolverImpl::onAresSocketStateChange(int fd, int read, int write) {
+void DnsResolverImpl::Channel::onAresSocketStateChange(int fd, int read, int write) {
   updateAresTimer();
   auto it = events_.find(fd);
   // Stop tracking events for fd if no more state change events.
@@ -198,13 +237,61 @@ void DnsResolverImpl::onAresSocketStateChange(int fd, int read, int write) {
                           (write ? Event::FileReadyType::Write : 0));
 }
 
+DnsResolverImpl::Channel& DnsResolverImpl::nextChannel() {
+  Channel& channel = *channels_[next_channel_];
+  next_channel_ = (next_channel_ + 1) % static_cast<uint32_t>(channels_.size());
+  return channel;
+}
+
+bool DnsResolverImpl::negativelyCached(const QueryKey& key) {
+  purgeNegativeCache(dispatcher_.timeSource().monotonicTime());
+  return negative_cache_.contains(key);
+}
+
+void DnsResolverImpl::negativelyCache(const QueryKey& key) {
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  purgeNegativeCache(now);
+  negative_cache_[key] = now + negative_cache_ttl_;
+  negative_cache_expirations_.emplace_back(now + negative_cache_ttl_, key);
+}
+
+void DnsResolverImpl::purgeNegativeCache(MonotonicTime now) {
+  while (!negative_cache_expirations_.empty() &&
+         negative_cache_expirations_.front().first <= now) {
+    const auto& expiration = negative_cache_expirations_.front();
+    auto it = negative_cache_.find(expiration.second);
+    // The failure may have been cached again since, in which case a later entry expires it.
+    if (it != negative_cache_.end() && it->second == expiration.first) {
+      negative_cache_.erase(it);
+    }
+    negative_cache_expirations_.pop_front();
+  }
+}
+
 ActiveDnsQuery* DnsResolverImpl::resolve(const std::string& dns_name,
                                          DnsLookupFamily dns_lookup_family, ResolveCb callback) {
+  QueryKey key(dns_name, dns_lookup_family);
+  if (negative_cache_ttl_.count() > 0 && negativelyCached(key)) {
+    ENVOY_LOG(debug, "DNS resolution of {} recently failed", dns_name);
+    callback({});
+    return nullptr;
+  }
+
+  // Wait on the identical resolution in flight, if any.
+  auto it = pending_resolutions_.find(key);
+  if (it != pending_resolutions_.end()) {
+    auto pending_callback = std::make_unique<PendingCallback>(*it->second, callback);
+    pending_callback->moveIntoListBack(std::move(pending_callback), it->second->callbacks_);
+    return it->second->callbacks_.back().get();
+  }
+
   // TODO(hennna): Add DNS caching which will allow testing the edge case of a
   // failed initial call to getHostByName followed by a synchronous IPv4
   // resolution.
   std::unique_ptr<PendingResolution> pending_resolution(
-      new PendingResolution(callback, dispatcher_, channel_, dns_name));
+      new PendingResolution(*this, nextChannel(), key));
+  auto pending_callback = std::make_unique<PendingCallback>(*pending_resolution, callback);
+  pending_callback->moveIntoListBack(std::move(pending_callback), pending_resolution->callbacks_);
   if (dns_lookup_family == DnsLookupFamily::Auto) {
     pending_resolution->fallback_if_failed_ = true;
   }
@@ -221,12 +308,15 @@ ActiveDnsQuery* DnsResolverImpl::resolve(const std::string& dns_name,
     return nullptr;
   } else {
     // Enable timer to wake us up if the request times out.
-    updateAresTimer();
+    pending_resolution->channel_.updateAresTimer();
 
     // The PendingResolution will self-delete when the request completes
     // (including if cancelled or if ~DnsResolverImpl() happens).
     pending_resolution->owned_ = true;
-    return pending_resolution.release();
+    pending_resolutions_[key] = pending_resolution.get();
+    ActiveDnsQuery* query = pending_resolution->callbacks_.back().get();
+    pending_resolution.release();
+    return query;
   }
 }
 
@@ -241,7 +331,7 @@ void DnsResolverImpl::PendingResolution::getAddrInfo(int family) {
   hints.ai_flags = ARES_AI_NOSORT;
 
   ares_getaddrinfo(
-      channel_, dns_name_.c_str(), /* service */ nullptr, &hints,
+      channel_.channel_, key_.first.c_str(), /* service */ nullptr, &hints,
       [](void* arg, int status, int timeouts, ares_addrinfo* addrinfo) {
         static_cast<PendingResolution*>(arg)->onAresGetAddrInfoCallback(status, timeouts, addrinfo);
       },
@@ -1,10 +1,16 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "envoy/common/platform.h"
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/file_event.h"
 #include "envoy/network/dns.h"
@@ -13,6 +19,7 @@
 #include "common/common/logger.h"
 #include "common/common/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "ares.h"
 
 namespace Envoy {
@@ -22,13 +29,15 @@ class DnsResolverImplPeer;
 
 /**
  * Implementation of DnsResolver that uses c-ares. All calls and callbacks are assumed to
- * happen on the thread that owns the creating dispatcher.
+ * happen on the thread that owns the creating dispatcher. Identical concurrent resolutions are
+ * coalesced into a single query, failed resolutions may be cached for a while, and the queries may
+ * be spread over several c-ares channels.
  */
 class DnsResolverImpl : public DnsResolver, protected Logger::Loggable<Logger::Id::upstream> {
 public:
   DnsResolverImpl(Event::Dispatcher& dispatcher,
                   const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers,
-                  const bool use_tcp_for_dns_lookups);
+                  const DnsResolverOptions& options);
   ~DnsResolverImpl() override;
 
   // Network::DnsResolver
@@ -37,17 +46,61 @@ public:
 
 private:
   friend class DnsResolverImplPeer;
-  struct PendingResolution : public ActiveDnsQuery {
+  using QueryKey = std::pair<std::string, DnsLookupFamily>;
+
+  /**
+   * A c-ares channel, with the sockets and the timer it needs the dispatcher to watch.
+   */
+  class Channel {
+  public:
+    Channel(Event::Dispatcher& dispatcher, ares_options* options, int optmask);
+    ~Channel();
+
+    // Initialize the channel with given ares_init_options().
+    void initialize(ares_options* options, int optmask);
+    // Update timer for c-ares timeouts.
+    void updateAresTimer();
+
+    ares_channel channel_;
+
+  private:
+    friend class DnsResolverImplPeer;
+
+    // Callback for events on sockets tracked in events_.
+    void onEventCallback(int fd, uint32_t events);
+    // c-ares callback when a socket state changes, indicating that libevent
+    // should listen for read/write events.
+    void onAresSocketStateChange(int fd, int read, int write);
+
+    Event::Dispatcher& dispatcher_;
+    Event::TimerPtr timer_;
+    std::unordered_map<int, Event::FileEventPtr> events_;
+  };
+
+  using ChannelPtr = std::unique_ptr<Channel>;
+
+  struct PendingResolution;
+
+  /**
+   * A caller waiting on a pending resolution.
+   */
+  struct PendingCallback : public ActiveDnsQuery, LinkedObject<PendingCallback> {
+    PendingCallback(PendingResolution& parent, ResolveCb callback)
+        : parent_(parent), callback_(callback) {}
+
     // Network::ActiveDnsQuery
-    PendingResolution(ResolveCb callback, Event::Dispatcher& dispatcher, ares_channel channel,
-                      const std::string& dns_name)
-        : callback_(callback), dispatcher_(dispatcher), channel_(channel), dns_name_(dns_name) {}
+    void cancel() override;
+
+    PendingResolution& parent_;
+    // Caller supplied callback to invoke on query completion or error.
+    const ResolveCb callback_;
+  };
+
+  using PendingCallbackPtr = std::unique_ptr<PendingCallback>;
 
-    void cancel() override {
-      // c-ares only supports channel-wide cancellation, so we just allow the
-      // network events to continue but don't invoke the callback on completion.
-      cancelled_ = true;
-    }
+  struct PendingResolution {
+    PendingResolution(DnsResolverImpl& parent, Channel& channel, const QueryKey& key)
+        : parent_(parent), channel_(channel), key_(key) {}
 
     /**
      * ares_getaddrinfo query callback.
@@ -61,39 +114,44 @@ private:
      * @param family currently AF_INET and AF_INET6 are supported.
      */
     void getAddrInfo(int family);
+    // Invoke the callbacks of the callers that have not cancelled.
+    void runCallbacks(std::list<DnsResponse>&& address_list);
 
-    // Caller supplied callback to invoke on query completion or error.
-    const ResolveCb callback_;
-    // Dispatcher to post any callback_ exceptions to.
-    Event::Dispatcher& dispatcher_;
+    DnsResolverImpl& parent_;
+    Channel& channel_;
+    const QueryKey key_;
+    // The callers waiting on the resolution.
+    std::list<PendingCallbackPtr> callbacks_;
     // Does the object own itself? Resource reclamation occurs via self-deleting
     // on query completion or error.
     bool owned_ = false;
     // Has the query completed? Only meaningful if !owned_;
     bool completed_ = false;
-    // Was the query cancelled via cancel()?
-    bool cancelled_ = false;
     // If dns_lookup_family is "fallback", fallback to v4 address if v6
     // resolution failed.
     bool fallback_if_failed_ = false;
-    const ares_channel channel_;
-    const std::string dns_name_;
   };
 
-  // Callback for events on sockets tracked in events_.
-  void onEventCallback(int fd, uint32_t events);
-  // c-ares callback when a socket state changes, indicating that libevent
-  // should listen for read/write events.
-  void onAresSocketStateChange(int fd, int read, int write);
-  // Initialize the channel with given ares_init_options().
-  void initializeChannel(ares_options* options, int optmask);
-  // Update timer for c-ares timeouts.
-  void updateAresTimer();
+  // @return the channel of the next query, in turn.
+  Channel& nextChannel();
+  // @return true if the resolution of the key is known to have failed recently.
+  bool negativelyCached(const QueryKey& key);
+  // Remember that the resolution of the key failed, for the negative cache TTL.
+  void negativelyCache(const QueryKey& key);
+  // Drop the failures which expired from the negative cache.
+  void purgeNegativeCache(MonotonicTime now);
 
   Event::Dispatcher& dispatcher_;
-  Event::TimerPtr timer_;
-  ares_channel channel_;
-  std::unordered_map<int, Event::FileEventPtr> events_;
+  const std::chrono::milliseconds negative_cache_ttl_;
+  std::vector<ChannelPtr> channels_;
+  uint32_t next_channel_{};
+  // The resolutions in flight, which the identical resolutions wait on.
+  absl::flat_hash_map<QueryKey, PendingResolution*> pending_resolutions_;
+  // When the failed resolutions can be retried.
+  absl::flat_hash_map<QueryKey, MonotonicTime> negative_cache_;
+  // The failures in the order they were cached, which is the order they expire in as the TTL is
+  // fixed. A failure cached again appears more than once, only its last entry is current.
+  std::deque<std::pair<MonotonicTime, QueryKey>> negative_cache_expirations_;
 };
 
 } // namespace Network
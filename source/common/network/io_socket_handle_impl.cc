@@ -209,50 +209,16 @@ absl::optional<uint32_t> maybeGetPacketsDroppedFromHeader(
   return absl::nullopt;
 }
 
-Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
-                                                    const uint64_t num_slice, uint32_t self_port,
-                                                    RecvMsgOutput& output) {
-
-  // The minimum cmsg buffer size to filled in destination address and packets dropped when
-  // receiving a packet. It is possible for a received packet to contain both IPv4 and IPv6
-  // addresses.
-  const size_t cmsg_space = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
-                            CMSG_SPACE(sizeof(struct in6_pktinfo));
-  STACK_ARRAY(cbuf, char, cmsg_space);
-  memset(cbuf.begin(), 0, cmsg_space);
-
-  STACK_ARRAY(iov, iovec, num_slice);
-  uint64_t num_slices_for_read = 0;
-  for (uint64_t i = 0; i < num_slice; i++) {
-    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
-      iov[num_slices_for_read].iov_base = slices[i].mem_;
-      iov[num_slices_for_read].iov_len = slices[i].len_;
-      ++num_slices_for_read;
-    }
-  }
-
-  sockaddr_storage peer_addr;
-  msghdr hdr;
-  hdr.msg_name = &peer_addr;
-  hdr.msg_namelen = sizeof(sockaddr_storage);
-  hdr.msg_iov = iov.begin();
-  hdr.msg_iovlen = num_slices_for_read;
-  hdr.msg_flags = 0;
-
-  auto cmsg = reinterpret_cast<struct cmsghdr*>(cbuf.begin());
-  cmsg->cmsg_len = cmsg_space;
-  hdr.msg_control = cmsg;
-  hdr.msg_controllen = cmsg_space;
-  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
-  const Api::SysCallSizeResult result = os_sys_calls.recvmsg(fd_, &hdr, 0);
-  if (result.rc_ < 0) {
-    return sysCallResultToIoCallResult(result);
-  }
-
+// Extracts the peer address, the destination address and the dropped packets count of a message
+// received with recvmsg() or recvmmsg().
+void getAddressesAndPacketsDroppedFromHeader(const msghdr& hdr, int fd, uint32_t self_port,
+                                             Address::InstanceConstSharedPtr& local_address,
+                                             Address::InstanceConstSharedPtr& peer_address,
+                                             uint32_t* dropped_packets) {
   RELEASE_ASSERT((hdr.msg_flags & MSG_CTRUNC) == 0,
                  fmt::format("Incorrectly set control message length: {}", hdr.msg_controllen));
   RELEASE_ASSERT(hdr.msg_namelen > 0,
-                 fmt::format("Unable to get remote address from recvmsg() for fd: {}", fd_));
+                 fmt::format("Unable to get remote address from recvmsg() for fd: {}", fd));
   try {
     // Set v6only to false so that mapped-v6 address can be normalize to v4
     // address. Though dual stack may be disabled, it's still okay to assume the
@@ -262,38 +228,136 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
     // address and the socket is actually v6 only, the returned address will be
     // regarded as a v6 address from dual stack socket. However, this address is not going to be
     // used to create socket. Wrong knowledge of dual stack support won't hurt.
-    output.peer_address_ =
-        Address::addressFromSockAddr(peer_addr, hdr.msg_namelen, /*v6only=*/false);
+    peer_address =
+        Address::addressFromSockAddr(*reinterpret_cast<const sockaddr_storage*>(hdr.msg_name),
+                                     hdr.msg_namelen, /*v6only=*/false);
   } catch (const EnvoyException& e) {
-    PANIC(fmt::format("Invalid remote address for fd: {}, error: {}", fd_, e.what()));
+    PANIC(fmt::format("Invalid remote address for fd: {}, error: {}", fd, e.what()));
   }
 
   // Get overflow, local and peer addresses from control message.
   if (hdr.msg_controllen > 0) {
     struct cmsghdr* cmsg;
-    for (cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
-      if (output.local_address_ == nullptr) {
+    for (cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
+      if (local_address == nullptr) {
         try {
           Address::InstanceConstSharedPtr addr = maybeGetDstAddressFromHeader(*cmsg, self_port);
           if (addr != nullptr) {
             // This is a IP packet info message.
-            output.local_address_ = std::move(addr);
+            local_address = std::move(addr);
             continue;
           }
         } catch (const EnvoyException& e) {
-          PANIC(fmt::format("Invalid destination address for fd: {}, error: {}", fd_, e.what()));
+          PANIC(fmt::format("Invalid destination address for fd: {}, error: {}", fd, e.what()));
         }
       }
-      if (output.dropped_packets_ != nullptr) {
+      if (dropped_packets != nullptr) {
         absl::optional<uint32_t> maybe_dropped = maybeGetPacketsDroppedFromHeader(*cmsg);
         if (maybe_dropped) {
-          *output.dropped_packets_ = *maybe_dropped;
+          *dropped_packets = *maybe_dropped;
         }
       }
     }
   }
+}
+
+// The minimum cmsg buffer size to filled in destination address and packets dropped when
+// receiving a packet. It is possible for a received packet to contain both IPv4 and IPv6
+// addresses.
+constexpr size_t RecvMsgCmsgSpace = CMSG_SPACE(sizeof(int)) +
+                                    CMSG_SPACE(sizeof(struct in_pktinfo)) +
+                                    CMSG_SPACE(sizeof(struct in6_pktinfo));
+
+Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
+                                                    const uint64_t num_slice, uint32_t self_port,
+                                                    RecvMsgOutput& output) {
+  STACK_ARRAY(cbuf, char, RecvMsgCmsgSpace);
+  memset(cbuf.begin(), 0, RecvMsgCmsgSpace);
+
+  STACK_ARRAY(iov, iovec, num_slice);
+  uint64_t num_slices_for_read = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      iov[num_slices_for_read].iov_base = slices[i].mem_;
+      iov[num_slices_for_read].iov_len = slices[i].len_;
+      ++num_slices_for_read;
+    }
+  }
+
+  sockaddr_storage peer_addr;
+  msghdr hdr;
+  hdr.msg_name = &peer_addr;
+  hdr.msg_namelen = sizeof(sockaddr_storage);
+  hdr.msg_iov = iov.begin();
+  hdr.msg_iovlen = num_slices_for_read;
+  hdr.msg_flags = 0;
+
+  auto cmsg = reinterpret_cast<struct cmsghdr*>(cbuf.begin());
+  cmsg->cmsg_len = RecvMsgCmsgSpace;
+  hdr.msg_control = cmsg;
+  hdr.msg_controllen = RecvMsgCmsgSpace;
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallSizeResult result = os_sys_calls.recvmsg(fd_, &hdr, 0);
+  if (result.rc_ < 0) {
+    return sysCallResultToIoCallResult(result);
+  }
+
+  getAddressesAndPacketsDroppedFromHeader(hdr, fd_, self_port, output.local_address_,
+                                          output.peer_address_, output.dropped_packets_);
   return sysCallResultToIoCallResult(result);
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::recvmmsg(Buffer::RawSlice* slices,
+                                                     uint64_t num_packets, uint32_t self_port,
+                                                     RecvMmsgOutput& output) {
+  ASSERT(output.msg_.size() >= num_packets);
+  STACK_ARRAY(mmsg_hdr, mmsghdr, num_packets);
+  STACK_ARRAY(iov, iovec, num_packets);
+  STACK_ARRAY(peer_addrs, sockaddr_storage, num_packets);
+  // Every message gets its own control buffer. RecvMsgCmsgSpace is a multiple of the cmsghdr
+  // alignment, so each of them is suitably aligned.
+  STACK_ARRAY(cbufs, char, RecvMsgCmsgSpace * num_packets);
+  memset(cbufs.begin(), 0, RecvMsgCmsgSpace * num_packets);
+
+  for (uint64_t i = 0; i < num_packets; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+
+    msghdr& hdr = mmsg_hdr[i].msg_hdr;
+    hdr.msg_name = &peer_addrs[i];
+    hdr.msg_namelen = sizeof(sockaddr_storage);
+    hdr.msg_iov = &iov[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_flags = 0;
+    auto cmsg = reinterpret_cast<struct cmsghdr*>(cbufs.begin() + i * RecvMsgCmsgSpace);
+    cmsg->cmsg_len = RecvMsgCmsgSpace;
+    hdr.msg_control = cmsg;
+    hdr.msg_controllen = RecvMsgCmsgSpace;
+    mmsg_hdr[i].msg_len = 0;
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult result =
+      os_sys_calls.recvmmsg(fd_, mmsg_hdr.begin(), num_packets, 0, nullptr);
+  if (result.rc_ <= 0) {
+    return sysCallResultToIoCallResult(SysCallSizeResult{result.rc_, result.errno_});
+  }
+
+  for (int i = 0; i < result.rc_; i++) {
+    RecvMsgPerPacketInfo& info = output.msg_[i];
+    info.local_address_ = nullptr;
+    getAddressesAndPacketsDroppedFromHeader(mmsg_hdr[i].msg_hdr, fd_, self_port,
+                                            info.local_address_, info.peer_address_,
+                                            output.dropped_packets_);
+    info.msg_len_ = mmsg_hdr[i].msg_len;
+  }
+  return sysCallResultToIoCallResult(SysCallSizeResult{result.rc_, result.errno_});
+}
+
+bool IoSocketHandleImpl::supportsMmsg() const {
+  return Api::OsSysCallsSingleton::get().supportsMmsg();
+}
+
 } // namespace Network
 } // namespace Envoy
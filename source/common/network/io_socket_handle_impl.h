@@ -39,6 +39,11 @@ public:
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override;
 
+  Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                   uint32_t self_port, RecvMmsgOutput& output) override;
+
+  bool supportsMmsg() const override;
+
 private:
   // Converts a SysCallSizeResult to IoCallUint64Result.
   Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallSizeResult& result);
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <climits>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -104,13 +106,11 @@ public:
     for (const auto& pair_data : data) {
       for (const auto& cidr_range : pair_data.second) {
         if (cidr_range.ip()->version() == Address::IpVersion::v4) {
-          IpPrefix<Ipv4> ip_prefix(ntohl(cidr_range.ip()->ipv4()->address()), cidr_range.length(),
-                                   pair_data.first);
-          ipv4_temp.insert(ip_prefix);
+          ipv4_temp.insert(ntohl(cidr_range.ip()->ipv4()->address()), cidr_range.length(),
+                           pair_data.first);
         } else {
-          IpPrefix<Ipv6> ip_prefix(Utility::Ip6ntohl(cidr_range.ip()->ipv6()->address()),
-                                   cidr_range.length(), pair_data.first);
-          ipv6_temp.insert(ip_prefix);
+          ipv6_temp.insert(Utility::Ip6ntohl(cidr_range.ip()->ipv6()->address()),
+                           cidr_range.length(), pair_data.first);
         }
       }
     }
@@ -134,9 +134,25 @@ public:
     // This trie yields the same match results as the original trie from
     // step 1. But it has a useful new property: now that all the prefixes
     // are at the leaves, they are disjoint: no prefix is nested under another.
-
-    std::vector<IpPrefix<Ipv4>> ipv4_prefixes = ipv4_temp.push_leaves();
-    std::vector<IpPrefix<Ipv6>> ipv6_prefixes = ipv6_temp.push_leaves();
+    //
+    // The leaves only keep the index of their data in data_sets_, where each distinct set of data
+    // is stored once: large tables map many prefixes to few sets of data, such as the tags of
+    // the country or network of a range, and the leaf push copies the data of the wide ranges to
+    // many leaves.
+
+    std::map<std::vector<T>, uint32_t> data_set_indices;
+    const auto intern = [this, &data_set_indices](const DataSet& data) -> uint32_t {
+      std::vector<T> sorted(data.begin(), data.end());
+      std::sort(sorted.begin(), sorted.end());
+      const auto result = data_set_indices.emplace(std::move(sorted),
+                                                  static_cast<uint32_t>(data_sets_.size()));
+      if (result.second) {
+        data_sets_.push_back(result.first->first);
+      }
+      return result.first->second;
+    };
+    std::vector<IpPrefix<Ipv4>> ipv4_prefixes = ipv4_temp.push_leaves(intern);
+    std::vector<IpPrefix<Ipv6>> ipv6_prefixes = ipv6_temp.push_leaves(intern);
 
     // Step 3: take the disjoint prefixes from the leaves of each Binary Trie
     // and use them to construct an LC Trie.
@@ -168,8 +184,10 @@ public:
     //
     // The Nilsson and Karlsson paper linked in lc_trie.h has a more thorough example.
 
-    ipv4_trie_.reset(new LcTrieInternal<Ipv4>(ipv4_prefixes, fill_factor, root_branching_factor));
-    ipv6_trie_.reset(new LcTrieInternal<Ipv6>(ipv6_prefixes, fill_factor, root_branching_factor));
+    ipv4_trie_.reset(
+        new LcTrieInternal<Ipv4>(std::move(ipv4_prefixes), fill_factor, root_branching_factor));
+    ipv6_trie_.reset(
+        new LcTrieInternal<Ipv6>(std::move(ipv6_prefixes), fill_factor, root_branching_factor));
   }
 
   /**
@@ -178,15 +196,16 @@ public:
    * @param  ip_address supplies the IP address.
    * @return a vector of data from the CIDR ranges and IP addresses that contains 'ip_address'. An
    * empty vector is returned if no prefix contains 'ip_address' or there is no data for the IP
-   * version of the ip_address.
+   * version of the ip_address. The vector is owned by the trie and lives as long as it does.
    */
-  std::vector<T> getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
+  const std::vector<T>&
+  getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
     if (ip_address->ip()->version() == Address::IpVersion::v4) {
       Ipv4 ip = ntohl(ip_address->ip()->ipv4()->address());
-      return ipv4_trie_->getData(ip);
+      return data_sets_[ipv4_trie_->getData(ip)];
     } else {
       Ipv6 ip = Utility::Ip6ntohl(ip_address->ip()->ipv6()->address());
-      return ipv6_trie_->getData(ip);
+      return data_sets_[ipv6_trie_->getData(ip)];
     }
   }
 
@@ -234,18 +253,14 @@ private:
   using DataSetSharedPtr = std::shared_ptr<DataSet>;
 
   /**
-   * Structure to hold a CIDR range and the data associated with it.
+   * Structure to hold a CIDR range and the index of the data associated with it.
    */
   template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)> struct IpPrefix {
 
     IpPrefix() = default;
 
-    IpPrefix(const IpType& ip, uint32_t length, const T& data) : ip_(ip), length_(length) {
-      data_.insert(data);
-    }
-
-    IpPrefix(const IpType& ip, int length, const DataSet& data)
-        : ip_(ip), length_(length), data_(data) {}
+    IpPrefix(const IpType& ip, uint32_t length, uint32_t data_index)
+        : ip_(ip), length_(length), data_index_(data_index) {}
 
     /**
      * @return -1 if the current object is less than other. 0 if they are the same. 1
@@ -293,8 +308,8 @@ private:
     IpType ip_{0};
     // Length of the cidr range.
     uint32_t length_{0};
-    // Data for this entry.
-    DataSet data_;
+    // Index of the data for this entry in LcTrie::data_sets_.
+    uint32_t data_index_{0};
   };
 
   /**
@@ -317,10 +332,10 @@ private:
      * Add a CIDR prefix and associated data to the binary trie. If an entry already
      * exists for the prefix, merge the data into the existing entry.
      */
-    void insert(const IpPrefix<IpType>& prefix) {
+    void insert(const IpType& ip, uint32_t length, const T& data) {
       Node* node = root_.get();
-      for (uint32_t i = 0; i < prefix.length_; i++) {
-        auto bit = static_cast<uint32_t>(extractBits(i, 1, prefix.ip_));
+      for (uint32_t i = 0; i < length; i++) {
+        auto bit = static_cast<uint32_t>(extractBits(i, 1, ip));
         NodePtr& next_node = node->children[bit];
         if (next_node == nullptr) {
           next_node = std::make_unique<Node>();
@@ -330,7 +345,7 @@ private:
       if (node->data == nullptr) {
         node->data = std::make_shared<DataSet>();
       }
-      node->data->insert(prefix.data_.begin(), prefix.data_.end());
+      node->data->insert(data);
     }
 
     /**
@@ -341,10 +356,16 @@ private:
      *     new property applies: no prefix in that set is nested under any
      *     other prefix in the set (since, by definition, no leaf of the
      *     trie can be nested under another leaf)
+     * @param intern supplies a function returning the index of a set of data in
+     *        LcTrie::data_sets_.
      * @return the prefixes associated with the leaf nodes.
      */
-    std::vector<IpPrefix<IpType>> push_leaves() {
+    std::vector<IpPrefix<IpType>>
+    push_leaves(const std::function<uint32_t(const DataSet&)>& intern) {
       std::vector<IpPrefix<IpType>> prefixes;
+      // The leaves that only inherit data share the set of their ancestor, which is then interned
+      // once rather than once per leaf. The sets are no longer modified once a leaf is reached.
+      std::unordered_map<const DataSet*, uint32_t> data_indices;
       std::function<void(Node*, DataSetSharedPtr, unsigned, IpType)> visit =
           [&](Node* node, DataSetSharedPtr data, unsigned depth, IpType prefix) {
             // Inherit any data set by ancestor nodes.
@@ -379,7 +400,11 @@ private:
                 if (depth != 0) {
                   ip <<= (address_size - depth);
                 }
-                prefixes.emplace_back(IpPrefix<IpType>(ip, depth, *node->data));
+                auto it = data_indices.find(node->data.get());
+                if (it == data_indices.end()) {
+                  it = data_indices.emplace(node->data.get(), intern(*node->data)).first;
+                }
+                prefixes.emplace_back(IpPrefix<IpType>(ip, depth, it->second));
               }
             }
           };
@@ -414,35 +439,36 @@ private:
   public:
     /**
      * Construct a LC-Trie for IpType.
-     * @param data supplies a vector of data and CIDR ranges (in IpPrefix format).
+     * @param data supplies a vector of CIDR ranges and the indices of their data (in IpPrefix
+     *             format).
      * @param fill_factor supplies the fraction of completeness to use when calculating the branch
      *                    value for a sub-trie.
      * @param root_branching_factor supplies the branching factor at the root. The paper suggests
      *                              for large LC-Tries to use the value '16' for the root
      *                              branching factor. It reduces the depth of the trie.
      */
-    LcTrieInternal(std::vector<IpPrefix<IpType>>& data, double fill_factor,
+    LcTrieInternal(std::vector<IpPrefix<IpType>> data, double fill_factor,
                    uint32_t root_branching_factor);
 
     /**
      * Retrieve the data associated with the CIDR range that contains `ip_address`.
      * @param  ip_address supplies the IP address in host byte order.
-     * @return a vector of data from the CIDR ranges and IP addresses that encompasses the input.
-     * An empty vector is returned if the LC Trie is empty.
+     * @return the index in LcTrie::data_sets_ of the data of the CIDR range that encompasses the
+     * input. The index of the empty set, 0, is returned if no range contains the input.
      */
-    std::vector<T> getData(const IpType& ip_address) const;
+    uint32_t getData(const IpType& ip_address) const;
 
   private:
     /**
      * Builds the Level Compressed Trie, by first sorting the data, removing duplicated
      * prefixes and invoking buildRecursive() to build the trie.
      */
-    void build(std::vector<IpPrefix<IpType>>& data) {
+    void build(std::vector<IpPrefix<IpType>> data) {
       if (data.empty()) {
         return;
       }
 
-      ip_prefixes_ = data;
+      ip_prefixes_ = std::move(data);
       std::sort(ip_prefixes_.begin(), ip_prefixes_.end());
 
       // Build the trie_.
@@ -692,26 +718,27 @@ private:
     const uint32_t root_branching_factor_;
   };
 
+  // Distinct sets of data, referenced by index from the prefixes of both tries. The first is the
+  // empty set returned when no prefix matches.
+  std::vector<std::vector<T>> data_sets_{std::vector<T>()};
   std::unique_ptr<LcTrieInternal<Ipv4>> ipv4_trie_;
   std::unique_ptr<LcTrieInternal<Ipv6>> ipv6_trie_;
 };
 
 template <class T>
 template <class IpType, uint32_t address_size>
-LcTrie<T>::LcTrieInternal<IpType, address_size>::LcTrieInternal(std::vector<IpPrefix<IpType>>& data,
+LcTrie<T>::LcTrieInternal<IpType, address_size>::LcTrieInternal(std::vector<IpPrefix<IpType>> data,
                                                                 double fill_factor,
                                                                 uint32_t root_branching_factor)
     : fill_factor_(fill_factor), root_branching_factor_(root_branching_factor) {
-  build(data);
+  build(std::move(data));
 }
 
 template <class T>
 template <class IpType, uint32_t address_size>
-std::vector<T>
-LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_address) const {
-  std::vector<T> return_vector;
+uint32_t LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_address) const {
   if (trie_.empty()) {
-    return return_vector;
+    return 0;
   }
 
   LcNode node = trie_[0];
@@ -734,10 +761,7 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_addres
   // so it is necessary to check whether the matched prefix really contains the
   // ip_address.
   const auto& prefix = ip_prefixes_[address];
-  if (prefix.contains(ip_address)) {
-    return std::vector<T>(prefix.data_.begin(), prefix.data_.end());
-  }
-  return std::vector<T>();
+  return prefix.contains(ip_address) ? prefix.data_index_ : 0;
 }
 
 } // namespace LcTrie
@@ -1,12 +1,26 @@
 #include "common/network/raw_buffer_socket.h"
 
+#include <algorithm>
+
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/http/headers.h"
+#include "common/runtime/runtime_impl.h"
 
 namespace Envoy {
 namespace Network {
 
+constexpr uint64_t RawBufferSocket::DefaultReadSize;
+constexpr uint64_t RawBufferSocket::MinReadSize;
+constexpr uint64_t RawBufferSocket::MaxReadSize;
+
+RawBufferSocket::RawBufferSocket()
+    : stop_on_partial_write_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.stop_on_partial_write")),
+      adaptive_read_size_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.adaptive_read_size")) {}
+
 void RawBufferSocket::setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) {
   ASSERT(!callbacks_);
   callbacks_ = &callbacks;
@@ -16,9 +30,10 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
   bool end_stream = false;
+  uint32_t num_reads = 0;
   do {
-    // 16K read is arbitrary. TODO(mattklein123) PERF: Tune the read size.
-    Api::IoCallUint64Result result = buffer.read(callbacks_->ioHandle(), 16384);
+    Api::IoCallUint64Result result = buffer.read(callbacks_->ioHandle(), read_size_);
+    num_reads++;
 
     if (result.ok()) {
       ENVOY_CONN_LOG(trace, "read returns: {}", callbacks_->connection(), result.rc_);
@@ -29,9 +44,13 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
       }
       bytes_read += result.rc_;
       if (callbacks_->shouldDrainReadBuffer()) {
+        // The read buffer is over its limit, so there is no point in reading more at once.
         callbacks_->setReadBufferReady();
         break;
       }
+      if (adaptive_read_size_) {
+        updateReadSize(result.rc_);
+      }
     } else {
       // Remote error (might be no data).
       ENVOY_CONN_LOG(trace, "read error: {}", callbacks_->connection(),
@@ -43,9 +62,29 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
     }
   } while (true);
 
+  callbacks_->recordReadsPerEvent(num_reads);
   return {action, bytes_read, end_stream};
 }
 
+void RawBufferSocket::updateReadSize(uint64_t bytes_read) {
+  if (bytes_read >= read_size_) {
+    // The read filled the whole reservation, so more data is likely pending. Grow right away to
+    // cut the number of reads for bulk transfers.
+    read_size_ = std::min(read_size_ * 2, MaxReadSize);
+    small_reads_ = 0;
+  } else if (bytes_read <= read_size_ / 2) {
+    // Shrink only after consecutive small reads so that the short read at the end of a burst does
+    // not undo the growth. Smaller reads keep less memory reserved in the read buffer of mostly
+    // idle connections.
+    if (++small_reads_ >= 2) {
+      read_size_ = std::max(read_size_ / 2, MinReadSize);
+      small_reads_ = 0;
+    }
+  } else {
+    small_reads_ = 0;
+  }
+}
+
 IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   PostIoAction action;
   uint64_t bytes_written = 0;
@@ -61,11 +100,18 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
       action = PostIoAction::KeepOpen;
       break;
     }
+    const uint64_t write_length = stop_on_partial_write_ ? nextWriteLength(buffer) : 0;
     Api::IoCallUint64Result result = buffer.write(callbacks_->ioHandle());
 
     if (result.ok()) {
       ENVOY_CONN_LOG(trace, "write returns: {}", callbacks_->connection(), result.rc_);
       bytes_written += result.rc_;
+      if (result.rc_ < write_length) {
+        // The socket send buffer is full, so the next write would fail with EAGAIN. Skip that
+        // system call and wait for the next write event instead.
+        action = PostIoAction::KeepOpen;
+        break;
+      }
     } else {
       ENVOY_CONN_LOG(trace, "write error: {}", callbacks_->connection(),
                      result.err_->getErrorDetails());
@@ -81,6 +127,18 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   return {action, bytes_written, false};
 }
 
+uint64_t RawBufferSocket::nextWriteLength(const Buffer::Instance& buffer) {
+  // As in OwnedImpl::move(), this assumes that all buffers are OwnedImpl buffers.
+  constexpr uint64_t MaxSlices = Buffer::OwnedImpl::MaxSlicesPerWrite;
+  Buffer::RawSlice slices[MaxSlices];
+  const uint64_t num_slices = std::min(buffer.getRawSlices(slices, MaxSlices), MaxSlices);
+  uint64_t length = 0;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    length += slices[i].len_;
+  }
+  return length;
+}
+
 std::string RawBufferSocket::protocol() const { return EMPTY_STRING; }
 absl::string_view RawBufferSocket::failureReason() const { return EMPTY_STRING; }
 
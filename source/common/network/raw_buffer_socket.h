@@ -11,6 +11,14 @@ namespace Network {
 
 class RawBufferSocket : public TransportSocket, protected Logger::Loggable<Logger::Id::connection> {
 public:
+  // Size of reads from the socket, which is adapted between MinReadSize and MaxReadSize when the
+  // envoy.reloadable_features.adaptive_read_size runtime feature is enabled.
+  static constexpr uint64_t DefaultReadSize = 16384;
+  static constexpr uint64_t MinReadSize = 4096;
+  static constexpr uint64_t MaxReadSize = 65536;
+
+  RawBufferSocket();
+
   // Network::TransportSocket
   void setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) override;
   std::string protocol() const override;
@@ -23,8 +31,18 @@ public:
   Ssl::ConnectionInfoConstSharedPtr ssl() const override { return nullptr; }
 
 private:
+  // @return the number of bytes the next Buffer::Instance::write() hands to the socket.
+  static uint64_t nextWriteLength(const Buffer::Instance& buffer);
+  // Adapt read_size_ to the number of bytes returned by the last read.
+  void updateReadSize(uint64_t bytes_read);
+
   TransportSocketCallbacks* callbacks_{};
   bool shutdown_{};
+  const bool stop_on_partial_write_;
+  const bool adaptive_read_size_;
+  uint64_t read_size_{DefaultReadSize};
+  // Number of consecutive reads that returned at most half of read_size_.
+  uint32_t small_reads_{};
 };
 
 class RawBufferSocketFactory : public TransportSocketFactory {
@@ -0,0 +1,300 @@
+#include "common/network/reuse_port_socket_option_impl.h"
+
+#include <vector>
+
+#include "envoy/config/core/v3alpha/base.pb.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#endif
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+#include <linux/bpf.h>
+#include <sched.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Network {
+
+ReusePortSteeringSocketOptionImpl::ReusePortSteeringSocketOptionImpl(std::string program)
+    : optname_(ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF), program_(std::move(program)) {}
+
+bool ReusePortSteeringSocketOptionImpl::setOption(
+    Socket& socket, envoy::config::core::v3alpha::SocketOption::SocketState state) const {
+  // The socket only joins its SO_REUSEPORT group once bound.
+  if (state != envoy::config::core::v3alpha::SocketOption::STATE_BOUND) {
+    return true;
+  }
+  if (!isSupported()) {
+    ENVOY_LOG(warn, "Failed to set unsupported SO_REUSEPORT steering option on socket");
+    return false;
+  }
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+  struct sock_fprog fprog;
+  fprog.len = static_cast<unsigned short>(program_.size() / sizeof(struct sock_filter));
+  fprog.filter = reinterpret_cast<struct sock_filter*>(const_cast<char*>(program_.data()));
+  const Api::SysCallIntResult result =
+      SocketOptionImpl::setSocketOption(socket, optname_, &fprog, sizeof(fprog));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "Setting {} option on socket failed: {}", optname_.name(),
+              strerror(result.errno_));
+    return false;
+  }
+  return true;
+#else
+  UNREFERENCED_PARAMETER(socket);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+absl::optional<Socket::Option::Details> ReusePortSteeringSocketOptionImpl::getOptionDetails(
+    const Socket&, envoy::config::core::v3alpha::SocketOption::SocketState state) const {
+  if (state != envoy::config::core::v3alpha::SocketOption::STATE_BOUND || !isSupported()) {
+    return absl::nullopt;
+  }
+
+  Socket::Option::Details info;
+  info.name_ = optname_;
+  info.value_ = program_;
+  return absl::make_optional(std::move(info));
+}
+
+bool ReusePortSteeringSocketOptionImpl::isSupported() const { return optname_.has_value(); }
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+namespace {
+
+struct bpf_insn instruction(uint8_t code, uint8_t dst_reg, uint8_t src_reg, int16_t off,
+                            int32_t imm) {
+  struct bpf_insn insn;
+  insn.code = code;
+  insn.dst_reg = dst_reg;
+  insn.src_reg = src_reg;
+  insn.off = off;
+  insn.imm = imm;
+  return insn;
+}
+
+// Selects the socket in slot (current CPU % num_sockets) of the map. The result of
+// bpf_sk_select_reuseport() is ignored and SK_PASS returned either way, so that an empty slot
+// falls back to the kernel's hash.
+std::vector<struct bpf_insn> program(uint32_t num_sockets, int map_fd) {
+  return {
+      // r6 = ctx
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+      // r0 = bpf_get_smp_processor_id()
+      instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_get_smp_processor_id),
+      // w0 %= num_sockets
+      instruction(BPF_ALU | BPF_MOD | BPF_K, BPF_REG_0, 0, 0, static_cast<int32_t>(num_sockets)),
+      // *(u32 *)(r10 - 4) = w0
+      instruction(BPF_STX | BPF_MEM | BPF_W, BPF_REG_10, BPF_REG_0, -4, 0),
+      // r1 = ctx
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0),
+      // r2 = map, a 16 byte instruction
+      instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_2, BPF_PSEUDO_MAP_FD, 0, map_fd),
+      instruction(0, 0, 0, 0, 0),
+      // r3 = r10 - 4
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0),
+      instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -4),
+      // r4 = 0
+      instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, 0),
+      // bpf_sk_select_reuseport(ctx, map, &key, 0)
+      instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_sk_select_reuseport),
+      // return SK_PASS
+      instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, SK_PASS),
+      instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+  };
+}
+
+// The CPU the calling thread is pinned to, if it may only run on one.
+absl::optional<uint32_t> pinnedCpu() {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (Api::LinuxOsSysCallsSingleton::get().sched_getaffinity(0, sizeof(mask), &mask).rc_ != 0 ||
+      CPU_COUNT(&mask) != 1) {
+    return absl::nullopt;
+  }
+  for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &mask)) {
+      return cpu;
+    }
+  }
+  return absl::nullopt;
+}
+
+} // namespace
+#endif
+
+ReusePortCpuSteeringSocketOptionImpl::ReusePortCpuSteeringSocketOptionImpl(uint32_t num_sockets)
+    : optname_(ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF), num_sockets_(num_sockets) {
+  ASSERT(num_sockets_ > 0);
+}
+
+ReusePortCpuSteeringSocketOptionImpl::~ReusePortCpuSteeringSocketOptionImpl() {
+  absl::MutexLock lock(&lock_);
+  // The group holds its own reference to the program, and the program to the map.
+  if (prog_fd_ >= 0) {
+    Api::OsSysCallsSingleton::get().close(prog_fd_);
+  }
+  if (map_fd_ >= 0) {
+    Api::OsSysCallsSingleton::get().close(map_fd_);
+  }
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::setOption(
+    Socket& socket, envoy::config::core::v3alpha::SocketOption::SocketState state) const {
+  // The socket joins its SO_REUSEPORT group once bound, but the kernel only accepts it in the map
+  // once it receives: when listening for TCP, when bound for UDP.
+  const envoy::config::core::v3alpha::SocketOption::SocketState receiving_state =
+      socket.socketType() == Address::SocketType::Stream
+          ? envoy::config::core::v3alpha::SocketOption::STATE_LISTENING
+          : envoy::config::core::v3alpha::SocketOption::STATE_BOUND;
+  if (state != envoy::config::core::v3alpha::SocketOption::STATE_BOUND &&
+      state != receiving_state) {
+    return true;
+  }
+  if (!isSupported()) {
+    ENVOY_LOG(warn, "Failed to set unsupported SO_REUSEPORT steering option on socket");
+    return false;
+  }
+
+  if (state == envoy::config::core::v3alpha::SocketOption::STATE_BOUND && !attach(socket)) {
+    return false;
+  }
+  return state != receiving_state || addSocket(socket);
+}
+
+absl::optional<Socket::Option::Details> ReusePortCpuSteeringSocketOptionImpl::getOptionDetails(
+    const Socket&, envoy::config::core::v3alpha::SocketOption::SocketState state) const {
+  if (state != envoy::config::core::v3alpha::SocketOption::STATE_BOUND || !isSupported()) {
+    return absl::nullopt;
+  }
+
+  Socket::Option::Details info;
+  info.name_ = optname_;
+  info.value_ = std::string(reinterpret_cast<const char*>(&num_sockets_), sizeof(num_sockets_));
+  return absl::make_optional(std::move(info));
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::isSupported() const { return optname_.has_value(); }
+
+void ReusePortCpuSteeringSocketOptionImpl::stop() {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+  absl::MutexLock lock(&lock_);
+  if (map_fd_ < 0) {
+    return;
+  }
+  for (uint32_t slot = 0; slot < num_sockets_; slot++) {
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = map_fd_;
+    attr.key = reinterpret_cast<uint64_t>(&slot);
+    // Slots of sockets that were closed are already empty.
+    Api::LinuxOsSysCallsSingleton::get().bpf(BPF_MAP_DELETE_ELEM, &attr, sizeof(attr));
+  }
+#endif
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::attach(Socket& socket) const {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+  int prog_fd;
+  {
+    absl::MutexLock lock(&lock_);
+    if (prog_fd_ < 0 && !load()) {
+      return false;
+    }
+    prog_fd = prog_fd_;
+  }
+  // Attaching replaces the program of the whole group, also for sockets bound earlier.
+  const Api::SysCallIntResult result =
+      SocketOptionImpl::setSocketOption(socket, optname_, &prog_fd, sizeof(prog_fd));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "Setting {} option on socket failed: {}", optname_.name(),
+              strerror(result.errno_));
+    return false;
+  }
+  return true;
+#else
+  UNREFERENCED_PARAMETER(socket);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::load() const {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+  auto& linux_os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  union bpf_attr attr;
+  if (map_fd_ < 0) {
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_REUSEPORT_SOCKARRAY;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint64_t);
+    attr.max_entries = num_sockets_;
+    const Api::SysCallIntResult result =
+        linux_os_syscalls.bpf(BPF_MAP_CREATE, &attr, sizeof(attr));
+    if (result.rc_ < 0) {
+      ENVOY_LOG(warn, "Creating SO_REUSEPORT steering map failed: {}", strerror(result.errno_));
+      return false;
+    }
+    map_fd_ = result.rc_;
+  }
+
+  const std::vector<struct bpf_insn> instructions = program(num_sockets_, map_fd_);
+  // None of the helpers the program calls is GPL only.
+  static const char license[] = "Apache-2.0";
+  memset(&attr, 0, sizeof(attr));
+  attr.prog_type = BPF_PROG_TYPE_SK_REUSEPORT;
+  attr.insns = reinterpret_cast<uint64_t>(instructions.data());
+  attr.insn_cnt = instructions.size();
+  attr.license = reinterpret_cast<uint64_t>(license);
+  const Api::SysCallIntResult result = linux_os_syscalls.bpf(BPF_PROG_LOAD, &attr, sizeof(attr));
+  if (result.rc_ < 0) {
+    ENVOY_LOG(warn, "Loading SO_REUSEPORT steering program failed: {}", strerror(result.errno_));
+    return false;
+  }
+  prog_fd_ = result.rc_;
+  return true;
+#else
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::addSocket(Socket& socket) const {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+  const absl::optional<uint32_t> cpu = pinnedCpu();
+  absl::MutexLock lock(&lock_);
+  ASSERT(map_fd_ >= 0);
+  // Sockets replacing those of an earlier worker, as on an in place listener update, take over
+  // the slots in the same way.
+  const uint32_t slot = (cpu.has_value() ? cpu.value() : next_slot_++) % num_sockets_;
+  const uint64_t fd = socket.ioHandle().fd();
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = map_fd_;
+  attr.key = reinterpret_cast<uint64_t>(&slot);
+  attr.value = reinterpret_cast<uint64_t>(&fd);
+  attr.flags = BPF_ANY;
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().bpf(BPF_MAP_UPDATE_ELEM, &attr, sizeof(attr));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "Adding socket to SO_REUSEPORT steering slot {} failed: {}", slot,
+              strerror(result.errno_));
+    return false;
+  }
+  ENVOY_LOG(debug, "Added socket to SO_REUSEPORT steering slot {}", slot);
+  return true;
+#else
+  UNREFERENCED_PARAMETER(socket);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3alpha/base.pb.h"
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/logger.h"
+#include "common/network/socket_option_impl.h"
+
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#define ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF                                                      \
+  ENVOY_MAKE_SOCKET_OPTION_NAME(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF)
+#else
+#define ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF Network::SocketOptionName()
+#endif
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+#define ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF                                                      \
+  ENVOY_MAKE_SOCKET_OPTION_NAME(SOL_SOCKET, SO_ATTACH_REUSEPORT_EBPF)
+#else
+#define ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF Network::SocketOptionName()
+#endif
+
+/**
+ * Attaches a classic BPF program to the SO_REUSEPORT group of a bound socket. The program returns
+ * the index in the group of the socket to receive the connection or datagram, and indexes past the
+ * end of the group fall back to the kernel's hash of the addresses. The program belongs to the
+ * group rather than to the socket, so it keeps steering while individual sockets join or leave the
+ * group.
+ */
+class ReusePortSteeringSocketOptionImpl : public Socket::Option,
+                                          Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param program supplies the instructions of the program, as struct sock_filter entries.
+   */
+  explicit ReusePortSteeringSocketOptionImpl(std::string program);
+
+  // Socket::Option
+  bool setOption(Socket& socket,
+                 envoy::config::core::v3alpha::SocketOption::SocketState state) const override;
+  // The steering program does not require a hash key.
+  void hashKey(std::vector<uint8_t>&) const override {}
+  absl::optional<Details>
+  getOptionDetails(const Socket& socket,
+                   envoy::config::core::v3alpha::SocketOption::SocketState state) const override;
+
+  bool isSupported() const;
+
+private:
+  const SocketOptionName optname_;
+  const std::string program_;
+};
+
+/**
+ * Steers each new connection or datagram of a SO_REUSEPORT group to the socket in slot
+ * (receiving CPU % num_sockets) of a BPF_MAP_TYPE_REUSEPORT_SOCKARRAY map, with an eBPF program
+ * attached to the group. A socket takes its slot explicitly once it starts receiving: a socket set
+ * up on a thread pinned to a single CPU takes the slot of that CPU, any other socket takes the next
+ * slot in turn. Sockets of other listeners or processes in the same group, such as a hot restart
+ * parent, are never picked, and while the slot of a CPU is empty the kernel falls back to its hash
+ * of the addresses. Loading the program requires CAP_BPF or CAP_SYS_ADMIN.
+ */
+class ReusePortCpuSteeringSocketOptionImpl : public Socket::Option,
+                                             Logger::Loggable<Logger::Id::connection> {
+public:
+  explicit ReusePortCpuSteeringSocketOptionImpl(uint32_t num_sockets);
+  ~ReusePortCpuSteeringSocketOptionImpl() override;
+
+  // Socket::Option
+  bool setOption(Socket& socket,
+                 envoy::config::core::v3alpha::SocketOption::SocketState state) const override;
+  // The steering program does not require a hash key.
+  void hashKey(std::vector<uint8_t>&) const override {}
+  absl::optional<Details>
+  getOptionDetails(const Socket& socket,
+                   envoy::config::core::v3alpha::SocketOption::SocketState state) const override;
+
+  bool isSupported() const;
+
+  /**
+   * Empties every slot, so that new connections and datagrams fall back to the kernel's hash
+   * until sockets take their slots again. Called once the listener owning the sockets drains.
+   */
+  void stop();
+
+private:
+  bool attach(Socket& socket) const;
+  bool addSocket(Socket& socket) const;
+  bool load() const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const SocketOptionName optname_;
+  const uint32_t num_sockets_;
+  // Options are const once built, but the map and program are only loaded when the first socket
+  // is bound, which may happen on any worker thread.
+  mutable absl::Mutex lock_;
+  mutable int map_fd_ GUARDED_BY(lock_){-1};
+  mutable int prog_fd_ GUARDED_BY(lock_){-1};
+  mutable uint32_t next_slot_ GUARDED_BY(lock_){};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "common/network/udp_listener_impl.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <csetjmp>
 #include <cstring>
@@ -17,6 +18,7 @@
 #include "common/event/dispatcher_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "event2/listener.h"
 
@@ -27,9 +29,29 @@
 namespace Envoy {
 namespace Network {
 
+constexpr uint32_t UdpListenerImpl::DefaultMaxPacketsPerRecv;
+constexpr uint32_t UdpListenerImpl::MaxPacketsPerRecv;
+
+namespace {
+// The runtime key overriding the number of packets read with a single recvmmsg() call.
+const char MaxPacketsPerRecvRuntimeKey[] = "udp_listener.max_packets_per_recv";
+
+uint32_t maxPacketsPerRecvFromRuntime() {
+  uint64_t max_packets_per_recv = UdpListenerImpl::DefaultMaxPacketsPerRecv;
+  Runtime::Loader* loader = Runtime::LoaderSingleton::getExisting();
+  if (loader != nullptr) {
+    max_packets_per_recv =
+        loader->threadsafeSnapshot()->getInteger(MaxPacketsPerRecvRuntimeKey, max_packets_per_recv);
+  }
+  return static_cast<uint32_t>(std::max<uint64_t>(
+      1, std::min<uint64_t>(UdpListenerImpl::MaxPacketsPerRecv, max_packets_per_recv)));
+}
+} // namespace
+
 UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, SocketSharedPtr socket,
                                  UdpListenerCallbacks& cb, TimeSource& time_source)
-    : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb), time_source_(time_source) {
+    : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb), time_source_(time_source),
+      max_packets_per_recv_(maxPacketsPerRecvFromRuntime()) {
   file_event_ = dispatcher_.createFileEvent(
       socket_->ioHandle().fd(), [this](uint32_t events) -> void { onSocketEvent(events); },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
@@ -71,7 +93,8 @@ void UdpListenerImpl::handleReadCallback() {
   ENVOY_UDP_LOG(trace, "handleReadCallback");
   cb_.onReadReady();
   const Api::IoErrorPtr result = Utility::readPacketsFromSocket(
-      socket_->ioHandle(), *socket_->localAddress(), *this, time_source_, packets_dropped_);
+      socket_->ioHandle(), *socket_->localAddress(), *this, time_source_, packets_dropped_,
+      &recv_buffer_);
   // TODO(mattklein123): Handle no error when we limit the number of packets read.
   if (result->getErrorCode() != Api::IoError::IoErrorCode::Again) {
     // TODO(mattklein123): When rate limited logging is implemented log this at error level
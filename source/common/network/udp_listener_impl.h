@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <vector>
 
 #include "envoy/common/time.h"
 
@@ -44,6 +45,14 @@ public:
     // TODO(danzh) make this variable configurable to support jumbo frames.
     return MAX_UDP_PACKET_SIZE;
   }
+  uint32_t maxPacketsPerRecv() const override { return max_packets_per_recv_; }
+  void onPacketsRead(uint64_t num_packets) override { cb_.onPacketsRead(num_packets); }
+
+  // Default number of packets read with a single recvmmsg() call, which can be overridden with
+  // the udp_listener.max_packets_per_recv runtime key up to MaxPacketsPerRecv. 1 disables
+  // batching.
+  static constexpr uint32_t DefaultMaxPacketsPerRecv = 16;
+  static constexpr uint32_t MaxPacketsPerRecv = 64;
 
 protected:
   void handleWriteCallback();
@@ -57,6 +66,9 @@ private:
 
   TimeSource& time_source_;
   Event::FileEventPtr file_event_;
+  const uint32_t max_packets_per_recv_;
+  // The staging area the batches of packets are received into, reused across read events.
+  std::vector<uint8_t> recv_buffer_;
 };
 
 } // namespace Network
@@ -566,10 +566,37 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
   return result;
 }
 
+namespace {
+
+void logPacketsDropped(uint32_t old_packets_dropped, uint32_t packets_dropped) {
+  if (packets_dropped != old_packets_dropped) {
+    // The kernel tracks SO_RXQ_OVFL as a uint32 which can overflow to a smaller
+    // value. So as long as this count differs from previously recorded value,
+    // more packets are dropped by kernel.
+    const uint32_t delta =
+        (packets_dropped > old_packets_dropped)
+            ? (packets_dropped - old_packets_dropped)
+            : (packets_dropped + (std::numeric_limits<uint32_t>::max() - old_packets_dropped) +
+               1);
+    // TODO(danzh) add stats for this.
+    ENVOY_LOG_MISC(debug, "Kernel dropped {} more packets. Consider increase receive buffer size.",
+                   delta);
+  }
+}
+
+} // namespace
+
 Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
                                                const Address::Instance& local_address,
                                                UdpPacketProcessor& udp_packet_processor,
-                                               TimeSource& time_source, uint32_t& packets_dropped) {
+                                               TimeSource& time_source, uint32_t& packets_dropped,
+                                               std::vector<uint8_t>* recv_buffer) {
+  const uint32_t max_packets_per_recv = udp_packet_processor.maxPacketsPerRecv();
+  if (max_packets_per_recv > 1 && handle.supportsMmsg()) {
+    return readPacketBatchesFromSocket(handle, local_address, udp_packet_processor, time_source,
+                                       packets_dropped, max_packets_per_recv, recv_buffer);
+  }
+
   do {
     const uint32_t old_packets_dropped = packets_dropped;
     const MonotonicTime receive_time = time_source.monotonicTime();
@@ -580,6 +607,7 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
       // No more to read or encountered a system error.
       return std::move(result.err_);
     }
+    udp_packet_processor.onPacketsRead(1);
 
     if (result.rc_ == 0) {
       // TODO(conqerAtapple): Is zero length packet interesting? If so add stats
@@ -587,18 +615,73 @@ Api::IoErrorPtr Utility::readPacketsFromSocket(IoHandle& handle,
       ENVOY_LOG_MISC(trace, "received 0-length packet");
     }
 
-    if (packets_dropped != old_packets_dropped) {
-      // The kernel tracks SO_RXQ_OVFL as a uint32 which can overflow to a smaller
-      // value. So as long as this count differs from previously recorded value,
-      // more packets are dropped by kernel.
-      const uint32_t delta =
-          (packets_dropped > old_packets_dropped)
-              ? (packets_dropped - old_packets_dropped)
-              : (packets_dropped + (std::numeric_limits<uint32_t>::max() - old_packets_dropped) +
-                 1);
-      // TODO(danzh) add stats for this.
-      ENVOY_LOG_MISC(
-          debug, "Kernel dropped {} more packets. Consider increase receive buffer size.", delta);
+    logPacketsDropped(old_packets_dropped, packets_dropped);
+  } while (true);
+}
+
+Api::IoErrorPtr Utility::readPacketBatchesFromSocket(IoHandle& handle,
+                                                     const Address::Instance& local_address,
+                                                     UdpPacketProcessor& udp_packet_processor,
+                                                     TimeSource& time_source,
+                                                     uint32_t& packets_dropped,
+                                                     uint32_t num_packets,
+                                                     std::vector<uint8_t>* recv_buffer) {
+  // Packets are received into a single staging area and copied into right-sized buffers, which is
+  // cheaper than allocating a full size buffer for every packet that could be received. The
+  // staging area of the caller is only allocated on its first read.
+  const uint64_t max_packet_size = udp_packet_processor.maxPacketSize();
+  std::vector<uint8_t> local_buffer;
+  std::vector<uint8_t>& storage = recv_buffer != nullptr ? *recv_buffer : local_buffer;
+  storage.resize(max_packet_size * num_packets);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_packets);
+  for (uint32_t i = 0; i < num_packets; i++) {
+    slices[i].mem_ = storage.data() + i * max_packet_size;
+    slices[i].len_ = max_packet_size;
+  }
+  IoHandle::RecvMmsgOutput output(num_packets, &packets_dropped);
+
+  do {
+    const uint32_t old_packets_dropped = packets_dropped;
+    const MonotonicTime receive_time = time_source.monotonicTime();
+    Api::IoCallUint64Result result =
+        handle.recvmmsg(slices.begin(), num_packets, local_address.ip()->port(), output);
+
+    if (!result.ok()) {
+      // No more to read or encountered a system error.
+      return std::move(result.err_);
+    }
+
+    ENVOY_LOG_MISC(trace, "recvmmsg read {} packets", result.rc_);
+    udp_packet_processor.onPacketsRead(result.rc_);
+    for (uint64_t i = 0; i < result.rc_; i++) {
+      IoHandle::RecvMsgPerPacketInfo& info = output.msg_[i];
+      RELEASE_ASSERT(info.peer_address_ != nullptr,
+                     fmt::format("Unable to get remote address for fd: {}, local address: {} ",
+                                 handle.fd(), local_address.asString()));
+      // Unix domain sockets are not supported
+      RELEASE_ASSERT(info.peer_address_->type() == Address::Type::Ip,
+                     fmt::format("Unsupported remote address: {} local address: {}, receive size: "
+                                 "{}",
+                                 info.peer_address_->asString(), local_address.asString(),
+                                 info.msg_len_));
+      if (info.msg_len_ == 0) {
+        ENVOY_LOG_MISC(trace, "received 0-length packet");
+      }
+
+      Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
+      buffer->add(slices[i].mem_, std::min(info.msg_len_, max_packet_size));
+      udp_packet_processor.processPacket(std::move(info.local_address_),
+                                         std::move(info.peer_address_), std::move(buffer),
+                                         receive_time);
+    }
+
+    logPacketsDropped(old_packets_dropped, packets_dropped);
+
+    if (result.rc_ < num_packets) {
+      // The socket had fewer packets queued than requested, so the next call would fail with
+      // EAGAIN. Skip it, as packets arriving from now on raise another edge triggered read event.
+      return Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                             IoSocketError::deleteIoError);
     }
   } while (true);
 }
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3alpha/address.pb.h"
@@ -55,6 +56,19 @@ public:
    * actually packets received, the payload will be truncated.
    */
   virtual uint64_t maxPacketSize() const PURE;
+
+  /**
+   * @return the maximum number of packets to read with a single recvmmsg() call. If this is 1 or
+   * the socket doesn't support recvmmsg(), packets are read one at a time with recvmsg().
+   */
+  virtual uint32_t maxPacketsPerRecv() const PURE;
+
+  /**
+   * Called after each receive system call that returned packets, before the packets are passed
+   * to processPacket().
+   * @param num_packets is the number of packets returned by the system call.
+   */
+  virtual void onPacketsRead(uint64_t num_packets) PURE;
 };
 
 static const uint64_t MAX_UDP_PACKET_SIZE = 1500;
@@ -328,6 +342,11 @@ public:
    * @param udp_packet_processor is the callback to receive the packets.
    * @param time_source is the time source used to generate the time stamp of the received packets.
    * @param packets_dropped is the output parameter for number of packets dropped in kernel.
+   * @param recv_buffer if not null, the staging area batches of packets are received into, kept by
+   *        the caller so that it is not allocated again on every read event.
+   *
+   * Packets are read in batches with recvmmsg() if udp_packet_processor allows more than one
+   * packet per read and the socket supports it.
    *
    * TODO(mattklein123): Allow the number of packets read to be limited for fairness. Currently
    *                     this function will always return an error, even if EAGAIN. In the future
@@ -339,11 +358,21 @@ public:
   static Api::IoErrorPtr readPacketsFromSocket(IoHandle& handle,
                                                const Address::Instance& local_address,
                                                UdpPacketProcessor& udp_packet_processor,
-                                               TimeSource& time_source, uint32_t& packets_dropped);
+                                               TimeSource& time_source, uint32_t& packets_dropped,
+                                               std::vector<uint8_t>* recv_buffer = nullptr);
 
 private:
   static void throwWithMalformedIp(absl::string_view ip_address);
 
+  // Reads packets in batches of num_packets with recvmmsg(). @see readPacketsFromSocket().
+  static Api::IoErrorPtr readPacketBatchesFromSocket(IoHandle& handle,
+                                                     const Address::Instance& local_address,
+                                                     UdpPacketProcessor& udp_packet_processor,
+                                                     TimeSource& time_source,
+                                                     uint32_t& packets_dropped,
+                                                     uint32_t num_packets,
+                                                     std::vector<uint8_t>* recv_buffer);
+
   /**
    * Takes a number and flips the order in byte chunks. The last byte of the input will be the
    * first byte in the output. The second to last byte will be the second to first byte in the
@@ -0,0 +1,428 @@
+#include "common/profiler/cpu_sampler.h"
+
+#ifdef __linux__
+
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "envoy/common/time.h"
+
+#include "common/common/macros.h"
+#include "common/profiler/profiler.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/debugging/stacktrace.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+// The deepest stack recorded, and the number of samples recorded before sampling stops. Later
+// samples are dropped. The buffer of the samples, about 8MiB, is only allocated while sampling.
+constexpr uint32_t MaxFrames = 30;
+constexpr uint32_t MaxSamples = 1 << 15;
+
+struct Sample {
+  int64_t thread_id;
+  int64_t depth;
+  void* frames[MaxFrames];
+};
+
+// The buffer recorded into by the signal handler, or null when not sampling.
+std::atomic<Sample*> sample_buffer{nullptr};
+std::atomic<uint32_t> next_sample{0};
+// The number of signal handlers running, which may still write into the buffer.
+std::atomic<uint32_t> handlers_running{0};
+
+// Owned by the thread starting and stopping the sampler.
+std::unique_ptr<Sample[]> samples;
+uint32_t sampling_frequency_hz;
+SystemTime sampling_start;
+
+// Returns the address of the instruction interrupted by the signal, or null if unknown.
+void* interruptedAddress(void* ucontext) {
+#if defined(__x86_64__)
+  return reinterpret_cast<void*>(static_cast<ucontext_t*>(ucontext)->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return reinterpret_cast<void*>(static_cast<ucontext_t*>(ucontext)->uc_mcontext.pc);
+#else
+  UNREFERENCED_PARAMETER(ucontext);
+  return nullptr;
+#endif
+}
+
+void onProfSignal(int, siginfo_t*, void* ucontext) {
+  const int saved_errno = errno;
+  handlers_running++;
+  Sample* buffer = sample_buffer.load();
+  if (buffer != nullptr) {
+    const uint32_t index = next_sample++;
+    if (index < MaxSamples) {
+      Sample& sample = buffer[index];
+      sample.thread_id = syscall(SYS_gettid);
+      // Unwinding from the handler reaches the callers of the interrupted function through the
+      // signal frame, skipped, but not the interrupted function itself, read from the context.
+      sample.depth = 0;
+      void* interrupted = interruptedAddress(ucontext);
+      if (interrupted != nullptr) {
+        sample.frames[sample.depth++] = interrupted;
+      }
+      sample.depth += absl::GetStackTraceWithContext(
+          sample.frames + sample.depth, MaxFrames - sample.depth, 1, ucontext, nullptr);
+    }
+  }
+  handlers_running--;
+  errno = saved_errno;
+}
+
+// Field numbers of the messages of profile.proto, the format of pprof.
+constexpr uint32_t ProfileSampleType = 1;
+constexpr uint32_t ProfileSample = 2;
+constexpr uint32_t ProfileMapping = 3;
+constexpr uint32_t ProfileLocation = 4;
+constexpr uint32_t ProfileStringTable = 6;
+constexpr uint32_t ProfileTimeNanos = 9;
+constexpr uint32_t ProfileDurationNanos = 10;
+constexpr uint32_t ProfilePeriodType = 11;
+constexpr uint32_t ProfilePeriod = 12;
+constexpr uint32_t ValueTypeType = 1;
+constexpr uint32_t ValueTypeUnit = 2;
+constexpr uint32_t SampleLocationId = 1;
+constexpr uint32_t SampleValue = 2;
+constexpr uint32_t SampleLabel = 3;
+constexpr uint32_t LabelKey = 1;
+constexpr uint32_t LabelStr = 2;
+constexpr uint32_t LabelNum = 3;
+constexpr uint32_t MappingId = 1;
+constexpr uint32_t MappingMemoryStart = 2;
+constexpr uint32_t MappingMemoryLimit = 3;
+constexpr uint32_t MappingFileOffset = 4;
+constexpr uint32_t MappingFilename = 5;
+constexpr uint32_t LocationId = 1;
+constexpr uint32_t LocationMappingId = 2;
+constexpr uint32_t LocationAddress = 3;
+
+/**
+ * Writes the fields of a message in the protobuf wire format.
+ */
+class ProtoWriter {
+public:
+  void uint64Field(uint32_t field, uint64_t value) {
+    varint(tag(field, WireTypeVarint));
+    varint(value);
+  }
+
+  void bytesField(uint32_t field, absl::string_view value) {
+    varint(tag(field, WireTypeLengthDelimited));
+    varint(value.size());
+    output_.append(value.data(), value.size());
+  }
+
+  void packedField(uint32_t field, const std::vector<uint64_t>& values) {
+    ProtoWriter packed;
+    for (const uint64_t value : values) {
+      packed.varint(value);
+    }
+    bytesField(field, packed.output());
+  }
+
+  void messageField(uint32_t field, const ProtoWriter& message) {
+    bytesField(field, message.output());
+  }
+
+  const std::string& output() const { return output_; }
+
+private:
+  static constexpr uint32_t WireTypeVarint = 0;
+  static constexpr uint32_t WireTypeLengthDelimited = 2;
+
+  static uint64_t tag(uint32_t field, uint32_t wire_type) {
+    return (static_cast<uint64_t>(field) << 3) | wire_type;
+  }
+
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      output_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    output_.push_back(static_cast<char>(value));
+  }
+
+  std::string output_;
+};
+
+/**
+ * The strings of a profile, referenced by their index in the string table.
+ */
+class StringTable {
+public:
+  // The first string of the table must be empty.
+  StringTable() { index(""); }
+
+  uint64_t index(const std::string& value) {
+    const auto it = indexes_.emplace(value, strings_.size());
+    if (it.second) {
+      strings_.push_back(value);
+    }
+    return it.first->second;
+  }
+
+  const std::vector<std::string>& strings() const { return strings_; }
+
+private:
+  absl::flat_hash_map<std::string, uint64_t> indexes_;
+  std::vector<std::string> strings_;
+};
+
+struct Mapping {
+  uint64_t start_;
+  uint64_t limit_;
+  uint64_t file_offset_;
+  std::string filename_;
+};
+
+// Reads the executable mappings of the process, in address order.
+std::vector<Mapping> readExecutableMappings() {
+  std::vector<Mapping> mappings;
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  while (std::getline(maps, line)) {
+    // Lines are: start-limit permissions offset device inode [filename]
+    Mapping mapping;
+    char permissions[5];
+    int filename_start = 0;
+    if (sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64 " %4s %" SCNx64 " %*s %*s %n", &mapping.start_,
+               &mapping.limit_, permissions, &mapping.file_offset_, &filename_start) < 4 ||
+        permissions[2] != 'x') {
+      continue;
+    }
+    if (filename_start > 0) {
+      mapping.filename_ = line.substr(filename_start);
+    }
+    mappings.push_back(mapping);
+  }
+  return mappings;
+}
+
+// Returns the id of the mapping containing the address, or 0 if none does.
+uint64_t mappingId(const std::vector<Mapping>& mappings, uint64_t address) {
+  const auto it = std::upper_bound(
+      mappings.begin(), mappings.end(), address,
+      [](uint64_t value, const Mapping& mapping) { return value < mapping.start_; });
+  if (it == mappings.begin() || address >= std::prev(it)->limit_) {
+    return 0;
+  }
+  return std::prev(it) - mappings.begin() + 1;
+}
+
+std::string threadName(int64_t thread_id) {
+  std::ifstream comm(absl::StrCat("/proc/self/task/", thread_id, "/comm"));
+  std::string name;
+  std::getline(comm, name);
+  return name;
+}
+
+ProtoWriter valueType(StringTable& strings, const std::string& type, const std::string& unit) {
+  ProtoWriter value_type;
+  value_type.uint64Field(ValueTypeType, strings.index(type));
+  value_type.uint64Field(ValueTypeUnit, strings.index(unit));
+  return value_type;
+}
+
+ProtoWriter label(StringTable& strings, const std::string& key) {
+  ProtoWriter key_label;
+  key_label.uint64Field(LabelKey, strings.index(key));
+  return key_label;
+}
+
+// Aggregates the samples by thread and stack, into a serialized pprof Profile message.
+std::string buildProfile(const Sample* buffer, uint32_t num_samples, uint32_t frequency_hz,
+                         SystemTime start, SystemTime end) {
+  // The stacks are keyed by the id of their thread followed by their frames, leaf first.
+  absl::flat_hash_map<std::vector<uint64_t>, uint64_t> stack_counts;
+  for (uint32_t i = 0; i < num_samples; i++) {
+    const Sample& sample = buffer[i];
+    std::vector<uint64_t> stack;
+    stack.reserve(sample.depth + 1);
+    stack.push_back(sample.thread_id);
+    for (int64_t j = 0; j < sample.depth; j++) {
+      stack.push_back(reinterpret_cast<uint64_t>(sample.frames[j]));
+    }
+    stack_counts[stack]++;
+  }
+
+  const uint64_t period_ns = 1000000000 / frequency_hz;
+  const std::vector<Mapping> mappings = readExecutableMappings();
+  StringTable strings;
+  ProtoWriter profile;
+  profile.messageField(ProfileSampleType, valueType(strings, "samples", "count"));
+  profile.messageField(ProfileSampleType, valueType(strings, "cpu", "nanoseconds"));
+
+  absl::flat_hash_map<uint64_t, uint64_t> location_ids;
+  std::vector<uint64_t> location_addresses;
+  absl::flat_hash_map<int64_t, std::string> thread_names;
+  for (const auto& stack_count : stack_counts) {
+    const std::vector<uint64_t>& stack = stack_count.first;
+    std::vector<uint64_t> stack_location_ids;
+    stack_location_ids.reserve(stack.size() - 1);
+    for (size_t i = 1; i < stack.size(); i++) {
+      // The frames above the leaf are return addresses, which pprof expects to be adjusted into
+      // the call instructions.
+      const uint64_t address = i == 1 ? stack[i] : stack[i] - 1;
+      const auto it = location_ids.emplace(address, location_addresses.size() + 1);
+      if (it.second) {
+        location_addresses.push_back(address);
+      }
+      stack_location_ids.push_back(it.first->second);
+    }
+
+    ProtoWriter sample;
+    sample.packedField(SampleLocationId, stack_location_ids);
+    sample.packedField(SampleValue, {stack_count.second, stack_count.second * period_ns});
+    const int64_t thread_id = stack[0];
+    ProtoWriter thread_id_label = label(strings, "thread_id");
+    thread_id_label.uint64Field(LabelNum, thread_id);
+    sample.messageField(SampleLabel, thread_id_label);
+    auto thread_name = thread_names.find(thread_id);
+    if (thread_name == thread_names.end()) {
+      thread_name = thread_names.emplace(thread_id, threadName(thread_id)).first;
+    }
+    // The threads that exited since they were sampled have no name.
+    if (!thread_name->second.empty()) {
+      ProtoWriter thread_name_label = label(strings, "thread_name");
+      thread_name_label.uint64Field(LabelStr, strings.index(thread_name->second));
+      sample.messageField(SampleLabel, thread_name_label);
+    }
+    profile.messageField(ProfileSample, sample);
+  }
+
+  for (size_t i = 0; i < mappings.size(); i++) {
+    ProtoWriter mapping;
+    mapping.uint64Field(MappingId, i + 1);
+    mapping.uint64Field(MappingMemoryStart, mappings[i].start_);
+    mapping.uint64Field(MappingMemoryLimit, mappings[i].limit_);
+    mapping.uint64Field(MappingFileOffset, mappings[i].file_offset_);
+    mapping.uint64Field(MappingFilename, strings.index(mappings[i].filename_));
+    profile.messageField(ProfileMapping, mapping);
+  }
+
+  for (size_t i = 0; i < location_addresses.size(); i++) {
+    ProtoWriter location;
+    location.uint64Field(LocationId, i + 1);
+    location.uint64Field(LocationMappingId, mappingId(mappings, location_addresses[i]));
+    location.uint64Field(LocationAddress, location_addresses[i]);
+    profile.messageField(ProfileLocation, location);
+  }
+
+  profile.uint64Field(ProfileTimeNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            start.time_since_epoch())
+                                            .count());
+  profile.uint64Field(ProfileDurationNanos,
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  profile.messageField(ProfilePeriodType, valueType(strings, "cpu", "nanoseconds"));
+  profile.uint64Field(ProfilePeriod, period_ns);
+  for (const std::string& value : strings.strings()) {
+    profile.bytesField(ProfileStringTable, value);
+  }
+  return profile.output();
+}
+
+} // namespace
+
+bool CpuSampler::samplerSupported() { return true; }
+
+bool CpuSampler::isSampling() { return samples != nullptr; }
+
+bool CpuSampler::startSampling(uint32_t frequency_hz) {
+  if (isSampling() || frequency_hz == 0 || Cpu::profilerEnabled()) {
+    return false;
+  }
+
+  // Unwinding once outside of the signal handler runs the lazy initialization of the unwinder,
+  // which is not async signal safe.
+  void* frame;
+  absl::GetStackTrace(&frame, 1, 0);
+
+  // The handler stays installed once sampling stops, as a SIGPROF still pending would otherwise
+  // terminate the process.
+  struct sigaction action {};
+  action.sa_sigaction = onProfSignal;
+  action.sa_flags = SA_RESTART | SA_SIGINFO;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, nullptr) != 0) {
+    return false;
+  }
+
+  samples = std::make_unique<Sample[]>(MaxSamples);
+  next_sample = 0;
+  sample_buffer = samples.get();
+  sampling_frequency_hz = frequency_hz;
+  sampling_start = std::chrono::system_clock::now();
+
+  // setitimer() rejects a tv_usec of a second or more, as a frequency of 1 would give.
+  const uint32_t period_us = std::max<uint32_t>(1000000 / frequency_hz, 1);
+  struct itimerval timer {};
+  timer.it_interval.tv_sec = period_us / 1000000;
+  timer.it_interval.tv_usec = period_us % 1000000;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    sample_buffer = nullptr;
+    samples.reset();
+    return false;
+  }
+  return true;
+}
+
+std::string CpuSampler::stopSampling() {
+  if (!isSampling()) {
+    return "";
+  }
+
+  struct itimerval timer {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  const SystemTime sampling_end = std::chrono::system_clock::now();
+  // Wait for the handlers that may still be recording samples, on other threads.
+  sample_buffer = nullptr;
+  while (handlers_running > 0) {
+    std::this_thread::yield();
+  }
+
+  const std::string profile =
+      buildProfile(samples.get(), std::min(next_sample.load(), MaxSamples), sampling_frequency_hz,
+                   sampling_start, sampling_end);
+  samples.reset();
+  return profile;
+}
+
+} // namespace Profiler
+} // namespace Envoy
+
+#else
+
+namespace Envoy {
+namespace Profiler {
+
+bool CpuSampler::samplerSupported() { return false; }
+bool CpuSampler::isSampling() { return false; }
+bool CpuSampler::startSampling(uint32_t) { return false; }
+std::string CpuSampler::stopSampling() { return ""; }
+
+} // namespace Profiler
+} // namespace Envoy
+
+#endif // #ifdef __linux__
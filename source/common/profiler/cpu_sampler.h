@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Process wide sampling CPU profiler, cheap enough to be run on production servers. On each
+ * SIGPROF of an interval timer counting the CPU time of the process, the thread interrupted records
+ * its stack into a preallocated buffer, without locking nor allocating. The samples are aggregated
+ * by thread and stack once sampling stops, and exported in the pprof format.
+ *
+ * The sampler and the gperftools CPU profiler both use SIGPROF, so only one of them can run at a
+ * time. Starting and stopping the sampler must be done from a single thread.
+ */
+class CpuSampler {
+public:
+  /**
+   * @return whether sampling is supported on this platform.
+   */
+  static bool samplerSupported();
+
+  /**
+   * @return whether the sampler is running.
+   */
+  static bool isSampling();
+
+  /**
+   * Start sampling the stacks of the threads of the process.
+   * @param frequency_hz the number of samples per second of CPU time used by the process.
+   * @return bool whether sampling started. It fails if the sampler or the gperftools CPU profiler
+   *         is already running.
+   */
+  static bool startSampling(uint32_t frequency_hz);
+
+  /**
+   * Stop sampling.
+   * @return std::string the samples as a serialized pprof Profile message, with the samples of each
+   *         stack labeled by the id and the name of the thread. The addresses are symbolized by
+   *         pprof from the binaries of the mappings of the profile. Empty if sampling was not
+   *         running.
+   */
+  static std::string stopSampling();
+};
+
+} // namespace Profiler
+} // namespace Envoy
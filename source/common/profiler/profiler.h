@@ -60,6 +60,14 @@ public:
    * @return bool whether the file is dumped
    */
   static bool stopProfiler();
+
+  /**
+   * @return std::string the sample of the allocations currently in use kept by tcmalloc, in the
+   *         heap profile format read by pprof, or an empty string if the build does not support it.
+   *         tcmalloc only samples allocations when the TCMALLOC_SAMPLE_PARAMETER environment
+   *         variable sets the average number of bytes between samples.
+   */
+  static std::string heapSample();
 };
 
 } // namespace Profiler
@@ -9,13 +9,16 @@
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 #include "common/config/api_type_oracle.h"
 #include "common/config/version_converter.h"
 #include "common/protobuf/message_validator_impl.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/well_known.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
+#include "absl/synchronization/mutex.h"
 #include "yaml-cpp/yaml.h"
 
 namespace Envoy {
@@ -361,6 +364,74 @@ void checkForDeprecatedNonRepeatedEnumValue(const Protobuf::Message& message,
   }
 }
 
+// What the check for deprecated fields needs to know about a field, derived from its descriptor
+// once rather than for every message checked.
+struct DeprecationFieldInfo {
+  // Points into the name of the file descriptor, which outlives the field info.
+  absl::string_view filename_;
+  bool deprecated_;
+  bool disallowed_by_default_;
+};
+
+// What the check for deprecated fields needs to know about a message type.
+struct DeprecationMessageInfo {
+  // The info of each field, indexed by the index of the field in the message type.
+  std::vector<DeprecationFieldInfo> fields_;
+  // The singular enum fields of an enum type with deprecated values. These are checked even when
+  // they are not set, as their default value may be deprecated.
+  std::vector<const Protobuf::FieldDescriptor*> deprecated_enum_fields_;
+};
+
+DeprecationMessageInfo buildDeprecationMessageInfo(const Protobuf::Descriptor& descriptor) {
+  DeprecationMessageInfo info;
+  info.fields_.reserve(descriptor.field_count());
+  for (int i = 0; i < descriptor.field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor.field(i);
+    info.fields_.push_back(
+        {filenameFromPath(field->file()->name()), field->options().deprecated(),
+         field->options().GetExtension(envoy::annotations::disallowed_by_default)});
+    if (field->is_repeated() || field->cpp_type() != Protobuf::FieldDescriptor::CPPTYPE_ENUM) {
+      continue;
+    }
+    const Protobuf::EnumDescriptor* enum_descriptor = field->enum_type();
+    for (int j = 0; j < enum_descriptor->value_count(); ++j) {
+      if (enum_descriptor->value(j)->options().deprecated()) {
+        info.deprecated_enum_fields_.push_back(field);
+        break;
+      }
+    }
+  }
+  return info;
+}
+
+// The info of the message types of the generated descriptor pool, whose descriptors live as long
+// as the process. The info of the other message types is built for each check.
+class DeprecationMessageInfoCache {
+public:
+  const DeprecationMessageInfo& get(const Protobuf::Descriptor& descriptor) {
+    {
+      absl::ReaderMutexLock lock(&mutex_);
+      const auto it = infos_.find(&descriptor);
+      if (it != infos_.end()) {
+        return *it->second;
+      }
+    }
+    auto info = std::make_unique<DeprecationMessageInfo>(buildDeprecationMessageInfo(descriptor));
+    absl::MutexLock lock(&mutex_);
+    // Another thread may have added the same info meanwhile, which is then kept.
+    return *infos_.emplace(&descriptor, std::move(info)).first->second;
+  }
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<const Protobuf::Descriptor*, std::unique_ptr<const DeprecationMessageInfo>>
+      infos_ ABSL_GUARDED_BY(mutex_);
+};
+
+DeprecationMessageInfoCache& deprecationMessageInfoCache() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(DeprecationMessageInfoCache);
+}
+
 void checkForUnexpectedFields(const Protobuf::Message& message,
                               ProtobufMessage::ValidationVisitor& validation_visitor,
                               Runtime::Loader* runtime) {
@@ -385,40 +456,49 @@ void checkForUnexpectedFields(const Protobuf::Message& message,
 
   const Protobuf::Descriptor* descriptor = message.GetDescriptor();
   const Protobuf::Reflection* reflection = message.GetReflection();
-  for (int i = 0; i < descriptor->field_count(); ++i) {
-    const Protobuf::FieldDescriptor* field = descriptor->field(i);
-    absl::string_view filename = filenameFromPath(field->file()->name());
+  DeprecationMessageInfo uncached_info;
+  const bool cacheable = descriptor->file()->pool() == Protobuf::DescriptorPool::generated_pool();
+  if (!cacheable) {
+    uncached_info = buildDeprecationMessageInfo(*descriptor);
+  }
+  const DeprecationMessageInfo& info =
+      cacheable ? deprecationMessageInfoCache().get(*descriptor) : uncached_info;
 
-    // Before we check to see if the field is in use, see if there's a
-    // deprecated default enum value.
-    checkForDeprecatedNonRepeatedEnumValue(message, filename, field, reflection, runtime);
+  // Before we check the fields in use, see if there's a deprecated default enum value.
+  for (const Protobuf::FieldDescriptor* field : info.deprecated_enum_fields_) {
+    checkForDeprecatedNonRepeatedEnumValue(message, info.fields_[field->index()].filename_, field,
+                                           reflection, runtime);
+  }
 
-    // If this field is not in use, continue.
-    if ((field->is_repeated() && reflection->FieldSize(message, field) == 0) ||
-        (!field->is_repeated() && !reflection->HasField(message, field))) {
+  // Only the fields in use are checked, which the reflection lists without looking at the others.
+  std::vector<const Protobuf::FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  for (const Protobuf::FieldDescriptor* field : fields) {
+    if (field->is_extension()) {
       continue;
     }
+    const DeprecationFieldInfo& field_info = info.fields_[field->index()];
 
+    // If this field is deprecated, warn or throw an error.
+    if (field_info.deprecated_) {
 #ifdef ENVOY_DISABLE_DEPRECATED_FEATURES
-    bool warn_only = false;
+      bool warn_only = false;
 #else
-    bool warn_only = !field->options().GetExtension(envoy::annotations::disallowed_by_default);
+      bool warn_only = !field_info.disallowed_by_default_;
 #endif
-    // Allow runtime to be null both to not crash if this is called before server initialization,
-    // and so proto validation works in context where runtime singleton is not set up (e.g.
-    // standalone config validation utilities)
-    if (runtime && field->options().deprecated()) {
-      warn_only = runtime->snapshot().deprecatedFeatureEnabled(
-          absl::StrCat("envoy.deprecated_features:", field->full_name()), warn_only);
-    }
+      // Allow runtime to be null both to not crash if this is called before server initialization,
+      // and so proto validation works in context where runtime singleton is not set up (e.g.
+      // standalone config validation utilities)
+      if (runtime) {
+        warn_only = runtime->snapshot().deprecatedFeatureEnabled(
+            absl::StrCat("envoy.deprecated_features:", field->full_name()), warn_only);
+      }
 
-    // If this field is deprecated, warn or throw an error.
-    if (field->options().deprecated()) {
       std::string err = fmt::format(
           "Using deprecated option '{}' from file {}. This configuration will be removed from "
           "Envoy soon. Please see https://www.envoyproxy.io/docs/envoy/latest/intro/deprecated "
           "for details.",
-          field->full_name(), filename);
+          field->full_name(), field_info.filename_);
       if (warn_only) {
         ENVOY_LOG_MISC(warn, "{}", err);
       } else {
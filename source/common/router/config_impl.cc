@@ -33,6 +33,7 @@
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/router/retry_state_impl.h"
+#include "common/runtime/runtime_impl.h"
 #include "common/tracing/http_tracer_impl.h"
 
 #include "extensions/filters/http/well_known_names.h"
@@ -64,10 +65,26 @@ std::string SslRedirector::newPath(const Http::HeaderMap& headers) const {
 HedgePolicyImpl::HedgePolicyImpl(const envoy::config::route::v3alpha::HedgePolicy& hedge_policy)
     : initial_requests_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(hedge_policy, initial_requests, 1)),
       additional_request_chance_(hedge_policy.additional_request_chance()),
-      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {}
+      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {
+  if (hedge_policy.has_latency_hedging()) {
+    latency_hedge_policy_ =
+        std::make_shared<const LatencyHedgePolicyImpl>(hedge_policy.latency_hedging());
+  }
+}
 
 HedgePolicyImpl::HedgePolicyImpl() : initial_requests_(1), hedge_on_per_try_timeout_(false) {}
 
+RequestCollapsingPolicyImpl::RequestCollapsingPolicyImpl(
+    const envoy::config::route::v3alpha::RouteAction::RequestCollapsingPolicy& policy)
+    : per_process_(policy.scope() ==
+                   envoy::config::route::v3alpha::RouteAction::RequestCollapsingPolicy::PROCESS),
+      max_response_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(policy, max_response_bytes, 1024 * 1024)) {
+  for (const std::string& header : policy.headers()) {
+    headers_.emplace_back(header);
+  }
+}
+
 RetryPolicyImpl::RetryPolicyImpl(const envoy::config::route::v3alpha::RetryPolicy& retry_policy,
                                  ProtobufMessage::ValidationVisitor& validation_visitor)
     : retriable_headers_(
@@ -156,19 +173,19 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::config::route::v3alpha::CorsPolicy&
       legacy_enabled_(config.has_hidden_envoy_deprecated_enabled()
                           ? config.hidden_envoy_deprecated_enabled().value()
                           : true) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher> matcher_configs;
   for (const auto& origin : config.hidden_envoy_deprecated_allow_origin()) {
-    envoy::type::matcher::v3alpha::StringMatcher matcher_config;
-    matcher_config.set_exact(origin);
-    allow_origins_.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher_config));
+    matcher_configs.Add()->set_exact(origin);
   }
   for (const auto& regex : config.hidden_envoy_deprecated_allow_origin_regex()) {
-    envoy::type::matcher::v3alpha::StringMatcher matcher_config;
-    matcher_config.set_hidden_envoy_deprecated_regex(regex);
-    allow_origins_.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher_config));
+    matcher_configs.Add()->set_hidden_envoy_deprecated_regex(regex);
   }
-  for (const auto& string_match : config.allow_origin_string_match()) {
-    allow_origins_.push_back(std::make_unique<Matchers::StringMatcherImpl>(string_match));
+  matcher_configs.MergeFrom(config.allow_origin_string_match());
+  for (const auto& matcher_config : matcher_configs) {
+    allow_origins_.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher_config));
+    allow_any_origin_ = allow_any_origin_ || allow_origins_.back()->match("*");
   }
+  allow_origin_list_ = std::make_unique<Matchers::StringMatcherListImpl>(matcher_configs);
   if (config.has_allow_credentials()) {
     allow_credentials_ = PROTOBUF_GET_WRAPPED_REQUIRED(config, allow_credentials);
   }
@@ -354,6 +371,11 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
         std::make_unique<TlsContextMatchCriteriaImpl>(route.match().tls_context());
   }
 
+  if (route.route().has_request_collapsing()) {
+    request_collapsing_policy_ =
+        std::make_unique<RequestCollapsingPolicyImpl>(route.route().request_collapsing());
+  }
+
   // Only set include_vh_rate_limits_ to true if the rate limit policy for the route is empty
   // or the route set `include_vh_rate_limits` to true.
   include_vh_rate_limits_ =
@@ -716,8 +738,69 @@ RouteConstSharedPtr RouteEntryImplBase::clusterEntry(const Http::HeaderMap& head
     }
   }
 
-  return WeightedClusterUtil::pickCluster(weighted_clusters_, total_cluster_weight_, random_value,
-                                          true);
+  return pickWeightedCluster(random_value);
+}
+
+const RouteEntryImplBase::WeightedClusterEntrySharedPtr&
+RouteEntryImplBase::pickWeightedCluster(uint64_t random_value) const {
+  const uint64_t generation = loader_.snapshot().generation();
+  if (generation == 0) {
+    return WeightedClusterUtil::pickCluster(weighted_clusters_, total_cluster_weight_, random_value,
+                                            true);
+  }
+
+  // The cluster picked is the first one whose interval ends after the selected value, the
+  // intervals being [0, cluster1_weight), [cluster1_weight, cluster1_weight+cluster2_weight),...
+  // as in WeightedClusterUtil::pickCluster().
+  const uint64_t selected_value = random_value % total_cluster_weight_;
+  const auto pick = [this, selected_value](const std::vector<uint64_t>& ends) -> const auto& {
+    const auto it = std::upper_bound(ends.begin(), ends.end(), selected_value);
+    if (it == ends.end()) {
+      // The runtime weights add up to less than the total weight.
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
+    return weighted_clusters_[it - ends.begin()];
+  };
+
+  {
+    // The weights replaced by a worker are only destroyed once no read which may have loaded them
+    // is in progress.
+    ThreadLocal::RcuReadScope scope;
+    const ClusterWeights* cached = cluster_weights_.load(std::memory_order_acquire);
+    if (cached != nullptr && cached->generation_ == generation) {
+      return pick(cached->ends_);
+    }
+  }
+
+  auto cluster_weights = std::make_unique<ClusterWeights>();
+  cluster_weights->generation_ = generation;
+  cluster_weights->ends_.reserve(weighted_clusters_.size());
+  uint64_t end = 0;
+  for (const WeightedClusterEntrySharedPtr& cluster : weighted_clusters_) {
+    end += cluster->clusterWeight();
+    cluster_weights->ends_.push_back(end);
+  }
+  const WeightedClusterEntrySharedPtr& cluster = pick(cluster_weights->ends_);
+
+  // The lock is only taken when a worker sees a new runtime generation. The workers pick up a new
+  // snapshot at slightly different times, so that an older one may still be seen after the weights
+  // of a newer one are cached.
+  absl::MutexLock lock(&cluster_weights_mutex_);
+  if (owned_cluster_weights_ == nullptr || generation > owned_cluster_weights_->generation_) {
+    cluster_weights_.store(cluster_weights.get(), std::memory_order_release);
+    if (owned_cluster_weights_ != nullptr) {
+      retired_cluster_weights_.emplace_back(ThreadLocal::RcuEpoch::retire(),
+                                            std::move(owned_cluster_weights_));
+    }
+    owned_cluster_weights_ = std::move(cluster_weights);
+  }
+  // The weights are retired in the order of their epochs.
+  auto it = retired_cluster_weights_.begin();
+  while (it != retired_cluster_weights_.end() && ThreadLocal::RcuEpoch::quiescent(it->first)) {
+    ++it;
+  }
+  retired_cluster_weights_.erase(retired_cluster_weights_.begin(), it);
+  return cluster;
 }
 
 void RouteEntryImplBase::validateClusters(Upstream::ClusterManager& cm) const {
@@ -968,6 +1051,29 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3alpha::VirtualHos
     }
   }
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.indexed_route_matching")) {
+    route_index_ = std::make_unique<RouteIndex>();
+    for (int i = 0; i < virtual_host.routes_size(); i++) {
+      const auto& match = virtual_host.routes(i).match();
+      const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, case_sensitive, true);
+      switch (match.path_specifier_case()) {
+      case envoy::config::route::v3alpha::RouteMatch::PathSpecifierCase::kPrefix:
+        route_index_->addPrefix(match.prefix(), case_sensitive, i);
+        break;
+      case envoy::config::route::v3alpha::RouteMatch::PathSpecifierCase::kPath:
+        route_index_->addPath(match.path(), case_sensitive, i);
+        break;
+      case envoy::config::route::v3alpha::RouteMatch::PathSpecifierCase::kSafeRegex:
+        route_index_->addRegex(match.safe_regex().regex(), i);
+        break;
+      default:
+        route_index_->addAlwaysCandidate(i);
+        break;
+      }
+    }
+    route_index_->compile();
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster, stat_name_pool_));
   }
@@ -1012,28 +1118,6 @@ const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::str
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. foo-bar.baz.com should match *-bar.baz.com before matching *.baz.com for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
-  }
-  return nullptr;
-}
-
 RouteMatcher::RouteMatcher(const envoy::config::route::v3alpha::RouteConfiguration& route_config,
                            const ConfigImpl& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
@@ -1050,13 +1134,11 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3alpha::RouteConfigurati
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_suffixes_.insert(domain.rbegin(),
+                                                                  domain.rend() - 1, virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found =
+            !wildcard_virtual_host_prefixes_.insert(domain.begin(), domain.end() - 1, virtual_host);
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -1088,6 +1170,20 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
   }
 
   // Check for a route that matches the request.
+  if (route_index_ != nullptr) {
+    // All path matchers require a :path header.
+    if (headers.Path() == nullptr) {
+      return nullptr;
+    }
+    RouteConstSharedPtr route_entry;
+    route_index_->forEachCandidate(
+        headers.Path()->value().getStringView(), [&](uint32_t route) -> bool {
+          route_entry = routes_[route]->matches(headers, stream_info, random_value);
+          return route_entry == nullptr;
+        });
+    return route_entry;
+  }
+
   for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
     RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
     if (nullptr != route_entry) {
@@ -1118,20 +1214,20 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& head
   if (iter != virtual_hosts_.end()) {
     return iter->second.get();
   }
+  // We do a longest wildcard match against the host that's passed in (e.g. foo-bar.baz.com
+  // should match *-bar.baz.com before matching *.baz.com for suffix wildcards).
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
+    const VirtualHostSharedPtr* vhost =
+        wildcard_virtual_host_suffixes_.findLongestPrefix(host.rbegin(), host.rend());
     if (vhost != nullptr) {
-      return vhost;
+      return vhost->get();
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
+    const VirtualHostSharedPtr* vhost =
+        wildcard_virtual_host_prefixes_.findLongestPrefix(host.begin(), host.end());
     if (vhost != nullptr) {
-      return vhost;
+      return vhost->get();
     }
   }
   return default_virtual_host_.get();
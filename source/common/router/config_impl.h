@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -19,17 +20,23 @@
 #include "envoy/type/v3alpha/percent.pb.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/matchers.h"
 #include "common/config/metadata.h"
 #include "common/http/hash_policy.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
+#include "common/router/latency_hedge_policy.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/radix_trie.h"
+#include "common/router/route_index.h"
 #include "common/router/router_ratelimit.h"
 #include "common/router/tls_context_match_criteria_impl.h"
 #include "common/stats/symbol_table_impl.h"
+#include "common/thread_local/rcu_slot.h"
 
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -113,6 +120,9 @@ public:
   const std::vector<Matchers::StringMatcherPtr>& allowOrigins() const override {
     return allow_origins_;
   };
+  bool allowsOrigin(absl::string_view origin) const override {
+    return allow_any_origin_ || allow_origin_list_->match(origin);
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -139,6 +149,9 @@ private:
   const envoy::config::route::v3alpha::CorsPolicy config_;
   Runtime::Loader& loader_;
   std::vector<Matchers::StringMatcherPtr> allow_origins_;
+  // The matchers of allow_origins_, compiled together to match origins at once.
+  std::unique_ptr<Matchers::StringMatcherListImpl> allow_origin_list_;
+  bool allow_any_origin_{};
   const std::string allow_methods_;
   const std::string allow_headers_;
   const std::string expose_headers_;
@@ -211,6 +224,8 @@ private:
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName stat_name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Index over the path matchers of routes_, nullptr if indexed route matching is disabled.
+  RouteIndexPtr route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -318,11 +333,34 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  const LatencyHedgePolicy* latencyHedgePolicy() const override {
+    return latency_hedge_policy_.get();
+  }
 
 private:
   const uint32_t initial_requests_;
   const envoy::type::v3alpha::FractionalPercent additional_request_chance_;
   const bool hedge_on_per_try_timeout_;
+  std::shared_ptr<const LatencyHedgePolicyImpl> latency_hedge_policy_;
+};
+
+/**
+ * Implementation of RequestCollapsingPolicy that reads from the proto route config.
+ */
+class RequestCollapsingPolicyImpl : public RequestCollapsingPolicy {
+public:
+  explicit RequestCollapsingPolicyImpl(
+      const envoy::config::route::v3alpha::RouteAction::RequestCollapsingPolicy& policy);
+
+  // Router::RequestCollapsingPolicy
+  const std::vector<Http::LowerCaseString>& headers() const override { return headers_; }
+  bool perProcess() const override { return per_process_; }
+  uint64_t maxResponseBytes() const override { return max_response_bytes_; }
+
+private:
+  std::vector<Http::LowerCaseString> headers_;
+  const bool per_process_;
+  const uint64_t max_response_bytes_;
 };
 
 /**
@@ -420,6 +458,9 @@ public:
   const TlsContextMatchCriteria* tlsContextMatchCriteria() const override {
     return tls_context_match_criteria_.get();
   }
+  const RequestCollapsingPolicy* requestCollapsingPolicy() const override {
+    return request_collapsing_policy_.get();
+  }
   Upstream::ResourcePriority priority() const override { return priority_; }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
   const RetryPolicy& retryPolicy() const override { return retry_policy_; }
@@ -538,6 +579,9 @@ private:
     const TlsContextMatchCriteria* tlsContextMatchCriteria() const override {
       return parent_->tlsContextMatchCriteria();
     }
+    const RequestCollapsingPolicy* requestCollapsingPolicy() const override {
+      return parent_->requestCollapsingPolicy();
+    }
 
     const VirtualCluster* virtualCluster(const Http::HeaderMap& headers) const override {
       return parent_->virtualCluster(headers);
@@ -634,6 +678,17 @@ private:
 
   using WeightedClusterEntrySharedPtr = std::shared_ptr<WeightedClusterEntry>;
 
+  /**
+   * The weights of the weighted clusters in a runtime snapshot, as the end of the interval of each
+   * cluster, in the order of weighted_clusters_.
+   */
+  struct ClusterWeights {
+    uint64_t generation_{};
+    std::vector<uint64_t> ends_;
+  };
+
+  const WeightedClusterEntrySharedPtr& pickWeightedCluster(uint64_t random_value) const;
+
   absl::optional<RuntimeData>
   loadRuntimeData(const envoy::config::route::v3alpha::RouteMatch& route);
 
@@ -692,9 +747,21 @@ private:
 
   UpgradeMap upgrade_map_;
   const uint64_t total_cluster_weight_;
+  // The weights of the weighted clusters in the latest runtime snapshot seen, so that they are only
+  // looked up in the runtime when it changes rather than on each request. The request path loads
+  // the plain pointer in an RCU read, without a lock nor a reference count. The route owns the
+  // weights. Those replaced are retired, and destroyed by a later replacement once no read may
+  // still see them.
+  mutable std::atomic<const ClusterWeights*> cluster_weights_{};
+  mutable absl::Mutex cluster_weights_mutex_;
+  mutable std::unique_ptr<const ClusterWeights>
+      owned_cluster_weights_ ABSL_GUARDED_BY(cluster_weights_mutex_);
+  mutable std::vector<std::pair<uint64_t, std::unique_ptr<const ClusterWeights>>>
+      retired_cluster_weights_ ABSL_GUARDED_BY(cluster_weights_mutex_);
   std::unique_ptr<const Http::HashPolicyImpl> hash_policy_;
   MetadataMatchCriteriaConstPtr metadata_match_criteria_;
   TlsContextMatchCriteriaConstPtr tls_context_match_criteria_;
+  std::unique_ptr<const RequestCollapsingPolicyImpl> request_collapsing_policy_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   uint32_t retry_shadow_buffer_limit_{std::numeric_limits<uint32_t>::max()};
@@ -814,23 +881,12 @@ public:
   const VirtualHostImpl* findVirtualHost(const Http::HeaderMap& headers) const;
 
 private:
-  using WildcardVirtualHosts =
-      std::map<int64_t, std::unordered_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<std::string(const std::string&, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
+  using WildcardVirtualHosts = RadixTrie<VirtualHostSharedPtr>;
 
   std::unordered_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
+  // Suffix wildcards are keyed by the reversed domain without the leading '*' and prefix
+  // wildcards by the domain without the trailing '*', so that the longest wildcard match is found
+  // in a single pass over the host.
   WildcardVirtualHosts wildcard_virtual_host_suffixes_;
   WildcardVirtualHosts wildcard_virtual_host_prefixes_;
 
@@ -25,6 +25,12 @@ public:
    *              headers
    */
   virtual bool append() const PURE;
+
+  /**
+   * @return const std::string* the value formatted for every stream when it does not depend on the
+   *         stream, which lives as long as the formatter, or nullptr if it does.
+   */
+  virtual const std::string* constantValue() const PURE;
 };
 
 using HeaderFormatterPtr = std::unique_ptr<HeaderFormatter>;
@@ -39,6 +45,7 @@ public:
   // HeaderFormatter::format
   const std::string format(const Envoy::StreamInfo::StreamInfo& stream_info) const override;
   bool append() const override { return append_; }
+  const std::string* constantValue() const override { return nullptr; }
 
   using FieldExtractor = std::function<std::string(const Envoy::StreamInfo::StreamInfo&)>;
 
@@ -62,6 +69,7 @@ public:
     return static_value_;
   };
   bool append() const override { return append_; }
+  const std::string* constantValue() const override { return &static_value_; }
 
 private:
   const std::string static_value_;
@@ -85,6 +93,8 @@ public:
     return buf;
   };
   bool append() const override { return append_; }
+  // Only built for values with at least one variable.
+  const std::string* constantValue() const override { return nullptr; }
 
 private:
   const std::vector<HeaderFormatterPtr> formatters_;
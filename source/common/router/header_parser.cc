@@ -264,6 +264,20 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers,
   }
 
   for (const auto& formatter : headers_to_add_) {
+    // Constant values are referenced by the headers, like their keys, rather than formatted and
+    // copied for each stream.
+    const std::string* constant_value = formatter.second->constantValue();
+    if (constant_value != nullptr) {
+      if (!constant_value->empty()) {
+        if (formatter.second->append()) {
+          headers.addReference(formatter.first, *constant_value);
+        } else {
+          headers.setReference(formatter.first, *constant_value);
+        }
+      }
+      continue;
+    }
+
     const std::string value = formatter.second->format(stream_info);
     if (!value.empty()) {
       if (formatter.second->append()) {
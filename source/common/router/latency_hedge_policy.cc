@@ -0,0 +1,135 @@
+#include "common/router/latency_hedge_policy.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+// The latencies, and the requests of the hedge budget, are decayed at twice this window.
+constexpr uint64_t DefaultWindow = 1000;
+
+uint64_t mostSignificantBit(uint64_t value) {
+  uint64_t msb = 0;
+  while (value >>= 1) {
+    msb++;
+  }
+  return msb;
+}
+
+} // namespace
+
+LatencyPercentileEstimator::LatencyPercentileEstimator(double percentile, uint64_t min_samples)
+    : percentile_(percentile), min_samples_(std::max<uint64_t>(min_samples, 1)),
+      window_(std::max(min_samples_, DefaultWindow)) {}
+
+uint64_t LatencyPercentileEstimator::bucketIndex(uint64_t latency_ms) {
+  latency_ms = std::min(latency_ms, kMaxLatencyMs);
+  if (latency_ms < kExactBuckets) {
+    return latency_ms;
+  }
+  const uint64_t msb = mostSignificantBit(latency_ms);
+  const uint64_t sub_bucket = (latency_ms >> (msb - 2)) & (kSubBuckets - 1);
+  return kExactBuckets + (msb - 3) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyPercentileEstimator::bucketUpperBound(uint64_t index) {
+  if (index < kExactBuckets) {
+    return index;
+  }
+  const uint64_t msb = (index - kExactBuckets) / kSubBuckets + 3;
+  const uint64_t sub_bucket = (index - kExactBuckets) % kSubBuckets;
+  const uint64_t lower_bound = (kSubBuckets + sub_bucket) << (msb - 2);
+  return lower_bound + (uint64_t(1) << (msb - 2)) - 1;
+}
+
+void LatencyPercentileEstimator::record(std::chrono::milliseconds latency) {
+  buckets_[bucketIndex(std::max<int64_t>(latency.count(), 0))].fetch_add(
+      1, std::memory_order_relaxed);
+  const uint64_t total = total_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (total >= 2 * window_) {
+    decay();
+  }
+  if (recorded_.fetch_add(1, std::memory_order_relaxed) % kRefreshInterval == 0 &&
+      total >= min_samples_) {
+    refreshPercentile();
+  }
+}
+
+void LatencyPercentileEstimator::decay() {
+  // A single thread decays the buckets; latencies recorded concurrently are kept.
+  if (decaying_.exchange(true, std::memory_order_acquire)) {
+    return;
+  }
+  uint64_t removed = 0;
+  for (auto& bucket : buckets_) {
+    const uint64_t half = bucket.load(std::memory_order_relaxed) / 2;
+    bucket.fetch_sub(half, std::memory_order_relaxed);
+    removed += half;
+  }
+  total_.fetch_sub(removed, std::memory_order_relaxed);
+  decaying_.store(false, std::memory_order_release);
+}
+
+void LatencyPercentileEstimator::refreshPercentile() {
+  uint64_t total = 0;
+  std::array<uint64_t, kNumBuckets> counts;
+  for (uint64_t i = 0; i < kNumBuckets; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return;
+  }
+  const uint64_t rank =
+      std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentile_ * total)), 1);
+  uint64_t seen = 0;
+  for (uint64_t i = 0; i < kNumBuckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      percentile_ms_.store(bucketUpperBound(i), std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+absl::optional<std::chrono::milliseconds> LatencyPercentileEstimator::percentile() const {
+  const int64_t percentile_ms = percentile_ms_.load(std::memory_order_relaxed);
+  if (percentile_ms < 0) {
+    return absl::nullopt;
+  }
+  return std::chrono::milliseconds(percentile_ms);
+}
+
+HedgeBudget::HedgeBudget(double budget_percent, uint64_t window)
+    : budget_percent_(budget_percent), window_(window) {}
+
+void HedgeBudget::onRequest() {
+  const uint64_t requests = requests_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (requests < 2 * window_ || decaying_.exchange(true, std::memory_order_acquire)) {
+    return;
+  }
+  requests_.fetch_sub(requests_.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+  hedges_.fetch_sub(hedges_.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+  decaying_.store(false, std::memory_order_release);
+}
+
+bool HedgeBudget::canHedge() const {
+  const double allowed = requests_.load(std::memory_order_relaxed) * budget_percent_ / 100;
+  return hedges_.load(std::memory_order_relaxed) + 1 <= allowed;
+}
+
+void HedgeBudget::onHedge() { hedges_.fetch_add(1, std::memory_order_relaxed); }
+
+LatencyHedgePolicyImpl::LatencyHedgePolicyImpl(
+    const envoy::config::route::v3alpha::HedgePolicy::LatencyHedging& config)
+    : estimator_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(config, percentile, 95.0) / 100,
+                 PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, min_samples, 100)),
+      budget_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(config, budget, 10.0), DefaultWindow) {}
+
+} // namespace Router
+} // namespace Envoy
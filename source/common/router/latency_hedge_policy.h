@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/config/route/v3alpha/route_components.pb.h"
+#include "envoy/router/router.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Lock free estimator of a percentile of latencies, recorded in log-linear millisecond buckets.
+ * When twice the window of latencies has been recorded, all the buckets are halved so that the
+ * estimate follows the recent latencies. The percentile is recomputed by the recording threads
+ * every few latencies, so that reading it is a single atomic load.
+ */
+class LatencyPercentileEstimator {
+public:
+  LatencyPercentileEstimator(double percentile, uint64_t min_samples);
+
+  /**
+   * Record a latency.
+   * @param latency supplies the latency.
+   */
+  void record(std::chrono::milliseconds latency);
+
+  /**
+   * @return the estimated percentile of the recorded latencies, or nullopt if fewer than
+   *         min_samples latencies have been recorded.
+   */
+  absl::optional<std::chrono::milliseconds> percentile() const;
+
+  // Latencies are recorded exactly up to kExactBuckets ms, then with kSubBuckets buckets per power
+  // of two up to kMaxLatencyMs.
+  static constexpr uint64_t kExactBuckets = 8;
+  static constexpr uint64_t kSubBuckets = 4;
+  static constexpr uint64_t kMaxLatencyMs = (1 << 20) - 1;
+  static constexpr uint64_t kNumBuckets = kExactBuckets + (20 - 3) * kSubBuckets;
+
+  static uint64_t bucketIndex(uint64_t latency_ms);
+  // The highest latency recorded in a bucket, so that the estimate errs towards hedging late.
+  static uint64_t bucketUpperBound(uint64_t index);
+
+private:
+  void decay();
+  void refreshPercentile();
+
+  // The number of latencies recorded between two refreshes of the percentile.
+  static constexpr uint64_t kRefreshInterval = 16;
+
+  const double percentile_;
+  const uint64_t min_samples_;
+  // At least min_samples_ latencies must remain after a decay.
+  const uint64_t window_;
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+  std::atomic<uint64_t> total_{0};
+  std::atomic<uint64_t> recorded_{0};
+  std::atomic<bool> decaying_{false};
+  // -1 until min_samples_ latencies have been recorded.
+  std::atomic<int64_t> percentile_ms_{-1};
+};
+
+/**
+ * Budget of hedged requests, as a percentage of the requests. Like the latencies, the counts are
+ * halved once the window is reached, so that the budget follows the recent requests.
+ */
+class HedgeBudget {
+public:
+  HedgeBudget(double budget_percent, uint64_t window);
+
+  void onRequest();
+  bool canHedge() const;
+  void onHedge();
+
+private:
+  const double budget_percent_;
+  const uint64_t window_;
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> hedges_{0};
+  std::atomic<bool> decaying_{false};
+};
+
+/**
+ * Implementation of LatencyHedgePolicy that reads from the proto route or virtual host config.
+ * The state is shared by the workers and kept in atomics, which is why the const methods of the
+ * interface are backed by mutable members.
+ */
+class LatencyHedgePolicyImpl : public LatencyHedgePolicy {
+public:
+  explicit LatencyHedgePolicyImpl(
+      const envoy::config::route::v3alpha::HedgePolicy::LatencyHedging& config);
+
+  // Router::LatencyHedgePolicy
+  absl::optional<std::chrono::milliseconds> hedgeDelay() const override {
+    return estimator_.percentile();
+  }
+  void recordLatency(std::chrono::milliseconds latency) const override {
+    estimator_.record(latency);
+  }
+  void onRequest() const override { budget_.onRequest(); }
+  bool canHedge() const override { return budget_.canHedge(); }
+  void onHedge() const override { budget_.onHedge(); }
+
+private:
+  mutable LatencyPercentileEstimator estimator_;
+  mutable HedgeBudget budget_;
+};
+
+} // namespace Router
+} // namespace Envoy
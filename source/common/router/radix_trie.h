@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Radix trie of string keys used to find the keys that are prefixes of a string in a single pass
+ * over it. Keys and lookups are given as iterator ranges, so that reverse iterators give a trie of
+ * suffixes, as used for suffix wildcard domains (e.g. *.foo.com), while forward iterators give a
+ * trie of prefixes, as used for prefix wildcard domains and path prefixes.
+ */
+template <class Value> class RadixTrie {
+public:
+  /**
+   * Find the value of a key, inserting a default constructed value if the key is not present.
+   * @param begin supplies the start of the key.
+   * @param end supplies the end of the key.
+   * @return std::pair<Value*, bool> the value of the key, and whether it was inserted.
+   */
+  template <class Iterator> std::pair<Value*, bool> findOrInsert(Iterator begin, Iterator end) {
+    const std::string key(begin, end);
+    absl::string_view remaining = key;
+    Node* node = &root_;
+    while (!remaining.empty()) {
+      auto it = findChild(*node, remaining[0]);
+      if (it == node->children_.end() || (*it)->label_[0] != remaining[0]) {
+        auto child = std::make_unique<Node>();
+        child->label_ = std::string(remaining);
+        Node* inserted = child.get();
+        node->children_.insert(it, std::move(child));
+        node = inserted;
+        break;
+      }
+
+      Node* child = it->get();
+      const absl::string_view label = child->label_;
+      size_t common = 0;
+      while (common < label.size() && common < remaining.size() &&
+             label[common] == remaining[common]) {
+        common++;
+      }
+      if (common < label.size()) {
+        // Split the edge so that the common part gets its own node.
+        auto split = std::make_unique<Node>();
+        split->label_ = std::string(label.substr(0, common));
+        child->label_ = std::string(label.substr(common));
+        split->children_.push_back(std::move(*it));
+        *it = std::move(split);
+        child = it->get();
+      }
+      node = child;
+      remaining.remove_prefix(common);
+    }
+    if (node->value_.has_value()) {
+      return {&node->value_.value(), false};
+    }
+    node->value_.emplace();
+    size_++;
+    return {&node->value_.value(), true};
+  }
+
+  /**
+   * Insert a key.
+   * @param begin supplies the start of the key.
+   * @param end supplies the end of the key.
+   * @param value supplies the value associated with the key.
+   * @return bool false if the key was already present, in which case nothing is inserted.
+   */
+  template <class Iterator> bool insert(Iterator begin, Iterator end, Value value) {
+    const std::pair<Value*, bool> result = findOrInsert(begin, end);
+    if (result.second) {
+      *result.first = std::move(value);
+    }
+    return result.second;
+  }
+
+  /**
+   * Invoke a callback on the value of every key that is a prefix of the given string, from the
+   * shortest key to the longest.
+   * @param begin supplies the start of the string.
+   * @param end supplies the end of the string.
+   * @param fold supplies the function applied to each character of the string before it is
+   *        compared, e.g. to lower case it for a trie of lower case keys.
+   * @param cb supplies the callback, called with the value and the position in the string right
+   *        after the key.
+   */
+  template <class Iterator, class Fold, class Callback>
+  void forEachPrefix(Iterator begin, Iterator end, Fold fold, Callback cb) const {
+    const Node* node = &root_;
+    while (true) {
+      if (node->value_.has_value()) {
+        cb(node->value_.value(), begin);
+      }
+      if (begin == end) {
+        return;
+      }
+      auto it = findChild(*node, fold(*begin));
+      if (it == node->children_.end() || (*it)->label_[0] != fold(*begin)) {
+        return;
+      }
+      for (const char c : (*it)->label_) {
+        if (begin == end || fold(*begin) != c) {
+          return;
+        }
+        ++begin;
+      }
+      node = it->get();
+    }
+  }
+
+  /**
+   * Find the value of the longest key that is a prefix of, and strictly shorter than, the given
+   * string. Keys must be strictly shorter since e.g. *.foo.com must not match .foo.com.
+   * @param begin supplies the start of the string.
+   * @param end supplies the end of the string.
+   * @return const Value* the value of the longest matching key or nullptr if none matches.
+   */
+  template <class Iterator> const Value* findLongestPrefix(Iterator begin, Iterator end) const {
+    const Value* result = nullptr;
+    forEachPrefix(
+        begin, end, [](char c) { return c; },
+        [&result, end](const Value& value, Iterator position) {
+          if (position != end) {
+            result = &value;
+          }
+        });
+    return result;
+  }
+
+  /**
+   * @return bool whether the trie holds no keys.
+   */
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @return size_t the number of keys in the trie.
+   */
+  size_t size() const { return size_; }
+
+private:
+  struct Node {
+    // Label of the edge leading to this node. Only empty for the root.
+    std::string label_;
+    absl::optional<Value> value_;
+    // Sorted by the first character of their label.
+    std::vector<std::unique_ptr<Node>> children_;
+  };
+
+  // Works for both const and non-const nodes, returning the matching kind of iterator.
+  template <class N> static auto findChild(N& node, char c) {
+    return std::lower_bound(
+        node.children_.begin(), node.children_.end(), c,
+        [](const std::unique_ptr<Node>& child, char key) { return child->label_[0] < key; });
+  }
+
+  Node root_;
+  size_t size_{};
+};
+
+} // namespace Router
+} // namespace Envoy
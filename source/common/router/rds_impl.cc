@@ -109,6 +109,13 @@ void RdsRouteConfigSubscription::onConfigUpdate(
     throw EnvoyException(fmt::format("Unexpected RDS configuration (expecting {}): {}",
                                      route_config_name_, route_config.name()));
   }
+  // An unchanged configuration was validated when it was applied, and is ignored by onRdsUpdate()
+  // below, so it is not built again to be validated.
+  if (config_update_info_->configInfo().has_value() &&
+      MessageUtil::hash(route_config) == config_update_info_->configHash()) {
+    init_target_.ready();
+    return;
+  }
   for (auto* provider : route_config_providers_) {
     // This seems inefficient, though it is necessary to validate config in each context,
     // especially when it comes with per_filter_config,
@@ -241,7 +248,7 @@ RdsRouteConfigProviderImpl::RdsRouteConfigProviderImpl(
       config_update_info_(subscription_->routeConfigUpdate()),
       factory_context_(factory_context.getServerFactoryContext()),
       validator_(factory_context.messageValidationVisitor()),
-      tls_(factory_context.threadLocal().allocateSlot()) {
+      config_(factory_context_.dispatcher()) {
   ConfigConstSharedPtr initial_config;
   if (config_update_info_->configInfo().has_value()) {
     initial_config = std::make_shared<ConfigImpl>(config_update_info_->routeConfiguration(),
@@ -249,9 +256,7 @@ RdsRouteConfigProviderImpl::RdsRouteConfigProviderImpl(
   } else {
     initial_config = std::make_shared<NullConfigImpl>();
   }
-  tls_->set([initial_config](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::make_shared<ThreadLocalConfig>(initial_config);
-  });
+  config_.set(initial_config);
   // It should be 1:1 mapping due to shared rds config.
   ASSERT(subscription_->routeConfigProviders().empty());
   subscription_->routeConfigProviders().insert(this);
@@ -264,18 +269,18 @@ RdsRouteConfigProviderImpl::~RdsRouteConfigProviderImpl() {
 }
 
 Router::ConfigConstSharedPtr RdsRouteConfigProviderImpl::config() {
-  return tls_->getTyped<ThreadLocalConfig>().config_;
+  return config_.get();
 }
 
 void RdsRouteConfigProviderImpl::onConfigUpdate() {
-  ConfigConstSharedPtr new_config(new ConfigImpl(config_update_info_->routeConfiguration(),
-                                                 factory_context_, validator_, false));
-  tls_->runOnAllThreads([new_config](ThreadLocal::ThreadLocalObjectSharedPtr previous)
-                            -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    auto prev_config = std::dynamic_pointer_cast<ThreadLocalConfig>(previous);
-    prev_config->config_ = new_config;
-    return previous;
-  });
+  ConfigConstSharedPtr new_config = std::move(validated_config_);
+  // With VHDS, the route configuration applied is merged with the virtual hosts received from
+  // VHDS, and differs from the one validated.
+  if (new_config == nullptr || config_update_info_->routeConfiguration().has_vhds()) {
+    new_config = std::make_shared<ConfigImpl>(config_update_info_->routeConfiguration(),
+                                              factory_context_, validator_, false);
+  }
+  config_.set(new_config);
 
   const auto aliases = config_update_info_->resourceIdsInLastVhdsUpdate();
   // Regular (non-VHDS) RDS updates don't populate aliases fields in resources.
@@ -309,8 +314,7 @@ void RdsRouteConfigProviderImpl::onConfigUpdate() {
 
 void RdsRouteConfigProviderImpl::validateConfig(
     const envoy::config::route::v3alpha::RouteConfiguration& config) const {
-  // TODO(lizan): consider cache the config here until onConfigUpdate.
-  ConfigImpl validation_config(config, factory_context_, validator_, false);
+  validated_config_ = std::make_shared<ConfigImpl>(config, factory_context_, validator_, false);
 }
 
 // Schedules a VHDS request on the main thread and queues up the callback to use when the VHDS
@@ -22,7 +22,6 @@
 #include "envoy/service/discovery/v3alpha/discovery.pb.h"
 #include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
-#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/callback_impl.h"
 #include "common/common/cleanup.h"
@@ -34,6 +33,7 @@
 #include "common/protobuf/utility.h"
 #include "common/router/route_config_update_receiver_impl.h"
 #include "common/router/vhds.h"
+#include "common/thread_local/rcu_slot.h"
 
 namespace Envoy {
 namespace Router {
@@ -212,11 +212,6 @@ public:
   validateConfig(const envoy::config::route::v3alpha::RouteConfiguration& config) const override;
 
 private:
-  struct ThreadLocalConfig : public ThreadLocal::ThreadLocalObject {
-    ThreadLocalConfig(ConfigConstSharedPtr initial_config) : config_(std::move(initial_config)) {}
-    ConfigConstSharedPtr config_;
-  };
-
   RdsRouteConfigProviderImpl(RdsRouteConfigSubscriptionSharedPtr&& subscription,
                              Server::Configuration::FactoryContext& factory_context);
 
@@ -224,7 +219,11 @@ private:
   RouteConfigUpdatePtr& config_update_info_;
   Server::Configuration::ServerFactoryContext& factory_context_;
   ProtobufMessage::ValidationVisitor& validator_;
-  ThreadLocal::SlotPtr tls_;
+  // Read by the workers, updated by the main thread without posting to them.
+  ThreadLocal::RcuSlot<Config> config_;
+  // The config built by the last validateConfig(), applied by the following onConfigUpdate()
+  // rather than built again when it is for the same route configuration, i.e. without VHDS.
+  mutable ConfigConstSharedPtr validated_config_;
   std::list<UpdateOnDemandCallback> config_update_callbacks_;
 
   friend class RouteConfigProviderManagerImpl;
@@ -31,6 +31,14 @@ const uint32_t RetryPolicy::RETRY_ON_GRPC_DEADLINE_EXCEEDED;
 const uint32_t RetryPolicy::RETRY_ON_GRPC_RESOURCE_EXHAUSTED;
 const uint32_t RetryPolicy::RETRY_ON_GRPC_UNAVAILABLE;
 
+namespace {
+
+// Registered statically, so that the snapshots index them.
+const Runtime::Key base_retry_backoff_key{"upstream.base_retry_backoff_ms"};
+const Runtime::Key use_retry_key{"upstream.use_retry"};
+
+} // namespace
+
 RetryStatePtr RetryStateImpl::create(const RetryPolicy& route_policy,
                                      Http::HeaderMap& request_headers,
                                      const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
@@ -65,7 +73,7 @@ RetryStateImpl::RetryStateImpl(const RetryPolicy& route_policy, Http::HeaderMap&
       retriable_request_headers_(route_policy.retriableRequestHeaders()) {
 
   std::chrono::milliseconds base_interval(
-      runtime_.snapshot().getInteger("upstream.base_retry_backoff_ms", 25));
+      runtime_.snapshot().getInteger(base_retry_backoff_key, 25));
   if (route_policy.baseInterval()) {
     base_interval = *route_policy.baseInterval();
   }
@@ -223,18 +231,18 @@ RetryStatus RetryStateImpl::shouldRetry(bool would_retry, DoRetryCallback callba
 
   retries_remaining_--;
 
-  if (!cluster_.resourceManager(priority_).retries().canCreate()) {
+  if (!cluster_.resourceManager(priority_).retries().tryInc()) {
     cluster_.stats().upstream_rq_retry_overflow_.inc();
     return RetryStatus::NoOverflow;
   }
 
-  if (!runtime_.snapshot().featureEnabled("upstream.use_retry", 100)) {
+  if (!runtime_.snapshot().featureEnabled(use_retry_key, 100)) {
+    cluster_.resourceManager(priority_).retries().dec();
     return RetryStatus::No;
   }
 
   ASSERT(!callback_);
   callback_ = callback;
-  cluster_.resourceManager(priority_).retries().inc();
   cluster_.stats().upstream_rq_retry_.inc();
   enableBackoffTimer();
   return RetryStatus::Yes;
@@ -0,0 +1,105 @@
+#include "common/router/route_index.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+void RouteIndex::addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t route) {
+  if (case_sensitive) {
+    prefixes_.findOrInsert(prefix.begin(), prefix.end()).first->push_back(route);
+  } else {
+    const std::string lower_prefix = absl::AsciiStrToLower(prefix);
+    prefixes_ignore_case_.findOrInsert(lower_prefix.begin(), lower_prefix.end())
+        .first->push_back(route);
+  }
+}
+
+void RouteIndex::addPath(absl::string_view path, bool case_sensitive, uint32_t route) {
+  if (case_sensitive) {
+    paths_[path].push_back(route);
+  } else {
+    paths_ignore_case_[absl::AsciiStrToLower(path)].push_back(route);
+  }
+}
+
+void RouteIndex::addRegex(const std::string& regex, uint32_t route) {
+  if (regexes_ == nullptr) {
+    re2::RE2::Options options;
+    options.set_log_errors(false);
+    regexes_ = std::make_unique<re2::RE2::Set>(options, re2::RE2::ANCHOR_BOTH);
+  }
+  if (regexes_->Add(regex, nullptr) < 0) {
+    // Routes are only indexed once their regex compiled on its own, so this isn't expected, but
+    // the route is still correctly matched as a candidate for every request.
+    addAlwaysCandidate(route);
+    return;
+  }
+  regex_routes_.push_back(route);
+}
+
+void RouteIndex::compile() {
+  if (regexes_ == nullptr || regexes_->Compile()) {
+    return;
+  }
+  // The set ran out of memory, so its routes are evaluated one by one instead.
+  regexes_.reset();
+  always_candidates_.insert(always_candidates_.end(), regex_routes_.begin(), regex_routes_.end());
+  std::sort(always_candidates_.begin(), always_candidates_.end());
+  regex_routes_.clear();
+}
+
+void RouteIndex::addAlwaysCandidate(uint32_t route) {
+  ASSERT(always_candidates_.empty() || always_candidates_.back() < route);
+  always_candidates_.push_back(route);
+}
+
+void RouteIndex::findIndexedCandidates(absl::string_view path, Candidates& candidates) const {
+  const auto add_routes = [&candidates](const std::vector<uint32_t>& routes,
+                                        absl::string_view::const_iterator) {
+    candidates.insert(candidates.end(), routes.begin(), routes.end());
+  };
+  prefixes_.forEachPrefix(path.begin(), path.end(), [](char c) { return c; }, add_routes);
+  if (!prefixes_ignore_case_.empty()) {
+    prefixes_ignore_case_.forEachPrefix(path.begin(), path.end(), absl::ascii_tolower,
+                                        add_routes);
+  }
+
+  // Exact path matchers ignore the query string.
+  const absl::string_view path_only = path.substr(0, path.find('?'));
+  if (!paths_.empty()) {
+    auto it = paths_.find(path_only);
+    if (it != paths_.end()) {
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+  }
+  if (!paths_ignore_case_.empty()) {
+    auto it = paths_ignore_case_.find(absl::AsciiStrToLower(path_only));
+    if (it != paths_ignore_case_.end()) {
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+  }
+
+  if (regexes_ != nullptr) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regexes_->Match(re2::StringPiece(path_only.data(), path_only.size()), &matches,
+                        &error_info)) {
+      for (int match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // The match failed, e.g. as the DFA ran out of memory, so every regex route is a candidate.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/router/radix_trie.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index over the path matchers of the routes of a virtual host. Routes are identified by their
+ * position in the virtual host. For a given request path the index yields, in route order, the
+ * routes whose path matcher may match, so that only those have to be fully evaluated and first
+ * match semantics are preserved. Prefix matchers are kept in radix tries, exact path matchers in
+ * hash tables, RE2 regex matchers in a single RE2::Set matched in one pass over the path, and
+ * routes with any other matcher are always candidates.
+ */
+class RouteIndex {
+public:
+  /**
+   * Index a prefix path matcher.
+   * @param prefix supplies the prefix that must match the start of the :path header.
+   * @param case_sensitive supplies whether the prefix match is case sensitive.
+   * @param route supplies the position of the route in the virtual host.
+   */
+  void addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t route);
+
+  /**
+   * Index an exact path matcher.
+   * @param path supplies the path that must match the :path header minus the query string.
+   * @param case_sensitive supplies whether the path match is case sensitive.
+   * @param route supplies the position of the route in the virtual host.
+   */
+  void addPath(absl::string_view path, bool case_sensitive, uint32_t route);
+
+  /**
+   * Index a RE2 regex path matcher. The index must be compiled once all the routes are added.
+   * @param regex supplies the regex that must match the whole :path header minus the query string.
+   * @param route supplies the position of the route in the virtual host.
+   */
+  void addRegex(const std::string& regex, uint32_t route);
+
+  /**
+   * Compile the regex path matchers added, which must be done before looking up candidates. If
+   * they cannot be compiled together, their routes are candidates for every request instead.
+   */
+  void compile();
+
+  /**
+   * Add a route that cannot be indexed and is a candidate for every request.
+   * @param route supplies the position of the route in the virtual host.
+   */
+  void addAlwaysCandidate(uint32_t route);
+
+  /**
+   * Invoke a callback for every candidate route of a request, in ascending route order.
+   * @param path supplies the :path header of the request, including the query string.
+   * @param cb supplies the callback. It returns false to stop the iteration.
+   */
+  template <class Callback> void forEachCandidate(absl::string_view path, Callback cb) const {
+    Candidates indexed;
+    findIndexedCandidates(path, indexed);
+    auto indexed_it = indexed.begin();
+    auto always_it = always_candidates_.begin();
+    while (indexed_it != indexed.end() || always_it != always_candidates_.end()) {
+      uint32_t next;
+      if (always_it == always_candidates_.end() ||
+          (indexed_it != indexed.end() && *indexed_it < *always_it)) {
+        next = *indexed_it++;
+      } else {
+        next = *always_it++;
+      }
+      if (!cb(next)) {
+        return;
+      }
+    }
+  }
+
+private:
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+  // The routes of each prefix.
+  using PrefixTrie = RadixTrie<std::vector<uint32_t>>;
+
+  void findIndexedCandidates(absl::string_view path, Candidates& candidates) const;
+
+  PrefixTrie prefixes_;
+  // Keyed by the lower case prefix.
+  PrefixTrie prefixes_ignore_case_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> paths_;
+  // Keyed by the lower case path.
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> paths_ignore_case_;
+  // The route of each regex of the set, by its index in the set.
+  std::vector<uint32_t> regex_routes_;
+  std::unique_ptr<re2::RE2::Set> regexes_;
+  std::vector<uint32_t> always_candidates_;
+};
+
+using RouteIndexPtr = std::unique_ptr<RouteIndex>;
+
+} // namespace Router
+} // namespace Envoy
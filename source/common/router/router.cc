@@ -14,6 +14,7 @@
 #include "envoy/upstream/cluster_manager.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
@@ -44,6 +45,12 @@ constexpr char NumInternalRedirectsFilterStateName[] = "num_internal_redirects";
 
 uint32_t getLength(const Buffer::Instance* instance) { return instance ? instance->length() : 0; }
 
+// Adds the buffered request body to a buffer without copying it. Sharing the slices of the
+// buffered body only changes how they are held, not the content of the buffer.
+void addBufferedBody(const Buffer::Instance& buffered, Buffer::OwnedImpl& body) {
+  body.addShared(const_cast<Buffer::Instance&>(buffered));
+}
+
 bool schemeIsHttp(const Http::HeaderMap& downstream_headers,
                   const Network::Connection& connection) {
   if (downstream_headers.ForwardedProto() &&
@@ -124,6 +131,13 @@ uint64_t percentageOfTimeout(const std::chrono::milliseconds response_time,
   return static_cast<uint64_t>(response_time.count() * TimeoutPrecisionFactor / timeout.count());
 }
 
+// Header values cannot contain a NUL character, so it delimits the parts of a collapsing key.
+constexpr absl::string_view CollapsingKeyDelimiter{"\0", 1};
+
+absl::string_view headerValueOrEmpty(const Http::HeaderEntry* entry) {
+  return entry != nullptr ? entry->value().getStringView() : absl::string_view();
+}
+
 } // namespace
 
 void FilterUtility::setUpstreamScheme(Http::HeaderMap& headers, bool use_secure_transport) {
@@ -267,6 +281,7 @@ FilterUtility::HedgingParams FilterUtility::finalHedgingParams(const RouteEntry&
                                                                Http::HeaderMap& request_headers) {
   HedgingParams hedging_params;
   hedging_params.hedge_on_per_try_timeout_ = route.hedgePolicy().hedgeOnPerTryTimeout();
+  hedging_params.latency_hedge_policy_ = route.hedgePolicy().latencyHedgePolicy();
 
   const Http::HeaderEntry* hedge_on_per_try_timeout_entry =
       request_headers.EnvoyHedgeOnPerTryTimeout();
@@ -284,6 +299,60 @@ FilterUtility::HedgingParams FilterUtility::finalHedgingParams(const RouteEntry&
   return hedging_params;
 }
 
+std::string FilterUtility::collapsingKey(const RequestCollapsingPolicy& policy,
+                                         const Http::HeaderMap& request_headers) {
+  std::string key;
+  // The scheme is only carried by x-forwarded-proto for HTTP/1 requests.
+  const Http::HeaderEntry* scheme = request_headers.Scheme() != nullptr
+                                        ? request_headers.Scheme()
+                                        : request_headers.ForwardedProto();
+  absl::StrAppend(&key, headerValueOrEmpty(request_headers.Method()), CollapsingKeyDelimiter,
+                  headerValueOrEmpty(scheme), CollapsingKeyDelimiter,
+                  headerValueOrEmpty(request_headers.Host()), CollapsingKeyDelimiter,
+                  headerValueOrEmpty(request_headers.Path()));
+  for (const Http::LowerCaseString& header : policy.headers()) {
+    const Http::HeaderEntry* entry = request_headers.get(header);
+    // Tell a missing header from an empty one.
+    absl::StrAppend(&key, CollapsingKeyDelimiter, entry != nullptr ? "=" : "",
+                    headerValueOrEmpty(entry));
+  }
+  return key;
+}
+
+bool FilterUtility::shareableCollapsedResponse(const Http::HeaderMap& response_headers) {
+  // A server error is not shared, so that each collapsed request gets its own chance to succeed.
+  if (Http::Utility::getResponseStatus(response_headers) >= 500 ||
+      response_headers.Vary() != nullptr ||
+      response_headers.get(Http::Headers::get().SetCookie) != nullptr ||
+      response_headers.CacheControl() == nullptr) {
+    return false;
+  }
+
+  bool cacheable = false;
+  for (absl::string_view directive :
+       StringUtil::splitToken(response_headers.CacheControl()->value().getStringView(), ",")) {
+    const size_t equals = directive.find('=');
+    const absl::string_view name = StringUtil::trim(directive.substr(0, equals));
+    if (StringUtil::caseCompare(name, "private") || StringUtil::caseCompare(name, "no-store") ||
+        StringUtil::caseCompare(name, "no-cache")) {
+      return false;
+    }
+    if (StringUtil::caseCompare(name, "max-age") || StringUtil::caseCompare(name, "s-maxage")) {
+      // A response which is stale as soon as it is received is not shared either.
+      uint64_t seconds;
+      if (equals == absl::string_view::npos ||
+          !absl::SimpleAtoi(StringUtil::trim(directive.substr(equals + 1)), &seconds) ||
+          seconds == 0) {
+        return false;
+      }
+      cacheable = true;
+    } else if (StringUtil::caseCompare(name, "public")) {
+      cacheable = true;
+    }
+  }
+  return cacheable;
+}
+
 Filter::~Filter() {
   // Upstream resources should already have been cleaned.
   ASSERT(upstream_requests_.empty());
@@ -571,6 +640,9 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
   }
 
   hedging_params_ = FilterUtility::finalHedgingParams(*route_entry_, headers);
+  if (hedging_params_.latency_hedge_policy_ != nullptr) {
+    hedging_params_.latency_hedge_policy_->onRequest();
+  }
 
   timeout_ = FilterUtility::finalTimeout(*route_entry_, headers, !config_.suppress_envoy_headers_,
                                          grpc_request_, hedging_params_.hedge_on_per_try_timeout_,
@@ -616,11 +688,17 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
   // Hang onto the modify_headers function for later use in handling upstream responses.
   modify_headers_ = modify_headers;
 
+  if (maybeCollapseRequest(headers, end_stream)) {
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+
   UpstreamRequestPtr upstream_request = std::make_unique<UpstreamRequest>(*this, *conn_pool);
   upstream_request->moveIntoList(std::move(upstream_request), upstream_requests_);
   upstream_requests_.front()->encodeHeaders(end_stream);
   if (end_stream) {
     onRequestComplete();
+  } else if (config_.stream_shadows_) {
+    startShadowStreams(headers);
   }
 
   return Http::FilterHeadersStatus::StopIteration;
@@ -637,6 +715,136 @@ Http::ConnectionPool::Instance* Filter::getConnPool() {
                                             protocol, this);
 }
 
+bool Filter::maybeCollapseRequest(const Http::HeaderMap& headers, bool end_stream) {
+  const RequestCollapsingPolicy* policy = route_entry_->requestCollapsingPolicy();
+  // Only GET requests without a body are collapsed, as their responses are safe to share. Requests
+  // carrying credentials are not, as their responses may be specific to the user.
+  if (policy == nullptr || !end_stream || headers.Method() == nullptr ||
+      headers.Method()->value().getStringView() != Http::Headers::get().MethodValues.Get ||
+      headers.Authorization() != nullptr || headers.get(Http::Headers::get().Cookie) != nullptr) {
+    return false;
+  }
+
+  request_coalescer_ = config_.requestCoalescer(policy->perProcess());
+  if (request_coalescer_ == nullptr) {
+    return false;
+  }
+
+  Event::Dispatcher& dispatcher = callbacks_->dispatcher();
+  collapsing_key_ = FilterUtility::collapsingKey(*policy, headers);
+  collapsed_request_ = std::make_shared<CollapsedRequestImpl>(*this);
+  if (request_coalescer_->join(collapsing_key_, collapsed_request_, dispatcher)) {
+    collapsed_request_.reset();
+    collapsed_response_ = std::make_shared<Http::CoalescedResponse>();
+    max_collapsed_response_bytes_ = policy->maxResponseBytes();
+    return false;
+  }
+
+  ENVOY_STREAM_LOG(debug, "router collapsing request into an in-flight request", *callbacks_);
+  onRequestComplete();
+  // The global timeout covers the wait for the leader, and keeps running if the request ends up
+  // being forwarded upstream itself.
+  if (timeout_.global_timeout_.count() > 0) {
+    response_timeout_ = dispatcher.createTimer([this]() -> void { onResponseTimeout(); });
+    response_timeout_->enableTimer(timeout_.global_timeout_);
+  }
+  return true;
+}
+
+void Filter::onCollapsedResponse(Http::CoalescedResponseConstSharedPtr response) {
+  // The coalescer holds a reference to the collapsed request for the duration of this call.
+  collapsed_request_.reset();
+
+  if (response == nullptr) {
+    ENVOY_STREAM_LOG(debug, "router forwarding collapsed request", *callbacks_);
+    Http::ConnectionPool::Instance* conn_pool = getConnPool();
+    if (!conn_pool) {
+      sendNoHealthyUpstreamResponse();
+      return;
+    }
+    UpstreamRequestPtr upstream_request = std::make_unique<UpstreamRequest>(*this, *conn_pool);
+    upstream_request->moveIntoList(std::move(upstream_request), upstream_requests_);
+    upstream_requests_.front()->encodeHeaders(true);
+    // Possible that we got an immediate reset.
+    if (!upstream_requests_.empty()) {
+      maybeDoShadowing();
+    }
+    return;
+  }
+
+  ENVOY_STREAM_LOG(debug, "router sending collapsed response", *callbacks_);
+  config_.stats_.rq_collapsed_.inc();
+  // Stop the global timeout.
+  cleanup();
+
+  const bool has_body = !response->body_.empty();
+  const bool has_trailers = response->trailers_ != nullptr;
+  downstream_response_started_ = true;
+  callbacks_->streamInfo().setResponseCodeDetails(
+      StreamInfo::ResponseCodeDetails::get().ViaUpstream);
+  callbacks_->encodeHeaders(std::make_unique<Http::HeaderMapImpl>(*response->headers_),
+                            !has_body && !has_trailers);
+  if (has_body) {
+    // The fragment holds a reference to the response until the body has been written, so that the
+    // body is shared by all the collapsed requests rather than copied.
+    Buffer::OwnedImpl body;
+    body.addBufferFragment(*new Buffer::BufferFragmentImpl(
+        response->body_.data(), response->body_.size(),
+        [response](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+          delete fragment;
+        }));
+    callbacks_->encodeData(body, !has_trailers);
+  }
+  if (has_trailers) {
+    callbacks_->encodeTrailers(std::make_unique<Http::HeaderMapImpl>(*response->trailers_));
+  }
+}
+
+void Filter::collapseResponseHeaders(const Http::HeaderMap& headers, bool end_stream) {
+  if (collapsed_response_ == nullptr) {
+    return;
+  }
+  if (!FilterUtility::shareableCollapsedResponse(headers)) {
+    ENVOY_STREAM_LOG(debug, "router not sharing a response which is not cacheable", *callbacks_);
+    completeCollapsedRequest(false);
+    return;
+  }
+  collapsed_response_->headers_ = std::make_unique<Http::HeaderMapImpl>(headers);
+  if (collapsed_response_->byteSize() > max_collapsed_response_bytes_) {
+    completeCollapsedRequest(false);
+  } else if (end_stream) {
+    completeCollapsedRequest(true);
+  }
+}
+
+void Filter::collapseResponseData(const Buffer::Instance& data, bool end_stream) {
+  if (collapsed_response_ == nullptr) {
+    return;
+  }
+  if (collapsed_response_->byteSize() + data.length() > max_collapsed_response_bytes_) {
+    completeCollapsedRequest(false);
+    return;
+  }
+  collapsed_response_->body_.append(data.toString());
+  if (end_stream) {
+    completeCollapsedRequest(true);
+  }
+}
+
+void Filter::collapseResponseTrailers(const Http::HeaderMap& trailers) {
+  if (collapsed_response_ == nullptr) {
+    return;
+  }
+  collapsed_response_->trailers_ = std::make_unique<Http::HeaderMapImpl>(trailers);
+  completeCollapsedRequest(collapsed_response_->byteSize() <= max_collapsed_response_bytes_);
+}
+
+void Filter::completeCollapsedRequest(bool share_response) {
+  ASSERT(collapsed_response_ != nullptr);
+  Http::CoalescedResponseConstSharedPtr response = std::move(collapsed_response_);
+  request_coalescer_->complete(collapsing_key_, share_response ? response : nullptr);
+}
+
 void Filter::sendNoHealthyUpstreamResponse() {
   callbacks_->streamInfo().setResponseFlag(StreamInfo::ResponseFlag::NoHealthyUpstream);
   chargeUpstreamCode(Http::Code::ServiceUnavailable, nullptr, false);
@@ -662,10 +870,13 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
     active_shadow_policies_.clear();
   }
 
+  sendDataToShadowStreams(data, end_stream);
+
   if (buffering) {
     // If we are going to buffer for retries or shadowing, we need to make a copy before encoding
-    // since it's all moves from here on.
-    Buffer::OwnedImpl copy(data);
+    // since it's all moves from here on. The copy shares the slices of the data.
+    Buffer::OwnedImpl copy;
+    copy.addShared(data);
     upstream_requests_.front()->encodeData(copy, end_stream);
 
     // If we are potentially going to retry or shadow this request we need to buffer.
@@ -694,6 +905,12 @@ Http::FilterTrailersStatus Filter::decodeTrailers(Http::HeaderMap& trailers) {
   // try timeout timer is not started until onUpstreamComplete().
   ASSERT(upstream_requests_.size() == 1);
   downstream_trailers_ = &trailers;
+  for (ShadowStream* shadow_stream : shadow_streams_) {
+    if (!shadow_stream->sendTrailers(trailers)) {
+      cluster_->stats().retry_or_shadow_abandoned_.inc();
+    }
+  }
+  releaseShadowStreams();
   for (auto& upstream_request : upstream_requests_) {
     upstream_request->encodeTrailers(trailers);
   }
@@ -741,7 +958,9 @@ void Filter::maybeDoShadowing() {
     Http::MessagePtr request(new Http::RequestMessageImpl(
         Http::HeaderMapPtr{new Http::HeaderMapImpl(*downstream_headers_)}));
     if (callbacks_->decodingBuffer()) {
-      request->body() = std::make_unique<Buffer::OwnedImpl>(*callbacks_->decodingBuffer());
+      auto body = std::make_unique<Buffer::OwnedImpl>();
+      addBufferedBody(*callbacks_->decodingBuffer(), *body);
+      request->body() = std::move(body);
     }
     if (downstream_trailers_) {
       request->trailers(Http::HeaderMapPtr{new Http::HeaderMapImpl(*downstream_trailers_)});
@@ -752,6 +971,43 @@ void Filter::maybeDoShadowing() {
   }
 }
 
+void Filter::startShadowStreams(const Http::HeaderMap& headers) {
+  // The streamed shadows replace the shadows of the complete request.
+  for (const auto& shadow_policy_wrapper : active_shadow_policies_) {
+    ShadowStream* shadow_stream = config_.shadowWriter().streamingShadow(
+        shadow_policy_wrapper.get().cluster(),
+        Http::HeaderMapPtr{new Http::HeaderMapImpl(headers)}, timeout_.global_timeout_);
+    if (shadow_stream != nullptr) {
+      shadow_streams_.push_back(shadow_stream);
+    }
+  }
+  active_shadow_policies_.clear();
+}
+
+void Filter::sendDataToShadowStreams(Buffer::Instance& data, bool end_stream) {
+  for (auto it = shadow_streams_.begin(); it != shadow_streams_.end();) {
+    Buffer::OwnedImpl shadow_data;
+    shadow_data.addShared(data);
+    if ((*it)->sendData(shadow_data, end_stream)) {
+      ++it;
+    } else {
+      cluster_->stats().retry_or_shadow_abandoned_.inc();
+      (*it)->release();
+      it = shadow_streams_.erase(it);
+    }
+  }
+  if (end_stream) {
+    releaseShadowStreams();
+  }
+}
+
+void Filter::releaseShadowStreams() {
+  for (ShadowStream* shadow_stream : shadow_streams_) {
+    shadow_stream->release();
+  }
+  shadow_streams_.clear();
+}
+
 void Filter::onRequestComplete() {
   // This should be called exactly once, when the downstream request has been received in full.
   ASSERT(!downstream_end_stream_);
@@ -773,20 +1029,45 @@ void Filter::onRequestComplete() {
     for (auto& upstream_request : upstream_requests_) {
       if (upstream_request->create_per_try_timeout_on_request_complete_) {
         upstream_request->setupPerTryTimeout();
+        upstream_request->setupHedgeTimeout();
       }
     }
   }
 }
 
 void Filter::onDestroy() {
-  // Reset any in-flight upstream requests.
+  // Hand over to the requests collapsed into this one, or stop waiting for the leader.
+  if (collapsed_response_ != nullptr) {
+    completeCollapsedRequest(false);
+  }
+  if (collapsed_request_ != nullptr) {
+    request_coalescer_->leave(collapsing_key_, *collapsed_request_);
+    collapsed_request_.reset();
+  }
+
+  // Reset any in-flight upstream requests, and the shadows of incomplete requests.
   resetAll();
+  releaseShadowStreams();
   cleanup();
 }
 
+uint64_t Filter::bufferedBytes() const {
+  uint64_t bytes = 0;
+  for (const UpstreamRequestPtr& upstream_request : upstream_requests_) {
+    bytes += upstream_request->bufferedBytes();
+  }
+  return bytes;
+}
+
 void Filter::onResponseTimeout() {
   ENVOY_STREAM_LOG(debug, "upstream timeout", *callbacks_);
 
+  // Stop waiting for the leader this request is collapsed into.
+  if (collapsed_request_ != nullptr) {
+    request_coalescer_->leave(collapsing_key_, *collapsed_request_);
+    collapsed_request_.reset();
+  }
+
   // If we had an upstream request that got a "good" response, save its
   // upstream timing information into the downstream stream info.
   if (final_upstream_request_) {
@@ -837,7 +1118,8 @@ void Filter::onSoftPerTryTimeout(UpstreamRequest& upstream_request) {
                          absl::optional<uint64_t>(enumToInt(timeout_response_code_)));
   upstream_request.outlier_detection_timeout_recorded_ = true;
 
-  if (!downstream_response_started_ && retry_state_) {
+  // A request already hedged on latency is not hedged again.
+  if (!downstream_response_started_ && retry_state_ && !upstream_request.retried_) {
     RetryStatus retry_status =
         retry_state_->shouldHedgeRetryPerTryTimeout([this]() -> void { doRetry(); });
 
@@ -882,10 +1164,37 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
 
   // Remove this upstream request from the list now that we're done with it.
   upstream_request.removeFromList(upstream_requests_);
+
+  // A request hedged on latency may still see an upstream response.
+  if (numRequestsAwaitingHeaders() > 0 || pending_retries_ > 0) {
+    return;
+  }
+
   onUpstreamTimeoutAbort(StreamInfo::ResponseFlag::UpstreamRequestTimeout,
                          StreamInfo::ResponseCodeDetails::get().UpstreamPerTryTimeout);
 }
 
+void Filter::onHedgeTimeout(UpstreamRequest& upstream_request) {
+  if (downstream_response_started_ || !retry_state_) {
+    return;
+  }
+
+  if (!hedging_params_.latency_hedge_policy_->canHedge()) {
+    cluster_->stats().upstream_rq_latency_hedge_budget_exceeded_.inc();
+    return;
+  }
+
+  const RetryStatus retry_status =
+      retry_state_->shouldHedgeRetryPerTryTimeout([this]() -> void { doRetry(); });
+  if (retry_status == RetryStatus::Yes && setupRetry()) {
+    // The slow request keeps racing the hedge, and is not retried again. Only a hedge which is
+    // sent is charged to the budget.
+    upstream_request.retried_ = true;
+    hedging_params_.latency_hedge_policy_->onHedge();
+    cluster_->stats().upstream_rq_latency_hedge_.inc();
+  }
+}
+
 void Filter::updateOutlierDetection(Upstream::Outlier::Result result,
                                     UpstreamRequest& upstream_request,
                                     absl::optional<uint64_t> code) {
@@ -1114,6 +1423,19 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& head
                                UpstreamRequest& upstream_request, bool end_stream) {
   ENVOY_STREAM_LOG(debug, "upstream headers complete: end_stream={}", *callbacks_, end_stream);
 
+  const MonotonicTime headers_received_time = callbacks_->dispatcher().timeSource().monotonicTime();
+  if (hedging_params_.latency_hedge_policy_ != nullptr) {
+    hedging_params_.latency_hedge_policy_->recordLatency(
+        std::chrono::duration_cast<std::chrono::milliseconds>(headers_received_time -
+                                                              upstream_request.start_time_));
+  }
+  if (cluster_->lbType() == Upstream::LoadBalancerType::PeakEwma) {
+    upstream_request.upstream_host_->latency().recordLatency(
+        std::chrono::duration_cast<std::chrono::microseconds>(headers_received_time -
+                                                              upstream_request.start_time_),
+        headers_received_time);
+  }
+
   modify_headers_(*headers);
   // When grpc-status appears in response headers, convert grpc-status to HTTP status code
   // for outlier detection. This does not currently change any stats or logging and does not
@@ -1240,6 +1562,7 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& head
     onUpstreamComplete(upstream_request);
   }
 
+  collapseResponseHeaders(*headers, end_stream);
   callbacks_->streamInfo().setResponseCodeDetails(
       StreamInfo::ResponseCodeDetails::get().ViaUpstream);
   callbacks_->encodeHeaders(std::move(headers), end_stream);
@@ -1259,6 +1582,7 @@ void Filter::onUpstreamData(Buffer::Instance& data, UpstreamRequest& upstream_re
     onUpstreamComplete(upstream_request);
   }
 
+  collapseResponseData(data, end_stream);
   callbacks_->encodeData(data, end_stream);
 }
 
@@ -1280,6 +1604,7 @@ void Filter::onUpstreamTrailers(Http::HeaderMapPtr&& trailers, UpstreamRequest&
 
   onUpstreamComplete(upstream_request);
 
+  collapseResponseTrailers(*trailers);
   callbacks_->encodeTrailers(std::move(trailers));
 }
 
@@ -1424,7 +1749,8 @@ void Filter::doRetry() {
   if (!upstream_requests_.empty() && (upstream_requests_.front().get() == upstream_request_tmp)) {
     if (callbacks_->decodingBuffer()) {
       // If we are doing a retry we need to make a copy.
-      Buffer::OwnedImpl copy(*callbacks_->decodingBuffer());
+      Buffer::OwnedImpl copy;
+      addBufferedBody(*callbacks_->decodingBuffer(), copy);
       upstream_requests_.front()->encodeData(copy, !downstream_trailers_);
     }
 
@@ -1472,6 +1798,9 @@ Filter::UpstreamRequest::~UpstreamRequest() {
     // Allows for testing.
     per_try_timeout_->disableTimer();
   }
+  if (hedge_timeout_ != nullptr) {
+    hedge_timeout_->disableTimer();
+  }
   clearRequestEncoder();
 
   // If desired, fire the per-try histogram when the UpstreamRequest
@@ -1560,6 +1889,14 @@ void Filter::UpstreamRequest::encodeHeaders(bool end_stream) {
   }
 }
 
+uint64_t Filter::UpstreamRequest::bufferedBytes() const {
+  uint64_t bytes = buffered_request_body_ != nullptr ? buffered_request_body_->length() : 0;
+  if (request_encoder_ != nullptr) {
+    bytes += request_encoder_->getStream().bufferedBytes();
+  }
+  return bytes;
+}
+
 void Filter::UpstreamRequest::encodeData(Buffer::Instance& data, bool end_stream) {
   ASSERT(!encode_complete_);
   encode_complete_ = end_stream;
@@ -1571,6 +1908,8 @@ void Filter::UpstreamRequest::encodeData(Buffer::Instance& data, bool end_stream
           [this]() -> void { this->enableDataFromDownstream(); },
           [this]() -> void { this->disableDataFromDownstream(); });
       buffered_request_body_->setWatermarks(parent_.callbacks_->decoderBufferLimit());
+      buffered_request_body_->setMemoryAccount(
+          Buffer::MemoryAccount::create(Buffer::MemoryClass::UpstreamRequest));
     }
 
     buffered_request_body_->move(data);
@@ -1670,6 +2009,37 @@ void Filter::UpstreamRequest::setupPerTryTimeout() {
   }
 }
 
+void Filter::UpstreamRequest::setupHedgeTimeout() {
+  ASSERT(!hedge_timeout_);
+  const LatencyHedgePolicy* latency_hedge_policy = parent_.hedging_params_.latency_hedge_policy_;
+  if (latency_hedge_policy == nullptr || retried_) {
+    return;
+  }
+  const absl::optional<std::chrono::milliseconds> hedge_delay = latency_hedge_policy->hedgeDelay();
+  // Requests slower than the per try timeout are left to the per try timeout.
+  if (!hedge_delay.has_value() || (parent_.timeout_.per_try_timeout_.count() > 0 &&
+                                   hedge_delay.value() >= parent_.timeout_.per_try_timeout_)) {
+    return;
+  }
+
+  // The latencies are measured from the start of the upstream request, which may precede the
+  // completion of the downstream request.
+  const std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      parent_.callbacks_->dispatcher().timeSource().monotonicTime() - start_time_);
+  hedge_timeout_ =
+      parent_.callbacks_->dispatcher().createTimer([this]() -> void { onHedgeTimeout(); });
+  hedge_timeout_->enableTimer(
+      std::max(hedge_delay.value() - elapsed, std::chrono::milliseconds(0)));
+}
+
+void Filter::UpstreamRequest::onHedgeTimeout() {
+  if (!parent_.downstream_response_started_ && awaiting_headers_ && !retried_) {
+    ENVOY_STREAM_LOG(debug, "upstream request slower than the latency hedge delay",
+                     *parent_.callbacks_);
+    parent_.onHedgeTimeout(*this);
+  }
+}
+
 void Filter::UpstreamRequest::onPerTryTimeout() {
   // If we've sent anything downstream, ignore the per try timeout and let the response continue
   // up to the global timeout
@@ -1724,6 +2094,7 @@ void Filter::UpstreamRequest::onPoolReady(Http::StreamEncoder& request_encoder,
 
   if (parent_.downstream_end_stream_) {
     setupPerTryTimeout();
+    setupHedgeTimeout();
   } else {
     create_per_try_timeout_on_request_complete_ = true;
   }
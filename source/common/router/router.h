@@ -16,6 +16,7 @@
 #include "envoy/server/filter_config.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/access_log/access_log_impl.h"
@@ -26,6 +27,7 @@
 #include "common/common/linked_object.h"
 #include "common/common/logger.h"
 #include "common/config/well_known_names.h"
+#include "common/http/request_coalescer.h"
 #include "common/http/utility.h"
 #include "common/router/config_impl.h"
 #include "common/stats/symbol_table_impl.h"
@@ -42,6 +44,7 @@ namespace Router {
 #define ALL_ROUTER_STATS(COUNTER)                                                                  \
   COUNTER(no_route)                                                                                \
   COUNTER(no_cluster)                                                                              \
+  COUNTER(rq_collapsed)                                                                            \
   COUNTER(rq_redirect)                                                                             \
   COUNTER(rq_direct_response)                                                                      \
   COUNTER(rq_total)                                                                                \
@@ -68,6 +71,7 @@ public:
 
   struct HedgingParams {
     bool hedge_on_per_try_timeout_;
+    const LatencyHedgePolicy* latency_hedge_policy_{};
   };
 
   class StrictHeaderChecker {
@@ -148,6 +152,24 @@ public:
   static bool trySetGlobalTimeout(const Http::HeaderEntry* header_timeout_entry,
                                   TimeoutData& timeout);
 
+  /**
+   * Compute the key which identical requests share when they are collapsed.
+   * @param policy supplies the route's request collapsing policy.
+   * @param request_headers supplies the request headers.
+   * @return the key of the request.
+   */
+  static std::string collapsingKey(const RequestCollapsingPolicy& policy,
+                                   const Http::HeaderMap& request_headers);
+
+  /**
+   * Determine whether a response may be sent to the requests collapsed into the request which
+   * received it. Only responses which are explicitly cacheable by a shared cache are, while server
+   * errors and responses which vary per request or set cookies are not.
+   * @param response_headers supplies the response headers.
+   * @return true if the response may be shared.
+   */
+  static bool shareableCollapsedResponse(const Http::HeaderMap& response_headers);
+
   /**
    * Determine the final hedging settings after applying randomized behavior.
    * @param route supplies the request route.
@@ -169,7 +191,8 @@ public:
                bool emit_dynamic_stats, bool start_child_span, bool suppress_envoy_headers,
                bool respect_expected_rq_timeout,
                const Protobuf::RepeatedPtrField<std::string>& strict_check_headers,
-               TimeSource& time_source, Http::Context& http_context)
+               TimeSource& time_source, Http::Context& http_context,
+               ThreadLocal::SlotAllocator* tls)
       : scope_(scope), local_info_(local_info), cm_(cm), runtime_(runtime),
         random_(random), stats_{ALL_ROUTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))},
         emit_dynamic_stats_(emit_dynamic_stats), start_child_span_(start_child_span),
@@ -178,7 +201,9 @@ public:
         stat_name_pool_(scope_.symbolTable()), retry_(stat_name_pool_.add("retry")),
         zone_name_(stat_name_pool_.add(local_info_.zoneName())),
         empty_stat_name_(stat_name_pool_.add("")), shadow_writer_(std::move(shadow_writer)),
-        time_source_(time_source) {
+        time_source_(time_source),
+        worker_request_coalescer_(tls != nullptr ? std::make_unique<Http::RequestCoalescer>(*tls)
+                                                 : nullptr) {
     if (!strict_check_headers.empty()) {
       strict_check_headers_ = std::make_unique<HeaderVector>();
       for (const auto& header : strict_check_headers) {
@@ -195,16 +220,22 @@ public:
                      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, dynamic_stats, true),
                      config.start_child_span(), config.suppress_envoy_headers(),
                      config.respect_expected_rq_timeout(), config.strict_check_headers(),
-                     context.api().timeSource(), context.httpContext()) {
+                     context.api().timeSource(), context.httpContext(), &context.threadLocal()) {
     for (const auto& upstream_log : config.upstream_log()) {
       upstream_logs_.push_back(AccessLog::AccessLogFactory::fromProto(upstream_log, context));
     }
+    stream_shadows_ = config.has_shadow_stream_budget_bytes();
   }
   using HeaderVector = std::vector<Http::LowerCaseString>;
   using HeaderVectorPtr = std::unique_ptr<HeaderVector>;
 
   ShadowWriter& shadowWriter() { return *shadow_writer_; }
   TimeSource& timeSource() { return time_source_; }
+  // nullptr if the requests are not collapsed per worker thread, e.g. by the async client whose
+  // routes do not collapse requests.
+  Http::RequestCoalescer* requestCoalescer(bool per_process) {
+    return per_process ? &process_request_coalescer_ : worker_request_coalescer_.get();
+  }
 
   Stats::Scope& scope_;
   const LocalInfo::LocalInfo& local_info_;
@@ -224,10 +255,16 @@ public:
   Stats::StatName retry_;
   Stats::StatName zone_name_;
   Stats::StatName empty_stat_name_;
+  // Whether the requests with a body are shadowed as they are streamed.
+  bool stream_shadows_{};
 
 private:
   ShadowWriterPtr shadow_writer_;
   TimeSource& time_source_;
+  // Shared by the workers, so that requests can be collapsed across them.
+  Http::RequestCoalescer process_request_coalescer_;
+  // Holds the in-flight requests of each worker, so that collapsing them takes no lock.
+  const Http::RequestCoalescerPtr worker_request_coalescer_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -248,6 +285,7 @@ public:
 
   // Http::StreamFilterBase
   void onDestroy() override;
+  uint64_t bufferedBytes() const override;
 
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
@@ -381,7 +419,11 @@ private:
     void resetStream();
     void setupPerTryTimeout();
     void onPerTryTimeout();
+    void setupHedgeTimeout();
+    void onHedgeTimeout();
     void maybeEndDecode(bool end_stream);
+    // The bytes of the request buffered until the upstream stream is ready, and then by its codec.
+    uint64_t bufferedBytes() const;
 
     void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) {
       stream_info_.onUpstreamHostSelected(host);
@@ -462,6 +504,8 @@ private:
     Http::ConnectionPool::Instance& conn_pool_;
     bool grpc_rq_success_deferred_;
     Event::TimerPtr per_try_timeout_;
+    // Fires when the request is slower than the latency percentile of the latency hedge policy.
+    Event::TimerPtr hedge_timeout_;
     Http::ConnectionPool::Cancellable* conn_pool_stream_handle_{};
     Http::StreamEncoder* request_encoder_{};
     absl::optional<Http::StreamResetReason> deferred_reset_reason_;
@@ -497,6 +541,23 @@ private:
 
   using UpstreamRequestPtr = std::unique_ptr<UpstreamRequest>;
 
+  /**
+   * Notifies a request collapsed into an in-flight request. It is owned by the filter, so that
+   * the collapser only holds a weak reference to it.
+   */
+  class CollapsedRequestImpl : public Http::CoalescedRequest {
+  public:
+    CollapsedRequestImpl(Filter& parent) : parent_(parent) {}
+
+    // Http::CoalescedRequest
+    void onLeaderComplete(Http::CoalescedResponseConstSharedPtr response) override {
+      parent_.onCollapsedResponse(std::move(response));
+    }
+
+  private:
+    Filter& parent_;
+  };
+
   StreamInfo::ResponseFlag streamResetReasonToResponseFlag(Http::StreamResetReason reset_reason);
 
   Stats::StatName upstreamZone(Upstream::HostDescriptionConstSharedPtr upstream_host);
@@ -513,11 +574,26 @@ private:
                                          Event::Dispatcher& dispatcher,
                                          Upstream::ResourcePriority priority) PURE;
   Http::ConnectionPool::Instance* getConnPool();
+  // Collapse the request into an identical in-flight request, or make it the leader which others
+  // are collapsed into. Returns true if the request has been collapsed.
+  bool maybeCollapseRequest(const Http::HeaderMap& headers, bool end_stream);
+  void onCollapsedResponse(Http::CoalescedResponseConstSharedPtr response);
+  // Record the response of the leader, to share it with the collapsed requests.
+  void collapseResponseHeaders(const Http::HeaderMap& headers, bool end_stream);
+  void collapseResponseData(const Buffer::Instance& data, bool end_stream);
+  void collapseResponseTrailers(const Http::HeaderMap& trailers);
+  // Complete the leader, sharing its response if possible. Otherwise the collapsed requests are
+  // forwarded upstream themselves.
+  void completeCollapsedRequest(bool share_response);
   void maybeDoShadowing();
+  void startShadowStreams(const Http::HeaderMap& headers);
+  void sendDataToShadowStreams(Buffer::Instance& data, bool end_stream);
+  void releaseShadowStreams();
   bool maybeRetryReset(Http::StreamResetReason reset_reason, UpstreamRequest& upstream_request);
   uint32_t numRequestsAwaitingHeaders();
   void onGlobalTimeout();
   void onPerTryTimeout(UpstreamRequest& upstream_request);
+  void onHedgeTimeout(UpstreamRequest& upstream_request);
   void onRequestComplete();
   void onResponseTimeout();
   void onUpstream100ContinueHeaders(Http::HeaderMapPtr&& headers,
@@ -583,6 +659,16 @@ private:
   MetadataMatchCriteriaConstPtr metadata_match_;
   std::function<void(Http::HeaderMap&)> modify_headers_;
   std::vector<std::reference_wrapper<const ShadowPolicy>> active_shadow_policies_{};
+  std::vector<ShadowStream*> shadow_streams_;
+  // The key of the request when it is the leader of, or collapsed into, an in-flight request, and
+  // the coalescer of the scope of its route's collapsing policy.
+  std::string collapsing_key_;
+  Http::RequestCoalescer* request_coalescer_{};
+  // Set while the request waits for the leader it is collapsed into.
+  std::shared_ptr<CollapsedRequestImpl> collapsed_request_;
+  // Set while the leader records its response.
+  Http::CoalescedResponseSharedPtr collapsed_response_;
+  uint64_t max_collapsed_response_bytes_{};
 
   // list of cookies to add to upstream headers
   std::vector<std::string> downstream_set_cookies_;
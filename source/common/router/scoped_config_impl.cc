@@ -19,7 +19,8 @@ bool ScopeKey::operator==(const ScopeKey& other) const {
 HeaderValueExtractorImpl::HeaderValueExtractorImpl(
     ScopedRoutes::ScopeKeyBuilder::FragmentBuilder&& config)
     : FragmentBuilderBase(std::move(config)),
-      header_value_extractor_config_(config_.header_value_extractor()) {
+      header_value_extractor_config_(config_.header_value_extractor()),
+      header_name_(header_value_extractor_config_.name()) {
   ASSERT(config_.type_case() ==
              ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::kHeaderValueExtractor,
          "header_value_extractor is not set.");
@@ -38,39 +39,75 @@ HeaderValueExtractorImpl::HeaderValueExtractorImpl(
   }
 }
 
-std::unique_ptr<ScopeKeyFragmentBase>
-HeaderValueExtractorImpl::computeFragment(const Http::HeaderMap& headers) const {
-  const Envoy::Http::HeaderEntry* header_entry =
-      headers.get(Envoy::Http::LowerCaseString(header_value_extractor_config_.name()));
+absl::optional<absl::string_view>
+HeaderValueExtractorImpl::extractValue(const Http::HeaderMap& headers) const {
+  const Envoy::Http::HeaderEntry* header_entry = headers.get(header_name_);
   if (header_entry == nullptr) {
-    return nullptr;
+    return absl::nullopt;
   }
 
-  std::vector<absl::string_view> elements{header_entry->value().getStringView()};
-  if (header_value_extractor_config_.element_separator().length() > 0) {
-    elements = absl::StrSplit(header_entry->value().getStringView(),
-                              header_value_extractor_config_.element_separator());
-  }
+  // The elements are split lazily, as views into the header value, until the fragment is found.
+  const absl::string_view value = header_entry->value().getStringView();
+  const std::string& element_separator = header_value_extractor_config_.element_separator();
   switch (header_value_extractor_config_.extract_type_case()) {
-  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kElement:
-    for (const auto& element : elements) {
+  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kElement: {
+    const auto element_value =
+        [this](absl::string_view element) -> absl::optional<absl::string_view> {
       std::pair<absl::string_view, absl::string_view> key_value = absl::StrSplit(
           element, absl::MaxSplits(header_value_extractor_config_.element().separator(), 1));
       if (key_value.first == header_value_extractor_config_.element().key()) {
-        return std::make_unique<StringKeyFragment>(key_value.second);
+        return key_value.second;
+      }
+      return absl::nullopt;
+    };
+    if (element_separator.empty()) {
+      return element_value(value);
+    }
+    for (const absl::string_view element : absl::StrSplit(value, element_separator)) {
+      const absl::optional<absl::string_view> fragment_value = element_value(element);
+      if (fragment_value.has_value()) {
+        return fragment_value;
       }
     }
     break;
-  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kIndex:
-    if (header_value_extractor_config_.index() < elements.size()) {
-      return std::make_unique<StringKeyFragment>(elements[header_value_extractor_config_.index()]);
+  }
+  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kIndex: {
+    if (element_separator.empty()) {
+      // The index is 0, checked in the constructor.
+      return value;
+    }
+    uint32_t index = 0;
+    for (const absl::string_view element : absl::StrSplit(value, element_separator)) {
+      if (index++ == header_value_extractor_config_.index()) {
+        return element;
+      }
     }
     break;
+  }
   default:                       // EXTRACT_TYPE_NOT_SET
     NOT_REACHED_GCOVR_EXCL_LINE; // Caught in constructor already.
   }
 
-  return nullptr;
+  return absl::nullopt;
+}
+
+std::unique_ptr<ScopeKeyFragmentBase>
+HeaderValueExtractorImpl::computeFragment(const Http::HeaderMap& headers) const {
+  const absl::optional<absl::string_view> value = extractValue(headers);
+  if (!value.has_value()) {
+    return nullptr;
+  }
+  return std::make_unique<StringKeyFragment>(value.value());
+}
+
+absl::optional<uint64_t>
+HeaderValueExtractorImpl::computeFragmentHash(const Http::HeaderMap& headers) const {
+  const absl::optional<absl::string_view> value = extractValue(headers);
+  if (!value.has_value()) {
+    return absl::nullopt;
+  }
+  // The hash of the StringKeyFragment of the value.
+  return HashUtil::xxHash64(value.value());
 }
 
 ScopedRouteInfo::ScopedRouteInfo(
@@ -119,6 +156,19 @@ ScopeKeyBuilderImpl::computeScopeKey(const Http::HeaderMap& headers) const {
   return std::make_unique<ScopeKey>(std::move(key));
 }
 
+absl::optional<uint64_t>
+ScopeKeyBuilderImpl::computeScopeKeyHash(const Http::HeaderMap& headers) const {
+  uint64_t hash = 0;
+  for (const auto& builder : fragment_builders_) {
+    const absl::optional<uint64_t> fragment_hash = builder->computeFragmentHash(headers);
+    if (!fragment_hash.has_value()) {
+      return absl::nullopt;
+    }
+    hash = ScopeKey::combineHash(hash, fragment_hash.value());
+  }
+  return hash;
+}
+
 void ScopedConfigImpl::addOrUpdateRoutingScope(
     const ScopedRouteInfoConstSharedPtr& scoped_route_info) {
   const auto iter = scoped_route_info_by_name_.find(scoped_route_info->scopeName());
@@ -141,11 +191,12 @@ void ScopedConfigImpl::removeRoutingScope(const std::string& scope_name) {
 
 Router::ConfigConstSharedPtr
 ScopedConfigImpl::getRouteConfig(const Http::HeaderMap& headers) const {
-  std::unique_ptr<ScopeKey> scope_key = scope_key_builder_.computeScopeKey(headers);
-  if (scope_key == nullptr) {
+  // Only the hash of the key is needed for the lookup, which is computed without building the key.
+  const absl::optional<uint64_t> scope_key_hash = scope_key_builder_.computeScopeKeyHash(headers);
+  if (!scope_key_hash.has_value()) {
     return nullptr;
   }
-  auto iter = scoped_route_info_by_key_.find(scope_key->hash());
+  auto iter = scoped_route_info_by_key_.find(scope_key_hash.value());
   if (iter != scoped_route_info_by_key_.end()) {
     return iter->second->routeConfig();
   }
@@ -15,6 +15,7 @@
 
 #include "absl/numeric/int128.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Router {
@@ -63,14 +64,17 @@ public:
   bool operator!=(const ScopeKey& other) const;
   bool operator==(const ScopeKey& other) const;
 
+  // Combines the hash of a key, 0 if it is empty, with the hash of its next fragment.
+  static uint64_t combineHash(uint64_t hash, uint64_t fragment_hash) {
+    const uint64_t hashes[] = {hash, fragment_hash};
+    return HashUtil::xxHash64(
+        absl::string_view(reinterpret_cast<const char*>(hashes), sizeof(hashes)));
+  }
+
 private:
   // Update the key's hash with the new fragment hash.
   void updateHash(const ScopeKeyFragmentBase& fragment) {
-    std::stringbuf buffer;
-    buffer.sputn(reinterpret_cast<const char*>(&hash_), sizeof(hash_));
-    const auto& fragment_hash = fragment.hash();
-    buffer.sputn(reinterpret_cast<const char*>(&fragment_hash), sizeof(fragment_hash));
-    hash_ = HashUtil::xxHash64(buffer.str());
+    hash_ = combineHash(hash_, fragment.hash());
   }
 
   uint64_t hash_{0};
@@ -104,6 +108,10 @@ public:
   virtual std::unique_ptr<ScopeKeyFragmentBase>
   computeFragment(const Http::HeaderMap& headers) const PURE;
 
+  // Returns the hash of the fragment computeFragment() would return, without building it, or
+  // absl::nullopt if no fragment could be generated from the headers.
+  virtual absl::optional<uint64_t> computeFragmentHash(const Http::HeaderMap& headers) const PURE;
+
 protected:
   const ScopedRoutes::ScopeKeyBuilder::FragmentBuilder config_;
 };
@@ -114,10 +122,16 @@ public:
 
   std::unique_ptr<ScopeKeyFragmentBase>
   computeFragment(const Http::HeaderMap& headers) const override;
+  absl::optional<uint64_t> computeFragmentHash(const Http::HeaderMap& headers) const override;
 
 private:
+  // Returns the value of the fragment, which points into the headers, or absl::nullopt if it can't
+  // be extracted from them.
+  absl::optional<absl::string_view> extractValue(const Http::HeaderMap& headers) const;
+
   const ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor&
       header_value_extractor_config_;
+  const Http::LowerCaseString header_name_;
 };
 
 /**
@@ -132,6 +146,10 @@ public:
   // Computes scope key for given headers, returns nullptr if a key can't be computed.
   virtual std::unique_ptr<ScopeKey> computeScopeKey(const Http::HeaderMap& headers) const PURE;
 
+  // Computes the hash of the scope key for given headers without building the key, returns
+  // absl::nullopt if a key can't be computed.
+  virtual absl::optional<uint64_t> computeScopeKeyHash(const Http::HeaderMap& headers) const PURE;
+
 protected:
   const ScopedRoutes::ScopeKeyBuilder config_;
 };
@@ -141,6 +159,7 @@ public:
   explicit ScopeKeyBuilderImpl(ScopedRoutes::ScopeKeyBuilder&& config);
 
   std::unique_ptr<ScopeKey> computeScopeKey(const Http::HeaderMap& headers) const override;
+  absl::optional<uint64_t> computeScopeKeyHash(const Http::HeaderMap& headers) const override;
 
 private:
   std::vector<std::unique_ptr<FragmentBuilderBase>> fragment_builders_;
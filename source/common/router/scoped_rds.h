@@ -167,9 +167,9 @@ private:
         .name();
   }
   static std::string loadTypeUrl(envoy::config::core::v3alpha::ApiVersion resource_api_version);
-  // Propagate RDS updates to ScopeConfigImpl in workers.
-  void onRdsConfigUpdate(const std::string& scope_name,
-                         RdsRouteConfigSubscription& rds_subscription);
+  // Propagate RDS updates to ScopeConfigImpl in workers. The route config is the one built by the
+  // RDS provider, shared by all the scopes using the same route configuration.
+  void onRdsConfigUpdate(const std::string& scope_name, ConfigConstSharedPtr route_config);
 
   // ScopedRouteInfo by scope name.
   ScopedRouteMap scoped_route_map_;
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "common/common/assert.h"
+#include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 
 #include "absl/strings/str_join.h"
@@ -11,6 +12,74 @@
 namespace Envoy {
 namespace Router {
 
+namespace {
+
+// Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
+void setShadowHost(Http::HeaderMap& headers) {
+  ASSERT(!headers.Host()->value().empty());
+  auto parts = StringUtil::splitToken(headers.Host()->value().getStringView(), ":");
+  ASSERT(!parts.empty() && parts.size() <= 2);
+  headers.setHost(parts.size() == 2
+                      ? absl::StrJoin(parts, "-shadow:")
+                      : absl::StrCat(headers.Host()->value().getStringView(), "-shadow"));
+}
+
+} // namespace
+
+bool ShadowStreamImpl::start(Http::AsyncClient& client, std::chrono::milliseconds timeout) {
+  stream_ = client.start(*this, Http::AsyncClient::StreamOptions().setTimeout(timeout));
+  if (stream_ != nullptr) {
+    stream_->sendHeaders(*headers_, false);
+  }
+  return stream_ != nullptr;
+}
+
+bool ShadowStreamImpl::sendData(Buffer::Instance& data, bool end_stream) {
+  if (stream_ == nullptr || reset_) {
+    return false;
+  }
+  // A shadow upstream slower than the primary one would have the data pile up in its connection,
+  // so it is abandoned instead.
+  const uint64_t length = data.length();
+  if (stream_->isAboveWriteBufferHighWatermark() || !budget_->charge(length)) {
+    stream_->reset();
+    return false;
+  }
+  charged_bytes_ += length;
+  end_stream_sent_ = end_stream;
+  stream_->sendData(data, end_stream);
+  return !reset_;
+}
+
+bool ShadowStreamImpl::sendTrailers(const Http::HeaderMap& trailers) {
+  if (stream_ == nullptr || reset_) {
+    return false;
+  }
+  trailers_ = std::make_unique<Http::HeaderMapImpl>(trailers);
+  end_stream_sent_ = true;
+  stream_->sendTrailers(*trailers_);
+  return !reset_;
+}
+
+void ShadowStreamImpl::release() {
+  released_ = true;
+  if (stream_ == nullptr) {
+    delete this;
+  } else if (!end_stream_sent_) {
+    // The shadow request cannot be completed. This deletes the stream through onReset().
+    stream_->reset();
+  }
+}
+
+void ShadowStreamImpl::onStreamDone() {
+  stream_ = nullptr;
+  budget_->release(charged_bytes_);
+  charged_bytes_ = 0;
+  if (released_) {
+    delete this;
+  }
+}
+
 void ShadowWriterImpl::shadow(const std::string& cluster, Http::MessagePtr&& request,
                               std::chrono::milliseconds timeout) {
   // It's possible that the cluster specified in the route configuration no longer exists due
@@ -21,18 +90,27 @@ void ShadowWriterImpl::shadow(const std::string& cluster, Http::MessagePtr&& req
     return;
   }
 
-  ASSERT(!request->headers().Host()->value().empty());
-  // Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
-  auto parts = StringUtil::splitToken(request->headers().Host()->value().getStringView(), ":");
-  ASSERT(!parts.empty() && parts.size() <= 2);
-  request->headers().setHost(
-      parts.size() == 2
-          ? absl::StrJoin(parts, "-shadow:")
-          : absl::StrCat(request->headers().Host()->value().getStringView(), "-shadow"));
+  setShadowHost(request->headers());
   // This is basically fire and forget. We don't handle cancelling.
   cm_.httpAsyncClientForCluster(cluster).send(
       std::move(request), *this, Http::AsyncClient::RequestOptions().setTimeout(timeout));
 }
 
+ShadowStream* ShadowWriterImpl::streamingShadow(const std::string& cluster,
+                                                Http::HeaderMapPtr&& headers,
+                                                std::chrono::milliseconds timeout) {
+  if (!cm_.get(cluster)) {
+    ENVOY_LOG(debug, "shadow cluster '{}' does not exist", cluster);
+    return nullptr;
+  }
+
+  setShadowHost(*headers);
+  auto stream = std::make_unique<ShadowStreamImpl>(stream_budget_, std::move(headers));
+  if (!stream->start(cm_.httpAsyncClientForCluster(cluster), timeout)) {
+    return nullptr;
+  }
+  return stream.release();
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -1,14 +1,93 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <string>
 
+#include "envoy/http/async_client.h"
 #include "envoy/router/shadow_writer.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/logger.h"
+
 namespace Envoy {
 namespace Router {
 
+/**
+ * Bounds the body bytes sent to the streamed shadows whose response has not been received yet.
+ * It is shared by the workers, and by the shadow streams, which can outlive the shadow writer.
+ */
+class ShadowStreamBudget {
+public:
+  ShadowStreamBudget(uint64_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /**
+   * @return bool whether the bytes fit in the budget, in which case they are charged.
+   */
+  bool charge(uint64_t bytes) {
+    if (bytes_.fetch_add(bytes) + bytes > max_bytes_) {
+      bytes_.fetch_sub(bytes);
+      return false;
+    }
+    return true;
+  }
+
+  void release(uint64_t bytes) { bytes_.fetch_sub(bytes); }
+
+  uint64_t bytes() const { return bytes_.load(); }
+
+private:
+  const uint64_t max_bytes_;
+  std::atomic<uint64_t> bytes_{};
+};
+
+using ShadowStreamBudgetSharedPtr = std::shared_ptr<ShadowStreamBudget>;
+
+/**
+ * A streamed shadow on an async client stream, whose response is ignored. It deletes itself once
+ * both released by the router and done with its stream.
+ */
+class ShadowStreamImpl : public ShadowStream, public Http::AsyncClient::StreamCallbacks {
+public:
+  ShadowStreamImpl(ShadowStreamBudgetSharedPtr budget, Http::HeaderMapPtr&& headers)
+      : budget_(std::move(budget)), headers_(std::move(headers)) {}
+
+  /**
+   * Start the stream and send the headers.
+   * @return bool whether the stream is still open.
+   */
+  bool start(Http::AsyncClient& client, std::chrono::milliseconds timeout);
+
+  // Router::ShadowStream
+  bool sendData(Buffer::Instance& data, bool end_stream) override;
+  bool sendTrailers(const Http::HeaderMap& trailers) override;
+  void release() override;
+
+  // Http::AsyncClient::StreamCallbacks
+  void onHeaders(Http::HeaderMapPtr&&, bool) override {}
+  void onData(Buffer::Instance&, bool) override {}
+  void onTrailers(Http::HeaderMapPtr&&) override {}
+  void onComplete() override { onStreamDone(); }
+  void onReset() override {
+    reset_ = true;
+    onStreamDone();
+  }
+
+private:
+  void onStreamDone();
+
+  const ShadowStreamBudgetSharedPtr budget_;
+  // The stream takes the headers and trailers by reference, so they are kept until it is done.
+  const Http::HeaderMapPtr headers_;
+  Http::HeaderMapPtr trailers_;
+  Http::AsyncClient::Stream* stream_{};
+  uint64_t charged_bytes_{};
+  bool end_stream_sent_{};
+  bool reset_{};
+  bool released_{};
+};
+
 /**
  * Implementation of ShadowWriter that takes incoming requests to shadow and implements "fire and
  * forget" behavior using an async client.
@@ -17,11 +96,17 @@ class ShadowWriterImpl : Logger::Loggable<Logger::Id::router>,
                          public ShadowWriter,
                          public Http::AsyncClient::Callbacks {
 public:
-  ShadowWriterImpl(Upstream::ClusterManager& cm) : cm_(cm) {}
+  /**
+   * @param stream_budget_bytes supplies the budget of the streamed shadows.
+   */
+  ShadowWriterImpl(Upstream::ClusterManager& cm, uint64_t stream_budget_bytes = 0)
+      : cm_(cm), stream_budget_(std::make_shared<ShadowStreamBudget>(stream_budget_bytes)) {}
 
   // Router::ShadowWriter
   void shadow(const std::string& cluster, Http::MessagePtr&& request,
               std::chrono::milliseconds timeout) override;
+  ShadowStream* streamingShadow(const std::string& cluster, Http::HeaderMapPtr&& headers,
+                                std::chrono::milliseconds timeout) override;
 
   // Http::AsyncClient::Callbacks
   void onSuccess(Http::MessagePtr&&) override {}
@@ -29,6 +114,7 @@ public:
 
 private:
   Upstream::ClusterManager& cm_;
+  const ShadowStreamBudgetSharedPtr stream_budget_;
 };
 
 } // namespace Router
@@ -32,6 +32,12 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.strict_authority_validation",
     "envoy.reloadable_features.reject_unsupported_transfer_encodings",
     "envoy.reloadable_features.strict_method_validation",
+    "envoy.reloadable_features.indexed_route_matching",
+    "envoy.reloadable_features.stop_on_partial_write",
+    "envoy.reloadable_features.adaptive_read_size",
+    "envoy.reloadable_features.tcp_proxy_lazy_idle_timer",
+    "envoy.reloadable_features.tls_unlinearized_write",
+    "envoy.reloadable_features.listener_in_place_filterchain_update",
 };
 
 // This is a section for officially sanctioned runtime features which are too
@@ -47,6 +53,8 @@ constexpr const char* disabled_runtime_features[] = {
     "envoy.reloadable_features.test_feature_false",
     // Should be removed as part of https://github.com/envoyproxy/envoy/issues/8993
     "envoy.reloadable_features.http2_protocol_options.stream_error_on_invalid_http_messaging",
+    // Opt-in, as stats that were never written to are left out of admin output and sinks.
+    "envoy.reloadable_features.lazy_cluster_stats",
 };
 
 RuntimeFeatures::RuntimeFeatures() {
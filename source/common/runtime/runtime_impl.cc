@@ -1,5 +1,6 @@
 #include "common/runtime/runtime_impl.h"
 
+#include <atomic>
 #include <cstdint>
 #include <random>
 #include <string>
@@ -51,6 +52,12 @@ bool isRuntimeFeature(absl::string_view feature) {
          RuntimeFeaturesDefaults::get().existsButDisabled(feature);
 }
 
+// @return uint64_t the generation of a new snapshot, starting at 1 since 0 stands for none.
+uint64_t nextGeneration() {
+  static std::atomic<uint64_t> next_generation{1};
+  return next_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
 } // namespace
 
 bool runtimeFeatureEnabled(absl::string_view feature) {
@@ -229,8 +236,16 @@ bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value) const {
+  return percentEnabled(getInteger(key, default_value));
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key, uint64_t default_value) const {
+  return percentEnabled(getInteger(key, default_value));
+}
+
+bool SnapshotImpl::percentEnabled(uint64_t percent) const {
   // Avoid PRNG if we know we don't need it.
-  uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
+  uint64_t cutoff = std::min(percent, static_cast<uint64_t>(100));
   if (cutoff == 0) {
     return false;
   } else if (cutoff == 100) {
@@ -297,6 +312,25 @@ uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value
   }
 }
 
+uint64_t SnapshotImpl::getInteger(const Key& key, uint64_t default_value) const {
+  ASSERT(isLegacyFeature(key.name()) || !isRuntimeFeature(key.name()));
+  const Entry* entry = findEntry(key);
+  if (entry == nullptr || !entry->uint_value_) {
+    return default_value;
+  } else {
+    return entry->uint_value_.value();
+  }
+}
+
+const Snapshot::Entry* SnapshotImpl::findEntry(const Key& key) const {
+  if (key.index() < key_entries_.size()) {
+    return key_entries_[key.index()];
+  }
+  // The key was registered after the snapshot was built.
+  auto entry = values_.find(key.name());
+  return entry == values_.end() ? nullptr : &entry->second;
+}
+
 double SnapshotImpl::getDouble(const std::string& key, double default_value) const {
   ASSERT(!isRuntimeFeature(key)); // Make sure runtime guarding is only used for getBoolean
   auto entry = values_.find(key);
@@ -316,19 +350,26 @@ bool SnapshotImpl::getBoolean(absl::string_view key, bool default_value) const {
   }
 }
 
-const std::vector<Snapshot::OverrideLayerConstPtr>& SnapshotImpl::getLayers() const {
+const std::vector<Snapshot::OverrideLayerConstSharedPtr>& SnapshotImpl::getLayers() const {
   return layers_;
 }
 
 SnapshotImpl::SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
-                           std::vector<OverrideLayerConstPtr>&& layers)
-    : layers_{std::move(layers)}, generator_{generator}, stats_{stats} {
+                           std::vector<OverrideLayerConstSharedPtr>&& layers)
+    : layers_{std::move(layers)}, generator_{generator}, stats_{stats},
+      generation_{nextGeneration()} {
   for (const auto& layer : layers_) {
     for (const auto& kv : layer->values()) {
       values_.erase(kv.first);
       values_.emplace(kv.first, kv.second);
     }
   }
+  const std::vector<std::string> key_names = Key::registeredNames();
+  key_entries_.reserve(key_names.size());
+  for (const auto& name : key_names) {
+    auto entry = values_.find(name);
+    key_entries_.push_back(entry == values_.end() ? nullptr : &entry->second);
+  }
   stats.num_keys_.set(values_.size());
 }
 
@@ -399,13 +440,14 @@ void AdminLayer::mergeValues(const std::unordered_map<std::string, std::string>&
   stats_.admin_overrides_active_.set(values_.empty() ? 0 : 1);
 }
 
-DiskLayer::DiskLayer(absl::string_view name, const std::string& path, Api::Api& api)
+DiskLayer::DiskLayer(absl::string_view name, const std::string& path, Api::Api& api,
+                     const Snapshot::OverrideLayer* previous)
     : OverrideLayerImpl{name} {
-  walkDirectory(path, "", 1, api);
+  walkDirectory(path, "", 1, api, previous != nullptr ? &previous->values() : nullptr);
 }
 
 void DiskLayer::walkDirectory(const std::string& path, const std::string& prefix, uint32_t depth,
-                              Api::Api& api) {
+                              Api::Api& api, const Snapshot::EntryMap* previous_values) {
   // Maximum recursion depth for walkDirectory().
   static constexpr uint32_t MaxWalkDepth = 16;
 
@@ -430,7 +472,7 @@ void DiskLayer::walkDirectory(const std::string& path, const std::string& prefix
 
     if (entry.type_ == Filesystem::FileType::Directory && entry.name_ != "." &&
         entry.name_ != "..") {
-      walkDirectory(full_path, full_prefix, depth + 1, api);
+      walkDirectory(full_path, full_prefix, depth + 1, api, previous_values);
     } else if (entry.type_ == Filesystem::FileType::Regular) {
       // Suck the file into a string. This is not very efficient but it should be good enough
       // for small files. Also, as noted elsewhere, none of this is non-blocking which could
@@ -456,6 +498,16 @@ void DiskLayer::walkDirectory(const std::string& path, const std::string& prefix
       // Separate erase/insert calls required due to the value type being constant; this prevents
       // the use of the [] operator. Can leverage insert_or_assign in C++17 in the future.
       values_.erase(full_prefix);
+      // Parsing the value may take a YAML parse, which is skipped for the values which have not
+      // changed since the previous load.
+      if (previous_values != nullptr) {
+        const auto previous_entry = previous_values->find(full_prefix);
+        if (previous_entry != previous_values->end() &&
+            previous_entry->second.raw_string_value_ == value) {
+          values_.insert(*previous_entry);
+          continue;
+        }
+      }
       values_.insert({full_prefix, SnapshotImpl::createEntry(value)});
     }
   }
@@ -528,7 +580,7 @@ LoaderImpl::LoaderImpl(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator
         watcher_ = dispatcher.createFilesystemWatcher();
       }
       watcher_->addWatch(layer.disk_layer().symlink_root(), Filesystem::Watcher::Events::MovedTo,
-                         [this](uint32_t) -> void { loadNewSnapshot(); });
+                         [this](uint32_t) -> void { loadNewSnapshot(LayerType::kDiskLayer); });
       break;
     case envoy::config::bootstrap::v3alpha::RuntimeLayer::LayerSpecifierCase::kRtdsLayer:
       subscriptions_.emplace_back(
@@ -540,7 +592,8 @@ LoaderImpl::LoaderImpl(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator
     }
   }
 
-  loadNewSnapshot();
+  layers_.resize(config_.layers_size());
+  loadNewSnapshot(absl::nullopt);
 }
 
 void LoaderImpl::initialize(Upstream::ClusterManager& cm) { cm_ = &cm; }
@@ -565,7 +618,7 @@ void RtdsSubscription::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufW
   }
   ENVOY_LOG(debug, "Reloading RTDS snapshot for onConfigUpdate");
   proto_.CopyFrom(runtime.layer());
-  parent_.loadNewSnapshot();
+  parent_.loadNewSnapshot(LoaderImpl::LayerType::kRtdsLayer);
   init_target_.ready();
 }
 
@@ -619,7 +672,8 @@ RtdsSubscription::loadTypeUrl(envoy::config::core::v3alpha::ApiVersion resource_
   }
 }
 
-void LoaderImpl::loadNewSnapshot() {
+void LoaderImpl::loadNewSnapshot(absl::optional<LayerType> reloaded_layers) {
+  loadLayers(reloaded_layers);
   std::shared_ptr<SnapshotImpl> ptr = createNewSnapshot();
   tls_->set([ptr](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::static_pointer_cast<ThreadLocal::ThreadLocalObject>(ptr);
@@ -652,7 +706,7 @@ void LoaderImpl::mergeValues(const std::unordered_map<std::string, std::string>&
     throw EnvoyException("No admin layer specified");
   }
   admin_layer_->mergeValues(values);
-  loadNewSnapshot();
+  loadNewSnapshot(LayerType::kAdminLayer);
 }
 
 RuntimeStats LoaderImpl::generateStats(Stats::Store& store) {
@@ -662,55 +716,73 @@ RuntimeStats LoaderImpl::generateStats(Stats::Store& store) {
   return stats;
 }
 
-std::unique_ptr<SnapshotImpl> LoaderImpl::createNewSnapshot() {
-  std::vector<Snapshot::OverrideLayerConstPtr> layers;
-  uint32_t disk_layers = 0;
-  uint32_t error_layers = 0;
+void LoaderImpl::loadLayers(absl::optional<LayerType> type) {
+  if (!type.has_value() || type.value() == LayerType::kDiskLayer) {
+    disk_layers_ = 0;
+    error_layers_ = 0;
+  }
   uint32_t rtds_layer = 0;
-  for (const auto& layer : config_.layers()) {
-    switch (layer.layer_specifier_case()) {
-    case envoy::config::bootstrap::v3alpha::RuntimeLayer::LayerSpecifierCase::kStaticLayer:
-      layers.emplace_back(std::make_unique<const ProtoLayer>(layer.name(), layer.static_layer()));
+  for (int i = 0; i < config_.layers_size(); ++i) {
+    const auto& layer = config_.layers(i);
+    const LayerType layer_type = layer.layer_specifier_case();
+    if (type.has_value() && type.value() != layer_type) {
+      // The RTDS layers which are skipped still count to find the subscription of the next ones.
+      rtds_layer += layer_type == LayerType::kRtdsLayer ? 1 : 0;
+      continue;
+    }
+    switch (layer_type) {
+    case LayerType::kStaticLayer:
+      layers_[i] = std::make_shared<const ProtoLayer>(layer.name(), layer.static_layer());
       break;
-    case envoy::config::bootstrap::v3alpha::RuntimeLayer::LayerSpecifierCase::kDiskLayer: {
+    case LayerType::kDiskLayer: {
       std::string path =
           layer.disk_layer().symlink_root() + "/" + layer.disk_layer().subdirectory();
       if (layer.disk_layer().append_service_cluster()) {
         path += "/" + service_cluster_;
       }
+      Snapshot::OverrideLayerConstSharedPtr previous = std::move(layers_[i]);
       if (api_.fileSystem().directoryExists(path)) {
         try {
-          layers.emplace_back(std::make_unique<DiskLayer>(layer.name(), path, api_));
-          ++disk_layers;
+          layers_[i] = std::make_shared<DiskLayer>(layer.name(), path, api_, previous.get());
+          ++disk_layers_;
         } catch (EnvoyException& e) {
           // TODO(htuch): Consider latching here, rather than ignoring the
           // layer. This would be consistent with filesystem RTDS.
-          ++error_layers;
+          ++error_layers_;
           ENVOY_LOG(debug, "error loading runtime values for layer {} from disk: {}",
                     layer.DebugString(), e.what());
         }
       }
       break;
     }
-    case envoy::config::bootstrap::v3alpha::RuntimeLayer::LayerSpecifierCase::kAdminLayer:
-      layers.push_back(std::make_unique<AdminLayer>(*admin_layer_));
+    case LayerType::kAdminLayer:
+      layers_[i] = std::make_shared<AdminLayer>(*admin_layer_);
       break;
-    case envoy::config::bootstrap::v3alpha::RuntimeLayer::LayerSpecifierCase::kRtdsLayer: {
-      auto* subscription = subscriptions_[rtds_layer++].get();
-      layers.emplace_back(std::make_unique<const ProtoLayer>(layer.name(), subscription->proto_));
+    case LayerType::kRtdsLayer: {
+      const auto* subscription = subscriptions_[rtds_layer++].get();
+      layers_[i] = std::make_shared<const ProtoLayer>(layer.name(), subscription->proto_);
       break;
     }
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
   }
+}
+
+std::unique_ptr<SnapshotImpl> LoaderImpl::createNewSnapshot() {
+  std::vector<Snapshot::OverrideLayerConstSharedPtr> layers;
+  for (const auto& layer : layers_) {
+    if (layer != nullptr) {
+      layers.push_back(layer);
+    }
+  }
   stats_.num_layers_.set(layers.size());
-  if (error_layers == 0) {
+  if (error_layers_ == 0) {
     stats_.load_success_.inc();
   } else {
     stats_.load_error_.inc();
   }
-  if (disk_layers > 1) {
+  if (disk_layers_ > 1) {
     stats_.override_dir_exists_.inc();
   } else {
     stats_.override_dir_not_exists_.inc();
@@ -78,7 +78,7 @@ class SnapshotImpl : public Snapshot,
                      Logger::Loggable<Logger::Id::runtime> {
 public:
   SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
-               std::vector<OverrideLayerConstPtr>&& layers);
+               std::vector<OverrideLayerConstSharedPtr>&& layers);
 
   // Runtime::Snapshot
   bool deprecatedFeatureEnabled(const std::string& key, bool default_value) const override;
@@ -86,6 +86,7 @@ public:
   bool featureEnabled(const std::string& key, uint64_t default_value, uint64_t random_value,
                       uint64_t num_buckets) const override;
   bool featureEnabled(const std::string& key, uint64_t default_value) const override;
+  bool featureEnabled(const Key& key, uint64_t default_value) const override;
   bool featureEnabled(const std::string& key, uint64_t default_value,
                       uint64_t random_value) const override;
   bool featureEnabled(const std::string& key,
@@ -95,10 +96,12 @@ public:
                       uint64_t random_value) const override;
   const std::string& get(const std::string& key) const override;
   uint64_t getInteger(const std::string& key, uint64_t default_value) const override;
+  uint64_t getInteger(const Key& key, uint64_t default_value) const override;
   double getDouble(const std::string& key, double default_value) const override;
   bool getBoolean(absl::string_view key, bool value) const override;
-  const std::vector<OverrideLayerConstPtr>& getLayers() const override;
+  const std::vector<OverrideLayerConstSharedPtr>& getLayers() const override;
   bool exists(const std::string& key) const override { return values_.contains(key); }
+  uint64_t generation() const override { return generation_; }
 
   static Entry createEntry(const std::string& value);
   static Entry createEntry(const ProtobufWkt::Value& value);
@@ -125,10 +128,18 @@ private:
   static bool parseEntryDoubleValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
-  const std::vector<OverrideLayerConstPtr> layers_;
+  // @return the entry of a registered key, or nullptr if the key has no value.
+  const Entry* findEntry(const Key& key) const;
+  // @return whether a feature of the given percentage is enabled, using the built in generator.
+  bool percentEnabled(uint64_t percent) const;
+
+  const std::vector<OverrideLayerConstSharedPtr> layers_;
   EntryMap values_;
+  // The entries of the keys registered when the snapshot was built, by key index.
+  std::vector<const Entry*> key_entries_;
   RandomGenerator& generator_;
   RuntimeStats& stats_;
+  const uint64_t generation_;
 };
 
 /**
@@ -178,11 +189,17 @@ using AdminLayerPtr = std::unique_ptr<AdminLayer>;
  */
 class DiskLayer : public OverrideLayerImpl, Logger::Loggable<Logger::Id::runtime> {
 public:
-  DiskLayer(absl::string_view name, const std::string& path, Api::Api& api);
+  /**
+   * @param previous supplies the layer previously loaded from the same directory, if any. The
+   *        entries of the keys whose file still holds the same value are copied from it rather than
+   *        parsed again.
+   */
+  DiskLayer(absl::string_view name, const std::string& path, Api::Api& api,
+            const Snapshot::OverrideLayer* previous = nullptr);
 
 private:
   void walkDirectory(const std::string& path, const std::string& prefix, uint32_t depth,
-                     Api::Api& api);
+                     Api::Api& api, const Snapshot::EntryMap* previous_values);
 
   const std::string path_;
   const Filesystem::WatcherPtr watcher_;
@@ -260,10 +277,15 @@ public:
 private:
   friend RtdsSubscription;
 
-  // Create a new Snapshot
+  using LayerType = envoy::config::bootstrap::v3alpha::RuntimeLayer::LayerSpecifierCase;
+
+  // Reload the layers of the given type, or all the layers if no type is given. The other layers
+  // are kept as last loaded, to be shared with the previous snapshots.
+  void loadLayers(absl::optional<LayerType> type);
+  // Create a new Snapshot from the layers last loaded.
   virtual std::unique_ptr<SnapshotImpl> createNewSnapshot();
-  // Load a new Snapshot into TLS
-  void loadNewSnapshot();
+  // Reload the layers of the given type, or all the layers, and load a new Snapshot into TLS.
+  void loadNewSnapshot(absl::optional<LayerType> reloaded_layers);
   RuntimeStats generateStats(Stats::Store& store);
 
   RandomGenerator& generator_;
@@ -276,6 +298,12 @@ private:
   Api::Api& api_;
   std::vector<RtdsSubscriptionPtr> subscriptions_;
   Upstream::ClusterManager* cm_{};
+  // The layers last loaded, in the order of config_. The disk layers whose directory does not exist
+  // or failed to load are null.
+  std::vector<Snapshot::OverrideLayerConstSharedPtr> layers_;
+  // The disk layers loaded and the disk layers which failed to load, on their last load.
+  uint32_t disk_layers_{};
+  uint32_t error_layers_{};
 
   absl::Mutex snapshot_mutex_;
   std::shared_ptr<const Snapshot> thread_safe_snapshot_ ABSL_GUARDED_BY(snapshot_mutex_);
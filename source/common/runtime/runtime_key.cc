@@ -0,0 +1,52 @@
+#include <string>
+#include <vector>
+
+#include "envoy/runtime/runtime.h"
+
+#include "common/common/macros.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Runtime {
+
+namespace {
+
+// The names of the keys registered in the process, each given the next index the first time it is
+// registered.
+class KeyRegistry {
+public:
+  uint32_t add(const std::string& name) {
+    absl::MutexLock lock(&mutex_);
+    const auto it = indexes_.find(name);
+    if (it != indexes_.end()) {
+      return it->second;
+    }
+    const uint32_t index = names_.size();
+    names_.push_back(name);
+    indexes_.emplace(name, index);
+    return index;
+  }
+
+  std::vector<std::string> names() {
+    absl::MutexLock lock(&mutex_);
+    return names_;
+  }
+
+private:
+  absl::Mutex mutex_;
+  std::vector<std::string> names_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, uint32_t> indexes_ ABSL_GUARDED_BY(mutex_);
+};
+
+KeyRegistry& keyRegistry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(KeyRegistry); }
+
+} // namespace
+
+Key::Key(absl::string_view name) : name_(name), index_(keyRegistry().add(name_)) {}
+
+std::vector<std::string> Key::registeredNames() { return keyRegistry().names(); }
+
+} // namespace Runtime
+} // namespace Envoy
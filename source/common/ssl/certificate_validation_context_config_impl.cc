@@ -6,12 +6,16 @@
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Ssl {
 
 static const std::string INLINE_STRING = "<inline>";
 
+// The maximum number of chains whose verification is cached, unless configured otherwise.
+static constexpr uint32_t DefaultVerificationCacheMaxEntries = 1024;
+
 CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
     const envoy::extensions::transport_sockets::tls::v3alpha::CertificateValidationContext& config,
     Api::Api& api)
@@ -31,7 +35,10 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
                                     config.verify_certificate_hash().end()),
       verify_certificate_spki_list_(config.verify_certificate_spki().begin(),
                                     config.verify_certificate_spki().end()),
-      allow_expired_certificate_(config.allow_expired_certificate()) {
+      allow_expired_certificate_(config.allow_expired_certificate()),
+      verification_cache_ttl_(PROTOBUF_GET_OPTIONAL_MS(config, verification_cache_ttl)),
+      verification_cache_max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, verification_cache_max_entries, DefaultVerificationCacheMaxEntries)) {
   if (ca_cert_.empty()) {
     if (!certificate_revocation_list_.empty()) {
       throw EnvoyException(fmt::format("Failed to load CRL from {} without trusted CA",
@@ -44,6 +51,9 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
     if (allow_expired_certificate_) {
       throw EnvoyException("Certificate validity period is always ignored without trusted CA");
     }
+    if (verification_cache_ttl_.has_value()) {
+      throw EnvoyException("Certificate verifications are only cached with a trusted CA");
+    }
   }
 }
 
@@ -39,6 +39,12 @@ public:
     return verify_certificate_spki_list_;
   }
   bool allowExpiredCertificate() const override { return allow_expired_certificate_; }
+  absl::optional<std::chrono::milliseconds> verificationCacheTtl() const override {
+    return verification_cache_ttl_;
+  }
+  uint32_t verificationCacheMaxEntries() const override {
+    return verification_cache_max_entries_;
+  }
 
 private:
   const std::string ca_cert_;
@@ -50,6 +56,8 @@ private:
   const std::vector<std::string> verify_certificate_hash_list_;
   const std::vector<std::string> verify_certificate_spki_list_;
   const bool allow_expired_certificate_;
+  const absl::optional<std::chrono::milliseconds> verification_cache_ttl_;
+  const uint32_t verification_cache_max_entries_;
 };
 
 } // namespace Ssl
@@ -19,6 +19,7 @@
 #include "common/common/utility.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 
@@ -99,6 +100,14 @@ public:
   bool lessThan(const StatName& a, const StatName& b) const override {
     return toStringView(a) < toStringView(b);
   }
+  bool startsWith(const StatName& name, const StatName& prefix) const override {
+    const absl::string_view name_view = toStringView(name);
+    const absl::string_view prefix_view = toStringView(prefix);
+    // The prefix must end at a token boundary of the name.
+    return prefix_view.empty() ||
+           (absl::StartsWith(name_view, prefix_view) &&
+            (name_view.size() == prefix_view.size() || name_view[prefix_view.size()] == '.'));
+  }
   void free(const StatName&) override {}
   void incRefCount(const StatName&) override {}
   StoragePtr encode(absl::string_view name) override { return encodeHelper(name); }
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Base of the stats handed out by LazyStatPool. The underlying stat is only created in the scope
+ * the first time it is written to, so unused stats take no room in the store and are left out of
+ * sinks and admin output. Reads of a stat that was never created return zero.
+ */
+template <class BaseClass> class LazyMetricImpl : public BaseClass {
+public:
+  LazyMetricImpl(Scope& scope, const char* name) : scope_(scope), name_(name) {}
+
+  // Metric
+  std::string name() const override { return metric().name(); }
+  StatName statName() const override { return metric().statName(); }
+  std::vector<Tag> tags() const override { return metric().tags(); }
+  std::string tagExtractedName() const override { return metric().tagExtractedName(); }
+  StatName tagExtractedStatName() const override { return metric().tagExtractedStatName(); }
+  void iterateTagStatNames(const Metric::TagStatNameIterFn& fn) const override {
+    metric().iterateTagStatNames(fn);
+  }
+  bool used() const override {
+    const BaseClass* created = createdMetric();
+    return created != nullptr && created->used();
+  }
+  SymbolTable& symbolTable() override { return scope_.symbolTable(); }
+  const SymbolTable& constSymbolTable() const override { return scope_.constSymbolTable(); }
+
+  // RefcountInterface
+  // Lazy stats are owned by their pool, so references to them are not counted.
+  void incRefCount() override {}
+  bool decRefCount() override { return false; }
+  uint32_t use_count() const override { return 1; }
+
+protected:
+  /**
+   * @return the underlying stat if it was created, nullptr otherwise.
+   */
+  BaseClass* createdMetric() const { return metric_.load(std::memory_order_acquire); }
+
+  /**
+   * @return the underlying stat, creating it if needed.
+   */
+  BaseClass& metric() const {
+    BaseClass* metric = createdMetric();
+    if (metric == nullptr) {
+      // The scope is thread safe and returns the same stat for the same name, so concurrent
+      // creations all store the same pointer.
+      metric = &create();
+      metric_.store(metric, std::memory_order_release);
+    }
+    return *metric;
+  }
+
+  virtual BaseClass& create() const PURE;
+
+  Scope& scope_;
+  const char* const name_;
+
+private:
+  mutable std::atomic<BaseClass*> metric_{};
+};
+
+class LazyCounterImpl : public LazyMetricImpl<Counter> {
+public:
+  using LazyMetricImpl<Counter>::LazyMetricImpl;
+
+  // Stats::Counter
+  void add(uint64_t amount) override { metric().add(amount); }
+  void inc() override { metric().inc(); }
+  uint64_t latch() override {
+    Counter* created = createdMetric();
+    return created != nullptr ? created->latch() : 0;
+  }
+  void reset() override {
+    Counter* created = createdMetric();
+    if (created != nullptr) {
+      created->reset();
+    }
+  }
+  uint64_t value() const override {
+    const Counter* created = createdMetric();
+    return created != nullptr ? created->value() : 0;
+  }
+
+private:
+  Counter& create() const override { return scope_.counter(name_); }
+};
+
+class LazyGaugeImpl : public LazyMetricImpl<Gauge> {
+public:
+  LazyGaugeImpl(Scope& scope, const char* name, ImportMode import_mode)
+      : LazyMetricImpl<Gauge>(scope, name), import_mode_(import_mode) {}
+
+  // Stats::Gauge
+  void add(uint64_t amount) override { metric().add(amount); }
+  void dec() override { metric().dec(); }
+  void inc() override { metric().inc(); }
+  void set(uint64_t value) override {
+    // A gauge that was never created already reads as zero.
+    if (value == 0 && createdMetric() == nullptr) {
+      return;
+    }
+    metric().set(value);
+  }
+  void sub(uint64_t amount) override { metric().sub(amount); }
+  uint64_t value() const override {
+    const Gauge* created = createdMetric();
+    return created != nullptr ? created->value() : 0;
+  }
+  ImportMode importMode() const override {
+    const Gauge* created = createdMetric();
+    return created != nullptr ? created->importMode() : import_mode_;
+  }
+  void mergeImportMode(ImportMode import_mode) override { metric().mergeImportMode(import_mode); }
+
+private:
+  Gauge& create() const override { return scope_.gauge(name_, import_mode_); }
+
+  const ImportMode import_mode_;
+};
+
+class LazyHistogramImpl : public LazyMetricImpl<Histogram> {
+public:
+  LazyHistogramImpl(Scope& scope, const char* name, Unit unit)
+      : LazyMetricImpl<Histogram>(scope, name), unit_(unit) {}
+
+  // Stats::Histogram
+  Unit unit() const override { return unit_; }
+  void recordValue(uint64_t value) override { metric().recordValue(value); }
+
+private:
+  Histogram& create() const override { return scope_.histogram(name_, unit_); }
+
+  const Unit unit_;
+};
+
+/**
+ * Hands out stats that are only created in the given scope when first written to. This trades a
+ * little indirection on every write for not paying for stats that are never used, e.g. the traffic
+ * stats of clusters that see no traffic. The scope must be thread safe if the stats are written
+ * from several threads, and must outlive the pool.
+ *
+ * Names are not copied, so they must outlive the pool too. The LAZY_POOL_* macros pass string
+ * literals.
+ */
+class LazyStatPool {
+public:
+  explicit LazyStatPool(Scope& scope) : scope_(scope) {}
+
+  Counter& counter(const char* name) {
+    counters_.emplace_back(scope_, name);
+    return counters_.back();
+  }
+  Gauge& gauge(const char* name, Gauge::ImportMode import_mode) {
+    gauges_.emplace_back(scope_, name, import_mode);
+    return gauges_.back();
+  }
+  Histogram& histogram(const char* name, Histogram::Unit unit) {
+    histograms_.emplace_back(scope_, name, unit);
+    return histograms_.back();
+  }
+
+private:
+  Scope& scope_;
+  // Deques, as stats structs keep references to the elements.
+  std::deque<LazyCounterImpl> counters_;
+  std::deque<LazyGaugeImpl> gauges_;
+  std::deque<LazyHistogramImpl> histograms_;
+};
+
+} // namespace Stats
+
+/**
+ * Lazy counterparts of the POOL_* macros in stats_macros.h, taking a LazyStatPool.
+ */
+#define LAZY_STAT_DECL_(X) #X),
+#define LAZY_STAT_DECL_MODE_(X, MODE) #X, Envoy::Stats::Gauge::ImportMode::MODE),
+#define LAZY_STAT_DECL_UNIT_(X, UNIT) #X, Envoy::Stats::Histogram::Unit::UNIT),
+
+#define LAZY_POOL_COUNTER(POOL) (POOL).counter(LAZY_STAT_DECL_
+#define LAZY_POOL_GAUGE(POOL) (POOL).gauge(LAZY_STAT_DECL_MODE_
+#define LAZY_POOL_HISTOGRAM(POOL) (POOL).histogram(LAZY_STAT_DECL_UNIT_
+
+} // namespace Envoy
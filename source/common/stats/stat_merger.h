@@ -21,9 +21,11 @@ public:
   void mergeStats(const Protobuf::Map<std::string, uint64_t>& counter_deltas,
                   const Protobuf::Map<std::string, uint64_t>& gauges);
 
+  // Merge a single counter delta or gauge value, for sources of stats other than protobuf maps.
+  void mergeCounter(absl::string_view name, uint64_t delta);
+  void mergeGauge(absl::string_view name, uint64_t value);
+
 private:
-  void mergeCounters(const Protobuf::Map<std::string, uint64_t>& counter_deltas);
-  void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges);
   StatNameHashMap<uint64_t> parent_gauge_values_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
   // shared_ptrs to the stats that live in them, with the question of which stats are living in a
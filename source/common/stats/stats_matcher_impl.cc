@@ -12,7 +12,8 @@ namespace Stats {
 
 // TODO(ambuc): Refactor this into common/matchers.cc, since StatsMatcher is really just a thin
 // wrapper around what might be called a StringMatcherList.
-StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v3alpha::StatsConfig& config) {
+StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v3alpha::StatsConfig& config,
+                                   SymbolTable& symbol_table) {
   switch (config.stats_matcher().stats_matcher_case()) {
   case envoy::config::metrics::v3alpha::StatsMatcher::StatsMatcherCase::kRejectAll:
     // In this scenario, there are no matchers to store.
@@ -20,16 +21,12 @@ StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v3alpha::StatsC
     break;
   case envoy::config::metrics::v3alpha::StatsMatcher::StatsMatcherCase::kInclusionList:
     // If we have an inclusion list, we are being default-exclusive.
-    for (const auto& stats_matcher : config.stats_matcher().inclusion_list().patterns()) {
-      matchers_.push_back(Matchers::StringMatcherImpl(stats_matcher));
-    }
+    addMatchers(config.stats_matcher().inclusion_list().patterns(), symbol_table);
     is_inclusive_ = false;
     break;
   case envoy::config::metrics::v3alpha::StatsMatcher::StatsMatcherCase::kExclusionList:
     // If we have an exclusion list, we are being default-inclusive.
-    for (const auto& stats_matcher : config.stats_matcher().exclusion_list().patterns()) {
-      matchers_.push_back(Matchers::StringMatcherImpl(stats_matcher));
-    }
+    addMatchers(config.stats_matcher().exclusion_list().patterns(), symbol_table);
     FALLTHRU;
   default:
     // No matcher was supplied, so we default to inclusion.
@@ -38,6 +35,59 @@ StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v3alpha::StatsC
   }
 }
 
+void StatsMatcherImpl::addMatchers(
+    const Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher>& patterns,
+    SymbolTable& symbol_table) {
+  // token_matchers_ and string_matchers_ point into matchers_, which must not
+  // be resized afterwards.
+  for (const auto& stats_matcher : patterns) {
+    matchers_.push_back(Matchers::StringMatcherImpl(stats_matcher));
+  }
+  stat_name_pool_.emplace(symbol_table);
+
+  for (int i = 0; i < patterns.size(); ++i) {
+    const Matchers::StringMatcherImpl& matcher = matchers_[i];
+    switch (patterns[i].match_pattern_case()) {
+    case envoy::type::matcher::v3alpha::StringMatcher::MatchPatternCase::kExact:
+      if (addTokenMatcher(patterns[i].exact(), true, nullptr, symbol_table)) {
+        continue;
+      }
+      break;
+    case envoy::type::matcher::v3alpha::StringMatcher::MatchPatternCase::kPrefix: {
+      // A name matching "a.b." or "a.bc" starts with the token "a" and has more
+      // tokens. The rest of a prefix that doesn't end with a '.' must still be
+      // matched against the elaborated name.
+      const std::string& prefix = patterns[i].prefix();
+      const size_t last_dot = prefix.rfind('.');
+      if (last_dot != std::string::npos && last_dot > 0) {
+        const bool whole_tokens = last_dot == prefix.size() - 1;
+        if (addTokenMatcher(absl::string_view(prefix).substr(0, last_dot), false,
+                            whole_tokens ? nullptr : &matcher, symbol_table)) {
+          continue;
+        }
+      }
+      break;
+    }
+    default:
+      break;
+    }
+    string_matchers_.push_back(&matcher);
+  }
+}
+
+bool StatsMatcherImpl::addTokenMatcher(absl::string_view tokens, bool exact,
+                                       const Matchers::StringMatcherImpl* partial,
+                                       SymbolTable& symbol_table) {
+  const StatName stat_name = stat_name_pool_->add(tokens);
+  // Patterns that are not kept as-is by the encoding, such as those ending
+  // with a '.', can't be compared token by token.
+  if (symbol_table.toString(stat_name) != tokens) {
+    return false;
+  }
+  token_matchers_.push_back({stat_name, exact, partial});
+  return true;
+}
+
 bool StatsMatcherImpl::rejects(const std::string& name) const {
   //
   //  is_inclusive_ | match | return
@@ -53,5 +103,41 @@ bool StatsMatcherImpl::rejects(const std::string& name) const {
                                        [&name](auto& matcher) { return matcher.match(name); }));
 }
 
+bool StatsMatcherImpl::rejects(StatName name, const SymbolTable& symbol_table) const {
+  // The name is only elaborated if a pattern can't be decided by its tokens,
+  // which makes rejecting names by their prefix cheap.
+  std::string elaborated;
+  const auto elaborated_name = [&elaborated, name, &symbol_table]() -> const std::string& {
+    if (elaborated.empty()) {
+      elaborated = symbol_table.toString(name);
+    }
+    return elaborated;
+  };
+
+  bool match = false;
+  for (const TokenMatcher& token_matcher : token_matchers_) {
+    if (token_matcher.exact_) {
+      match = name == token_matcher.tokens_;
+    } else {
+      match = name.dataSize() > token_matcher.tokens_.dataSize() &&
+              symbol_table.startsWith(name, token_matcher.tokens_) &&
+              (token_matcher.partial_ == nullptr ||
+               token_matcher.partial_->match(elaborated_name()));
+    }
+    if (match) {
+      break;
+    }
+  }
+  if (!match) {
+    match = std::any_of(string_matchers_.begin(), string_matchers_.end(),
+                        [&elaborated_name](const Matchers::StringMatcherImpl* matcher) {
+                          return matcher->match(elaborated_name());
+                        });
+  }
+
+  // See rejects(const std::string&) for the truth table.
+  return is_inclusive_ == match;
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -7,8 +7,10 @@
 
 #include "common/common/matchers.h"
 #include "common/protobuf/protobuf.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Stats {
@@ -18,22 +20,53 @@ namespace Stats {
  */
 class StatsMatcherImpl : public StatsMatcher {
 public:
-  explicit StatsMatcherImpl(const envoy::config::metrics::v3alpha::StatsConfig& config);
+  // The exact and prefix patterns are encoded with symbol_table, which must be
+  // the one of the names passed to rejects(StatName, const SymbolTable&).
+  StatsMatcherImpl(const envoy::config::metrics::v3alpha::StatsConfig& config,
+                   SymbolTable& symbol_table);
 
   // Default constructor simply allows everything.
   StatsMatcherImpl() = default;
 
   // StatsMatcher
   bool rejects(const std::string& name) const override;
+  bool rejects(StatName name, const SymbolTable& symbol_table) const override;
   bool acceptsAll() const override { return is_inclusive_ && matchers_.empty(); }
   bool rejectsAll() const override { return !is_inclusive_ && matchers_.empty(); }
 
 private:
+  // A pattern tested against the tokens of a StatName.
+  struct TokenMatcher {
+    // The tokens of the pattern: all of them for an exact match, and the
+    // complete ones for a prefix match.
+    StatName tokens_;
+    // Whether the name must be made of exactly these tokens, rather than have
+    // more tokens after them.
+    bool exact_;
+    // The matcher of a prefix that ends within a token, which is only tested
+    // against the elaborated name once the complete tokens matched. Null when
+    // the tokens are enough to decide.
+    const Matchers::StringMatcherImpl* partial_;
+  };
+
+  void addMatchers(
+      const Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher>& patterns,
+      SymbolTable& symbol_table);
+  bool addTokenMatcher(absl::string_view tokens, bool exact,
+                       const Matchers::StringMatcherImpl* partial, SymbolTable& symbol_table);
+
   // Bool indicating whether or not the StatsMatcher is including or excluding stats by default. See
   // StatsMatcherImpl::rejects() for much more detail.
   bool is_inclusive_{true};
 
   std::vector<Matchers::StringMatcherImpl> matchers_;
+
+  // The matchers_ compiled for StatNames: exact and prefix patterns are tested
+  // against the tokens of the name, and the other ones against its elaborated
+  // string.
+  absl::optional<StatNamePool> stat_name_pool_;
+  std::vector<TokenMatcher> token_matchers_;
+  std::vector<const Matchers::StringMatcherImpl*> string_matchers_;
 };
 
 } // namespace Stats
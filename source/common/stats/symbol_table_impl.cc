@@ -145,10 +145,21 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // Names made of known tokens, which is the common case for the dynamic names
+  // created on workers, only need the shared lock to bump the ref-counts of
+  // their symbols. This is not possible when recent lookups are remembered, as
+  // recording them mutates recent_lookups_.
+  bool found = false;
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
+    found = recent_lookups_.capacity() == 0 && addExistingSymbols(tokens, symbols);
+  }
+  if (found) {
+    shared_lookups_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    // Now take the lock exclusively and populate the Symbol objects, which may
+    // involve adding new symbols.
+    absl::MutexLock lock(&lock_);
     recent_lookups_.lookup(name);
     for (auto& token : tokens) {
       symbols.push_back(toSymbol(token));
@@ -160,7 +171,7 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
 }
 
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -179,7 +190,7 @@ std::string SymbolTableImpl::decodeSymbolVec(const SymbolVec& symbols) const {
   name_tokens.reserve(symbols.size());
   {
     // Hold the lock only while decoding symbols.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     for (Symbol symbol : symbols) {
       name_tokens.push_back(fromSymbol(symbol));
     }
@@ -191,7 +202,9 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
+  // The caller holds a reference on each symbol, so none can be removed while
+  // the shared lock is held.
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
@@ -199,7 +212,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
     auto encode_search = encode_map_.find(decode_search->second->toStringView());
     ASSERT(encode_search != encode_map_.end());
 
-    ++encode_search->second.ref_count_;
+    encode_search->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -207,8 +220,23 @@ void SymbolTableImpl::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
+  // References that aren't the last ones are released with the shared lock.
+  // Only the symbols that may have to be removed take the exclusive lock.
+  SymbolVec last_references;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    for (Symbol symbol : symbols) {
+      if (!releaseSharedSymbol(symbol)) {
+        last_references.push_back(symbol);
+      }
+    }
+  }
+  if (last_references.empty()) {
+    return;
+  }
+
+  absl::MutexLock lock(&lock_);
+  for (Symbol symbol : last_references) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
 
@@ -248,12 +276,13 @@ uint64_t SymbolTableImpl::getRecentLookups(const RecentLookupsFn& iter) const {
   // We also don't want to hold lock_ while calling the iterator, but we need it
   // to access recent_lookups_.
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
     total += recent_lookups_.total();
   }
+  total += shared_lookups_.load(std::memory_order_relaxed);
 
   // Now we have the collated name-count map data: we need to vectorize and
   // sort. We define the pair with the count first as std::pair::operator<
@@ -280,7 +309,7 @@ void SymbolTableImpl::setRecentLookupCapacity(uint64_t capacity) {
   }
 
   {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&lock_);
     recent_lookups_.setCapacity(capacity);
   }
 }
@@ -293,13 +322,14 @@ void SymbolTableImpl::clearRecentLookups() {
     }
   }
   {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&lock_);
     recent_lookups_.clear();
+    shared_lookups_ = 0;
   }
 }
 
 uint64_t SymbolTableImpl::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   return recent_lookups_.capacity();
 }
 
@@ -347,12 +377,49 @@ Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
 }
 
+bool SymbolTableImpl::addExistingSymbols(const std::vector<absl::string_view>& tokens,
+                                         std::vector<Symbol>& symbols)
+    SHARED_LOCKS_REQUIRED(lock_) {
+  // Find all the tokens before taking any reference, so there is nothing to
+  // undo if one is missing. The map values can't move while the lock is held.
+  STACK_ARRAY(shared_symbols, SharedSymbol*, tokens.size());
+  for (uint64_t i = 0; i < tokens.size(); ++i) {
+    auto encode_find = encode_map_.find(tokens[i]);
+    if (encode_find == encode_map_.end()) {
+      return false;
+    }
+    shared_symbols[i] = &encode_find->second;
+  }
+  for (SharedSymbol* shared_symbol : shared_symbols) {
+    shared_symbol->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    symbols.push_back(shared_symbol->symbol_);
+  }
+  return true;
+}
+
+bool SymbolTableImpl::releaseSharedSymbol(Symbol symbol) SHARED_LOCKS_REQUIRED(lock_) {
+  auto decode_search = decode_map_.find(symbol);
+  ASSERT(decode_search != decode_map_.end());
+
+  auto encode_search = encode_map_.find(decode_search->second->toStringView());
+  ASSERT(encode_search != encode_map_.end());
+
+  std::atomic<uint32_t>& ref_count = encode_search->second.ref_count_;
+  uint32_t count = ref_count.load(std::memory_order_relaxed);
+  while (count > 1) {
+    if (ref_count.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void SymbolTableImpl::newSymbol() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
   if (pool_.empty()) {
     next_symbol_ = ++monotonic_counter_;
@@ -365,28 +432,46 @@ void SymbolTableImpl::newSymbol() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
 }
 
 bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
-  // Constructing two temp vectors during lessThan is not strictly necessary.
-  // If this becomes a performance bottleneck (e.g. during sorting), we could
-  // provide an iterator-like interface for incrementally decoding the symbols
-  // without allocating memory.
-  const SymbolVec av = Encoding::decodeSymbols(a.data(), a.dataSize());
-  const SymbolVec bv = Encoding::decodeSymbols(b.data(), b.dataSize());
+  // Symbols are self-delimiting, so if the encodings share a byte prefix they also share the
+  // symbols in it, and only the symbol holding the first differing byte needs to be decoded.
+  // This avoids decoding either name into a temp vector, which matters when sorting.
+  const uint8_t* a_data = a.data();
+  const uint8_t* b_data = b.data();
+  const uint64_t a_size = a.dataSize();
+  const uint64_t b_size = b.dataSize();
+  const uint64_t common_size = std::min(a_size, b_size);
+  const uint64_t mismatch = std::mismatch(a_data, a_data + common_size, b_data).first - a_data;
+  if (mismatch == common_size) {
+    // One name is a prefix of the other, symbol-wise.
+    return a_size < b_size;
+  }
+
+  // Back up to the first byte of the symbol holding the mismatch. All bytes of a symbol but
+  // the last have the spillover bit set.
+  uint64_t symbol_start = mismatch;
+  while (symbol_start > 0 && (a_data[symbol_start - 1] & SpilloverMask) != 0) {
+    --symbol_start;
+  }
+  const Symbol a_symbol = Encoding::decodeNumber(a_data + symbol_start).first;
+  const Symbol b_symbol = Encoding::decodeNumber(b_data + symbol_start).first;
 
   // Calling fromSymbol requires holding the lock, as it needs read-access to
   // the maps that are written when adding new symbols.
-  Thread::LockGuard lock(lock_);
-  for (uint64_t i = 0, n = std::min(av.size(), bv.size()); i < n; ++i) {
-    if (av[i] != bv[i]) {
-      bool ret = fromSymbol(av[i]) < fromSymbol(bv[i]);
-      return ret;
-    }
-  }
-  return av.size() < bv.size();
+  absl::ReaderMutexLock lock(&lock_);
+  return fromSymbol(a_symbol) < fromSymbol(b_symbol);
+}
+
+bool SymbolTableImpl::startsWith(const StatName& name, const StatName& prefix) const {
+  // Symbols are self-delimiting, so a byte prefix of the encoding is made of
+  // whole symbols, and thus of whole tokens.
+  const uint64_t prefix_size = prefix.dataSize();
+  return prefix_size <= name.dataSize() &&
+         std::equal(prefix.data(), prefix.data() + prefix_size, name.data());
 }
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -395,7 +480,8 @@ void SymbolTableImpl::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
@@ -577,7 +663,17 @@ StatName StatNameSet::getDynamic(absl::string_view token) {
   }
 
   {
-    // Other tokens require holding a lock for our local cache.
+    // Other tokens require holding a lock for our local cache. Tokens that were
+    // seen before only need it shared, so workers looking up the same dynamic
+    // names don't exclude each other.
+    absl::ReaderMutexLock lock(&mutex_);
+    const auto dynamic_iter = dynamic_stat_names_.find(token);
+    if (dynamic_iter != dynamic_stat_names_.end()) {
+      return dynamic_iter->second;
+    }
+  }
+
+  {
     absl::MutexLock lock(&mutex_);
     Stats::StatName& stat_name_ref = dynamic_stat_names_[token];
     if (stat_name_ref.empty()) { // Note that builtin_stat_names_ already has one for "".
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -164,6 +165,7 @@ public:
   std::string toString(const StatName& stat_name) const override;
   uint64_t numSymbols() const override;
   bool lessThan(const StatName& a, const StatName& b) const override;
+  bool startsWith(const StatName& name, const StatName& prefix) const override;
   void free(const StatName& stat_name) override;
   void incRefCount(const StatName& stat_name) override;
   StoragePtr join(const StatNameVec& stat_names) const override;
@@ -190,13 +192,22 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    // The maps only move their values when rehashing, with lock_ held exclusively.
+    SharedSymbol(SharedSymbol&& src) noexcept
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
 
     Symbol symbol_;
-    uint32_t ref_count_;
+    // Adjusted atomically when lock_ is held shared, but only ever drops to
+    // zero with lock_ held exclusively, so a symbol found in the maps with the
+    // shared lock stays there until that lock is released.
+    std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // This is held shared to look up existing symbols and adjust their
+  // ref-counts, and exclusively to add or remove symbols. Workers encoding
+  // names made of known tokens, and freeing references that aren't the last
+  // ones, thus don't exclude each other.
+  mutable absl::Mutex lock_;
 
   // This must be held while updating stat_name_sets_.
   mutable Thread::MutexBasicLockable stat_name_set_mutex_;
@@ -226,7 +237,27 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const SHARED_LOCKS_REQUIRED(lock_);
+
+  /**
+   * Finds the symbols of tokens that are all already in the table, and takes a
+   * reference on each of them. Nothing is referenced if any token is missing.
+   *
+   * @param tokens the tokens to look up.
+   * @param symbols receives the symbols of the tokens, if they are all found.
+   * @return bool whether all the tokens were found.
+   */
+  bool addExistingSymbols(const std::vector<absl::string_view>& tokens,
+                          std::vector<Symbol>& symbols) SHARED_LOCKS_REQUIRED(lock_);
+
+  /**
+   * Releases a reference on a symbol, unless it is the last one, which can only
+   * be released with the lock held exclusively.
+   *
+   * @param symbol the symbol to release.
+   * @return bool whether the reference was released.
+   */
+  bool releaseSharedSymbol(Symbol symbol) SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -243,7 +274,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -267,6 +298,10 @@ private:
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ GUARDED_BY(lock_);
   RecentLookups recent_lookups_ GUARDED_BY(lock_);
+  // Lookups of names whose tokens were all found with the shared lock, which
+  // isn't enough to update recent_lookups_. This only happens when recent
+  // lookups are not being remembered, so only their count is missing.
+  std::atomic<uint64_t> shared_lookups_{0};
 
   absl::flat_hash_set<StatNameSet*> stat_name_sets_ GUARDED_BY(stat_name_set_mutex_);
 };
@@ -714,11 +749,11 @@ public:
    * subsequent lookups of the same string to take only the set's lock, and not
    * the whole symbol-table lock.
    *
-   * @return a StatName corresponding to the passed-in token, owned by the set.
+   * Tokens already in dynamic_stat_names_ only take the set's lock shared, and
+   * creating a StatName made of existing symbols only takes the symbol-table
+   * lock shared, so lookups from concurrent workers rarely exclude each other.
    *
-   * TODO(jmarantz): Potential perf issue here with contention, both on this
-   * set's mutex and also the SymbolTable mutex which must be taken during
-   * StatNamePool::add().
+   * @return a StatName corresponding to the passed-in token, owned by the set.
    */
   StatName getDynamic(absl::string_view token);
 
@@ -1,16 +1,19 @@
 #include "common/stats/tag_extractor_impl.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 
 #include "envoy/common/exception.h"
 
+#include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/perf_annotation.h"
 #include "common/common/regex.h"
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Stats {
@@ -21,6 +24,14 @@ bool regexStartsWithDot(absl::string_view regex) {
   return absl::StartsWith(regex, "\\.") || absl::StartsWith(regex, "(?=\\.)");
 }
 
+constexpr absl::string_view ValueToken = "$";
+constexpr absl::string_view AnyToken = "*";
+constexpr absl::string_view AnyTokens = "**";
+
+bool isWildcardToken(absl::string_view token) {
+  return token == ValueToken || token == AnyToken || token == AnyTokens;
+}
+
 } // namespace
 
 TagExtractorImpl::TagExtractorImpl(const std::string& name, const std::string& regex,
@@ -105,5 +116,64 @@ bool TagExtractorImpl::extractTag(absl::string_view stat_name, std::vector<Tag>&
   return false;
 }
 
+TagExtractorTokensImpl::TagExtractorTokensImpl(const std::string& name,
+                                               const std::string& pattern)
+    : name_(name), tokens_(absl::StrSplit(pattern, '.')),
+      prefix_(isWildcardToken(tokens_[0]) ? "" : tokens_[0]) {
+  ASSERT(std::count(tokens_.begin(), tokens_.end(), ValueToken) == 1);
+  ASSERT(tokens_.back() != ValueToken);
+  ASSERT(std::find(tokens_.begin(), tokens_.end() - 1, AnyTokens) == tokens_.end() - 1);
+}
+
+bool TagExtractorTokensImpl::extractTag(absl::string_view stat_name, std::vector<Tag>& tags,
+                                        IntervalSet<size_t>& remove_characters) const {
+  PERF_OPERATION(perf);
+
+  // Walks the tokens of the name along with the pattern, without splitting the name up front.
+  absl::string_view remaining = stat_name;
+  bool has_token = true;
+  absl::string_view value;
+  for (const std::string& pattern_token : tokens_) {
+    if (!has_token) {
+      PERF_RECORD(perf, "tokens-miss", name_);
+      return false;
+    }
+    if (pattern_token == AnyTokens) {
+      // Matches the rest of the name, which has at least one token.
+      has_token = false;
+      break;
+    }
+    const absl::string_view::size_type dot = remaining.find('.');
+    const absl::string_view token = remaining.substr(0, dot);
+    if (pattern_token == ValueToken) {
+      value = token;
+    } else if (pattern_token != AnyToken && pattern_token != token) {
+      PERF_RECORD(perf, "tokens-miss", name_);
+      return false;
+    }
+    if (dot == absl::string_view::npos) {
+      has_token = false;
+    } else {
+      remaining.remove_prefix(dot + 1);
+    }
+  }
+  if (has_token) {
+    // The name has more tokens than the pattern.
+    PERF_RECORD(perf, "tokens-miss", name_);
+    return false;
+  }
+
+  tags.emplace_back();
+  Tag& tag = tags.back();
+  tag.name_ = name_;
+  tag.value_ = std::string(value);
+
+  // The value token is never the last one, so it is always followed by a dot.
+  const size_t start = value.data() - stat_name.data();
+  remove_characters.insert(start, start + value.size() + 1);
+  PERF_RECORD(perf, "tokens-match", name_);
+  return true;
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <regex>
 #include <string>
+#include <vector>
 
 #include "envoy/stats/tag_extractor.h"
 
@@ -53,5 +54,34 @@ private:
   const std::regex regex_;
 };
 
+/**
+ * Tag extractor matching a pattern of dot-separated tokens against the tokens of a stat name,
+ * which is much cheaper than evaluating a regex. In the pattern:
+ * - "$" matches any single token, which is the tag value. It must occur exactly once and may not
+ *   be the last token. The tag value and the dot following it are removed from the name.
+ * - "*" matches any single token.
+ * - "**" matches one or more tokens, and may only be the last token.
+ * - Any other token matches only itself.
+ * For example "cluster.$.**" extracts the same tag as the regex "^cluster\.((.*?)\.)".
+ */
+class TagExtractorTokensImpl : public TagExtractor {
+public:
+  /**
+   * @param name name for tag extractor.
+   * @param pattern the dot-separated pattern, as described above.
+   */
+  TagExtractorTokensImpl(const std::string& name, const std::string& pattern);
+
+  std::string name() const override { return name_; }
+  bool extractTag(absl::string_view stat_name, std::vector<Tag>& tags,
+                  IntervalSet<size_t>& remove_characters) const override;
+  absl::string_view prefixToken() const override { return prefix_; }
+
+private:
+  const std::string name_;
+  const std::vector<std::string> tokens_;
+  const std::string prefix_;
+};
+
 } // namespace Stats
 } // namespace Envoy
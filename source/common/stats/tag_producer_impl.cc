@@ -1,5 +1,6 @@
 #include "common/stats/tag_producer_impl.h"
 
+#include <memory>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -52,6 +53,12 @@ int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
       ++num_found;
     }
   }
+  for (const auto& desc : Config::TagNames::get().tokenizedDescriptorVec()) {
+    if (desc.name_ == name) {
+      addExtractor(std::make_unique<TagExtractorTokensImpl>(desc.name_, desc.pattern_));
+      ++num_found;
+    }
+  }
   return num_found;
 }
 
@@ -106,6 +113,10 @@ TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v3alpha::Sta
       addExtractor(
           Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
     }
+    for (const auto& desc : Config::TagNames::get().tokenizedDescriptorVec()) {
+      names.emplace(desc.name_);
+      addExtractor(std::make_unique<TagExtractorTokensImpl>(desc.name_, desc.pattern_));
+    }
   }
   return names;
 }
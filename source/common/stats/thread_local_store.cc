@@ -80,11 +80,9 @@ bool ThreadLocalStoreImpl::rejects(StatName stat_name) const {
   // hot path) could become prohibitively expensive. Revisit this usage in the
   // future.
   //
-  // Also note that the elaboration of the stat-name into a string is expensive,
-  // so I think it might be better to move the matcher test until after caching,
-  // unless its acceptsAll/rejectsAll.
-  return stats_matcher_->rejectsAll() ||
-         stats_matcher_->rejects(constSymbolTable().toString(stat_name));
+  // Exact and prefix patterns are tested against the tokens of the stat-name,
+  // which is only elaborated into a string for the other patterns.
+  return stats_matcher_->rejectsAll() || stats_matcher_->rejects(stat_name, constSymbolTable());
 }
 
 std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
@@ -165,16 +163,10 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
     ASSERT(!merge_in_progress_);
     merge_in_progress_ = true;
+    // Swapping the shared active index keeps the time spent on each thread constant, regardless of
+    // the number of histograms.
     tls_->runOnAllThreads(
-        [this]() -> void {
-          for (const auto& scope : tls_->getTyped<TlsCache>().scope_cache_) {
-            const TlsCacheEntry& tls_cache_entry = scope.second;
-            for (const auto& name_histogram_pair : tls_cache_entry.histograms_) {
-              const TlsHistogramSharedPtr& tls_hist = name_histogram_pair.second;
-              tls_hist->beginMerge();
-            }
-          }
-        },
+        [this]() -> void { tls_->getTyped<TlsCache>().histogram_active_index_->beginMerge(); },
         [this, merge_complete_cb]() -> void { mergeInternal(merge_complete_cb); });
   } else {
     // If server is shutting down, just call the callback to allow flush to continue.
@@ -369,6 +361,15 @@ ThreadLocalStoreImpl::ScopeImpl::findStatLockHeld(
   return std::cref(*iter->second);
 }
 
+StatName ThreadLocalStoreImpl::ScopeImpl::prefixedName(StatName name,
+                                                       SymbolTable::StoragePtr& storage) {
+  if (prefix_.statName().empty()) {
+    return name;
+  }
+  storage = symbolTable().join({prefix_.statName(), name});
+  return StatName(storage.get());
+}
+
 Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(StatName name) {
   if (parent_.rejectsAll()) {
     return parent_.null_counter_;
@@ -383,8 +384,8 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(StatName name) {
   // after we construct the stat we can insert it into the required maps. This
   // strategy costs an extra hash lookup for each miss, but saves time
   // re-copying the string and significant memory overhead.
-  Stats::SymbolTable::StoragePtr final_name = symbolTable().join({prefix_.statName(), name});
-  StatName final_stat_name(final_name.get());
+  Stats::SymbolTable::StoragePtr final_name;
+  const StatName final_stat_name = prefixedName(name, final_name);
 
   // We now find the TLS cache. This might remain null if we don't have TLS
   // initialized currently.
@@ -435,8 +436,8 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatName(StatName name,
   // a temporary, and address sanitization errors would follow. Instead we must
   // do a find() first, using that if it succeeds. If it fails, then after we
   // construct the stat we can insert it into the required maps.
-  Stats::SymbolTable::StoragePtr final_name = symbolTable().join({prefix_.statName(), name});
-  StatName final_stat_name(final_name.get());
+  Stats::SymbolTable::StoragePtr final_name;
+  const StatName final_stat_name = prefixedName(name, final_name);
 
   StatRefMap<Gauge>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
@@ -471,8 +472,8 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatName(StatName name,
   // a temporary, and address sanitization errors would follow. Instead we must
   // do a find() first, using that if it succeeds. If it fails, then after we
   // construct the stat we can insert it into the required maps.
-  Stats::SymbolTable::StoragePtr final_name = symbolTable().join({prefix_.statName(), name});
-  StatName final_stat_name(final_name.get());
+  Stats::SymbolTable::StoragePtr final_name;
+  const StatName final_stat_name = prefixedName(name, final_name);
 
   StatNameHashMap<ParentHistogramSharedPtr>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
@@ -539,19 +540,24 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
   // See comments in counterFromStatName() which explains the logic here.
 
   StatNameHashMap<TlsHistogramSharedPtr>* tls_cache = nullptr;
+  TlsHistogramActiveIndexSharedPtr active_index;
   if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_cache = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_].histograms_;
+    TlsCache& tls = parent_.tls_->getTyped<TlsCache>();
+    tls_cache = &tls.scope_cache_[this->scope_id_].histograms_;
     auto iter = tls_cache->find(name);
     if (iter != tls_cache->end()) {
       return *iter->second;
     }
+    active_index = tls.histogram_active_index_;
+  } else {
+    active_index = std::make_shared<TlsHistogramActiveIndex>();
   }
 
   std::vector<Tag> tags;
   std::string tag_extracted_name =
       parent_.tagProducer().produceTags(symbolTable().toString(name), tags);
-  TlsHistogramSharedPtr hist_tls_ptr(
-      new ThreadLocalHistogramImpl(name, parent.unit(), tag_extracted_name, tags, symbolTable()));
+  TlsHistogramSharedPtr hist_tls_ptr(new ThreadLocalHistogramImpl(
+      name, parent.unit(), tag_extracted_name, tags, symbolTable(), std::move(active_index)));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -564,10 +570,11 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
                                                    const std::string& tag_extracted_name,
                                                    const std::vector<Tag>& tags,
-                                                   SymbolTable& symbol_table)
+                                                   SymbolTable& symbol_table,
+                                                   TlsHistogramActiveIndexSharedPtr active_index)
     : HistogramImplHelper(name, tag_extracted_name, tags, symbol_table), unit_(unit),
-      current_active_(0), used_(false), created_thread_id_(std::this_thread::get_id()),
-      symbol_table_(symbol_table) {
+      active_index_(std::move(active_index)), used_(false),
+      created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
   histograms_[0] = hist_alloc();
   histograms_[1] = hist_alloc();
 }
@@ -580,7 +587,7 @@ ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  hist_insert_intscale(histograms_[active_index_->active()], value, 0, 1);
   used_ = true;
 }
 
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 
 #include "envoy/thread_local/thread_local.h"
@@ -24,30 +25,48 @@
 namespace Envoy {
 namespace Stats {
 
+/**
+ * Index of the histogram that the TLS histograms of a thread collect values into. It is shared by
+ * all the TLS histograms of a thread, so that the beginning of a merge swaps all of them at once
+ * rather than walking every histogram on every thread.
+ */
+class TlsHistogramActiveIndex {
+public:
+  /**
+   * Called in the beginning of merge process on the owning thread. Swaps the histogram used for
+   * collection so that we do not have to lock the histograms in high throughput TLS writes.
+   */
+  void beginMerge() {
+    // This switches the active index between 1 and 0.
+    ASSERT(std::this_thread::get_id() == created_thread_id_);
+    active_ = 1 - active_;
+  }
+
+  uint64_t active() const { return active_; }
+
+private:
+  uint64_t active_{0};
+  const std::thread::id created_thread_id_{std::this_thread::get_id()};
+};
+
+using TlsHistogramActiveIndexSharedPtr = std::shared_ptr<TlsHistogramActiveIndex>;
+
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process, through the active index shared by the thread's TLS
+ * histograms.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
                            const std::string& tag_extracted_name, const std::vector<Tag>& tags,
-                           SymbolTable& symbol_table);
+                           SymbolTable& symbol_table,
+                           TlsHistogramActiveIndexSharedPtr active_index);
   ~ThreadLocalHistogramImpl() override;
 
   void merge(histogram_t* target);
 
-  /**
-   * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
-   * not have to lock the histogram in high throughput TLS writes.
-   */
-  void beginMerge() {
-    // This switches the current_active_ between 1 and 0.
-    ASSERT(std::this_thread::get_id() == created_thread_id_);
-    current_active_ = otherHistogramIndex();
-  }
-
   // Stats::Histogram
   Histogram::Unit unit() const override {
     // If at some point ThreadLocalHistogramImpl will hold a pointer to its parent we can just
@@ -62,8 +81,10 @@ public:
 
 private:
   Histogram::Unit unit_;
-  uint64_t otherHistogramIndex() const { return 1 - current_active_; }
-  uint64_t current_active_;
+  uint64_t otherHistogramIndex() const { return 1 - active_index_->active(); }
+  // Kept alive by the histogram, as the parent histogram may merge it after the thread's TLS cache
+  // is gone.
+  const TlsHistogramActiveIndexSharedPtr active_index_;
   histogram_t* histograms_[2];
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
@@ -350,6 +371,16 @@ private:
                                 std::unique_ptr<StatNameManagedStorage>& truncated_name_storage,
                                 std::vector<Tag>& tags, std::string& tag_extracted_name);
 
+    /**
+     * Adds the scope prefix to a name. The join, and its allocation, is skipped for scopes
+     * without a prefix, such as the default scope of the store.
+     *
+     * @param name the name of the stat, without the scope prefix.
+     * @param storage receives the joined name, if a join was needed.
+     * @return the full name of the stat, valid as long as both name and storage are.
+     */
+    StatName prefixedName(StatName name, SymbolTable::StoragePtr& storage);
+
     const uint64_t scope_id_;
     ThreadLocalStoreImpl& parent_;
     StatNameStorage prefix_;
@@ -368,6 +399,10 @@ private:
     // store. See the overview for more information. This complexity is required for lockless
     // operation in the fast path.
     absl::flat_hash_map<uint64_t, TlsCacheEntry> scope_cache_;
+
+    // Shared by all the TLS histograms created on this thread.
+    TlsHistogramActiveIndexSharedPtr histogram_active_index_{
+        std::make_shared<TlsHistogramActiveIndex>()};
   };
 
   std::string getTagsForName(const std::string& name, std::vector<Tag>& tags) const;
@@ -61,6 +61,12 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 void ConnPoolImpl::assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks) {
   ASSERT(conn.wrapper_ == nullptr);
   conn.wrapper_ = std::make_shared<ConnectionWrapper>(conn);
+  conn.prefetched_ = false;
+  if (conn.holding_data_) {
+    // The data held is delivered to the new owner of the connection once reading resumes.
+    conn.holding_data_ = false;
+    conn.conn_->readDisable(false);
+  }
 
   callbacks.onPoolReady(std::make_unique<ConnectionDataImpl>(conn.wrapper_),
                         conn.real_host_description_);
@@ -86,10 +92,18 @@ void ConnPoolImpl::createNewConnection() {
 }
 
 ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbacks& callbacks) {
+  const bool prefetch = host_->cluster().tcpPrefetchConnections() > 0;
   if (!ready_conns_.empty()) {
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
-    ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
-    assignConnection(*busy_conns_.front(), callbacks);
+    ActiveConn& conn = *busy_conns_.front();
+    ENVOY_CONN_LOG(debug, "using existing connection", *conn.conn_);
+    if (conn.prefetched_) {
+      host_->cluster().stats().upstream_rq_prefetch_hit_.inc();
+    }
+    assignConnection(conn, callbacks);
+    if (prefetch) {
+      prefetchConnections();
+    }
     return nullptr;
   }
 
@@ -109,7 +123,12 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
-    return pending_requests_.front().get();
+    ConnectionPool::Cancellable* pending = pending_requests_.front().get();
+    if (prefetch) {
+      host_->cluster().stats().upstream_rq_prefetch_miss_.inc();
+      prefetchConnections();
+    }
+    return pending;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
@@ -251,6 +270,21 @@ void ConnPoolImpl::onUpstreamReady() {
   }
 }
 
+void ConnPoolImpl::prefetchConnections() {
+  // The connections being established are bound to the pending requests first, so the connections
+  // kept ahead of demand are the ones left over. The pool is only topped up when a connection is
+  // requested, so that a failing host isn't connected to in a loop.
+  const uint64_t prefetch_connections = host_->cluster().tcpPrefetchConnections();
+  while (ready_conns_.size() + pending_conns_.size() <
+             pending_requests_.size() + prefetch_connections &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "prefetching a connection");
+    host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+    createNewConnection();
+    pending_conns_.front()->prefetched_ = true;
+  }
+}
+
 void ConnPoolImpl::processIdleConnection(ActiveConn& conn, bool new_connection, bool delay) {
   if (conn.wrapper_) {
     conn.wrapper_->invalidate();
@@ -377,7 +411,7 @@ ConnPoolImpl::ActiveConn::ActiveConn(ConnPoolImpl& parent)
                              parent_.host_->cluster().stats().upstream_cx_rx_bytes_buffered_,
                              parent_.host_->cluster().stats().upstream_cx_tx_bytes_total_,
                              parent_.host_->cluster().stats().upstream_cx_tx_bytes_buffered_,
-                             &parent_.host_->cluster().stats().bind_errors_, nullptr});
+                             &parent_.host_->cluster().stats().bind_errors_, nullptr, nullptr});
 
   // We just universally set no delay on connections. Theoretically we might at some point want
   // to make this configurable.
@@ -410,6 +444,14 @@ void ConnPoolImpl::ActiveConn::onUpstreamData(Buffer::Instance& data, bool end_s
   if (wrapper_ != nullptr && wrapper_->callbacks_ != nullptr) {
     // Delegate to the connection owner.
     wrapper_->callbacks_->onUpstreamData(data, end_stream);
+  } else if (prefetched_ && !end_stream) {
+    // Servers which speak first, e.g. MySQL, send data on connections established ahead of demand.
+    // Leave it in the read buffer and stop reading until the connection is assigned.
+    ENVOY_CONN_LOG(debug, "holding data from upstream until the connection is assigned", *conn_);
+    if (!holding_data_) {
+      holding_data_ = true;
+      conn_->readDisable(true);
+    }
   } else {
     // Unexpected data from upstream, close down the connection.
     ENVOY_CONN_LOG(debug, "unexpected data from upstream, closing connection", *conn_);
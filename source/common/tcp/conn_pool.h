@@ -116,6 +116,10 @@ protected:
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
     bool timed_out_;
+    // Whether the connection was established ahead of demand and hasn't been assigned yet.
+    bool prefetched_{};
+    // Whether reading was disabled to hold the data received before the connection was assigned.
+    bool holding_data_{};
   };
 
   using ActiveConnPtr = std::unique_ptr<ActiveConn>;
@@ -142,6 +146,7 @@ protected:
   virtual void onConnReleased(ActiveConn& conn);
   virtual void onConnDestroyed(ActiveConn& conn);
   void onUpstreamReady();
+  void prefetchConnections();
   void processIdleConnection(ActiveConn& conn, bool new_connection, bool delay);
   void checkForDrained();
 
@@ -24,6 +24,7 @@
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/runtime/runtime_impl.h"
 
 namespace Envoy {
 namespace TcpProxy {
@@ -205,7 +206,9 @@ UpstreamDrainManager& Config::drainManager() {
 Filter::Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager,
                TimeSource& time_source)
     : config_(config), cluster_manager_(cluster_manager), downstream_callbacks_(*this),
-      upstream_callbacks_(new UpstreamCallbacks(this)), stream_info_(time_source) {
+      upstream_callbacks_(new UpstreamCallbacks(this)), stream_info_(time_source),
+      lazy_idle_timer_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tcp_proxy_lazy_idle_timer")) {
   ASSERT(config != nullptr);
 }
 
@@ -249,7 +252,7 @@ void Filter::initialize(Network::ReadFilterCallbacks& callbacks, bool set_connec
         {config_->stats().downstream_cx_rx_bytes_total_,
          config_->stats().downstream_cx_rx_bytes_buffered_,
          config_->stats().downstream_cx_tx_bytes_total_,
-         config_->stats().downstream_cx_tx_bytes_buffered_, nullptr, nullptr});
+         config_->stats().downstream_cx_tx_bytes_buffered_, nullptr, nullptr, nullptr});
   }
 }
 
@@ -490,7 +493,7 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
   getStreamInfo().addBytesReceived(data.length());
   upstream_conn_data_->connection().write(data, end_stream);
   ASSERT(0 == data.length());
-  resetIdleTimer(); // TODO(ggreenway) PERF: do we need to reset timer on both send and receive?
+  resetIdleTimer();
   return Network::FilterStatus::StopIteration;
 }
 
@@ -504,6 +507,11 @@ void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
 
       if (upstream_conn_data_ != nullptr) {
         if (upstream_conn_data_->connection().state() != Network::Connection::State::Closed) {
+          if (lazy_idle_timer_ && idle_timer_ != nullptr) {
+            // The Drainer re-arms the timer on every write, so hand it over with the actual
+            // deadline.
+            idle_timer_->enableTimer(idleTimeoutRemaining());
+          }
           config_->drainManager().add(config_->sharedConfig(), std::move(upstream_conn_data_),
                                       std::move(upstream_callbacks_), std::move(idle_timer_),
                                       read_callbacks_->upstreamHost());
@@ -532,7 +540,7 @@ void Filter::onUpstreamData(Buffer::Instance& data, bool end_stream) {
   getStreamInfo().addBytesSent(data.length());
   read_callbacks_->connection().write(data, end_stream);
   ASSERT(0 == data.length());
-  resetIdleTimer(); // TODO(ggreenway) PERF: do we need to reset timer on both send and receive?
+  resetIdleTimer();
 }
 
 void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
@@ -577,7 +585,8 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
       // the call to either TcpProxy or to Drainer, depending on the current state.
       idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
           [upstream_callbacks = upstream_callbacks_]() { upstream_callbacks->onIdleTimeout(); });
-      resetIdleTimer();
+      last_activity_ = read_callbacks_->connection().dispatcher().approximateMonotonicTime();
+      idle_timer_->enableTimer(config_->idleTimeout().value());
       read_callbacks_->connection().addBytesSentCallback([this](uint64_t) { resetIdleTimer(); });
       upstream_conn_data_->connection().addBytesSentCallback(
           [upstream_callbacks = upstream_callbacks_](uint64_t) {
@@ -588,6 +597,15 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 }
 
 void Filter::onIdleTimeout() {
+  if (lazy_idle_timer_) {
+    const std::chrono::milliseconds remaining = idleTimeoutRemaining();
+    if (remaining.count() > 0) {
+      // There was activity since the timer was armed.
+      idle_timer_->enableTimer(remaining);
+      return;
+    }
+  }
+
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
 
@@ -598,8 +616,25 @@ void Filter::onIdleTimeout() {
 void Filter::resetIdleTimer() {
   if (idle_timer_ != nullptr) {
     ASSERT(config_->idleTimeout());
-    idle_timer_->enableTimer(config_->idleTimeout().value());
+    if (lazy_idle_timer_) {
+      last_activity_ = read_callbacks_->connection().dispatcher().approximateMonotonicTime();
+    } else {
+      idle_timer_->enableTimer(config_->idleTimeout().value());
+    }
+  }
+}
+
+std::chrono::milliseconds Filter::idleTimeoutRemaining() const {
+  const auto idle_time =
+      read_callbacks_->connection().dispatcher().approximateMonotonicTime() - last_activity_;
+  const std::chrono::milliseconds timeout = config_->idleTimeout().value();
+  if (idle_time >= timeout) {
+    return std::chrono::milliseconds(0);
   }
+  // Round up so that the timer never fires before the connection has been idle long enough.
+  const auto remaining = timeout - idle_time;
+  const auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+  return remaining_ms < remaining ? remaining_ms + std::chrono::milliseconds(1) : remaining_ms;
 }
 
 void Filter::disableIdleTimer() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -7,6 +8,7 @@
 #include <vector>
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/common/time.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/network/tcp_proxy/v3alpha/tcp_proxy.pb.h"
 #include "envoy/network/connection.h"
@@ -340,6 +342,8 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  // @return the time left until the connections have been idle for the configured idle timeout.
+  std::chrono::milliseconds idleTimeoutRemaining() const;
 
   const ConfigSharedPtr config_;
   Upstream::ClusterManager& cluster_manager_;
@@ -355,6 +359,10 @@ protected:
   Network::TransportSocketOptionsSharedPtr transport_socket_options_;
   uint32_t connect_attempts_{};
   bool connecting_{};
+  // When set, activity only updates last_activity_ and the idle timer is re-armed when it fires,
+  // instead of re-arming the timer on every read and write.
+  const bool lazy_idle_timer_;
+  MonotonicTime last_activity_;
 };
 
 // This class deals with an upstream connection that needs to finish flushing, when the downstream
@@ -0,0 +1,90 @@
+#include "common/thread_local/rcu_slot.h"
+
+namespace Envoy {
+namespace ThreadLocal {
+
+namespace {
+
+// The record of the reads of a thread. The records are never freed, the record of an exited thread
+// is reused by the next thread reading, so that there are as many as the most threads ever reading
+// at once.
+struct ReaderRecord {
+  // The epoch the read in progress started at, or 0 if none is.
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<bool> in_use_{true};
+  // Set before the record is published.
+  ReaderRecord* next_{};
+};
+
+std::atomic<uint64_t> global_epoch{1};
+std::atomic<ReaderRecord*> reader_records{nullptr};
+
+ReaderRecord* acquireRecord() {
+  for (ReaderRecord* record = reader_records.load(std::memory_order_acquire); record != nullptr;
+       record = record->next_) {
+    bool in_use = false;
+    if (!record->in_use_.load(std::memory_order_relaxed) &&
+        record->in_use_.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+      return record;
+    }
+  }
+  ReaderRecord* record = new ReaderRecord();
+  record->next_ = reader_records.load(std::memory_order_relaxed);
+  while (!reader_records.compare_exchange_weak(record->next_, record, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+  }
+  return record;
+}
+
+struct ThreadReader {
+  ~ThreadReader() {
+    if (record_ != nullptr) {
+      record_->epoch_.store(0, std::memory_order_release);
+      record_->in_use_.store(false, std::memory_order_release);
+    }
+  }
+
+  ReaderRecord* record_{};
+  uint32_t depth_{};
+};
+
+thread_local ThreadReader thread_reader;
+
+} // namespace
+
+void RcuEpoch::enterRead() {
+  ThreadReader& reader = thread_reader;
+  if (reader.depth_++ != 0) {
+    return;
+  }
+  if (reader.record_ == nullptr) {
+    reader.record_ = acquireRecord();
+  }
+  // Sequentially consistent, so that the data is loaded after the epoch is announced and a writer
+  // either sees the epoch or has already published its update.
+  reader.record_->epoch_.store(global_epoch.load());
+}
+
+void RcuEpoch::exitRead() {
+  ThreadReader& reader = thread_reader;
+  ASSERT(reader.depth_ > 0);
+  if (--reader.depth_ == 0) {
+    reader.record_->epoch_.store(0, std::memory_order_release);
+  }
+}
+
+uint64_t RcuEpoch::retire() { return global_epoch.fetch_add(1); }
+
+bool RcuEpoch::quiescent(uint64_t epoch) {
+  for (ReaderRecord* record = reader_records.load(std::memory_order_acquire); record != nullptr;
+       record = record->next_) {
+    const uint64_t read_epoch = record->epoch_.load();
+    if (read_epoch != 0 && read_epoch <= epoch) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace ThreadLocal
+} // namespace Envoy
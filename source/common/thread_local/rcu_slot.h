@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace ThreadLocal {
+
+/**
+ * The epochs of the reads of RcuSlot, which tell when a version retired by an update can no longer
+ * be read. Each thread reading a slot announces the epoch it started reading at in a record of its
+ * own, so that entering and leaving a read are a store each and never wait on other threads.
+ */
+class RcuEpoch {
+public:
+  /**
+   * Enter and leave a read on the calling thread. Reads may be nested.
+   */
+  static void enterRead();
+  static void exitRead();
+
+  /**
+   * Advance the epoch after a version is unpublished.
+   * @return uint64_t the epoch the version is retired at.
+   */
+  static uint64_t retire();
+
+  /**
+   * @return bool whether no read started at or before an epoch is still in progress, so that the
+   *         versions retired at the epoch can be destroyed.
+   */
+  static bool quiescent(uint64_t epoch);
+};
+
+/**
+ * A read of RcuSlot on the calling thread, for the lifetime of the scope.
+ */
+class RcuReadScope : NonCopyable {
+public:
+  RcuReadScope() { RcuEpoch::enterRead(); }
+  ~RcuReadScope() { RcuEpoch::exitRead(); }
+};
+
+/**
+ * A slot holding the same data for all the threads, as an alternative to ThreadLocal::Slot for
+ * data which is read by the workers and updated by the main thread. Rather than posting the new
+ * data to every worker, an update publishes it with a single atomic exchange, so that it costs the
+ * same however many workers there are and is seen by all of them at once. The workers read the
+ * slot without waiting nor writing to memory shared with other threads.
+ *
+ * The version replaced by an update is retired, and released on the owner thread once no read
+ * which may have seen it is in progress: right away if none is, or else by a timer on the
+ * dispatcher of the owner thread, which checks again until the last of these reads is over. The
+ * data is then destroyed as soon as the callers of get() drop it. The slot must be created,
+ * updated and destroyed on the same thread, and outlive the reads on the other threads.
+ */
+template <class T> class RcuSlot : NonCopyable {
+public:
+  using DataConstSharedPtr = std::shared_ptr<const T>;
+
+  explicit RcuSlot(Event::Dispatcher& dispatcher, DataConstSharedPtr data = nullptr)
+      : owner_thread_id_(std::this_thread::get_id()),
+        current_(new DataConstSharedPtr(std::move(data))),
+        reclaim_timer_(dispatcher.createTimer([this]() -> void { reclaimOrRetry(); })) {}
+
+  ~RcuSlot() {
+    ASSERT(std::this_thread::get_id() == owner_thread_id_);
+    delete current_.load();
+  }
+
+  /**
+   * @return DataConstSharedPtr the current data. Called by any thread.
+   */
+  DataConstSharedPtr get() const {
+    RcuReadScope scope;
+    return *current_.load();
+  }
+
+  /**
+   * Run a callback on the current data, without taking a reference to it. Called by any thread.
+   * @param cb supplies the callback, which must not keep the data beyond its return.
+   */
+  template <class Callback> void read(Callback cb) const {
+    RcuReadScope scope;
+    cb(*current_.load());
+  }
+
+  /**
+   * Publish new data to all the threads. Called by the owner thread.
+   * @param data supplies the data.
+   */
+  void set(DataConstSharedPtr data) {
+    ASSERT(std::this_thread::get_id() == owner_thread_id_);
+    std::unique_ptr<DataConstSharedPtr> previous(
+        current_.exchange(new DataConstSharedPtr(std::move(data))));
+    retired_.emplace_back(RcuEpoch::retire(), std::move(previous));
+    reclaimOrRetry();
+  }
+
+  /**
+   * Destroy the retired versions which can no longer be read. Called by the owner thread.
+   * @return bool whether versions remain retired.
+   */
+  bool reclaim() {
+    ASSERT(std::this_thread::get_id() == owner_thread_id_);
+    // The versions are retired in the order of their epochs.
+    auto it = retired_.begin();
+    while (it != retired_.end() && RcuEpoch::quiescent(it->first)) {
+      ++it;
+    }
+    retired_.erase(retired_.begin(), it);
+    return !retired_.empty();
+  }
+
+private:
+  void reclaimOrRetry() {
+    // The reads are only as long as copying a shared pointer, so they are over by the next check.
+    if (reclaim() && !reclaim_timer_->enabled()) {
+      reclaim_timer_->enableTimer(std::chrono::milliseconds(1));
+    }
+  }
+
+  const std::thread::id owner_thread_id_;
+  // Each version is held by a node of its own, so that it is published by a pointer exchange.
+  std::atomic<DataConstSharedPtr*> current_;
+  std::vector<std::pair<uint64_t, std::unique_ptr<DataConstSharedPtr>>> retired_;
+  const Event::TimerPtr reclaim_timer_;
+};
+
+} // namespace ThreadLocal
+} // namespace Envoy
@@ -157,6 +157,12 @@ void HttpTracerUtility::finalizeDownstreamSpan(Span& span, const Http::HeaderMap
                                                const Http::HeaderMap* response_trailers,
                                                const StreamInfo::StreamInfo& stream_info,
                                                const Config& tracing_config) {
+  // Tags of a span that is not recorded are discarded, don't build them.
+  if (!span.isRecording()) {
+    span.finishSpan();
+    return;
+  }
+
   // Pre response data.
   if (request_headers) {
     if (request_headers->RequestId()) {
@@ -202,6 +208,11 @@ void HttpTracerUtility::finalizeUpstreamSpan(Span& span, const Http::HeaderMap*
                                              const Http::HeaderMap* response_trailers,
                                              const StreamInfo::StreamInfo& stream_info,
                                              const Config& tracing_config) {
+  if (!span.isRecording()) {
+    span.finishSpan();
+    return;
+  }
+
   span.setTag(Tracing::Tags::get().HttpProtocol,
               AccessLog::AccessLogFormatUtils::protocolToString(stream_info.protocol()));
 
@@ -280,7 +291,7 @@ SpanPtr HttpTracerImpl::startSpan(const Config& config, Http::HeaderMap& request
                                            stream_info.startTime(), tracing_decision);
 
   // Set tags related to the local environment
-  if (active_span) {
+  if (active_span && active_span->isRecording()) {
     active_span->setTag(Tracing::Tags::get().NodeId, local_info_.nodeName());
     active_span->setTag(Tracing::Tags::get().Zone, local_info_.zoneName());
   }
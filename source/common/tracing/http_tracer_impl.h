@@ -172,6 +172,7 @@ public:
     return SpanPtr{new NullSpan()};
   }
   void setSampled(bool) override {}
+  bool isRecording() const override { return false; }
 };
 
 class HttpNullTracer : public HttpTracer {
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+// Alias table (https://en.wikipedia.org/wiki/Alias_method) used for weighted random selection.
+// The table is built once for a set of integer weights, after which each pick takes a single random
+// number and O(1) time, rather than a scan or a search over the cumulative weights. Each column of
+// the table holds an entry and the threshold under which it is picked rather than its alias, and
+// the weights are scaled by the number of columns so that the table is exact, without any floating
+// point rounding.
+class AliasTable {
+public:
+  AliasTable() = default;
+
+  /**
+   * Build the table for a set of weights. The entries of weight 0 are never picked.
+   * @param weights supplies the weight of each entry, indexed by entry. The weights multiplied by
+   *        the number of entries must fit in 64 bits.
+   */
+  explicit AliasTable(const std::vector<uint64_t>& weights) {
+    for (uint32_t i = 0; i < weights.size(); ++i) {
+      if (weights[i] > 0) {
+        columns_.push_back({i, i, weights[i]});
+        total_weight_ += weights[i];
+      }
+    }
+
+    // The columns whose scaled weight is below the total weight are filled up to it with an alias
+    // taken from a column whose scaled weight is above it, until all the columns are full.
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t i = 0; i < columns_.size(); ++i) {
+      columns_[i].threshold_ *= columns_.size();
+      (columns_[i].threshold_ < total_weight_ ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      Column& column = columns_[small.back()];
+      small.pop_back();
+      Column& alias = columns_[large.back()];
+      column.alias_ = alias.index_;
+      alias.threshold_ -= total_weight_ - column.threshold_;
+      if (alias.threshold_ < total_weight_) {
+        small.push_back(large.back());
+        large.pop_back();
+      }
+    }
+    // The scaled weights add up to the total weight per column, so the columns left are full.
+    for (uint32_t i : small) {
+      ASSERT(columns_[i].threshold_ == total_weight_);
+    }
+    for (uint32_t i : large) {
+      ASSERT(columns_[i].threshold_ == total_weight_);
+    }
+  }
+
+  /**
+   * @return bool whether no entry has a positive weight, in which case nothing can be picked.
+   */
+  bool empty() const { return columns_.empty(); }
+
+  /**
+   * Pick an entry with a probability proportional to its weight.
+   * @param random supplies a uniformly distributed random number.
+   * @return uint32_t the index of the entry picked. The table must not be empty.
+   */
+  uint32_t pick(uint64_t random) const {
+    ASSERT(!empty());
+    const Column& column = columns_[(random / total_weight_) % columns_.size()];
+    return random % total_weight_ < column.threshold_ ? column.index_ : column.alias_;
+  }
+
+private:
+  struct Column {
+    uint32_t index_;
+    uint32_t alias_;
+    uint64_t threshold_;
+  };
+
+  std::vector<Column> columns_;
+  uint64_t total_weight_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -16,6 +16,7 @@
 #include "common/config/resources.h"
 #include "common/config/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/stats/timespan_impl.h"
 
 #include "absl/strings/str_join.h"
 
@@ -24,46 +25,103 @@ namespace Upstream {
 
 CdsApiPtr CdsApiImpl::create(const envoy::config::core::v3alpha::ConfigSource& cds_config,
                              ClusterManager& cm, Stats::Scope& scope,
-                             ProtobufMessage::ValidationVisitor& validation_visitor) {
-  return CdsApiPtr{new CdsApiImpl(cds_config, cm, scope, validation_visitor)};
+                             ProtobufMessage::ValidationVisitor& validation_visitor,
+                             TimeSource& time_source) {
+  return CdsApiPtr{new CdsApiImpl(cds_config, cm, scope, validation_visitor, time_source)};
 }
 
 CdsApiImpl::CdsApiImpl(const envoy::config::core::v3alpha::ConfigSource& cds_config,
                        ClusterManager& cm, Stats::Scope& scope,
-                       ProtobufMessage::ValidationVisitor& validation_visitor)
+                       ProtobufMessage::ValidationVisitor& validation_visitor,
+                       TimeSource& time_source)
     : cm_(cm), scope_(scope.createScope("cluster_manager.cds.")),
-      validation_visitor_(validation_visitor) {
+      stats_{ALL_CDS_API_STATS(POOL_HISTOGRAM(*scope_))}, validation_visitor_(validation_visitor),
+      time_source_(time_source) {
   subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
       cds_config, loadTypeUrl(cds_config.resource_api_version()), *scope_, *this);
 }
 
 void CdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                                 const std::string& version_info) {
+  Stats::HistogramCompletableTimespanImpl decode_timer(stats_.update_decode_time_, time_source_);
   ClusterManager::ClusterInfoMap clusters_to_remove = cm_.clusters();
-  std::vector<envoy::config::cluster::v3alpha::Cluster> clusters;
+  std::vector<ClusterUpdate> clusters;
+  clusters.reserve(resources.size());
+  std::unordered_set<std::string> cluster_names;
+  std::vector<std::string> exception_msgs;
   for (const auto& cluster_blob : resources) {
-    clusters.push_back(
-        MessageUtil::anyConvert<envoy::config::cluster::v3alpha::Cluster>(cluster_blob));
-    clusters_to_remove.erase(clusters.back().name());
+    // Decode each cluster once and hand it over as is, rather than packing it back into a delta
+    // resource only for it to be decoded again. There are no per-resource versions in SotW.
+    // A cluster which fails validation is still kept out of the clusters to remove, so that a bad
+    // update leaves the cluster with its last good config.
+    const std::string cluster_name =
+        decodeCluster(cluster_blob, version_info, "", clusters, cluster_names, exception_msgs);
+    clusters_to_remove.erase(cluster_name);
   }
   Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
   for (const auto& cluster : clusters_to_remove) {
     *to_remove_repeated.Add() = cluster.first;
   }
-  Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> to_add_repeated;
-  for (const auto& cluster : clusters) {
-    envoy::service::discovery::v3alpha::Resource* to_add = to_add_repeated.Add();
-    to_add->set_name(cluster.name());
-    to_add->set_version(version_info);
-    to_add->mutable_resource()->PackFrom(cluster);
-  }
-  onConfigUpdate(to_add_repeated, to_remove_repeated, version_info);
+  decode_timer.complete();
+  applyUpdate(clusters, to_remove_repeated, version_info, exception_msgs);
 }
 
 void CdsApiImpl::onConfigUpdate(
     const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>& added_resources,
     const Protobuf::RepeatedPtrField<std::string>& removed_resources,
     const std::string& system_version_info) {
+  Stats::HistogramCompletableTimespanImpl decode_timer(stats_.update_decode_time_, time_source_);
+  std::vector<ClusterUpdate> clusters;
+  clusters.reserve(added_resources.size());
+  std::unordered_set<std::string> cluster_names;
+  std::vector<std::string> exception_msgs;
+  for (const auto& resource : added_resources) {
+    decodeCluster(resource.resource(), resource.version(), resource.version(), clusters,
+                  cluster_names, exception_msgs);
+  }
+  decode_timer.complete();
+  applyUpdate(clusters, removed_resources, system_version_info, exception_msgs);
+}
+
+std::string CdsApiImpl::decodeCluster(const ProtobufWkt::Any& resource, const std::string& version,
+                                      const std::string& resource_version,
+                                      std::vector<ClusterUpdate>& clusters,
+                                      std::unordered_set<std::string>& cluster_names,
+                                      std::vector<std::string>& exception_msgs) {
+  envoy::config::cluster::v3alpha::Cluster cluster;
+  const uint64_t hash = Config::AppliedResources::hash(resource);
+  std::string cluster_name;
+  try {
+    // A cluster which is still active and unchanged since it was applied is neither unpacked nor
+    // handed to the cluster manager again.
+    cluster_name = resourceName(resource);
+    if (applied_clusters_.unchanged(cluster_name, hash, resource_version) &&
+        cm_.get(cluster_name) != nullptr) {
+      if (!cluster_names.insert(cluster_name).second) {
+        throw EnvoyException(fmt::format("duplicate cluster {} found", cluster_name));
+      }
+      ENVOY_LOG(debug, "cds: cluster '{}' unchanged", cluster_name);
+      return cluster_name;
+    }
+    cluster = MessageUtil::anyConvert<envoy::config::cluster::v3alpha::Cluster>(resource);
+    MessageUtil::validate(cluster, validation_visitor_);
+    if (!cluster_names.insert(cluster.name()).second) {
+      // NOTE: the first of these duplicates is still applied.
+      throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
+    }
+  } catch (const EnvoyException& e) {
+    exception_msgs.push_back(fmt::format("{}: {}", cluster_name, e.what()));
+    return cluster_name;
+  }
+  clusters.push_back({std::move(cluster), version, resource_version, hash});
+  return clusters.back().cluster_.name();
+}
+
+void CdsApiImpl::applyUpdate(const std::vector<ClusterUpdate>& clusters,
+                             const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                             const std::string& system_version_info,
+                             std::vector<std::string>& exception_msgs) {
+  Stats::HistogramCompletableTimespanImpl apply_timer(stats_.update_apply_time_, time_source_);
   std::unique_ptr<Cleanup> maybe_eds_resume;
   if (cm_.adsMux()) {
     cm_.adsMux()->pause(Config::TypeUrl::get().ClusterLoadAssignment);
@@ -71,33 +129,27 @@ void CdsApiImpl::onConfigUpdate(
         [this] { cm_.adsMux()->resume(Config::TypeUrl::get().ClusterLoadAssignment); });
   }
 
-  ENVOY_LOG(info, "cds: add {} cluster(s), remove {} cluster(s)", added_resources.size(),
+  ENVOY_LOG(info, "cds: add {} cluster(s), remove {} cluster(s)", clusters.size(),
             removed_resources.size());
 
-  std::vector<std::string> exception_msgs;
-  std::unordered_set<std::string> cluster_names;
   bool any_applied = false;
-  for (const auto& resource : added_resources) {
-    envoy::config::cluster::v3alpha::Cluster cluster;
+  for (const auto& update : clusters) {
+    const auto& cluster = update.cluster_;
     try {
-      cluster =
-          MessageUtil::anyConvert<envoy::config::cluster::v3alpha::Cluster>(resource.resource());
-      MessageUtil::validate(cluster, validation_visitor_);
-      if (!cluster_names.insert(cluster.name()).second) {
-        // NOTE: at this point, the first of these duplicates has already been successfully applied.
-        throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
-      }
-      if (cm_.addOrUpdateCluster(cluster, resource.version())) {
+      if (cm_.addOrUpdateCluster(cluster, update.version_)) {
         any_applied = true;
         ENVOY_LOG(info, "cds: add/update cluster '{}'", cluster.name());
       } else {
         ENVOY_LOG(debug, "cds: add/update cluster '{}' skipped", cluster.name());
       }
+      applied_clusters_.applied(cluster.name(), update.hash_, update.resource_version_);
     } catch (const EnvoyException& e) {
+      applied_clusters_.forget(cluster.name());
       exception_msgs.push_back(fmt::format("{}: {}", cluster.name(), e.what()));
     }
   }
   for (const auto& resource_name : removed_resources) {
+    applied_clusters_.forget(resource_name);
     if (cm_.removeCluster(resource_name)) {
       any_applied = true;
       ENVOY_LOG(info, "cds: remove cluster '{}'", resource_name);
@@ -107,6 +159,7 @@ void CdsApiImpl::onConfigUpdate(
   if (any_applied) {
     system_version_info_ = system_version_info;
   }
+  apply_timer.complete();
   runInitializeCallbackIfAny();
   if (!exception_msgs.empty()) {
     throw EnvoyException(
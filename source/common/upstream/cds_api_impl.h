@@ -1,8 +1,12 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "envoy/api/api.h"
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3alpha/cluster.pb.h"
 #include "envoy/config/core/v3alpha/config_source.pb.h"
 #include "envoy/config/subscription.h"
@@ -10,13 +14,30 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/discovery/v3alpha/discovery.pb.h"
 #include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/logger.h"
+#include "common/config/applied_resources.h"
+#include "common/config/utility.h"
 
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * All CDS API stats. @see stats_macros.h
+ */
+#define ALL_CDS_API_STATS(HISTOGRAM)                                                               \
+  HISTOGRAM(update_apply_time, Milliseconds)                                                       \
+  HISTOGRAM(update_decode_time, Milliseconds)
+
+/**
+ * Struct definition for all CDS API stats. @see stats_macros.h
+ */
+struct CdsApiStats {
+  ALL_CDS_API_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * CDS API implementation that fetches via Subscription.
  */
@@ -26,7 +47,8 @@ class CdsApiImpl : public CdsApi,
 public:
   static CdsApiPtr create(const envoy::config::core::v3alpha::ConfigSource& cds_config,
                           ClusterManager& cm, Stats::Scope& scope,
-                          ProtobufMessage::ValidationVisitor& validation_visitor);
+                          ProtobufMessage::ValidationVisitor& validation_visitor,
+                          TimeSource& time_source);
 
   // Upstream::CdsApi
   void initialize() override { subscription_->start({}); }
@@ -47,19 +69,57 @@ private:
   void onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
                             const EnvoyException* e) override;
   std::string resourceName(const ProtobufWkt::Any& resource) override {
-    return MessageUtil::anyConvert<envoy::config::cluster::v3alpha::Cluster>(resource).name();
+    return Config::Utility::anyStringField(
+        resource, envoy::config::cluster::v3alpha::Cluster::kNameFieldNumber);
   }
   static std::string loadTypeUrl(envoy::config::core::v3alpha::ApiVersion resource_api_version);
   CdsApiImpl(const envoy::config::core::v3alpha::ConfigSource& cds_config, ClusterManager& cm,
-             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor);
+             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor,
+             TimeSource& time_source);
   void runInitializeCallbackIfAny();
 
+  struct ClusterUpdate {
+    envoy::config::cluster::v3alpha::Cluster cluster_;
+    std::string version_;
+    // The per-resource version and the hash of the serialized cluster, which are remembered once
+    // the cluster is applied.
+    std::string resource_version_;
+    uint64_t hash_;
+  };
+
+  /**
+   * Decodes and validates a cluster of an update, appending it to the given list unless it is
+   * unchanged since it was last applied.
+   * @param version the version the cluster is added or updated with.
+   * @param resource_version the version of the resource given by the management server, if any.
+   * @return std::string the name of the cluster, even if it is not valid, in which case the error
+   *         is added to exception_msgs. The name is empty if the resource could not be read.
+   */
+  std::string decodeCluster(const ProtobufWkt::Any& resource, const std::string& version,
+                            const std::string& resource_version,
+                            std::vector<ClusterUpdate>& clusters,
+                            std::unordered_set<std::string>& cluster_names,
+                            std::vector<std::string>& exception_msgs);
+
+  /**
+   * Adds or updates the decoded clusters of an update and removes the given clusters. Errors are
+   * added to exception_msgs, and if there are any an EnvoyException listing them is thrown once
+   * the update is applied.
+   */
+  void applyUpdate(const std::vector<ClusterUpdate>& clusters,
+                   const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                   const std::string& system_version_info,
+                   std::vector<std::string>& exception_msgs);
+
   ClusterManager& cm_;
   std::unique_ptr<Config::Subscription> subscription_;
   std::string system_version_info_;
+  Config::AppliedResources applied_clusters_;
   std::function<void()> initialize_callback_;
   Stats::ScopePtr scope_;
+  CdsApiStats stats_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
+  TimeSource& time_source_;
 };
 
 } // namespace Upstream
@@ -31,7 +31,8 @@ std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr> ClusterFactoryImplBase::
     AccessLog::AccessLogManager& log_manager, const LocalInfo::LocalInfo& local_info,
     Server::Admin& admin, Singleton::Manager& singleton_manager,
     Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api,
-    ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api) {
+    ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+    Event::Dispatcher* health_check_dispatcher) {
   std::string cluster_type;
 
   if (!cluster.has_cluster_type()) {
@@ -67,7 +68,8 @@ std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr> ClusterFactoryImplBase::
   ClusterFactoryContextImpl context(
       cluster_manager, stats, tls, std::move(dns_resolver), ssl_context_manager, runtime, random,
       dispatcher, log_manager, local_info, admin, singleton_manager,
-      std::move(outlier_event_logger), added_via_api, validation_visitor, api);
+      std::move(outlier_event_logger), added_via_api, validation_visitor, api,
+      health_check_dispatcher);
   return factory->create(cluster, context);
 }
 
@@ -87,8 +89,9 @@ ClusterFactoryImplBase::selectDnsResolver(const envoy::config::cluster::v3alpha:
     for (const auto& resolver_addr : resolver_addrs) {
       resolvers.push_back(Network::Address::resolveProtoAddress(resolver_addr));
     }
-    const bool use_tcp_for_dns_lookups = cluster.use_tcp_for_dns_lookups();
-    return context.dispatcher().createDnsResolver(resolvers, use_tcp_for_dns_lookups);
+    Network::DnsResolverOptions options;
+    options.use_tcp_for_dns_lookups_ = cluster.use_tcp_for_dns_lookups();
+    return context.dispatcher().createDnsResolver(resolvers, options);
   }
 
   return context.dnsResolver();
@@ -114,7 +117,7 @@ ClusterFactoryImplBase::create(const envoy::config::cluster::v3alpha::Cluster& c
       new_cluster_pair.first->setHealthChecker(HealthCheckerFactory::create(
           cluster.health_checks()[0], *new_cluster_pair.first, context.runtime(), context.random(),
           context.dispatcher(), context.logManager(), context.messageValidationVisitor(),
-          context.api()));
+          context.api(), context.healthCheckDispatcher()));
     }
   }
 
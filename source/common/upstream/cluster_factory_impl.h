@@ -60,13 +60,15 @@ public:
                             const LocalInfo::LocalInfo& local_info, Server::Admin& admin,
                             Singleton::Manager& singleton_manager,
                             Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api,
-                            ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api)
+                            ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+                            Event::Dispatcher* health_check_dispatcher = nullptr)
       : cluster_manager_(cluster_manager), stats_(stats), tls_(tls),
         dns_resolver_(std::move(dns_resolver)), ssl_context_manager_(ssl_context_manager),
         runtime_(runtime), random_(random), dispatcher_(dispatcher), log_manager_(log_manager),
         local_info_(local_info), admin_(admin), singleton_manager_(singleton_manager),
         outlier_event_logger_(std::move(outlier_event_logger)), added_via_api_(added_via_api),
-        validation_visitor_(validation_visitor), api_(api) {}
+        validation_visitor_(validation_visitor), api_(api),
+        health_check_dispatcher_(health_check_dispatcher) {}
 
   ClusterManager& clusterManager() override { return cluster_manager_; }
   Stats::Store& stats() override { return stats_; }
@@ -76,6 +78,7 @@ public:
   Runtime::Loader& runtime() override { return runtime_; }
   Runtime::RandomGenerator& random() override { return random_; }
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  Event::Dispatcher* healthCheckDispatcher() override { return health_check_dispatcher_; }
   AccessLog::AccessLogManager& logManager() override { return log_manager_; }
   const LocalInfo::LocalInfo& localInfo() override { return local_info_; }
   Server::Admin& admin() override { return admin_; }
@@ -104,6 +107,7 @@ private:
   const bool added_via_api_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   Api::Api& api_;
+  Event::Dispatcher* health_check_dispatcher_;
 };
 
 /**
@@ -124,7 +128,8 @@ public:
          AccessLog::AccessLogManager& log_manager, const LocalInfo::LocalInfo& local_info,
          Server::Admin& admin, Singleton::Manager& singleton_manager,
          Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api,
-         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api);
+         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+         Event::Dispatcher* health_check_dispatcher = nullptr);
 
   /**
    * Create a dns resolver to be used by the cluster.
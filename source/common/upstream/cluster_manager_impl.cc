@@ -46,6 +46,8 @@ namespace Envoy {
 namespace Upstream {
 namespace {
 
+const Runtime::Key use_http2_key{"upstream.use_http2"};
+
 void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
                          const Network::Socket::OptionsSharedPtr& to_add) {
   if (to_add != nullptr) {
@@ -63,10 +65,12 @@ void ClusterManagerInitHelper::addCluster(Cluster& cluster) {
   const auto initialize_cb = [&cluster, this] { onClusterInit(cluster); };
   if (cluster.initializePhase() == Cluster::InitializePhase::Primary) {
     primary_init_clusters_.push_back(&cluster);
+    init_cluster_positions_[&cluster] = std::prev(primary_init_clusters_.end());
     cluster.initialize(initialize_cb);
   } else {
     ASSERT(cluster.initializePhase() == Cluster::InitializePhase::Secondary);
     secondary_init_clusters_.push_back(&cluster);
+    init_cluster_positions_[&cluster] = std::prev(secondary_init_clusters_.end());
     if (started_secondary_initialize_) {
       // This can happen if we get a second CDS update that adds new clusters after we have
       // already started secondary init. In this case, just immediately initialize.
@@ -100,8 +104,14 @@ void ClusterManagerInitHelper::removeCluster(Cluster& cluster) {
   }
 
   // It is possible that the cluster we are removing has already been initialized, and is not
-  // present in the initializer list. If so, this is fine.
-  cluster_list->remove(&cluster);
+  // present in the initializer list. If so, this is fine. The position of each cluster in its list
+  // is kept so that removing it doesn't scan the list, which would make initializing many clusters
+  // quadratic.
+  const auto position = init_cluster_positions_.find(&cluster);
+  if (position != init_cluster_positions_.end()) {
+    cluster_list->erase(position->second);
+    init_cluster_positions_.erase(position);
+  }
   ENVOY_LOG(debug, "cm init: init complete: cluster={} primary={} secondary={}",
             cluster.info()->name(), primary_init_clusters_.size(), secondary_init_clusters_.size());
   maybeFinishInitialize();
@@ -219,9 +229,9 @@ ClusterManagerImpl::ClusterManagerImpl(
       http_context_(http_context),
       subscription_factory_(local_info, main_thread_dispatcher, *this, random,
                             validation_context.dynamicValidationVisitor(), api) {
-  async_client_manager_ =
-      std::make_unique<Grpc::AsyncClientManagerImpl>(*this, tls, time_source_, api);
   const auto& cm_config = bootstrap.cluster_manager();
+  async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
+      *this, tls, time_source_, api, cm_config.google_grpc_completion_threads());
   if (cm_config.has_outlier_detection()) {
     const std::string event_log_file_path = cm_config.outlier_detection().event_log_path();
     if (!event_log_file_path.empty()) {
@@ -537,15 +547,8 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3alph
       init_helper_.removeCluster(*existing_active_cluster->second->cluster_);
     } else {
       // Validate that warming clusters are not added to the init_helper_.
-      // NOTE: This loop is compiled out in optimized builds.
-      for (const std::list<Cluster*>& cluster_list :
-           {std::cref(init_helper_.primary_init_clusters_),
-            std::cref(init_helper_.secondary_init_clusters_)}) {
-        ASSERT(!std::any_of(cluster_list.begin(), cluster_list.end(),
-                            [&existing_warming_cluster](Cluster* cluster) {
-                              return existing_warming_cluster->second->cluster_.get() == cluster;
-                            }));
-      }
+      ASSERT(init_helper_.init_cluster_positions_.count(
+                 existing_warming_cluster->second->cluster_.get()) == 0);
     }
     cm_stats_.cluster_modified_.inc();
   } else {
@@ -610,6 +613,7 @@ void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster)
 
     auto thread_local_cluster = new ThreadLocalClusterManagerImpl::ClusterEntry(
         cluster_manager, new_cluster, thread_aware_lb_factory);
+    cluster_manager.invalidateClusterHandles();
     cluster_manager.thread_local_clusters_[new_cluster->name()].reset(thread_local_cluster);
     for (auto& cb : cluster_manager.update_callbacks_) {
       cb->onClusterAddOrUpdate(*thread_local_cluster);
@@ -636,6 +640,7 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
       for (auto& cb : cluster_manager.update_callbacks_) {
         cb->onClusterRemoval(cluster_name);
       }
+      cluster_manager.invalidateClusterHandles();
       cluster_manager.thread_local_clusters_.erase(cluster_name);
     });
   }
@@ -759,48 +764,40 @@ void ClusterManagerImpl::updateClusterCounts() {
 }
 
 ThreadLocalCluster* ClusterManagerImpl::get(absl::string_view cluster) {
-  auto& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second.get();
-  } else {
-    return nullptr;
-  }
+  return tls_->getTyped<ThreadLocalClusterManagerImpl>().findCluster(cluster);
 }
 
 Http::ConnectionPool::Instance*
 ClusterManagerImpl::httpConnPoolForCluster(const std::string& cluster, ResourcePriority priority,
                                            Http::Protocol protocol, LoadBalancerContext* context) {
-  ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  auto entry = tls_->getTyped<ThreadLocalClusterManagerImpl>().findCluster(cluster);
+  if (entry == nullptr) {
     return nullptr;
   }
 
   // Select a host and create a connection pool for it if it does not already exist.
-  return entry->second->connPool(priority, protocol, context);
+  return entry->connPool(priority, protocol, context);
 }
 
 Tcp::ConnectionPool::Instance*
 ClusterManagerImpl::tcpConnPoolForCluster(const std::string& cluster, ResourcePriority priority,
                                           LoadBalancerContext* context) {
-  ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  auto entry = tls_->getTyped<ThreadLocalClusterManagerImpl>().findCluster(cluster);
+  if (entry == nullptr) {
     return nullptr;
   }
 
   // Select a host and create a connection pool for it if it does not already exist.
-  return entry->second->tcpConnPool(priority, context);
+  return entry->tcpConnPool(priority, context);
 }
 
 void ClusterManagerImpl::postThreadLocalDrainConnections(const Cluster& cluster,
                                                          const HostVector& hosts_removed) {
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), hosts_removed]() {
-    ThreadLocalClusterManagerImpl::removeHosts(name, hosts_removed, *tls_);
+  // The removed hosts are shared by all the workers instead of being copied into the callback
+  // posted to each of them.
+  tls_->runOnAllThreads([this, name = cluster.info()->name(),
+                         hosts_removed = std::make_shared<const HostVector>(hosts_removed)]() {
+    ThreadLocalClusterManagerImpl::removeHosts(name, *hosts_removed, *tls_);
   });
 }
 
@@ -809,12 +806,17 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, ui
                                                       const HostVector& hosts_removed) {
   const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[priority];
 
+  // The host lists of the host set are already immutable snapshots which every worker references.
+  // Also share the added and removed hosts, so that posting an update to the workers costs a few
+  // reference count increments per worker rather than a copy of the deltas per worker.
   tls_->runOnAllThreads([this, name = cluster.info()->name(), priority,
                          update_params = HostSetImpl::updateHostsParams(*host_set),
-                         locality_weights = host_set->localityWeights(), hosts_added, hosts_removed,
+                         locality_weights = host_set->localityWeights(),
+                         hosts_added = std::make_shared<const HostVector>(hosts_added),
+                         hosts_removed = std::make_shared<const HostVector>(hosts_removed),
                          overprovisioning_factor = host_set->overprovisioningFactor()]() {
     ThreadLocalClusterManagerImpl::updateClusterMembership(
-        name, priority, update_params, locality_weights, hosts_added, hosts_removed, *tls_,
+        name, priority, update_params, locality_weights, *hosts_added, *hosts_removed, *tls_,
         overprovisioning_factor);
   });
 }
@@ -828,17 +830,17 @@ Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(const std::stri
                                                                  LoadBalancerContext* context) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  auto entry = cluster_manager.findCluster(cluster);
+  if (entry == nullptr) {
     throw EnvoyException(fmt::format("unknown cluster '{}'", cluster));
   }
 
-  HostConstSharedPtr logical_host = entry->second->lb_->chooseHost(context);
+  HostConstSharedPtr logical_host = entry->lb_->chooseHost(context);
   if (logical_host) {
     auto conn_info = logical_host->createConnection(
         cluster_manager.thread_local_dispatcher_, nullptr,
         context == nullptr ? nullptr : context->upstreamTransportSocketOptions());
-    if ((entry->second->cluster_info_->features() &
+    if ((entry->cluster_info_->features() &
          ClusterInfo::Features::CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE) &&
         conn_info.connection_ != nullptr) {
       auto& conn_map = cluster_manager.host_tcp_conn_map_[logical_host];
@@ -848,16 +850,15 @@ Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(const std::stri
     }
     return conn_info;
   } else {
-    entry->second->cluster_info_->stats().upstream_cx_none_healthy_.inc();
+    entry->cluster_info_->stats().upstream_cx_none_healthy_.inc();
     return {nullptr, nullptr};
   }
 }
 
 Http::AsyncClient& ClusterManagerImpl::httpAsyncClientForCluster(const std::string& cluster) {
-  ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second->http_async_client_;
+  auto entry = tls_->getTyped<ThreadLocalClusterManagerImpl>().findCluster(cluster);
+  if (entry != nullptr) {
+    return entry->http_async_client_;
   } else {
     throw EnvoyException(fmt::format("unknown cluster '{}'", cluster));
   }
@@ -929,6 +930,26 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
   }
 }
 
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::findCluster(absl::string_view name) {
+  // The handles are indexed by the address of the name, whose low bits are the alignment.
+  ClusterHandle& handle =
+      cluster_handles_[(reinterpret_cast<uintptr_t>(name.data()) >> 4) % ClusterHandleCacheSize];
+  // The storage of a name may be reused for another one, so the name of the cluster is compared,
+  // which is cheaper than hashing it.
+  if (handle.generation_ == clusters_generation_ && handle.name_ == name.data() &&
+      handle.entry_->cluster_info_->name() == name) {
+    return handle.entry_;
+  }
+
+  auto entry = thread_local_clusters_.find(name);
+  if (entry == thread_local_clusters_.end()) {
+    return nullptr;
+  }
+  handle = {name.data(), entry->second.get(), clusters_generation_};
+  return entry->second.get();
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImpl() {
   // Clear out connection pools as well as the thread local cluster map so that we release all
   // cluster pointers. Currently we have to free all non-local clusters before we free
@@ -1198,6 +1219,14 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
                                                      parent.parent_.random_, cluster->lbConfig());
       break;
     }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      lb_ = std::make_unique<PeakEwmaLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, parent.thread_local_dispatcher_.timeSource(),
+          cluster->lbConfig(), cluster->lbPeakEwmaConfig());
+      break;
+    }
     case LoadBalancerType::ClusterProvided:
     case LoadBalancerType::RingHash:
     case LoadBalancerType::Maglev:
@@ -1332,7 +1361,7 @@ Http::ConnectionPool::InstancePtr ProdClusterManagerFactory::allocateConnPool(
     Http::Protocol protocol, const Network::ConnectionSocket::OptionsSharedPtr& options,
     const Network::TransportSocketOptionsSharedPtr& transport_socket_options) {
   if (protocol == Http::Protocol::Http2 &&
-      runtime_.snapshot().featureEnabled("upstream.use_http2", 100)) {
+      runtime_.snapshot().featureEnabled(use_http2_key, 100)) {
     return std::make_unique<Http::Http2::ProdConnPoolImpl>(dispatcher, host, priority, options,
                                                            transport_socket_options);
   } else if (protocol == Http::Protocol::Http3) {
@@ -1362,14 +1391,15 @@ std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr> ProdClusterManagerFactor
       outlier_event_logger, added_via_api,
       added_via_api ? validation_context_.dynamicValidationVisitor()
                     : validation_context_.staticValidationVisitor(),
-      api_);
+      api_, health_check_dispatcher_);
 }
 
 CdsApiPtr
 ProdClusterManagerFactory::createCds(const envoy::config::core::v3alpha::ConfigSource& cds_config,
                                      ClusterManager& cm) {
   // TODO(htuch): Differentiate static vs. dynamic validation visitors.
-  return CdsApiImpl::create(cds_config, cm, stats_, validation_context_.dynamicValidationVisitor());
+  return CdsApiImpl::create(cds_config, cm, stats_, validation_context_.dynamicValidationVisitor(),
+                            api_.timeSource());
 }
 
 } // namespace Upstream
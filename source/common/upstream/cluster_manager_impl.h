@@ -31,6 +31,8 @@
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -48,13 +50,14 @@ public:
                             Secret::SecretManager& secret_manager,
                             ProtobufMessage::ValidationContext& validation_context, Api::Api& api,
                             Http::Context& http_context, AccessLog::AccessLogManager& log_manager,
-                            Singleton::Manager& singleton_manager)
+                            Singleton::Manager& singleton_manager,
+                            Event::Dispatcher* health_check_dispatcher = nullptr)
       : main_thread_dispatcher_(main_thread_dispatcher), validation_context_(validation_context),
         api_(api), http_context_(http_context), admin_(admin), runtime_(runtime), stats_(stats),
         tls_(tls), random_(random), dns_resolver_(dns_resolver),
         ssl_context_manager_(ssl_context_manager), local_info_(local_info),
         secret_manager_(secret_manager), log_manager_(log_manager),
-        singleton_manager_(singleton_manager) {}
+        singleton_manager_(singleton_manager), health_check_dispatcher_(health_check_dispatcher) {}
 
   // Upstream::ClusterManagerFactory
   ClusterManagerPtr
@@ -91,6 +94,7 @@ protected:
   Secret::SecretManager& secret_manager_;
   AccessLog::AccessLogManager& log_manager_;
   Singleton::Manager& singleton_manager_;
+  Event::Dispatcher* health_check_dispatcher_;
 };
 
 // For friend declaration in ClusterManagerInitHelper.
@@ -148,6 +152,8 @@ private:
   std::function<void()> initialized_callback_;
   std::list<Cluster*> primary_init_clusters_;
   std::list<Cluster*> secondary_init_clusters_;
+  // The position of each cluster in the list of the clusters of its phase.
+  absl::flat_hash_map<Cluster*, std::list<Cluster*>::iterator> init_cluster_positions_;
   State state_{State::Loading};
   bool started_secondary_initialize_{};
 };
@@ -335,9 +341,26 @@ private:
 
     using ClusterEntryPtr = std::unique_ptr<ClusterEntry>;
 
+    // A cluster entry resolved for the storage of a cluster name, which stays valid as long as the
+    // clusters generation is the one it was resolved in.
+    struct ClusterHandle {
+      const char* name_{};
+      ClusterEntry* entry_{};
+      uint64_t generation_{};
+    };
+
+    // The number of cluster handles cached, enough for the clusters of the routes in use at once.
+    static constexpr size_t ClusterHandleCacheSize = 16;
+
     ThreadLocalClusterManagerImpl(ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
                                   const absl::optional<std::string>& local_cluster_name);
     ~ThreadLocalClusterManagerImpl() override;
+    // Finds the cluster entry of a cluster name. The names looked up again from the same storage,
+    // as those of the route entries are, are resolved from the cached handles without hashing
+    // them, until a cluster is added, updated or removed.
+    ClusterEntry* findCluster(absl::string_view name);
+    // Invalidates the cached cluster handles, before a cluster entry is replaced or removed.
+    void invalidateClusterHandles() { clusters_generation_++; }
     void drainConnPools(const HostVector& hosts);
     void drainConnPools(HostSharedPtr old_host, ConnPoolsContainer& container);
     void clearContainer(HostSharedPtr old_host, ConnPoolsContainer& container);
@@ -359,6 +382,8 @@ private:
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
+    std::array<ClusterHandle, ClusterHandleCacheSize> cluster_handles_{};
+    uint64_t clusters_generation_{1};
 
     // These maps are owned by the ThreadLocalClusterManagerImpl instead of the ClusterEntry
     // to prevent lifetime/ownership issues when a cluster is dynamically removed.
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
-#include <queue>
+#include <memory>
+#include <vector>
 
 #include "common/common/assert.h"
 
@@ -37,22 +39,57 @@ public:
         EDF_TRACE("Queue is empty.");
         return nullptr;
       }
-      const EdfEntry& edf_entry = queue_.top();
+      const EdfEntry& edf_entry = queue_.front();
+      std::shared_ptr<C> ret = edf_entry.entry_.lock();
       // Entry has been removed, let's see if there's another one.
-      if (edf_entry.entry_.expired()) {
+      if (ret == nullptr) {
         EDF_TRACE("Entry has expired, repick.");
-        queue_.pop();
+        popTop();
         continue;
       }
-      std::shared_ptr<C> ret{edf_entry.entry_};
       ASSERT(edf_entry.deadline_ >= current_time_);
       current_time_ = edf_entry.deadline_;
-      queue_.pop();
+      popTop();
       EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
       return ret;
     }
   }
 
+  /**
+   * Pick queue entry with closest deadline and add it back with the weight returned by
+   * calculate_weight. This is equivalent to pick() followed by add(), but the entry is updated in
+   * place, which avoids a second heap operation and the reference count updates of re-creating the
+   * weak reference to it.
+   * @param calculate_weight supplies the function returning the new weight of the picked entry.
+   * @return std::shared_ptr<C> to the queue entry if a valid entry exists in the queue, nullptr
+   *         otherwise.
+   */
+  template <class WeightCb> std::shared_ptr<C> pickAndAdd(const WeightCb& calculate_weight) {
+    while (true) {
+      if (queue_.empty()) {
+        EDF_TRACE("Queue is empty.");
+        return nullptr;
+      }
+      EdfEntry& edf_entry = queue_.front();
+      std::shared_ptr<C> ret = edf_entry.entry_.lock();
+      if (ret == nullptr) {
+        EDF_TRACE("Entry has expired, repick.");
+        popTop();
+        continue;
+      }
+      ASSERT(edf_entry.deadline_ >= current_time_);
+      current_time_ = edf_entry.deadline_;
+      const double weight = calculate_weight(*ret);
+      ASSERT(weight > 0);
+      edf_entry.deadline_ = current_time_ + 1.0 / weight;
+      edf_entry.order_offset_ = order_offset_++;
+      siftDownTop();
+      EDF_TRACE("Picked and re-added {} with weight {}, current_time_={}.",
+                static_cast<const void*>(ret.get()), weight, current_time_);
+      return ret;
+    }
+  }
+
   /**
    * Insert entry into queue with a given weight. The deadline will be current_time_ + 1 / weight.
    * @param weight floating point weight.
@@ -63,8 +100,9 @@ public:
     const double deadline = current_time_ + 1.0 / weight;
     EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
               static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
-    ASSERT(queue_.top().deadline_ >= current_time_);
+    queue_.push_back({deadline, order_offset_++, entry});
+    std::push_heap(queue_.begin(), queue_.end());
+    ASSERT(queue_.front().deadline_ >= current_time_);
   }
 
   /**
@@ -89,6 +127,33 @@ private:
     }
   };
 
+  void popTop() {
+    std::pop_heap(queue_.begin(), queue_.end());
+    queue_.pop_back();
+  }
+
+  // Restore the heap property after the deadline of the top entry was pushed back.
+  void siftDownTop() {
+    const size_t size = queue_.size();
+    size_t index = 0;
+    while (true) {
+      size_t earliest = index;
+      const size_t left = 2 * index + 1;
+      const size_t right = left + 1;
+      if (left < size && queue_[earliest] < queue_[left]) {
+        earliest = left;
+      }
+      if (right < size && queue_[earliest] < queue_[right]) {
+        earliest = right;
+      }
+      if (earliest == index) {
+        return;
+      }
+      std::swap(queue_[index], queue_[earliest]);
+      index = earliest;
+    }
+  }
+
   // Current time in EDF scheduler.
   // TODO(htuch): Is it worth the small extra complexity to use integer time for performance
   // reasons?
@@ -96,8 +161,9 @@ private:
   // Offset used during addition to break ties when entries have the same weight but should reflect
   // FIFO insertion order in picks.
   uint64_t order_offset_{};
-  // Min priority queue for EDF.
-  std::priority_queue<EdfEntry> queue_;
+  // Min priority queue for EDF, kept as a heap with the std heap algorithms so that the top entry
+  // can be updated in place.
+  std::vector<EdfEntry> queue_;
 };
 
 #undef EDF_DEBUG
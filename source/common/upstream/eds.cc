@@ -1,5 +1,7 @@
 #include "common/upstream/eds.h"
 
+#include <algorithm>
+
 #include "envoy/api/v2/endpoint.pb.h"
 #include "envoy/common/exception.h"
 #include "envoy/config/cluster/v3alpha/cluster.pb.h"
@@ -9,10 +11,13 @@
 #include "envoy/service/discovery/v3alpha/discovery.pb.h"
 
 #include "common/common/assert.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/config/api_version.h"
 #include "common/config/version_converter.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -26,10 +31,20 @@ EdsClusterImpl::EdsClusterImpl(
       cluster_name_(cluster.eds_cluster_config().service_name().empty()
                         ? cluster.name()
                         : cluster.eds_cluster_config().service_name()),
+      incremental_endpoints_(cluster.eds_cluster_config().incremental_endpoints()),
       validation_visitor_(factory_context.messageValidationVisitor()) {
   Event::Dispatcher& dispatcher = factory_context.dispatcher();
   assignment_timeout_ = dispatcher.createTimer([this]() -> void { onAssignmentTimeout(); });
   const auto& eds_config = cluster.eds_cluster_config().eds_config();
+  // The resources of a collection come and go individually, which only delta xDS can convey. ADS
+  // is delta or not depending on the bootstrap, and is left to the management server to get right.
+  if (incremental_endpoints_ && !eds_config.has_ads() &&
+      eds_config.api_config_source().api_type() !=
+          envoy::config::core::v3alpha::ApiConfigSource::DELTA_GRPC) {
+    throw EnvoyException(fmt::format(
+        "cluster: incremental endpoints of cluster {} require a DELTA_GRPC EDS config source",
+        cluster.name()));
+  }
   if (eds_config.config_source_specifier_case() ==
       envoy::config::core::v3alpha::ConfigSource::ConfigSourceSpecifierCase::kPath) {
     initialize_phase_ = InitializePhase::Primary;
@@ -42,7 +57,9 @@ EdsClusterImpl::EdsClusterImpl(
           info_->statsScope(), *this);
 }
 
-void EdsClusterImpl::startPreInit() { subscription_->start({cluster_name_}); }
+void EdsClusterImpl::startPreInit() {
+  subscription_->start({incremental_endpoints_ ? cluster_name_ + "/*" : cluster_name_});
+}
 
 void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) {
   std::unordered_map<std::string, HostSharedPtr> updated_hosts;
@@ -109,11 +126,210 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
   parent_.onPreInitComplete();
 }
 
+void EdsClusterImpl::IncrementalBatchUpdateHelper::batchUpdate(
+    PrioritySet::HostUpdateCb& host_update_cb) {
+  PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
+
+  // A removed resource is reconciled with no hosts, which keeps its hosts pending removal after
+  // health checking, if any.
+  PriorityState no_hosts;
+  for (const auto& resource_name : removed_resources_) {
+    const auto resource = parent_.endpoint_resources_.find(resource_name);
+    if (resource == parent_.endpoint_resources_.end()) {
+      continue;
+    }
+    updateResourceLocalityWeights(resource->second, no_hosts);
+    updateResourceHosts(resource->second, no_hosts);
+    if (std::all_of(resource->second.hosts_per_priority_.begin(),
+                    resource->second.hosts_per_priority_.end(),
+                    [](const HostVector& hosts) { return hosts.empty(); })) {
+      parent_.endpoint_resources_.erase(resource);
+    }
+  }
+
+  for (const auto& added_resource : added_resources_) {
+    const auto& cluster_load_assignment = added_resource.second;
+    PriorityStateManager resource_state_manager(parent_, parent_.local_info_, nullptr);
+    for (const auto& locality_lb_endpoint : cluster_load_assignment.endpoints()) {
+      parent_.validateEndpointsForZoneAwareRouting(locality_lb_endpoint);
+      resource_state_manager.initializePriorityFor(locality_lb_endpoint);
+      for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
+        resource_state_manager.registerHostForPriority(
+            "", parent_.resolveProtoAddress(lb_endpoint.endpoint().address()),
+            locality_lb_endpoint, lb_endpoint);
+      }
+    }
+
+    parent_.overprovisioning_factor_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        cluster_load_assignment.policy(), overprovisioning_factor, kDefaultOverProvisioningFactor);
+    auto& resource_state = resource_state_manager.priorityState();
+    EndpointResource& resource = parent_.endpoint_resources_[added_resource.first];
+    updateResourceLocalityWeights(resource, resource_state);
+    updateResourceHosts(resource, resource_state);
+  }
+
+  // Each updated priority only has the hosts removed from it filtered out and the hosts added to
+  // it appended, the hosts of the resources left out of the update are not looked at.
+  bool cluster_rebuilt = false;
+  auto& priority_state = priority_state_manager.priorityState();
+  for (auto& priority_update : priority_updates_) {
+    const uint32_t priority = priority_update.first;
+    PriorityUpdate& update = priority_update.second;
+    const auto& host_set =
+        parent_.priority_set_.getOrCreateHostSet(priority, parent_.overprovisioning_factor_);
+    if (!update.hosts_changed_ &&
+        host_set.overprovisioningFactor() == parent_.overprovisioning_factor_) {
+      continue;
+    }
+
+    absl::flat_hash_set<const Host*> hosts_removed;
+    for (const auto& host : update.hosts_removed_) {
+      hosts_removed.insert(host.get());
+    }
+    absl::flat_hash_set<const Host*> hosts_present;
+    HostVectorSharedPtr hosts(new HostVector());
+    hosts->reserve(host_set.hosts().size() + update.hosts_added_.size());
+    for (const auto& host : host_set.hosts()) {
+      if (hosts_removed.count(host.get()) == 0 && hosts_present.insert(host.get()).second) {
+        hosts->push_back(host);
+      }
+    }
+    for (const auto& host : update.hosts_added_) {
+      if (hosts_present.insert(host.get()).second) {
+        hosts->push_back(host);
+      }
+    }
+
+    if (priority_state.size() <= priority) {
+      priority_state.resize(priority + 1);
+    }
+    priority_state[priority].second = priorityLocalityWeights(priority);
+    ENVOY_LOG(debug, "EDS hosts changed for cluster: {} ({} hosts) priority {}",
+              parent_.info_->name(), hosts->size(), priority);
+    priority_state_manager.updateClusterPrioritySet(
+        priority, std::move(hosts), update.hosts_added_, update.hosts_removed_, absl::nullopt,
+        parent_.overprovisioning_factor_);
+    cluster_rebuilt = true;
+  }
+
+  if (!cluster_rebuilt) {
+    parent_.info_->stats().update_no_rebuild_.inc();
+  }
+
+  parent_.onPreInitComplete();
+}
+
+void EdsClusterImpl::IncrementalBatchUpdateHelper::updateResourceLocalityWeights(
+    EndpointResource& resource, PriorityState& new_state) {
+  auto& locality_weights = resource.locality_weights_per_priority_;
+  const size_t priorities = std::max(locality_weights.size(), new_state.size());
+  locality_weights.resize(priorities);
+  for (size_t i = 0; i < priorities; ++i) {
+    LocalityWeightsMap new_locality_weights =
+        i < new_state.size() ? std::move(new_state[i].second) : LocalityWeightsMap();
+    if (locality_weights[i] != new_locality_weights) {
+      locality_weights[i] = std::move(new_locality_weights);
+      priority_updates_[i].hosts_changed_ = true;
+    }
+  }
+
+  while (!locality_weights.empty() && locality_weights.back().empty()) {
+    locality_weights.pop_back();
+  }
+}
+
+EdsClusterImpl::LocalityWeightsMap
+EdsClusterImpl::IncrementalBatchUpdateHelper::priorityLocalityWeights(uint32_t priority) const {
+  // Recomputed for each update, so that the localities of removed resources, or which a resource
+  // no longer has, are dropped. A locality in several resources takes the largest of its weights.
+  LocalityWeightsMap locality_weights;
+  for (const auto& resource : parent_.endpoint_resources_) {
+    const auto& resource_locality_weights = resource.second.locality_weights_per_priority_;
+    if (priority >= resource_locality_weights.size()) {
+      continue;
+    }
+    for (const auto& locality_weight : resource_locality_weights[priority]) {
+      uint32_t& weight = locality_weights[locality_weight.first];
+      weight = std::max(weight, locality_weight.second);
+    }
+  }
+  return locality_weights;
+}
+
+void EdsClusterImpl::IncrementalBatchUpdateHelper::updateResourceHosts(EndpointResource& resource,
+                                                                       PriorityState& new_hosts) {
+  auto& hosts_per_priority = resource.hosts_per_priority_;
+  if (hosts_per_priority.size() < new_hosts.size()) {
+    hosts_per_priority.resize(new_hosts.size());
+  }
+
+  const HostVector no_hosts;
+  HostMap updated_hosts;
+  HostVector resource_hosts_removed;
+  for (size_t i = 0; i < hosts_per_priority.size(); ++i) {
+    // The hosts of the resource that were dropped from the cluster since, e.g. when excluded after
+    // failing health checking while pending removal, are no longer its hosts.
+    HostVector& current_hosts = hosts_per_priority[i];
+    current_hosts.erase(std::remove_if(current_hosts.begin(), current_hosts.end(),
+                                       [this](const HostSharedPtr& host) {
+                                         const auto it =
+                                             parent_.all_hosts_.find(host->address()->asString());
+                                         return it == parent_.all_hosts_.end() ||
+                                                it->second != host;
+                                       }),
+                        current_hosts.end());
+
+    const HostVector& new_priority_hosts =
+        i < new_hosts.size() && new_hosts[i].first != nullptr ? *new_hosts[i].first : no_hosts;
+    HostVector hosts_added;
+    HostVector hosts_removed;
+    const bool hosts_updated =
+        parent_.updateDynamicHostList(new_priority_hosts, current_hosts, hosts_added,
+                                      hosts_removed, updated_hosts, parent_.all_hosts_);
+    if (hosts_updated || !hosts_added.empty() || !hosts_removed.empty()) {
+      PriorityUpdate& update = priority_updates_[i];
+      update.hosts_changed_ = true;
+      update.hosts_added_.insert(update.hosts_added_.end(), hosts_added.begin(),
+                                 hosts_added.end());
+      update.hosts_removed_.insert(update.hosts_removed_.end(), hosts_removed.begin(),
+                                   hosts_removed.end());
+      resource_hosts_removed.insert(resource_hosts_removed.end(), hosts_removed.begin(),
+                                    hosts_removed.end());
+    }
+  }
+
+  while (!hosts_per_priority.empty() && hosts_per_priority.back().empty()) {
+    hosts_per_priority.pop_back();
+  }
+
+  for (const auto& host : resource_hosts_removed) {
+    const auto it = parent_.all_hosts_.find(host->address()->asString());
+    if (it != parent_.all_hosts_.end() && it->second == host &&
+        updated_hosts.count(it->first) == 0) {
+      parent_.all_hosts_.erase(it);
+    }
+  }
+  for (auto& host : updated_hosts) {
+    parent_.all_hosts_[host.first] = std::move(host.second);
+  }
+}
+
 void EdsClusterImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                                     const std::string&) {
   if (!validateUpdateSize(resources.size())) {
     return;
   }
+  // Management servers commonly resend unchanged assignments, which are neither unpacked nor
+  // applied again.
+  const uint64_t assignment_hash = HashUtil::xxHash64(resources[0].value());
+  if (assignment_hash_.has_value() && assignment_hash_.value() == assignment_hash) {
+    ENVOY_LOG(debug, "EDS assignment for cluster {} is unchanged", cluster_name_);
+    updateAssignmentTimeout(assignment_stale_after_ms_);
+    info_->stats().update_no_rebuild_.inc();
+    onPreInitComplete();
+    return;
+  }
+
   auto cluster_load_assignment =
       MessageUtil::anyConvert<envoy::config::endpoint::v3alpha::ClusterLoadAssignment>(
           resources[0]);
@@ -126,26 +342,55 @@ void EdsClusterImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt
   // this is significant memory overhead.
   Config::VersionConverter::eraseOriginalTypeInformation(cluster_load_assignment);
 
+  // Check if endpoint_stale_after is set.
+  const uint64_t stale_after_ms =
+      PROTOBUF_GET_MS_OR_DEFAULT(cluster_load_assignment.policy(), endpoint_stale_after, 0);
+  updateAssignmentTimeout(stale_after_ms);
+
+  BatchUpdateHelper helper(*this, cluster_load_assignment);
+  priority_set_.batchHostUpdate(helper);
+  assignment_hash_ = assignment_hash;
+  assignment_stale_after_ms_ = stale_after_ms;
+}
+
+void EdsClusterImpl::updateAssignmentTimeout(uint64_t stale_after_ms) {
   // Disable timer (if enabled) as we have received new assignment.
   if (assignment_timeout_->enabled()) {
     assignment_timeout_->disableTimer();
   }
-  // Check if endpoint_stale_after is set.
-  const uint64_t stale_after_ms =
-      PROTOBUF_GET_MS_OR_DEFAULT(cluster_load_assignment.policy(), endpoint_stale_after, 0);
   if (stale_after_ms > 0) {
     // Stat to track how often we receive valid assignment_timeout in response.
     info_->stats().assignment_timeout_received_.inc();
     assignment_timeout_->enableTimer(std::chrono::milliseconds(stale_after_ms));
   }
-
-  BatchUpdateHelper helper(*this, cluster_load_assignment);
-  priority_set_.batchHostUpdate(helper);
 }
 
 void EdsClusterImpl::onConfigUpdate(
     const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>& resources,
-    const Protobuf::RepeatedPtrField<std::string>&, const std::string&) {
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources, const std::string&) {
+  if (incremental_endpoints_) {
+    // All the resources are validated before any is applied, so that a bad update is rejected as a
+    // whole.
+    std::vector<EndpointResourceUpdate> added_resources;
+    added_resources.reserve(resources.size());
+    for (const auto& resource : resources) {
+      auto cluster_load_assignment =
+          MessageUtil::anyConvert<envoy::config::endpoint::v3alpha::ClusterLoadAssignment>(
+              resource.resource());
+      MessageUtil::validate(cluster_load_assignment, validation_visitor_);
+      if (cluster_load_assignment.cluster_name() != cluster_name_) {
+        throw EnvoyException(fmt::format("Unexpected EDS cluster (expecting {}): {}",
+                                         cluster_name_, cluster_load_assignment.cluster_name()));
+      }
+      Config::VersionConverter::eraseOriginalTypeInformation(cluster_load_assignment);
+      added_resources.emplace_back(resource.name(), std::move(cluster_load_assignment));
+    }
+
+    IncrementalBatchUpdateHelper helper(*this, added_resources, removed_resources);
+    priority_set_.batchHostUpdate(helper);
+    return;
+  }
+
   if (!validateUpdateSize(resources.size())) {
     return;
   }
@@ -225,6 +470,21 @@ void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
   if (host_to_exclude != nullptr) {
     ASSERT(all_hosts_.find(host_to_exclude->address()->asString()) != all_hosts_.end());
     all_hosts_.erase(host_to_exclude->address()->asString());
+
+    // The resource the host was kept for may have been removed, in which case nothing else would
+    // release it.
+    for (auto resource = endpoint_resources_.begin(); resource != endpoint_resources_.end();) {
+      bool empty = resource->second.locality_weights_per_priority_.empty();
+      for (auto& hosts : resource->second.hosts_per_priority_) {
+        hosts.erase(std::remove(hosts.begin(), hosts.end(), host_to_exclude), hosts.end());
+        empty &= hosts.empty();
+      }
+      if (empty) {
+        endpoint_resources_.erase(resource++);
+      } else {
+        ++resource;
+      }
+    }
   }
 }
 
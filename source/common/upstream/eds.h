@@ -12,11 +12,14 @@
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/locality.h"
 
+#include "common/config/utility.h"
 #include "common/upstream/cluster_factory_impl.h"
 #include "common/upstream/upstream_impl.h"
 
 #include "extensions/clusters/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -42,9 +45,9 @@ private:
   void onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
                             const EnvoyException* e) override;
   std::string resourceName(const ProtobufWkt::Any& resource) override {
-    return MessageUtil::anyConvert<envoy::config::endpoint::v3alpha::ClusterLoadAssignment>(
-               resource)
-        .cluster_name();
+    return Config::Utility::anyStringField(
+        resource,
+        envoy::config::endpoint::v3alpha::ClusterLoadAssignment::kClusterNameFieldNumber);
   }
   static std::string loadTypeUrl(envoy::config::core::v3alpha::ApiVersion resource_api_version);
   using LocalityWeightsMap = std::unordered_map<envoy::config::core::v3alpha::Locality, uint32_t,
@@ -55,6 +58,7 @@ private:
                               PriorityStateManager& priority_state_manager,
                               std::unordered_map<std::string, HostSharedPtr>& updated_hosts);
   bool validateUpdateSize(int num_resources);
+  void updateAssignmentTimeout(uint64_t stale_after_ms);
 
   // ClusterImplBase
   void reloadHealthyHostsHelper(const HostSharedPtr& host) override;
@@ -76,12 +80,64 @@ private:
     const envoy::config::endpoint::v3alpha::ClusterLoadAssignment& cluster_load_assignment_;
   };
 
+  // The hosts and the locality weights of a resource of an incremental cluster, by priority.
+  struct EndpointResource {
+    std::vector<HostVector> hosts_per_priority_;
+    std::vector<LocalityWeightsMap> locality_weights_per_priority_;
+  };
+
+  using EndpointResourceUpdate =
+      std::pair<std::string, envoy::config::endpoint::v3alpha::ClusterLoadAssignment>;
+
+  // Applies a delta update of the resources of an incremental cluster. Only the hosts of the
+  // resources in the update are reconciled, and only the priorities they have hosts at are updated.
+  class IncrementalBatchUpdateHelper : public PrioritySet::BatchUpdateCb {
+  public:
+    IncrementalBatchUpdateHelper(EdsClusterImpl& parent,
+                                 const std::vector<EndpointResourceUpdate>& added_resources,
+                                 const Protobuf::RepeatedPtrField<std::string>& removed_resources)
+        : parent_(parent), added_resources_(added_resources),
+          removed_resources_(removed_resources) {}
+
+    // Upstream::PrioritySet::BatchUpdateCb
+    void batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) override;
+
+  private:
+    struct PriorityUpdate {
+      HostVector hosts_added_;
+      HostVector hosts_removed_;
+      bool hosts_changed_{};
+    };
+
+    // Reconciles the hosts of a resource with its new hosts, by priority.
+    void updateResourceHosts(EndpointResource& resource, PriorityState& new_hosts);
+    // Replaces the locality weights of a resource with its new ones, by priority.
+    void updateResourceLocalityWeights(EndpointResource& resource, PriorityState& new_state);
+    // The locality weights of a priority, merged from those of all the resources.
+    LocalityWeightsMap priorityLocalityWeights(uint32_t priority) const;
+
+    EdsClusterImpl& parent_;
+    const std::vector<EndpointResourceUpdate>& added_resources_;
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources_;
+    std::map<uint32_t, PriorityUpdate> priority_updates_;
+  };
+
   std::unique_ptr<Config::Subscription> subscription_;
   const LocalInfo::LocalInfo& local_info_;
   const std::string cluster_name_;
+  const bool incremental_endpoints_;
+  // The resources of an incremental cluster by name.
+  absl::flat_hash_map<std::string, EndpointResource> endpoint_resources_;
+  // The overprovisioning factor of the last resource of an incremental cluster.
+  uint32_t overprovisioning_factor_{kDefaultOverProvisioningFactor};
+  // The locality weights of a cluster updated with the state of the world, by priority.
   std::vector<LocalityWeightsMap> locality_weights_map_;
   HostMap all_hosts_;
   Event::TimerPtr assignment_timeout_;
+  // The hash of the serialized last applied assignment, and its endpoint_stale_after, so that an
+  // unchanged assignment is not unpacked again.
+  absl::optional<uint64_t> assignment_hash_;
+  uint64_t assignment_stale_after_ms_{};
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   InitializePhase initialize_phase_;
 };
@@ -0,0 +1,36 @@
+#include "common/upstream/health_check_thread.h"
+
+namespace Envoy {
+namespace Upstream {
+
+HealthCheckThread::HealthCheckThread(Api::Api& api, ThreadLocal::Instance& tls)
+    : tls_(tls), dispatcher_(api.allocateDispatcher()) {
+  tls_.registerThread(*dispatcher_, false);
+  thread_ = api.threadFactory().createThread([this]() -> void { threadRoutine(); });
+}
+
+HealthCheckThread::~HealthCheckThread() { stop(); }
+
+void HealthCheckThread::stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  // Exiting from a callback lets the callbacks posted before it run first.
+  dispatcher_->post([this]() -> void { dispatcher_->exit(); });
+  thread_->join();
+  thread_.reset();
+}
+
+void HealthCheckThread::threadRoutine() {
+  ENVOY_LOG(debug, "health check thread entering dispatch loop");
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "health check thread exited dispatch loop");
+
+  // Destroy the connections closed by the health checkers on this thread, as their destructors
+  // might reference thread locals.
+  dispatcher_->clearDeferredDeleteList();
+  tls_.shutdownThread();
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Dedicated thread on which the active health checks run, so that health checking large numbers
+ * of hosts and the main thread do not delay each other. Like the workers, it is registered for
+ * thread local updates so that stats and runtime can be used from it, and so it must be created
+ * before any thread local data is set.
+ */
+class HealthCheckThread : Logger::Loggable<Logger::Id::health_checker> {
+public:
+  HealthCheckThread(Api::Api& api, ThreadLocal::Instance& tls);
+  ~HealthCheckThread();
+
+  /**
+   * @return the dispatcher of the thread.
+   */
+  Event::Dispatcher& dispatcher() { return *dispatcher_; }
+
+  /**
+   * Stop the thread once the callbacks already posted to it have run, such as the destruction of
+   * the health checkers of the clusters removed by the cluster manager shutdown.
+   */
+  void stop();
+
+private:
+  void threadRoutine();
+
+  ThreadLocal::Instance& tls_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+};
+
+using HealthCheckThreadPtr = std::unique_ptr<HealthCheckThread>;
+
+} // namespace Upstream
+} // namespace Envoy
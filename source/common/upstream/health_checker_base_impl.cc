@@ -1,13 +1,18 @@
 #include "common/upstream/health_checker_base_impl.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3alpha/address.pb.h"
 #include "envoy/config/core/v3alpha/health_check.pb.h"
 #include "envoy/data/core/v3alpha/health_check_event.pb.h"
 #include "envoy/stats/scope.h"
 
 #include "common/network/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/router/router.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -16,7 +21,7 @@ HealthCheckerImplBase::HealthCheckerImplBase(
     Event::Dispatcher& dispatcher, Runtime::Loader& runtime, Runtime::RandomGenerator& random,
     HealthCheckEventLoggerPtr&& event_logger)
     : always_log_health_check_failures_(config.always_log_health_check_failures()),
-      cluster_(cluster), dispatcher_(dispatcher),
+      cluster_(cluster), cluster_info_(cluster.info()), dispatcher_(dispatcher),
       timeout_(PROTOBUF_GET_MS_REQUIRED(config, timeout)),
       unhealthy_threshold_(PROTOBUF_GET_WRAPPED_REQUIRED(config, unhealthy_threshold)),
       healthy_threshold_(PROTOBUF_GET_WRAPPED_REQUIRED(config, healthy_threshold)),
@@ -33,7 +38,10 @@ HealthCheckerImplBase::HealthCheckerImplBase(
           PROTOBUF_GET_MS_OR_DEFAULT(config, unhealthy_edge_interval, unhealthy_interval_.count())),
       healthy_edge_interval_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
-      transport_socket_options_(initTransportSocketOptions(config)) {
+      transport_socket_options_(initTransportSocketOptions(config)),
+      shared_sessions_(config.share_across_clusters() ? SharedSessions::get(dispatcher) : nullptr),
+      config_hash_(config.share_across_clusters() ? MessageUtil::hash(config) : 0),
+      interval_batching_tick_(PROTOBUF_GET_MS_OR_DEFAULT(config, interval_batching_tick, 0)) {
   cluster_.prioritySet().addMemberUpdateCb(
       [this](const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
         onClusterMemberUpdate(hosts_added, hosts_removed);
@@ -56,6 +64,7 @@ HealthCheckerImplBase::initTransportSocketOptions(
 HealthCheckerImplBase::~HealthCheckerImplBase() {
   // ASSERTs inside the session destructor check to make sure we have been previously deferred
   // deleted. Unify that logic here before actual destruction happens.
+  destroying_ = true;
   for (auto& session : active_sessions_) {
     session.second->onDeferredDeleteBase();
   }
@@ -97,7 +106,7 @@ std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
   // If a connection has been established, we choose an interval based on the host's health. Please
   // refer to the HealthCheck API documentation for more details.
   uint64_t base_time_ms;
-  if (cluster_.info()->stats().upstream_cx_total_.used()) {
+  if (cluster_info_->stats().upstream_cx_total_.used()) {
     // When healthy/unhealthy threshold is configured the health transition of a host will be
     // delayed. In this situation Envoy should use the edge interval settings between health checks.
     //
@@ -147,20 +156,54 @@ HealthCheckerImplBase::intervalWithJitter(uint64_t base_time_ms,
   return std::chrono::milliseconds(final_ms);
 }
 
+Event::TimerPtr HealthCheckerImplBase::createIntervalTimer(Event::TimerCb cb) {
+  if (interval_batching_tick_.count() == 0) {
+    return dispatcher_.createTimer(cb);
+  }
+  if (interval_wheel_ == nullptr) {
+    interval_wheel_ = std::make_unique<Event::TimerWheel>(dispatcher_, interval_batching_tick_);
+  }
+  return interval_wheel_->createTimer(cb);
+}
+
 void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
   for (const HostSharedPtr& host : hosts) {
-    active_sessions_[host] = makeSession(host);
+    ActiveHealthCheckSessionPtr& session = active_sessions_[host];
+    session = makeSession(host);
+    if (shared_sessions_ != nullptr) {
+      session->shared_key_ =
+          absl::StrCat(host->healthCheckAddress()->asString(), "_", config_hash_);
+      if (!shared_sessions_->add(*session)) {
+        // The host is checked by the session of another cluster.
+        continue;
+      }
+    }
+    session->start();
+  }
+}
+
+void HealthCheckerImplBase::onClusterMemberUpdate(const HostVector& hosts_added,
+                                                  const HostVector& hosts_removed) {
+  for (const HostSharedPtr& host : hosts_added) {
     host->setActiveHealthFailureType(Host::ActiveHealthFailureType::UNKNOWN);
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
-    active_sessions_[host]->start();
   }
+  if (main_thread_dispatcher_ == nullptr) {
+    addHosts(hosts_added);
+    removeHosts(hosts_removed);
+    return;
+  }
+  // The health checker is destroyed on the dispatcher of the sessions, after the updates posted
+  // to it, so they can capture it.
+  dispatcher_.post([this, hosts_added, hosts_removed]() -> void {
+    addHosts(hosts_added);
+    removeHosts(hosts_removed);
+  });
 }
 
-void HealthCheckerImplBase::onClusterMemberUpdate(const HostVector& hosts_added,
-                                                  const HostVector& hosts_removed) {
-  addHosts(hosts_added);
-  for (const HostSharedPtr& host : hosts_removed) {
+void HealthCheckerImplBase::removeHosts(const HostVector& hosts) {
+  for (const HostSharedPtr& host : hosts) {
     auto session_iter = active_sessions_.find(host);
     ASSERT(active_sessions_.end() != session_iter);
     // This deletion can happen inline in response to a host failure, so we deferred delete.
@@ -184,11 +227,43 @@ void HealthCheckerImplBase::runCallbacks(HostSharedPtr host, HealthTransition ch
   // any HC happens against a host so just refresh the healthy stat here so that it is correct.
   refreshHealthyStat();
 
+  if (main_thread_dispatcher_ != nullptr) {
+    // The results reported until the main thread runs the callbacks are applied in one batch.
+    {
+      Thread::LockGuard lock(pending_callbacks_lock_);
+      pending_callbacks_.emplace_back(std::move(host), changed_state);
+      if (pending_callbacks_.size() > 1) {
+        return;
+      }
+    }
+    std::weak_ptr<HealthCheckerImplBase> weak_this = weak_this_;
+    main_thread_dispatcher_->post([weak_this]() -> void {
+      std::shared_ptr<HealthCheckerImplBase> shared_this = weak_this.lock();
+      if (shared_this != nullptr) {
+        shared_this->runPendingCallbacks();
+      }
+    });
+    return;
+  }
+
   for (const HostStatusCb& cb : callbacks_) {
     cb(host, changed_state);
   }
 }
 
+void HealthCheckerImplBase::runPendingCallbacks() {
+  std::vector<std::pair<HostSharedPtr, HealthTransition>> pending_callbacks;
+  {
+    Thread::LockGuard lock(pending_callbacks_lock_);
+    pending_callbacks.swap(pending_callbacks_);
+  }
+  for (const auto& pending_callback : pending_callbacks) {
+    for (const HostStatusCb& cb : callbacks_) {
+      cb(pending_callback.first, pending_callback.second);
+    }
+  }
+}
+
 void HealthCheckerImplBase::HealthCheckHostMonitorImpl::setUnhealthy() {
   // This is called cross thread. The cluster/health checker might already be gone.
   std::shared_ptr<HealthCheckerImplBase> health_checker = health_checker_.lock();
@@ -222,15 +297,67 @@ void HealthCheckerImplBase::setUnhealthyCrossThread(const HostSharedPtr& host) {
 }
 
 void HealthCheckerImplBase::start() {
+  if (main_thread_dispatcher_ != nullptr) {
+    weak_this_ = shared_from_this();
+  }
   for (auto& host_set : cluster_.prioritySet().hostSetsPerPriority()) {
-    addHosts(host_set->hosts());
+    onClusterMemberUpdate(host_set->hosts(), {});
   }
 }
 
+std::shared_ptr<HealthCheckerImplBase::SharedSessions>
+HealthCheckerImplBase::SharedSessions::get(Event::Dispatcher& dispatcher) {
+  // The health checkers sharing their health checks keep the shared sessions alive. As the
+  // sessions of a dispatcher only run on its thread, each dispatcher has its own shared sessions.
+  // The health checkers are always created on the main thread.
+  static auto* shared_sessions =
+      new absl::flat_hash_map<Event::Dispatcher*, std::weak_ptr<SharedSessions>>();
+  std::weak_ptr<SharedSessions>& weak_sessions = (*shared_sessions)[&dispatcher];
+  std::shared_ptr<SharedSessions> sessions = weak_sessions.lock();
+  if (sessions == nullptr) {
+    sessions = std::make_shared<SharedSessions>();
+    weak_sessions = sessions;
+  }
+  return sessions;
+}
+
+bool HealthCheckerImplBase::SharedSessions::add(ActiveHealthCheckSession& session) {
+  std::list<ActiveHealthCheckSession*>& sessions = sessions_[session.shared_key_];
+  sessions.push_back(&session);
+  return sessions.size() == 1;
+}
+
+HealthCheckerImplBase::ActiveHealthCheckSession*
+HealthCheckerImplBase::SharedSessions::remove(ActiveHealthCheckSession& session) {
+  auto it = sessions_.find(session.shared_key_);
+  ASSERT(it != sessions_.end());
+  const bool was_checking = it->second.front() == &session;
+  it->second.remove(&session);
+  if (it->second.empty()) {
+    sessions_.erase(it);
+    return nullptr;
+  }
+  return was_checking ? it->second.front() : nullptr;
+}
+
+std::vector<HealthCheckerImplBase::ActiveHealthCheckSession*>
+HealthCheckerImplBase::SharedSessions::followers(const ActiveHealthCheckSession& session) const {
+  auto it = sessions_.find(session.shared_key_);
+  ASSERT(it != sessions_.end() && it->second.front() == &session);
+  return {std::next(it->second.begin()), it->second.end()};
+}
+
+bool HealthCheckerImplBase::SharedSessions::contains(
+    const ActiveHealthCheckSession& session) const {
+  auto it = sessions_.find(session.shared_key_);
+  return it != sessions_.end() &&
+         std::find(it->second.begin(), it->second.end(), &session) != it->second.end();
+}
+
 HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
     HealthCheckerImplBase& parent, HostSharedPtr host)
     : host_(host), parent_(parent),
-      interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
+      interval_timer_(parent.createIntervalTimer([this]() -> void { onIntervalBase(); })),
       timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })) {
 
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
@@ -248,6 +375,11 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
   ASSERT(interval_timer_ == nullptr && timeout_timer_ == nullptr);
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  ASSERT(interval_timer_ != nullptr);
+  onInitialInterval();
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   // The session is about to be deferred deleted. Make sure all timers are gone and any
   // implementation specific state is destroyed.
@@ -260,9 +392,31 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
     parent_.decDegraded();
   }
   onDeferredDelete();
+  if (!shared_key_.empty()) {
+    // If this session was checking the host for other clusters, the next one takes over.
+    ActiveHealthCheckSession* next = parent_.shared_sessions_->remove(*this);
+    if (next != nullptr && !next->parent_.destroying_) {
+      next->start();
+    }
+  }
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  // Share the result first, as the callbacks may cause this session to be deferred deleted, after
+  // which it is no longer checking the host for the other clusters.
+  if (!shared_key_.empty()) {
+    shareSuccess(degraded);
+    if (timeout_timer_ == nullptr) {
+      return;
+    }
+  }
+  HealthTransition changed_state = setHealthy(degraded);
+
+  timeout_timer_->disableTimer();
+  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+}
+
+HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setHealthy(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -310,9 +464,25 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   parent_.stats_.success_.inc();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
+  return changed_state;
+}
 
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+void HealthCheckerImplBase::ActiveHealthCheckSession::shareSuccess(bool degraded) {
+  for (ActiveHealthCheckSession* session : parent_.shared_sessions_->followers(*this)) {
+    // The callbacks of a cluster may remove hosts of the others, so skip the removed sessions.
+    if (parent_.shared_sessions_->contains(*session)) {
+      session->setHealthy(degraded);
+    }
+  }
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::shareFailure(
+    envoy::data::core::v3alpha::HealthCheckFailureType type) {
+  for (ActiveHealthCheckSession* session : parent_.shared_sessions_->followers(*this)) {
+    if (parent_.shared_sessions_->contains(*session)) {
+      session->setUnhealthy(type);
+    }
+  }
 }
 
 HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
@@ -355,6 +525,9 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v3alpha::HealthCheckFailureType type) {
+  if (!shared_key_.empty()) {
+    shareFailure(type);
+  }
   HealthTransition changed_state = setUnhealthy(type);
   // It's possible that the previous call caused this session to be deferred deleted.
   if (timeout_timer_ != nullptr) {
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/core/v3alpha/health_check.pb.h"
 #include "envoy/data/core/v3alpha/health_check_event.pb.h"
@@ -11,8 +17,12 @@
 
 #include "common/common/logger.h"
 #include "common/common/matchers.h"
+#include "common/common/thread.h"
+#include "common/event/timer_wheel.h"
 #include "common/network/transport_socket_options_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -50,13 +60,24 @@ public:
     return transport_socket_options_;
   }
 
+  /**
+   * Run the sessions on the dispatcher passed at construction, which is then the one of the
+   * dedicated health check thread, rather than on the main thread. The cluster membership updates
+   * are posted to the sessions, and their results are posted back to the main thread in batches,
+   * where the host status callbacks run. Must be called before start().
+   * @param main_thread_dispatcher supplies the dispatcher of the main thread.
+   */
+  void setMainThreadDispatcher(Event::Dispatcher& main_thread_dispatcher) {
+    main_thread_dispatcher_ = &main_thread_dispatcher;
+  }
+
 protected:
   class ActiveHealthCheckSession : public Event::DeferredDeletable {
   public:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v3alpha::HealthCheckFailureType type);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start();
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -72,6 +93,10 @@ protected:
     // been health checked.
     // Returns the changed state to use following the flag update.
     HealthTransition clearPendingFlag(HealthTransition changed_state);
+    HealthTransition setHealthy(bool degraded);
+    // Applies the result of an active health check to the sessions sharing it.
+    void shareSuccess(bool degraded);
+    void shareFailure(envoy::data::core::v3alpha::HealthCheckFailureType type);
     virtual void onInterval() PURE;
     void onIntervalBase();
     virtual void onTimeout() PURE;
@@ -85,6 +110,10 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    // The key of the host in the shared sessions, empty if the health checks are not shared.
+    std::string shared_key_;
+
+    friend class HealthCheckerImplBase;
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -99,7 +128,9 @@ protected:
   virtual envoy::data::core::v3alpha::HealthCheckerType healthCheckerType() const PURE;
 
   const bool always_log_health_check_failures_;
+  // Only used on the main thread, the sessions use cluster_info_ which they keep alive.
   const Cluster& cluster_;
+  const ClusterInfoConstSharedPtr cluster_info_;
   Event::Dispatcher& dispatcher_;
   const std::chrono::milliseconds timeout_;
   const uint32_t unhealthy_threshold_;
@@ -111,6 +142,35 @@ protected:
   HealthCheckEventLoggerPtr event_logger_;
 
 private:
+  /**
+   * The sessions of the health checkers which share their health checks, keyed by health check
+   * address and configuration. The first session of a key checks the host and applies its results
+   * to the others, which stay idle until it is removed. Like the sessions, it is only used on the
+   * thread of their dispatcher.
+   */
+  class SharedSessions {
+  public:
+    static std::shared_ptr<SharedSessions> get(Event::Dispatcher& dispatcher);
+
+    /**
+     * @return true if the session is the first of its key, and so should check its host.
+     */
+    bool add(ActiveHealthCheckSession& session);
+    /**
+     * @return the session which now checks the host of the removed session, or nullptr if there is
+     *         none or it did not change.
+     */
+    ActiveHealthCheckSession* remove(ActiveHealthCheckSession& session);
+    /**
+     * @return the sessions to apply the results of the first session of a key to.
+     */
+    std::vector<ActiveHealthCheckSession*> followers(const ActiveHealthCheckSession& session) const;
+    bool contains(const ActiveHealthCheckSession& session) const;
+
+  private:
+    absl::flat_hash_map<std::string, std::list<ActiveHealthCheckSession*>> sessions_;
+  };
+
   struct HealthCheckHostMonitorImpl : public HealthCheckHostMonitor {
     HealthCheckHostMonitorImpl(const std::shared_ptr<HealthCheckerImplBase>& health_checker,
                                const HostSharedPtr& host)
@@ -124,6 +184,7 @@ private:
   };
 
   void addHosts(const HostVector& hosts);
+  Event::TimerPtr createIntervalTimer(Event::TimerCb cb);
   void decHealthy();
   void decDegraded();
   HealthCheckerStats generateStats(Stats::Scope& scope);
@@ -134,7 +195,9 @@ private:
                                                std::chrono::milliseconds interval_jitter) const;
   void onClusterMemberUpdate(const HostVector& hosts_added, const HostVector& hosts_removed);
   void refreshHealthyStat();
+  void removeHosts(const HostVector& hosts);
   void runCallbacks(HostSharedPtr host, HealthTransition changed_state);
+  void runPendingCallbacks();
   void setUnhealthyCrossThread(const HostSharedPtr& host);
   static std::shared_ptr<const Network::TransportSocketOptionsImpl>
   initTransportSocketOptions(const envoy::config::core::v3alpha::HealthCheck& config);
@@ -154,6 +217,25 @@ private:
   uint64_t local_process_healthy_{};
   uint64_t local_process_degraded_{};
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
+  // Set if the health checks are shared across clusters, along with the hash of the configuration
+  // which is part of the key of the shared sessions.
+  const std::shared_ptr<SharedSessions> shared_sessions_;
+  const uint64_t config_hash_;
+  // Set while the sessions are torn down, so that none of them is started to take over a host.
+  bool destroying_{};
+  // Set if the interval timers of the sessions are batched, the wheel is created by the first
+  // session on the thread of the dispatcher.
+  const std::chrono::milliseconds interval_batching_tick_;
+  Event::TimerWheelPtr interval_wheel_;
+  // Set if the sessions do not run on the main thread.
+  Event::Dispatcher* main_thread_dispatcher_{};
+  // Set by start() if the sessions do not run on the main thread, as they cannot use
+  // shared_from_this() once the health checker is being destroyed.
+  std::weak_ptr<HealthCheckerImplBase> weak_this_;
+  Thread::MutexBasicLockable pending_callbacks_lock_;
+  // The results of the health checks whose callbacks have not yet run on the main thread.
+  std::vector<std::pair<HostSharedPtr, HealthTransition>>
+      pending_callbacks_ GUARDED_BY(pending_callbacks_lock_);
 };
 
 class HealthCheckEventLoggerImpl : public HealthCheckEventLogger {
@@ -63,27 +63,35 @@ HealthCheckerSharedPtr HealthCheckerFactory::create(
     const envoy::config::core::v3alpha::HealthCheck& health_check_config,
     Upstream::Cluster& cluster, Runtime::Loader& runtime, Runtime::RandomGenerator& random,
     Event::Dispatcher& dispatcher, AccessLog::AccessLogManager& log_manager,
-    ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api) {
+    ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+    Event::Dispatcher* health_check_dispatcher) {
   HealthCheckEventLoggerPtr event_logger;
   if (!health_check_config.event_log_path().empty()) {
     event_logger = std::make_unique<HealthCheckEventLoggerImpl>(
         log_manager, dispatcher.timeSource(), health_check_config.event_log_path());
   }
+  Event::Dispatcher& session_dispatcher =
+      health_check_dispatcher != nullptr ? *health_check_dispatcher : dispatcher;
+  std::unique_ptr<HealthCheckerImplBase> health_checker;
   switch (health_check_config.health_checker_case()) {
   case envoy::config::core::v3alpha::HealthCheck::HealthCheckerCase::kHttpHealthCheck:
-    return std::make_shared<ProdHttpHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, random, std::move(event_logger));
+    health_checker = std::make_unique<ProdHttpHealthCheckerImpl>(
+        cluster, health_check_config, session_dispatcher, runtime, random, std::move(event_logger));
+    break;
   case envoy::config::core::v3alpha::HealthCheck::HealthCheckerCase::kTcpHealthCheck:
-    return std::make_shared<TcpHealthCheckerImpl>(cluster, health_check_config, dispatcher, runtime,
-                                                  random, std::move(event_logger));
+    health_checker = std::make_unique<TcpHealthCheckerImpl>(
+        cluster, health_check_config, session_dispatcher, runtime, random, std::move(event_logger));
+    break;
   case envoy::config::core::v3alpha::HealthCheck::HealthCheckerCase::kGrpcHealthCheck:
     if (!(cluster.info()->features() & Upstream::ClusterInfo::Features::HTTP2)) {
       throw EnvoyException(fmt::format("{} cluster must support HTTP/2 for gRPC healthchecking",
                                        cluster.info()->name()));
     }
-    return std::make_shared<ProdGrpcHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, random, std::move(event_logger));
+    health_checker = std::make_unique<ProdGrpcHealthCheckerImpl>(
+        cluster, health_check_config, session_dispatcher, runtime, random, std::move(event_logger));
+    break;
   case envoy::config::core::v3alpha::HealthCheck::HealthCheckerCase::kCustomHealthCheck: {
+    // Custom health checkers always run on the main thread.
     auto& factory =
         Config::Utility::getAndCheckFactory<Server::Configuration::CustomHealthCheckerFactory>(
             health_check_config.custom_health_check());
@@ -96,6 +104,17 @@ HealthCheckerSharedPtr HealthCheckerFactory::create(
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
+
+  if (health_check_dispatcher == nullptr) {
+    return HealthCheckerSharedPtr(std::move(health_checker));
+  }
+  // The sessions run on the health check dispatcher, so the health checker is destroyed there
+  // too, after any host update posted to it by the main thread.
+  health_checker->setMainThreadDispatcher(dispatcher);
+  return HealthCheckerSharedPtr(
+      health_checker.release(), [health_check_dispatcher](HealthChecker* to_delete) -> void {
+        health_check_dispatcher->post([to_delete]() -> void { delete to_delete; });
+      });
 }
 
 HttpHealthCheckerImpl::HttpHealthCheckerImpl(
@@ -182,7 +201,7 @@ Http::Protocol codecClientTypeToProtocol(Http::CodecClient::Type codec_client_ty
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HttpActiveHealthCheckSession(
     HttpHealthCheckerImpl& parent, const HostSharedPtr& host)
     : ActiveHealthCheckSession(parent, host), parent_(parent),
-      hostname_(parent_.host_value_.empty() ? parent_.cluster_.info()->name()
+      hostname_(parent_.host_value_.empty() ? parent_.cluster_info_->name()
                                             : parent_.host_value_),
       protocol_(codecClientTypeToProtocol(parent_.codec_client_type_)),
       local_address_(std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1")) {}
@@ -643,7 +662,7 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onInterval() {
 
   const std::string& authority = parent_.authority_value_.has_value()
                                      ? parent_.authority_value_.value()
-                                     : parent_.cluster_.info()->name();
+                                     : parent_.cluster_info_->name();
   auto headers_message =
       Grpc::Common::prepareHeaders(authority, parent_.service_method_.service()->full_name(),
                                    parent_.service_method_.name(), absl::nullopt);
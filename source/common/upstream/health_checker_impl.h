@@ -34,13 +34,16 @@ public:
    * @param dispatcher supplies the dispatcher.
    * @param event_logger supplies the event_logger.
    * @param validation_visitor message validation visitor instance.
+   * @param health_check_dispatcher supplies the dispatcher the built-in health checkers run their
+   *        health checks on, if not the main thread dispatcher.
    * @return a health checker.
    */
   static HealthCheckerSharedPtr
   create(const envoy::config::core::v3alpha::HealthCheck& health_check_config,
          Upstream::Cluster& cluster, Runtime::Loader& runtime, Runtime::RandomGenerator& random,
          Event::Dispatcher& dispatcher, AccessLog::AccessLogManager& log_manager,
-         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api);
+         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+         Event::Dispatcher* health_check_dispatcher = nullptr);
 };
 
 /**
@@ -0,0 +1,39 @@
+#include "common/upstream/host_latency_impl.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Envoy {
+namespace Upstream {
+
+HostLatencyImpl::HostLatencyImpl(std::chrono::nanoseconds decay_time)
+    : decay_time_ns_(std::max<double>(decay_time.count(), 1)) {}
+
+double HostLatencyImpl::decayWeight(int64_t now_ns) const {
+  const int64_t elapsed_ns = now_ns - last_update_ns_.load(std::memory_order_relaxed);
+  return std::exp(-std::max<int64_t>(elapsed_ns, 0) / decay_time_ns_);
+}
+
+void HostLatencyImpl::recordLatency(std::chrono::microseconds latency, MonotonicTime now) {
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  const double weight = decayWeight(now_ns);
+  const double sample = latency.count();
+  double ewma = ewma_.load(std::memory_order_relaxed);
+  double updated;
+  do {
+    // A latency above the average replaces it, so that a host which slows down is avoided at once.
+    // This is also how the first latency is recorded, as the average starts at 0.
+    updated = sample > ewma ? sample : ewma * weight + sample * (1 - weight);
+  } while (!ewma_.compare_exchange_weak(ewma, updated, std::memory_order_relaxed));
+  last_update_ns_.store(now_ns, std::memory_order_relaxed);
+}
+
+double HostLatencyImpl::peakEwma(MonotonicTime now) const {
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  return ewma_.load(std::memory_order_relaxed) * decayWeight(now_ns);
+}
+
+} // namespace Upstream
+} // namespace Envoy
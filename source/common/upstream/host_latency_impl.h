@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/upstream/host_description.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Lock free implementation of HostLatency. The average and the time it was last updated are kept
+ * in separate atomics, so a concurrent reader may pair an average with a slightly stale time,
+ * which only affects the decay of a single read. Without new latencies the average decays towards
+ * 0, so that a host which was slow is eventually tried again.
+ */
+class HostLatencyImpl : public HostLatency {
+public:
+  explicit HostLatencyImpl(std::chrono::nanoseconds decay_time);
+
+  // Upstream::HostLatency
+  void recordLatency(std::chrono::microseconds latency, MonotonicTime now) override;
+  double peakEwma(MonotonicTime now) const override;
+
+private:
+  double decayWeight(int64_t now_ns) const;
+
+  const double decay_time_ns_;
+  std::atomic<double> ewma_{0};
+  std::atomic<int64_t> last_update_ns_{0};
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -72,9 +72,8 @@ LoadBalancerBase::choosePriority(uint64_t hash, const HealthyLoad& healthy_per_p
                                  const DegradedLoad& degraded_per_priority_load) {
   hash = hash % 100 + 1; // 1-100
   uint32_t aggregate_percentage_load = 0;
-  // As with tryChooseLocalLocalityHosts, this can be refactored for efficiency
-  // but O(N) is good enough for now given the expected number of priorities is
-  // small.
+  // This can be refactored for efficiency but O(N) is good enough for now given
+  // the expected number of priorities is small.
 
   // We first attempt to select a priority based on healthy availability.
   for (size_t priority = 0; priority < healthy_per_priority_load.get().size(); ++priority) {
@@ -373,32 +372,24 @@ void ZoneAwareLoadBalancerBase::regenerateLocalityRoutingStructures() {
   // locality we should route. Percentage of requests routed cross locality to a specific locality
   // needed be proportional to the residual capacity upstream locality has.
   //
-  // residual_capacity contains capacity left in a given locality, we keep accumulating residual
-  // capacity to make search for sampled value easier.
+  // residual_capacity contains capacity left in a given locality, which is the weight of the
+  // locality when sampling the locality to route to.
   // For example, if we have the following upstream and local percentage:
   // local_percentage: 40000 40000 20000
   // upstream_percentage: 25000 50000 25000
-  // Residual capacity would look like: 0 10000 5000. Now we need to sample proportionally to
-  // bucket sizes (residual capacity). For simplicity of finding where specific
-  // sampled value is, we accumulate values in residual capacity. This is what it will look like:
-  // residual_capacity: 0 10000 15000
-  // Now to find a locality to route (bucket) we could simply iterate over residual_capacity
-  // searching where sampled value is placed.
-  state.residual_capacity_.resize(num_localities);
+  // Residual capacity would look like: 0 10000 5000. The localities are then sampled from an alias
+  // table built for these weights, so that a locality is found in constant time however many
+  // localities there are.
+  std::vector<uint64_t> residual_capacity(num_localities);
 
   // Local locality (index 0) does not have residual capacity as we have routed all we could.
-  state.residual_capacity_[0] = 0;
   for (size_t i = 1; i < num_localities; ++i) {
     // Only route to the localities that have additional capacity.
     if (upstream_percentage[i] > local_percentage[i]) {
-      state.residual_capacity_[i] =
-          state.residual_capacity_[i - 1] + upstream_percentage[i] - local_percentage[i];
-    } else {
-      // Locality with index "i" does not have residual capacity, but we keep accumulating previous
-      // values to make search easier on the next step.
-      state.residual_capacity_[i] = state.residual_capacity_[i - 1];
+      residual_capacity[i] = upstream_percentage[i] - local_percentage[i];
     }
   }
+  state.residual_capacity_ = AliasTable(residual_capacity);
 }
 
 void ZoneAwareLoadBalancerBase::resizePerPriorityState() {
@@ -521,25 +512,14 @@ uint32_t ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const HostSet& h
 
   // This is *extremely* unlikely but possible due to rounding errors when calculating
   // locality percentages. In this case just select random locality.
-  if (state.residual_capacity_[number_of_localities - 1] == 0) {
+  if (state.residual_capacity_.empty()) {
     stats_.lb_zone_no_capacity_left_.inc();
     return random_.random() % number_of_localities;
   }
 
   // Random sampling to select specific locality for cross locality traffic based on the additional
   // capacity in localities.
-  uint64_t threshold = random_.random() % state.residual_capacity_[number_of_localities - 1];
-
-  // This potentially can be optimized to be O(log(N)) where N is the number of localities.
-  // Linear scan should be faster for smaller N, in most of the scenarios N will be small.
-  // TODO(htuch): is there a bug here when threshold == 0? Seems like we pick
-  // local locality in that situation. Probably should start iterating at 1.
-  int i = 0;
-  while (threshold > state.residual_capacity_[i]) {
-    i++;
-  }
-
-  return i;
+  return state.residual_capacity_.pick(random_.random());
 }
 
 absl::optional<ZoneAwareLoadBalancerBase::HostsSource>
@@ -683,8 +663,7 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     // refreshes for the weighted case.
     if (!hosts.empty()) {
       for (uint32_t i = 0; i < seed_ % hosts.size(); ++i) {
-        auto host = scheduler.edf_->pick();
-        scheduler.edf_->add(hostWeight(*host), host);
+        scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
       }
     }
   };
@@ -726,11 +705,7 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
   // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original weights
   // of 2 or more hosts differ.
   if (scheduler.edf_ != nullptr) {
-    auto host = scheduler.edf_->pick();
-    if (host != nullptr) {
-      scheduler.edf_->add(hostWeight(*host), host);
-    }
-    return host;
+    return scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
     if (hosts_to_use.empty()) {
@@ -763,6 +738,34 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
+double PeakEwmaLoadBalancer::hostCost(const Host& host, MonotonicTime now) {
+  const uint64_t active_rq = host.stats().rq_active_.value();
+  const double peak_ewma = host.latency().peakEwma(now);
+  if (peak_ewma == 0 && active_rq > 0) {
+    return kPenalty * active_rq;
+  }
+  return peak_ewma * (active_rq + 1);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
+                                                            const HostsSource&) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  HostSharedPtr candidate_host = nullptr;
+  double candidate_cost = 0;
+  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
+    const int rand_idx = random_.random() % hosts_to_use.size();
+    HostSharedPtr sampled_host = hosts_to_use[rand_idx];
+    const double sampled_cost = hostCost(*sampled_host, now);
+
+    if (candidate_host == nullptr || sampled_cost < candidate_cost) {
+      candidate_host = sampled_host;
+      candidate_cost = sampled_cost;
+    }
+  }
+
+  return candidate_host;
+}
+
 HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context);
   if (!hosts_source) {
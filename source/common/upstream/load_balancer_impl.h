@@ -5,12 +5,14 @@
 #include <set>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3alpha/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
 
 #include "common/protobuf/utility.h"
+#include "common/upstream/alias_table.h"
 #include "common/upstream/edf_scheduler.h"
 
 namespace Envoy {
@@ -312,10 +314,9 @@ private:
     uint64_t local_percent_to_route_{};
     // Tracks the current state of locality based routing.
     LocalityRoutingState locality_routing_state_{LocalityRoutingState::NoLocalityRouting};
-    // When locality_routing_state_ == LocalityResidual this tracks the capacity
-    // for each of the non-local localities to determine what traffic should be
-    // routed where.
-    std::vector<uint64_t> residual_capacity_;
+    // When locality_routing_state_ == LocalityResidual this samples the non-local localities
+    // in proportion to their capacity to determine what traffic should be routed where.
+    AliasTable residual_capacity_;
   };
   using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
   // Routing state broken out for each priority level in priority_set_.
@@ -465,6 +466,57 @@ private:
   const uint32_t choice_count_;
 };
 
+/**
+ * Peak EWMA load balancer. Like the least request load balancer it uses P2C, but the cost of a
+ * host is the peak EWMA of its latencies (see HostLatency) scaled by its number of active
+ * requests, so that hosts which are slow to respond get fewer requests even before requests pile
+ * up on them. The latencies are recorded by the router.
+ *
+ * A host without latency has no cost, so that new hosts are tried, unless it already has active
+ * requests, in which case it is penalized until its first response is received.
+ *
+ * When hosts have different weights, an RR EDF schedule is used with the host weight divided by
+ * its cost at pick/insert time, as for the least request load balancer.
+ */
+class PeakEwmaLoadBalancer : public EdfLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(
+      const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
+      Runtime::Loader& runtime, Runtime::RandomGenerator& random, TimeSource& time_source,
+      const envoy::config::cluster::v3alpha::Cluster::CommonLbConfig& common_config,
+      const absl::optional<envoy::config::cluster::v3alpha::Cluster::PeakEwmaLbConfig>
+          peak_ewma_config)
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                            common_config),
+        time_source_(time_source),
+        choice_count_(
+            peak_ewma_config.has_value()
+                ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(peak_ewma_config.value(), choice_count, 2)
+                : 2) {
+    initialize();
+  }
+
+  /**
+   * @return the cost of sending a request to a host.
+   */
+  static double hostCost(const Host& host, MonotonicTime now);
+
+  // The cost of a host without latency but with active requests, in microseconds per request.
+  static constexpr double kPenalty = 1e9;
+
+private:
+  void refreshHostSource(const HostsSource&) override {}
+  double hostWeight(const Host& host) override {
+    // We always add 1 to avoid division by 0.
+    return static_cast<double>(host.weight()) / (hostCost(host, time_source_.monotonicTime()) + 1);
+  }
+  HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                        const HostsSource& source) override;
+
+  TimeSource& time_source_;
+  const uint32_t choice_count_;
+};
+
 /**
  * Random load balancer that picks a random host out of all hosts.
  */
@@ -45,9 +45,10 @@ void LoadStatsReporter::establishNewStream() {
 
 void LoadStatsReporter::sendLoadStatsRequest() {
   request_.mutable_cluster_stats()->Clear();
-  for (const auto& cluster_name_and_timestamp : clusters_) {
-    const std::string& cluster_name = cluster_name_and_timestamp.first;
-    auto cluster_info_map = cm_.clusters();
+  const auto cluster_info_map = cm_.clusters();
+  for (auto& cluster_name_and_state : clusters_) {
+    const std::string& cluster_name = cluster_name_and_state.first;
+    ClusterState& state = cluster_name_and_state.second;
     auto it = cluster_info_map.find(cluster_name);
     if (it == cluster_info_map.end()) {
       ENVOY_LOG(debug, "Cluster {} does not exist", cluster_name);
@@ -59,39 +60,23 @@ void LoadStatsReporter::sendLoadStatsRequest() {
     if (cluster.info()->eds_service_name().has_value()) {
       cluster_stats->set_cluster_service_name(cluster.info()->eds_service_name().value());
     }
-    for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
-      ENVOY_LOG(trace, "Load report locality count {}", host_set->hostsPerLocality().get().size());
-      for (auto& hosts : host_set->hostsPerLocality().get()) {
-        ASSERT(!hosts.empty());
-        uint64_t rq_success = 0;
-        uint64_t rq_error = 0;
-        uint64_t rq_active = 0;
-        uint64_t rq_issued = 0;
-        for (const auto& host : hosts) {
-          rq_success += host->stats().rq_success_.latch();
-          rq_error += host->stats().rq_error_.latch();
-          rq_active += host->stats().rq_active_.value();
-          rq_issued += host->stats().rq_total_.latch();
-        }
-        if (rq_success + rq_error + rq_active != 0) {
-          auto* locality_stats = cluster_stats->add_upstream_locality_stats();
-          locality_stats->mutable_locality()->MergeFrom(hosts[0]->locality());
-          locality_stats->set_priority(host_set->priority());
-          locality_stats->set_total_successful_requests(rq_success);
-          locality_stats->set_total_error_requests(rq_error);
-          locality_stats->set_total_requests_in_progress(rq_active);
-          locality_stats->set_total_issued_requests(rq_issued);
-        }
-      }
+    // Requests are counted by the cluster when they are counted by their host, so when the
+    // cluster did not have any, the stats of its hosts have nothing to report.
+    const uint64_t rq_total = cluster.info()->stats().upstream_rq_total_.value();
+    const uint64_t rq_active = cluster.info()->stats().upstream_rq_active_.value();
+    if (rq_total != state.rq_total_ || rq_active != 0 || state.rq_active_ != 0) {
+      addLocalityStats(cluster, *cluster_stats);
     }
+    state.rq_total_ = rq_total;
+    state.rq_active_ = rq_active;
     cluster_stats->set_total_dropped_requests(
         cluster.info()->loadReportStats().upstream_rq_dropped_.latch());
     const auto now = time_source_.monotonicTime().time_since_epoch();
-    const auto measured_interval = now - cluster_name_and_timestamp.second;
+    const auto measured_interval = now - state.start_;
     cluster_stats->mutable_load_report_interval()->MergeFrom(
         Protobuf::util::TimeUtil::MicrosecondsToDuration(
             std::chrono::duration_cast<std::chrono::microseconds>(measured_interval).count()));
-    clusters_[cluster_name] = now;
+    state.start_ = now;
   }
 
   Config::VersionConverter::prepareMessageForGrpcWire(request_, transport_api_version_);
@@ -105,6 +90,35 @@ void LoadStatsReporter::sendLoadStatsRequest() {
   }
 }
 
+void LoadStatsReporter::addLocalityStats(
+    const Cluster& cluster, envoy::config::endpoint::v3alpha::ClusterStats& cluster_stats) {
+  for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
+    ENVOY_LOG(trace, "Load report locality count {}", host_set->hostsPerLocality().get().size());
+    for (auto& hosts : host_set->hostsPerLocality().get()) {
+      ASSERT(!hosts.empty());
+      uint64_t rq_success = 0;
+      uint64_t rq_error = 0;
+      uint64_t rq_active = 0;
+      uint64_t rq_issued = 0;
+      for (const auto& host : hosts) {
+        rq_success += host->stats().rq_success_.latch();
+        rq_error += host->stats().rq_error_.latch();
+        rq_active += host->stats().rq_active_.value();
+        rq_issued += host->stats().rq_total_.latch();
+      }
+      if (rq_success + rq_error + rq_active != 0) {
+        auto* locality_stats = cluster_stats.add_upstream_locality_stats();
+        locality_stats->mutable_locality()->MergeFrom(hosts[0]->locality());
+        locality_stats->set_priority(host_set->priority());
+        locality_stats->set_total_successful_requests(rq_success);
+        locality_stats->set_total_error_requests(rq_error);
+        locality_stats->set_total_requests_in_progress(rq_active);
+        locality_stats->set_total_issued_requests(rq_issued);
+      }
+    }
+  }
+}
+
 void LoadStatsReporter::handleFailure() {
   ENVOY_LOG(warn, "Load reporter stats stream/connection failure, will retry in {} ms.",
             RETRY_DELAY_MS);
@@ -135,28 +149,36 @@ void LoadStatsReporter::startLoadReportPeriod() {
   // problems due to referencing of temporaries in the below loop with Google's
   // internal string type. Consider this optimization when the string types
   // converge.
-  std::unordered_map<std::string, std::chrono::steady_clock::duration> existing_clusters;
+  std::unordered_map<std::string, ClusterState> existing_clusters;
   for (const std::string& cluster_name : message_->clusters()) {
-    if (clusters_.count(cluster_name) > 0) {
-      existing_clusters.emplace(cluster_name, clusters_[cluster_name]);
+    auto it = clusters_.find(cluster_name);
+    if (it != clusters_.end()) {
+      existing_clusters.emplace(cluster_name, it->second);
     }
   }
   clusters_.clear();
+  const auto cluster_info_map = cm_.clusters();
   // Reset stats for all hosts in clusters we are tracking.
   for (const std::string& cluster_name : message_->clusters()) {
-    clusters_.emplace(cluster_name, existing_clusters.count(cluster_name) > 0
-                                        ? existing_clusters[cluster_name]
-                                        : time_source_.monotonicTime().time_since_epoch());
-    auto cluster_info_map = cm_.clusters();
+    auto existing_it = existing_clusters.find(cluster_name);
+    const bool existing = existing_it != existing_clusters.end();
+    ClusterState& state =
+        clusters_
+            .emplace(cluster_name,
+                     existing ? existing_it->second
+                              : ClusterState{time_source_.monotonicTime().time_since_epoch()})
+            .first->second;
     auto it = cluster_info_map.find(cluster_name);
     if (it == cluster_info_map.end()) {
       continue;
     }
     // Don't reset stats for existing tracked clusters.
-    if (existing_clusters.count(cluster_name) > 0) {
+    if (existing) {
       continue;
     }
     auto& cluster = it->second.get();
+    state.rq_total_ = cluster.info()->stats().upstream_rq_total_.value();
+    state.rq_active_ = cluster.info()->stats().upstream_rq_active_.value();
     for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
       for (const auto& host : host_set->hosts()) {
         host->stats().rq_success_.latch();
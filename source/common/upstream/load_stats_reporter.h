@@ -51,6 +51,8 @@ private:
   void sendLoadStatsRequest();
   void handleFailure();
   void startLoadReportPeriod();
+  void addLocalityStats(const Cluster& cluster,
+                        envoy::config::endpoint::v3alpha::ClusterStats& cluster_stats);
 
   ClusterManager& cm_;
   LoadReporterStats stats_;
@@ -64,8 +66,17 @@ private:
   Event::TimerPtr response_timer_;
   envoy::service::load_stats::v3alpha::LoadStatsRequest request_;
   std::unique_ptr<envoy::service::load_stats::v3alpha::LoadStatsResponse> message_;
-  // Map from cluster name to start of measurement interval.
-  std::unordered_map<std::string, std::chrono::steady_clock::duration> clusters_;
+  struct ClusterState {
+    // Start of the measurement interval.
+    std::chrono::steady_clock::duration start_;
+    // The upstream_rq_total and upstream_rq_active stats of the cluster when it was last reported.
+    // The hosts of a cluster without any request since, nor in progress then or now, are skipped.
+    uint64_t rq_total_{};
+    uint64_t rq_active_{};
+  };
+
+  // Map from cluster name to its state.
+  std::unordered_map<std::string, ClusterState> clusters_;
   TimeSource& time_source_;
 };
 
@@ -74,7 +74,7 @@ public:
   // Upstream:HostDescription
   bool canary() const override { return logical_host_->canary(); }
   void canary(bool) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
-  const std::shared_ptr<envoy::config::core::v3alpha::Metadata> metadata() const override {
+  const std::shared_ptr<const envoy::config::core::v3alpha::Metadata> metadata() const override {
     return logical_host_->metadata();
   }
   void metadata(const envoy::config::core::v3alpha::Metadata&) override {
@@ -90,6 +90,7 @@ public:
     return logical_host_->outlierDetector();
   }
   HostStats& stats() const override { return logical_host_->stats(); }
+  HostLatency& latency() const override { return logical_host_->latency(); }
   const std::string& hostname() const override { return logical_host_->hostname(); }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
   const envoy::config::core::v3alpha::Locality& locality() const override {
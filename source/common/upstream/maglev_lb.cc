@@ -47,14 +47,12 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (table_[entry.position_] != nullptr) {
+        advance(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      table_[entry.position_] = entry.host_;
+      advance(entry);
       entry.count_++;
       table_index++;
     }
@@ -84,8 +82,14 @@ HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
   return table_[hash % table_size_];
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
+void MaglevTable::advance(TableBuildEntry& entry) const {
+  // permutation[next] = (offset + skip * next) % table_size. As both offset and skip are smaller
+  // than the table size, the next position is reached with an addition and a conditional
+  // subtraction rather than a multiplication and a modulo.
+  entry.position_ += entry.skip_;
+  if (entry.position_ >= table_size_) {
+    entry.position_ -= table_size_;
+  }
 }
 
 MaglevLoadBalancer::MaglevLoadBalancer(
@@ -45,18 +45,19 @@ public:
 private:
   struct TableBuildEntry {
     TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+        : host_(host), skip_(skip), weight_(weight), position_(offset) {}
 
     HostConstSharedPtr host_;
-    const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // The table slot of the next entry in this host's permutation.
+    uint64_t position_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  // Move to the next entry of the host's permutation.
+  void advance(TableBuildEntry& entry) const;
 
   const uint64_t table_size_;
   std::vector<HostConstSharedPtr> table_;
@@ -38,10 +38,19 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
 
     if (dst_host) {
       const Network::Address::Instance& dst_addr = *dst_host.get();
-      // Check if a host with the destination address is already in the host set.
+      // Check if a host with the destination address is already in the host set, or has been
+      // added by this load balancer and is not yet in its host map.
+      HostSharedPtr host;
       auto it = host_map_->find(dst_addr.asString());
       if (it != host_map_->end()) {
-        HostSharedPtr host(it->second); // takes a reference
+        host = it->second; // takes a reference
+      } else {
+        auto added_it = added_hosts_.find(dst_addr.asString());
+        if (added_it != added_hosts_.end()) {
+          host = added_it->second;
+        }
+      }
+      if (host) {
         ENVOY_LOG(debug, "Using existing host {}.", host->address()->asString());
         host->used(true); // Mark as used.
         return host;
@@ -53,23 +62,27 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
             Network::Utility::copyInternetAddressAndPort(*dst_ip));
         // Create a host we can use immediately.
         auto info = parent_->info();
-        HostSharedPtr host(std::make_shared<HostImpl>(
+        host = std::make_shared<HostImpl>(
             info, info->name() + dst_addr.asString(), std::move(host_ip_port),
             envoy::config::core::v3alpha::Metadata::default_instance(), 1,
             envoy::config::core::v3alpha::Locality().default_instance(),
             envoy::config::endpoint::v3alpha::Endpoint::HealthCheckConfig().default_instance(), 0,
-            envoy::config::core::v3alpha::UNKNOWN));
+            envoy::config::core::v3alpha::UNKNOWN);
         ENVOY_LOG(debug, "Created host {}.", host->address()->asString());
 
-        // Tell the cluster about the new host
-        // lambda cannot capture a member by value.
-        std::weak_ptr<OriginalDstCluster> post_parent = parent_;
-        parent_->dispatcher_.post([post_parent, host]() mutable {
-          // The main cluster may have disappeared while this post was queued.
-          if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
-            parent->addHost(host);
-          }
-        });
+        added_hosts_.emplace(dst_addr.asString(), host);
+
+        // Tell the cluster about the new host, along with the hosts queued until the post runs.
+        if (parent_->queueHost(host)) {
+          // lambda cannot capture a member by value.
+          std::weak_ptr<OriginalDstCluster> post_parent = parent_;
+          parent_->dispatcher_.post([post_parent]() {
+            // The main cluster may have disappeared while this post was queued.
+            if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
+              parent->addQueuedHosts();
+            }
+          });
+        }
         return host;
       } else {
         ENVOY_LOG(debug, "Failed to create host for {}.", dst_addr.asString());
@@ -122,22 +135,40 @@ OriginalDstCluster::OriginalDstCluster(
   cleanup_timer_->enableTimer(cleanup_interval_ms_);
 }
 
-void OriginalDstCluster::addHost(HostSharedPtr& host) {
+bool OriginalDstCluster::queueHost(const HostSharedPtr& host) {
+  absl::MutexLock lock(&queued_hosts_lock_);
+  queued_hosts_.push_back(host);
+  return queued_hosts_.size() == 1;
+}
+
+void OriginalDstCluster::addQueuedHosts() {
+  HostVector queued_hosts;
+  {
+    absl::MutexLock lock(&queued_hosts_lock_);
+    queued_hosts.swap(queued_hosts_);
+  }
+
   HostMapSharedPtr new_host_map = std::make_shared<HostMap>(*getCurrentHostMap());
-  auto pair = new_host_map->emplace(host->address()->asString(), host);
-  bool added = pair.second;
-  if (added) {
-    ENVOY_LOG(debug, "addHost() adding {}", host->address()->asString());
-    setHostMap(new_host_map);
-    // Given the current config, only EDS clusters support multiple priorities.
-    ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
-    const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
-    HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
-    all_hosts->emplace_back(host);
-    priority_set_.updateHosts(0,
-                              HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
-                              {}, {std::move(host)}, {}, absl::nullopt);
+  HostVector hosts_added;
+  for (HostSharedPtr& host : queued_hosts) {
+    if (new_host_map->emplace(host->address()->asString(), host).second) {
+      ENVOY_LOG(debug, "addQueuedHosts() adding {}", host->address()->asString());
+      hosts_added.push_back(std::move(host));
+    }
   }
+  if (hosts_added.empty()) {
+    return;
+  }
+
+  setHostMap(new_host_map);
+  // Given the current config, only EDS clusters support multiple priorities.
+  ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
+  const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
+  HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
+  all_hosts->insert(all_hosts->end(), hosts_added.begin(), hosts_added.end());
+  priority_set_.updateHosts(0,
+                            HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
+                            {}, hosts_added, {}, absl::nullopt);
 }
 
 void OriginalDstCluster::cleanup() {
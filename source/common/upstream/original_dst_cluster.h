@@ -49,7 +49,8 @@ public:
    * add hosts on demand. Additions are synced with all other threads so that the host set in the
    * cluster remains (eventually) consistent. If multiple threads add a host to the same upstream
    * address then two distinct HostSharedPtr's (with the same upstream IP address) will be added,
-   * and both of them will eventually time out.
+   * and both of them will eventually time out. A load balancer reuses the hosts it added itself
+   * until they are in its host map.
    */
   class LoadBalancer : public Upstream::LoadBalancer {
   public:
@@ -64,6 +65,8 @@ public:
 
     const std::shared_ptr<OriginalDstCluster> parent_;
     HostMapConstSharedPtr host_map_;
+    // Hosts added by this load balancer since its host map was taken.
+    HostMap added_hosts_;
   };
 
 private:
@@ -99,7 +102,15 @@ private:
     host_map_ = new_host_map;
   }
 
-  void addHost(HostSharedPtr&);
+  /**
+   * Queue a host created by a worker to be added to the cluster by the main thread, along with the
+   * other hosts queued until then, so that the host map is copied and the host set updated once
+   * for all of them.
+   * @return whether the queue was empty, in which case addQueuedHosts() must be posted to the main
+   *         thread.
+   */
+  bool queueHost(const HostSharedPtr& host);
+  void addQueuedHosts();
   void cleanup();
 
   // ClusterImplBase
@@ -113,6 +124,9 @@ private:
   absl::Mutex host_map_lock_;
   HostMapConstSharedPtr host_map_ ABSL_GUARDED_BY(host_map_lock_);
 
+  absl::Mutex queued_hosts_lock_;
+  HostVector queued_hosts_ ABSL_GUARDED_BY(queued_hosts_lock_);
+
   friend class OriginalDstClusterFactory;
 };
 
@@ -65,8 +65,8 @@ void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
 }
 
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
-  external_origin_sr_monitor_.incTotalReqCounter();
   if (Http::CodeUtility::is5xx(response_code)) {
+    external_origin_sr_monitor_.incFailedReqCounter();
     std::shared_ptr<DetectorImpl> detector = detector_.lock();
     if (!detector) {
       // It's possible for the cluster/detector to go away while we still have a host in use.
@@ -89,8 +89,14 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
     }
   } else {
     external_origin_sr_monitor_.incSuccessReqCounter();
-    consecutive_5xx_ = 0;
-    consecutive_gateway_failure_ = 0;
+    // Most responses are successes, so only write the counters shared by all the workers when
+    // there is something to reset.
+    if (consecutive_5xx_.load(std::memory_order_relaxed) != 0) {
+      consecutive_5xx_ = 0;
+    }
+    if (consecutive_gateway_failure_.load(std::memory_order_relaxed) != 0) {
+      consecutive_gateway_failure_ = 0;
+    }
   }
 }
 
@@ -185,7 +191,7 @@ void DetectorHostMonitorImpl::localOriginFailure() {
     // It's possible for the cluster/detector to go away while we still have a host in use.
     return;
   }
-  local_origin_sr_monitor_.incTotalReqCounter();
+  local_origin_sr_monitor_.incFailedReqCounter();
   if (++consecutive_local_origin_failure_ ==
       detector->runtime().snapshot().getInteger(
           "outlier_detection.consecutive_local_origin_failure",
@@ -201,10 +207,11 @@ void DetectorHostMonitorImpl::localOriginNoFailure() {
     return;
   }
 
-  local_origin_sr_monitor_.incTotalReqCounter();
   local_origin_sr_monitor_.incSuccessReqCounter();
 
-  resetConsecutiveLocalOriginFailure();
+  if (consecutive_local_origin_failure_.load(std::memory_order_relaxed) != 0) {
+    resetConsecutiveLocalOriginFailure();
+  }
 }
 
 DetectorConfig::DetectorConfig(const envoy::config::cluster::v3alpha::OutlierDetection& config)
@@ -339,8 +346,8 @@ void DetectorImpl::checkHostForUneject(HostSharedPtr host, DetectorHostMonitorIm
     host->healthFlagClear(Host::HealthFlag::FAILED_OUTLIER_CHECK);
     // Reset the consecutive failure counters to avoid re-ejection on very few new errors due
     // to the non-triggering counter being close to its trigger value.
-    host_monitors_[host]->resetConsecutive5xx();
-    host_monitors_[host]->resetConsecutiveGatewayFailure();
+    monitor->resetConsecutive5xx();
+    monitor->resetConsecutiveGatewayFailure();
     monitor->uneject(now);
     runCallbacks(host);
 
@@ -496,6 +503,11 @@ void DetectorImpl::notifyMainThreadConsecutiveError(
   //       3) If when running on the main thread the weak pointer can be converted to a strong
   //          pointer, the detector/cluster must still exist so we can safely fire callbacks.
   //          Otherwise we do nothing since the detector/cluster is already gone.
+  // The health flags are atomic, so an ejected host is skipped here rather than on the main
+  // thread, which avoids a post for each bout of errors of a host that is already ejected.
+  if (host == nullptr || host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+    return;
+  }
   std::weak_ptr<DetectorImpl> weak_this = shared_from_this();
   dispatcher_.post([weak_this, host, type]() -> void {
     std::shared_ptr<DetectorImpl> shared_this = weak_this.lock();
@@ -573,10 +585,10 @@ DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
   // threshold returned = 52
   double mean = success_rate_sum / valid_success_rate_hosts.size();
   double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
+  for (const HostSuccessRatePair& v : valid_success_rate_hosts) {
+    const double deviation = v.success_rate_ - mean;
+    variance += deviation * deviation;
+  }
   variance /= valid_success_rate_hosts.size();
   double stdev = std::sqrt(variance);
 
@@ -689,7 +701,7 @@ void DetectorImpl::processSuccessRateEjections(
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
-  for (auto host : host_monitors_) {
+  for (const auto& host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
     // Need to update the writer bucket to keep the data valid.
@@ -701,7 +713,10 @@ void DetectorImpl::onIntervalTimer() {
   }
 
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
-  processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  // Local origin events are only recorded separately when they are split from external ones.
+  if (config_.splitExternalLocalOriginErrors()) {
+    processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  }
 
   armIntervalTimer();
 }
@@ -784,8 +799,7 @@ void EventLoggerImpl::setCommonEventParams(
 
 SuccessRateAccumulatorBucket* SuccessRateAccumulator::updateCurrentWriter() {
   // Right now current is being written to and backup is not. Flush the backup and swap.
-  backup_success_rate_bucket_->success_request_counter_ = 0;
-  backup_success_rate_bucket_->total_request_counter_ = 0;
+  backup_success_rate_bucket_->counters_ = 0;
 
   current_success_rate_bucket_.swap(backup_success_rate_bucket_);
 
@@ -793,14 +807,15 @@ SuccessRateAccumulatorBucket* SuccessRateAccumulator::updateCurrentWriter() {
 }
 
 absl::optional<std::pair<double, uint64_t>> SuccessRateAccumulator::getSuccessRateAndVolume() {
-  if (!backup_success_rate_bucket_->total_request_counter_) {
+  const uint64_t counters = backup_success_rate_bucket_->counters_;
+  const uint64_t total_request_counter = counters & SuccessRateAccumulatorBucket::kTotalRequestMask;
+  if (!total_request_counter) {
     return absl::nullopt;
   }
 
-  double success_rate = backup_success_rate_bucket_->success_request_counter_ * 100.0 /
-                        backup_success_rate_bucket_->total_request_counter_;
+  double success_rate = (counters >> 32) * 100.0 / total_request_counter;
 
-  return {{success_rate, backup_success_rate_bucket_->total_request_counter_}};
+  return {{success_rate, total_request_counter}};
 }
 
 } // namespace Outlier
@@ -64,9 +64,18 @@ struct HostSuccessRatePair {
   double success_rate_;
 };
 
+/**
+ * The success and total request counters of a host are packed in a single word, so that workers
+ * record a request with a single atomic add and the interval timer reads a consistent pair. The
+ * success requests are in the upper 32 bits and the total requests in the lower 32 bits, which
+ * holds more requests than a host can receive in an interval.
+ */
 struct SuccessRateAccumulatorBucket {
-  std::atomic<uint64_t> success_request_counter_;
-  std::atomic<uint64_t> total_request_counter_;
+  static constexpr uint64_t kSuccessRequest = (uint64_t(1) << 32) | 1;
+  static constexpr uint64_t kFailedRequest = 1;
+  static constexpr uint64_t kTotalRequestMask = 0xFFFFFFFF;
+
+  std::atomic<uint64_t> counters_{0};
 };
 
 /**
@@ -114,9 +123,15 @@ public:
   void updateCurrentSuccessRateBucket() {
     success_rate_accumulator_bucket_.store(success_rate_accumulator_.updateCurrentWriter());
   }
-  void incTotalReqCounter() { success_rate_accumulator_bucket_.load()->total_request_counter_++; }
   void incSuccessReqCounter() {
-    success_rate_accumulator_bucket_.load()->success_request_counter_++;
+    success_rate_accumulator_bucket_.load(std::memory_order_acquire)
+        ->counters_.fetch_add(SuccessRateAccumulatorBucket::kSuccessRequest,
+                              std::memory_order_relaxed);
+  }
+  void incFailedReqCounter() {
+    success_rate_accumulator_bucket_.load(std::memory_order_acquire)
+        ->counters_.fetch_add(SuccessRateAccumulatorBucket::kFailedRequest,
+                              std::memory_order_relaxed);
   }
 
   envoy::data::cluster::v2alpha::OutlierEjectionType getEjectionType() const {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -22,6 +23,9 @@ namespace Upstream {
  *    occur during high contention.
  * 2) Though atomics are used, it is possible for resources to temporarily go above the supplied
  *    maximums. This should not effect overall behavior.
+ * 3) With striped counters, the connections, pending requests and requests of the workers are
+ *    counted in stripes that are only added to the cluster wide counts once they have changed by
+ *    a batch, so the maximums are checked against counts that may lag by up to a batch per stripe.
  */
 class ResourceManagerImpl : public ResourceManager {
 public:
@@ -29,15 +33,16 @@ public:
                       uint64_t max_connections, uint64_t max_pending_requests,
                       uint64_t max_requests, uint64_t max_retries, uint64_t max_connection_pools,
                       ClusterCircuitBreakersStats cb_stats, absl::optional<double> budget_percent,
-                      absl::optional<uint32_t> min_retry_concurrency)
+                      absl::optional<uint32_t> min_retry_concurrency, bool striped_counters)
       : connections_(max_connections, runtime, runtime_key + "max_connections", cb_stats.cx_open_,
-                     cb_stats.remaining_cx_),
+                     cb_stats.remaining_cx_, striped_counters),
         pending_requests_(max_pending_requests, runtime, runtime_key + "max_pending_requests",
-                          cb_stats.rq_pending_open_, cb_stats.remaining_pending_),
+                          cb_stats.rq_pending_open_, cb_stats.remaining_pending_,
+                          striped_counters),
         requests_(max_requests, runtime, runtime_key + "max_requests", cb_stats.rq_open_,
-                  cb_stats.remaining_rq_),
+                  cb_stats.remaining_rq_, striped_counters),
         connection_pools_(max_connection_pools, runtime, runtime_key + "max_connection_pools",
-                          cb_stats.cx_pool_open_, cb_stats.remaining_cx_pools_),
+                          cb_stats.cx_pool_open_, cb_stats.remaining_cx_pools_, false),
         retries_(budget_percent, min_retry_concurrency, max_retries, runtime,
                  runtime_key + "retry_budget.", runtime_key + "max_retries",
                  cb_stats.rq_retry_open_, cb_stats.remaining_retries_, requests_,
@@ -53,29 +58,76 @@ public:
 private:
   struct ResourceImpl : public Resource {
     ResourceImpl(uint64_t max, Runtime::Loader& runtime, const std::string& runtime_key,
-                 Stats::Gauge& open_gauge, Stats::Gauge& remaining)
+                 Stats::Gauge& open_gauge, Stats::Gauge& remaining, bool striped)
         : max_(max), runtime_(runtime), runtime_key_(runtime_key), open_gauge_(open_gauge),
           remaining_(remaining) {
+      if (striped) {
+        allocateStripes();
+      }
       remaining_.set(max);
     }
-    ~ResourceImpl() override { ASSERT(current_ == 0); }
+    ~ResourceImpl() override { ASSERT(count() == 0); }
 
     // Upstream::Resource
-    bool canCreate() override { return current_ < max(); }
+    bool canCreate() override { return globalCount() < max(); }
     void inc() override {
+      if (stripes_ != nullptr) {
+        addToStripe(1);
+        return;
+      }
       current_++;
       updateRemaining();
       open_gauge_.set(canCreate() ? 0 : 1);
     }
+    bool tryInc() override {
+      if (stripes_ != nullptr) {
+        if (!canCreate()) {
+          open_gauge_.set(1);
+          return false;
+        }
+        addToStripe(1);
+        return true;
+      }
+      return tryIncBelow(max());
+    }
     void dec() override { decBy(1); }
     void decBy(uint64_t amount) override {
+      if (stripes_ != nullptr) {
+        addToStripe(-static_cast<int64_t>(amount));
+        return;
+      }
       ASSERT(current_ >= amount);
       current_ -= amount;
       updateRemaining();
       open_gauge_.set(canCreate() ? 0 : 1);
     }
     uint64_t max() override { return runtime_.snapshot().getInteger(runtime_key_, max_); }
-    uint64_t count() const override { return current_.load(); }
+    uint64_t count() const override {
+      uint64_t count = current_.load();
+      if (stripes_ != nullptr) {
+        for (size_t i = 0; i < NumStripes; i++) {
+          count += stripes_[i].delta_.load(std::memory_order_relaxed);
+        }
+      }
+      return count;
+    }
+
+    /**
+     * Increment the resource count if it is below the supplied maximum.
+     * @return true if the resource count was incremented.
+     */
+    bool tryIncBelow(uint64_t max) {
+      uint64_t current = current_.load();
+      do {
+        if (current >= max) {
+          open_gauge_.set(1);
+          return false;
+        }
+      } while (!current_.compare_exchange_weak(current, current + 1));
+      updateRemaining();
+      open_gauge_.set(current + 1 < max ? 0 : 1);
+      return true;
+    }
 
     /**
      * We set the gauge instead of incrementing and decrementing because,
@@ -87,10 +139,70 @@ private:
        * We cannot use std::max here because max() and current_ are
        * unsigned and subtracting them may overflow.
        */
-      const uint64_t current_copy = current_;
+      const uint64_t current_copy = globalCount();
       remaining_.set(max() > current_copy ? max() - current_copy : 0);
     }
 
+    /**
+     * With striped counters, the count of the stripes of other workers that is not yet added may
+     * be the increments of resources a stripe decremented, so the cluster wide count may be
+     * transiently negative, in which case none of the resources are counted.
+     */
+    uint64_t globalCount() const {
+      const uint64_t current = current_.load();
+      return stripes_ == nullptr || static_cast<int64_t>(current) > 0 ? current : 0;
+    }
+
+    /**
+     * Changes the count of the stripe of the calling worker, and adds it to the cluster wide count
+     * once it has changed by a batch. The batch is small enough for the count to lag by at most
+     * 1/NumStripes of the maximum, and the gauges are only updated along with the count.
+     */
+    void addToStripe(int64_t amount) {
+      const int64_t batch = std::max<uint64_t>(1, max() / (NumStripes * NumStripes));
+      std::atomic<int64_t>& delta = stripes_[stripeIndex()].delta_;
+      const int64_t stripe_delta = delta.fetch_add(amount, std::memory_order_relaxed) + amount;
+      if (stripe_delta < batch && stripe_delta > -batch) {
+        return;
+      }
+      current_ += static_cast<uint64_t>(delta.exchange(0, std::memory_order_relaxed));
+      updateRemaining();
+      open_gauge_.set(canCreate() ? 0 : 1);
+    }
+
+    /**
+     * @return size_t the stripe of the calling thread. The threads are given the stripes in turn.
+     */
+    static size_t stripeIndex() {
+      static std::atomic<size_t> next_stripe{0};
+      static thread_local const size_t stripe = next_stripe++ % NumStripes;
+      return stripe;
+    }
+
+    // Enough stripes for the workers of most deployments not to share them.
+    static constexpr size_t NumStripes = 16;
+
+    // A stripe is a cache line of its own, so that the workers don't write the same cache line.
+    struct alignas(64) Stripe {
+      std::atomic<int64_t> delta_{};
+    };
+
+    /**
+     * Allocates the stripes on a cache line boundary. The storage is over-allocated by a stripe and
+     * aligned by hand, as operator new[] only guarantees the alignment of over-aligned types from
+     * C++17 on.
+     */
+    void allocateStripes() {
+      size_t space = sizeof(Stripe) * (NumStripes + 1);
+      stripe_storage_ = std::make_unique<char[]>(space);
+      void* storage = stripe_storage_.get();
+      std::align(alignof(Stripe), sizeof(Stripe) * NumStripes, storage, space);
+      stripes_ = static_cast<Stripe*>(storage);
+      for (size_t i = 0; i < NumStripes; i++) {
+        new (&stripes_[i]) Stripe();
+      }
+    }
+
     const uint64_t max_;
     std::atomic<uint64_t> current_{};
     Runtime::Loader& runtime_;
@@ -106,6 +218,14 @@ private:
      * The number of resources remaining before the circuit breaker opens.
      */
     Stats::Gauge& remaining_;
+
+    /**
+     * The counts of the workers not yet added to current_, if the counters are striped, in the
+     * storage they are aligned in. A Stripe is trivially destructible, so freeing the storage is
+     * enough.
+     */
+    std::unique_ptr<char[]> stripe_storage_;
+    Stripe* stripes_{};
   };
 
   class RetryBudgetImpl : public Resource {
@@ -117,7 +237,8 @@ private:
                     Stats::Gauge& remaining, const Resource& requests,
                     const Resource& pending_requests)
         : runtime_(runtime),
-          max_retry_resource_(max_retries, runtime, max_retries_runtime_key, open_gauge, remaining),
+          max_retry_resource_(max_retries, runtime, max_retries_runtime_key, open_gauge, remaining,
+                              false),
           budget_percent_(budget_percent), min_retry_concurrency_(min_retry_concurrency),
           budget_percent_key_(retry_budget_runtime_key + "budget_percent"),
           min_retry_concurrency_key_(retry_budget_runtime_key + "min_retry_concurrency"),
@@ -135,6 +256,13 @@ private:
       max_retry_resource_.inc();
       clearRemainingGauge();
     }
+    bool tryInc() override {
+      // The budget is checked against the retries of all the workers, so that concurrent retries
+      // cannot exceed it.
+      const bool created = max_retry_resource_.tryIncBelow(max());
+      clearRemainingGauge();
+      return created;
+    }
     void dec() override {
       max_retry_resource_.dec();
       clearRemainingGauge();
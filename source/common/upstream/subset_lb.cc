@@ -330,6 +330,24 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
   return nullptr;
 }
 
+void SubsetLoadBalancer::updateHostMetadata(uint32_t priority, const HostVector& hosts_removed) {
+  metadata_generation_++;
+  for (const auto& host : hosts_removed) {
+    host_metadata_.erase(host.get());
+  }
+  // Hosts setting new metadata replace the shared metadata rather than modify it, so that a change
+  // is found by comparing pointers. The previous metadata is kept alive, so its address can't be
+  // reused by new metadata.
+  for (const auto& host : original_priority_set_.hostSetsPerPriority()[priority]->hosts()) {
+    std::shared_ptr<const envoy::config::core::v3alpha::Metadata> metadata = host->metadata();
+    HostMetadata& entry = host_metadata_[host.get()];
+    if (entry.metadata_ != metadata) {
+      entry.metadata_ = std::move(metadata);
+      entry.generation_ = metadata_generation_;
+    }
+  }
+}
+
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                                               const HostVector& hosts_removed) {
 
@@ -417,6 +435,7 @@ void SubsetLoadBalancer::processSubsets(
 // new subsets as necessary.
 void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added,
                                 const HostVector& hosts_removed) {
+  updateHostMetadata(priority, hosts_removed);
   updateFallbackSubset(priority, hosts_added, hosts_removed);
 
   processSubsets(
@@ -598,8 +617,9 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
                                                            HostPredicate predicate,
                                                            bool locality_weight_aware,
                                                            bool scale_locality_weight)
-    : original_priority_set_(subset_lb.original_priority_set_), predicate_(predicate),
-      locality_weight_aware_(locality_weight_aware), scale_locality_weight_(scale_locality_weight) {
+    : subset_lb_(subset_lb), original_priority_set_(subset_lb.original_priority_set_),
+      predicate_(predicate), locality_weight_aware_(locality_weight_aware),
+      scale_locality_weight_(scale_locality_weight) {
 
   for (size_t i = 0; i < original_priority_set_.hostSetsPerPriority().size(); ++i) {
     empty_ &= getOrCreateHostSet(i).hosts().empty();
@@ -652,14 +672,24 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
 
   case LoadBalancerType::OriginalDst:
   case LoadBalancerType::ClusterProvided:
-    // LoadBalancerType::OriginalDst is blocked in the factory. LoadBalancerType::ClusterProvided
-    // is impossible because the subset LB returns a null load balancer from its factory.
+  case LoadBalancerType::PeakEwma:
+    // LoadBalancerType::OriginalDst and LoadBalancerType::PeakEwma are blocked in the factory.
+    // LoadBalancerType::ClusterProvided is impossible because the subset LB returns a null load
+    // balancer from its factory.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
   triggerCallbacks();
 }
 
+bool SubsetLoadBalancer::HostSubsetImpl::mustMatch(const Host& host) const {
+  if (metadata_generation_ == 0) {
+    return true;
+  }
+  const auto it = subset_lb_.host_metadata_.find(&host);
+  return it == subset_lb_.host_metadata_.end() || it->second.generation_ > metadata_generation_;
+}
+
 // Given hosts_added and hosts_removed, update the underlying HostSet. The hosts_added Hosts must
 // be filtered to match hosts that belong in this subset. The hosts_removed Hosts are ignored if
 // they are not currently a member of this subset.
@@ -668,7 +698,8 @@ void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
                                                 std::function<bool(const Host&)> predicate) {
   // We cache the result of matching the host against the predicate. This ensures
   // that we maintain a consistent view of the metadata and saves on computation
-  // since metadata lookups can be expensive.
+  // since metadata lookups can be expensive. Only the hosts added or whose metadata changed since
+  // the last update are matched again, the others keep their membership.
   //
   // We use an unordered_set because this can potentially be in the tens of thousands.
   std::unordered_set<const Host*> matching_hosts;
@@ -682,7 +713,7 @@ void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
   auto hosts = std::make_shared<HostVector>();
   hosts->reserve(original_host_set_.hosts().size());
   for (const auto& host : original_host_set_.hosts()) {
-    if (predicate(*host)) {
+    if (mustMatch(*host) ? predicate(*host) : members_.count(host.get()) == 1) {
       matching_hosts.insert(host.get());
       hosts->emplace_back(host);
     }
@@ -747,6 +778,8 @@ void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
       filtered_removed.emplace_back(host);
     }
   }
+  members_ = std::move(matching_hosts);
+  metadata_generation_ = subset_lb_.metadata_generation_;
 
   HostSetImpl::updateHosts(HostSetImpl::updateHostsParams(
                                hosts, hosts_per_locality, healthy_hosts, healthy_hosts_per_locality,
@@ -800,7 +833,7 @@ HostSetImplPtr SubsetLoadBalancer::PrioritySubsetImpl::createHostSet(
   ASSERT(!overprovisioning_factor.has_value() ||
          overprovisioning_factor.value() == host_set->overprovisioningFactor());
   return HostSetImplPtr{
-      new HostSubsetImpl(*host_set, locality_weight_aware_, scale_locality_weight_)};
+      new HostSubsetImpl(subset_lb_, *host_set, locality_weight_aware_, scale_locality_weight_)};
 }
 
 void SubsetLoadBalancer::PrioritySubsetImpl::update(uint32_t priority,
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "envoy/config/cluster/v3alpha/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
@@ -52,10 +53,11 @@ private:
   // Represents a subset of an original HostSet.
   class HostSubsetImpl : public HostSetImpl {
   public:
-    HostSubsetImpl(const HostSet& original_host_set, bool locality_weight_aware,
-                   bool scale_locality_weight)
+    HostSubsetImpl(const SubsetLoadBalancer& subset_lb, const HostSet& original_host_set,
+                   bool locality_weight_aware, bool scale_locality_weight)
         : HostSetImpl(original_host_set.priority(), original_host_set.overprovisioningFactor()),
-          original_host_set_(original_host_set), locality_weight_aware_(locality_weight_aware),
+          subset_lb_(subset_lb), original_host_set_(original_host_set),
+          locality_weight_aware_(locality_weight_aware),
           scale_locality_weight_(scale_locality_weight) {}
 
     void update(const HostVector& hosts_added, const HostVector& hosts_removed,
@@ -67,9 +69,18 @@ private:
     bool empty() { return hosts().empty(); }
 
   private:
+    // Whether a host of the original host set must be matched against the predicate again, as it
+    // was added or its metadata changed since the last update of the subset.
+    bool mustMatch(const Host& host) const;
+
+    const SubsetLoadBalancer& subset_lb_;
     const HostSet& original_host_set_;
     const bool locality_weight_aware_;
     const bool scale_locality_weight_;
+    // The hosts of the original host set which are members of the subset.
+    std::unordered_set<const Host*> members_;
+    // The generation of the host metadata the subset was last updated at, 0 if never.
+    uint64_t metadata_generation_{0};
   };
 
   // Represents a subset of an original PrioritySet.
@@ -110,6 +121,7 @@ private:
                                  absl::optional<uint32_t> overprovisioning_factor) override;
 
   private:
+    const SubsetLoadBalancer& subset_lb_;
     const PrioritySet& original_priority_set_;
     const HostPredicate predicate_;
     const bool locality_weight_aware_;
@@ -195,6 +207,13 @@ private:
     PrioritySubsetImplPtr priority_subset_;
   };
 
+  // The metadata of a host when it was last seen by an update, and the generation at which it
+  // changed.
+  struct HostMetadata {
+    std::shared_ptr<const envoy::config::core::v3alpha::Metadata> metadata_;
+    uint64_t generation_;
+  };
+
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   void refreshSubsets();
   void refreshSubsets(uint32_t priority);
@@ -202,6 +221,9 @@ private:
   // Called by HostSet::MemberUpdateCb
   void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed);
 
+  // Records the hosts of a priority whose metadata changed, or which were added, since the last
+  // update.
+  void updateHostMetadata(uint32_t priority, const HostVector& hosts_removed);
   void updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                             const HostVector& hosts_removed);
   void processSubsets(
@@ -255,6 +277,11 @@ private:
 
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
+  // The metadata of every host, so that a subset only matches the hosts whose metadata changed
+  // since its last update against its predicate, rather than all the hosts.
+  std::unordered_map<const Host*, HostMetadata> host_metadata_;
+  // Incremented on every update.
+  uint64_t metadata_generation_{0};
   // Forms a trie-like structure of lexically sorted keys+fallback policy from subset
   // selectors configuration
   SubsetSelectorMapPtr selectors_;
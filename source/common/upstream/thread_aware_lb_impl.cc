@@ -93,6 +93,9 @@ void ThreadAwareLoadBalancerBase::refresh() {
   auto degraded_per_priority_load =
       std::make_shared<DegradedLoad>(per_priority_load_.degraded_priority_load_);
 
+  const size_t num_priorities = priority_set_.hostSetsPerPriority().size();
+  normalized_host_weights_.resize(num_priorities);
+  current_lbs_.resize(num_priorities);
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
     (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
@@ -107,8 +110,17 @@ void ThreadAwareLoadBalancerBase::refresh() {
     double max_normalized_weight = 0.0;
     normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
                      min_normalized_weight, max_normalized_weight);
-    per_priority_state->current_lb_ =
-        createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+
+    // Any priority update refreshes all priorities, but building a hashing load balancer is
+    // expensive (e.g. a 65537 entry Maglev table), so only rebuild the ones whose hosts or weights
+    // changed. The min and max weights are derived from the normalized weights, so they match too.
+    if (current_lbs_[priority] == nullptr ||
+        normalized_host_weights != normalized_host_weights_[priority]) {
+      current_lbs_[priority] =
+          createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+      normalized_host_weights_[priority] = std::move(normalized_host_weights);
+    }
+    per_priority_state->current_lb_ = current_lbs_[priority];
   }
 
   {
@@ -88,6 +88,10 @@ private:
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  // The normalized host weights each priority's current hashing load balancer was built from and
+  // the load balancers themselves. Only accessed from the main thread.
+  std::vector<NormalizedHostWeightVector> normalized_host_weights_;
+  std::vector<HashingLoadBalancerSharedPtr> current_lbs_;
 };
 
 } // namespace Upstream
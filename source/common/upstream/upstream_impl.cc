@@ -28,6 +28,7 @@
 
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 #include "common/common/utility.h"
 #include "common/config/utility.h"
 #include "common/http/utility.h"
@@ -47,12 +48,70 @@
 
 #include "extensions/transport_sockets/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Upstream {
 namespace {
 
+/**
+ * A pool of the messages that hosts have in common, so that the hosts with the same locality or
+ * metadata, which are most of the hosts of a large cluster, share a single copy of it. A message is
+ * freed along with the last host sharing it. Hosts may be created on any thread, so the pool is
+ * locked, but only when hosts are created or their metadata updated.
+ */
+template <class Message> class SharedMessagePool {
+public:
+  std::shared_ptr<const Message> get(const Message& message) {
+    // The deterministic serialization of equal messages is the same.
+    std::string key;
+    {
+      Protobuf::io::StringOutputStream string_stream(&key);
+      Protobuf::io::CodedOutputStream coded_stream(&string_stream);
+      coded_stream.SetSerializationDeterministic(true);
+      message.SerializeToCodedStream(&coded_stream);
+    }
+
+    absl::MutexLock lock(&mutex_);
+    auto it = messages_.find(key);
+    if (it != messages_.end()) {
+      std::shared_ptr<const Message> shared = it->second.lock();
+      if (shared != nullptr) {
+        return shared;
+      }
+    }
+    std::shared_ptr<const Message> shared(new Message(message),
+                                          [this, key](const Message* shared_message) {
+                                            delete shared_message;
+                                            release(key);
+                                          });
+    messages_[key] = shared;
+    return shared;
+  }
+
+private:
+  void release(const std::string& key) {
+    absl::MutexLock lock(&mutex_);
+    auto it = messages_.find(key);
+    // The message may have been added again since the last host sharing it was freed.
+    if (it != messages_.end() && it->second.expired()) {
+      messages_.erase(it);
+    }
+  }
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<const Message>> messages_ ABSL_GUARDED_BY(mutex_);
+};
+
+// The pools are never freed, as the hosts sharing their messages may outlive any of their owners.
+using MetadataPool = SharedMessagePool<envoy::config::core::v3alpha::Metadata>;
+MetadataPool& metadataPool() { MUTABLE_CONSTRUCT_ON_FIRST_USE(MetadataPool); }
+
+using LocalityPool = SharedMessagePool<envoy::config::core::v3alpha::Locality>;
+LocalityPool& localityPool() { MUTABLE_CONSTRUCT_ON_FIRST_USE(LocalityPool); }
+
 const Network::Address::InstanceConstSharedPtr
 getSourceAddress(const envoy::config::cluster::v3alpha::Cluster& cluster,
                  const envoy::config::core::v3alpha::BindConfig& bind_config) {
@@ -239,9 +298,12 @@ HostDescriptionImpl::HostDescriptionImpl(
       canary_(Config::Metadata::metadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
                                               Config::MetadataEnvoyLbKeys::get().CANARY)
                   .bool_value()),
-      metadata_(std::make_shared<envoy::config::core::v3alpha::Metadata>(metadata)),
-      locality_(locality),
+      metadata_(metadataPool().get(metadata)), locality_(localityPool().get(locality)),
       locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
+      latency_(std::chrono::milliseconds(
+          cluster->lbPeakEwmaConfig().has_value()
+              ? PROTOBUF_GET_MS_OR_DEFAULT(cluster->lbPeakEwmaConfig().value(), decay_time, 10000)
+              : 10000)),
       priority_(priority), socket_factory_(resolveTransportSocketFactory(dest_address, metadata)) {
   if (health_check_config.port_value() != 0 && dest_address->type() != Network::Address::Type::Ip) {
     // Setting the health check port to non-0 only works for IP-type addresses. Setting the port
@@ -255,6 +317,12 @@ HostDescriptionImpl::HostDescriptionImpl(
           : Network::Utility::getAddressWithPort(*dest_address, health_check_config.port_value());
 }
 
+void HostDescriptionImpl::metadata(const envoy::config::core::v3alpha::Metadata& new_metadata) {
+  auto metadata = metadataPool().get(new_metadata);
+  absl::WriterMutexLock lock(&metadata_mutex_);
+  metadata_ = std::move(metadata);
+}
+
 Network::TransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFactory(
     const Network::Address::InstanceConstSharedPtr& dest_address,
     const envoy::config::core::v3alpha::Metadata& metadata) {
@@ -450,12 +518,12 @@ HostSetImpl::chooseLocality(EdfScheduler<LocalityEntry>* locality_scheduler) {
   if (locality_scheduler == nullptr) {
     return {};
   }
-  const std::shared_ptr<LocalityEntry> locality = locality_scheduler->pick();
+  const std::shared_ptr<LocalityEntry> locality = locality_scheduler->pickAndAdd(
+      [](const LocalityEntry& locality) { return locality.effective_weight_; });
   // We don't build a schedule if there are no weighted localities, so we should always succeed.
   ASSERT(locality != nullptr);
   // If we picked it before, its weight must have been positive.
   ASSERT(locality->effective_weight_ > 0);
-  locality_scheduler->add(locality->effective_weight_, locality);
   return locality->index_;
 }
 
@@ -591,6 +659,11 @@ ClusterStats ClusterInfoImpl::generateStats(Stats::Scope& scope) {
   return {ALL_CLUSTER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+ClusterStats ClusterInfoImpl::generateLazyStats(Stats::LazyStatPool& pool) {
+  return {ALL_CLUSTER_STATS(LAZY_POOL_COUNTER(pool), LAZY_POOL_GAUGE(pool),
+                            LAZY_POOL_HISTOGRAM(pool))};
+}
+
 ClusterLoadReportStats ClusterInfoImpl::generateLoadReportStats(Stats::Scope& scope) {
   return {ALL_CLUSTER_LOAD_REPORT_STATS(POOL_COUNTER(scope))};
 }
@@ -599,6 +672,11 @@ ClusterTimeoutBudgetStats ClusterInfoImpl::generateTimeoutBudgetStats(Stats::Sco
   return {ALL_CLUSTER_TIMEOUT_BUDGET_STATS(POOL_HISTOGRAM(scope))};
 }
 
+ClusterTimeoutBudgetStats
+ClusterInfoImpl::generateLazyTimeoutBudgetStats(Stats::LazyStatPool& pool) {
+  return {ALL_CLUSTER_TIMEOUT_BUDGET_STATS(LAZY_POOL_HISTOGRAM(pool))};
+}
+
 // Implements the FactoryContext interface required by network filters.
 class FactoryContextImpl : public Server::Configuration::CommonFactoryContext {
 public:
@@ -645,6 +723,8 @@ ClusterInfoImpl::ClusterInfoImpl(
     : runtime_(runtime), name_(config.name()), type_(config.type()),
       max_requests_per_connection_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_requests_per_connection, 0)),
+      tcp_prefetch_connections_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.tcp_protocol_options(), prefetch_connections, 0)),
       max_response_headers_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           config.common_http_protocol_options(), max_headers_count,
           runtime_.snapshot().getInteger(Http::MaxResponseHeadersCountOverrideKey,
@@ -654,12 +734,20 @@ ClusterInfoImpl::ClusterInfoImpl(
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
-      stats_(generateStats(*stats_scope_)), load_report_stats_store_(stats_scope_->symbolTable()),
+      lazy_stats_pool_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.lazy_cluster_stats")
+              ? std::make_unique<Stats::LazyStatPool>(*stats_scope_)
+              : nullptr),
+      stats_(lazy_stats_pool_ != nullptr ? generateLazyStats(*lazy_stats_pool_)
+                                         : generateStats(*stats_scope_)),
+      load_report_stats_store_(stats_scope_->symbolTable()),
       load_report_stats_(generateLoadReportStats(load_report_stats_store_)),
-      timeout_budget_stats_(config.track_timeout_budgets()
-                                ? absl::make_optional<ClusterTimeoutBudgetStats>(
-                                      generateTimeoutBudgetStats(*stats_scope_))
-                                : absl::nullopt),
+      timeout_budget_stats_(
+          config.track_timeout_budgets()
+              ? absl::make_optional<ClusterTimeoutBudgetStats>(
+                    lazy_stats_pool_ != nullptr ? generateLazyTimeoutBudgetStats(*lazy_stats_pool_)
+                                                : generateTimeoutBudgetStats(*stats_scope_))
+              : absl::nullopt),
       features_(parseFeatures(config)),
       http1_settings_(Http::Utility::parseHttp1Settings(config.http_protocol_options())),
       http2_settings_(Http::Utility::parseHttp2Settings(config.http2_protocol_options())),
@@ -668,6 +756,7 @@ ClusterInfoImpl::ClusterInfoImpl(
       maintenance_mode_runtime_key_(absl::StrCat("upstream.maintenance_mode.", name_)),
       source_address_(getSourceAddress(config, bind_config)),
       lb_least_request_config_(config.least_request_lb_config()),
+      lb_peak_ewma_config_(config.peak_ewma_lb_config()),
       lb_ring_hash_config_(config.ring_hash_lb_config()),
       lb_original_dst_config_(config.original_dst_lb_config()), added_via_api_(added_via_api),
       lb_subset_(LoadBalancerSubsetInfoImpl(config.lb_subset_config())),
@@ -721,6 +810,15 @@ ClusterInfoImpl::ClusterInfoImpl(
   case envoy::config::cluster::v3alpha::Cluster::MAGLEV:
     lb_type_ = LoadBalancerType::Maglev;
     break;
+  case envoy::config::cluster::v3alpha::Cluster::PEAK_EWMA:
+    if (config.has_lb_subset_config()) {
+      throw EnvoyException(
+          fmt::format("cluster: LB policy {} cannot be combined with lb_subset_config",
+                      envoy::config::cluster::v3alpha::Cluster::LbPolicy_Name(config.lb_policy())));
+    }
+
+    lb_type_ = LoadBalancerType::PeakEwma;
+    break;
   case envoy::config::cluster::v3alpha::Cluster::CLUSTER_PROVIDED:
     if (config.has_lb_subset_config()) {
       throw EnvoyException(
@@ -1091,6 +1189,7 @@ ResourceManagerImplPtr ClusterInfoImpl::ResourceManagers::load(
   uint64_t max_connection_pools = std::numeric_limits<uint64_t>::max();
 
   bool track_remaining = false;
+  bool striped_counters = false;
 
   std::string priority_name;
   switch (priority) {
@@ -1123,6 +1222,7 @@ ResourceManagerImplPtr ClusterInfoImpl::ResourceManagers::load(
     max_requests = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_requests, max_requests);
     max_retries = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_retries, max_retries);
     track_remaining = it->track_remaining();
+    striped_counters = it->striped_counters();
     max_connection_pools =
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connection_pools, max_connection_pools);
     if (it->has_retry_budget()) {
@@ -1143,7 +1243,7 @@ ResourceManagerImplPtr ClusterInfoImpl::ResourceManagers::load(
       runtime, runtime_prefix, max_connections, max_pending_requests, max_requests, max_retries,
       max_connection_pools,
       ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_name, track_remaining),
-      budget_percent, min_retry_concurrency);
+      budget_percent, min_retry_concurrency, striped_counters);
 }
 
 PriorityStateManager::PriorityStateManager(ClusterImplBase& cluster,
@@ -43,6 +43,8 @@
 #include "common/init/manager_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/stats/lazy_stats_impl.h"
+#include "common/upstream/host_latency_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
 #include "common/upstream/resource_manager_impl.h"
@@ -89,14 +91,11 @@ public:
   // endpoints churning during a deploy of a large cluster). A possible improvement
   // would be to use TLS and post metadata updates from the main thread. This model would
   // possibly benefit other related and expensive computations too (e.g.: updating subsets).
-  const std::shared_ptr<envoy::config::core::v3alpha::Metadata> metadata() const override {
+  const std::shared_ptr<const envoy::config::core::v3alpha::Metadata> metadata() const override {
     absl::ReaderMutexLock lock(&metadata_mutex_);
     return metadata_;
   }
-  void metadata(const envoy::config::core::v3alpha::Metadata& new_metadata) override {
-    absl::WriterMutexLock lock(&metadata_mutex_);
-    metadata_ = std::make_shared<envoy::config::core::v3alpha::Metadata>(new_metadata);
-  }
+  void metadata(const envoy::config::core::v3alpha::Metadata& new_metadata) override;
 
   const ClusterInfo& cluster() const override { return *cluster_; }
   HealthCheckHostMonitor& healthChecker() const override {
@@ -118,12 +117,13 @@ public:
     }
   }
   HostStats& stats() const override { return stats_; }
+  HostLatency& latency() const override { return latency_; }
   const std::string& hostname() const override { return hostname_; }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
   Network::Address::InstanceConstSharedPtr healthCheckAddress() const override {
     return health_check_address_;
   }
-  const envoy::config::core::v3alpha::Locality& locality() const override { return locality_; }
+  const envoy::config::core::v3alpha::Locality& locality() const override { return *locality_; }
   Stats::StatName localityZoneStatName() const override {
     return locality_zone_stat_name_.statName();
   }
@@ -142,11 +142,13 @@ protected:
   Network::Address::InstanceConstSharedPtr health_check_address_;
   std::atomic<bool> canary_;
   mutable absl::Mutex metadata_mutex_;
-  std::shared_ptr<envoy::config::core::v3alpha::Metadata>
+  // The metadata and locality of the hosts are shared by the hosts that have the same ones.
+  std::shared_ptr<const envoy::config::core::v3alpha::Metadata>
       metadata_ ABSL_GUARDED_BY(metadata_mutex_);
-  const envoy::config::core::v3alpha::Locality locality_;
+  const std::shared_ptr<const envoy::config::core::v3alpha::Locality> locality_;
   Stats::StatNameManagedStorage locality_zone_stat_name_;
   mutable HostStats stats_;
+  mutable HostLatencyImpl latency_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
   std::atomic<uint32_t> priority_;
@@ -516,11 +518,13 @@ public:
                   Server::Configuration::TransportSocketFactoryContext&);
 
   static ClusterStats generateStats(Stats::Scope& scope);
+  static ClusterStats generateLazyStats(Stats::LazyStatPool& pool);
   static ClusterLoadReportStats generateLoadReportStats(Stats::Scope& scope);
   static ClusterCircuitBreakersStats generateCircuitBreakersStats(Stats::Scope& scope,
                                                                   const std::string& stat_prefix,
                                                                   bool track_remaining);
   static ClusterTimeoutBudgetStats generateTimeoutBudgetStats(Stats::Scope&);
+  static ClusterTimeoutBudgetStats generateLazyTimeoutBudgetStats(Stats::LazyStatPool& pool);
 
   // Upstream::ClusterInfo
   bool addedViaApi() const override { return added_via_api_; }
@@ -549,6 +553,10 @@ public:
   lbLeastRequestConfig() const override {
     return lb_least_request_config_;
   }
+  const absl::optional<envoy::config::cluster::v3alpha::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const override {
+    return lb_peak_ewma_config_;
+  }
   const absl::optional<envoy::config::cluster::v3alpha::Cluster::RingHashLbConfig>&
   lbRingHashConfig() const override {
     return lb_ring_hash_config_;
@@ -559,6 +567,7 @@ public:
   }
   bool maintenanceMode() const override;
   uint64_t maxRequestsPerConnection() const override { return max_requests_per_connection_; }
+  uint32_t tcpPrefetchConnections() const override { return tcp_prefetch_connections_; }
   uint32_t maxResponseHeadersCount() const override { return max_response_headers_count_; }
   const std::string& name() const override { return name_; }
   ResourceManager& resourceManager(ResourcePriority priority) const override;
@@ -612,12 +621,15 @@ private:
   const std::string name_;
   const envoy::config::cluster::v3alpha::Cluster::DiscoveryType type_;
   const uint64_t max_requests_per_connection_;
+  const uint32_t tcp_prefetch_connections_;
   const uint32_t max_response_headers_count_;
   const std::chrono::milliseconds connect_timeout_;
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const uint32_t per_connection_buffer_limit_bytes_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopePtr stats_scope_;
+  // Only set when cluster stats are created on first use. Must outlive stats_.
+  const std::unique_ptr<Stats::LazyStatPool> lazy_stats_pool_;
   mutable ClusterStats stats_;
   Stats::IsolatedStoreImpl load_report_stats_store_;
   mutable ClusterLoadReportStats load_report_stats_;
@@ -632,6 +644,7 @@ private:
   LoadBalancerType lb_type_;
   absl::optional<envoy::config::cluster::v3alpha::Cluster::LeastRequestLbConfig>
       lb_least_request_config_;
+  absl::optional<envoy::config::cluster::v3alpha::Cluster::PeakEwmaLbConfig> lb_peak_ewma_config_;
   absl::optional<envoy::config::cluster::v3alpha::Cluster::RingHashLbConfig> lb_ring_hash_config_;
   absl::optional<envoy::config::cluster::v3alpha::Cluster::OriginalDstLbConfig>
       lb_original_dst_config_;
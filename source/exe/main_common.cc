@@ -81,6 +81,8 @@ MainCommonBase::MainCommonBase(const OptionsImpl& options, Event::TimeSystem& ti
     std::set_new_handler([]() { PANIC("out of memory"); });
 
     stats_store_ = std::make_unique<Stats::ThreadLocalStoreImpl>(stats_allocator_);
+    // The server init manager times its targets, to profile the startup.
+    init_manager_ = std::make_unique<Init::ManagerImpl>("Server", time_system);
 
     server_ = std::make_unique<Server::InstanceImpl>(
         *init_manager_, options_, time_system, local_address, listener_hooks, *restarter_,
@@ -82,7 +82,7 @@ protected:
   std::unique_ptr<Server::HotRestart> restarter_;
   std::unique_ptr<Stats::ThreadLocalStoreImpl> stats_store_;
   std::unique_ptr<Logger::Context> logging_context_;
-  std::unique_ptr<Init::Manager> init_manager_{std::make_unique<Init::ManagerImpl>("Server")};
+  std::unique_ptr<Init::Manager> init_manager_;
   std::unique_ptr<Server::InstanceImpl> server_;
 
 private:
@@ -0,0 +1,424 @@
+#include "extensions/access_loggers/file/delimited_proto_formatter.h"
+
+#include "envoy/config/core/v3alpha/address.pb.h"
+#include "envoy/config/core/v3alpha/base.pb.h"
+#include "envoy/data/accesslog/v3alpha/accesslog.pb.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/common/assert.h"
+#include "common/protobuf/protobuf.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+
+namespace {
+
+using envoy::data::accesslog::v3alpha::AccessLogCommon;
+using envoy::data::accesslog::v3alpha::HTTPAccessLogEntry;
+using envoy::data::accesslog::v3alpha::HTTPRequestProperties;
+using envoy::data::accesslog::v3alpha::HTTPResponseProperties;
+using envoy::data::accesslog::v3alpha::ResponseFlags;
+
+// The largest size of a varint, for 64 bit values.
+constexpr size_t MaxVarintSize = 10;
+
+// Map entries are messages with the key and the value as first and second fields.
+constexpr uint32_t MapKeyFieldNumber = 1;
+constexpr uint32_t MapValueFieldNumber = 2;
+
+/**
+ * Appends fields in the protobuf wire format to a string. Scalar fields with default values are
+ * not written, as in the serialization of proto3 messages.
+ *
+ * As with the serialization of generated messages, the fields are written in two passes: the
+ * first one only sizes the messages, so that the second one can write the size of each message
+ * ahead of it rather than insert it once the message is written.
+ */
+class WireWriter {
+public:
+  explicit WireWriter(std::string& output) : output_(output) {}
+
+  /**
+   * Writes the fields written by the callback, preceded by their size as a varint.
+   */
+  template <class Callback> void delimited(Callback callback) {
+    sizing_ = true;
+    callback();
+    sizing_ = false;
+    output_.reserve(output_.size() + varintSize(size_) + size_);
+    appendVarint(size_);
+    callback();
+    ASSERT(next_message_ == message_sizes_.size());
+  }
+
+  void uint64Field(uint32_t field, uint64_t value) {
+    if (value != 0) {
+      appendVarint(tag(field, WireType::Varint));
+      appendVarint(value);
+    }
+  }
+
+  // Negative values are sign extended to 64 bits, as for both int32 and int64 fields.
+  void int64Field(uint32_t field, int64_t value) {
+    uint64Field(field, static_cast<uint64_t>(value));
+  }
+
+  void stringField(uint32_t field, absl::string_view value) {
+    if (!value.empty()) {
+      appendVarint(tag(field, WireType::LengthDelimited));
+      appendVarint(value.size());
+      appendBytes(value);
+    }
+  }
+
+  // Writes a message field with the fields written by the callback. Unlike scalar fields, the
+  // message is written even if empty, to mark its presence.
+  template <class Callback> void messageField(uint32_t field, Callback callback) {
+    appendVarint(tag(field, WireType::LengthDelimited));
+    if (!sizing_) {
+      appendVarint(message_sizes_[next_message_++]);
+      callback();
+      return;
+    }
+
+    // The sizes are recorded in the order the messages start, which is the order they are
+    // written in.
+    const size_t index = message_sizes_.size();
+    message_sizes_.push_back(0);
+    const uint64_t start = size_;
+    callback();
+    message_sizes_[index] = size_ - start;
+    size_ += varintSize(message_sizes_[index]);
+  }
+
+private:
+  enum class WireType : uint32_t { Varint = 0, LengthDelimited = 2 };
+
+  static uint64_t tag(uint32_t field, WireType type) {
+    return (static_cast<uint64_t>(field) << 3) | static_cast<uint32_t>(type);
+  }
+
+  static size_t encodeVarint(uint64_t value, char* output) {
+    size_t size = 0;
+    while (value >= 0x80) {
+      output[size++] = static_cast<char>(value | 0x80);
+      value >>= 7;
+    }
+    output[size++] = static_cast<char>(value);
+    return size;
+  }
+
+  static uint64_t varintSize(uint64_t value) {
+    uint64_t size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      size++;
+    }
+    return size;
+  }
+
+  void appendVarint(uint64_t value) {
+    if (sizing_) {
+      size_ += varintSize(value);
+      return;
+    }
+    char varint[MaxVarintSize];
+    output_.append(varint, encodeVarint(value, varint));
+  }
+
+  void appendBytes(absl::string_view bytes) {
+    if (sizing_) {
+      size_ += bytes.size();
+      return;
+    }
+    output_.append(bytes.data(), bytes.size());
+  }
+
+  std::string& output_;
+  bool sizing_{};
+  // The size of the fields written while sizing.
+  uint64_t size_{};
+  // The sizes of the messages, recorded while sizing and consumed while writing.
+  absl::InlinedVector<uint64_t, 32> message_sizes_;
+  size_t next_message_{};
+};
+
+void writeAddress(WireWriter& writer, uint32_t field, const Network::Address::Instance& address) {
+  writer.messageField(field, [&writer, &address]() {
+    if (address.type() == Network::Address::Type::Pipe) {
+      writer.messageField(envoy::config::core::v3alpha::Address::kPipeFieldNumber,
+                          [&writer, &address]() {
+                            writer.stringField(envoy::config::core::v3alpha::Pipe::kPathFieldNumber,
+                                               address.asString());
+                          });
+    } else {
+      ASSERT(address.type() == Network::Address::Type::Ip);
+      writer.messageField(
+          envoy::config::core::v3alpha::Address::kSocketAddressFieldNumber, [&writer, &address]() {
+            writer.stringField(envoy::config::core::v3alpha::SocketAddress::kAddressFieldNumber,
+                               address.ip()->addressAsString());
+            writer.uint64Field(envoy::config::core::v3alpha::SocketAddress::kPortValueFieldNumber,
+                               address.ip()->port());
+          });
+    }
+  });
+}
+
+// Timestamps and durations share their seconds and nanos fields.
+void writeNanoseconds(WireWriter& writer, uint32_t field, std::chrono::nanoseconds nanoseconds) {
+  writer.messageField(field, [&writer, nanoseconds]() {
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(nanoseconds);
+    writer.int64Field(ProtobufWkt::Duration::kSecondsFieldNumber, seconds.count());
+    writer.int64Field(ProtobufWkt::Duration::kNanosFieldNumber, (nanoseconds - seconds).count());
+  });
+}
+
+void writeDuration(WireWriter& writer, uint32_t field,
+                   const absl::optional<std::chrono::nanoseconds>& duration) {
+  if (duration) {
+    writeNanoseconds(writer, field, duration.value());
+  }
+}
+
+void writeResponseFlags(WireWriter& writer, const StreamInfo::StreamInfo& stream_info) {
+  static_assert(StreamInfo::ResponseFlag::LastFlag == 0x40000,
+                "A flag has been added. Fix this code.");
+
+  struct ResponseFlagField {
+    StreamInfo::ResponseFlag flag_;
+    uint32_t field_;
+  };
+  static const ResponseFlagField response_flag_fields[] = {
+      {StreamInfo::ResponseFlag::FailedLocalHealthCheck,
+       ResponseFlags::kFailedLocalHealthcheckFieldNumber},
+      {StreamInfo::ResponseFlag::NoHealthyUpstream, ResponseFlags::kNoHealthyUpstreamFieldNumber},
+      {StreamInfo::ResponseFlag::UpstreamRequestTimeout,
+       ResponseFlags::kUpstreamRequestTimeoutFieldNumber},
+      {StreamInfo::ResponseFlag::LocalReset, ResponseFlags::kLocalResetFieldNumber},
+      {StreamInfo::ResponseFlag::UpstreamRemoteReset,
+       ResponseFlags::kUpstreamRemoteResetFieldNumber},
+      {StreamInfo::ResponseFlag::UpstreamConnectionFailure,
+       ResponseFlags::kUpstreamConnectionFailureFieldNumber},
+      {StreamInfo::ResponseFlag::UpstreamConnectionTermination,
+       ResponseFlags::kUpstreamConnectionTerminationFieldNumber},
+      {StreamInfo::ResponseFlag::UpstreamOverflow, ResponseFlags::kUpstreamOverflowFieldNumber},
+      {StreamInfo::ResponseFlag::NoRouteFound, ResponseFlags::kNoRouteFoundFieldNumber},
+      {StreamInfo::ResponseFlag::DelayInjected, ResponseFlags::kDelayInjectedFieldNumber},
+      {StreamInfo::ResponseFlag::FaultInjected, ResponseFlags::kFaultInjectedFieldNumber},
+      {StreamInfo::ResponseFlag::RateLimited, ResponseFlags::kRateLimitedFieldNumber},
+      {StreamInfo::ResponseFlag::RateLimitServiceError,
+       ResponseFlags::kRateLimitServiceErrorFieldNumber},
+      {StreamInfo::ResponseFlag::DownstreamConnectionTermination,
+       ResponseFlags::kDownstreamConnectionTerminationFieldNumber},
+      {StreamInfo::ResponseFlag::UpstreamRetryLimitExceeded,
+       ResponseFlags::kUpstreamRetryLimitExceededFieldNumber},
+      {StreamInfo::ResponseFlag::StreamIdleTimeout, ResponseFlags::kStreamIdleTimeoutFieldNumber},
+      {StreamInfo::ResponseFlag::InvalidEnvoyRequestHeaders,
+       ResponseFlags::kInvalidEnvoyRequestHeadersFieldNumber},
+      {StreamInfo::ResponseFlag::DownstreamProtocolError,
+       ResponseFlags::kDownstreamProtocolErrorFieldNumber},
+  };
+
+  if (!stream_info.hasAnyResponseFlag()) {
+    return;
+  }
+
+  writer.messageField(AccessLogCommon::kResponseFlagsFieldNumber, [&writer, &stream_info]() {
+    for (const ResponseFlagField& response_flag_field : response_flag_fields) {
+      writer.uint64Field(response_flag_field.field_,
+                         stream_info.hasResponseFlag(response_flag_field.flag_));
+    }
+    if (stream_info.hasResponseFlag(StreamInfo::ResponseFlag::UnauthorizedExternalService)) {
+      writer.messageField(ResponseFlags::kUnauthorizedDetailsFieldNumber, [&writer]() {
+        writer.uint64Field(ResponseFlags::Unauthorized::kReasonFieldNumber,
+                           ResponseFlags::Unauthorized::EXTERNAL_SERVICE);
+      });
+    }
+  });
+}
+
+// Writes the same common properties as the gRPC access loggers, except for the TLS properties,
+// the dynamic metadata and the filter state objects.
+void writeCommonProperties(WireWriter& writer, const StreamInfo::StreamInfo& stream_info) {
+  if (stream_info.downstreamRemoteAddress() != nullptr) {
+    writeAddress(writer, AccessLogCommon::kDownstreamRemoteAddressFieldNumber,
+                 *stream_info.downstreamRemoteAddress());
+  }
+  if (stream_info.downstreamLocalAddress() != nullptr) {
+    writeAddress(writer, AccessLogCommon::kDownstreamLocalAddressFieldNumber,
+                 *stream_info.downstreamLocalAddress());
+  }
+  writeNanoseconds(writer, AccessLogCommon::kStartTimeFieldNumber,
+                   stream_info.startTime().time_since_epoch());
+  writeDuration(writer, AccessLogCommon::kTimeToLastRxByteFieldNumber,
+                stream_info.lastDownstreamRxByteReceived());
+  writeDuration(writer, AccessLogCommon::kTimeToFirstUpstreamTxByteFieldNumber,
+                stream_info.firstUpstreamTxByteSent());
+  writeDuration(writer, AccessLogCommon::kTimeToLastUpstreamTxByteFieldNumber,
+                stream_info.lastUpstreamTxByteSent());
+  writeDuration(writer, AccessLogCommon::kTimeToFirstUpstreamRxByteFieldNumber,
+                stream_info.firstUpstreamRxByteReceived());
+  writeDuration(writer, AccessLogCommon::kTimeToLastUpstreamRxByteFieldNumber,
+                stream_info.lastUpstreamRxByteReceived());
+  writeDuration(writer, AccessLogCommon::kTimeToFirstDownstreamTxByteFieldNumber,
+                stream_info.firstDownstreamTxByteSent());
+  writeDuration(writer, AccessLogCommon::kTimeToLastDownstreamTxByteFieldNumber,
+                stream_info.lastDownstreamTxByteSent());
+  if (stream_info.upstreamHost() != nullptr) {
+    writeAddress(writer, AccessLogCommon::kUpstreamRemoteAddressFieldNumber,
+                 *stream_info.upstreamHost()->address());
+  }
+  if (stream_info.upstreamLocalAddress() != nullptr) {
+    writeAddress(writer, AccessLogCommon::kUpstreamLocalAddressFieldNumber,
+                 *stream_info.upstreamLocalAddress());
+  }
+  if (stream_info.upstreamHost() != nullptr) {
+    writer.stringField(AccessLogCommon::kUpstreamClusterFieldNumber,
+                       stream_info.upstreamHost()->cluster().name());
+  }
+  writeResponseFlags(writer, stream_info);
+  writer.stringField(AccessLogCommon::kUpstreamTransportFailureReasonFieldNumber,
+                     stream_info.upstreamTransportFailureReason());
+  writer.stringField(AccessLogCommon::kRouteNameFieldNumber, stream_info.getRouteName());
+  if (stream_info.downstreamDirectRemoteAddress() != nullptr) {
+    writeAddress(writer, AccessLogCommon::kDownstreamDirectRemoteAddressFieldNumber,
+                 *stream_info.downstreamDirectRemoteAddress());
+  }
+}
+
+void writeHeader(WireWriter& writer, uint32_t field, const Http::HeaderEntry* entry) {
+  if (entry != nullptr) {
+    writer.stringField(field, entry->value().getStringView());
+  }
+}
+
+void writeHeaders(WireWriter& writer, uint32_t field, const Http::HeaderMap& headers,
+                  const std::vector<Http::LowerCaseString>& headers_to_log) {
+  for (const Http::LowerCaseString& header : headers_to_log) {
+    const Http::HeaderEntry* entry = headers.get(header);
+    if (entry != nullptr) {
+      writer.messageField(field, [&writer, &header, entry]() {
+        writer.stringField(MapKeyFieldNumber, header.get());
+        writer.stringField(MapValueFieldNumber, entry->value().getStringView());
+      });
+    }
+  }
+}
+
+} // namespace
+
+DelimitedProtoFormatter::DelimitedProtoFormatter(
+    const envoy::extensions::access_loggers::file::v3alpha::FileAccessLog::DelimitedProtoFormat&
+        config) {
+  for (const auto& header : config.additional_request_headers_to_log()) {
+    request_headers_to_log_.emplace_back(header);
+  }
+
+  for (const auto& header : config.additional_response_headers_to_log()) {
+    response_headers_to_log_.emplace_back(header);
+  }
+
+  for (const auto& header : config.additional_response_trailers_to_log()) {
+    response_trailers_to_log_.emplace_back(header);
+  }
+}
+
+std::string DelimitedProtoFormatter::format(const Http::HeaderMap& request_headers,
+                                            const Http::HeaderMap& response_headers,
+                                            const Http::HeaderMap& response_trailers,
+                                            const StreamInfo::StreamInfo& stream_info) const {
+  std::string log_entry;
+  formatTo(request_headers, response_headers, response_trailers, stream_info, log_entry);
+  return log_entry;
+}
+
+void DelimitedProtoFormatter::formatTo(const Http::HeaderMap& request_headers,
+                                       const Http::HeaderMap& response_headers,
+                                       const Http::HeaderMap& response_trailers,
+                                       const StreamInfo::StreamInfo& stream_info,
+                                       std::string& output) const {
+  WireWriter writer(output);
+  writer.delimited([&]() {
+    writer.messageField(HTTPAccessLogEntry::kCommonPropertiesFieldNumber,
+                        [&writer, &stream_info]() { writeCommonProperties(writer, stream_info); });
+
+    if (stream_info.protocol()) {
+      switch (stream_info.protocol().value()) {
+      case Http::Protocol::Http10:
+        writer.uint64Field(HTTPAccessLogEntry::kProtocolVersionFieldNumber,
+                           HTTPAccessLogEntry::HTTP10);
+        break;
+      case Http::Protocol::Http11:
+        writer.uint64Field(HTTPAccessLogEntry::kProtocolVersionFieldNumber,
+                           HTTPAccessLogEntry::HTTP11);
+        break;
+      case Http::Protocol::Http2:
+        writer.uint64Field(HTTPAccessLogEntry::kProtocolVersionFieldNumber,
+                           HTTPAccessLogEntry::HTTP2);
+        break;
+      case Http::Protocol::Http3:
+        writer.uint64Field(HTTPAccessLogEntry::kProtocolVersionFieldNumber,
+                           HTTPAccessLogEntry::HTTP3);
+        break;
+      }
+    }
+
+    writer.messageField(HTTPAccessLogEntry::kRequestFieldNumber, [&]() {
+      if (request_headers.Method() != nullptr) {
+        envoy::config::core::v3alpha::RequestMethod method =
+            envoy::config::core::v3alpha::METHOD_UNSPECIFIED;
+        envoy::config::core::v3alpha::RequestMethod_Parse(
+            std::string(request_headers.Method()->value().getStringView()), &method);
+        writer.uint64Field(HTTPRequestProperties::kRequestMethodFieldNumber, method);
+      }
+      writeHeader(writer, HTTPRequestProperties::kSchemeFieldNumber, request_headers.Scheme());
+      writeHeader(writer, HTTPRequestProperties::kAuthorityFieldNumber, request_headers.Host());
+      writeHeader(writer, HTTPRequestProperties::kPathFieldNumber, request_headers.Path());
+      writeHeader(writer, HTTPRequestProperties::kUserAgentFieldNumber,
+                  request_headers.UserAgent());
+      writeHeader(writer, HTTPRequestProperties::kRefererFieldNumber, request_headers.Referer());
+      writeHeader(writer, HTTPRequestProperties::kForwardedForFieldNumber,
+                  request_headers.ForwardedFor());
+      writeHeader(writer, HTTPRequestProperties::kRequestIdFieldNumber,
+                  request_headers.RequestId());
+      writeHeader(writer, HTTPRequestProperties::kOriginalPathFieldNumber,
+                  request_headers.EnvoyOriginalPath());
+      writer.uint64Field(HTTPRequestProperties::kRequestHeadersBytesFieldNumber,
+                         request_headers.byteSize());
+      writer.uint64Field(HTTPRequestProperties::kRequestBodyBytesFieldNumber,
+                         stream_info.bytesReceived());
+      writeHeaders(writer, HTTPRequestProperties::kRequestHeadersFieldNumber, request_headers,
+                   request_headers_to_log_);
+    });
+
+    writer.messageField(HTTPAccessLogEntry::kResponseFieldNumber, [&]() {
+      if (stream_info.responseCode()) {
+        writer.messageField(HTTPResponseProperties::kResponseCodeFieldNumber, [&]() {
+          writer.uint64Field(ProtobufWkt::UInt32Value::kValueFieldNumber,
+                             stream_info.responseCode().value());
+        });
+      }
+      writer.uint64Field(HTTPResponseProperties::kResponseHeadersBytesFieldNumber,
+                         response_headers.byteSize());
+      writer.uint64Field(HTTPResponseProperties::kResponseBodyBytesFieldNumber,
+                         stream_info.bytesSent());
+      writeHeaders(writer, HTTPResponseProperties::kResponseHeadersFieldNumber, response_headers,
+                   response_headers_to_log_);
+      writeHeaders(writer, HTTPResponseProperties::kResponseTrailersFieldNumber, response_trailers,
+                   response_trailers_to_log_);
+      if (stream_info.responseCodeDetails()) {
+        writer.stringField(HTTPResponseProperties::kResponseCodeDetailsFieldNumber,
+                           stream_info.responseCodeDetails().value());
+      }
+    });
+  });
+}
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/extensions/access_loggers/file/v3alpha/file.pb.h"
+#include "envoy/http/header_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+
+/**
+ * Formatter writing each log entry as a binary HTTPAccessLogEntry message preceded by its size as a
+ * varint. The wire format of the entry is written directly from the headers and the stream info,
+ * without building the message, and only the fields that are set are written.
+ */
+class DelimitedProtoFormatter : public AccessLog::Formatter {
+public:
+  DelimitedProtoFormatter(
+      const envoy::extensions::access_loggers::file::v3alpha::FileAccessLog::DelimitedProtoFormat&
+          config);
+
+  // AccessLog::Formatter
+  std::string format(const Http::HeaderMap& request_headers,
+                     const Http::HeaderMap& response_headers,
+                     const Http::HeaderMap& response_trailers,
+                     const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
+
+private:
+  std::vector<Http::LowerCaseString> request_headers_to_log_;
+  std::vector<Http::LowerCaseString> response_headers_to_log_;
+  std::vector<Http::LowerCaseString> response_trailers_to_log_;
+};
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -5,6 +5,11 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace File {
 
+namespace {
+// Above this capacity, the log line buffer of a thread is released after a line is written.
+constexpr size_t MaxRetainedLogLineCapacity = 64 * 1024;
+} // namespace
+
 FileAccessLog::FileAccessLog(const std::string& access_log_path, AccessLog::FilterPtr&& filter,
                              AccessLog::FormatterPtr&& formatter,
                              AccessLog::AccessLogManager& log_manager)
@@ -16,8 +21,15 @@ void FileAccessLog::emitLog(const Http::HeaderMap& request_headers,
                             const Http::HeaderMap& response_headers,
                             const Http::HeaderMap& response_trailers,
                             const StreamInfo::StreamInfo& stream_info) {
-  log_file_->write(
-      formatter_->format(request_headers, response_headers, response_trailers, stream_info));
+  // Each thread formats its log lines into a buffer which keeps its capacity across lines, as the
+  // file copies the line into its own buffer when written.
+  static thread_local std::string log_line;
+  log_line.clear();
+  formatter_->formatTo(request_headers, response_headers, response_trailers, stream_info, log_line);
+  log_file_->write(log_line);
+  if (log_line.capacity() > MaxRetainedLogLineCapacity) {
+    std::string().swap(log_line);
+  }
 }
 
 } // namespace File
@@ -26,19 +26,40 @@ void GrpcAccessLoggerImpl::LocalStream::onRemoteClose(Grpc::Status::GrpcStatus,
 GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std::string log_name,
                                            std::chrono::milliseconds buffer_flush_interval_msec,
                                            uint64_t buffer_size_bytes,
+                                           uint64_t max_buffer_size_bytes,
                                            Event::Dispatcher& dispatcher,
-                                           const LocalInfo::LocalInfo& local_info)
+                                           const LocalInfo::LocalInfo& local_info,
+                                           Stats::Scope& scope)
     : client_(std::move(client)), log_name_(log_name),
       buffer_flush_interval_msec_(buffer_flush_interval_msec),
       flush_timer_(dispatcher.createTimer([this]() {
         flush();
         flush_timer_->enableTimer(buffer_flush_interval_msec_);
       })),
-      buffer_size_bytes_(buffer_size_bytes), local_info_(local_info) {
+      buffer_size_bytes_(buffer_size_bytes), max_buffer_size_bytes_(max_buffer_size_bytes),
+      local_info_(local_info),
+      stats_({ALL_GRPC_ACCESS_LOGGER_STATS(
+          POOL_COUNTER_PREFIX(scope, "access_logs.grpc_access_log."))}) {
   flush_timer_->enableTimer(buffer_flush_interval_msec_);
 }
 
+bool GrpcAccessLoggerImpl::canLogMore() {
+  if (approximate_message_size_bytes_ < max_buffer_size_bytes_) {
+    return true;
+  }
+  // The stream may have drained since the last flush.
+  flush();
+  if (approximate_message_size_bytes_ < max_buffer_size_bytes_) {
+    return true;
+  }
+  stats_.logs_dropped_.inc();
+  return false;
+}
+
 void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3alpha::HTTPAccessLogEntry&& entry) {
+  if (!canLogMore()) {
+    return;
+  }
   approximate_message_size_bytes_ += entry.ByteSizeLong();
   message_.mutable_http_logs()->mutable_log_entry()->Add(std::move(entry));
   if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
@@ -47,6 +68,9 @@ void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3alpha::HTTPAccessLogEnt
 }
 
 void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3alpha::TCPAccessLogEntry&& entry) {
+  if (!canLogMore()) {
+    return;
+  }
   approximate_message_size_bytes_ += entry.ByteSizeLong();
   message_.mutable_tcp_logs()->mutable_log_entry()->Add(std::move(entry));
   if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
@@ -75,11 +99,19 @@ void GrpcAccessLoggerImpl::flush() {
     identifier->set_log_name(log_name_);
   }
 
+  const uint64_t num_entries =
+      message_.http_logs().log_entry_size() + message_.tcp_logs().log_entry_size();
   if (stream_->stream_ != nullptr) {
+    if (stream_->stream_->isAboveWriteBufferHighWatermark()) {
+      // Keep the entries until the stream drains rather than buffering them in the stream.
+      return;
+    }
     stream_->stream_->sendMessage(message_, false);
+    stats_.logs_written_.add(num_entries);
   } else {
     // Clear out the stream data due to stream creation failure.
     stream_.reset();
+    stats_.logs_dropped_.add(num_entries);
   }
 
   // Clear the message regardless of the success.
@@ -112,8 +144,9 @@ GrpcAccessLoggerSharedPtr GrpcAccessLoggerCacheImpl::getOrCreateLogger(
   const GrpcAccessLoggerSharedPtr logger = std::make_shared<GrpcAccessLoggerImpl>(
       factory->create(), config.log_name(),
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), cache.dispatcher_,
-      local_info_);
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffer_size_bytes, 1024 * 1024),
+      cache.dispatcher_, local_info_, scope_);
   cache.access_loggers_.emplace(cache_key, logger);
   return logger;
 }
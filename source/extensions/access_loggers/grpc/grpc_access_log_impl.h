@@ -10,6 +10,8 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/accesslog/v3alpha/als.pb.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/grpc/typed_async_client.h"
@@ -21,7 +23,19 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace GrpcCommon {
 
-// TODO(mattklein123): Stats
+/**
+ * All stats for the gRPC access loggers. @see stats_macros.h
+ */
+#define ALL_GRPC_ACCESS_LOGGER_STATS(COUNTER)                                                      \
+  COUNTER(logs_dropped)                                                                            \
+  COUNTER(logs_written)
+
+/**
+ * Struct definition for the stats of the gRPC access loggers. @see stats_macros.h
+ */
+struct GrpcAccessLoggerStats {
+  ALL_GRPC_ACCESS_LOGGER_STATS(GENERATE_COUNTER_STRUCT)
+};
 
 /**
  * Interface for an access logger. The logger provides abstraction on top of gRPC stream, deals with
@@ -68,12 +82,17 @@ public:
 
 using GrpcAccessLoggerCacheSharedPtr = std::shared_ptr<GrpcAccessLoggerCache>;
 
+/**
+ * Access logger batching the entries in a message per stream. While the stream is backed up, the
+ * entries are kept in the message up to a hard size limit, past which they are dropped.
+ */
 class GrpcAccessLoggerImpl : public GrpcAccessLogger {
 public:
   GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std::string log_name,
                        std::chrono::milliseconds buffer_flush_interval_msec,
-                       uint64_t buffer_size_bytes, Event::Dispatcher& dispatcher,
-                       const LocalInfo::LocalInfo& local_info);
+                       uint64_t buffer_size_bytes, uint64_t max_buffer_size_bytes,
+                       Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info,
+                       Stats::Scope& scope);
 
   // Extensions::AccessLoggers::GrpcCommon::GrpcAccessLogger
   void log(envoy::data::accesslog::v3alpha::HTTPAccessLogEntry&& entry) override;
@@ -96,6 +115,9 @@ private:
     Grpc::AsyncStream<envoy::service::accesslog::v3alpha::StreamAccessLogsMessage> stream_{};
   };
 
+  // @return true if the entry can be added to the message, flushing it if needed, false if it is
+  //         dropped.
+  bool canLogMore();
   void flush();
 
   Grpc::AsyncClient<envoy::service::accesslog::v3alpha::StreamAccessLogsMessage,
@@ -105,10 +127,12 @@ private:
   const std::chrono::milliseconds buffer_flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
   const uint64_t buffer_size_bytes_;
+  const uint64_t max_buffer_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
   envoy::service::accesslog::v3alpha::StreamAccessLogsMessage message_;
   absl::optional<LocalStream> stream_;
   const LocalInfo::LocalInfo& local_info_;
+  GrpcAccessLoggerStats stats_;
 };
 
 class GrpcAccessLoggerCacheImpl : public Singleton::Instance, public GrpcAccessLoggerCache {
@@ -54,9 +54,11 @@ RedisCluster::RedisCluster(
           factory_context.clusterManager(), factory_context.api().timeSource())),
       registration_handle_(refresh_manager_->registerCluster(
           cluster_name_, redirect_refresh_interval_, redirect_refresh_threshold_,
-          failure_refresh_threshold_, host_degraded_refresh_threshold_, [&]() {
+          failure_refresh_threshold_, host_degraded_refresh_threshold_,
+          [&]() {
             redis_discovery_session_.resolve_timer_->enableTimer(std::chrono::milliseconds(0));
-          })) {
+          },
+          [&](const Common::Redis::MovedSlots& moved_slots) { onSlotsMoved(moved_slots); })) {
   const auto& locality_lb_endpoints = load_assignment_.endpoints();
   for (const auto& locality_lb_endpoint : locality_lb_endpoints) {
     for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
@@ -129,6 +131,14 @@ void RedisCluster::onClusterSlotUpdate(ClusterSlotsPtr&& slots) {
   onPreInitComplete();
 }
 
+void RedisCluster::onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) {
+  // The moved slots are repointed without waiting for the next discovery, and the thread local
+  // load balancers are recreated with the updated topology.
+  if (lb_factory_ && lb_factory_->onSlotsMoved(moved_slots)) {
+    updateAllHosts({}, {}, localityLbEndpoint().priority());
+  }
+}
+
 void RedisCluster::reloadHealthyHostsHelper(const Upstream::HostSharedPtr& host) {
   if (lb_factory_) {
     lb_factory_->onHostHealthUpdate();
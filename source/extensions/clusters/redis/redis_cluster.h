@@ -127,6 +127,7 @@ private:
                       const Upstream::HostVector& hosts_removed, uint32_t priority);
 
   void onClusterSlotUpdate(ClusterSlotsPtr&&);
+  void onSlotsMoved(const Common::Redis::MovedSlots& moved_slots);
 
   void reloadHealthyHostsHelper(const Upstream::HostSharedPtr& host) override;
 
@@ -219,6 +220,11 @@ private:
     std::chrono::milliseconds bufferFlushTimeoutInMs() const override { return buffer_timeout_; }
     uint32_t maxUpstreamUnknownConnections() const override { return 0; }
     bool enableCommandStats() const override { return false; }
+    bool enableAdaptiveBatching() const override { return false; }
+    Extensions::NetworkFilters::Common::Redis::Client::ReplicaSelection
+    replicaSelection() const override {
+      return Extensions::NetworkFilters::Common::Redis::Client::ReplicaSelection::Random;
+    }
     // For any readPolicy other than Master, the RedisClientFactory will send a READONLY command
     // when establishing a new connection. Since we're only using this for making the "cluster
     // slots" commands, the READONLY command is not relevant in this context. We're setting it to
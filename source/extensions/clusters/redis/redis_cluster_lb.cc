@@ -24,9 +24,9 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
     return false;
   }
 
-  auto updated_slots = std::make_shared<SlotArray>();
+  auto topology = std::make_shared<ClusterTopology>();
   auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>();
-  absl::flat_hash_map<std::string, uint64_t> shards;
+  absl::flat_hash_map<std::string, uint16_t> shards;
 
   for (const ClusterSlot& slot : *slots) {
     // look in the updated map
@@ -55,72 +55,123 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
     }
 
     for (auto i = slot.start(); i <= slot.end(); ++i) {
-      updated_slots->at(i) = result.first->second;
+      topology->slot_array_.at(i) = result.first->second;
     }
   }
 
-  {
-    absl::WriterMutexLock lock(&mutex_);
-    current_cluster_slot_ = std::move(slots);
-    slot_array_ = std::move(updated_slots);
-    shard_vector_ = std::move(shard_vector);
-  }
+  topology->shard_vector_ = std::move(shard_vector);
+  current_cluster_slot_ = std::move(slots);
+  publishTopology(std::move(topology));
   return true;
 }
 
 void RedisClusterLoadBalancerFactory::onHostHealthUpdate() {
-  ShardVectorSharedPtr current_shard_vector;
-  {
-    absl::ReaderMutexLock lock(&mutex_);
-    current_shard_vector = shard_vector_;
-  }
+  const ClusterTopologyConstSharedPtr current_topology = currentTopology();
 
   // This can get called by cluster initialization before the Redis Cluster topology is resolved.
-  if (!current_shard_vector) {
+  if (!current_topology) {
     return;
   }
 
   auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>();
 
-  for (auto const& shard : *current_shard_vector) {
+  for (auto const& shard : *current_topology->shard_vector_) {
     shard_vector->emplace_back(std::make_shared<RedisShard>(
         shard->master(), shard->replicas().hostsPtr(), shard->allHosts().hostsPtr()));
   }
 
-  {
-    absl::WriterMutexLock lock(&mutex_);
-    shard_vector_ = std::move(shard_vector);
+  auto topology = std::make_shared<ClusterTopology>();
+  topology->slot_array_ = current_topology->slot_array_;
+  topology->shard_vector_ = std::move(shard_vector);
+  publishTopology(std::move(topology));
+}
+
+bool RedisClusterLoadBalancerFactory::onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) {
+  const ClusterTopologyConstSharedPtr current_topology = currentTopology();
+  if (!current_topology) {
+    return false;
+  }
+
+  absl::flat_hash_map<std::string, uint16_t> masters;
+  const std::vector<RedisShardSharedPtr>& shard_vector = *current_topology->shard_vector_;
+  for (uint16_t i = 0; i < shard_vector.size(); ++i) {
+    masters.emplace(shard_vector[i]->master()->address()->asString(), i);
+  }
+
+  ClusterTopologySharedPtr topology;
+  for (const auto& moved_slot : moved_slots) {
+    const auto master = masters.find(moved_slot.second);
+    if (moved_slot.first >= MaxSlot || master == masters.end() ||
+        current_topology->slot_array_[moved_slot.first] == master->second) {
+      continue;
+    }
+    if (!topology) {
+      // The shards are shared with the current topology, only the slots are copied.
+      topology = std::make_shared<ClusterTopology>(*current_topology);
+    }
+    topology->slot_array_[moved_slot.first] = master->second;
+  }
+
+  if (!topology) {
+    return false;
   }
+  // The slots no longer match the last discovered ones, so that the next discovery updates them
+  // even if it reports the same slots as the last one.
+  current_cluster_slot_.reset();
+  publishTopology(std::move(topology));
+  return true;
 }
 
-Upstream::LoadBalancerPtr RedisClusterLoadBalancerFactory::create() {
+void RedisClusterLoadBalancerFactory::publishTopology(ClusterTopologyConstSharedPtr topology) {
+  absl::WriterMutexLock lock(&mutex_);
+  topology_ = std::move(topology);
+}
+
+RedisClusterLoadBalancerFactory::ClusterTopologyConstSharedPtr
+RedisClusterLoadBalancerFactory::currentTopology() {
   absl::ReaderMutexLock lock(&mutex_);
-  return std::make_unique<RedisClusterLoadBalancer>(slot_array_, shard_vector_, random_);
+  return topology_;
+}
+
+Upstream::LoadBalancerPtr RedisClusterLoadBalancerFactory::create() {
+  return std::make_unique<RedisClusterLoadBalancer>(currentTopology(), random_);
 }
 
 namespace {
-Upstream::HostConstSharedPtr chooseRandomHost(const Upstream::HostSetImpl& host_set,
-                                              Runtime::RandomGenerator& random) {
-  auto hosts = host_set.healthyHosts();
-  if (hosts.empty()) {
-    hosts = host_set.degradedHosts();
+Upstream::HostConstSharedPtr
+chooseReadHost(const Upstream::HostSetImpl& host_set,
+               NetworkFilters::Common::Redis::Client::ReplicaSelection replica_selection,
+               Runtime::RandomGenerator& random) {
+  const Upstream::HostVector* hosts = &host_set.healthyHosts();
+  if (hosts->empty()) {
+    hosts = &host_set.degradedHosts();
   }
 
-  if (hosts.empty()) {
-    hosts = host_set.hosts();
+  if (hosts->empty()) {
+    hosts = &host_set.hosts();
   }
 
-  if (!hosts.empty()) {
-    return hosts[random.random() % hosts.size()];
-  } else {
+  if (hosts->empty()) {
     return nullptr;
   }
+
+  const Upstream::HostConstSharedPtr& host = (*hosts)[random.random() % hosts->size()];
+  if (replica_selection == NetworkFilters::Common::Redis::Client::ReplicaSelection::LeastRequest &&
+      hosts->size() > 1) {
+    // Power of two choices on the requests in flight, which the clients of all the workers count
+    // in the host stats.
+    const Upstream::HostConstSharedPtr& other_host = (*hosts)[random.random() % hosts->size()];
+    if (other_host->stats().rq_active_.value() < host->stats().rq_active_.value()) {
+      return other_host;
+    }
+  }
+  return host;
 }
 } // namespace
 
 Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::chooseHost(
     Envoy::Upstream::LoadBalancerContext* context) {
-  if (!slot_array_) {
+  if (!topology_) {
     return nullptr;
   }
   absl::optional<uint64_t> hash;
@@ -132,11 +183,12 @@ Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBa
     return nullptr;
   }
 
-  auto shard = shard_vector_->at(
-      slot_array_->at(hash.value() % Envoy::Extensions::Clusters::Redis::MaxSlot));
+  auto shard = topology_->shard_vector_->at(
+      topology_->slot_array_[hash.value() % Envoy::Extensions::Clusters::Redis::MaxSlot]);
 
   auto redis_context = dynamic_cast<RedisLoadBalancerContext*>(context);
   if (redis_context && redis_context->isReadCommand()) {
+    const auto replica_selection = redis_context->replicaSelection();
     switch (redis_context->readPolicy()) {
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Master:
       return shard->master();
@@ -144,18 +196,18 @@ Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBa
       if (shard->master()->health() == Upstream::Host::Health::Healthy) {
         return shard->master();
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseReadHost(shard->allHosts(), replica_selection, random_);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Replica:
-      return chooseRandomHost(shard->replicas(), random_);
+      return chooseReadHost(shard->replicas(), replica_selection, random_);
     case NetworkFilters::Common::Redis::Client::ReadPolicy::PreferReplica:
       if (!shard->replicas().healthyHosts().empty()) {
-        return chooseRandomHost(shard->replicas(), random_);
+        return chooseReadHost(shard->replicas(), replica_selection, random_);
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseReadHost(shard->allHosts(), replica_selection, random_);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Any:
-      return chooseRandomHost(shard->allHosts(), random_);
+      return chooseReadHost(shard->allHosts(), replica_selection, random_);
     }
   }
   return shard->master();
@@ -189,10 +241,12 @@ const ToLowerTable& RedisLoadBalancerContextImpl::toLowerTable() {
 RedisLoadBalancerContextImpl::RedisLoadBalancerContextImpl(
     const std::string& key, bool enabled_hashtagging, bool is_redis_cluster,
     const NetworkFilters::Common::Redis::RespValue& request,
-    NetworkFilters::Common::Redis::Client::ReadPolicy read_policy)
+    NetworkFilters::Common::Redis::Client::ReadPolicy read_policy,
+    NetworkFilters::Common::Redis::Client::ReplicaSelection replica_selection)
     : hash_key_(is_redis_cluster ? Crc16::crc16(hashtag(key, true))
                                  : MurmurHash::murmurHash2_64(hashtag(key, enabled_hashtagging))),
-      is_read_(isReadRequest(request)), read_policy_(read_policy) {}
+      is_read_(isReadRequest(request)), read_policy_(read_policy),
+      replica_selection_(replica_selection) {}
 
 // Inspired by the redis-cluster hashtagging algorithm
 // https://redis.io/topics/cluster-spec#keys-hash-tags
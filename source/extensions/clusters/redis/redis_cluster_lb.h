@@ -14,6 +14,7 @@
 #include "source/extensions/clusters/redis/crc16.h"
 
 #include "extensions/clusters/well_known_names.h"
+#include "extensions/common/redis/cluster_refresh_manager.h"
 #include "extensions/filters/network/common/redis/client.h"
 #include "extensions/filters/network/common/redis/codec.h"
 #include "extensions/filters/network/common/redis/supported_commands.h"
@@ -62,6 +63,7 @@ public:
 
   virtual bool isReadCommand() const PURE;
   virtual NetworkFilters::Common::Redis::Client::ReadPolicy readPolicy() const PURE;
+  virtual NetworkFilters::Common::Redis::Client::ReplicaSelection replicaSelection() const PURE;
 };
 
 class RedisLoadBalancerContextImpl : public RedisLoadBalancerContext,
@@ -77,12 +79,15 @@ public:
    * will be hashed using crc16.
    * @param request specify the Redis request.
    * @param read_policy specify the read policy.
+   * @param replica_selection specify the replica selection.
    */
-  RedisLoadBalancerContextImpl(const std::string& key, bool enabled_hashtagging,
-                               bool is_redis_cluster,
-                               const NetworkFilters::Common::Redis::RespValue& request,
-                               NetworkFilters::Common::Redis::Client::ReadPolicy read_policy =
-                                   NetworkFilters::Common::Redis::Client::ReadPolicy::Master);
+  RedisLoadBalancerContextImpl(
+      const std::string& key, bool enabled_hashtagging, bool is_redis_cluster,
+      const NetworkFilters::Common::Redis::RespValue& request,
+      NetworkFilters::Common::Redis::Client::ReadPolicy read_policy =
+          NetworkFilters::Common::Redis::Client::ReadPolicy::Master,
+      NetworkFilters::Common::Redis::Client::ReplicaSelection replica_selection =
+          NetworkFilters::Common::Redis::Client::ReplicaSelection::Random);
 
   // Upstream::LoadBalancerContextBase
   absl::optional<uint64_t> computeHashKey() override { return hash_key_; }
@@ -93,6 +98,10 @@ public:
     return read_policy_;
   }
 
+  NetworkFilters::Common::Redis::Client::ReplicaSelection replicaSelection() const override {
+    return replica_selection_;
+  }
+
 private:
   absl::string_view hashtag(absl::string_view v, bool enabled);
 
@@ -102,6 +111,7 @@ private:
   const absl::optional<uint64_t> hash_key_;
   const bool is_read_;
   const NetworkFilters::Common::Redis::Client::ReadPolicy read_policy_;
+  const NetworkFilters::Common::Redis::Client::ReplicaSelection replica_selection_;
 };
 
 class ClusterSlotUpdateCallBack {
@@ -120,6 +130,14 @@ public:
    * Callback when a host's health status is updated
    */
   virtual void onHostHealthUpdate() PURE;
+
+  /**
+   * Callback when slots are reported moved by MOVED redirections. The slots moved to a known
+   * master are repointed to its shard, the others are left to the next cluster slot update.
+   * @param moved_slots provides the moved slots, with the address of their new master.
+   * @return indicate if any slot is updated or not.
+   */
+  virtual bool onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) PURE;
 };
 
 using ClusterSlotUpdateCallBackSharedPtr = std::shared_ptr<ClusterSlotUpdateCallBack>;
@@ -138,6 +156,8 @@ public:
 
   void onHostHealthUpdate() override;
 
+  bool onSlotsMoved(const Common::Redis::MovedSlots& moved_slots) override;
+
   // Upstream::LoadBalancerFactory
   Upstream::LoadBalancerPtr create() override;
 
@@ -165,42 +185,59 @@ private:
   };
 
   using RedisShardSharedPtr = std::shared_ptr<const RedisShard>;
-  using ShardVectorSharedPtr = std::shared_ptr<std::vector<RedisShardSharedPtr>>;
-  using SlotArray = std::array<uint64_t, MaxSlot>;
-  using SlotArraySharedPtr = std::shared_ptr<const SlotArray>;
+  using ShardVectorSharedPtr = std::shared_ptr<const std::vector<RedisShardSharedPtr>>;
+  // There are at most as many shards as slots, so their indices fit in 16 bits, keeping the array
+  // at 32KiB.
+  using SlotArray = std::array<uint16_t, MaxSlot>;
+
+  /**
+   * A snapshot of the topology, which is not modified once published. Updates build a new snapshot
+   * and publish it by swapping a single pointer, while the load balancers keep the snapshot they
+   * were created with. A slot move only copies the slot array and shares the shards, and a health
+   * update only rebuilds the shards.
+   */
+  struct ClusterTopology {
+    SlotArray slot_array_{};
+    ShardVectorSharedPtr shard_vector_;
+  };
+
+  using ClusterTopologySharedPtr = std::shared_ptr<ClusterTopology>;
+  using ClusterTopologyConstSharedPtr = std::shared_ptr<const ClusterTopology>;
 
   /*
    * This class implements load balancing according to `Redis Cluster
    * <https://redis.io/topics/cluster-spec>`_. This load balancer is thread local and created
    * through the RedisClusterLoadBalancerFactory by the cluster manager.
    *
-   * The topology is stored in slot_array_ and shard_vector_. According to the
-   * `Redis Cluster Spec <https://redis.io/topics/cluster-spec#keys-distribution-model`_, the key
-   * space is split into a fixed size 16384 slots. The current implementation uses a fixed size
+   * The topology is stored in the slot_array_ and shard_vector_ of a ClusterTopology. According to
+   * the `Redis Cluster Spec <https://redis.io/topics/cluster-spec#keys-distribution-model`_, the
+   * key space is split into a fixed size 16384 slots. The current implementation uses a fixed size
    * std::array() of the index of the shard in the shard_vector_. This has a fixed cpu and memory
    * cost and provide a fast lookup constant time lookup similar to Maglev. This will be used by the
    * redis proxy filter for load balancing purpose.
    */
   class RedisClusterLoadBalancer : public Upstream::LoadBalancer {
   public:
-    RedisClusterLoadBalancer(SlotArraySharedPtr slot_array, ShardVectorSharedPtr shard_vector,
+    RedisClusterLoadBalancer(ClusterTopologyConstSharedPtr topology,
                              Runtime::RandomGenerator& random)
-        : slot_array_(std::move(slot_array)), shard_vector_(std::move(shard_vector)),
-          random_(random) {}
+        : topology_(std::move(topology)), random_(random) {}
 
     // Upstream::LoadBalancerBase
     Upstream::HostConstSharedPtr chooseHost(Upstream::LoadBalancerContext*) override;
 
   private:
-    const SlotArraySharedPtr slot_array_;
-    const ShardVectorSharedPtr shard_vector_;
+    const ClusterTopologyConstSharedPtr topology_;
     Runtime::RandomGenerator& random_;
   };
 
+  void publishTopology(ClusterTopologyConstSharedPtr topology);
+  ClusterTopologyConstSharedPtr currentTopology();
+
+  // Only guards the publication of topology_, which the updates on the main thread and the load
+  // balancers created on the workers copy out of it.
   absl::Mutex mutex_;
-  SlotArraySharedPtr slot_array_ GUARDED_BY(mutex_);
+  ClusterTopologyConstSharedPtr topology_ GUARDED_BY(mutex_);
   ClusterSlotsSharedPtr current_cluster_slot_;
-  ShardVectorSharedPtr shard_vector_;
   Runtime::RandomGenerator& random_;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/api/api.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/extensions/common/dynamic_forward_proxy/v3alpha/dns_cache.pb.h"
 #include "envoy/singleton/manager.h"
@@ -175,7 +176,8 @@ using DnsCacheManagerSharedPtr = std::shared_ptr<DnsCacheManager>;
  */
 DnsCacheManagerSharedPtr getCacheManager(Singleton::Manager& manager,
                                          Event::Dispatcher& main_thread_dispatcher,
-                                         ThreadLocal::SlotAllocator& tls, Stats::Scope& root_scope);
+                                         ThreadLocal::SlotAllocator& tls, Api::Api& api,
+                                         Stats::Scope& root_scope);
 
 /**
  * Factory for getting a DNS cache manager.
@@ -1,35 +1,67 @@
 #include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 
+#include <limits>
+
 #include "envoy/extensions/common/dynamic_forward_proxy/v3alpha/dns_cache.pb.h"
+#include "envoy/filesystem/filesystem.h"
 
+#include "common/common/hash.h"
+#include "common/common/lock_guard.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
+#include "common/protobuf/protobuf.h"
 
 // TODO(mattklein123): Move DNS family helpers to a smaller include.
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
 namespace DynamicForwardProxy {
 
 DnsCacheImpl::DnsCacheImpl(
-    Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
-    Stats::Scope& root_scope,
+    Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls, Api::Api& api,
+    const DnsCacheSnapshotWriterSharedPtr& snapshot_writer, Stats::Scope& root_scope,
     const envoy::extensions::common::dynamic_forward_proxy::v3alpha::DnsCacheConfig& config)
     : main_thread_dispatcher_(main_thread_dispatcher),
       dns_lookup_family_(Upstream::getDnsLookupFamilyFromEnum(config.dns_lookup_family())),
-      resolver_(main_thread_dispatcher.createDnsResolver({}, false)), tls_slot_(tls.allocateSlot()),
+      resolver_(main_thread_dispatcher.createDnsResolver({}, {})), tls_slot_(tls.allocateSlot()),
       scope_(root_scope.createScope(fmt::format("dns_cache.{}.", config.name()))),
       stats_{ALL_DNS_CACHE_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))},
       refresh_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_refresh_rate, 60000)),
       host_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, host_ttl, 300000)),
-      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)) {
+      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)),
+      evict_least_recently_used_(config.evict_least_recently_used()), api_(api),
+      snapshot_path_(config.snapshot_path()), snapshot_writer_(snapshot_writer) {
   tls_slot_->set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalHostInfo>(); });
-  updateTlsHostsMap();
+  auto host_map = std::make_shared<TlsHostMap>();
+  for (auto& shard : host_map->shards_) {
+    shard = std::make_shared<const HostMapShard>();
+  }
+  tls_host_map_ = host_map;
+  tls_slot_->runOnAllThreads([this, host_map = tls_host_map_]() {
+    tls_slot_->getTyped<ThreadLocalHostInfo>().updateHostMap(host_map);
+  });
+
+  if (!snapshot_path_.empty()) {
+    loadSnapshot();
+    snapshot_timer_ = main_thread_dispatcher_.createTimer([this]() -> void {
+      if (snapshot_dirty_) {
+        writeSnapshot();
+      }
+      snapshot_timer_->enableTimer(refresh_interval_);
+    });
+    snapshot_timer_->enableTimer(refresh_interval_);
+  }
 }
 
 DnsCacheImpl::~DnsCacheImpl() {
+  if (!snapshot_path_.empty() && snapshot_dirty_) {
+    writeSnapshot();
+  }
+
   for (const auto& primary_host : primary_hosts_) {
     if (primary_host.second->active_query_ != nullptr) {
       primary_host.second->active_query_->cancel();
@@ -46,11 +78,10 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
                                 LoadDnsCacheEntryCallbacks& callbacks) {
   ENVOY_LOG(debug, "thread local lookup for host '{}'", host);
   auto& tls_host_info = tls_slot_->getTyped<ThreadLocalHostInfo>();
-  auto tls_host = tls_host_info.host_map_->find(host);
-  if (tls_host != tls_host_info.host_map_->end()) {
+  if (tls_host_info.host_map_->contains(host)) {
     ENVOY_LOG(debug, "thread local hit for host '{}'", host);
     return {LoadDnsCacheEntryStatus::InCache, nullptr};
-  } else if (tls_host_info.host_map_->size() >= max_hosts_) {
+  } else if (!evict_least_recently_used_ && tls_host_info.host_map_->size_ >= max_hosts_) {
     // Given that we do this check in thread local context, it's possible for two threads to race
     // and potentially go slightly above the configured max hosts. This is an OK given compromise
     // given how much simpler the implementation is.
@@ -71,7 +102,7 @@ absl::flat_hash_map<std::string, DnsHostInfoSharedPtr> DnsCacheImpl::hosts() {
   absl::flat_hash_map<std::string, DnsHostInfoSharedPtr> ret;
   for (const auto& host : primary_hosts_) {
     // Only include hosts that have ever resolved to an address.
-    if (host.second->host_info_->address_ != nullptr) {
+    if (host.second->host_info_->address() != nullptr) {
       ret.emplace(host.first, host.second->host_info_);
     }
   }
@@ -93,6 +124,11 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
     return;
   }
 
+  // When all the hosts are still being resolved for the first time, none of them is evicted and
+  // the cache briefly goes above its maximum, until the hosts after it can evict some again.
+  while (evict_least_recently_used_ && primary_hosts_.size() >= max_hosts_ && evictHost()) {
+  }
+
   const auto host_attributes = Http::Utility::parseAuthority(host);
 
   // TODO(mattklein123): Right now, the same host with different ports will become two
@@ -106,9 +142,73 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
                                                    host_attributes.is_ip_address_,
                                                    [this, host]() { onReResolve(host); }))
                             .first->second;
+  if (evict_least_recently_used_) {
+    primary_host.eviction_entry_ = eviction_order_.insert(eviction_order_.end(), host);
+    primary_host.eviction_last_used_time_ = primary_host.host_info_->last_used_time_.load();
+  }
+  snapshot_dirty_ = true;
   startResolve(host, primary_host);
 }
 
+bool DnsCacheImpl::evictHost() {
+  ASSERT(!eviction_order_.empty());
+  // CLOCK approximation of LRU: the hand gives the hosts used since it last went past them a
+  // second chance by moving them to the back, and stops at the first host that was not used. The
+  // hosts still being resolved for the first time are never evicted, as requests wait on them. The
+  // hand goes round the hosts at most twice, after which the first resolved host is evicted even if
+  // it keeps being used.
+  auto victim = eviction_order_.end();
+  for (size_t i = 2 * eviction_order_.size(); i > 0; i--) {
+    PrimaryHostInfo& primary_host = *primary_hosts_.find(eviction_order_.front())->second;
+    if (primary_host.host_info_->first_resolve_complete_) {
+      const auto last_used_time = primary_host.host_info_->last_used_time_.load();
+      if (last_used_time == primary_host.eviction_last_used_time_) {
+        victim = eviction_order_.begin();
+        break;
+      }
+      primary_host.eviction_last_used_time_ = last_used_time;
+    }
+    eviction_order_.splice(eviction_order_.end(), eviction_order_, eviction_order_.begin());
+  }
+  if (victim == eviction_order_.end()) {
+    victim = std::find_if(eviction_order_.begin(), eviction_order_.end(),
+                          [this](const std::string& host) {
+                            return primary_hosts_.find(host)->second->host_info_
+                                ->first_resolve_complete_;
+                          });
+    if (victim == eviction_order_.end()) {
+      ENVOY_LOG(debug, "no host evicted, all the hosts are being resolved");
+      return false;
+    }
+  }
+
+  const std::string host = *victim;
+  ENVOY_LOG(debug, "host='{}' evicted", host);
+  stats_.host_evicted_.inc();
+  removeHost(host);
+  return true;
+}
+
+void DnsCacheImpl::removeHost(const std::string& host) {
+  const auto primary_host_it = primary_hosts_.find(host);
+  ASSERT(primary_host_it != primary_hosts_.end());
+  auto& primary_host_info = *primary_host_it->second;
+
+  if (primary_host_info.active_query_ != nullptr) {
+    primary_host_info.active_query_->cancel();
+  }
+  if (evict_least_recently_used_) {
+    eviction_order_.erase(primary_host_info.eviction_entry_);
+  }
+  runRemoveCallbacks(host);
+  if (primary_host_info.host_info_->first_resolve_complete_) {
+    updateTlsHostsMap(host, nullptr);
+  }
+  snapshot_dirty_ = true;
+  // This must be last as the host may be owned by the refresh timer callback of the host.
+  primary_hosts_.erase(primary_host_it);
+}
+
 void DnsCacheImpl::onReResolve(const std::string& host) {
   const auto primary_host_it = primary_hosts_.find(host);
   ASSERT(primary_host_it != primary_hosts_.end());
@@ -120,9 +220,7 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
             primary_host_it->second->host_info_->last_used_time_.load().count());
   if (now_duration - primary_host_it->second->host_info_->last_used_time_.load() > host_ttl_) {
     ENVOY_LOG(debug, "host='{}' TTL expired, removing", host);
-    runRemoveCallbacks(host);
-    primary_hosts_.erase(primary_host_it);
-    updateTlsHostsMap();
+    removeHost(host);
   } else {
     startResolve(host, *primary_host_it->second);
   }
@@ -170,18 +268,18 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   //
   // This means that once a host gets an address it will stick even in the case of a subsequent
   // resolution failure.
-  bool address_changed = false;
-  if (new_address != nullptr && (primary_host_info.host_info_->address_ == nullptr ||
-                                 *primary_host_info.host_info_->address_ != *new_address)) {
+  //
+  // The workers share the host info, so that a changed address does not need a new host map.
+  const auto current_address = primary_host_info.host_info_->address();
+  if (new_address != nullptr && (current_address == nullptr || *current_address != *new_address)) {
     ENVOY_LOG(debug, "host '{}' address has changed", host);
-    primary_host_info.host_info_->address_ = new_address;
+    primary_host_info.host_info_->setAddress(new_address);
     runAddUpdateCallbacks(host, primary_host_info.host_info_);
-    address_changed = true;
     stats_.host_address_changed_.inc();
   }
 
-  if (first_resolve || address_changed) {
-    updateTlsHostsMap();
+  if (first_resolve) {
+    updateTlsHostsMap(host, primary_host_info.host_info_);
   }
 
   // Kick off the refresh timer.
@@ -203,18 +301,143 @@ void DnsCacheImpl::runRemoveCallbacks(const std::string& host) {
   }
 }
 
-void DnsCacheImpl::updateTlsHostsMap() {
-  TlsHostMapSharedPtr new_host_map = std::make_shared<TlsHostMap>();
+void DnsCacheImpl::updateTlsHostsMap(const std::string& host,
+                                     const DnsHostInfoSharedPtr& host_info) {
+  // Only the shard of the host is copied, the other shards are shared with the current map.
+  const uint32_t shard_index = TlsHostMap::shardIndex(host);
+  const HostMapShard& shard = *tls_host_map_->shards_[shard_index];
+  auto new_shard = std::make_shared<HostMapShard>(shard);
+  if (host_info != nullptr) {
+    new_shard->emplace(host, host_info);
+  } else {
+    new_shard->erase(host);
+  }
+
+  auto new_host_map = std::make_shared<TlsHostMap>(*tls_host_map_);
+  new_host_map->size_ = new_host_map->size_ - shard.size() + new_shard->size();
+  new_host_map->shards_[shard_index] = std::move(new_shard);
+  tls_host_map_ = new_host_map;
+
+  tls_slot_->runOnAllThreads([this, host_map = tls_host_map_]() {
+    tls_slot_->getTyped<ThreadLocalHostInfo>().updateHostMap(host_map);
+  });
+}
+
+void DnsCacheImpl::loadSnapshot() {
+  if (!api_.fileSystem().fileExists(snapshot_path_)) {
+    return;
+  }
+
+  // The snapshot maps each host to its default port, in the text format of a Struct.
+  ProtobufWkt::Struct snapshot;
+  try {
+    if (!Protobuf::TextFormat::ParseFromString(api_.fileSystem().fileReadToEnd(snapshot_path_),
+                                               &snapshot)) {
+      ENVOY_LOG(warn, "invalid DNS cache snapshot '{}'", snapshot_path_);
+      return;
+    }
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "unable to read DNS cache snapshot '{}': {}", snapshot_path_, e.what());
+    return;
+  }
+
+  for (const auto& entry : snapshot.fields()) {
+    if (primary_hosts_.size() >= max_hosts_) {
+      break;
+    }
+    const double default_port = entry.second.number_value();
+    if (entry.second.kind_case() != ProtobufWkt::Value::kNumberValue || default_port < 0 ||
+        default_port > std::numeric_limits<uint16_t>::max() ||
+        default_port != static_cast<uint16_t>(default_port)) {
+      ENVOY_LOG(warn, "invalid DNS cache snapshot '{}' entry for host '{}'", snapshot_path_,
+                entry.first);
+      continue;
+    }
+    ENVOY_LOG(debug, "loading host '{}' from DNS cache snapshot", entry.first);
+    startCacheLoad(entry.first, static_cast<uint16_t>(default_port));
+  }
+}
+
+void DnsCacheImpl::writeSnapshot() {
+  ProtobufWkt::Struct snapshot;
   for (const auto& primary_host : primary_hosts_) {
-    // Do not include hosts that have not resolved at least once.
-    if (primary_host.second->host_info_->first_resolve_complete_) {
-      new_host_map->emplace(primary_host.first, primary_host.second->host_info_);
+    (*snapshot.mutable_fields())[primary_host.first].set_number_value(primary_host.second->port_);
+  }
+  std::string text;
+  Protobuf::TextFormat::PrintToString(snapshot, &text);
+  snapshot_writer_->queue(snapshot_path_, std::move(text));
+  snapshot_dirty_ = false;
+}
+
+DnsCacheSnapshotWriter::~DnsCacheSnapshotWriter() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  // The thread writes the snapshots still queued before it exits.
+  {
+    Thread::LockGuard lock(lock_);
+    shutdown_ = true;
+    queued_.notifyOne();
+  }
+  thread_->join();
+}
+
+void DnsCacheSnapshotWriter::queue(const std::string& path, std::string&& snapshot) {
+  if (thread_ == nullptr) {
+    thread_ = api_.threadFactory().createThread([this]() -> void { writeQueuedSnapshots(); });
+  }
+  Thread::LockGuard lock(lock_);
+  queued_snapshots_[path] = std::move(snapshot);
+  queued_.notifyOne();
+}
+
+void DnsCacheSnapshotWriter::writeQueuedSnapshots() {
+  while (true) {
+    absl::flat_hash_map<std::string, std::string> snapshots;
+    {
+      Thread::LockGuard lock(lock_);
+      while (queued_snapshots_.empty() && !shutdown_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        queued_.wait(lock_);
+      }
+      if (queued_snapshots_.empty()) {
+        return;
+      }
+      snapshots.swap(queued_snapshots_);
+    }
+
+    for (const auto& snapshot : snapshots) {
+      write(snapshot.first, snapshot.second);
     }
   }
+}
 
-  tls_slot_->runOnAllThreads([this, new_host_map]() {
-    tls_slot_->getTyped<ThreadLocalHostInfo>().updateHostMap(new_host_map);
-  });
+void DnsCacheSnapshotWriter::write(const std::string& path, const std::string& snapshot) {
+  // The snapshot is written to a temporary file which then replaces the previous snapshot, so that
+  // the previous snapshot is kept whole if the write fails.
+  const std::string temp_path = absl::StrCat(path, ".tmp");
+  Filesystem::FilePtr file = api_.fileSystem().createFile(temp_path);
+  const Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                  1 << Filesystem::File::Operation::Create |
+                                  1 << Filesystem::File::Operation::Truncate};
+  bool written = file->open(flags).rc_;
+  if (written) {
+    const Api::IoCallSizeResult result = file->write(snapshot);
+    written = result.ok() && static_cast<size_t>(result.rc_) == snapshot.size();
+    written = file->close().rc_ && written;
+  }
+  if (!written || !api_.fileSystem().renameFile(temp_path, path)) {
+    ENVOY_LOG(warn, "unable to write DNS cache snapshot '{}'", path);
+  }
+}
+
+uint32_t DnsCacheImpl::TlsHostMap::shardIndex(absl::string_view host) {
+  // A hash independent of the one of the shards, so that the hosts are spread over each shard.
+  return HashUtil::xxHash64(host) % NumHostMapShards;
+}
+
+bool DnsCacheImpl::TlsHostMap::contains(absl::string_view host) const {
+  return shards_[shardIndex(host)]->count(host) != 0;
 }
 
 DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
@@ -224,12 +447,13 @@ DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
   }
 }
 
-void DnsCacheImpl::ThreadLocalHostInfo::updateHostMap(const TlsHostMapSharedPtr& new_host_map) {
+void DnsCacheImpl::ThreadLocalHostInfo::updateHostMap(
+    const TlsHostMapConstSharedPtr& new_host_map) {
   host_map_ = new_host_map;
   for (auto pending_resolution_it = pending_resolutions_.begin();
        pending_resolution_it != pending_resolutions_.end();) {
     auto& pending_resolution = **pending_resolution_it;
-    if (host_map_->count(pending_resolution.host_) != 0) {
+    if (host_map_->contains(pending_resolution.host_)) {
       auto& callbacks = pending_resolution.callbacks_;
       pending_resolution.cancel();
       pending_resolution_it = pending_resolutions_.erase(pending_resolution_it);
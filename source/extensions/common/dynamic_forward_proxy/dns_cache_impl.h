@@ -1,14 +1,20 @@
 #pragma once
 
+#include <array>
+#include <list>
+
+#include "envoy/api/api.h"
 #include "envoy/extensions/common/dynamic_forward_proxy/v3alpha/dns_cache.pb.h"
 #include "envoy/network/dns.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/cleanup.h"
+#include "common/common/thread.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -24,6 +30,7 @@ namespace DynamicForwardProxy {
   COUNTER(dns_query_success)                                                                       \
   COUNTER(host_added)                                                                              \
   COUNTER(host_address_changed)                                                                    \
+  COUNTER(host_evicted)                                                                            \
   COUNTER(host_overflow)                                                                           \
   COUNTER(host_removed)                                                                            \
   GAUGE(num_hosts, NeverImport)
@@ -35,11 +42,44 @@ struct DnsCacheStats {
   ALL_DNS_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
 };
 
+/**
+ * Writes the snapshots of DNS caches to the file system through Api::Api. A single thread,
+ * started when the first snapshot is queued, writes the snapshots of all the caches sharing the
+ * writer, so that the main thread never waits on the disk. Only the latest snapshot queued for a
+ * path is written.
+ */
+class DnsCacheSnapshotWriter : Logger::Loggable<Logger::Id::forward_proxy> {
+public:
+  explicit DnsCacheSnapshotWriter(Api::Api& api) : api_(api) {}
+  // Writes the snapshots still queued before returning.
+  ~DnsCacheSnapshotWriter();
+
+  /**
+   * Queue a snapshot to be written. Called by the main thread.
+   * @param path supplies the path of the snapshot.
+   * @param snapshot supplies the contents of the snapshot.
+   */
+  void queue(const std::string& path, std::string&& snapshot);
+
+private:
+  void writeQueuedSnapshots();
+  void write(const std::string& path, const std::string& snapshot);
+
+  Api::Api& api_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar queued_;
+  absl::flat_hash_map<std::string, std::string> queued_snapshots_ ABSL_GUARDED_BY(lock_);
+  bool shutdown_ ABSL_GUARDED_BY(lock_){};
+  Thread::ThreadPtr thread_;
+};
+
+using DnsCacheSnapshotWriterSharedPtr = std::shared_ptr<DnsCacheSnapshotWriter>;
+
 class DnsCacheImpl : public DnsCache, Logger::Loggable<Logger::Id::forward_proxy> {
 public:
   DnsCacheImpl(
-      Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
-      Stats::Scope& root_scope,
+      Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls, Api::Api& api,
+      const DnsCacheSnapshotWriterSharedPtr& snapshot_writer, Stats::Scope& root_scope,
       const envoy::extensions::common::dynamic_forward_proxy::v3alpha::DnsCacheConfig& config);
   ~DnsCacheImpl() override;
 
@@ -50,8 +90,24 @@ public:
   absl::flat_hash_map<std::string, DnsHostInfoSharedPtr> hosts() override;
 
 private:
-  using TlsHostMap = absl::flat_hash_map<std::string, DnsHostInfoSharedPtr>;
-  using TlsHostMapSharedPtr = std::shared_ptr<TlsHostMap>;
+  using HostMapShard = absl::flat_hash_map<std::string, DnsHostInfoSharedPtr>;
+  using HostMapShardConstSharedPtr = std::shared_ptr<const HostMapShard>;
+
+  static constexpr uint32_t NumHostMapShards = 64;
+
+  // The resolved hosts, as seen by the workers. The map is immutable once published and split in
+  // shards, so that a change to a host only copies the shard of the host and the array of shard
+  // pointers, however many hosts the cache holds. The workers look up the map they were last
+  // given without any lock.
+  struct TlsHostMap {
+    static uint32_t shardIndex(absl::string_view host);
+    bool contains(absl::string_view host) const;
+
+    std::array<HostMapShardConstSharedPtr, NumHostMapShards> shards_;
+    size_t size_{};
+  };
+
+  using TlsHostMapConstSharedPtr = std::shared_ptr<const TlsHostMap>;
 
   struct LoadDnsCacheEntryHandleImpl : public LoadDnsCacheEntryHandle,
                                        RaiiListElement<LoadDnsCacheEntryHandleImpl*> {
@@ -67,9 +123,9 @@ private:
   // Per-thread DNS cache info including the currently known hosts as well as any pending callbacks.
   struct ThreadLocalHostInfo : public ThreadLocal::ThreadLocalObject {
     ~ThreadLocalHostInfo() override;
-    void updateHostMap(const TlsHostMapSharedPtr& new_host_map);
+    void updateHostMap(const TlsHostMapConstSharedPtr& new_host_map);
 
-    TlsHostMapSharedPtr host_map_;
+    TlsHostMapConstSharedPtr host_map_;
     std::list<LoadDnsCacheEntryHandleImpl*> pending_resolutions_;
   };
 
@@ -80,16 +136,26 @@ private:
     }
 
     // DnsHostInfo
-    Network::Address::InstanceConstSharedPtr address() override { return address_; }
+    Network::Address::InstanceConstSharedPtr address() override {
+      absl::ReaderMutexLock lock(&address_mutex_);
+      return address_;
+    }
     const std::string& resolvedHost() const override { return resolved_host_; }
     bool isIpAddress() const override { return is_ip_address_; }
     void touch() override { last_used_time_ = time_source_.monotonicTime().time_since_epoch(); }
 
+    void setAddress(const Network::Address::InstanceConstSharedPtr& address) {
+      absl::WriterMutexLock lock(&address_mutex_);
+      address_ = address;
+    }
+
     TimeSource& time_source_;
     const std::string resolved_host_;
     const bool is_ip_address_;
     bool first_resolve_complete_{};
-    Network::Address::InstanceConstSharedPtr address_;
+    // The address is changed on the main thread while workers may be reading it.
+    absl::Mutex address_mutex_;
+    Network::Address::InstanceConstSharedPtr address_ ABSL_GUARDED_BY(address_mutex_);
     // Using std::chrono::steady_clock::duration is required for compilation within an atomic vs.
     // using MonotonicTime.
     std::atomic<std::chrono::steady_clock::duration> last_used_time_;
@@ -108,6 +174,10 @@ private:
     const Event::TimerPtr refresh_timer_;
     const DnsHostInfoImplSharedPtr host_info_;
     Network::ActiveDnsQuery* active_query_{};
+    // The entry of the host in the eviction order, and the last use of the host seen by the
+    // eviction, if eviction is enabled.
+    std::list<std::string>::iterator eviction_entry_;
+    std::chrono::steady_clock::duration eviction_last_used_time_{};
   };
 
   using PrimaryHostInfoPtr = std::unique_ptr<PrimaryHostInfo>;
@@ -126,8 +196,12 @@ private:
   void finishResolve(const std::string& host, std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void runRemoveCallbacks(const std::string& host);
-  void updateTlsHostsMap();
+  void updateTlsHostsMap(const std::string& host, const DnsHostInfoSharedPtr& host_info);
+  void removeHost(const std::string& host);
+  bool evictHost();
   void onReResolve(const std::string& host);
+  void loadSnapshot();
+  void writeSnapshot();
 
   Event::Dispatcher& main_thread_dispatcher_;
   const Network::DnsLookupFamily dns_lookup_family_;
@@ -137,9 +211,22 @@ private:
   DnsCacheStats stats_;
   std::list<AddUpdateCallbacksHandleImpl*> update_callbacks_;
   absl::flat_hash_map<std::string, PrimaryHostInfoPtr> primary_hosts_;
+  // The last host map published to the workers.
+  TlsHostMapConstSharedPtr tls_host_map_;
   const std::chrono::milliseconds refresh_interval_;
   const std::chrono::milliseconds host_ttl_;
   const uint32_t max_hosts_;
+  const bool evict_least_recently_used_;
+  // The hosts in the order the eviction clock hand goes through them, if eviction is enabled.
+  std::list<std::string> eviction_order_;
+  Api::Api& api_;
+  const std::string snapshot_path_;
+  Event::TimerPtr snapshot_timer_;
+  // Whether the hosts changed since the snapshot was last written.
+  bool snapshot_dirty_{};
+  // Shared with the other caches of the DnsCacheManagerImpl, and kept alive by each cache so that
+  // the snapshot queued when a cache is destroyed is still written.
+  const DnsCacheSnapshotWriterSharedPtr snapshot_writer_;
 };
 
 } // namespace DynamicForwardProxy
@@ -3,6 +3,7 @@
 #include "envoy/extensions/common/dynamic_forward_proxy/v3alpha/dns_cache.pb.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache.h"
+#include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 
 #include "absl/container/flat_hash_map.h"
 
@@ -14,8 +15,9 @@ namespace DynamicForwardProxy {
 class DnsCacheManagerImpl : public DnsCacheManager, public Singleton::Instance {
 public:
   DnsCacheManagerImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
-                      Stats::Scope& root_scope)
-      : main_thread_dispatcher_(main_thread_dispatcher), tls_(tls), root_scope_(root_scope) {}
+                      Api::Api& api, Stats::Scope& root_scope)
+      : main_thread_dispatcher_(main_thread_dispatcher), tls_(tls), api_(api),
+        root_scope_(root_scope), snapshot_writer_(std::make_shared<DnsCacheSnapshotWriter>(api)) {}
 
   // DnsCacheManager
   DnsCacheSharedPtr
@@ -35,25 +37,30 @@ private:
 
   Event::Dispatcher& main_thread_dispatcher_;
   ThreadLocal::SlotAllocator& tls_;
+  Api::Api& api_;
   Stats::Scope& root_scope_;
+  // Writes the snapshots of all the caches, so that they share one thread.
+  const DnsCacheSnapshotWriterSharedPtr snapshot_writer_;
   absl::flat_hash_map<std::string, ActiveCache> caches_;
 };
 
 class DnsCacheManagerFactoryImpl : public DnsCacheManagerFactory {
 public:
   DnsCacheManagerFactoryImpl(Singleton::Manager& singleton_manager, Event::Dispatcher& dispatcher,
-                             ThreadLocal::SlotAllocator& tls, Stats::Scope& root_scope)
-      : singleton_manager_(singleton_manager), dispatcher_(dispatcher), tls_(tls),
+                             ThreadLocal::SlotAllocator& tls, Api::Api& api,
+                             Stats::Scope& root_scope)
+      : singleton_manager_(singleton_manager), dispatcher_(dispatcher), tls_(tls), api_(api),
         root_scope_(root_scope) {}
 
   DnsCacheManagerSharedPtr get() override {
-    return getCacheManager(singleton_manager_, dispatcher_, tls_, root_scope_);
+    return getCacheManager(singleton_manager_, dispatcher_, tls_, api_, root_scope_);
   }
 
 private:
   Singleton::Manager& singleton_manager_;
   Event::Dispatcher& dispatcher_;
   ThreadLocal::SlotAllocator& tls_;
+  Api::Api& api_;
   Stats::Scope& root_scope_;
 };
 
@@ -8,12 +8,17 @@
 
 #include "envoy/common/pure.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
 namespace Redis {
 
 using RefreshCB = std::function<void()>;
+// The slots moved by MOVED redirections, with the address of the master now serving each slot.
+using MovedSlots = absl::flat_hash_map<uint64_t, std::string>;
+using SlotsMovedCB = std::function<void(const MovedSlots& moved_slots)>;
 
 /**
  * A manager for tracking events that would trigger a cluster refresh, and calling registered
@@ -39,6 +44,20 @@ public:
    */
   virtual bool onRedirection(const std::string& cluster_name) PURE;
 
+  /**
+   * Notifies the manager that a MOVED redirection has been received for a given cluster. The
+   * moves are batched and passed to the cluster's registered slots moved callback on the main
+   * thread, so that the affected slots are repointed without waiting for a full refresh. This is
+   * not counted as a redirection, for which onRedirection() is called separately.
+   * @param cluster_name is the name of the cluster.
+   * @param slot is the slot of the redirected request.
+   * @param address is the address of the master now serving the slot.
+   * @return bool true if a call to the cluster's slots moved callback is scheduled on the main
+   * thread, false if none is scheduled or one is already pending.
+   */
+  virtual bool onSlotMoved(const std::string& cluster_name, uint64_t slot,
+                           const std::string& address) PURE;
+
   /**
    * Notifies the manager that a failure has been received for a given cluster.
    * @param cluster_name is the name of the cluster.
@@ -63,6 +82,7 @@ public:
    * @param redirects_threshold is the number of redirects that must be reached to consider
    * calling the callback.
    * @param cb is the cluster callback function.
+   * @param moved_cb is the callback passed the slots moved by MOVED redirections.
    * @return HandlePtr is a smart pointer to an opaque Handle that will unregister the cluster upon
    * destruction.
    */
@@ -71,7 +91,7 @@ public:
                                     const uint32_t redirects_threshold,
                                     const uint32_t failure_threshold,
                                     const uint32_t host_degraded_threshold,
-                                    const RefreshCB& cb) PURE;
+                                    const RefreshCB& cb, const SlotsMovedCB& moved_cb) PURE;
 };
 
 using ClusterRefreshManagerSharedPtr = std::shared_ptr<ClusterRefreshManager>;
@@ -31,17 +31,48 @@ bool ClusterRefreshManagerImpl::onRedirection(const std::string& cluster_name) {
   return onEvent(cluster_name, EventType::Redirection);
 }
 
-bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventType event_type) {
-  ClusterInfoSharedPtr info;
+bool ClusterRefreshManagerImpl::onSlotMoved(const std::string& cluster_name, uint64_t slot,
+                                            const std::string& address) {
+  ClusterInfoSharedPtr info = getClusterInfo(cluster_name);
+  if (!info || !info->moved_cb_) {
+    return false;
+  }
   {
-    // Hold the map lock to avoid a race condition with calls to unregisterCluster
-    // on the main thread.
-    Thread::LockGuard lock(map_mutex_);
-    auto it = info_map_.find(cluster_name);
-    if (it != info_map_.end()) {
-      info = it->second;
+    // The moves received while a call to the callback is pending are added to its batch, so that
+    // a burst of redirections during a resharding only updates the cluster once.
+    Thread::LockGuard lock(info->moved_slots_mutex_);
+    const bool pending = !info->moved_slots_.empty();
+    info->moved_slots_[slot] = address;
+    if (pending) {
+      return false;
     }
   }
+  main_thread_dispatcher_.post([this, cluster_name, info]() {
+    MovedSlots moved_slots;
+    {
+      Thread::LockGuard lock(info->moved_slots_mutex_);
+      moved_slots.swap(info->moved_slots_);
+    }
+    // Ensure that cluster is still active before calling callback.
+    auto map = cm_.clusters();
+    if (map.find(cluster_name) != map.end()) {
+      info->moved_cb_(moved_slots);
+    }
+  });
+  return true;
+}
+
+ClusterRefreshManagerImpl::ClusterInfoSharedPtr
+ClusterRefreshManagerImpl::getClusterInfo(const std::string& cluster_name) {
+  // Hold the map lock to avoid a race condition with calls to unregisterCluster
+  // on the main thread.
+  Thread::LockGuard lock(map_mutex_);
+  auto it = info_map_.find(cluster_name);
+  return it != info_map_.end() ? it->second : nullptr;
+}
+
+bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventType event_type) {
+  ClusterInfoSharedPtr info = getClusterInfo(cluster_name);
   // No locks needed for thread safety while accessing clusterInfoSharedPtr members as
   // all potentially modified members are atomic (redirects_count_, last_callback_time_ms_).
   if (info.get()) {
@@ -99,11 +130,11 @@ bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventTy
 ClusterRefreshManagerImpl::HandlePtr ClusterRefreshManagerImpl::registerCluster(
     const std::string& cluster_name, std::chrono::milliseconds min_time_between_triggering,
     const uint32_t redirects_threshold, const uint32_t failure_threshold,
-    const uint32_t host_degraded_threshold, const RefreshCB& cb) {
+    const uint32_t host_degraded_threshold, const RefreshCB& cb, const SlotsMovedCB& moved_cb) {
   Thread::LockGuard lock(map_mutex_);
   ClusterInfoSharedPtr info =
       std::make_shared<ClusterInfo>(cluster_name, min_time_between_triggering, redirects_threshold,
-                                    failure_threshold, host_degraded_threshold, cb);
+                                    failure_threshold, host_degraded_threshold, cb, moved_cb);
   info_map_[cluster_name] = info;
 
   return std::make_unique<ClusterRefreshManagerImpl::HandleImpl>(this, info);
@@ -30,11 +30,12 @@ public:
   struct ClusterInfo {
     ClusterInfo(std::string cluster_name, std::chrono::milliseconds min_time_between_triggering,
                 const uint32_t redirects_threshold, const uint32_t failure_threshold,
-                const uint32_t host_degraded_threshold, RefreshCB cb)
+                const uint32_t host_degraded_threshold, RefreshCB cb, SlotsMovedCB moved_cb)
         : cluster_name_(std::move(cluster_name)),
           min_time_between_triggering_(min_time_between_triggering),
           redirects_threshold_(redirects_threshold), failure_threshold_(failure_threshold),
-          host_degraded_threshold_(host_degraded_threshold), cb_(std::move(cb)) {}
+          host_degraded_threshold_(host_degraded_threshold), cb_(std::move(cb)),
+          moved_cb_(std::move(moved_cb)) {}
     std::string cluster_name_;
     std::atomic<uint64_t> last_callback_time_ms_{};
     std::atomic<uint32_t> redirects_count_{};
@@ -45,6 +46,10 @@ public:
     const uint32_t failure_threshold_;
     const uint32_t host_degraded_threshold_;
     RefreshCB cb_;
+    SlotsMovedCB moved_cb_;
+    Thread::MutexBasicLockable moved_slots_mutex_;
+    // The slots moved since the last call to moved_cb_, which is pending while this is not empty.
+    MovedSlots moved_slots_ GUARDED_BY(moved_slots_mutex_);
   };
 
   using ClusterInfoSharedPtr = std::shared_ptr<ClusterInfo>;
@@ -68,14 +73,18 @@ public:
   bool onRedirection(const std::string& cluster_name) override;
   bool onFailure(const std::string& cluster_name) override;
   bool onHostDegraded(const std::string& cluster_name) override;
+  bool onSlotMoved(const std::string& cluster_name, uint64_t slot,
+                   const std::string& address) override;
 
   HandlePtr registerCluster(const std::string& cluster_name,
                             std::chrono::milliseconds min_time_between_triggering,
                             const uint32_t redirects_threshold, const uint32_t failure_threshold,
-                            const uint32_t host_degraded_threshold, const RefreshCB& cb) override;
+                            const uint32_t host_degraded_threshold, const RefreshCB& cb,
+                            const SlotsMovedCB& moved_cb) override;
 
 private:
   void unregisterCluster(const ClusterInfoSharedPtr& cluster_info);
+  ClusterInfoSharedPtr getClusterInfo(const std::string& cluster_name);
   /**
    * The type of events that can trigger discovery
    */
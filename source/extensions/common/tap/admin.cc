@@ -64,8 +64,12 @@ Http::Code AdminHandler::handler(absl::string_view, Http::HeaderMap&, Buffer::In
         response, fmt::format("Unknown config id '{}'. No extension has registered with this id.",
                               tap_request.config_id()));
   }
-  for (auto config : config_id_map_[tap_request.config_id()]) {
-    config->newTapConfig(std::move(*tap_request.mutable_tap_config()), this);
+  try {
+    for (auto config : config_id_map_[tap_request.config_id()]) {
+      config->newTapConfig(std::move(*tap_request.mutable_tap_config()), this);
+    }
+  } catch (EnvoyException& e) {
+    return badRequest(response, e.what());
   }
 
   admin_stream.setEndStreamOnComplete(false);
@@ -105,12 +109,19 @@ void AdminHandler::unregisterConfig(ExtensionConfig& config) {
 
 void AdminHandler::AdminPerTapSinkHandle::submitTrace(
     TraceWrapperPtr&& trace, envoy::config::tap::v3alpha::OutputSink::Format format) {
+  if (parent_.pending_traces_.fetch_add(1) >= MaxPendingTraces) {
+    parent_.pending_traces_--;
+    ENVOY_LOG(debug, "admin dropping trace, too many traces are pending");
+    return;
+  }
+
   ENVOY_LOG(debug, "admin submitting buffered trace to main thread");
   // Convert to a shared_ptr, so we can send it to the main thread.
   std::shared_ptr<envoy::data::tap::v3alpha::TraceWrapper> shared_trace{std::move(trace)};
   // The handle can be destroyed before the cross thread post is complete. Thus, we capture a
   // reference to our parent.
   parent_.main_thread_dispatcher_.post([& parent = parent_, trace = shared_trace, format]() {
+    parent.pending_traces_--;
     if (!parent.attached_request_.has_value()) {
       return;
     }
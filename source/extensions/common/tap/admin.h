@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "envoy/config/tap/v3alpha/common.pb.h"
 #include "envoy/server/admin.h"
 #include "envoy/singleton/manager.h"
@@ -55,6 +57,11 @@ public:
     return std::make_unique<AdminPerTapSinkHandle>(*this);
   }
 
+  // The maximum number of traces submitted by the workers that can wait for the main thread to
+  // write them to the admin stream. Traces submitted beyond this are dropped, so that a main thread
+  // falling behind busy workers does not grow the memory without bound.
+  static constexpr uint32_t MaxPendingTraces = 1000;
+
 private:
   struct AdminPerTapSinkHandle : public PerTapSinkHandle {
     AdminPerTapSinkHandle(AdminHandler& parent) : parent_(parent) {}
@@ -82,6 +89,7 @@ private:
   Event::Dispatcher& main_thread_dispatcher_;
   std::unordered_map<std::string, std::unordered_set<ExtensionConfig*>> config_id_map_;
   absl::optional<const AttachedRequest> attached_request_;
+  std::atomic<uint32_t> pending_traces_{};
 };
 
 } // namespace Tap
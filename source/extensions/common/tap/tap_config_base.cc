@@ -1,5 +1,6 @@
 #include "extensions/common/tap/tap_config_base.h"
 
+#include "envoy/common/exception.h"
 #include "envoy/config/tap/v3alpha/common.pb.h"
 #include "envoy/data/tap/v3alpha/common.pb.h"
 #include "envoy/data/tap/v3alpha/wrapper.pb.h"
@@ -44,8 +45,11 @@ bool Utility::addBufferToProtoBytes(envoy::data::tap::v3alpha::Body& output_body
 }
 
 TapConfigBaseImpl::TapConfigBaseImpl(envoy::config::tap::v3alpha::TapConfig&& proto_config,
-                                     Common::Tap::Sink* admin_streamer)
-    : max_buffered_rx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                                     Common::Tap::Sink* admin_streamer,
+                                     SinkPtr&& extension_sink)
+    : tap_enabled_(proto_config.has_tap_enabled() ? absl::make_optional(proto_config.tap_enabled())
+                                                  : absl::nullopt),
+      max_buffered_rx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_rx_bytes, DefaultMaxBufferedBytes)),
       max_buffered_tx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_tx_bytes, DefaultMaxBufferedBytes)),
@@ -69,6 +73,13 @@ TapConfigBaseImpl::TapConfigBaseImpl(envoy::config::tap::v3alpha::TapConfig&& pr
         std::make_unique<FilePerTapSink>(proto_config.output_config().sinks()[0].file_per_tap());
     sink_to_use_ = sink_.get();
     break;
+  case envoy::config::tap::v3alpha::OutputSink::OutputSinkTypeCase::kPcapng:
+    if (extension_sink == nullptr) {
+      throw EnvoyException("pcap-ng tap output is only supported by the tap transport socket");
+    }
+    sink_ = std::move(extension_sink);
+    sink_to_use_ = sink_.get();
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -3,6 +3,7 @@
 #include <fstream>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/config/core/v3alpha/base.pb.h"
 #include "envoy/config/tap/v3alpha/common.pb.h"
 #include "envoy/data/tap/v3alpha/common.pb.h"
 #include "envoy/data/tap/v3alpha/wrapper.pb.h"
@@ -10,6 +11,8 @@
 #include "extensions/common/tap/tap.h"
 #include "extensions/common/tap/tap_matcher.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
@@ -96,8 +99,16 @@ public:
   bool streaming() const override { return streaming_; }
 
 protected:
+  /**
+   * @param extension_sink supplies the sink to use for the output sink types which only the
+   *        extension supports (e.g. pcap-ng for socket taps), or nullptr.
+   */
   TapConfigBaseImpl(envoy::config::tap::v3alpha::TapConfig&& proto_config,
-                    Common::Tap::Sink* admin_streamer);
+                    Common::Tap::Sink* admin_streamer, SinkPtr&& extension_sink = nullptr);
+
+  // The fraction of the requests/connections to tap, if configured. It is up to the extension to
+  // sample with it, as this requires access to the runtime.
+  const absl::optional<envoy::config::core::v3alpha::RuntimeFractionalPercent> tap_enabled_;
 
 private:
   // This is the default setting for both RX/TX max buffered bytes. (This means that per tap, the
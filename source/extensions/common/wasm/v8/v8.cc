@@ -86,7 +86,8 @@ private:
   void getModuleFunctionImpl(absl::string_view function_name,
                              std::function<R(Context*, Args...)>* function);
 
-  wasm::vec<byte_t> source_ = wasm::vec<byte_t>::invalid();
+  // The module bytecode, shared with the clones for the lookups of custom sections.
+  std::shared_ptr<const wasm::vec<byte_t>> source_;
   wasm::own<wasm::Store> store_;
   wasm::own<wasm::Module> module_;
   wasm::own<wasm::Shared<wasm::Module>> shared_module_;
@@ -243,10 +244,12 @@ bool V8::load(const std::string& code, bool /* allow_precompiled */) {
   ENVOY_LOG(trace, "load()");
   store_ = wasm::Store::make(engine());
 
-  source_ = wasm::vec<byte_t>::make_uninitialized(code.size());
-  ::memcpy(source_.get(), code.data(), code.size());
+  auto source =
+      std::make_shared<wasm::vec<byte_t>>(wasm::vec<byte_t>::make_uninitialized(code.size()));
+  ::memcpy(source->get(), code.data(), code.size());
+  source_ = std::move(source);
 
-  module_ = wasm::Module::make(store_.get(), source_);
+  module_ = wasm::Module::make(store_.get(), *source_);
   if (module_) {
     shared_module_ = module_->share();
   }
@@ -258,8 +261,11 @@ WasmVmPtr V8::clone() {
   ENVOY_LOG(trace, "clone()");
   ASSERT(shared_module_ != nullptr);
 
+  // The clone obtains the module compiled by load(), so starting a VM on a worker does not compile
+  // the bytecode again.
   auto clone = std::make_unique<V8>(scope_);
   clone->store_ = wasm::Store::make(engine());
+  clone->source_ = source_;
 
   clone->module_ = wasm::Module::obtain(clone->store_.get(), shared_module_.get());
 
@@ -268,10 +274,10 @@ WasmVmPtr V8::clone() {
 
 absl::string_view V8::getCustomSection(absl::string_view name) {
   ENVOY_LOG(trace, "getCustomSection(\"{}\")", name);
-  ASSERT(source_.get() != nullptr);
+  ASSERT(source_ != nullptr);
 
-  const byte_t* end = source_.get() + source_.size();
-  const byte_t* pos = source_.get() + 8; // skip header
+  const byte_t* end = source_->get() + source_->size();
+  const byte_t* pos = source_->get() + 8; // skip header
   while (pos < end) {
     if (pos + 1 > end) {
       throw WasmVmException("Failed to parse corrupted WASM module");
@@ -2,6 +2,8 @@
 
 #include "envoy/common/exception.h"
 
+#include "common/common/macros.h"
+
 #include "eval/public/builtin_func_registrar.h"
 #include "eval/public/cel_expr_builder_factory.h"
 
@@ -11,20 +13,111 @@ namespace Filters {
 namespace Common {
 namespace Expr {
 
+const ReferencedAttributes& ReferencedAttributes::all() {
+  CONSTRUCT_ON_FIRST_USE(ReferencedAttributes, true /* request */, true /* response */,
+                         true /* connection */, true /* upstream */, true /* source */,
+                         true /* destination */, true /* metadata */);
+}
+
+namespace {
+
+void collectAttributes(const google::api::expr::v1alpha1::Expr& expr,
+                       ReferencedAttributes& attributes) {
+  switch (expr.expr_kind_case()) {
+  case google::api::expr::v1alpha1::Expr::kIdentExpr: {
+    const std::string& name = expr.ident_expr().name();
+    attributes.request_ |= name == Request;
+    attributes.response_ |= name == Response;
+    attributes.connection_ |= name == Connection;
+    attributes.upstream_ |= name == Upstream;
+    attributes.source_ |= name == Source;
+    attributes.destination_ |= name == Destination;
+    attributes.metadata_ |= name == Metadata;
+    break;
+  }
+  case google::api::expr::v1alpha1::Expr::kSelectExpr:
+    collectAttributes(expr.select_expr().operand(), attributes);
+    break;
+  case google::api::expr::v1alpha1::Expr::kCallExpr:
+    if (expr.call_expr().has_target()) {
+      collectAttributes(expr.call_expr().target(), attributes);
+    }
+    for (const auto& arg : expr.call_expr().args()) {
+      collectAttributes(arg, attributes);
+    }
+    break;
+  case google::api::expr::v1alpha1::Expr::kListExpr:
+    for (const auto& element : expr.list_expr().elements()) {
+      collectAttributes(element, attributes);
+    }
+    break;
+  case google::api::expr::v1alpha1::Expr::kStructExpr:
+    for (const auto& entry : expr.struct_expr().entries()) {
+      if (entry.has_map_key()) {
+        collectAttributes(entry.map_key(), attributes);
+      }
+      collectAttributes(entry.value(), attributes);
+    }
+    break;
+  case google::api::expr::v1alpha1::Expr::kComprehensionExpr: {
+    const auto& comprehension = expr.comprehension_expr();
+    collectAttributes(comprehension.iter_range(), attributes);
+    collectAttributes(comprehension.accu_init(), attributes);
+    collectAttributes(comprehension.loop_condition(), attributes);
+    collectAttributes(comprehension.loop_step(), attributes);
+    collectAttributes(comprehension.result(), attributes);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+} // namespace
+
+ReferencedAttributes referencedAttributes(const google::api::expr::v1alpha1::Expr& expr) {
+  ReferencedAttributes attributes;
+  collectAttributes(expr, attributes);
+  return attributes;
+}
+
+void populateActivation(Activation& activation, const ReferencedAttributes& attributes,
+                        const StreamInfo::StreamInfo& info, const Http::HeaderMap* request_headers,
+                        const Http::HeaderMap* response_headers,
+                        const Http::HeaderMap* response_trailers) {
+  if (attributes.request_) {
+    activation.InsertValueProducer(Request,
+                                   std::make_unique<RequestWrapper>(request_headers, info));
+  }
+  if (attributes.response_) {
+    activation.InsertValueProducer(
+        Response, std::make_unique<ResponseWrapper>(response_headers, response_trailers, info));
+  }
+  if (attributes.connection_) {
+    activation.InsertValueProducer(Connection, std::make_unique<ConnectionWrapper>(info));
+  }
+  if (attributes.upstream_) {
+    activation.InsertValueProducer(Upstream, std::make_unique<UpstreamWrapper>(info));
+  }
+  if (attributes.source_) {
+    activation.InsertValueProducer(Source, std::make_unique<PeerWrapper>(info, false));
+  }
+  if (attributes.destination_) {
+    activation.InsertValueProducer(Destination, std::make_unique<PeerWrapper>(info, true));
+  }
+  if (attributes.metadata_) {
+    activation.InsertValueProducer(Metadata,
+                                   std::make_unique<MetadataProducer>(info.dynamicMetadata()));
+  }
+}
+
 ActivationPtr createActivation(const StreamInfo::StreamInfo& info,
                                const Http::HeaderMap* request_headers,
                                const Http::HeaderMap* response_headers,
                                const Http::HeaderMap* response_trailers) {
   auto activation = std::make_unique<Activation>();
-  activation->InsertValueProducer(Request, std::make_unique<RequestWrapper>(request_headers, info));
-  activation->InsertValueProducer(
-      Response, std::make_unique<ResponseWrapper>(response_headers, response_trailers, info));
-  activation->InsertValueProducer(Connection, std::make_unique<ConnectionWrapper>(info));
-  activation->InsertValueProducer(Upstream, std::make_unique<UpstreamWrapper>(info));
-  activation->InsertValueProducer(Source, std::make_unique<PeerWrapper>(info, false));
-  activation->InsertValueProducer(Destination, std::make_unique<PeerWrapper>(info, true));
-  activation->InsertValueProducer(Metadata,
-                                  std::make_unique<MetadataProducer>(info.dynamicMetadata()));
+  populateActivation(*activation, ReferencedAttributes::all(), info, request_headers,
+                     response_headers, response_trailers);
   return activation;
 }
 
@@ -81,12 +174,26 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena
 
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::HeaderMap& headers) {
-  Protobuf::Arena arena;
-  auto eval_status = Expr::evaluate(expr, &arena, info, &headers, nullptr, nullptr);
-  if (!eval_status.has_value()) {
+  return matches(expr, ReferencedAttributes::all(), info, headers);
+}
+
+bool matches(const Expression& expr, const ReferencedAttributes& attributes,
+             const StreamInfo::StreamInfo& info, const Http::HeaderMap& headers) {
+  // The intermediate results of most conditions fit in the initial block, which saves allocating
+  // the arena blocks on each evaluation.
+  alignas(8) char initial_block[1024];
+  Protobuf::ArenaOptions arena_options;
+  arena_options.initial_block = initial_block;
+  arena_options.initial_block_size = sizeof(initial_block);
+  Protobuf::Arena arena(arena_options);
+
+  Activation activation;
+  populateActivation(activation, attributes, info, &headers, nullptr, nullptr);
+  auto eval_status = expr.Evaluate(activation, &arena);
+  if (!eval_status.ok()) {
     return false;
   }
-  auto result = eval_status.value();
+  auto result = eval_status.ValueOrDie();
   return result.IsBool() ? result.BoolOrDie() : false;
 }
 
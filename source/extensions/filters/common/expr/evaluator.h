@@ -23,6 +23,25 @@ using BuilderPtr = std::unique_ptr<Builder>;
 using Expression = google::api::expr::runtime::CelExpression;
 using ExpressionPtr = std::unique_ptr<Expression>;
 
+// The top level context attributes which an expression refers to. The activation of an
+// evaluation only provides these, so that the attributes which are not used cost nothing.
+struct ReferencedAttributes {
+  // All of the context attributes, for expressions which are not analyzed.
+  static const ReferencedAttributes& all();
+
+  bool request_{};
+  bool response_{};
+  bool connection_{};
+  bool upstream_{};
+  bool source_{};
+  bool destination_{};
+  bool metadata_{};
+};
+
+// Collects the top level context attributes which an expression refers to. This is meant to be
+// computed once, along with the runtime expression, when the config is loaded.
+ReferencedAttributes referencedAttributes(const google::api::expr::v1alpha1::Expr& expr);
+
 // Creates an activation providing the common context attributes.
 // The activation lazily creates wrappers during an evaluation using the evaluation arena.
 ActivationPtr createActivation(const StreamInfo::StreamInfo& info,
@@ -30,6 +49,12 @@ ActivationPtr createActivation(const StreamInfo::StreamInfo& info,
                                const Http::HeaderMap* response_headers,
                                const Http::HeaderMap* response_trailers);
 
+// Populates an activation with the given context attributes only.
+void populateActivation(Activation& activation, const ReferencedAttributes& attributes,
+                        const StreamInfo::StreamInfo& info, const Http::HeaderMap* request_headers,
+                        const Http::HeaderMap* response_headers,
+                        const Http::HeaderMap* response_trailers);
+
 // Creates an expression builder. The optional arena is used to enable constant folding
 // for intermediate evaluation results.
 // Throws an exception if fails to construct an expression builder.
@@ -52,6 +77,11 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::HeaderMap& headers);
 
+// Same as above, only providing the given context attributes to the expression. The attributes
+// must include all the ones referenced by the expression.
+bool matches(const Expression& expr, const ReferencedAttributes& attributes,
+             const StreamInfo::StreamInfo& info, const Http::HeaderMap& headers);
+
 // Thrown when there is an CEL library error.
 class CelException : public EnvoyException {
 public:
@@ -41,11 +41,18 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
     yield_callback();
   } else {
     state_ = State::Finished;
+    failed_ = true;
     const char* error = lua_tostring(coroutine_state_.get(), -1);
     throw LuaException(error);
   }
 }
 
+void Coroutine::reset() {
+  ASSERT(reusable());
+  lua_settop(coroutine_state_.get(), 0);
+  state_ = State::NotStarted;
+}
+
 ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls)
     : tls_slot_(tls.allocateSlot()) {
 
@@ -86,10 +93,29 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global) {
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tls_slot_->getTyped<LuaThreadLocal>().state_.get();
+  LuaThreadLocal& tls = tls_slot_->getTyped<LuaThreadLocal>();
+  if (!tls.coroutine_pool_.empty()) {
+    CoroutinePtr coroutine = std::move(tls.coroutine_pool_.back());
+    tls.coroutine_pool_.pop_back();
+    return coroutine;
+  }
+  lua_State* state = tls.state_.get();
   return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
 }
 
+void ThreadLocalState::releaseCoroutine(CoroutinePtr&& coroutine) {
+  LuaThreadLocal& tls = tls_slot_->getTyped<LuaThreadLocal>();
+  // A coroutine which failed is dead and one which yielded may still reference the objects of the
+  // previous function, so they are only reclaimed by the GC.
+  if (coroutine == nullptr || !coroutine->reusable() ||
+      tls.coroutine_pool_.size() >= MaxPooledCoroutines) {
+    coroutine.reset();
+    return;
+  }
+  coroutine->reset();
+  tls.coroutine_pool_.emplace_back(std::move(coroutine));
+}
+
 ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code) : state_(lua_open()) {
   luaL_openlibs(state_.get());
   int rc = luaL_dostring(state_.get(), code.c_str());
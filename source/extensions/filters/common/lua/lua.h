@@ -346,9 +346,21 @@ public:
    */
   void resume(int num_args, const std::function<void()>& yield_callback);
 
+  /**
+   * @return whether the Lua thread of the coroutine can run a new function: the coroutine is not
+   *         suspended in the middle of a function and it did not fail.
+   */
+  bool reusable() const { return state_ != State::Yielded && !failed_; }
+
+  /**
+   * Return a reusable coroutine to its not started state, dropping the values left on its stack.
+   */
+  void reset();
+
 private:
   LuaRef<lua_State> coroutine_state_;
   State state_{State::NotStarted};
+  bool failed_{};
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -363,10 +375,19 @@ public:
   ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls);
 
   /**
-   * @return CoroutinePtr a new coroutine.
+   * @return CoroutinePtr a new coroutine. The coroutines previously released on the calling thread
+   *         are reused first.
    */
   CoroutinePtr createCoroutine();
 
+  /**
+   * Release a coroutine which is not needed anymore, so that a later createCoroutine() on the same
+   * thread reuses its Lua thread instead of allocating a new one. Coroutines which can not be
+   * reused or which do not fit in the pool are destroyed.
+   * @param coroutine supplies the coroutine, created by this state on the calling thread.
+   */
+  void releaseCoroutine(CoroutinePtr&& coroutine);
+
   /**
    * @return a global reference previously registered via registerGlobal(). This may return
    *         LUA_REFNIL if there was no such global.
@@ -411,8 +432,13 @@ private:
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    // Declared after the state, so that the coroutines are destroyed before it is closed.
+    std::vector<CoroutinePtr> coroutine_pool_;
   };
 
+  // The number of released coroutines kept for reuse by each thread.
+  static constexpr size_t MaxPooledCoroutines = 128;
+
   ThreadLocal::SlotPtr tls_slot_;
   uint64_t current_global_slot_{};
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -72,6 +73,15 @@ public:
   virtual void limit(RequestCallbacks& callbacks, const std::string& domain,
                      const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                      Tracing::Span& parent_span) PURE;
+
+  /**
+   * Request a limit check which counts several hits at once, so that they can be handed out
+   * locally by the caller. @see limit() for the other parameters.
+   * @param hits_addend supplies the number of hits the request counts.
+   */
+  virtual void limit(RequestCallbacks& callbacks, const std::string& domain,
+                     const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                     Tracing::Span& parent_span, uint32_t hits_addend) PURE;
 };
 
 using ClientPtr = std::unique_ptr<Client>;
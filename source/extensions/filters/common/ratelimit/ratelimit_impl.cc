@@ -36,8 +36,11 @@ void GrpcClientImpl::cancel() {
 
 void GrpcClientImpl::createRequest(envoy::service::ratelimit::v3alpha::RateLimitRequest& request,
                                    const std::string& domain,
-                                   const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+                                   const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                                   uint32_t hits_addend) {
   request.set_domain(domain);
+  // The rate limit service counts a single hit when this is not set.
+  request.set_hits_addend(hits_addend);
   for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
     envoy::extensions::common::ratelimit::v3alpha::RateLimitDescriptor* new_descriptor =
         request.add_descriptors();
@@ -53,11 +56,17 @@ void GrpcClientImpl::createRequest(envoy::service::ratelimit::v3alpha::RateLimit
 void GrpcClientImpl::limit(RequestCallbacks& callbacks, const std::string& domain,
                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                            Tracing::Span& parent_span) {
+  limit(callbacks, domain, descriptors, parent_span, 0);
+}
+
+void GrpcClientImpl::limit(RequestCallbacks& callbacks, const std::string& domain,
+                           const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                           Tracing::Span& parent_span, uint32_t hits_addend) {
   ASSERT(callbacks_ == nullptr);
   callbacks_ = &callbacks;
 
   envoy::service::ratelimit::v3alpha::RateLimitRequest request;
-  createRequest(request, domain, descriptors);
+  createRequest(request, domain, descriptors, hits_addend);
 
   request_ = async_client_->send(service_method_, request, *this, parent_span,
                                  Http::AsyncClient::RequestOptions().setTimeout(timeout_));
@@ -51,13 +51,17 @@ public:
 
   static void createRequest(envoy::service::ratelimit::v3alpha::RateLimitRequest& request,
                             const std::string& domain,
-                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                            uint32_t hits_addend = 0);
 
   // Filters::Common::RateLimit::Client
   void cancel() override;
   void limit(RequestCallbacks& callbacks, const std::string& domain,
              const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
              Tracing::Span& parent_span) override;
+  void limit(RequestCallbacks& callbacks, const std::string& domain,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+             Tracing::Span& parent_span, uint32_t hits_addend) override;
 
   // Grpc::AsyncRequestCallbacks
   void onCreateInitialMetadata(Http::HeaderMap&) override {}
@@ -1,5 +1,10 @@
 #include "extensions/filters/common/rbac/engine_impl.h"
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+
 #include "envoy/config/rbac/v3alpha/rbac.pb.h"
 
 #include "common/http/header_map_impl.h"
@@ -9,10 +14,293 @@ namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace RBAC {
+namespace {
+
+uint64_t nextEngineId() {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id++;
+}
+
+// Returns whether the permission only depends on the connection, and not on the headers or the
+// dynamic metadata which may differ between requests.
+bool connectionOnly(const envoy::config::rbac::v3alpha::Permission& permission) {
+  switch (permission.rule_case()) {
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kAndRules:
+    return std::all_of(permission.and_rules().rules().begin(), permission.and_rules().rules().end(),
+                       [](const envoy::config::rbac::v3alpha::Permission& rule) {
+                         return connectionOnly(rule);
+                       });
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kOrRules:
+    return std::all_of(permission.or_rules().rules().begin(), permission.or_rules().rules().end(),
+                       [](const envoy::config::rbac::v3alpha::Permission& rule) {
+                         return connectionOnly(rule);
+                       });
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kNotRule:
+    return connectionOnly(permission.not_rule());
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kAny:
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kDestinationIp:
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kDestinationPort:
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kRequestedServerName:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool connectionOnly(const envoy::config::rbac::v3alpha::Principal& principal) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kAndIds:
+    return std::all_of(principal.and_ids().ids().begin(), principal.and_ids().ids().end(),
+                       [](const envoy::config::rbac::v3alpha::Principal& id) {
+                         return connectionOnly(id);
+                       });
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kOrIds:
+    return std::all_of(principal.or_ids().ids().begin(), principal.or_ids().ids().end(),
+                       [](const envoy::config::rbac::v3alpha::Principal& id) {
+                         return connectionOnly(id);
+                       });
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kNotId:
+    return connectionOnly(principal.not_id());
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kAny:
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kAuthenticated:
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kSourceIp:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// The conditions may refer to any attribute of the request.
+bool connectionOnly(const envoy::config::rbac::v3alpha::Policy& policy) {
+  return !policy.has_condition() &&
+         std::all_of(policy.permissions().begin(), policy.permissions().end(),
+                     [](const envoy::config::rbac::v3alpha::Permission& permission) {
+                       return connectionOnly(permission);
+                     }) &&
+         std::all_of(policy.principals().begin(), policy.principals().end(),
+                     [](const envoy::config::rbac::v3alpha::Principal& principal) {
+                       return connectionOnly(principal);
+                     });
+}
+
+} // namespace
+
+bool PolicyIndex::collectHeaderKey(const envoy::config::route::v3alpha::HeaderMatcher& header,
+                                   Keys& keys) {
+  // An empty exact match matches any value of the header.
+  if (header.header_match_specifier_case() !=
+          envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch ||
+      header.exact_match().empty() || header.invert_match()) {
+    return false;
+  }
+  keys.headers_.emplace_back(Http::LowerCaseString(header.name()).get(), header.exact_match());
+  return true;
+}
+
+// Returns whether the permission matches only if one of the collected keys does.
+bool PolicyIndex::collectKeys(const envoy::config::rbac::v3alpha::Permission& permission,
+                              Keys& keys) {
+  switch (permission.rule_case()) {
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kHeader:
+    return collectHeaderKey(permission.header(), keys);
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kRequestedServerName:
+    if (permission.requested_server_name().match_pattern_case() !=
+        envoy::type::matcher::v3alpha::StringMatcher::MatchPatternCase::kExact) {
+      return false;
+    }
+    keys.server_names_.push_back(permission.requested_server_name().exact());
+    return true;
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kOrRules:
+    for (const auto& rule : permission.or_rules().rules()) {
+      if (!collectKeys(rule, keys)) {
+        return false;
+      }
+    }
+    return true;
+  case envoy::config::rbac::v3alpha::Permission::RuleCase::kAndRules:
+    // Any of the rules is required, so the first one which can be indexed is enough.
+    for (const auto& rule : permission.and_rules().rules()) {
+      Keys rule_keys;
+      if (collectKeys(rule, rule_keys)) {
+        std::move(rule_keys.headers_.begin(), rule_keys.headers_.end(),
+                  std::back_inserter(keys.headers_));
+        std::move(rule_keys.server_names_.begin(), rule_keys.server_names_.end(),
+                  std::back_inserter(keys.server_names_));
+        return true;
+      }
+    }
+    return false;
+  default:
+    return false;
+  }
+}
+
+// Returns whether the principal matches only if one of the collected keys does.
+bool PolicyIndex::collectKeys(const envoy::config::rbac::v3alpha::Principal& principal,
+                              Keys& keys) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kHeader:
+    return collectHeaderKey(principal.header(), keys);
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kAuthenticated:
+    // Without a principal name, any authenticated connection matches.
+    if (!principal.authenticated().has_principal_name() ||
+        principal.authenticated().principal_name().match_pattern_case() !=
+            envoy::type::matcher::v3alpha::StringMatcher::MatchPatternCase::kExact) {
+      return false;
+    }
+    keys.principal_names_.push_back(principal.authenticated().principal_name().exact());
+    return true;
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kSourceIp: {
+    Network::Address::CidrRange range = Network::Address::CidrRange::create(principal.source_ip());
+    if (!range.isValid()) {
+      return false;
+    }
+    keys.source_ips_.push_back(std::move(range));
+    return true;
+  }
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kOrIds:
+    for (const auto& id : principal.or_ids().ids()) {
+      if (!collectKeys(id, keys)) {
+        return false;
+      }
+    }
+    return true;
+  case envoy::config::rbac::v3alpha::Principal::IdentifierCase::kAndIds:
+    for (const auto& id : principal.and_ids().ids()) {
+      Keys id_keys;
+      if (collectKeys(id, id_keys)) {
+        std::move(id_keys.headers_.begin(), id_keys.headers_.end(),
+                  std::back_inserter(keys.headers_));
+        std::move(id_keys.principal_names_.begin(), id_keys.principal_names_.end(),
+                  std::back_inserter(keys.principal_names_));
+        std::move(id_keys.source_ips_.begin(), id_keys.source_ips_.end(),
+                  std::back_inserter(keys.source_ips_));
+        return true;
+      }
+    }
+    return false;
+  default:
+    return false;
+  }
+}
+
+void PolicyIndex::addPolicy(uint32_t position, const envoy::config::rbac::v3alpha::Policy& policy) {
+  // The policy matches only if one of its permissions and one of its principals do, so the keys
+  // of either of them are enough.
+  Keys keys;
+  bool indexed = std::all_of(
+      policy.permissions().begin(), policy.permissions().end(),
+      [&keys](const envoy::config::rbac::v3alpha::Permission& permission) {
+        return collectKeys(permission, keys);
+      });
+  if (!indexed) {
+    keys = Keys();
+    indexed = std::all_of(policy.principals().begin(), policy.principals().end(),
+                          [&keys](const envoy::config::rbac::v3alpha::Principal& principal) {
+                            return collectKeys(principal, keys);
+                          });
+  }
+  if (!indexed) {
+    unindexed_.push_back(position);
+    return;
+  }
+
+  const auto add = [position](std::vector<uint32_t>& positions) {
+    // A policy may have several keys with the same value.
+    if (positions.empty() || positions.back() != position) {
+      positions.push_back(position);
+    }
+  };
+  for (const auto& header : keys.headers_) {
+    auto it = std::find_if(
+        headers_.begin(), headers_.end(),
+        [&header](const std::pair<Http::LowerCaseString, PositionsByValue>& entry) {
+          return entry.first.get() == header.first;
+        });
+    if (it == headers_.end()) {
+      headers_.emplace_back(Http::LowerCaseString(header.first), PositionsByValue());
+      it = std::prev(headers_.end());
+    }
+    add(it->second[header.second]);
+  }
+  for (const auto& server_name : keys.server_names_) {
+    add(server_names_[server_name]);
+  }
+  for (const auto& principal_name : keys.principal_names_) {
+    add(principal_names_[principal_name]);
+  }
+  if (!keys.source_ips_.empty()) {
+    source_ip_ranges_.emplace_back(position, std::move(keys.source_ips_));
+  }
+}
+
+void PolicyIndex::finalize() {
+  if (source_ip_ranges_.empty()) {
+    return;
+  }
+  size_t num_ranges = 0;
+  for (const auto& position_and_ranges : source_ip_ranges_) {
+    num_ranges += position_and_ranges.second.size();
+  }
+  // Past the capacity of the trie with its default fill factor, the policies are not indexed by
+  // their source ranges.
+  if (num_ranges > Network::LcTrie::MaxLcTrieNodes / 4) {
+    for (const auto& position_and_ranges : source_ip_ranges_) {
+      unindexed_.push_back(position_and_ranges.first);
+    }
+    std::sort(unindexed_.begin(), unindexed_.end());
+  } else {
+    source_ips_ = std::make_unique<Network::LcTrie::LcTrie<uint32_t>>(source_ip_ranges_);
+  }
+  source_ip_ranges_.clear();
+}
+
+void PolicyIndex::lookup(const PositionsByValue& positions_by_value, absl::string_view value,
+                         std::vector<uint32_t>& candidates) {
+  const auto it = positions_by_value.find(value);
+  if (it != positions_by_value.end()) {
+    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+  }
+}
+
+std::vector<uint32_t> PolicyIndex::candidates(const Network::Connection& connection,
+                                              const Envoy::Http::HeaderMap& headers) const {
+  std::vector<uint32_t> candidates;
+  // Header rules use the first value of a header, see HeaderUtility::matchHeaders().
+  for (const auto& header : headers_) {
+    const Http::HeaderEntry* entry = headers.get(header.first);
+    if (entry != nullptr) {
+      lookup(header.second, entry->value().getStringView(), candidates);
+    }
+  }
+  if (!server_names_.empty()) {
+    lookup(server_names_, connection.requestedServerName(), candidates);
+  }
+  // The principal names are matched as in AuthenticatedMatcher::matches().
+  const auto& ssl = connection.ssl();
+  if (!principal_names_.empty() && ssl) {
+    for (const std::string& uri : ssl->uriSanPeerCertificate()) {
+      lookup(principal_names_, uri, candidates);
+    }
+    for (const std::string& dns : ssl->dnsSansPeerCertificate()) {
+      lookup(principal_names_, dns, candidates);
+    }
+    lookup(principal_names_, ssl->subjectPeerCertificate(), candidates);
+  }
+  if (source_ips_ != nullptr && connection.remoteAddress()->ip() != nullptr) {
+    const std::vector<uint32_t>& positions = source_ips_->getData(connection.remoteAddress());
+    candidates.insert(candidates.end(), positions.begin(), positions.end());
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  return candidates;
+}
 
 RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     const envoy::config::rbac::v3alpha::RBAC& rules)
-    : allowed_if_matched_(rules.action() == envoy::config::rbac::v3alpha::RBAC::ALLOW) {
+    : allowed_if_matched_(rules.action() == envoy::config::rbac::v3alpha::RBAC::ALLOW),
+      id_(nextEngineId()) {
   // guard expression builder by presence of a condition in policies
   for (const auto& policy : rules.policies()) {
     if (policy.second.has_condition()) {
@@ -21,9 +309,18 @@ RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     }
   }
 
+  std::map<std::string, const envoy::config::rbac::v3alpha::Policy*> sorted_policies;
   for (const auto& policy : rules.policies()) {
-    policies_.emplace(policy.first, std::make_unique<PolicyMatcher>(policy.second, builder_.get()));
+    sorted_policies.emplace(policy.first, &policy.second);
+  }
+  policies_.reserve(sorted_policies.size());
+  for (const auto& policy : sorted_policies) {
+    connection_only_ = connection_only_ && connectionOnly(*policy.second);
+    policy_index_.addPolicy(policies_.size(), *policy.second);
+    policies_.emplace_back(policy.first,
+                           std::make_unique<PolicyMatcher>(*policy.second, builder_.get()));
   }
+  policy_index_.finalize();
 }
 
 bool RoleBasedAccessControlEngineImpl::allowed(const Network::Connection& connection,
@@ -32,7 +329,21 @@ bool RoleBasedAccessControlEngineImpl::allowed(const Network::Connection& connec
                                                std::string* effective_policy_id) const {
   bool matched = false;
 
-  for (const auto& policy : policies_) {
+  // Evaluate the policies which may match in their order, merging the candidates of the index
+  // with the policies it can not skip.
+  const std::vector<uint32_t> candidates = policy_index_.candidates(connection, headers);
+  const std::vector<uint32_t>& unindexed = policy_index_.unindexed();
+  auto candidate = candidates.begin();
+  auto other = unindexed.begin();
+  while (candidate != candidates.end() || other != unindexed.end()) {
+    uint32_t position;
+    if (other == unindexed.end() || (candidate != candidates.end() && *candidate < *other)) {
+      position = *candidate++;
+    } else {
+      position = *other++;
+    }
+
+    const auto& policy = policies_[position];
     if (policy.second->matches(connection, headers, info)) {
       matched = true;
       if (effective_policy_id != nullptr) {
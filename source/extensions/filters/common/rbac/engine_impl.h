@@ -1,16 +1,89 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "envoy/config/rbac/v3alpha/rbac.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/network/connection.h"
+
+#include "common/network/cidr_range.h"
+#include "common/network/lc_trie.h"
 
 #include "extensions/filters/common/rbac/engine.h"
 #include "extensions/filters/common/rbac/matchers.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace RBAC {
 
+/**
+ * Index of the exact match rules of the policies of an engine, used to find the policies which may
+ * match a request or a connection without evaluating all of them. A policy is indexed by a set of
+ * exact header, requested server name or principal name matches and source CIDR ranges, at least
+ * one of which is required for either its permissions or its principals to match. The policies
+ * without such a set can not be skipped and are always evaluated.
+ */
+class PolicyIndex {
+public:
+  /**
+   * Add a policy to the index.
+   * @param position supplies the position of the policy in the evaluation order. Policies must be
+   *        added in increasing positions.
+   * @param policy supplies the config of the policy.
+   */
+  void addPolicy(uint32_t position, const envoy::config::rbac::v3alpha::Policy& policy);
+
+  /**
+   * Build the lookup structures once all the policies have been added.
+   */
+  void finalize();
+
+  /**
+   * @return the sorted positions of the indexed policies which may match the connection and the
+   *         headers.
+   */
+  std::vector<uint32_t> candidates(const Network::Connection& connection,
+                                   const Envoy::Http::HeaderMap& headers) const;
+
+  /**
+   * @return the sorted positions of the policies which are not indexed.
+   */
+  const std::vector<uint32_t>& unindexed() const { return unindexed_; }
+
+private:
+  using PositionsByValue = absl::flat_hash_map<std::string, std::vector<uint32_t>>;
+
+  // The exact match rules of a policy, one of which is required for it to match.
+  struct Keys {
+    std::vector<std::pair<std::string, std::string>> headers_;
+    std::vector<std::string> server_names_;
+    std::vector<std::string> principal_names_;
+    std::vector<Network::Address::CidrRange> source_ips_;
+  };
+
+  static bool collectKeys(const envoy::config::rbac::v3alpha::Permission& permission, Keys& keys);
+  static bool collectKeys(const envoy::config::rbac::v3alpha::Principal& principal, Keys& keys);
+  static bool collectHeaderKey(const envoy::config::route::v3alpha::HeaderMatcher& header,
+                               Keys& keys);
+  static void lookup(const PositionsByValue& positions_by_value, absl::string_view value,
+                     std::vector<uint32_t>& candidates);
+
+  std::vector<uint32_t> unindexed_;
+  // The header names are few, so they are looked up one by one in the request headers.
+  std::vector<std::pair<Http::LowerCaseString, PositionsByValue>> headers_;
+  PositionsByValue server_names_;
+  PositionsByValue principal_names_;
+  std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>> source_ip_ranges_;
+  std::unique_ptr<Network::LcTrie::LcTrie<uint32_t>> source_ips_;
+};
+
 class RoleBasedAccessControlEngineImpl : public RoleBasedAccessControlEngine, NonCopyable {
 public:
   RoleBasedAccessControlEngineImpl(const envoy::config::rbac::v3alpha::RBAC& rules);
@@ -21,10 +94,27 @@ public:
   bool allowed(const Network::Connection& connection, const StreamInfo::StreamInfo& info,
                std::string* effective_policy_id) const override;
 
+  /**
+   * @return whether the decisions of the engine only depend on attributes of the connection which
+   *         do not change over its lifetime, i.e. its addresses, requested server name and peer
+   *         certificate. Such decisions can be reused for all the requests of a connection.
+   */
+  bool connectionOnly() const { return connection_only_; }
+
+  /**
+   * @return an id which is unique to this engine for the lifetime of the process, used to key the
+   *         decisions cached on connections.
+   */
+  uint64_t id() const { return id_; }
+
 private:
   const bool allowed_if_matched_;
+  const uint64_t id_;
+  bool connection_only_{true};
 
-  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies_;
+  // The policies in the order of their names, which is the order they are evaluated in.
+  std::vector<std::pair<std::string, std::unique_ptr<PolicyMatcher>>> policies_;
+  PolicyIndex policy_index_;
 
   Protobuf::Arena constant_arena_;
   Expr::BuilderPtr builder_;
@@ -4,6 +4,9 @@
 
 #include "common/common/assert.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -82,18 +85,55 @@ bool AndMatcher::matches(const Network::Connection& connection,
   return true;
 }
 
-OrMatcher::OrMatcher(
-    const Protobuf::RepeatedPtrField<envoy::config::rbac::v3alpha::Permission>& rules) {
+namespace {
+
+const envoy::config::route::v3alpha::HeaderMatcher*
+headerOf(const envoy::config::rbac::v3alpha::Permission& permission) {
+  return permission.rule_case() == envoy::config::rbac::v3alpha::Permission::RuleCase::kHeader
+             ? &permission.header()
+             : nullptr;
+}
+
+const envoy::config::route::v3alpha::HeaderMatcher*
+headerOf(const envoy::config::rbac::v3alpha::Principal& principal) {
+  return principal.identifier_case() ==
+                 envoy::config::rbac::v3alpha::Principal::IdentifierCase::kHeader
+             ? &principal.header()
+             : nullptr;
+}
+
+// Creates the matchers of an OR of rules. The values of a header matched by several rules are
+// gathered in a single matcher, in the position of the first of them, which doesn't change the
+// result of the OR.
+template <class Rules>
+void createOrMatchers(const Rules& rules, std::vector<MatcherConstSharedPtr>& matchers) {
+  absl::flat_hash_map<std::string, std::shared_ptr<HeaderValuesMatcher>> header_values;
   for (const auto& rule : rules) {
-    matchers_.push_back(Matcher::create(rule));
+    const envoy::config::route::v3alpha::HeaderMatcher* header = headerOf(rule);
+    if (header == nullptr || !HeaderValuesMatcher::canAdd(*header)) {
+      matchers.push_back(Matcher::create(rule));
+      continue;
+    }
+    const std::string name = Envoy::Http::LowerCaseString(header->name()).get();
+    std::shared_ptr<HeaderValuesMatcher>& values = header_values[name];
+    if (values == nullptr) {
+      values = std::make_shared<HeaderValuesMatcher>(name);
+      matchers.push_back(values);
+    }
+    values->add(*header);
   }
 }
 
+} // namespace
+
+OrMatcher::OrMatcher(
+    const Protobuf::RepeatedPtrField<envoy::config::rbac::v3alpha::Permission>& rules) {
+  createOrMatchers(rules, matchers_);
+}
+
 OrMatcher::OrMatcher(
     const Protobuf::RepeatedPtrField<envoy::config::rbac::v3alpha::Principal>& ids) {
-  for (const auto& id : ids) {
-    matchers_.push_back(Matcher::create(id));
-  }
+  createOrMatchers(ids, matchers_);
 }
 
 bool OrMatcher::matches(const Network::Connection& connection,
@@ -119,6 +159,63 @@ bool HeaderMatcher::matches(const Network::Connection&, const Envoy::Http::Heade
   return Envoy::Http::HeaderUtility::matchHeaders(headers, header_);
 }
 
+bool HeaderValuesMatcher::canAdd(const envoy::config::route::v3alpha::HeaderMatcher& matcher) {
+  if (matcher.invert_match()) {
+    return false;
+  }
+  switch (matcher.header_match_specifier_case()) {
+  case envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch:
+    // An empty exact value matches any present header.
+    return !matcher.exact_match().empty();
+  case envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kPrefixMatch:
+  case envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kSuffixMatch:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void HeaderValuesMatcher::add(const envoy::config::route::v3alpha::HeaderMatcher& matcher) {
+  ASSERT(canAdd(matcher));
+  switch (matcher.header_match_specifier_case()) {
+  case envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch:
+    exact_values_.insert(matcher.exact_match());
+    break;
+  case envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kPrefixMatch:
+    prefixes_.push_back(matcher.prefix_match());
+    break;
+  case envoy::config::route::v3alpha::HeaderMatcher::HeaderMatchSpecifierCase::kSuffixMatch:
+    suffixes_.push_back(matcher.suffix_match());
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+bool HeaderValuesMatcher::matches(const Network::Connection&,
+                                  const Envoy::Http::HeaderMap& headers,
+                                  const StreamInfo::StreamInfo&) const {
+  const Envoy::Http::HeaderEntry* header = headers.get(name_);
+  if (header == nullptr) {
+    return false;
+  }
+  const absl::string_view value = header->value().getStringView();
+  if (exact_values_.contains(value)) {
+    return true;
+  }
+  for (const std::string& prefix : prefixes_) {
+    if (absl::StartsWith(value, prefix)) {
+      return true;
+    }
+  }
+  for (const std::string& suffix : suffixes_) {
+    if (absl::EndsWith(value, suffix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool IPMatcher::matches(const Network::Connection& connection, const Envoy::Http::HeaderMap&,
                         const StreamInfo::StreamInfo&) const {
   const Envoy::Network::Address::InstanceConstSharedPtr& ip =
@@ -172,7 +269,7 @@ bool PolicyMatcher::matches(const Network::Connection& connection,
                             const StreamInfo::StreamInfo& info) const {
   return permissions_.matches(connection, headers, info) &&
          principals_.matches(connection, headers, info) &&
-         (expr_ == nullptr ? true : Expr::matches(*expr_, info, headers));
+         (expr_ == nullptr ? true : Expr::matches(*expr_, attributes_, info, headers));
 }
 
 bool RequestedServerNameMatcher::matches(const Network::Connection& connection,
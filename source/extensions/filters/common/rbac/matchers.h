@@ -15,6 +15,8 @@
 
 #include "extensions/filters/common/expr/evaluator.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -129,6 +131,33 @@ private:
   const Envoy::Http::HeaderUtility::HeaderData header_;
 };
 
+/**
+ * Perform a match against any of the exact, prefix and suffix values of a single header. The header
+ * is looked up once per match and its exact values are looked up in a hash set, so that an OR of
+ * many values of a header costs about as much as a single one.
+ */
+class HeaderValuesMatcher : public Matcher {
+public:
+  HeaderValuesMatcher(const std::string& name) : name_(name) {}
+
+  /**
+   * @return bool whether a header matcher is a non inverted exact, prefix or suffix match, which
+   *         can be added to the values of its header.
+   */
+  static bool canAdd(const envoy::config::route::v3alpha::HeaderMatcher& matcher);
+
+  void add(const envoy::config::route::v3alpha::HeaderMatcher& matcher);
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::HeaderMap& headers,
+               const StreamInfo::StreamInfo&) const override;
+
+private:
+  const Envoy::Http::LowerCaseString name_;
+  absl::flat_hash_set<std::string> exact_values_;
+  std::vector<std::string> prefixes_;
+  std::vector<std::string> suffixes_;
+};
+
 /**
  * Perform a match against an IP CIDR range. This rule can be applied to either the source
  * (remote) or the destination (local) IP.
@@ -190,6 +219,7 @@ public:
         condition_(policy.condition()) {
     if (policy.has_condition()) {
       expr_ = Expr::createExpression(*builder, condition_);
+      attributes_ = Expr::referencedAttributes(condition_);
     }
   }
 
@@ -202,6 +232,7 @@ private:
 
   const google::api::expr::v1alpha1::Expr condition_;
   Expr::ExpressionPtr expr_;
+  Expr::ReferencedAttributes attributes_;
 };
 
 class MetadataMatcher : public Matcher {
@@ -8,6 +8,7 @@
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.h"
 
 #include "common/common/assert.h"
+#include "common/http/utility.h"
 #include "common/protobuf/utility.h"
 
 #include "extensions/filters/http/adaptive_concurrency/concurrency_controller/concurrency_controller.h"
@@ -27,7 +28,7 @@ AdaptiveConcurrencyFilterConfig::AdaptiveConcurrencyFilterConfig(
 
 AdaptiveConcurrencyFilter::AdaptiveConcurrencyFilter(
     AdaptiveConcurrencyFilterConfigSharedPtr config, ConcurrencyControllerSharedPtr controller)
-    : config_(std::move(config)), controller_(std::move(controller)) {}
+    : config_(std::move(config)), default_controller_(std::move(controller)) {}
 
 Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::HeaderMap&, bool) {
   // In addition to not sampling if the filter is disabled, health checks should also not be sampled
@@ -37,6 +38,11 @@ Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::HeaderM
     return Http::FilterHeadersStatus::Continue;
   }
 
+  const auto* route_config =
+      Http::Utility::resolveMostSpecificPerFilterConfig<AdaptiveConcurrencyRouteConfig>(
+          HttpFilterNames::get().AdaptiveConcurrency, decoder_callbacks_->route());
+  controller_ = route_config != nullptr ? route_config->controller() : default_controller_;
+
   if (controller_->forwardingDecision() == ConcurrencyController::RequestForwardingAction::Block) {
     decoder_callbacks_->sendLocalReply(Http::Code::ServiceUnavailable, "", nullptr, absl::nullopt,
                                        "reached concurrency limit");
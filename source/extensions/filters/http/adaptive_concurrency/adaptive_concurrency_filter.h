@@ -7,7 +7,9 @@
 #include "envoy/common/time.h"
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/router/router.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 
@@ -47,6 +49,28 @@ using AdaptiveConcurrencyFilterConfigSharedPtr =
 using ConcurrencyControllerSharedPtr =
     std::shared_ptr<ConcurrencyController::ConcurrencyController>;
 
+/**
+ * Per-route configuration of the adaptive concurrency limit filter, referring to the concurrency
+ * controller of the route.
+ */
+class AdaptiveConcurrencyRouteConfig : public Router::RouteSpecificFilterConfig {
+public:
+  /**
+   * @param controller supplies the controller of the route.
+   * @param controller_registry supplies the registry the controller comes from, if any, which is
+   *        kept as long as a route configuration may look the controller up again in it.
+   */
+  explicit AdaptiveConcurrencyRouteConfig(ConcurrencyControllerSharedPtr controller,
+                                          Singleton::InstanceSharedPtr controller_registry = {})
+      : controller_(std::move(controller)), controller_registry_(std::move(controller_registry)) {}
+
+  const ConcurrencyControllerSharedPtr& controller() const { return controller_; }
+
+private:
+  const ConcurrencyControllerSharedPtr controller_;
+  const Singleton::InstanceSharedPtr controller_registry_;
+};
+
 /**
  * A filter that samples request latencies and dynamically adjusts the request
  * concurrency window.
@@ -66,7 +90,11 @@ public:
 
 private:
   AdaptiveConcurrencyFilterConfigSharedPtr config_;
-  const ConcurrencyControllerSharedPtr controller_;
+  // The controller of the filter, used by the routes without a controller of their own.
+  const ConcurrencyControllerSharedPtr default_controller_;
+  // The controller which made the forwarding decision of the request. A reference is held, as the
+  // route configuration owning it may be updated while the request is in flight.
+  ConcurrencyControllerSharedPtr controller_;
   std::unique_ptr<Cleanup> deferred_sample_task_;
 };
 
@@ -42,15 +42,44 @@ GradientControllerConfig::GradientControllerConfig(
       min_concurrency_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.min_rtt_calc_params(), min_concurrency, 3)),
       min_rtt_buffer_pct_(
-          PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(proto_config.min_rtt_calc_params(), buffer, 25)) {}
+          PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(proto_config.min_rtt_calc_params(), buffer, 25)),
+      sample_rate_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(proto_config, sample_rate, 100)) {}
+
+void GradientController::WorkerSamples::record(uint64_t window, uint32_t latency_usec) {
+  WindowSamples& samples = samples_[window % samples_.size()];
+  if (samples.window_ != window) {
+    // These are the samples of an older window, which were dropped rather than merged.
+    hist_clear(samples.histogram_.get());
+    samples.window_ = window;
+  }
+  hist_insert(samples.histogram_.get(), latency_usec, 1);
+}
+
+void GradientController::WorkerSamples::merge(uint64_t window, histogram_t* target) {
+  WindowSamples& samples = samples_[window % samples_.size()];
+  if (samples.window_ != window) {
+    // No sample was recorded by this worker during the window.
+    return;
+  }
+  histogram_t* histogram = samples.histogram_.get();
+  hist_accumulate(target, &histogram, 1);
+  hist_clear(histogram);
+}
+
 GradientController::GradientController(GradientControllerConfig config,
                                        Event::Dispatcher& dispatcher, Runtime::Loader&,
                                        const std::string& stats_prefix, Stats::Scope& scope,
-                                       Runtime::RandomGenerator& random)
+                                       Runtime::RandomGenerator& random,
+                                       ThreadLocal::SlotAllocator& tls)
     : config_(std::move(config)), dispatcher_(dispatcher), scope_(scope),
       stats_(generateStats(scope_, stats_prefix)), random_(random), deferred_limit_value_(1),
       num_rq_outstanding_(0), concurrency_limit_(config_.minConcurrency()),
-      latency_sample_hist_(hist_fast_alloc(), hist_free) {
+      latency_sample_hist_(hist_fast_alloc(), hist_free), tls_(tls.allocateSlot()),
+      merged_samples_(std::make_shared<MergedSamples>()), sample_window_(0) {
+  tls_->set([](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<WorkerSamples>();
+  });
+
   min_rtt_calc_timer_ = dispatcher_.createTimer([this]() -> void { enterMinRTTSamplingWindow(); });
 
   sample_reset_timer_ = dispatcher_.createTimer([this]() -> void {
@@ -61,12 +90,7 @@ GradientController::GradientController(GradientControllerConfig config,
       return;
     }
 
-    {
-      absl::MutexLock ml(&sample_mutation_mtx_);
-      resetSampleWindow();
-    }
-
-    sample_reset_timer_->enableTimer(config_.sampleRTTCalcInterval());
+    mergeSampleWindow();
   });
 
   enterMinRTTSamplingWindow();
@@ -80,6 +104,46 @@ GradientControllerStats GradientController::generateStats(Stats::Scope& scope,
                                         POOL_GAUGE_PREFIX(scope, stats_prefix))};
 }
 
+void GradientController::mergeSampleWindow() {
+  // The workers record the samples of the next window while the samples of this one are merged.
+  const uint64_t window = sample_window_++;
+
+  // The merge completes on the main thread once all the workers merged their samples, which may
+  // happen after the controller is destroyed.
+  std::weak_ptr<GradientController> weak_this = shared_from_this();
+  tls_->runOnAllThreads(
+      [window, merged_samples = merged_samples_](ThreadLocal::ThreadLocalObjectSharedPtr object)
+          -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        absl::MutexLock ml(&merged_samples->mutex_);
+        dynamic_cast<WorkerSamples&>(*object).merge(window, merged_samples->histogram_.get());
+        return object;
+      },
+      [weak_this]() -> void {
+        GradientControllerSharedPtr controller = weak_this.lock();
+        if (controller != nullptr) {
+          controller->onSampleWindowMerged();
+        }
+      });
+}
+
+void GradientController::onSampleWindowMerged() {
+  if (inMinRTTSamplingWindow()) {
+    // The minRTT sampling window started while the samples were merged, so they may not represent
+    // the latencies once the minRTT is updated. The sample reset timer is enabled again as part of
+    // the minRTT calculation.
+    absl::MutexLock ml(&merged_samples_->mutex_);
+    hist_clear(merged_samples_->histogram_.get());
+    return;
+  }
+
+  {
+    absl::MutexLock ml(&sample_mutation_mtx_);
+    resetSampleWindow();
+  }
+
+  sample_reset_timer_->enableTimer(config_.sampleRTTCalcInterval());
+}
+
 void GradientController::enterMinRTTSamplingWindow() {
   absl::MutexLock ml(&sample_mutation_mtx_);
 
@@ -92,8 +156,9 @@ void GradientController::enterMinRTTSamplingWindow() {
   updateConcurrencyLimit(config_.minConcurrency());
 
   // Throw away any latency samples from before the recalculation window as it may not represent
-  // the minRTT.
+  // the minRTT, including the ones the workers recorded for the sampleRTT calculation window.
   hist_clear(latency_sample_hist_.get());
+  ++sample_window_;
 }
 
 void GradientController::updateMinRTT() {
@@ -101,12 +166,14 @@ void GradientController::updateMinRTT() {
 
   {
     absl::MutexLock ml(&sample_mutation_mtx_);
-    min_rtt_ = processLatencySamplesAndClear();
+    min_rtt_ = processLatencySamplesAndClear(latency_sample_hist_.get());
     stats_.min_rtt_msecs_.set(
         std::chrono::duration_cast<std::chrono::milliseconds>(min_rtt_).count());
     updateConcurrencyLimit(deferred_limit_value_.load());
     deferred_limit_value_.store(0);
     stats_.min_rtt_calculation_active_.set(0);
+    // The samples the workers recorded during the minRTT calculation window are not used.
+    ++sample_window_;
   }
 
   min_rtt_calc_timer_->enableTimer(
@@ -128,21 +195,23 @@ void GradientController::resetSampleWindow() {
   // The sampling window must not be reset while sampling for the new minRTT value.
   ASSERT(!inMinRTTSamplingWindow());
 
-  if (hist_sample_count(latency_sample_hist_.get()) == 0) {
+  absl::MutexLock ml(&merged_samples_->mutex_);
+  if (hist_sample_count(merged_samples_->histogram_.get()) == 0) {
     return;
   }
 
-  sample_rtt_ = processLatencySamplesAndClear();
+  sample_rtt_ = processLatencySamplesAndClear(merged_samples_->histogram_.get());
   stats_.sample_rtt_msecs_.set(
       std::chrono::duration_cast<std::chrono::milliseconds>(sample_rtt_).count());
   updateConcurrencyLimit(calculateNewLimit());
 }
 
-std::chrono::microseconds GradientController::processLatencySamplesAndClear() {
+std::chrono::microseconds
+GradientController::processLatencySamplesAndClear(histogram_t* histogram) const {
   const std::array<double, 1> quantile{config_.sampleAggregatePercentile()};
   std::array<double, 1> calculated_quantile;
-  hist_approx_quantile(latency_sample_hist_.get(), quantile.data(), 1, calculated_quantile.data());
-  hist_clear(latency_sample_hist_.get());
+  hist_approx_quantile(histogram, quantile.data(), 1, calculated_quantile.data());
+  hist_clear(histogram);
   return std::chrono::microseconds(static_cast<int>(calculated_quantile[0]));
 }
 
@@ -189,6 +258,15 @@ void GradientController::recordLatencySample(std::chrono::nanoseconds rq_latency
   ASSERT(num_rq_outstanding_.load() > 0);
   --num_rq_outstanding_;
 
+  if (!inMinRTTSamplingWindow()) {
+    // The samples of the sampleRTT calculation window are recorded without locking, and merged
+    // when the window is closed.
+    if (sampled()) {
+      tls_->getTyped<WorkerSamples>().record(sample_window_.load(), latency_usec);
+    }
+    return;
+  }
+
   uint32_t sample_count;
   {
     absl::MutexLock ml(&sample_mutation_mtx_);
@@ -196,13 +274,19 @@ void GradientController::recordLatencySample(std::chrono::nanoseconds rq_latency
     sample_count = hist_sample_count(latency_sample_hist_.get());
   }
 
-  if (inMinRTTSamplingWindow() && sample_count >= config_.minRTTAggregateRequestCount()) {
+  if (sample_count >= config_.minRTTAggregateRequestCount()) {
     // This sample has pushed the request count over the request count requirement for the minRTT
     // recalculation. It must now be finished.
     updateMinRTT();
   }
 }
 
+bool GradientController::sampled() const {
+  const double sample_rate = config_.sampleRate();
+  // The random number generation is saved when all the requests are sampled.
+  return sample_rate >= 1.0 || random_.random() % 10000 < sample_rate * 10000;
+}
+
 void GradientController::cancelLatencySample() {
   ASSERT(num_rq_outstanding_.load() > 0);
   --num_rq_outstanding_;
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "extensions/filters/http/adaptive_concurrency/concurrency_controller/concurrency_controller.h"
 
@@ -93,6 +97,13 @@ public:
     return std::max(0.0, std::min(val, 100.0)) / 100.0;
   }
 
+  // The percentage is normalized to the range [0.0, 1.0].
+  double sampleRate() const {
+    const double val =
+        runtime_.snapshot().getDouble(RuntimeKeys::get().SampleRateKey, sample_rate_);
+    return std::max(0.0, std::min(val, 100.0)) / 100.0;
+  }
+
 private:
   class RuntimeKeyValues {
   public:
@@ -111,6 +122,7 @@ private:
         "adaptive_concurrency.gradient_controller.min_concurrency";
     const std::string MinRTTBufferPercentKey =
         "adaptive_concurrency.gradient_controller.min_rtt_buffer";
+    const std::string SampleRateKey = "adaptive_concurrency.gradient_controller.sample_rate";
   };
 
   using RuntimeKeys = ConstSingleton<RuntimeKeyValues>;
@@ -140,6 +152,9 @@ private:
 
   // The amount added to the measured minRTT as a hedge against natural variability in latency.
   const double min_rtt_buffer_pct_;
+
+  // The percentage of the requests sampled outside of the minRTT calculation window.
+  const double sample_rate_;
 };
 using GradientControllerConfigSharedPtr = std::shared_ptr<GradientControllerConfig>;
 
@@ -204,12 +219,20 @@ using GradientControllerConfigSharedPtr = std::shared_ptr<GradientControllerConf
  * prevent the overlap of these windows. It is necessary for a worker thread to know specifically if
  * the controller is inside of a minRTT recalculation window during the recording of a latency
  * sample, so this extra bit of information is stored in inMinRTTSamplingWindow().
+ *
+ * The minRTT samples are few, as the concurrency is pinned to min_concurrency while they are
+ * taken, so they are recorded into the shared histogram under the mutex. The samples of the
+ * sampleRTT calculation window are recorded by each worker into its own thread local histograms
+ * without locking, and only merged by the workers once per window, when the sample reset timer
+ * fires. Each worker alternates between 2 histograms, so that the samples of the next window can be
+ * recorded while the ones of the closed window wait to be merged.
  */
-class GradientController : public ConcurrencyController {
+class GradientController : public ConcurrencyController,
+                           public std::enable_shared_from_this<GradientController> {
 public:
   GradientController(GradientControllerConfig config, Event::Dispatcher& dispatcher,
                      Runtime::Loader& runtime, const std::string& stats_prefix, Stats::Scope& scope,
-                     Runtime::RandomGenerator& random);
+                     Runtime::RandomGenerator& random, ThreadLocal::SlotAllocator& tls);
 
   // ConcurrencyController.
   RequestForwardingAction forwardingDecision() override;
@@ -218,11 +241,47 @@ public:
   uint32_t concurrencyLimit() const override { return concurrency_limit_.load(); }
 
 private:
+  using HistogramPtr = std::unique_ptr<histogram_t, decltype(&hist_free)>;
+
+  /**
+   * The sampleRTT calculation window samples of a worker.
+   */
+  class WorkerSamples : public ThreadLocal::ThreadLocalObject {
+  public:
+    void record(uint64_t window, uint32_t latency_usec);
+    void merge(uint64_t window, histogram_t* target);
+
+  private:
+    struct WindowSamples {
+      WindowSamples() : histogram_(hist_fast_alloc(), hist_free) {}
+
+      uint64_t window_{};
+      HistogramPtr histogram_;
+    };
+
+    // Indexed by the parity of the window.
+    std::array<WindowSamples, 2> samples_;
+  };
+
+  /**
+   * The histogram the workers merge their samples into, shared with the merge callbacks which may
+   * outlive the controller.
+   */
+  struct MergedSamples {
+    MergedSamples() : histogram_(hist_fast_alloc(), hist_free) {}
+
+    absl::Mutex mutex_;
+    HistogramPtr histogram_ ABSL_GUARDED_BY(mutex_);
+  };
+  using MergedSamplesSharedPtr = std::shared_ptr<MergedSamples>;
+
   static GradientControllerStats generateStats(Stats::Scope& scope,
                                                const std::string& stats_prefix);
+  void mergeSampleWindow();
+  void onSampleWindowMerged();
+  bool sampled() const;
   void updateMinRTT();
-  std::chrono::microseconds processLatencySamplesAndClear()
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
+  std::chrono::microseconds processLatencySamplesAndClear(histogram_t* histogram) const;
   uint32_t calculateNewLimit() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   void enterMinRTTSamplingWindow();
   bool inMinRTTSamplingWindow() const { return deferred_limit_value_.load() > 0; }
@@ -265,10 +324,17 @@ private:
   // make the forwarding decision without locking.
   std::atomic<uint32_t> concurrency_limit_;
 
-  // Stores all sampled latencies and provides percentile estimations when using the sampled data to
-  // calculate a new concurrency limit.
-  std::unique_ptr<histogram_t, decltype(&hist_free)>
-      latency_sample_hist_ ABSL_GUARDED_BY(sample_mutation_mtx_);
+  // Stores the latencies sampled during the minRTT calculation window and provides percentile
+  // estimations when using the sampled data to calculate the minRTT.
+  HistogramPtr latency_sample_hist_ ABSL_GUARDED_BY(sample_mutation_mtx_);
+
+  // The sampleRTT calculation window samples, recorded first in the histograms of the workers.
+  ThreadLocal::SlotPtr tls_;
+  const MergedSamplesSharedPtr merged_samples_;
+
+  // Identifies the sampleRTT calculation window the workers record their samples for. Bumped as
+  // each window is closed, and as a minRTT calculation window starts or ends.
+  std::atomic<uint64_t> sample_window_;
 
   Event::TimerPtr min_rtt_calc_timer_;
   Event::TimerPtr sample_reset_timer_;
@@ -3,6 +3,9 @@
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.h"
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.validate.h"
 #include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
+
+#include "common/protobuf/protobuf.h"
 
 #include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
 #include "extensions/filters/http/adaptive_concurrency/concurrency_controller/gradient_controller.h"
@@ -12,6 +15,39 @@ namespace Extensions {
 namespace HttpFilters {
 namespace AdaptiveConcurrency {
 
+SINGLETON_MANAGER_REGISTRATION(adaptive_concurrency_route_controller_registry);
+
+ConcurrencyControllerSharedPtr RouteControllerRegistry::getOrCreate(
+    const envoy::extensions::filters::http::adaptive_concurrency::v3alpha::
+        AdaptiveConcurrencyPerRoute& proto_config,
+    Server::Configuration::ServerFactoryContext& context) {
+  ActiveController& active_controller = controllers_[proto_config.stat_prefix()];
+  ConcurrencyControllerSharedPtr controller = active_controller.controller_.lock();
+  if (controller != nullptr &&
+      Protobuf::util::MessageDifferencer::Equivalent(proto_config, active_controller.config_)) {
+    return controller;
+  }
+
+  using Proto =
+      envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrencyPerRoute;
+  ASSERT(proto_config.concurrency_controller_config_case() ==
+         Proto::ConcurrencyControllerConfigCase::kGradientControllerConfig);
+  Event::Dispatcher& main_thread_dispatcher = context.dispatcher();
+  controller = ConcurrencyControllerSharedPtr(
+      new ConcurrencyController::GradientController(
+          ConcurrencyController::GradientControllerConfig(
+              proto_config.gradient_controller_config(), context.runtime()),
+          main_thread_dispatcher, context.runtime(),
+          "adaptive_concurrency." + proto_config.stat_prefix() + ".gradient_controller.",
+          context.scope(), context.random(), context.threadLocal()),
+      [&main_thread_dispatcher](ConcurrencyController::ConcurrencyController* controller) {
+        // The last reference may be dropped by a worker, at the end of a request.
+        main_thread_dispatcher.post([controller]() { delete controller; });
+      });
+  active_controller = {proto_config, controller};
+  return controller;
+}
+
 Http::FilterFactoryCb AdaptiveConcurrencyFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrency&
         config,
@@ -28,7 +64,8 @@ Http::FilterFactoryCb AdaptiveConcurrencyFilterFactory::createFilterFactoryFromP
       config.gradient_controller_config(), context.runtime());
   controller = std::make_shared<ConcurrencyController::GradientController>(
       std::move(gradient_controller_config), context.dispatcher(), context.runtime(),
-      acc_stats_prefix + "gradient_controller.", context.scope(), context.random());
+      acc_stats_prefix + "gradient_controller.", context.scope(), context.random(),
+      context.threadLocal());
 
   AdaptiveConcurrencyFilterConfigSharedPtr filter_config(
       new AdaptiveConcurrencyFilterConfig(config, context.runtime(), std::move(acc_stats_prefix),
@@ -40,6 +77,21 @@ Http::FilterFactoryCb AdaptiveConcurrencyFilterFactory::createFilterFactoryFromP
   };
 }
 
+Router::RouteSpecificFilterConfigConstSharedPtr
+AdaptiveConcurrencyFilterFactory::createRouteSpecificFilterConfigTyped(
+    const envoy::extensions::filters::http::adaptive_concurrency::v3alpha::
+        AdaptiveConcurrencyPerRoute& proto_config,
+    Server::Configuration::ServerFactoryContext& context, ProtobufMessage::ValidationVisitor&) {
+  // The route configuration only refers to the controller, which is kept by the registry for the
+  // next route configuration with the same per-route configuration.
+  auto registry = context.singletonManager().getTyped<RouteControllerRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(adaptive_concurrency_route_controller_registry),
+      [] { return std::make_shared<RouteControllerRegistry>(); });
+  ConcurrencyControllerSharedPtr controller = registry->getOrCreate(proto_config, context);
+  return std::make_shared<const AdaptiveConcurrencyRouteConfig>(std::move(controller),
+                                                                std::move(registry));
+}
+
 /**
  * Static registration for the adaptive_concurrency filter. @see RegisterFactory.
  */
@@ -2,21 +2,55 @@
 
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.h"
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.validate.h"
+#include "envoy/singleton/instance.h"
 
+#include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
 #include "extensions/filters/http/common/factory_base.h"
 #include "extensions/filters/http/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace AdaptiveConcurrency {
 
+/**
+ * The concurrency controllers of the routes, by stat prefix. The route configurations with the
+ * same per-route configuration share a controller, so that it keeps its minRTT and concurrency
+ * limit across updates of the route configuration. Only used on the main thread, which creates the
+ * route configurations.
+ */
+class RouteControllerRegistry : public Singleton::Instance {
+public:
+  /**
+   * @return the controller of the given per-route configuration, which is created if there is
+   *         none. The controller is deleted on the main thread once the last route configuration
+   *         or request using it is gone, as its timers and thread local slot belong to that thread.
+   */
+  ConcurrencyControllerSharedPtr
+  getOrCreate(const envoy::extensions::filters::http::adaptive_concurrency::v3alpha::
+                  AdaptiveConcurrencyPerRoute& proto_config,
+              Server::Configuration::ServerFactoryContext& context);
+
+private:
+  struct ActiveController {
+    envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrencyPerRoute
+        config_;
+    std::weak_ptr<ConcurrencyController::ConcurrencyController> controller_;
+  };
+
+  absl::flat_hash_map<std::string, ActiveController> controllers_;
+};
+
 /**
  * Config registration for the adaptive concurrency limit filter. @see NamedHttpFilterConfigFactory.
  */
 class AdaptiveConcurrencyFilterFactory
     : public Common::FactoryBase<
-          envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrency> {
+          envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrency,
+          envoy::extensions::filters::http::adaptive_concurrency::v3alpha::
+              AdaptiveConcurrencyPerRoute> {
 public:
   AdaptiveConcurrencyFilterFactory() : FactoryBase(HttpFilterNames::get().AdaptiveConcurrency) {}
 
@@ -24,6 +58,12 @@ public:
       const envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrency&
           proto_config,
       const std::string& stats_prefix, Server::Configuration::FactoryContext& context) override;
+
+  Router::RouteSpecificFilterConfigConstSharedPtr createRouteSpecificFilterConfigTyped(
+      const envoy::extensions::filters::http::adaptive_concurrency::v3alpha::
+          AdaptiveConcurrencyPerRoute& proto_config,
+      Server::Configuration::ServerFactoryContext& context,
+      ProtobufMessage::ValidationVisitor& validator) override;
 };
 
 } // namespace AdaptiveConcurrency
@@ -0,0 +1,203 @@
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+#include "extensions/filters/http/cache/in_memory_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+constexpr uint64_t DefaultMaxSizeBytes = 64 * 1024 * 1024;
+constexpr uint64_t DefaultMaxEntryBytes = 1024 * 1024;
+constexpr uint32_t DefaultShardCount = 16;
+
+} // namespace
+
+CacheFilterConfig::CacheFilterConfig(
+    const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+    const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source)
+    : stats_prefix_(stats_prefix + "cache."),
+      stats_{ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix_))},
+      cache_(std::make_shared<InMemoryCache>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.in_memory(), max_size_bytes, DefaultMaxSizeBytes),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.in_memory(), max_entry_bytes,
+                                          DefaultMaxEntryBytes),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.in_memory(), shard_count, DefaultShardCount),
+          stats_prefix_ + "in_memory.", scope)),
+      coalescer_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, coalesce_requests, true)
+                     ? std::make_unique<Http::RequestCoalescer>()
+                     : nullptr),
+      time_source_(time_source) {}
+
+void CacheFilter::onDestroy() {
+  if (state_ == State::WaitingForFill) {
+    config_->coalescer()->leave(key_, *this);
+  }
+  state_ = State::Done;
+  // The waiters of an incomplete response are forwarded upstream themselves.
+  abortInsert();
+}
+
+Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::HeaderMap& headers, bool end_stream) {
+  const RequestCacheability cacheability =
+      CacheHeadersUtils::requestCacheability(headers, end_stream);
+  if (!cacheability.lookup_ && !cacheability.insert_) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  key_ = CacheHeadersUtils::cacheKey(headers);
+  insertable_ = cacheability.insert_;
+  if (cacheability.lookup_) {
+    if (serveFromCache()) {
+      return Http::FilterHeadersStatus::StopIteration;
+    }
+    config_->stats().miss_.inc();
+
+    Http::RequestCoalescer* coalescer = config_->coalescer();
+    if (coalescer != nullptr && insertable_) {
+      filler_ = coalescer->join(key_, shared_from_this(), decoder_callbacks_->dispatcher());
+      if (!filler_) {
+        ENVOY_STREAM_LOG(debug, "cache: waiting for a concurrent request for {}",
+                         *decoder_callbacks_, key_);
+        config_->stats().coalesced_.inc();
+        state_ = State::WaitingForFill;
+        return Http::FilterHeadersStatus::StopIteration;
+      }
+    }
+  }
+
+  state_ = State::Forwarded;
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::HeaderMap& headers, bool end_stream) {
+  if (state_ != State::Forwarded) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  absl::optional<std::chrono::seconds> freshness_lifetime;
+  if (insertable_) {
+    response_time_ = config_->timeSource().systemTime();
+    freshness_lifetime = CacheHeadersUtils::freshnessLifetime(headers);
+    initial_age_ = CacheHeadersUtils::initialAge(headers, response_time_);
+  }
+  if (!freshness_lifetime.has_value() || freshness_lifetime.value() <= initial_age_) {
+    config_->stats().not_cacheable_.inc();
+    abortInsert();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  freshness_lifetime_ = freshness_lifetime.value();
+  insert_headers_ = std::make_unique<Http::HeaderMapImpl>(headers);
+  if (insert_headers_->byteSize() > config_->cache().maxEntryBytes()) {
+    config_->stats().not_cacheable_.inc();
+    abortInsert();
+  } else if (end_stream) {
+    finishInsert();
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (insert_headers_ == nullptr) {
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (insert_headers_->byteSize() + insert_body_.size() + data.length() >
+      config_->cache().maxEntryBytes()) {
+    config_->stats().not_cacheable_.inc();
+    abortInsert();
+  } else {
+    insert_body_.append(data.toString());
+    if (end_stream) {
+      finishInsert();
+    }
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::HeaderMap&) {
+  // Trailers are not cached.
+  if (insert_headers_ != nullptr) {
+    config_->stats().not_cacheable_.inc();
+    abortInsert();
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
+void CacheFilter::onLeaderComplete(Http::CoalescedResponseConstSharedPtr) {
+  if (state_ != State::WaitingForFill) {
+    return;
+  }
+  if (serveFromCache()) {
+    return;
+  }
+  // The response has not been cached, e.g. because it is not cacheable or the filler has been
+  // reset, so the request is forwarded after all.
+  state_ = State::Forwarded;
+  decoder_callbacks_->continueDecoding();
+}
+
+bool CacheFilter::serveFromCache() {
+  const SystemTime now = config_->timeSource().systemTime();
+  const CachedResponseConstSharedPtr response = config_->cache().lookup(key_, now);
+  if (response == nullptr) {
+    return false;
+  }
+
+  ENVOY_STREAM_LOG(debug, "cache: serving {} from the cache", *decoder_callbacks_, key_);
+  config_->stats().hit_.inc();
+  state_ = State::Done;
+  auto headers = std::make_unique<Http::HeaderMapImpl>(*response->headers_);
+  headers->setCopy(CacheHeaders::get().Age, std::to_string(response->age(now).count()));
+  const bool end_stream = response->body_.empty();
+  decoder_callbacks_->encodeHeaders(std::move(headers), end_stream);
+  if (!end_stream) {
+    // The fragment holds a reference to the response until the body has been written, so that the
+    // body is not copied even if the response is evicted in the meantime.
+    Buffer::OwnedImpl body;
+    body.addBufferFragment(*new Buffer::BufferFragmentImpl(
+        response->body_.data(), response->body_.size(),
+        [response](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+          delete fragment;
+        }));
+    decoder_callbacks_->encodeData(body, true);
+  }
+  return true;
+}
+
+void CacheFilter::finishInsert() {
+  config_->cache().insert(key_, std::make_shared<const CachedResponse>(
+                                    std::move(insert_headers_), std::move(insert_body_),
+                                    response_time_, initial_age_, freshness_lifetime_));
+  config_->stats().insert_.inc();
+  insert_headers_.reset();
+  insert_body_.clear();
+  completeFill();
+}
+
+void CacheFilter::abortInsert() {
+  insert_headers_.reset();
+  insert_body_.clear();
+  completeFill();
+}
+
+void CacheFilter::completeFill() {
+  if (filler_) {
+    filler_ = false;
+    // The waiters look the response up in the cache rather than share it.
+    config_->coalescer()->complete(key_, nullptr);
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
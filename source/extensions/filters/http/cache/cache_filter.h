@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+#include "common/http/request_coalescer.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All cache filter stats. @see stats_macros.h
+ */
+#define ALL_CACHE_FILTER_STATS(COUNTER)                                                            \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(coalesced)                                                                               \
+  COUNTER(insert)                                                                                  \
+  COUNTER(not_cacheable)
+
+/**
+ * Struct definition for the cache filter stats. @see stats_macros.h
+ */
+struct CacheFilterStats {
+  ALL_CACHE_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Configuration for the cache filter, shared by the filters of all the worker threads.
+ */
+class CacheFilterConfig {
+public:
+  CacheFilterConfig(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+                    const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source);
+
+  HttpCache& cache() { return *cache_; }
+  // nullptr if the concurrent misses are not coalesced.
+  Http::RequestCoalescer* coalescer() { return coalescer_.get(); }
+  CacheFilterStats& stats() { return stats_; }
+  TimeSource& timeSource() { return time_source_; }
+
+private:
+  const std::string stats_prefix_;
+  CacheFilterStats stats_;
+  HttpCacheSharedPtr cache_;
+  // Shared by the workers, as the cache is.
+  Http::RequestCoalescerPtr coalescer_;
+  TimeSource& time_source_;
+};
+
+using CacheFilterConfigSharedPtr = std::shared_ptr<CacheFilterConfig>;
+
+/**
+ * A filter serving the cacheable GET responses from a cache shared by all the worker threads.
+ * Cached bodies are served without being copied.
+ */
+class CacheFilter : public Http::PassThroughFilter,
+                    public Http::CoalescedRequest,
+                    public std::enable_shared_from_this<CacheFilter>,
+                    Logger::Loggable<Logger::Id::filter> {
+public:
+  CacheFilter(const CacheFilterConfigSharedPtr& config) : config_(config) {}
+
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap& trailers) override;
+
+  // Http::CoalescedRequest
+  void onLeaderComplete(Http::CoalescedResponseConstSharedPtr response) override;
+
+private:
+  enum class State {
+    // The request is not handled by the cache.
+    Bypass,
+    // The request waits for a concurrent request for the same response.
+    WaitingForFill,
+    // The request has been forwarded upstream after a miss.
+    Forwarded,
+    // The request has been served from the cache, or the stream is over.
+    Done
+  };
+
+  bool serveFromCache();
+  void finishInsert();
+  void abortInsert();
+  void completeFill();
+
+  const CacheFilterConfigSharedPtr config_;
+  State state_{State::Bypass};
+  std::string key_;
+  // Whether the response may be inserted in the cache.
+  bool insertable_{};
+  // Whether this request is the filler of its response, i.e. the leader of the requests coalesced
+  // into it, see Http::RequestCoalescer.
+  bool filler_{};
+  // The response being inserted.
+  Http::HeaderMapPtr insert_headers_;
+  std::string insert_body_;
+  SystemTime response_time_;
+  std::chrono::seconds initial_age_{};
+  std::chrono::seconds freshness_lifetime_{};
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
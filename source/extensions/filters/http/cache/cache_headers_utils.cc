@@ -0,0 +1,196 @@
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+
+#include <algorithm>
+
+#include "common/common/utility.h"
+#include "common/http/headers.h"
+#include "common/http/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/time.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+std::chrono::seconds parseDeltaSeconds(absl::string_view value) {
+  uint64_t seconds;
+  if (!absl::SimpleAtoi(value, &seconds)) {
+    return std::chrono::seconds(0);
+  }
+  // RFC 7234 section 1.2.1: delta-seconds which do not fit are read as 2^31.
+  return std::chrono::seconds(std::min<uint64_t>(seconds, 1U << 31));
+}
+
+// The response codes which are cacheable by default, see RFC 7231 section 6.1. Partial content is
+// not supported.
+bool cacheableStatus(uint64_t status) {
+  switch (status) {
+  case 200:
+  case 203:
+  case 204:
+  case 300:
+  case 301:
+  case 404:
+  case 405:
+  case 410:
+  case 414:
+  case 501:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+CacheControl CacheHeadersUtils::parseCacheControl(absl::string_view value) {
+  CacheControl cache_control;
+  for (absl::string_view directive : absl::StrSplit(value, ',', absl::SkipWhitespace())) {
+    const std::pair<absl::string_view, absl::string_view> name_and_argument =
+        absl::StrSplit(StringUtil::trim(directive), absl::MaxSplits('=', 1));
+    const std::string name = absl::AsciiStrToLower(StringUtil::trim(name_and_argument.first));
+    absl::string_view argument = StringUtil::trim(name_and_argument.second);
+    if (argument.size() >= 2 && argument.front() == '"' && argument.back() == '"') {
+      argument = argument.substr(1, argument.size() - 2);
+    }
+
+    // The field-name arguments of no-cache and private are not supported, they apply to the whole
+    // response as if they were absent.
+    if (name == "no-store") {
+      cache_control.no_store_ = true;
+    } else if (name == "no-cache") {
+      cache_control.no_cache_ = true;
+    } else if (name == "private") {
+      cache_control.private_ = true;
+    } else if (name == "max-age") {
+      cache_control.max_age_ = parseDeltaSeconds(argument);
+    } else if (name == "s-maxage") {
+      cache_control.s_maxage_ = parseDeltaSeconds(argument);
+    }
+  }
+  return cache_control;
+}
+
+absl::optional<SystemTime> CacheHeadersUtils::parseHttpTime(absl::string_view value) {
+  absl::Time time;
+  std::string error;
+  if (!absl::ParseTime("%a, %d %b %Y %H:%M:%S GMT", std::string(value), absl::UTCTimeZone(), &time,
+                       &error)) {
+    return absl::nullopt;
+  }
+  return absl::ToChronoTime(time);
+}
+
+RequestCacheability CacheHeadersUtils::requestCacheability(const Http::HeaderMap& request_headers,
+                                                           bool end_stream) {
+  if (!end_stream || request_headers.Method() == nullptr ||
+      request_headers.Method()->value() != Http::Headers::get().MethodValues.Get ||
+      request_headers.Host() == nullptr || request_headers.Path() == nullptr ||
+      request_headers.Authorization() != nullptr ||
+      request_headers.get(CacheHeaders::get().Range) != nullptr) {
+    return {};
+  }
+
+  CacheControl cache_control;
+  if (request_headers.CacheControl() != nullptr) {
+    cache_control = parseCacheControl(request_headers.CacheControl()->value().getStringView());
+  } else {
+    // RFC 7234 section 5.4: Pragma is only considered in the absence of Cache-Control.
+    const Http::HeaderEntry* pragma = request_headers.get(CacheHeaders::get().Pragma);
+    cache_control.no_cache_ =
+        pragma != nullptr && StringUtil::findToken(pragma->value().getStringView(), ",",
+                                                   Http::Headers::get().CacheControlValues.NoCache);
+  }
+
+  RequestCacheability cacheability;
+  cacheability.lookup_ =
+      !cache_control.no_store_ && !cache_control.no_cache_ &&
+      !(cache_control.max_age_.has_value() && cache_control.max_age_->count() == 0);
+  cacheability.insert_ = !cache_control.no_store_;
+  return cacheability;
+}
+
+absl::optional<std::chrono::seconds>
+CacheHeadersUtils::freshnessLifetime(const Http::HeaderMap& response_headers) {
+  if (!cacheableStatus(Http::Utility::getResponseStatus(response_headers))) {
+    return absl::nullopt;
+  }
+  // Secondary cache keys are not supported.
+  if (response_headers.Vary() != nullptr && !response_headers.Vary()->value().empty()) {
+    return absl::nullopt;
+  }
+
+  CacheControl cache_control;
+  if (response_headers.CacheControl() != nullptr) {
+    cache_control = parseCacheControl(response_headers.CacheControl()->value().getStringView());
+  }
+  // Responses which must be revalidated before being served are not cached, as the cache does not
+  // revalidate.
+  if (cache_control.no_store_ || cache_control.no_cache_ || cache_control.private_) {
+    return absl::nullopt;
+  }
+
+  if (cache_control.s_maxage_.has_value()) {
+    return cache_control.s_maxage_;
+  }
+  if (cache_control.max_age_.has_value()) {
+    return cache_control.max_age_;
+  }
+  const Http::HeaderEntry* expires = response_headers.get(CacheHeaders::get().Expires);
+  if (expires == nullptr || response_headers.Date() == nullptr) {
+    // Heuristic freshness is not supported.
+    return absl::nullopt;
+  }
+  const absl::optional<SystemTime> date =
+      parseHttpTime(response_headers.Date()->value().getStringView());
+  if (!date.has_value()) {
+    return absl::nullopt;
+  }
+  // RFC 7234 section 5.3: an invalid Expires date represents a time in the past.
+  const absl::optional<SystemTime> expiration = parseHttpTime(expires->value().getStringView());
+  if (!expiration.has_value() || expiration.value() <= date.value()) {
+    return std::chrono::seconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::seconds>(expiration.value() - date.value());
+}
+
+std::chrono::seconds CacheHeadersUtils::initialAge(const Http::HeaderMap& response_headers,
+                                                   SystemTime response_time) {
+  std::chrono::seconds age_value(0);
+  const Http::HeaderEntry* age = response_headers.get(CacheHeaders::get().Age);
+  if (age != nullptr) {
+    age_value = parseDeltaSeconds(age->value().getStringView());
+  }
+
+  std::chrono::seconds apparent_age(0);
+  if (response_headers.Date() != nullptr) {
+    const absl::optional<SystemTime> date =
+        parseHttpTime(response_headers.Date()->value().getStringView());
+    if (date.has_value() && response_time > date.value()) {
+      apparent_age = std::chrono::duration_cast<std::chrono::seconds>(response_time - date.value());
+    }
+  }
+  return std::max(age_value, apparent_age);
+}
+
+std::string CacheHeadersUtils::cacheKey(const Http::HeaderMap& request_headers) {
+  absl::string_view scheme = Http::Headers::get().SchemeValues.Http;
+  if (request_headers.ForwardedProto() != nullptr) {
+    scheme = request_headers.ForwardedProto()->value().getStringView();
+  }
+  return absl::StrCat(scheme, "://",
+                      absl::AsciiStrToLower(request_headers.Host()->value().getStringView()),
+                      request_headers.Path()->value().getStringView());
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/http/header_map.h"
+
+#include "common/singleton/const_singleton.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class CacheHeaderValues {
+public:
+  const Http::LowerCaseString Age{"age"};
+  const Http::LowerCaseString Expires{"expires"};
+  const Http::LowerCaseString Pragma{"pragma"};
+  const Http::LowerCaseString Range{"range"};
+};
+
+using CacheHeaders = ConstSingleton<CacheHeaderValues>;
+
+/**
+ * The Cache-Control directives which matter to a shared cache, see RFC 7234 section 5.2.
+ */
+struct CacheControl {
+  bool no_store_{};
+  bool no_cache_{};
+  bool private_{};
+  absl::optional<std::chrono::seconds> max_age_;
+  absl::optional<std::chrono::seconds> s_maxage_;
+};
+
+/**
+ * How a request can be served by the cache.
+ */
+struct RequestCacheability {
+  // Whether a cached response can be served to the request.
+  bool lookup_{};
+  // Whether the response to the request can be cached.
+  bool insert_{};
+};
+
+/**
+ * The caching rules of RFC 7234 which are supported by the cache filter. Responses are only cached
+ * with an explicit freshness lifetime, and stale responses are not revalidated but fetched again.
+ */
+class CacheHeadersUtils {
+public:
+  /**
+   * Parse the value of a Cache-Control header. Unknown directives are ignored. An invalid max-age
+   * or s-maxage argument is read as 0, so that the response is considered stale.
+   */
+  static CacheControl parseCacheControl(absl::string_view value);
+
+  /**
+   * Parse an HTTP-date in the preferred IMF-fixdate format, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+   * @return the parsed time, or absl::nullopt if the value is not a valid date.
+   */
+  static absl::optional<SystemTime> parseHttpTime(absl::string_view value);
+
+  /**
+   * @return how the cache can handle the request. Only GET requests without a body, credentials or
+   *         range can be served by the cache.
+   */
+  static RequestCacheability requestCacheability(const Http::HeaderMap& request_headers,
+                                                 bool end_stream);
+
+  /**
+   * @return the freshness lifetime of a response, see RFC 7234 section 4.2.1, or absl::nullopt if
+   *         the response can not be stored by a shared cache.
+   */
+  static absl::optional<std::chrono::seconds>
+  freshnessLifetime(const Http::HeaderMap& response_headers);
+
+  /**
+   * @return the age of a response at the time it was received, see RFC 7234 section 4.2.3. The
+   *         request is assumed to have been sent at the time its response was received.
+   */
+  static std::chrono::seconds initialAge(const Http::HeaderMap& response_headers,
+                                         SystemTime response_time);
+
+  /**
+   * @return the key of the responses to the request, made of its scheme, authority and path.
+   */
+  static std::string cacheKey(const Http::HeaderMap& request_headers);
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,33 @@
+#include "extensions/filters/http/cache/config.h"
+
+#include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
+#include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  // The cache is owned by the filter configuration, so that it is shared by all the workers.
+  CacheFilterConfigSharedPtr config = std::make_shared<CacheFilterConfig>(
+      proto_config, stats_prefix, context.scope(), context.timeSource());
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<CacheFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the cache filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(CacheFilterFactory, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
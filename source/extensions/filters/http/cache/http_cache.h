@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/http/header_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * A response stored in a cache. A cached response is immutable, so that it can be shared by the
+ * requests of all the worker threads and its body served without being copied.
+ */
+struct CachedResponse {
+  CachedResponse(Http::HeaderMapPtr&& headers, std::string&& body, SystemTime response_time,
+                 std::chrono::seconds initial_age, std::chrono::seconds freshness_lifetime)
+      : headers_(std::move(headers)), body_(std::move(body)), response_time_(response_time),
+        initial_age_(initial_age),
+        expiration_time_(response_time + freshness_lifetime - initial_age) {}
+
+  /**
+   * @return the age of the response at the given time, see RFC 7234 section 4.2.3.
+   */
+  std::chrono::seconds age(SystemTime now) const {
+    return initial_age_ + std::chrono::duration_cast<std::chrono::seconds>(now - response_time_);
+  }
+
+  /**
+   * @return the number of bytes of the response.
+   */
+  uint64_t byteSize() const { return headers_->byteSize() + body_.size(); }
+
+  const Http::HeaderMapPtr headers_;
+  const std::string body_;
+  // The time at which the response was received from upstream.
+  const SystemTime response_time_;
+  // The age of the response when it was received.
+  const std::chrono::seconds initial_age_;
+  // The time from which the response is stale.
+  const SystemTime expiration_time_;
+};
+
+using CachedResponseConstSharedPtr = std::shared_ptr<const CachedResponse>;
+
+/**
+ * The storage of an HTTP cache. A storage is shared by the filters of all the worker threads, so
+ * that its methods may be called concurrently.
+ */
+class HttpCache {
+public:
+  virtual ~HttpCache() = default;
+
+  /**
+   * @param key supplies the key of the response.
+   * @param now supplies the current time.
+   * @return the response stored under the key if it is still fresh, nullptr otherwise.
+   */
+  virtual CachedResponseConstSharedPtr lookup(const std::string& key, SystemTime now) PURE;
+
+  /**
+   * Store a response, replacing the response stored under the same key if any. The storage may
+   * drop the response, or evict it at any time.
+   * @param key supplies the key of the response.
+   * @param response supplies the response.
+   */
+  virtual void insert(const std::string& key, CachedResponseConstSharedPtr&& response) PURE;
+
+  /**
+   * @return the size of the largest response which can be stored, so that the filter can give up
+   *         on inserting a larger response without buffering all of it.
+   */
+  virtual uint64_t maxEntryBytes() const PURE;
+};
+
+using HttpCacheSharedPtr = std::shared_ptr<HttpCache>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
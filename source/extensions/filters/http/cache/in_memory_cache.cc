@@ -0,0 +1,81 @@
+#include "extensions/filters/http/cache/in_memory_cache.h"
+
+#include "common/common/hash.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+InMemoryCache::InMemoryCache(uint64_t max_size_bytes, uint64_t max_entry_bytes,
+                             uint32_t shard_count, const std::string& stats_prefix,
+                             Stats::Scope& scope)
+    : max_entry_bytes_(max_entry_bytes), max_shard_bytes_(max_size_bytes / shard_count),
+      stats_{ALL_IN_MEMORY_CACHE_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix),
+                                       POOL_GAUGE_PREFIX(scope, stats_prefix))} {
+  ASSERT(shard_count > 0);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; i++) {
+    shards_.emplace_back(std::make_unique<Shard>());
+  }
+}
+
+CachedResponseConstSharedPtr InMemoryCache::lookup(const std::string& key, SystemTime now) {
+  Shard& shard = this->shard(key);
+  Thread::LockGuard lock(shard.lock_);
+  auto it = shard.index_.find(key);
+  if (it == shard.index_.end()) {
+    return nullptr;
+  }
+  EntryList::iterator entry = it->second;
+  if (now >= entry->response_->expiration_time_) {
+    // A stale response is fetched again, and replaced once the new one is inserted. It is dropped
+    // right away so that it does not take space in the meantime.
+    remove(shard, entry);
+    return nullptr;
+  }
+  shard.entries_.splice(shard.entries_.begin(), shard.entries_, entry);
+  return entry->response_;
+}
+
+void InMemoryCache::insert(const std::string& key, CachedResponseConstSharedPtr&& response) {
+  const uint64_t byte_size = key.size() + response->byteSize();
+  if (byte_size > max_entry_bytes_ || byte_size > max_shard_bytes_) {
+    return;
+  }
+
+  Shard& shard = this->shard(key);
+  Thread::LockGuard lock(shard.lock_);
+  auto it = shard.index_.find(key);
+  if (it != shard.index_.end()) {
+    remove(shard, it->second);
+  }
+  while (shard.size_bytes_ + byte_size > max_shard_bytes_) {
+    remove(shard, std::prev(shard.entries_.end()));
+    stats_.eviction_.inc();
+  }
+
+  shard.entries_.emplace_front(key, std::move(response));
+  shard.index_.emplace(shard.entries_.front().key_, shard.entries_.begin());
+  shard.size_bytes_ += byte_size;
+  stats_.entries_.inc();
+  stats_.size_bytes_.add(byte_size);
+}
+
+InMemoryCache::Shard& InMemoryCache::shard(const std::string& key) {
+  return *shards_[HashUtil::xxHash64(key) % shards_.size()];
+}
+
+void InMemoryCache::remove(Shard& shard, EntryList::iterator entry) {
+  shard.size_bytes_ -= entry->byte_size_;
+  stats_.entries_.dec();
+  stats_.size_bytes_.sub(entry->byte_size_);
+  shard.index_.erase(entry->key_);
+  shard.entries_.erase(entry);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/thread.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All in-memory cache stats. @see stats_macros.h
+ */
+#define ALL_IN_MEMORY_CACHE_STATS(COUNTER, GAUGE)                                                  \
+  COUNTER(eviction)                                                                                \
+  GAUGE(entries, Accumulate)                                                                       \
+  GAUGE(size_bytes, Accumulate)
+
+/**
+ * Struct definition for the in-memory cache stats. @see stats_macros.h
+ */
+struct InMemoryCacheStats {
+  ALL_IN_MEMORY_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A cache storage holding the responses in memory, shared by all the worker threads. The storage
+ * is split in shards which are locked independently, each of them evicting its least recently
+ * used responses once over its share of the size budget.
+ */
+class InMemoryCache : public HttpCache {
+public:
+  InMemoryCache(uint64_t max_size_bytes, uint64_t max_entry_bytes, uint32_t shard_count,
+                const std::string& stats_prefix, Stats::Scope& scope);
+
+  // HttpCache
+  CachedResponseConstSharedPtr lookup(const std::string& key, SystemTime now) override;
+  void insert(const std::string& key, CachedResponseConstSharedPtr&& response) override;
+  uint64_t maxEntryBytes() const override { return max_entry_bytes_; }
+
+private:
+  struct Entry {
+    Entry(const std::string& key, CachedResponseConstSharedPtr&& response)
+        : key_(key), response_(std::move(response)),
+          byte_size_(key_.size() + response_->byteSize()) {}
+
+    const std::string key_;
+    const CachedResponseConstSharedPtr response_;
+    const uint64_t byte_size_;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    Thread::MutexBasicLockable lock_;
+    // The entries of the shard, the most recently used first.
+    EntryList entries_ ABSL_GUARDED_BY(lock_);
+    // The entries by key. The keys are views of the keys of the entries, which do not move.
+    absl::flat_hash_map<absl::string_view, EntryList::iterator> index_ ABSL_GUARDED_BY(lock_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(lock_){};
+  };
+
+  Shard& shard(const std::string& key);
+  void remove(Shard& shard, EntryList::iterator entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.lock_);
+
+  const uint64_t max_entry_bytes_;
+  const uint64_t max_shard_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  InMemoryCacheStats stats_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -128,13 +128,7 @@ bool CsrfFilter::isValid(const absl::string_view source_origin, Http::HeaderMap&
     return true;
   }
 
-  for (const auto& additional_origin : policy_->additionalOrigins()) {
-    if (additional_origin->match(source_origin)) {
-      return true;
-    }
-  }
-
-  return false;
+  return policy_->additionalOrigins().match(source_origin);
 }
 
 } // namespace Csrf
@@ -36,12 +36,7 @@ class CsrfPolicy : public Router::RouteSpecificFilterConfig {
 public:
   CsrfPolicy(const envoy::extensions::filters::http::csrf::v3alpha::CsrfPolicy& policy,
              Runtime::Loader& runtime)
-      : policy_(policy), runtime_(runtime) {
-    for (const auto& additional_origin : policy.additional_origins()) {
-      additional_origins_.emplace_back(
-          std::make_unique<Matchers::StringMatcherImpl>(additional_origin));
-    }
-  }
+      : policy_(policy), additional_origins_(policy.additional_origins()), runtime_(runtime) {}
 
   bool enabled() const {
     const envoy::config::core::v3alpha::RuntimeFractionalPercent& filter_enabled =
@@ -60,13 +55,11 @@ public:
                                               shadow_enabled.default_value());
   }
 
-  const std::vector<Matchers::StringMatcherPtr>& additionalOrigins() const {
-    return additional_origins_;
-  };
+  const Matchers::StringMatcher& additionalOrigins() const { return additional_origins_; };
 
 private:
   const envoy::extensions::filters::http::csrf::v3alpha::CsrfPolicy policy_;
-  std::vector<Matchers::StringMatcherPtr> additional_origins_;
+  const Matchers::StringMatcherListImpl additional_origins_;
   Runtime::Loader& runtime_;
 };
 using CsrfPolicyPtr = std::unique_ptr<CsrfPolicy>;
@@ -0,0 +1,32 @@
+#include "extensions/filters/http/decompressor/config.h"
+
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.h"
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/filters/http/decompressor/decompressor_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Decompressor {
+
+Http::FilterFactoryCb DecompressorFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::extensions::filters::http::decompressor::v3alpha::Decompressor& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  DecompressorFilterConfigSharedPtr config =
+      std::make_shared<DecompressorFilterConfig>(proto_config, stats_prefix, context.scope());
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<DecompressorFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the decompressor filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(DecompressorFilterFactory, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace Decompressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,150 @@
+#include "extensions/filters/http/decompressor/decompressor_filter.h"
+
+#include <algorithm>
+
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/utility.h"
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Decompressor {
+
+struct RcDetailsValues {
+  const std::string InvalidRequestBody = "decompressor_invalid_request_body";
+};
+using RcDetails = ConstSingleton<RcDetailsValues>;
+
+namespace {
+// Default size of the decompressed output chunks.
+const uint64_t DefaultChunkSize = 4096;
+
+// Default maximum ratio between the decompressed and the compressed size of a body.
+const uint64_t DefaultMaxRatio = 100;
+
+// Window bits of the zlib format, which deflate encoded bodies use.
+const int64_t DeflateWindowBits = 15;
+
+// When summed to window bits, this makes zlib expect a gzip header and trailer.
+const int64_t GzipHeaderValue = 16;
+
+// The largest ratio deflate achieves, which bounds the output of any input.
+const uint64_t MaxDeflateRatio = 1032;
+} // namespace
+
+DecompressorFilterConfig::DecompressorFilterConfig(
+    const envoy::extensions::filters::http::decompressor::v3alpha::Decompressor& proto_config,
+    const std::string& stats_prefix, Stats::Scope& scope)
+    : decompress_requests_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, decompress_requests, true)),
+      decompress_responses_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, decompress_responses, true)),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, chunk_size, DefaultChunkSize)),
+      max_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, max_ratio, DefaultMaxRatio)),
+      stats_(generateStats(stats_prefix + "decompressor.", scope)) {}
+
+Http::FilterHeadersStatus DecompressorFilter::decodeHeaders(Http::HeaderMap& headers,
+                                                            bool end_stream) {
+  if (!end_stream && config_->decompressRequests() && maybeInitDecompressor(headers, request_)) {
+    config_->stats().request_decompressed_.inc();
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus DecompressorFilter::decodeData(Buffer::Instance& data, bool) {
+  if (request_.decompressor_ == nullptr || decompress(request_, data)) {
+    return Http::FilterDataStatus::Continue;
+  }
+  // Stop decompressing, the rest of the body is dropped along with the stream.
+  request_.decompressor_.reset();
+  decoder_callbacks_->sendLocalReply(Http::Code::BadRequest, "Invalid request body", nullptr,
+                                     absl::nullopt, RcDetails::get().InvalidRequestBody);
+  return Http::FilterDataStatus::StopIterationNoBuffer;
+}
+
+Http::FilterHeadersStatus DecompressorFilter::encodeHeaders(Http::HeaderMap& headers,
+                                                            bool end_stream) {
+  if (!end_stream && config_->decompressResponses() &&
+      maybeInitDecompressor(headers, response_)) {
+    config_->stats().response_decompressed_.inc();
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus DecompressorFilter::encodeData(Buffer::Instance& data, bool) {
+  if (response_.decompressor_ == nullptr || decompress(response_, data)) {
+    return Http::FilterDataStatus::Continue;
+  }
+  // The response headers may already be on their way downstream, so the stream is reset.
+  response_.decompressor_.reset();
+  encoder_callbacks_->resetStream();
+  return Http::FilterDataStatus::StopIterationNoBuffer;
+}
+
+bool DecompressorFilter::maybeInitDecompressor(Http::HeaderMap& headers, BodyDecompressor& body) {
+  const Http::HeaderEntry* content_encoding = headers.ContentEncoding();
+  if (content_encoding == nullptr) {
+    return false;
+  }
+
+  // Only a single encoding is handled, chained encodings are passed through untouched.
+  const absl::string_view encoding = StringUtil::trim(content_encoding->value().getStringView());
+  int64_t window_bits;
+  if (absl::EqualsIgnoreCase(encoding, Http::Headers::get().ContentEncodingValues.Gzip)) {
+    window_bits = DeflateWindowBits | GzipHeaderValue;
+  } else if (absl::EqualsIgnoreCase(encoding,
+                                    Http::Headers::get().ContentEncodingValues.Deflate)) {
+    window_bits = DeflateWindowBits;
+  } else {
+    return false;
+  }
+
+  body.decompressor_ =
+      std::make_unique<Envoy::Decompressor::ZlibDecompressorImpl>(config_->chunkSize());
+  body.decompressor_->init(window_bits);
+  headers.removeContentEncoding();
+  headers.removeContentLength();
+  return true;
+}
+
+bool DecompressorFilter::decompress(BodyDecompressor& body, Buffer::Instance& data) {
+  Buffer::OwnedImpl output;
+  // The ratio is enforced on the totals of the whole body. Each step takes no more input than
+  // can expand into the output the body is still allowed, so that a bomb is caught within a
+  // single byte of input rather than after a whole chunk of it has been inflated.
+  while (data.length() > 0) {
+    const uint64_t allowed_bytes =
+        body.compressed_bytes_ * config_->maxRatio() - body.uncompressed_bytes_;
+    Buffer::OwnedImpl input;
+    input.move(data, std::min({data.length(), config_->chunkSize(),
+                               std::max<uint64_t>(1, allowed_bytes / MaxDeflateRatio)}));
+    const uint64_t output_length = output.length();
+    body.decompressor_->decompress(input, output);
+    body.compressed_bytes_ += input.length();
+    body.uncompressed_bytes_ += output.length() - output_length;
+    config_->stats().total_compressed_bytes_.add(input.length());
+    config_->stats().total_uncompressed_bytes_.add(output.length() - output_length);
+
+    if (body.decompressor_->decompression_error_ < 0) {
+      config_->stats().decompression_error_.inc();
+      return false;
+    }
+    if (body.uncompressed_bytes_ > body.compressed_bytes_ * config_->maxRatio()) {
+      config_->stats().max_ratio_exceeded_.inc();
+      return false;
+    }
+  }
+  data.move(output);
+  return true;
+}
+
+} // namespace Decompressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
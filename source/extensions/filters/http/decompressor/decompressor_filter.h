@@ -0,0 +1,115 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/http/header_map.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/decompressor/zlib_decompressor_impl.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Decompressor {
+
+/**
+ * All decompressor filter stats. @see stats_macros.h
+ * "total_compressed_bytes" and "total_uncompressed_bytes" only include the bodies which were
+ * decompressed, requests and responses alike.
+ */
+#define ALL_DECOMPRESSOR_STATS(COUNTER)                                                            \
+  COUNTER(request_decompressed)                                                                    \
+  COUNTER(response_decompressed)                                                                   \
+  COUNTER(decompression_error)                                                                     \
+  COUNTER(max_ratio_exceeded)                                                                      \
+  COUNTER(total_compressed_bytes)                                                                  \
+  COUNTER(total_uncompressed_bytes)
+
+/**
+ * Struct definition for decompressor stats. @see stats_macros.h
+ */
+struct DecompressorStats {
+  ALL_DECOMPRESSOR_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Configuration for the decompressor filter.
+ */
+class DecompressorFilterConfig {
+public:
+  DecompressorFilterConfig(
+      const envoy::extensions::filters::http::decompressor::v3alpha::Decompressor& proto_config,
+      const std::string& stats_prefix, Stats::Scope& scope);
+
+  bool decompressRequests() const { return decompress_requests_; }
+  bool decompressResponses() const { return decompress_responses_; }
+  uint64_t chunkSize() const { return chunk_size_; }
+  uint64_t maxRatio() const { return max_ratio_; }
+  DecompressorStats& stats() { return stats_; }
+
+private:
+  static DecompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+    return DecompressorStats{ALL_DECOMPRESSOR_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+  }
+
+  const bool decompress_requests_;
+  const bool decompress_responses_;
+  const uint64_t chunk_size_;
+  const uint64_t max_ratio_;
+  DecompressorStats stats_;
+};
+using DecompressorFilterConfigSharedPtr = std::shared_ptr<DecompressorFilterConfig>;
+
+/**
+ * A filter which decompresses the gzip or deflate encoded bodies of the requests and the
+ * responses as they stream through, so that the other filters and the upstreams see plain bodies.
+ */
+class DecompressorFilter : public Http::PassThroughFilter {
+public:
+  DecompressorFilter(const DecompressorFilterConfigSharedPtr& config) : config_(config) {}
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override;
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+
+private:
+  // The decompression state of one direction of the stream.
+  struct BodyDecompressor {
+    std::unique_ptr<Envoy::Decompressor::ZlibDecompressorImpl> decompressor_;
+    uint64_t compressed_bytes_{};
+    uint64_t uncompressed_bytes_{};
+  };
+
+  /**
+   * Set up the decompression of a body if its headers say it is gzip or deflate encoded. The
+   * content-encoding and content-length headers are removed, as they do not describe the
+   * decompressed body.
+   * @return whether the body is decompressed.
+   */
+  bool maybeInitDecompressor(Http::HeaderMap& headers, BodyDecompressor& body);
+
+  /**
+   * Replace the content of the supplied buffer by its decompressed content.
+   * @return false if the data is not valid or exceeds the configured ratio, in which case the
+   *         stream must be failed.
+   */
+  bool decompress(BodyDecompressor& body, Buffer::Instance& data);
+
+  DecompressorFilterConfigSharedPtr config_;
+  BodyDecompressor request_;
+  BodyDecompressor response_;
+};
+
+} // namespace Decompressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
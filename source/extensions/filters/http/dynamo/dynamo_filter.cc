@@ -5,14 +5,11 @@
 #include <string>
 #include <vector>
 
-#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
-#include "common/common/stack_array.h"
 #include "common/http/codes.h"
 #include "common/http/exception.h"
 #include "common/http/utility.h"
-#include "common/json/json_loader.h"
 
 #include "extensions/filters/http/dynamo/dynamo_request_parser.h"
 #include "extensions/filters/http/dynamo/dynamo_stats.h"
@@ -22,138 +19,107 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Dynamo {
 
-Http::FilterHeadersStatus DynamoFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
+Http::FilterHeadersStatus DynamoFilter::decodeHeaders(Http::HeaderMap& headers, bool end_stream) {
   if (enabled_) {
     start_decode_ = time_source_.monotonicTime();
     operation_ = RequestParser::parseOperation(headers);
-    return Http::FilterHeadersStatus::StopIteration;
-  } else {
-    return Http::FilterHeadersStatus::Continue;
+    table_parser_ = std::make_unique<RequestParser::TableParser>(operation_);
+    if (end_stream) {
+      onDecodeComplete();
+    }
   }
+
+  return Http::FilterHeadersStatus::Continue;
 }
 
 Http::FilterDataStatus DynamoFilter::decodeData(Buffer::Instance& data, bool end_stream) {
-  if (enabled_ && end_stream) {
-    onDecodeComplete(data);
+  if (enabled_ && table_parser_ != nullptr) {
+    table_parser_->parse(data);
+    if (end_stream) {
+      onDecodeComplete();
+    }
   }
 
-  if (!enabled_ || end_stream) {
-    return Http::FilterDataStatus::Continue;
-  } else {
-    // Buffer until the complete request has been processed.
-    return Http::FilterDataStatus::StopIterationAndBuffer;
-  }
+  return Http::FilterDataStatus::Continue;
 }
 
 Http::FilterTrailersStatus DynamoFilter::decodeTrailers(Http::HeaderMap&) {
-  if (enabled_) {
-    Buffer::OwnedImpl empty;
-    onDecodeComplete(empty);
+  if (enabled_ && table_parser_ != nullptr) {
+    onDecodeComplete();
   }
 
   return Http::FilterTrailersStatus::Continue;
 }
 
-void DynamoFilter::onDecodeComplete(const Buffer::Instance& data) {
-  std::string body = buildBody(decoder_callbacks_->decodingBuffer(), data);
-  if (!body.empty()) {
-    try {
-      Json::ObjectSharedPtr json_body = Json::Factory::loadFromString(body);
-      table_descriptor_ = RequestParser::parseTable(operation_, *json_body);
-    } catch (const Json::Exception& jsonEx) {
+void DynamoFilter::onDecodeComplete() {
+  if (!table_parser_->empty()) {
+    if (table_parser_->finish()) {
+      table_descriptor_ = table_parser_->table();
+    } else {
       // Body parsing failed. This should not happen, just put a stat for that.
       stats_->counter({stats_->invalid_req_body_}).inc();
     }
   }
+  table_parser_.reset();
 }
 
-void DynamoFilter::onEncodeComplete(const Buffer::Instance& data) {
+void DynamoFilter::onEncodeComplete() {
   ASSERT(enabled_);
-  uint64_t status = Http::Utility::getResponseStatus(*response_headers_);
-  chargeBasicStats(status);
+  chargeBasicStats(status_);
 
-  std::string body = buildBody(encoder_callbacks_->encodingBuffer(), data);
-  if (!body.empty()) {
-    try {
-      Json::ObjectSharedPtr json_body = Json::Factory::loadFromString(body);
-      chargeTablePartitionIdStats(*json_body);
+  if (!response_parser_->empty()) {
+    if (response_parser_->finish()) {
+      chargeTablePartitionIdStats(response_parser_->partitions());
 
-      if (Http::CodeUtility::is4xx(status)) {
-        chargeFailureSpecificStats(*json_body);
+      if (Http::CodeUtility::is4xx(status_)) {
+        chargeFailureSpecificStats(response_parser_->errorType());
       }
       // Batch Operations will always return status 200 for a partial or full success. Check
       // unprocessed keys to determine partial success.
       // http://docs.aws.amazon.com/amazondynamodb/latest/developerguide/Programming.Errors.html#Programming.Errors.BatchOperations
       if (RequestParser::isBatchOperation(operation_)) {
-        chargeUnProcessedKeysStats(*json_body);
+        chargeUnProcessedKeysStats(response_parser_->unprocessedTables());
       }
-    } catch (const Json::Exception&) {
+    } else {
       // Body parsing failed. This should not happen, just put a stat for that.
       stats_->counter({stats_->invalid_resp_body_}).inc();
     }
   }
+  response_parser_.reset();
 }
 
 Http::FilterHeadersStatus DynamoFilter::encodeHeaders(Http::HeaderMap& headers, bool end_stream) {
-  Http::FilterHeadersStatus status = Http::FilterHeadersStatus::Continue;
   if (enabled_) {
-    response_headers_ = &headers;
-
+    status_ = Http::Utility::getResponseStatus(headers);
+    response_parser_ = std::make_unique<RequestParser::ResponseParser>(
+        Http::CodeUtility::is4xx(status_), RequestParser::isBatchOperation(operation_));
     if (end_stream) {
-      Buffer::OwnedImpl empty;
-      onEncodeComplete(empty);
-    } else {
-      status = Http::FilterHeadersStatus::StopIteration;
+      onEncodeComplete();
     }
   }
 
-  return status;
+  return Http::FilterHeadersStatus::Continue;
 }
 
 Http::FilterDataStatus DynamoFilter::encodeData(Buffer::Instance& data, bool end_stream) {
-  if (enabled_ && end_stream) {
-    onEncodeComplete(data);
+  if (enabled_ && response_parser_ != nullptr) {
+    response_parser_->parse(data);
+    if (end_stream) {
+      onEncodeComplete();
+    }
   }
 
-  if (!enabled_ || end_stream) {
-    return Http::FilterDataStatus::Continue;
-  } else {
-    // Buffer until the complete response has been processed.
-    return Http::FilterDataStatus::StopIterationAndBuffer;
-  }
+  return Http::FilterDataStatus::Continue;
 }
 
 Http::FilterTrailersStatus DynamoFilter::encodeTrailers(Http::HeaderMap&) {
-  if (enabled_) {
-    Buffer::OwnedImpl empty;
-    onEncodeComplete(empty);
+  if (enabled_ && response_parser_ != nullptr) {
+    onEncodeComplete();
   }
 
   return Http::FilterTrailersStatus::Continue;
 }
 
-std::string DynamoFilter::buildBody(const Buffer::Instance* buffered,
-                                    const Buffer::Instance& last) {
-  std::string body;
-  if (buffered) {
-    uint64_t num_slices = buffered->getRawSlices(nullptr, 0);
-    STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
-    buffered->getRawSlices(slices.begin(), num_slices);
-    for (const Buffer::RawSlice& slice : slices) {
-      body.append(static_cast<const char*>(slice.mem_), slice.len_);
-    }
-  }
-
-  uint64_t num_slices = last.getRawSlices(nullptr, 0);
-  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
-  last.getRawSlices(slices.begin(), num_slices);
-  for (const Buffer::RawSlice& slice : slices) {
-    body.append(static_cast<const char*>(slice.mem_), slice.len_);
-  }
-
-  return body;
-}
-
 void DynamoFilter::chargeBasicStats(uint64_t status) {
   if (!operation_.empty()) {
     chargeStatsPerEntity(operation_, "operation", status);
@@ -200,10 +166,8 @@ void DynamoFilter::chargeStatsPerEntity(const std::string& entity, const std::st
       .recordValue(latency.count());
 }
 
-void DynamoFilter::chargeUnProcessedKeysStats(const Json::Object& json_body) {
-  // The unprocessed keys block contains a list of tables and keys for that table that did not
-  // complete apart of the batch operation. Only the table names will be logged for errors.
-  std::vector<std::string> unprocessed_tables = RequestParser::parseBatchUnProcessedKeys(json_body);
+void DynamoFilter::chargeUnProcessedKeysStats(
+    const std::vector<std::string>& unprocessed_tables) {
   for (const std::string& unprocessed_table : unprocessed_tables) {
     stats_
         ->counter({stats_->error_, stats_->getDynamic(unprocessed_table),
@@ -212,9 +176,7 @@ void DynamoFilter::chargeUnProcessedKeysStats(const Json::Object& json_body) {
   }
 }
 
-void DynamoFilter::chargeFailureSpecificStats(const Json::Object& json_body) {
-  std::string error_type = RequestParser::parseErrorType(json_body);
-
+void DynamoFilter::chargeFailureSpecificStats(const std::string& error_type) {
   if (!error_type.empty()) {
     if (table_descriptor_.table_name.empty()) {
       stats_->counter({stats_->error_, stats_->no_table_, stats_->getDynamic(error_type)}).inc();
@@ -229,13 +191,12 @@ void DynamoFilter::chargeFailureSpecificStats(const Json::Object& json_body) {
   }
 }
 
-void DynamoFilter::chargeTablePartitionIdStats(const Json::Object& json_body) {
+void DynamoFilter::chargeTablePartitionIdStats(
+    const std::vector<RequestParser::PartitionDescriptor>& partitions) {
   if (table_descriptor_.table_name.empty() || operation_.empty()) {
     return;
   }
 
-  std::vector<RequestParser::PartitionDescriptor> partitions =
-      RequestParser::parsePartitions(json_body);
   for (const RequestParser::PartitionDescriptor& partition : partitions) {
     stats_
         ->buildPartitionStatCounter(table_descriptor_.table_name, operation_,
@@ -1,14 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/http/filter.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 
-#include "common/json/json_loader.h"
-
 #include "extensions/filters/http/dynamo/dynamo_request_parser.h"
 #include "extensions/filters/http/dynamo/dynamo_stats.h"
 
@@ -22,6 +22,8 @@ namespace Dynamo {
  * It captures RPS/latencies:
  *  1) Per table per response code (and group of response codes, e.g., 2xx/3xx/etc)
  *  2) Per operation per response code (and group of response codes, e.g., 2xx/3xx/etc)
+ * Request and response bodies are not buffered: the fields needed for the stats are extracted
+ * from them as they stream through the filter.
  */
 class DynamoFilter : public Http::StreamFilter {
 public:
@@ -56,15 +58,15 @@ public:
   }
 
 private:
-  void onDecodeComplete(const Buffer::Instance& data);
-  void onEncodeComplete(const Buffer::Instance& data);
-  std::string buildBody(const Buffer::Instance* buffered, const Buffer::Instance& last);
+  void onDecodeComplete();
+  void onEncodeComplete();
   void chargeBasicStats(uint64_t status);
   void chargeStatsPerEntity(const std::string& entity, const std::string& entity_type,
                             uint64_t status);
-  void chargeFailureSpecificStats(const Json::Object& json_body);
-  void chargeUnProcessedKeysStats(const Json::Object& json_body);
-  void chargeTablePartitionIdStats(const Json::Object& json_body);
+  void chargeFailureSpecificStats(const std::string& error_type);
+  void chargeUnProcessedKeysStats(const std::vector<std::string>& unprocessed_tables);
+  void chargeTablePartitionIdStats(
+      const std::vector<RequestParser::PartitionDescriptor>& partitions);
 
   Runtime::Loader& runtime_;
   const DynamoStatsSharedPtr stats_;
@@ -72,9 +74,10 @@ private:
   bool enabled_{};
   std::string operation_{};
   RequestParser::TableDescriptor table_descriptor_{"", true};
-  std::string error_type_{};
   MonotonicTime start_decode_;
-  Http::HeaderMap* response_headers_;
+  uint64_t status_{};
+  std::unique_ptr<RequestParser::TableParser> table_parser_;
+  std::unique_ptr<RequestParser::ResponseParser> response_parser_;
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
   Http::StreamEncoderFilterCallbacks* encoder_callbacks_{};
   TimeSource& time_source_;
@@ -8,6 +8,7 @@
 #include "common/common/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -74,78 +75,7 @@ std::string RequestParser::parseOperation(const Http::HeaderMap& header_map) {
   return operation;
 }
 
-RequestParser::TableDescriptor RequestParser::parseTable(const std::string& operation,
-                                                         const Json::Object& json_data) {
-  TableDescriptor table{"", true};
-
-  // Simple operations on a single table, have "TableName" explicitly specified.
-  if (find(SINGLE_TABLE_OPERATIONS.begin(), SINGLE_TABLE_OPERATIONS.end(), operation) !=
-      SINGLE_TABLE_OPERATIONS.end()) {
-    table.table_name = json_data.getString("TableName", "");
-  } else if (find(BATCH_OPERATIONS.begin(), BATCH_OPERATIONS.end(), operation) !=
-             BATCH_OPERATIONS.end()) {
-    Json::ObjectSharedPtr tables = json_data.getObject("RequestItems", true);
-    tables->iterate([&table](const std::string& key, const Json::Object&) {
-      if (table.table_name.empty()) {
-        table.table_name = key;
-      } else {
-        if (table.table_name != key) {
-          table.table_name = "";
-          table.is_single_table = false;
-          return false;
-        }
-      }
-      return true;
-    });
-  } else if (find(TRANSACT_OPERATIONS.begin(), TRANSACT_OPERATIONS.end(), operation) !=
-             TRANSACT_OPERATIONS.end()) {
-    std::vector<Json::ObjectSharedPtr> transact_items =
-        json_data.getObjectArray("TransactItems", true);
-    for (const Json::ObjectSharedPtr& transact_item : transact_items) {
-      const auto next_table_name = getTableNameFromTransactItem(*transact_item);
-      if (!next_table_name.has_value()) {
-        // if an operation is missing a table name, we want to throw the normal set of errors
-        table.table_name = "";
-        table.is_single_table = true;
-        break;
-      }
-      if (table.table_name.empty()) {
-        table.table_name = next_table_name.value();
-      } else if (table.table_name != next_table_name.value()) {
-        table.table_name = "";
-        table.is_single_table = false;
-        break;
-      }
-    }
-  }
-  return table;
-}
-
-absl::optional<std::string>
-RequestParser::getTableNameFromTransactItem(const Json::Object& transact_item) {
-  for (const std::string& operation : TRANSACT_ITEM_OPERATIONS) {
-    Json::ObjectSharedPtr item = transact_item.getObject(operation, true);
-    std::string table_name = item->getString("TableName", "");
-    if (!table_name.empty()) {
-      return absl::make_optional(table_name);
-    }
-  }
-  return absl::nullopt;
-}
-
-std::vector<std::string> RequestParser::parseBatchUnProcessedKeys(const Json::Object& json_data) {
-  std::vector<std::string> unprocessed_tables;
-  Json::ObjectSharedPtr tables = json_data.getObject("UnprocessedKeys", true);
-  tables->iterate([&unprocessed_tables](const std::string& key, const Json::Object&) {
-    unprocessed_tables.emplace_back(key);
-    return true;
-  });
-
-  return unprocessed_tables;
-}
-
-std::string RequestParser::parseErrorType(const Json::Object& json_data) {
-  std::string error_type = json_data.getString("__type", "");
+std::string RequestParser::parseErrorType(absl::string_view error_type) {
   if (error_type.empty()) {
     return "";
   }
@@ -164,26 +94,6 @@ bool RequestParser::isBatchOperation(const std::string& operation) {
          BATCH_OPERATIONS.end();
 }
 
-std::vector<RequestParser::PartitionDescriptor>
-RequestParser::parsePartitions(const Json::Object& json_data) {
-  std::vector<RequestParser::PartitionDescriptor> partition_descriptors;
-
-  Json::ObjectSharedPtr partitions =
-      json_data.getObject("ConsumedCapacity", true)->getObject("Partitions", true);
-  partitions->iterate([&partition_descriptors, &partitions](const std::string& key,
-                                                            const Json::Object&) {
-    // For a given partition id, the amount of capacity used is returned in the body as a double.
-    // A stat will be created to track the capacity consumed for the operation, table and partition.
-    // Stats counter only increments by whole numbers, capacity is round up to the nearest integer
-    // to account for this.
-    uint64_t capacity_integer = static_cast<uint64_t>(std::ceil(partitions->getDouble(key, 0.0)));
-    partition_descriptors.emplace_back(key, capacity_integer);
-    return true;
-  });
-
-  return partition_descriptors;
-}
-
 void RequestParser::forEachStatString(const StringFn& fn) {
   for (const std::string& str : SINGLE_TABLE_OPERATIONS) {
     fn(str);
@@ -202,6 +112,244 @@ void RequestParser::forEachStatString(const StringFn& fn) {
   }
 }
 
+RequestParser::TableParser::TableParser(const std::string& operation) : parser_(*this) {
+  if (find(SINGLE_TABLE_OPERATIONS.begin(), SINGLE_TABLE_OPERATIONS.end(), operation) !=
+      SINGLE_TABLE_OPERATIONS.end()) {
+    operation_ = Operation::SingleTable;
+  } else if (isBatchOperation(operation)) {
+    operation_ = Operation::Batch;
+  } else if (find(TRANSACT_OPERATIONS.begin(), TRANSACT_OPERATIONS.end(), operation) !=
+             TRANSACT_OPERATIONS.end()) {
+    operation_ = Operation::Transact;
+  } else {
+    operation_ = Operation::Other;
+  }
+}
+
+RequestParser::TableParser::Field RequestParser::TableParser::nextField() const {
+  if (fields_.empty()) {
+    return Field::Root;
+  }
+
+  switch (fields_.back()) {
+  case Field::Root:
+    // Simple operations on a single table, have "TableName" explicitly specified.
+    if (operation_ == Operation::SingleTable && key_ == "TableName") {
+      return Field::TableName;
+    } else if (operation_ == Operation::Batch && key_ == "RequestItems") {
+      return Field::RequestItems;
+    } else if (operation_ == Operation::Transact && key_ == "TransactItems") {
+      return Field::TransactItems;
+    }
+    return Field::Other;
+  case Field::TransactItems:
+    return Field::TransactItem;
+  case Field::TransactItem:
+    // The items after the one settling the table descriptor are not looked into.
+    if (!done_ && find(TRANSACT_ITEM_OPERATIONS.begin(), TRANSACT_ITEM_OPERATIONS.end(), key_) !=
+                      TRANSACT_ITEM_OPERATIONS.end()) {
+      return Field::TransactItemOperation;
+    }
+    return Field::Other;
+  case Field::TransactItemOperation:
+    return key_ == "TableName" ? Field::TransactItemTableName : Field::Other;
+  default:
+    return Field::Other;
+  }
+}
+
+RequestParser::TableParser::Field RequestParser::TableParser::startValue(ValueType type) {
+  const Field field = nextField();
+  switch (field) {
+  case Field::Root:
+    // Any value is valid for the operations no table is extracted for.
+    valid_ &= operation_ == Operation::Other || type == ValueType::Object;
+    break;
+  case Field::TableName:
+  case Field::TransactItemTableName:
+    valid_ &= type == ValueType::String;
+    break;
+  case Field::TransactItems:
+    valid_ &= type == ValueType::Array;
+    break;
+  case Field::RequestItems:
+  case Field::TransactItem:
+  case Field::TransactItemOperation:
+    valid_ &= type == ValueType::Object;
+    break;
+  case Field::Other:
+    break;
+  }
+  return field;
+}
+
+void RequestParser::TableParser::onStartObject() {
+  const Field field = startValue(ValueType::Object);
+  if (field == Field::TransactItem) {
+    transact_item_tables_.assign(TRANSACT_ITEM_OPERATIONS.size(), "");
+  } else if (field == Field::TransactItemOperation) {
+    transact_item_operation_ =
+        find(TRANSACT_ITEM_OPERATIONS.begin(), TRANSACT_ITEM_OPERATIONS.end(), key_) -
+        TRANSACT_ITEM_OPERATIONS.begin();
+  }
+  fields_.push_back(field);
+}
+
+void RequestParser::TableParser::onEndObject() {
+  if (fields_.back() == Field::TransactItem) {
+    endTransactItem();
+  }
+  fields_.pop_back();
+}
+
+void RequestParser::TableParser::onStartArray() {
+  fields_.push_back(startValue(ValueType::Array));
+}
+
+void RequestParser::TableParser::onKey(const std::string& key) {
+  switch (fields_.back()) {
+  case Field::RequestItems:
+    // Batch operations have the tables as the keys of "RequestItems".
+    addTable(key);
+    break;
+  case Field::Other:
+    // The keys of the objects which are not of interest do not matter.
+    return;
+  default:
+    break;
+  }
+  key_ = key;
+}
+
+void RequestParser::TableParser::onString(const std::string& value) {
+  switch (startValue(ValueType::String)) {
+  case Field::TableName:
+    table_.table_name = value;
+    break;
+  case Field::TransactItemTableName:
+    transact_item_tables_[transact_item_operation_] = value;
+    break;
+  default:
+    break;
+  }
+}
+
+void RequestParser::TableParser::addTable(const std::string& table_name) {
+  if (done_) {
+    return;
+  }
+
+  if (table_.table_name.empty()) {
+    table_.table_name = table_name;
+  } else if (table_.table_name != table_name) {
+    table_.table_name = "";
+    table_.is_single_table = false;
+    done_ = true;
+  }
+}
+
+void RequestParser::TableParser::endTransactItem() {
+  if (done_) {
+    return;
+  }
+
+  // The table of the item is that of its first operation having one.
+  for (const std::string& table_name : transact_item_tables_) {
+    if (!table_name.empty()) {
+      addTable(table_name);
+      return;
+    }
+  }
+
+  // If an operation is missing a table name, we want to throw the normal set of errors.
+  table_.table_name = "";
+  table_.is_single_table = true;
+  done_ = true;
+}
+
+RequestParser::ResponseParser::Field RequestParser::ResponseParser::nextField() const {
+  if (fields_.empty()) {
+    return Field::Root;
+  }
+
+  switch (fields_.back()) {
+  case Field::Root:
+    if (parse_error_type_ && key_ == "__type") {
+      return Field::ErrorType;
+    } else if (parse_unprocessed_keys_ && key_ == "UnprocessedKeys") {
+      return Field::UnprocessedKeys;
+    } else if (key_ == "ConsumedCapacity") {
+      return Field::ConsumedCapacity;
+    }
+    return Field::Other;
+  case Field::ConsumedCapacity:
+    return key_ == "Partitions" ? Field::Partitions : Field::Other;
+  case Field::Partitions:
+    return Field::Partition;
+  default:
+    return Field::Other;
+  }
+}
+
+RequestParser::ResponseParser::Field RequestParser::ResponseParser::startValue(ValueType type) {
+  const Field field = nextField();
+  switch (field) {
+  case Field::Root:
+  case Field::UnprocessedKeys:
+  case Field::ConsumedCapacity:
+  case Field::Partitions:
+    valid_ &= type == ValueType::Object;
+    break;
+  case Field::ErrorType:
+    valid_ &= type == ValueType::String;
+    break;
+  case Field::Partition:
+    valid_ &= type == ValueType::Number;
+    break;
+  case Field::Other:
+    break;
+  }
+  return field;
+}
+
+void RequestParser::ResponseParser::onKey(const std::string& key) {
+  switch (fields_.back()) {
+  case Field::UnprocessedKeys:
+    // The unprocessed keys block contains a list of tables and keys for that table that did not
+    // complete apart of the batch operation. Only the table names are extracted.
+    unprocessed_tables_.push_back(key);
+    return;
+  case Field::Other:
+    return;
+  default:
+    break;
+  }
+  key_ = key;
+}
+
+void RequestParser::ResponseParser::onString(const std::string& value) {
+  if (startValue(ValueType::String) == Field::ErrorType) {
+    error_type_ = parseErrorType(value);
+  }
+}
+
+void RequestParser::ResponseParser::onNumber(const std::string& value) {
+  if (startValue(ValueType::Number) != Field::Partition) {
+    return;
+  }
+
+  // For a given partition id, the amount of capacity used is returned in the body as a double.
+  // A stat will be created to track the capacity consumed for the operation, table and partition.
+  // Stats counter only increments by whole numbers, capacity is round up to the nearest integer
+  // to account for this.
+  double capacity;
+  if (!absl::SimpleAtod(value, &capacity)) {
+    valid_ = false;
+    return;
+  }
+  partitions_.emplace_back(key_, static_cast<uint64_t>(std::ceil(capacity)));
+}
+
 } // namespace Dynamo
 } // namespace HttpFilters
 } // namespace Extensions
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/http/header_map.h"
 
-#include "common/json/json_loader.h"
+#include "extensions/filters/http/dynamo/json_stream_parser.h"
+
+#include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -40,63 +44,25 @@ public:
    */
   static std::string parseOperation(const Http::HeaderMap& header_map);
 
-  /**
-   * Parse table name out of data, based on the operation.
-   * @return empty string as TableDescriptor.table_name if table name cannot be parsed out of valid
-   *json data
-   * or if operation is not in the list of operations that we support.
-   *
-   * For simple operations on single table, e.g., GetItem, PutItem, Query etc @return table
-   * name in TableDescriptor.table_name.
-   *
-   * For batch operations, e.g. BatchGetItem/BatchWriteItem, @return table name in
-   *TableDescriptor.table_name if it's only one
-   * table used in all operations, @return empty string in TableDescriptor.table_name and
-   *TableDescriptor.is_single_table=false in case of multiple.
-   *
-   * @throw Json::Exception if data is not in valid Json format.
-   */
-  static TableDescriptor parseTable(const std::string& operation, const Json::Object& json_data);
-
-  /**
-   * @return string name of table in transaction object, or empty string if none
-   */
-  static absl::optional<std::string>
-  getTableNameFromTransactItem(const Json::Object& transact_item);
+  class TableParser;
+  class ResponseParser;
 
   /**
    * Parse error details which might be provided for a given response code.
+   * @param error_type supplies the "__type" of the response body.
    * @return empty string if cannot get error details.
    * For the full list of errors, see
    * http://docs.aws.amazon.com/amazondynamodb/latest/APIReference/CommonErrors.html
    * Operation specific errors, for example, error section of
    * http://docs.aws.amazon.com/amazondynamodb/latest/APIReference/API_UpdateItem.html
-   *
-   * @throw Json::Exception if data is not in valid Json format.
-   */
-  static std::string parseErrorType(const Json::Object& json_data);
-
-  /**
-   * Parse unprocessed keys for batch operation results.
-   * @return empty set if there are no unprocessed keys or a set of table names that did not get
-   * processed in the batch operation.
    */
-  static std::vector<std::string> parseBatchUnProcessedKeys(const Json::Object& json_data);
+  static std::string parseErrorType(absl::string_view error_type);
 
   /**
    * @return true if the operation is in the set of supported BATCH_OPERATIONS
    */
   static bool isBatchOperation(const std::string& operation);
 
-  /**
-   * Parse the Partition ids and the consumed capacity from the body.
-   * @return empty set if there is no partition data or a set of partition data containing
-   * the partition id as a string and the capacity consumed as an integer.
-   *
-   * @throw Json::Exception if data is not in valid Json format.
-   */
-  static std::vector<PartitionDescriptor> parsePartitions(const Json::Object& json_data);
-
   using StringFn = std::function<void(const std::string&)>;
 
   /**
@@ -109,6 +75,8 @@ public:
   static void forEachStatString(const StringFn& fn);
 
 private:
+  enum class ValueType { Object, Array, String, Number, Literal };
+
   static const Http::LowerCaseString X_AMZ_TARGET;
   static const std::vector<std::string> SINGLE_TABLE_OPERATIONS;
   static const std::vector<std::string> BATCH_OPERATIONS;
@@ -121,6 +89,161 @@ private:
   RequestParser() = default;
 };
 
+/**
+ * Extracts the table(s) used by a request out of its body, as the body is received.
+ *
+ * For simple operations on single table, e.g., GetItem, PutItem, Query etc the table name is
+ * TableDescriptor.table_name.
+ *
+ * For batch and transaction operations, e.g. BatchGetItem/TransactWriteItems, the table name is
+ * TableDescriptor.table_name if it's only one table used in all operations, empty with
+ * TableDescriptor.is_single_table=false in case of multiple.
+ *
+ * The table name is empty if it cannot be parsed out of the body, or if the operation is not in
+ * the list of operations that we support.
+ */
+class RequestParser::TableParser : private JsonStreamParser::Callbacks {
+public:
+  explicit TableParser(const std::string& operation);
+
+  void parse(const Buffer::Instance& data) { parser_.parse(data); }
+
+  /**
+   * @return whether no data has been parsed.
+   */
+  bool empty() const { return parser_.empty(); }
+
+  /**
+   * Ends the body.
+   * @return whether the body is valid JSON, with the fields used for the operation of the expected
+   *         types.
+   */
+  bool finish() { return parser_.finish() && valid_; }
+
+  const TableDescriptor& table() const { return table_; }
+
+private:
+  enum class Operation { SingleTable, Batch, Transact, Other };
+  // The fields of the body which are of interest, the values being parsed are for.
+  enum class Field {
+    Root,
+    TableName,
+    RequestItems,
+    TransactItems,
+    TransactItem,
+    TransactItemOperation,
+    TransactItemTableName,
+    Other
+  };
+
+  // JsonStreamParser::Callbacks
+  void onStartObject() override;
+  void onEndObject() override;
+  void onStartArray() override;
+  void onEndArray() override { fields_.pop_back(); }
+  void onKey(const std::string& key) override;
+  void onString(const std::string& value) override;
+  void onNumber(const std::string&) override { startValue(ValueType::Number); }
+  void onLiteral() override { startValue(ValueType::Literal); }
+
+  Field nextField() const;
+  Field startValue(ValueType type);
+  void addTable(const std::string& table_name);
+  void endTransactItem();
+
+  JsonStreamParser parser_;
+  Operation operation_;
+  TableDescriptor table_{"", true};
+  // Whether the table descriptor is final, i.e. there are multiple tables or a missing one.
+  bool done_{};
+  bool valid_{true};
+  std::vector<Field> fields_;
+  // The last key of the object being parsed, if it is of interest.
+  std::string key_;
+  // The table names of the operations of the transaction item being parsed.
+  std::vector<std::string> transact_item_tables_;
+  size_t transact_item_operation_{};
+};
+
+/**
+ * Extracts the error type, the tables with unprocessed keys, and the capacity consumed per
+ * partition out of the body of a response, as the body is received.
+ */
+class RequestParser::ResponseParser : private JsonStreamParser::Callbacks {
+public:
+  /**
+   * @param parse_error_type supplies whether to extract the error type, for failed requests.
+   * @param parse_unprocessed_keys supplies whether to extract the tables with unprocessed keys,
+   *        for batch operations.
+   */
+  ResponseParser(bool parse_error_type, bool parse_unprocessed_keys)
+      : parser_(*this), parse_error_type_(parse_error_type),
+        parse_unprocessed_keys_(parse_unprocessed_keys) {}
+
+  void parse(const Buffer::Instance& data) { parser_.parse(data); }
+
+  /**
+   * @return whether no data has been parsed.
+   */
+  bool empty() const { return parser_.empty(); }
+
+  /**
+   * Ends the body.
+   * @return whether the body is valid JSON, with the fields extracted of the expected types.
+   */
+  bool finish() { return parser_.finish() && valid_; }
+
+  /**
+   * @return the supported error type, see parseErrorType().
+   */
+  const std::string& errorType() const { return error_type_; }
+
+  /**
+   * @return the tables that did not get processed in the batch operation.
+   */
+  const std::vector<std::string>& unprocessedTables() const { return unprocessed_tables_; }
+
+  /**
+   * @return the partition ids, and the capacity consumed for each of them rounded up to an
+   *         integer.
+   */
+  const std::vector<PartitionDescriptor>& partitions() const { return partitions_; }
+
+private:
+  enum class Field {
+    Root,
+    ErrorType,
+    UnprocessedKeys,
+    ConsumedCapacity,
+    Partitions,
+    Partition,
+    Other
+  };
+
+  // JsonStreamParser::Callbacks
+  void onStartObject() override { fields_.push_back(startValue(ValueType::Object)); }
+  void onEndObject() override { fields_.pop_back(); }
+  void onStartArray() override { fields_.push_back(startValue(ValueType::Array)); }
+  void onEndArray() override { fields_.pop_back(); }
+  void onKey(const std::string& key) override;
+  void onString(const std::string& value) override;
+  void onNumber(const std::string& value) override;
+  void onLiteral() override { startValue(ValueType::Literal); }
+
+  Field nextField() const;
+  Field startValue(ValueType type);
+
+  JsonStreamParser parser_;
+  const bool parse_error_type_;
+  const bool parse_unprocessed_keys_;
+  bool valid_{true};
+  std::vector<Field> fields_;
+  std::string key_;
+  std::string error_type_;
+  std::vector<std::string> unprocessed_tables_;
+  std::vector<PartitionDescriptor> partitions_;
+};
+
 } // namespace Dynamo
 } // namespace HttpFilters
 } // namespace Extensions
@@ -0,0 +1,369 @@
+#include "extensions/filters/http/dynamo/json_stream_parser.h"
+
+#include <cstdint>
+#include <string>
+
+#include "common/common/stack_array.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Dynamo {
+
+namespace {
+
+bool isWhitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+bool isNumberCharacter(char c) {
+  return absl::ascii_isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// Numbers are gathered from any of the characters they can contain, and only checked against the
+// JSON grammar once they end: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+bool isValidNumber(absl::string_view number) {
+  size_t i = 0;
+  const auto digits = [&number, &i]() {
+    const size_t start = i;
+    while (i < number.size() && absl::ascii_isdigit(number[i])) {
+      ++i;
+    }
+    return i > start;
+  };
+
+  if (i < number.size() && number[i] == '-') {
+    ++i;
+  }
+  if (i < number.size() && number[i] == '0') {
+    ++i;
+  } else if (!digits()) {
+    return false;
+  }
+  if (i < number.size() && number[i] == '.') {
+    ++i;
+    if (!digits()) {
+      return false;
+    }
+  }
+  if (i < number.size() && (number[i] == 'e' || number[i] == 'E')) {
+    ++i;
+    if (i < number.size() && (number[i] == '+' || number[i] == '-')) {
+      ++i;
+    }
+    if (!digits()) {
+      return false;
+    }
+  }
+  return i == number.size();
+}
+
+} // namespace
+
+void JsonStreamParser::parse(const Buffer::Instance& data) {
+  uint64_t num_slices = data.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  data.getRawSlices(slices.begin(), num_slices);
+  for (const Buffer::RawSlice& slice : slices) {
+    parse(absl::string_view(static_cast<const char*>(slice.mem_), slice.len_));
+  }
+}
+
+void JsonStreamParser::parse(absl::string_view data) {
+  if (!data.empty()) {
+    empty_ = false;
+  }
+
+  size_t i = 0;
+  while (i < data.size()) {
+    switch (state_) {
+    case State::Error:
+      return;
+    case State::String: {
+      // Copy the characters which need no unescaping at once.
+      size_t end = i;
+      while (end < data.size() && data[end] != '"' && data[end] != '\\' &&
+             static_cast<unsigned char>(data[end]) >= 0x20) {
+        ++end;
+      }
+      if (end > i) {
+        if (high_surrogate_ != 0) {
+          state_ = State::Error;
+          return;
+        }
+        token_.append(data.data() + i, end - i);
+        i = end;
+        break;
+      }
+      const char c = data[i++];
+      if (c == '"' && high_surrogate_ == 0) {
+        endString();
+      } else if (c == '\\') {
+        state_ = State::StringEscape;
+      } else {
+        // Unescaped control characters, or a lone high surrogate.
+        state_ = State::Error;
+      }
+      break;
+    }
+    case State::StringEscape:
+      parseEscape(data[i++]);
+      break;
+    case State::StringUnicode:
+      parseUnicode(data[i++]);
+      break;
+    default:
+      if (parseStructural(data[i])) {
+        ++i;
+      }
+      break;
+    }
+  }
+}
+
+bool JsonStreamParser::finish() {
+  if (state_ == State::Number) {
+    endNumber();
+  }
+  return state_ == State::Done;
+}
+
+bool JsonStreamParser::parseStructural(char c) {
+  if (state_ == State::Number) {
+    if (isNumberCharacter(c)) {
+      token_.push_back(c);
+      return true;
+    }
+    endNumber();
+    return false;
+  }
+  if (state_ == State::Literal) {
+    if (c != literal_[literal_position_]) {
+      state_ = State::Error;
+    } else if (++literal_position_ == literal_.size()) {
+      callbacks_.onLiteral();
+      endValue();
+    }
+    return true;
+  }
+  if (isWhitespace(c)) {
+    return true;
+  }
+
+  switch (state_) {
+  case State::Value:
+    startValue(c);
+    break;
+  case State::FirstValue:
+    if (c == ']') {
+      containers_.pop_back();
+      callbacks_.onEndArray();
+      endValue();
+    } else {
+      startValue(c);
+    }
+    break;
+  case State::FirstKey:
+  case State::Key:
+    if (c == '"') {
+      key_ = true;
+      token_.clear();
+      state_ = State::String;
+    } else if (c == '}' && state_ == State::FirstKey) {
+      containers_.pop_back();
+      callbacks_.onEndObject();
+      endValue();
+    } else {
+      state_ = State::Error;
+    }
+    break;
+  case State::Colon:
+    state_ = c == ':' ? State::Value : State::Error;
+    break;
+  case State::AfterValue: {
+    const bool object = containers_.back() == '{';
+    if (c == ',') {
+      state_ = object ? State::Key : State::Value;
+    } else if (c == (object ? '}' : ']')) {
+      containers_.pop_back();
+      if (object) {
+        callbacks_.onEndObject();
+      } else {
+        callbacks_.onEndArray();
+      }
+      endValue();
+    } else {
+      state_ = State::Error;
+    }
+    break;
+  }
+  default:
+    // Anything but whitespace after the value.
+    state_ = State::Error;
+    break;
+  }
+  return true;
+}
+
+void JsonStreamParser::startValue(char c) {
+  switch (c) {
+  case '{':
+    containers_.push_back('{');
+    callbacks_.onStartObject();
+    state_ = State::FirstKey;
+    break;
+  case '[':
+    containers_.push_back('[');
+    callbacks_.onStartArray();
+    state_ = State::FirstValue;
+    break;
+  case '"':
+    key_ = false;
+    token_.clear();
+    state_ = State::String;
+    break;
+  case 't':
+    literal_ = "true";
+    literal_position_ = 1;
+    state_ = State::Literal;
+    break;
+  case 'f':
+    literal_ = "false";
+    literal_position_ = 1;
+    state_ = State::Literal;
+    break;
+  case 'n':
+    literal_ = "null";
+    literal_position_ = 1;
+    state_ = State::Literal;
+    break;
+  default:
+    if (c == '-' || absl::ascii_isdigit(c)) {
+      token_.assign(1, c);
+      state_ = State::Number;
+    } else {
+      state_ = State::Error;
+    }
+    break;
+  }
+}
+
+void JsonStreamParser::parseEscape(char c) {
+  if (high_surrogate_ != 0 && c != 'u') {
+    state_ = State::Error;
+    return;
+  }
+
+  switch (c) {
+  case '"':
+  case '\\':
+  case '/':
+    token_.push_back(c);
+    break;
+  case 'b':
+    token_.push_back('\b');
+    break;
+  case 'f':
+    token_.push_back('\f');
+    break;
+  case 'n':
+    token_.push_back('\n');
+    break;
+  case 'r':
+    token_.push_back('\r');
+    break;
+  case 't':
+    token_.push_back('\t');
+    break;
+  case 'u':
+    code_point_ = 0;
+    code_point_digits_ = 0;
+    state_ = State::StringUnicode;
+    return;
+  default:
+    state_ = State::Error;
+    return;
+  }
+  state_ = State::String;
+}
+
+void JsonStreamParser::parseUnicode(char c) {
+  uint32_t digit;
+  if (c >= '0' && c <= '9') {
+    digit = c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    digit = c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    digit = c - 'A' + 10;
+  } else {
+    state_ = State::Error;
+    return;
+  }
+
+  code_point_ = code_point_ * 16 + digit;
+  if (++code_point_digits_ < 4) {
+    return;
+  }
+
+  state_ = State::String;
+  if (high_surrogate_ != 0) {
+    if (code_point_ < 0xDC00 || code_point_ > 0xDFFF) {
+      state_ = State::Error;
+      return;
+    }
+    appendCodePoint(0x10000 + ((high_surrogate_ - 0xD800) << 10) + (code_point_ - 0xDC00));
+    high_surrogate_ = 0;
+  } else if (code_point_ >= 0xD800 && code_point_ <= 0xDBFF) {
+    high_surrogate_ = code_point_;
+  } else if (code_point_ >= 0xDC00 && code_point_ <= 0xDFFF) {
+    state_ = State::Error;
+  } else {
+    appendCodePoint(code_point_);
+  }
+}
+
+void JsonStreamParser::appendCodePoint(uint32_t code_point) {
+  if (code_point < 0x80) {
+    token_.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    token_.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    token_.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    token_.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    token_.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    token_.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    token_.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    token_.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    token_.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    token_.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+void JsonStreamParser::endString() {
+  if (key_) {
+    callbacks_.onKey(token_);
+    state_ = State::Colon;
+  } else {
+    callbacks_.onString(token_);
+    endValue();
+  }
+}
+
+void JsonStreamParser::endNumber() {
+  if (!isValidNumber(token_)) {
+    state_ = State::Error;
+    return;
+  }
+  callbacks_.onNumber(token_);
+  endValue();
+}
+
+void JsonStreamParser::endValue() {
+  state_ = containers_.empty() ? State::Done : State::AfterValue;
+}
+
+} // namespace Dynamo
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Dynamo {
+
+/**
+ * Incremental JSON parser, fed with a document piece by piece as it is received, and reporting its
+ * tokens SAX style without building a tree nor needing the whole document at once. A token may be
+ * split across pieces, in which case it is reported once its last piece has been parsed.
+ */
+class JsonStreamParser {
+public:
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    virtual void onStartObject() PURE;
+    virtual void onEndObject() PURE;
+    virtual void onStartArray() PURE;
+    virtual void onEndArray() PURE;
+
+    /**
+     * Called for the key of an object member, before its value.
+     * @param key supplies the unescaped key.
+     */
+    virtual void onKey(const std::string& key) PURE;
+
+    /**
+     * @param value supplies the unescaped string value.
+     */
+    virtual void onString(const std::string& value) PURE;
+
+    /**
+     * @param value supplies the number as written in the document.
+     */
+    virtual void onNumber(const std::string& value) PURE;
+
+    /**
+     * Called for true, false and null.
+     */
+    virtual void onLiteral() PURE;
+  };
+
+  explicit JsonStreamParser(Callbacks& callbacks) : callbacks_(callbacks) {}
+
+  /**
+   * Parses the next piece of the document. Nothing is reported anymore once the document has been
+   * found to be invalid.
+   */
+  void parse(absl::string_view data);
+  void parse(const Buffer::Instance& data);
+
+  /**
+   * Ends the document.
+   * @return whether the document parsed was a single valid JSON value.
+   */
+  bool finish();
+
+  /**
+   * @return whether any data has been parsed.
+   */
+  bool empty() const { return empty_; }
+
+private:
+  enum class State {
+    // Expecting a value.
+    Value,
+    // Expecting a value or the end of an array, right after '['.
+    FirstValue,
+    // Expecting a key or the end of an object, right after '{'.
+    FirstKey,
+    // Expecting a key, after ',' in an object.
+    Key,
+    // Expecting ':' after a key.
+    Colon,
+    // Expecting ',' or the end of the enclosing object or array.
+    AfterValue,
+    String,
+    StringEscape,
+    StringUnicode,
+    Number,
+    Literal,
+    // A whole value has been parsed, and only whitespace may follow.
+    Done,
+    Error
+  };
+
+  /**
+   * Parses a character outside of strings.
+   * @return whether the character was consumed, numbers only being known to end at the character
+   *         following them.
+   */
+  bool parseStructural(char c);
+  void parseEscape(char c);
+  void parseUnicode(char c);
+  void startValue(char c);
+  void endString();
+  void endNumber();
+  void endValue();
+  void appendCodePoint(uint32_t code_point);
+
+  Callbacks& callbacks_;
+  State state_{State::Value};
+  // The enclosing objects and arrays, as '{' or '['.
+  std::vector<char> containers_;
+  // The string or number being parsed.
+  std::string token_;
+  bool key_{};
+  absl::string_view literal_;
+  size_t literal_position_{};
+  uint32_t code_point_{};
+  uint32_t code_point_digits_{};
+  // The first half of a UTF-16 surrogate pair, waiting for the second one.
+  uint32_t high_surrogate_{};
+  bool empty_{true};
+};
+
+} // namespace Dynamo
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -22,9 +22,9 @@ namespace ExtAuthz {
 Http::FilterFactoryCb ExtAuthzFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ext_authz::v3alpha::ExtAuthz& proto_config,
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
-  const auto filter_config =
-      std::make_shared<FilterConfig>(proto_config, context.localInfo(), context.scope(),
-                                     context.runtime(), context.httpContext(), stats_prefix);
+  const auto filter_config = std::make_shared<FilterConfig>(
+      proto_config, context.localInfo(), context.scope(), context.runtime(), context.httpContext(),
+      stats_prefix, context.threadLocal(), context.timeSource());
   Http::FilterFactoryCb callback;
 
   if (proto_config.has_http_service()) {
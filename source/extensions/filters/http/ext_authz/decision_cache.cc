@@ -0,0 +1,201 @@
+#include "extensions/filters/http/ext_authz/decision_cache.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/empty_string.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+using Filters::Common::ExtAuthz::Response;
+
+namespace {
+// Default maximum number of decisions cached by each worker.
+constexpr uint32_t DefaultMaxEntries = 10000;
+
+// Append a length prefixed value to a key, so that distinct attributes never make the same key.
+void appendToKey(std::string& key, absl::string_view value) {
+  absl::StrAppend(&key, value.size(), ":", value);
+}
+
+// Remove a header from a header vector.
+// @return whether the header was found, and its value if so.
+bool takeHeader(Http::HeaderVector& headers, const Http::LowerCaseString& name,
+                std::string& value) {
+  const auto it = std::find_if(headers.begin(), headers.end(),
+                               [&name](const auto& header) { return header.first == name; });
+  if (it == headers.end()) {
+    return false;
+  }
+  value = it->second;
+  headers.erase(it);
+  return true;
+}
+} // namespace
+
+const Response* DecisionCache::lookup(const std::string& key) {
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  if (it->second.expiration_->first <= time_source_.monotonicTime()) {
+    erase(it);
+    return nullptr;
+  }
+  return &it->second.response_;
+}
+
+void DecisionCache::insert(const std::string& key, const Response& response,
+                           std::chrono::milliseconds ttl) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    erase(it);
+  } else if (entries_.size() >= max_entries_) {
+    // The expired decisions, if any, come first.
+    erase(entries_.find(expirations_.begin()->second));
+  }
+  const auto expiration = expirations_.emplace(time_source_.monotonicTime() + ttl, key);
+  entries_.emplace(key, Entry{response, expiration});
+}
+
+void DecisionCache::erase(absl::flat_hash_map<std::string, Entry>::iterator it) {
+  ASSERT(it != entries_.end());
+  expirations_.erase(it->second.expiration_);
+  entries_.erase(it);
+}
+
+bool DecisionCache::addCheck(const std::string& key, CoalescedCheck& check) {
+  auto& in_flight = in_flight_checks_[key];
+  if (in_flight.sent_ == nullptr && in_flight.waiting_.empty()) {
+    in_flight.sent_ = &check;
+    return true;
+  }
+  in_flight.waiting_.push_back(&check);
+  return false;
+}
+
+void DecisionCache::completeCheck(const std::string& key, const Response& response) {
+  auto it = in_flight_checks_.find(key);
+  if (it == in_flight_checks_.end()) {
+    return;
+  }
+  it->second.sent_ = nullptr;
+  // The waiting checks are handed the decision one at a time, as each of them can end streams
+  // whose checks then remove themselves.
+  while (true) {
+    it = in_flight_checks_.find(key);
+    if (it == in_flight_checks_.end() || it->second.sent_ != nullptr) {
+      // A new identical check was sent meanwhile, the remaining checks wait for it instead.
+      return;
+    }
+    if (it->second.waiting_.empty()) {
+      in_flight_checks_.erase(it);
+      return;
+    }
+    CoalescedCheck* check = it->second.waiting_.front();
+    it->second.waiting_.pop_front();
+    check->onCoalescedDecision(response);
+  }
+}
+
+void DecisionCache::removeCheck(const std::string& key, CoalescedCheck& check) {
+  const auto it = in_flight_checks_.find(key);
+  if (it == in_flight_checks_.end()) {
+    return;
+  }
+  InFlightCheck& in_flight = it->second;
+  if (in_flight.sent_ != &check) {
+    in_flight.waiting_.remove(&check);
+    return;
+  }
+  if (in_flight.waiting_.empty()) {
+    in_flight_checks_.erase(it);
+    return;
+  }
+  CoalescedCheck* next = in_flight.waiting_.front();
+  in_flight.waiting_.pop_front();
+  in_flight.sent_ = next;
+  // This may complete the check right away, which modifies the checks in flight.
+  next->sendCheck();
+}
+
+DecisionCacheConfig::DecisionCacheConfig(
+    const envoy::extensions::filters::http::ext_authz::v3alpha::DecisionCache& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source)
+    : path_prefix_segments_(config.path_prefix_segments()),
+      default_ttl_(PROTOBUF_GET_MS_REQUIRED(config, default_ttl)),
+      ttl_header_(config.ttl_header()), coalesce_checks_(config.coalesce_checks()),
+      tls_(tls.allocateSlot()) {
+  for (const auto& header : config.principal_headers()) {
+    principal_headers_.push_back(Http::LowerCaseString(header).get());
+  }
+  const uint32_t max_entries =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries);
+  tls_->set(
+      [max_entries, &time_source](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        return std::make_shared<DecisionCache>(max_entries, time_source);
+      });
+}
+
+std::string
+DecisionCacheConfig::key(const envoy::service::auth::v3alpha::CheckRequest& request) const {
+  const auto& attributes = request.attributes();
+  const auto& http = attributes.request().http();
+  std::string key;
+  appendToKey(key, http.method());
+
+  absl::string_view path = http.path();
+  path = path.substr(0, path.find('?'));
+  if (path_prefix_segments_ > 0) {
+    // Keep the leading slash and the configured number of segments after it.
+    size_t end = 0;
+    for (uint32_t i = 0; i < path_prefix_segments_ && end != absl::string_view::npos; i++) {
+      end = path.find('/', end + 1);
+    }
+    path = path.substr(0, end);
+  }
+  appendToKey(key, path);
+
+  for (const auto& name : principal_headers_) {
+    const auto it = http.headers().find(name);
+    appendToKey(key, it != http.headers().end() ? it->second : EMPTY_STRING);
+  }
+  appendToKey(key, attributes.source().principal());
+
+  // The context extensions are set by the route, and may change the decision.
+  std::vector<std::pair<std::string, std::string>> context_extensions(
+      attributes.context_extensions().begin(), attributes.context_extensions().end());
+  std::sort(context_extensions.begin(), context_extensions.end());
+  for (const auto& extension : context_extensions) {
+    appendToKey(key, extension.first);
+    appendToKey(key, extension.second);
+  }
+  return key;
+}
+
+std::chrono::milliseconds DecisionCacheConfig::takeTtl(Response& response) const {
+  if (ttl_header_.get().empty()) {
+    return default_ttl_;
+  }
+  // The header is taken out of both vectors, so that it never reaches the request or the reply.
+  std::string value;
+  const bool added = takeHeader(response.headers_to_add, ttl_header_, value);
+  const bool appended = takeHeader(response.headers_to_append, ttl_header_, value);
+  uint32_t seconds;
+  if (!(added || appended) || !absl::SimpleAtoi(value, &seconds)) {
+    return default_ttl_;
+  }
+  return std::chrono::seconds(seconds);
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
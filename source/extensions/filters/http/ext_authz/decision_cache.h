@@ -0,0 +1,153 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3alpha/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/service/auth/v3alpha/external_auth.pb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * A check coalesced with the identical checks of the same worker. @see DecisionCache.
+ */
+class CoalescedCheck {
+public:
+  virtual ~CoalescedCheck() = default;
+
+  /**
+   * Called with the decision of the identical check this check was waiting for.
+   * @param response supplies the decision, which is only valid for the duration of the call.
+   */
+  virtual void onCoalescedDecision(const Filters::Common::ExtAuthz::Response& response) PURE;
+
+  /**
+   * Called when the identical check this check was waiting for went away along with its
+   * stream, for this check to be sent instead.
+   */
+  virtual void sendCheck() PURE;
+};
+
+/**
+ * Per worker cache of the authorization decisions. It also tracks the checks in flight, so that
+ * identical checks can wait for the decision of the first one rather than all being sent.
+ */
+class DecisionCache : public ThreadLocal::ThreadLocalObject {
+public:
+  DecisionCache(uint32_t max_entries, TimeSource& time_source)
+      : max_entries_(max_entries), time_source_(time_source) {}
+
+  /**
+   * @return the decision cached for the key, or nullptr if there is none or it expired. The
+   *         decision is only valid until the cache is next modified.
+   */
+  const Filters::Common::ExtAuthz::Response* lookup(const std::string& key);
+
+  /**
+   * Cache a decision, evicting the one which expires first when the cache is full.
+   */
+  void insert(const std::string& key, const Filters::Common::ExtAuthz::Response& response,
+              std::chrono::milliseconds ttl);
+
+  /**
+   * Register a check which is about to be sent, unless an identical one is already in flight.
+   * @return true if the check must be sent, false if it waits for the decision of the identical
+   *         check in flight.
+   */
+  bool addCheck(const std::string& key, CoalescedCheck& check);
+
+  /**
+   * Hand the decision of a sent check to the checks waiting for it. The sent check must not call
+   * removeCheck() afterwards.
+   */
+  void completeCheck(const std::string& key, const Filters::Common::ExtAuthz::Response& response);
+
+  /**
+   * Remove a sent or waiting check whose stream went away. If it was sent, the first waiting
+   * check, if any, is sent instead.
+   */
+  void removeCheck(const std::string& key, CoalescedCheck& check);
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  using ExpirationIndex = std::multimap<MonotonicTime, std::string>;
+
+  struct Entry {
+    Filters::Common::ExtAuthz::Response response_;
+    ExpirationIndex::iterator expiration_;
+  };
+
+  struct InFlightCheck {
+    // The check which was sent, if it is still around.
+    CoalescedCheck* sent_{};
+    // The identical checks waiting for its decision, in arrival order.
+    std::list<CoalescedCheck*> waiting_;
+  };
+
+  void erase(absl::flat_hash_map<std::string, Entry>::iterator it);
+
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+  // The keys of the cached decisions, ordered by expiration time.
+  ExpirationIndex expirations_;
+  absl::flat_hash_map<std::string, InFlightCheck> in_flight_checks_;
+};
+
+/**
+ * Configuration of the decision cache, shared by all the workers.
+ */
+class DecisionCacheConfig {
+public:
+  DecisionCacheConfig(
+      const envoy::extensions::filters::http::ext_authz::v3alpha::DecisionCache& config,
+      ThreadLocal::SlotAllocator& tls, TimeSource& time_source);
+
+  /**
+   * @return the decision cache of the current worker.
+   */
+  DecisionCache& cache() { return tls_->getTyped<DecisionCache>(); }
+
+  bool coalesceChecks() const { return coalesce_checks_; }
+
+  /**
+   * @return the key of the decision for a check request, made of the configured attributes.
+   */
+  std::string key(const envoy::service::auth::v3alpha::CheckRequest& request) const;
+
+  /**
+   * Remove the TTL header from the headers of a decision.
+   * @return the time the decision is cached for, the default TTL if it was not set.
+   */
+  std::chrono::milliseconds takeTtl(Filters::Common::ExtAuthz::Response& response) const;
+
+private:
+  std::vector<std::string> principal_headers_;
+  const uint32_t path_prefix_segments_;
+  const std::chrono::milliseconds default_ttl_;
+  const Http::LowerCaseString ttl_header_;
+  const bool coalesce_checks_;
+  ThreadLocal::SlotPtr tls_;
+};
+
+using DecisionCacheConfigPtr = std::unique_ptr<DecisionCacheConfig>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
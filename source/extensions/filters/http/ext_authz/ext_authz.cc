@@ -79,15 +79,41 @@ void Filter::initiateCall(const Http::HeaderMap& headers) {
       callbacks_, headers, std::move(context_extensions), std::move(metadata_context),
       check_request_, config_->maxRequestBytes(), config_->includePeerCertificate());
 
-  ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *callbacks_);
-  state_ = State::Calling;
   filter_return_ = FilterReturn::StopDecoding; // Don't let the filter chain continue as we are
                                                // going to invoke check call.
   initiating_call_ = true;
-  client_->check(*this, check_request_, callbacks_->activeSpan());
+  DecisionCacheConfig* decision_cache = config_->decisionCache();
+  if (decision_cache != nullptr) {
+    cache_key_ = decision_cache->key(check_request_);
+    const auto* cached = decision_cache->cache().lookup(cache_key_);
+    if (cached != nullptr) {
+      ENVOY_STREAM_LOG(trace, "ext_authz filter using a cached decision", *callbacks_);
+      stats_.cache_hit_.inc();
+      applyDecision(std::make_unique<Filters::Common::ExtAuthz::Response>(*cached));
+      initiating_call_ = false;
+      return;
+    }
+    if (decision_cache->coalesceChecks()) {
+      coalescing_ = true;
+      if (!decision_cache->cache().addCheck(cache_key_, *this)) {
+        ENVOY_STREAM_LOG(trace, "ext_authz filter waiting for an identical check", *callbacks_);
+        stats_.coalesced_.inc();
+        state_ = State::Waiting;
+        initiating_call_ = false;
+        return;
+      }
+    }
+  }
+  sendCheck();
   initiating_call_ = false;
 }
 
+void Filter::sendCheck() {
+  ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *callbacks_);
+  state_ = State::Calling;
+  client_->check(*this, check_request_, callbacks_->activeSpan());
+}
+
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool end_stream) {
   if (!config_->filterEnabled()) {
     return Http::FilterHeadersStatus::Continue;
@@ -152,12 +178,37 @@ void Filter::setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callb
 
 void Filter::onDestroy() {
   if (state_ == State::Calling) {
-    state_ = State::Complete;
     client_->cancel();
   }
+  state_ = State::Complete;
+  if (coalescing_) {
+    // An identical check waiting for this one is sent instead.
+    coalescing_ = false;
+    config_->decisionCache()->cache().removeCheck(cache_key_, *this);
+  }
 }
 
 void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
+  DecisionCacheConfig* decision_cache = config_->decisionCache();
+  if (decision_cache != nullptr) {
+    const std::chrono::milliseconds ttl = decision_cache->takeTtl(*response);
+    if (response->status != Filters::Common::ExtAuthz::CheckStatus::Error && ttl.count() > 0) {
+      decision_cache->cache().insert(cache_key_, *response, ttl);
+    }
+    if (coalescing_) {
+      coalescing_ = false;
+      decision_cache->cache().completeCheck(cache_key_, *response);
+    }
+  }
+  applyDecision(std::move(response));
+}
+
+void Filter::onCoalescedDecision(const Filters::Common::ExtAuthz::Response& response) {
+  coalescing_ = false;
+  applyDecision(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+}
+
+void Filter::applyDecision(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   state_ = State::Complete;
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/common/exception.h"
 #include "envoy/extensions/filters/http/ext_authz/v3alpha/ext_authz.pb.h"
 #include "envoy/http/filter.h"
 #include "envoy/local_info/local_info.h"
@@ -12,6 +13,7 @@
 #include "envoy/service/auth/v3alpha/external_auth.pb.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/assert.h"
@@ -24,6 +26,7 @@
 #include "extensions/filters/common/ext_authz/ext_authz.h"
 #include "extensions/filters/common/ext_authz/ext_authz_grpc_impl.h"
 #include "extensions/filters/common/ext_authz/ext_authz_http_impl.h"
+#include "extensions/filters/http/ext_authz/decision_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -43,7 +46,9 @@ enum class FilterRequestType { Internal, External, Both };
   COUNTER(ok)                                                                                      \
   COUNTER(denied)                                                                                  \
   COUNTER(error)                                                                                   \
-  COUNTER(failure_mode_allowed)
+  COUNTER(failure_mode_allowed)                                                                    \
+  COUNTER(cache_hit)                                                                               \
+  COUNTER(coalesced)
 
 /**
  * Wrapper struct for ext_authz filter stats. @see stats_macros.h
@@ -60,7 +65,8 @@ public:
   FilterConfig(const envoy::extensions::filters::http::ext_authz::v3alpha::ExtAuthz& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
                Runtime::Loader& runtime, Http::Context& http_context,
-               const std::string& stats_prefix)
+               const std::string& stats_prefix, ThreadLocal::SlotAllocator& tls,
+               TimeSource& time_source)
       : allow_partial_message_(config.with_request_body().allow_partial_message()),
         failure_mode_allow_(config.failure_mode_allow()),
         clear_route_cache_(config.clear_route_cache()),
@@ -78,7 +84,16 @@ public:
         stats_(generateStats(stats_prefix, scope)), ext_authz_ok_(pool_.add("ext_authz.ok")),
         ext_authz_denied_(pool_.add("ext_authz.denied")),
         ext_authz_error_(pool_.add("ext_authz.error")),
-        ext_authz_failure_mode_allowed_(pool_.add("ext_authz.failure_mode_allowed")) {}
+        ext_authz_failure_mode_allowed_(pool_.add("ext_authz.failure_mode_allowed")) {
+    if (config.has_decision_cache()) {
+      if (withRequestBody()) {
+        throw EnvoyException(
+            "ext_authz decision_cache cannot be used along with with_request_body");
+      }
+      decision_cache_ = std::make_unique<DecisionCacheConfig>(config.decision_cache(), tls,
+                                                              time_source);
+    }
+  }
 
   bool allowPartialMessage() const { return allow_partial_message_; }
 
@@ -114,6 +129,9 @@ public:
 
   bool includePeerCertificate() const { return include_peer_certificate_; }
 
+  // @return the decision cache configuration, nullptr if the decisions are not cached.
+  DecisionCacheConfig* decisionCache() { return decision_cache_.get(); }
+
 private:
   static Http::Code toErrorCode(uint64_t status) {
     const auto code = static_cast<Http::Code>(status);
@@ -150,6 +168,8 @@ private:
   // The stats for the filter.
   ExtAuthzFilterStats stats_;
 
+  DecisionCacheConfigPtr decision_cache_;
+
 public:
   // TODO(nezdolik): deprecate cluster scope stats counters in favor of filter scope stats
   // (ExtAuthzFilterStats stats_).
@@ -200,7 +220,8 @@ private:
  */
 class Filter : public Logger::Loggable<Logger::Id::filter>,
                public Http::StreamDecoderFilter,
-               public Filters::Common::ExtAuthz::RequestCallbacks {
+               public Filters::Common::ExtAuthz::RequestCallbacks,
+               public CoalescedCheck {
 public:
   Filter(FilterConfigSharedPtr config, Filters::Common::ExtAuthz::ClientPtr&& client)
       : config_(config), client_(std::move(client)), stats_(config->stats()) {}
@@ -217,16 +238,24 @@ public:
   // ExtAuthz::RequestCallbacks
   void onComplete(Filters::Common::ExtAuthz::ResponsePtr&&) override;
 
+  // CoalescedCheck
+  void onCoalescedDecision(const Filters::Common::ExtAuthz::Response& response) override;
+  void sendCheck() override;
+
 private:
   void addResponseHeaders(Http::HeaderMap& header_map, const Http::HeaderVector& headers);
   void initiateCall(const Http::HeaderMap& headers);
   void continueDecoding();
   bool isBufferFull();
+  // Apply the decision for the request, be it fresh, cached or coalesced.
+  void applyDecision(Filters::Common::ExtAuthz::ResponsePtr&& response);
 
   // State of this filter's communication with the external authorization service.
   // The filter has either not started calling the external service, in the middle of calling
   // it or has completed.
-  enum class State { NotStarted, Calling, Complete };
+  // While waiting, the filter does not call the service itself but waits for the decision of an
+  // identical check.
+  enum class State { NotStarted, Calling, Waiting, Complete };
 
   // FilterReturn is used to capture what the return code should be to the filter chain.
   // if this filter is either in the middle of calling the service or the result is denied then
@@ -248,6 +277,10 @@ private:
   bool initiating_call_{};
   bool buffer_data_{};
   envoy::service::auth::v3alpha::CheckRequest check_request_{};
+  // The key of the decision, when the decisions are cached.
+  std::string cache_key_;
+  // Whether the check is registered with the decision cache for coalescing.
+  bool coalescing_{};
 };
 
 } // namespace ExtAuthz
@@ -13,7 +13,6 @@
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
-#include "common/common/fmt.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
@@ -120,10 +119,8 @@ Http::FilterHeadersStatus FaultFilter::decodeHeaders(Http::HeaderMap& headers, b
     fault_settings_ = per_route_settings ? per_route_settings : fault_settings_;
   }
 
-  if (faultOverflow()) {
-    return Http::FilterHeadersStatus::Continue;
-  }
-
+  // The targeting of the fault only depends on the configuration, and is checked before anything
+  // which looks up the runtime.
   if (!matchesTargetUpstreamCluster()) {
     return Http::FilterHeadersStatus::Continue;
   }
@@ -137,18 +134,14 @@ Http::FilterHeadersStatus FaultFilter::decodeHeaders(Http::HeaderMap& headers, b
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (faultOverflow()) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  // The runtime keys specific to the downstream cluster are only built when they are looked up.
   if (headers.EnvoyDownstreamServiceCluster()) {
     downstream_cluster_ =
         std::string(headers.EnvoyDownstreamServiceCluster()->value().getStringView());
-
-    downstream_cluster_delay_percent_key_ =
-        fmt::format("fault.http.{}.delay.fixed_delay_percent", downstream_cluster_);
-    downstream_cluster_abort_percent_key_ =
-        fmt::format("fault.http.{}.abort.abort_percent", downstream_cluster_);
-    downstream_cluster_delay_duration_key_ =
-        fmt::format("fault.http.{}.delay.fixed_duration_ms", downstream_cluster_);
-    downstream_cluster_abort_http_status_key_ =
-        fmt::format("fault.http.{}.abort.http_status", downstream_cluster_);
   }
 
   maybeSetupResponseRateLimit(headers);
@@ -225,18 +218,20 @@ bool FaultFilter::isDelayEnabled() {
     return false;
   }
 
-  if (!downstream_cluster_delay_percent_key_.empty()) {
+  if (!downstream_cluster_.empty()) {
     return config_->runtime().snapshot().featureEnabled(
-        downstream_cluster_delay_percent_key_, fault_settings_->requestDelay()->percentage());
+        downstreamClusterKey(downstream_cluster_delay_percent_key_, ".delay.fixed_delay_percent"),
+        fault_settings_->requestDelay()->percentage());
   }
   return config_->runtime().snapshot().featureEnabled(
       fault_settings_->delayPercentRuntime(), fault_settings_->requestDelay()->percentage());
 }
 
 bool FaultFilter::isAbortEnabled() {
-  if (!downstream_cluster_abort_percent_key_.empty()) {
-    return config_->runtime().snapshot().featureEnabled(downstream_cluster_abort_percent_key_,
-                                                        fault_settings_->abortPercentage());
+  if (!downstream_cluster_.empty()) {
+    return config_->runtime().snapshot().featureEnabled(
+        downstreamClusterKey(downstream_cluster_abort_percent_key_, ".abort.abort_percent"),
+        fault_settings_->abortPercentage());
   }
   return config_->runtime().snapshot().featureEnabled(fault_settings_->abortPercentRuntime(),
                                                       fault_settings_->abortPercentage());
@@ -261,9 +256,10 @@ FaultFilter::delayDuration(const Http::HeaderMap& request_headers) {
   std::chrono::milliseconds duration =
       std::chrono::milliseconds(config_->runtime().snapshot().getInteger(
           fault_settings_->delayDurationRuntime(), config_duration.value().count()));
-  if (!downstream_cluster_delay_duration_key_.empty()) {
+  if (!downstream_cluster_.empty()) {
     duration = std::chrono::milliseconds(config_->runtime().snapshot().getInteger(
-        downstream_cluster_delay_duration_key_, duration.count()));
+        downstreamClusterKey(downstream_cluster_delay_duration_key_, ".delay.fixed_duration_ms"),
+        duration.count()));
   }
 
   // Delay only if the duration is >0ms
@@ -279,14 +275,22 @@ uint64_t FaultFilter::abortHttpStatus() {
   uint64_t http_status = config_->runtime().snapshot().getInteger(
       fault_settings_->abortHttpStatusRuntime(), fault_settings_->abortCode());
 
-  if (!downstream_cluster_abort_http_status_key_.empty()) {
+  if (!downstream_cluster_.empty()) {
     http_status = config_->runtime().snapshot().getInteger(
-        downstream_cluster_abort_http_status_key_, http_status);
+        downstreamClusterKey(downstream_cluster_abort_http_status_key_, ".abort.http_status"),
+        http_status);
   }
 
   return http_status;
 }
 
+const std::string& FaultFilter::downstreamClusterKey(std::string& key, absl::string_view suffix) {
+  if (key.empty()) {
+    key = absl::StrCat("fault.http.", downstream_cluster_, suffix);
+  }
+  return key;
+}
+
 void FaultFilter::recordDelaysInjectedStats() {
   // Downstream specific stats.
   if (!downstream_cluster_.empty()) {
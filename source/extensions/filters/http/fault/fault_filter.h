@@ -52,7 +52,9 @@ public:
   const std::vector<Http::HeaderUtility::HeaderDataPtr>& filterHeaders() const {
     return fault_filter_headers_;
   }
-  envoy::type::v3alpha::FractionalPercent abortPercentage() const { return abort_percentage_; }
+  const envoy::type::v3alpha::FractionalPercent& abortPercentage() const {
+    return abort_percentage_;
+  }
   uint64_t abortCode() const { return http_status_; }
   const Filters::Common::Fault::FaultDelayConfig* requestDelay() const {
     return request_delay_config_.get();
@@ -250,6 +252,8 @@ private:
   bool isDelayEnabled();
   absl::optional<std::chrono::milliseconds> delayDuration(const Http::HeaderMap& request_headers);
   uint64_t abortHttpStatus();
+  // Builds the runtime key of the downstream cluster with the given suffix into key, if not yet.
+  const std::string& downstreamClusterKey(std::string& key, absl::string_view suffix);
   void maybeIncActiveFaults();
   void maybeSetupResponseRateLimit(const Http::HeaderMap& request_headers);
 
@@ -1,5 +1,7 @@
 #include "extensions/filters/http/grpc_http1_reverse_bridge/filter.h"
 
+#include <limits>
+
 #include "envoy/http/header_map.h"
 
 #include "common/common/enum_to_int.h"
@@ -149,6 +151,14 @@ Http::FilterHeadersStatus Filter::encodeHeaders(Http::HeaderMap& headers, bool)
     headers.setContentType(content_type_);
 
     if (withhold_grpc_frames_) {
+      // When the upstream tells the length of the response, the gRPC frame header can be sent
+      // ahead of the response, which then streams rather than being buffered.
+      uint64_t length;
+      if (headers.ContentLength() != nullptr &&
+          absl::SimpleAtoi(headers.ContentLength()->value().getStringView(), &length) &&
+          length <= std::numeric_limits<uint32_t>::max()) {
+        response_length_ = length;
+      }
       // Adjust content-length to account for the frame header that's added.
       adjustContentLength(headers,
                           [](auto length) { return length + Grpc::GRPC_FRAME_HEADER_SIZE; });
@@ -166,6 +176,18 @@ Http::FilterDataStatus Filter::encodeData(Buffer::Instance& buffer, bool end_str
     return Http::FilterDataStatus::Continue;
   }
 
+  if (withhold_grpc_frames_ && response_length_.has_value()) {
+    // Stream the response behind the gRPC frame header.
+    if (!frame_header_sent_) {
+      buildGrpcFrameHeader(buffer, response_length_.value());
+      frame_header_sent_ = true;
+    }
+    if (end_stream) {
+      encoder_callbacks_->addEncodedTrailers().setGrpcStatus(grpc_status_);
+    }
+    return Http::FilterDataStatus::Continue;
+  }
+
   if (end_stream) {
     // Insert grpc-status trailers to communicate the error code.
     auto& trailers = encoder_callbacks_->addEncodedTrailers();
@@ -173,7 +195,7 @@ Http::FilterDataStatus Filter::encodeData(Buffer::Instance& buffer, bool end_str
 
     if (withhold_grpc_frames_) {
       buffer.prepend(buffer_);
-      buildGrpcFrameHeader(buffer);
+      buildGrpcFrameHeader(buffer, buffer.length());
     }
 
     return Http::FilterDataStatus::Continue;
@@ -193,15 +215,16 @@ Http::FilterDataStatus Filter::encodeData(Buffer::Instance& buffer, bool end_str
 Http::FilterTrailersStatus Filter::encodeTrailers(Http::HeaderMap& trailers) {
   trailers.setGrpcStatus(grpc_status_);
 
-  if (withhold_grpc_frames_) {
-    buildGrpcFrameHeader(buffer_);
+  if (withhold_grpc_frames_ && !frame_header_sent_) {
+    buildGrpcFrameHeader(buffer_, response_length_.value_or(buffer_.length()));
+    frame_header_sent_ = true;
     encoder_callbacks_->addEncodedData(buffer_, false);
   }
 
   return Http::FilterTrailersStatus::Continue;
 }
 
-void Filter::buildGrpcFrameHeader(Buffer::Instance& buffer) {
+void Filter::buildGrpcFrameHeader(Buffer::Instance& buffer, uint64_t length) {
   // Compute the size of the payload and construct the length prefix.
   //
   // We do this even if the upstream failed: If the response returned non-200,
@@ -209,7 +232,6 @@ void Filter::buildGrpcFrameHeader(Buffer::Instance& buffer) {
   // was unsuccessful. Since we're guaranteed at this point to have a valid response
   // (unless upstream lied in content-type) we attempt to return a well-formed gRPC
   // response body.
-  const auto length = buffer.length();
   std::array<uint8_t, Grpc::GRPC_FRAME_HEADER_SIZE> frame;
   Grpc::Encoder().newFrame(Grpc::GRPC_FH_DEFAULT, length, frame);
   Buffer::OwnedImpl frame_buffer(frame.data(), frame.size());
@@ -10,6 +10,8 @@
 
 #include "extensions/filters/http/common/pass_through_filter.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -31,8 +33,8 @@ public:
   Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap& trailers) override;
 
 private:
-  // Prepend the grpc frame into the buffer
-  void buildGrpcFrameHeader(Buffer::Instance& buffer);
+  // Prepend the grpc frame header of a payload of the given length into the buffer
+  void buildGrpcFrameHeader(Buffer::Instance& buffer, uint64_t length);
 
   const std::string upstream_content_type_;
   const bool withhold_grpc_frames_;
@@ -41,6 +43,10 @@ private:
   bool prefix_stripped_{};
   std::string content_type_{};
   Grpc::Status::GrpcStatus grpc_status_{};
+  // The length of the upstream response, if known from its content-length, in which case the
+  // response streams behind the gRPC frame header rather than being buffered.
+  absl::optional<uint64_t> response_length_;
+  bool frame_header_sent_{};
   // Normally we'd use the encoding buffer, but since we need to mutate the
   // buffer we instead maintain our own.
   Buffer::OwnedImpl buffer_{};
@@ -16,7 +16,7 @@ Http::FilterFactoryCb GrpcJsonTranscoderFilterConfig::createFilterFactoryFromPro
         proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
   JsonTranscoderConfigSharedPtr filter_config =
-      std::make_shared<JsonTranscoderConfig>(proto_config, context.api());
+      std::make_shared<JsonTranscoderConfig>(proto_config, context.api(), context.threadLocal());
 
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<JsonTranscoderFilter>(*filter_config));
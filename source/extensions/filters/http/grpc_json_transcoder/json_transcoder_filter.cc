@@ -17,11 +17,13 @@
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "google/api/annotations.pb.h"
 #include "google/api/http.pb.h"
 #include "google/api/httpbody.pb.h"
 #include "grpc_transcoding/json_request_translator.h"
 #include "grpc_transcoding/path_matcher_utility.h"
+#include "google/protobuf/type.pb.h"
 #include "grpc_transcoding/response_to_json_translator.h"
 
 using Envoy::Protobuf::FileDescriptorSet;
@@ -91,12 +93,57 @@ private:
   std::unique_ptr<TranscoderInputStream> response_stream_;
 };
 
+// A TypeResolver which caches the types it resolves from the descriptor pool, so that a descriptor
+// is converted to a type once per worker thread rather than by every request translator. It is not
+// thread safe.
+class CachingTypeResolver : public Protobuf::util::TypeResolver {
+public:
+  CachingTypeResolver(const Protobuf::DescriptorPool& descriptor_pool)
+      : resolver_(Protobuf::util::NewTypeResolverForDescriptorPool(Grpc::Common::typeUrlPrefix(),
+                                                                   &descriptor_pool)) {}
+
+  // Protobuf::util::TypeResolver
+  Status ResolveMessageType(const std::string& type_url, ProtobufWkt::Type* type) override {
+    auto it = message_types_.find(type_url);
+    if (it == message_types_.end()) {
+      ProtobufWkt::Type resolved;
+      const Status status = resolver_->ResolveMessageType(type_url, &resolved);
+      if (!status.ok()) {
+        return status;
+      }
+      it = message_types_.emplace(type_url, std::move(resolved)).first;
+    }
+    *type = it->second;
+    return Status();
+  }
+
+  Status ResolveEnumType(const std::string& type_url, ProtobufWkt::Enum* enum_type) override {
+    auto it = enum_types_.find(type_url);
+    if (it == enum_types_.end()) {
+      ProtobufWkt::Enum resolved;
+      const Status status = resolver_->ResolveEnumType(type_url, &resolved);
+      if (!status.ok()) {
+        return status;
+      }
+      it = enum_types_.emplace(type_url, std::move(resolved)).first;
+    }
+    *enum_type = it->second;
+    return Status();
+  }
+
+private:
+  std::unique_ptr<Protobuf::util::TypeResolver> resolver_;
+  absl::flat_hash_map<std::string, ProtobufWkt::Type> message_types_;
+  absl::flat_hash_map<std::string, ProtobufWkt::Enum> enum_types_;
+};
+
 } // namespace
 
 JsonTranscoderConfig::JsonTranscoderConfig(
     const envoy::extensions::filters::http::grpc_json_transcoder::v3alpha::GrpcJsonTranscoder&
         proto_config,
-    Api::Api& api) {
+    Api::Api& api, ThreadLocal::SlotAllocator& tls)
+    : tls_(tls.allocateSlot()) {
   FileDescriptorSet descriptor_set;
 
   switch (proto_config.descriptor_set_case()) {
@@ -161,9 +208,10 @@ JsonTranscoderConfig::JsonTranscoderConfig(
 
   path_matcher_ = pmb.Build();
 
-  type_helper_ = std::make_unique<google::grpc::transcoding::TypeHelper>(
-      Protobuf::util::NewTypeResolverForDescriptorPool(Grpc::Common::typeUrlPrefix(),
-                                                       &descriptor_pool_));
+  // The descriptor pool is complete and is only read from now on, so that the workers can share it.
+  tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalTypeHelper>(new CachingTypeResolver(descriptor_pool_));
+  });
 
   const auto& print_config = proto_config.print_options();
   print_options_.add_whitespace = print_config.add_whitespace();
@@ -236,8 +284,8 @@ ProtobufUtil::Status JsonTranscoderConfig::createTranscoder(
 
   for (const auto& binding : variable_bindings) {
     google::grpc::transcoding::RequestWeaver::BindingInfo resolved_binding;
-    status = type_helper_->ResolveFieldPath(*request_info.message_type, binding.field_path,
-                                            &resolved_binding.field_path);
+    status = typeHelper().ResolveFieldPath(*request_info.message_type, binding.field_path,
+                                           &resolved_binding.field_path);
     if (!status.ok()) {
       if (ignore_unknown_query_parameters_) {
         continue;
@@ -251,13 +299,13 @@ ProtobufUtil::Status JsonTranscoderConfig::createTranscoder(
   }
 
   std::unique_ptr<JsonRequestTranslator> request_translator{
-      new JsonRequestTranslator(type_helper_->Resolver(), &request_input, request_info,
+      new JsonRequestTranslator(typeHelper().Resolver(), &request_input, request_info,
                                 method_descriptor->client_streaming(), true)};
 
   const auto response_type_url =
       Grpc::Common::typeUrl(method_descriptor->output_type()->full_name());
   std::unique_ptr<ResponseToJsonTranslator> response_translator{new ResponseToJsonTranslator(
-      type_helper_->Resolver(), response_type_url, method_descriptor->server_streaming(),
+      typeHelper().Resolver(), response_type_url, method_descriptor->server_streaming(),
       &response_input, print_options_)};
 
   transcoder = std::make_unique<TranscoderImpl>(std::move(request_translator),
@@ -269,7 +317,7 @@ ProtobufUtil::Status
 JsonTranscoderConfig::methodToRequestInfo(const Protobuf::MethodDescriptor* method,
                                           google::grpc::transcoding::RequestInfo* info) {
   auto request_type_url = Grpc::Common::typeUrl(method->input_type()->full_name());
-  info->message_type = type_helper_->Info()->GetTypeByTypeUrl(request_type_url);
+  info->message_type = typeHelper().Info()->GetTypeByTypeUrl(request_type_url);
   if (info->message_type == nullptr) {
     ENVOY_LOG(debug, "Cannot resolve input-type: {}", method->input_type()->full_name());
     return ProtobufUtil::Status(Code::NOT_FOUND,
@@ -283,7 +331,7 @@ ProtobufUtil::Status
 JsonTranscoderConfig::translateProtoMessageToJson(const Protobuf::Message& message,
                                                   std::string* json_out) {
   return ProtobufUtil::BinaryToJsonString(
-      type_helper_->Resolver(), Grpc::Common::typeUrl(message.GetDescriptor()->full_name()),
+      typeHelper().Resolver(), Grpc::Common::typeUrl(message.GetDescriptor()->full_name()),
       message.SerializeAsString(), json_out, print_options_);
 }
 
@@ -299,7 +347,7 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::HeaderMap& h
     // just pass-through the request to upstream.
     return Http::FilterHeadersStatus::Continue;
   }
-  has_http_body_output_ = !method_->server_streaming() && hasHttpBodyAsOutputType();
+  has_http_body_output_ = hasHttpBodyAsOutputType();
 
   headers.removeContentLength();
   headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Grpc);
@@ -410,7 +458,7 @@ Http::FilterHeadersStatus JsonTranscoderFilter::encodeHeaders(Http::HeaderMap& h
 
   if (end_stream) {
 
-    if (method_->server_streaming()) {
+    if (method_->server_streaming() && !has_http_body_output_) {
       // When there is no body in a streaming response, a empty JSON array is
       // returned by default. Set the content type correctly.
       headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
@@ -428,6 +476,11 @@ Http::FilterHeadersStatus JsonTranscoderFilter::encodeHeaders(Http::HeaderMap& h
     return Http::FilterHeadersStatus::StopIteration;
   }
 
+  if (has_http_body_output_) {
+    // The body is streamed, and its content type is only known once the first message arrives.
+    headers.removeContentLength();
+    return Http::FilterHeadersStatus::StopIteration;
+  }
   return Http::FilterHeadersStatus::Continue;
 }
 
@@ -438,8 +491,15 @@ Http::FilterDataStatus JsonTranscoderFilter::encodeData(Buffer::Instance& data,
 
   has_body_ = true;
 
-  // TODO(dio): Add support for streaming case.
   if (has_http_body_output_) {
+    if (method_->server_streaming()) {
+      buildResponseFromStreamingHttpBodyOutput(data);
+      if (!has_http_body_content_type_ && !end_stream) {
+        // Keep holding the headers until a message gives the content type of the body.
+        return Http::FilterDataStatus::StopIterationNoBuffer;
+      }
+      return Http::FilterDataStatus::Continue;
+    }
     buildResponseFromHttpBodyOutput(*response_headers_, data);
     return Http::FilterDataStatus::StopIterationAndBuffer;
   }
@@ -474,11 +534,13 @@ Http::FilterTrailersStatus JsonTranscoderFilter::encodeTrailers(Http::HeaderMap&
     return Http::FilterTrailersStatus::Continue;
   }
 
-  Buffer::OwnedImpl data;
-  readToBuffer(*transcoder_->ResponseOutput(), data);
+  if (!has_http_body_output_) {
+    Buffer::OwnedImpl data;
+    readToBuffer(*transcoder_->ResponseOutput(), data);
 
-  if (data.length()) {
-    encoder_callbacks_->addEncodedData(data, true);
+    if (data.length()) {
+      encoder_callbacks_->addEncodedData(data, true);
+    }
   }
 
   if (method_->server_streaming()) {
@@ -561,6 +623,27 @@ void JsonTranscoderFilter::buildResponseFromHttpBodyOutput(Http::HeaderMap& resp
   }
 }
 
+void JsonTranscoderFilter::buildResponseFromStreamingHttpBodyOutput(Buffer::Instance& data) {
+  std::vector<Grpc::Frame> frames;
+  decoder_.decode(data, frames);
+
+  // The data of each message is written out as soon as the message is complete, so that the body
+  // is never buffered as a whole.
+  for (auto& frame : frames) {
+    if (frame.length_ == 0) {
+      continue;
+    }
+    Buffer::ZeroCopyInputStreamImpl stream(std::move(frame.data_));
+    google::api::HttpBody http_body;
+    http_body.ParseFromZeroCopyStream(&stream);
+    if (!has_http_body_content_type_) {
+      response_headers_->setContentType(http_body.content_type());
+      has_http_body_content_type_ = true;
+    }
+    data.add(http_body.data());
+  }
+}
+
 bool JsonTranscoderFilter::maybeConvertGrpcStatus(Grpc::Status::GrpcStatus grpc_status,
                                                   Http::HeaderMap& trailers) {
   if (!config_.convertGrpcStatus()) {
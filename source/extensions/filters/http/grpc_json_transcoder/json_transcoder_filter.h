@@ -6,6 +6,7 @@
 #include "envoy/http/filter.h"
 #include "envoy/http/header_map.h"
 #include "envoy/json/json_object.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
 #include "common/grpc/codec.h"
@@ -52,7 +53,7 @@ public:
   JsonTranscoderConfig(
       const envoy::extensions::filters::http::grpc_json_transcoder::v3alpha::GrpcJsonTranscoder&
           proto_config,
-      Api::Api& api);
+      Api::Api& api, ThreadLocal::SlotAllocator& tls);
 
   /**
    * Create an instance of Transcoder interface based on incoming request
@@ -99,9 +100,25 @@ private:
   void addFileDescriptor(const Protobuf::FileDescriptorProto& file);
   void addBuiltinSymbolDescriptor(const std::string& symbol_name);
 
+  /**
+   * @return the type helper of the current worker thread.
+   */
+  google::grpc::transcoding::TypeHelper& typeHelper() {
+    return tls_->getTyped<ThreadLocalTypeHelper>().type_helper_;
+  }
+
+  // The type helper caches the types it resolves from the descriptor pool, and it is not thread
+  // safe, so each worker thread has its own.
+  struct ThreadLocalTypeHelper : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalTypeHelper(Protobuf::util::TypeResolver* type_resolver)
+        : type_helper_(type_resolver) {}
+
+    google::grpc::transcoding::TypeHelper type_helper_;
+  };
+
   Protobuf::DescriptorPool descriptor_pool_;
   google::grpc::transcoding::PathMatcherPtr<const Protobuf::MethodDescriptor*> path_matcher_;
-  std::unique_ptr<google::grpc::transcoding::TypeHelper> type_helper_;
+  ThreadLocal::SlotPtr tls_;
   Protobuf::util::JsonPrintOptions print_options_;
 
   bool match_incoming_request_route_{false};
@@ -142,6 +159,7 @@ public:
 private:
   bool readToBuffer(Protobuf::io::ZeroCopyInputStream& stream, Buffer::Instance& data);
   void buildResponseFromHttpBodyOutput(Http::HeaderMap& response_headers, Buffer::Instance& data);
+  void buildResponseFromStreamingHttpBodyOutput(Buffer::Instance& data);
   bool maybeConvertGrpcStatus(Grpc::Status::GrpcStatus grpc_status, Http::HeaderMap& trailers);
   bool hasHttpBodyAsOutputType();
 
@@ -157,6 +175,7 @@ private:
 
   bool error_{false};
   bool has_http_body_output_{false};
+  bool has_http_body_content_type_{false};
   bool has_body_{false};
 };
 
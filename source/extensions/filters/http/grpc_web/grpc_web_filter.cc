@@ -96,8 +96,8 @@ Http::FilterDataStatus GrpcWebFilter::decodeData(Buffer::Instance& data, bool en
     return Http::FilterDataStatus::Continue;
   }
 
-  // Parse application/grpc-web-text format.
-  const uint64_t available = data.length() + decoding_buffer_.length();
+  // Parse application/grpc-web-text format, decoding the base64 text as it streams.
+  const uint64_t available = data.length() + request_decoder_.pending();
   if (end_stream) {
     if (available == 0) {
       return Http::FilterDataStatus::Continue;
@@ -109,17 +109,10 @@ Http::FilterDataStatus GrpcWebFilter::decodeData(Buffer::Instance& data, bool en
                                          absl::nullopt, RcDetails::get().GrpcDecodeFailedDueToSize);
       return Http::FilterDataStatus::StopIterationNoBuffer;
     }
-  } else if (available < 4) {
-    decoding_buffer_.move(data);
-    return Http::FilterDataStatus::StopIterationNoBuffer;
   }
 
-  const uint64_t needed = available / 4 * 4 - decoding_buffer_.length();
-  decoding_buffer_.move(data, needed);
-  const std::string decoded = Base64::decode(
-      std::string(static_cast<const char*>(decoding_buffer_.linearize(decoding_buffer_.length())),
-                  decoding_buffer_.length()));
-  if (decoded.empty()) {
+  Buffer::OwnedImpl decoded;
+  if (!request_decoder_.decode(data, decoded)) {
     // Error happened when decoding base64.
     decoder_callbacks_->sendLocalReply(Http::Code::BadRequest,
                                        "Bad gRPC-web request, invalid base64 data.", nullptr,
@@ -127,11 +120,13 @@ Http::FilterDataStatus GrpcWebFilter::decodeData(Buffer::Instance& data, bool en
     return Http::FilterDataStatus::StopIterationNoBuffer;
   }
 
-  decoding_buffer_.drain(decoding_buffer_.length());
-  decoding_buffer_.move(data);
-  data.add(decoded);
+  data.drain(data.length());
+  data.move(decoded);
   // Any block of 4 bytes or more should have been decoded and passed through.
-  ASSERT(decoding_buffer_.length() < 4);
+  ASSERT(request_decoder_.pending() < 4);
+  if (data.length() == 0 && !end_stream) {
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
   return Http::FilterDataStatus::Continue;
 }
 
@@ -152,7 +147,7 @@ Http::FilterHeadersStatus GrpcWebFilter::encodeHeaders(Http::HeaderMap& headers,
   return Http::FilterHeadersStatus::Continue;
 }
 
-Http::FilterDataStatus GrpcWebFilter::encodeData(Buffer::Instance& data, bool) {
+Http::FilterDataStatus GrpcWebFilter::encodeData(Buffer::Instance& data, bool end_stream) {
   if (!is_grpc_web_request_) {
     return Http::FilterDataStatus::Continue;
   }
@@ -162,27 +157,20 @@ Http::FilterDataStatus GrpcWebFilter::encodeData(Buffer::Instance& data, bool) {
     return Http::FilterDataStatus::Continue;
   }
 
-  // The decoder always consumes and drains the given buffer. Incomplete data frame is buffered
-  // inside the decoder.
-  std::vector<Grpc::Frame> frames;
-  decoder_.decode(data, frames);
-  if (frames.empty()) {
-    // We don't have enough data to decode for one single frame, stop iteration until more data
+  // The gRPC frames are encoded as they stream, only the bytes of an incomplete base64 group of a
+  // frame are kept until more data comes in.
+  Buffer::OwnedImpl encoded;
+  response_encoder_.encode(data, encoded);
+  data.drain(data.length());
+  if (end_stream) {
+    response_encoder_.flush(encoded);
+  }
+  data.move(encoded);
+  if (data.length() == 0 && !end_stream) {
+    // We don't have enough data to encode a single base64 group, stop iteration until more data
     // comes in.
     return Http::FilterDataStatus::StopIterationNoBuffer;
   }
-
-  // Encodes the decoded gRPC frames with base64.
-  for (auto& frame : frames) {
-    Buffer::OwnedImpl temp;
-    temp.add(&frame.flags_, 1);
-    const uint32_t length = htonl(frame.length_);
-    temp.add(&length, 4);
-    if (frame.length_ > 0) {
-      temp.add(*frame.data_);
-    }
-    data.add(Base64::encode(temp, temp.length()));
-  }
   return Http::FilterDataStatus::Continue;
 }
 
@@ -219,7 +207,10 @@ Http::FilterTrailersStatus GrpcWebFilter::encodeTrailers(Http::HeaderMap& traile
   buffer.add(&length, 4);
   buffer.move(temp);
   if (is_text_response_) {
-    Buffer::OwnedImpl encoded(Base64::encode(buffer, buffer.length()));
+    // Pads the encoding of a response frame cut short, if any, before the trailers frame.
+    Buffer::OwnedImpl encoded;
+    response_encoder_.flush(encoded);
+    encoded.add(Base64::encode(buffer, buffer.length()));
     encoder_callbacks_->addEncodedData(encoded, true);
   } else {
     encoder_callbacks_->addEncodedData(buffer, true);
@@ -227,6 +218,29 @@ Http::FilterTrailersStatus GrpcWebFilter::encodeTrailers(Http::HeaderMap& traile
   return Http::FilterTrailersStatus::Continue;
 }
 
+void GrpcWebFilter::Base64FrameEncoder::encode(const Buffer::Instance& input,
+                                               Buffer::Instance& output) {
+  output_ = &output;
+  inspect(input);
+  output_ = nullptr;
+}
+
+bool GrpcWebFilter::Base64FrameEncoder::frameStart(uint8_t flags) {
+  encoder_.encode(&flags, 1, *output_);
+  return true;
+}
+
+void GrpcWebFilter::Base64FrameEncoder::frameDataStart() {
+  const uint32_t length = htonl(length_);
+  encoder_.encode(reinterpret_cast<const uint8_t*>(&length), sizeof(length), *output_);
+}
+
+void GrpcWebFilter::Base64FrameEncoder::frameData(uint8_t* data, uint64_t length) {
+  encoder_.encode(data, length, *output_);
+}
+
+void GrpcWebFilter::Base64FrameEncoder::frameDataEnd() { encoder_.flush(*output_); }
+
 void GrpcWebFilter::setupStatTracking(const Http::HeaderMap& headers) {
   cluster_ = decoder_callbacks_->clusterInfo();
   if (!cluster_) {
@@ -6,6 +6,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/base64.h"
 #include "common/common/non_copyable.h"
 #include "common/grpc/codec.h"
 #include "common/grpc/context_impl.h"
@@ -55,6 +56,25 @@ public:
 private:
   friend class GrpcWebFilterTest;
 
+  // Encodes the gRPC frames of a response in base64 as they stream, padding the encoding of each
+  // frame so that the client can decode a frame as soon as it has received it.
+  class Base64FrameEncoder : public Grpc::FrameInspector {
+  public:
+    void encode(const Buffer::Instance& input, Buffer::Instance& output);
+    void flush(Buffer::Instance& output) { encoder_.flush(output); }
+
+  protected:
+    // Grpc::FrameInspector
+    bool frameStart(uint8_t flags) override;
+    void frameDataStart() override;
+    void frameData(uint8_t* data, uint64_t length) override;
+    void frameDataEnd() override;
+
+  private:
+    Base64StreamEncoder encoder_;
+    Buffer::Instance* output_{};
+  };
+
   void chargeStat(const Http::HeaderMap& headers);
   void setupStatTracking(const Http::HeaderMap& headers);
   bool isGrpcWebRequest(const Http::HeaderMap& headers);
@@ -67,8 +87,8 @@ private:
   Http::StreamEncoderFilterCallbacks* encoder_callbacks_{};
   bool is_text_request_{};
   bool is_text_response_{};
-  Buffer::OwnedImpl decoding_buffer_;
-  Grpc::Decoder decoder_;
+  Base64StreamDecoder request_decoder_;
+  Base64FrameEncoder response_encoder_;
   absl::optional<Grpc::Context::RequestNames> request_names_;
   bool is_grpc_web_request_{};
   Grpc::Context& context_;
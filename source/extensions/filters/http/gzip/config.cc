@@ -15,7 +15,7 @@ Http::FilterFactoryCb GzipFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::gzip::v3alpha::Gzip& proto_config,
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
   GzipFilterConfigSharedPtr config = std::make_shared<GzipFilterConfig>(
-      proto_config, stats_prefix, context.scope(), context.runtime());
+      proto_config, stats_prefix, context.scope(), context.runtime(), context.threadLocal());
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<GzipFilter>(config));
   };
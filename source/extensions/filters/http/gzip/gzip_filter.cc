@@ -27,6 +27,9 @@ const uint64_t MinimumContentLength = 30;
 // When summed to window bits, this sets a gzip header and trailer around the compressed data.
 const uint64_t GzipHeaderValue = 16;
 
+// Maximum number of compressors kept for reuse by each worker thread.
+const uint64_t MaxPooledCompressors = 16;
+
 // Used for verifying accept-encoding values.
 const char ZeroQvalueString[] = "q=0";
 
@@ -42,7 +45,8 @@ const std::vector<std::string>& defaultContentEncoding() {
 
 GzipFilterConfig::GzipFilterConfig(
     const envoy::extensions::filters::http::gzip::v3alpha::Gzip& gzip,
-    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    ThreadLocal::SlotAllocator& tls)
     : compression_level_(compressionLevelEnum(gzip.compression_level())),
       compression_strategy_(compressionStrategyEnum(gzip.compression_strategy())),
       content_length_(contentLengthUint(gzip.content_length().value())),
@@ -51,7 +55,33 @@ GzipFilterConfig::GzipFilterConfig(
       content_type_values_(contentTypeSet(gzip.content_type())),
       disable_on_etag_header_(gzip.disable_on_etag_header()),
       remove_accept_encoding_header_(gzip.remove_accept_encoding_header()),
-      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime) {}
+      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime),
+      tls_(tls.allocateSlot()) {
+  tls_->set([](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalCompressors>();
+  });
+}
+
+Compressor::ZlibCompressorImplPtr GzipFilterConfig::acquireCompressor() {
+  auto& compressors = tls_->getTyped<ThreadLocalCompressors>().compressors_;
+  if (!compressors.empty()) {
+    Compressor::ZlibCompressorImplPtr compressor = std::move(compressors.back());
+    compressors.pop_back();
+    return compressor;
+  }
+
+  auto compressor = std::make_unique<Compressor::ZlibCompressorImpl>();
+  compressor->init(compressionLevel(), compressionStrategy(), windowBits(), memoryLevel());
+  return compressor;
+}
+
+void GzipFilterConfig::releaseCompressor(Compressor::ZlibCompressorImplPtr&& compressor) {
+  auto& compressors = tls_->getTyped<ThreadLocalCompressors>().compressors_;
+  if (compressors.size() < MaxPooledCompressors) {
+    compressor->reset();
+    compressors.push_back(std::move(compressor));
+  }
+}
 
 Compressor::ZlibCompressorImpl::CompressionLevel GzipFilterConfig::compressionLevelEnum(
     envoy::extensions::filters::http::gzip::v3alpha::Gzip::CompressionLevel::Enum
@@ -103,6 +133,12 @@ uint64_t GzipFilterConfig::windowBitsUint(Protobuf::uint32 window_bits) {
 GzipFilter::GzipFilter(const GzipFilterConfigSharedPtr& config)
     : skip_compression_{true}, config_(config) {}
 
+void GzipFilter::onDestroy() {
+  if (compressor_ != nullptr) {
+    config_->releaseCompressor(std::move(compressor_));
+  }
+}
+
 Http::FilterHeadersStatus GzipFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
   if (config_->runtime().snapshot().featureEnabled("gzip.filter_enabled", 100) &&
       isAcceptEncodingAllowed(headers)) {
@@ -125,8 +161,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
     insertVaryHeader(headers);
     headers.removeContentLength();
     headers.setReferenceContentEncoding(Http::Headers::get().ContentEncodingValues.Gzip);
-    compressor_.init(config_->compressionLevel(), config_->compressionStrategy(),
-                     config_->windowBits(), config_->memoryLevel());
+    compressor_ = config_->acquireCompressor();
     config_->stats().compressed_.inc();
   } else if (!skip_compression_) {
     skip_compression_ = true;
@@ -138,7 +173,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
 Http::FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_stream) {
   if (!skip_compression_) {
     config_->stats().total_uncompressed_bytes_.add(data.length());
-    compressor_.compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
+    compressor_->compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
     config_->stats().total_compressed_bytes_.add(data.length());
   }
   return Http::FilterDataStatus::Continue;
@@ -147,7 +182,7 @@ Http::FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_s
 Http::FilterTrailersStatus GzipFilter::encodeTrailers(Http::HeaderMap&) {
   if (!skip_compression_) {
     Buffer::OwnedImpl empty_buffer;
-    compressor_.compress(empty_buffer, Compressor::State::Finish);
+    compressor_->compress(empty_buffer, Compressor::State::Finish);
     config_->stats().total_compressed_bytes_.add(empty_buffer.length());
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "envoy/extensions/filters/http/gzip/v3alpha/gzip.pb.h"
 #include "envoy/http/filter.h"
 #include "envoy/http/header_map.h"
@@ -7,6 +9,7 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/compressor/zlib_compressor_impl.h"
@@ -55,7 +58,20 @@ class GzipFilterConfig {
 
 public:
   GzipFilterConfig(const envoy::extensions::filters::http::gzip::v3alpha::Gzip& gzip,
-                   const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime);
+                   const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+                   ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @return a compressor initialized with the configured parameters. It is taken from the pool of
+   *         the worker thread if there is one, so that its memory is not allocated again.
+   */
+  Compressor::ZlibCompressorImplPtr acquireCompressor();
+
+  /**
+   * Return a compressor to the pool of the worker thread, to be reused by another stream. It does
+   * not matter whether its stream is finished.
+   */
+  void releaseCompressor(Compressor::ZlibCompressorImplPtr&& compressor);
 
   Compressor::ZlibCompressorImpl::CompressionLevel compressionLevel() const {
     return compression_level_;
@@ -91,6 +107,11 @@ private:
     return GzipStats{ALL_GZIP_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
   }
 
+  // The compressors which are not in use on a worker thread.
+  struct ThreadLocalCompressors : public ThreadLocal::ThreadLocalObject {
+    std::vector<Compressor::ZlibCompressorImplPtr> compressors_;
+  };
+
   Compressor::ZlibCompressorImpl::CompressionLevel compression_level_;
   Compressor::ZlibCompressorImpl::CompressionStrategy compression_strategy_;
 
@@ -103,6 +124,7 @@ private:
   bool remove_accept_encoding_header_;
   GzipStats stats_;
   Runtime::Loader& runtime_;
+  ThreadLocal::SlotPtr tls_;
 };
 using GzipFilterConfigSharedPtr = std::shared_ptr<GzipFilterConfig>;
 
@@ -114,7 +136,7 @@ public:
   GzipFilter(const GzipFilterConfigSharedPtr& config);
 
   // Http::StreamFilterBase
-  void onDestroy() override{};
+  void onDestroy() override;
 
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
@@ -159,7 +181,7 @@ private:
 
   bool skip_compression_;
   Buffer::OwnedImpl compressed_data_;
-  Compressor::ZlibCompressorImpl compressor_;
+  Compressor::ZlibCompressorImplPtr compressor_;
   GzipFilterConfigSharedPtr config_;
 
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{nullptr};
@@ -1,5 +1,7 @@
 #include "extensions/filters/http/header_to_metadata/header_to_metadata_filter.h"
 
+#include <algorithm>
+
 #include "envoy/extensions/filters/http/header_to_metadata/v3alpha/header_to_metadata.pb.h"
 
 #include "common/common/base64.h"
@@ -27,15 +29,13 @@ Config::Config(const envoy::extensions::filters::http::header_to_metadata::v3alp
 }
 
 bool Config::configToVector(const ProtobufRepeatedRule& proto_rules,
-                            HeaderToMetadataRules& vector) {
+                            HeaderToMetadataRules& rules) {
   if (proto_rules.empty()) {
     ENVOY_LOG(debug, "no rules provided");
     return false;
   }
 
   for (const auto& entry : proto_rules) {
-    std::pair<Http::LowerCaseString, Rule> rule = {Http::LowerCaseString(entry.header()), entry};
-
     // Rule must have at least one of the `on_header_*` fields set.
     if (!entry.has_on_header_present() && !entry.has_on_header_missing()) {
       const auto& error = fmt::format("header to metadata filter: rule for header '{}' has neither "
@@ -44,12 +44,42 @@ bool Config::configToVector(const ProtobufRepeatedRule& proto_rules,
       throw EnvoyException(error);
     }
 
-    vector.push_back(rule);
+    HeaderToMetadataRules::Entry rule{entry, headerPosition(entry.header(), rules), 0, 0};
+    if (entry.has_on_header_present()) {
+      rule.present_namespace_ =
+          namespacePosition(entry.on_header_present().metadata_namespace(), rules);
+    }
+    if (entry.has_on_header_missing()) {
+      rule.missing_namespace_ =
+          namespacePosition(entry.on_header_missing().metadata_namespace(), rules);
+    }
+    rules.rules_.push_back(std::move(rule));
   }
 
   return true;
 }
 
+size_t Config::headerPosition(const std::string& header, HeaderToMetadataRules& rules) {
+  Http::LowerCaseString lower_case_header(header);
+  auto it = rules.header_positions_.find(lower_case_header.get());
+  if (it != rules.header_positions_.end()) {
+    return it->second;
+  }
+  rules.header_positions_.emplace(lower_case_header.get(), rules.headers_.size());
+  rules.headers_.push_back(std::move(lower_case_header));
+  return rules.headers_.size() - 1;
+}
+
+size_t Config::namespacePosition(const std::string& nspace, HeaderToMetadataRules& rules) {
+  const std::string& name = nspace.empty() ? HttpFilterNames::get().HeaderToMetadata : nspace;
+  auto it = std::find(rules.namespaces_.begin(), rules.namespaces_.end(), name);
+  if (it != rules.namespaces_.end()) {
+    return it - rules.namespaces_.begin();
+  }
+  rules.namespaces_.push_back(name);
+  return rules.namespaces_.size() - 1;
+}
+
 HeaderToMetadataFilter::HeaderToMetadataFilter(const ConfigSharedPtr config) : config_(config) {}
 
 HeaderToMetadataFilter::~HeaderToMetadataFilter() = default;
@@ -79,7 +109,7 @@ void HeaderToMetadataFilter::setEncoderFilterCallbacks(
   encoder_callbacks_ = &callbacks;
 }
 
-bool HeaderToMetadataFilter::addMetadata(StructMap& map, const std::string& meta_namespace,
+bool HeaderToMetadataFilter::addMetadata(absl::optional<ProtobufWkt::Struct>& metadata,
                                          const std::string& key, absl::string_view value,
                                          ValueType type, ValueEncode encode) const {
   ProtobufWkt::Value val;
@@ -132,32 +162,27 @@ bool HeaderToMetadataFilter::addMetadata(StructMap& map, const std::string& meta
     return false;
   }
 
-  // Have we seen this namespace before?
-  auto namespace_iter = map.find(meta_namespace);
-  if (namespace_iter == map.end()) {
-    map[meta_namespace] = ProtobufWkt::Struct();
-    namespace_iter = map.find(meta_namespace);
+  // Is this the first value of the namespace?
+  if (!metadata.has_value()) {
+    metadata.emplace();
   }
-
-  auto& keyval = namespace_iter->second;
-  (*keyval.mutable_fields())[key] = val;
+  (*metadata->mutable_fields())[key] = std::move(val);
 
   return true;
 }
 
-const std::string& HeaderToMetadataFilter::decideNamespace(const std::string& nspace) const {
-  return nspace.empty() ? HttpFilterNames::get().HeaderToMetadata : nspace;
-}
-
 void HeaderToMetadataFilter::writeHeaderToMetadata(Http::HeaderMap& headers,
                                                    const HeaderToMetadataRules& rules,
                                                    Http::StreamFilterCallbacks& callbacks) {
-  StructMap structs_by_namespace;
+  HeaderEntries header_entries(rules.headers_.size());
+  findHeaders(headers, rules, header_entries);
+  // The metadata of each namespace, only created once a value is added to it.
+  absl::InlinedVector<absl::optional<ProtobufWkt::Struct>, 2> structs_by_namespace(
+      rules.namespaces_.size());
 
-  for (const auto& rulePair : rules) {
-    const auto& header = rulePair.first;
-    const auto& rule = rulePair.second;
-    const Http::HeaderEntry* header_entry = headers.get(header);
+  for (const auto& entry : rules.rules_) {
+    const auto& rule = entry.rule_;
+    const Http::HeaderEntry* header_entry = header_entries[entry.header_];
 
     if (header_entry != nullptr && rule.has_on_header_present()) {
       const auto& keyval = rule.on_header_present();
@@ -165,24 +190,24 @@ void HeaderToMetadataFilter::writeHeaderToMetadata(Http::HeaderMap& headers,
                                                        : absl::string_view(keyval.value());
 
       if (!value.empty()) {
-        const auto& nspace = decideNamespace(keyval.metadata_namespace());
-        addMetadata(structs_by_namespace, nspace, keyval.key(), value, keyval.type(),
-                    keyval.encode());
+        addMetadata(structs_by_namespace[entry.present_namespace_], keyval.key(), value,
+                    keyval.type(), keyval.encode());
       } else {
         ENVOY_LOG(debug, "value is empty, not adding metadata");
       }
 
       if (rule.remove()) {
-        headers.remove(header);
+        headers.remove(rules.headers_[entry.header_]);
+        // Every entry of the header is removed, so the rules following see it as missing.
+        header_entries[entry.header_] = nullptr;
       }
     } else if (rule.has_on_header_missing()) {
       // Add metadata for the header missing case.
       const auto& keyval = rule.on_header_missing();
 
       if (!keyval.value().empty()) {
-        const auto& nspace = decideNamespace(keyval.metadata_namespace());
-        addMetadata(structs_by_namespace, nspace, keyval.key(), keyval.value(), keyval.type(),
-                    keyval.encode());
+        addMetadata(structs_by_namespace[entry.missing_namespace_], keyval.key(), keyval.value(),
+                    keyval.type(), keyval.encode());
       } else {
         ENVOY_LOG(debug, "value is empty, not adding metadata");
       }
@@ -190,13 +215,47 @@ void HeaderToMetadataFilter::writeHeaderToMetadata(Http::HeaderMap& headers,
   }
 
   // Any matching rules?
-  if (!structs_by_namespace.empty()) {
-    for (auto const& entry : structs_by_namespace) {
-      callbacks.streamInfo().setDynamicMetadata(entry.first, entry.second);
+  for (size_t i = 0; i < structs_by_namespace.size(); ++i) {
+    if (structs_by_namespace[i].has_value()) {
+      callbacks.streamInfo().setDynamicMetadata(rules.namespaces_[i],
+                                                structs_by_namespace[i].value());
     }
   }
 }
 
+void HeaderToMetadataFilter::findHeaders(const Http::HeaderMap& headers,
+                                         const HeaderToMetadataRules& rules,
+                                         HeaderEntries& entries) {
+  if (rules.headers_.size() < MIN_HEADERS_FOR_SINGLE_PASS) {
+    for (size_t i = 0; i < rules.headers_.size(); ++i) {
+      entries[i] = headers.get(rules.headers_[i]);
+    }
+    return;
+  }
+
+  struct Context {
+    const HeaderToMetadataRules& rules_;
+    HeaderEntries& entries_;
+    size_t remaining_;
+  };
+  Context context{rules, entries, rules.headers_.size()};
+  headers.iterate(
+      [](const Http::HeaderEntry& header, void* context) -> Http::HeaderMap::Iterate {
+        auto* find_context = static_cast<Context*>(context);
+        const auto it = find_context->rules_.header_positions_.find(header.key().getStringView());
+        // Like HeaderMap::get(), only the first entry of a header is used.
+        if (it != find_context->rules_.header_positions_.end() &&
+            find_context->entries_[it->second] == nullptr) {
+          find_context->entries_[it->second] = &header;
+          if (--find_context->remaining_ == 0) {
+            return Http::HeaderMap::Iterate::Break;
+          }
+        }
+        return Http::HeaderMap::Iterate::Continue;
+      },
+      &context);
+}
+
 } // namespace HeaderToMetadataFilter
 } // namespace HttpFilters
 } // namespace Extensions
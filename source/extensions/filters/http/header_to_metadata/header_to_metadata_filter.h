@@ -9,7 +9,10 @@
 
 #include "common/common/logger.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -20,11 +23,37 @@ using Rule = envoy::extensions::filters::http::header_to_metadata::v3alpha::Conf
 using ValueType = envoy::extensions::filters::http::header_to_metadata::v3alpha::Config::ValueType;
 using ValueEncode =
     envoy::extensions::filters::http::header_to_metadata::v3alpha::Config::ValueEncode;
-using HeaderToMetadataRules = std::vector<std::pair<Http::LowerCaseString, Rule>>;
+
+/**
+ * The rules of one direction, with the headers they look up and the metadata namespaces they write
+ * resolved at configuration time.
+ */
+struct HeaderToMetadataRules {
+  struct Entry {
+    Rule rule_;
+    // The position of the header of the rule in headers_.
+    size_t header_;
+    // The positions in namespaces_ of the namespaces of on_header_present and on_header_missing.
+    size_t present_namespace_;
+    size_t missing_namespace_;
+  };
+
+  std::vector<Entry> rules_;
+  // The distinct headers of the rules.
+  std::vector<Http::LowerCaseString> headers_;
+  // The position of each header in headers_, to find all of them in a single pass over the headers.
+  absl::flat_hash_map<std::string, size_t> header_positions_;
+  // The distinct metadata namespaces of the rules.
+  std::vector<std::string> namespaces_;
+};
 
 // TODO(yangminzhu): Make MAX_HEADER_VALUE_LEN configurable.
 const uint32_t MAX_HEADER_VALUE_LEN = 8 * 1024;
 
+// From this number of distinct headers, they are found with a single pass over the headers rather
+// than looked up one by one.
+const uint32_t MIN_HEADERS_FOR_SINGLE_PASS = 4;
+
 /**
  *  Encapsulates the filter configuration with STL containers and provides an area for any custom
  *  configuration logic.
@@ -33,8 +62,8 @@ class Config : public Logger::Loggable<Logger::Id::config> {
 public:
   Config(const envoy::extensions::filters::http::header_to_metadata::v3alpha::Config config);
 
-  HeaderToMetadataRules requestRules() const { return request_rules_; }
-  HeaderToMetadataRules responseRules() const { return response_rules_; }
+  const HeaderToMetadataRules& requestRules() const { return request_rules_; }
+  const HeaderToMetadataRules& responseRules() const { return response_rules_; }
   bool doResponse() const { return response_set_; }
   bool doRequest() const { return request_set_; }
 
@@ -52,13 +81,14 @@ private:
    *
    *  @param config A protobuf repeated field of metadata that specifies what headers to convert to
    *         metadata
-   *  @param vector A vector that will be populated with the configuration data from config
+   *  @param rules The rules that will be populated with the configuration data from config
    *  @return true if any configuration data was added to the vector, false otherwise. Can be used
    *          to validate whether the configuration was empty.
    */
   static bool configToVector(const ProtobufRepeatedRule&, HeaderToMetadataRules&);
 
-  const std::string& decideNamespace(const std::string& nspace) const;
+  static size_t headerPosition(const std::string& header, HeaderToMetadataRules& rules);
+  static size_t namespacePosition(const std::string& nspace, HeaderToMetadataRules& rules);
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
@@ -103,7 +133,7 @@ public:
   void setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks& callbacks) override;
 
 private:
-  using StructMap = std::map<std::string, ProtobufWkt::Struct>;
+  using HeaderEntries = absl::InlinedVector<const Http::HeaderEntry*, 8>;
 
   const ConfigSharedPtr config_;
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
@@ -121,9 +151,15 @@ private:
    */
   void writeHeaderToMetadata(Http::HeaderMap& headers, const HeaderToMetadataRules& rules,
                              Http::StreamFilterCallbacks& callbacks);
-  bool addMetadata(StructMap&, const std::string&, const std::string&, absl::string_view, ValueType,
-                   ValueEncode) const;
-  const std::string& decideNamespace(const std::string& nspace) const;
+  /**
+   *  findHeaders looks up the headers of the rules, with a single pass over the headers when there
+   *  are enough of them for it to be cheaper than looking them up one by one.
+   *  @param entries receives the first entry of each of the headers of the rules, or nullptr.
+   */
+  static void findHeaders(const Http::HeaderMap& headers, const HeaderToMetadataRules& rules,
+                          HeaderEntries& entries);
+  bool addMetadata(absl::optional<ProtobufWkt::Struct>&, const std::string&, absl::string_view,
+                   ValueType, ValueEncode) const;
 };
 
 } // namespace HeaderToMetadataFilter
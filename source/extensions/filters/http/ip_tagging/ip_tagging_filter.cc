@@ -76,7 +76,7 @@ Http::FilterHeadersStatus IpTaggingFilter::decodeHeaders(Http::HeaderMap& header
     return Http::FilterHeadersStatus::Continue;
   }
 
-  std::vector<std::string> tags =
+  const std::vector<std::string>& tags =
       config_->trie().getData(callbacks_->streamInfo().downstreamRemoteAddress());
 
   if (!tags.empty()) {
@@ -198,6 +198,14 @@ void AuthenticatorImpl::startVerify() {
     return;
   }
 
+  // Keep verifying with the expired keys, rather than holding the request until new ones are
+  // fetched.
+  if (jwks_obj != nullptr && jwks_data_->canRefreshInBackground()) {
+    jwks_data_->refreshInBackground([this]() { return create_jwks_fetcher_cb_(cm_); });
+    verifyKey();
+    return;
+  }
+
   // TODO(potatop): potential optimization.
   // Only one remote jwks will be fetched, verify will not continue util it is completed. This is
   // fine for provider name requirements, as each provider has only one issuer, but for allow
@@ -234,10 +242,14 @@ void AuthenticatorImpl::onDestroy() {
 
 // Verify with a specific public key.
 void AuthenticatorImpl::verifyKey() {
-  const Status status = ::google::jwt_verify::verifyJwt(*jwt_, *jwks_data_->getJwksObj());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  // The claims were checked by startVerify(), only the signature check can be skipped.
+  if (!jwks_data_->isJwtVerified(curr_token_->token())) {
+    const Status status = ::google::jwt_verify::verifyJwt(*jwt_, *jwks_data_->getJwksObj());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    jwks_data_->addVerifiedJwt(curr_token_->token());
   }
 
   // Forward the payload
@@ -1,6 +1,7 @@
 #include "extensions/filters/http/jwt_authn/jwks_cache.h"
 
 #include <chrono>
+#include <list>
 #include <unordered_map>
 
 #include "envoy/common/time.h"
@@ -9,7 +10,9 @@
 #include "common/common/logger.h"
 #include "common/config/datasource.h"
 #include "common/protobuf/utility.h"
+#include "common/tracing/http_tracer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "jwt_verify_lib/check_audience.h"
 
 using envoy::extensions::filters::http::jwt_authn::v3alpha::JwtAuthentication;
@@ -26,7 +29,9 @@ namespace {
 // Default cache expiration time in 5 minutes.
 constexpr int PubkeyCacheExpirationSec = 600;
 
-class JwksDataImpl : public JwksCache::JwksData, public Logger::Loggable<Logger::Id::jwt> {
+class JwksDataImpl : public JwksCache::JwksData,
+                     public Common::JwksFetcher::JwksReceiver,
+                     public Logger::Loggable<Logger::Id::jwt> {
 public:
   JwksDataImpl(const JwtProvider& jwt_provider, TimeSource& time_source, Api::Api& api)
       : jwt_provider_(jwt_provider), time_source_(time_source) {
@@ -60,26 +65,94 @@ public:
   bool isExpired() const override { return time_source_.monotonicTime() >= expiration_time_; }
 
   const ::google::jwt_verify::Jwks* setRemoteJwks(::google::jwt_verify::JwksPtr&& jwks) override {
-    return setKey(std::move(jwks), getRemoteJwksExpirationTime());
+    const auto* jwks_obj = setKey(std::move(jwks), getRemoteJwksExpirationTime());
+    // An expired remote Jwks stays in use for one more cache duration while it is refreshed.
+    stale_expiration_time_ = expiration_time_ + getRemoteJwksCacheDuration();
+    return jwks_obj;
+  }
+
+  bool canRefreshInBackground() const override {
+    return jwks_obj_ != nullptr && jwt_provider_.has_remote_jwks() &&
+           jwt_provider_.remote_jwks().async_refresh() &&
+           time_source_.monotonicTime() < stale_expiration_time_;
+  }
+
+  void refreshInBackground(const std::function<Common::JwksFetcherPtr()>& create_fetcher) override {
+    if (refreshing_) {
+      return;
+    }
+    // The fetcher is kept around once done, as it is not safe to destroy it from its own
+    // callbacks.
+    if (fetcher_ == nullptr) {
+      fetcher_ = create_fetcher();
+    }
+    ENVOY_LOG(debug, "Refreshing the jwks of issuer {} in the background", jwt_provider_.issuer());
+    refreshing_ = true;
+    fetcher_->fetch(jwt_provider_.remote_jwks().http_uri(), Tracing::NullSpan::instance(), *this);
+  }
+
+  bool isJwtVerified(const std::string& token) override {
+    const auto it = verified_jwt_map_.find(token);
+    if (it == verified_jwt_map_.end()) {
+      return false;
+    }
+    verified_jwts_.splice(verified_jwts_.begin(), verified_jwts_, it->second);
+    return true;
+  }
+
+  void addVerifiedJwt(const std::string& token) override {
+    const uint32_t cache_size = jwt_provider_.jwt_cache_size();
+    if (cache_size == 0 || verified_jwt_map_.find(token) != verified_jwt_map_.end()) {
+      return;
+    }
+    if (verified_jwts_.size() >= cache_size) {
+      verified_jwt_map_.erase(verified_jwts_.back());
+      verified_jwts_.pop_back();
+    }
+    verified_jwts_.push_front(token);
+    verified_jwt_map_.emplace(verified_jwts_.front(), verified_jwts_.begin());
+  }
+
+  // Common::JwksFetcher::JwksReceiver
+  void onJwksSuccess(::google::jwt_verify::JwksPtr&& jwks) override {
+    refreshing_ = false;
+    if (jwks->getStatus() != Status::Ok) {
+      // Keep using the current keys rather than failing all the requests.
+      ENVOY_LOG(warn, "Invalid jwks refreshed in the background for issuer: {}",
+                jwt_provider_.issuer());
+      return;
+    }
+    setRemoteJwks(std::move(jwks));
+  }
+
+  void onJwksError(Failure) override {
+    refreshing_ = false;
+    ENVOY_LOG(warn, "Failed to refresh the jwks of issuer {} in the background",
+              jwt_provider_.issuer());
   }
 
 private:
-  // Get the expiration time for a remote Jwks
-  std::chrono::steady_clock::time_point getRemoteJwksExpirationTime() const {
-    auto expire = time_source_.monotonicTime();
+  // Get the cache duration of a remote Jwks
+  std::chrono::milliseconds getRemoteJwksCacheDuration() const {
     if (jwt_provider_.has_remote_jwks() && jwt_provider_.remote_jwks().has_cache_duration()) {
-      expire += std::chrono::milliseconds(
+      return std::chrono::milliseconds(
           DurationUtil::durationToMilliseconds(jwt_provider_.remote_jwks().cache_duration()));
-    } else {
-      expire += std::chrono::seconds(PubkeyCacheExpirationSec);
     }
-    return expire;
+    return std::chrono::seconds(PubkeyCacheExpirationSec);
+  }
+
+  // Get the expiration time for a remote Jwks
+  std::chrono::steady_clock::time_point getRemoteJwksExpirationTime() const {
+    return time_source_.monotonicTime() + getRemoteJwksCacheDuration();
   }
 
   const ::google::jwt_verify::Jwks* setKey(::google::jwt_verify::JwksPtr&& jwks,
                                            MonotonicTime expire) {
     jwks_obj_ = std::move(jwks);
     expiration_time_ = expire;
+    // The verified tokens are only valid for the keys they were verified with.
+    verified_jwt_map_.clear();
+    verified_jwts_.clear();
     return jwks_obj_.get();
   }
 
@@ -92,6 +165,16 @@ private:
   TimeSource& time_source_;
   // The pubkey expiration time.
   MonotonicTime expiration_time_;
+  // The time until which an expired pubkey can be used while it is refreshed.
+  MonotonicTime stale_expiration_time_;
+  // The fetcher used to refresh the remote Jwks in the background.
+  Common::JwksFetcherPtr fetcher_;
+  // Whether a background refresh is in flight.
+  bool refreshing_{};
+  // The verified tokens, from the most to the least recently used.
+  std::list<std::string> verified_jwts_;
+  // The verified tokens indexed by their content.
+  absl::flat_hash_map<absl::string_view, std::list<std::string>::iterator> verified_jwt_map_;
 };
 
 class JwksCacheImpl : public JwksCache {
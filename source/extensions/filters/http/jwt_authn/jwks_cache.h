@@ -5,6 +5,8 @@
 #include "envoy/common/time.h"
 #include "envoy/extensions/filters/http/jwt_authn/v3alpha/config.pb.h"
 
+#include "extensions/filters/http/common/jwks_fetcher.h"
+
 #include "jwt_verify_lib/jwks.h"
 
 namespace Envoy {
@@ -26,11 +28,18 @@ using JwksCachePtr = std::unique_ptr<JwksCache>;
  *     if (!jwks_data->areAudiencesAllowed(jwt->getAudiences())) reject;
  *
  *     if (jwks_data->getJwksObj() == nullptr || jwks_data->isExpired()) {
- *        // Fetch remote Jwks.
- *        jwks_data->setRemoteJwks(remote_jwks_str);
+ *        if (jwks_data->canRefreshInBackground()) {
+ *          jwks_data->refreshInBackground(create_fetcher);
+ *        } else {
+ *          // Fetch remote Jwks.
+ *          jwks_data->setRemoteJwks(remote_jwks_str);
+ *        }
  *     }
  *
- *     verifyJwt(jwks_data->getJwksObj(), jwt);
+ *     if (!jwks_data->isJwtVerified(token)) {
+ *       verifyJwt(jwks_data->getJwksObj(), jwt);
+ *       jwks_data->addVerifiedJwt(token);
+ *     }
  */
 
 class JwksCache {
@@ -58,6 +67,22 @@ public:
     // Set a remote Jwks.
     virtual const ::google::jwt_verify::Jwks*
     setRemoteJwks(::google::jwt_verify::JwksPtr&& jwks) PURE;
+
+    // Return true if the jwks object is expired, but can still be used while a new one is
+    // fetched in the background.
+    virtual bool canRefreshInBackground() const PURE;
+
+    // Fetch a new remote Jwks in the background, unless a fetch is already in flight. The
+    // fetcher is only created for the first refresh, and reused by the following ones.
+    virtual void
+    refreshInBackground(const std::function<Common::JwksFetcherPtr()>& create_fetcher) PURE;
+
+    // Return true if the token was verified with the current jwks object. A cached token is
+    // marked as the most recently used one.
+    virtual bool isJwtVerified(const std::string& token) PURE;
+
+    // Remember a token verified with the current jwks object.
+    virtual void addVerifiedJwt(const std::string& token) PURE;
   };
 
   // Lookup issuer cache map. The cache only stores Jwks specified in the config.
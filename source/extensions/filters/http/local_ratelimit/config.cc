@@ -0,0 +1,33 @@
+#include "extensions/filters/http/local_ratelimit/config.h"
+
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.h"
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/filters/http/local_ratelimit/local_ratelimit.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+
+Http::FilterFactoryCb LocalRateLimitFilterConfig::createFilterFactoryFromProtoTyped(
+    const envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit& proto_config,
+    const std::string&, Server::Configuration::FactoryContext& context) {
+  // The token buckets are created here, on the main thread, whose dispatcher refills them.
+  FilterConfigSharedPtr filter_config = std::make_shared<FilterConfig>(
+      proto_config, context.dispatcher(), context.localInfo(), context.scope(), context.runtime());
+  return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamDecoderFilter(std::make_shared<Filter>(filter_config));
+  };
+}
+
+/**
+ * Static registration for the local rate limit filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(LocalRateLimitFilterConfig, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
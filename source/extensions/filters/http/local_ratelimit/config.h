@@ -0,0 +1,33 @@
+#pragma once
+
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.h"
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.validate.h"
+
+#include "extensions/filters/http/common/factory_base.h"
+#include "extensions/filters/http/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+
+/**
+ * Config registration for the local rate limit filter. @see NamedHttpFilterConfigFactory.
+ */
+class LocalRateLimitFilterConfig
+    : public Common::FactoryBase<
+          envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit> {
+public:
+  LocalRateLimitFilterConfig() : FactoryBase(HttpFilterNames::get().LocalRateLimit) {}
+
+private:
+  Http::FilterFactoryCb createFilterFactoryFromProtoTyped(
+      const envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit&
+          proto_config,
+      const std::string& stats_prefix, Server::Configuration::FactoryContext& context) override;
+};
+
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
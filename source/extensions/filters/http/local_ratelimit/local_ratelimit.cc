@@ -0,0 +1,184 @@
+#include "extensions/filters/http/local_ratelimit/local_ratelimit.h"
+
+#include <algorithm>
+
+#include "envoy/extensions/common/ratelimit/v3alpha/ratelimit.pb.h"
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.h"
+#include "envoy/http/codes.h"
+
+#include "common/common/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+
+struct RcDetailsValues {
+  const std::string RateLimited = "local_rate_limited";
+};
+using RcDetails = ConstSingleton<RcDetailsValues>;
+
+namespace {
+// Append a descriptor entry to a descriptor key. The values are length prefixed so that distinct
+// descriptors never make the same key.
+void appendEntry(std::string& key, absl::string_view entry_key, absl::string_view entry_value) {
+  absl::StrAppend(&key, entry_key.size(), ":", entry_key, entry_value.size(), ":", entry_value);
+}
+
+std::string descriptorKey(
+    const envoy::extensions::common::ratelimit::v3alpha::RateLimitDescriptor& descriptor) {
+  std::string key;
+  for (const auto& entry : descriptor.entries()) {
+    appendEntry(key, entry.key(), entry.value());
+  }
+  return key;
+}
+
+std::string descriptorKey(const RateLimit::Descriptor& descriptor) {
+  std::string key;
+  for (const auto& entry : descriptor.entries_) {
+    appendEntry(key, entry.key_, entry.value_);
+  }
+  return key;
+}
+} // namespace
+
+SharedTokenBucket::SharedTokenBucket(const envoy::type::v3alpha::TokenBucket& proto_config,
+                                     Event::Dispatcher& dispatcher)
+    : fill_timer_(dispatcher.createTimer([this] { onFillTimer(); })),
+      max_tokens_(proto_config.max_tokens()),
+      tokens_per_fill_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, tokens_per_fill, 1)),
+      fill_interval_(PROTOBUF_GET_MS_REQUIRED(proto_config, fill_interval)), tokens_(max_tokens_) {
+  if (fill_interval_ < std::chrono::milliseconds(50)) {
+    throw EnvoyException("local rate limit token bucket fill timer must be >= 50ms");
+  }
+  fill_timer_->enableTimer(fill_interval_);
+}
+
+void SharedTokenBucket::onFillTimer() {
+  // Relaxed consistency is used for all operations because we don't care about ordering, just the
+  // final atomic correctness.
+  uint32_t expected_tokens = tokens_.load(std::memory_order_relaxed);
+  uint32_t new_tokens_value;
+  do {
+    // expected_tokens is either initialized above or reloaded during the CAS failure below.
+    new_tokens_value = std::min(max_tokens_, expected_tokens + tokens_per_fill_);
+  } while (
+      !tokens_.compare_exchange_weak(expected_tokens, new_tokens_value, std::memory_order_relaxed));
+
+  ENVOY_LOG(trace, "local_rate_limit: fill tokens={}", new_tokens_value);
+  fill_timer_->enableTimer(fill_interval_);
+}
+
+bool SharedTokenBucket::consume() {
+  uint32_t expected_tokens = tokens_.load(std::memory_order_relaxed);
+  do {
+    if (expected_tokens == 0) {
+      return false;
+    }
+    // Loop while the weak CAS fails trying to subtract 1 from expected.
+  } while (!tokens_.compare_exchange_weak(expected_tokens, expected_tokens - 1,
+                                          std::memory_order_relaxed));
+  return true;
+}
+
+FilterConfig::FilterConfig(
+    const envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit& config,
+    Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
+    Runtime::Loader& runtime)
+    : stage_(config.stage()), local_info_(local_info), enabled_(config.runtime_enabled(), runtime),
+      stats_(generateStats(config.stat_prefix(), scope)) {
+  if (config.has_token_bucket()) {
+    default_bucket_ = std::make_unique<SharedTokenBucket>(config.token_bucket(), dispatcher);
+  }
+  for (const auto& descriptor : config.descriptors()) {
+    const std::string key = descriptorKey(descriptor.descriptor());
+    if (descriptors_.find(key) != descriptors_.end()) {
+      throw EnvoyException("local rate limit descriptors must be unique");
+    }
+    descriptors_.emplace(
+        key, std::make_unique<SharedTokenBucket>(descriptor.token_bucket(), dispatcher));
+  }
+}
+
+LocalRateLimitStats FilterConfig::generateStats(const std::string& prefix, Stats::Scope& scope) {
+  const std::string final_prefix = "http_local_rate_limit." + prefix;
+  return {ALL_LOCAL_RATE_LIMIT_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
+}
+
+bool FilterConfig::requestAllowed(const std::vector<RateLimit::Descriptor>& descriptors) {
+  bool matched = false;
+  for (const auto& descriptor : descriptors) {
+    const auto it = descriptors_.find(descriptorKey(descriptor));
+    if (it == descriptors_.end()) {
+      continue;
+    }
+    matched = true;
+    // The tokens already taken from the other buckets are not given back.
+    if (!it->second->consume()) {
+      return false;
+    }
+  }
+  return matched || default_bucket_ == nullptr || default_bucket_->consume();
+}
+
+Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool) {
+  if (!config_->enabled()) {
+    ENVOY_STREAM_LOG(trace, "local_rate_limit: runtime disabled", *decoder_callbacks_);
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  std::vector<RateLimit::Descriptor> descriptors;
+  if (config_->hasDescriptors()) {
+    populateDescriptors(headers, descriptors);
+  }
+
+  if (config_->requestAllowed(descriptors)) {
+    config_->stats().ok_.inc();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  config_->stats().rate_limited_.inc();
+  ENVOY_STREAM_LOG(trace, "local_rate_limit: rate limiting request", *decoder_callbacks_);
+  decoder_callbacks_->streamInfo().setResponseFlag(StreamInfo::ResponseFlag::RateLimited);
+  decoder_callbacks_->sendLocalReply(Http::Code::TooManyRequests, "", nullptr, absl::nullopt,
+                                     RcDetails::get().RateLimited);
+  return Http::FilterHeadersStatus::StopIteration;
+}
+
+void Filter::populateDescriptors(const Http::HeaderMap& headers,
+                                 std::vector<RateLimit::Descriptor>& descriptors) const {
+  Router::RouteConstSharedPtr route = decoder_callbacks_->route();
+  if (route == nullptr || route->routeEntry() == nullptr) {
+    return;
+  }
+  const Router::RouteEntry* route_entry = route->routeEntry();
+
+  // The same rate limit actions as the rate limit filter's are used, so that both filters can
+  // limit the same descriptors.
+  populateDescriptors(route_entry->rateLimitPolicy(), route_entry, headers, descriptors);
+  if (route_entry->includeVirtualHostRateLimits()) {
+    populateDescriptors(route_entry->virtualHost().rateLimitPolicy(), route_entry, headers,
+                        descriptors);
+  }
+}
+
+void Filter::populateDescriptors(const Router::RateLimitPolicy& rate_limit_policy,
+                                 const Router::RouteEntry* route_entry,
+                                 const Http::HeaderMap& headers,
+                                 std::vector<RateLimit::Descriptor>& descriptors) const {
+  for (const Router::RateLimitPolicyEntry& rate_limit :
+       rate_limit_policy.getApplicableRateLimit(config_->stage())) {
+    rate_limit.populateDescriptors(*route_entry, descriptors, config_->localInfo().clusterName(),
+                                   headers,
+                                   *decoder_callbacks_->streamInfo().downstreamRemoteAddress());
+  }
+}
+
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
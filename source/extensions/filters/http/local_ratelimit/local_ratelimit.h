@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/local_info/local_info.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/router/router.h"
+#include "envoy/router/router_ratelimit.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/type/v3alpha/token_bucket.pb.h"
+
+#include "common/common/logger.h"
+#include "common/runtime/runtime_protos.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+
+/**
+ * All local rate limit stats. @see stats_macros.h
+ */
+#define ALL_LOCAL_RATE_LIMIT_STATS(COUNTER)                                                        \
+  COUNTER(ok)                                                                                      \
+  COUNTER(rate_limited)
+
+/**
+ * Struct definition for all local rate limit stats. @see stats_macros.h
+ */
+struct LocalRateLimitStats {
+  ALL_LOCAL_RATE_LIMIT_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A token bucket shared by all the workers. The tokens are taken without locking, and a
+ * periodic timer of the main thread puts them back, as the network local rate limit filter does.
+ * Unlike TokenBucketImpl, this is safe to use from several threads at once.
+ */
+class SharedTokenBucket : Logger::Loggable<Logger::Id::filter> {
+public:
+  SharedTokenBucket(const envoy::type::v3alpha::TokenBucket& proto_config,
+                    Event::Dispatcher& dispatcher);
+
+  /**
+   * Take a single token from the bucket.
+   * @return false if the bucket is empty.
+   */
+  bool consume();
+
+private:
+  void onFillTimer();
+
+  const Event::TimerPtr fill_timer_;
+  const uint32_t max_tokens_;
+  const uint32_t tokens_per_fill_;
+  const std::chrono::milliseconds fill_interval_;
+  std::atomic<uint32_t> tokens_;
+};
+
+using SharedTokenBucketPtr = std::unique_ptr<SharedTokenBucket>;
+
+/**
+ * Configuration shared by all the streams of all the workers. Must be thread safe.
+ */
+class FilterConfig {
+public:
+  FilterConfig(
+      const envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit& config,
+      Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
+      Runtime::Loader& runtime);
+
+  /**
+   * Take a token from the bucket of each of the configured descriptors among the supplied ones,
+   * or from the default bucket if there is none of them.
+   * @return false if a bucket is empty, in which case the request must be limited.
+   */
+  bool requestAllowed(const std::vector<RateLimit::Descriptor>& descriptors);
+
+  bool enabled() { return enabled_.enabled(); }
+  bool hasDescriptors() const { return !descriptors_.empty(); }
+  uint32_t stage() const { return stage_; }
+  const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
+  LocalRateLimitStats& stats() { return stats_; }
+
+private:
+  static LocalRateLimitStats generateStats(const std::string& prefix, Stats::Scope& scope);
+
+  const uint32_t stage_;
+  const LocalInfo::LocalInfo& local_info_;
+  Runtime::FeatureFlag enabled_;
+  LocalRateLimitStats stats_;
+  SharedTokenBucketPtr default_bucket_;
+  // The buckets of the configured descriptors, by the key made of their entries.
+  absl::flat_hash_map<std::string, SharedTokenBucketPtr> descriptors_;
+};
+
+using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
+
+/**
+ * HTTP local rate limit filter. The requests consume the tokens of buckets shared by the workers
+ * of the process, so that they are limited without calling a rate limit service.
+ */
+class Filter : public Http::PassThroughDecoderFilter, Logger::Loggable<Logger::Id::filter> {
+public:
+  Filter(const FilterConfigSharedPtr& config) : config_(config) {}
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+
+private:
+  void populateDescriptors(const Http::HeaderMap& headers,
+                           std::vector<RateLimit::Descriptor>& descriptors) const;
+  void populateDescriptors(const Router::RateLimitPolicy& rate_limit_policy,
+                           const Router::RouteEntry* route_entry, const Http::HeaderMap& headers,
+                           std::vector<RateLimit::Descriptor>& descriptors) const;
+
+  const FilterConfigSharedPtr config_;
+};
+
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
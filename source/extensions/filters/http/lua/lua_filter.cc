@@ -511,6 +511,15 @@ FilterConfig::FilterConfig(const std::string& lua_code, ThreadLocal::SlotAllocat
   }
 }
 
+Filter::~Filter() {
+  // The stream handles are dropped first, so that the finished coroutines can be reused by the
+  // next streams of the worker.
+  request_stream_wrapper_.reset();
+  response_stream_wrapper_.reset();
+  config_->releaseCoroutine(std::move(request_coroutine_));
+  config_->releaseCoroutine(std::move(response_coroutine_));
+}
+
 void Filter::onDestroy() {
   destroyed_ = true;
   if (request_stream_wrapper_.get()) {
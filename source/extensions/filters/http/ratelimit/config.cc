@@ -19,13 +19,22 @@ namespace RateLimitFilter {
 
 Http::FilterFactoryCb RateLimitFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit& proto_config,
-    const std::string&, Server::Configuration::FactoryContext& context) {
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
   ASSERT(!proto_config.domain().empty());
-  FilterConfigSharedPtr filter_config(new FilterConfig(proto_config, context.localInfo(),
-                                                       context.scope(), context.runtime(),
-                                                       context.httpContext()));
   const std::chrono::milliseconds timeout =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, timeout, 20));
+  QuotaLeasesPtr quota_leases;
+  if (proto_config.has_quota_lease()) {
+    const auto grpc_service = proto_config.rate_limit_service().grpc_service();
+    quota_leases = std::make_unique<QuotaLeases>(
+        proto_config.quota_lease(), proto_config.domain(), context.threadLocal(),
+        context.timeSource(), stats_prefix, context.scope(), [&context, grpc_service, timeout]() {
+          return Filters::Common::RateLimit::rateLimitClient(context, grpc_service, timeout);
+        });
+  }
+  FilterConfigSharedPtr filter_config(
+      new FilterConfig(proto_config, context.localInfo(), context.scope(), context.runtime(),
+                       context.httpContext(), std::move(quota_leases)));
 
   return [proto_config, &context, timeout,
           filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
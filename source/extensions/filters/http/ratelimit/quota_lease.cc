@@ -0,0 +1,150 @@
+#include "extensions/filters/http/ratelimit/quota_lease.h"
+
+#include "common/protobuf/utility.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+using Filters::Common::RateLimit::LimitStatus;
+
+namespace {
+// Default time the leased hits can be used for.
+constexpr uint64_t DefaultLeaseDurationMs = 1000;
+
+// Default maximum number of descriptor sets each worker leases hits for.
+constexpr uint32_t DefaultMaxLeases = 1000;
+
+// The key of a descriptor set. The values are length prefixed, so that distinct descriptor sets
+// never make the same key.
+std::string descriptorsKey(const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  std::string key;
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    absl::StrAppend(&key, descriptor.entries_.size(), ";");
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      absl::StrAppend(&key, entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                      entry.value_);
+    }
+  }
+  return key;
+}
+} // namespace
+
+QuotaLeaseConfig::QuotaLeaseConfig(
+    const envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit::QuotaLease& config,
+    const std::string& domain, TimeSource& time_source, const std::string& stats_prefix,
+    Stats::Scope& scope, RateLimitClientFactory client_factory)
+    : domain_(domain), lease_size_(config.lease_size()),
+      refill_threshold_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, refill_threshold, config.lease_size() / 4)),
+      lease_duration_(PROTOBUF_GET_MS_OR_DEFAULT(config, lease_duration, DefaultLeaseDurationMs)),
+      max_leases_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_leases, DefaultMaxLeases)),
+      time_source_(time_source),
+      stats_(generateStats(stats_prefix + "ratelimit.quota_lease.", scope)),
+      client_factory_(std::move(client_factory)) {}
+
+QuotaLease::~QuotaLease() {
+  if (leasing_) {
+    client_->cancel();
+  }
+}
+
+bool QuotaLease::consume() {
+  const MonotonicTime now = config_.timeSource().monotonicTime();
+  if (expiration_ <= now) {
+    hits_ = 0;
+  }
+  if (hits_ == 0) {
+    maybeRequestLease(now);
+    return false;
+  }
+  hits_--;
+  if (hits_ <= config_.refillThreshold()) {
+    maybeRequestLease(now);
+  }
+  return true;
+}
+
+void QuotaLease::maybeRequestLease(MonotonicTime now) {
+  if (leasing_ || now < next_lease_) {
+    return;
+  }
+  if (client_ == nullptr) {
+    client_ = config_.createClient();
+  }
+  // The lease is not part of any request, hence not traced. It may be complete right away.
+  leasing_ = true;
+  client_->limit(*this, config_.domain(), descriptors_, Tracing::NullSpan::instance(),
+                 config_.leaseSize());
+}
+
+void QuotaLease::complete(LimitStatus status, Http::HeaderMapPtr&&, Http::HeaderMapPtr&&) {
+  leasing_ = false;
+  const MonotonicTime now = config_.timeSource().monotonicTime();
+  if (status != LimitStatus::OK) {
+    // The rate limit service keeps being called for each request until a lease is granted.
+    config_.stats().lease_failed_.inc();
+    next_lease_ = now + config_.leaseDuration();
+    return;
+  }
+  config_.stats().lease_ok_.inc();
+  if (expiration_ <= now) {
+    hits_ = 0;
+  }
+  hits_ += config_.leaseSize();
+  expiration_ = now + config_.leaseDuration();
+}
+
+bool QuotaLeaseCache::consume(const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  const std::string key = descriptorsKey(descriptors);
+  auto it = leases_by_key_.find(key);
+  if (it == leases_by_key_.end()) {
+    if (leases_.size() >= config_->maxLeases() && !evictIdleLease()) {
+      config_->stats().miss_.inc();
+      return false;
+    }
+    leases_.emplace_front(key, std::make_unique<QuotaLease>(*config_, descriptors));
+    it = leases_by_key_.emplace(key, leases_.begin()).first;
+  } else {
+    leases_.splice(leases_.begin(), leases_, it->second);
+  }
+  if (!it->second->second->consume()) {
+    config_->stats().miss_.inc();
+    return false;
+  }
+  config_->stats().hit_.inc();
+  return true;
+}
+
+bool QuotaLeaseCache::evictIdleLease() {
+  // Only the least recently used lease is looked at. A lease still holding hits is not evicted,
+  // as its hits were taken from the limit already and a new lease would take more.
+  if (leases_.empty() || !leases_.back().second->idle(config_->timeSource().monotonicTime())) {
+    return false;
+  }
+  leases_by_key_.erase(leases_.back().first);
+  leases_.pop_back();
+  config_->stats().lease_evicted_.inc();
+  return true;
+}
+
+QuotaLeases::QuotaLeases(
+    const envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit::QuotaLease& config,
+    const std::string& domain, ThreadLocal::SlotAllocator& tls, TimeSource& time_source,
+    const std::string& stats_prefix, Stats::Scope& scope, RateLimitClientFactory client_factory)
+    : tls_(tls.allocateSlot()) {
+  QuotaLeaseConfigSharedPtr lease_config = std::make_shared<QuotaLeaseConfig>(
+      config, domain, time_source, stats_prefix, scope, std::move(client_factory));
+  tls_->set([lease_config](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<QuotaLeaseCache>(lease_config);
+  });
+}
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ratelimit/v3alpha/rate_limit.pb.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/filters/common/ratelimit/ratelimit.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+/**
+ * All quota lease stats. @see stats_macros.h
+ */
+#define ALL_QUOTA_LEASE_STATS(COUNTER)                                                             \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(lease_ok)                                                                                \
+  COUNTER(lease_failed)                                                                            \
+  COUNTER(lease_evicted)
+
+/**
+ * Struct definition for all quota lease stats. @see stats_macros.h
+ */
+struct QuotaLeaseStats {
+  ALL_QUOTA_LEASE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+using RateLimitClientFactory = std::function<Filters::Common::RateLimit::ClientPtr()>;
+
+/**
+ * Configuration of the quota leases, shared by the lease caches of all the workers.
+ */
+class QuotaLeaseConfig {
+public:
+  QuotaLeaseConfig(
+      const envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit::QuotaLease& config,
+      const std::string& domain, TimeSource& time_source, const std::string& stats_prefix,
+      Stats::Scope& scope, RateLimitClientFactory client_factory);
+
+  const std::string& domain() const { return domain_; }
+  uint32_t leaseSize() const { return lease_size_; }
+  uint32_t refillThreshold() const { return refill_threshold_; }
+  std::chrono::milliseconds leaseDuration() const { return lease_duration_; }
+  uint32_t maxLeases() const { return max_leases_; }
+  TimeSource& timeSource() const { return time_source_; }
+  QuotaLeaseStats& stats() { return stats_; }
+  Filters::Common::RateLimit::ClientPtr createClient() const { return client_factory_(); }
+
+private:
+  static QuotaLeaseStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+    return QuotaLeaseStats{ALL_QUOTA_LEASE_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+  }
+
+  const std::string domain_;
+  const uint32_t lease_size_;
+  const uint32_t refill_threshold_;
+  const std::chrono::milliseconds lease_duration_;
+  const uint32_t max_leases_;
+  TimeSource& time_source_;
+  QuotaLeaseStats stats_;
+  const RateLimitClientFactory client_factory_;
+};
+
+using QuotaLeaseConfigSharedPtr = std::shared_ptr<QuotaLeaseConfig>;
+
+/**
+ * The hits leased from the rate limit service for a descriptor set, on a single worker.
+ */
+class QuotaLease : public Filters::Common::RateLimit::RequestCallbacks {
+public:
+  QuotaLease(QuotaLeaseConfig& config,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors)
+      : config_(config), descriptors_(descriptors) {}
+  ~QuotaLease() override;
+
+  /**
+   * Take a leased hit, requesting a new lease in the background when they run low.
+   * @return false if no leased hit is left, in which case the rate limit service must be called
+   *         for the request.
+   */
+  bool consume();
+
+  /**
+   * @return true if the lease has no unexpired hit and is neither requesting a lease nor waiting to
+   *         request one after a refusal, so that it can be dropped without losing anything.
+   */
+  bool idle(MonotonicTime now) const {
+    return !leasing_ && expiration_ <= now && next_lease_ <= now;
+  }
+
+  // Filters::Common::RateLimit::RequestCallbacks
+  void complete(Filters::Common::RateLimit::LimitStatus status, Http::HeaderMapPtr&&,
+                Http::HeaderMapPtr&&) override;
+
+private:
+  void maybeRequestLease(MonotonicTime now);
+
+  QuotaLeaseConfig& config_;
+  const std::vector<Envoy::RateLimit::Descriptor> descriptors_;
+  // Created by the first lease request, and reused by the next ones as leases are requested one
+  // at a time.
+  Filters::Common::RateLimit::ClientPtr client_;
+  uint32_t hits_{};
+  MonotonicTime expiration_;
+  // A refused lease is not requested again before this time.
+  MonotonicTime next_lease_;
+  bool leasing_{};
+};
+
+using QuotaLeasePtr = std::unique_ptr<QuotaLease>;
+
+/**
+ * Per worker cache of the quota leases, by descriptor set.
+ */
+class QuotaLeaseCache : public ThreadLocal::ThreadLocalObject {
+public:
+  QuotaLeaseCache(const QuotaLeaseConfigSharedPtr& config) : config_(config) {}
+
+  /**
+   * Take a leased hit for a descriptor set. @see QuotaLease::consume().
+   */
+  bool consume(const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  size_t size() const { return leases_.size(); }
+
+private:
+  using LeaseList = std::list<std::pair<std::string, QuotaLeasePtr>>;
+
+  bool evictIdleLease();
+
+  // Declared first, as the leases refer to it.
+  const QuotaLeaseConfigSharedPtr config_;
+  // The leases by descriptor set key, the most recently used first.
+  LeaseList leases_;
+  absl::flat_hash_map<std::string, LeaseList::iterator> leases_by_key_;
+};
+
+/**
+ * The quota leases of a rate limit filter configuration, with a lease cache on each worker.
+ */
+class QuotaLeases {
+public:
+  QuotaLeases(
+      const envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit::QuotaLease& config,
+      const std::string& domain, ThreadLocal::SlotAllocator& tls, TimeSource& time_source,
+      const std::string& stats_prefix, Stats::Scope& scope, RateLimitClientFactory client_factory);
+
+  /**
+   * Take a leased hit for a descriptor set on the current worker. @see QuotaLease::consume().
+   */
+  bool consume(const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+    return tls_->getTyped<QuotaLeaseCache>().consume(descriptors);
+  }
+
+private:
+  ThreadLocal::SlotPtr tls_;
+};
+
+using QuotaLeasesPtr = std::unique_ptr<QuotaLeases>;
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -55,12 +55,18 @@ void Filter::initiateCall(const Http::HeaderMap& headers) {
                                  route_entry, headers);
   }
 
-  if (!descriptors.empty()) {
-    state_ = State::Calling;
-    initiating_call_ = true;
-    client_->limit(*this, config_->domain(), descriptors, callbacks_->activeSpan());
-    initiating_call_ = false;
+  if (descriptors.empty()) {
+    return;
+  }
+  if (config_->quotaLeases() != nullptr && config_->quotaLeases()->consume(descriptors)) {
+    // A hit leased from the rate limit service was used, no call is needed.
+    return;
   }
+
+  state_ = State::Calling;
+  initiating_call_ = true;
+  client_->limit(*this, config_->domain(), descriptors, callbacks_->activeSpan());
+  initiating_call_ = false;
 }
 
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool) {
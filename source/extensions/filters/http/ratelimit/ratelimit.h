@@ -19,6 +19,7 @@
 
 #include "extensions/filters/common/ratelimit/ratelimit.h"
 #include "extensions/filters/common/ratelimit/stat_names.h"
+#include "extensions/filters/http/ratelimit/quota_lease.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -37,7 +38,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-               Runtime::Loader& runtime, Http::Context& http_context)
+               Runtime::Loader& runtime, Http::Context& http_context,
+               QuotaLeasesPtr&& quota_leases = nullptr)
       : domain_(config.domain()), stage_(static_cast<uint64_t>(config.stage())),
         request_type_(config.request_type().empty() ? stringToType("both")
                                                     : stringToType(config.request_type())),
@@ -47,7 +49,8 @@ public:
             config.rate_limited_as_resource_exhausted()
                 ? absl::make_optional(Grpc::Status::WellKnownGrpcStatus::ResourceExhausted)
                 : absl::nullopt),
-        http_context_(http_context), stat_names_(scope.symbolTable()) {}
+        http_context_(http_context), stat_names_(scope.symbolTable()),
+        quota_leases_(std::move(quota_leases)) {}
   const std::string& domain() const { return domain_; }
   const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
   uint64_t stage() const { return stage_; }
@@ -60,6 +63,8 @@ public:
   }
   Http::Context& httpContext() { return http_context_; }
   Filters::Common::RateLimit::StatNames& statNames() { return stat_names_; }
+  // @return the quota leases, or nullptr if the hits are not leased.
+  QuotaLeases* quotaLeases() { return quota_leases_.get(); }
 
 private:
   static FilterRequestType stringToType(const std::string& request_type) {
@@ -83,6 +88,7 @@ private:
   const absl::optional<Grpc::Status::GrpcStatus> rate_limited_grpc_status_;
   Http::Context& http_context_;
   Filters::Common::RateLimit::StatNames stat_names_;
+  const QuotaLeasesPtr quota_leases_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
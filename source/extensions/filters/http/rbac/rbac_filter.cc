@@ -2,11 +2,14 @@
 
 #include "envoy/extensions/filters/http/rbac/v3alpha/rbac.pb.h"
 #include "envoy/stats/scope.h"
+#include "envoy/stream_info/filter_state.h"
 
+#include "common/common/macros.h"
 #include "common/http/utility.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -20,6 +23,21 @@ struct RcDetailsValues {
 };
 using RcDetails = ConstSingleton<RcDetailsValues>;
 
+namespace {
+
+// The decisions of the connection only engines for a downstream connection, keyed by engine id,
+// along with their effective policy ids.
+class ConnectionDecisions : public StreamInfo::FilterState::Object {
+public:
+  absl::flat_hash_map<uint64_t, std::pair<bool, std::string>> decisions_;
+};
+
+const std::string& connectionDecisionsKey() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "envoy.filters.http.rbac.connection_decisions");
+}
+
+} // namespace
+
 RoleBasedAccessControlFilterConfig::RoleBasedAccessControlFilterConfig(
     const envoy::extensions::filters::http::rbac::v3alpha::RBAC& proto_config,
     const std::string& stats_prefix, Stats::Scope& scope)
@@ -74,8 +92,7 @@ Http::FilterHeadersStatus RoleBasedAccessControlFilter::decodeHeaders(Http::Head
   if (shadow_engine != nullptr) {
     std::string shadow_resp_code =
         Filters::Common::RBAC::DynamicMetadataKeysSingleton::get().EngineResultAllowed;
-    if (shadow_engine->allowed(*callbacks_->connection(), headers, callbacks_->streamInfo(),
-                               &effective_policy_id)) {
+    if (allowed(*shadow_engine, headers, &effective_policy_id)) {
       ENVOY_LOG(debug, "shadow allowed");
       config_->stats().shadow_allowed_.inc();
     } else {
@@ -103,7 +120,7 @@ Http::FilterHeadersStatus RoleBasedAccessControlFilter::decodeHeaders(Http::Head
   const auto engine =
       config_->engine(callbacks_->route(), Filters::Common::RBAC::EnforcementMode::Enforced);
   if (engine != nullptr) {
-    if (engine->allowed(*callbacks_->connection(), headers, callbacks_->streamInfo(), nullptr)) {
+    if (allowed(*engine, headers, nullptr)) {
       ENVOY_LOG(debug, "enforced allowed");
       config_->stats().allowed_.inc();
       return Http::FilterHeadersStatus::Continue;
@@ -120,6 +137,37 @@ Http::FilterHeadersStatus RoleBasedAccessControlFilter::decodeHeaders(Http::Head
   return Http::FilterHeadersStatus::Continue;
 }
 
+bool RoleBasedAccessControlFilter::allowed(
+    const Filters::Common::RBAC::RoleBasedAccessControlEngineImpl& engine,
+    const Http::HeaderMap& headers, std::string* effective_policy_id) {
+  if (!engine.connectionOnly()) {
+    return engine.allowed(*callbacks_->connection(), headers, callbacks_->streamInfo(),
+                          effective_policy_id);
+  }
+
+  StreamInfo::FilterState& filter_state = callbacks_->streamInfo().filterState();
+  if (!filter_state.hasData<ConnectionDecisions>(connectionDecisionsKey())) {
+    filter_state.setData(connectionDecisionsKey(), std::make_shared<ConnectionDecisions>(),
+                         StreamInfo::FilterState::StateType::Mutable,
+                         StreamInfo::FilterState::LifeSpan::DownstreamConnection);
+  }
+  auto& decisions =
+      filter_state.getDataMutable<ConnectionDecisions>(connectionDecisionsKey()).decisions_;
+  auto it = decisions.find(engine.id());
+  if (it == decisions.end()) {
+    std::string policy_id;
+    const bool allowed = engine.allowed(*callbacks_->connection(), headers,
+                                        callbacks_->streamInfo(), &policy_id);
+    it = decisions.emplace(engine.id(), std::make_pair(allowed, std::move(policy_id))).first;
+  } else {
+    ENVOY_LOG(debug, "reusing the decision of the connection");
+  }
+  if (effective_policy_id != nullptr) {
+    *effective_policy_id = it->second.second;
+  }
+  return it->second.first;
+}
+
 } // namespace RBACFilter
 } // namespace HttpFilters
 } // namespace Extensions
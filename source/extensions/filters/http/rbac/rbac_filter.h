@@ -92,6 +92,11 @@ public:
   void onDestroy() override {}
 
 private:
+  // Evaluate the engine, reusing the decision cached on the connection when it only depends on
+  // the connection.
+  bool allowed(const Filters::Common::RBAC::RoleBasedAccessControlEngineImpl& engine,
+               const Http::HeaderMap& headers, std::string* effective_policy_id);
+
   RoleBasedAccessControlFilterConfigSharedPtr config_;
   Http::StreamDecoderFilterCallbacks* callbacks_{};
 };
@@ -15,7 +15,10 @@ Http::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::router::v3alpha::Router& proto_config,
     const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
   Router::FilterConfigSharedPtr filter_config(new Router::FilterConfig(
-      stat_prefix, context, std::make_unique<Router::ShadowWriterImpl>(context.clusterManager()),
+      stat_prefix, context,
+      std::make_unique<Router::ShadowWriterImpl>(
+          context.clusterManager(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, shadow_stream_budget_bytes, 0)),
       proto_config));
 
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
@@ -15,20 +15,26 @@ namespace TapFilter {
 
 class HttpTapConfigFactoryImpl : public Extensions::Common::Tap::TapConfigFactory {
 public:
+  HttpTapConfigFactoryImpl(Runtime::Loader& runtime) : runtime_(runtime) {}
+
   // TapConfigFactory
   Extensions::Common::Tap::TapConfigSharedPtr
   createConfigFromProto(envoy::config::tap::v3alpha::TapConfig&& proto_config,
                         Extensions::Common::Tap::Sink* admin_streamer) override {
-    return std::make_shared<HttpTapConfigImpl>(std::move(proto_config), admin_streamer);
+    return std::make_shared<HttpTapConfigImpl>(std::move(proto_config), admin_streamer, runtime_);
   }
+
+private:
+  Runtime::Loader& runtime_;
 };
 
 Http::FilterFactoryCb TapFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::tap::v3alpha::Tap& proto_config,
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
   FilterConfigSharedPtr filter_config(new FilterConfigImpl(
-      proto_config, stats_prefix, std::make_unique<HttpTapConfigFactoryImpl>(), context.scope(),
-      context.admin(), context.singletonManager(), context.threadLocal(), context.dispatcher()));
+      proto_config, stats_prefix, std::make_unique<HttpTapConfigFactoryImpl>(context.runtime()),
+      context.scope(), context.admin(), context.singletonManager(), context.threadLocal(),
+      context.dispatcher()));
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     auto filter = std::make_shared<Filter>(filter_config);
     callbacks.addStreamFilter(filter);
@@ -27,10 +27,18 @@ Http::HeaderMap::Iterate fillHeaderList(const Http::HeaderEntry& header, void* c
 } // namespace
 
 HttpTapConfigImpl::HttpTapConfigImpl(envoy::config::tap::v3alpha::TapConfig&& proto_config,
-                                     Common::Tap::Sink* admin_streamer)
-    : TapCommon::TapConfigBaseImpl(std::move(proto_config), admin_streamer) {}
+                                     Common::Tap::Sink* admin_streamer,
+                                     Runtime::Loader& runtime)
+    : TapCommon::TapConfigBaseImpl(std::move(proto_config), admin_streamer), runtime_(runtime) {}
 
 HttpPerRequestTapperPtr HttpTapConfigImpl::createPerRequestTapper(uint64_t stream_id) {
+  // Requests that are not sampled are not tapped at all, so they neither run the matchers nor copy
+  // their headers and bodies.
+  if (tap_enabled_.has_value() &&
+      !runtime_.snapshot().featureEnabled(tap_enabled_.value().runtime_key(),
+                                          tap_enabled_.value().default_value())) {
+    return nullptr;
+  }
   return std::make_unique<HttpPerRequestTapperImpl>(shared_from_this(), stream_id);
 }
 
@@ -4,6 +4,7 @@
 #include "envoy/data/tap/v3alpha/common.pb.h"
 #include "envoy/data/tap/v3alpha/http.pb.h"
 #include "envoy/http/header_map.h"
+#include "envoy/runtime/runtime.h"
 
 #include "common/common/logger.h"
 
@@ -20,10 +21,13 @@ class HttpTapConfigImpl : public Extensions::Common::Tap::TapConfigBaseImpl,
                           public std::enable_shared_from_this<HttpTapConfigImpl> {
 public:
   HttpTapConfigImpl(envoy::config::tap::v3alpha::TapConfig&& proto_config,
-                    Extensions::Common::Tap::Sink* admin_streamer);
+                    Extensions::Common::Tap::Sink* admin_streamer, Runtime::Loader& runtime);
 
   // TapFilter::HttpTapConfig
   HttpPerRequestTapperPtr createPerRequestTapper(uint64_t stream_id) override;
+
+private:
+  Runtime::Loader& runtime_;
 };
 
 class HttpPerRequestTapperImpl : public HttpPerRequestTapper, Logger::Loggable<Logger::Id::tap> {
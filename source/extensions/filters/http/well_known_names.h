@@ -64,6 +64,12 @@ public:
   const std::string OriginalSrc = "envoy.filters.http.original_src";
   // Dynamic forward proxy filter
   const std::string DynamicForwardProxy = "envoy.filters.http.dynamic_forward_proxy";
+  // HTTP cache filter
+  const std::string Cache = "envoy.filters.http.cache";
+  // Decompressor filter
+  const std::string Decompressor = "envoy.filters.http.decompressor";
+  // Local rate limit filter
+  const std::string LocalRateLimit = "envoy.filters.http.local_ratelimit";
 };
 
 using HttpFilterNames = ConstSingleton<HttpFilterNameValues>;
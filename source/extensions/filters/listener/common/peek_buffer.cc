@@ -0,0 +1,56 @@
+#include "extensions/filters/listener/common/peek_buffer.h"
+
+#include <algorithm>
+
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+
+PeekBuffer& PeekBuffer::get() {
+  static thread_local PeekBuffer buffer;
+  return buffer;
+}
+
+Api::SysCallSizeResult PeekBuffer::peek(const Network::ConnectionSocket& socket,
+                                        uint64_t max_size) {
+  ASSERT(max_size <= MaxSize);
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().recv(socket.ioHandle().fd(), data_, max_size, MSG_PEEK);
+  // A failed recv() leaves the buffer as it was.
+  if (result.rc_ >= 0) {
+    socket_ = &socket;
+    length_ = result.rc_;
+  }
+  return result;
+}
+
+Api::SysCallSizeResult PeekBuffer::read(const Network::ConnectionSocket& socket, uint64_t size) {
+  ASSERT(size <= MaxSize);
+  socket_ = nullptr;
+  length_ = 0;
+  return Api::OsSysCallsSingleton::get().recv(socket.ioHandle().fd(), data_, size, 0);
+}
+
+absl::string_view PeekBuffer::peeked(const Network::ConnectionSocket& socket,
+                                     uint64_t max_size) const {
+  if (socket_ != &socket) {
+    return {};
+  }
+  return {reinterpret_cast<const char*>(data_), std::min(length_, max_size)};
+}
+
+void PeekBuffer::release(const Network::ConnectionSocket* socket) {
+  if (socket_ == socket) {
+    socket_ = nullptr;
+    length_ = 0;
+  }
+}
+
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+
+/**
+ * The buffer the listener filters of a thread peek the data of the accepted sockets into. The
+ * filters share a single buffer per thread rather than each having their own, and the buffer
+ * remembers the socket it was last peeked from, so that a filter inspecting the data of a socket
+ * after another one can start from the data already peeked rather than peeking again.
+ */
+class PeekBuffer : NonCopyable {
+public:
+  // The most data a filter can peek.
+  static constexpr uint64_t MaxSize = 64 * 1024;
+
+  /**
+   * @return PeekBuffer& the buffer of the calling thread.
+   */
+  static PeekBuffer& get();
+
+  /**
+   * Peek the data of a socket into the buffer, as a recv() with MSG_PEEK.
+   * @param socket supplies the socket.
+   * @param max_size supplies the most data to peek, at most MaxSize.
+   * @return Api::SysCallSizeResult the result of the recv().
+   */
+  Api::SysCallSizeResult peek(const Network::ConnectionSocket& socket, uint64_t max_size);
+
+  /**
+   * Read the data of a socket into the buffer, consuming it, as a recv() without MSG_PEEK. The
+   * data peeked from the socket before is forgotten, as it is stale once consumed.
+   * @param socket supplies the socket.
+   * @param size supplies the most data to read, at most MaxSize.
+   * @return Api::SysCallSizeResult the result of the recv().
+   */
+  Api::SysCallSizeResult read(const Network::ConnectionSocket& socket, uint64_t size);
+
+  /**
+   * @param socket supplies the socket.
+   * @param max_size supplies the most data to return.
+   * @return absl::string_view the data last peeked from the socket, which is empty if the buffer
+   *         was since peeked from another socket.
+   */
+  absl::string_view peeked(const Network::ConnectionSocket& socket, uint64_t max_size) const;
+
+  /**
+   * @return const uint8_t* the start of the buffer.
+   */
+  const uint8_t* data() const { return data_; }
+
+  /**
+   * Forget the data peeked from a socket, before the socket is destroyed. A filter calls this
+   * when it is destroyed, as the socket may not outlive the filters.
+   * @param socket supplies the socket, which is not dereferenced.
+   */
+  void release(const Network::ConnectionSocket* socket);
+
+private:
+  PeekBuffer() = default;
+
+  // The socket the buffer was last peeked from, and the length of its data in the buffer.
+  const Network::ConnectionSocket* socket_{};
+  uint64_t length_{};
+  uint8_t data_[MaxSize];
+};
+
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
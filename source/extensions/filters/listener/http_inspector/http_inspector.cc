@@ -4,11 +4,11 @@
 #include "envoy/network/listen_socket.h"
 #include "envoy/stats/scope.h"
 
-#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/macros.h"
 #include "common/http/headers.h"
 
+#include "extensions/filters/listener/common/peek_buffer.h"
 #include "extensions/transport_sockets/well_known_names.h"
 
 #include "absl/strings/match.h"
@@ -23,12 +23,20 @@ Config::Config(Stats::Scope& scope)
     : stats_{ALL_HTTP_INSPECTOR_STATS(POOL_COUNTER_PREFIX(scope, "http_inspector."))} {}
 
 const absl::string_view Filter::HTTP2_CONNECTION_PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
-thread_local uint8_t Filter::buf_[Config::MAX_INSPECT_SIZE];
+
+static_assert(Config::MAX_INSPECT_SIZE <= PeekBuffer::MaxSize,
+              "the inspected data must fit in the peek buffer");
 
 Filter::Filter(const ConfigSharedPtr config) : config_(config) {
   http_parser_init(&parser_, HTTP_REQUEST);
 }
 
+Filter::~Filter() {
+  if (peeked_socket_ != nullptr) {
+    PeekBuffer::get().release(peeked_socket_);
+  }
+}
+
 http_parser_settings Filter::settings_{
     nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
 };
@@ -47,7 +55,17 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
   }
 
   cb_ = &cb;
-  const ParseState parse_state = onRead();
+  // A listener filter run earlier, such as the TLS inspector not finding TLS, may have peeked
+  // enough data to tell the protocol without peeking again.
+  const absl::string_view peeked = PeekBuffer::get().peeked(socket, Config::MAX_INSPECT_SIZE);
+  ParseState parse_state = ParseState::Continue;
+  if (!peeked.empty()) {
+    peeked_socket_ = &socket;
+    parse_state = onPeeked(peeked);
+  }
+  if (parse_state == ParseState::Continue) {
+    parse_state = onRead();
+  }
   switch (parse_state) {
   case ParseState::Error:
     // As per discussion in https://github.com/envoyproxy/envoy/issues/7864
@@ -99,10 +117,9 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
 }
 
 ParseState Filter::onRead() {
-  auto& os_syscalls = Api::OsSysCallsSingleton::get();
-  const Network::ConnectionSocket& socket = cb_->socket();
-  const Api::SysCallSizeResult result =
-      os_syscalls.recv(socket.ioHandle().fd(), buf_, Config::MAX_INSPECT_SIZE, MSG_PEEK);
+  PeekBuffer& peek_buffer = PeekBuffer::get();
+  peeked_socket_ = &cb_->socket();
+  const Api::SysCallSizeResult result = peek_buffer.peek(cb_->socket(), Config::MAX_INSPECT_SIZE);
   ENVOY_LOG(trace, "http inspector: recv: {}", result.rc_);
   if (result.rc_ == -1 && result.errno_ == EAGAIN) {
     return ParseState::Continue;
@@ -111,8 +128,12 @@ ParseState Filter::onRead() {
     return ParseState::Error;
   }
 
-  const auto parse_state =
-      parseHttpHeader(absl::string_view(reinterpret_cast<const char*>(buf_), result.rc_));
+  return onPeeked(
+      absl::string_view(reinterpret_cast<const char*>(peek_buffer.data()), result.rc_));
+}
+
+ParseState Filter::onPeeked(absl::string_view data) {
+  const auto parse_state = parseHttpHeader(data);
   switch (parse_state) {
   case ParseState::Continue:
     // do nothing but wait for the next event
@@ -66,6 +66,7 @@ using ConfigSharedPtr = std::shared_ptr<Config>;
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(const ConfigSharedPtr config);
+  ~Filter() override;
 
   // Network::ListenerFilter
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
@@ -74,6 +75,7 @@ private:
   static const absl::string_view HTTP2_CONNECTION_PREFACE;
 
   ParseState onRead();
+  ParseState onPeeked(absl::string_view data);
   void done(bool success);
   ParseState parseHttpHeader(absl::string_view data);
 
@@ -87,8 +89,8 @@ private:
   http_parser parser_;
   static http_parser_settings settings_;
 
-  // Use static thread_local to avoid allocating buffer over and over again.
-  static thread_local uint8_t buf_[Config::MAX_INSPECT_SIZE];
+  // The socket peeked into the thread's peek buffer, which is released when the filter is done.
+  const Network::ConnectionSocket* peeked_socket_{};
 };
 
 } // namespace HttpInspector
@@ -19,6 +19,8 @@
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 
+#include "extensions/filters/listener/common/peek_buffer.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace ListenerFilters {
@@ -29,6 +31,8 @@ Config::Config(Stats::Scope& scope) : stats_{ALL_PROXY_PROTOCOL_STATS(POOL_COUNT
 Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
   ENVOY_LOG(debug, "proxy_protocol: New connection accepted");
   Network::ConnectionSocket& socket = cb.socket();
+  // The data peeked by the listener filters run before is stale once the header is read.
+  PeekBuffer::get().release(&socket);
   ASSERT(file_event_.get() == nullptr);
   file_event_ = cb.dispatcher().createFileEvent(
       socket.ioHandle().fd(),
@@ -53,8 +57,12 @@ void Filter::onRead() {
 void Filter::onReadWorker() {
   Network::ConnectionSocket& socket = cb_->socket();
 
-  if ((!proxy_protocol_header_.has_value() && !readProxyHeader(socket.ioHandle().fd())) ||
-      (proxy_protocol_header_.has_value() && !parseExtensions(socket.ioHandle().fd()))) {
+  // Nothing has been read from the socket yet when the header may have been received whole.
+  const bool read_whole_header =
+      !proxy_protocol_header_.has_value() && buf_off_ == 0 && readWholeV2Header(socket);
+  if (!read_whole_header &&
+      ((!proxy_protocol_header_.has_value() && !readProxyHeader(socket.ioHandle().fd())) ||
+       (proxy_protocol_header_.has_value() && !parseExtensions(socket.ioHandle().fd())))) {
     // We return if a) we do not yet have the header, or b) we have the header but not yet all
     // the extension data. In both cases we'll be called again when the socket is ready to read
     // and pick up where we left off.
@@ -91,7 +99,7 @@ void Filter::onReadWorker() {
   cb_->continueFilterChain(true);
 }
 
-size_t Filter::lenV2Address(char* buf) {
+size_t Filter::lenV2Address(const char* buf) {
   const uint8_t proto_family = buf[PROXY_PROTO_V2_SIGNATURE_LEN + 1];
   const int ver_cmd = buf[PROXY_PROTO_V2_SIGNATURE_LEN];
   size_t len;
@@ -114,7 +122,7 @@ size_t Filter::lenV2Address(char* buf) {
   return len;
 }
 
-void Filter::parseV2Header(char* buf) {
+void Filter::parseV2Header(const char* buf) {
   const int ver_cmd = buf[PROXY_PROTO_V2_SIGNATURE_LEN];
   uint8_t upper_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 2];
   uint8_t lower_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 1];
@@ -140,8 +148,8 @@ void Filter::parseV2Header(char* buf) {
           uint16_t src_port;
           uint16_t dst_port;
         });
-        pp_ipv4_addr* v4;
-        v4 = reinterpret_cast<pp_ipv4_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
+        const pp_ipv4_addr* v4;
+        v4 = reinterpret_cast<const pp_ipv4_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
         sockaddr_in ra4, la4;
         memset(&ra4, 0, sizeof(ra4));
         memset(&la4, 0, sizeof(la4));
@@ -164,8 +172,8 @@ void Filter::parseV2Header(char* buf) {
           uint16_t src_port;
           uint16_t dst_port;
         });
-        pp_ipv6_addr* v6;
-        v6 = reinterpret_cast<pp_ipv6_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
+        const pp_ipv6_addr* v6;
+        v6 = reinterpret_cast<const pp_ipv6_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
         sockaddr_in6 ra6, la6;
         memset(&ra6, 0, sizeof(ra6));
         memset(&la6, 0, sizeof(la6));
@@ -255,6 +263,44 @@ bool Filter::parseExtensions(int fd) {
   return true;
 }
 
+bool Filter::readWholeV2Header(const Network::ConnectionSocket& socket) {
+  PeekBuffer& peek_buffer = PeekBuffer::get();
+  const Api::SysCallSizeResult result = peek_buffer.peek(socket, MAX_PEEK_LEN_V2);
+  if (result.rc_ < 0 && result.errno_ != EAGAIN) {
+    throw EnvoyException("failed to read proxy protocol");
+  }
+
+  // Anything else than a v2 header whose address and extensions were all peeked is left to
+  // readProxyHeader(), which reports invalid headers.
+  const char* buf = reinterpret_cast<const char*>(peek_buffer.data());
+  size_t len = 0;
+  if (result.rc_ >= ssize_t(PROXY_PROTO_V2_HEADER_LEN) &&
+      !memcmp(buf, PROXY_PROTO_V2_SIGNATURE, PROXY_PROTO_V2_SIGNATURE_LEN) &&
+      ((buf[PROXY_PROTO_V2_SIGNATURE_LEN] & 0xf0) >> 4) == PROXY_PROTO_V2_VERSION) {
+    const uint8_t upper_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 2];
+    const uint8_t lower_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 1];
+    len = PROXY_PROTO_V2_HEADER_LEN + (upper_byte << 8) + lower_byte;
+  }
+  if (len == 0 || len > size_t(result.rc_)) {
+    peek_buffer.release(&socket);
+    return false;
+  }
+
+  // The header is consumed before it is parsed, reading into the buffer the very data peeked.
+  const Api::SysCallSizeResult read_result = peek_buffer.read(socket, len);
+  if (read_result.rc_ != ssize_t(len)) {
+    throw EnvoyException("failed to read proxy protocol (remote closed)");
+  }
+  const size_t hdr_addr_len = len - PROXY_PROTO_V2_HEADER_LEN;
+  if (hdr_addr_len < lenV2Address(buf)) {
+    throw EnvoyException("failed to read proxy protocol (insufficient data)");
+  }
+  parseV2Header(buf);
+  // The extensions were consumed along with the header.
+  proxy_protocol_header_.value().extensions_length_ = 0;
+  return true;
+}
+
 bool Filter::readProxyHeader(int fd) {
   while (buf_off_ < MAX_PROXY_PROTO_LEN_V2) {
     int bytes_avail;
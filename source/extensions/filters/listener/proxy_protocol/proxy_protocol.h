@@ -52,6 +52,9 @@ enum ProxyProtocolVersion { Unknown = -1, InProgress = -2, V1 = 1, V2 = 2 };
  *
  * Non INET (AF_UNIX) address family in v2 is not supported, will throw an error.
  * Extensions (TLV) in v2 are skipped over.
+ *
+ * A v2 header received whole, which is the common case, is parsed from a single peek of the
+ * socket and then consumed with a single read. Other headers are read piecewise.
  */
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
@@ -64,6 +67,8 @@ private:
   static const size_t MAX_PROXY_PROTO_LEN_V2 =
       PROXY_PROTO_V2_HEADER_LEN + PROXY_PROTO_V2_ADDR_LEN_UNIX;
   static const size_t MAX_PROXY_PROTO_LEN_V1 = 108;
+  // The most data peeked for a v2 header received whole, leaving room for a few extensions.
+  static const size_t MAX_PEEK_LEN_V2 = 512;
 
   void onRead();
   void onReadWorker();
@@ -76,6 +81,14 @@ private:
    */
   bool readProxyHeader(int fd);
 
+  /**
+   * Helper function that attempts to read a v2 header, including its extensions, from a single
+   * peek of the socket.
+   * throws EnvoyException on any socket errors or an invalid header.
+   * @return bool true if the header was read, false if it is to be read by readProxyHeader().
+   */
+  bool readWholeV2Header(const Network::ConnectionSocket& socket);
+
   /**
    * Parse (and discard unknown) header extensions (until hdr.extensions_length == 0)
    */
@@ -85,8 +98,8 @@ private:
    * Given a char * & len, parse the header as per spec
    */
   void parseV1Header(char* buf, size_t len);
-  void parseV2Header(char* buf);
-  size_t lenV2Address(char* buf);
+  void parseV2Header(const char* buf);
+  size_t lenV2Address(const char* buf);
 
   Network::ListenerFilterCallbacks* cb_{};
   Event::FileEventPtr file_event_;
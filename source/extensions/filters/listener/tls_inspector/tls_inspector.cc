@@ -10,11 +10,12 @@
 #include "envoy/network/listen_socket.h"
 #include "envoy/stats/scope.h"
 
-#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 
+#include "extensions/filters/listener/common/peek_buffer.h"
 #include "extensions/transport_sockets/well_known_names.h"
 
+#include "openssl/bytestring.h"
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -22,50 +23,106 @@ namespace Extensions {
 namespace ListenerFilters {
 namespace TlsInspector {
 
+namespace {
+
+// The sizes of the fixed fields of a ClientHello.
+constexpr size_t ClientHelloRandomSize = 32;
+constexpr size_t MaxSessionIdSize = 32;
+
+/**
+ * The extensions of a ClientHello the inspector is interested in.
+ */
+struct ClientHelloExtensions {
+  bool has_sni_{false};
+  absl::string_view sni_;
+  bool has_alpn_{false};
+  CBS alpn_;
+};
+
+// Parses the server_name extension as BoringSSL does: a single non-empty host name, without NULs.
+bool parseServerName(CBS extension, absl::string_view& name) {
+  CBS server_name_list, host_name;
+  uint8_t name_type;
+  if (!CBS_get_u16_length_prefixed(&extension, &server_name_list) ||
+      !CBS_get_u8(&server_name_list, &name_type) ||
+      !CBS_get_u16_length_prefixed(&server_name_list, &host_name) ||
+      CBS_len(&server_name_list) != 0 || CBS_len(&extension) != 0) {
+    return false;
+  }
+  if (name_type != TLSEXT_NAMETYPE_host_name || CBS_len(&host_name) == 0 ||
+      CBS_len(&host_name) > TLSEXT_MAXLEN_host_name || CBS_contains_zero_byte(&host_name)) {
+    return false;
+  }
+  name = absl::string_view(reinterpret_cast<const char*>(CBS_data(&host_name)),
+                           CBS_len(&host_name));
+  return true;
+}
+
+// Parses the body of a ClientHello handshake message.
+bool parseClientHelloBody(CBS body, ClientHelloExtensions& extensions) {
+  uint16_t legacy_version;
+  CBS random, session_id, cipher_suites, compression_methods;
+  if (!CBS_get_u16(&body, &legacy_version) ||
+      !CBS_get_bytes(&body, &random, ClientHelloRandomSize) ||
+      !CBS_get_u8_length_prefixed(&body, &session_id) ||
+      CBS_len(&session_id) > MaxSessionIdSize ||
+      !CBS_get_u16_length_prefixed(&body, &cipher_suites) || CBS_len(&cipher_suites) < 2 ||
+      CBS_len(&cipher_suites) % 2 != 0 ||
+      !CBS_get_u8_length_prefixed(&body, &compression_methods) ||
+      CBS_len(&compression_methods) < 1) {
+    return false;
+  }
+  if (CBS_len(&body) == 0) {
+    // The extensions are optional.
+    return true;
+  }
+  CBS extension_list;
+  if (!CBS_get_u16_length_prefixed(&body, &extension_list) || CBS_len(&body) != 0) {
+    return false;
+  }
+  while (CBS_len(&extension_list) != 0) {
+    uint16_t type;
+    CBS extension;
+    if (!CBS_get_u16(&extension_list, &type) ||
+        !CBS_get_u16_length_prefixed(&extension_list, &extension)) {
+      return false;
+    }
+    if (type == TLSEXT_TYPE_server_name) {
+      if (extensions.has_sni_ || !parseServerName(extension, extensions.sni_)) {
+        return false;
+      }
+      extensions.has_sni_ = true;
+    } else if (type == TLSEXT_TYPE_application_layer_protocol_negotiation) {
+      if (extensions.has_alpn_) {
+        return false;
+      }
+      extensions.has_alpn_ = true;
+      extensions.alpn_ = extension;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 Config::Config(Stats::Scope& scope, uint32_t max_client_hello_size)
     : stats_{ALL_TLS_INSPECTOR_STATS(POOL_COUNTER_PREFIX(scope, "tls_inspector."))},
-      ssl_ctx_(SSL_CTX_new(TLS_with_buffers_method())),
       max_client_hello_size_(max_client_hello_size) {
-
   if (max_client_hello_size_ > TLS_MAX_CLIENT_HELLO) {
     throw EnvoyException(fmt::format("max_client_hello_size of {} is greater than maximum of {}.",
                                      max_client_hello_size_, size_t(TLS_MAX_CLIENT_HELLO)));
   }
-
-  SSL_CTX_set_options(ssl_ctx_.get(), SSL_OP_NO_TICKET);
-  SSL_CTX_set_session_cache_mode(ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
-  SSL_CTX_set_select_certificate_cb(
-      ssl_ctx_.get(), [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
-        const uint8_t* data;
-        size_t len;
-        if (SSL_early_callback_ctx_extension_get(
-                client_hello, TLSEXT_TYPE_application_layer_protocol_negotiation, &data, &len)) {
-          Filter* filter = static_cast<Filter*>(SSL_get_app_data(client_hello->ssl));
-          filter->onALPN(data, len);
-        }
-        return ssl_select_cert_success;
-      });
-  SSL_CTX_set_tlsext_servername_callback(
-      ssl_ctx_.get(), [](SSL* ssl, int* out_alert, void*) -> int {
-        Filter* filter = static_cast<Filter*>(SSL_get_app_data(ssl));
-        filter->onServername(
-            absl::NullSafeStringView(SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name)));
-
-        // Return an error to stop the handshake; we have what we wanted already.
-        *out_alert = SSL_AD_USER_CANCELLED;
-        return SSL_TLSEXT_ERR_ALERT_FATAL;
-      });
 }
 
-bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_ctx_.get())}; }
-
-thread_local uint8_t Filter::buf_[Config::TLS_MAX_CLIENT_HELLO];
+static_assert(Config::TLS_MAX_CLIENT_HELLO <= PeekBuffer::MaxSize,
+              "the ClientHello must fit in the peek buffer");
 
-Filter::Filter(const ConfigSharedPtr config) : config_(config), ssl_(config_->newSsl()) {
-  RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
+Filter::Filter(const ConfigSharedPtr config) : config_(config) {}
 
-  SSL_set_app_data(ssl_.get(), this);
-  SSL_set_accept_state(ssl_.get());
+Filter::~Filter() {
+  if (peeked_socket_ != nullptr) {
+    PeekBuffer::get().release(peeked_socket_);
+  }
 }
 
 Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
@@ -115,10 +172,10 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
   NOT_REACHED_GCOVR_EXCL_LINE;
 }
 
-void Filter::onALPN(const unsigned char* data, unsigned int len) {
-  CBS wire, list;
-  CBS_init(&wire, reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(len));
-  if (!CBS_get_u16_length_prefixed(&wire, &list) || CBS_len(&wire) != 0 || CBS_len(&list) < 2) {
+void Filter::onALPN(CBS extension) {
+  CBS list;
+  if (!CBS_get_u16_length_prefixed(&extension, &list) || CBS_len(&extension) != 0 ||
+      CBS_len(&list) < 2) {
     // Don't produce errors, let the real TLS stack do it.
     return;
   }
@@ -143,7 +200,6 @@ void Filter::onServername(absl::string_view name) {
   } else {
     config_->stats().sni_not_found_.inc();
   }
-  clienthello_success_ = true;
 }
 
 ParseState Filter::onRead() {
@@ -159,9 +215,10 @@ ParseState Filter::onRead() {
   //
   // TODO(ggreenway): write an integration test to ensure the events work as expected on all
   // platforms.
-  auto& os_syscalls = Api::OsSysCallsSingleton::get();
-  const Api::SysCallSizeResult result = os_syscalls.recv(cb_->socket().ioHandle().fd(), buf_,
-                                                         config_->maxClientHelloSize(), MSG_PEEK);
+  PeekBuffer& peek_buffer = PeekBuffer::get();
+  peeked_socket_ = &cb_->socket();
+  const Api::SysCallSizeResult result =
+      peek_buffer.peek(cb_->socket(), config_->maxClientHelloSize());
   ENVOY_LOG(trace, "tls inspector: recv: {}", result.rc_);
 
   if (result.rc_ == -1 && result.errno_ == EAGAIN) {
@@ -171,13 +228,11 @@ ParseState Filter::onRead() {
     return ParseState::Error;
   }
 
-  // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so
-  // skip over what we've already processed.
+  // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so the
+  // ClientHello is only parsed again once more data is available.
   if (static_cast<uint64_t>(result.rc_) > read_) {
-    const uint8_t* data = buf_ + read_;
-    const size_t len = result.rc_ - read_;
     read_ = result.rc_;
-    return parseClientHello(data, len);
+    return parseClientHello(peek_buffer.data(), read_);
   }
   return ParseState::Continue;
 }
@@ -188,47 +243,91 @@ void Filter::done(bool success) {
   cb_->continueFilterChain(success);
 }
 
-ParseState Filter::parseClientHello(const void* data, size_t len) {
-  // Ownership is passed to ssl_ in SSL_set_bio()
-  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(data, len));
-
-  // Make the mem-BIO return that there is more data
-  // available beyond it's end
-  BIO_set_mem_eof_return(bio.get(), -1);
-
-  SSL_set_bio(ssl_.get(), bio.get(), bio.get());
-  bio.release();
+ParseState Filter::parseClientHello(const uint8_t* data, size_t len) {
+  // The ClientHello may span several handshake records, in which case their fragments are
+  // reassembled. It is otherwise parsed in place.
+  CBS input;
+  CBS_init(&input, data, len);
+  CBS message;
+  std::vector<uint8_t> reassembled;
+  uint32_t records = 0;
+  while (true) {
+    // A record not starting as a handshake record of TLS is rejected without waiting for its
+    // header to be complete.
+    if ((CBS_len(&input) >= 1 && CBS_data(&input)[0] != SSL3_RT_HANDSHAKE) ||
+        (CBS_len(&input) >= 2 && CBS_data(&input)[1] != SSL3_VERSION_MAJOR)) {
+      break;
+    }
+    uint8_t type;
+    uint16_t version, fragment_length;
+    CBS fragment;
+    if (!CBS_get_u8(&input, &type) || !CBS_get_u16(&input, &version) ||
+        !CBS_get_u16(&input, &fragment_length)) {
+      return needMoreData();
+    }
+    if (fragment_length > SSL3_RT_MAX_PLAIN_LENGTH) {
+      break;
+    }
+    if (!CBS_get_bytes(&input, &fragment, fragment_length)) {
+      return needMoreData();
+    }
+    if (records++ == 0) {
+      message = fragment;
+    } else {
+      if (records == 2) {
+        reassembled.assign(CBS_data(&message), CBS_data(&message) + CBS_len(&message));
+      }
+      reassembled.insert(reassembled.end(), CBS_data(&fragment),
+                         CBS_data(&fragment) + CBS_len(&fragment));
+      CBS_init(&message, reassembled.data(), reassembled.size());
+    }
 
-  int ret = SSL_do_handshake(ssl_.get());
+    CBS header = message;
+    uint8_t message_type;
+    uint32_t message_length;
+    if (!CBS_get_u8(&header, &message_type)) {
+      continue;
+    }
+    if (message_type != SSL3_MT_CLIENT_HELLO) {
+      break;
+    }
+    CBS body;
+    if (!CBS_get_u24(&header, &message_length) ||
+        !CBS_get_bytes(&header, &body, message_length)) {
+      continue;
+    }
 
-  // This should never succeed because an error is always returned from the SNI callback.
-  ASSERT(ret <= 0);
-  switch (SSL_get_error(ssl_.get(), ret)) {
-  case SSL_ERROR_WANT_READ:
-    if (read_ == config_->maxClientHelloSize()) {
-      // We've hit the specified size limit. This is an unreasonably large ClientHello;
-      // indicate failure.
-      config_->stats().client_hello_too_large_.inc();
-      return ParseState::Error;
+    ClientHelloExtensions extensions;
+    if (!parseClientHelloBody(body, extensions)) {
+      break;
     }
-    return ParseState::Continue;
-  case SSL_ERROR_SSL:
-    if (clienthello_success_) {
-      config_->stats().tls_found_.inc();
-      if (alpn_found_) {
-        config_->stats().alpn_found_.inc();
-      } else {
-        config_->stats().alpn_not_found_.inc();
-      }
-      cb_->socket().setDetectedTransportProtocol(
-          TransportSockets::TransportProtocolNames::get().Tls);
+    if (extensions.has_alpn_) {
+      onALPN(extensions.alpn_);
+    }
+    onServername(extensions.sni_);
+    config_->stats().tls_found_.inc();
+    if (alpn_found_) {
+      config_->stats().alpn_found_.inc();
     } else {
-      config_->stats().tls_not_found_.inc();
+      config_->stats().alpn_not_found_.inc();
     }
+    cb_->socket().setDetectedTransportProtocol(
+        TransportSockets::TransportProtocolNames::get().Tls);
     return ParseState::Done;
-  default:
+  }
+
+  config_->stats().tls_not_found_.inc();
+  return ParseState::Done;
+}
+
+ParseState Filter::needMoreData() {
+  if (read_ == config_->maxClientHelloSize()) {
+    // We've hit the specified size limit. This is an unreasonably large ClientHello;
+    // indicate failure.
+    config_->stats().client_hello_too_large_.inc();
     return ParseState::Error;
   }
+  return ParseState::Continue;
 }
 
 } // namespace TlsInspector
@@ -8,7 +8,7 @@
 
 #include "common/common/logger.h"
 
-#include "openssl/ssl.h"
+#include "openssl/bytestring.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -52,49 +52,45 @@ public:
   Config(Stats::Scope& scope, uint32_t max_client_hello_size = TLS_MAX_CLIENT_HELLO);
 
   const TlsInspectorStats& stats() const { return stats_; }
-  bssl::UniquePtr<SSL> newSsl();
   uint32_t maxClientHelloSize() const { return max_client_hello_size_; }
 
   static constexpr size_t TLS_MAX_CLIENT_HELLO = 64 * 1024;
 
 private:
   TlsInspectorStats stats_;
-  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
   const uint32_t max_client_hello_size_;
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
 
 /**
- * TLS inspector listener filter.
+ * TLS inspector listener filter. The ClientHello is parsed from the data peeked from the socket,
+ * without handing it to a TLS stack, as only the SNI and ALPN extensions are of interest.
  */
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(const ConfigSharedPtr config);
+  ~Filter() override;
 
   // Network::ListenerFilter
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  ParseState parseClientHello(const void* data, size_t len);
+  ParseState parseClientHello(const uint8_t* data, size_t len);
+  ParseState needMoreData();
   ParseState onRead();
   void done(bool success);
-  void onALPN(const unsigned char* data, unsigned int len);
+  void onALPN(CBS extension);
   void onServername(absl::string_view name);
 
   ConfigSharedPtr config_;
   Network::ListenerFilterCallbacks* cb_;
   Event::FileEventPtr file_event_;
 
-  bssl::UniquePtr<SSL> ssl_;
+  // The socket peeked into the thread's peek buffer, which is released when the filter is done.
+  const Network::ConnectionSocket* peeked_socket_{};
   uint64_t read_{0};
   bool alpn_found_{false};
-  bool clienthello_success_{false};
-
-  static thread_local uint8_t buf_[Config::TLS_MAX_CLIENT_HELLO];
-
-  // Allows callbacks on the SSL_CTX to set fields in this class.
-  friend class Config;
 };
 
 } // namespace TlsInspector
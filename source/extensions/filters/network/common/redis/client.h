@@ -116,6 +116,12 @@ using ClientPtr = std::unique_ptr<Client>;
  */
 enum class ReadPolicy { Master, PreferMaster, Replica, PreferReplica, Any };
 
+/**
+ * How a node is selected among the replicas of a shard, or among its master and replicas, by the
+ * read policies other than Master.
+ */
+enum class ReplicaSelection { Random, LeastRequest };
+
 /**
  * Configuration for a redis connection pool.
  */
@@ -184,6 +190,18 @@ public:
    * @return the read policy the proxy should use.
    */
   virtual ReadPolicy readPolicy() const PURE;
+
+  /**
+   * @return when enabled, the requests made while earlier ones are in flight on the same upstream
+   * connection are written together at the end of the event loop iteration, rather than each
+   * right away. Only used when maxBufferSizeBeforeFlush() is zero.
+   */
+  virtual bool enableAdaptiveBatching() const PURE;
+
+  /**
+   * @return the replica selection to use for read commands when the read policy is not Master.
+   */
+  virtual ReplicaSelection replicaSelection() const PURE;
 };
 
 /**
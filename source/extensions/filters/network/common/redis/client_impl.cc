@@ -28,7 +28,13 @@ ConfigImpl::ConfigImpl(
                // as the buffer is flushed on each request immediately.
       max_upstream_unknown_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_upstream_unknown_connections, 100)),
-      enable_command_stats_(config.enable_command_stats()) {
+      enable_command_stats_(config.enable_command_stats()),
+      enable_adaptive_batching_(config.enable_adaptive_batching()),
+      replica_selection_(config.replica_selection() ==
+                                 envoy::extensions::filters::network::redis_proxy::v3alpha::
+                                     RedisProxy::ConnPoolSettings::LEAST_REQUEST
+                             ? ReplicaSelection::LeastRequest
+                             : ReplicaSelection::Random) {
   switch (config.read_policy()) {
   case envoy::extensions::filters::network::redis_proxy::v3alpha::RedisProxy::ConnPoolSettings::
       MASTER:
@@ -106,6 +112,10 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, ClientCallbacks&
   ASSERT(connection_->state() == Network::Connection::State::Open);
 
   const bool empty_buffer = encoder_buffer_.length() == 0;
+  // The requests made while earlier ones are in flight are coalesced when adaptive batching is
+  // enabled, while a request to an idle upstream is not delayed.
+  const bool batch = config_.enableAdaptiveBatching() &&
+                     config_.maxBufferSizeBeforeFlush() == 0 && !pending_requests_.empty();
 
   Stats::StatName command;
   if (config_.enableCommandStats()) {
@@ -120,8 +130,14 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, ClientCallbacks&
   pending_requests_.emplace_back(*this, callbacks, command);
   encoder_->encode(request, encoder_buffer_);
 
-  // If buffer is full, flush. If the buffer was empty before the request, start the timer.
-  if (encoder_buffer_.length() >= config_.maxBufferSizeBeforeFlush()) {
+  // If batching, flush once the event loop is done with the events of this iteration, which may
+  // make more requests. If buffer is full, flush. If the buffer was empty before the request, start
+  // the timer.
+  if (batch) {
+    if (empty_buffer) {
+      flush_timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+  } else if (encoder_buffer_.length() >= config_.maxBufferSizeBeforeFlush()) {
     flushBufferAndResetTimer();
   } else if (empty_buffer) {
     flush_timer_->enableTimer(std::chrono::milliseconds(config_.bufferFlushTimeoutInMs()));
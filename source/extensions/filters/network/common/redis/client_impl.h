@@ -54,6 +54,8 @@ public:
   }
   bool enableCommandStats() const override { return enable_command_stats_; }
   ReadPolicy readPolicy() const override { return read_policy_; }
+  bool enableAdaptiveBatching() const override { return enable_adaptive_batching_; }
+  ReplicaSelection replicaSelection() const override { return replica_selection_; }
 
 private:
   const std::chrono::milliseconds op_timeout_;
@@ -64,6 +66,8 @@ private:
   const uint32_t max_upstream_unknown_connections_;
   const bool enable_command_stats_;
   ReadPolicy read_policy_;
+  const bool enable_adaptive_batching_;
+  const ReplicaSelection replica_selection_;
 };
 
 class ClientImpl : public Client, public DecoderCallbacks, public Network::ConnectionCallbacks {
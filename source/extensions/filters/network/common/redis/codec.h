@@ -126,6 +126,16 @@ public:
   CompositeArray& asCompositeArray();
   const CompositeArray& asCompositeArray() const;
 
+  /**
+   * A large bulk string can hold its content in a buffer referencing the slices it was decoded
+   * from, rather than in a copy, so that it is encoded by adding these slices to the output. The
+   * buffer is shared by the copies of the value. asString() copies the content to the string the
+   * first time it is called, and drops the buffer when the string can be modified.
+   * @return the buffer holding the content of a bulk string, or nullptr when it is in the string.
+   */
+  const std::shared_ptr<Buffer::Instance>& bulkStringBuffer() const;
+  void bulkStringBuffer(std::shared_ptr<Buffer::Instance> buffer);
+
   /**
    * Get/set the type of the RespValue. A RespValue can only be a single type at a time. Each time
    * type() is called the type is changed and then the type specific as* methods can be used.
@@ -136,7 +146,8 @@ public:
 private:
   union {
     std::vector<RespValue> array_;
-    std::string string_;
+    // Filled from bulk_string_buffer_ on first access.
+    mutable std::string string_;
     int64_t integer_;
     CompositeArray composite_array_;
   };
@@ -144,6 +155,7 @@ private:
   void cleanup();
 
   RespType type_{};
+  std::shared_ptr<Buffer::Instance> bulk_string_buffer_;
 };
 
 using RespValuePtr = std::unique_ptr<RespValue>;
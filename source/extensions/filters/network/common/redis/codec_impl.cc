@@ -7,6 +7,7 @@
 
 #include "envoy/common/platform.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/stack_array.h"
@@ -67,15 +68,36 @@ const std::vector<RespValue>& RespValue::asArray() const {
 std::string& RespValue::asString() {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  if (bulk_string_buffer_ != nullptr) {
+    // The string can be modified, after which it no longer matches the buffer.
+    static_cast<const RespValue*>(this)->asString();
+    bulk_string_buffer_.reset();
+  }
   return string_;
 }
 
 const std::string& RespValue::asString() const {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  // A buffered bulk string is never empty, so an empty string has not been filled yet.
+  if (bulk_string_buffer_ != nullptr && string_.empty()) {
+    string_ = bulk_string_buffer_->toString();
+  }
   return string_;
 }
 
+const std::shared_ptr<Buffer::Instance>& RespValue::bulkStringBuffer() const {
+  ASSERT(type_ == RespType::BulkString);
+  return bulk_string_buffer_;
+}
+
+void RespValue::bulkStringBuffer(std::shared_ptr<Buffer::Instance> buffer) {
+  ASSERT(type_ == RespType::BulkString);
+  ASSERT(buffer == nullptr || buffer->length() > 0);
+  string_.clear();
+  bulk_string_buffer_ = std::move(buffer);
+}
+
 int64_t& RespValue::asInteger() {
   ASSERT(type_ == RespType::Integer);
   return integer_;
@@ -118,6 +140,7 @@ void RespValue::cleanup() {
     break;
   }
   }
+  bulk_string_buffer_.reset();
 }
 
 void RespValue::type(RespType type) {
@@ -161,7 +184,8 @@ RespValue::RespValue(const RespValue& other) : type_(RespType::Null) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    asString() = other.asString();
+    string_ = other.string_;
+    bulk_string_buffer_ = other.bulk_string_buffer_;
     break;
   }
   case RespType::Integer: {
@@ -187,6 +211,7 @@ RespValue::RespValue(RespValue&& other) noexcept : type_(other.type_) {
   case RespType::BulkString:
   case RespType::Error: {
     new (&string_) std::string(std::move(other.string_));
+    bulk_string_buffer_ = std::move(other.bulk_string_buffer_);
     break;
   }
   case RespType::Integer: {
@@ -215,7 +240,8 @@ RespValue& RespValue::operator=(const RespValue& other) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    asString() = other.asString();
+    string_ = other.string_;
+    bulk_string_buffer_ = other.bulk_string_buffer_;
     break;
   }
   case RespType::Integer: {
@@ -247,6 +273,7 @@ RespValue& RespValue::operator=(RespValue&& other) noexcept {
   case RespType::BulkString:
   case RespType::Error: {
     string_ = std::move(other.string_);
+    bulk_string_buffer_ = std::move(other.bulk_string_buffer_);
     break;
   }
   case RespType::Integer: {
@@ -329,17 +356,44 @@ RespValue::CompositeArray::CompositeArrayConstIterator::empty() {
 }
 
 void DecoderImpl::decode(Buffer::Instance& data) {
-  uint64_t num_slices = data.getRawSlices(nullptr, 0);
-  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
-  data.getRawSlices(slices.begin(), num_slices);
-  for (const Buffer::RawSlice& slice : slices) {
-    parseSlice(slice);
+  while (data.length() != 0) {
+    if (bulk_string_body_ != nullptr) {
+      moveBulkStringBody(data);
+      continue;
+    }
+
+    uint64_t num_slices = data.getRawSlices(nullptr, 0);
+    STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+    data.getRawSlices(slices.begin(), num_slices);
+    uint64_t parsed = 0;
+    for (const Buffer::RawSlice& slice : slices) {
+      const uint64_t slice_parsed = parseSlice(slice);
+      parsed += slice_parsed;
+      if (slice_parsed < slice.len_) {
+        // The body of a large bulk string starts here. It is moved from the data rather than
+        // parsed, after which the slices left are fetched again.
+        break;
+      }
+    }
+
+    data.drain(parsed);
   }
+}
 
-  data.drain(data.length());
+void DecoderImpl::moveBulkStringBody(Buffer::Instance& data) {
+  ASSERT(state_ == State::BulkStringBody);
+  const uint64_t length = std::min(pending_integer_.integer_, data.length());
+  // The whole slices are moved, only the partial ones at the edges of the body are copied.
+  bulk_string_body_->move(data, length);
+  pending_integer_.integer_ -= length;
+  if (pending_integer_.integer_ == 0) {
+    ENVOY_LOG(trace, "parse slice: BulkStringBody complete: {} bytes", bulk_string_body_->length());
+    pending_value_stack_.front().value_->bulkStringBuffer(std::move(bulk_string_body_));
+    state_ = State::CR;
+  }
 }
 
-void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
+uint64_t DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   const char* buffer = reinterpret_cast<const char*>(slice.mem_);
   uint64_t remaining = slice.len_;
 
@@ -461,6 +515,9 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
         ASSERT(current_value.value_->type() == RespType::BulkString);
         if (!pending_integer_.negative_) {
           // TODO(mattklein123): reserve and define max length since we don't stream currently.
+          if (pending_integer_.integer_ >= MinBufferedBulkStringSize) {
+            bulk_string_body_ = std::make_unique<Buffer::OwnedImpl>();
+          }
           state_ = State::BulkStringBody;
         } else {
           // Null bulk string. Switch type to null and move to value complete.
@@ -474,6 +531,9 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
 
     case State::BulkStringBody: {
       ASSERT(!pending_integer_.negative_);
+      if (bulk_string_body_ != nullptr) {
+        return slice.len_ - remaining;
+      }
       uint64_t length_to_copy =
           std::min(static_cast<uint64_t>(pending_integer_.integer_), remaining);
       pending_value_stack_.front().value_->asString().append(buffer, length_to_copy);
@@ -549,6 +609,8 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     }
     }
   }
+
+  return slice.len_;
 }
 
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
@@ -566,7 +628,11 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
     break;
   }
   case RespType::BulkString: {
-    encodeBulkString(value.asString(), out);
+    if (value.bulkStringBuffer() != nullptr) {
+      encodeBulkStringBuffer(*value.bulkStringBuffer(), out);
+    } else {
+      encodeBulkString(value.asString(), out);
+    }
     break;
   }
   case RespType::Error: {
@@ -623,6 +689,21 @@ void EncoderImpl::encodeBulkString(const std::string& string, Buffer::Instance&
   out.add("\r\n", 2);
 }
 
+void EncoderImpl::encodeBulkStringBuffer(Buffer::Instance& content, Buffer::Instance& out) {
+  char buffer[32];
+  char* current = buffer;
+  *current++ = '$';
+  current += StringUtil::itoa(current, 21, content.length());
+  *current++ = '\r';
+  *current++ = '\n';
+  out.add(buffer, current - buffer);
+  // The content is shared with the value, which can still be encoded again.
+  Buffer::OwnedImpl shared;
+  shared.addShared(content);
+  out.move(shared);
+  out.add("\r\n", 2);
+}
+
 void EncoderImpl::encodeError(const std::string& string, Buffer::Instance& out) {
   out.add("-", 1);
   out.add(string);
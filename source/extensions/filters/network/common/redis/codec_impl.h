@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 
 #include "extensions/filters/network/common/redis/codec.h"
@@ -19,6 +20,8 @@ namespace Redis {
  * Decoder implementation of https://redis.io/topics/protocol
  *
  * This implementation buffers when needed and will always consume all bytes passed for decoding.
+ * The bodies of large bulk strings are moved from the decoded data to a buffer held by the value
+ * instead of being copied to its string.
  */
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::redis> {
 public:
@@ -27,6 +30,9 @@ public:
   // RedisProxy::Decoder
   void decode(Buffer::Instance& data) override;
 
+  // The size from which the body of a bulk string is held in a buffer.
+  static constexpr uint64_t MinBufferedBulkStringSize = 16384;
+
 private:
   enum class State {
     ValueRootStart,
@@ -56,13 +62,18 @@ private:
     uint64_t current_array_element_;
   };
 
-  void parseSlice(const Buffer::RawSlice& slice);
+  // Returns the number of bytes parsed, which is less than the slice length when the body of a
+  // buffered bulk string starts.
+  uint64_t parseSlice(const Buffer::RawSlice& slice);
+  void moveBulkStringBody(Buffer::Instance& data);
 
   DecoderCallbacks& callbacks_;
   State state_{State::ValueRootStart};
   PendingInteger pending_integer_;
   RespValuePtr pending_value_root_;
   std::forward_list<PendingValue> pending_value_stack_;
+  // The body of the bulk string being decoded, when it is buffered.
+  std::unique_ptr<Buffer::OwnedImpl> bulk_string_body_;
 };
 
 /**
@@ -88,6 +99,7 @@ private:
   void encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out);
   void encodeCompositeArray(const RespValue::CompositeArray& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
+  void encodeBulkStringBuffer(Buffer::Instance& content, Buffer::Instance& out);
   void encodeError(const std::string& string, Buffer::Instance& out);
   void encodeInteger(int64_t integer, Buffer::Instance& out);
   void encodeSimpleString(const std::string& string, Buffer::Instance& out);
@@ -18,10 +18,11 @@ namespace DubboProxy {
 std::pair<RpcInvocationSharedPtr, bool>
 DubboHessian2SerializerImpl::deserializeRpcInvocation(Buffer::Instance& buffer,
                                                       ContextSharedPtr context) {
-  size_t total_size = 0, size;
+  size_t size;
   // TODO(zyfjeff): Add format checker
-  std::string dubbo_version = HessianUtils::peekString(buffer, &size);
-  total_size += size;
+  // Only the fields needed to route the request are copied out. The dubbo version is skipped, and
+  // the arguments and attachments following the method name are left in the buffer.
+  size_t total_size = HessianUtils::peekStringSize(buffer);
   std::string service_name = HessianUtils::peekString(buffer, &size, total_size);
   total_size += size;
   std::string service_version = HessianUtils::peekString(buffer, &size, total_size);
@@ -179,6 +179,42 @@ std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uin
   throw EnvoyException(absl::StrCat("hessian type is not string ", code));
 }
 
+size_t HessianUtils::peekStringSize(Buffer::Instance& buffer, uint64_t offset) {
+  ASSERT(buffer.length() > offset);
+  const uint8_t code = buffer.peekInt<uint8_t>(offset);
+  size_t header_size = 0;
+  size_t delta_length = 0;
+  if (code <= 0x1f) {
+    header_size = 1;
+    delta_length = code;
+  } else if (code >= 0x30 && code <= 0x33) {
+    if (offset + 2 > buffer.length()) {
+      throw EnvoyException("buffer underflow");
+    }
+    header_size = 2;
+    delta_length = (code - 0x30) * 256 + buffer.peekInt<uint8_t>(offset + 1);
+  } else if (code == 0x52 || code == 0x53) {
+    if (offset + 3 > buffer.length()) {
+      throw EnvoyException("buffer underflow");
+    }
+    header_size = 3;
+    delta_length = buffer.peekBEInt<uint16_t>(offset + 1);
+  } else {
+    throw EnvoyException(absl::StrCat("hessian type is not string ", code));
+  }
+
+  if (delta_length + header_size + offset > buffer.length()) {
+    throw EnvoyException("buffer underflow");
+  }
+
+  if (code == 0x52) {
+    // A non-final chunk is followed by the rest of the string.
+    return delta_length + header_size +
+           peekStringSize(buffer, delta_length + header_size + offset);
+  }
+  return delta_length + header_size;
+}
+
 std::string HessianUtils::readString(Buffer::Instance& buffer) {
   size_t size;
   std::string result(peekString(buffer, &size));
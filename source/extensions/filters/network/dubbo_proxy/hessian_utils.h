@@ -27,6 +27,11 @@ public:
                                             uint64_t offset = 0);
   static std::string peekByte(Buffer::Instance& buffer, size_t* size, uint64_t offset = 0);
 
+  /**
+   * @return size_t the encoded size of the string at the offset, without copying it out.
+   */
+  static size_t peekStringSize(Buffer::Instance& buffer, uint64_t offset = 0);
+
   static std::string readString(Buffer::Instance& buffer);
   static long readLong(Buffer::Instance& buffer);
   static bool readBool(Buffer::Instance& buffer);
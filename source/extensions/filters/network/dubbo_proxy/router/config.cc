@@ -3,6 +3,7 @@
 #include "envoy/extensions/filters/network/dubbo_proxy/router/v3alpha/router.pb.h"
 #include "envoy/extensions/filters/network/dubbo_proxy/router/v3alpha/router.pb.validate.h"
 #include "envoy/registry/registry.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "extensions/filters/network/dubbo_proxy/router/router_impl.h"
 
@@ -13,10 +14,21 @@ namespace DubboProxy {
 namespace Router {
 
 DubboFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
-    const envoy::extensions::filters::network::dubbo_proxy::router::v3alpha::Router&,
+    const envoy::extensions::filters::network::dubbo_proxy::router::v3alpha::Router& proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
-  return [&context](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager()));
+  if (!proto_config.multiplex_upstream_connections()) {
+    return [&context](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+      callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager()));
+    };
+  }
+
+  std::shared_ptr<ThreadLocal::Slot> tls = context.threadLocal().allocateSlot();
+  tls->set([](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ConnectionMultiplexer>(dispatcher);
+  });
+  return [&context, tls](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addDecoderFilter(std::make_shared<Router>(
+        context.clusterManager(), &tls->getTyped<ConnectionMultiplexer>()));
   };
 }
 
@@ -0,0 +1,247 @@
+#include "extensions/filters/network/dubbo_proxy/router/connection_multiplexer.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+
+namespace {
+
+// The layout of the Dubbo message header.
+constexpr uint64_t HeaderSize = 16;
+constexpr uint16_t MagicNumber = 0xdabb;
+constexpr uint64_t RequestIdOffset = 4;
+constexpr uint64_t BodySizeOffset = 12;
+
+void setRequestId(Buffer::Instance& message, uint64_t request_id) {
+  Buffer::OwnedImpl header;
+  header.move(message, RequestIdOffset);
+  header.writeBEInt<uint64_t>(request_id);
+  message.drain(sizeof(uint64_t));
+  message.prepend(header);
+}
+
+} // namespace
+
+MultiplexedRequest* ConnectionMultiplexer::newRequest(Tcp::ConnectionPool::Instance& pool,
+                                                      Buffer::Instance& request, bool two_way,
+                                                      MultiplexedRequestCallbacks& callbacks) {
+  MultiplexedConnectionPtr& connection = connections_[&pool];
+  if (connection == nullptr) {
+    connection = std::make_unique<MultiplexedConnection>(*this, pool);
+  }
+  return connection->newRequest(request, two_way, callbacks);
+}
+
+void ConnectionMultiplexer::removeConnection(Tcp::ConnectionPool::Instance& pool) {
+  auto it = connections_.find(&pool);
+  ASSERT(it != connections_.end());
+  dispatcher_.deferredDelete(std::move(it->second));
+  connections_.erase(it);
+}
+
+void ConnectionMultiplexer::ActiveRequest::cancel() { parent_.cancelRequest(*this); }
+
+MultiplexedRequest*
+ConnectionMultiplexer::MultiplexedConnection::newRequest(Buffer::Instance& request, bool two_way,
+                                                         MultiplexedRequestCallbacks& callbacks) {
+  ASSERT(request.length() >= HeaderSize);
+  const uint64_t upstream_request_id = parent_.next_request_id_++;
+  auto active_request =
+      std::make_unique<ActiveRequest>(*this, upstream_request_id, two_way, callbacks);
+  active_request->request_id_ = request.peekBEInt<uint64_t>(RequestIdOffset);
+  active_request->data_.move(request);
+  setRequestId(active_request->data_, upstream_request_id);
+
+  MultiplexedRequest* handle = active_request.get();
+  requests_.emplace(upstream_request_id, std::move(active_request));
+  pending_request_ids_.push_back(upstream_request_id);
+
+  if (conn_data_ != nullptr) {
+    sendPendingRequests();
+  } else if (conn_pool_handle_ == nullptr) {
+    // The pool calls back before returning when it has a ready connection, or fails right away.
+    conn_pool_handle_ = pool_.newConnection(*this);
+  }
+
+  // The request is already done if it failed, or if it is a one way request and has been sent.
+  if (requests_.find(upstream_request_id) == requests_.end()) {
+    maybeRelease();
+    return nullptr;
+  }
+  return handle;
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::cancelRequest(ActiveRequest& request) {
+  if (request.sent_) {
+    close_on_release_ = true;
+  }
+  requests_.erase(request.upstream_request_id_);
+  maybeRelease();
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::onPoolFailure(
+    Tcp::ConnectionPool::PoolFailureReason reason, Upstream::HostDescriptionConstSharedPtr host) {
+  conn_pool_handle_ = nullptr;
+  upstream_host_ = host;
+  failRequests(reason);
+  maybeRelease();
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::onPoolReady(
+    Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+    Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "dubbo multiplexed connection: connection to {} is ready",
+            host->address()->asString());
+
+  conn_pool_handle_ = nullptr;
+  upstream_host_ = host;
+  conn_data_ = std::move(conn_data);
+  conn_data_->addUpstreamCallbacks(*this);
+  sendPendingRequests();
+  maybeRelease();
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::onUpstreamData(Buffer::Instance& data, bool) {
+  response_buffer_.move(data);
+  // The callbacks of the requests may close or release the connection.
+  while (conn_data_ != nullptr && response_buffer_.length() >= HeaderSize) {
+    if (response_buffer_.peekBEInt<uint16_t>() != MagicNumber) {
+      ENVOY_LOG(debug, "dubbo multiplexed connection: invalid response magic number");
+      response_buffer_.drain(response_buffer_.length());
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+      return;
+    }
+
+    const uint64_t message_size =
+        HeaderSize + response_buffer_.peekBEInt<uint32_t>(BodySizeOffset);
+    if (response_buffer_.length() < message_size) {
+      break;
+    }
+
+    const uint64_t upstream_request_id = response_buffer_.peekBEInt<uint64_t>(RequestIdOffset);
+    Buffer::OwnedImpl response;
+    response.move(response_buffer_, message_size);
+
+    auto it = requests_.find(upstream_request_id);
+    if (it == requests_.end() || !it->second->sent_) {
+      ENVOY_LOG(debug, "dubbo multiplexed connection: dropping the response to unknown request {}",
+                upstream_request_id);
+      continue;
+    }
+
+    ActiveRequestPtr request = std::move(it->second);
+    requests_.erase(it);
+    setRequestId(response, request->request_id_);
+    request->callbacks_.onResponse(response);
+  }
+
+  // When the stream ended, the requests still waiting for a response are failed by the close
+  // event.
+  maybeRelease();
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::onEvent(Network::ConnectionEvent event) {
+  if (conn_data_ == nullptr) {
+    // The connection is closed while being released.
+    return;
+  }
+
+  Tcp::ConnectionPool::PoolFailureReason reason;
+  switch (event) {
+  case Network::ConnectionEvent::RemoteClose:
+    reason = Tcp::ConnectionPool::PoolFailureReason::RemoteConnectionFailure;
+    break;
+  case Network::ConnectionEvent::LocalClose:
+    reason = Tcp::ConnectionPool::PoolFailureReason::LocalConnectionFailure;
+    break;
+  default:
+    // Connected is consumed by the connection pool.
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
+  ENVOY_LOG(debug, "dubbo multiplexed connection: connection to {} closed with {} requests",
+            upstream_host_->address()->asString(), requests_.size());
+  conn_data_.reset();
+  response_buffer_.drain(response_buffer_.length());
+  close_on_release_ = false;
+  failRequests(reason);
+  maybeRelease();
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::sendPendingRequests() {
+  std::vector<uint64_t> request_ids;
+  request_ids.swap(pending_request_ids_);
+  for (const uint64_t upstream_request_id : request_ids) {
+    auto it = requests_.find(upstream_request_id);
+    if (it == requests_.end()) {
+      // The request was cancelled, or failed as the connection was closed by the callbacks of a
+      // previous one.
+      continue;
+    }
+
+    ActiveRequest& request = *it->second;
+    request.sent_ = true;
+    conn_data_->connection().write(request.data_, false);
+
+    MultiplexedRequestCallbacks& callbacks = request.callbacks_;
+    if (!request.two_way_) {
+      requests_.erase(it);
+    }
+    callbacks.onRequestSent(upstream_host_);
+  }
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::failRequests(
+    Tcp::ConnectionPool::PoolFailureReason reason) {
+  // The callbacks may cancel other requests, or send new ones which are sent on a new connection.
+  std::vector<uint64_t> request_ids;
+  request_ids.reserve(requests_.size());
+  for (const auto& request : requests_) {
+    request_ids.push_back(request.first);
+  }
+  pending_request_ids_.clear();
+
+  for (const uint64_t upstream_request_id : request_ids) {
+    auto it = requests_.find(upstream_request_id);
+    if (it == requests_.end()) {
+      continue;
+    }
+    ActiveRequestPtr request = std::move(it->second);
+    requests_.erase(it);
+    request->callbacks_.onRequestFailure(reason, upstream_host_);
+  }
+}
+
+void ConnectionMultiplexer::MultiplexedConnection::maybeRelease() {
+  if (released_ || !requests_.empty()) {
+    return;
+  }
+  released_ = true;
+
+  if (conn_pool_handle_ != nullptr) {
+    conn_pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+    conn_pool_handle_ = nullptr;
+  }
+
+  if (conn_data_ != nullptr) {
+    // The connection data is cleared first, so that the close event is ignored.
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data = std::move(conn_data_);
+    if (close_on_release_ || response_buffer_.length() > 0) {
+      // A response may still be received for a cancelled request, so the connection cannot be
+      // reused.
+      conn_data->connection().close(Network::ConnectionCloseType::NoFlush);
+    }
+  }
+
+  parent_.removeConnection(pool_);
+}
+
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+
+/**
+ * Callbacks for a request sent through a multiplexed upstream connection.
+ */
+class MultiplexedRequestCallbacks {
+public:
+  virtual ~MultiplexedRequestCallbacks() = default;
+
+  /**
+   * Called when the request has been written to the upstream connection.
+   * @param host supplies the upstream host of the connection.
+   */
+  virtual void onRequestSent(Upstream::HostDescriptionConstSharedPtr host) PURE;
+
+  /**
+   * Called when no connection could be obtained for the request, or when the connection is closed
+   * before the response of the request is received.
+   * @param reason supplies the failure reason.
+   * @param host supplies the upstream host, if any.
+   */
+  virtual void onRequestFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                                Upstream::HostDescriptionConstSharedPtr host) PURE;
+
+  /**
+   * Called with the response of a two way request.
+   * @param data supplies the whole response message, carrying the request id of the request.
+   */
+  virtual void onResponse(Buffer::Instance& data) PURE;
+};
+
+/**
+ * A handle to a request sent through a multiplexed upstream connection. The handle is valid until
+ * the request fails, its response is received or, for a one way request, it has been sent.
+ */
+class MultiplexedRequest {
+public:
+  virtual ~MultiplexedRequest() = default;
+
+  /**
+   * Cancel the request. Its callbacks are not called anymore, and its response is discarded.
+   */
+  virtual void cancel() PURE;
+};
+
+/**
+ * Shares the upstream connections of a worker between the requests of all its downstream
+ * connections. The requests routed to the same connection pool, and so to the same host, are
+ * written to a single connection, with their request ids replaced with ids unique to the worker.
+ * The responses are matched to the requests by their ids, which are restored before handing them
+ * to the requests.
+ *
+ * The connection is returned to the pool once no request is pending on it, so that the pool keeps
+ * managing its lifetime.
+ */
+class ConnectionMultiplexer : public ThreadLocal::ThreadLocalObject,
+                              Logger::Loggable<Logger::Id::dubbo> {
+public:
+  ConnectionMultiplexer(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  /**
+   * Send a request through the connection shared for a pool.
+   * @param pool supplies the connection pool of the upstream host.
+   * @param request supplies the whole request message, which is drained.
+   * @param two_way supplies whether a response is expected for the request.
+   * @param callbacks supplies the callbacks of the request, which may be called before returning.
+   * @return MultiplexedRequest* a handle to the request, or nullptr if the request is already
+   *         done.
+   */
+  MultiplexedRequest* newRequest(Tcp::ConnectionPool::Instance& pool, Buffer::Instance& request,
+                                 bool two_way, MultiplexedRequestCallbacks& callbacks);
+
+  /**
+   * @return size_t the number of the connection pools having requests pending.
+   */
+  size_t activeConnections() const { return connections_.size(); }
+
+private:
+  class MultiplexedConnection;
+
+  struct ActiveRequest : public MultiplexedRequest {
+    ActiveRequest(MultiplexedConnection& parent, uint64_t upstream_request_id, bool two_way,
+                  MultiplexedRequestCallbacks& callbacks)
+        : parent_(parent), upstream_request_id_(upstream_request_id), two_way_(two_way),
+          callbacks_(callbacks) {}
+
+    // MultiplexedRequest
+    void cancel() override;
+
+    MultiplexedConnection& parent_;
+    const uint64_t upstream_request_id_;
+    uint64_t request_id_{};
+    const bool two_way_;
+    MultiplexedRequestCallbacks& callbacks_;
+    Buffer::OwnedImpl data_;
+    bool sent_{};
+  };
+  using ActiveRequestPtr = std::unique_ptr<ActiveRequest>;
+
+  class MultiplexedConnection : public Tcp::ConnectionPool::Callbacks,
+                                public Tcp::ConnectionPool::UpstreamCallbacks,
+                                public Event::DeferredDeletable {
+  public:
+    MultiplexedConnection(ConnectionMultiplexer& parent, Tcp::ConnectionPool::Instance& pool)
+        : parent_(parent), pool_(pool) {}
+
+    MultiplexedRequest* newRequest(Buffer::Instance& request, bool two_way,
+                                   MultiplexedRequestCallbacks& callbacks);
+    void cancelRequest(ActiveRequest& request);
+
+    // Tcp::ConnectionPool::Callbacks
+    void onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+
+    // Tcp::ConnectionPool::UpstreamCallbacks
+    void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+  private:
+    void sendPendingRequests();
+    void failRequests(Tcp::ConnectionPool::PoolFailureReason reason);
+    void maybeRelease();
+
+    ConnectionMultiplexer& parent_;
+    Tcp::ConnectionPool::Instance& pool_;
+    Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    Upstream::HostDescriptionConstSharedPtr upstream_host_;
+    // The requests waiting for a connection or for their response, by upstream request id.
+    absl::flat_hash_map<uint64_t, ActiveRequestPtr> requests_;
+    // The upstream request ids of the requests waiting for a connection, in arrival order.
+    std::vector<uint64_t> pending_request_ids_;
+    Buffer::OwnedImpl response_buffer_;
+    // Set when a request is cancelled after being sent, as its response may still be received on
+    // the connection, which is then closed rather than returned to the pool.
+    bool close_on_release_{};
+    bool released_{};
+  };
+  using MultiplexedConnectionPtr = std::unique_ptr<MultiplexedConnection>;
+
+  void removeConnection(Tcp::ConnectionPool::Instance& pool);
+
+  Event::Dispatcher& dispatcher_;
+  absl::flat_hash_map<Tcp::ConnectionPool::Instance*, MultiplexedConnectionPtr> connections_;
+  // The upstream request ids are unique to the worker rather than to a connection, as the
+  // connections returned to a pool are handed to the next multiplexed connection of the pool.
+  uint64_t next_request_id_{};
+};
+
+using ConnectionMultiplexerSharedPtr = std::shared_ptr<ConnectionMultiplexer>;
+
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -169,6 +169,17 @@ Router::UpstreamRequest::UpstreamRequest(Router& parent, Tcp::ConnectionPool::In
 Router::UpstreamRequest::~UpstreamRequest() = default;
 
 FilterStatus Router::UpstreamRequest::start() {
+  if (parent_.multiplexer_ != nullptr) {
+    multiplexed_request_ = parent_.multiplexer_->newRequest(
+        conn_pool_, parent_.upstream_request_buffer_,
+        metadata_->message_type() != MessageType::Oneway, *this);
+    if (multiplexed_request_ != nullptr && !request_complete_) {
+      // Pause while we wait for a connection.
+      return FilterStatus::StopIteration;
+    }
+    return FilterStatus::Continue;
+  }
+
   Tcp::ConnectionPool::Cancellable* handle = conn_pool_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
@@ -189,6 +200,12 @@ void Router::UpstreamRequest::resetStream() {
     ENVOY_LOG(debug, "dubbo upstream request: reset connection pool handler");
   }
 
+  if (multiplexed_request_) {
+    multiplexed_request_->cancel();
+    multiplexed_request_ = nullptr;
+    ENVOY_LOG(debug, "dubbo upstream request: reset multiplexed request");
+  }
+
   if (conn_data_) {
     ASSERT(!conn_pool_handle_);
     conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
@@ -242,6 +259,35 @@ void Router::UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr
   encodeData(parent_.upstream_request_buffer_);
 }
 
+void Router::UpstreamRequest::onRequestSent(Upstream::HostDescriptionConstSharedPtr host) {
+  // Only invoke continueDecoding if the request waited for a connection.
+  bool continue_decoding = multiplexed_request_ != nullptr;
+  if (metadata_->message_type() == MessageType::Oneway) {
+    // The multiplexer is done with one way requests once they are sent.
+    multiplexed_request_ = nullptr;
+  }
+
+  onUpstreamHostSelected(host);
+  onRequestStart(continue_decoding);
+}
+
+void Router::UpstreamRequest::onRequestFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                                               Upstream::HostDescriptionConstSharedPtr host) {
+  multiplexed_request_ = nullptr;
+  if (request_complete_) {
+    // The connection was closed while waiting for the response.
+    onResetStream(reason);
+    return;
+  }
+  onPoolFailure(reason, host);
+}
+
+void Router::UpstreamRequest::onResponse(Buffer::Instance& data) {
+  multiplexed_request_ = nullptr;
+  // The response is whole, so no more data follows it.
+  parent_.onUpstreamData(data, true);
+}
+
 void Router::UpstreamRequest::onRequestStart(bool continue_decoding) {
   ENVOY_LOG(debug, "dubbo upstream request: start sending data to the server {}",
             upstream_host_->address()->asString());
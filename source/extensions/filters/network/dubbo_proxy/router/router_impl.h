@@ -10,6 +10,7 @@
 #include "common/upstream/load_balancer_impl.h"
 
 #include "extensions/filters/network/dubbo_proxy/filters/filter.h"
+#include "extensions/filters/network/dubbo_proxy/router/connection_multiplexer.h"
 #include "extensions/filters/network/dubbo_proxy/router/router.h"
 
 namespace Envoy {
@@ -23,7 +24,8 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                public DubboFilters::DecoderFilter,
                Logger::Loggable<Logger::Id::dubbo> {
 public:
-  Router(Upstream::ClusterManager& cluster_manager) : cluster_manager_(cluster_manager) {}
+  Router(Upstream::ClusterManager& cluster_manager, ConnectionMultiplexer* multiplexer = nullptr)
+      : cluster_manager_(cluster_manager), multiplexer_(multiplexer) {}
   ~Router() override = default;
 
   // DubboFilters::DecoderFilter
@@ -43,7 +45,8 @@ public:
   void onBelowWriteBufferLowWatermark() override {}
 
 private:
-  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks {
+  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
+                           public MultiplexedRequestCallbacks {
     UpstreamRequest(Router& parent, Tcp::ConnectionPool::Instance& pool,
                     MessageMetadataSharedPtr& metadata, SerializationType serialization_type,
                     ProtocolType protocol_type);
@@ -59,6 +62,12 @@ private:
     void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
                      Upstream::HostDescriptionConstSharedPtr host) override;
 
+    // MultiplexedRequestCallbacks
+    void onRequestSent(Upstream::HostDescriptionConstSharedPtr host) override;
+    void onRequestFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                          Upstream::HostDescriptionConstSharedPtr host) override;
+    void onResponse(Buffer::Instance& data) override;
+
     void onRequestStart(bool continue_decoding);
     void onRequestComplete();
     void onResponseComplete();
@@ -71,6 +80,8 @@ private:
 
     Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
     Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    // Set instead of the connection when the request is sent through a multiplexed connection.
+    MultiplexedRequest* multiplexed_request_{};
     Upstream::HostDescriptionConstSharedPtr upstream_host_;
     SerializerPtr serializer_;
     ProtocolPtr protocol_;
@@ -84,6 +95,7 @@ private:
   void cleanup();
 
   Upstream::ClusterManager& cluster_manager_;
+  ConnectionMultiplexer* const multiplexer_;
 
   DubboFilters::DecoderFilterCallbacks* callbacks_{};
   RouteConstSharedPtr route_{};
@@ -83,11 +83,10 @@ HttpConnectionManagerFilterConfigFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::network::http_connection_manager::v3alpha::
         HttpConnectionManager& proto_config,
     Server::Configuration::FactoryContext& context) {
-  std::shared_ptr<Http::TlsCachingDateProviderImpl> date_provider =
-      context.singletonManager().getTyped<Http::TlsCachingDateProviderImpl>(
+  std::shared_ptr<Http::CachingDateProviderImpl> date_provider =
+      context.singletonManager().getTyped<Http::CachingDateProviderImpl>(
           SINGLETON_MANAGER_REGISTERED_NAME(date_provider), [&context] {
-            return std::make_shared<Http::TlsCachingDateProviderImpl>(context.dispatcher(),
-                                                                      context.threadLocal());
+            return std::make_shared<Http::CachingDateProviderImpl>(context.dispatcher());
           });
 
   std::shared_ptr<Router::RouteConfigProviderManager> route_config_provider_manager =
@@ -183,7 +182,9 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
           context.runtime().snapshot().featureEnabled("http_connection_manager.normalize_path",
                                                       0))),
 #endif
-      merge_slashes_(config.merge_slashes()) {
+      merge_slashes_(config.merge_slashes()),
+      stream_arena_block_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, stream_arena_block_size, 0)) {
   // If idle_timeout_ was not configured in common_http_protocol_options, use value in deprecated
   // idle_timeout field.
   // TODO(asraa): Remove when idle_timeout is removed.
@@ -196,6 +197,19 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     idle_timeout_ = absl::nullopt;
   }
 
+  if (config.has_request_body_spill()) {
+    request_body_spill_ = Http::RequestBodySpillConfig{
+        config.request_body_spill().directory(),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.request_body_spill(), memory_threshold_bytes,
+                                        1024 * 1024)};
+  }
+
+  // The stats of each filter are created as the filters are processed below.
+  if (config.filter_timing_sampling().value() > 0) {
+    filter_timing_ = Http::FilterTimingConfig{
+        static_cast<uint64_t>(config.filter_timing_sampling().value() * 100), {}};
+  }
+
   // If scoped RDS is enabled, avoid creating a route config provider. Route config providers will
   // be managed by the scoped routing logic instead.
   switch (config.route_specifier_case()) {
@@ -422,6 +436,20 @@ void HttpConnectionManagerConfig::processFilter(
   Http::FilterFactoryCb callback =
       factory.createFilterFactoryFromProto(*message, stats_prefix_, context_);
   is_terminal = factory.isTerminalFilter();
+  if (filter_timing_.has_value()) {
+    const std::string& name = proto_config.name();
+    if (filter_timing_->stats_.find(name) == filter_timing_->stats_.end()) {
+      const std::string prefix = fmt::format("{}filter.{}.", stats_prefix_, name);
+      filter_timing_->stats_.emplace(
+          name, Http::FilterTimingStats{ALL_HTTP_FILTER_TIMING_STATS(
+                    POOL_HISTOGRAM_PREFIX(context_.scope(), prefix))});
+    }
+    // The connection manager finds the stats of the filters by the name they are added with.
+    callback = [name, callback](Http::FilterChainFactoryCallbacks& callbacks) {
+      callbacks.setFilterName(name);
+      callback(callbacks);
+    };
+  }
   filter_factories.push_back(callback);
 }
 
@@ -144,6 +144,13 @@ public:
   const Http::Http1Settings& http1Settings() const override { return http1_settings_; }
   bool shouldNormalizePath() const override { return normalize_path_; }
   bool shouldMergeSlashes() const override { return merge_slashes_; }
+  uint32_t streamArenaBlockSize() const override { return stream_arena_block_size_; }
+  const absl::optional<Http::RequestBodySpillConfig>& requestBodySpill() const override {
+    return request_body_spill_;
+  }
+  const absl::optional<Http::FilterTimingConfig>& filterTiming() const override {
+    return filter_timing_;
+  }
   std::chrono::milliseconds delayedCloseTimeout() const override { return delayed_close_timeout_; }
 
 private:
@@ -194,6 +201,9 @@ private:
   std::chrono::milliseconds delayed_close_timeout_;
   const bool normalize_path_;
   const bool merge_slashes_;
+  const uint32_t stream_arena_block_size_;
+  absl::optional<Http::RequestBodySpillConfig> request_body_spill_;
+  absl::optional<Http::FilterTimingConfig> filter_timing_;
 
   // Default idle timeout is 5 minutes if nothing is specified in the HCM config.
   static const uint64_t StreamIdleTimeoutMs = 5 * 60 * 1000;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -26,6 +27,22 @@ using Bytes = std::vector<unsigned char>;
  */
 using NullableBytes = absl::optional<Bytes>;
 
+/**
+ * Record batches carried by produce requests and fetch responses, encoded as a nullable byte array.
+ * They are forwarded untouched and never inspected, so the parsers step over them without copying
+ * them, and only keep their size.
+ */
+struct Records {
+  int32_t size_;
+
+  bool operator==(const Records& rhs) const { return size_ == rhs.size_; }
+};
+
+/**
+ * Nullable record batches used by Kafka.
+ */
+using NullableRecords = absl::optional<Records>;
+
 /**
  * Kafka array of elements of type T.
  */
@@ -141,7 +141,11 @@ def parse_field(field_spec, highest_possible_version):
   version_usage_as_nullable = Statics.parse_version_string(
       field_spec['nullableVersions'],
       highest_possible_version) if 'nullableVersions' in field_spec else range(-1)
-  parsed_type = parse_type(field_spec['type'], field_spec, highest_possible_version)
+  type_name = field_spec['type']
+  if field_spec['name'] == 'Records' and type_name == 'bytes':
+    # Record batches are forwarded untouched, so they are skipped rather than copied when parsing.
+    type_name = 'records'
+  parsed_type = parse_type(type_name, field_spec, highest_possible_version)
   return FieldSpec(field_spec['name'], parsed_type, version_usage, version_usage_as_nullable)
 
 
@@ -360,7 +364,7 @@ class Primitive(TypeSpecification):
   Represents a Kafka primitive value.
   """
 
-  PRIMITIVE_TYPE_NAMES = ['bool', 'int8', 'int16', 'int32', 'int64', 'string', 'bytes']
+  PRIMITIVE_TYPE_NAMES = ['bool', 'int8', 'int16', 'int32', 'int64', 'string', 'bytes', 'records']
 
   KAFKA_TYPE_TO_ENVOY_TYPE = {
       'string': 'std::string',
@@ -370,6 +374,7 @@ class Primitive(TypeSpecification):
       'int32': 'int32_t',
       'int64': 'int64_t',
       'bytes': 'Bytes',
+      'records': 'Records',
   }
 
   KAFKA_TYPE_TO_DESERIALIZER = {
@@ -380,6 +385,7 @@ class Primitive(TypeSpecification):
       'int32': 'Int32Deserializer',
       'int64': 'Int64Deserializer',
       'bytes': 'BytesDeserializer',
+      'records': 'RecordsDeserializer',
   }
 
   # See https://github.com/apache/kafka/tree/trunk/clients/src/main/resources/common/message#deserializing-messages
@@ -391,6 +397,7 @@ class Primitive(TypeSpecification):
       'int32': '0',
       'int64': '0',
       'bytes': '{}',
+      'records': '{}',
   }
 
   # Custom values that make test code more readable.
@@ -402,6 +409,7 @@ class Primitive(TypeSpecification):
       'int32': 'static_cast<int32_t>(32)',
       'int64': 'static_cast<int64_t>(64)',
       'bytes': 'Bytes({0, 1, 2, 3})',
+      'records': 'Records{4}',
   }
 
   def __init__(self, name, custom_default_value):
@@ -431,7 +439,7 @@ class Primitive(TypeSpecification):
     return Primitive.compute(self.original_name, Primitive.KAFKA_TYPE_TO_EXAMPLE_VALUE_FOR_TEST)
 
   def is_printable(self):
-    return self.name not in ['Bytes']
+    return self.name not in ['Bytes', 'Records']
 
 
 class Complex(TypeSpecification):
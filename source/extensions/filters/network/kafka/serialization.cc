@@ -84,6 +84,65 @@ uint32_t feedBytesIntoBuffers(absl::string_view& data, DeserializerType& length_
   return length_consumed + data_consumed;
 }
 
+/**
+ * Helper method for deserializers that get the length of data, and then step over the given bytes
+ * without storing them. Impl note: This method modifies (sets up) most of Deserializer's fields.
+ * @param data bytes to deserialize.
+ * @param length_deserializer payload length deserializer.
+ * @param length_consumed_marker marker telling whether length has been extracted from
+ * length_deserializer.
+ * @param length extracted payload length.
+ * @param required remaining bytes to skip.
+ * @param ready marker telling whether this deserialized has finished processing.
+ * @param allow_null_value whether null value if allowed.
+ * @return number of bytes consumed.
+ */
+uint32_t feedBytesSkippingThem(absl::string_view& data, Int32Deserializer& length_deserializer,
+                               bool& length_consumed_marker, int32_t& length, int32_t& required,
+                               bool& ready, const bool allow_null_value) {
+
+  const uint32_t length_consumed = length_deserializer.feed(data);
+  if (!length_deserializer.ready()) {
+    // Break early: we still need to fill in length buffer.
+    return length_consumed;
+  }
+
+  if (!length_consumed_marker) {
+    length = length_deserializer.get();
+    required = length;
+
+    if (length == NULL_BYTES_LENGTH) {
+      if (allow_null_value) {
+        ready = true;
+      } else {
+        // Invalid payload: null length for non-null object.
+        throw EnvoyException(absl::StrCat("invalid length: ", length));
+      }
+    }
+
+    if (length < NULL_BYTES_LENGTH) {
+      throw EnvoyException(absl::StrCat("invalid length: ", length));
+    }
+
+    length_consumed_marker = true;
+  }
+
+  if (ready) {
+    return length_consumed;
+  }
+
+  // The bytes are only stepped over, the caller keeps forwarding the original data.
+  const uint32_t data_consumed = std::min<uint32_t>(required, data.size());
+  required -= data_consumed;
+  data = {data.data() + data_consumed, data.size() - data_consumed};
+
+  if (required == 0) {
+    ready = true;
+  }
+
+  return length_consumed + data_consumed;
+}
+
 uint32_t StringDeserializer::feed(absl::string_view& data) {
   return feedBytesIntoBuffers<Int16Deserializer, int16_t, char>(
       data, length_buf_, length_consumed_, required_, data_buf_, ready_, NULL_STRING_LENGTH, false);
@@ -104,6 +163,16 @@ uint32_t NullableBytesDeserializer::feed(absl::string_view& data) {
       data, length_buf_, length_consumed_, required_, data_buf_, ready_, NULL_BYTES_LENGTH, true);
 }
 
+uint32_t RecordsDeserializer::feed(absl::string_view& data) {
+  return feedBytesSkippingThem(data, length_buf_, length_consumed_, length_, required_, ready_,
+                               false);
+}
+
+uint32_t NullableRecordsDeserializer::feed(absl::string_view& data) {
+  return feedBytesSkippingThem(data, length_buf_, length_consumed_, length_, required_, ready_,
+                               true);
+}
+
 } // namespace Kafka
 } // namespace NetworkFilters
 } // namespace Extensions
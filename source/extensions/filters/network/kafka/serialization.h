@@ -290,6 +290,58 @@ private:
   bool ready_{false};
 };
 
+/**
+ * Deserializer of records value.
+ * First reads length (INT32) and then skips the given number of bytes, without storing them. Used
+ * for the record batches of produce requests and fetch responses, which can be large and are never
+ * inspected.
+ */
+class RecordsDeserializer : public Deserializer<Records> {
+public:
+  /**
+   * Can throw EnvoyException if given records length is not valid.
+   */
+  uint32_t feed(absl::string_view& data) override;
+
+  bool ready() const override { return ready_; }
+
+  Records get() const override { return {length_}; }
+
+private:
+  Int32Deserializer length_buf_;
+  bool length_consumed_{false};
+  int32_t length_;
+  int32_t required_;
+
+  bool ready_{false};
+};
+
+/**
+ * Deserializer of nullable records value.
+ * Behaves like RecordsDeserializer, but a length of -1 stands for a null value.
+ */
+class NullableRecordsDeserializer : public Deserializer<NullableRecords> {
+public:
+  /**
+   * Can throw EnvoyException if given records length is not valid.
+   */
+  uint32_t feed(absl::string_view& data) override;
+
+  bool ready() const override { return ready_; }
+
+  NullableRecords get() const override {
+    return length_ >= 0 ? absl::make_optional<Records>({length_}) : absl::nullopt;
+  }
+
+private:
+  Int32Deserializer length_buf_;
+  bool length_consumed_{false};
+  int32_t length_;
+  int32_t required_;
+
+  bool ready_{false};
+};
+
 /**
  * Deserializer for array of objects of the same type.
  *
@@ -567,6 +619,22 @@ template <> inline uint32_t EncodingContext::computeSize(const NullableBytes& ar
   return sizeof(int32_t) + (arg ? arg->size() : 0);
 }
 
+/**
+ * Template overload for records.
+ * Kafka records size is INT32 for header + N bytes.
+ */
+template <> inline uint32_t EncodingContext::computeSize(const Records& arg) const {
+  return sizeof(int32_t) + arg.size_;
+}
+
+/**
+ * Template overload for nullable records.
+ * Kafka nullable records size is INT32 for header + N bytes (N >= 0).
+ */
+template <> inline uint32_t EncodingContext::computeSize(const NullableRecords& arg) const {
+  return sizeof(int32_t) + (arg ? arg->size_ : 0);
+}
+
 /**
  * Template overload for Array of T.
  * The size of array is size of header and all of its elements.
@@ -682,6 +750,32 @@ inline uint32_t EncodingContext::encode(const NullableBytes& arg, Buffer::Instan
   }
 }
 
+/**
+ * Template overload for Records.
+ * Only the size of the records is kept when they are parsed, so they are encoded as INT32 length +
+ * N zero bytes.
+ */
+template <> inline uint32_t EncodingContext::encode(const Records& arg, Buffer::Instance& dst) {
+  const uint32_t header_length = encode(arg.size_, dst);
+  const std::string data(arg.size_, '\0');
+  dst.add(data);
+  return header_length + arg.size_;
+}
+
+/**
+ * Template overload for NullableRecords.
+ * Encode nullable records as INT32 length + N zero bytes (length = -1 for null value).
+ */
+template <>
+inline uint32_t EncodingContext::encode(const NullableRecords& arg, Buffer::Instance& dst) {
+  if (arg.has_value()) {
+    return encode(*arg, dst);
+  } else {
+    const int32_t len = -1;
+    return encode(len, dst);
+  }
+}
+
 /**
  * Encode nullable object array to T as INT32 length + N elements.
  * Each element of type T then serializes itself on its own.
@@ -576,6 +576,68 @@ const Field* DocumentImpl::find(const std::string& name, Field::Type type) const
   return nullptr;
 }
 
+void LazyDocumentList::fromBuffer(Buffer::Instance& data, uint64_t length) {
+  if (length > data.length()) {
+    throw EnvoyException("invalid BSON documents length");
+  }
+
+  // Walk the length prefixes, so that the documents are known to fill the given length exactly.
+  uint64_t offset = 0;
+  while (offset < length) {
+    if (length - offset < sizeof(int32_t)) {
+      throw EnvoyException("invalid BSON message length");
+    }
+    const int32_t document_length = data.peekLEInt<int32_t>(offset);
+    // The smallest document is its length and its terminating byte.
+    if (document_length < static_cast<int32_t>(sizeof(int32_t) + 1) ||
+        static_cast<uint64_t>(document_length) > length - offset) {
+      throw EnvoyException("invalid BSON message length");
+    }
+    offset += document_length;
+    raw_documents_count_++;
+  }
+
+  raw_documents_.move(data, length);
+}
+
+const std::list<DocumentSharedPtr>& LazyDocumentList::documents() const {
+  decode();
+  return documents_;
+}
+
+std::list<DocumentSharedPtr>& LazyDocumentList::documents() {
+  decode();
+  return documents_;
+}
+
+uint64_t LazyDocumentList::byteSize() const {
+  uint64_t byte_size = raw_documents_.length();
+  for (const DocumentSharedPtr& document : documents_) {
+    byte_size += document->byteSize();
+  }
+  return byte_size;
+}
+
+void LazyDocumentList::decode() const {
+  if (raw_documents_count_ == 0) {
+    return;
+  }
+
+  // The raw documents are dropped if one is invalid, so that the list is left in a consistent
+  // state.
+  const size_t raw_documents_count = raw_documents_count_;
+  raw_documents_count_ = 0;
+  try {
+    for (size_t i = 0; i < raw_documents_count; i++) {
+      documents_.emplace_back(DocumentImpl::create(raw_documents_));
+    }
+  } catch (EnvoyException&) {
+    raw_documents_.drain(raw_documents_.length());
+    throw;
+  }
+  ASSERT(raw_documents_.length() == 0);
+}
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
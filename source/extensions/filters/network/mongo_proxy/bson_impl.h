@@ -7,6 +7,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/exception.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 
 #include "extensions/filters/network/mongo_proxy/bson.h"
@@ -275,6 +276,47 @@ private:
   std::list<FieldPtr> fields_;
 };
 
+/**
+ * A list of documents which are only decoded when the list is first looked at. Until then, the raw
+ * documents are kept in the buffer slices moved out of the message, and their count and size are
+ * worked out from their length prefixes. This spares building the document trees of large
+ * messages, like inserts and replies, when only their stats are needed.
+ */
+class LazyDocumentList {
+public:
+  /**
+   * Move raw documents out of a buffer. Only their length prefixes are checked, the documents
+   * themselves are checked when decoded.
+   * @param data supplies the buffer holding the documents.
+   * @param length supplies the total length of the documents.
+   */
+  void fromBuffer(Buffer::Instance& data, uint64_t length);
+
+  /**
+   * @return the documents, which are decoded on first use. Throws EnvoyException if a document is
+   *         invalid.
+   */
+  const std::list<DocumentSharedPtr>& documents() const;
+  std::list<DocumentSharedPtr>& documents();
+
+  /**
+   * @return size_t the number of documents, without decoding them.
+   */
+  size_t size() const { return raw_documents_count_ + documents_.size(); }
+
+  /**
+   * @return uint64_t the total size in bytes of the documents, without decoding them.
+   */
+  uint64_t byteSize() const;
+
+private:
+  void decode() const;
+
+  mutable Buffer::OwnedImpl raw_documents_;
+  mutable size_t raw_documents_count_{};
+  mutable std::list<DocumentSharedPtr> documents_;
+};
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
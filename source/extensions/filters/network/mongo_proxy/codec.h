@@ -152,6 +152,18 @@ public:
   virtual void numberReturned(int32_t number_returned) PURE;
   virtual const std::list<Bson::DocumentSharedPtr>& documents() const PURE;
   virtual std::list<Bson::DocumentSharedPtr>& documents() PURE;
+
+  /**
+   * @return uint64_t the number of documents of the reply, without decoding them. Also available
+   *         when the documents were skipped by the decoder, in which case documents() is empty.
+   */
+  virtual uint64_t documentsCount() const PURE;
+
+  /**
+   * @return uint64_t the total size in bytes of the documents of the reply, without decoding them.
+   *         Also available when the documents were skipped by the decoder.
+   */
+  virtual uint64_t documentsByteSize() const PURE;
 };
 
 using ReplyMessagePtr = std::unique_ptr<ReplyMessage>;
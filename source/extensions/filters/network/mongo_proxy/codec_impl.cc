@@ -1,5 +1,6 @@
 #include "extensions/filters/network/mongo_proxy/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -19,6 +20,24 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace MongoProxy {
 
+namespace {
+
+// The size of the fields of OP_REPLY which precede its documents.
+constexpr uint32_t ReplyFieldsSize = 3 * Message::Int32Length + Message::Int64Length;
+
+// Move the documents filling the rest of a message out of the buffer, given the length of the
+// buffer before the message was decoded.
+void documentsFromBuffer(Bson::LazyDocumentList& documents, uint32_t message_length,
+                         uint64_t original_buffer_length, Buffer::Instance& data) {
+  const uint64_t consumed = original_buffer_length - data.length();
+  if (consumed > message_length) {
+    throw EnvoyException("invalid mongo message length");
+  }
+  documents.fromBuffer(data, message_length - consumed);
+}
+
+} // namespace
+
 std::string
 MessageImpl::documentListToString(const std::list<Bson::DocumentSharedPtr>& documents) const {
   std::stringstream out;
@@ -67,9 +86,7 @@ void InsertMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& da
 
   flags_ = Bson::BufferHelper::removeInt32(data);
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
-  while (data.length() - (original_buffer_length - message_length) > 0) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data));
-  }
+  documentsFromBuffer(documents_, message_length, original_buffer_length, data);
 
   ENVOY_LOG(trace, "{}", toString(true));
 }
@@ -96,7 +113,7 @@ std::string InsertMessageImpl::toString(bool full) const {
       R"EOF({{"opcode": "OP_INSERT", "id": {}, "response_to": {}, "flags": "{:#x}", "collection": "{}", )EOF"
       R"EOF("documents": {}}})EOF",
       request_id_, response_to_, flags_, full_collection_name_,
-      full ? documentListToString(documents_) : std::to_string(documents_.size()));
+      full ? documentListToString(documents()) : std::to_string(documents_.size()));
 }
 
 void KillCursorsMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
@@ -183,17 +200,44 @@ std::string QueryMessageImpl::toString(bool full) const {
       return_fields_selector_ ? return_fields_selector_->toString() : "{}");
 }
 
-void ReplyMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
+void ReplyMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& data) {
   ENVOY_LOG(trace, "decoding reply message");
+  fieldsFromBuffer(message_length, data);
+  documents_.fromBuffer(data, message_length - ReplyFieldsSize);
+
+  ENVOY_LOG(trace, "{}", toString(true));
+}
+
+uint64_t ReplyMessageImpl::fromBufferSkippingDocuments(uint32_t message_length,
+                                                       Buffer::Instance& data) {
+  ENVOY_LOG(trace, "decoding reply message, skipping its documents");
+  fieldsFromBuffer(message_length, data);
+  skipped_documents_byte_size_ = message_length - ReplyFieldsSize;
+
+  ENVOY_LOG(trace, "{}", toString(false));
+  return skipped_documents_byte_size_.value();
+}
+
+void ReplyMessageImpl::fieldsFromBuffer(uint32_t message_length, Buffer::Instance& data) {
+  if (message_length < ReplyFieldsSize) {
+    throw EnvoyException("invalid reply message length");
+  }
+
   flags_ = Bson::BufferHelper::removeInt32(data);
   cursor_id_ = Bson::BufferHelper::removeInt64(data);
   starting_from_ = Bson::BufferHelper::removeInt32(data);
   number_returned_ = Bson::BufferHelper::removeInt32(data);
-  for (int32_t i = 0; i < number_returned_; i++) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data));
+}
+
+uint64_t ReplyMessageImpl::documentsCount() const {
+  if (skipped_documents_byte_size_.has_value()) {
+    return std::max(number_returned_, 0);
   }
+  return documents_.size();
+}
 
-  ENVOY_LOG(trace, "{}", toString(true));
+uint64_t ReplyMessageImpl::documentsByteSize() const {
+  return skipped_documents_byte_size_.value_or(documents_.byteSize());
 }
 
 bool ReplyMessageImpl::operator==(const ReplyMessage& rhs) const {
@@ -219,7 +263,7 @@ std::string ReplyMessageImpl::toString(bool full) const {
       R"EOF({{"opcode": "OP_REPLY", "id": {}, "response_to": {}, "flags": "{:#x}", "cursor": "{}", )EOF"
       R"EOF("from": {}, "returned": {}, "documents": {}}})EOF",
       request_id_, response_to_, flags_, cursor_id_, starting_from_, number_returned_,
-      full ? documentListToString(documents_) : std::to_string(documents_.size()));
+      full ? documentListToString(documents()) : std::to_string(documentsCount()));
 }
 
 /*
@@ -238,9 +282,7 @@ void CommandMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& d
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
-  while (data.length() - (original_data_length - message_length) > 0) {
-    input_docs_.emplace_back(Bson::DocumentImpl::create(data));
-  }
+  documentsFromBuffer(input_docs_, message_length, original_data_length, data);
 
   ENVOY_LOG(trace, "{}", toString(true));
 }
@@ -252,7 +294,7 @@ std::string CommandMessageImpl::toString(bool full) const {
       R"EOF("commandArgs": {}, "inputDocs": {}}})EOF",
       request_id_, response_to_, database_.c_str(), command_name_.c_str(), metadata_->toString(),
       command_args_->toString(),
-      full ? documentListToString(input_docs_) : std::to_string(input_docs_.size()));
+      full ? documentListToString(inputDocs()) : std::to_string(input_docs_.size()));
 }
 
 bool CommandMessageImpl::operator==(const CommandMessage& rhs) const {
@@ -298,9 +340,7 @@ void CommandReplyMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instan
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
-  while (data.length() - (original_data_length - message_length) > 0) {
-    output_docs_.emplace_back(Bson::DocumentImpl::create(data));
-  }
+  documentsFromBuffer(output_docs_, message_length, original_data_length, data);
 
   ENVOY_LOG(trace, "{}", toString(true));
 }
@@ -309,7 +349,7 @@ std::string CommandReplyMessageImpl::toString(bool full) const {
   return fmt::format(R"EOF({{"opcode": "OP_COMMANDREPLY", "id": {}, "response_to": {}, )EOF"
                      R"EOF("metadata": {}, "commandReply": {}, "outputDocs":{}}} )EOF",
                      request_id_, response_to_, metadata_->toString(), command_reply_->toString(),
-                     full ? documentListToString(output_docs_)
+                     full ? documentListToString(outputDocs())
                           : std::to_string(output_docs_.size()));
 }
 
@@ -352,7 +392,13 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   uint32_t message_length = Bson::BufferHelper::peekInt32(data);
   ENVOY_LOG(trace, "message is {} bytes", message_length);
   if (data.length() < message_length) {
-    return false;
+    // The documents of the replies being skipped are not buffered, so a reply is decoded as soon
+    // as its fields are received.
+    if (!skip_reply_documents_ || data.length() < Message::MessageHeaderSize + ReplyFieldsSize ||
+        static_cast<Message::OpCode>(data.peekLEInt<int32_t>(3 * Message::Int32Length)) !=
+            Message::OpCode::Reply) {
+      return false;
+    }
   }
 
   data.drain(sizeof(int32_t));
@@ -368,7 +414,12 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   switch (op_code) {
   case Message::OpCode::Reply: {
     std::unique_ptr<ReplyMessageImpl> message(new ReplyMessageImpl(request_id, response_to));
-    message->fromBuffer(message_length, data);
+    if (skip_reply_documents_) {
+      reply_bytes_to_skip_ = message->fromBufferSkippingDocuments(message_length, data);
+      skipReplyDocuments(data);
+    } else {
+      message->fromBuffer(message_length, data);
+    }
     callbacks_.decodeReply(std::move(message));
     break;
   }
@@ -426,10 +477,20 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 }
 
 void DecoderImpl::onData(Buffer::Instance& data) {
+  skipReplyDocuments(data);
   while (data.length() > 0 && decode(data)) {
   }
 }
 
+void DecoderImpl::skipReplyDocuments(Buffer::Instance& data) {
+  const uint64_t skipped = std::min(reply_bytes_to_skip_, data.length());
+  if (skipped > 0) {
+    ENVOY_LOG(trace, "skipping {} bytes of reply documents", skipped);
+    data.drain(skipped);
+    reply_bytes_to_skip_ -= skipped;
+  }
+}
+
 void EncoderImpl::encodeCommonHeader(int32_t total_size, const Message& message,
                                      Message::OpCode op) {
   Bson::BufferHelper::writeInt32(output_, total_size);
@@ -7,8 +7,11 @@
 
 #include "common/common/logger.h"
 
+#include "extensions/filters/network/mongo_proxy/bson_impl.h"
 #include "extensions/filters/network/mongo_proxy/codec.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -77,13 +80,15 @@ public:
   void flags(int32_t flags) override { flags_ = flags; }
   const std::string& fullCollectionName() const override { return full_collection_name_; }
   void fullCollectionName(const std::string& name) override { full_collection_name_ = name; }
-  const std::list<Bson::DocumentSharedPtr>& documents() const override { return documents_; }
-  std::list<Bson::DocumentSharedPtr>& documents() override { return documents_; }
+  const std::list<Bson::DocumentSharedPtr>& documents() const override {
+    return documents_.documents();
+  }
+  std::list<Bson::DocumentSharedPtr>& documents() override { return documents_.documents(); }
 
 private:
   int32_t flags_{};
   std::string full_collection_name_;
-  std::list<Bson::DocumentSharedPtr> documents_;
+  Bson::LazyDocumentList documents_;
 };
 
 class KillCursorsMessageImpl : public MessageImpl,
@@ -176,15 +181,31 @@ public:
   void startingFrom(int32_t starting_from) override { starting_from_ = starting_from; }
   int32_t numberReturned() const override { return number_returned_; }
   void numberReturned(int32_t number_returned) override { number_returned_ = number_returned; }
-  const std::list<Bson::DocumentSharedPtr>& documents() const override { return documents_; }
-  std::list<Bson::DocumentSharedPtr>& documents() override { return documents_; }
+  const std::list<Bson::DocumentSharedPtr>& documents() const override {
+    return documents_.documents();
+  }
+  std::list<Bson::DocumentSharedPtr>& documents() override { return documents_.documents(); }
+  uint64_t documentsCount() const override;
+  uint64_t documentsByteSize() const override;
+
+  /**
+   * Decode the fields of the reply, leaving its documents in the buffer for the caller to drain.
+   * @param message_length supplies the length of the message, without its header.
+   * @param data supplies the buffer holding at least the fields of the reply.
+   * @return uint64_t the number of bytes of documents which follow the fields.
+   */
+  uint64_t fromBufferSkippingDocuments(uint32_t message_length, Buffer::Instance& data);
 
 private:
+  void fieldsFromBuffer(uint32_t message_length, Buffer::Instance& data);
+
   int32_t flags_{};
   int64_t cursor_id_{};
   int32_t starting_from_{};
   int32_t number_returned_{};
-  std::list<Bson::DocumentSharedPtr> documents_;
+  Bson::LazyDocumentList documents_;
+  // Set when the documents were skipped rather than decoded.
+  absl::optional<uint64_t> skipped_documents_byte_size_;
 };
 
 // OP_COMMAND message.
@@ -210,15 +231,17 @@ public:
   void commandArgs(Bson::DocumentSharedPtr&& command_args) override {
     command_args_ = std::move(command_args);
   }
-  const std::list<Bson::DocumentSharedPtr>& inputDocs() const override { return input_docs_; }
-  std::list<Bson::DocumentSharedPtr>& inputDocs() override { return input_docs_; }
+  const std::list<Bson::DocumentSharedPtr>& inputDocs() const override {
+    return input_docs_.documents();
+  }
+  std::list<Bson::DocumentSharedPtr>& inputDocs() override { return input_docs_.documents(); }
 
 private:
   std::string database_;
   std::string command_name_;
   Bson::DocumentSharedPtr metadata_;
   Bson::DocumentSharedPtr command_args_;
-  std::list<Bson::DocumentSharedPtr> input_docs_;
+  Bson::LazyDocumentList input_docs_;
 };
 
 // OP_COMMANDREPLY message.
@@ -240,26 +263,39 @@ public:
   void commandReply(Bson::DocumentSharedPtr&& command_reply) override {
     command_reply_ = std::move(command_reply);
   }
-  const std::list<Bson::DocumentSharedPtr>& outputDocs() const override { return output_docs_; }
-  std::list<Bson::DocumentSharedPtr>& outputDocs() override { return output_docs_; }
+  const std::list<Bson::DocumentSharedPtr>& outputDocs() const override {
+    return output_docs_.documents();
+  }
+  std::list<Bson::DocumentSharedPtr>& outputDocs() override { return output_docs_.documents(); }
 
 private:
   Bson::DocumentSharedPtr metadata_;
   Bson::DocumentSharedPtr command_reply_;
-  std::list<Bson::DocumentSharedPtr> output_docs_;
+  Bson::LazyDocumentList output_docs_;
 };
 
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::mongo> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+  /**
+   * @param callbacks supplies the callbacks of the decoded messages.
+   * @param skip_reply_documents supplies whether the documents of the replies are drained as they
+   *        are received rather than buffered and decoded. The replies are then decoded as soon as
+   *        their fields are received, and have no documents.
+   */
+  DecoderImpl(DecoderCallbacks& callbacks, bool skip_reply_documents = false)
+      : callbacks_(callbacks), skip_reply_documents_(skip_reply_documents) {}
 
   // Mongo::Decoder
   void onData(Buffer::Instance& data) override;
 
 private:
   bool decode(Buffer::Instance& data);
+  void skipReplyDocuments(Buffer::Instance& data);
 
   DecoderCallbacks& callbacks_;
+  const bool skip_reply_documents_;
+  // The bytes of documents of the last reply which are still to be drained.
+  uint64_t reply_bytes_to_skip_{};
 };
 
 class EncoderImpl : public Encoder, Logger::Loggable<Logger::Id::mongo> {
@@ -34,11 +34,13 @@ Network::FilterFactoryCb MongoProxyFilterConfigFactory::createFilterFactoryFromP
 
   auto stats = std::make_shared<MongoStats>(context.scope(), stat_prefix);
   const bool emit_dynamic_metadata = proto_config.emit_dynamic_metadata();
+  const bool skip_reply_documents = proto_config.skip_reply_documents();
   return [stat_prefix, &context, access_log, fault_config, emit_dynamic_metadata,
-          stats](Network::FilterManager& filter_manager) -> void {
+          skip_reply_documents, stats](Network::FilterManager& filter_manager) -> void {
     filter_manager.addFilter(std::make_shared<ProdProxyFilter>(
         stat_prefix, context.scope(), context.runtime(), access_log, fault_config,
-        context.drainDecision(), context.dispatcher().timeSource(), emit_dynamic_metadata, stats));
+        context.drainDecision(), context.dispatcher().timeSource(), emit_dynamic_metadata,
+        skip_reply_documents, stats));
   };
 }
 
@@ -58,8 +58,10 @@ ProxyFilter::ProxyFilter(const std::string& stat_prefix, Stats::Scope& scope,
                          Runtime::Loader& runtime, AccessLogSharedPtr access_log,
                          const Filters::Common::Fault::FaultDelayConfigSharedPtr& fault_config,
                          const Network::DrainDecision& drain_decision, TimeSource& time_source,
-                         bool emit_dynamic_metadata, const MongoStatsSharedPtr& mongo_stats)
-    : stat_prefix_(stat_prefix), stats_(generateStats(stat_prefix, scope)), runtime_(runtime),
+                         bool emit_dynamic_metadata, bool skip_reply_documents,
+                         const MongoStatsSharedPtr& mongo_stats)
+    : skip_reply_documents_(skip_reply_documents), stat_prefix_(stat_prefix),
+      stats_(generateStats(stat_prefix, scope)), runtime_(runtime),
       drain_decision_(drain_decision), access_log_(access_log), fault_config_(fault_config),
       time_source_(time_source), emit_dynamic_metadata_(emit_dynamic_metadata),
       mongo_stats_(mongo_stats) {
@@ -292,20 +294,16 @@ void ProxyFilter::onDrainClose() {
 
 void ProxyFilter::chargeReplyStats(ActiveQuery& active_query, Stats::StatNameVec& names,
                                    const ReplyMessage& message) {
-  uint64_t reply_documents_byte_size = 0;
-  for (const Bson::DocumentSharedPtr& document : message.documents()) {
-    reply_documents_byte_size += document->byteSize();
-  }
-
   // Write 3 different histograms; appending 3 different suffixes to the name
   // that was passed in. Here we overwrite the passed-in names, but we restore
   // names to its original state upon return.
   const size_t orig_size = names.size();
   names.push_back(mongo_stats_->reply_num_docs_);
   mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Unspecified,
-                                message.documents().size());
+                                message.documentsCount());
   names[orig_size] = mongo_stats_->reply_size_;
-  mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Bytes, reply_documents_byte_size);
+  mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Bytes,
+                                message.documentsByteSize());
   names[orig_size] = mongo_stats_->reply_time_ms_;
   mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Milliseconds,
                                 std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -389,7 +387,7 @@ Network::FilterStatus ProxyFilter::onWrite(Buffer::Instance& data, bool) {
 }
 
 DecoderPtr ProdProxyFilter::createDecoder(DecoderCallbacks& callbacks) {
-  return DecoderPtr{new DecoderImpl(callbacks)};
+  return DecoderPtr{new DecoderImpl(callbacks, skip_reply_documents_)};
 }
 
 absl::optional<std::chrono::milliseconds> ProxyFilter::delayDuration() {
@@ -110,7 +110,8 @@ public:
               AccessLogSharedPtr access_log,
               const Filters::Common::Fault::FaultDelayConfigSharedPtr& fault_config,
               const Network::DrainDecision& drain_decision, TimeSource& time_system,
-              bool emit_dynamic_metadata, const MongoStatsSharedPtr& stats);
+              bool emit_dynamic_metadata, bool skip_reply_documents,
+              const MongoStatsSharedPtr& stats);
   ~ProxyFilter() override;
 
   virtual DecoderPtr createDecoder(DecoderCallbacks& callbacks) PURE;
@@ -142,6 +143,9 @@ public:
 
   void setDynamicMetadata(std::string operation, std::string resource);
 
+protected:
+  const bool skip_reply_documents_;
+
 private:
   struct ActiveQuery {
     ActiveQuery(ProxyFilter& parent, const QueryMessage& query)
@@ -1,5 +1,7 @@
 #include "extensions/filters/network/mysql_proxy/mysql_decoder.h"
 
+#include <algorithm>
+
 #include "extensions/filters/network/mysql_proxy/mysql_utils.h"
 
 namespace Envoy {
@@ -7,6 +9,24 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace MySQLProxy {
 
+namespace {
+
+// Whether the payload of the packets received in a state is parsed. The payload of the other
+// packets (e.g. result sets) is skipped as it is received, rather than buffered whole.
+bool payloadParsed(MySQLSession::State state) {
+  switch (state) {
+  case MySQLSession::State::SslPt:
+  case MySQLSession::State::ReqResp:
+  case MySQLSession::State::Error:
+  case MySQLSession::State::NotHandled:
+    return false;
+  default:
+    return true;
+  }
+}
+
+} // namespace
+
 void DecoderImpl::parseMessage(Buffer::Instance& message, uint8_t seq, uint32_t len) {
   ENVOY_LOG(trace, "mysql_proxy: parsing message, seq {}, len {}", seq, len);
 
@@ -139,25 +159,34 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
     throw EnvoyException("error parsing mysql packet header");
   }
 
-  // If message is split over multiple packets, hold off until the entire message is available.
-  // Consider the size of the header here as it's not consumed yet.
-  if (sizeof(uint32_t) + len > data.length()) {
+  // If message is split over multiple packets, hold off until the entire message is available,
+  // unless its payload is skipped. Consider the size of the header here as it's not consumed yet.
+  const bool parse_payload =
+      seq == session_.getExpectedSeq() && payloadParsed(session_.getState());
+  if (parse_payload && sizeof(uint32_t) + len > data.length()) {
     return false;
   }
 
-  BufferHelper::consumeHdr(data); // Consume the header once the message is fully available.
+  BufferHelper::consumeHdr(data);
   callbacks_.onNewMessage(session_.getState());
 
   // Ignore duplicate and out-of-sync packets.
   if (seq != session_.getExpectedSeq()) {
     callbacks_.onProtocolError();
     ENVOY_LOG(info, "mysql_proxy: ignoring out-of-sync packet");
-    data.drain(len); // Ensure that the whole message was consumed
+    skipPayload(data, len);
     return true;
   }
 
   session_.setExpectedSeq(seq + 1);
 
+  if (!parse_payload) {
+    Buffer::OwnedImpl payload;
+    parseMessage(payload, seq, len);
+    skipPayload(data, len);
+    return true;
+  }
+
   const ssize_t data_len = data.length();
   parseMessage(data, seq, len);
   const ssize_t consumed_len = data_len - data.length();
@@ -167,7 +196,18 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   return true;
 }
 
+void DecoderImpl::skipPayload(Buffer::Instance& data, uint32_t len) {
+  const uint64_t skipped = std::min<uint64_t>(len, data.length());
+  data.drain(skipped);
+  bytes_to_skip_ = len - skipped;
+}
+
 void DecoderImpl::onData(Buffer::Instance& data) {
+  // Skip the rest of the payload of a packet received in previous buffers.
+  const uint64_t skipped = std::min(bytes_to_skip_, data.length());
+  data.drain(skipped);
+  bytes_to_skip_ -= skipped;
+
   // TODO(venilnoronha): handle messages over 16 mb. See
   // https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_basic_packets.html#sect_protocol_basic_packets_sending_mt_16mb.
   while (!BufferHelper::endOfBuffer(data) && decode(data)) {
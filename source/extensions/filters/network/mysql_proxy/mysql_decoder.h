@@ -60,9 +60,13 @@ public:
 private:
   bool decode(Buffer::Instance& data);
   void parseMessage(Buffer::Instance& message, uint8_t seq, uint32_t len);
+  void skipPayload(Buffer::Instance& data, uint32_t len);
 
   DecoderCallbacks& callbacks_;
   MySQLSession session_;
+  // The number of bytes of the payload of the last packet left to skip. As the protocol is half
+  // duplex, a single count covers both directions.
+  uint64_t bytes_to_skip_{};
 };
 
 } // namespace MySQLProxy
@@ -82,9 +82,21 @@ EngineResult
 RoleBasedAccessControlFilter::checkEngine(Filters::Common::RBAC::EnforcementMode mode) {
   const auto engine = config_->engine(mode);
   if (engine != nullptr) {
-    std::string effective_policy_id;
-    if (engine->allowed(callbacks_->connection(), callbacks_->connection().streamInfo(),
-                        &effective_policy_id)) {
+    const bool shadow = mode == Filters::Common::RBAC::EnforcementMode::Shadow;
+    const EngineResult previous_result = shadow ? shadow_engine_result_ : engine_result_;
+    std::string& effective_policy_id =
+        shadow ? shadow_effective_policy_id_ : enforced_effective_policy_id_;
+    bool allowed;
+    // With continuous enforcement the decision of an engine which only depends on the connection
+    // can not change, so it is only evaluated once.
+    if (engine->connectionOnly() && (previous_result == Allow || previous_result == Deny)) {
+      allowed = previous_result == Allow;
+    } else {
+      effective_policy_id.clear();
+      allowed = engine->allowed(callbacks_->connection(), callbacks_->connection().streamInfo(),
+                                &effective_policy_id);
+    }
+    if (allowed) {
       if (mode == Filters::Common::RBAC::EnforcementMode::Shadow) {
         ENVOY_LOG(debug, "shadow allowed");
         config_->stats().shadow_allowed_.inc();
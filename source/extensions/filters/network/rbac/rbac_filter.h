@@ -75,6 +75,8 @@ private:
   Network::ReadFilterCallbacks* callbacks_{};
   EngineResult engine_result_{Unknown};
   EngineResult shadow_engine_result_{Unknown};
+  std::string enforced_effective_policy_id_;
+  std::string shadow_effective_policy_id_;
 
   EngineResult checkEngine(Filters::Common::RBAC::EnforcementMode mode);
 };
@@ -12,10 +12,13 @@
 #include "envoy/extensions/filters/network/redis_proxy/v3alpha/redis_proxy.pb.validate.h"
 
 #include "common/common/assert.h"
+#include "common/common/utility.h"
 #include "common/stats/utility.h"
 
 #include "extensions/filters/network/redis_proxy/config.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -231,9 +234,9 @@ InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&&
     return nullptr;
   }
 
-  Clusters::Redis::RedisLoadBalancerContextImpl lb_context(key, parent_.config_.enableHashtagging(),
-                                                           is_redis_cluster_, getRequest(request),
-                                                           parent_.config_.readPolicy());
+  Clusters::Redis::RedisLoadBalancerContextImpl lb_context(
+      key, parent_.config_.enableHashtagging(), is_redis_cluster_, getRequest(request),
+      parent_.config_.readPolicy(), parent_.config_.replicaSelection());
   Upstream::HostConstSharedPtr host = cluster_->loadBalancer().chooseHost(&lb_context);
   if (!host) {
     return nullptr;
@@ -404,6 +407,16 @@ bool InstanceImpl::PendingRequest::onRedirection(Common::Redis::RespValuePtr&& v
     onResponse(std::move(value));
     return false;
   } else {
+    if (!ask_redirection) {
+      // A MOVED redirection error has the slot of the request as its second substring, which is
+      // now served by host_address.
+      const std::vector<absl::string_view> err =
+          StringUtil::splitToken(value->asString(), " ", false);
+      uint64_t slot;
+      if (err.size() == 3 && absl::SimpleAtoi(err[1], &slot)) {
+        parent_.parent_.onSlotMoved(slot, host_address);
+      }
+    }
     parent_.parent_.onRedirection();
     return true;
   }
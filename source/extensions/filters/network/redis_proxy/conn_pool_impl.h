@@ -82,6 +82,9 @@ public:
   bool onRedirection() override { return refresh_manager_->onRedirection(cluster_name_); }
   bool onFailure() { return refresh_manager_->onFailure(cluster_name_); }
   bool onHostDegraded() { return refresh_manager_->onHostDegraded(cluster_name_); }
+  bool onSlotMoved(uint64_t slot, const std::string& address) {
+    return refresh_manager_->onSlotMoved(cluster_name_, slot, address);
+  }
 
   // Allow the unit test to have access to private members.
   friend class RedisConnPoolImplTest;
@@ -176,6 +176,16 @@ DecoderEventHandler& ConnectionManager::newDecoderEventHandler() {
   return **rpcs_.begin();
 }
 
+bool ConnectionManager::passthroughEnabled() const {
+  if (!config_.payloadPassthrough()) {
+    return false;
+  }
+
+  // The decoder queries the RPC whose message begin was just decoded, which is the newest one.
+  ASSERT(!rpcs_.empty());
+  return (*rpcs_.begin())->passthroughSupported();
+}
+
 bool ConnectionManager::ResponseDecoder::onData(Buffer::Instance& data) {
   upstream_buffer_.move(data);
 
@@ -194,6 +204,33 @@ FilterStatus ConnectionManager::ResponseDecoder::messageBegin(MessageMetadataSha
   return ProtocolConverter::messageBegin(metadata);
 }
 
+FilterStatus ConnectionManager::ResponseDecoder::passthroughData(Buffer::Instance& data) {
+  if (first_reply_field_) {
+    // See fieldBegin. The first field header is read from a copy of its bytes, with a protocol of
+    // its own so that the state of the decoder is left as is. Field headers take at most 4 bytes,
+    // in the compact protocol.
+    constexpr uint64_t MaxFieldBeginBytes = 4;
+    uint8_t field_bytes[MaxFieldBeginBytes];
+    Buffer::OwnedImpl field_buffer;
+    const uint64_t size = std::min<uint64_t>(data.length(), MaxFieldBeginBytes);
+    data.copyOut(0, size, field_bytes);
+    field_buffer.add(field_bytes, size);
+
+    ProtocolPtr protocol =
+        NamedProtocolConfigFactory::getFactory(decoder_->protocolType()).createProtocol();
+    std::string name;
+    FieldType field_type;
+    int16_t field_id;
+    if (protocol->readStructBegin(field_buffer, name) &&
+        protocol->readFieldBegin(field_buffer, name, field_type, field_id)) {
+      success_ = field_id == 0 && field_type != FieldType::Stop;
+    }
+    first_reply_field_ = false;
+  }
+
+  return ProtocolConverter::passthroughData(data);
+}
+
 FilterStatus ConnectionManager::ResponseDecoder::fieldBegin(absl::string_view name,
                                                             FieldType& field_type,
                                                             int16_t& field_id) {
@@ -208,6 +245,15 @@ FilterStatus ConnectionManager::ResponseDecoder::fieldBegin(absl::string_view na
   return ProtocolConverter::fieldBegin(name, field_type, field_id);
 }
 
+bool ConnectionManager::ResponseDecoder::passthroughEnabled() const {
+  // The body of the response can be moved to the downstream response when both are encoded in the
+  // same protocol.
+  const ConnectionManager& cm = parent_.parent_;
+  const ProtocolType protocol = cm.decoder_->protocolType();
+  return cm.config_.payloadPassthrough() && decoder_->protocolType() == protocol &&
+         protocol != ProtocolType::Twitter;
+}
+
 FilterStatus ConnectionManager::ResponseDecoder::transportEnd() {
   ASSERT(metadata_ != nullptr);
 
@@ -308,6 +354,24 @@ FilterStatus ConnectionManager::ActiveRpc::applyDecoderFilters(ActiveRpcDecoderF
   return FilterStatus::Continue;
 }
 
+bool ConnectionManager::ActiveRpc::passthroughSupported() const {
+  if (upgrade_handler_) {
+    return false;
+  }
+
+  if (local_response_sent_) {
+    // The rest of the request is dropped.
+    return true;
+  }
+
+  for (auto& entry : decoder_filters_) {
+    if (!entry->handle_->passthroughSupported()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 FilterStatus ConnectionManager::ActiveRpc::transportBegin(MessageMetadataSharedPtr metadata) {
   filter_context_ = metadata;
   filter_action_ = [this](DecoderEventHandler* filter) -> FilterStatus {
@@ -412,6 +476,16 @@ FilterStatus ConnectionManager::ActiveRpc::messageEnd() {
   return applyDecoderFilters(nullptr);
 }
 
+FilterStatus ConnectionManager::ActiveRpc::passthroughData(Buffer::Instance& data) {
+  filter_context_ = &data;
+  filter_action_ = [this](DecoderEventHandler* filter) -> FilterStatus {
+    Buffer::Instance* data = absl::any_cast<Buffer::Instance*>(filter_context_);
+    return filter->passthroughData(*data);
+  };
+
+  return applyDecoderFilters(nullptr);
+}
+
 FilterStatus ConnectionManager::ActiveRpc::structBegin(absl::string_view name) {
   filter_context_ = std::string(name);
   filter_action_ = [this](DecoderEventHandler* filter) -> FilterStatus {
@@ -39,6 +39,7 @@ public:
   virtual TransportPtr createTransport() PURE;
   virtual ProtocolPtr createProtocol() PURE;
   virtual Router::Config& routerConfig() PURE;
+  virtual bool payloadPassthrough() const PURE;
 };
 
 /**
@@ -76,6 +77,7 @@ public:
 
   // DecoderCallbacks
   DecoderEventHandler& newDecoderEventHandler() override;
+  bool passthroughEnabled() const override;
 
 private:
   struct ActiveRpc;
@@ -91,6 +93,7 @@ private:
 
     // ProtocolConverter
     FilterStatus messageBegin(MessageMetadataSharedPtr metadata) override;
+    FilterStatus passthroughData(Buffer::Instance& data) override;
     FilterStatus fieldBegin(absl::string_view name, FieldType& field_type,
                             int16_t& field_id) override;
     FilterStatus transportBegin(MessageMetadataSharedPtr metadata) override {
@@ -101,6 +104,7 @@ private:
 
     // DecoderCallbacks
     DecoderEventHandler& newDecoderEventHandler() override { return *this; }
+    bool passthroughEnabled() const override;
 
     ActiveRpc& parent_;
     DecoderPtr decoder_;
@@ -179,6 +183,7 @@ private:
     FilterStatus transportEnd() override;
     FilterStatus messageBegin(MessageMetadataSharedPtr metadata) override;
     FilterStatus messageEnd() override;
+    FilterStatus passthroughData(Buffer::Instance& data) override;
     FilterStatus structBegin(absl::string_view name) override;
     FilterStatus structEnd() override;
     FilterStatus fieldBegin(absl::string_view name, FieldType& field_type,
@@ -223,6 +228,7 @@ private:
     }
 
     FilterStatus applyDecoderFilters(ActiveRpcDecoderFilter* filter);
+    bool passthroughSupported() const;
     void finalizeRequest();
 
     void createFilterChain();
@@ -14,8 +14,10 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace ThriftProxy {
 
-// MessageBegin -> StructBegin
+// MessageBegin -> StructBegin, or
+// MessageBegin -> PassthroughData
 DecoderStateMachine::DecoderStatus DecoderStateMachine::messageBegin(Buffer::Instance& buffer) {
+  const uint64_t available = buffer.length();
   if (!proto_.readMessageBegin(buffer, *metadata_)) {
     return {ProtocolState::WaitForData};
   }
@@ -23,7 +25,21 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::messageBegin(Buffer::Ins
   stack_.clear();
   stack_.emplace_back(Frame(ProtocolState::MessageEnd));
 
-  return {ProtocolState::StructBegin, handler_.messageBegin(metadata_)};
+  const FilterStatus status = handler_.messageBegin(metadata_);
+
+  // The body can only be delimited when the transport reports the size of the message.
+  if (metadata_->hasFrameSize() && callbacks_.passthroughEnabled()) {
+    const uint64_t header_bytes = available - buffer.length();
+    if (header_bytes > metadata_->frameSize()) {
+      throw EnvoyException(fmt::format("message begin of {} bytes exceeds the frame size of {}",
+                                       header_bytes, metadata_->frameSize()));
+    }
+
+    body_bytes_ = metadata_->frameSize() - header_bytes;
+    return {ProtocolState::PassthroughData, status};
+  }
+
+  return {ProtocolState::StructBegin, status};
 }
 
 // MessageEnd -> Done
@@ -35,6 +51,16 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::messageEnd(Buffer::Insta
   return {ProtocolState::Done, handler_.messageEnd()};
 }
 
+// PassthroughData -> MessageEnd
+DecoderStateMachine::DecoderStatus DecoderStateMachine::passthroughData(Buffer::Instance& buffer) {
+  if (buffer.length() < body_bytes_) {
+    return {ProtocolState::WaitForData};
+  }
+
+  passthrough_buffer_.move(buffer, body_bytes_);
+  return {ProtocolState::MessageEnd, handler_.passthroughData(passthrough_buffer_)};
+}
+
 // StructBegin -> FieldBegin
 DecoderStateMachine::DecoderStatus DecoderStateMachine::structBegin(Buffer::Instance& buffer) {
   std::string name;
@@ -288,6 +314,8 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::handleState(Buffer::Inst
   switch (state_) {
   case ProtocolState::MessageBegin:
     return messageBegin(buffer);
+  case ProtocolState::PassthroughData:
+    return passthroughData(buffer);
   case ProtocolState::StructBegin:
     return structBegin(buffer);
   case ProtocolState::StructEnd:
@@ -409,7 +437,7 @@ FilterStatus Decoder::onData(Buffer::Instance& data, bool& buffer_underflow) {
     request_ = std::make_unique<ActiveRequest>(callbacks_.newDecoderEventHandler());
     frame_started_ = true;
     state_machine_ =
-        std::make_unique<DecoderStateMachine>(protocol_, metadata_, request_->handler_);
+        std::make_unique<DecoderStateMachine>(protocol_, metadata_, request_->handler_, callbacks_);
 
     if (request_->handler_.transportBegin(metadata_) == FilterStatus::StopIteration) {
       return FilterStatus::StopIteration;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/buffer/buffer.h"
+
 #include "extensions/filters/network/thrift_proxy/metadata.h"
 #include "extensions/filters/network/thrift_proxy/thrift.h"
 
@@ -48,6 +50,15 @@ public:
    */
   virtual FilterStatus messageEnd() PURE;
 
+  /**
+   * Indicates that the body of a Thrift protocol message, following its message begin, is passed
+   * through without being decoded. Handlers forwarding the message drain the body from the
+   * buffer. Called between messageBegin and messageEnd in place of the struct events.
+   * @param data the Buffer containing the protocol encoded body of the message
+   * @return FilterStatus to indicate if filter chain iteration should continue
+   */
+  virtual FilterStatus passthroughData(Buffer::Instance& data) PURE;
+
   /**
    * Indicates that the start of a Thrift protocol struct was detected.
    * @param name the name of the struct, if available
@@ -123,6 +123,13 @@ public:
    * filter should use. Callbacks will not be invoked by the filter after onDestroy() is called.
    */
   virtual void setDecoderFilterCallbacks(DecoderFilterCallbacks& callbacks) PURE;
+
+  /**
+   * Called once the filter has handled the message begin of a request.
+   * @return bool true if the filter does not need the fields of the request, which may then be
+   *         passed through to the filter with passthroughData in place of the struct events.
+   */
+  virtual bool passthroughSupported() const PURE;
 };
 
 using DecoderFilterSharedPtr = std::shared_ptr<DecoderFilter>;
@@ -78,6 +78,7 @@ public:
       ThriftProxy::ThriftFilters::DecoderFilterCallbacks& callbacks) override {
     callbacks_ = &callbacks;
   };
+  bool passthroughSupported() const override { return true; }
   ThriftProxy::FilterStatus
   transportBegin(NetworkFilters::ThriftProxy::MessageMetadataSharedPtr) override {
     return ThriftProxy::FilterStatus::Continue;
@@ -85,6 +86,9 @@ public:
   ThriftProxy::FilterStatus transportEnd() override { return ThriftProxy::FilterStatus::Continue; }
   ThriftProxy::FilterStatus messageBegin(ThriftProxy::MessageMetadataSharedPtr) override;
   ThriftProxy::FilterStatus messageEnd() override { return ThriftProxy::FilterStatus::Continue; }
+  ThriftProxy::FilterStatus passthroughData(Buffer::Instance&) override {
+    return ThriftProxy::FilterStatus::Continue;
+  }
   ThriftProxy::FilterStatus structBegin(absl::string_view) override {
     return ThriftProxy::FilterStatus::Continue;
   }
@@ -35,6 +35,12 @@ public:
     return FilterStatus::Continue;
   }
 
+  FilterStatus passthroughData(Buffer::Instance& data) override {
+    // The body is encoded in the protocol of the converter, and is moved rather than re-encoded.
+    buffer_->move(data);
+    return FilterStatus::Continue;
+  }
+
   FilterStatus structBegin(absl::string_view name) override {
     proto_->writeStructBegin(*buffer_, std::string(name));
     return FilterStatus::Continue;
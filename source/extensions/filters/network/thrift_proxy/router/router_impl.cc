@@ -255,8 +255,9 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
                                       : callbacks_->downstreamTransportType();
   ASSERT(transport != TransportType::Auto);
 
-  const ProtocolType protocol = options ? options->protocol(callbacks_->downstreamProtocolType())
-                                        : callbacks_->downstreamProtocolType();
+  const ProtocolType downstream_protocol = callbacks_->downstreamProtocolType();
+  const ProtocolType protocol =
+      options ? options->protocol(downstream_protocol) : downstream_protocol;
   ASSERT(protocol != ProtocolType::Auto);
 
   Tcp::ConnectionPool::Instance* conn_pool = cluster_manager_.tcpConnPoolForCluster(
@@ -272,6 +273,10 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
 
   ENVOY_STREAM_LOG(debug, "router decoding request", *callbacks_);
 
+  // The Twitter protocol is left out, as its upgraded connections add request headers to the
+  // messages.
+  passthrough_supported_ = protocol == downstream_protocol && protocol != ProtocolType::Twitter;
+
   if (route_entry_->stripServiceName()) {
     const auto& method = metadata->methodName();
     const auto pos = method.find(':');
@@ -190,6 +190,7 @@ public:
   // ThriftFilters::DecoderFilter
   void onDestroy() override;
   void setDecoderFilterCallbacks(ThriftFilters::DecoderFilterCallbacks& callbacks) override;
+  bool passthroughSupported() const override { return passthrough_supported_; }
 
   // ProtocolConverter
   FilterStatus transportBegin(MessageMetadataSharedPtr metadata) override;
@@ -270,6 +271,10 @@ private:
 
   std::unique_ptr<UpstreamRequest> upstream_request_;
   Buffer::OwnedImpl upstream_request_buffer_;
+
+  // Whether the body of the request is encoded in the upstream protocol, and can be moved to the
+  // upstream request as is.
+  bool passthrough_supported_{false};
 };
 
 } // namespace Router
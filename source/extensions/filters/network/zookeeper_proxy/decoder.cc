@@ -1,5 +1,6 @@
 #include "extensions/filters/network/zookeeper_proxy/decoder.h"
 
+#include <algorithm>
 #include <string>
 
 #include "common/common/enum_to_int.h"
@@ -461,37 +462,123 @@ void DecoderImpl::onData(Buffer::Instance& data) { decode(data, DecodeType::READ
 void DecoderImpl::onWrite(Buffer::Instance& data) { decode(data, DecodeType::WRITE); }
 
 void DecoderImpl::decode(Buffer::Instance& data, DecodeType dtype) {
+  DecodeState& state = dtype == DecodeType::READ ? request_state_ : response_state_;
   uint64_t offset = 0;
 
   try {
+    // Skip the rest of the payload of a packet decoded from a previous buffer.
+    offset = std::min(state.bytes_to_skip_, data.length());
+    state.bytes_to_skip_ -= offset;
+
+    // Complete the beginning of a packet split across buffers, copying only the bytes needed to
+    // decode it. The payload of the packet, if any, is then skipped in place.
+    while (state.partial_.length() > 0) {
+      const uint64_t needed = bytesNeeded(state.partial_, 0, dtype);
+      if (state.partial_.length() < needed) {
+        if (offset == data.length()) {
+          return;
+        }
+        const uint64_t size = std::min(needed - state.partial_.length(), data.length() - offset);
+        std::string bytes(size, '\0');
+        data.copyOut(offset, size, &bytes[0]);
+        state.partial_.add(bytes);
+        offset += size;
+        continue;
+      }
+
+      uint64_t partial_offset = 0;
+      decodePacket(state.partial_, partial_offset, dtype);
+      if (partial_offset > state.partial_.length()) {
+        state.bytes_to_skip_ = partial_offset - state.partial_.length();
+        const uint64_t skipped = std::min(state.bytes_to_skip_, data.length() - offset);
+        state.bytes_to_skip_ -= skipped;
+        offset += skipped;
+      }
+      state.partial_.drain(std::min(partial_offset, state.partial_.length()));
+    }
+
     while (offset < data.length()) {
-      // Reset the helper's cursor, to ensure the current message stays within the
-      // allowed max length, even when it's different than the declared length
-      // by the message.
-      //
-      // Note: we need to keep two cursors — offset and helper_'s internal one — because
-      //       a buffer may contain multiple messages, so offset is global while helper_'s
-      //       internal cursor gets reset for each individual message.
-      helper_.reset();
-
-      const uint64_t current = offset;
-      switch (dtype) {
-      case DecodeType::READ:
-        decodeOnData(data, offset);
-        callbacks_.onRequestBytes(offset - current);
-        break;
-      case DecodeType::WRITE:
-        decodeOnWrite(data, offset);
-        callbacks_.onResponseBytes(offset - current);
+      const uint64_t available = data.length() - offset;
+      if (available < bytesNeeded(data, offset, dtype)) {
+        // Wait for the rest of the beginning of the packet.
+        std::string bytes(available, '\0');
+        data.copyOut(offset, available, &bytes[0]);
+        state.partial_.add(bytes);
+        offset = data.length();
         break;
       }
+      decodePacket(data, offset, dtype);
+    }
+
+    // The payload of the last packet may continue in the next buffers.
+    if (offset > data.length()) {
+      state.bytes_to_skip_ = offset - data.length();
     }
   } catch (const EnvoyException& e) {
     ENVOY_LOG(debug, "zookeeper_proxy: decoding exception {}", e.what());
+    state.partial_.drain(state.partial_.length());
+    state.bytes_to_skip_ = 0;
     callbacks_.onDecodeError();
   }
 }
 
+void DecoderImpl::decodePacket(Buffer::Instance& data, uint64_t& offset, DecodeType dtype) {
+  // Reset the helper's cursor, to ensure the current message stays within the
+  // allowed max length, even when it's different than the declared length
+  // by the message.
+  //
+  // Note: we need to keep two cursors — offset and helper_'s internal one — because
+  //       a buffer may contain multiple messages, so offset is global while helper_'s
+  //       internal cursor gets reset for each individual message.
+  helper_.reset();
+
+  const uint64_t current = offset;
+  switch (dtype) {
+  case DecodeType::READ:
+    decodeOnData(data, offset);
+    callbacks_.onRequestBytes(offset - current);
+    break;
+  case DecodeType::WRITE:
+    decodeOnWrite(data, offset);
+    callbacks_.onResponseBytes(offset - current);
+    break;
+  }
+}
+
+uint64_t DecoderImpl::bytesNeeded(Buffer::Instance& data, uint64_t offset,
+                                  DecodeType dtype) const {
+  const uint64_t available = data.length() - offset;
+  if (available < INT_LENGTH) {
+    return INT_LENGTH;
+  }
+
+  // Let the decoding fail right away on an invalid length.
+  const int32_t len = data.peekBEInt<int32_t>(offset);
+  if (len < static_cast<int32_t>(INT_LENGTH + XID_LENGTH) ||
+      static_cast<uint32_t>(len) > max_packet_bytes_) {
+    return 0;
+  }
+
+  // Requests are decoded whole, as some of their fields follow their data (e.g. the flags of a
+  // create request).
+  const uint64_t packet_length = INT_LENGTH + len;
+  if (dtype == DecodeType::READ) {
+    return packet_length;
+  }
+
+  if (available < INT_LENGTH + XID_LENGTH) {
+    return INT_LENGTH + XID_LENGTH;
+  }
+
+  // Only the reply header of responses is decoded, except for connect responses and watch
+  // events, so their payload (e.g. znode data or children) is skipped without being buffered.
+  const auto xid_code = static_cast<XidCodes>(data.peekBEInt<int32_t>(offset + INT_LENGTH));
+  if (xid_code == XidCodes::ConnectXid || xid_code == XidCodes::WatchXid) {
+    return packet_length;
+  }
+  return std::min<uint64_t>(packet_length, INT_LENGTH + SERVER_HEADER_LENGTH);
+}
+
 void DecoderImpl::parseConnectResponse(Buffer::Instance& data, uint64_t& offset, uint32_t len,
                                        const std::chrono::milliseconds& latency) {
   ensureMinLength(len, PROTOCOL_VERSION_LENGTH + TIMEOUT_LENGTH + SESSION_LENGTH + INT_LENGTH);
@@ -134,8 +134,18 @@ private:
     OpCodes opcode;
     MonotonicTime start_time;
   };
+  // The decoding state of a direction, carried over from a buffer to the next one when a packet is
+  // split across them.
+  struct DecodeState {
+    // The beginning of a packet, holding only the bytes needed to decode it.
+    Buffer::OwnedImpl partial_;
+    // The number of bytes of the payload of a decoded packet left to skip.
+    uint64_t bytes_to_skip_{};
+  };
 
   void decode(Buffer::Instance& data, DecodeType dtype);
+  void decodePacket(Buffer::Instance& data, uint64_t& offset, DecodeType dtype);
+  uint64_t bytesNeeded(Buffer::Instance& data, uint64_t offset, DecodeType dtype) const;
   void decodeOnData(Buffer::Instance& data, uint64_t& offset);
   void decodeOnWrite(Buffer::Instance& data, uint64_t& offset);
   void parseConnect(Buffer::Instance& data, uint64_t& offset, uint32_t len);
@@ -170,6 +180,8 @@ private:
   BufferHelper helper_;
   TimeSource& time_source_;
   std::unordered_map<int32_t, RequestBegin> requests_by_xid_;
+  DecodeState request_state_;
+  DecodeState response_state_;
 };
 
 } // namespace ZooKeeperProxy
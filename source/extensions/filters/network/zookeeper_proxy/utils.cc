@@ -46,9 +46,8 @@ std::string BufferHelper::peekString(Buffer::Instance& buffer, uint64_t& offset)
 
   ensureMaxLen(len);
 
-  std::unique_ptr<char[]> data(new char[len]);
-  buffer.copyOut(offset, len, data.get());
-  val.assign(data.get(), len);
+  val.resize(len);
+  buffer.copyOut(offset, len, &val[0]);
   offset += len;
 
   return val;
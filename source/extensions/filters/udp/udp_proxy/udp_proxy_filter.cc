@@ -2,6 +2,8 @@
 
 #include "envoy/network/listener.h"
 
+#include "common/common/stack_array.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace UdpFilters {
@@ -155,8 +157,9 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
     : cluster_(cluster), addresses_(std::move(addresses)), host_(host),
       idle_timer_(cluster.filter_.read_callbacks_->udpListener().dispatcher().createTimer(
           [this] { onIdleTimer(); })),
-      // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
-      //       is bound until the first packet is sent to the upstream host.
+      // NOTE: The socket call can only fail due to memory/fd exhaustion. A local ephemeral port is
+      //       bound when the socket is connected to the upstream host, which can fail due to port
+      //       exhaustion.
       io_handle_(cluster.filter_.createIoHandle(host)),
       socket_event_(cluster.filter_.read_callbacks_->udpListener().dispatcher().createFileEvent(
           io_handle_->fd(), [this](uint32_t) { onReadReady(); }, Event::FileTriggerType::Edge,
@@ -218,12 +221,12 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
 
   idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
 
-  // NOTE: On the first write, a local ephemeral port is bound, and thus this write can fail due to
-  //       port exhaustion.
-  // NOTE: We do not specify the local IP to use for the sendmsg call. We allow the OS to select
-  //       the right IP based on outbound routing rules.
-  Api::IoCallUint64Result rc =
-      Network::Utility::writeToSocket(*io_handle_, buffer, nullptr, *host_->address());
+  // NOTE: The socket is connected to the upstream host, so the datagram is written without a peer
+  //       address, and the OS selects the local IP based on outbound routing rules.
+  const uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer.getRawSlices(slices.begin(), num_slices);
+  const Api::IoCallUint64Result rc = io_handle_->writev(slices.begin(), num_slices);
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
   } else {
@@ -132,6 +132,11 @@ private:
       // forwarding.
       return Network::MAX_UDP_PACKET_SIZE;
     }
+    // The responses of the upstream host are read in batches, as the downstream datagrams are.
+    uint32_t maxPacketsPerRecv() const override { return MaxUpstreamPacketsPerRecv; }
+    void onPacketsRead(uint64_t) override {}
+
+    static constexpr uint32_t MaxUpstreamPacketsPerRecv = 16;
 
     ClusterInfo& cluster_;
     const Network::UdpRecvData::LocalPeerAddresses addresses_;
@@ -143,8 +148,8 @@ private:
     // stamp and scan approach.
     const Event::TimerPtr idle_timer_;
     // The IO handle is used for writing packets to the selected upstream host as well as receiving
-    // packets from the upstream host. Note that a a local ephemeral port is bound on the first
-    // write to the upstream host.
+    // packets from the upstream host. It is connected to the upstream host, so that a local
+    // ephemeral port is bound when the session is created.
     const Network::IoHandlePtr io_handle_;
     const Event::FileEventPtr socket_event_;
   };
@@ -221,7 +226,13 @@ private:
 
   virtual Network::IoHandlePtr createIoHandle(const Upstream::HostConstSharedPtr& host) {
     // Virtual so this can be overridden in unit tests.
-    return host->address()->socket(Network::Address::SocketType::Datagram);
+    Network::IoHandlePtr io_handle =
+        host->address()->socket(Network::Address::SocketType::Datagram);
+    // The socket is connected to the upstream host, so that the kernel only delivers the datagrams
+    // of the host to it and resolves the route to the host once rather than for every datagram
+    // sent. If the host is unreachable the connect fails, and so do the writes of the session.
+    host->address()->connect(io_handle->fd());
+    return io_handle;
   }
 
   // Upstream::ClusterUpdateCallbacks
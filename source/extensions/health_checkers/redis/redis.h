@@ -88,6 +88,10 @@ private:
 
     uint32_t maxUpstreamUnknownConnections() const override { return 0; }
     bool enableCommandStats() const override { return false; }
+    bool enableAdaptiveBatching() const override { return false; }
+    NetworkFilters::Common::Redis::Client::ReplicaSelection replicaSelection() const override {
+      return NetworkFilters::Common::Redis::Client::ReplicaSelection::Random;
+    }
 
     // Extensions::NetworkFilters::Common::Redis::Client::ClientCallbacks
     void onResponse(NetworkFilters::Common::Redis::RespValuePtr&& value) override;
@@ -0,0 +1,37 @@
+#include "extensions/private_key_providers/thread_pool/config.h"
+
+#include "envoy/config/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/config/private_key_providers/thread_pool/v3alpha/thread_pool.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+ThreadPoolPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3alpha::PrivateKeyProvider& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const auto provider_config = MessageUtil::anyConvert<
+      envoy::config::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig>(
+      config.typed_config());
+  MessageUtil::validate(provider_config, factory_context.messageValidationVisitor());
+  return std::make_shared<ThreadPoolPrivateKeyMethodProvider>(provider_config,
+                                                              factory_context.api());
+}
+
+/**
+ * Static registration for the thread pool private key provider. @see RegisterFactory.
+ */
+REGISTER_FACTORY(ThreadPoolPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
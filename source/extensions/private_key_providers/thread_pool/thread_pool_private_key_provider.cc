@@ -0,0 +1,293 @@
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
+
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+void ThreadPoolPrivateKeyOperation::setResult(bool success, std::vector<uint8_t>&& output) {
+  Thread::LockGuard lock(lock_);
+  if (cancelled_) {
+    return;
+  }
+  done_ = true;
+  success_ = success;
+  output_ = std::move(output);
+  // Posting while holding the lock guarantees that the dispatcher is still around: the connection
+  // cancels its operation on the worker thread before it, or the dispatcher, goes away.
+  dispatcher_.post([operation = shared_from_this()]() { operation->onComplete(); });
+}
+
+void ThreadPoolPrivateKeyOperation::onComplete() {
+  {
+    Thread::LockGuard lock(lock_);
+    if (cancelled_) {
+      return;
+    }
+  }
+  cb_.onPrivateKeyMethodComplete();
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyOperation::takeResult(uint8_t* out, size_t* out_len,
+                                                                   size_t max_out) {
+  Thread::LockGuard lock(lock_);
+  if (!done_) {
+    // The handshake may be retried before the crypto thread is done, e.g. on a socket event.
+    return ssl_private_key_retry;
+  }
+  if (!success_ || output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(output_.begin(), output_.end(), out);
+  *out_len = output_.size();
+  return ssl_private_key_success;
+}
+
+void ThreadPoolPrivateKeyOperation::cancel() {
+  Thread::LockGuard lock(lock_);
+  cancelled_ = true;
+}
+
+ThreadPoolPrivateKeyConnection::~ThreadPoolPrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    operation_->cancel();
+  }
+}
+
+void ThreadPoolPrivateKeyConnection::post(std::function<bool(std::vector<uint8_t>&)> operation) {
+  operation_ = std::make_shared<ThreadPoolPrivateKeyOperation>(cb_, dispatcher_);
+  provider_.post([pending = operation_, operation]() {
+    std::vector<uint8_t> output;
+    const bool success = operation(output);
+    pending->setResult(success, std::move(output));
+  });
+}
+
+namespace {
+
+ThreadPoolPrivateKeyConnection* getConnection(SSL* ssl) {
+  return static_cast<ThreadPoolPrivateKeyConnection*>(
+      SSL_get_ex_data(ssl, ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+// Runs on a crypto thread.
+bool signWithKey(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::vector<uint8_t>& in,
+                 std::vector<uint8_t>& out) {
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm);
+  if (md == nullptr) {
+    return false;
+  }
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pctx, md, nullptr, pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1 /* salt length is the digest length */))) {
+    return false;
+  }
+
+  size_t out_len;
+  if (!EVP_DigestSign(ctx.get(), nullptr, &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), out.data(), &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+// Runs on a crypto thread.
+bool decryptWithKey(EVP_PKEY* pkey, const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+  if (rsa == nullptr) {
+    return false;
+  }
+  size_t out_len;
+  out.resize(RSA_size(rsa));
+  if (!RSA_decrypt(rsa, &out_len, out.data(), out.size(), in.data(), in.size(), RSA_NO_PADDING)) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  EVP_PKEY* pkey = connection->provider().privateKey();
+  if (EVP_PKEY_id(pkey) != SSL_get_signature_algorithm_key_type(signature_algorithm)) {
+    return ssl_private_key_failure;
+  }
+
+  // The input is only valid for the duration of this call.
+  std::vector<uint8_t> input(in, in + in_len);
+  connection->post([pkey, signature_algorithm, input](std::vector<uint8_t>& output) {
+    return signWithKey(pkey, signature_algorithm, input, output);
+  });
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in,
+                                           size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  EVP_PKEY* pkey = connection->provider().privateKey();
+  if (EVP_PKEY_id(pkey) != EVP_PKEY_RSA) {
+    return ssl_private_key_failure;
+  }
+
+  std::vector<uint8_t> input(in, in + in_len);
+  connection->post([pkey, input](std::vector<uint8_t>& output) {
+    return decryptWithKey(pkey, input, output);
+  });
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr || connection->operation() == nullptr) {
+    return ssl_private_key_failure;
+  }
+  const ssl_private_key_result_t result =
+      connection->operation()->takeResult(out, out_len, max_out);
+  if (result != ssl_private_key_retry) {
+    connection->operation().reset();
+  }
+  return result;
+}
+
+int createIndex() {
+  int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+  return index;
+}
+
+} // namespace
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::config::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig& config,
+    Api::Api& api) {
+  const std::string private_key = Config::DataSource::read(config.private_key(), false, api);
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  pkey_.reset(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey_ == nullptr) {
+    throw EnvoyException("Failed to load the private key of the thread pool private key provider.");
+  }
+  if (EVP_PKEY_id(pkey_.get()) != EVP_PKEY_RSA && EVP_PKEY_id(pkey_.get()) != EVP_PKEY_EC) {
+    throw EnvoyException("The thread pool private key provider only supports RSA and ECDSA keys.");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  const uint32_t thread_count = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, thread_count, std::max(1U, std::thread::hardware_concurrency()));
+  for (uint32_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(api.threadFactory().createThread([this]() { threadRoutine(); }));
+  }
+}
+
+ThreadPoolPrivateKeyMethodProvider::~ThreadPoolPrivateKeyMethodProvider() {
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    job_available_.notifyAll();
+  }
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void ThreadPoolPrivateKeyMethodProvider::post(std::function<void()> job) {
+  Thread::LockGuard lock(lock_);
+  jobs_.emplace_back(std::move(job));
+  job_available_.notifyOne();
+}
+
+void ThreadPoolPrivateKeyMethodProvider::threadRoutine() {
+  while (true) {
+    std::function<void()> job;
+    {
+      Thread::LockGuard lock(lock_);
+      while (jobs_.empty() && !exit_) {
+        job_available_.wait(lock_);
+      }
+      if (exit_) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+  }
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  if (getConnection(ssl) != nullptr) {
+    throw EnvoyException(
+        "Only one certificate of a TLS context can use the thread pool private key provider.");
+  }
+  SSL_set_ex_data(ssl, connectionIndex(),
+                  new ThreadPoolPrivateKeyConnection(*this, cb, dispatcher));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+  delete connection;
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() {
+  if (EVP_PKEY_id(pkey_.get()) == EVP_PKEY_RSA) {
+    RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa != nullptr && RSA_check_fips(rsa);
+  }
+  const EC_KEY* ec_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+  return ec_key != nullptr && EC_KEY_check_fips(ec_key);
+}
+
+Ssl::BoringSslPrivateKeyMethodSharedPtr
+ThreadPoolPrivateKeyMethodProvider::getBoringSslPrivateKeyMethod() {
+  return method_;
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, createIndex());
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/config/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+/**
+ * The state of a single private key operation. The operation is created on the worker thread,
+ * computed on a crypto thread and its result is handed back to the worker thread.
+ */
+class ThreadPoolPrivateKeyOperation
+    : public std::enable_shared_from_this<ThreadPoolPrivateKeyOperation> {
+public:
+  ThreadPoolPrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher)
+      : cb_(cb), dispatcher_(dispatcher) {}
+
+  /**
+   * Store the result of the operation and wake up the handshake on the worker thread, unless the
+   * operation has been cancelled. Called on a crypto thread.
+   */
+  void setResult(bool success, std::vector<uint8_t>&& output);
+
+  /**
+   * Move the result of the operation into the supplied output.
+   * @return ssl_private_key_retry if the result is not available yet, ssl_private_key_success or
+   *         ssl_private_key_failure otherwise.
+   */
+  ssl_private_key_result_t takeResult(uint8_t* out, size_t* out_len, size_t max_out);
+
+  /**
+   * Drop the result of the operation. Once this returns the connection callbacks are not invoked
+   * anymore, so the connection may go away. Called on the worker thread.
+   */
+  void cancel();
+
+private:
+  void onComplete();
+
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  Thread::MutexBasicLockable lock_;
+  bool cancelled_ ABSL_GUARDED_BY(lock_){};
+  bool done_ ABSL_GUARDED_BY(lock_){};
+  bool success_ ABSL_GUARDED_BY(lock_){};
+  std::vector<uint8_t> output_ ABSL_GUARDED_BY(lock_);
+};
+
+using ThreadPoolPrivateKeyOperationSharedPtr = std::shared_ptr<ThreadPoolPrivateKeyOperation>;
+
+class ThreadPoolPrivateKeyMethodProvider;
+
+/**
+ * Per SSL connection state, stored in the SSL object's user data.
+ */
+class ThreadPoolPrivateKeyConnection {
+public:
+  ThreadPoolPrivateKeyConnection(ThreadPoolPrivateKeyMethodProvider& provider,
+                                 Ssl::PrivateKeyConnectionCallbacks& cb,
+                                 Event::Dispatcher& dispatcher)
+      : provider_(provider), cb_(cb), dispatcher_(dispatcher) {}
+  ~ThreadPoolPrivateKeyConnection();
+
+  /**
+   * Start a new operation running the supplied function on the thread pool.
+   */
+  void post(std::function<bool(std::vector<uint8_t>&)> operation);
+
+  ThreadPoolPrivateKeyMethodProvider& provider() { return provider_; }
+  ThreadPoolPrivateKeyOperationSharedPtr& operation() { return operation_; }
+
+private:
+  ThreadPoolPrivateKeyMethodProvider& provider_;
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  ThreadPoolPrivateKeyOperationSharedPtr operation_;
+};
+
+/**
+ * A private key method provider which performs the private key operations of the handshakes on a
+ * pool of crypto threads, so that they do not block the worker threads.
+ */
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::config::private_key_providers::thread_pool::v3alpha::
+          ThreadPoolPrivateKeyMethodConfig& config,
+      Api::Api& api);
+  ~ThreadPoolPrivateKeyMethodProvider() override;
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override;
+
+  EVP_PKEY* privateKey() { return pkey_.get(); }
+
+  /**
+   * Queue a job for the crypto threads. Jobs still queued when the provider is destroyed are
+   * dropped.
+   */
+  void post(std::function<void()> job);
+
+  static int connectionIndex();
+
+private:
+  void threadRoutine();
+
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar job_available_;
+  std::list<std::function<void()>> jobs_ ABSL_GUARDED_BY(lock_);
+  bool exit_ ABSL_GUARDED_BY(lock_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -1,6 +1,16 @@
 #include "extensions/quic_listeners/quiche/active_quic_listener.h"
 
+#include <limits>
+
+#include "common/common/macros.h"
+#include "common/network/reuse_port_socket_option_impl.h"
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#endif
+
 #include "extensions/quic_listeners/quiche/envoy_quic_alarm_factory.h"
+#include "extensions/quic_listeners/quiche/envoy_quic_batch_packet_writer.h"
 #include "extensions/quic_listeners/quiche/envoy_quic_connection_helper.h"
 #include "extensions/quic_listeners/quiche/envoy_quic_dispatcher.h"
 #include "extensions/quic_listeners/quiche/envoy_quic_fake_proof_source.h"
@@ -24,8 +34,11 @@ ActiveQuicListener::ActiveQuicListener(Event::Dispatcher& dispatcher,
                                        Network::ListenerConfig& listener_config,
                                        const quic::QuicConfig& quic_config)
     : Server::ConnectionHandlerImpl::ActiveListenerImplBase(parent, listener_config),
+      udp_stats_({ALL_UDP_LISTENER_STATS(
+          POOL_COUNTER_PREFIX(listener_config.listenerScope(), "udp."))}),
       dispatcher_(dispatcher), version_manager_(quic::CurrentSupportedVersions()),
-      listen_socket_(*listen_socket) {
+      listen_socket_(*listen_socket),
+      udp_forwarding_(Server::HotRestartUdpForwardingSingleton::getExisting()) {
   udp_listener_ = dispatcher_.createUdpListener(std::move(listen_socket), *this);
   quic::QuicRandom* const random = quic::QuicRandom::GetInstance();
   random->RandBytes(random_seed_, sizeof(random_seed_));
@@ -40,19 +53,46 @@ ActiveQuicListener::ActiveQuicListener(Event::Dispatcher& dispatcher,
       std::make_unique<EnvoyQuicAlarmFactory>(dispatcher_, *connection_helper->GetClock());
   quic_dispatcher_ = std::make_unique<EnvoyQuicDispatcher>(
       crypto_config_.get(), quic_config, &version_manager_, std::move(connection_helper),
-      std::move(alarm_factory), quic::kQuicDefaultConnectionIdLength, parent, config_, stats_,
+      std::move(alarm_factory), quic::kQuicDefaultConnectionIdLength, parent, *config_, stats_,
       dispatcher, listen_socket_);
-  quic_dispatcher_->InitializeWithWriter(new EnvoyQuicPacketWriter(listen_socket_));
+  if (EnvoyQuicBatchPacketWriter::isSupported(listen_socket_)) {
+    writer_ = new EnvoyQuicBatchPacketWriter(listen_socket_, listener_config.listenerScope());
+  } else {
+    writer_ = new EnvoyQuicPacketWriter(listen_socket_);
+  }
+  quic_dispatcher_->InitializeWithWriter(writer_);
+  if (udp_forwarding_ != nullptr) {
+    // As a hot restart child, packets of the connections of the parent reach this listener until
+    // the parent terminates. As a parent, the child forwards them back.
+    udp_forwarding_id_ =
+        udp_forwarding_->addListener(*listen_socket_.localAddress(), dispatcher_, *this);
+    quic_dispatcher_->setUnknownConnectionCb([this]() -> bool { return forwardToParent(); });
+  }
 }
 
-ActiveQuicListener::~ActiveQuicListener() { onListenerShutdown(); }
+ActiveQuicListener::~ActiveQuicListener() {
+  if (udp_forwarding_ != nullptr) {
+    udp_forwarding_->removeListener(udp_forwarding_id_);
+  }
+  onListenerShutdown();
+}
 
 void ActiveQuicListener::onListenerShutdown() {
-  ENVOY_LOG(info, "Quic listener {} shutdown.", config_.name());
+  ENVOY_LOG(info, "Quic listener {} shutdown.", config_->name());
   quic_dispatcher_->Shutdown();
 }
 
 void ActiveQuicListener::onData(Network::UdpRecvData& data) {
+  current_data_ = &data;
+  processPacket(data, /*forwarded=*/false);
+  current_data_ = nullptr;
+}
+
+void ActiveQuicListener::onForwardedPacket(Network::UdpRecvData& data) {
+  processPacket(data, /*forwarded=*/true);
+}
+
+void ActiveQuicListener::processPacket(Network::UdpRecvData& data, bool forwarded) {
   quic::QuicSocketAddress peer_address(
       envoyAddressInstanceToQuicSocketAddress(data.addresses_.peer_));
   quic::QuicSocketAddress self_address(
@@ -71,15 +111,76 @@ void ActiveQuicListener::onData(Network::UdpRecvData& data) {
                                   /*owns_buffer=*/false, /*ttl=*/0, /*ttl_valid=*/false,
                                   /*packet_headers=*/nullptr, /*headers_length=*/0,
                                   /*owns_header_buffer*/ false);
-  quic_dispatcher_->ProcessPacket(self_address, peer_address, packet);
+  if (forwarded) {
+    quic_dispatcher_->processForwardedPacket(self_address, peer_address, packet);
+  } else {
+    quic_dispatcher_->ProcessPacket(self_address, peer_address, packet);
+  }
+}
+
+bool ActiveQuicListener::forwardToParent() {
+  if (current_data_ == nullptr || !udp_forwarding_->forwardingToParent()) {
+    return false;
+  }
+  udp_forwarding_->forwardToParent(*listen_socket_.localAddress(), *current_data_);
+  return true;
 }
 
 void ActiveQuicListener::onReadReady() {
   quic_dispatcher_->ProcessBufferedChlos(kNumSessionsToCreatePerLoop);
+  writer_->Flush();
+}
+
+void ActiveQuicListener::onPacketsRead(uint64_t num_packets) {
+  udp_stats_.downstream_rx_recv_calls_.inc();
+  udp_stats_.downstream_rx_datagrams_.add(num_packets);
+  // The packets written in response to those read, which weren't flushed by their connection, e.g.
+  // those of the time wait list, are sent together.
+  writer_->Flush();
 }
 
 void ActiveQuicListener::onWriteReady(const Network::Socket& /*socket*/) {
   quic_dispatcher_->OnCanWrite();
+  // Sends the packets buffered by a batch writer when the socket got blocked.
+  writer_->Flush();
+}
+
+Network::Socket::OptionsSharedPtr
+ActiveQuicListenerFactory::reusePortSteeringOptions(uint32_t concurrency) const {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+  if (concurrency <= 1) {
+    return nullptr;
+  }
+  // Steer a packet by the first bytes of its destination connection ID, which the connection IDs
+  // of the server keep (see EnvoyQuicDispatcher), so that all the packets of a connection reach
+  // the same worker even if the client address changes. The connection ID starts at byte 1 of a
+  // short header or a Google QUIC header, and at byte 6 of an IETF long header, whose first bit is
+  // set. Packets too short to hold it are left to the kernel's hash of the addresses.
+  static_assert(EnvoyQuicDispatcher::kSteeringConnectionIdPrefixLength == 4,
+                "the program loads a 4 bytes connection ID prefix");
+  const struct sock_filter program[] = {
+      {BPF_LD | BPF_W | BPF_LEN, 0, 0, 0},                            // A = length
+      {BPF_JMP | BPF_JGE | BPF_K, 0, 8, 5},                           // A < 5: goto hash
+      {BPF_LD | BPF_B | BPF_ABS, 0, 0, 0},                            // A = byte 0
+      {BPF_JMP | BPF_JSET | BPF_K, 2, 0, 0x80},                       // long header: goto long
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, 1},                            // A = bytes 1-4
+      {BPF_JMP | BPF_JA, 0, 0, 5},                                    // goto steer
+      {BPF_LD | BPF_W | BPF_LEN, 0, 0, 0},                            // long: A = length
+      {BPF_JMP | BPF_JGE | BPF_K, 0, 2, 10},                          // A < 10: goto hash
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, 6},                            // A = bytes 6-9
+      {BPF_JMP | BPF_JA, 0, 0, 1},                                    // goto steer
+      {BPF_RET | BPF_K, 0, 0, std::numeric_limits<uint32_t>::max()}, // hash: return past the end
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, concurrency},                 // steer: A = A % concurrency
+      {BPF_RET | BPF_A, 0, 0, 0},                                     // return A
+  };
+  auto options = std::make_shared<Network::Socket::Options>();
+  options->push_back(std::make_shared<Network::ReusePortSteeringSocketOptionImpl>(
+      std::string(reinterpret_cast<const char*>(program), sizeof(program))));
+  return options;
+#else
+  UNREFERENCED_PARAMETER(concurrency);
+  return nullptr;
+#endif
 }
 
 } // namespace Quic
@@ -3,6 +3,7 @@
 #include "envoy/config/listener/v3alpha/quic_config.pb.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/listener.h"
+#include "envoy/server/hot_restart.h"
 
 #include "common/protobuf/utility.h"
 
@@ -17,6 +18,7 @@ namespace Quic {
 // packets, write signals and listener errors to QuicDispatcher.
 class ActiveQuicListener : public Network::UdpListenerCallbacks,
                            public Server::ConnectionHandlerImpl::ActiveListenerImplBase,
+                           public Server::HotRestartUdpForwarding::Listener,
                            Logger::Loggable<Logger::Id::quic> {
 public:
   // TODO(bencebeky): Tune this value.
@@ -37,6 +39,7 @@ public:
   // Network::UdpListenerCallbacks
   void onData(Network::UdpRecvData& data) override;
   void onReadReady() override;
+  void onPacketsRead(uint64_t num_packets) override;
   void onWriteReady(const Network::Socket& socket) override;
   void onReceiveError(Api::IoError::IoErrorCode /*error_code*/) override {
     // No-op. Quic can't do anything upon listener error.
@@ -46,16 +49,31 @@ public:
   Network::Listener* listener() override { return udp_listener_.get(); }
   void destroy() override { udp_listener_.reset(); }
 
+  // Server::HotRestartUdpForwarding::Listener
+  void onForwardedPacket(Network::UdpRecvData& data) override;
+
 private:
   friend class ActiveQuicListenerPeer;
 
+  void processPacket(Network::UdpRecvData& data, bool forwarded);
+  // Hands the packet being processed to the hot restart parent, if any.
+  bool forwardToParent();
+
+  Server::UdpListenerStats udp_stats_;
   Network::UdpListenerPtr udp_listener_;
   uint8_t random_seed_[16];
   std::unique_ptr<quic::QuicCryptoServerConfig> crypto_config_;
   Event::Dispatcher& dispatcher_;
   quic::QuicVersionManager version_manager_;
   std::unique_ptr<EnvoyQuicDispatcher> quic_dispatcher_;
+  // Owned by quic_dispatcher_.
+  quic::QuicPacketWriter* writer_{};
   Network::Socket& listen_socket_;
+  // Non-null while the hot restart of the process may forward packets.
+  Server::HotRestartUdpForwarding* udp_forwarding_;
+  uint64_t udp_forwarding_id_{};
+  // The packet received from the socket being processed, if any.
+  const Network::UdpRecvData* current_data_{};
 };
 
 using ActiveQuicListenerPtr = std::unique_ptr<ActiveQuicListener>;
@@ -88,6 +106,7 @@ public:
     return std::make_unique<ActiveQuicListener>(disptacher, parent, config, quic_config_);
   }
   bool isTransportConnectionless() const override { return false; }
+  Network::Socket::OptionsSharedPtr reusePortSteeringOptions(uint32_t concurrency) const override;
 
 private:
   friend class ActiveQuicListenerFactoryPeer;
@@ -0,0 +1,265 @@
+#include "extensions/quic_listeners/quiche/envoy_quic_batch_packet_writer.h"
+
+#include <netinet/udp.h>
+
+#include <array>
+#include <cstring>
+
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Quic {
+
+namespace {
+
+// Room for the source address of a message and the segment size of its packets.
+constexpr size_t ControlSpace = CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(uint16_t));
+
+struct alignas(cmsghdr) ControlBuffer {
+  char data_[ControlSpace];
+};
+
+bool gsoSupported(int fd) {
+#ifdef UDP_SEGMENT
+  int segment_size;
+  socklen_t length = sizeof(segment_size);
+  return Api::OsSysCallsSingleton::get()
+             .getsockopt(fd, SOL_UDP, UDP_SEGMENT, &segment_size, &length)
+             .rc_ == 0;
+#else
+  UNREFERENCED_PARAMETER(fd);
+  return false;
+#endif
+}
+
+// Sets the control messages of a message sent from the given address and, if segment_size isn't
+// 0, made of segments of that size.
+void setControlMessages(msghdr& message, const quic::QuicIpAddress& self_address,
+                        uint16_t segment_size) {
+  memset(message.msg_control, 0, message.msg_controllen);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  size_t length = 0;
+  if (self_address.IsIPv4()) {
+    cmsg->cmsg_level = IPPROTO_IP;
+#ifndef IP_SENDSRCADDR
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg->cmsg_type = IP_PKTINFO;
+    auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi_spec_dst = self_address.GetIPv4();
+    length += CMSG_SPACE(sizeof(in_pktinfo));
+#else
+    cmsg->cmsg_type = IP_SENDSRCADDR;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
+    *reinterpret_cast<in_addr*>(CMSG_DATA(cmsg)) = self_address.GetIPv4();
+    length += CMSG_SPACE(sizeof(in_addr));
+#endif
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  } else if (self_address.IsIPv6()) {
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi6_addr = self_address.GetIPv6();
+    length += CMSG_SPACE(sizeof(in6_pktinfo));
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  }
+#ifdef UDP_SEGMENT
+  if (segment_size != 0) {
+    ASSERT(cmsg != nullptr);
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    length += CMSG_SPACE(sizeof(uint16_t));
+  }
+#else
+  ASSERT(segment_size == 0);
+#endif
+  message.msg_controllen = length;
+  if (length == 0) {
+    message.msg_control = nullptr;
+  }
+}
+
+} // namespace
+
+EnvoyQuicBatchPacketWriter::EnvoyQuicBatchPacketWriter(Network::Socket& socket,
+                                                       Stats::Scope& scope)
+    : socket_(socket),
+      stats_({ALL_QUIC_BATCH_WRITER_STATS(POOL_COUNTER_PREFIX(scope, "quic_writer."),
+                                          POOL_HISTOGRAM_PREFIX(scope, "quic_writer."))}),
+      gso_supported_(gsoSupported(socket.ioHandle().fd())),
+      buffer_(new char[kMaxBatchPackets * quic::kMaxOutgoingPacketSize]) {
+  packets_.reserve(kMaxBatchPackets);
+}
+
+bool EnvoyQuicBatchPacketWriter::isSupported(const Network::Socket& socket) {
+  return Api::OsSysCallsSingleton::get().supportsMmsg() || gsoSupported(socket.ioHandle().fd());
+}
+
+quic::WriteResult EnvoyQuicBatchPacketWriter::WritePacket(
+    const char* buffer, size_t buf_len, const quic::QuicIpAddress& self_address,
+    const quic::QuicSocketAddress& peer_address, quic::PerPacketOptions* options) {
+  ASSERT(options == nullptr, "Per packet option is not supported yet.");
+  ASSERT(!write_blocked_, "Cannot write while IO handle is blocked.");
+  ASSERT(buf_len <= quic::kMaxOutgoingPacketSize);
+
+  if (packets_.size() == kMaxBatchPackets) {
+    const quic::WriteResult result = sendBuffered();
+    if (result.status == quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED) {
+      // The packet isn't buffered, the caller writes it again once the socket is writable.
+      return {quic::WRITE_STATUS_BLOCKED, result.error_code};
+    }
+    if (result.status != quic::WRITE_STATUS_OK) {
+      return result;
+    }
+  }
+  memcpy(buffer_.get() + buffer_used_, buffer, buf_len);
+  packets_.push_back({buffer_used_, buf_len, self_address, peer_address});
+  buffer_used_ += buf_len;
+  return {quic::WRITE_STATUS_OK, 0};
+}
+
+quic::WriteResult EnvoyQuicBatchPacketWriter::Flush() {
+  if (write_blocked_) {
+    // The buffered packets are sent once the socket is writable again.
+    return {quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED,
+            static_cast<int>(Api::IoError::IoErrorCode::Again)};
+  }
+  return sendBuffered();
+}
+
+bool EnvoyQuicBatchPacketWriter::canSegment(size_t first, size_t index,
+                                            size_t message_size) const {
+  const BufferedPacket& segment = packets_[first];
+  const BufferedPacket& packet = packets_[index];
+  // All the segments of a message but the last have the same size.
+  return gso_supported_ && packets_[index - 1].length_ == segment.length_ &&
+         packet.length_ <= segment.length_ &&
+         message_size + packet.length_ <= kMaxSegmentedMessageSize &&
+         packet.self_address_ == segment.self_address_ &&
+         packet.peer_address_ == segment.peer_address_;
+}
+
+quic::WriteResult EnvoyQuicBatchPacketWriter::sendBuffered() {
+  if (packets_.empty()) {
+    return {quic::WRITE_STATUS_OK, 0};
+  }
+
+  std::array<struct mmsghdr, kMaxBatchPackets> headers;
+  std::array<struct iovec, kMaxBatchPackets> iovecs;
+  std::array<sockaddr_storage, kMaxBatchPackets> peer_addresses;
+  std::array<ControlBuffer, kMaxBatchPackets> controls;
+  // The index of the first packet of each message, followed by the number of packets.
+  std::array<size_t, kMaxBatchPackets + 1> first_packets;
+  size_t num_messages = 0;
+  for (size_t first = 0; first < packets_.size(); num_messages++) {
+    const BufferedPacket& packet = packets_[first];
+    size_t message_size = packet.length_;
+    size_t end = first + 1;
+    while (end < packets_.size() && canSegment(first, end, message_size)) {
+      message_size += packets_[end].length_;
+      end++;
+    }
+
+    memset(&headers[num_messages], 0, sizeof(struct mmsghdr));
+    struct msghdr& message = headers[num_messages].msg_hdr;
+    iovecs[num_messages].iov_base = buffer_.get() + packet.offset_;
+    iovecs[num_messages].iov_len = message_size;
+    message.msg_iov = &iovecs[num_messages];
+    message.msg_iovlen = 1;
+    peer_addresses[num_messages] = packet.peer_address_.generic_address();
+    message.msg_name = &peer_addresses[num_messages];
+    message.msg_namelen =
+        packet.peer_address_.host().IsIPv4() ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+    message.msg_control = controls[num_messages].data_;
+    message.msg_controllen = ControlSpace;
+    setControlMessages(message, packet.self_address_,
+                       end - first > 1 ? static_cast<uint16_t>(packet.length_) : 0);
+    first_packets[num_messages] = first;
+    first = end;
+  }
+  first_packets[num_messages] = packets_.size();
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const int fd = socket_.ioHandle().fd();
+  size_t num_sent = 0;
+  uint64_t bytes_sent = 0;
+  int error = 0;
+  while (num_sent < num_messages) {
+    size_t num_messages_sent = 1;
+    if (os_sys_calls.supportsMmsg()) {
+      const Api::SysCallIntResult result =
+          os_sys_calls.sendmmsg(fd, &headers[num_sent], num_messages - num_sent, 0);
+      if (result.rc_ <= 0) {
+        error = result.errno_;
+        break;
+      }
+      num_messages_sent = result.rc_;
+    } else {
+      const Api::SysCallSizeResult result = os_sys_calls.sendmsg(fd, &headers[num_sent].msg_hdr, 0);
+      if (result.rc_ < 0) {
+        error = result.errno_;
+        break;
+      }
+    }
+    const size_t num_packets =
+        first_packets[num_sent + num_messages_sent] - first_packets[num_sent];
+    stats_.send_calls_.inc();
+    stats_.packets_sent_.add(num_packets);
+    stats_.packets_per_send_.recordValue(num_packets);
+    for (size_t i = num_sent; i < num_sent + num_messages_sent; i++) {
+      bytes_sent += iovecs[i].iov_len;
+    }
+    num_sent += num_messages_sent;
+  }
+
+  if (num_sent == num_messages) {
+    packets_.clear();
+    buffer_used_ = 0;
+    return {quic::WRITE_STATUS_OK, static_cast<int>(bytes_sent)};
+  }
+  if (error == EIO && first_packets[num_sent + 1] - first_packets[num_sent] > 1) {
+    // The device can't segment the message, for instance as it lacks checksum offload. Stop
+    // segmenting and send the packets left again, one per message.
+    gso_supported_ = false;
+    stats_.gso_disabled_.inc();
+    dropSent(first_packets[num_sent]);
+    const quic::WriteResult result = sendBuffered();
+    if (result.status != quic::WRITE_STATUS_OK) {
+      return result;
+    }
+    return {quic::WRITE_STATUS_OK, static_cast<int>(bytes_sent) + result.bytes_written};
+  }
+  if (error == EAGAIN) {
+    dropSent(first_packets[num_sent]);
+    write_blocked_ = true;
+    return {quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED,
+            static_cast<int>(Api::IoError::IoErrorCode::Again)};
+  }
+  // The packets not sent are dropped, as if lost on the way.
+  packets_.clear();
+  buffer_used_ = 0;
+  return {quic::WRITE_STATUS_ERROR,
+          static_cast<int>(Network::IoSocketError(error).getErrorCode())};
+}
+
+void EnvoyQuicBatchPacketWriter::dropSent(size_t num_packets) {
+  if (num_packets == 0) {
+    return;
+  }
+  const size_t offset = packets_[num_packets].offset_;
+  memmove(buffer_.get(), buffer_.get() + offset, buffer_used_ - offset);
+  buffer_used_ -= offset;
+  packets_.erase(packets_.begin(), packets_.begin() + num_packets);
+  for (BufferedPacket& packet : packets_) {
+    packet.offset_ -= offset;
+  }
+}
+
+} // namespace Quic
+} // namespace Envoy
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#pragma GCC diagnostic push
+// QUICHE allows unused parameters.
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+// QUICHE uses offsetof().
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+
+#include "quiche/quic/core/quic_packet_writer.h"
+
+#pragma GCC diagnostic pop
+
+#include "envoy/network/listener.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Quic {
+
+/**
+ * All stats for the QUIC batch packet writer. @see stats_macros.h
+ */
+#define ALL_QUIC_BATCH_WRITER_STATS(COUNTER, HISTOGRAM)                                            \
+  COUNTER(send_calls)                                                                              \
+  COUNTER(packets_sent)                                                                            \
+  COUNTER(gso_disabled)                                                                            \
+  HISTOGRAM(packets_per_send, Unspecified)
+
+/**
+ * Struct definition for all QUIC batch packet writer stats. @see stats_macros.h
+ */
+struct QuicBatchWriterStats {
+  ALL_QUIC_BATCH_WRITER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * A packet writer in the batch mode of QUICHE: the packets written are buffered and only sent on
+ * Flush(), or once the buffer is full. Consecutive packets of the same size to the same peer are
+ * sent as the segments of a single message with UDP_SEGMENT (generic segmentation offload), and
+ * the messages of a flush are sent by a single sendmmsg() call. If the socket fails a segmented
+ * message with EIO, which it does when the device can't segment it, segmentation is disabled and
+ * the packets are sent again one per message.
+ */
+class EnvoyQuicBatchPacketWriter : public quic::QuicPacketWriter {
+public:
+  // The most packets buffered before they are sent, which is also the most segments the kernel
+  // accepts in a single UDP_SEGMENT message.
+  static constexpr size_t kMaxBatchPackets = 64;
+  // The most bytes a single UDP_SEGMENT message carries: those of a UDP datagram over IPv4.
+  static constexpr size_t kMaxSegmentedMessageSize = 65507;
+
+  EnvoyQuicBatchPacketWriter(Network::Socket& socket, Stats::Scope& scope);
+
+  /**
+   * @param socket supplies the socket to write to.
+   * @return bool whether batching the packets written to the socket saves system calls, which is
+   *         the case if either sendmmsg() or UDP_SEGMENT is supported.
+   */
+  static bool isSupported(const Network::Socket& socket);
+
+  // quic::QuicPacketWriter
+  quic::WriteResult WritePacket(const char* buffer, size_t buf_len,
+                                const quic::QuicIpAddress& self_address,
+                                const quic::QuicSocketAddress& peer_address,
+                                quic::PerPacketOptions* options) override;
+  bool IsWriteBlocked() const override { return write_blocked_; }
+  void SetWritable() override { write_blocked_ = false; }
+  quic::QuicByteCount
+  GetMaxPacketSize(const quic::QuicSocketAddress& /*peer_address*/) const override {
+    return quic::kMaxOutgoingPacketSize;
+  }
+  bool SupportsReleaseTime() const override { return false; }
+  bool IsBatchMode() const override { return true; }
+  // The packets are copied into the buffer rather than serialized in place, so that the buffer
+  // can be compacted after a partial send without any packet of the caller in it.
+  char* GetNextWriteLocation(const quic::QuicIpAddress& /*self_address*/,
+                             const quic::QuicSocketAddress& /*peer_address*/) override {
+    return nullptr;
+  }
+  quic::WriteResult Flush() override;
+
+private:
+  struct BufferedPacket {
+    size_t offset_;
+    size_t length_;
+    quic::QuicIpAddress self_address_;
+    quic::QuicSocketAddress peer_address_;
+  };
+
+  // Whether the buffered packet at the given index can be sent as the next segment of the message
+  // starting at the buffered packet at index first.
+  bool canSegment(size_t first, size_t index, size_t message_size) const;
+  // Sends the buffered packets, keeping those not sent if the socket is blocked.
+  quic::WriteResult sendBuffered();
+  // Forgets the buffered packets before the given index, which were sent.
+  void dropSent(size_t num_packets);
+
+  Network::Socket& socket_;
+  QuicBatchWriterStats stats_;
+  // Cleared once a segmented message fails with EIO.
+  bool gso_supported_;
+  bool write_blocked_{false};
+  std::vector<BufferedPacket> packets_;
+  // The packets are stored back to back, from the start of the buffer.
+  std::unique_ptr<char[]> buffer_;
+  size_t buffer_used_{0};
+};
+
+} // namespace Quic
+} // namespace Envoy
@@ -36,6 +36,8 @@ public:
                      Network::Address::InstanceConstSharedPtr peer_address,
                      Buffer::InstancePtr buffer, MonotonicTime receive_time) override;
   uint64_t maxPacketSize() const override;
+  uint32_t maxPacketsPerRecv() const override { return 1; }
+  void onPacketsRead(uint64_t) override {}
 
   // Register file event and apply socket options.
   void setUpConnectionSocket();
@@ -1,5 +1,8 @@
 #include "extensions/quic_listeners/quiche/envoy_quic_dispatcher.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "extensions/quic_listeners/quiche/envoy_quic_server_connection.h"
 #include "extensions/quic_listeners/quiche/envoy_quic_server_session.h"
 
@@ -40,6 +43,41 @@ void EnvoyQuicDispatcher::OnConnectionClosed(quic::QuicConnectionId connection_i
   connection_handler_.decNumConnections();
 }
 
+void EnvoyQuicDispatcher::processForwardedPacket(const quic::QuicSocketAddress& self_address,
+                                                 const quic::QuicSocketAddress& peer_address,
+                                                 const quic::QuicReceivedPacket& packet) {
+  processing_forwarded_packet_ = true;
+  ProcessPacket(self_address, peer_address, packet);
+  processing_forwarded_packet_ = false;
+}
+
+quic::QuicConnectionId
+EnvoyQuicDispatcher::GenerateNewServerConnectionId(quic::ParsedQuicVersion /*version*/,
+                                                   quic::QuicConnectionId connection_id) const {
+  quic::QuicConnectionId new_connection_id = quic::QuicUtils::CreateRandomConnectionId();
+  const size_t prefix_length = std::min<size_t>(
+      {kSteeringConnectionIdPrefixLength, connection_id.length(), new_connection_id.length()});
+  memcpy(new_connection_id.mutable_data(), connection_id.data(), prefix_length);
+  return new_connection_id;
+}
+
+bool EnvoyQuicDispatcher::MaybeDispatchPacket(const quic::ReceivedPacketInfo& packet_info) {
+  // Packets with a long header may create a connection and are always handled here. A short
+  // header one of a connection in neither the session map nor the time wait list belongs to a
+  // connection that this dispatcher never had.
+  if (!packet_info.version_flag &&
+      session_map().find(packet_info.destination_connection_id) == session_map().end() &&
+      !time_wait_list_manager()->IsConnectionIdInTimeWait(packet_info.destination_connection_id)) {
+    if (processing_forwarded_packet_) {
+      return true;
+    }
+    if (unknown_connection_cb_ != nullptr && unknown_connection_cb_()) {
+      return true;
+    }
+  }
+  return quic::QuicDispatcher::MaybeDispatchPacket(packet_info);
+}
+
 std::unique_ptr<quic::QuicSession> EnvoyQuicDispatcher::CreateQuicSession(
     quic::QuicConnectionId server_connection_id, const quic::QuicSocketAddress& peer_address,
     quiche::QuicheStringPiece /*alpn*/, const quic::ParsedQuicVersion& version) {
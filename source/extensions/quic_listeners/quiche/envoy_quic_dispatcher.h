@@ -12,6 +12,7 @@
 
 #pragma GCC diagnostic pop
 
+#include <functional>
 #include <string>
 
 #include "envoy/network/listener.h"
@@ -40,6 +41,11 @@ public:
 
 class EnvoyQuicDispatcher : public quic::QuicDispatcher {
 public:
+  // Called for a packet of an established connection this dispatcher does not know, e.g. one of a
+  // hot restart parent's. Returns whether the packet was taken care of, in which case the
+  // dispatcher neither resets nor time waits the connection.
+  using UnknownConnectionCb = std::function<bool()>;
+
   EnvoyQuicDispatcher(const quic::QuicCryptoServerConfig* crypto_config,
                       const quic::QuicConfig& quic_config,
                       quic::QuicVersionManager* version_manager,
@@ -55,18 +61,30 @@ public:
                           const std::string& error_details,
                           quic::ConnectionCloseSource source) override;
 
+  // Process a packet forwarded by a hot restart child. Unlike ProcessPacket(), a packet of an
+  // unknown connection is dropped, as it may belong to the connection of another worker.
+  void processForwardedPacket(const quic::QuicSocketAddress& self_address,
+                              const quic::QuicSocketAddress& peer_address,
+                              const quic::QuicReceivedPacket& packet);
+
+  void setUnknownConnectionCb(UnknownConnectionCb cb) { unknown_connection_cb_ = std::move(cb); }
+
+  // The packets of a connection are steered to the worker owning it by the leading bytes of its
+  // server connection ID, see ActiveQuicListenerFactory::reusePortSteeringOptions().
+  static constexpr size_t kSteeringConnectionIdPrefixLength = 4;
+
+  // Keeps the leading bytes of the connection ID chosen by the client, so that the packets of the
+  // connection keep being steered to this worker.
   quic::QuicConnectionId
-  GenerateNewServerConnectionId(quic::ParsedQuicVersion /*version*/,
-                                quic::QuicConnectionId /*connection_id*/) const override {
-    // TODO(danzh): create reject connection id based on given connection_id.
-    return quic::QuicUtils::CreateRandomConnectionId();
-  }
+  GenerateNewServerConnectionId(quic::ParsedQuicVersion version,
+                                quic::QuicConnectionId connection_id) const override;
 
 protected:
   std::unique_ptr<quic::QuicSession>
   CreateQuicSession(quic::QuicConnectionId server_connection_id,
                     const quic::QuicSocketAddress& peer_address, quiche::QuicheStringPiece alpn,
                     const quic::ParsedQuicVersion& version) override;
+  bool MaybeDispatchPacket(const quic::ReceivedPacketInfo& packet_info) override;
 
 private:
   Network::ConnectionHandler& connection_handler_;
@@ -74,6 +92,8 @@ private:
   Server::ListenerStats& listener_stats_;
   Event::Dispatcher& dispatcher_;
   Network::Socket& listen_socket_;
+  UnknownConnectionCb unknown_connection_cb_;
+  bool processing_forwarded_packet_{};
 };
 
 } // namespace Quic
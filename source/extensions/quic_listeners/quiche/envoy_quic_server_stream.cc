@@ -141,26 +141,27 @@ void EnvoyQuicServerStream::OnBodyAvailable() {
   ASSERT(!in_decode_data_callstack_);
   in_decode_data_callstack_ = true;
 
-  Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
+  Buffer::OwnedImpl buffer;
   // TODO(danzh): check Envoy per stream buffer limit.
-  // Currently read out all the data.
+  // Currently read out all the data. The data is copied out of the sequencer, which recycles its
+  // blocks once they are consumed while the stream may be gone before the buffer is drained. All
+  // the readable regions are consumed at once, so that the sequencer and the flow controller are
+  // updated once rather than region by region.
   while (HasBytesToRead()) {
-    struct iovec iov;
-    int num_regions = GetReadableRegions(&iov, 1);
+    struct iovec iovs[MaxReadableRegions];
+    const int num_regions = GetReadableRegions(iovs, MaxReadableRegions);
     ASSERT(num_regions > 0);
-    size_t bytes_read = iov.iov_len;
-    Buffer::RawSlice slice;
-    buffer->reserve(bytes_read, &slice, 1);
-    ASSERT(slice.len_ >= bytes_read);
-    slice.len_ = bytes_read;
-    memcpy(slice.mem_, iov.iov_base, iov.iov_len);
-    buffer->commit(&slice, 1);
+    size_t bytes_read = 0;
+    for (int i = 0; i < num_regions; i++) {
+      buffer.add(iovs[i].iov_base, iovs[i].iov_len);
+      bytes_read += iovs[i].iov_len;
+    }
     MarkConsumed(bytes_read);
   }
 
   // True if no trailer and FIN read.
   bool finished_reading = IsDoneReading();
-  bool empty_payload_with_fin = buffer->length() == 0 && fin_received();
+  bool empty_payload_with_fin = buffer.length() == 0 && fin_received();
   // If this call is triggered by an empty frame with FIN which is not from peer
   // but synthesized by stream itself upon receiving HEADERS with FIN or
   // TRAILERS, do not deliver end of stream here. Because either decodeHeaders
@@ -168,7 +169,7 @@ void EnvoyQuicServerStream::OnBodyAvailable() {
   bool skip_decoding = empty_payload_with_fin && (end_stream_decoded_ || !finished_reading);
   if (!skip_decoding) {
     ASSERT(decoder() != nullptr);
-    decoder()->decodeData(*buffer, finished_reading);
+    decoder()->decodeData(buffer, finished_reading);
     if (finished_reading) {
       end_stream_decoded_ = true;
     }
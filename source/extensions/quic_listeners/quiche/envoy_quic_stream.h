@@ -100,6 +100,9 @@ public:
   }
 
 protected:
+  // The most readable regions of the stream sequencer read at once.
+  static constexpr int MaxReadableRegions = 16;
+
   virtual void switchStreamBlockState(bool should_block) PURE;
 
   // Needed for ENVOY_STREAM_LOG.
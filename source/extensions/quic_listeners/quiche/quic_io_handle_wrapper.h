@@ -50,6 +50,15 @@ public:
     }
     return io_handle_.recvmsg(slices, num_slice, self_port, output);
   }
+  Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                   uint32_t self_port, RecvMmsgOutput& output) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.recvmmsg(slices, num_packets, self_port, output);
+  }
+  bool supportsMmsg() const override { return io_handle_.supportsMmsg(); }
 
 private:
   Network::IoHandle& io_handle_;
@@ -15,8 +15,8 @@ namespace FixedHeapMonitor {
 
 Server::ResourceMonitorPtr FixedHeapMonitorFactory::createResourceMonitorFromProtoTyped(
     const envoy::config::resource_monitor::fixed_heap::v2alpha::FixedHeapConfig& config,
-    Server::Configuration::ResourceMonitorFactoryContext& /*unused_context*/) {
-  return std::make_unique<FixedHeapMonitor>(config);
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<FixedHeapMonitor>(config, context.api().timeSource());
 }
 
 /**
@@ -4,6 +4,7 @@
 
 #include "common/common/assert.h"
 #include "common/memory/stats.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -16,19 +17,38 @@ uint64_t MemoryStatsReader::unmappedHeapBytes() { return Memory::Stats::totalPag
 
 FixedHeapMonitor::FixedHeapMonitor(
     const envoy::config::resource_monitor::fixed_heap::v2alpha::FixedHeapConfig& config,
-    std::unique_ptr<MemoryStatsReader> stats)
-    : max_heap_(config.max_heap_size_bytes()), stats_(std::move(stats)) {
+    TimeSource& time_source, std::unique_ptr<MemoryStatsReader> stats)
+    : max_heap_(config.max_heap_size_bytes()),
+      stats_refresh_interval_(
+          config.has_stats_refresh_interval()
+              ? absl::make_optional(std::chrono::milliseconds(
+                    DurationUtil::durationToMilliseconds(config.stats_refresh_interval())))
+              : absl::nullopt),
+      time_source_(time_source), stats_(std::move(stats)) {
   ASSERT(max_heap_ > 0);
 }
 
-void FixedHeapMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+double FixedHeapMonitor::readPressure() {
   const size_t physical = stats_->reservedHeapBytes();
   const size_t unmapped = stats_->unmappedHeapBytes();
   ASSERT(physical >= unmapped);
   const size_t used = physical - unmapped;
+  return used / static_cast<double>(max_heap_);
+}
+
+void FixedHeapMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  if (!stats_refresh_interval_.has_value()) {
+    last_pressure_ = readPressure();
+  } else {
+    const MonotonicTime now = time_source_.monotonicTime();
+    if (!last_read_.has_value() || now - last_read_.value() >= stats_refresh_interval_.value()) {
+      last_pressure_ = readPressure();
+      last_read_ = now;
+    }
+  }
 
   Server::ResourceUsage usage;
-  usage.resource_pressure_ = used / static_cast<double>(max_heap_);
+  usage.resource_pressure_ = last_pressure_;
 
   callbacks.onSuccess(usage);
 }
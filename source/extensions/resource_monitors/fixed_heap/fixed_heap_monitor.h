@@ -1,8 +1,13 @@
 #pragma once
 
+#include <chrono>
+
+#include "envoy/common/time.h"
 #include "envoy/config/resource_monitor/fixed_heap/v2alpha/fixed_heap.pb.h"
 #include "envoy/server/resource_monitor.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace ResourceMonitors {
@@ -23,19 +28,29 @@ public:
 };
 
 /**
- * Heap memory monitor with a statically configured maximum.
+ * Heap memory monitor with a statically configured maximum. Reading the heap stats takes the
+ * allocator's page heap lock, so with a stats refresh interval configured the stats are only
+ * sampled once per interval, and the last pressure is reported in between.
  */
 class FixedHeapMonitor : public Server::ResourceMonitor {
 public:
   FixedHeapMonitor(
       const envoy::config::resource_monitor::fixed_heap::v2alpha::FixedHeapConfig& config,
+      TimeSource& time_source,
       std::unique_ptr<MemoryStatsReader> stats = std::make_unique<MemoryStatsReader>());
 
   void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
 
 private:
+  double readPressure();
+
   const uint64_t max_heap_;
+  const absl::optional<std::chrono::milliseconds> stats_refresh_interval_;
+  TimeSource& time_source_;
   std::unique_ptr<MemoryStatsReader> stats_;
+  // The pressure last read from the heap stats, and when.
+  double last_pressure_{};
+  absl::optional<MonotonicTime> last_read_;
 };
 
 } // namespace FixedHeapMonitor
@@ -0,0 +1,29 @@
+#include "extensions/resource_monitors/loop_lag/config.h"
+
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.h"
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/loop_lag/loop_lag_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace LoopLagMonitor {
+
+Server::ResourceMonitorPtr LoopLagMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<LoopLagMonitor>(config, context.api().timeSource(),
+                                          context.threadLocal());
+}
+
+/**
+ * Static registration for the event loop lag resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(LoopLagMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace LoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
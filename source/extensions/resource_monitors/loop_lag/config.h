@@ -0,0 +1,30 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.h"
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace LoopLagMonitor {
+
+class LoopLagMonitorFactory
+    : public Common::FactoryBase<
+          envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig> {
+public:
+  LoopLagMonitorFactory() : FactoryBase(ResourceMonitorNames::get().LoopLag) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace LoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,59 @@
+#include "extensions/resource_monitors/loop_lag/loop_lag_monitor.h"
+
+#include <atomic>
+
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.h"
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace LoopLagMonitor {
+
+LoopLagMonitor::LoopLagMonitor(
+    const envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig& config,
+    TimeSource& time_source, ThreadLocal::SlotAllocator& slot_allocator)
+    : max_lag_(std::chrono::milliseconds(DurationUtil::durationToMilliseconds(config.max_lag()))),
+      time_source_(time_source), slot_(slot_allocator.allocateSlot()),
+      alive_(std::make_shared<bool>(true)) {
+  ASSERT(max_lag_.count() > 0);
+}
+
+LoopLagMonitor::~LoopLagMonitor() { *alive_ = false; }
+
+void LoopLagMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  struct Probe {
+    MonotonicTime posted_;
+    std::atomic<int64_t> max_lag_us_{0};
+  };
+  auto probe = std::make_shared<Probe>();
+  probe->posted_ = time_source_.monotonicTime();
+
+  TimeSource& time_source = time_source_;
+  slot_->runOnAllThreads(
+      [probe, &time_source]() -> void {
+        const int64_t lag_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                   time_source.monotonicTime() - probe->posted_)
+                                   .count();
+        int64_t max_lag_us = probe->max_lag_us_.load();
+        while (lag_us > max_lag_us &&
+               !probe->max_lag_us_.compare_exchange_weak(max_lag_us, lag_us)) {
+        }
+      },
+      [probe, alive = alive_, max_lag = max_lag_, &callbacks]() -> void {
+        // Runs on the main thread, as does the destruction of the monitor.
+        if (!*alive) {
+          return;
+        }
+        Server::ResourceUsage usage;
+        usage.resource_pressure_ = probe->max_lag_us_.load() / static_cast<double>(max_lag.count());
+        callbacks.onSuccess(usage);
+      });
+}
+
+} // namespace LoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace LoopLagMonitor {
+
+/**
+ * Event loop lag monitor. On each update it posts a probe to the main and worker threads, and
+ * reports the longest time the probe waited to be run, relative to a statically configured
+ * maximum. As the probe is run once the threads get to it, only busy threads lag behind.
+ */
+class LoopLagMonitor : public Server::ResourceMonitor {
+public:
+  LoopLagMonitor(const envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig& config,
+                 TimeSource& time_source, ThreadLocal::SlotAllocator& slot_allocator);
+  ~LoopLagMonitor() override;
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const std::chrono::microseconds max_lag_;
+  TimeSource& time_source_;
+  ThreadLocal::SlotPtr slot_;
+  // Cleared on destruction, so that probes completing later don't report to the callbacks.
+  std::shared_ptr<bool> alive_;
+};
+
+} // namespace LoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -18,6 +18,9 @@ public:
 
   // File-based injected resource monitor.
   const std::string InjectedResource = "envoy.resource_monitors.injected_resource";
+
+  // Lag of the event loops of the main and worker threads.
+  const std::string LoopLag = "envoy.resource_monitors.loop_lag";
 };
 
 using ResourceMonitorNames = ConstSingleton<ResourceMonitorNameValues>;
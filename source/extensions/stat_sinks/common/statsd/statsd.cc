@@ -1,8 +1,10 @@
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/common/platform.h"
@@ -25,6 +27,11 @@ namespace StatSinks {
 namespace Common {
 namespace Statsd {
 
+namespace {
+// The maximum number of messages sent by a sendmmsg() call.
+constexpr size_t MessagesPerBatch = 64;
+} // namespace
+
 Writer::Writer(Network::Address::InstanceConstSharedPtr address)
     : io_handle_(address->socket(Network::Address::SocketType::Datagram)) {
   ASSERT(io_handle_->fd() != -1);
@@ -43,31 +50,99 @@ void Writer::write(const std::string& message) {
   ::send(io_handle_->fd(), message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+void Writer::writeBatch(const std::vector<std::string>& messages) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  if (!os_sys_calls.supportsMmsg()) {
+    for (const std::string& message : messages) {
+      write(message);
+    }
+    return;
+  }
+
+  std::array<struct mmsghdr, MessagesPerBatch> headers;
+  std::array<struct iovec, MessagesPerBatch> iovecs;
+  size_t offset = 0;
+  while (offset < messages.size()) {
+    const size_t num_messages = std::min(MessagesPerBatch, messages.size() - offset);
+    memset(headers.data(), 0, num_messages * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < num_messages; i++) {
+      const std::string& message = messages[offset + i];
+      iovecs[i].iov_base = const_cast<char*>(message.data());
+      iovecs[i].iov_len = message.size();
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    const Api::SysCallIntResult result =
+        os_sys_calls.sendmmsg(io_handle_->fd(), headers.data(), num_messages, MSG_DONTWAIT);
+    if (result.rc_ > 0) {
+      // sendmmsg() stops at the first message it fails to send, and the rest are sent again.
+      offset += result.rc_;
+    } else if (result.errno_ == EAGAIN) {
+      // None of the remaining messages could be sent without blocking either.
+      return;
+    } else if (result.errno_ != EINTR) {
+      // The first message could not be sent, and is dropped like write() would.
+      offset++;
+    }
+  }
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
-                             const std::string& prefix)
+                             const std::string& prefix, uint64_t max_bytes_per_datagram)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
-      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix) {
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      max_bytes_per_datagram_(max_bytes_per_datagram) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<Writer>(this->server_address_);
   });
 }
 
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
-  Writer& writer = tls_->getTyped<Writer>();
+  DatagramBatch batch(tls_->getTyped<Writer>(), max_bytes_per_datagram_);
   for (const auto& counter : snapshot.counters()) {
-    if (counter.counter_.get().used()) {
-      writer.write(absl::StrCat(prefix_, ".", getName(counter.counter_.get()), ":", counter.delta_,
-                                "|c", buildTagStr(counter.counter_.get().tags())));
+    // Counters that did not change since the last flush would not change the value aggregated by
+    // the listener.
+    if (counter.counter_.get().used() && counter.delta_ != 0) {
+      batch.add(absl::StrCat(prefix_, ".", getName(counter.counter_.get()), ":", counter.delta_,
+                             "|c", buildTagStr(counter.counter_.get().tags())));
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      writer.write(absl::StrCat(prefix_, ".", getName(gauge.get()), ":", gauge.get().value(), "|g",
-                                buildTagStr(gauge.get().tags())));
+      batch.add(absl::StrCat(prefix_, ".", getName(gauge.get()), ":", gauge.get().value(), "|g",
+                             buildTagStr(gauge.get().tags())));
     }
   }
+  batch.write();
+}
+
+void UdpStatsdSink::DatagramBatch::add(const std::string& metric) {
+  if (max_bytes_per_datagram_ == 0) {
+    writer_.write(metric);
+    return;
+  }
+
+  if (!current_.empty() && current_.size() + 1 + metric.size() > max_bytes_per_datagram_) {
+    datagrams_.push_back(std::move(current_));
+    current_.clear();
+  }
+  if (!current_.empty()) {
+    current_.push_back('\n');
+  }
+  current_.append(metric);
+}
+
+void UdpStatsdSink::DatagramBatch::write() {
+  if (!current_.empty()) {
+    datagrams_.push_back(std::move(current_));
+    current_.clear();
+  }
+  if (!datagrams_.empty()) {
+    writer_.writeBatch(datagrams_);
+    datagrams_.clear();
+  }
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -253,11 +328,12 @@ void TcpStatsdSink::TlsSink::write(Buffer::Instance& buffer) {
 
     connection_ = std::move(info.connection_);
     connection_->addConnectionCallbacks(*this);
-    connection_->setConnectionStats({parent_.cluster_info_->stats().upstream_cx_rx_bytes_total_,
-                                     parent_.cluster_info_->stats().upstream_cx_rx_bytes_buffered_,
-                                     parent_.cluster_info_->stats().upstream_cx_tx_bytes_total_,
-                                     parent_.cluster_info_->stats().upstream_cx_tx_bytes_buffered_,
-                                     &parent_.cluster_info_->stats().bind_errors_, nullptr});
+    connection_->setConnectionStats(
+        {parent_.cluster_info_->stats().upstream_cx_rx_bytes_total_,
+         parent_.cluster_info_->stats().upstream_cx_rx_bytes_buffered_,
+         parent_.cluster_info_->stats().upstream_cx_tx_bytes_total_,
+         parent_.cluster_info_->stats().upstream_cx_tx_bytes_buffered_,
+         &parent_.cluster_info_->stats().bind_errors_, nullptr, nullptr});
     connection_->connect();
   }
 
@@ -34,6 +34,12 @@ public:
   ~Writer() override;
 
   virtual void write(const std::string& message);
+  /**
+   * Writes each message as a datagram, with as few system calls as the platform allows. The
+   * messages after one which fails to be sent are sent again. Like write(), messages that can't be
+   * sent without blocking are dropped.
+   */
+  virtual void writeBatch(const std::vector<std::string>& messages);
   // Called in unit test to validate address.
   int getFdForTests() const { return io_handle_->fd(); }
 
@@ -47,12 +53,15 @@ private:
 class UdpStatsdSink : public Stats::Sink {
 public:
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix());
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                uint64_t max_bytes_per_datagram = 0);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix())
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                uint64_t max_bytes_per_datagram = 0)
       : tls_(tls.allocateSlot()), use_tag_(use_tag),
-        prefix_(prefix.empty() ? getDefaultPrefix() : prefix) {
+        prefix_(prefix.empty() ? getDefaultPrefix() : prefix),
+        max_bytes_per_datagram_(max_bytes_per_datagram) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
   }
@@ -60,6 +69,7 @@ public:
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
+  bool flushOffMainThread() const override { return true; }
 
   // Called in unit test to validate writer construction and address.
   int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
@@ -67,6 +77,26 @@ public:
   const std::string& getPrefix() { return prefix_; }
 
 private:
+  /**
+   * Packs the metrics of a flush into datagrams of up to max_bytes_per_datagram bytes, one metric
+   * per line, and writes them in a single batch. Without a maximum, each metric is written on its
+   * own as soon as it is added.
+   */
+  class DatagramBatch {
+  public:
+    DatagramBatch(Writer& writer, uint64_t max_bytes_per_datagram)
+        : writer_(writer), max_bytes_per_datagram_(max_bytes_per_datagram) {}
+
+    void add(const std::string& metric);
+    void write();
+
+  private:
+    Writer& writer_;
+    const uint64_t max_bytes_per_datagram_;
+    std::vector<std::string> datagrams_;
+    std::string current_;
+  };
+
   const std::string getName(const Stats::Metric& metric) const;
   const std::string buildTagStr(const std::vector<Stats::Tag>& tags) const;
 
@@ -75,6 +105,8 @@ private:
   const bool use_tag_;
   // Prefix for all flushed stats.
   const std::string prefix_;
+  // Maximum size of the datagrams flushed, or 0 to send each metric in its own datagram.
+  const uint64_t max_bytes_per_datagram_;
 };
 
 /**
@@ -93,6 +125,7 @@ public:
     tls_->getTyped<TlsSink>().onTimespanComplete(histogram.name(),
                                                  std::chrono::milliseconds(value));
   }
+  bool flushOffMainThread() const override { return true; }
 
   const std::string& getPrefix() { return prefix_; }
 
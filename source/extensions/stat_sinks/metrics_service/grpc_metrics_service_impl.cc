@@ -35,17 +35,17 @@ void GrpcMetricsStreamerImpl::send(
 }
 
 MetricsServiceSink::MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
-                                       TimeSource& time_source)
-    : grpc_metrics_streamer_(grpc_metrics_streamer), time_source_(time_source) {}
+                                       TimeSource& time_source,
+                                       bool report_changed_metrics_only)
+    : grpc_metrics_streamer_(grpc_metrics_streamer), time_source_(time_source),
+      report_changed_metrics_only_(report_changed_metrics_only) {}
 
 void MetricsServiceSink::flushCounter(const Stats::Counter& counter) {
   io::prometheus::client::MetricFamily* metrics_family = message_.add_envoy_metrics();
   metrics_family->set_type(io::prometheus::client::MetricType::COUNTER);
   metrics_family->set_name(counter.name());
   auto* metric = metrics_family->add_metric();
-  metric->set_timestamp_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
-                               time_source_.systemTime().time_since_epoch())
-                               .count());
+  metric->set_timestamp_ms(flush_time_ms_);
   auto* counter_metric = metric->mutable_counter();
   counter_metric->set_value(counter.value());
 }
@@ -55,9 +55,7 @@ void MetricsServiceSink::flushGauge(const Stats::Gauge& gauge) {
   metrics_family->set_type(io::prometheus::client::MetricType::GAUGE);
   metrics_family->set_name(gauge.name());
   auto* metric = metrics_family->add_metric();
-  metric->set_timestamp_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
-                               time_source_.systemTime().time_since_epoch())
-                               .count());
+  metric->set_timestamp_ms(flush_time_ms_);
   auto* gauge_metric = metric->mutable_gauge();
   gauge_metric->set_value(gauge.value());
 }
@@ -72,9 +70,7 @@ void MetricsServiceSink::flushHistogram(const Stats::ParentHistogram& envoy_hist
   summary_metrics_family->set_type(io::prometheus::client::MetricType::SUMMARY);
   summary_metrics_family->set_name(envoy_histogram.name());
   auto* summary_metric = summary_metrics_family->add_metric();
-  summary_metric->set_timestamp_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       time_source_.systemTime().time_since_epoch())
-                                       .count());
+  summary_metric->set_timestamp_ms(flush_time_ms_);
   auto* summary = summary_metric->mutable_summary();
   const Stats::HistogramStatistics& hist_stats = envoy_histogram.intervalStatistics();
   for (size_t i = 0; i < hist_stats.supportedQuantiles().size(); i++) {
@@ -88,9 +84,7 @@ void MetricsServiceSink::flushHistogram(const Stats::ParentHistogram& envoy_hist
   histogram_metrics_family->set_type(io::prometheus::client::MetricType::HISTOGRAM);
   histogram_metrics_family->set_name(envoy_histogram.name());
   auto* histogram_metric = histogram_metrics_family->add_metric();
-  histogram_metric->set_timestamp_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                         time_source_.systemTime().time_since_epoch())
-                                         .count());
+  histogram_metric->set_timestamp_ms(flush_time_ms_);
   auto* histogram = histogram_metric->mutable_histogram();
   histogram->set_sample_count(hist_stats.sampleCount());
   histogram->set_sample_sum(hist_stats.sampleSum());
@@ -101,8 +95,22 @@ void MetricsServiceSink::flushHistogram(const Stats::ParentHistogram& envoy_hist
   }
 }
 
+bool MetricsServiceSink::gaugeChanged(
+    const Stats::Gauge& gauge, absl::flat_hash_map<std::string, uint64_t>& gauge_values) const {
+  std::string name = gauge.name();
+  const uint64_t value = gauge.value();
+  const auto it = last_gauge_values_.find(name);
+  const bool changed = it == last_gauge_values_.end() || it->second != value;
+  gauge_values.emplace(std::move(name), value);
+  return changed;
+}
+
 void MetricsServiceSink::flush(Stats::MetricSnapshot& snapshot) {
+  // Clearing keeps the metric families allocated, for the next ones added to reuse.
   message_.clear_envoy_metrics();
+  flush_time_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       time_source_.systemTime().time_since_epoch())
+                       .count();
 
   // TODO(mrice32): there's probably some more sophisticated preallocation we can do here where we
   // actually preallocate the submessages and then pass ownership to the proto (rather than just
@@ -110,19 +118,28 @@ void MetricsServiceSink::flush(Stats::MetricSnapshot& snapshot) {
   message_.mutable_envoy_metrics()->Reserve(snapshot.counters().size() + snapshot.gauges().size() +
                                             snapshot.histograms().size());
   for (const auto& counter : snapshot.counters()) {
-    if (counter.counter_.get().used()) {
+    if (counter.counter_.get().used() && (!report_changed_metrics_only_ || counter.delta_ > 0)) {
       flushCounter(counter.counter_.get());
     }
   }
 
+  // Only the gauges of this snapshot are kept, so that removed gauges are forgotten.
+  absl::flat_hash_map<std::string, uint64_t> gauge_values;
   for (const auto& gauge : snapshot.gauges()) {
-    if (gauge.get().used()) {
+    if (gauge.get().used() &&
+        (!report_changed_metrics_only_ || gaugeChanged(gauge.get(), gauge_values))) {
       flushGauge(gauge.get());
     }
   }
+  if (report_changed_metrics_only_) {
+    last_gauge_values_.swap(gauge_values);
+  }
 
+  // The interval statistics are computed once when the histograms are merged, and shared by the
+  // sinks.
   for (const auto& histogram : snapshot.histograms()) {
-    if (histogram.get().used()) {
+    if (histogram.get().used() && (!report_changed_metrics_only_ ||
+                                   histogram.get().intervalStatistics().sampleCount() > 0)) {
       flushHistogram(histogram.get());
     }
   }
@@ -13,6 +13,8 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/grpc/typed_async_client.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -66,13 +68,14 @@ private:
 };
 
 /**
- * Stat Sink implementation of Metrics Service.
+ * Stat Sink implementation of Metrics Service. With report_changed_metrics_only, only the counters
+ * incremented, the gauges changed and the histograms recorded into since the last flush are sent.
  */
 class MetricsServiceSink : public Stats::Sink {
 public:
   // MetricsService::Sink
   MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
-                     TimeSource& time_system);
+                     TimeSource& time_system, bool report_changed_metrics_only);
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
@@ -81,9 +84,18 @@ public:
   void flushHistogram(const Stats::ParentHistogram& envoy_histogram);
 
 private:
+  bool gaugeChanged(const Stats::Gauge& gauge,
+                    absl::flat_hash_map<std::string, uint64_t>& gauge_values) const;
+
   GrpcMetricsStreamerSharedPtr grpc_metrics_streamer_;
+  // Reused across flushes, so that the metric families cleared are reused by the next flush.
   envoy::service::metrics::v3alpha::StreamMetricsMessage message_;
   TimeSource& time_source_;
+  const bool report_changed_metrics_only_;
+  // The timestamp of the metrics of the current flush.
+  int64_t flush_time_ms_{};
+  // The values of the gauges sent at the last flush, by name, with report_changed_metrics_only.
+  absl::flat_hash_map<std::string, uint64_t> last_gauge_values_;
 };
 
 } // namespace MetricsService
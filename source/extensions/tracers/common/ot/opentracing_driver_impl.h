@@ -40,6 +40,7 @@ public:
   Tracing::SpanPtr spawnChild(const Tracing::Config& config, const std::string& name,
                               SystemTime start_time) override;
   void setSampled(bool) override;
+  bool isRecording() const override { return true; }
 
 private:
   OpenTracingDriver& driver_;
@@ -65,6 +65,7 @@ public:
   Tracing::SpanPtr spawnChild(const Tracing::Config& config, const std::string& name,
                               SystemTime start_time) override;
   void setSampled(bool sampled) override;
+  bool isRecording() const override { return span_.IsRecording(); }
 
 private:
   ::opencensus::trace::Span span_;
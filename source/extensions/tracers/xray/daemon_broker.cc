@@ -3,6 +3,7 @@
 #include "envoy/network/address.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/lock_guard.h"
 #include "common/network/utility.h"
 
 #include "source/extensions/tracers/xray/daemon.pb.h"
@@ -33,13 +34,12 @@ std::string createHeader(const std::string& format, uint32_t version) {
 
 DaemonBrokerImpl::DaemonBrokerImpl(const std::string& daemon_endpoint)
     : address_(Network::Utility::parseInternetAddressAndPort(daemon_endpoint, false /*v6only*/)),
-      io_handle_(address_->socket(Network::Address::SocketType::Datagram)) {}
+      io_handle_(address_->socket(Network::Address::SocketType::Datagram)),
+      header_(absl::StrCat(createHeader("json" /*format*/, 1 /*version*/), "\n")) {}
 
 void DaemonBrokerImpl::send(const std::string& data) const {
   auto& logger = Logger::Registry::getLog(Logger::Id::tracing);
-  constexpr auto version = 1;
-  constexpr auto format = "json";
-  const std::string payload = absl::StrCat(createHeader(format, version), "\n", data);
+  const std::string payload = absl::StrCat(header_, data);
   Buffer::RawSlice buf;
   buf.mem_ = const_cast<char*>(payload.data());
   buf.len_ = payload.length();
@@ -52,6 +52,60 @@ void DaemonBrokerImpl::send(const std::string& data) const {
   }
 }
 
+AsyncDaemonBroker::AsyncDaemonBroker(DaemonBrokerPtr broker, Thread::ThreadFactory& thread_factory,
+                                     size_t max_queued_segments)
+    : broker_(std::move(broker)), max_queued_segments_(max_queued_segments),
+      thread_(thread_factory.createThread([this]() -> void { sendQueuedSegments(); })) {}
+
+AsyncDaemonBroker::~AsyncDaemonBroker() {
+  {
+    Thread::LockGuard lock(lock_);
+    shutdown_ = true;
+    queued_.notifyOne();
+  }
+  thread_->join();
+}
+
+void AsyncDaemonBroker::send(const std::string& data) const {
+  Thread::LockGuard lock(lock_);
+  if (queue_.size() >= max_queued_segments_) {
+    ++dropped_segments_;
+    return;
+  }
+  queue_.push_back(data);
+  if (queue_.size() == 1) {
+    queued_.notifyOne();
+  }
+}
+
+uint64_t AsyncDaemonBroker::droppedSegments() const {
+  Thread::LockGuard lock(lock_);
+  return dropped_segments_;
+}
+
+void AsyncDaemonBroker::sendQueuedSegments() {
+  std::vector<std::string> segments;
+  while (true) {
+    {
+      Thread::LockGuard lock(lock_);
+      while (queue_.empty() && !shutdown_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        queued_.wait(lock_);
+      }
+      if (queue_.empty()) {
+        return;
+      }
+      // The segments queued meanwhile are sent from the vector the previous ones were sent from,
+      // whose capacity is reused by the workers.
+      segments.swap(queue_);
+    }
+    for (const std::string& segment : segments) {
+      broker_->send(segment);
+    }
+    segments.clear();
+  }
+}
+
 } // namespace XRay
 } // namespace Tracers
 } // namespace Extensions
@@ -2,10 +2,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/common/pure.h"
 #include "envoy/network/address.h"
+#include "envoy/thread/thread.h"
 
+#include "common/common/thread.h"
 #include "common/network/io_socket_handle_impl.h"
 
 namespace Envoy {
@@ -30,6 +33,7 @@ public:
 };
 
 using DaemonBrokerPtr = std::unique_ptr<DaemonBroker>;
+using DaemonBrokerSharedPtr = std::shared_ptr<DaemonBroker>;
 
 class DaemonBrokerImpl : public DaemonBroker {
 public:
@@ -45,6 +49,41 @@ public:
 private:
   const Network::Address::InstanceConstSharedPtr address_;
   const Network::IoHandlePtr io_handle_;
+  // The header prefixing each segment, followed by a newline.
+  const std::string header_;
+};
+
+/**
+ * Hands the segments over to a thread which sends them with the wrapped broker, so that the workers
+ * sharing this broker neither serialize their sends nor wait for the socket. The segments are sent
+ * in batches, as they are queued while the thread sends the previous ones. At most
+ * |max_queued_segments| segments wait to be sent: the segments sent while the queue is full are
+ * dropped.
+ */
+class AsyncDaemonBroker : public DaemonBroker {
+public:
+  AsyncDaemonBroker(DaemonBrokerPtr broker, Thread::ThreadFactory& thread_factory,
+                    size_t max_queued_segments);
+  ~AsyncDaemonBroker() override;
+
+  void send(const std::string& data) const override;
+
+  /**
+   * @return the number of segments dropped so far because the queue was full.
+   */
+  uint64_t droppedSegments() const;
+
+private:
+  void sendQueuedSegments();
+
+  const DaemonBrokerPtr broker_;
+  const size_t max_queued_segments_;
+  mutable Thread::MutexBasicLockable lock_;
+  mutable Thread::CondVar queued_;
+  mutable std::vector<std::string> queue_ ABSL_GUARDED_BY(lock_);
+  mutable uint64_t dropped_segments_ ABSL_GUARDED_BY(lock_){};
+  bool shutdown_ ABSL_GUARDED_BY(lock_){};
+  Thread::ThreadPtr thread_;
 };
 
 } // namespace XRay
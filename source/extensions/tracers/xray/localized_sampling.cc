@@ -3,8 +3,6 @@
 #include "common/http/exception.h"
 #include "common/protobuf/utility.h"
 
-#include "extensions/tracers/xray/util.h"
-
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
@@ -79,9 +77,9 @@ LocalizedSamplingRule LocalizedSamplingRule::createDefault() {
 }
 
 bool LocalizedSamplingRule::appliesTo(const SamplingRequest& request) const {
-  return (request.host_.empty() || wildcardMatch(host_, request.host_)) &&
-         (request.http_method_.empty() || wildcardMatch(http_method_, request.http_method_)) &&
-         (request.http_url_.empty() || wildcardMatch(url_path_, request.http_url_));
+  return (request.host_.empty() || host_matcher_.matches(request.host_)) &&
+         (request.http_method_.empty() || http_method_matcher_.matches(request.http_method_)) &&
+         (request.http_url_.empty() || url_path_matcher_.matches(request.http_url_));
 }
 
 LocalizedSamplingManifest::LocalizedSamplingManifest(const std::string& rule_json)
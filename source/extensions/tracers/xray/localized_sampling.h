@@ -11,6 +11,7 @@
 
 #include "extensions/tracers/xray/reservoir.h"
 #include "extensions/tracers/xray/sampling_strategy.h"
+#include "extensions/tracers/xray/util.h"
 
 #include "absl/strings/string_view.h"
 
@@ -37,7 +38,8 @@ public:
   static LocalizedSamplingRule createDefault();
 
   LocalizedSamplingRule(uint32_t fixed_target, double rate)
-      : fixed_target_(fixed_target), rate_(rate), reservoir_(fixed_target_) {}
+      : host_matcher_(host_), http_method_matcher_(http_method_), url_path_matcher_(url_path_),
+        fixed_target_(fixed_target), rate_(rate), reservoir_(fixed_target_) {}
 
   /**
    * Determines whether Hostname, HTTP method and URL path match the given request.
@@ -48,19 +50,28 @@ public:
    * Set the hostname to match against.
    * This value can contain wildcard characters such as '*' or '?'.
    */
-  void setHost(absl::string_view host) { host_ = std::string(host); }
+  void setHost(absl::string_view host) {
+    host_ = std::string(host);
+    host_matcher_ = WildcardMatcher(host_);
+  }
 
   /**
    * Set the HTTP method to match against.
    * This value can contain wildcard characters such as '*' or '?'.
    */
-  void setHttpMethod(absl::string_view http_method) { http_method_ = std::string(http_method); }
+  void setHttpMethod(absl::string_view http_method) {
+    http_method_ = std::string(http_method);
+    http_method_matcher_ = WildcardMatcher(http_method_);
+  }
 
   /**
    * Set the URL path to match against.
    * This value can contain wildcard characters such as '*' or '?'.
    */
-  void setUrlPath(absl::string_view url_path) { url_path_ = std::string(url_path); }
+  void setUrlPath(absl::string_view url_path) {
+    url_path_ = std::string(url_path);
+    url_path_matcher_ = WildcardMatcher(url_path_);
+  }
 
   /**
    * Set the minimum number of requests to sample per second.
@@ -87,6 +98,10 @@ private:
   std::string host_;
   std::string http_method_;
   std::string url_path_;
+  // The patterns above, compiled when they are set rather than for each request.
+  WildcardMatcher host_matcher_;
+  WildcardMatcher http_method_matcher_;
+  WildcardMatcher url_path_matcher_;
   uint32_t fixed_target_;
   double rate_;
   Reservoir reservoir_;
@@ -14,10 +14,13 @@ namespace Extensions {
 namespace Tracers {
 namespace XRay {
 
+/**
+ * The parts of a request the sampling rules match, which refer to the request headers.
+ */
 struct SamplingRequest {
-  std::string host_;
-  std::string http_method_;
-  std::string http_url_;
+  absl::string_view host_;
+  absl::string_view http_method_;
+  absl::string_view http_url_;
 };
 
 /**
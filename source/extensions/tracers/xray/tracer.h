@@ -126,6 +126,11 @@ public:
    */
   bool sampled() const { return sampled_; }
 
+  /**
+   * Spans that are not sampled are not sent to the X-Ray daemon.
+   */
+  bool isRecording() const override { return sampled_; }
+
   /**
    * Not used by X-Ray because the Spans are "logged" (serialized) to the X-Ray daemon.
    */
@@ -159,7 +164,8 @@ using SpanPtr = std::unique_ptr<Span>;
 
 class Tracer {
 public:
-  Tracer(absl::string_view segment_name, DaemonBrokerPtr daemon_broker, TimeSource& time_source)
+  Tracer(absl::string_view segment_name, DaemonBrokerSharedPtr daemon_broker,
+         TimeSource& time_source)
       : segment_name_(segment_name), daemon_broker_(std::move(daemon_broker)),
         time_source_(time_source) {}
 
@@ -179,7 +185,7 @@ public:
 
 private:
   const std::string segment_name_;
-  const DaemonBrokerPtr daemon_broker_;
+  const DaemonBrokerSharedPtr daemon_broker_;
   Envoy::TimeSource& time_source_;
 };
 
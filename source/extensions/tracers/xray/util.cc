@@ -1,6 +1,7 @@
 #include "extensions/tracers/xray/util.h"
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -60,6 +61,49 @@ bool wildcardMatch(absl::string_view pattern, absl::string_view input) {
   return p == pattern.size() && i == input.size();
 }
 
+WildcardMatcher::WildcardMatcher(absl::string_view pattern) : type_(Type::Wildcard) {
+  constexpr char glob = '*';
+  const size_t first = pattern.find_first_not_of(glob);
+  if (first == absl::string_view::npos && !pattern.empty()) {
+    type_ = Type::Any;
+    return;
+  }
+
+  absl::string_view literal = pattern;
+  const bool leading_glob = first > 0 && first != absl::string_view::npos;
+  if (leading_glob) {
+    literal.remove_prefix(first);
+  }
+  const size_t last = literal.find_last_not_of(glob);
+  const bool trailing_glob = last != absl::string_view::npos && last + 1 < literal.size();
+  if (trailing_glob) {
+    literal.remove_suffix(literal.size() - last - 1);
+  }
+
+  if (literal.find_first_of("*?") != absl::string_view::npos || (leading_glob && trailing_glob)) {
+    pattern_ = std::string(pattern);
+    return;
+  }
+  type_ = leading_glob ? Type::Suffix : trailing_glob ? Type::Prefix : Type::Exact;
+  pattern_ = std::string(literal);
+}
+
+bool WildcardMatcher::matches(absl::string_view input) const {
+  switch (type_) {
+  case Type::Any:
+    return true;
+  case Type::Exact:
+    return absl::EqualsIgnoreCase(input, pattern_);
+  case Type::Prefix:
+    return absl::StartsWithIgnoreCase(input, pattern_);
+  case Type::Suffix:
+    return absl::EndsWithIgnoreCase(input, pattern_);
+  case Type::Wildcard:
+    return wildcardMatch(pattern_, input);
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
 } // namespace XRay
 } // namespace Tracers
 } // namespace Extensions
@@ -21,6 +21,28 @@ namespace XRay {
  */
 bool wildcardMatch(absl::string_view pattern, absl::string_view input);
 
+/**
+ * A wildcard pattern compiled once, which matches the same inputs as wildcardMatch() does. The
+ * patterns made of a literal, possibly preceded or followed by asterisks, are matched by a single
+ * case-insensitive comparison without scanning for wildcards.
+ */
+class WildcardMatcher {
+public:
+  explicit WildcardMatcher(absl::string_view pattern);
+
+  /**
+   * @return whether the input matches the pattern.
+   */
+  bool matches(absl::string_view input) const;
+
+private:
+  enum class Type { Any, Exact, Prefix, Suffix, Wildcard };
+
+  Type type_;
+  // The literal of the pattern, or the whole pattern for Type::Wildcard.
+  std::string pattern_;
+};
+
 } // namespace XRay
 } // namespace Tracers
 } // namespace Extensions
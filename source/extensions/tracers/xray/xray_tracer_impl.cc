@@ -14,6 +14,8 @@ namespace XRay {
 
 namespace {
 constexpr auto DefaultDaemonEndpoint = "127.0.0.1:2000";
+// The segments waiting to be sent to the daemon, beyond which finished segments are dropped.
+constexpr size_t MaxQueuedSegments = 1024;
 XRayHeader parseXRayHeader(const Http::LowerCaseString& header) {
   const auto& lowered_header = header.get();
   XRayHeader result;
@@ -46,16 +48,20 @@ Driver::Driver(const XRayConfiguration& config, Server::Instance& server)
   ENVOY_LOG(debug, "send X-Ray generated segments to daemon address on {}", daemon_endpoint);
   sampling_strategy_ = std::make_unique<XRay::LocalizedSamplingStrategy>(
       xray_config_.sampling_rules_, server.random(), server.timeSource());
-
-  tls_slot_ptr_->set([this, daemon_endpoint,
-                      &server](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    std::string span_name = xray_config_.segment_name_.empty() ? server.localInfo().clusterName()
-                                                               : xray_config_.segment_name_;
-
-    DaemonBrokerPtr broker = std::make_unique<DaemonBrokerImpl>(daemon_endpoint);
-    TracerPtr tracer = std::make_unique<Tracer>(span_name, std::move(broker), server.timeSource());
-    return std::make_shared<XRay::Driver::TlsTracer>(std::move(tracer), *this);
-  });
+  daemon_broker_ =
+      std::make_shared<AsyncDaemonBroker>(std::make_unique<DaemonBrokerImpl>(daemon_endpoint),
+                                          server.api().threadFactory(), MaxQueuedSegments);
+
+  tls_slot_ptr_->set(
+      [this, &server](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        std::string span_name = xray_config_.segment_name_.empty()
+                                    ? server.localInfo().clusterName()
+                                    : xray_config_.segment_name_;
+
+        TracerPtr tracer =
+            std::make_unique<Tracer>(span_name, daemon_broker_, server.timeSource());
+        return std::make_shared<XRay::Driver::TlsTracer>(std::move(tracer), *this);
+      });
 }
 
 Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config, Http::HeaderMap& request_headers,
@@ -93,9 +99,9 @@ Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config, Http::HeaderMa
   }
 
   if (!should_trace.has_value()) {
-    const SamplingRequest request{std::string{request_headers.Host()->value().getStringView()},
-                                  std::string{request_headers.Method()->value().getStringView()},
-                                  std::string{request_headers.Path()->value().getStringView()}};
+    const SamplingRequest request{request_headers.Host()->value().getStringView(),
+                                  request_headers.Method()->value().getStringView(),
+                                  request_headers.Path()->value().getStringView()};
 
     should_trace = sampling_strategy_->shouldTrace(request);
   }
@@ -31,6 +31,8 @@ private:
 
   XRayConfiguration xray_config_;
   SamplingStrategyPtr sampling_strategy_;
+  // Shared by the tracers of all the threads.
+  DaemonBrokerSharedPtr daemon_broker_;
   ThreadLocal::SlotPtr tls_slot_ptr_;
 };
 
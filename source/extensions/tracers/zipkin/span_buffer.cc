@@ -2,13 +2,13 @@
 
 #include "envoy/config/trace/v3alpha/trace.pb.h"
 
+#include "common/common/assert.h"
 #include "common/protobuf/utility.h"
 
 #include "extensions/tracers/zipkin/util.h"
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_json_field_names.h"
 
-#include "absl/strings/str_join.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -59,34 +59,33 @@ SerializerPtr SpanBuffer::makeSerializer(
   }
 }
 
-std::string JsonV1Serializer::serialize(const std::vector<Span>& zipkin_spans) {
-  const std::string serialized_elements =
-      absl::StrJoin(zipkin_spans, ",", [](std::string* element, Span zipkin_span) {
-        absl::StrAppend(element, zipkin_span.toJson());
-      });
-  return absl::StrCat("[", serialized_elements, "]");
+void JsonV1Serializer::serialize(const std::vector<Span>& zipkin_spans,
+                                 Buffer::Instance& output) {
+  output.add("[", 1);
+  for (auto it = zipkin_spans.begin(); it != zipkin_spans.end(); ++it) {
+    if (it != zipkin_spans.begin()) {
+      output.add(",", 1);
+    }
+    output.add(it->toJson());
+  }
+  output.add("]", 1);
 }
 
 JsonV2Serializer::JsonV2Serializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
-std::string JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans) {
-  const std::string serialized_elements =
-      absl::StrJoin(zipkin_spans, ",", [this](std::string* out, const Span& zipkin_span) {
-        absl::StrAppend(
-            out, absl::StrJoin(toListOfSpans(zipkin_span), ",",
-                               [](std::string* element, const ProtobufWkt::Struct& span) {
-                                 absl::StrAppend(element, MessageUtil::getJsonStringFromMessage(
-                                                              span, false, true));
-                               }));
-      });
-  return absl::StrCat("[", serialized_elements, "]");
+void JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans,
+                                 Buffer::Instance& output) {
+  output.add("[", 1);
+  bool first = true;
+  for (const Span& zipkin_span : zipkin_spans) {
+    addSpans(zipkin_span, output, first);
+  }
+  output.add("]", 1);
 }
 
-const std::vector<ProtobufWkt::Struct>
-JsonV2Serializer::toListOfSpans(const Span& zipkin_span) const {
-  std::vector<ProtobufWkt::Struct> spans;
-  spans.reserve(zipkin_span.annotations().size());
+void JsonV2Serializer::addSpans(const Span& zipkin_span, Buffer::Instance& output,
+                                bool& first) const {
   for (const auto& annotation : zipkin_span.annotations()) {
     ProtobufWkt::Struct span;
     auto* fields = span.mutable_fields();
@@ -134,9 +133,12 @@ JsonV2Serializer::toListOfSpans(const Span& zipkin_span) const {
       (*fields)[SPAN_TAGS] = ValueUtil::structValue(tags);
     }
 
-    spans.push_back(std::move(span));
+    if (!first) {
+      output.add(",", 1);
+    }
+    first = false;
+    output.add(MessageUtil::getJsonStringFromMessage(span, false, true));
   }
-  return spans;
 }
 
 const ProtobufWkt::Struct JsonV2Serializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
@@ -164,32 +166,47 @@ const ProtobufWkt::Struct JsonV2Serializer::toProtoEndpoint(const Endpoint& zipk
 ProtobufSerializer::ProtobufSerializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
-std::string ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans) {
+void ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans,
+                                   Buffer::Instance& output) {
   zipkin::proto3::ListOfSpans spans;
   for (const Span& zipkin_span : zipkin_spans) {
-    spans.MergeFrom(toListOfSpans(zipkin_span));
+    addSpans(zipkin_span, spans);
+  }
+
+  // Serialize directly into the output, without an intermediate string.
+  const uint32_t size = spans.ByteSizeLong();
+  if (size == 0) {
+    return;
   }
-  std::string serialized;
-  spans.SerializeToString(&serialized);
-  return serialized;
+  Buffer::RawSlice iovec;
+  output.reserve(size, &iovec, 1);
+  ASSERT(iovec.len_ >= size);
+  iovec.len_ = size;
+  spans.SerializeWithCachedSizesToArray(static_cast<uint8_t*>(iovec.mem_));
+  output.commit(&iovec, 1);
 }
 
-const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span& zipkin_span) const {
-  zipkin::proto3::ListOfSpans spans;
+void ProtobufSerializer::addSpans(const Span& zipkin_span,
+                                  zipkin::proto3::ListOfSpans& spans) const {
   for (const auto& annotation : zipkin_span.annotations()) {
-    zipkin::proto3::Span span;
+    zipkin::proto3::Span::Kind kind;
     if (annotation.value() == CLIENT_SEND) {
-      span.set_kind(zipkin::proto3::Span::CLIENT);
+      kind = zipkin::proto3::Span::CLIENT;
     } else if (annotation.value() == SERVER_RECV) {
-      span.set_shared(shared_span_context_ && zipkin_span.annotations().size() > 1);
-      span.set_kind(zipkin::proto3::Span::SERVER);
+      kind = zipkin::proto3::Span::SERVER;
     } else {
       continue;
     }
 
+    zipkin::proto3::Span& span = *spans.add_spans();
+    span.set_kind(kind);
+    if (kind == zipkin::proto3::Span::SERVER) {
+      span.set_shared(shared_span_context_ && zipkin_span.annotations().size() > 1);
+    }
+
     if (annotation.isSetEndpoint()) {
       span.set_timestamp(annotation.timestamp());
-      span.mutable_local_endpoint()->MergeFrom(toProtoEndpoint(annotation.endpoint()));
+      toProtoEndpoint(annotation.endpoint(), *span.mutable_local_endpoint());
     }
 
     span.set_trace_id(zipkin_span.traceIdAsByteString());
@@ -208,16 +225,11 @@ const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span&
     for (const auto& binary_annotation : zipkin_span.binaryAnnotations()) {
       tags[binary_annotation.key()] = binary_annotation.value();
     }
-
-    auto* mutable_span = spans.add_spans();
-    mutable_span->MergeFrom(span);
   }
-  return spans;
 }
 
-const zipkin::proto3::Endpoint
-ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
-  zipkin::proto3::Endpoint endpoint;
+void ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint,
+                                         zipkin::proto3::Endpoint& endpoint) const {
   Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
   if (address) {
     if (address->ip()->version() == Network::Address::IpVersion::v4) {
@@ -232,8 +244,6 @@ ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
   if (!service_name.empty()) {
     endpoint.set_service_name(service_name);
   }
-
-  return endpoint;
 }
 
 } // namespace Zipkin
@@ -2,6 +2,7 @@
 
 #include "envoy/config/trace/v3alpha/trace.pb.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/protobuf/protobuf.h"
 
 #include "extensions/tracers/zipkin/tracer_interface.h"
@@ -72,14 +73,22 @@ public:
   uint64_t pendingSpans() { return span_buffer_.size(); }
 
   /**
-   * Serializes std::vector<Span> span_buffer_ to std::string as payload for the reporter when the
-   * reporter does spans flushing. This function does only serialization and does not clear
-   * span_buffer_.
+   * Serializes std::vector<Span> span_buffer_ into the payload of the reporter when the reporter
+   * does spans flushing. This function does only serialization and does not clear span_buffer_.
    *
+   * @param output the buffer the collection of serialized pending Zipkin spans is appended to.
+   */
+  void serialize(Buffer::Instance& output) const { serializer_->serialize(span_buffer_, output); }
+
+  /**
    * @return std::string the contents of the buffer, a collection of serialized pending Zipkin
    * spans.
    */
-  std::string serialize() const { return serializer_->serialize(span_buffer_); }
+  std::string serialize() const {
+    Buffer::OwnedImpl output;
+    serialize(output);
+    return output.toString();
+  }
 
 private:
   SerializerPtr makeSerializer(
@@ -103,9 +112,8 @@ public:
 
   /**
    * Serialize list of Zipkin spans into Zipkin v1 JSON array.
-   * @return std::string serialized pending spans as Zipkin v1 JSON array.
    */
-  std::string serialize(const std::vector<Span>& pending_spans) override;
+  void serialize(const std::vector<Span>& pending_spans, Buffer::Instance& output) override;
 };
 
 /**
@@ -118,12 +126,11 @@ public:
 
   /**
    * Serialize list of Zipkin spans into Zipkin v2 JSON array.
-   * @return std::string serialized pending spans as Zipkin v2 JSON array.
    */
-  std::string serialize(const std::vector<Span>& pending_spans) override;
+  void serialize(const std::vector<Span>& pending_spans, Buffer::Instance& output) override;
 
 private:
-  const std::vector<ProtobufWkt::Struct> toListOfSpans(const Span& zipkin_span) const;
+  void addSpans(const Span& zipkin_span, Buffer::Instance& output, bool& first) const;
   const ProtobufWkt::Struct toProtoEndpoint(const Endpoint& zipkin_endpoint) const;
 
   const bool shared_span_context_;
@@ -139,13 +146,12 @@ public:
 
   /**
    * Serialize list of Zipkin spans into Zipkin v2 zipkin::proto3::ListOfSpans.
-   * @return std::string serialized pending spans as Zipkin zipkin::proto3::ListOfSpans.
    */
-  std::string serialize(const std::vector<Span>& pending_spans) override;
+  void serialize(const std::vector<Span>& pending_spans, Buffer::Instance& output) override;
 
 private:
-  const zipkin::proto3::ListOfSpans toListOfSpans(const Span& zipkin_span) const;
-  const zipkin::proto3::Endpoint toProtoEndpoint(const Endpoint& zipkin_endpoint) const;
+  void addSpans(const Span& zipkin_span, zipkin::proto3::ListOfSpans& spans) const;
+  void toProtoEndpoint(const Endpoint& zipkin_endpoint, zipkin::proto3::Endpoint& endpoint) const;
 
   const bool shared_span_context_;
 };
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 
 namespace Envoy {
@@ -45,9 +46,10 @@ public:
   /**
    * Serialize buffered pending spans.
    *
-   * @return std::string serialized buffered pending spans.
+   * @param spans the buffered pending spans.
+   * @param output the buffer the serialized spans are appended to.
    */
-  virtual std::string serialize(const std::vector<Span>& spans) PURE;
+  virtual void serialize(const std::vector<Span>& spans, Buffer::Instance& output) PURE;
 };
 
 using SerializerPtr = std::unique_ptr<Serializer>;
@@ -20,6 +20,12 @@ namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
+namespace {
+// The window bits of the compressor, 15 with the flag for a gzip header and trailer.
+constexpr int64_t GzipWindowBits = 15 | 16;
+constexpr uint64_t GzipMemoryLevel = 8;
+} // namespace
+
 ZipkinSpan::ZipkinSpan(Zipkin::Span& span, Zipkin::Tracer& tracer) : span_(span), tracer_(tracer) {}
 
 void ZipkinSpan::finishSpan() { span_.finish(); }
@@ -88,6 +94,7 @@ Driver::Driver(const envoy::config::trace::v3alpha::ZipkinConfig& zipkin_config,
   const bool shared_span_context = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       zipkin_config, shared_span_context, DEFAULT_SHARED_SPAN_CONTEXT);
   collector.shared_span_context_ = shared_span_context;
+  collector.gzip_compression_ = zipkin_config.gzip_compression();
 
   tls_->set([this, collector, &random_generator, trace_id_128bit, shared_span_context](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
@@ -143,6 +150,13 @@ ReporterImpl::ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
       driver_.runtime().snapshot().getInteger("tracing.zipkin.min_flush_spans", 5U);
   span_buffer_->allocateBuffer(min_flush_spans);
 
+  if (collector_.gzip_compression_) {
+    compressor_ = std::make_unique<Compressor::ZlibCompressorImpl>();
+    compressor_->init(Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                      Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+                      GzipWindowBits, GzipMemoryLevel);
+  }
+
   enableTimer();
 }
 
@@ -171,7 +185,6 @@ void ReporterImpl::enableTimer() {
 void ReporterImpl::flushSpans() {
   if (span_buffer_->pendingSpans()) {
     driver_.tracerStats().spans_sent_.add(span_buffer_->pendingSpans());
-    const std::string request_body = span_buffer_->serialize();
     Http::MessagePtr message = std::make_unique<Http::RequestMessageImpl>();
     message->headers().setReferenceMethod(Http::Headers::get().MethodValues.Post);
     message->headers().setPath(collector_.endpoint_);
@@ -182,7 +195,14 @@ void ReporterImpl::flushSpans() {
             : Http::Headers::get().ContentTypeValues.Json);
 
     Buffer::InstancePtr body = std::make_unique<Buffer::OwnedImpl>();
-    body->add(request_body);
+    span_buffer_->serialize(*body);
+    if (compressor_) {
+      // The compressor is reused across reports, without allocating its state again.
+      compressor_->reset();
+      compressor_->compress(*body, Compressor::State::Finish);
+      message->headers().setReferenceContentEncoding(
+          Http::Headers::get().ContentEncodingValues.Gzip);
+    }
     message->body() = std::move(body);
 
     const uint64_t timeout =
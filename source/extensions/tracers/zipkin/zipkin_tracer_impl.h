@@ -7,6 +7,7 @@
 #include "envoy/tracing/http_tracer.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/compressor/zlib_compressor_impl.h"
 #include "common/http/header_map_impl.h"
 #include "common/json/json_loader.h"
 
@@ -72,6 +73,12 @@ public:
 
   void setSampled(bool sampled) override;
 
+  /**
+   * @return whether the wrapped Zipkin::Span is sampled, as spans that are not sampled are not
+   * reported.
+   */
+  bool isRecording() const override { return span_.sampled(); }
+
   /**
    * @return a reference to the Zipkin::Span object.
    */
@@ -154,6 +161,9 @@ struct CollectorInfo {
       envoy::config::trace::v3alpha::ZipkinConfig::hidden_envoy_deprecated_HTTP_JSON_V1};
 
   bool shared_span_context_{DEFAULT_SHARED_SPAN_CONTEXT};
+
+  // Whether the payload is gzip compressed.
+  bool gzip_compression_{false};
 };
 
 /**
@@ -169,6 +179,9 @@ struct CollectorInfo {
  * expires, whichever happens first.
  *
  * The default values for the runtime parameters are 5 spans and 5000ms.
+ *
+ * The spans are serialized directly into the body of the request, which is gzip compressed when
+ * configured, reusing the compressor of the reporter.
  */
 class ReporterImpl : public Reporter, Http::AsyncClient::Callbacks {
 public:
@@ -226,6 +239,7 @@ private:
   Event::TimerPtr flush_timer_;
   const CollectorInfo collector_;
   SpanBufferPtr span_buffer_;
+  std::unique_ptr<Compressor::ZlibCompressorImpl> compressor_;
 };
 } // namespace Zipkin
 } // namespace Tracers
@@ -126,7 +126,11 @@ Network::TransportSocketFactoryPtr createTransportSocketFactoryHelper(
     return std::make_unique<TsiHandshaker>(std::move(handshaker_ptr), dispatcher);
   };
 
-  return std::make_unique<TsiSocketFactory>(factory, validator);
+  absl::optional<uint32_t> max_frame_size;
+  if (config.has_max_frame_size()) {
+    max_frame_size = config.max_frame_size().value();
+  }
+  return std::make_unique<TsiSocketFactory>(factory, validator, max_frame_size);
 }
 
 } // namespace
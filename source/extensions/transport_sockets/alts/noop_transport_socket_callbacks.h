@@ -27,6 +27,7 @@ public:
    */
   void setReadBufferReady() override {}
   void raiseEvent(Network::ConnectionEvent) override {}
+  void recordReadsPerEvent(uint32_t num_reads) override { parent_.recordReadsPerEvent(num_reads); }
 
 private:
   Network::TransportSocketCallbacks& parent_;
@@ -1,6 +1,7 @@
 #include "extensions/transport_sockets/alts/tsi_frame_protector.h"
 
 #include "common/common/assert.h"
+#include "common/common/stack_array.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -16,33 +17,50 @@ TsiFrameProtector::TsiFrameProtector(CFrameProtectorPtr&& frame_protector)
 tsi_result TsiFrameProtector::protect(Buffer::Instance& input, Buffer::Instance& output) {
   ASSERT(frame_protector_);
 
-  unsigned char protected_buffer[BUFFER_SIZE];
-  while (input.length() > 0) {
-    auto* message_bytes = reinterpret_cast<unsigned char*>(input.linearize(input.length()));
-    size_t protected_buffer_size = BUFFER_SIZE;
-    size_t processed_message_size = input.length();
-    tsi_result result =
-        tsi_frame_protector_protect(frame_protector_.get(), message_bytes, &processed_message_size,
-                                    protected_buffer, &protected_buffer_size);
-    if (result != TSI_OK) {
-      ASSERT(result != TSI_INVALID_ARGUMENT && result != TSI_UNIMPLEMENTED);
-      return result;
+  // The input is protected slice by slice rather than linearized first, and the protected frames
+  // are written directly into space reserved in the output.
+  const uint64_t num_slices = input.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  input.getRawSlices(slices.begin(), num_slices);
+  uint64_t processed_size = 0;
+  for (const Buffer::RawSlice& slice : slices) {
+    auto* message_bytes = static_cast<unsigned char*>(slice.mem_);
+    size_t remaining_size = slice.len_;
+    while (remaining_size > 0) {
+      Buffer::RawSlice protected_slice;
+      output.reserve(BUFFER_SIZE, &protected_slice, 1);
+      size_t protected_buffer_size = protected_slice.len_;
+      size_t processed_message_size = remaining_size;
+      tsi_result result = tsi_frame_protector_protect(
+          frame_protector_.get(), message_bytes, &processed_message_size,
+          static_cast<unsigned char*>(protected_slice.mem_), &protected_buffer_size);
+      if (result != TSI_OK) {
+        ASSERT(result != TSI_INVALID_ARGUMENT && result != TSI_UNIMPLEMENTED);
+        input.drain(processed_size);
+        return result;
+      }
+      commit(output, protected_slice, protected_buffer_size);
+      message_bytes += processed_message_size;
+      remaining_size -= processed_message_size;
+      processed_size += processed_message_size;
     }
-    output.add(protected_buffer, protected_buffer_size);
-    input.drain(processed_message_size);
   }
+  input.drain(processed_size);
 
-  // TSI may buffer some of the input internally. Flush its buffer to protected_buffer.
+  // TSI may buffer some of the input internally. Flush its buffer to the output.
   size_t still_pending_size;
   do {
-    size_t protected_buffer_size = BUFFER_SIZE;
+    Buffer::RawSlice protected_slice;
+    output.reserve(BUFFER_SIZE, &protected_slice, 1);
+    size_t protected_buffer_size = protected_slice.len_;
     tsi_result result = tsi_frame_protector_protect_flush(
-        frame_protector_.get(), protected_buffer, &protected_buffer_size, &still_pending_size);
+        frame_protector_.get(), static_cast<unsigned char*>(protected_slice.mem_),
+        &protected_buffer_size, &still_pending_size);
     if (result != TSI_OK) {
       ASSERT(result != TSI_INVALID_ARGUMENT && result != TSI_UNIMPLEMENTED);
       return result;
     }
-    output.add(protected_buffer, protected_buffer_size);
+    commit(output, protected_slice, protected_buffer_size);
   } while (still_pending_size > 0);
 
   return TSI_OK;
@@ -51,26 +69,67 @@ tsi_result TsiFrameProtector::protect(Buffer::Instance& input, Buffer::Instance&
 tsi_result TsiFrameProtector::unprotect(Buffer::Instance& input, Buffer::Instance& output) {
   ASSERT(frame_protector_);
 
-  unsigned char unprotected_buffer[BUFFER_SIZE];
+  const uint64_t num_slices = input.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  input.getRawSlices(slices.begin(), num_slices);
+  uint64_t processed_size = 0;
+  bool output_full = false;
+  for (const Buffer::RawSlice& slice : slices) {
+    auto* message_bytes = static_cast<unsigned char*>(slice.mem_);
+    size_t remaining_size = slice.len_;
+    while (remaining_size > 0) {
+      size_t processed_message_size = remaining_size;
+      tsi_result result = unprotectInto(message_bytes, processed_message_size, output, output_full);
+      if (result != TSI_OK) {
+        input.drain(processed_size);
+        return result;
+      }
+      message_bytes += processed_message_size;
+      remaining_size -= processed_message_size;
+      processed_size += processed_message_size;
+    }
+  }
+  input.drain(processed_size);
 
-  while (input.length() > 0) {
-    auto* message_bytes = reinterpret_cast<unsigned char*>(input.linearize(input.length()));
-    size_t unprotected_buffer_size = BUFFER_SIZE;
-    size_t processed_message_size = input.length();
-    tsi_result result = tsi_frame_protector_unprotect(frame_protector_.get(), message_bytes,
-                                                      &processed_message_size, unprotected_buffer,
-                                                      &unprotected_buffer_size);
+  // The data of a frame larger than the space reserved for it is handed out over several calls,
+  // which take no more input once the whole frame has been read.
+  while (output_full) {
+    unsigned char no_input;
+    size_t processed_message_size = 0;
+    tsi_result result = unprotectInto(&no_input, processed_message_size, output, output_full);
     if (result != TSI_OK) {
-      ASSERT(result != TSI_INVALID_ARGUMENT && result != TSI_UNIMPLEMENTED);
       return result;
     }
-    output.add(unprotected_buffer, unprotected_buffer_size);
-    input.drain(processed_message_size);
   }
 
   return TSI_OK;
 }
 
+tsi_result TsiFrameProtector::unprotectInto(const unsigned char* message_bytes,
+                                            size_t& processed_message_size,
+                                            Buffer::Instance& output, bool& output_full) {
+  Buffer::RawSlice unprotected_slice;
+  output.reserve(BUFFER_SIZE, &unprotected_slice, 1);
+  size_t unprotected_buffer_size = unprotected_slice.len_;
+  tsi_result result = tsi_frame_protector_unprotect(
+      frame_protector_.get(), message_bytes, &processed_message_size,
+      static_cast<unsigned char*>(unprotected_slice.mem_), &unprotected_buffer_size);
+  if (result != TSI_OK) {
+    ASSERT(result != TSI_INVALID_ARGUMENT && result != TSI_UNIMPLEMENTED);
+    return result;
+  }
+  output_full = unprotected_buffer_size == unprotected_slice.len_;
+  commit(output, unprotected_slice, unprotected_buffer_size);
+  return TSI_OK;
+}
+
+void TsiFrameProtector::commit(Buffer::Instance& output, Buffer::RawSlice& slice, size_t size) {
+  if (size > 0) {
+    slice.len_ = size;
+    output.commit(&slice, 1);
+  }
+}
+
 } // namespace Alts
 } // namespace TransportSockets
 } // namespace Extensions
@@ -38,6 +38,13 @@ public:
   tsi_result unprotect(Buffer::Instance& input, Buffer::Instance& output);
 
 private:
+  // Unprotects the given input into space reserved in the output, recording whether the data
+  // unprotected filled the whole reservation.
+  tsi_result unprotectInto(const unsigned char* message_bytes, size_t& processed_message_size,
+                           Buffer::Instance& output, bool& output_full);
+  // Commits the given size of a slice reserved in the output, if it isn't empty.
+  static void commit(Buffer::Instance& output, Buffer::RawSlice& slice, size_t size);
+
   CFrameProtectorPtr frame_protector_;
 };
 
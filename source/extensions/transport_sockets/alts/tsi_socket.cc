@@ -11,12 +11,14 @@ namespace TransportSockets {
 namespace Alts {
 
 TsiSocket::TsiSocket(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator,
+                     absl::optional<uint32_t> max_frame_size,
                      Network::TransportSocketPtr&& raw_socket)
     : handshaker_factory_(handshaker_factory), handshake_validator_(handshake_validator),
-      raw_buffer_socket_(std::move(raw_socket)) {}
+      max_frame_size_(max_frame_size), raw_buffer_socket_(std::move(raw_socket)) {}
 
-TsiSocket::TsiSocket(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator)
-    : TsiSocket(handshaker_factory, handshake_validator,
+TsiSocket::TsiSocket(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator,
+                     absl::optional<uint32_t> max_frame_size)
+    : TsiSocket(handshaker_factory, handshake_validator, max_frame_size,
                 std::make_unique<Network::RawBufferSocket>()) {}
 
 TsiSocket::~TsiSocket() { ASSERT(!handshaker_); }
@@ -132,8 +134,10 @@ Network::PostIoAction TsiSocket::doHandshakeNextDone(NextResultPtr&& next_result
 
     // returns TSI_OK assuming there is no fatal error. Asserting OK.
     tsi_frame_protector* frame_protector;
-    status =
-        tsi_handshaker_result_create_frame_protector(handshaker_result, nullptr, &frame_protector);
+    size_t max_frame_size = max_frame_size_.value_or(0);
+    status = tsi_handshaker_result_create_frame_protector(
+        handshaker_result, max_frame_size_.has_value() ? &max_frame_size : nullptr,
+        &frame_protector);
     ASSERT(status == TSI_OK);
     frame_protector_ = std::make_unique<TsiFrameProtector>(frame_protector);
 
@@ -249,15 +253,16 @@ void TsiSocket::onNextDone(NextResultPtr&& result) {
 }
 
 TsiSocketFactory::TsiSocketFactory(HandshakerFactory handshaker_factory,
-                                   HandshakeValidator handshake_validator)
+                                   HandshakeValidator handshake_validator,
+                                   absl::optional<uint32_t> max_frame_size)
     : handshaker_factory_(std::move(handshaker_factory)),
-      handshake_validator_(std::move(handshake_validator)) {}
+      handshake_validator_(std::move(handshake_validator)), max_frame_size_(max_frame_size) {}
 
 bool TsiSocketFactory::implementsSecureTransport() const { return true; }
 
 Network::TransportSocketPtr
 TsiSocketFactory::createTransportSocket(Network::TransportSocketOptionsSharedPtr) const {
-  return std::make_unique<TsiSocket>(handshaker_factory_, handshake_validator_);
+  return std::make_unique<TsiSocket>(handshaker_factory_, handshake_validator_, max_frame_size_);
 }
 
 } // namespace Alts
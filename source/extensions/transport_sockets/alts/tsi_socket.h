@@ -9,6 +9,8 @@
 #include "extensions/transport_sockets/alts/tsi_frame_protector.h"
 #include "extensions/transport_sockets/alts/tsi_handshaker.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -42,15 +44,18 @@ class TsiSocket : public Network::TransportSocket,
 public:
   // For Test
   TsiSocket(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator,
-            Network::TransportSocketPtr&& raw_socket_ptr);
+            absl::optional<uint32_t> max_frame_size, Network::TransportSocketPtr&& raw_socket_ptr);
 
   /**
    * @param handshaker_factory a function to initiate a TsiHandshaker
    * @param handshake_validator a function to validate the peer. Called right
    * after the handshake completed with peer data to do the peer validation.
    * The connection will be closed immediately if it returns false.
+   * @param max_frame_size the maximum size of the protected frames sent, or absl::nullopt for the
+   * default size of the TSI implementation.
    */
-  TsiSocket(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator);
+  TsiSocket(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator,
+            absl::optional<uint32_t> max_frame_size);
   ~TsiSocket() override;
 
   // Network::TransportSocket
@@ -74,6 +79,7 @@ private:
 
   HandshakerFactory handshaker_factory_;
   HandshakeValidator handshake_validator_;
+  const absl::optional<uint32_t> max_frame_size_;
   TsiHandshakerPtr handshaker_{};
   bool handshaker_next_calling_{};
 
@@ -95,7 +101,8 @@ private:
  */
 class TsiSocketFactory : public Network::TransportSocketFactory {
 public:
-  TsiSocketFactory(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator);
+  TsiSocketFactory(HandshakerFactory handshaker_factory, HandshakeValidator handshake_validator,
+                   absl::optional<uint32_t> max_frame_size);
 
   bool implementsSecureTransport() const override;
   Network::TransportSocketPtr
@@ -104,6 +111,7 @@ public:
 private:
   HandshakerFactory handshaker_factory_;
   HandshakeValidator handshake_validator_;
+  const absl::optional<uint32_t> max_frame_size_;
 };
 
 } // namespace Alts
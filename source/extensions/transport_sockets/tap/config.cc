@@ -8,6 +8,7 @@
 #include "common/config/utility.h"
 #include "common/protobuf/utility.h"
 
+#include "extensions/transport_sockets/tap/pcapng_sink.h"
 #include "extensions/transport_sockets/tap/tap.h"
 #include "extensions/transport_sockets/tap/tap_config_impl.h"
 
@@ -18,18 +19,25 @@ namespace Tap {
 
 class SocketTapConfigFactoryImpl : public Extensions::Common::Tap::TapConfigFactory {
 public:
-  SocketTapConfigFactoryImpl(TimeSource& time_source) : time_source_(time_source) {}
+  SocketTapConfigFactoryImpl(TimeSource& time_source, Thread::ThreadFactory& thread_factory)
+      : time_source_(time_source), thread_factory_(thread_factory) {}
 
   // TapConfigFactory
   Extensions::Common::Tap::TapConfigSharedPtr
   createConfigFromProto(envoy::config::tap::v3alpha::TapConfig&& proto_config,
                         Extensions::Common::Tap::Sink* admin_streamer) override {
+    Extensions::Common::Tap::SinkPtr pcapng_sink;
+    if (proto_config.output_config().sinks()[0].has_pcapng()) {
+      pcapng_sink = std::make_unique<PcapngSink>(proto_config.output_config().sinks()[0].pcapng(),
+                                                 thread_factory_);
+    }
     return std::make_shared<SocketTapConfigImpl>(std::move(proto_config), admin_streamer,
-                                                 time_source_);
+                                                 std::move(pcapng_sink), time_source_);
   }
 
 private:
   TimeSource& time_source_;
+  Thread::ThreadFactory& thread_factory_;
 };
 
 Network::TransportSocketFactoryPtr UpstreamTapSocketConfigFactory::createTransportSocketFactory(
@@ -45,7 +53,9 @@ Network::TransportSocketFactoryPtr UpstreamTapSocketConfigFactory::createTranspo
   auto inner_transport_factory =
       inner_config_factory.createTransportSocketFactory(*inner_factory_config, context);
   return std::make_unique<TapSocketFactory>(
-      outer_config, std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource()),
+      outer_config,
+      std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource(),
+                                                   context.api().threadFactory()),
       context.admin(), context.singletonManager(), context.threadLocal(), context.dispatcher(),
       std::move(inner_transport_factory));
 }
@@ -64,7 +74,9 @@ Network::TransportSocketFactoryPtr DownstreamTapSocketConfigFactory::createTrans
   auto inner_transport_factory = inner_config_factory.createTransportSocketFactory(
       *inner_factory_config, context, server_names);
   return std::make_unique<TapSocketFactory>(
-      outer_config, std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource()),
+      outer_config,
+      std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource(),
+                                                   context.api().threadFactory()),
       context.admin(), context.singletonManager(), context.threadLocal(), context.dispatcher(),
       std::move(inner_transport_factory));
 }
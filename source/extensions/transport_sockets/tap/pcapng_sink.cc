@@ -0,0 +1,315 @@
+#include "extensions/transport_sockets/tap/pcapng_sink.h"
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+
+#include "envoy/config/core/v3alpha/address.pb.h"
+#include "envoy/data/tap/v3alpha/common.pb.h"
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tap {
+
+namespace {
+
+// See https://github.com/pcapng/pcapng for the format of the blocks.
+constexpr uint32_t SectionHeaderBlockType = 0x0A0D0D0A;
+constexpr uint32_t InterfaceDescriptionBlockType = 0x00000001;
+constexpr uint32_t EnhancedPacketBlockType = 0x00000006;
+constexpr uint32_t ByteOrderMagic = 0x1A2B3C4D;
+// The packets start with their IPv4 or IPv6 header, without a link layer header.
+constexpr uint16_t LinkTypeRaw = 101;
+
+constexpr uint32_t Ipv4HeaderSize = 20;
+constexpr uint32_t Ipv6HeaderSize = 40;
+constexpr uint32_t TcpHeaderSize = 20;
+constexpr uint8_t IpProtocolTcp = 6;
+constexpr uint8_t TcpFlagFin = 0x01;
+constexpr uint8_t TcpFlagPsh = 0x08;
+constexpr uint8_t TcpFlagAck = 0x10;
+// Reads and writes larger than this are split in several packets, so that the IP lengths fit in
+// 16 bits.
+constexpr uint32_t MaxSegmentSize = 65535 - Ipv4HeaderSize - TcpHeaderSize;
+
+// The fields of the blocks are written in the byte order of the host, which readers find from the
+// byte order magic of the section header. The fields of the IP and TCP headers are in network
+// order.
+template <typename T> void appendHostOrder(T value, std::string& output) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendNetworkOrder16(uint16_t value, std::string& output) {
+  appendHostOrder<uint16_t>(htons(value), output);
+}
+
+void appendNetworkOrder32(uint32_t value, std::string& output) {
+  appendHostOrder<uint32_t>(htonl(value), output);
+}
+
+void appendPadding(std::string& output) { output.append((4 - output.size() % 4) % 4, '\0'); }
+
+uint16_t ipv4HeaderChecksum(absl::string_view header) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < header.size(); i += 2) {
+    sum += (static_cast<uint8_t>(header[i]) << 8) | static_cast<uint8_t>(header[i + 1]);
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(~sum);
+}
+
+absl::string_view bodyData(const envoy::data::tap::v3alpha::Body& body) {
+  return body.body_type_case() == envoy::data::tap::v3alpha::Body::kAsString ? body.as_string()
+                                                                            : body.as_bytes();
+}
+
+// Parses an IP address to its 4 or 16 bytes in network order. Addresses which are not IP, such as
+// pipes, are written as 0.0.0.0.
+std::string ipBytes(const envoy::config::core::v3alpha::Address& address) {
+  const std::string& ip = address.socket_address().address();
+  char bytes[16];
+  if (inet_pton(AF_INET, ip.c_str(), bytes) == 1) {
+    return std::string(bytes, 4);
+  }
+  if (inet_pton(AF_INET6, ip.c_str(), bytes) == 1) {
+    return std::string(bytes, 16);
+  }
+  return std::string(4, '\0');
+}
+
+// Maps an IPv4 address to an IPv6 address, for connections mixing both.
+std::string toIpv6Bytes(const std::string& ip) {
+  if (ip.size() == 16) {
+    return ip;
+  }
+  return std::string(10, '\0') + std::string(2, '\xff') + ip;
+}
+
+} // namespace
+
+void PcapngWriter::writeHeader(std::string& output) const {
+  // Section header block, without options and of unspecified length.
+  appendHostOrder<uint32_t>(SectionHeaderBlockType, output);
+  appendHostOrder<uint32_t>(28, output);
+  appendHostOrder<uint32_t>(ByteOrderMagic, output);
+  appendHostOrder<uint16_t>(1, output);
+  appendHostOrder<uint16_t>(0, output);
+  appendHostOrder<int64_t>(-1, output);
+  appendHostOrder<uint32_t>(28, output);
+
+  // Interface description block, without options so that timestamps are in microseconds.
+  appendHostOrder<uint32_t>(InterfaceDescriptionBlockType, output);
+  appendHostOrder<uint32_t>(20, output);
+  appendHostOrder<uint16_t>(LinkTypeRaw, output);
+  appendHostOrder<uint16_t>(0, output);
+  appendHostOrder<uint32_t>(snaplen_, output);
+  appendHostOrder<uint32_t>(20, output);
+}
+
+PcapngWriter::ConnectionState
+PcapngWriter::connectionState(const envoy::data::tap::v3alpha::Connection& connection) {
+  ConnectionState state;
+  state.local_ip_ = ipBytes(connection.local_address());
+  state.remote_ip_ = ipBytes(connection.remote_address());
+  if (state.local_ip_.size() != state.remote_ip_.size()) {
+    state.local_ip_ = toIpv6Bytes(state.local_ip_);
+    state.remote_ip_ = toIpv6Bytes(state.remote_ip_);
+  }
+  state.ipv4_ = state.local_ip_.size() == 4;
+  state.local_port_ = connection.local_address().socket_address().port_value();
+  state.remote_port_ = connection.remote_address().socket_address().port_value();
+  return state;
+}
+
+void PcapngWriter::writeTrace(const envoy::data::tap::v3alpha::TraceWrapper& trace,
+                              std::string& output) {
+  switch (trace.trace_case()) {
+  case envoy::data::tap::v3alpha::TraceWrapper::TraceCase::kSocketBufferedTrace: {
+    const auto& buffered_trace = trace.socket_buffered_trace();
+    ConnectionState state = connectionState(buffered_trace.connection());
+    for (const auto& event : buffered_trace.events()) {
+      writeEvent(state, event, output);
+    }
+    break;
+  }
+  case envoy::data::tap::v3alpha::TraceWrapper::TraceCase::kSocketStreamedTraceSegment: {
+    const auto& segment = trace.socket_streamed_trace_segment();
+    if (segment.has_connection()) {
+      connections_[segment.trace_id()] = connectionState(segment.connection());
+    } else if (segment.has_event()) {
+      if (segment.event().has_closed()) {
+        connections_.erase(segment.trace_id());
+      } else {
+        writeEvent(connections_[segment.trace_id()], segment.event(), output);
+      }
+    }
+    break;
+  }
+  default:
+    // Only the socket traces are converted to packets.
+    break;
+  }
+}
+
+void PcapngWriter::writeEvent(ConnectionState& state,
+                              const envoy::data::tap::v3alpha::SocketEvent& event,
+                              std::string& output) const {
+  const uint64_t timestamp_us =
+      Protobuf::util::TimeUtil::TimestampToMicroseconds(event.timestamp());
+  if (event.has_read()) {
+    absl::string_view data = bodyData(event.read().data());
+    while (!data.empty()) {
+      const absl::string_view payload = data.substr(0, MaxSegmentSize);
+      writePacket(state, false, state.remote_seq_, state.local_seq_, false, payload, timestamp_us,
+                  output);
+      state.remote_seq_ += payload.size();
+      data.remove_prefix(payload.size());
+    }
+  } else if (event.has_write()) {
+    absl::string_view data = bodyData(event.write().data());
+    const bool end_stream = event.write().end_stream();
+    if (data.empty() && !end_stream) {
+      return;
+    }
+    do {
+      const absl::string_view payload = data.substr(0, MaxSegmentSize);
+      data.remove_prefix(payload.size());
+      const bool fin = end_stream && data.empty();
+      writePacket(state, true, state.local_seq_, state.remote_seq_, fin, payload, timestamp_us,
+                  output);
+      // The FIN takes a sequence number.
+      state.local_seq_ += payload.size() + (fin ? 1 : 0);
+    } while (!data.empty());
+  }
+}
+
+void PcapngWriter::writePacket(const ConnectionState& state, bool from_local, uint32_t seq,
+                               uint32_t ack, bool fin, absl::string_view payload,
+                               uint64_t timestamp_us, std::string& output) const {
+  const std::string& source_ip = from_local ? state.local_ip_ : state.remote_ip_;
+  const std::string& destination_ip = from_local ? state.remote_ip_ : state.local_ip_;
+  const uint32_t ip_header_size = state.ipv4_ ? Ipv4HeaderSize : Ipv6HeaderSize;
+
+  std::string packet;
+  packet.reserve(ip_header_size + TcpHeaderSize + payload.size());
+  if (state.ipv4_) {
+    packet.push_back(0x45); // Version 4, header of 5 words.
+    packet.push_back(0);
+    appendNetworkOrder16(static_cast<uint16_t>(Ipv4HeaderSize + TcpHeaderSize + payload.size()),
+                         packet);
+    appendNetworkOrder16(0, packet); // Identification.
+    appendNetworkOrder16(0x4000, packet); // Don't fragment.
+    packet.push_back(64); // TTL.
+    packet.push_back(IpProtocolTcp);
+    appendNetworkOrder16(0, packet); // Checksum, filled once the header is complete.
+    packet.append(source_ip);
+    packet.append(destination_ip);
+    const uint16_t checksum = ipv4HeaderChecksum(packet);
+    packet[10] = static_cast<char>(checksum >> 8);
+    packet[11] = static_cast<char>(checksum & 0xff);
+  } else {
+    appendNetworkOrder32(0x60000000, packet); // Version 6, no traffic class nor flow label.
+    appendNetworkOrder16(static_cast<uint16_t>(TcpHeaderSize + payload.size()), packet);
+    packet.push_back(IpProtocolTcp);
+    packet.push_back(64); // Hop limit.
+    packet.append(source_ip);
+    packet.append(destination_ip);
+  }
+
+  // The TCP checksum is left to 0, which readers do not verify by default.
+  appendNetworkOrder16(from_local ? state.local_port_ : state.remote_port_, packet);
+  appendNetworkOrder16(from_local ? state.remote_port_ : state.local_port_, packet);
+  appendNetworkOrder32(seq, packet);
+  appendNetworkOrder32(ack, packet);
+  packet.push_back(static_cast<char>((TcpHeaderSize / 4) << 4));
+  packet.push_back(static_cast<char>(TcpFlagAck | TcpFlagPsh | (fin ? TcpFlagFin : 0)));
+  appendNetworkOrder16(65535, packet); // Window.
+  appendNetworkOrder16(0, packet);     // Checksum.
+  appendNetworkOrder16(0, packet);     // Urgent pointer.
+  packet.append(payload.data(), payload.size());
+
+  // Enhanced packet block, holding at most snaplen bytes of the packet.
+  const uint32_t captured_size = std::min<uint32_t>(packet.size(), snaplen_);
+  const uint32_t padded_size = (captured_size + 3) & ~3;
+  const uint32_t block_size = 32 + padded_size;
+  appendHostOrder<uint32_t>(EnhancedPacketBlockType, output);
+  appendHostOrder<uint32_t>(block_size, output);
+  appendHostOrder<uint32_t>(0, output); // Interface ID.
+  appendHostOrder<uint32_t>(timestamp_us >> 32, output);
+  appendHostOrder<uint32_t>(timestamp_us & 0xffffffff, output);
+  appendHostOrder<uint32_t>(captured_size, output);
+  appendHostOrder<uint32_t>(packet.size(), output);
+  output.append(packet.data(), captured_size);
+  appendPadding(output);
+  appendHostOrder<uint32_t>(block_size, output);
+}
+
+PcapngSink::PcapngSink(const envoy::config::tap::v3alpha::PcapngSink& config,
+                       Thread::ThreadFactory& thread_factory)
+    : writer_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, snaplen, 65535)) {
+  ENVOY_LOG(debug, "Opening pcap-ng tap file {}", config.path());
+  // When reading and writing binary files, we need to be sure std::ios_base::binary
+  // is set, otherwise we will not get the expected results on Windows
+  output_file_.open(config.path(), std::ios_base::binary);
+  std::string header;
+  writer_.writeHeader(header);
+  output_file_ << header;
+  write_thread_ = thread_factory.createThread([this]() -> void { writeThreadRoutine(); });
+}
+
+PcapngSink::~PcapngSink() {
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    queued_traces_event_.notifyOne();
+  }
+  write_thread_->join();
+}
+
+void PcapngSink::queueTrace(Extensions::Common::Tap::TraceWrapperPtr&& trace) {
+  Thread::LockGuard lock(lock_);
+  if (queued_traces_.size() >= MaxQueuedTraces) {
+    ENVOY_LOG(debug, "pcap-ng tap dropping trace, too many traces are queued");
+    return;
+  }
+  queued_traces_.push_back(std::move(trace));
+  if (queued_traces_.size() == 1) {
+    queued_traces_event_.notifyOne();
+  }
+}
+
+void PcapngSink::writeThreadRoutine() {
+  std::vector<Extensions::Common::Tap::TraceWrapperPtr> traces;
+  bool exit = false;
+  while (!exit) {
+    {
+      Thread::LockGuard lock(lock_);
+      while (queued_traces_.empty() && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        queued_traces_event_.wait(lock_);
+      }
+      // The traces queued before exiting are still written.
+      exit = exit_;
+      traces.swap(queued_traces_);
+    }
+
+    std::string output;
+    for (const auto& trace : traces) {
+      writer_.writeTrace(*trace, output);
+    }
+    traces.clear();
+    output_file_ << output;
+  }
+  output_file_.flush();
+}
+
+} // namespace Tap
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "envoy/config/tap/v3alpha/common.pb.h"
+#include "envoy/data/tap/v3alpha/transport.pb.h"
+#include "envoy/data/tap/v3alpha/wrapper.pb.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+
+#include "extensions/common/tap/tap.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tap {
+
+/**
+ * Converts socket traces to the blocks of a pcap-ng file, with one TCP packet per read and write
+ * of the tapped connections. As the packets are captured above the socket, their IP and TCP
+ * headers are synthesized from the addresses of the connections, and the sequence numbers from
+ * the bytes read and written so far.
+ */
+class PcapngWriter {
+public:
+  PcapngWriter(uint32_t snaplen) : snaplen_(snaplen) {}
+
+  /**
+   * Append the section header and the interface description blocks starting a file.
+   * @param output supplies the string to append to.
+   */
+  void writeHeader(std::string& output) const;
+
+  /**
+   * Append the packets of a buffered trace or of a streamed trace segment. The state of the
+   * connections of streamed traces is kept from their connection segment until their closed
+   * segment.
+   * @param trace supplies the socket trace.
+   * @param output supplies the string to append to.
+   */
+  void writeTrace(const envoy::data::tap::v3alpha::TraceWrapper& trace, std::string& output);
+
+private:
+  struct ConnectionState {
+    bool ipv4_{true};
+    // The addresses in network order, on 4 bytes for IPv4 and 16 bytes for IPv6.
+    std::string local_ip_{std::string(4, '\0')};
+    std::string remote_ip_{std::string(4, '\0')};
+    uint16_t local_port_{};
+    uint16_t remote_port_{};
+    // The sequence numbers of the next bytes written and read by the connection.
+    uint32_t local_seq_{1};
+    uint32_t remote_seq_{1};
+  };
+
+  static ConnectionState connectionState(const envoy::data::tap::v3alpha::Connection& connection);
+  void writeEvent(ConnectionState& state, const envoy::data::tap::v3alpha::SocketEvent& event,
+                  std::string& output) const;
+  void writePacket(const ConnectionState& state, bool from_local, uint32_t seq, uint32_t ack,
+                   bool fin, absl::string_view payload, uint64_t timestamp_us,
+                   std::string& output) const;
+
+  const uint32_t snaplen_;
+  absl::flat_hash_map<uint64_t, ConnectionState> connections_;
+};
+
+/**
+ * A tap sink that writes the traces of all the tapped connections to a single pcap-ng file. The
+ * workers only queue the traces, which are converted and written by a background thread.
+ */
+class PcapngSink : public Extensions::Common::Tap::Sink, Logger::Loggable<Logger::Id::tap> {
+public:
+  PcapngSink(const envoy::config::tap::v3alpha::PcapngSink& config,
+             Thread::ThreadFactory& thread_factory);
+  ~PcapngSink() override;
+
+  // Extensions::Common::Tap::Sink
+  Extensions::Common::Tap::PerTapSinkHandlePtr createPerTapSinkHandle(uint64_t) override {
+    return std::make_unique<PcapngSinkHandle>(*this);
+  }
+
+  // The maximum number of traces queued for the background thread. Traces submitted beyond this
+  // are dropped, so that a slow file system does not grow the memory without bound.
+  static constexpr uint32_t MaxQueuedTraces = 10000;
+
+private:
+  struct PcapngSinkHandle : public Extensions::Common::Tap::PerTapSinkHandle {
+    PcapngSinkHandle(PcapngSink& parent) : parent_(parent) {}
+
+    // Extensions::Common::Tap::PerTapSinkHandle
+    void submitTrace(Extensions::Common::Tap::TraceWrapperPtr&& trace,
+                     envoy::config::tap::v3alpha::OutputSink::Format) override {
+      parent_.queueTrace(std::move(trace));
+    }
+
+    PcapngSink& parent_;
+  };
+
+  void queueTrace(Extensions::Common::Tap::TraceWrapperPtr&& trace);
+  void writeThreadRoutine();
+
+  PcapngWriter writer_;
+  std::ofstream output_file_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar queued_traces_event_;
+  std::vector<Extensions::Common::Tap::TraceWrapperPtr> queued_traces_ ABSL_GUARDED_BY(lock_);
+  bool exit_ ABSL_GUARDED_BY(lock_){};
+  Thread::ThreadPtr write_thread_;
+};
+
+} // namespace Tap
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
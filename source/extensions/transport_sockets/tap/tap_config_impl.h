@@ -51,8 +51,10 @@ class SocketTapConfigImpl : public Extensions::Common::Tap::TapConfigBaseImpl,
                             public std::enable_shared_from_this<SocketTapConfigImpl> {
 public:
   SocketTapConfigImpl(envoy::config::tap::v3alpha::TapConfig&& proto_config,
-                      Extensions::Common::Tap::Sink* admin_streamer, TimeSource& time_system)
-      : Extensions::Common::Tap::TapConfigBaseImpl(std::move(proto_config), admin_streamer),
+                      Extensions::Common::Tap::Sink* admin_streamer,
+                      Extensions::Common::Tap::SinkPtr&& pcapng_sink, TimeSource& time_system)
+      : Extensions::Common::Tap::TapConfigBaseImpl(std::move(proto_config), admin_streamer,
+                                                   std::move(pcapng_sink)),
         time_source_(time_system) {}
 
   // SocketTapConfig
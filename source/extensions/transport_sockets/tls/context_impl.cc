@@ -50,7 +50,7 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
 } // namespace
 
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-                         TimeSource& time_source)
+                         TimeSource& time_source, TrustedCaStoreCache& trusted_ca_store_cache)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
       tls_max_version_(config.maxProtocolVersion()),
       stat_name_set_(scope.symbolTable().makeSet("TransportSockets::Tls")),
@@ -101,81 +101,21 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
   if (config.certificateValidationContext() != nullptr &&
       !config.certificateValidationContext()->caCert().empty()) {
     ca_file_path_ = config.certificateValidationContext()->caCertPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config.certificateValidationContext()->caCert().data()),
-                        config.certificateValidationContext()->caCert().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
-      throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ",
-                                        config.certificateValidationContext()->caCertPath()));
-    }
-
-    for (auto& ctx : tls_contexts_) {
-      X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      bool has_crl = false;
-      for (const X509_INFO* item : list.get()) {
-        if (item->x509) {
-          X509_STORE_add_cert(store, item->x509);
-          if (ca_cert_ == nullptr) {
-            X509_up_ref(item->x509);
-            ca_cert_.reset(item->x509);
-          }
-        }
-        if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
-          has_crl = true;
-        }
-      }
-      if (ca_cert_ == nullptr) {
-        throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ",
-                                          config.certificateValidationContext()->caCertPath()));
-      }
-      if (has_crl) {
-        X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
-      }
-      verify_mode = SSL_VERIFY_PEER;
-      verify_trusted_ca_ = true;
-
-      // NOTE: We're using SSL_CTX_set_cert_verify_callback() instead of X509_verify_cert()
-      // directly. However, our new callback is still calling X509_verify_cert() under
-      // the hood. Therefore, to ignore cert expiration, we need to set the callback
-      // for X509_verify_cert to ignore that error.
-      if (config.certificateValidationContext()->allowExpiredCertificate()) {
-        X509_STORE_set_verify_cb(store, ContextImpl::ignoreCertificateExpirationCallback);
-      }
-    }
-  }
-
-  if (config.certificateValidationContext() != nullptr &&
-      !config.certificateValidationContext()->certificateRevocationList().empty()) {
-    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(
-        const_cast<char*>(
-            config.certificateValidationContext()->certificateRevocationList().data()),
-        config.certificateValidationContext()->certificateRevocationList().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
-      throw EnvoyException(
-          absl::StrCat("Failed to load CRL from ",
-                       config.certificateValidationContext()->certificateRevocationListPath()));
-    }
+    verification_cache_ttl_ = config.certificateValidationContext()->verificationCacheTtl();
+    verification_cache_max_entries_ =
+        config.certificateValidationContext()->verificationCacheMaxEntries();
+    allow_expired_certificate_ = config.certificateValidationContext()->allowExpiredCertificate();
+    trusted_ca_store_ = trusted_ca_store_cache.getOrCreate(*config.certificateValidationContext());
+    X509_up_ref(trusted_ca_store_->ca_cert_.get());
+    ca_cert_.reset(trusted_ca_store_->ca_cert_.get());
 
     for (auto& ctx : tls_contexts_) {
-      X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      for (const X509_INFO* item : list.get()) {
-        if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
-        }
-      }
-
-      X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+      // The store is shared with the other contexts of the same validation material.
+      X509_STORE_up_ref(trusted_ca_store_->store_.get());
+      SSL_CTX_set_cert_store(ctx.ssl_ctx_.get(), trusted_ca_store_->store_.get());
     }
+    verify_mode = SSL_VERIFY_PEER;
+    verify_trusted_ca_ = true;
   }
 
   const Envoy::Ssl::CertificateValidationContextConfig* cert_validation_config =
@@ -478,17 +418,28 @@ int ContextImpl::ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* ctx
 
 int ContextImpl::verifyCallback(X509_STORE_CTX* store_ctx, void* arg) {
   ContextImpl* impl = reinterpret_cast<ContextImpl*>(arg);
+  SSL* ssl = reinterpret_cast<SSL*>(
+      X509_STORE_CTX_get_ex_data(store_ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
 
   if (impl->verify_trusted_ca_) {
-    int ret = X509_verify_cert(store_ctx);
-    if (ret <= 0) {
-      impl->stats_.fail_verify_error_.inc();
-      return ret;
+    std::string key;
+    if (impl->verification_cache_ttl_.has_value()) {
+      key = verificationCacheKey(ssl);
+    }
+    if (!key.empty() && impl->verificationCached(key)) {
+      impl->stats_.verify_cache_hit_.inc();
+    } else {
+      int ret = X509_verify_cert(store_ctx);
+      if (ret <= 0) {
+        impl->stats_.fail_verify_error_.inc();
+        return ret;
+      }
+      if (!key.empty()) {
+        impl->cacheVerification(key, store_ctx);
+      }
     }
   }
 
-  SSL* ssl = reinterpret_cast<SSL*>(
-      X509_STORE_CTX_get_ex_data(store_ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
   bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl));
 
   const Network::TransportSocketOptions* transport_socket_options =
@@ -532,6 +483,79 @@ int ContextImpl::verifyCertificate(
   return 1;
 }
 
+std::string ContextImpl::verificationCacheKey(SSL* ssl) {
+  bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl));
+  if (cert == nullptr) {
+    return "";
+  }
+  // The peer chain of a client connection starts with the peer certificate, which is then digested
+  // twice, consistently for all the connections of the context.
+  std::vector<X509*> certs{cert.get()};
+  const STACK_OF(X509)* chain = SSL_get_peer_cert_chain(ssl);
+  if (chain != nullptr) {
+    for (X509* chain_cert : chain) {
+      certs.push_back(chain_cert);
+    }
+  }
+
+  bssl::ScopedEVP_MD_CTX md;
+  int rc = EVP_DigestInit_ex(md.get(), EVP_sha256(), nullptr);
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  for (X509* chain_cert : certs) {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    unsigned digest_length;
+    rc = X509_digest(chain_cert, EVP_sha256(), digest, &digest_length);
+    RELEASE_ASSERT(rc == 1 && digest_length == SHA256_DIGEST_LENGTH,
+                   Utility::getLastCryptoError().value_or(""));
+    rc = EVP_DigestUpdate(md.get(), digest, digest_length);
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  }
+  std::string key(SHA256_DIGEST_LENGTH, '\0');
+  unsigned key_length;
+  rc = EVP_DigestFinal_ex(md.get(), reinterpret_cast<uint8_t*>(&key[0]), &key_length);
+  RELEASE_ASSERT(rc == 1 && key_length == SHA256_DIGEST_LENGTH,
+                 Utility::getLastCryptoError().value_or(""));
+  return key;
+}
+
+bool ContextImpl::verificationCached(const std::string& key) {
+  absl::MutexLock lock(&verification_cache_mu_);
+  auto it = verified_chain_index_.find(key);
+  if (it == verified_chain_index_.end()) {
+    return false;
+  }
+  if (it->second->expiry_ <= time_source_.systemTime()) {
+    verified_chains_.erase(it->second);
+    verified_chain_index_.erase(it);
+    return false;
+  }
+  return true;
+}
+
+void ContextImpl::cacheVerification(const std::string& key, X509_STORE_CTX* store_ctx) {
+  SystemTime expiry = time_source_.systemTime() + verification_cache_ttl_.value();
+  if (!allow_expired_certificate_) {
+    // The verification no longer holds once a certificate of the verified chain, including the
+    // trusted CA it ends with, expires.
+    for (const X509* cert : X509_STORE_CTX_get0_chain(store_ctx)) {
+      expiry = std::min(expiry, Utility::getExpirationTime(*cert));
+    }
+  }
+
+  absl::MutexLock lock(&verification_cache_mu_);
+  auto it = verified_chain_index_.find(key);
+  if (it != verified_chain_index_.end()) {
+    verified_chains_.erase(it->second);
+    verified_chain_index_.erase(it);
+  }
+  verified_chains_.push_front({key, expiry});
+  verified_chain_index_.emplace(key, verified_chains_.begin());
+  if (verified_chains_.size() > verification_cache_max_entries_) {
+    verified_chain_index_.erase(verified_chains_.back().key_);
+    verified_chains_.pop_back();
+  }
+}
+
 void ContextImpl::incCounter(const Stats::StatName name, absl::string_view value,
                              const Stats::StatName fallback) const {
   Stats::SymbolTable& symbol_table = scope_.symbolTable();
@@ -777,8 +801,9 @@ Envoy::Ssl::CertificateDetailsPtr ContextImpl::certificateDetails(X509* cert,
 
 ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ClientContextConfig& config,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source),
+                                     TimeSource& time_source,
+                                     TrustedCaStoreCache& trusted_ca_store_cache)
+    : ContextImpl(scope, config, time_source, trusted_ca_store_cache),
       server_name_indication_(config.serverNameIndication()),
       allow_renegotiation_(config.allowRenegotiation()),
       max_session_keys_(config.maxSessionKeys()) {
@@ -811,7 +836,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
   }
 }
@@ -848,47 +873,67 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(const Network::TransportSocketOpt
   }
 
   if (max_session_keys_ > 0) {
-    if (session_keys_single_use_) {
-      // Stored single-use session keys, use write/write locks.
-      absl::WriterMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-        // Remove single-use session key (TLS 1.3) after first use.
-        if (SSL_SESSION_should_be_single_use(session)) {
-          session_keys_.pop_front();
-        }
-      }
-    } else {
-      // Never stored single-use session keys, use read/write locks.
-      absl::ReaderMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
+    setSessionKey(ssl_con.get(), server_name_indication);
+  }
+
+  return ssl_con;
+}
+
+std::deque<ClientContextImpl::SessionKey>::iterator
+ClientContextImpl::findSessionKey(const std::string& server_name) {
+  // The most recently stored session key of the server name comes first, which has the highest
+  // probability of still being recognized/accepted by the server.
+  return std::find_if(
+      session_keys_.begin(), session_keys_.end(),
+      [&server_name](const SessionKey& key) { return key.server_name_ == server_name; });
+}
+
+void ClientContextImpl::setSessionKey(SSL* ssl, const std::string& server_name) {
+  bool found;
+  if (session_keys_single_use_) {
+    // Stored single-use session keys, use write/write locks.
+    absl::WriterMutexLock l(&session_keys_mu_);
+    auto it = findSessionKey(server_name);
+    found = it != session_keys_.end();
+    if (found) {
+      SSL_set_session(ssl, it->session_.get());
+      // Remove single-use session key (TLS 1.3) after first use.
+      if (SSL_SESSION_should_be_single_use(it->session_.get())) {
+        session_keys_.erase(it);
       }
     }
+  } else {
+    // Never stored single-use session keys, use read/write locks.
+    absl::ReaderMutexLock l(&session_keys_mu_);
+    auto it = findSessionKey(server_name);
+    found = it != session_keys_.end();
+    if (found) {
+      SSL_set_session(ssl, it->session_.get());
+    }
   }
 
-  return ssl_con;
+  if (found) {
+    stats_.session_cache_hit_.inc();
+  } else {
+    stats_.session_cache_miss_.inc();
+  }
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
   // In case we ever store single-use session key (TLS 1.3),
   // we need to switch to using write/write locks.
   if (SSL_SESSION_should_be_single_use(session)) {
     session_keys_single_use_ = true;
   }
+  const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
   absl::WriterMutexLock l(&session_keys_mu_);
   // Evict oldest entries.
   while (session_keys_.size() >= max_session_keys_) {
     session_keys_.pop_back();
   }
   // Add new session key at the front of the queue, so that it's used first.
-  session_keys_.push_front(bssl::UniquePtr<SSL_SESSION>(session));
+  session_keys_.push_front(
+      {server_name != nullptr ? server_name : "", bssl::UniquePtr<SSL_SESSION>(session)});
   return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
@@ -906,8 +951,10 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()) {
+                                     TimeSource& time_source,
+                                     TrustedCaStoreCache& trusted_ca_store_cache)
+    : ContextImpl(scope, config, time_source, trusted_ca_store_cache),
+      session_ticket_keys_(config.sessionTicketKeys()) {
   if (config.tlsCertificates().empty()) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
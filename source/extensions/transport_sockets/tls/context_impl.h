@@ -2,6 +2,7 @@
 
 #include <deque>
 #include <functional>
+#include <list>
 #include <string>
 #include <vector>
 
@@ -17,7 +18,9 @@
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
 
@@ -34,6 +37,9 @@ namespace Tls {
   COUNTER(connection_error)                                                                        \
   COUNTER(handshake)                                                                               \
   COUNTER(session_reused)                                                                          \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(verify_cache_hit)                                                                        \
   COUNTER(no_certificate)                                                                          \
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
@@ -93,9 +99,12 @@ public:
 
   std::vector<Ssl::PrivateKeyMethodProviderSharedPtr> getPrivateKeyMethodProviders();
 
+  // A X509_STORE_CTX_verify_cb callback for ignoring cert expiration in X509_verify_cert().
+  static int ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* store_ctx);
+
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-              TimeSource& time_source);
+              TimeSource& time_source, TrustedCaStoreCache& trusted_ca_store_cache);
 
   /**
    * The global SSL-library index used for storing a pointer to the context
@@ -103,15 +112,30 @@ protected:
    */
   static int sslContextIndex();
 
-  // A X509_STORE_CTX_verify_cb callback for ignoring cert expiration in X509_verify_cert().
-  static int ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* store_ctx);
-
   // A SSL_CTX_set_cert_verify_callback for custom cert validation.
   static int verifyCallback(X509_STORE_CTX* store_ctx, void* arg);
 
   int verifyCertificate(X509* cert, const std::vector<std::string>& verify_san_list,
                         const std::vector<Matchers::StringMatcherImpl>& subject_alt_name_matchers);
 
+  /**
+   * Computes the key of the peer certificate chain of a connection in the verification cache,
+   * which is a SHA-256 digest of the digests of the certificates presented by the peer.
+   */
+  static std::string verificationCacheKey(SSL* ssl);
+
+  /**
+   * @return whether the chain of the given key was successfully verified against the trusted CA
+   *         less than the verification cache TTL ago.
+   */
+  bool verificationCached(const std::string& key);
+
+  /**
+   * Caches the successful verification of the chain of the given key, until the verification
+   * cache TTL elapses or a certificate of the verified chain expires, whichever comes first.
+   */
+  void cacheVerification(const std::string& key, X509_STORE_CTX* store_ctx);
+
   /**
    * Verifies certificate hash for pinning. The hash is a hex-encoded SHA-256 of the DER-encoded
    * certificate.
@@ -177,6 +201,7 @@ protected:
   Stats::Scope& scope_;
   SslStats stats_;
   std::vector<uint8_t> parsed_alpn_protocols_;
+  TrustedCaStoreCache::TrustedCaStoreSharedPtr trusted_ca_store_;
   bssl::UniquePtr<X509> ca_cert_;
   bssl::UniquePtr<X509> cert_chain_;
   std::string ca_file_path_;
@@ -192,6 +217,21 @@ protected:
   const Stats::StatName ssl_versions_;
   const Stats::StatName ssl_curves_;
   const Stats::StatName ssl_sigalgs_;
+
+  struct VerifiedChain {
+    std::string key_;
+    SystemTime expiry_;
+  };
+
+  absl::optional<std::chrono::milliseconds> verification_cache_ttl_;
+  size_t verification_cache_max_entries_{};
+  bool allow_expired_certificate_{};
+  absl::Mutex verification_cache_mu_;
+  // Ordered from the most recently to the least recently stored verification. The cache is shared
+  // by the connections of all workers.
+  std::list<VerifiedChain> verified_chains_ ABSL_GUARDED_BY(verification_cache_mu_);
+  absl::flat_hash_map<std::string, std::list<VerifiedChain>::iterator>
+      verified_chain_index_ ABSL_GUARDED_BY(verification_cache_mu_);
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -199,26 +239,39 @@ using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
 class ClientContextImpl : public ContextImpl, public Envoy::Ssl::ClientContext {
 public:
   ClientContextImpl(Stats::Scope& scope, const Envoy::Ssl::ClientContextConfig& config,
-                    TimeSource& time_source);
+                    TimeSource& time_source, TrustedCaStoreCache& trusted_ca_store_cache);
 
   bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options) override;
 
 private:
-  int newSessionKey(SSL_SESSION* session);
+  struct SessionKey {
+    // The SNI of the connection the session was established on. Sessions are only resumed on
+    // connections to the same server name, as a server will not accept sessions of another one.
+    std::string server_name_;
+    bssl::UniquePtr<SSL_SESSION> session_;
+  };
+
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
+  void setSessionKey(SSL* ssl, const std::string& server_name);
+  std::deque<SessionKey>::iterator findSessionKey(const std::string& server_name)
+      ABSL_SHARED_LOCKS_REQUIRED(session_keys_mu_);
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
 
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
   absl::Mutex session_keys_mu_;
-  std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
+  // Ordered from the most recently to the least recently stored session key. The cache is shared
+  // by the connections of all workers.
+  std::deque<SessionKey> session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
   bool session_keys_single_use_{false};
 };
 
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    TrustedCaStoreCache& trusted_ca_store_cache);
 
 private:
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
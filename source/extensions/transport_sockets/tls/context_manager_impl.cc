@@ -2,17 +2,130 @@
 
 #include <functional>
 
+#include "envoy/common/exception.h"
 #include "envoy/stats/scope.h"
 
 #include "common/common/assert.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+TrustedCaStoreCache::TrustedCaStoreSharedPtr
+TrustedCaStoreCache::getOrCreate(const Envoy::Ssl::CertificateValidationContextConfig& config) {
+  ASSERT(!config.caCert().empty());
+  // The sizes delimit the certificates from the CRL, and the last character records whether
+  // expired certificates are allowed, which sets a verify callback on the store.
+  const std::string key =
+      absl::StrCat(config.caCert().size(), ":", config.caCert(),
+                   config.certificateRevocationList().size(), ":",
+                   config.certificateRevocationList(), config.allowExpiredCertificate() ? 1 : 0);
+
+  absl::MutexLock lock(&mutex_);
+  auto it = stores_.find(key);
+  if (it != stores_.end()) {
+    TrustedCaStoreSharedPtr store = it->second.lock();
+    if (store != nullptr) {
+      return store;
+    }
+  }
+  // A store is only cached once built, so that a config failing to load isn't cached.
+  TrustedCaStoreSharedPtr store = createStore(config);
+  for (auto stale = stores_.begin(); stale != stores_.end();) {
+    if (stale->second.expired()) {
+      stores_.erase(stale++);
+    } else {
+      ++stale;
+    }
+  }
+  stores_[key] = store;
+  return store;
+}
+
+size_t TrustedCaStoreCache::size() {
+  absl::MutexLock lock(&mutex_);
+  size_t size = 0;
+  for (const auto& store : stores_) {
+    if (!store.second.expired()) {
+      size++;
+    }
+  }
+  return size;
+}
+
+TrustedCaStoreCache::TrustedCaStoreSharedPtr
+TrustedCaStoreCache::createStore(const Envoy::Ssl::CertificateValidationContextConfig& config) {
+  auto trusted_ca_store = std::make_shared<TrustedCaStore>();
+  trusted_ca_store->store_.reset(X509_STORE_new());
+  RELEASE_ASSERT(trusted_ca_store->store_ != nullptr, "");
+  X509_STORE* store = trusted_ca_store->store_.get();
+
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(config.caCert().data()), config.caCert().size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  // Based on BoringSSL's X509_load_cert_crl_file().
+  bssl::UniquePtr<STACK_OF(X509_INFO)> list(
+      PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+  if (list == nullptr) {
+    throw EnvoyException(
+        absl::StrCat("Failed to load trusted CA certificates from ", config.caCertPath()));
+  }
+  bool has_crl = false;
+  for (const X509_INFO* item : list.get()) {
+    if (item->x509) {
+      X509_STORE_add_cert(store, item->x509);
+      if (trusted_ca_store->ca_cert_ == nullptr) {
+        X509_up_ref(item->x509);
+        trusted_ca_store->ca_cert_.reset(item->x509);
+      }
+    }
+    if (item->crl) {
+      X509_STORE_add_crl(store, item->crl);
+      has_crl = true;
+    }
+  }
+  if (trusted_ca_store->ca_cert_ == nullptr) {
+    throw EnvoyException(
+        absl::StrCat("Failed to load trusted CA certificates from ", config.caCertPath()));
+  }
+
+  if (!config.certificateRevocationList().empty()) {
+    bio.reset(BIO_new_mem_buf(const_cast<char*>(config.certificateRevocationList().data()),
+                              config.certificateRevocationList().size()));
+    RELEASE_ASSERT(bio != nullptr, "");
+
+    // Based on BoringSSL's X509_load_cert_crl_file().
+    list.reset(PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+    if (list == nullptr) {
+      throw EnvoyException(
+          absl::StrCat("Failed to load CRL from ", config.certificateRevocationListPath()));
+    }
+    for (const X509_INFO* item : list.get()) {
+      if (item->crl) {
+        X509_STORE_add_crl(store, item->crl);
+      }
+    }
+    has_crl = true;
+  }
+  if (has_crl) {
+    X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+  }
+
+  // NOTE: We're using SSL_CTX_set_cert_verify_callback() instead of X509_verify_cert()
+  // directly. However, our new callback is still calling X509_verify_cert() under
+  // the hood. Therefore, to ignore cert expiration, we need to set the callback
+  // for X509_verify_cert to ignore that error.
+  if (config.allowExpiredCertificate()) {
+    X509_STORE_set_verify_cb(store, ContextImpl::ignoreCertificateExpirationCallback);
+  }
+  return trusted_ca_store;
+}
+
 ContextManagerImpl::~ContextManagerImpl() {
   removeEmptyContexts();
   ASSERT(contexts_.empty());
@@ -30,7 +143,7 @@ ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
   }
 
   Envoy::Ssl::ClientContextSharedPtr context =
-      std::make_shared<ClientContextImpl>(scope, config, time_source_);
+      std::make_shared<ClientContextImpl>(scope, config, time_source_, trusted_ca_store_cache_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -45,7 +158,8 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
   }
 
   Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_,
+                                          trusted_ca_store_cache_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -2,19 +2,64 @@
 
 #include <functional>
 #include <list>
+#include <memory>
+#include <string>
 
 #include "envoy/common/time.h"
+#include "envoy/ssl/certificate_validation_context_config.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/ssl/private_key/private_key.h"
 #include "envoy/stats/scope.h"
 
 #include "extensions/transport_sockets/tls/private_key/private_key_manager_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+/**
+ * The trust stores built from the trusted CA certificates and CRLs of the contexts. The contexts
+ * with the same validation material share a single store, so that the clusters and listeners
+ * trusting the same CA bundle parse it and hold it in memory once rather than once each. A store
+ * is released along with the last context using it.
+ */
+class TrustedCaStoreCache {
+public:
+  struct TrustedCaStore {
+    bssl::UniquePtr<X509_STORE> store_;
+    // The first trusted CA certificate, which is reported by the context.
+    bssl::UniquePtr<X509> ca_cert_;
+  };
+  using TrustedCaStoreSharedPtr = std::shared_ptr<const TrustedCaStore>;
+
+  /**
+   * Get the trust store of a validation config, building it if no other context holds it.
+   * @param config supplies the validation config, whose trusted CA must not be empty.
+   * @return TrustedCaStoreSharedPtr the trust store.
+   * @throw EnvoyException if the trusted CA certificates or the CRL fail to load.
+   */
+  TrustedCaStoreSharedPtr getOrCreate(const Envoy::Ssl::CertificateValidationContextConfig& config);
+
+  /**
+   * @return size_t the number of trust stores held by the contexts.
+   */
+  size_t size();
+
+private:
+  static TrustedCaStoreSharedPtr
+  createStore(const Envoy::Ssl::CertificateValidationContextConfig& config);
+
+  absl::Mutex mutex_;
+  // Keyed by the validation material the store is built from.
+  absl::flat_hash_map<std::string, std::weak_ptr<const TrustedCaStore>>
+      stores_ ABSL_GUARDED_BY(mutex_);
+};
+
 /**
  * The SSL context manager has the following threading model:
  * Contexts can be allocated via any thread (through in practice they are only allocated on the main
@@ -40,11 +85,14 @@ public:
     return private_key_method_manager_;
   };
 
+  TrustedCaStoreCache& trustedCaStoreCache() { return trusted_ca_store_cache_; }
+
 private:
   void removeEmptyContexts();
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
+  TrustedCaStoreCache trusted_ca_store_cache_;
 };
 
 } // namespace Tls
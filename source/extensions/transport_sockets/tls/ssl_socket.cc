@@ -6,6 +6,7 @@
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
 #include "common/http/headers.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -42,10 +43,15 @@ public:
 };
 } // namespace
 
+constexpr uint64_t SslSocket::MaxWriteSize;
+constexpr uint64_t SslSocket::MinUnlinearizedWriteSize;
+
 SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
                      const Network::TransportSocketOptionsSharedPtr& transport_socket_options)
     : transport_socket_options_(transport_socket_options),
-      ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)), state_(SocketState::PreHandshake) {
+      ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)), state_(SocketState::PreHandshake),
+      unlinearized_write_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_unlinearized_write")) {
   bssl::UniquePtr<SSL> ssl = ctx_->newSsl(transport_socket_options_.get());
   ssl_ = ssl.get();
   info_ = std::make_shared<SslSocketInfo>(std::move(ssl));
@@ -243,7 +249,7 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = nextWriteLength(write_buffer, unlinearized_write_);
   }
 
   uint64_t total_bytes_written = 0;
@@ -261,7 +267,7 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_to_write = nextWriteLength(write_buffer, unlinearized_write_);
     } else {
       int err = SSL_get_error(ssl_, rc);
       switch (err) {
@@ -286,6 +292,21 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::nextWriteLength(const Buffer::Instance& write_buffer, bool unlinearized) {
+  const uint64_t length = std::min(write_buffer.length(), MaxWriteSize);
+  if (unlinearized) {
+    // linearize() copies the data into a newly allocated slice whenever the front slice is
+    // shorter than the requested length. Write the front slice as a smaller record instead, as
+    // long as it is large enough for the per-record overhead to be negligible.
+    Buffer::RawSlice slice;
+    if (write_buffer.getRawSlices(&slice, 1) > 0 && slice.len_ < length &&
+        slice.len_ >= MinUnlinearizedWriteSize) {
+      return slice.len_;
+    }
+  }
+  return length;
+}
+
 void SslSocket::onConnected() { ASSERT(state_ == SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
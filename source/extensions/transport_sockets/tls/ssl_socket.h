@@ -105,6 +105,21 @@ public:
 
   SSL* rawSslForTest() const { return ssl_; }
 
+  // Maximum number of bytes handed to a single SSL_write() call, which is the maximum TLS record
+  // plaintext size.
+  static constexpr uint64_t MaxWriteSize = 16384;
+  // Smallest front slice that is written on its own rather than linearized together with the
+  // following slices when the envoy.reloadable_features.tls_unlinearized_write runtime feature is
+  // enabled.
+  static constexpr uint64_t MinUnlinearizedWriteSize = 4096;
+
+  /**
+   * @param write_buffer supplies the buffer being written.
+   * @param unlinearized supplies whether a large enough front slice is written on its own.
+   * @return uint64_t the number of bytes to hand to the next SSL_write() call.
+   */
+  static uint64_t nextWriteLength(const Buffer::Instance& write_buffer, bool unlinearized);
+
 private:
   struct ReadResult {
     bool commit_slice_{};
@@ -125,6 +140,7 @@ private:
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
   SocketState state_;
+  const bool unlinearized_write_;
 
   SSL* ssl_;
   Ssl::ConnectionInfoConstSharedPtr info_;
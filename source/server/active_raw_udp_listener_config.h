@@ -14,6 +14,11 @@ public:
                           Network::ListenerConfig& config) const override;
 
   bool isTransportConnectionless() const override { return true; }
+
+  // The datagrams of raw UDP listeners have no affinity to a worker.
+  Network::Socket::OptionsSharedPtr reusePortSteeringOptions(uint32_t) const override {
+    return nullptr;
+  }
 };
 
 // This class uses a protobuf config to create a UDP listener factory which
@@ -17,7 +17,8 @@ Network::ClientConnectionPtr ValidationDispatcher::createClientConnection(
 }
 
 Network::DnsResolverSharedPtr ValidationDispatcher::createDnsResolver(
-    const std::vector<Network::Address::InstanceConstSharedPtr>&, const bool) {
+    const std::vector<Network::Address::InstanceConstSharedPtr>&,
+    const Network::DnsResolverOptions&) {
   return dns_resolver_;
 }
 
@@ -25,7 +25,7 @@ public:
                          const Network::ConnectionSocket::OptionsSharedPtr& options) override;
   Network::DnsResolverSharedPtr
   createDnsResolver(const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers,
-                    const bool use_tcp_for_dns_lookups) override;
+                    const Network::DnsResolverOptions& options) override;
   Network::ListenerPtr createListener(Network::SocketSharedPtr&&, Network::ListenerCallbacks&,
                                       bool bind_to_port) override;
 
@@ -30,6 +30,14 @@ void ConnectionHandlerImpl::decNumConnections() {
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
   ActiveListenerDetails details;
   if (config.listenSocketFactory().socketType() == Network::Address::SocketType::Stream) {
+    for (auto& listener : listeners_) {
+      if (listener.second.listener_->listenerTag() == config.listenerTag()) {
+        // This is an in place filter chain update of an active listener, which keeps its socket.
+        ASSERT(listener.second.tcp_listener_.has_value());
+        listener.second.tcp_listener_->get().updateListenerConfig(config);
+        return;
+      }
+    }
     auto tcp_listener = std::make_unique<ActiveTcpListener>(*this, config);
     details.tcp_listener_ = *tcp_listener;
     details.listener_ = std::move(tcp_listener);
@@ -54,6 +62,23 @@ void ConnectionHandlerImpl::removeListeners(uint64_t listener_tag) {
   }
 }
 
+void ConnectionHandlerImpl::removeFilterChains(
+    uint64_t listener_tag, const std::list<const Network::FilterChain*>& filter_chains,
+    std::function<void()> completion) {
+  for (auto& listener : listeners_) {
+    if (listener.second.listener_->listenerTag() == listener_tag) {
+      ASSERT(listener.second.tcp_listener_.has_value());
+      listener.second.tcp_listener_->get().closeFilterChainConnections(filter_chains);
+      // The connections hold on to the filters built from the filter chains, so they must be
+      // destroyed before the owner of the filter chains is let go.
+      dispatcher_.clearDeferredDeleteList();
+      break;
+    }
+  }
+  // The listener may have been removed meanwhile, together with all its connections.
+  completion();
+}
+
 void ConnectionHandlerImpl::stopListeners(uint64_t listener_tag) {
   for (auto& listener : listeners_) {
     if (listener.second.listener_->listenerTag() == listener_tag) {
@@ -109,7 +134,7 @@ ConnectionHandlerImpl::ActiveListenerImplBase::ActiveListenerImplBase(
       per_worker_stats_({ALL_PER_HANDLER_LISTENER_STATS(
           POOL_COUNTER_PREFIX(config.listenerScope(), parent.statPrefix()),
           POOL_GAUGE_PREFIX(config.listenerScope(), parent.statPrefix()))}),
-      config_(config) {}
+      config_(&config) {}
 
 ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerConfig& config)
@@ -128,9 +153,35 @@ ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImp
   config.connectionBalancer().registerHandler(*this);
 }
 
+void ConnectionHandlerImpl::ActiveTcpListener::updateListenerConfig(
+    Network::ListenerConfig& config) {
+  ENVOY_LOG(trace, "replacing listener config of listener {}", config_->listenerTag());
+  // The listener filters timeout settings and the connection balancer are part of the listener
+  // config which an in place filter chain update does not change.
+  ASSERT(&config_->connectionBalancer() == &config.connectionBalancer());
+  config_ = &config;
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::closeFilterChainConnections(
+    const std::list<const Network::FilterChain*>& filter_chains) {
+  for (const Network::FilterChain* filter_chain : filter_chains) {
+    auto iter = connections_by_context_.find(filter_chain);
+    if (iter == connections_by_context_.end()) {
+      // The filter chain has no connection on this worker.
+      continue;
+    }
+    // The map entry is erased by removeConnection() once its last connection is closed, while the
+    // connections themselves are deferred deleted.
+    auto& connections = iter->second->connections_;
+    while (!connections.empty()) {
+      connections.front()->connection_->close(Network::ConnectionCloseType::NoFlush);
+    }
+  }
+}
+
 ConnectionHandlerImpl::ActiveTcpListener::~ActiveTcpListener() {
   is_deleting_ = true;
-  config_.connectionBalancer().unregisterHandler(*this);
+  config_->connectionBalancer().unregisterHandler(*this);
 
   // Purge sockets that have not progressed to connections. This should only happen when
   // a listener filter stops iteration and never resumes.
@@ -292,7 +343,7 @@ void ConnectionHandlerImpl::ActiveTcpSocket::newConnection() {
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onAccept(Network::ConnectionSocketPtr&& socket) {
-  onAcceptWorker(std::move(socket), config_.handOffRestoredDestinationConnections(), false);
+  onAcceptWorker(std::move(socket), config_->handOffRestoredDestinationConnections(), false);
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
@@ -300,7 +351,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
     bool rebalanced) {
   if (!rebalanced) {
     Network::BalancedConnectionHandler& target_handler =
-        config_.connectionBalancer().pickTargetHandler(*this);
+        config_->connectionBalancer().pickTargetHandler(*this);
     if (&target_handler != this) {
       target_handler.post(std::move(socket));
       return;
@@ -311,7 +362,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
                                                          hand_off_restored_destination_connections);
 
   // Create and run the filters
-  config_.filterChainFactory().createListenerFilterChain(*active_socket);
+  config_->filterChainFactory().createListenerFilterChain(*active_socket);
   active_socket->continueFilterChain(true);
 
   // Move active_socket to the sockets_ list if filter iteration needs to continue later.
@@ -325,7 +376,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
 void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
     Network::ConnectionSocketPtr&& socket) {
   // Find matching filter chain.
-  const auto filter_chain = config_.filterChainManager().findFilterChain(*socket);
+  const auto filter_chain = config_->filterChainManager().findFilterChain(*socket);
   if (filter_chain == nullptr) {
     ENVOY_LOG(debug, "closing connection: no matching filter chain found");
     stats_.no_filter_chain_match_.inc();
@@ -339,9 +390,9 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
       active_connections,
       parent_.dispatcher_.createServerConnection(std::move(socket), std::move(transport_socket)),
       parent_.dispatcher_.timeSource()));
-  active_connection->connection_->setBufferLimits(config_.perConnectionBufferLimitBytes());
+  active_connection->connection_->setBufferLimits(config_->perConnectionBufferLimitBytes());
 
-  const bool empty_filter_chain = !config_.filterChainFactory().createNetworkFilterChain(
+  const bool empty_filter_chain = !config_->filterChainFactory().createNetworkFilterChain(
       *active_connection->connection_, filter_chain->networkFilterFactories());
   if (empty_filter_chain) {
     ENVOY_CONN_LOG(debug, "closing connection: no filters", *active_connection->connection_);
@@ -383,7 +434,8 @@ void ConnectionHandlerImpl::ActiveTcpListener::post(Network::ConnectionSocketPtr
   RebalancedSocketSharedPtr socket_to_rebalance = std::make_shared<RebalancedSocket>();
   socket_to_rebalance->socket = std::move(socket);
 
-  parent_.dispatcher_.post([socket_to_rebalance, tag = config_.listenerTag(), &parent = parent_]() {
+  parent_.dispatcher_.post([socket_to_rebalance, tag = config_->listenerTag(),
+                            &parent = parent_]() {
     // TODO(mattklein123): We should probably use a hash table here to lookup the tag instead of
     // iterating through the listener list.
     for (const auto& listener : parent.listeners_) {
@@ -395,7 +447,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::post(Network::ConnectionSocketPtr
             std::move(socket_to_rebalance->socket),
             listener.second.tcp_listener_.value()
                 .get()
-                .config_.handOffRestoredDestinationConnections(),
+                .config_->handOffRestoredDestinationConnections(),
             true);
         return;
       }
@@ -457,15 +509,16 @@ ActiveUdpListener::ActiveUdpListener(Network::ConnectionHandler& parent,
                                      Network::UdpListenerPtr&& listener,
                                      Network::ListenerConfig& config)
     : ConnectionHandlerImpl::ActiveListenerImplBase(parent, config),
+      udp_stats_({ALL_UDP_LISTENER_STATS(POOL_COUNTER_PREFIX(config.listenerScope(), "udp."))}),
       udp_listener_(std::move(listener)), read_filter_(nullptr) {
   // Create the filter chain on creating a new udp listener
-  config_.filterChainFactory().createUdpListenerFilterChain(*this, *this);
+  config_->filterChainFactory().createUdpListenerFilterChain(*this, *this);
 
   // If filter is nullptr, fail the creation of the listener
   if (read_filter_ == nullptr) {
     throw Network::CreateListenerException(
         fmt::format("Cannot create listener as no read filter registered for the udp listener: {} ",
-                    config_.name()));
+                    config_->name()));
   }
 }
 
@@ -473,6 +526,11 @@ void ActiveUdpListener::onData(Network::UdpRecvData& data) { read_filter_->onDat
 
 void ActiveUdpListener::onReadReady() {}
 
+void ActiveUdpListener::onPacketsRead(uint64_t num_packets) {
+  udp_stats_.downstream_rx_recv_calls_.inc();
+  udp_stats_.downstream_rx_datagrams_.add(num_packets);
+}
+
 void ActiveUdpListener::onWriteReady(const Network::Socket&) {
   // TODO(sumukhs): This is not used now. When write filters are implemented, this is a
   // trigger to invoke the on write ready API on the filters which is when they can write
@@ -52,6 +52,17 @@ struct PerHandlerListenerStats {
   ALL_PER_HANDLER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
 };
 
+#define ALL_UDP_LISTENER_STATS(COUNTER)                                                            \
+  COUNTER(downstream_rx_datagrams)                                                                 \
+  COUNTER(downstream_rx_recv_calls)
+
+/**
+ * Wrapper struct for UDP listener stats. @see stats_macros.h
+ */
+struct UdpListenerStats {
+  ALL_UDP_LISTENER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
@@ -68,6 +79,9 @@ public:
   void decNumConnections() override;
   void addListener(Network::ListenerConfig& config) override;
   void removeListeners(uint64_t listener_tag) override;
+  void removeFilterChains(uint64_t listener_tag,
+                          const std::list<const Network::FilterChain*>& filter_chains,
+                          std::function<void()> completion) override;
   void stopListeners(uint64_t listener_tag) override;
   void stopListeners() override;
   void disableListeners() override;
@@ -82,11 +96,12 @@ public:
     ActiveListenerImplBase(Network::ConnectionHandler& parent, Network::ListenerConfig& config);
 
     // Network::ConnectionHandler::ActiveListener.
-    uint64_t listenerTag() override { return config_.listenerTag(); }
+    uint64_t listenerTag() override { return config_->listenerTag(); }
 
     ListenerStats stats_;
     PerHandlerListenerStats per_worker_stats_;
-    Network::ListenerConfig& config_;
+    // Not a reference, as an in place filter chain update replaces the config of a TCP listener.
+    Network::ListenerConfig* config_{};
   };
 
 private:
@@ -140,6 +155,17 @@ private:
 
     ActiveConnections& getOrCreateActiveConnections(const Network::FilterChain& filter_chain);
 
+    /**
+     * Close the connections of the filter chains. The connections are deferred deleted.
+     */
+    void closeFilterChainConnections(const std::list<const Network::FilterChain*>& filter_chains);
+
+    /**
+     * Update the listener config. The follow up connections will see the new config. The existing
+     * connections are not impacted.
+     */
+    void updateListenerConfig(Network::ListenerConfig& config);
+
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     const std::chrono::milliseconds listener_filters_timeout_;
@@ -282,6 +308,7 @@ public:
   // Network::UdpListenerCallbacks
   void onData(Network::UdpRecvData& data) override;
   void onReadReady() override;
+  void onPacketsRead(uint64_t num_packets) override;
   void onWriteReady(const Network::Socket& socket) override;
   void onReceiveError(Api::IoError::IoErrorCode error_code) override;
 
@@ -296,6 +323,7 @@ public:
   Network::UdpListener& udpListener() override;
 
 private:
+  UdpListenerStats udp_stats_;
   Network::UdpListenerPtr udp_listener_;
   Network::UdpListenerReadFilterPtr read_filter_;
 };
@@ -26,20 +26,18 @@ Network::Address::InstanceConstSharedPtr fakeAddress() {
 } // namespace
 
 FilterChainFactoryContextImpl::FilterChainFactoryContextImpl(
-    Configuration::FactoryContext& parent_context)
-    : parent_context_(parent_context) {}
+    Configuration::FactoryContext& parent_context, Init::Manager& init_manager)
+    : parent_context_(parent_context), init_manager_(init_manager) {}
 
 bool FilterChainFactoryContextImpl::drainClose() const {
-  // TODO(lambdai): will provide individual value for each filter chain context.
-  return parent_context_.drainDecision().drainClose();
+  // A filter chain removed by an in place listener update drains on its own, while the listener
+  // keeps serving its other filter chains.
+  return is_draining_.load() || parent_context_.drainDecision().drainClose();
 }
 
 Network::DrainDecision& FilterChainFactoryContextImpl::drainDecision() { return *this; }
 
-// TODO(lambdai): init manager will be provided for each filter chain update.
-Init::Manager& FilterChainFactoryContextImpl::initManager() {
-  return parent_context_.initManager();
-}
+Init::Manager& FilterChainFactoryContextImpl::initManager() { return init_manager_; }
 
 ThreadLocal::SlotAllocator& FilterChainFactoryContextImpl::threadLocal() {
   return parent_context_.threadLocal();
@@ -185,12 +183,44 @@ void FilterChainManagerImpl::addFilterChain(
         filter_chain_match.server_names(), filter_chain_match.transport_protocol(),
         filter_chain_match.application_protocols(), filter_chain_match.source_type(), source_ips,
         filter_chain_match.source_ports(),
-        std::shared_ptr<Network::FilterChain>(
-            filter_chain_factory_builder.buildFilterChain(*filter_chain, context_creator)));
+        getOrBuildFilterChain(*filter_chain, filter_chain_factory_builder, context_creator));
   }
   convertIPsToTries();
 }
 
+Network::FilterChainSharedPtr FilterChainManagerImpl::getOrBuildFilterChain(
+    const envoy::config::listener::v3alpha::FilterChain& filter_chain,
+    FilterChainFactoryBuilder& filter_chain_factory_builder,
+    FilterChainFactoryContextCreator& context_creator) {
+  if (origin_ != nullptr) {
+    const auto existing = origin_->fc_contexts_.find(filter_chain);
+    if (existing != origin_->fc_contexts_.end()) {
+      // The config of the filter chain is unchanged, so share it along with its context. The
+      // connections already using it are not affected by the update.
+      fc_contexts_[filter_chain] = existing->second;
+      return existing->second.filter_chain_;
+    }
+  }
+  // The context, if created through this manager, is recorded by
+  // createFilterChainFactoryContext().
+  Network::FilterChainSharedPtr built =
+      filter_chain_factory_builder.buildFilterChain(filter_chain, context_creator);
+  fc_contexts_[filter_chain].filter_chain_ = built;
+  return built;
+}
+
+void FilterChainManagerImpl::diffFilterChains(
+    const FilterChainManagerImpl& other,
+    const std::function<void(const Network::FilterChain&, FilterChainFactoryContextImpl*)>&
+        callback) const {
+  for (const auto& config_and_filter_chain : fc_contexts_) {
+    if (other.fc_contexts_.find(config_and_filter_chain.first) == other.fc_contexts_.end()) {
+      const FilterChainAndContext& entry = config_and_filter_chain.second;
+      callback(*entry.filter_chain_, entry.factory_context_.get());
+    }
+  }
+}
+
 void FilterChainManagerImpl::addFilterChainForDestinationPorts(
     DestinationPortsMap& destination_ports_map, uint16_t destination_port,
     const std::vector<std::string>& destination_ips,
@@ -393,7 +423,9 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
+  // The lookups below go through absl::string_view, so that matching a server name against large
+  // numbers of exact and wildcard names does not allocate.
+  const absl::string_view server_name = socket.requestedServerName();
 
   // Match on exact server name, i.e. "www.example.com" for "www.example.com".
   const auto server_name_exact_match = server_names_map.find(server_name);
@@ -403,8 +435,8 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 
   // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
   size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
+  while (pos < server_name.size() - 1 && pos != absl::string_view::npos) {
+    const absl::string_view wildcard = server_name.substr(pos);
     const auto server_name_wildcard_match = server_names_map.find(wildcard);
     if (server_name_wildcard_match != server_names_map.end()) {
       return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
@@ -424,7 +456,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -572,9 +604,9 @@ void FilterChainManagerImpl::convertIPsToTries() {
 
 Configuration::FilterChainFactoryContext& FilterChainManagerImpl::createFilterChainFactoryContext(
     const ::envoy::config::listener::v3alpha::FilterChain* const filter_chain) {
-  // TODO(lambdai): drain close should be saved in per filter chain context
-  UNREFERENCED_PARAMETER(filter_chain);
-  factory_contexts_.push_back(std::make_unique<FilterChainFactoryContextImpl>(parent_context_));
+  factory_contexts_.push_back(
+      std::make_shared<FilterChainFactoryContextImpl>(parent_context_, init_manager_));
+  fc_contexts_[*filter_chain].factory_context_ = factory_contexts_.back();
   return *factory_contexts_.back();
 }
 } // namespace Server
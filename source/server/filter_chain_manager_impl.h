@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "envoy/config/listener/v3alpha/listener_components.pb.h"
@@ -13,6 +15,7 @@
 #include "common/init/manager_impl.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
+#include "common/protobuf/utility.h"
 
 #include "server/filter_chain_factory_context_callback.h"
 
@@ -31,12 +34,23 @@ public:
 
 // FilterChainFactoryContextImpl is supposed to be used by network filter chain.
 // Its lifetime must cover the created network filter chain.
-// Its lifetime should be covered by the owned listeners so as to support replacing the active
-// filter chains in the listener.
+// Its lifetime is shared by the listeners owning the filter chain, so that a filter chain can
+// survive an in place update of its listener.
 class FilterChainFactoryContextImpl : public Configuration::FilterChainFactoryContext,
                                       public Network::DrainDecision {
 public:
-  explicit FilterChainFactoryContextImpl(Configuration::FactoryContext& parent_context);
+  /**
+   * @param parent_context supplies the listener level context, which must outlive this context.
+   * @param init_manager supplies the init manager of the listener building the filter chain. It is
+   *        only used while the filter chain is being built.
+   */
+  FilterChainFactoryContextImpl(Configuration::FactoryContext& parent_context,
+                                Init::Manager& init_manager);
+
+  /**
+   * Start draining the connections of the filter chain, independently of the listener.
+   */
+  void startDraining() { is_draining_.store(true); }
 
   // DrainDecision
   bool drainClose() const override;
@@ -71,8 +85,12 @@ public:
 
 private:
   Configuration::FactoryContext& parent_context_;
+  Init::Manager& init_manager_;
+  std::atomic<bool> is_draining_{false};
 };
 
+using FilterChainFactoryContextSharedPtr = std::shared_ptr<FilterChainFactoryContextImpl>;
+
 /**
  * Implementation of FilterChainManager.
  */
@@ -82,7 +100,25 @@ class FilterChainManagerImpl : public Network::FilterChainManager,
 public:
   FilterChainManagerImpl(const Network::Address::InstanceConstSharedPtr& address,
                          Configuration::FactoryContext& factory_context)
-      : address_(address), parent_context_(factory_context) {}
+      : FilterChainManagerImpl(address, factory_context, factory_context.initManager()) {}
+
+  FilterChainManagerImpl(const Network::Address::InstanceConstSharedPtr& address,
+                         Configuration::FactoryContext& factory_context,
+                         Init::Manager& init_manager)
+      : address_(address), parent_context_(factory_context), init_manager_(init_manager) {}
+
+  /**
+   * Create a filter chain manager which reuses the filter chains of another manager whose config
+   * is unchanged, instead of building them again.
+   * @param parent_manager supplies the manager to reuse the filter chains of. It is only used while
+   *        filter chains are added.
+   */
+  FilterChainManagerImpl(const Network::Address::InstanceConstSharedPtr& address,
+                         Configuration::FactoryContext& factory_context,
+                         Init::Manager& init_manager,
+                         const FilterChainManagerImpl& parent_manager)
+      : address_(address), parent_context_(factory_context), init_manager_(init_manager),
+        origin_(&parent_manager) {}
 
   // FilterChainFactoryContextCreator
   Configuration::FilterChainFactoryContext& createFilterChainFactoryContext(
@@ -97,8 +133,21 @@ public:
       FilterChainFactoryBuilder& b, FilterChainFactoryContextCreator& context_creator);
   static bool isWildcardServerName(const std::string& name);
 
+  /**
+   * Invoke the callback for each filter chain of this manager which is not part of another one,
+   * along with the factory context it was built with, if any.
+   */
+  void diffFilterChains(
+      const FilterChainManagerImpl& other,
+      const std::function<void(const Network::FilterChain&, FilterChainFactoryContextImpl*)>&
+          callback) const;
+
 private:
   void convertIPsToTries();
+  Network::FilterChainSharedPtr
+  getOrBuildFilterChain(const envoy::config::listener::v3alpha::FilterChain& filter_chain,
+                        FilterChainFactoryBuilder& filter_chain_factory_builder,
+                        FilterChainFactoryContextCreator& context_creator);
   using SourcePortsMap = absl::flat_hash_map<uint16_t, Network::FilterChainSharedPtr>;
   using SourcePortsMapSharedPtr = std::shared_ptr<SourcePortsMap>;
   using SourceIPsMap = absl::flat_hash_map<std::string, SourcePortsMapSharedPtr>;
@@ -191,7 +240,18 @@ private:
   DestinationPortsMap destination_ports_map_;
   const Network::Address::InstanceConstSharedPtr address_;
   Configuration::FactoryContext& parent_context_;
-  std::list<std::unique_ptr<Configuration::FilterChainFactoryContext>> factory_contexts_;
+  Init::Manager& init_manager_;
+  std::list<FilterChainFactoryContextSharedPtr> factory_contexts_;
+  // The filter chains and the contexts they were built with, keyed by their config so that an
+  // update of the listener can find the unchanged ones.
+  struct FilterChainAndContext {
+    Network::FilterChainSharedPtr filter_chain_;
+    FilterChainFactoryContextSharedPtr factory_context_;
+  };
+  absl::flat_hash_map<envoy::config::listener::v3alpha::FilterChain, FilterChainAndContext,
+                      MessageUtil, MessageUtil>
+      fc_contexts_;
+  const FilterChainManagerImpl* origin_{};
 };
 
 class FilterChainImpl : public Network::FilterChain {
@@ -92,16 +92,19 @@ void initializeMutex(pthread_mutex_t& mutex) {
 }
 
 HotRestartImpl::HotRestartImpl(const Options& options)
-    : as_child_(HotRestartingChild(options.baseId(), options.restartEpoch())),
-      as_parent_(HotRestartingParent(options.baseId(), options.restartEpoch())),
+    : as_child_(options.baseId(), options.restartEpoch(), options.hotRestartSharedStats()),
+      as_parent_(options.baseId(), options.restartEpoch()),
       shmem_(attachSharedMemory(options)), log_lock_(shmem_->log_lock_),
       access_log_lock_(shmem_->access_log_lock_) {
   // If our parent ever goes away just terminate us so that we don't have to rely on ops/launching
   // logic killing the entire process tree. We should never exist without our parent.
   int rc = prctl(PR_SET_PDEATHSIG, SIGTERM);
   RELEASE_ASSERT(rc != -1, "");
+  HotRestartUdpForwardingSingleton::initialize(this);
 }
 
+HotRestartImpl::~HotRestartImpl() { HotRestartUdpForwardingSingleton::clear(); }
+
 void HotRestartImpl::drainParentListeners() {
   as_child_.drainParentListeners();
   // At this point we are initialized and a new Envoy can startup if needed.
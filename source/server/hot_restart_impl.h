@@ -22,7 +22,7 @@ namespace Server {
 
 // Increment this whenever there is a shared memory / RPC change that will prevent a hot restart
 // from working. Operations code can then cope with this and do a full restart.
-const uint64_t HOT_RESTART_VERSION = 11;
+const uint64_t HOT_RESTART_VERSION = 12;
 
 /**
  * Shared memory segment. This structure is laid directly into shared memory and is used amongst
@@ -92,10 +92,12 @@ private:
 /**
  * Implementation of HotRestart built for Linux. Most of the "protocol" type logic is split out into
  * HotRestarting{Base,Parent,Child}. This class ties all that to shared memory and version logic.
+ * It also serves as the HotRestartUdpForwardingSingleton for as long as it exists.
  */
-class HotRestartImpl : public HotRestart {
+class HotRestartImpl : public HotRestart, public HotRestartUdpForwarding {
 public:
   HotRestartImpl(const Options& options);
+  ~HotRestartImpl() override;
 
   // Server::HotRestart
   void drainParentListeners() override;
@@ -109,6 +111,19 @@ public:
   Thread::BasicLockable& logLock() override { return log_lock_; }
   Thread::BasicLockable& accessLogLock() override { return access_log_lock_; }
 
+  // Server::HotRestartUdpForwarding
+  bool forwardingToParent() const override { return as_child_.forwardingUdpPackets(); }
+  void forwardToParent(const Network::Address::Instance& listen_address,
+                       const Network::UdpRecvData& data) override {
+    as_child_.forwardUdpPacket(listen_address, data);
+  }
+  uint64_t addListener(const Network::Address::Instance& listen_address,
+                       Event::Dispatcher& dispatcher,
+                       HotRestartUdpForwarding::Listener& listener) override {
+    return as_parent_.addUdpListener(listen_address, dispatcher, listener);
+  }
+  void removeListener(uint64_t id) override { as_parent_.removeUdpListener(id); }
+
   /**
    * envoy --hot_restart_version doesn't initialize Envoy, but computes the version string
    * based on the configured options.
@@ -9,6 +9,9 @@ namespace Server {
 using HotRestartMessage = envoy::HotRestartMessage;
 
 static constexpr uint64_t MaxSendmsgSize = 4096;
+// Right now we only allow a maximum of 3 concurrent envoy processes to be running. When the third
+// starts up it will kill the oldest parent.
+static constexpr uint64_t MaxConcurrentProcesses = 3;
 
 void HotRestartingBase::initDomainSocketAddress(sockaddr_un* address) {
   memset(address, 0, sizeof(*address));
@@ -16,9 +19,6 @@ void HotRestartingBase::initDomainSocketAddress(sockaddr_un* address) {
 }
 
 sockaddr_un HotRestartingBase::createDomainSocketAddress(uint64_t id, const std::string& role) {
-  // Right now we only allow a maximum of 3 concurrent envoy processes to be running. When the third
-  // starts up it will kill the oldest parent.
-  static constexpr uint64_t MaxConcurrentProcesses = 3;
   id = id % MaxConcurrentProcesses;
 
   // This creates an anonymous domain socket name (where the first byte of the name of \0).
@@ -31,6 +31,10 @@ sockaddr_un HotRestartingBase::createDomainSocketAddress(uint64_t id, const std:
   return address;
 }
 
+std::string HotRestartingBase::sharedStatsRegionName(uint64_t id) const {
+  return fmt::format("/envoy_shared_stats_{}", base_id_ + id % MaxConcurrentProcesses);
+}
+
 void HotRestartingBase::bindDomainSocket(uint64_t id, const std::string& role) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
   // This actually creates the socket and binds it. We use the socket in datagram mode so we can
@@ -56,6 +60,7 @@ void HotRestartingBase::sendHotRestartMessage(sockaddr_un& address,
   RELEASE_ASSERT(proto.SerializeWithCachedSizesToArray(send_buf.data() + sizeof(uint64_t)),
                  "failed to serialize a HotRestartMessage");
 
+  absl::MutexLock lock(&send_mutex_);
   RELEASE_ASSERT(fcntl(my_domain_socket_, F_SETFL, 0) != -1,
                  fmt::format("Set domain socket blocking failed, errno = {}", errno));
 
@@ -98,6 +103,34 @@ void HotRestartingBase::sendHotRestartMessage(sockaddr_un& address,
                  fmt::format("Set domain socket nonblocking failed, errno = {}", errno));
 }
 
+bool HotRestartingBase::trySendHotRestartMessage(sockaddr_un& address,
+                                                 const HotRestartMessage& proto) {
+  const uint64_t serialized_size = proto.ByteSizeLong();
+  const uint64_t total_size = sizeof(uint64_t) + serialized_size;
+  if (total_size > MaxSendmsgSize) {
+    return false;
+  }
+  uint8_t send_buf[MaxSendmsgSize];
+  *reinterpret_cast<uint64_t*>(send_buf) = htobe64(serialized_size);
+  RELEASE_ASSERT(proto.SerializeWithCachedSizesToArray(send_buf + sizeof(uint64_t)),
+                 "failed to serialize a HotRestartMessage");
+
+  iovec iov[1];
+  iov[0].iov_base = send_buf;
+  iov[0].iov_len = total_size;
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_name = &address;
+  message.msg_namelen = sizeof(address);
+  message.msg_iov = iov;
+  message.msg_iovlen = 1;
+
+  // MSG_DONTWAIT rather than the socket flags, which the receiving side toggles.
+  absl::MutexLock lock(&send_mutex_);
+  const int rc = sendmsg(my_domain_socket_, &message, MSG_DONTWAIT);
+  return rc == static_cast<int>(total_size);
+}
+
 bool HotRestartingBase::replyIsExpectedType(const HotRestartMessage* proto,
                                             HotRestartMessage::Reply::ReplyCase oneof_type) const {
   return proto != nullptr && proto->requestreply_case() == HotRestartMessage::kReply &&
@@ -14,6 +14,8 @@
 
 #include "common/common/assert.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -29,6 +31,8 @@ protected:
   sockaddr_un createDomainSocketAddress(uint64_t id, const std::string& role);
   void bindDomainSocket(uint64_t id, const std::string& role);
   int myDomainSocket() const { return my_domain_socket_; }
+  // The name of the shared memory region into which the process of the given id exports its stats.
+  std::string sharedStatsRegionName(uint64_t id) const;
 
   // Protocol description:
   //
@@ -44,6 +48,10 @@ protected:
   // There is no mechanism to explicitly pair responses to requests. However, the child initiates
   // all exchanges, and blocks until a reply is received, so there is implicit pairing.
   void sendHotRestartMessage(sockaddr_un& address, const envoy::HotRestartMessage& proto);
+  // Same as sendHotRestartMessage(), but may be called from any thread, and drops the message
+  // rather than blocking when the receiver is not keeping up, or when the message does not fit in
+  // one datagram. Returns whether the message was sent.
+  bool trySendHotRestartMessage(sockaddr_un& address, const envoy::HotRestartMessage& proto);
 
   enum class Blocking { Yes, No };
   // Receive data, possibly enough to build one of our protocol messages.
@@ -68,6 +76,8 @@ private:
   // our child. (E.g. if we are 2, 1 is parent and 0 is child).
   const uint64_t base_id_;
   int my_domain_socket_{-1};
+  // Keeps the datagrams of the messages sent by different threads from interleaving.
+  absl::Mutex send_mutex_;
 
   // State for the receiving half of the protocol.
   //
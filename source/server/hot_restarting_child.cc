@@ -2,13 +2,15 @@
 
 #include "common/common/utility.h"
 
+#include "server/shared_stats_region.h"
+
 namespace Envoy {
 namespace Server {
 
 using HotRestartMessage = envoy::HotRestartMessage;
 
-HotRestartingChild::HotRestartingChild(int base_id, int restart_epoch)
-    : HotRestartingBase(base_id), restart_epoch_(restart_epoch) {
+HotRestartingChild::HotRestartingChild(int base_id, int restart_epoch, bool shared_stats)
+    : HotRestartingBase(base_id), restart_epoch_(restart_epoch), shared_stats_(shared_stats) {
   initDomainSocketAddress(&parent_address_);
   if (restart_epoch_ != 0) {
     parent_address_ = createDomainSocketAddress(restart_epoch_ + -1, "parent");
@@ -38,7 +40,7 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  wrapped_request.mutable_request()->mutable_stats()->set_shared_memory(shared_stats_);
   sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
@@ -94,7 +96,28 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   if (!stat_merger_) {
     stat_merger_ = std::make_unique<Stats::StatMerger>(stats_store);
   }
-  stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges());
+  if (stats_proto.shared_memory_size() > 0) {
+    SharedStatsRegion::merge(sharedStatsRegionName(restart_epoch_ - 1),
+                             stats_proto.shared_memory_size(), *stat_merger_);
+  } else {
+    stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges());
+  }
+}
+
+void HotRestartingChild::forwardUdpPacket(const Network::Address::Instance& listen_address,
+                                          const Network::UdpRecvData& data) {
+  if (!forwardingUdpPackets()) {
+    return;
+  }
+  HotRestartMessage wrapped_request;
+  auto* packet = wrapped_request.mutable_request()->mutable_forwarded_udp_packet();
+  packet->set_listen_address(listen_address.asString());
+  packet->set_local_address(data.addresses_.local_->asString());
+  packet->set_peer_address(data.addresses_.peer_->asString());
+  packet->set_payload(data.buffer_->toString());
+  if (!trySendHotRestartMessage(parent_address_, wrapped_request)) {
+    ENVOY_LOG(debug, "dropped a UDP packet forwarded to the hot restart parent");
+  }
 }
 
 } // namespace Server
@@ -12,7 +12,7 @@ namespace Server {
  */
 class HotRestartingChild : HotRestartingBase, Logger::Loggable<Logger::Id::main> {
 public:
-  HotRestartingChild(int base_id, int restart_epoch);
+  HotRestartingChild(int base_id, int restart_epoch, bool shared_stats = false);
 
   int duplicateParentListenSocket(const std::string& address);
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
@@ -21,10 +21,19 @@ public:
   void sendParentTerminateRequest();
   void mergeParentStats(Stats::Store& stats_store,
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
+  // Whether there is a parent to forward UDP packets to. May be called from any thread.
+  bool forwardingUdpPackets() const { return restart_epoch_ != 0 && !parent_terminated_; }
+  // Forward a UDP packet to the parent, dropping it if the parent is not keeping up. May be called
+  // from any thread.
+  void forwardUdpPacket(const Network::Address::Instance& listen_address,
+                        const Network::UdpRecvData& data);
 
 private:
   const int restart_epoch_;
-  bool parent_terminated_{};
+  // Whether the parent is asked to export its stats in a shared memory region.
+  const bool shared_stats_;
+  // Read by the threads forwarding UDP packets.
+  std::atomic<bool> parent_terminated_{};
   sockaddr_un parent_address_;
   std::unique_ptr<Stats::StatMerger> stat_merger_{};
 };
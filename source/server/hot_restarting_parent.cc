@@ -2,10 +2,12 @@
 
 #include "envoy/server/instance.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/utility.h"
 
 #include "server/listener_impl.h"
+#include "server/shared_stats_region.h"
 
 namespace Envoy {
 namespace Server {
@@ -53,7 +55,12 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      if (wrapped_request->request().stats().shared_memory()) {
+        internal_->exportStatsToSharedMemory(sharedStatsRegionName(restart_epoch_),
+                                             wrapped_reply.mutable_reply()->mutable_stats());
+      } else {
+        internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      }
       sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -63,6 +70,12 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kForwardedUdpPacket: {
+      // No reply expected.
+      udp_listeners_.deliver(wrapped_request->request().forwarded_udp_packet());
+      break;
+    }
+
     case HotRestartMessage::Request::kTerminate: {
       ENVOY_LOG(info, "shutting down due to child request");
       kill(getpid(), SIGTERM);
@@ -135,7 +148,81 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
+void HotRestartingParent::Internal::exportStatsToSharedMemory(
+    const std::string& region_name, HotRestartMessage::Reply::Stats* stats) {
+  const uint64_t size = SharedStatsRegion::write(region_name, server_->stats());
+  if (size == 0) {
+    ENVOY_LOG(warn,
+              "unable to create hot restart stats region {}, exporting the stats in the reply",
+              region_name);
+    exportStatsToChild(stats);
+    return;
+  }
+  stats->set_shared_memory_size(size);
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+}
+
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
+uint64_t HotRestartingParent::UdpListeners::add(const Network::Address::Instance& listen_address,
+                                                Event::Dispatcher& dispatcher,
+                                                HotRestartUdpForwarding::Listener& listener) {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t id = next_id_++;
+  entries_.emplace(id, Entry{listen_address.asString(), &dispatcher, &listener});
+  return id;
+}
+
+void HotRestartingParent::UdpListeners::remove(uint64_t id) {
+  absl::MutexLock lock(&mutex_);
+  entries_.erase(id);
+}
+
+bool HotRestartingParent::UdpListeners::contains(uint64_t id) {
+  absl::MutexLock lock(&mutex_);
+  return entries_.contains(id);
+}
+
+void HotRestartingParent::UdpListeners::deliver(
+    const HotRestartMessage::Request::ForwardedUdpPacket& packet) {
+  Network::UdpRecvData::LocalPeerAddresses addresses;
+  try {
+    addresses.local_ = Network::Utility::parseInternetAddressAndPort(packet.local_address());
+    addresses.peer_ = Network::Utility::parseInternetAddressAndPort(packet.peer_address());
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(error, "child forwarded a UDP packet with a malformed address: {}", e.what());
+    return;
+  }
+  auto payload = std::make_shared<const std::string>(packet.payload());
+
+  std::vector<std::pair<uint64_t, Entry>> targets;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& entry : entries_) {
+      if (entry.second.listen_address_ == packet.listen_address()) {
+        targets.emplace_back(entry);
+      }
+    }
+  }
+  for (const auto& target : targets) {
+    const uint64_t id = target.first;
+    Event::Dispatcher& dispatcher = *target.second.dispatcher_;
+    HotRestartUdpForwarding::Listener& listener = *target.second.listener_;
+    dispatcher.post([this, id, &dispatcher, &listener, addresses, payload]() -> void {
+      // Listeners are only removed from their own thread, so the listener can't go away once
+      // known to still be there.
+      if (!contains(id)) {
+        return;
+      }
+      Network::UdpRecvData data;
+      data.addresses_ = addresses;
+      data.buffer_ = std::make_unique<Buffer::OwnedImpl>(*payload);
+      data.receive_time_ = dispatcher.timeSource().monotonicTime();
+      listener.onForwardedPacket(data);
+    });
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
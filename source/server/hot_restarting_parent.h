@@ -4,6 +4,9 @@
 
 #include "server/hot_restarting_base.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -17,6 +20,12 @@ public:
   HotRestartingParent(int base_id, int restart_epoch);
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server);
   void shutdown();
+  uint64_t addUdpListener(const Network::Address::Instance& listen_address,
+                          Event::Dispatcher& dispatcher,
+                          HotRestartUdpForwarding::Listener& listener) {
+    return udp_listeners_.add(listen_address, dispatcher, listener);
+  }
+  void removeUdpListener(uint64_t id) { udp_listeners_.remove(id); }
 
   // The hot restarting parent's hot restart logic. Each function is meant to be called to fulfill a
   // request from the child for that action.
@@ -30,12 +39,41 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Same as exportStatsToChild(), with the stats laid out in the shared memory region of the
+    // given name rather than in the maps of the reply, unless the region can't be created.
+    void exportStatsToSharedMemory(const std::string& region_name,
+                                   envoy::HotRestartMessage::Reply::Stats* stats);
     void drainListeners();
 
   private:
     Server::Instance* const server_{};
   };
 
+  // The listeners that the UDP packets forwarded by the child are delivered to. Listeners are
+  // added and removed from their own threads, while packets are delivered from the main thread.
+  class UdpListeners {
+  public:
+    uint64_t add(const Network::Address::Instance& listen_address, Event::Dispatcher& dispatcher,
+                 HotRestartUdpForwarding::Listener& listener);
+    void remove(uint64_t id);
+    // Posts the packet to each listener of its listen address, as the child can't tell which of
+    // them owns the connection of the packet.
+    void deliver(const envoy::HotRestartMessage::Request::ForwardedUdpPacket& packet);
+
+  private:
+    struct Entry {
+      std::string listen_address_;
+      Event::Dispatcher* dispatcher_;
+      HotRestartUdpForwarding::Listener* listener_;
+    };
+
+    bool contains(uint64_t id);
+
+    absl::Mutex mutex_;
+    uint64_t next_id_ ABSL_GUARDED_BY(mutex_){};
+    absl::flat_hash_map<uint64_t, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  };
+
 private:
   void onSocketEvent();
 
@@ -43,6 +81,7 @@ private:
   sockaddr_un child_address_;
   Event::FileEventPtr socket_event_;
   std::unique_ptr<Internal> internal_;
+  UdpListeners udp_listeners_;
 };
 
 } // namespace Server
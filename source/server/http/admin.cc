@@ -45,21 +45,32 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/json/json_loader.h"
+#include "common/memory/heap_sample.h"
 #include "common/memory/stats.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/utility.h"
+#include "common/profiler/cpu_sampler.h"
 #include "common/profiler/profiler.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/router/config_impl.h"
 #include "common/stats/histogram_impl.h"
 #include "common/upstream/host_utility.h"
+#include "common/upstream/upstream_impl.h"
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/debugging/symbolize.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "re2/re2.h"
 #include "spdlog/spdlog.h"
 
 namespace Envoy {
@@ -131,10 +142,14 @@ const char AdminHtmlEnd[] = R"(
 </body>
 )";
 
-const std::regex PromRegex("[^a-zA-Z0-9_]");
-
 const uint64_t RecentLookupsCapacity = 100;
 
+// Bounds of the parameters of /cpuprofiler/sample. Sampling longer or faster than the bounds would
+// drop samples, as the sampler records a bounded number of them.
+const uint64_t MaxCpuSampleSeconds = 600;
+const uint64_t DefaultCpuSampleFrequencyHz = 100;
+const uint64_t MaxCpuSampleFrequencyHz = 1000;
+
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.setStatus(std::to_string(enumToInt(code)));
   const auto& headers = Http::Headers::get();
@@ -191,6 +206,20 @@ absl::optional<std::string> maskParam(const Http::Utility::QueryParams& params)
   return queryParam(params, "mask");
 }
 
+// Helper method to get the name_regex parameter, or report an error for an invalid regex.
+bool nameRegexParam(const Http::Utility::QueryParams& params, Buffer::Instance& response,
+                    std::unique_ptr<re2::RE2>& regex) {
+  const auto pattern = queryParam(params, "name_regex");
+  if (pattern.has_value()) {
+    regex = std::make_unique<re2::RE2>(pattern.value(), re2::RE2::Quiet);
+    if (!regex->ok()) {
+      response.add(fmt::format("Invalid regex: \"{}\"\n", regex->error()));
+      return false;
+    }
+  }
+  return true;
+}
+
 // Helper method that ensures that we've setting flags based on all the health flag values on the
 // host.
 void setHealthFlag(Upstream::Host::HealthFlag flag, const Upstream::Host& host,
@@ -313,6 +342,326 @@ void trimResourceMessage(const Protobuf::FieldMask& field_mask, Protobuf::Messag
   ProtobufUtil::FieldMaskUtil::TrimMessage(outer_field_mask, &message);
 }
 
+// Returns the name of a config dump resource: its name field, or else that of the resource packed
+// in its Any field, as the resources of the dynamic config dumps wrap the config of a resource. An
+// empty string is returned for a resource without a name.
+std::string resourceName(const Protobuf::Message& message) {
+  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  const Protobuf::FieldDescriptor* name_field = descriptor->FindFieldByName("name");
+  if (name_field != nullptr && name_field->type() == Protobuf::FieldDescriptor::TYPE_STRING &&
+      !name_field->is_repeated()) {
+    std::string name = reflection->GetString(message, name_field);
+    if (!name.empty()) {
+      return name;
+    }
+  }
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated() || field->type() != Protobuf::FieldDescriptor::TYPE_MESSAGE ||
+        field->message_type()->full_name() != "google.protobuf.Any" ||
+        !reflection->HasField(message, field)) {
+      continue;
+    }
+    ProtobufWkt::Any any_message;
+    any_message.MergeFrom(reflection->GetMessage(message, field));
+    const absl::string_view inner_type_name =
+        TypeUtil::typeUrlToDescriptorFullName(any_message.type_url());
+    const Protobuf::Descriptor* inner_descriptor =
+        Protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(
+            static_cast<std::string>(inner_type_name));
+    if (inner_descriptor == nullptr) {
+      return EMPTY_STRING;
+    }
+    Protobuf::DynamicMessageFactory dmf;
+    std::unique_ptr<Protobuf::Message> inner_message(dmf.GetPrototype(inner_descriptor)->New());
+    MessageUtil::unpackTo(any_message, *inner_message);
+    return resourceName(*inner_message);
+  }
+  return EMPTY_STRING;
+}
+
+// Adds the lines of a pretty printed JSON value to the output, indented by the given number of
+// spaces, without a newline after the last line.
+void addIndentedJson(absl::string_view json, uint32_t indent, Buffer::Instance& output) {
+  const std::string prefix(indent, ' ');
+  bool first_line = true;
+  for (absl::string_view line : absl::StrSplit(absl::StripSuffix(json, "\n"), '\n')) {
+    if (!first_line) {
+      output.add("\n", 1);
+    }
+    first_line = false;
+    output.add(prefix);
+    output.add(line.data(), line.size());
+  }
+}
+
+// Adds the JSON of a message packed in an Any, as the config dump holds it, to the output.
+void addAnyJson(const Protobuf::Message& message, uint32_t indent, Buffer::Instance& output) {
+  ProtobufWkt::Any any_message;
+  any_message.PackFrom(message);
+  addIndentedJson(MessageUtil::getJsonStringFromMessage(any_message, true), indent, output);
+}
+
+/**
+ * Writes the JSON of a config dump one resource at a time, rather than building the whole
+ * ConfigDump message and serializing it to a single string, which takes as much memory as the dump
+ * several times over for a large config. The output is the same as that of the ConfigDump. The
+ * config tracker messages are all fetched up front, so that the chunks of the dump form one
+ * consistent snapshot of the config even if it changes while they are written, and the repeated
+ * fields of resources that they hold are written one element at a time. The dump is written in
+ * chunks, the first of them in the response of the handler and the others, if any, from the
+ * dispatcher as the downstream connection drains them, so that a large dump neither blocks the
+ * main thread nor buffers its whole JSON.
+ */
+class ConfigDumpStream : public Http::DownstreamWatermarkCallbacks {
+public:
+  ConfigDumpStream(const ConfigTrackerImpl& config_tracker,
+                   const absl::optional<std::string>& mask, std::unique_ptr<re2::RE2>&& name_regex)
+      : name_regex_(std::move(name_regex)) {
+    if (mask.has_value()) {
+      field_mask_.emplace();
+      ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask_.value());
+    }
+    for (const auto& key_callback_pair : config_tracker.getCallbacksMap()) {
+      messages_.push_back(key_callback_pair.second());
+      ASSERT(messages_.back());
+    }
+  }
+
+  /**
+   * Restrict the dump to the elements of a repeated field of one of the config tracker messages.
+   * @return absl::nullopt on success, else the Http::Code and an error message that should be
+   * added to the admin response.
+   */
+  absl::optional<std::pair<Http::Code, std::string>> setResource(const std::string& resource) {
+    for (ProtobufTypes::MessagePtr& message : messages_) {
+      const Protobuf::FieldDescriptor* field_descriptor =
+          message->GetDescriptor()->FindFieldByName(resource);
+      if (!field_descriptor) {
+        continue;
+      } else if (!field_descriptor->is_repeated()) {
+        return absl::optional<std::pair<Http::Code, std::string>>{std::make_pair(
+            Http::Code::BadRequest,
+            fmt::format("{} is not a repeated field. Use ?mask={} to get only this field",
+                        field_descriptor->name(), field_descriptor->name()))};
+      }
+      message_ = std::move(message);
+      messages_.clear();
+      resource_field_ = field_descriptor;
+      return absl::nullopt;
+    }
+
+    return absl::optional<std::pair<Http::Code, std::string>>{
+        std::make_pair(Http::Code::NotFound, fmt::format("{} not found in config dump", resource))};
+  }
+
+  /**
+   * Write the next chunk of the dump.
+   * @param output supplies the buffer to write it to.
+   * @return bool whether the whole dump has been written.
+   */
+  bool write(Buffer::Instance& output) {
+    while (output.length() < ChunkSize) {
+      if (!writeNext(output)) {
+        if (entries_ == 0) {
+          output.add(MessageUtil::getJsonStringFromMessage(envoy::admin::v3alpha::ConfigDump(),
+                                                           true));
+        } else {
+          output.add("\n ]\n}\n");
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Write the rest of the dump to the admin stream from the dispatcher, after the first chunk has
+   * been written to the response of the handler.
+   */
+  void stream(AdminStream& admin_stream, Event::Dispatcher& dispatcher) {
+    admin_stream.setEndStreamOnComplete(false);
+    callbacks_ = &admin_stream.getDecoderFilterCallbacks();
+    timer_ = dispatcher.createTimer([this]() -> void { onTimer(); });
+    timer_->enableTimer(std::chrono::milliseconds(0));
+    callbacks_->addDownstreamWatermarkCallbacks(*this);
+  }
+
+  /**
+   * Stop writing the dump, the admin stream being destroyed.
+   */
+  void onDestroy() {
+    timer_.reset();
+    if (callbacks_ != nullptr) {
+      callbacks_->removeDownstreamWatermarkCallbacks(*this);
+      callbacks_ = nullptr;
+    }
+  }
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override { ++above_high_watermark_; }
+  void onBelowWriteBufferLowWatermark() override {
+    ASSERT(above_high_watermark_ > 0);
+    if (--above_high_watermark_ == 0 && timer_ != nullptr) {
+      timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+  }
+
+private:
+  // The size of the chunks the dump is written in, each being written in one go on the main thread.
+  static constexpr uint64_t ChunkSize = 1024 * 1024;
+
+  void onTimer() {
+    // The rest of the dump is written once the downstream connection has drained what was written.
+    if (above_high_watermark_ > 0) {
+      return;
+    }
+    Buffer::OwnedImpl chunk;
+    if (write(chunk)) {
+      Http::StreamDecoderFilterCallbacks* callbacks = callbacks_;
+      callbacks_->removeDownstreamWatermarkCallbacks(*this);
+      callbacks_ = nullptr;
+      callbacks->encodeData(chunk, true);
+      return;
+    }
+    callbacks_->encodeData(chunk, false);
+    if (above_high_watermark_ == 0 && timer_ != nullptr) {
+      timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+  }
+
+  bool nameMatches(const Protobuf::Message& resource) const {
+    return name_regex_ == nullptr || re2::RE2::PartialMatch(resourceName(resource), *name_regex_);
+  }
+
+  void addEntrySeparator(Buffer::Instance& output) {
+    output.add(entries_++ == 0 ? "{\n \"configs\": [\n" : ",\n");
+  }
+
+  // Writes the next piece of the dump: an entry of the dump, or a field or an element of a
+  // repeated field of an entry written a field at a time.
+  // @return bool whether there was anything left to write.
+  bool writeNext(Buffer::Instance& output) {
+    if (resource_field_ != nullptr) {
+      return writeNextResource(output);
+    }
+    if (message_ == nullptr) {
+      return writeNextMessage(output);
+    }
+    const Protobuf::Reflection* reflection = message_->GetReflection();
+    while (field_index_ < fields_.size()) {
+      const Protobuf::FieldDescriptor* field = fields_[field_index_];
+      if (!field->is_repeated() || field->type() != Protobuf::FieldDescriptor::TYPE_MESSAGE ||
+          field->is_map()) {
+        // The JSON of the field is that of a message holding only it, without its braces.
+        std::unique_ptr<Protobuf::Message> field_message(message_->New());
+        reflection->SwapFields(message_.get(), field_message.get(), {field});
+        const std::string json = MessageUtil::getJsonStringFromMessage(*field_message, true);
+        reflection->SwapFields(message_.get(), field_message.get(), {field});
+        const absl::string_view json_view(json);
+        const size_t begin = json_view.find('\n') + 1;
+        const size_t end = json_view.rfind("\n}");
+        output.add(",\n", 2);
+        addIndentedJson(json_view.substr(begin, end - begin), 2, output);
+        ++field_index_;
+        return true;
+      }
+      while (element_index_ < reflection->FieldSize(*message_, field)) {
+        const Protobuf::Message& element =
+            reflection->GetRepeatedMessage(*message_, field, element_index_++);
+        if (!nameMatches(element)) {
+          continue;
+        }
+        if (elements_++ == 0) {
+          output.add(fmt::format(",\n   \"{}\": [\n", field->name()));
+        } else {
+          output.add(",\n", 2);
+        }
+        addIndentedJson(MessageUtil::getJsonStringFromMessage(element, true), 4, output);
+        return true;
+      }
+      if (elements_ > 0) {
+        output.add("\n   ]");
+      }
+      ++field_index_;
+      element_index_ = 0;
+      elements_ = 0;
+    }
+    output.add("\n  }");
+    message_.reset();
+    return true;
+  }
+
+  // Writes the next element of the resource the dump is restricted to.
+  bool writeNextResource(Buffer::Instance& output) {
+    const Protobuf::Reflection* reflection = message_->GetReflection();
+    while (element_index_ < reflection->FieldSize(*message_, resource_field_)) {
+      Protobuf::Message* element =
+          reflection->MutableRepeatedMessage(message_.get(), resource_field_, element_index_++);
+      if (!nameMatches(*element)) {
+        continue;
+      }
+      if (field_mask_.has_value()) {
+        trimResourceMessage(field_mask_.value(), *element);
+      }
+      addEntrySeparator(output);
+      addAnyJson(*element, 2, output);
+      return true;
+    }
+    return false;
+  }
+
+  // Takes the next config tracker message of the snapshot, and writes it whole if it is not one of
+  // the config dump messages, which are written a field at a time, or only starts writing it.
+  bool writeNextMessage(Buffer::Instance& output) {
+    if (next_message_ == messages_.size()) {
+      return false;
+    }
+    ProtobufTypes::MessagePtr message = std::move(messages_[next_message_++]);
+    if (field_mask_.has_value()) {
+      // We don't use trimMessage() above here since masks don't support
+      // indexing through repeated fields.
+      ProtobufUtil::FieldMaskUtil::TrimMessage(field_mask_.value(), message.get());
+    }
+    addEntrySeparator(output);
+    // The well known types have their own JSON representation.
+    const std::string& type_name = message->GetDescriptor()->full_name();
+    if (absl::StartsWith(type_name, "google.protobuf.")) {
+      addAnyJson(*message, 2, output);
+      return true;
+    }
+    output.add(fmt::format("  {{\n   \"@type\": \"type.googleapis.com/{}\"", type_name));
+    fields_.clear();
+    message->GetReflection()->ListFields(*message, &fields_);
+    field_index_ = 0;
+    message_ = std::move(message);
+    return true;
+  }
+
+  // The mask parsed once for every message or resource of the dump.
+  absl::optional<Protobuf::FieldMask> field_mask_;
+  const std::unique_ptr<re2::RE2> name_regex_;
+  // The snapshot of the config tracker messages taken at the start of the dump, and the index of
+  // the next one to write. Each message is released once it has been written.
+  std::vector<ProtobufTypes::MessagePtr> messages_;
+  size_t next_message_{0};
+  // The message being written, its fields being written, the index of the field being written, and
+  // the index of the next element to write and the number of elements written of a repeated field.
+  ProtobufTypes::MessagePtr message_;
+  std::vector<const Protobuf::FieldDescriptor*> fields_;
+  size_t field_index_{0};
+  int element_index_{0};
+  uint64_t elements_{0};
+  // If set, the repeated field of message_ whose elements only are written.
+  const Protobuf::FieldDescriptor* resource_field_{};
+  // The number of entries of the dump written.
+  uint64_t entries_{0};
+  Http::StreamDecoderFilterCallbacks* callbacks_{};
+  Event::TimerPtr timer_;
+  uint32_t above_high_watermark_{0};
+};
+
 } // namespace
 
 AdminFilter::AdminFilter(AdminImpl& parent) : parent_(parent) {}
@@ -623,84 +972,31 @@ Http::Code AdminImpl::handlerClusters(absl::string_view url, Http::HeaderMap& re
   return Http::Code::OK;
 }
 
-void AdminImpl::addAllConfigToDump(envoy::admin::v3alpha::ConfigDump& dump,
-                                   const absl::optional<std::string>& mask) const {
-  for (const auto& key_callback_pair : config_tracker_.getCallbacksMap()) {
-    ProtobufTypes::MessagePtr message = key_callback_pair.second();
-    ASSERT(message);
-
-    if (mask.has_value()) {
-      Protobuf::FieldMask field_mask;
-      ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-      // We don't use trimMessage() above here since masks don't support
-      // indexing through repeated fields.
-      ProtobufUtil::FieldMaskUtil::TrimMessage(field_mask, message.get());
-    }
-
-    auto* config = dump.add_configs();
-    config->PackFrom(*message);
-  }
-}
-
-absl::optional<std::pair<Http::Code, std::string>>
-AdminImpl::addResourceToDump(envoy::admin::v3alpha::ConfigDump& dump,
-                             const absl::optional<std::string>& mask,
-                             const std::string& resource) const {
-  for (const auto& key_callback_pair : config_tracker_.getCallbacksMap()) {
-    ProtobufTypes::MessagePtr message = key_callback_pair.second();
-    ASSERT(message);
-
-    auto field_descriptor = message->GetDescriptor()->FindFieldByName(resource);
-    const Protobuf::Reflection* reflection = message->GetReflection();
-    if (!field_descriptor) {
-      continue;
-    } else if (!field_descriptor->is_repeated()) {
-      return absl::optional<std::pair<Http::Code, std::string>>{std::make_pair(
-          Http::Code::BadRequest,
-          fmt::format("{} is not a repeated field. Use ?mask={} to get only this field",
-                      field_descriptor->name(), field_descriptor->name()))};
-    }
-
-    auto repeated = reflection->GetRepeatedPtrField<Protobuf::Message>(*message, field_descriptor);
-    for (Protobuf::Message& msg : repeated) {
-      if (mask.has_value()) {
-        Protobuf::FieldMask field_mask;
-        ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-        trimResourceMessage(field_mask, msg);
-      }
-      auto* config = dump.add_configs();
-      config->PackFrom(msg);
-    }
-
-    // We found the desired resource so there is no need to continue iterating over
-    // the other keys.
-    return absl::nullopt;
-  }
-
-  return absl::optional<std::pair<Http::Code, std::string>>{
-      std::make_pair(Http::Code::NotFound, fmt::format("{} not found in config dump", resource))};
-}
-
 Http::Code AdminImpl::handlerConfigDump(absl::string_view url, Http::HeaderMap& response_headers,
-                                        Buffer::Instance& response, AdminStream&) const {
+                                        Buffer::Instance& response,
+                                        AdminStream& admin_stream) const {
   Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
   const auto resource = resourceParam(query_params);
   const auto mask = maskParam(query_params);
+  std::unique_ptr<re2::RE2> name_regex;
+  if (!nameRegexParam(query_params, response, name_regex)) {
+    return Http::Code::BadRequest;
+  }
 
-  envoy::admin::v3alpha::ConfigDump dump;
-
+  auto stream = std::make_shared<ConfigDumpStream>(config_tracker_, mask, std::move(name_regex));
   if (resource.has_value()) {
-    auto err = addResourceToDump(dump, mask, resource.value());
+    auto err = stream->setResource(resource.value());
     if (err.has_value()) {
       response.add(err.value().second);
       return err.value().first;
     }
-  } else {
-    addAllConfigToDump(dump, mask);
   }
 
   response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-  response.add(MessageUtil::getJsonStringFromMessage(dump, true)); // pretty-print
+  if (!stream->write(response)) {
+    stream->stream(admin_stream, server_.dispatcher());
+    admin_stream.addOnDestroyCallback([stream]() { stream->onDestroy(); });
+  }
   return Http::Code::OK;
 }
 
@@ -734,7 +1030,8 @@ Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::HeaderMap&
 
   bool enable = query_params.begin()->second == "y";
   if (enable && !Profiler::Cpu::profilerEnabled()) {
-    if (!Profiler::Cpu::startProfiler(profile_path_)) {
+    // Both profilers use SIGPROF.
+    if (Profiler::CpuSampler::isSampling() || !Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
       return Http::Code::InternalServerError;
     }
@@ -747,6 +1044,64 @@ Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::HeaderMap&
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerCpuSample(absl::string_view url, Http::HeaderMap&,
+                                       Buffer::Instance& response, AdminStream&) {
+  if (!Profiler::CpuSampler::samplerSupported()) {
+    response.add("The current platform does not support CPU sampling");
+    return Http::Code::NotImplemented;
+  }
+
+  Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  const auto seconds_param = query_params.find("seconds");
+  const auto frequency_param = query_params.find("frequency");
+  uint64_t seconds = 0;
+  uint64_t frequency_hz = DefaultCpuSampleFrequencyHz;
+  if (seconds_param == query_params.end() ||
+      !absl::SimpleAtoi(seconds_param->second, &seconds) || seconds == 0 ||
+      seconds > MaxCpuSampleSeconds ||
+      (frequency_param != query_params.end() &&
+       (!absl::SimpleAtoi(frequency_param->second, &frequency_hz) || frequency_hz == 0 ||
+        frequency_hz > MaxCpuSampleFrequencyHz))) {
+    response.add(fmt::format("?seconds=<1-{}>&frequency=<1-{}>\n", MaxCpuSampleSeconds,
+                             MaxCpuSampleFrequencyHz));
+    return Http::Code::BadRequest;
+  }
+
+  if (Profiler::CpuSampler::isSampling()) {
+    response.add("Fail to start CPU sampling: already started\n");
+    return Http::Code::BadRequest;
+  }
+  if (!Profiler::CpuSampler::startSampling(frequency_hz)) {
+    response.add("failure to start CPU sampling, the CPU profiler may be enabled\n");
+    return Http::Code::InternalServerError;
+  }
+
+  cpu_profile_.clear();
+  cpu_sample_timer_ = server_.dispatcher().createTimer(
+      [this]() -> void { cpu_profile_ = Profiler::CpuSampler::stopSampling(); });
+  cpu_sample_timer_->enableTimer(std::chrono::seconds(seconds));
+  response.add(fmt::format("CPU sampling started for {} seconds, the profile can then be fetched "
+                           "from /cpuprofiler/profile\n",
+                           seconds));
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerCpuProfile(absl::string_view, Http::HeaderMap& response_headers,
+                                        Buffer::Instance& response, AdminStream&) {
+  if (Profiler::CpuSampler::isSampling()) {
+    response.add("CPU sampling in progress\n");
+    return Http::Code::ServiceUnavailable;
+  }
+  if (cpu_profile_.empty()) {
+    response.add("No CPU profile, see /cpuprofiler/sample\n");
+    return Http::Code::NotFound;
+  }
+
+  response_headers.setContentType("application/octet-stream");
+  response.add(cpu_profile_);
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerHeapProfiler(absl::string_view url, Http::HeaderMap&,
                                           Buffer::Instance& response, AdminStream&) {
   if (!Profiler::Heap::profilerEnabled()) {
@@ -794,6 +1149,34 @@ Http::Code AdminImpl::handlerHeapProfiler(absl::string_view url, Http::HeaderMap
   return res;
 }
 
+Http::Code AdminImpl::handlerHeapSample(absl::string_view url, Http::HeaderMap&,
+                                        Buffer::Instance& response, AdminStream&) {
+  const std::string heap_sample = Profiler::Heap::heapSample();
+  if (heap_sample.empty()) {
+    response.add("The current build does not support heap sampling");
+    return Http::Code::NotImplemented;
+  }
+
+  const Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  if (query_params.find("subsystems") == query_params.end()) {
+    response.add(heap_sample);
+    return Http::Code::OK;
+  }
+
+  const auto bytes_by_subsystem =
+      Memory::HeapSample::bytesBySubsystem(heap_sample, [](uint64_t address) -> std::string {
+        char name[1024];
+        if (!absl::Symbolize(reinterpret_cast<void*>(address), name, sizeof(name))) {
+          return "";
+        }
+        return name;
+      });
+  for (const auto& subsystem_bytes : bytes_by_subsystem) {
+    response.add(fmt::format("{}: {}\n", subsystem_bytes.first, subsystem_bytes.second));
+  }
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerHealthcheckFail(absl::string_view, Http::HeaderMap&,
                                              Buffer::Instance& response, AdminStream&) {
   server_.failHealthcheck(true);
@@ -850,6 +1233,14 @@ Http::Code AdminImpl::handlerMemory(absl::string_view, Http::HeaderMap& response
   memory.set_total_thread_cache(Memory::Stats::totalThreadCacheBytes());
   memory.set_pageheap_unmapped(Memory::Stats::totalPageHeapUnmapped());
   memory.set_pageheap_free(Memory::Stats::totalPageHeapFree());
+  uint64_t upstream_hosts = 0;
+  for (const auto& cluster : server_.clusterManager().clusters()) {
+    for (const auto& host_set : cluster.second.get().prioritySet().hostSetsPerPriority()) {
+      upstream_hosts += host_set->hosts().size();
+    }
+  }
+  memory.set_upstream_hosts(upstream_hosts);
+  memory.set_upstream_host_size(sizeof(Upstream::HostImpl));
   response.add(MessageUtil::getJsonStringFromMessage(memory, true, true)); // pretty-print
   return Http::Code::OK;
 }
@@ -957,19 +1348,33 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
     return Http::Code::BadRequest;
   }
 
-  std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+  // Sorting a vector is considerably cheaper than building a std::map with a node per stat.
+  const std::vector<Stats::CounterSharedPtr> counters = server_.stats().counters();
+  const std::vector<Stats::GaugeSharedPtr> gauges = server_.stats().gauges();
+  std::vector<std::pair<std::string, uint64_t>> all_stats;
+  all_stats.reserve(counters.size() + gauges.size());
+  for (const Stats::CounterSharedPtr& counter : counters) {
     if (shouldShowMetric(*counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
+      all_stats.emplace_back(counter->name(), counter->value());
     }
   }
 
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+  for (const Stats::GaugeSharedPtr& gauge : gauges) {
     if (shouldShowMetric(*gauge, used_only, regex)) {
       ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-      all_stats.emplace(gauge->name(), gauge->value());
+      all_stats.emplace_back(gauge->name(), gauge->value());
     }
   }
+  // Only the first of several stats with the same name is shown, counters before gauges.
+  std::stable_sort(all_stats.begin(), all_stats.end(),
+                   [](const std::pair<std::string, uint64_t>& a,
+                      const std::pair<std::string, uint64_t>& b) { return a.first < b.first; });
+  all_stats.erase(std::unique(all_stats.begin(), all_stats.end(),
+                              [](const std::pair<std::string, uint64_t>& a,
+                                 const std::pair<std::string, uint64_t>& b) {
+                                return a.first == b.first;
+                              }),
+                  all_stats.end());
 
   if (const auto format_value = formatParam(params)) {
     if (format_value.value() == "json") {
@@ -987,15 +1392,19 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
     for (const auto& stat : all_stats) {
       response.add(fmt::format("{}: {}\n", stat.first, stat.second));
     }
-    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
-    // multimap here. This makes sure that duplicate histograms get output. When shared storage is
-    // implemented this can be switched back to a normal map.
-    std::multimap<std::string, std::string> all_histograms;
+    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why
+    // duplicate histograms are kept here. When shared storage is implemented, duplicates can be
+    // dropped.
+    std::vector<std::pair<std::string, std::string>> all_histograms;
     for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
       if (shouldShowMetric(*histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
+        all_histograms.emplace_back(histogram->name(), histogram->quantileSummary());
       }
     }
+    std::stable_sort(
+        all_histograms.begin(), all_histograms.end(),
+        [](const std::pair<std::string, std::string>& a,
+           const std::pair<std::string, std::string>& b) { return a.first < b.first; });
     for (const auto& histogram : all_histograms) {
       response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
     }
@@ -1013,14 +1422,20 @@ Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, H
   }
   PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
                                               server_.stats().histograms(), response, used_only,
-                                              regex);
+                                              regex, prometheus_stats_cache_);
   return Http::Code::OK;
 }
 
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
-  // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
-  std::string stats_name = std::regex_replace(name, PromRegex, "_");
+  // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/. This is done without a
+  // regex, as it is called several times per stat.
+  std::string stats_name = name;
+  for (char& c : stats_name) {
+    if (!absl::ascii_isalnum(c) && c != '_') {
+      c = '_';
+    }
+  }
   if (stats_name[0] >= '0' && stats_name[0] <= '9') {
     return absl::StrCat("_", stats_name);
   } else {
@@ -1049,75 +1464,134 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only, const absl::optional<std::regex>& regex) {
-  std::unordered_set<std::string> metric_type_tracker;
+  PrometheusStatsCache cache;
+  return statsAsPrometheus(counters, gauges, histograms, response, used_only, regex, cache);
+}
+
+uint64_t PrometheusStatsFormatter::statsAsPrometheus(
+    const std::vector<Stats::CounterSharedPtr>& counters,
+    const std::vector<Stats::GaugeSharedPtr>& gauges,
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
+    const bool used_only, const absl::optional<std::regex>& regex,
+    PrometheusStatsCache& cache) {
+  const uint64_t scrape = ++cache.scrape_;
+  uint64_t families = 0;
+  // The samples are appended to a string added to the response once it is large enough, rather
+  // than formatting each of them into a string of its own.
+  std::string output;
+  const auto flush_if_full = [&output, &response]() {
+    if (output.size() >= 64 * 1024) {
+      response.add(output);
+      output.clear();
+    }
+  };
+  // Returns the cached series of a stat, adding the type of its metric family to the output the
+  // first time that the family is written in this scrape.
+  const auto cached_series = [&cache, &families, &output, scrape](
+                                 Stats::Metric& metric,
+                                 absl::string_view type) -> const PrometheusStatsCache::Series& {
+    auto it = cache.series_.find(&metric);
+    if (it == cache.series_.end()) {
+      auto family = cache.families_.emplace(metricName(metric.tagExtractedName()), 0).first;
+      it = cache.series_
+               .emplace(&metric, PrometheusStatsCache::Series{Stats::RefcountPtr<Stats::Metric>(
+                                                                  &metric),
+                                                              &*family,
+                                                              formattedTags(metric.tags()), 0})
+               .first;
+    }
+    PrometheusStatsCache::Series& entry = it->second;
+    entry.scrape_ = scrape;
+    if (entry.family_->second != scrape) {
+      entry.family_->second = scrape;
+      ++families;
+      absl::StrAppend(&output, "# TYPE ", entry.family_->first, " ", type, "\n");
+    }
+    return entry;
+  };
+
   for (const auto& counter : counters) {
     if (!shouldShowMetric(*counter, used_only, regex)) {
       continue;
     }
-
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} counter\n", metric_name));
-    }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter->value()));
+    const PrometheusStatsCache::Series& counter_series = cached_series(*counter, "counter");
+    absl::StrAppend(&output, counter_series.family_->first, "{", counter_series.tags_, "} ",
+                    counter->value(), "\n");
+    flush_if_full();
   }
 
   for (const auto& gauge : gauges) {
     if (!shouldShowMetric(*gauge, used_only, regex)) {
       continue;
     }
-
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
-    }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge->value()));
+    const PrometheusStatsCache::Series& gauge_series = cached_series(*gauge, "gauge");
+    absl::StrAppend(&output, gauge_series.family_->first, "{", gauge_series.tags_, "} ",
+                    gauge->value(), "\n");
+    flush_if_full();
   }
 
+  // The bounds of the buckets, formatted once for all the histograms having the same buckets.
+  std::vector<double> bucket_bounds;
+  std::vector<std::string> formatted_bucket_bounds;
   for (const auto& histogram : histograms) {
     if (!shouldShowMetric(*histogram, used_only, regex)) {
       continue;
     }
-
-    const std::string tags = formattedTags(histogram->tags());
-    const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
-
-    const std::string metric_name = metricName(histogram->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
-    }
+    const PrometheusStatsCache::Series& histogram_series = cached_series(*histogram, "histogram");
+    const std::string& metric_name = histogram_series.family_->first;
+    const std::string& tags = histogram_series.tags_;
+    const absl::string_view hist_tags_separator = tags.empty() ? "" : ",";
 
     const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
     const std::vector<double>& supported_buckets = stats.supportedBuckets();
     const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+    if (supported_buckets != bucket_bounds) {
+      bucket_bounds = supported_buckets;
+      formatted_bucket_bounds.clear();
+      for (double bucket : bucket_bounds) {
+        // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
+        // doesn't have a specific modifier to format as a fixed-point value only so we use the
+        // 'g' operator which prints the number in general fixed point format or scientific format
+        // with precision 50 to round the number up to 32 significant digits in fixed point format
+        // which should cover pretty much all cases
+        formatted_bucket_bounds.push_back(fmt::format("{:.32g}", bucket));
+      }
+    }
     for (size_t i = 0; i < supported_buckets.size(); ++i) {
-      double bucket = supported_buckets[i];
-      uint64_t value = computed_buckets[i];
-      // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
-      // doesn't have a specific modifier to format as a fixed-point value only so we use the
-      // 'g' operator which prints the number in general fixed point format or scientific format
-      // with precision 50 to round the number up to 32 significant digits in fixed point format
-      // which should cover pretty much all cases
-      response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
-                               bucket, value));
+      absl::StrAppend(&output, metric_name, "_bucket{", tags, hist_tags_separator, "le=\"",
+                      formatted_bucket_bounds[i], "\"} ", computed_buckets[i], "\n");
     }
 
-    response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
-                             stats.sampleCount()));
-    response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
-    response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
+    absl::StrAppend(&output, metric_name, "_bucket{", tags, hist_tags_separator, "le=\"+Inf\"} ",
+                    stats.sampleCount(), "\n");
+    output.append(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
+    absl::StrAppend(&output, metric_name, "_count{", tags, "} ", stats.sampleCount(), "\n");
+    flush_if_full();
+  }
+  response.add(output);
+
+  // The stats that were not written by this scrape are forgotten, as they may have been deleted,
+  // along with the metric families that no longer have any stat.
+  for (auto it = cache.series_.begin(); it != cache.series_.end();) {
+    if (it->second.scrape_ != scrape) {
+      cache.series_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = cache.families_.begin(); it != cache.families_.end();) {
+    if (it->second != scrape) {
+      cache.families_.erase(it++);
+    } else {
+      ++it;
+    }
   }
 
-  return metric_type_tracker.size();
+  return families;
 }
 
 std::string
-AdminImpl::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
+AdminImpl::statsAsJson(const std::vector<std::pair<std::string, uint64_t>>& all_stats,
                        const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
                        const bool used_only, const absl::optional<std::regex> regex,
                        const bool pretty_print) {
@@ -1395,8 +1869,14 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(handlerContention), false, false},
           {"/cpuprofiler", "enable/disable the CPU profiler",
            MAKE_ADMIN_HANDLER(handlerCpuProfiler), false, true},
+          {"/cpuprofiler/profile", "get the sampled CPU profile in pprof format",
+           MAKE_ADMIN_HANDLER(handlerCpuProfile), false, false},
+          {"/cpuprofiler/sample", "sample the CPU usage of the threads for the given duration",
+           MAKE_ADMIN_HANDLER(handlerCpuSample), false, true},
           {"/heapprofiler", "enable/disable the heap profiler",
            MAKE_ADMIN_HANDLER(handlerHeapProfiler), false, true},
+          {"/heapprofiler/sample", "get the sampled heap in use, or its bytes by subsystem",
+           MAKE_ADMIN_HANDLER(handlerHeapSample), false, false},
           {"/healthcheck/fail", "cause the server to fail health checks",
            MAKE_ADMIN_HANDLER(handlerHealthcheckFail), false, true},
           {"/healthcheck/ok", "cause the server to pass health checks",
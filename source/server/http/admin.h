@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <list>
+#include <regex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -37,6 +38,8 @@
 
 #include "server/http/config_tracker_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -51,6 +54,35 @@ class AdminInternalAddressConfig : public Http::InternalAddressConfig {
   bool isInternalAddress(const Network::Address::Instance&) const override { return false; }
 };
 
+class PrometheusStatsFormatter;
+
+/**
+ * The metric family names and the labels of the stats exported to Prometheus, kept from one scrape
+ * to the next so that they are rendered once per stat rather than on every scrape. The stats are
+ * held until a scrape that does not include them, so that a cached stat cannot be freed and its
+ * address reused by another stat.
+ */
+class PrometheusStatsCache {
+private:
+  friend class PrometheusStatsFormatter;
+
+  // The metric family names, with the number of the last scrape that has written their type.
+  using FamilyMap = absl::node_hash_map<std::string, uint64_t>;
+
+  struct Series {
+    Stats::RefcountPtr<Stats::Metric> metric_;
+    FamilyMap::value_type* family_;
+    // The labels of the stat, as written between the braces of its samples.
+    std::string tags_;
+    // The number of the last scrape that has written the stat.
+    uint64_t scrape_;
+  };
+
+  FamilyMap families_;
+  absl::flat_hash_map<const Stats::Metric*, Series> series_;
+  uint64_t scrape_{0};
+};
+
 /**
  * Implementation of Server::Admin.
  */
@@ -155,6 +187,13 @@ public:
   const Http::Http1Settings& http1Settings() const override { return http1_settings_; }
   bool shouldNormalizePath() const override { return true; }
   bool shouldMergeSlashes() const override { return true; }
+  uint32_t streamArenaBlockSize() const override { return 0; }
+  const absl::optional<Http::RequestBodySpillConfig>& requestBodySpill() const override {
+    return request_body_spill_;
+  }
+  const absl::optional<Http::FilterTimingConfig>& filterTiming() const override {
+    return filter_timing_;
+  }
   Http::Code request(absl::string_view path_and_query, absl::string_view method,
                      Http::HeaderMap& response_headers, std::string& body) override;
   void closeSocket();
@@ -242,27 +281,13 @@ private:
   void writeListenersAsJson(Buffer::Instance& response);
   void writeListenersAsText(Buffer::Instance& response);
 
-  /**
-   * Helper methods for the /config_dump url handler.
-   */
-  void addAllConfigToDump(envoy::admin::v3alpha::ConfigDump& dump,
-                          const absl::optional<std::string>& mask) const;
-  /**
-   * Add the config matching the passed resource to the passed config dump.
-   * @return absl::nullopt on success, else the Http::Code and an error message that should be added
-   * to the admin response.
-   */
-  absl::optional<std::pair<Http::Code, std::string>>
-  addResourceToDump(envoy::admin::v3alpha::ConfigDump& dump,
-                    const absl::optional<std::string>& mask, const std::string& resource) const;
-
   template <class StatType>
   static bool shouldShowMetric(const StatType& metric, const bool used_only,
                                const absl::optional<std::regex>& regex) {
     return ((!used_only || metric.used()) &&
             (!regex.has_value() || std::regex_search(metric.name(), regex.value())));
   }
-  static std::string statsAsJson(const std::map<std::string, uint64_t>& all_stats,
+  static std::string statsAsJson(const std::vector<std::pair<std::string, uint64_t>>& all_stats,
                                  const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
                                  bool used_only,
                                  const absl::optional<std::regex> regex = absl::nullopt,
@@ -285,9 +310,15 @@ private:
                                Buffer::Instance& response, AdminStream&);
   Http::Code handlerCpuProfiler(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                                 Buffer::Instance& response, AdminStream&);
+  Http::Code handlerCpuSample(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                              Buffer::Instance& response, AdminStream&);
+  Http::Code handlerCpuProfile(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                               Buffer::Instance& response, AdminStream&);
   Http::Code handlerHeapProfiler(absl::string_view path_and_query,
                                  Http::HeaderMap& response_headers, Buffer::Instance& response,
                                  AdminStream&);
+  Http::Code handlerHeapSample(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                               Buffer::Instance& response, AdminStream&);
   Http::Code handlerHealthcheckFail(absl::string_view path_and_query,
                                     Http::HeaderMap& response_headers, Buffer::Instance& response,
                                     AdminStream&);
@@ -432,6 +463,9 @@ private:
   Server::Instance& server_;
   std::list<AccessLog::InstanceSharedPtr> access_logs_;
   const std::string profile_path_;
+  // Stops the CPU sampling started by /cpuprofiler/sample, keeping the profile in pprof format.
+  Event::TimerPtr cpu_sample_timer_;
+  std::string cpu_profile_;
   Http::ConnectionManagerStats stats_;
   // Note: this is here to essentially blackhole the tracing stats since they aren't used in the
   // Admin case.
@@ -448,7 +482,10 @@ private:
   Http::SlowDateProviderImpl date_provider_;
   std::vector<Http::ClientCertDetailsType> set_current_client_cert_details_;
   Http::Http1Settings http1_settings_;
+  const absl::optional<Http::RequestBodySpillConfig> request_body_spill_;
+  const absl::optional<Http::FilterTimingConfig> filter_timing_;
   ConfigTrackerImpl config_tracker_;
+  PrometheusStatsCache prometheus_stats_cache_;
   const Network::FilterChainSharedPtr admin_filter_chain_;
   Network::SocketSharedPtr socket_;
   Network::ListenSocketFactorySharedPtr socket_factory_;
@@ -516,6 +553,16 @@ public:
                                     const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
                                     Buffer::Instance& response, const bool used_only,
                                     const absl::optional<std::regex>& regex);
+  /**
+   * As above, with the metric family names and the labels of the stats taken from the cache of the
+   * previous scrapes, and updated for the next ones.
+   */
+  static uint64_t statsAsPrometheus(const std::vector<Stats::CounterSharedPtr>& counters,
+                                    const std::vector<Stats::GaugeSharedPtr>& gauges,
+                                    const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                                    Buffer::Instance& response, const bool used_only,
+                                    const absl::optional<std::regex>& regex,
+                                    PrometheusStatsCache& cache);
   /**
    * Format the given tags, returning a string as a comma-separated list
    * of <tag_name>="<tag_value>" pairs.
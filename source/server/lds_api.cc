@@ -12,6 +12,7 @@
 
 #include "common/common/assert.h"
 #include "common/common/cleanup.h"
+#include "common/common/empty_string.h"
 #include "common/config/api_version.h"
 #include "common/config/resources.h"
 #include "common/config/utility.h"
@@ -38,6 +39,18 @@ void LdsApiImpl::onConfigUpdate(
     const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>& added_resources,
     const Protobuf::RepeatedPtrField<std::string>& removed_resources,
     const std::string& system_version_info) {
+  std::unordered_set<std::string> active_listeners;
+  for (const auto& listener : listener_manager_.listeners()) {
+    active_listeners.insert(listener.get().name());
+  }
+  applyUpdate(added_resources, removed_resources, system_version_info, active_listeners, true);
+}
+
+void LdsApiImpl::applyUpdate(
+    const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info,
+    const std::unordered_set<std::string>& active_listeners, bool resource_versions) {
   std::unique_ptr<Cleanup> maybe_eds_resume;
   if (cm_.adsMux()) {
     cm_.adsMux()->pause(Config::TypeUrl::get().RouteConfiguration);
@@ -51,6 +64,7 @@ void LdsApiImpl::onConfigUpdate(
   // We do all listener removals before adding the new listeners. This allows adding a new listener
   // with the same address as a listener that is to be removed. Do not change the order.
   for (const auto& removed_listener : removed_resources) {
+    applied_listeners_.forget(removed_listener);
     if (listener_manager_.removeListener(removed_listener)) {
       ENVOY_LOG(info, "lds: remove listener '{}'", removed_listener);
       any_applied = true;
@@ -62,7 +76,20 @@ void LdsApiImpl::onConfigUpdate(
   std::string message;
   for (const auto& resource : added_resources) {
     envoy::config::listener::v3alpha::Listener listener;
+    const uint64_t hash = Config::AppliedResources::hash(resource.resource());
+    const std::string& resource_version = resource_versions ? resource.version() : EMPTY_STRING;
     try {
+      // A listener which is still active and unchanged since it was applied is neither unpacked
+      // nor handed to the listener manager again.
+      if (active_listeners.count(resource.name()) != 0 &&
+          applied_listeners_.unchanged(resource.name(), hash, resource_version)) {
+        if (!listener_names.insert(resource.name()).second) {
+          listener.set_name(resource.name());
+          throw EnvoyException(fmt::format("duplicate listener {} found", resource.name()));
+        }
+        ENVOY_LOG(debug, "lds: listener '{}' unchanged", resource.name());
+        continue;
+      }
       listener =
           MessageUtil::anyConvert<envoy::config::listener::v3alpha::Listener>(resource.resource());
       MessageUtil::validate(listener, validation_visitor_);
@@ -76,7 +103,9 @@ void LdsApiImpl::onConfigUpdate(
       } else {
         ENVOY_LOG(debug, "lds: add/update listener '{}' skipped", listener.name());
       }
+      applied_listeners_.applied(listener.name(), hash, resource_version);
     } catch (const EnvoyException& e) {
+      applied_listeners_.forget(listener.name());
       failure_state.push_back(std::make_unique<envoy::admin::v3alpha::UpdateFailureState>());
       auto& state = failure_state.back();
       state->set_details(e.what());
@@ -99,17 +128,17 @@ void LdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::An
                                 const std::string& version_info) {
   // We need to keep track of which listeners need to remove.
   // Specifically, it's [listeners we currently have] - [listeners found in the response].
-  std::unordered_set<std::string> listeners_to_remove;
+  std::unordered_set<std::string> active_listeners;
   for (const auto& listener : listener_manager_.listeners()) {
-    listeners_to_remove.insert(listener.get().name());
+    active_listeners.insert(listener.get().name());
   }
+  std::unordered_set<std::string> listeners_to_remove = active_listeners;
 
   Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> to_add_repeated;
   for (const auto& listener_blob : resources) {
     // Add this resource to our delta added/updated pile...
     envoy::service::discovery::v3alpha::Resource* to_add = to_add_repeated.Add();
-    const std::string listener_name =
-        MessageUtil::anyConvert<envoy::config::listener::v3alpha::Listener>(listener_blob).name();
+    const std::string listener_name = resourceName(listener_blob);
     to_add->set_name(listener_name);
     to_add->set_version(version_info);
     to_add->mutable_resource()->MergeFrom(listener_blob);
@@ -122,7 +151,8 @@ void LdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::An
   for (const auto& listener : listeners_to_remove) {
     *to_remove_repeated.Add() = listener;
   }
-  onConfigUpdate(to_add_repeated, to_remove_repeated, version_info);
+  // The system version_info is not a per-resource version.
+  applyUpdate(to_add_repeated, to_remove_repeated, version_info, active_listeners, false);
 }
 
 void LdsApiImpl::onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
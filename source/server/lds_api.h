@@ -1,6 +1,8 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <unordered_set>
 
 #include "envoy/config/core/v3alpha/config_source.pb.h"
 #include "envoy/config/listener/v3alpha/listener.pb.h"
@@ -12,6 +14,8 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/config/applied_resources.h"
+#include "common/config/utility.h"
 #include "common/init/target_impl.h"
 
 namespace Envoy {
@@ -43,12 +47,28 @@ private:
   void onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
                             const EnvoyException* e) override;
   std::string resourceName(const ProtobufWkt::Any& resource) override {
-    return MessageUtil::anyConvert<envoy::config::listener::v3alpha::Listener>(resource).name();
+    return Config::Utility::anyStringField(
+        resource, envoy::config::listener::v3alpha::Listener::kNameFieldNumber);
   }
   static std::string loadTypeUrl(envoy::config::core::v3alpha::ApiVersion resource_api_version);
 
+  /**
+   * Removes and adds or updates the listeners of an update, skipping the listeners which are still
+   * active and unchanged since they were last applied.
+   * @param active_listeners the names of the active listeners.
+   * @param resource_versions whether the versions of the resources are per-resource versions,
+   *        which identify unchanged listeners.
+   */
+  void applyUpdate(
+      const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>&
+          added_resources,
+      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+      const std::string& system_version_info,
+      const std::unordered_set<std::string>& active_listeners, bool resource_versions);
+
   std::unique_ptr<Config::Subscription> subscription_;
   std::string system_version_info_;
+  Config::AppliedResources applied_listeners_;
   ListenerManager& listener_manager_;
   Stats::ScopePtr scope_;
   Upstream::ClusterManager& cm_;
@@ -15,6 +15,7 @@
 #include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "server/configuration_impl.h"
 #include "server/drain_manager_impl.h"
@@ -28,6 +29,20 @@
 
 namespace Envoy {
 namespace Server {
+namespace {
+
+// Whether two listener configs only differ by their filter chains.
+bool filterChainOnlyChange(const envoy::config::listener::v3alpha::Listener& lhs,
+                           const envoy::config::listener::v3alpha::Listener& rhs) {
+  Protobuf::util::MessageDifferencer differencer;
+  differencer.set_message_field_comparison(Protobuf::util::MessageDifferencer::EQUIVALENT);
+  differencer.IgnoreField(
+      envoy::config::listener::v3alpha::Listener::GetDescriptor()->FindFieldByName(
+          "filter_chains"));
+  return differencer.Compare(lhs, rhs);
+}
+
+} // namespace
 
 ListenSocketFactoryImpl::ListenSocketFactoryImpl(ListenerComponentFactory& factory,
                                                  Network::Address::InstanceConstSharedPtr address,
@@ -123,16 +138,93 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket() {
   return createListenSocketAndApplyOptions();
 }
 
+ListenerFactoryContextBaseImpl::ListenerFactoryContextBaseImpl(
+    Envoy::Server::Instance& server, ProtobufMessage::ValidationVisitor& validation_visitor,
+    const envoy::config::listener::v3alpha::Listener& config,
+    const Network::Address::Instance& address, DrainManagerPtr drain_manager)
+    : server_(server), metadata_(config.metadata()), direction_(config.traffic_direction()),
+      global_scope_(server.stats().createScope("")),
+      listener_scope_(
+          server.stats().createScope(fmt::format("listener.{}.", address.asString()))),
+      validation_visitor_(validation_visitor), drain_manager_(std::move(drain_manager)) {}
+
+AccessLog::AccessLogManager& ListenerFactoryContextBaseImpl::accessLogManager() {
+  return server_.accessLogManager();
+}
+Upstream::ClusterManager& ListenerFactoryContextBaseImpl::clusterManager() {
+  return server_.clusterManager();
+}
+Event::Dispatcher& ListenerFactoryContextBaseImpl::dispatcher() { return server_.dispatcher(); }
+Network::DrainDecision& ListenerFactoryContextBaseImpl::drainDecision() { return *this; }
+Grpc::Context& ListenerFactoryContextBaseImpl::grpcContext() { return server_.grpcContext(); }
+bool ListenerFactoryContextBaseImpl::healthCheckFailed() { return server_.healthCheckFailed(); }
+Tracing::HttpTracer& ListenerFactoryContextBaseImpl::httpTracer() {
+  return httpContext().tracer();
+}
+Http::Context& ListenerFactoryContextBaseImpl::httpContext() { return server_.httpContext(); }
+Init::Manager& ListenerFactoryContextBaseImpl::initManager() {
+  // The init manager depends on the listener being built, which supplies it to the filter chain
+  // factory contexts itself.
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+const LocalInfo::LocalInfo& ListenerFactoryContextBaseImpl::localInfo() const {
+  return server_.localInfo();
+}
+Envoy::Runtime::RandomGenerator& ListenerFactoryContextBaseImpl::random() {
+  return server_.random();
+}
+Envoy::Runtime::Loader& ListenerFactoryContextBaseImpl::runtime() { return server_.runtime(); }
+Stats::Scope& ListenerFactoryContextBaseImpl::scope() { return *global_scope_; }
+Singleton::Manager& ListenerFactoryContextBaseImpl::singletonManager() {
+  return server_.singletonManager();
+}
+OverloadManager& ListenerFactoryContextBaseImpl::overloadManager() {
+  return server_.overloadManager();
+}
+ThreadLocal::Instance& ListenerFactoryContextBaseImpl::threadLocal() {
+  return server_.threadLocal();
+}
+Admin& ListenerFactoryContextBaseImpl::admin() { return server_.admin(); }
+const envoy::config::core::v3alpha::Metadata&
+ListenerFactoryContextBaseImpl::listenerMetadata() const {
+  return metadata_;
+};
+envoy::config::core::v3alpha::TrafficDirection ListenerFactoryContextBaseImpl::direction() const {
+  return direction_;
+};
+TimeSource& ListenerFactoryContextBaseImpl::timeSource() { return api().timeSource(); }
+ProtobufMessage::ValidationVisitor& ListenerFactoryContextBaseImpl::messageValidationVisitor() {
+  return validation_visitor_;
+}
+Api::Api& ListenerFactoryContextBaseImpl::api() { return server_.api(); }
+ServerLifecycleNotifier& ListenerFactoryContextBaseImpl::lifecycleNotifier() {
+  return server_.lifecycleNotifier();
+}
+OptProcessContextRef ListenerFactoryContextBaseImpl::processContext() {
+  return server_.processContext();
+}
+Configuration::ServerFactoryContext&
+ListenerFactoryContextBaseImpl::getServerFactoryContext() const {
+  return server_.serverFactoryContext();
+}
+Stats::Scope& ListenerFactoryContextBaseImpl::listenerScope() { return *listener_scope_; }
+
+bool ListenerFactoryContextBaseImpl::drainClose() const {
+  // When a listener is draining, the "drain close" decision is the union of the per-listener drain
+  // manager and the server wide drain manager. This allows individual listeners to be drained and
+  // removed independently of a server-wide drain event (e.g., /healthcheck/fail or hot restart).
+  return drain_manager_->drainClose() || server_.drainManager().drainClose();
+}
+
 ListenerImpl::ListenerImpl(const envoy::config::listener::v3alpha::Listener& config,
                            const std::string& version_info, ListenerManagerImpl& parent,
                            const std::string& name, bool added_via_api, bool workers_started,
                            uint64_t hash, ProtobufMessage::ValidationVisitor& validation_visitor,
                            uint32_t concurrency)
     : parent_(parent), address_(Network::Address::resolveProtoAddress(config.address())),
-      filter_chain_manager_(address_, *this),
-      global_scope_(parent_.server_.stats().createScope("")),
-      listener_scope_(
-          parent_.server_.stats().createScope(fmt::format("listener.{}.", address_->asString()))),
+      listener_factory_context_(std::make_shared<ListenerFactoryContextBaseImpl>(
+          parent_.server_, validation_visitor, config, *address_,
+          parent.factory_.createDrainManager(config.drain_type()))),
       bind_to_port_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.deprecated_v1(), bind_to_port, true)),
       hand_off_restored_destination_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hidden_envoy_deprecated_use_original_dst, false)),
@@ -143,76 +235,158 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3alpha::Listener& con
       dynamic_init_manager_(fmt::format("Listener {}", name)),
       init_watcher_(std::make_unique<Init::WatcherImpl>(
           "ListenerImpl", [this] { parent_.onListenerWarmed(*this); })),
-      local_drain_manager_(parent.factory_.createDrainManager(config.drain_type())),
       config_(config), version_info_(version_info),
       listener_filters_timeout_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)),
-      continue_on_listener_filters_timeout_(config.continue_on_listener_filters_timeout()) {
+      continue_on_listener_filters_timeout_(config.continue_on_listener_filters_timeout()),
+      filter_chain_manager_(address_, *listener_factory_context_, initManager()) {
+  Network::Address::SocketType socket_type =
+      Network::Utility::protobufAddressSocketType(config.address());
+  buildUdpListenerFactory(socket_type);
+  buildListenSocketOptions(socket_type, concurrency);
+  createListenerFilterFactories(socket_type);
+  validateFilterChains(socket_type);
+  buildFilterChains();
+  if (socket_type == Network::Address::SocketType::Datagram) {
+    return;
+  }
+  buildConnectionBalancer(concurrency);
+  buildSocketOptions();
+  buildOriginalDstListenerFilter();
+  buildProxyProtocolListenerFilter();
+  buildTlsInspectorListenerFilter();
+}
+
+ListenerImpl::ListenerImpl(ListenerImpl& origin,
+                           const envoy::config::listener::v3alpha::Listener& config,
+                           const std::string& version_info, ListenerManagerImpl& parent,
+                           const std::string& name, bool added_via_api, bool workers_started,
+                           uint64_t hash)
+    : parent_(parent), address_(origin.address_),
+      listener_factory_context_(origin.listener_factory_context_),
+      bind_to_port_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.deprecated_v1(), bind_to_port, true)),
+      hand_off_restored_destination_connections_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hidden_envoy_deprecated_use_original_dst, false)),
+      per_connection_buffer_limit_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
+      listener_tag_(origin.listener_tag_), name_(name), added_via_api_(added_via_api),
+      workers_started_(workers_started), hash_(hash),
+      validation_visitor_(origin.validation_visitor_),
+      dynamic_init_manager_(fmt::format("Listener {}", name)),
+      init_watcher_(std::make_unique<Init::WatcherImpl>(
+          "ListenerImpl", [this] { parent_.onListenerWarmed(*this); })),
+      config_(config), version_info_(version_info),
+      listener_filters_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)),
+      continue_on_listener_filters_timeout_(config.continue_on_listener_filters_timeout()),
+      cpu_steering_option_(origin.cpu_steering_option_),
+      connection_balancer_(origin.connection_balancer_),
+      filter_chain_manager_(address_, *listener_factory_context_, initManager(),
+                            origin.filter_chain_manager_) {
+  // The listen socket and its options are taken over from the origin listener, and only TCP
+  // listeners are updated in place.
   Network::Address::SocketType socket_type =
       Network::Utility::protobufAddressSocketType(config.address());
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, transparent, false)) {
+  ASSERT(socket_type == Network::Address::SocketType::Stream);
+  createListenerFilterFactories(socket_type);
+  validateFilterChains(socket_type);
+  buildFilterChains();
+  buildOriginalDstListenerFilter();
+  buildProxyProtocolListenerFilter();
+  buildTlsInspectorListenerFilter();
+}
+
+void ListenerImpl::buildListenSocketOptions(Network::Address::SocketType socket_type,
+                                            uint32_t concurrency) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, transparent, false)) {
     addListenSocketOptions(Network::SocketOptionFactory::buildIpTransparentOptions());
   }
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, freebind, false)) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, freebind, false)) {
     addListenSocketOptions(Network::SocketOptionFactory::buildIpFreebindOptions());
   }
-  if (config.reuse_port()) {
+  if (config_.reuse_port_cpu_steering() && !config_.reuse_port()) {
+    throw EnvoyException(
+        fmt::format("error adding listener '{}': reuse_port_cpu_steering requires reuse_port",
+                    address_->asString()));
+  }
+  if (config_.reuse_port()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
+    if (config_.reuse_port_cpu_steering()) {
+      // Each worker gets its own socket in the SO_REUSEPORT group.
+      cpu_steering_option_ =
+          std::make_shared<Network::ReusePortCpuSteeringSocketOptionImpl>(concurrency);
+      addListenSocketOption(cpu_steering_option_);
+    } else if (udp_listener_factory_ != nullptr) {
+      const Network::Socket::OptionsSharedPtr steering_options =
+          udp_listener_factory_->reusePortSteeringOptions(concurrency);
+      if (steering_options != nullptr) {
+        addListenSocketOptions(steering_options);
+      }
+    }
   } else if (socket_type == Network::Address::SocketType::Datagram && concurrency > 1) {
     ENVOY_LOG(warn, "Listening on UDP without SO_REUSEPORT socket option may result to unstable "
                     "packet proxying. Consider configuring the reuse_port listener option.");
   }
-  if (!config.socket_options().empty()) {
+  if (!config_.socket_options().empty()) {
     addListenSocketOptions(
-        Network::SocketOptionFactory::buildLiteralOptions(config.socket_options()));
+        Network::SocketOptionFactory::buildLiteralOptions(config_.socket_options()));
   }
   if (socket_type == Network::Address::SocketType::Datagram) {
     // Needed for recvmsg to return destination address in IP header.
     addListenSocketOptions(Network::SocketOptionFactory::buildIpPacketInfoOptions());
     // Needed to return receive buffer overflown indicator.
     addListenSocketOptions(Network::SocketOptionFactory::buildRxQueueOverFlowOptions());
-    auto udp_config = config.udp_listener_config();
-    if (udp_config.udp_listener_name().empty()) {
-      udp_config.set_udp_listener_name(UdpListenerNames::get().RawUdp);
-    }
-    auto& config_factory =
-        Config::Utility::getAndCheckFactoryByName<ActiveUdpListenerConfigFactory>(
-            udp_config.udp_listener_name());
-    ProtobufTypes::MessagePtr message =
-        Config::Utility::translateToFactoryConfig(udp_config, validation_visitor_, config_factory);
-    udp_listener_factory_ = config_factory.createActiveUdpListenerFactory(*message);
   }
+}
+
+void ListenerImpl::buildUdpListenerFactory(Network::Address::SocketType socket_type) {
+  if (socket_type != Network::Address::SocketType::Datagram) {
+    return;
+  }
+  auto udp_config = config_.udp_listener_config();
+  if (udp_config.udp_listener_name().empty()) {
+    udp_config.set_udp_listener_name(UdpListenerNames::get().RawUdp);
+  }
+  auto& config_factory = Config::Utility::getAndCheckFactoryByName<ActiveUdpListenerConfigFactory>(
+      udp_config.udp_listener_name());
+  ProtobufTypes::MessagePtr message =
+      Config::Utility::translateToFactoryConfig(udp_config, validation_visitor_, config_factory);
+  udp_listener_factory_ = config_factory.createActiveUdpListenerFactory(*message);
+}
 
-  if (!config.listener_filters().empty()) {
+void ListenerImpl::createListenerFilterFactories(Network::Address::SocketType socket_type) {
+  if (!config_.listener_filters().empty()) {
     switch (socket_type) {
     case Network::Address::SocketType::Datagram:
-      if (config.listener_filters().size() > 1) {
+      if (config_.listener_filters().size() > 1) {
         // Currently supports only 1 UDP listener
         throw EnvoyException(
             fmt::format("error adding listener '{}': Only 1 UDP filter per listener supported",
                         address_->asString()));
       }
       udp_listener_filter_factories_ =
-          parent_.factory_.createUdpListenerFilterFactoryList(config.listener_filters(), *this);
+          parent_.factory_.createUdpListenerFilterFactoryList(config_.listener_filters(), *this);
       break;
     case Network::Address::SocketType::Stream:
       listener_filter_factories_ =
-          parent_.factory_.createListenerFilterFactoryList(config.listener_filters(), *this);
+          parent_.factory_.createListenerFilterFactoryList(config_.listener_filters(), *this);
       break;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
   }
+}
 
-  if (config.filter_chains().empty() && (socket_type == Network::Address::SocketType::Stream ||
-                                         !udp_listener_factory_->isTransportConnectionless())) {
+void ListenerImpl::validateFilterChains(Network::Address::SocketType socket_type) {
+  if (config_.filter_chains().empty() && (socket_type == Network::Address::SocketType::Stream ||
+                                          !udp_listener_factory_->isTransportConnectionless())) {
     // If we got here, this is a tcp listener or connection-oriented udp listener, so ensure there
     // is a filter chain specified
     throw EnvoyException(fmt::format("error adding listener '{}': no filter chains specified",
                                      address_->asString()));
   } else if (udp_listener_factory_ != nullptr &&
              !udp_listener_factory_->isTransportConnectionless()) {
-    for (auto& filter_chain : config.filter_chains()) {
+    for (auto& filter_chain : config_.filter_chains()) {
       // Early fail if any filter chain doesn't have transport socket configured.
       if (!filter_chain.has_transport_socket()) {
         throw EnvoyException(fmt::format("error adding listener '{}': no transport socket "
@@ -221,67 +395,84 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3alpha::Listener& con
       }
     }
   }
+}
 
+void ListenerImpl::buildFilterChains() {
   Server::Configuration::TransportSocketFactoryContextImpl transport_factory_context(
-      parent_.server_.admin(), parent_.server_.sslContextManager(), *listener_scope_,
+      parent_.server_.admin(), parent_.server_.sslContextManager(), listenerScope(),
       parent_.server_.clusterManager(), parent_.server_.localInfo(), parent_.server_.dispatcher(),
       parent_.server_.random(), parent_.server_.stats(), parent_.server_.singletonManager(),
-      parent_.server_.threadLocal(), validation_visitor, parent_.server_.api());
+      parent_.server_.threadLocal(), validation_visitor_, parent_.server_.api());
   transport_factory_context.setInitManager(initManager());
   // The init manager is a little messy. Will refactor when filter chain manager could accept
   // network filter chain update.
   // TODO(lambdai): create builder from filter_chain_manager to obtain the init manager
   ListenerFilterChainFactoryBuilder builder(*this, transport_factory_context);
-  filter_chain_manager_.addFilterChain(config.filter_chains(), builder, filter_chain_manager_);
-
-  if (socket_type == Network::Address::SocketType::Datagram) {
-    return;
-  }
+  filter_chain_manager_.addFilterChain(config_.filter_chains(), builder, filter_chain_manager_);
+}
 
-  // TCP specific setup.
-  if (config.has_connection_balance_config()) {
-    // Currently exact balance is the only supported type and there are no options.
-    ASSERT(config.connection_balance_config().has_exact_balance());
-    connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+void ListenerImpl::buildConnectionBalancer(uint32_t concurrency) {
+  if (config_.has_connection_balance_config()) {
+    switch (config_.connection_balance_config().balance_type_case()) {
+    case envoy::config::listener::v3alpha::Listener::ConnectionBalanceConfig::kExactBalance:
+      connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+      break;
+    case envoy::config::listener::v3alpha::Listener::ConnectionBalanceConfig::
+        kPowerOfTwoChoicesBalance:
+      connection_balancer_ = std::make_shared<Network::PowerOfTwoChoicesConnectionBalancerImpl>(
+          parent_.server_.random(), concurrency);
+      break;
+    default:
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
   } else {
-    connection_balancer_ = std::make_unique<Network::NopConnectionBalancerImpl>();
+    connection_balancer_ = std::make_shared<Network::NopConnectionBalancerImpl>();
   }
+}
 
-  if (config.has_tcp_fast_open_queue_length()) {
+void ListenerImpl::buildSocketOptions() {
+  if (config_.has_tcp_fast_open_queue_length()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildTcpFastOpenOptions(
-        config.tcp_fast_open_queue_length().value()));
+        config_.tcp_fast_open_queue_length().value()));
   }
+}
 
+void ListenerImpl::buildOriginalDstListenerFilter() {
   // Add original dst listener filter if 'use_original_dst' flag is set.
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hidden_envoy_deprecated_use_original_dst, false)) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, hidden_envoy_deprecated_use_original_dst, false)) {
     auto& factory =
         Config::Utility::getAndCheckFactoryByName<Configuration::NamedListenerFilterConfigFactory>(
             Extensions::ListenerFilters::ListenerFilterNames::get().OriginalDst);
     listener_filter_factories_.push_back(
         factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
   }
+}
+
+void ListenerImpl::buildProxyProtocolListenerFilter() {
   // Add proxy protocol listener filter if 'use_proxy_proto' flag is set.
   // TODO(jrajahalme): This is the last listener filter on purpose. When filter chain matching
   //                   is implemented, this needs to be run after the filter chain has been
   //                   selected.
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.filter_chains()[0], use_proxy_proto, false)) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.filter_chains()[0], use_proxy_proto, false)) {
     auto& factory =
         Config::Utility::getAndCheckFactoryByName<Configuration::NamedListenerFilterConfigFactory>(
             Extensions::ListenerFilters::ListenerFilterNames::get().ProxyProtocol);
     listener_filter_factories_.push_back(
         factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
   }
+}
 
+void ListenerImpl::buildTlsInspectorListenerFilter() {
   const bool need_tls_inspector =
       std::any_of(
-          config.filter_chains().begin(), config.filter_chains().end(),
+          config_.filter_chains().begin(), config_.filter_chains().end(),
           [](const auto& filter_chain) {
             const auto& matcher = filter_chain.filter_chain_match();
             return matcher.transport_protocol() == "tls" ||
                    (matcher.transport_protocol().empty() &&
                     (!matcher.server_names().empty() || !matcher.application_protocols().empty()));
           }) &&
-      !std::any_of(config.listener_filters().begin(), config.listener_filters().end(),
+      !std::any_of(config_.listener_filters().begin(), config_.listener_filters().end(),
                    [](const auto& filter) {
                      return filter.name() ==
                             Extensions::ListenerFilters::ListenerFilterNames::get().TlsInspector;
@@ -328,7 +519,7 @@ Http::Context& ListenerImpl::httpContext() { return parent_.server_.httpContext(
 const LocalInfo::LocalInfo& ListenerImpl::localInfo() const { return parent_.server_.localInfo(); }
 Envoy::Runtime::RandomGenerator& ListenerImpl::random() { return parent_.server_.random(); }
 Envoy::Runtime::Loader& ListenerImpl::runtime() { return parent_.server_.runtime(); }
-Stats::Scope& ListenerImpl::scope() { return *global_scope_; }
+Stats::Scope& ListenerImpl::scope() { return listener_factory_context_->scope(); }
 Singleton::Manager& ListenerImpl::singletonManager() { return parent_.server_.singletonManager(); }
 OverloadManager& ListenerImpl::overloadManager() { return parent_.server_.overloadManager(); }
 ThreadLocal::Instance& ListenerImpl::threadLocal() { return parent_.server_.threadLocal(); }
@@ -370,12 +561,7 @@ void ListenerImpl::createUdpListenerFilterChain(Network::UdpListenerFilterManage
                                                          udp_listener_filter_factories_);
 }
 
-bool ListenerImpl::drainClose() const {
-  // When a listener is draining, the "drain close" decision is the union of the per-listener drain
-  // manager and the server wide drain manager. This allows individual listeners to be drained and
-  // removed independently of a server-wide drain event (e.g., /healthcheck/fail or hot restart).
-  return local_drain_manager_->drainClose() || parent_.server_.drainManager().drainClose();
-}
+bool ListenerImpl::drainClose() const { return listener_factory_context_->drainClose(); }
 
 void ListenerImpl::debugLog(const std::string& message) {
   UNREFERENCED_PARAMETER(message);
@@ -401,10 +587,55 @@ Init::Manager& ListenerImpl::initManager() {
   }
 }
 
+bool ListenerImpl::supportUpdateFilterChain(
+    const envoy::config::listener::v3alpha::Listener& config, bool workers_started) {
+  if (!Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.listener_in_place_filterchain_update")) {
+    return false;
+  }
+  // The in place update needs the active listener on the workers, which exists only once they have
+  // been started.
+  if (!workers_started) {
+    return false;
+  }
+  // Only TCP listeners keep track of their connections per filter chain.
+  if (Network::Utility::protobufAddressSocketType(config_.address()) !=
+          Network::Address::SocketType::Stream ||
+      Network::Utility::protobufAddressSocketType(config.address()) !=
+          Network::Address::SocketType::Stream) {
+    return false;
+  }
+  // A full update rejects a TCP listener without filter chains, keep doing so.
+  if (config.filter_chains().empty()) {
+    return false;
+  }
+  return filterChainOnlyChange(config_, config);
+}
+
+ListenerImplPtr
+ListenerImpl::newListenerWithFilterChain(const envoy::config::listener::v3alpha::Listener& config,
+                                         const std::string& version_info, bool workers_started,
+                                         uint64_t hash) {
+  // The constructor is private, so make_unique can not be used.
+  return ListenerImplPtr(new ListenerImpl(*this, config, version_info, parent_, name_,
+                                          added_via_api_, workers_started, hash));
+}
+
 void ListenerImpl::setSocketFactory(const Network::ListenSocketFactorySharedPtr& socket_factory) {
   ASSERT(!socket_factory_);
   socket_factory_ = socket_factory;
 }
 
+void ListenerImpl::shareSocketFactory(const ListenerImpl& existing) {
+  setSocketFactory(existing.socket_factory_);
+  cpu_steering_option_ = existing.cpu_steering_option_;
+}
+
+void ListenerImpl::stopCpuSteering() {
+  if (cpu_steering_option_ != nullptr) {
+    cpu_steering_option_->stop();
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
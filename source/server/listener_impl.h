@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "envoy/config/core/v3alpha/base.pb.h"
@@ -7,11 +8,13 @@
 #include "envoy/network/filter.h"
 #include "envoy/server/drain_manager.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/server/instance.h"
 #include "envoy/server/listener_manager.h"
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
 #include "common/init/manager_impl.h"
+#include "common/network/reuse_port_socket_option_impl.h"
 
 #include "server/filter_chain_manager_impl.h"
 
@@ -69,6 +72,68 @@ private:
   absl::once_flag steal_once_;
 };
 
+/**
+ * The listener level state of the factory contexts, i.e. the stats scopes and the drain manager.
+ * It is shared by the listeners created by in place filter chain updates of the same listener, so
+ * that the filter chains kept by an update can keep referencing it.
+ */
+class ListenerFactoryContextBaseImpl final : public Configuration::FactoryContext,
+                                             public Network::DrainDecision {
+public:
+  ListenerFactoryContextBaseImpl(Envoy::Server::Instance& server,
+                                 ProtobufMessage::ValidationVisitor& validation_visitor,
+                                 const envoy::config::listener::v3alpha::Listener& config,
+                                 const Network::Address::Instance& address,
+                                 DrainManagerPtr drain_manager);
+
+  // Configuration::FactoryContext
+  AccessLog::AccessLogManager& accessLogManager() override;
+  Upstream::ClusterManager& clusterManager() override;
+  Event::Dispatcher& dispatcher() override;
+  Network::DrainDecision& drainDecision() override;
+  Grpc::Context& grpcContext() override;
+  bool healthCheckFailed() override;
+  Tracing::HttpTracer& httpTracer() override;
+  Http::Context& httpContext() override;
+  Init::Manager& initManager() override;
+  const LocalInfo::LocalInfo& localInfo() const override;
+  Envoy::Runtime::RandomGenerator& random() override;
+  Envoy::Runtime::Loader& runtime() override;
+  Stats::Scope& scope() override;
+  Singleton::Manager& singletonManager() override;
+  OverloadManager& overloadManager() override;
+  ThreadLocal::Instance& threadLocal() override;
+  Admin& admin() override;
+  const envoy::config::core::v3alpha::Metadata& listenerMetadata() const override;
+  envoy::config::core::v3alpha::TrafficDirection direction() const override;
+  TimeSource& timeSource() override;
+  ProtobufMessage::ValidationVisitor& messageValidationVisitor() override;
+  Api::Api& api() override;
+  ServerLifecycleNotifier& lifecycleNotifier() override;
+  OptProcessContextRef processContext() override;
+  Configuration::ServerFactoryContext& getServerFactoryContext() const override;
+  Stats::Scope& listenerScope() override;
+
+  // Network::DrainDecision
+  bool drainClose() const override;
+
+  DrainManager& drainManager() { return *drain_manager_; }
+
+private:
+  Envoy::Server::Instance& server_;
+  const envoy::config::core::v3alpha::Metadata metadata_;
+  const envoy::config::core::v3alpha::TrafficDirection direction_;
+  Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
+  Stats::ScopePtr listener_scope_; // Stats with listener named scope.
+  ProtobufMessage::ValidationVisitor& validation_visitor_;
+  const DrainManagerPtr drain_manager_;
+};
+
+using ListenerFactoryContextBaseImplSharedPtr = std::shared_ptr<ListenerFactoryContextBaseImpl>;
+
+class ListenerImpl;
+using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
+
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
 //                     initializing all listeners after workers are started.
 
@@ -99,6 +164,38 @@ public:
                ProtobufMessage::ValidationVisitor& validation_visitor, uint32_t concurrency);
   ~ListenerImpl() override;
 
+  /**
+   * Determine whether an update of the listener only changes its filter chains and can therefore
+   * be applied in place: the listen socket and the connections of the unchanged filter chains are
+   * kept, and only the connections of the removed filter chains are drained.
+   * @param config supplies the updated configuration proto.
+   * @param workers_started supplies whether the workers have been started, i.e. whether the
+   *        listener is active on the workers.
+   */
+  bool supportUpdateFilterChain(const envoy::config::listener::v3alpha::Listener& config,
+                                bool workers_started);
+
+  /**
+   * Create a listener for an in place filter chain update of this listener. The new listener
+   * takes over the tag, the listen socket factory and the listener level context of this one,
+   * and reuses the filter chains whose config is unchanged.
+   * @see supportUpdateFilterChain().
+   */
+  ListenerImplPtr
+  newListenerWithFilterChain(const envoy::config::listener::v3alpha::Listener& config,
+                             const std::string& version_info, bool workers_started, uint64_t hash);
+
+  /**
+   * Invoke the callback for each filter chain of this listener which is not part of the other
+   * listener, along with the factory context it was built with, if any.
+   */
+  void diffFilterChain(
+      const ListenerImpl& another_listener,
+      const std::function<void(const Network::FilterChain&, FilterChainFactoryContextImpl*)>&
+          callback) const {
+    filter_chain_manager_.diffFilterChains(another_listener.filter_chain_manager_, callback);
+  }
+
   /**
    * Helper functions to determine whether a listener is blocked for update or remove.
    */
@@ -120,8 +217,18 @@ public:
   const Network::ListenSocketFactorySharedPtr& getSocketFactory() const { return socket_factory_; }
   void debugLog(const std::string& message);
   void initialize();
-  DrainManager& localDrainManager() const { return *local_drain_manager_; }
+  DrainManager& localDrainManager() const { return listener_factory_context_->drainManager(); }
   void setSocketFactory(const Network::ListenSocketFactorySharedPtr& socket_factory);
+  /**
+   * Takes over the socket factory of an existing listener for the same address, along with the
+   * CPU steering the factory's sockets are set up with.
+   */
+  void shareSocketFactory(const ListenerImpl& existing);
+  /**
+   * Stops steering new connections to the sockets of this listener by CPU, if enabled. Called
+   * when the listener starts draining and no other listener shares its socket factory.
+   */
+  void stopCpuSteering();
   void setSocketAndOptions(const Network::SocketSharedPtr& socket);
   const Network::Socket::OptionsSharedPtr& listenSocketOptions() { return listen_socket_options_; }
   const std::string& versionInfo() const { return version_info_; }
@@ -143,7 +250,7 @@ public:
   bool continueOnListenerFiltersTimeout() const override {
     return continue_on_listener_filters_timeout_;
   }
-  Stats::Scope& listenerScope() override { return *listener_scope_; }
+  Stats::Scope& listenerScope() override { return listener_factory_context_->listenerScope(); }
   uint64_t listenerTag() const override { return listener_tag_; }
   const std::string& name() const override { return name_; }
   const Network::ActiveUdpListenerFactory* udpListenerFactory() override {
@@ -198,6 +305,25 @@ public:
   SystemTime last_updated_;
 
 private:
+  /**
+   * Create a listener for an in place filter chain update of the origin listener.
+   */
+  ListenerImpl(ListenerImpl& origin, const envoy::config::listener::v3alpha::Listener& config,
+               const std::string& version_info, ListenerManagerImpl& parent,
+               const std::string& name, bool added_via_api, bool workers_started, uint64_t hash);
+
+  // Helpers for constructor.
+  void buildListenSocketOptions(Network::Address::SocketType socket_type, uint32_t concurrency);
+  void buildUdpListenerFactory(Network::Address::SocketType socket_type);
+  void createListenerFilterFactories(Network::Address::SocketType socket_type);
+  void validateFilterChains(Network::Address::SocketType socket_type);
+  void buildFilterChains();
+  void buildConnectionBalancer(uint32_t concurrency);
+  void buildSocketOptions();
+  void buildOriginalDstListenerFilter();
+  void buildProxyProtocolListenerFilter();
+  void buildTlsInspectorListenerFilter();
+
   void addListenSocketOption(const Network::Socket::OptionConstSharedPtr& option) {
     ensureSocketOptions();
     listen_socket_options_->emplace_back(std::move(option));
@@ -209,11 +335,11 @@ private:
 
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
-  FilterChainManagerImpl filter_chain_manager_;
+  // Shared with the listeners of in place filter chain updates, and declared first so that it
+  // outlives everything built with it.
+  ListenerFactoryContextBaseImplSharedPtr listener_factory_context_;
 
   Network::ListenSocketFactorySharedPtr socket_factory_;
-  Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
-  Stats::ScopePtr listener_scope_; // Stats with listener named scope.
   const bool bind_to_port_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
@@ -233,7 +359,6 @@ private:
   std::unique_ptr<Init::WatcherImpl> init_watcher_;
   std::vector<Network::ListenerFilterFactoryCb> listener_filter_factories_;
   std::vector<Network::UdpListenerFilterFactoryCb> udp_listener_filter_factories_;
-  DrainManagerPtr local_drain_manager_;
   bool saw_listener_create_failure_{};
   const envoy::config::listener::v3alpha::Listener config_;
   const std::string version_info_;
@@ -241,7 +366,13 @@ private:
   const std::chrono::milliseconds listener_filters_timeout_;
   const bool continue_on_listener_filters_timeout_;
   Network::ActiveUdpListenerFactoryPtr udp_listener_factory_;
-  Network::ConnectionBalancerPtr connection_balancer_;
+  // The CPU steering the sockets of socket_factory_ are set up with, if enabled.
+  std::shared_ptr<Network::ReusePortCpuSteeringSocketOptionImpl> cpu_steering_option_;
+  // Shared with the listeners of in place filter chain updates, as the active listeners on the
+  // workers stay registered with it.
+  Network::ConnectionBalancerSharedPtr connection_balancer_;
+  // Declared last as it depends on the init manager selection above.
+  FilterChainManagerImpl filter_chain_manager_;
 
   // to access ListenerManagerImpl::factory_.
   friend class ListenerFilterChainFactoryBuilder;
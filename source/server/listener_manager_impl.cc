@@ -372,11 +372,21 @@ bool ListenerManagerImpl::addOrUpdateListenerInternal(
     return false;
   }
 
-  ListenerImplPtr new_listener(
-      new ListenerImpl(config, version_info, *this, name, added_via_api, workers_started_, hash,
-                       added_via_api ? server_.messageValidationContext().dynamicValidationVisitor()
-                                     : server_.messageValidationContext().staticValidationVisitor(),
-                       server_.options().concurrency()));
+  ListenerImplPtr new_listener;
+  // The in place filter chain update needs the listener to be active on the workers.
+  if (existing_active_listener != active_listeners_.end() &&
+      (*existing_active_listener)->supportUpdateFilterChain(config, workers_started_)) {
+    ENVOY_LOG(debug, "use in place filter chain update for listener name={} hash={}", name, hash);
+    new_listener = (*existing_active_listener)
+                       ->newListenerWithFilterChain(config, version_info, workers_started_, hash);
+    stats_.listener_in_place_updated_.inc();
+  } else {
+    new_listener.reset(new ListenerImpl(
+        config, version_info, *this, name, added_via_api, workers_started_, hash,
+        added_via_api ? server_.messageValidationContext().dynamicValidationVisitor()
+                      : server_.messageValidationContext().staticValidationVisitor(),
+        server_.options().concurrency()));
+  }
   ListenerImpl& new_listener_ref = *new_listener;
 
   // We mandate that a listener with the same name must have the same configured address. This
@@ -399,12 +409,12 @@ bool ListenerManagerImpl::addOrUpdateListenerInternal(
     // In this case we can just replace inline.
     ASSERT(workers_started_);
     new_listener->debugLog("update warming listener");
-    new_listener->setSocketFactory((*existing_warming_listener)->getSocketFactory());
+    new_listener->shareSocketFactory(**existing_warming_listener);
     *existing_warming_listener = std::move(new_listener);
   } else if (existing_active_listener != active_listeners_.end()) {
     // In this case we have no warming listener, so what we do depends on whether workers
     // have been started or not. Either way we get the socket from the existing listener.
-    new_listener->setSocketFactory((*existing_active_listener)->getSocketFactory());
+    new_listener->shareSocketFactory(**existing_active_listener);
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -490,7 +500,6 @@ bool ListenerManagerImpl::hasListenerWithAddress(const ListenerList& list,
 
 bool ListenerManagerImpl::shareSocketWithOtherListener(
     const ListenerList& list, const Network::ListenSocketFactorySharedPtr& socket_factory) {
-  ASSERT(socket_factory->sharedSocket().has_value());
   for (const auto& listener : list) {
     if (listener->getSocketFactory() == socket_factory) {
       return true;
@@ -508,6 +517,14 @@ void ListenerManagerImpl::drainListener(ListenerImplPtr&& listener) {
   // restart. Same below inside the lambda.
   stats_.total_listeners_draining_.set(draining_listeners_.size());
 
+  // Stop steering new connections to the sockets of this listener. A listener updated for the
+  // same address shares the socket factory and with it the steering, so leave that alone.
+  const auto& draining_socket_factory = draining_it->listener_->getSocketFactory();
+  if (!shareSocketWithOtherListener(active_listeners_, draining_socket_factory) &&
+      !shareSocketWithOtherListener(warming_listeners_, draining_socket_factory)) {
+    draining_it->listener_->stopCpuSteering();
+  }
+
   // Tell all workers to stop accepting new connections on this listener.
   draining_it->listener_->debugLog("draining listener");
   const uint64_t listener_tag = draining_it->listener_->listenerTag();
@@ -561,6 +578,55 @@ void ListenerManagerImpl::drainListener(ListenerImplPtr&& listener) {
   updateWarmingActiveGauges();
 }
 
+void ListenerManagerImpl::drainFilterChains(ListenerImplPtr&& draining_listener,
+                                            ListenerImpl& new_listener) {
+  std::list<DrainingFilterChains>::iterator draining_it = draining_filter_chains_.emplace(
+      draining_filter_chains_.begin(), std::move(draining_listener), workers_.size());
+  draining_it->listener_->diffFilterChain(
+      new_listener, [&draining_it](const Network::FilterChain& filter_chain,
+                                   FilterChainFactoryContextImpl* factory_context) {
+        if (factory_context != nullptr) {
+          factory_context->startDraining();
+        }
+        draining_it->filter_chains_.push_back(&filter_chain);
+      });
+  const uint64_t filter_chains_size = draining_it->filter_chains_.size();
+  stats_.total_filter_chains_draining_.add(filter_chains_size);
+  draining_it->listener_->debugLog(
+      absl::StrCat("draining ", filter_chains_size, " filter chains of listener"));
+
+  auto remove_filter_chains = [this, draining_it]() -> void {
+    draining_it->listener_->debugLog("removing draining filter chains");
+    for (const auto& worker : workers_) {
+      // Once the drain time has completed, we tell the workers to close the remaining connections
+      // of the filter chains. This also makes sure that the workers have switched to the new
+      // listener before the replaced one is destroyed.
+      worker->removeFilterChains(
+          draining_it->listener_->listenerTag(), draining_it->filter_chains_,
+          [this, draining_it]() -> void {
+            // The completion is called on the worker thread. We post back to the main thread to
+            // avoid locking.
+            server_.dispatcher().post([this, draining_it]() -> void {
+              if (--draining_it->workers_pending_removal_ == 0) {
+                draining_it->listener_->debugLog("draining filter chains removal complete");
+                stats_.total_filter_chains_draining_.sub(draining_it->filter_chains_.size());
+                draining_filter_chains_.erase(draining_it);
+              }
+            });
+          });
+    }
+  };
+
+  if (filter_chains_size == 0) {
+    // No connection needs to drain, the filter chains were only added or kept.
+    remove_filter_chains();
+    return;
+  }
+  // Drain the connections of the filter chains for the server configured drain time.
+  draining_it->drain_timer_ = server_.dispatcher().createTimer(remove_filter_chains);
+  draining_it->drain_timer_->enableTimer(server_.options().drainTime());
+}
+
 ListenerManagerImpl::ListenerList::iterator
 ListenerManagerImpl::getListenerByName(ListenerList& listeners, const std::string& name) {
   auto ret = listeners.end();
@@ -630,7 +696,12 @@ void ListenerManagerImpl::onListenerWarmed(ListenerImpl& listener) {
     // state.
     auto listener = std::move(*existing_active_listener);
     *existing_active_listener = std::move(*existing_warming_listener);
-    drainListener(std::move(listener));
+    if (listener->listenerTag() == (*existing_active_listener)->listenerTag()) {
+      // The workers replaced the config of the listener in place, rather than adding a new one.
+      drainFilterChains(std::move(listener), **existing_active_listener);
+    } else {
+      drainListener(std::move(listener));
+    }
   } else {
     active_listeners_.emplace_back(std::move(*existing_warming_listener));
   }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <list>
 #include <memory>
 
 #include "envoy/admin/v3alpha/config_dump.pb.h"
@@ -8,6 +9,7 @@
 #include "envoy/config/core/v3alpha/config_source.pb.h"
 #include "envoy/config/listener/v3alpha/listener.pb.h"
 #include "envoy/config/listener/v3alpha/listener_components.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/server/filter_config.h"
@@ -98,9 +100,6 @@ private:
   uint64_t next_listener_tag_{1};
 };
 
-class ListenerImpl;
-using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
-
 /**
  * All listener manager stats. @see stats_macros.h
  */
@@ -108,9 +107,11 @@ using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
   COUNTER(listener_added)                                                                          \
   COUNTER(listener_create_failure)                                                                 \
   COUNTER(listener_create_success)                                                                 \
+  COUNTER(listener_in_place_updated)                                                               \
   COUNTER(listener_modified)                                                                       \
   COUNTER(listener_removed)                                                                        \
   COUNTER(listener_stopped)                                                                        \
+  GAUGE(total_filter_chains_draining, NeverImport)                                                 \
   GAUGE(total_listeners_active, NeverImport)                                                       \
   GAUGE(total_listeners_draining, NeverImport)                                                     \
   GAUGE(total_listeners_warming, NeverImport)                                                      \
@@ -171,6 +172,20 @@ private:
     uint64_t workers_pending_removal_;
   };
 
+  /**
+   * A listener replaced by an in place filter chain update. It is kept until the connections of
+   * its filter chains which are not part of the new listener have drained and been closed.
+   */
+  struct DrainingFilterChains {
+    DrainingFilterChains(ListenerImplPtr&& listener, uint64_t workers_pending_removal)
+        : listener_(std::move(listener)), workers_pending_removal_(workers_pending_removal) {}
+
+    ListenerImplPtr listener_;
+    std::list<const Network::FilterChain*> filter_chains_;
+    Event::TimerPtr drain_timer_;
+    uint64_t workers_pending_removal_;
+  };
+
   void addListenerToWorker(Worker& worker, ListenerImpl& listener,
                            ListenerCompletionCallback completion_callback);
   ProtobufTypes::MessagePtr dumpListenerConfigs();
@@ -202,6 +217,15 @@ private:
    */
   void drainListener(ListenerImplPtr&& listener);
 
+  /**
+   * Drain the filter chains of a listener replaced by an in place filter chain update which are not
+   * part of the new listener. The replaced listener is destroyed once the connections of these
+   * filter chains are closed.
+   * @param draining_listener supplies the replaced listener.
+   * @param new_listener supplies the listener replacing it.
+   */
+  void drainFilterChains(ListenerImplPtr&& draining_listener, ListenerImpl& new_listener);
+
   /**
    * Stop a listener. The listener will stop accepting new connections and its socket will be
    * closed.
@@ -234,6 +258,9 @@ private:
   // connections are drained. Then after that time period the listener is removed from all workers
   // and any remaining connections are closed.
   std::list<DrainingListener> draining_listeners_;
+  // Listeners replaced by in place filter chain updates, which wait for the connections of their
+  // removed filter chains to drain.
+  std::list<DrainingFilterChains> draining_filter_chains_;
   std::list<WorkerPtr> workers_;
   bool workers_started_{};
   absl::optional<StopListenersType> stop_listeners_type_;
@@ -125,10 +125,16 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
                                              123, "uint64_t", cmd);
   TCLAP::SwitchArg disable_hot_restart("", "disable-hot-restart",
                                        "Disable hot restart functionality", cmd, false);
+  TCLAP::SwitchArg hot_restart_shared_stats(
+      "", "hot-restart-shared-stats",
+      "Receive the stats of the hot restart parent in a shared memory region", cmd, false);
   TCLAP::SwitchArg enable_mutex_tracing(
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::SwitchArg worker_cpu_affinity(
+      "", "worker-cpu-affinity", "Pin each worker thread to a CPU of the process affinity mask",
+      cmd, false);
 
   TCLAP::ValueArg<bool> use_fake_symbol_table("", "use-fake-symbol-table",
                                               "Use fake symbol table implementation", false, true,
@@ -157,11 +163,13 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   }
 
   hot_restart_disabled_ = disable_hot_restart.getValue();
+  hot_restart_shared_stats_ = hot_restart_shared_stats.getValue();
 
   mutex_tracing_enabled_ = enable_mutex_tracing.getValue();
 
   fake_symbol_table_enabled_ = use_fake_symbol_table.getValue();
   cpuset_threads_ = cpuset_threads.getValue();
+  worker_cpu_affinity_ = worker_cpu_affinity.getValue();
 
   log_level_ = default_log_level;
   for (size_t i = 0; i < ARRAY_SIZE(spdlog::level::level_string_views); i++) {
@@ -317,8 +325,10 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
+  command_line_options->set_hot_restart_shared_stats(hotRestartSharedStats());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
+  command_line_options->set_worker_cpu_affinity(workerCpuAffinityEnabled());
   command_line_options->set_restart_epoch(restartEpoch());
   for (const auto& e : disabledExtensions()) {
     command_line_options->add_disabled_extensions(e);
@@ -334,7 +344,8 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       restart_epoch_(0u), service_cluster_(service_cluster), service_node_(service_node),
       service_zone_(service_zone), file_flush_interval_msec_(10000), drain_time_(600),
       parent_shutdown_time_(900), mode_(Server::Mode::Serve), hot_restart_disabled_(false),
-      signal_handling_enabled_(true), mutex_tracing_enabled_(false), cpuset_threads_(false),
+      hot_restart_shared_stats_(false), signal_handling_enabled_(true),
+      mutex_tracing_enabled_(false), cpuset_threads_(false), worker_cpu_affinity_(false),
       fake_symbol_table_enabled_(false) {}
 
 void OptionsImpl::disableExtensions(const std::vector<std::string>& names) {
@@ -82,10 +82,16 @@ public:
   void setHotRestartDisabled(bool hot_restart_disabled) {
     hot_restart_disabled_ = hot_restart_disabled;
   }
+  void setHotRestartSharedStats(bool hot_restart_shared_stats) {
+    hot_restart_shared_stats_ = hot_restart_shared_stats;
+  }
   void setSignalHandling(bool signal_handling_enabled) {
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setWorkerCpuAffinity(bool worker_cpu_affinity_enabled) {
+    worker_cpu_affinity_ = worker_cpu_affinity_enabled;
+  }
   void setAllowUnkownFields(bool allow_unknown_static_fields) {
     allow_unknown_static_fields_ = allow_unknown_static_fields;
   }
@@ -129,12 +135,14 @@ public:
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
   bool hotRestartDisabled() const override { return hot_restart_disabled_; }
+  bool hotRestartSharedStats() const override { return hot_restart_shared_stats_; }
   bool signalHandlingEnabled() const override { return signal_handling_enabled_; }
   bool mutexTracingEnabled() const override { return mutex_tracing_enabled_; }
   bool fakeSymbolTableEnabled() const override { return fake_symbol_table_enabled_; }
   Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  bool workerCpuAffinityEnabled() const override { return worker_cpu_affinity_; }
   const std::vector<std::string>& disabledExtensions() const override {
     return disabled_extensions_;
   }
@@ -174,9 +182,11 @@ private:
   std::chrono::seconds parent_shutdown_time_;
   Server::Mode mode_;
   bool hot_restart_disabled_;
+  bool hot_restart_shared_stats_;
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
+  bool worker_cpu_affinity_;
   bool fake_symbol_table_enabled_;
   std::vector<std::string> disabled_extensions_;
   uint32_t count_;
@@ -23,18 +23,51 @@ public:
       : threshold_(config.value()) {}
 
   bool updateValue(double value) override {
-    const bool fired = isFired();
+    const OverloadActionState state = actionState();
     value_ = value;
-    return fired != isFired();
+    return state != actionState();
   }
 
-  bool isFired() const override { return value_.has_value() && value_ >= threshold_; }
+  OverloadActionState actionState() const override {
+    return value_.has_value() && value_ >= threshold_ ? OverloadActionState::saturated()
+                                                      : OverloadActionState::inactive();
+  }
 
 private:
   const double threshold_;
   absl::optional<double> value_;
 };
 
+class ScaledTriggerImpl : public OverloadAction::Trigger {
+public:
+  ScaledTriggerImpl(const envoy::config::overload::v3alpha::ScaledTrigger& config)
+      : scaling_threshold_(config.scaling_threshold()),
+        saturation_threshold_(config.saturation_threshold()) {
+    if (scaling_threshold_ >= saturation_threshold_) {
+      throw EnvoyException("scaling_threshold must be less than saturation_threshold");
+    }
+  }
+
+  bool updateValue(double value) override {
+    const OverloadActionState state = actionState();
+    value_ = value;
+    return state != actionState();
+  }
+
+  OverloadActionState actionState() const override {
+    if (!value_.has_value() || value_ <= scaling_threshold_) {
+      return OverloadActionState::inactive();
+    }
+    return OverloadActionState((value_.value() - scaling_threshold_) /
+                               (saturation_threshold_ - scaling_threshold_));
+  }
+
+private:
+  const double scaling_threshold_;
+  const double saturation_threshold_;
+  absl::optional<double> value_;
+};
+
 Stats::Counter& makeCounter(Stats::Scope& scope, absl::string_view a, absl::string_view b) {
   Stats::StatNameManagedStorage stat_name(absl::StrCat("overload.", a, ".", b),
                                           scope.symbolTable());
@@ -53,7 +86,9 @@ Stats::Gauge& makeGauge(Stats::Scope& scope, absl::string_view a, absl::string_v
 OverloadAction::OverloadAction(const envoy::config::overload::v3alpha::OverloadAction& config,
                                Stats::Scope& stats_scope)
     : active_gauge_(
-          makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)) {
+          makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)),
+      scale_percent_gauge_(makeGauge(stats_scope, config.name(), "scale_percent",
+                                     Stats::Gauge::ImportMode::Accumulate)) {
   for (const auto& trigger_config : config.triggers()) {
     TriggerPtr trigger;
 
@@ -61,6 +96,9 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3alpha::OverloadA
     case envoy::config::overload::v3alpha::Trigger::TriggerOneofCase::kThreshold:
       trigger = std::make_unique<ThresholdTriggerImpl>(trigger_config.threshold());
       break;
+    case envoy::config::overload::v3alpha::Trigger::TriggerOneofCase::kScaled:
+      trigger = std::make_unique<ScaledTriggerImpl>(trigger_config.scaled());
+      break;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
@@ -72,29 +110,31 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3alpha::OverloadA
   }
 
   active_gauge_.set(0);
+  scale_percent_gauge_.set(0);
 }
 
 bool OverloadAction::updateResourcePressure(const std::string& name, double pressure) {
-  const bool active = isActive();
+  const OverloadActionState old_state = state_;
 
   auto it = triggers_.find(name);
   ASSERT(it != triggers_.end());
-  if (it->second->updateValue(pressure)) {
-    if (it->second->isFired()) {
-      active_gauge_.set(1);
-      const auto result = fired_triggers_.insert(name);
-      ASSERT(result.second);
-    } else {
-      active_gauge_.set(0);
-      const auto result = fired_triggers_.erase(name);
-      ASSERT(result == 1);
+  if (!it->second->updateValue(pressure)) {
+    return false;
+  }
+  state_ = OverloadActionState::inactive();
+  for (const auto& trigger : triggers_) {
+    const OverloadActionState trigger_state = trigger.second->actionState();
+    if (trigger_state.value() > state_.value()) {
+      state_ = trigger_state;
     }
   }
+  active_gauge_.set(state_.isSaturated() ? 1 : 0);
+  scale_percent_gauge_.set(state_.value() * 100);
 
-  return active != isActive();
+  return old_state != state_;
 }
 
-bool OverloadAction::isActive() const { return !fired_triggers_.empty(); }
+OverloadActionState OverloadAction::getState() const { return state_; }
 
 OverloadManagerImpl::OverloadManagerImpl(
     Event::Dispatcher& dispatcher, Stats::Scope& stats_scope,
@@ -104,7 +144,8 @@ OverloadManagerImpl::OverloadManagerImpl(
     : started_(false), dispatcher_(dispatcher), tls_(slot_allocator.allocateSlot()),
       refresh_interval_(
           std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))) {
-  Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, api, validation_visitor);
+  Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, api, slot_allocator,
+                                                           validation_visitor);
   for (const auto& resource : config.resource_monitors()) {
     const auto& name = resource.name();
     ENVOY_LOG(debug, "Adding resource monitor for {}", name);
@@ -202,11 +243,14 @@ void OverloadManagerImpl::updateResourcePressure(const std::string& resource, do
                   auto action_it = actions_.find(action);
                   ASSERT(action_it != actions_.end());
                   if (action_it->second.updateResourcePressure(resource, pressure)) {
-                    const bool is_active = action_it->second.isActive();
-                    const auto state =
-                        is_active ? OverloadActionState::Active : OverloadActionState::Inactive;
-                    ENVOY_LOG(info, "Overload action {} became {}", action,
-                              is_active ? "active" : "inactive");
+                    const OverloadActionState state = action_it->second.getState();
+                    if (state.isSaturated() || state == OverloadActionState::inactive()) {
+                      ENVOY_LOG(info, "Overload action {} became {}", action,
+                                state.isSaturated() ? "active" : "inactive");
+                    } else {
+                      // Scaled actions change often, as the pressure on their resources does.
+                      ENVOY_LOG(debug, "Overload action {} scaled to {}", action, state.value());
+                    }
                     tls_->runOnAllThreads([this, action, state] {
                       tls_->getTyped<ThreadLocalOverloadState>().setState(action, state);
                     });
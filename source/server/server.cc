@@ -20,6 +20,8 @@
 
 #include "common/api/api_impl.h"
 #include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/memory_account.h"
+#include "common/buffer/slice_pool.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/mutex_tracer_impl.h"
 #include "common/common/utility.h"
@@ -37,6 +39,7 @@
 #include "common/stats/thread_local_store.h"
 #include "common/stats/timespan_impl.h"
 #include "common/upstream/cluster_manager_impl.h"
+#include "common/upstream/health_check_thread.h"
 
 #include "server/configuration_impl.h"
 #include "server/connection_handler_impl.h"
@@ -66,7 +69,7 @@ InstanceImpl::InstanceImpl(
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(new ConnectionHandlerImpl(*dispatcher_, "main_thread")),
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
-      worker_factory_(thread_local_, *api_, hooks),
+      worker_factory_(thread_local_, *api_, hooks, options.workerCpuAffinityEnabled()),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
                           store),
       terminated_(false),
@@ -194,6 +197,14 @@ void InstanceImpl::updateServerStats() {
   server_stats_->memory_allocated_.set(Memory::Stats::totalCurrentlyAllocated() +
                                        parent_stats.parent_memory_allocated_);
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
+  server_stats_->buffer_budget_throttled_.add(Buffer::MemoryBudget::throttledAccounts() -
+                                            server_stats_->buffer_budget_throttled_.value());
+  server_stats_->buffer_huge_page_bytes_.set(Buffer::SlicePool::hugePageBytes());
+  server_stats_->buffer_slice_pool_bytes_.set(Buffer::SlicePool::pooledBytes());
+  server_stats_->buffer_slice_pool_hits_.add(Buffer::SlicePool::hits() -
+                                             server_stats_->buffer_slice_pool_hits_.value());
+  server_stats_->buffer_slice_pool_misses_.add(Buffer::SlicePool::misses() -
+                                               server_stats_->buffer_slice_pool_misses_.value());
   server_stats_->parent_connections_.set(parent_stats.parent_connections_);
   server_stats_->total_connections_.set(listener_manager_->numConnections() +
                                         parent_stats.parent_connections_);
@@ -207,6 +218,10 @@ void InstanceImpl::updateServerStats() {
 
 void InstanceImpl::flushStatsInternal() {
   updateServerStats();
+  if (stats_flush_thread_ != nullptr && !terminated_) {
+    flushStatsOnThread();
+    return;
+  }
   InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
@@ -214,6 +229,34 @@ void InstanceImpl::flushStatsInternal() {
   }
 }
 
+void InstanceImpl::flushStatsOnThread() {
+  // The counters are latched on the main thread, and the sinks flushed on either thread see the
+  // same snapshot. The next flush is only scheduled once the stats flush thread is done with it, so
+  // the histograms are not merged again while the sinks read them.
+  ASSERT(stats_flush_snapshot_ == nullptr);
+  stats_flush_snapshot_ = std::make_unique<MetricSnapshotImpl>(stats_store_);
+  for (const auto& sink : config_.statsSinks()) {
+    if (!sink->flushOffMainThread()) {
+      sink->flush(*stats_flush_snapshot_);
+    }
+  }
+
+  stats_flush_thread_->dispatcher().post([this]() -> void {
+    for (const auto& sink : config_.statsSinks()) {
+      if (sink->flushOffMainThread()) {
+        sink->flush(*stats_flush_snapshot_);
+      }
+    }
+    // The snapshot holds references to the metrics, which must be released on the main thread.
+    dispatcher_->post([this]() -> void {
+      stats_flush_snapshot_.reset();
+      if (stat_flush_timer_ != nullptr) {
+        stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+      }
+    });
+  });
+}
+
 bool InstanceImpl::healthCheckFailed() { return !live_.load(); }
 
 InstanceUtil::BootstrapVersion InstanceUtil::loadBootstrapConfig(
@@ -270,7 +313,8 @@ void InstanceImpl::initialize(const Options& options,
   // Needs to happen as early as possible in the instantiation to preempt the objects that require
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
-  stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  stats_store_.setStatsMatcher(
+      Config::Utility::createStatsMatcher(bootstrap_, stats_store_.symbolTable()));
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
@@ -324,6 +368,10 @@ void InstanceImpl::initialize(const Options& options,
       bootstrap_.node(), local_address, options.serviceZone(), options.serviceClusterName(),
       options.serviceNodeName());
 
+  // Set before any worker buffer is created, so that all the buffers grow alike.
+  Buffer::SlicePool::setHugePages(bootstrap_.buffer_huge_pages());
+  Buffer::MemoryBudget::setWorkerLimit(bootstrap_.worker_buffer_budget_bytes());
+
   Configuration::InitialImpl initial_config(bootstrap_);
 
   // Learn original_start_time_ if our parent is still around to inform us of it.
@@ -356,13 +404,22 @@ void InstanceImpl::initialize(const Options& options,
       *dispatcher_, stats_store_, thread_local_, bootstrap_.overload_manager(),
       messageValidationContext().staticValidationVisitor(), *api_);
 
-  heap_shrinker_ =
-      std::make_unique<Memory::HeapShrinker>(*dispatcher_, *overload_manager_, stats_store_);
+  heap_shrinker_ = std::make_unique<Memory::HeapShrinker>(*dispatcher_, *overload_manager_,
+                                                          thread_local_, stats_store_);
 
   // Workers get created first so they register for thread local updates.
   listener_manager_ = std::make_unique<ListenerManagerImpl>(
       *this, listener_component_factory_, worker_factory_, bootstrap_.enable_dispatcher_stats());
 
+  // Like the workers, the health check and stats flush threads must be registered for thread local
+  // updates before any thread local data is set.
+  if (bootstrap_.cluster_manager().dedicated_health_check_thread()) {
+    health_check_thread_ = std::make_unique<Upstream::HealthCheckThread>(*api_, thread_local_);
+  }
+  if (bootstrap_.dedicated_stats_flush_thread()) {
+    stats_flush_thread_ = std::make_unique<StatsFlushThread>(*api_, thread_local_);
+  }
+
   // The main thread is also registered for thread local updates so that code that does not care
   // whether it runs on the main thread or on workers can still use TLS.
   thread_local_.registerThread(*dispatcher_, true);
@@ -384,13 +441,19 @@ void InstanceImpl::initialize(const Options& options,
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ = createContextManager("ssl_context_manager", time_source_);
 
-  const bool use_tcp_for_dns_lookups = bootstrap_.use_tcp_for_dns_lookups();
-  dns_resolver_ = dispatcher_->createDnsResolver({}, use_tcp_for_dns_lookups);
+  Network::DnsResolverOptions dns_resolver_options;
+  dns_resolver_options.use_tcp_for_dns_lookups_ = bootstrap_.use_tcp_for_dns_lookups();
+  dns_resolver_options.negative_cache_ttl_ =
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(bootstrap_, dns_negative_cache_ttl, 0));
+  dns_resolver_options.channels_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(bootstrap_, dns_resolver_channels, 1);
+  dns_resolver_ = dispatcher_->createDnsResolver({}, dns_resolver_options);
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, *random_generator_,
       dns_resolver_, *ssl_context_manager_, *dispatcher_, *local_info_, *secret_manager_,
-      messageValidationContext(), *api_, http_context_, access_log_manager_, *singleton_manager_);
+      messageValidationContext(), *api_, http_context_, access_log_manager_, *singleton_manager_,
+      health_check_thread_ != nullptr ? &health_check_thread_->dispatcher() : nullptr);
 
   // Now the configuration gets parsed. The configuration may start setting
   // thread local data per above. See MainImpl::initialize() for why ConfigImpl
@@ -412,7 +475,8 @@ void InstanceImpl::initialize(const Options& options,
   if (bootstrap_.has_hds_config()) {
     const auto& hds_config = bootstrap_.hds_config();
     async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
-        *config_.clusterManager(), thread_local_, time_source_, *api_);
+        *config_.clusterManager(), thread_local_, time_source_, *api_,
+        bootstrap_.cluster_manager().google_grpc_completion_threads());
     hds_delegate_ = std::make_unique<Upstream::HdsDelegate>(
         stats_store_,
         Config::Utility::factoryForGrpcApiConfigSource(*async_client_manager_, hds_config,
@@ -581,6 +645,13 @@ void InstanceImpl::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // Wait for the flush in progress on the stats flush thread, as the final flush is done on the
+  // main thread.
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->stop();
+    stats_flush_snapshot_.reset();
+  }
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
@@ -589,6 +660,10 @@ void InstanceImpl::terminate() {
   if (config_.clusterManager() != nullptr) {
     config_.clusterManager()->shutdown();
   }
+  // Stop the health check thread once it has destroyed the health checkers of the clusters.
+  if (health_check_thread_ != nullptr) {
+    health_check_thread_->stop();
+  }
   handler_.reset();
   thread_local_.shutdownThread();
   restarter_.shutdown();
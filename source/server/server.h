@@ -39,6 +39,7 @@
 #include "server/listener_hooks.h"
 #include "server/listener_manager_impl.h"
 #include "server/overload_manager_impl.h"
+#include "server/stats_flush_thread.h"
 #include "server/worker_impl.h"
 
 #include "absl/container/node_hash_map.h"
@@ -51,9 +52,14 @@ namespace Server {
  * All server wide stats. @see stats_macros.h
  */
 #define ALL_SERVER_STATS(COUNTER, GAUGE, HISTOGRAM)                                                \
+  COUNTER(buffer_budget_throttled)                                                                 \
+  COUNTER(buffer_slice_pool_hits)                                                                  \
+  COUNTER(buffer_slice_pool_misses)                                                                \
   COUNTER(debug_assertion_failures)                                                                \
   COUNTER(dynamic_unknown_fields)                                                                  \
   COUNTER(static_unknown_fields)                                                                   \
+  GAUGE(buffer_huge_page_bytes, NeverImport)                                                       \
+  GAUGE(buffer_slice_pool_bytes, NeverImport)                                                      \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, Accumulate)                                                \
   GAUGE(hot_restart_epoch, NeverImport)                                                            \
@@ -244,6 +250,7 @@ private:
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStats();
   void flushStatsInternal();
+  void flushStatsOnThread();
   void updateServerStats();
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory, ListenerHooks& hooks);
@@ -290,11 +297,15 @@ private:
   ProdListenerComponentFactory listener_component_factory_;
   ProdWorkerFactory worker_factory_;
   std::unique_ptr<ListenerManager> listener_manager_;
+  Upstream::HealthCheckThreadPtr health_check_thread_;
   absl::node_hash_map<Stage, LifecycleNotifierCallbacks> stage_callbacks_;
   absl::node_hash_map<Stage, LifecycleNotifierCompletionCallbacks> stage_completable_callbacks_;
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  StatsFlushThreadPtr stats_flush_thread_;
+  // The snapshot being flushed on the stats flush thread, released on the main thread.
+  std::unique_ptr<Stats::MetricSnapshot> stats_flush_snapshot_;
   LocalInfo::LocalInfoPtr local_info_;
   DrainManagerPtr drain_manager_;
   AccessLog::AccessLogManagerImpl access_log_manager_;
@@ -0,0 +1,136 @@
+#include "server/shared_stats_region.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/api/os_sys_calls_impl_hot_restart.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Server {
+
+const uint64_t SharedStatsRegion::VERSION;
+
+namespace {
+
+char* writeRecord(char* cursor, const std::string& name, uint64_t value) {
+  SharedStatsRegion::Record* record = reinterpret_cast<SharedStatsRegion::Record*>(cursor);
+  record->value_ = value;
+  record->name_size_ = name.size();
+  memcpy(cursor + sizeof(SharedStatsRegion::Record), name.data(), name.size());
+  return cursor + SharedStatsRegion::recordSize(name.size());
+}
+
+} // namespace
+
+uint64_t SharedStatsRegion::write(const std::string& name, Stats::Store& store) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  // The region is sized for all the used stats, as the counters can only be latched once the
+  // region exists. The stats are picked first, as more of them may become used meanwhile.
+  std::vector<Stats::GaugeSharedPtr> gauges;
+  std::vector<Stats::CounterSharedPtr> counters;
+  uint64_t size = sizeof(Header);
+  for (auto& gauge : store.gauges()) {
+    if (gauge->used()) {
+      size += recordSize(gauge->name().size());
+      gauges.push_back(std::move(gauge));
+    }
+  }
+  for (auto& counter : store.counters()) {
+    if (counter->used()) {
+      size += recordSize(counter->name().size());
+      counters.push_back(std::move(counter));
+    }
+  }
+
+  const Api::SysCallIntResult result = hot_restart_os_sys_calls.shmOpen(
+      name.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (result.rc_ == -1) {
+    return 0;
+  }
+  if (os_sys_calls.ftruncate(result.rc_, size).rc_ == -1) {
+    os_sys_calls.close(result.rc_);
+    hot_restart_os_sys_calls.shmUnlink(name.c_str());
+    return 0;
+  }
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, result.rc_, 0);
+  os_sys_calls.close(result.rc_);
+  if (mmap_result.rc_ == MAP_FAILED) {
+    hot_restart_os_sys_calls.shmUnlink(name.c_str());
+    return 0;
+  }
+
+  char* base = static_cast<char*>(mmap_result.rc_);
+  Header* header = reinterpret_cast<Header*>(base);
+  header->version_ = VERSION;
+  header->num_gauges_ = 0;
+  header->num_counters_ = 0;
+  char* cursor = base + sizeof(Header);
+  for (const auto& gauge : gauges) {
+    cursor = writeRecord(cursor, gauge->name(), gauge->value());
+    header->num_gauges_++;
+  }
+  for (const auto& counter : counters) {
+    // The hot restart parent is expected to have stopped its normal stat exporting (and so
+    // latching) by the time it begins exporting to the hot restart child.
+    const uint64_t latched_value = counter->latch();
+    if (latched_value > 0) {
+      cursor = writeRecord(cursor, counter->name(), latched_value);
+      header->num_counters_++;
+    }
+  }
+  header->size_ = cursor - base;
+  munmap(base, size);
+  return size;
+}
+
+void SharedStatsRegion::merge(const std::string& name, uint64_t size,
+                              Stats::StatMerger& merger) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  const Api::SysCallIntResult result = hot_restart_os_sys_calls.shmOpen(name.c_str(), O_RDONLY, 0);
+  if (result.rc_ == -1) {
+    PANIC(fmt::format("cannot open hot restart stats region {}. Error: {}", name,
+                      strerror(result.errno_)));
+  }
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_SHARED, result.rc_, 0);
+  os_sys_calls.close(result.rc_);
+  hot_restart_os_sys_calls.shmUnlink(name.c_str());
+  RELEASE_ASSERT(mmap_result.rc_ != MAP_FAILED, "");
+
+  const char* base = static_cast<const char*>(mmap_result.rc_);
+  const Header* header = reinterpret_cast<const Header*>(base);
+  RELEASE_ASSERT(size >= sizeof(Header) && header->version_ == VERSION && header->size_ <= size,
+                 "Hot restart stats region mismatch.");
+  const char* end = base + header->size_;
+  const char* cursor = base + sizeof(Header);
+  for (uint64_t i = 0; i < header->num_gauges_ + header->num_counters_; i++) {
+    RELEASE_ASSERT(end - cursor >= static_cast<std::ptrdiff_t>(sizeof(Record)),
+                   "Hot restart stats region truncated.");
+    const Record* record = reinterpret_cast<const Record*>(cursor);
+    RELEASE_ASSERT(record->name_size_ < static_cast<uint64_t>(end - cursor) &&
+                       recordSize(record->name_size_) <= static_cast<uint64_t>(end - cursor),
+                   "Hot restart stats region truncated.");
+    // The name is merged in place, without being copied out of the region.
+    const absl::string_view stat_name(cursor + sizeof(Record), record->name_size_);
+    if (i < header->num_gauges_) {
+      merger.mergeGauge(stat_name, record->value_);
+    } else {
+      merger.mergeCounter(stat_name, record->value_);
+    }
+    cursor += recordSize(record->name_size_);
+  }
+  munmap(const_cast<char*>(base), size);
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/stats/store.h"
+
+#include "common/stats/stat_merger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Shared memory region into which a hot restart parent lays out the stats it exports to its child,
+ * so that the child merges them straight from the mapping rather than from protobuf maps received
+ * over the domain socket. With many stats this avoids building, serializing and chunking the maps
+ * on one side and parsing them on the other, and the names are merged without being copied.
+ *
+ * The region starts with a Header, followed by the gauges and then the counter deltas. Each of
+ * them is a Record followed by the name of the stat, padded to a multiple of 8 bytes.
+ */
+class SharedStatsRegion {
+public:
+  // Increment this whenever the layout of the region changes.
+  static const uint64_t VERSION = 1;
+
+  struct Header {
+    uint64_t version_;
+    // The bytes in use, which may be fewer than the size of the region.
+    uint64_t size_;
+    uint64_t num_gauges_;
+    uint64_t num_counters_;
+  };
+
+  struct Record {
+    uint64_t value_;
+    uint64_t name_size_;
+  };
+
+  /**
+   * Lays the used gauges and the latched deltas of the used counters of a store out in a new
+   * region, replacing any previous region of the same name.
+   * @param name supplies the name of the shared memory object.
+   * @param store supplies the stats to export.
+   * @return uint64_t the size of the region, or 0 if it could not be created, in which case no
+   *         counter was latched.
+   */
+  static uint64_t write(const std::string& name, Stats::Store& store);
+
+  /**
+   * Merges the stats of a region written by write(), then removes the region.
+   * @param name supplies the name of the shared memory object.
+   * @param size supplies the size returned by write().
+   * @param merger supplies the merger of the stats.
+   */
+  static void merge(const std::string& name, uint64_t size, Stats::StatMerger& merger);
+
+  /**
+   * @return uint64_t the bytes taken by a stat of the given name length.
+   */
+  static uint64_t recordSize(uint64_t name_size) {
+    constexpr uint64_t alignment = sizeof(uint64_t);
+    return sizeof(Record) + (name_size + alignment - 1) / alignment * alignment;
+  }
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,36 @@
+#include "server/stats_flush_thread.h"
+
+namespace Envoy {
+namespace Server {
+
+StatsFlushThread::StatsFlushThread(Api::Api& api, ThreadLocal::Instance& tls)
+    : tls_(tls), dispatcher_(api.allocateDispatcher()) {
+  tls_.registerThread(*dispatcher_, false);
+  thread_ = api.threadFactory().createThread([this]() -> void { threadRoutine(); });
+}
+
+StatsFlushThread::~StatsFlushThread() { stop(); }
+
+void StatsFlushThread::stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  // Exiting from a callback lets the flushes posted before it run first.
+  dispatcher_->post([this]() -> void { dispatcher_->exit(); });
+  thread_->join();
+  thread_.reset();
+}
+
+void StatsFlushThread::threadRoutine() {
+  ENVOY_LOG(debug, "stats flush thread entering dispatch loop");
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "stats flush thread exited dispatch loop");
+
+  // Destroy the connections closed by the sinks on this thread, as their destructors might
+  // reference thread locals.
+  dispatcher_->clearDeferredDeleteList();
+  tls_.shutdownThread();
+}
+
+} // namespace Server
+} // namespace Envoy
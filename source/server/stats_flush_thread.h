@@ -0,0 +1,44 @@
+#pragma once
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Dedicated thread on which the stats sinks supporting it are flushed, so that slow sinks do not
+ * delay the main thread. Like the workers, it is registered for thread local updates so that the
+ * sinks can keep thread local state, and so it must be created before any thread local data is set.
+ */
+class StatsFlushThread : Logger::Loggable<Logger::Id::main> {
+public:
+  StatsFlushThread(Api::Api& api, ThreadLocal::Instance& tls);
+  ~StatsFlushThread();
+
+  /**
+   * @return the dispatcher of the thread.
+   */
+  Event::Dispatcher& dispatcher() { return *dispatcher_; }
+
+  /**
+   * Stop the thread once the flushes already posted to it are done.
+   */
+  void stop();
+
+private:
+  void threadRoutine();
+
+  ThreadLocal::Instance& tls_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+};
+
+using StatsFlushThreadPtr = std::unique_ptr<StatsFlushThread>;
+
+} // namespace Server
+} // namespace Envoy
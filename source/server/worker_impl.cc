@@ -8,30 +8,87 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/macros.h"
+#include "common/http/stream_memory_tracker.h"
+
 #include "server/connection_handler_impl.h"
 
+#if defined(__linux__)
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
 namespace Envoy {
 namespace Server {
 
+namespace {
+
+// The CPUs of the affinity mask of the process, in order.
+std::vector<uint32_t> affinityCpus() {
+  std::vector<uint32_t> cpus;
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (Api::LinuxOsSysCallsSingleton::get().sched_getaffinity(0, sizeof(mask), &mask).rc_ == 0) {
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &mask)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
+// Pins the calling thread to a CPU, returning whether it could be pinned.
+bool pinCurrentThread(uint32_t cpu) {
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(cpu, &mask);
+  return Api::LinuxOsSysCallsSingleton::get().sched_setaffinity(0, sizeof(mask), &mask).rc_ == 0;
+#else
+  UNREFERENCED_PARAMETER(cpu);
+  return false;
+#endif
+}
+
+} // namespace
+
+ProdWorkerFactory::ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api,
+                                     ListenerHooks& hooks, bool cpu_affinity)
+    : tls_(tls), api_(api), hooks_(hooks),
+      worker_cpus_(cpu_affinity ? affinityCpus() : std::vector<uint32_t>()) {
+  if (cpu_affinity && worker_cpus_.empty()) {
+    ENVOY_LOG(warn, "worker CPU affinity isn't supported on this platform, not pinning workers");
+  }
+}
+
 WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager,
                                           const std::string& worker_name) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
+  absl::optional<uint32_t> cpu;
+  if (!worker_cpus_.empty()) {
+    cpu = worker_cpus_[num_workers_++ % worker_cpus_.size()];
+  }
   return WorkerPtr{new WorkerImpl(
       tls_, hooks_, std::move(dispatcher),
       Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(*dispatcher, worker_name)},
-      overload_manager, api_, worker_name)};
+      overload_manager, api_, worker_name, cpu)};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
                        OverloadManager& overload_manager, Api::Api& api,
-                       const std::string& worker_name)
+                       const std::string& worker_name, absl::optional<uint32_t> cpu)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api), worker_name_(worker_name) {
+      api_(api), worker_name_(worker_name), cpu_(cpu) {
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
       [this](OverloadActionState state) { stopAcceptingConnectionsCb(state); });
+  overload_manager.registerForAction(
+      OverloadActionNames::get().ResetHighMemoryStreams, *dispatcher_,
+      [](OverloadActionState state) { resetHighMemoryStreamsCb(state); });
 }
 
 void WorkerImpl::addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) {
@@ -69,6 +126,15 @@ void WorkerImpl::removeListener(Network::ListenerConfig& listener,
   });
 }
 
+void WorkerImpl::removeFilterChains(uint64_t listener_tag,
+                                    const std::list<const Network::FilterChain*>& filter_chains,
+                                    std::function<void()> completion) {
+  ASSERT(thread_);
+  dispatcher_->post([this, listener_tag, filter_chains, completion]() -> void {
+    handler_->removeFilterChains(listener_tag, filter_chains, completion);
+  });
+}
+
 void WorkerImpl::start(GuardDog& guard_dog) {
   ASSERT(!thread_);
   thread_ =
@@ -100,6 +166,11 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
 }
 
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
+  // The worker is pinned before it accepts any connection, so that the memory of its connections
+  // and buffers is first touched, and so placed, on the NUMA node of its CPU.
+  if (cpu_.has_value() && !pinCurrentThread(cpu_.value())) {
+    ENVOY_LOG(warn, "unable to pin {} to CPU {}", worker_name_, cpu_.value());
+  }
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
@@ -119,14 +190,18 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   watch_dog_.reset();
 }
 
+void WorkerImpl::resetHighMemoryStreamsCb(OverloadActionState state) {
+  // The callback runs on the worker thread, whose streams are reset.
+  if (state != OverloadActionState::inactive()) {
+    Http::StreamMemoryTracker::threadTracker().resetLargest(state.value());
+  }
+}
+
 void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
-  switch (state) {
-  case OverloadActionState::Active:
+  if (state.isSaturated()) {
     handler_->disableListeners();
-    break;
-  case OverloadActionState::Inactive:
+  } else {
     handler_->enableListeners();
-    break;
   }
 }
 
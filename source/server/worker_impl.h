@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/api/api.h"
 #include "envoy/network/connection_handler.h"
@@ -14,13 +15,19 @@
 
 #include "server/listener_hooks.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  /**
+   * @param cpu_affinity supplies whether the workers are pinned to the CPUs of the process affinity
+   *        mask, one CPU per worker in turn.
+   */
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks,
+                    bool cpu_affinity);
 
   // Server::WorkerFactory
   WorkerPtr createWorker(OverloadManager& overload_manager,
@@ -30,6 +37,9 @@ private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  // The CPUs the workers are pinned to, which is empty if the workers aren't pinned.
+  const std::vector<uint32_t> worker_cpus_;
+  uint32_t num_workers_{};
 };
 
 /**
@@ -39,12 +49,15 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api, const std::string& worker_name);
+             Api::Api& api, const std::string& worker_name, absl::optional<uint32_t> cpu);
 
   // Server::Worker
   void addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) override;
   uint64_t numConnections() const override;
   void removeListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
+  void removeFilterChains(uint64_t listener_tag,
+                          const std::list<const Network::FilterChain*>& filter_chains,
+                          std::function<void()> completion) override;
   void start(GuardDog& guard_dog) override;
   void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
   void stop() override;
@@ -53,6 +66,7 @@ public:
 private:
   void threadRoutine(GuardDog& guard_dog);
   void stopAcceptingConnectionsCb(OverloadActionState state);
+  static void resetHighMemoryStreamsCb(OverloadActionState state);
 
   ThreadLocal::Instance& tls_;
   ListenerHooks& hooks_;
@@ -61,6 +75,8 @@ private:
   Api::Api& api_;
   Thread::ThreadPtr thread_;
   const std::string worker_name_;
+  // The CPU the worker thread is pinned to, if any.
+  const absl::optional<uint32_t> cpu_;
   WatchDogSharedPtr watch_dog_;
 };
 
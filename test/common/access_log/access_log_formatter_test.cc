@@ -1537,6 +1537,30 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+// formatTo() appends the same line as format() returns, keeping the existing output.
+TEST(AccessLogFormatterTest, CompositeFormatterAppends) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
+  Http::TestHeaderMapImpl response_header{{"second", "PUT"}};
+  Http::TestHeaderMapImpl response_trailer;
+
+  const SystemTime start_time(std::chrono::microseconds(1522796769123456));
+  EXPECT_CALL(stream_info, startTime()).WillRepeatedly(Return(start_time));
+  EXPECT_CALL(stream_info, bytesReceived()).WillRepeatedly(Return(1234));
+  EXPECT_CALL(stream_info, requestComplete())
+      .WillRepeatedly(Return(absl::optional<std::chrono::nanoseconds>()));
+
+  const std::string format = "[%START_TIME%] %REQ(FIRST):2% %RESP(FIRST?SECOND)% %REQ(NONE)% "
+                             "%BYTES_RECEIVED% %DURATION% %START_TIME(%s.%3f)%";
+  FormatterImpl formatter(format);
+
+  std::string output = "prefix ";
+  formatter.formatTo(request_header, response_header, response_trailer, stream_info, output);
+  EXPECT_EQ("prefix [2018-04-03T23:06:09.123Z] GE PUT - 1234 - 1522796769.123", output);
+  EXPECT_EQ(output.substr(7),
+            formatter.format(request_header, response_header, response_trailer, stream_info));
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
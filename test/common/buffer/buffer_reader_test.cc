@@ -0,0 +1,88 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/buffer_reader.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+// Build a buffer holding each of the strings in its own slice.
+void addSlices(OwnedImpl& buffer, const std::vector<std::string>& slices) {
+  for (const std::string& data : slices) {
+    OwnedImpl slice(data);
+    buffer.move(slice);
+  }
+}
+
+TEST(BufferReaderTest, Empty) {
+  OwnedImpl buffer;
+  Reader reader(buffer);
+  EXPECT_EQ(0, reader.remaining());
+  EXPECT_TRUE(reader.contiguous().empty());
+  EXPECT_TRUE(reader.skip(0));
+  EXPECT_FALSE(reader.skip(1));
+  uint8_t value;
+  EXPECT_FALSE(reader.readInt(value));
+  EXPECT_EQ(-1, reader.find('a'));
+}
+
+TEST(BufferReaderTest, ReadAcrossSlices) {
+  OwnedImpl buffer;
+  addSlices(buffer, {"ab", "", "cdef", "g"});
+  Reader reader(buffer);
+  EXPECT_EQ(7, reader.remaining());
+  EXPECT_EQ("ab", reader.contiguous());
+
+  char data[3];
+  EXPECT_TRUE(reader.read(data, 3));
+  EXPECT_EQ("abc", std::string(data, 3));
+  EXPECT_EQ(3, reader.position());
+  EXPECT_EQ("def", reader.contiguous());
+
+  EXPECT_FALSE(reader.read(data, 5));
+  EXPECT_EQ(3, reader.position());
+
+  EXPECT_TRUE(reader.skip(3));
+  EXPECT_EQ("g", reader.contiguous());
+  EXPECT_TRUE(reader.skip(1));
+  EXPECT_EQ(0, reader.remaining());
+  EXPECT_TRUE(reader.contiguous().empty());
+}
+
+TEST(BufferReaderTest, ReadInts) {
+  OwnedImpl buffer;
+  addSlices(buffer, {std::string("\x01\x02", 2), std::string("\x03\x04\x05", 3)});
+  Reader reader(buffer);
+
+  uint32_t value;
+  EXPECT_TRUE(reader.readBEInt(value));
+  EXPECT_EQ(0x01020304, value);
+  EXPECT_FALSE(reader.readBEInt(value));
+
+  uint8_t byte;
+  EXPECT_TRUE(reader.readInt(byte));
+  EXPECT_EQ(5, byte);
+
+  Reader le_reader(buffer);
+  uint16_t le_value;
+  EXPECT_TRUE(le_reader.readLEInt(le_value));
+  EXPECT_EQ(0x0201, le_value);
+}
+
+TEST(BufferReaderTest, Find) {
+  OwnedImpl buffer;
+  addSlices(buffer, {"ab\r", "cd", "e\rf"});
+  Reader reader(buffer);
+  EXPECT_EQ(2, reader.find('\r'));
+  EXPECT_EQ(4, reader.find('d'));
+
+  // The search starts at the cursor.
+  EXPECT_TRUE(reader.skip(3));
+  EXPECT_EQ(6, reader.find('\r'));
+  EXPECT_EQ(-1, reader.find('a'));
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
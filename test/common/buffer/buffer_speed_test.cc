@@ -1,4 +1,5 @@
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/buffer_reader.h"
 #include "common/common/assert.h"
 
 #include "absl/strings/string_view.h"
@@ -365,6 +366,68 @@ BENCHMARK(BufferStartsWithMatch)
     ->Args({16384, 256})
     ->Args({65536, 4096});
 
+// Test buffer search, when the buffer is made of many small slices and the pattern spans two of
+// them.
+static void BufferSearchManySlices(benchmark::State& state) {
+  const std::string Pattern("\r\n");
+  Buffer::OwnedImpl buffer;
+  for (int64_t i = 0; i < state.range(0) / 64; i++) {
+    Buffer::OwnedImpl slice(std::string(64, 'a'));
+    buffer.move(slice);
+  }
+  Buffer::OwnedImpl end("\r");
+  buffer.move(end);
+  Buffer::OwnedImpl pattern_end("\n");
+  buffer.move(pattern_end);
+
+  ssize_t result = 0;
+  for (auto _ : state) {
+    result += buffer.search(Pattern.c_str(), Pattern.length(), 0);
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(BufferSearchManySlices)->Arg(64)->Arg(4096)->Arg(16384)->Arg(65536);
+
+// Test reading consecutive integers from a buffer made of many small slices with peekBEInt(),
+// which walks the slices from the front of the buffer on each read.
+static void BufferPeekInts(benchmark::State& state) {
+  Buffer::OwnedImpl buffer;
+  for (int64_t i = 0; i < state.range(0) / 64; i++) {
+    Buffer::OwnedImpl slice(std::string(64, 'a'));
+    buffer.move(slice);
+  }
+
+  uint64_t result = 0;
+  for (auto _ : state) {
+    for (uint64_t offset = 0; offset + sizeof(uint32_t) <= buffer.length();
+         offset += sizeof(uint32_t)) {
+      result += buffer.peekBEInt<uint32_t>(offset);
+    }
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(BufferPeekInts)->Arg(64)->Arg(4096)->Arg(16384)->Arg(65536);
+
+// Test reading the same integers with a Buffer::Reader, which keeps its position in the slices.
+static void BufferReaderReadInts(benchmark::State& state) {
+  Buffer::OwnedImpl buffer;
+  for (int64_t i = 0; i < state.range(0) / 64; i++) {
+    Buffer::OwnedImpl slice(std::string(64, 'a'));
+    buffer.move(slice);
+  }
+
+  uint64_t result = 0;
+  for (auto _ : state) {
+    Buffer::Reader reader(buffer);
+    uint32_t value;
+    while (reader.readBEInt(value)) {
+      result += value;
+    }
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(BufferReaderReadInts)->Arg(64)->Arg(4096)->Arg(16384)->Arg(65536);
+
 } // namespace Envoy
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
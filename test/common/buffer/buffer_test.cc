@@ -1,4 +1,5 @@
 #include <limits>
+#include <vector>
 
 #include "envoy/common/exception.h"
 
@@ -224,6 +225,54 @@ TEST(UnownedSliceTest, CreateDeleteOwnedBufferFragment) {
   EXPECT_TRUE(release_callback_called);
 }
 
+// The memory of a freed slice is reused by the next slice of the same size on the thread.
+TEST(SlicePoolTest, ReuseFreedSlice) {
+  auto slice = OwnedSlice::create(100);
+  const void* data = slice->data();
+  slice.reset();
+
+  const uint64_t hits = SlicePool::hits();
+  auto other_slice = OwnedSlice::create(200);
+  EXPECT_EQ(data, other_slice->data());
+  EXPECT_EQ(hits + 1, SlicePool::hits());
+}
+
+// The slices of sizes which are not pooled, and the slices freed once the free lists of the thread
+// are full, are returned to the allocator.
+TEST(SlicePoolTest, Bounded) {
+  constexpr uint64_t MaxPooledBytes = SlicePool::MaxPooledBytes;
+  std::vector<SlicePtr> slices;
+  for (uint64_t i = 0; i < 2 * MaxPooledBytes / 65536; ++i) {
+    slices.push_back(OwnedSlice::create(60000));
+  }
+  slices.push_back(OwnedSlice::create(1024 * 1024));
+  slices.clear();
+  EXPECT_LE(SlicePool::pooledBytes(), MaxPooledBytes);
+  EXPECT_GT(SlicePool::pooledBytes(), MaxPooledBytes - 65536);
+}
+
+// When huge pages are enabled, the buffers holding at least a large block worth of data grow by
+// large slices, carved out of huge page regions.
+TEST(SlicePoolTest, HugePageSlices) {
+  SlicePool::setHugePages(true);
+  OwnedImpl buffer;
+  const std::string data(16384, 'a');
+  while (buffer.length() < SlicePool::LargeBlockSize) {
+    buffer.add(data);
+  }
+  const uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  buffer.add(data);
+  EXPECT_EQ(num_slices + 1, buffer.getRawSlices(nullptr, 0));
+  EXPECT_GT(SlicePool::hugePageBytes(), 0);
+
+  // The large slice has room for the next adds.
+  for (int i = 0; i < 8; ++i) {
+    buffer.add(data);
+  }
+  EXPECT_EQ(num_slices + 1, buffer.getRawSlices(nullptr, 0));
+  SlicePool::setHugePages(false);
+}
+
 TEST(SliceDequeTest, CreateDelete) {
   bool slice1_deleted = false;
   bool slice2_deleted = false;
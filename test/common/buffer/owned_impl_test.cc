@@ -453,6 +453,18 @@ TEST_F(OwnedImplTest, Search) {
   EXPECT_EQ(-1, buffer.search("abaaaabaaaaabaa", 15, 0));
 }
 
+TEST_F(OwnedImplTest, SearchWithinAndAcrossSlices) {
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("xxabcabxabcdx");
+  buffer.appendSliceForTest("cdab");
+  EXPECT_EQ(8, buffer.search("abcd", 4, 0));
+  EXPECT_EQ(13, buffer.search("cdab", 4, 9));
+  EXPECT_EQ(5, buffer.search("abxa", 4, 0));
+  EXPECT_EQ(11, buffer.search("dxc", 3, 0));
+  EXPECT_EQ(-1, buffer.search("abz", 3, 9));
+  EXPECT_EQ(-1, buffer.search("dabx", 4, 0));
+}
+
 TEST_F(OwnedImplTest, StartsWith) {
   // Populate a buffer with a string split across many small slices, to
   // exercise edge cases in the startsWith implementation.
@@ -563,6 +575,85 @@ TEST_F(OwnedImplTest, ReserveZeroCommit) {
   EXPECT_EQ("bbbbb", buf.toString().substr(0, 5));
 }
 
+// The content added with addShared() is shared by both buffers rather than copied, and the new
+// content of either buffer goes to new slices.
+TEST_F(OwnedImplTest, AddShared) {
+  Buffer::OwnedImpl buffer("hello");
+  Buffer::OwnedImpl shared;
+  shared.addShared(buffer);
+  EXPECT_EQ(5, buffer.length());
+  EXPECT_EQ(5, shared.length());
+
+  RawSlice slice;
+  RawSlice shared_slice;
+  ASSERT_EQ(1, buffer.getRawSlices(&slice, 1));
+  ASSERT_EQ(1, shared.getRawSlices(&shared_slice, 1));
+  EXPECT_EQ(slice.mem_, shared_slice.mem_);
+
+  buffer.add(" world");
+  shared.add("!");
+  EXPECT_EQ("hello world", buffer.toString());
+  EXPECT_EQ("hello!", shared.toString());
+
+  // Sharing again does not nest the shared slices.
+  Buffer::OwnedImpl shared_again;
+  shared_again.addShared(shared);
+  EXPECT_EQ("hello!", shared_again.toString());
+
+  buffer.drain(buffer.length());
+  shared.drain(2);
+  EXPECT_EQ("llo!", shared.toString());
+  EXPECT_EQ("hello!", shared_again.toString());
+
+  // Prepending does not write over the drained content, which is still shared.
+  shared.prepend("HE");
+  EXPECT_EQ("HEllo!", shared.toString());
+  EXPECT_EQ("hello!", shared_again.toString());
+}
+
+// A shared fragment is released once all the buffers sharing it drained it.
+TEST_F(OwnedImplTest, AddSharedFragment) {
+  char input[] = "hello world";
+  BufferFragmentImpl frag(input, 11, [this](const void*, size_t, const BufferFragmentImpl*) {
+    release_callback_called_ = true;
+  });
+  Buffer::OwnedImpl buffer;
+  buffer.addBufferFragment(frag);
+  Buffer::OwnedImpl shared;
+  shared.addShared(buffer);
+
+  buffer.drain(11);
+  EXPECT_FALSE(release_callback_called_);
+  EXPECT_EQ("hello world", shared.toString());
+  shared.drain(11);
+  EXPECT_TRUE(release_callback_called_);
+}
+
+// The space reserved but not filled is released, while the slices holding content are kept.
+TEST_F(OwnedImplTest, ReleaseEmptySlices) {
+  Buffer::OwnedImpl buffer;
+  static constexpr uint64_t NumIovecs = 2;
+  Buffer::RawSlice iovecs[NumIovecs];
+  EXPECT_EQ(0, buffer.releaseEmptySlices());
+
+  // An unused reservation is released.
+  EXPECT_EQ(1, buffer.reserve(8192, iovecs, NumIovecs));
+  EXPECT_EQ(1, buffer.releaseEmptySlices());
+  EXPECT_EQ(0, buffer.releaseEmptySlices());
+
+  // Only the slices past the content are released.
+  buffer.add("hello");
+  EXPECT_EQ(2, buffer.reserve(16384, iovecs, NumIovecs));
+  EXPECT_EQ(1, buffer.releaseEmptySlices());
+  EXPECT_EQ("hello", buffer.toString());
+
+  // Once drained, the content slices are gone too.
+  EXPECT_EQ(1, buffer.reserve(8192, iovecs, 1));
+  buffer.drain(5);
+  EXPECT_EQ(1, buffer.releaseEmptySlices());
+  EXPECT_EQ(0, buffer.length());
+}
+
 TEST(OverflowDetectingUInt64, Arithmetic) {
   Logger::StderrSinkDelegate stderr_sink(Logger::Registry::getSink()); // For coverage build.
   OverflowDetectingUInt64 length;
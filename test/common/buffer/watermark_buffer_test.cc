@@ -5,6 +5,7 @@
 #include "common/network/io_socket_handle_impl.h"
 
 #include "test/common/buffer/utility.h"
+#include "test/test_common/environment.h"
 
 #include "gtest/gtest.h"
 
@@ -320,6 +321,139 @@ TEST_F(WatermarkBufferTest, MoveBackWithWatermarks) {
   EXPECT_EQ(1, low_watermark_buffer1);
 }
 
+// The data past the threshold is moved to the spill file, and still counts towards the
+// watermarks.
+TEST_F(WatermarkBufferTest, SpillToFile) {
+  buffer_.setSpillToFile(4, TestEnvironment::temporaryDirectory());
+  buffer_.add(TEN_BYTES, 10);
+  buffer_.add(std::string(TEN_BYTES));
+  EXPECT_EQ(1, times_high_watermark_called_);
+  OwnedImpl other(TEN_BYTES);
+  buffer_.move(other, 5);
+  buffer_.move(other);
+  EXPECT_EQ(0, other.length());
+  EXPECT_EQ(30, buffer_.length());
+  EXPECT_EQ("012345678901234567890123456789", buffer_.toString());
+
+  // The first slice holds the bytes kept in memory.
+  RawSlice slice;
+  buffer_.getRawSlices(&slice, 1);
+  EXPECT_EQ(4, slice.len_);
+
+  buffer_.drain(25);
+  EXPECT_EQ(1, times_low_watermark_called_);
+  EXPECT_EQ("56789", buffer_.toString());
+}
+
+// The spilled data can be shared with other buffers, and outlives the buffer.
+TEST_F(WatermarkBufferTest, SpilledDataShared) {
+  OwnedImpl copy;
+  {
+    Buffer::WatermarkBuffer buffer{[]() -> void {}, []() -> void {}};
+    buffer.setSpillToFile(2, TestEnvironment::temporaryDirectory());
+    buffer.add(TEN_BYTES, 10);
+    copy.addShared(buffer);
+
+    RawSlice slices[2];
+    RawSlice copy_slices[2];
+    ASSERT_EQ(2, buffer.getRawSlices(slices, 2));
+    ASSERT_EQ(2, copy.getRawSlices(copy_slices, 2));
+    EXPECT_EQ(slices[1].mem_, copy_slices[1].mem_);
+    EXPECT_EQ(10, buffer.length());
+  }
+  EXPECT_EQ("0123456789", copy.toString());
+}
+
+// The data is kept in memory when the spill file cannot be created.
+TEST_F(WatermarkBufferTest, SpillToMissingDirectory) {
+  buffer_.setSpillToFile(4, TestEnvironment::temporaryPath("missing/directory"));
+  buffer_.add(TEN_BYTES, 10);
+  buffer_.add(TEN_BYTES, 10);
+  EXPECT_EQ("01234567890123456789", buffer_.toString());
+  EXPECT_EQ(1, times_high_watermark_called_);
+}
+
+class MemoryBudgetTest : public testing::Test {
+public:
+  MemoryBudgetTest() { MemoryBudget::setWorkerLimit(100); }
+  ~MemoryBudgetTest() override { MemoryBudget::setWorkerLimit(0); }
+
+  uint32_t times_low_called_[2]{};
+  uint32_t times_high_called_[2]{};
+  Buffer::WatermarkBuffer buffers_[2]{
+      {[&]() -> void { ++times_low_called_[0]; }, [&]() -> void { ++times_high_called_[0]; }},
+      {[&]() -> void { ++times_low_called_[1]; }, [&]() -> void { ++times_high_called_[1]; }}};
+};
+
+TEST_F(MemoryBudgetTest, Disabled) {
+  MemoryBudget::setWorkerLimit(0);
+  EXPECT_EQ(nullptr, MemoryAccount::create(MemoryClass::FilterBody));
+}
+
+// The largest account is throttled when the worker goes over its budget, and released once it has
+// drained.
+TEST_F(MemoryBudgetTest, ThrottleLargest) {
+  const uint64_t throttled = MemoryBudget::throttledAccounts();
+  buffers_[0].setMemoryAccount(MemoryAccount::create(MemoryClass::DownstreamConnection));
+  buffers_[1].setMemoryAccount(MemoryAccount::create(MemoryClass::UpstreamConnection));
+  buffers_[0].add(std::string(30, 'a'));
+  buffers_[1].add(std::string(80, 'b'));
+  EXPECT_EQ(110, MemoryBudget::threadBudget().bytes());
+  EXPECT_EQ(80, MemoryBudget::threadBudget().bytes(MemoryClass::UpstreamConnection));
+  EXPECT_EQ(0, times_high_called_[0]);
+  EXPECT_EQ(1, times_high_called_[1]);
+  EXPECT_TRUE(buffers_[1].aboveBudget());
+  EXPECT_EQ(throttled + 1, MemoryBudget::throttledAccounts());
+
+  buffers_[1].drain(80);
+  EXPECT_EQ(1, times_low_called_[1]);
+  EXPECT_FALSE(buffers_[1].aboveBudget());
+  EXPECT_EQ(30, MemoryBudget::threadBudget().bytes());
+
+  buffers_[0].drain(30);
+  EXPECT_EQ(0, MemoryBudget::threadBudget().bytes());
+}
+
+// The buffers sharing an account are throttled together, and released once the worker is back
+// under half its budget.
+TEST_F(MemoryBudgetTest, SharedAccount) {
+  MemoryAccountSharedPtr account = MemoryAccount::create(MemoryClass::FilterBody);
+  buffers_[0].setMemoryAccount(account);
+  buffers_[1].setMemoryAccount(account);
+  buffers_[0].add(std::string(60, 'a'));
+  buffers_[1].add(std::string(60, 'b'));
+  EXPECT_EQ(120, account->bytes());
+  EXPECT_TRUE(account->throttled());
+  EXPECT_EQ(1, times_high_called_[0]);
+  EXPECT_EQ(1, times_high_called_[1]);
+
+  buffers_[0].drain(60);
+  EXPECT_EQ(0, times_low_called_[0]);
+  buffers_[1].drain(20);
+  EXPECT_FALSE(account->throttled());
+  EXPECT_EQ(1, times_low_called_[0]);
+  EXPECT_EQ(1, times_low_called_[1]);
+
+  // A buffer leaving its account gives back its bytes.
+  buffers_[1].setMemoryAccount(nullptr);
+  EXPECT_EQ(0, account->bytes());
+}
+
+// The factory charges the buffers it creates for a memory class to a new account of that class.
+TEST_F(MemoryBudgetTest, FactoryChargesMemoryClass) {
+  WatermarkBufferFactory factory;
+  InstancePtr buffer = factory.create([]() -> void {}, []() -> void {}, MemoryClass::FilterBody);
+  buffer->add(std::string(40, 'a'));
+  EXPECT_EQ(40, MemoryBudget::threadBudget().bytes(MemoryClass::FilterBody));
+  buffer.reset();
+  EXPECT_EQ(0, MemoryBudget::threadBudget().bytes(MemoryClass::FilterBody));
+
+  // The buffers created without a memory class are not charged.
+  buffer = factory.create([]() -> void {}, []() -> void {});
+  buffer->add(std::string(40, 'a'));
+  EXPECT_EQ(0, MemoryBudget::threadBudget().bytes());
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
@@ -0,0 +1,38 @@
+#include "common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(Arena, AllocatesFromBlocks) {
+  Arena arena(1024);
+  EXPECT_EQ(0, arena.bytesReserved());
+
+  char* a = static_cast<char*>(arena.allocate(10));
+  char* b = static_cast<char*>(arena.allocate(10));
+  EXPECT_EQ(1024, arena.bytesReserved());
+  EXPECT_EQ(a + alignof(std::max_align_t), b);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a) % alignof(std::max_align_t));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(b) % alignof(std::max_align_t));
+  EXPECT_EQ(2 * alignof(std::max_align_t), arena.bytesAllocated());
+
+  // Does not fit in the rest of the first block.
+  arena.allocate(1000);
+  EXPECT_EQ(2048, arena.bytesReserved());
+}
+
+TEST(Arena, LargeAllocationsGetTheirOwnBlock) {
+  Arena arena(128);
+  arena.allocate(16);
+  arena.allocate(4096);
+  EXPECT_EQ(128 + 4096, arena.bytesReserved());
+
+  // The current block is still used for small allocations.
+  arena.allocate(16);
+  EXPECT_EQ(128 + 4096, arena.bytesReserved());
+  EXPECT_EQ(16 + 4096 + 16, arena.bytesAllocated());
+}
+
+} // namespace
+} // namespace Envoy
@@ -0,0 +1,89 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/base64.h"
+#include "common/common/hex.h"
+
+#include "benchmark/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+namespace Envoy {
+
+static std::string makeInput(size_t length) {
+  std::string input(length, 0);
+  for (size_t i = 0; i < length; i++) {
+    input[i] = static_cast<char>(i * 37);
+  }
+  return input;
+}
+
+static void BM_Base64Encode(benchmark::State& state) {
+  const std::string input = makeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Base64::encode(input.data(), input.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Base64Encode)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_Base64EncodeBuffer(benchmark::State& state) {
+  const std::string input = makeInput(state.range(0));
+  // The input is split in odd slices, so that groups straddle slices.
+  Buffer::OwnedImpl buffer;
+  for (size_t i = 0; i < input.size(); i += 1001) {
+    Buffer::OwnedImpl slice(input.substr(i, 1001));
+    buffer.move(slice);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Base64::encode(buffer, buffer.length()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Base64EncodeBuffer)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_Base64Decode(benchmark::State& state) {
+  const std::string input = makeInput(state.range(0));
+  const std::string encoded = Base64::encode(input.data(), input.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Base64::decode(encoded));
+  }
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_Base64Decode)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_HexEncode(benchmark::State& state) {
+  const std::string input = makeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        Hex::encode(reinterpret_cast<const uint8_t*>(input.data()), input.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_HexEncode)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_HexDecode(benchmark::State& state) {
+  const std::string input = makeInput(state.range(0));
+  const std::string encoded =
+      Hex::encode(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Hex::decode(encoded));
+  }
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_HexDecode)->Arg(16)->Arg(1024)->Arg(65536);
+
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -120,6 +120,19 @@ TEST(Base64Test, MultiSlicesBufferEncode) {
   EXPECT_EQ("Zm9vYmFy", Base64::encode(buffer, 7));
 }
 
+// Every length of input, in whole groups or not, round trips.
+TEST(Base64Test, RoundTripLengths) {
+  std::string input;
+  for (uint32_t i = 0; i < 20; i++) {
+    const std::string encoded = Base64::encode(input.data(), input.size());
+    EXPECT_EQ(0, encoded.size() % 4);
+    EXPECT_EQ(input, Base64::decode(encoded));
+    EXPECT_EQ(input, Base64::decodeWithoutPadding(
+                         Base64::encode(input.data(), input.size(), /*add_padding=*/false)));
+    input.push_back(static_cast<char>(i * 37));
+  }
+}
+
 TEST(Base64Test, BinaryBufferEncode) {
   Buffer::OwnedImpl buffer;
   buffer.add("\0\1\2\3", 4);
@@ -132,6 +145,72 @@ TEST(Base64Test, BinaryBufferEncode) {
   EXPECT_EQ("AAECAwgKCQCqvN4=", Base64::encode(buffer, 30));
 }
 
+TEST(Base64StreamEncoderTest, Encode) {
+  Base64StreamEncoder encoder;
+  Buffer::OwnedImpl output;
+  // The bytes of an incomplete group are kept until more bytes come.
+  encoder.encode(reinterpret_cast<const uint8_t*>("fo"), 2, output);
+  EXPECT_EQ("", output.toString());
+  encoder.encode(reinterpret_cast<const uint8_t*>("obarb"), 5, output);
+  EXPECT_EQ("Zm9vYmFy", output.toString());
+  encoder.flush(output);
+  EXPECT_EQ("Zm9vYmFyYg==", output.toString());
+  // Flushing without bytes kept adds nothing, and the next bytes start a new encoding.
+  encoder.flush(output);
+  encoder.encode(reinterpret_cast<const uint8_t*>("fo"), 2, output);
+  encoder.flush(output);
+  EXPECT_EQ("Zm9vYmFyYg==Zm8=", output.toString());
+}
+
+TEST(Base64StreamEncoderTest, EncodeMatchesEncode) {
+  const std::string input("\0\0\0\0als;jkopqitu[\0opbjlcxnb35g]b[\xaa\b\n", 36);
+  for (size_t split = 0; split <= input.size(); ++split) {
+    Base64StreamEncoder encoder;
+    Buffer::OwnedImpl output;
+    encoder.encode(reinterpret_cast<const uint8_t*>(input.data()), split, output);
+    encoder.encode(reinterpret_cast<const uint8_t*>(input.data()) + split, input.size() - split,
+                   output);
+    encoder.flush(output);
+    EXPECT_EQ(Base64::encode(input.data(), input.size()), output.toString());
+  }
+}
+
+TEST(Base64StreamDecoderTest, Decode) {
+  Base64StreamDecoder decoder;
+  Buffer::OwnedImpl output;
+  // The characters of an incomplete group are kept until more characters come, across slices.
+  Buffer::OwnedImpl input;
+  input.add("Zm9");
+  EXPECT_TRUE(decoder.decode(input, output));
+  EXPECT_EQ(3, decoder.pending());
+  EXPECT_EQ("", output.toString());
+
+  input.drain(input.length());
+  input.add("vYm");
+  input.add("Fy", 2);
+  input.add("Yg==Zm8=Zg");
+  EXPECT_TRUE(decoder.decode(input, output));
+  EXPECT_EQ(2, decoder.pending());
+  // Padded encodings may follow each other.
+  EXPECT_EQ("foobarbfo", output.toString());
+
+  input.drain(input.length());
+  input.add("==");
+  EXPECT_TRUE(decoder.decode(input, output));
+  EXPECT_EQ(0, decoder.pending());
+  EXPECT_EQ("foobarbfof", output.toString());
+}
+
+TEST(Base64StreamDecoderTest, DecodeFailure) {
+  const char* const invalid[] = {"Zm9v****", "Zm9=", "Zh==", "=m9v", "Z===", "Zm=v"};
+  for (const char* text : invalid) {
+    Base64StreamDecoder decoder;
+    Buffer::OwnedImpl input(text);
+    Buffer::OwnedImpl output;
+    EXPECT_FALSE(decoder.decode(input, output)) << text;
+  }
+}
+
 TEST(Base64UrlTest, EncodeString) {
   EXPECT_EQ("", Base64Url::encode("", 0));
   EXPECT_EQ("AAA", Base64Url::encode("\0\0", 2));
@@ -27,6 +27,13 @@ TEST(Hex, RoundTrip) {
 
 TEST(Hex, BadHex) { EXPECT_EQ(0, Hex::decode("abcde").size()); }
 
+TEST(Hex, BadDigits) {
+  EXPECT_EQ(0, Hex::decode("+f").size());
+  EXPECT_EQ(0, Hex::decode(" f").size());
+  EXPECT_EQ(0, Hex::decode("0x").size());
+  EXPECT_EQ(0, Hex::decode("00g0").size());
+}
+
 TEST(Hex, DecodeUppercase) { EXPECT_EQ(4, Hex::decode("ABCDEFAB").size()); }
 
 TEST(Hex, UIntToHex) {
@@ -7,6 +7,8 @@
 #include "common/config/metadata.h"
 #include "common/protobuf/protobuf.h"
 
+#include "test/test_common/utility.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -267,6 +269,49 @@ TEST(StringMatcher, SafeRegexValue) {
   EXPECT_FALSE(Matchers::StringMatcherImpl(matcher).match("bar"));
 }
 
+TEST(StringMatcherList, MatchAny) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher> matchers;
+  EXPECT_TRUE(Matchers::StringMatcherListImpl(matchers).empty());
+  EXPECT_FALSE(Matchers::StringMatcherListImpl(matchers).match(""));
+
+  matchers.Add()->set_exact("foo");
+  matchers.Add()->set_exact("bar");
+  matchers.Add()->set_prefix("pre.");
+  matchers.Add()->set_suffix(".suf");
+  matchers.Add()->set_hidden_envoy_deprecated_regex("std.*");
+  auto* regex = matchers.Add()->mutable_safe_regex();
+  regex->mutable_google_re2();
+  regex->set_regex("re2-[0-9]+");
+  regex = matchers.Add()->mutable_safe_regex();
+  regex->mutable_google_re2();
+  regex->set_regex("[a-z]+\\.example\\.com");
+
+  const Matchers::StringMatcherListImpl list(matchers);
+  EXPECT_FALSE(list.empty());
+  EXPECT_TRUE(list.match("foo"));
+  EXPECT_TRUE(list.match("bar"));
+  EXPECT_TRUE(list.match("pre.value"));
+  EXPECT_TRUE(list.match("value.suf"));
+  EXPECT_TRUE(list.match("stdvalue"));
+  EXPECT_TRUE(list.match("re2-42"));
+  EXPECT_TRUE(list.match("www.example.com"));
+  EXPECT_FALSE(list.match("fooo"));
+  EXPECT_FALSE(list.match("value.pre."));
+  // Regexes must match the whole value.
+  EXPECT_FALSE(list.match("re2-42a"));
+  EXPECT_FALSE(list.match("http://www.example.com"));
+  EXPECT_FALSE(list.match(""));
+}
+
+TEST(StringMatcherList, InvalidRegex) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3alpha::StringMatcher> matchers;
+  auto* regex = matchers.Add()->mutable_safe_regex();
+  regex->mutable_google_re2()->mutable_max_program_size()->set_value(1);
+  regex->set_regex("/asdf/.*");
+  EXPECT_THROW_WITH_REGEX(Matchers::StringMatcherListImpl{matchers}, EnvoyException,
+                          "RE2 program size of [0-9]+ > max program size of 1\\.");
+}
+
 TEST(LowerCaseStringMatcher, MatchExactValue) {
   envoy::type::matcher::v3alpha::StringMatcher matcher;
   matcher.set_exact("Foo");
@@ -0,0 +1,82 @@
+#include <list>
+#include <string>
+#include <vector>
+
+#include "common/common/slab_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(SlabPool, ReusesFreedBlocks) {
+  SlabPool pool(2, 8);
+  void* a = pool.allocate(24);
+  void* b = pool.allocate(24);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(1, pool.slabCount());
+
+  pool.deallocate(a, 24);
+  EXPECT_EQ(a, pool.allocate(24));
+  EXPECT_EQ(1, pool.slabCount());
+
+  pool.deallocate(a, 24);
+  pool.deallocate(b, 24);
+}
+
+TEST(SlabPool, SlabsGrowGeometricallyUpToMax) {
+  SlabPool pool(2, 4);
+  std::vector<void*> blocks;
+  for (int i = 0; i < 14; i++) {
+    blocks.push_back(pool.allocate(32));
+  }
+  // Slabs of 2, 4, 4, 4 blocks.
+  EXPECT_EQ(4, pool.slabCount());
+  EXPECT_EQ(14 * 32, pool.bytesReserved());
+  for (void* block : blocks) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t));
+    pool.deallocate(block, 32);
+  }
+}
+
+TEST(SlabPool, OtherSizesUseHeap) {
+  SlabPool pool;
+  void* a = pool.allocate(32);
+  void* b = pool.allocate(256);
+  EXPECT_EQ(1, pool.slabCount());
+  pool.deallocate(b, 256);
+  pool.deallocate(a, 32);
+}
+
+TEST(SlabAllocator, BacksList) {
+  SlabPool pool;
+  std::list<std::string, SlabAllocator<std::string>> list{SlabAllocator<std::string>(pool)};
+  for (int i = 0; i < 100; i++) {
+    list.emplace_back(std::to_string(i));
+  }
+  list.remove_if([](const std::string& s) { return s.size() == 1; });
+  EXPECT_EQ(90, list.size());
+  EXPECT_EQ("10", list.front());
+  EXPECT_EQ("99", list.back());
+
+  const size_t slabs = pool.slabCount();
+  for (int i = 0; i < 10; i++) {
+    list.emplace_front(std::to_string(i));
+  }
+  // Nodes of removed elements are reused.
+  EXPECT_EQ(slabs, pool.slabCount());
+}
+
+TEST(SlabAllocator, Equality) {
+  SlabPool pool1;
+  SlabPool pool2;
+  SlabAllocator<int> a(pool1);
+  SlabAllocator<char> b(pool1);
+  SlabAllocator<int> c(pool2);
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a != b);
+  EXPECT_TRUE(a != c);
+}
+
+} // namespace
+} // namespace Envoy
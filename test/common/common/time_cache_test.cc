@@ -0,0 +1,75 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/common/time_cache.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+std::string read(std::chrono::seconds epoch_time_seconds, TimeCache::Format format) {
+  TimeCache::Buffer buffer;
+  return std::string(TimeCache::get().read(epoch_time_seconds, format, buffer));
+}
+
+TEST(TimeCacheTest, Formats) {
+  // 2018-04-03T23:06:09Z
+  const std::chrono::seconds second(1522796769);
+  TimeCache::get().update(SystemTime(second + std::chrono::milliseconds(123)));
+  EXPECT_EQ("Tue, 03 Apr 2018 23:06:09 GMT", read(second, TimeCache::Format::Rfc1123));
+  EXPECT_EQ("2018-04-03T23:06:09.000Z", read(second, TimeCache::Format::Iso8601));
+
+  // Other seconds aren't cached.
+  EXPECT_EQ("", read(second - std::chrono::seconds(1), TimeCache::Format::Rfc1123));
+  EXPECT_EQ("", read(second + std::chrono::seconds(1), TimeCache::Format::Iso8601));
+
+  TimeCache::get().update(SystemTime(second + std::chrono::seconds(1)));
+  EXPECT_EQ("", read(second, TimeCache::Format::Rfc1123));
+  EXPECT_EQ("Tue, 03 Apr 2018 23:06:10 GMT",
+            read(second + std::chrono::seconds(1), TimeCache::Format::Rfc1123));
+}
+
+// Readers racing with updates read either the old or the new second, whole.
+TEST(TimeCacheTest, ConcurrentReads) {
+  const std::chrono::seconds first_second(1522796769);
+  const int num_updates = 1000;
+  TimeCache::get().update(SystemTime(first_second));
+  std::vector<std::string> expected;
+  for (int k = 0; k < num_updates; k += 100) {
+    expected.push_back(absl::FormatTime("%Y-%m-%dT%H:%M:%S.000Z",
+                                        absl::FromUnixSeconds(first_second.count() + k),
+                                        absl::UTCTimeZone()));
+  }
+
+  std::vector<Thread::ThreadPtr> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.push_back(Thread::threadFactoryForTest().createThread([first_second, &expected]() {
+      for (int j = 0; j < num_updates; j++) {
+        for (int k = 0; k < num_updates; k += 100) {
+          const std::string formatted =
+              read(first_second + std::chrono::seconds(k), TimeCache::Format::Iso8601);
+          if (!formatted.empty()) {
+            EXPECT_EQ(expected[k / 100], formatted);
+          }
+        }
+      }
+    }));
+  }
+  for (int i = 1; i < num_updates; i++) {
+    TimeCache::get().update(SystemTime(first_second + std::chrono::seconds(i)));
+  }
+  for (Thread::ThreadPtr& reader : readers) {
+    reader->join();
+  }
+  EXPECT_EQ("2018-04-03T23:22:48.000Z",
+            read(first_second + std::chrono::seconds(num_updates - 1), TimeCache::Format::Iso8601));
+}
+
+} // namespace
+} // namespace Envoy
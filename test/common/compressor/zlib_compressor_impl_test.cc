@@ -2,6 +2,7 @@
 #include "common/common/hex.h"
 #include "common/common/stack_array.h"
 #include "common/compressor/zlib_compressor_impl.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
 
 #include "test/test_common/utility.h"
 
@@ -204,6 +205,37 @@ TEST_F(ZlibCompressorImplTest, CompressWithNotCommonParams) {
   expectValidFinishedBuffer(accumulation_buffer, input_size);
 }
 
+// A reset compressor produces a new stream, whether or not the previous one was finished.
+TEST_F(ZlibCompressorImplTest, Reset) {
+  ZlibCompressorImplTester compressor;
+  compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                  ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits,
+                  memory_level);
+
+  for (const bool finish_previous : {true, false}) {
+    Buffer::OwnedImpl previous;
+    TestUtility::feedBufferWithRandomCharacters(previous, default_input_size);
+    if (finish_previous) {
+      compressor.finish(previous);
+    } else {
+      compressor.compressThenFlush(previous);
+    }
+    compressor.reset();
+
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size, 1);
+    const std::string original = buffer.toString();
+    compressor.finish(buffer);
+    expectValidFinishedBuffer(buffer, default_input_size);
+
+    Decompressor::ZlibDecompressorImpl decompressor;
+    decompressor.init(gzip_window_bits);
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(buffer, decompressed);
+    EXPECT_EQ(original, decompressed.toString());
+  }
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace Envoy
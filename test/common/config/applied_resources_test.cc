@@ -0,0 +1,38 @@
+#include "envoy/config/cluster/v3alpha/cluster.pb.h"
+
+#include "common/config/applied_resources.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+TEST(AppliedResourcesTest, Unchanged) {
+  envoy::config::cluster::v3alpha::Cluster cluster;
+  cluster.set_name("foo");
+  ProtobufWkt::Any resource;
+  resource.PackFrom(cluster);
+  const uint64_t hash = AppliedResources::hash(resource);
+  cluster.mutable_connect_timeout()->set_seconds(1);
+  resource.PackFrom(cluster);
+  const uint64_t changed_hash = AppliedResources::hash(resource);
+  EXPECT_NE(hash, changed_hash);
+
+  AppliedResources applied;
+  EXPECT_FALSE(applied.unchanged("foo", hash, ""));
+  applied.applied("foo", hash, "v1");
+  EXPECT_TRUE(applied.unchanged("foo", hash, ""));
+  EXPECT_TRUE(applied.unchanged("foo", hash, "v2"));
+  EXPECT_TRUE(applied.unchanged("foo", changed_hash, "v1"));
+  EXPECT_FALSE(applied.unchanged("foo", changed_hash, "v2"));
+  EXPECT_FALSE(applied.unchanged("foo", changed_hash, ""));
+  EXPECT_FALSE(applied.unchanged("bar", hash, "v1"));
+
+  applied.forget("foo");
+  EXPECT_FALSE(applied.unchanged("foo", hash, "v1"));
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,125 @@
+// Usage: bazel run //test/common/config:config_update_benchmark
+
+#include "envoy/config/endpoint/v3alpha/endpoint.pb.h"
+#include "envoy/config/subscription.h"
+
+#include "common/common/fmt.h"
+#include "common/config/utility.h"
+#include "common/config/watch_map.h"
+#include "common/protobuf/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+// Builds assignments of the given number of endpoints, as pushed by EDS.
+Protobuf::RepeatedPtrField<ProtobufWkt::Any> makeAssignments(uint64_t num_assignments,
+                                                            uint64_t num_endpoints) {
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources;
+  for (uint64_t i = 0; i < num_assignments; i++) {
+    envoy::config::endpoint::v3alpha::ClusterLoadAssignment assignment;
+    assignment.set_cluster_name(fmt::format("cluster_{}", i));
+    auto* endpoints = assignment.add_endpoints();
+    for (uint64_t j = 0; j < num_endpoints; j++) {
+      auto* socket_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address(fmt::format("10.{}.{}.{}", i % 256, j / 256, j % 256));
+      socket_address->set_port_value(80);
+    }
+    resources.Add()->PackFrom(assignment);
+  }
+  return resources;
+}
+
+class AssignmentCallbacks : public SubscriptionCallbacks {
+public:
+  // Config::SubscriptionCallbacks
+  void onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
+                      const std::string&) override {
+    updates_ += resources.size();
+  }
+  void onConfigUpdate(
+      const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>& resources,
+      const Protobuf::RepeatedPtrField<std::string>&, const std::string&) override {
+    updates_ += resources.size();
+  }
+  void onConfigUpdateFailed(ConfigUpdateFailureReason, const EnvoyException*) override {}
+  std::string resourceName(const ProtobufWkt::Any& resource) override {
+    return Utility::anyStringField(
+        resource,
+        envoy::config::endpoint::v3alpha::ClusterLoadAssignment::kClusterNameFieldNumber);
+  }
+
+  uint64_t updates_{};
+};
+
+// Naming a resource by unpacking it, as done before reading the name field of the packed message.
+// Args: number of endpoints of the assignment.
+void BM_ResourceNameUnpack(benchmark::State& state) {
+  const auto resources = makeAssignments(1, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        MessageUtil::anyConvert<envoy::config::endpoint::v3alpha::ClusterLoadAssignment>(
+            resources[0])
+            .cluster_name());
+  }
+}
+BENCHMARK(BM_ResourceNameUnpack)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Naming a resource by reading the name field of the packed message.
+// Args: number of endpoints of the assignment.
+void BM_ResourceNameField(benchmark::State& state) {
+  const auto resources = makeAssignments(1, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Utility::anyStringField(
+        resources[0],
+        envoy::config::endpoint::v3alpha::ClusterLoadAssignment::kClusterNameFieldNumber));
+  }
+}
+BENCHMARK(BM_ResourceNameField)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Delivering a state of the world update to the watches of the assignments.
+// Args: number of assignments, each with its own watch, number of endpoints per assignment.
+void BM_WatchMapUpdate(benchmark::State& state) {
+  const auto resources = makeAssignments(state.range(0), state.range(1));
+  std::vector<AssignmentCallbacks> callbacks(state.range(0));
+  WatchMap watch_map;
+  for (uint64_t i = 0; i < callbacks.size(); i++) {
+    watch_map.updateWatchInterest(watch_map.addWatch(callbacks[i]),
+                                  {fmt::format("cluster_{}", i)});
+  }
+  for (auto _ : state) {
+    watch_map.onConfigUpdate(resources, "version");
+  }
+}
+BENCHMARK(BM_WatchMapUpdate)->Args({100, 100})->Args({1000, 10})->Args({10, 10000});
+
+// Delivering a state of the world update to a single wildcard watch, as for CDS and LDS.
+// Args: number of resources, number of endpoints per resource.
+void BM_WatchMapWildcardUpdate(benchmark::State& state) {
+  const auto resources = makeAssignments(state.range(0), state.range(1));
+  AssignmentCallbacks callbacks;
+  WatchMap watch_map;
+  watch_map.addWatch(callbacks);
+  for (auto _ : state) {
+    watch_map.onConfigUpdate(resources, "version");
+  }
+}
+BENCHMARK(BM_WatchMapWildcardUpdate)->Args({100, 100})->Args({1000, 10});
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
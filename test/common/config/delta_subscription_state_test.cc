@@ -306,6 +306,40 @@ TEST_F(DeltaSubscriptionStateTest, SubscribeAndUnsubscribeAfterReconnect) {
   EXPECT_TRUE(cur_request.resource_names_unsubscribe().empty());
 }
 
+// The members of a subscribed collection are tracked without being subscribed to one by one, and
+// are forgotten once the server removes them or the collection is unsubscribed.
+TEST_F(DeltaSubscriptionStateTest, CollectionMembers) {
+  state_.updateSubscriptionInterest({"fare/*"}, {});
+  state_.getNextRequestAckless();
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> add_a_b =
+      populateRepeatedResource({{"fare/a", "versionA"}, {"fare/b", "versionB"}});
+  deliverDiscoveryResponse(add_a_b, {}, "debugversion1");
+  Protobuf::RepeatedPtrField<std::string> remove_b;
+  *remove_b.Add() = "fare/b";
+  deliverDiscoveryResponse({}, remove_b, "debugversion2");
+
+  state_.markStreamFresh(); // simulate a stream reconnection
+  {
+    envoy::service::discovery::v3alpha::DeltaDiscoveryRequest cur_request =
+        state_.getNextRequestAckless();
+    EXPECT_THAT(cur_request.resource_names_subscribe(),
+                UnorderedElementsAre("name1", "name2", "name3", "fare/*"));
+    EXPECT_EQ("versionA", cur_request.initial_resource_versions().at("fare/a"));
+    EXPECT_EQ(cur_request.initial_resource_versions().end(),
+              cur_request.initial_resource_versions().find("fare/b"));
+  }
+
+  state_.updateSubscriptionInterest({}, {"fare/*"});
+  state_.markStreamFresh(); // simulate a stream reconnection
+  {
+    envoy::service::discovery::v3alpha::DeltaDiscoveryRequest cur_request =
+        state_.getNextRequestAckless();
+    EXPECT_THAT(cur_request.resource_names_subscribe(),
+                UnorderedElementsAre("name1", "name2", "name3"));
+    EXPECT_TRUE(cur_request.initial_resource_versions().empty());
+  }
+}
+
 // initial_resource_versions should not be present on messages after the first in a stream.
 TEST_F(DeltaSubscriptionStateTest, InitialVersionMapFirstMessageOnly) {
   // First, verify that the first message of a new stream sends initial versions.
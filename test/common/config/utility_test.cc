@@ -37,6 +37,35 @@ TEST(UtilityTest, ComputeHashedVersion) {
   EXPECT_EQ("hash_33bf00a859c4ba3f", Utility::computeHashedVersion("foo").first);
 }
 
+TEST(UtilityTest, AnyStringField) {
+  envoy::config::cluster::v3alpha::Cluster cluster;
+  cluster.set_name("foo");
+  cluster.mutable_connect_timeout()->set_seconds(1);
+  cluster.add_hosts()->mutable_socket_address()->set_address("1.2.3.4");
+  ProtobufWkt::Any any;
+  any.PackFrom(cluster);
+  EXPECT_EQ("foo", Utility::anyStringField(
+                       any, envoy::config::cluster::v3alpha::Cluster::kNameFieldNumber));
+
+  // The last occurrence of the field wins, as when the message is parsed.
+  envoy::config::cluster::v3alpha::Cluster renamed;
+  renamed.set_name("bar");
+  any.mutable_value()->append(renamed.SerializeAsString());
+  EXPECT_EQ("bar", Utility::anyStringField(
+                       any, envoy::config::cluster::v3alpha::Cluster::kNameFieldNumber));
+
+  ProtobufWkt::Any unnamed;
+  unnamed.PackFrom(envoy::config::cluster::v3alpha::Cluster());
+  EXPECT_EQ("", Utility::anyStringField(
+                    unnamed, envoy::config::cluster::v3alpha::Cluster::kNameFieldNumber));
+
+  any.mutable_value()->resize(any.value().size() - 1);
+  EXPECT_THROW_WITH_MESSAGE(
+      Utility::anyStringField(any, envoy::config::cluster::v3alpha::Cluster::kNameFieldNumber),
+      EnvoyException,
+      "Unable to read field 1 of type.googleapis.com/envoy.config.cluster.v3alpha.Cluster");
+}
+
 TEST(UtilityTest, ApiConfigSourceRefreshDelay) {
   envoy::config::core::v3alpha::ApiConfigSource api_config_source;
   api_config_source.mutable_refresh_delay()->CopyFrom(
@@ -412,6 +412,42 @@ TEST(WatchMapTest, DeltaOnConfigUpdate) {
   doDeltaAndSotwUpdate(watch_map, update, {"removed"}, "version1");
 }
 
+// A watch on a collection receives the delta updates and removals of the resources within it.
+TEST(WatchMapTest, DeltaCollectionInterest) {
+  NamedMockSubscriptionCallbacks callbacks;
+  WatchMap watch_map;
+  Watch* watch = watch_map.addWatch(callbacks);
+  watch_map.updateWatchInterest(watch, {"fare/*"});
+  EXPECT_EQ("fare/*", WatchMap::collectionName("fare/a"));
+  EXPECT_EQ("", WatchMap::collectionName("fare"));
+
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> delta_resources;
+  for (const auto name : {"fare/a", "other/a"}) {
+    envoy::config::endpoint::v3alpha::ClusterLoadAssignment resource;
+    resource.set_cluster_name(name);
+    auto* cur_resource = delta_resources.Add();
+    cur_resource->set_name(name);
+    cur_resource->set_version("version1");
+    cur_resource->mutable_resource()->PackFrom(resource);
+  }
+  Protobuf::RepeatedPtrField<std::string> removed_names;
+  removed_names.Add("fare/b");
+  removed_names.Add("other/b");
+
+  EXPECT_CALL(callbacks, onConfigUpdate(_, _, "version1"))
+      .WillOnce(Invoke(
+          [](const Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource>&
+                 gotten_resources,
+             const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+             const std::string&) {
+            ASSERT_EQ(1, gotten_resources.size());
+            EXPECT_EQ("fare/a", gotten_resources[0].name());
+            ASSERT_EQ(1, removed_resources.size());
+            EXPECT_EQ("fare/b", removed_resources[0]);
+          }));
+  watch_map.onConfigUpdate(delta_resources, removed_names, "version1");
+}
+
 TEST(WatchMapTest, OnConfigUpdateFailed) {
   WatchMap watch_map;
   // calling on empty map doesn't break
@@ -1,4 +1,5 @@
 #include <functional>
+#include <vector>
 
 #include "envoy/thread/thread.h"
 
@@ -128,6 +129,12 @@ TEST_F(DispatcherImplTest, InitializeStats) {
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.poll_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.poll_duration_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_latency_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_queue_depth", Stats::Histogram::Unit::Unspecified));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
@@ -146,6 +153,70 @@ TEST_F(DispatcherImplTest, Post) {
   }
 }
 
+// The callbacks posted concurrently by many threads are all run, in the order of each thread.
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  constexpr int NumThreads = 4;
+  constexpr int NumPosts = 1000;
+  std::vector<int> last_posted(NumThreads, -1);
+  int remaining = NumThreads * NumPosts;
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < NumThreads; ++i) {
+    threads.push_back(api_->threadFactory().createThread([this, i, &last_posted, &remaining]() {
+      for (int post = 0; post < NumPosts; ++post) {
+        dispatcher_->post([this, i, post, &last_posted, &remaining]() {
+          EXPECT_EQ(post - 1, last_posted[i]);
+          last_posted[i] = post;
+          if (--remaining == 0) {
+            {
+              Thread::LockGuard lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notifyOne();
+          }
+        });
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+}
+
+// A callback which keeps posting itself does not starve the timers of the dispatcher, since each
+// run of the post callbacks only runs those queued when it starts.
+TEST_F(DispatcherImplTest, RepostDoesNotStarveTimers) {
+  TimerPtr timer;
+  std::function<void()> repost;
+  bool timer_fired = false;
+  repost = [this, &repost, &timer, &timer_fired]() {
+    if (timer_fired) {
+      timer.reset();
+      {
+        Thread::LockGuard lock(mu_);
+        work_finished_ = true;
+      }
+      cv_.notifyOne();
+      return;
+    }
+    dispatcher_->post(repost);
+  };
+  dispatcher_->post([this, &timer, &repost, &timer_fired]() {
+    timer = dispatcher_->createTimer([&timer_fired]() { timer_fired = true; });
+    timer->enableTimer(std::chrono::milliseconds(0));
+    dispatcher_->post(repost);
+  });
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+}
+
 // Ensure that there is no deadlock related to calling a posted callback, or
 // destructing a closure when finished calling it.
 TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
@@ -163,7 +234,7 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
+    // This also ensures that no lock of the dispatcher is held while callbacks are called,
     // or else this would deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
@@ -190,6 +261,31 @@ TEST_F(DispatcherImplTest, Timer) {
   timerTest([](Timer& timer) { timer.enableHRTimer(std::chrono::microseconds(50)); });
 }
 
+TEST_F(DispatcherImplTest, CoarseTimer) {
+  TimerPtr timer;
+  dispatcher_->post([this, &timer]() {
+    // The coarse timers are run by the wheel of the dispatcher, so they are enabled from its
+    // thread.
+    Thread::LockGuard lock(mu_);
+    timer = dispatcher_->createCoarseTimer([this]() {
+      {
+        Thread::LockGuard lock(mu_);
+        work_finished_ = true;
+      }
+      cv_.notifyOne();
+    });
+    EXPECT_FALSE(timer->enabled());
+    timer->enableTimer(std::chrono::milliseconds(50));
+    EXPECT_TRUE(timer->enabled());
+  });
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  EXPECT_FALSE(timer->enabled());
+}
+
 TEST_F(DispatcherImplTest, TimerWithScope) {
   TimerPtr timer;
   MockScopedTrackedObject scope;
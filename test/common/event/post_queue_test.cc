@@ -0,0 +1,77 @@
+#include <vector>
+
+#include "common/event/post_queue.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+TEST(PostQueueTest, PushPop) {
+  PostQueue queue;
+  std::function<void()> callback;
+  MonotonicTime posted;
+  EXPECT_FALSE(queue.pop(callback, posted));
+  EXPECT_FALSE(queue.release(0));
+
+  std::vector<int> runs;
+  EXPECT_TRUE(queue.push([&runs]() { runs.push_back(1); }, MonotonicTime(std::chrono::seconds(1))));
+  EXPECT_FALSE(queue.push([&runs]() { runs.push_back(2); }, MonotonicTime()));
+  EXPECT_EQ(2, queue.size());
+
+  ASSERT_TRUE(queue.pop(callback, posted));
+  EXPECT_EQ(MonotonicTime(std::chrono::seconds(1)), posted);
+  callback();
+  ASSERT_TRUE(queue.pop(callback, posted));
+  callback();
+  EXPECT_FALSE(queue.pop(callback, posted));
+  EXPECT_EQ((std::vector<int>{1, 2}), runs);
+
+  // The queue is empty once the callbacks are released, so the next push wakes the consumer.
+  EXPECT_FALSE(queue.release(2));
+  EXPECT_TRUE(queue.push([]() {}, MonotonicTime()));
+  EXPECT_TRUE(queue.release(0));
+}
+
+// The callbacks pushed by concurrent producers are all popped, in the order of each producer.
+TEST(PostQueueTest, ConcurrentProducers) {
+  constexpr int NumThreads = 4;
+  constexpr int NumPushes = 10000;
+  PostQueue queue;
+  std::vector<int> last_pushed(NumThreads, -1);
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < NumThreads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&queue, &last_pushed, i]() {
+      for (int push = 0; push < NumPushes; ++push) {
+        queue.push(
+            [&last_pushed, i, push]() {
+              EXPECT_EQ(push - 1, last_pushed[i]);
+              last_pushed[i] = push;
+            },
+            MonotonicTime());
+      }
+    }));
+  }
+
+  int popped = 0;
+  std::function<void()> callback;
+  MonotonicTime posted;
+  while (popped < NumThreads * NumPushes) {
+    if (queue.pop(callback, posted)) {
+      callback();
+      popped++;
+    }
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_FALSE(queue.pop(callback, posted));
+  EXPECT_FALSE(queue.release(popped));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,147 @@
+#include <chrono>
+
+#include "common/event/timer_wheel.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TimerWheelTest : public testing::Test {
+public:
+  TimerWheelTest() {
+    // Start on a tick boundary.
+    time_system_.setMonotonicTime(MonotonicTime(std::chrono::seconds(1000)));
+  }
+
+  void advance(std::chrono::milliseconds ms) {
+    time_system_.setMonotonicTime(time_system_.monotonicTime() + ms);
+  }
+
+  SimulatedTimeSystem time_system_;
+  NiceMock<MockDispatcher> dispatcher_;
+  MockTimer* tick_timer_{new MockTimer(&dispatcher_)};
+  TimerWheel wheel_{dispatcher_, std::chrono::milliseconds(100)};
+};
+
+// Timers due in the same tick are run by a single wakeup at the end of the tick.
+TEST_F(TimerWheelTest, Batching) {
+  std::vector<int> runs;
+  TimerPtr timer1 = wheel_.createTimer([&runs]() -> void { runs.push_back(1); });
+  TimerPtr timer2 = wheel_.createTimer([&runs]() -> void { runs.push_back(2); });
+  TimerPtr timer3 = wheel_.createTimer([&runs]() -> void { runs.push_back(3); });
+
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(100), _));
+  timer1->enableTimer(std::chrono::milliseconds(10));
+  timer2->enableTimer(std::chrono::milliseconds(50));
+  timer3->enableTimer(std::chrono::milliseconds(150));
+  EXPECT_TRUE(timer1->enabled());
+
+  advance(std::chrono::milliseconds(100));
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(100), _));
+  tick_timer_->invokeCallback();
+  EXPECT_EQ((std::vector<int>{1, 2}), runs);
+  EXPECT_FALSE(timer1->enabled());
+  EXPECT_TRUE(timer3->enabled());
+
+  advance(std::chrono::milliseconds(100));
+  EXPECT_CALL(*tick_timer_, enableTimer(_, _)).Times(0);
+  tick_timer_->invokeCallback();
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), runs);
+}
+
+// An earlier timer reschedules the wheel, a disabled or destroyed one is not run.
+TEST_F(TimerWheelTest, DisableAndReschedule) {
+  uint32_t runs = 0;
+  TimerPtr timer1 = wheel_.createTimer([&runs]() -> void { runs++; });
+  TimerPtr timer2 = wheel_.createTimer([&runs]() -> void { runs++; });
+
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(500), _));
+  timer1->enableTimer(std::chrono::milliseconds(420));
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(200), _));
+  timer2->enableTimer(std::chrono::milliseconds(120));
+
+  timer1->disableTimer();
+  EXPECT_FALSE(timer1->enabled());
+  timer2.reset();
+
+  advance(std::chrono::milliseconds(200));
+  EXPECT_CALL(*tick_timer_, enableTimer(_, _)).Times(0);
+  tick_timer_->invokeCallback();
+  EXPECT_EQ(0, runs);
+}
+
+// A timer can be enabled again from its callback.
+TEST_F(TimerWheelTest, EnableFromCallback) {
+  uint32_t runs = 0;
+  TimerPtr timer;
+  timer = wheel_.createTimer([&]() -> void {
+    if (++runs < 3) {
+      timer->enableTimer(std::chrono::milliseconds(30));
+    }
+  });
+
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(100), _)).Times(3);
+  timer->enableTimer(std::chrono::milliseconds(0));
+  for (uint32_t i = 0; i < 3; i++) {
+    advance(std::chrono::milliseconds(100));
+    tick_timer_->invokeCallback();
+  }
+  EXPECT_EQ(3, runs);
+  EXPECT_FALSE(timer->enabled());
+}
+
+// The timers due after a turn of the wheel are held by its coarser levels, and cascaded down as the
+// wheel turns.
+TEST_F(TimerWheelTest, CascadeLaterTimers) {
+  uint32_t runs = 0;
+  TimerPtr timer = wheel_.createTimer([&runs]() -> void { runs++; });
+
+  // The wheel wakes up at the end of its turn, at tick 10240, to cascade the timer due at 10300.
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(24000), _));
+  timer->enableTimer(std::chrono::milliseconds(30000));
+
+  advance(std::chrono::milliseconds(24000));
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(6000), _));
+  tick_timer_->invokeCallback();
+  EXPECT_EQ(0, runs);
+  EXPECT_TRUE(timer->enabled());
+
+  advance(std::chrono::milliseconds(6000));
+  EXPECT_CALL(*tick_timer_, enableTimer(_, _)).Times(0);
+  tick_timer_->invokeCallback();
+  EXPECT_EQ(1, runs);
+  EXPECT_FALSE(timer->enabled());
+}
+
+// Resetting a timer moves it between slots without waking up the wheel earlier than needed.
+TEST_F(TimerWheelTest, Reset) {
+  uint32_t runs = 0;
+  TimerPtr timer = wheel_.createTimer([&runs]() -> void { runs++; });
+
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(300), _));
+  timer->enableTimer(std::chrono::milliseconds(300));
+  // A later expiry keeps the scheduled wakeup, which then finds nothing to run.
+  timer->enableTimer(std::chrono::milliseconds(500));
+
+  advance(std::chrono::milliseconds(300));
+  EXPECT_CALL(*tick_timer_, enableTimer(std::chrono::milliseconds(200), _));
+  tick_timer_->invokeCallback();
+  EXPECT_EQ(0, runs);
+
+  advance(std::chrono::milliseconds(200));
+  tick_timer_->invokeCallback();
+  EXPECT_EQ(1, runs);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
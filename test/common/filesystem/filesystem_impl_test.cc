@@ -251,6 +251,31 @@ TEST_F(FileSystemImplTest, WriteAfterClose) {
   EXPECT_EQ("Bad file descriptor", size_result.err_->getErrorDetails());
 }
 
+TEST_F(FileSystemImplTest, Truncate) {
+  const std::string file_path =
+      TestEnvironment::writeStringToFileForTest("test_envoy", "existing data");
+
+  FilePtr file = file_system_.createFile(file_path);
+  const Api::IoCallBoolResult open_result = file->open(FlagSet{
+      1 << Filesystem::File::Operation::Write | 1 << Filesystem::File::Operation::Truncate});
+  EXPECT_TRUE(open_result.rc_);
+  const Api::IoCallSizeResult write_result = file->write("new");
+  EXPECT_EQ(3, write_result.rc_);
+  EXPECT_TRUE(file->close().rc_);
+
+  EXPECT_EQ("new", file_system_.fileReadToEnd(file_path));
+}
+
+TEST_F(FileSystemImplTest, RenameFile) {
+  const std::string old_path = TestEnvironment::writeStringToFileForTest("test_envoy_old", "new");
+  const std::string new_path = TestEnvironment::writeStringToFileForTest("test_envoy_new", "old");
+
+  EXPECT_TRUE(file_system_.renameFile(old_path, new_path));
+  EXPECT_FALSE(file_system_.fileExists(old_path));
+  EXPECT_EQ("new", file_system_.fileReadToEnd(new_path));
+  EXPECT_FALSE(file_system_.renameFile(old_path, new_path));
+}
+
 TEST_F(FileSystemImplTest, NonExistingFileAndReadOnly) {
   const std::string new_file_path = TestEnvironment::temporaryPath("envoy_this_not_exist");
   ::unlink(new_file_path.c_str());
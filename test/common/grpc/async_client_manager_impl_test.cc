@@ -30,7 +30,7 @@ public:
 };
 
 TEST_F(AsyncClientManagerImplTest, EnvoyGrpcOk) {
-  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_);
+  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_, 0);
   envoy::config::core::v3alpha::GrpcService grpc_service;
   grpc_service.mutable_envoy_grpc()->set_cluster_name("foo");
 
@@ -45,7 +45,7 @@ TEST_F(AsyncClientManagerImplTest, EnvoyGrpcOk) {
 }
 
 TEST_F(AsyncClientManagerImplTest, EnvoyGrpcUnknown) {
-  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_);
+  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_, 0);
   envoy::config::core::v3alpha::GrpcService grpc_service;
   grpc_service.mutable_envoy_grpc()->set_cluster_name("foo");
 
@@ -55,7 +55,7 @@ TEST_F(AsyncClientManagerImplTest, EnvoyGrpcUnknown) {
 }
 
 TEST_F(AsyncClientManagerImplTest, EnvoyGrpcDynamicCluster) {
-  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_);
+  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_, 0);
   envoy::config::core::v3alpha::GrpcService grpc_service;
   grpc_service.mutable_envoy_grpc()->set_cluster_name("foo");
 
@@ -71,7 +71,7 @@ TEST_F(AsyncClientManagerImplTest, EnvoyGrpcDynamicCluster) {
 
 TEST_F(AsyncClientManagerImplTest, GoogleGrpc) {
   EXPECT_CALL(scope_, createScope_("grpc.foo."));
-  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_);
+  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_, 0);
   envoy::config::core::v3alpha::GrpcService grpc_service;
   grpc_service.mutable_google_grpc()->set_stat_prefix("foo");
 
@@ -83,8 +83,19 @@ TEST_F(AsyncClientManagerImplTest, GoogleGrpc) {
 #endif
 }
 
+#ifdef ENVOY_GOOGLE_GRPC
+TEST_F(AsyncClientManagerImplTest, GoogleGrpcSharedCompletionQueues) {
+  EXPECT_CALL(scope_, createScope_("grpc.foo."));
+  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_, 2);
+  envoy::config::core::v3alpha::GrpcService grpc_service;
+  grpc_service.mutable_google_grpc()->set_stat_prefix("foo");
+
+  EXPECT_NE(nullptr, async_client_manager.factoryForGrpcService(grpc_service, scope_, false));
+}
+#endif
+
 TEST_F(AsyncClientManagerImplTest, EnvoyGrpcUnknownOk) {
-  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_);
+  AsyncClientManagerImpl async_client_manager(cm_, tls_, test_time_.timeSystem(), *api_, 0);
   envoy::config::core::v3alpha::GrpcService grpc_service;
   grpc_service.mutable_envoy_grpc()->set_cluster_name("foo");
 
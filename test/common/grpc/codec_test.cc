@@ -106,6 +106,59 @@ TEST(GrpcCodecTest, decodeInvalidFrame) {
   EXPECT_EQ(size, buffer.length());
 }
 
+// No frame is output when a later frame of the input is invalid, and the input is left unchanged.
+TEST(GrpcCodecTest, decodeInvalidFrameAfterValidFrame) {
+  helloworld::HelloRequest request;
+  request.set_name("hello");
+
+  Buffer::OwnedImpl buffer;
+  std::array<uint8_t, 5> header;
+  Encoder encoder;
+  encoder.newFrame(GRPC_FH_DEFAULT, request.ByteSize(), header);
+  buffer.add(header.data(), 5);
+  buffer.add(request.SerializeAsString());
+  encoder.newFrame(0b10u, request.ByteSize(), header);
+  buffer.add(header.data(), 5);
+  buffer.add(request.SerializeAsString());
+  const std::string input = buffer.toString();
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  EXPECT_FALSE(decoder.decode(buffer, frames));
+  EXPECT_EQ(input, buffer.toString());
+  EXPECT_EQ(static_cast<size_t>(0), frames.size());
+}
+
+// The slices of the input holding only frame data are moved to the frames rather than copied.
+TEST(GrpcCodecTest, decodeMovesDataSlices) {
+  const std::string data(4096, 'a');
+  Buffer::BufferFragmentImpl first_fragment(data.data(), data.size(), nullptr);
+  Buffer::BufferFragmentImpl second_fragment(data.data(), data.size(), nullptr);
+  Buffer::OwnedImpl buffer;
+  std::array<uint8_t, 5> header;
+  Encoder encoder;
+  encoder.newFrame(GRPC_FH_DEFAULT, 2 * data.size(), header);
+  buffer.add(header.data(), 5);
+  buffer.addBufferFragment(first_fragment);
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  EXPECT_TRUE(decoder.decode(buffer, frames));
+  EXPECT_EQ(static_cast<size_t>(0), frames.size());
+  EXPECT_EQ(static_cast<size_t>(0), buffer.length());
+
+  buffer.addBufferFragment(second_fragment);
+  EXPECT_TRUE(decoder.decode(buffer, frames));
+  EXPECT_EQ(static_cast<size_t>(0), buffer.length());
+  ASSERT_EQ(static_cast<size_t>(1), frames.size());
+  EXPECT_EQ(2 * data.size(), frames[0].length_);
+
+  Buffer::RawSlice slices[2];
+  ASSERT_EQ(2, frames[0].data_->getRawSlices(slices, 2));
+  EXPECT_EQ(static_cast<const void*>(data.data()), slices[0].mem_);
+  EXPECT_EQ(static_cast<const void*>(data.data()), slices[1].mem_);
+}
+
 TEST(GrpcCodecTest, decodeEmptyFrame) {
   Buffer::OwnedImpl buffer("\0\0\0\0", 5);
 
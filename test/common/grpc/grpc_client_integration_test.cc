@@ -47,6 +47,26 @@ TEST_P(GrpcClientIntegrationTest, BasicRequest) {
   dispatcher_helper_.runDispatcher();
 }
 
+#ifdef ENVOY_GOOGLE_GRPC
+// Validate that the Google gRPC client works with a completion queue shared with another silo, and
+// that the streams left open when its silo goes away are drained without shutting the shared
+// completion queue down.
+TEST_P(GrpcClientIntegrationTest, SharedCompletionQueue) {
+  SKIP_IF_GRPC_CLIENT(ClientType::EnvoyGrpc);
+  google_completion_queue_ = std::make_shared<GoogleCompletionQueue>(*api_);
+  GoogleAsyncClientThreadLocal other_silo_tls(google_completion_queue_);
+  initialize();
+  auto request = createRequest(empty_metadata_);
+  request->sendReply();
+  dispatcher_helper_.runDispatcher();
+
+  auto stream = createStream(empty_metadata_);
+  stream->sendRequest();
+  grpc_client_.reset();
+  google_tls_.reset();
+}
+#endif
+
 // Validate that multiple streams work.
 TEST_P(GrpcClientIntegrationTest, MultiStream) {
   initialize();
@@ -312,7 +312,9 @@ public:
 
   RawAsyncClientPtr createGoogleAsyncClientImpl() {
 #ifdef ENVOY_GOOGLE_GRPC
-    google_tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_);
+    google_tls_ = google_completion_queue_ != nullptr
+                      ? std::make_unique<GoogleAsyncClientThreadLocal>(google_completion_queue_)
+                      : std::make_unique<GoogleAsyncClientThreadLocal>(*api_);
     GoogleGenericStubFactory stub_factory;
     return std::make_unique<GoogleAsyncClientImpl>(*dispatcher_, *google_tls_, stub_factory,
                                                    stats_scope_, createGoogleGrpcConfig(), *api_);
@@ -428,6 +430,8 @@ public:
   Stats::ScopeSharedPtr stats_scope_{stats_store_};
   TestMetadata service_wide_initial_metadata_;
 #ifdef ENVOY_GOOGLE_GRPC
+  // If set, the completion queue shared by the Google gRPC client with other silos.
+  GoogleCompletionQueueSharedPtr google_completion_queue_;
   std::unique_ptr<GoogleAsyncClientThreadLocal> google_tls_;
 #endif
   AsyncClient<helloworld::HelloRequest, helloworld::HelloReply> grpc_client_;
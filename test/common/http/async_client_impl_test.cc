@@ -1184,8 +1184,14 @@ TEST_F(AsyncClientImplTest, WatermarkCallbacks) {
   stream->sendHeaders(headers, false);
   Http::StreamDecoderFilterCallbacks* filter_callbacks =
       static_cast<Http::AsyncStreamImpl*>(stream);
+  EXPECT_FALSE(stream->isAboveWriteBufferHighWatermark());
   filter_callbacks->onDecoderFilterAboveWriteBufferHighWatermark();
+  EXPECT_TRUE(stream->isAboveWriteBufferHighWatermark());
+  filter_callbacks->onDecoderFilterAboveWriteBufferHighWatermark();
+  filter_callbacks->onDecoderFilterBelowWriteBufferLowWatermark();
+  EXPECT_TRUE(stream->isAboveWriteBufferHighWatermark());
   filter_callbacks->onDecoderFilterBelowWriteBufferLowWatermark();
+  EXPECT_FALSE(stream->isAboveWriteBufferHighWatermark());
   EXPECT_CALL(stream_callbacks_, onReset());
 }
 
@@ -1213,6 +1219,21 @@ TEST_F(AsyncClientImplTest, RdsGettersTest) {
   EXPECT_CALL(stream_callbacks_, onReset());
 }
 
+// The route is part of the stream rather than allocated and reference counted for each call.
+TEST_F(AsyncClientImplTest, RouteOwnedByStream) {
+  AsyncClient::Stream* stream = client_.start(stream_callbacks_, AsyncClient::StreamOptions());
+  Http::StreamDecoderFilterCallbacks* filter_callbacks =
+      static_cast<Http::AsyncStreamImpl*>(stream);
+  Router::RouteConstSharedPtr route = filter_callbacks->route();
+  EXPECT_EQ(route.get(), filter_callbacks->route().get());
+  EXPECT_EQ(0, route.use_count());
+  EXPECT_EQ("fake_cluster", route->routeEntry()->clusterName());
+  EXPECT_EQ("", route->routeEntry()->routeName());
+  EXPECT_TRUE(route->routeEntry()->upgradeMap().empty());
+
+  EXPECT_CALL(stream_callbacks_, onReset());
+}
+
 TEST_F(AsyncClientImplTest, DumpState) {
   TestHeaderMapImpl headers;
   HttpTestUtility::addDefaultHeaders(headers);
@@ -146,6 +146,13 @@ public:
   const Http::Http1Settings& http1Settings() const override { return http1_settings_; }
   bool shouldNormalizePath() const override { return false; }
   bool shouldMergeSlashes() const override { return false; }
+  uint32_t streamArenaBlockSize() const override { return 0; }
+  const absl::optional<RequestBodySpillConfig>& requestBodySpill() const override {
+    return request_body_spill_;
+  }
+  const absl::optional<FilterTimingConfig>& filterTiming() const override {
+    return filter_timing_;
+  }
 
   const envoy::extensions::filters::network::http_connection_manager::v3alpha::HttpConnectionManager
       config_;
@@ -182,6 +189,8 @@ public:
   bool proxy_100_continue_{true};
   bool preserve_external_request_id_{false};
   Http::Http1Settings http1_settings_;
+  absl::optional<RequestBodySpillConfig> request_body_spill_;
+  absl::optional<FilterTimingConfig> filter_timing_;
   Http::DefaultInternalAddressConfig internal_address_config_;
   bool normalize_path_{true};
 };
@@ -0,0 +1,296 @@
+// Usage: bazel run -c opt //test/common/http:conn_manager_impl_speed_test
+//
+// Drives streams through the connection manager, from the codec creating a stream and decoding its
+// request headers to the response headers encoded back to the codec, with a chain of pass-through
+// filters and no network. The filters are followed by a filter responding to the request, so each
+// stream goes through all the filters on both the decoding and the encoding paths. The difference
+// between chains of different lengths is the cost of a filter, and the time with no filters is the
+// fixed cost of a stream, which includes that of the mocked connection.
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/http/codec.h"
+#include "envoy/http/filter.h"
+#include "envoy/router/rds.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/empty_string.h"
+#include "common/event/real_time_system.h"
+#include "common/http/conn_manager_impl.h"
+#include "common/http/context_impl.h"
+#include "common/http/date_provider_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// A route configuration with no routes, as no router follows the filters.
+class NoRouteConfig : public Router::Config {
+public:
+  // Router::Config
+  Router::RouteConstSharedPtr route(const HeaderMap&, const StreamInfo::StreamInfo&,
+                                    uint64_t) const override {
+    return nullptr;
+  }
+  const std::list<LowerCaseString>& internalOnlyHeaders() const override {
+    return internal_only_headers_;
+  }
+  const std::string& name() const override { return EMPTY_STRING; }
+  bool usesVhds() const override { return false; }
+  bool mostSpecificHeaderMutationsWins() const override { return false; }
+
+private:
+  const std::list<LowerCaseString> internal_only_headers_;
+};
+
+class NoRouteConfigProvider : public Router::RouteConfigProvider {
+public:
+  NoRouteConfigProvider(TimeSource& time_source) : time_source_(time_source) {}
+
+  // Router::RouteConfigProvider
+  Router::ConfigConstSharedPtr config() override { return config_; }
+  absl::optional<ConfigInfo> configInfo() const override { return {}; }
+  SystemTime lastUpdated() const override { return time_source_.systemTime(); }
+  void onConfigUpdate() override {}
+  void validateConfig(const envoy::config::route::v3alpha::RouteConfiguration&) const override {}
+
+private:
+  TimeSource& time_source_;
+  const Router::ConfigConstSharedPtr config_{std::make_shared<NoRouteConfig>()};
+};
+
+// Responds to the requests once they have gone through the filters before it.
+class ResponseFilter : public PassThroughDecoderFilter {
+public:
+  // Http::StreamDecoderFilter
+  FilterHeadersStatus decodeHeaders(HeaderMap&, bool) override {
+    decoder_callbacks_->encodeHeaders(
+        std::make_unique<HeaderMapImpl>(
+            std::initializer_list<std::pair<LowerCaseString, std::string>>{
+                {Headers::get().Status, "200"}}),
+        true);
+    return FilterHeadersStatus::StopIteration;
+  }
+};
+
+class PassThroughFilterChainFactory : public FilterChainFactory {
+public:
+  PassThroughFilterChainFactory(uint32_t filters) : filters_(filters) {}
+
+  // Http::FilterChainFactory
+  void createFilterChain(FilterChainFactoryCallbacks& callbacks) override {
+    for (uint32_t i = 0; i < filters_; ++i) {
+      callbacks.addStreamFilter(std::make_shared<PassThroughFilter>());
+    }
+    callbacks.addStreamDecoderFilter(std::make_shared<ResponseFilter>());
+  }
+  bool createUpgradeFilterChain(absl::string_view, const UpgradeMap*,
+                                FilterChainFactoryCallbacks&) override {
+    return false;
+  }
+
+private:
+  const uint32_t filters_;
+};
+
+// The codec of the connection, which creates a stream and decodes its request headers on each
+// dispatch, and the encoder of the streams, which drops the responses.
+class BenchmarkCodec : public ServerConnection, public StreamEncoder, public Stream {
+public:
+  BenchmarkCodec(ServerConnectionCallbacks& callbacks, const HeaderMap& request_headers)
+      : callbacks_(callbacks), request_headers_(request_headers) {}
+
+  // Http::Connection
+  void dispatch(Buffer::Instance&) override {
+    StreamDecoder& decoder = callbacks_.newStream(*this);
+    decoder.decodeHeaders(std::make_unique<HeaderMapImpl>(request_headers_), true);
+  }
+  void goAway() override {}
+  Protocol protocol() override { return Protocol::Http2; }
+  void shutdownNotice() override {}
+  bool wantsToWrite() override { return false; }
+  void onUnderlyingConnectionAboveWriteBufferHighWatermark() override {}
+  void onUnderlyingConnectionBelowWriteBufferLowWatermark() override {}
+
+  // Http::StreamEncoder
+  void encode100ContinueHeaders(const HeaderMap&) override {}
+  void encodeHeaders(const HeaderMap& headers, bool) override {
+    benchmark::DoNotOptimize(headers.size());
+  }
+  void encodeData(Buffer::Instance&, bool) override {}
+  void encodeTrailers(const HeaderMap&) override {}
+  Stream& getStream() override { return *this; }
+  void encodeMetadata(const MetadataMapVector&) override {}
+
+  // Http::Stream
+  void addCallbacks(StreamCallbacks&) override {}
+  void removeCallbacks(StreamCallbacks&) override {}
+  void resetStream(StreamResetReason) override {}
+  void readDisable(bool) override {}
+  uint32_t bufferLimit() override { return 0; }
+  const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
+    return local_address_;
+  }
+
+private:
+  ServerConnectionCallbacks& callbacks_;
+  const HeaderMap& request_headers_;
+  const Network::Address::InstanceConstSharedPtr local_address_{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1")};
+};
+
+class BenchmarkConfig : public ConnectionManagerConfig {
+public:
+  BenchmarkConfig(uint32_t filters, TimeSource& time_source)
+      : filter_factory_(filters), date_provider_(time_source), route_config_provider_(time_source),
+        stats_{{ALL_HTTP_CONN_MAN_STATS(POOL_COUNTER(stats_store_), POOL_GAUGE(stats_store_),
+                                        POOL_HISTOGRAM(stats_store_))},
+               "",
+               stats_store_},
+        tracing_stats_{CONN_MAN_TRACING_STATS(POOL_COUNTER(stats_store_))},
+        listener_stats_{CONN_MAN_LISTENER_STATS(POOL_COUNTER(stats_store_))} {}
+
+  // Http::ConnectionManagerConfig
+  const std::list<AccessLog::InstanceSharedPtr>& accessLogs() override { return access_logs_; }
+  ServerConnectionPtr createCodec(Network::Connection&, const Buffer::Instance&,
+                                  ServerConnectionCallbacks& callbacks) override {
+    return std::make_unique<BenchmarkCodec>(callbacks, request_headers_);
+  }
+  DateProvider& dateProvider() override { return date_provider_; }
+  std::chrono::milliseconds drainTimeout() const override { return std::chrono::milliseconds(100); }
+  FilterChainFactory& filterFactory() override { return filter_factory_; }
+  bool generateRequestId() const override { return false; }
+  bool preserveExternalRequestId() const override { return false; }
+  uint32_t maxRequestHeadersKb() const override { return DEFAULT_MAX_REQUEST_HEADERS_KB; }
+  uint32_t maxRequestHeadersCount() const override { return DEFAULT_MAX_HEADERS_COUNT; }
+  absl::optional<std::chrono::milliseconds> idleTimeout() const override { return {}; }
+  bool isRoutable() const override { return true; }
+  absl::optional<std::chrono::milliseconds> maxConnectionDuration() const override { return {}; }
+  std::chrono::milliseconds streamIdleTimeout() const override { return {}; }
+  std::chrono::milliseconds requestTimeout() const override { return {}; }
+  std::chrono::milliseconds delayedCloseTimeout() const override { return {}; }
+  Router::RouteConfigProvider* routeConfigProvider() override { return &route_config_provider_; }
+  Config::ConfigProvider* scopedRouteConfigProvider() override { return nullptr; }
+  const std::string& serverName() const override { return server_name_; }
+  HttpConnectionManagerProto::ServerHeaderTransformation
+  serverHeaderTransformation() const override {
+    return HttpConnectionManagerProto::OVERWRITE;
+  }
+  ConnectionManagerStats& stats() override { return stats_; }
+  ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  bool useRemoteAddress() const override { return true; }
+  const InternalAddressConfig& internalAddressConfig() const override {
+    return internal_address_config_;
+  }
+  uint32_t xffNumTrustedHops() const override { return 0; }
+  bool skipXffAppend() const override { return false; }
+  const std::string& via() const override { return EMPTY_STRING; }
+  ForwardClientCertType forwardClientCert() const override {
+    return ForwardClientCertType::Sanitize;
+  }
+  const std::vector<ClientCertDetailsType>& setCurrentClientCertDetails() const override {
+    return set_current_client_cert_details_;
+  }
+  const Network::Address::Instance& localAddress() override { return local_address_; }
+  const absl::optional<std::string>& userAgent() override { return user_agent_; }
+  const TracingConnectionManagerConfig* tracingConfig() override { return nullptr; }
+  ConnectionManagerListenerStats& listenerStats() override { return listener_stats_; }
+  bool proxy100Continue() const override { return false; }
+  const Http1Settings& http1Settings() const override { return http1_settings_; }
+  bool shouldNormalizePath() const override { return false; }
+  bool shouldMergeSlashes() const override { return false; }
+  uint32_t streamArenaBlockSize() const override { return 0; }
+  const absl::optional<RequestBodySpillConfig>& requestBodySpill() const override {
+    return request_body_spill_;
+  }
+  const absl::optional<FilterTimingConfig>& filterTiming() const override {
+    return filter_timing_;
+  }
+
+private:
+  const TestHeaderMapImpl request_headers_{{":method", "GET"},
+                                           {":path", "/"},
+                                           {":scheme", "http"},
+                                           {":authority", "host"},
+                                           {"user-agent", "benchmark"}};
+  std::list<AccessLog::InstanceSharedPtr> access_logs_;
+  PassThroughFilterChainFactory filter_factory_;
+  SlowDateProviderImpl date_provider_;
+  NoRouteConfigProvider route_config_provider_;
+  const std::string server_name_{"envoy"};
+  Stats::IsolatedStoreImpl stats_store_;
+  ConnectionManagerStats stats_;
+  ConnectionManagerTracingStats tracing_stats_;
+  ConnectionManagerListenerStats listener_stats_;
+  DefaultInternalAddressConfig internal_address_config_;
+  const std::vector<ClientCertDetailsType> set_current_client_cert_details_;
+  const Network::Address::Ipv4Instance local_address_{"127.0.0.1"};
+  const absl::optional<std::string> user_agent_;
+  const Http1Settings http1_settings_;
+  const absl::optional<RequestBodySpillConfig> request_body_spill_;
+  const absl::optional<FilterTimingConfig> filter_timing_;
+};
+
+// Each stream is a header only request and response. state.range(0) is the number of pass-through
+// filters.
+void ConnectionManagerStream(benchmark::State& state) {
+  Event::RealTimeSystem time_system;
+  BenchmarkConfig config(state.range(0), time_system);
+  testing::NiceMock<Network::MockDrainDecision> drain_close;
+  testing::NiceMock<Runtime::MockRandomGenerator> random;
+  Stats::IsolatedStoreImpl stats_store;
+  ContextImpl http_context(stats_store.symbolTable());
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  testing::NiceMock<LocalInfo::MockLocalInfo> local_info;
+  testing::NiceMock<Upstream::MockClusterManager> cluster_manager;
+  testing::NiceMock<Network::MockReadFilterCallbacks> filter_callbacks;
+  filter_callbacks.connection_.local_address_ =
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1");
+  filter_callbacks.connection_.remote_address_ =
+      std::make_shared<Network::Address::Ipv4Instance>("10.0.0.1");
+
+  ConnectionManagerImpl conn_manager(config, drain_close, random, http_context, runtime,
+                                     local_info, cluster_manager, nullptr, time_system);
+  conn_manager.initializeReadFilterCallbacks(filter_callbacks);
+  Buffer::OwnedImpl data;
+  for (auto _ : state) {
+    // Each dispatch creates a stream, which is complete once it returns.
+    conn_manager.onData(data, false);
+    // The streams are deleted by the connection's dispatcher once complete.
+    filter_callbacks.connection_.dispatcher_.to_delete_.clear();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ConnectionManagerStream)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(20);
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -23,6 +23,7 @@
 #include "common/http/exception.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
+#include "common/http/stream_memory_tracker.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 #include "common/upstream/upstream_impl.h"
@@ -39,9 +40,11 @@
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/ssl/mocks.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/test_time.h"
@@ -343,6 +346,13 @@ public:
   const Http::Http1Settings& http1Settings() const override { return http1_settings_; }
   bool shouldNormalizePath() const override { return normalize_path_; }
   bool shouldMergeSlashes() const override { return merge_slashes_; }
+  uint32_t streamArenaBlockSize() const override { return stream_arena_block_size_; }
+  const absl::optional<RequestBodySpillConfig>& requestBodySpill() const override {
+    return request_body_spill_;
+  }
+  const absl::optional<FilterTimingConfig>& filterTiming() const override {
+    return filter_timing_;
+  }
 
   DangerousDeprecatedTestTime test_time_;
   NiceMock<Router::MockRouteConfigProvider> route_config_provider_;
@@ -397,6 +407,9 @@ public:
   Http::Http1Settings http1_settings_;
   bool normalize_path_ = false;
   bool merge_slashes_ = false;
+  uint32_t stream_arena_block_size_ = 0;
+  absl::optional<RequestBodySpillConfig> request_body_spill_;
+  absl::optional<FilterTimingConfig> filter_timing_;
   NiceMock<Network::MockClientConnection> upstream_conn_; // for websocket tests
   NiceMock<Tcp::ConnectionPool::MockInstance> conn_pool_; // for websocket tests
 
@@ -3420,6 +3433,154 @@ TEST_F(HttpConnectionManagerImplTest, FilterAddBodyInline) {
       HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
 }
 
+// Filter wrappers come out of the stream arena when it is enabled and the bytes are reported in
+// the listener stats when the stream is destroyed.
+TEST_F(HttpConnectionManagerImplTest, StreamArena) {
+  stream_arena_block_size_ = 1024;
+  setup(false, "");
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(response_encoder_);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+  }));
+
+  setupFilterChain(2, 2);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*decoder_filters_[0], decodeComplete());
+  EXPECT_CALL(*decoder_filters_[1], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filters_[1], decodeComplete());
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  EXPECT_CALL(*encoder_filters_[1], encodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*encoder_filters_[1], encodeComplete());
+  EXPECT_CALL(*encoder_filters_[0], encodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*encoder_filters_[0], encodeComplete());
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  expectOnDestroy();
+
+  decoder_filters_[1]->callbacks_->encodeHeaders(
+      HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+  EXPECT_EQ(0U, listener_stats_.downstream_rq_arena_bytes_.value());
+
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+  EXPECT_NE(0U, listener_stats_.downstream_rq_arena_bytes_.value());
+}
+
+// The buffered request body past the threshold is moved to a temporary file.
+TEST_F(HttpConnectionManagerImplTest, RequestBodySpill) {
+  InSequence s;
+  request_body_spill_ = RequestBodySpillConfig{TestEnvironment::temporaryDirectory(), 2};
+  setup(false, "");
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(response_encoder_);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "POST"}}};
+    decoder->decodeHeaders(std::move(headers), false);
+
+    Buffer::OwnedImpl fake_data("hello");
+    decoder->decodeData(fake_data, true);
+  }));
+
+  setupFilterChain(1, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filters_[0], decodeData(_, true))
+      .WillOnce(Return(FilterDataStatus::StopIterationAndBuffer));
+  EXPECT_CALL(*decoder_filters_[0], decodeComplete());
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  // The bytes kept in memory and the spilled bytes are in separate slices.
+  const Buffer::Instance* buffered = decoder_filters_[0]->callbacks_->decodingBuffer();
+  EXPECT_EQ("hello", buffered->toString());
+  Buffer::RawSlice slices[2];
+  ASSERT_EQ(2, buffered->getRawSlices(slices, 2));
+  EXPECT_EQ(2, slices[0].len_);
+  EXPECT_EQ(3, slices[1].len_);
+
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  expectOnDestroy();
+
+  decoder_filters_[0]->callbacks_->encodeHeaders(
+      HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+}
+
+// The named filters of the sampled streams are timed, including the time they are paused for.
+TEST_F(HttpConnectionManagerImplTest, FilterTiming) {
+  setup(false, "");
+  NiceMock<Stats::MockHistogram> decode_us;
+  NiceMock<Stats::MockHistogram> decode_paused_us;
+  NiceMock<Stats::MockHistogram> encode_us;
+  NiceMock<Stats::MockHistogram> encode_paused_us;
+  filter_timing_ = FilterTimingConfig{10000, {}};
+  filter_timing_->stats_.emplace(
+      "timed", FilterTimingStats{decode_us, decode_paused_us, encode_us, encode_paused_us});
+
+  auto filter = std::make_shared<NiceMock<MockStreamFilter>>();
+  auto untimed_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  std::shared_ptr<AccessLog::MockInstance> handler(new NiceMock<AccessLog::MockInstance>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.setFilterName("timed");
+        callbacks.addStreamFilter(filter);
+        callbacks.setFilterName("untimed");
+        callbacks.addStreamDecoderFilter(untimed_filter);
+        callbacks.addAccessLogHandler(handler);
+      }));
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(response_encoder_);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+  }));
+  EXPECT_CALL(*filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  // The filter is paused until it continues decoding.
+  test_time_.timeSystem().sleep(std::chrono::milliseconds(1));
+  EXPECT_CALL(*untimed_filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  filter->decoder_callbacks_->continueDecoding();
+
+  EXPECT_CALL(decode_us, recordValue(_));
+  EXPECT_CALL(decode_paused_us, recordValue(testing::Ge(1000)));
+  EXPECT_CALL(encode_us, recordValue(_));
+  EXPECT_CALL(encode_paused_us, recordValue(0));
+  EXPECT_CALL(*handler, log(_, _, _, _))
+      .WillOnce(Invoke([](const HeaderMap*, const HeaderMap*, const HeaderMap*,
+                          const StreamInfo::StreamInfo& stream_info) {
+        const ProtobufTypes::MessagePtr message =
+            stream_info.filterState()
+                .getDataReadOnly<StreamInfo::FilterState::Object>("envoy.http.filter_timing")
+                .serializeAsProto();
+        const auto& times = dynamic_cast<const ProtobufWkt::Struct&>(*message).fields();
+        ASSERT_EQ(1, times.size());
+        const auto& timed = times.at("timed").struct_value().fields();
+        EXPECT_EQ(4, timed.size());
+        EXPECT_GE(timed.at("decode_paused_us").number_value(), 1000);
+        EXPECT_EQ(0, timed.at("encode_paused_us").number_value());
+      }));
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  untimed_filter->callbacks_->encodeHeaders(
+      HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+}
+
 TEST_F(HttpConnectionManagerImplTest, FilterClearRouteCache) {
   setup(false, "");
 
@@ -4612,7 +4773,7 @@ TEST_F(HttpConnectionManagerImplTest, NoNewStreamWhenOverloaded) {
 
   overload_manager_.overload_state_.setState(
       Server::OverloadActionNames::get().StopAcceptingRequests,
-      Server::OverloadActionState::Active);
+      Server::OverloadActionState::saturated());
 
   EXPECT_CALL(*codec_, dispatch(_)).WillRepeatedly(Invoke([&](Buffer::Instance&) -> void {
     StreamDecoder* decoder = &conn_manager_->newStream(response_encoder_);
@@ -4636,11 +4797,75 @@ TEST_F(HttpConnectionManagerImplTest, NoNewStreamWhenOverloaded) {
   EXPECT_EQ(1U, stats_.named_.downstream_rq_overload_close_.value());
 }
 
+// While the action is scaled, the requests drawn within its scale are dropped.
+TEST_F(HttpConnectionManagerImplTest, NewStreamDroppedWhenScaledOverloaded) {
+  setup(false, "");
+
+  overload_manager_.overload_state_.setState(
+      Server::OverloadActionNames::get().StopAcceptingRequests, Server::OverloadActionState(0.5));
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(4999));
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillRepeatedly(Invoke([&](Buffer::Instance&) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(response_encoder_);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), false);
+  }));
+
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, false))
+      .WillOnce(Invoke([](const HeaderMap& headers, bool) -> void {
+        EXPECT_EQ("503", headers.Status()->value().getStringView());
+      }));
+  EXPECT_CALL(response_encoder_, encodeData(_, true));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_overload_close_.value());
+}
+
+// The streams holding buffered memory are reset by the overload manager through the tracker of
+// the worker.
+TEST_F(HttpConnectionManagerImplTest, ResetHighMemoryStreamWhenOverloaded) {
+  InSequence s;
+  setup(false, "");
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(response_encoder_);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "POST"}}};
+    decoder->decodeHeaders(std::move(headers), false);
+
+    Buffer::OwnedImpl fake_data("hello");
+    decoder->decodeData(fake_data, false);
+  }));
+
+  setupFilterChain(1, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filters_[0], decodeData(_, false))
+      .WillOnce(Return(FilterDataStatus::StopIterationAndBuffer));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  // Nothing is reset while the action is inactive.
+  EXPECT_EQ(0, StreamMemoryTracker::threadTracker().resetLargest(0));
+
+  EXPECT_CALL(response_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  expectOnDestroy();
+  EXPECT_EQ(1, StreamMemoryTracker::threadTracker().resetLargest(1));
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_overload_reset_.value());
+  EXPECT_EQ(0, StreamMemoryTracker::threadTracker().size());
+}
+
 TEST_F(HttpConnectionManagerImplTest, DisableKeepAliveWhenOverloaded) {
   setup(false, "");
 
   overload_manager_.overload_state_.setState(
-      Server::OverloadActionNames::get().DisableHttpKeepAlive, Server::OverloadActionState::Active);
+      Server::OverloadActionNames::get().DisableHttpKeepAlive,
+      Server::OverloadActionState::saturated());
 
   std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
   EXPECT_CALL(filter_factory_, createFilterChain(_))
@@ -94,6 +94,9 @@ public:
   MOCK_CONST_METHOD0(http1Settings, const Http::Http1Settings&());
   MOCK_CONST_METHOD0(shouldNormalizePath, bool());
   MOCK_CONST_METHOD0(shouldMergeSlashes, bool());
+  MOCK_CONST_METHOD0(streamArenaBlockSize, uint32_t());
+  MOCK_CONST_METHOD0(requestBodySpill, const absl::optional<RequestBodySpillConfig>&());
+  MOCK_CONST_METHOD0(filterTiming, const absl::optional<FilterTimingConfig>&());
 
   std::unique_ptr<Http::InternalAddressConfig> internal_address_config_ =
       std::make_unique<DefaultInternalAddressConfig>();
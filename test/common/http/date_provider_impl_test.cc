@@ -1,27 +1,25 @@
 #include <chrono>
+#include <string>
 
+#include "common/common/time_cache.h"
 #include "common/http/date_provider_impl.h"
 #include "common/http/header_map_impl.h"
 
 #include "test/mocks/event/mocks.h"
-#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/printers.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
-using testing::NiceMock;
-
 namespace Envoy {
 namespace Http {
 
 TEST(DateProviderImplTest, All) {
   Event::MockDispatcher dispatcher;
-  NiceMock<ThreadLocal::MockInstance> tls;
   Event::MockTimer* timer = new Event::MockTimer(&dispatcher);
   EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(500), _));
 
-  TlsCachingDateProviderImpl provider(dispatcher, tls);
+  CachingDateProviderImpl provider(dispatcher);
   HeaderMapImpl headers;
   provider.setDateHeader(headers);
   EXPECT_NE(nullptr, headers.Date());
@@ -34,5 +32,24 @@ TEST(DateProviderImplTest, All) {
   EXPECT_NE(nullptr, headers.Date());
 }
 
+// The date is still set once the time cache is updated to another second by another provider.
+TEST(DateProviderImplTest, TimeCacheUpdatedElsewhere) {
+  Event::MockDispatcher dispatcher;
+  Event::MockTimer* timer = new Event::MockTimer(&dispatcher);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(500), _));
+
+  CachingDateProviderImpl provider(dispatcher);
+  HeaderMapImpl headers;
+  provider.setDateHeader(headers);
+  ASSERT_NE(nullptr, headers.Date());
+  const std::string date(headers.Date()->value().getStringView());
+
+  TimeCache::get().update(SystemTime(std::chrono::seconds(1000)));
+  headers.removeDate();
+  provider.setDateHeader(headers);
+  ASSERT_NE(nullptr, headers.Date());
+  EXPECT_EQ(date, headers.Date()->value().getStringView());
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -1,3 +1,6 @@
+#include <list>
+
+#include "common/common/slab_allocator.h"
 #include "common/http/header_map_impl.h"
 
 #include "benchmark/benchmark.h"
@@ -193,6 +196,30 @@ static void HeaderMapImplRemoveInline(benchmark::State& state) {
 }
 BENCHMARK(HeaderMapImplRemoveInline)->Arg(0)->Arg(1)->Arg(10)->Arg(50);
 
+/**
+ * Measure the speed of removing several headers by key name in a single pass, as done for the
+ * internal only headers of a route configuration. The numeric Arg passed by the BENCHMARK(...)
+ * macro call below indicates how many dummy headers this test will add to the HeaderMapImpl.
+ * @note The measured time for each iteration includes the time needed to add one copy of each
+ *       header.
+ */
+static void HeaderMapImplRemoveKeys(benchmark::State& state) {
+  const std::list<LowerCaseString> keys{LowerCaseString("example-key-1"),
+                                        LowerCaseString("example-key-2"),
+                                        LowerCaseString("example-key-3")};
+  const std::string value("01234567890123456789");
+  HeaderMapImpl headers;
+  addDummyHeaders(headers, state.range(0));
+  for (auto _ : state) {
+    for (const LowerCaseString& key : keys) {
+      headers.addReference(key, value);
+    }
+    headers.removeKeys(keys);
+  }
+  benchmark::DoNotOptimize(headers.size());
+}
+BENCHMARK(HeaderMapImplRemoveKeys)->Arg(0)->Arg(1)->Arg(10)->Arg(50);
+
 /**
  * Measure the speed of creating a HeaderMapImpl and populating it with a realistic
  * set of response headers.
@@ -220,6 +247,114 @@ static void HeaderMapImplPopulate(benchmark::State& state) {
 }
 BENCHMARK(HeaderMapImplPopulate);
 
+/**
+ * Measure the speed of populating a HeaderMapImpl with a realistic set of request headers,
+ * copying their keys as a codec does, so that each key is looked up in the static lookup table.
+ */
+static void HeaderMapImplPopulateRequest(benchmark::State& state) {
+  const std::pair<std::string, std::string> headers_to_add[] = {
+      {":method", "GET"},
+      {":path", "/index.html"},
+      {":scheme", "https"},
+      {":authority", "www.example.com"},
+      {"user-agent", "Mozilla/5.0 (X11; Linux x86_64; rv:71.0) Gecko/20100101 Firefox/71.0"},
+      {"accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"},
+      {"accept-language", "en-US,en;q=0.5"},
+      {"accept-encoding", "gzip, deflate, br"},
+      {"cookie", "_cookie1=12345678; _cookie2=12345678"},
+      {"upgrade-insecure-requests", "1"},
+      {"cache-control", "max-age=0"},
+      {"x-forwarded-for", "10.0.0.1"},
+      {"x-request-id", "4d5b1c3e-6f2a-4b8e-9c1d-2e3f4a5b6c7d"},
+      {"x-custom-header", "example"},
+  };
+  for (auto _ : state) {
+    HeaderMapImpl headers;
+    for (const auto& key_value : headers_to_add) {
+      HeaderString key;
+      key.setCopy(key_value.first);
+      HeaderString value;
+      value.setCopy(key_value.second);
+      headers.addViaMove(std::move(key), std::move(value));
+    }
+    benchmark::DoNotOptimize(headers.size());
+  }
+}
+BENCHMARK(HeaderMapImplPopulateRequest);
+
+/**
+ * Measure the speed of creating a HeaderMapImpl, populating it with the number of dummy headers
+ * given by the Arg, iterating over it and removing a prefix. This is representative of the
+ * lifetime of a request header map at the edge.
+ */
+static void HeaderMapImplLifecycle(benchmark::State& state) {
+  const LowerCaseString prefix("dummy-key-1");
+  size_t num_callbacks = 0;
+  auto counting_callback = [](const HeaderEntry&, void* context) -> HeaderMap::Iterate {
+    (*static_cast<size_t*>(context))++;
+    return HeaderMap::Iterate::Continue;
+  };
+  for (auto _ : state) {
+    HeaderMapImpl headers;
+    addDummyHeaders(headers, state.range(0));
+    headers.iterate(counting_callback, &num_callbacks);
+    headers.removePrefix(prefix);
+    benchmark::DoNotOptimize(headers.size());
+  }
+  benchmark::DoNotOptimize(num_callbacks);
+}
+BENCHMARK(HeaderMapImplLifecycle)->Arg(10)->Arg(30)->Arg(60);
+
+// Stand-in for HeaderMapImpl::HeaderEntryImpl, which is not accessible outside of the map.
+struct BenchmarkHeaderEntry {
+  BenchmarkHeaderEntry(absl::string_view key, absl::string_view value) {
+    key_.setCopy(key);
+    value_.setCopy(value);
+  }
+
+  HeaderString key_;
+  HeaderString value_;
+};
+
+/**
+ * Compare the std::allocator backed header list that HeaderMapImpl used to have with the
+ * SlabAllocator backed one it uses now. Each iteration builds a list with the number of entries
+ * given by the Arg, iterates over it and then removes every other entry.
+ */
+template <class List> static void populateIterateRemove(List& list, size_t num_headers) {
+  const std::string prefix("dummy-key-");
+  for (size_t i = 0; i < num_headers; i++) {
+    list.emplace_back(prefix + std::to_string(i), "abcd");
+  }
+  size_t total = 0;
+  for (const BenchmarkHeaderEntry& entry : list) {
+    total += entry.key_.size() + entry.value_.size();
+  }
+  benchmark::DoNotOptimize(total);
+  size_t index = 0;
+  list.remove_if([&index](const BenchmarkHeaderEntry&) { return (index++ % 2) == 0; });
+}
+
+static void HeaderListStdAllocator(benchmark::State& state) {
+  for (auto _ : state) {
+    std::list<BenchmarkHeaderEntry> list;
+    populateIterateRemove(list, state.range(0));
+    benchmark::DoNotOptimize(list.size());
+  }
+}
+BENCHMARK(HeaderListStdAllocator)->Arg(10)->Arg(30)->Arg(60);
+
+static void HeaderListSlabAllocator(benchmark::State& state) {
+  for (auto _ : state) {
+    SlabPool pool;
+    std::list<BenchmarkHeaderEntry, SlabAllocator<BenchmarkHeaderEntry>> list{
+        SlabAllocator<BenchmarkHeaderEntry>(pool)};
+    populateIterateRemove(list, state.range(0));
+    benchmark::DoNotOptimize(list.size());
+  }
+}
+BENCHMARK(HeaderListSlabAllocator)->Arg(10)->Arg(30)->Arg(60);
+
 } // namespace Http
 } // namespace Envoy
 
@@ -450,6 +450,34 @@ TEST(HeaderMapImplTest, MoveIntoInline) {
   EXPECT_EQ("hello,there", headers.CacheControl()->value().getStringView());
 }
 
+// Every inline header is found in the static lookup table by a copy of its key, and keys close to
+// those of inline headers are not.
+TEST(HeaderMapImplTest, StaticLookup) {
+  VerifiedHeaderMapImpl headers;
+#define ADD_AND_CHECK_INLINE_HEADER(name)                                                          \
+  headers.addCopy(LowerCaseString(std::string(Headers::get().name.get())), "value");               \
+  ASSERT_NE(nullptr, headers.name());                                                              \
+  EXPECT_EQ(Headers::get().name.get(), headers.name()->key().getStringView());
+
+  ALL_INLINE_HEADERS(ADD_AND_CHECK_INLINE_HEADER)
+#undef ADD_AND_CHECK_INLINE_HEADER
+
+  // The legacy host header is mapped to :authority.
+  VerifiedHeaderMapImpl legacy_headers;
+  legacy_headers.addCopy(LowerCaseString("host"), "example.com");
+  ASSERT_NE(nullptr, legacy_headers.Host());
+  EXPECT_EQ(":authority", legacy_headers.Host()->key().getStringView());
+
+  VerifiedHeaderMapImpl other_headers;
+  for (const std::string& key : {":metho", ":methods", "hosts", "content-lengtx", "x"}) {
+    other_headers.addCopy(LowerCaseString(key), "value");
+  }
+  EXPECT_EQ(5, other_headers.size());
+  EXPECT_EQ(nullptr, other_headers.Method());
+  EXPECT_EQ(nullptr, other_headers.Host());
+  EXPECT_EQ(nullptr, other_headers.ContentLength());
+}
+
 TEST(HeaderMapImplTest, Remove) {
   VerifiedHeaderMapImpl headers;
 
@@ -525,6 +553,28 @@ TEST(HeaderMapImplTest, RemoveRegex) {
   EXPECT_EQ(nullptr, headers.ContentLength());
 }
 
+TEST(HeaderMapImplTest, RemoveKeys) {
+  VerifiedHeaderMapImpl headers;
+  headers.addCopy(LowerCaseString("x-first"), "value");
+  headers.addCopy(LowerCaseString("x-kept"), "value");
+  headers.addCopy(LowerCaseString("x-second"), "value");
+  headers.addCopy(LowerCaseString("x-first"), "value2");
+  headers.setContentLength(5);
+
+  // Removing no key is a no-op.
+  headers.removeKeys({});
+  EXPECT_EQ(5UL, headers.size());
+
+  // All the instances of the keys are removed, including inline headers.
+  headers.removeKeys({LowerCaseString("x-first"), LowerCaseString("x-second"),
+                      LowerCaseString("content-length"), LowerCaseString("x-missing")});
+  EXPECT_EQ(1UL, headers.size());
+  EXPECT_NE(nullptr, headers.get(LowerCaseString("x-kept")));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-first")));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-second")));
+  EXPECT_EQ(nullptr, headers.ContentLength());
+}
+
 TEST(HeaderMapImplTest, SetRemovesAllValues) {
   VerifiedHeaderMapImpl headers;
 
@@ -1237,6 +1287,38 @@ TEST(HeaderMapImplTest, ClearHeaderMap) {
   EXPECT_TRUE(headers.empty());
 }
 
+// Exercises node reuse in the slab backed header list with enough headers to span several slabs.
+TEST(HeaderMapImplTest, ManyHeadersRemoveAndReinsert) {
+  VerifiedHeaderMapImpl headers;
+  for (int i = 0; i < 100; i++) {
+    headers.addCopy(LowerCaseString("x-header-" + std::to_string(i)), std::to_string(i));
+  }
+  headers.setReferenceKey(Headers::get().Path, "/");
+  EXPECT_EQ(101UL, headers.size());
+
+  headers.removePrefix(LowerCaseString("x-header-1"));
+  EXPECT_EQ(90UL, headers.size());
+
+  for (int i = 0; i < 20; i++) {
+    headers.addCopy(LowerCaseString("y-header-" + std::to_string(i)), std::to_string(i));
+  }
+  EXPECT_EQ(110UL, headers.size());
+  EXPECT_EQ("/", headers.Path()->value().getStringView());
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-10")));
+  EXPECT_EQ("99", headers.get(LowerCaseString("x-header-99"))->value().getStringView());
+  EXPECT_EQ("19", headers.get(LowerCaseString("y-header-19"))->value().getStringView());
+
+  // Pseudo headers stay in front of reused nodes.
+  const HeaderEntry* first = nullptr;
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        *static_cast<const HeaderEntry**>(context) = &header;
+        return HeaderMap::Iterate::Break;
+      },
+      &first);
+  EXPECT_EQ(headers.Path(), first);
+}
+
 // Validates byte size is properly accounted for in different inline header setting scenarios.
 TEST(HeaderMapImplTest, InlineHeaderByteSize) {
   {
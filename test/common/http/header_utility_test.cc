@@ -205,6 +205,28 @@ name: match-header-B
   EXPECT_FALSE(HeaderUtility::matchHeaders(unmatching_headers_4, header_data));
 }
 
+// The matchers of the same header are grouped, and all of them still apply.
+TEST(MatchHeadersTest, BuildGroupsMatchersOfSameHeader) {
+  envoy::config::route::v3alpha::RouteMatch match;
+  match.add_headers()->MergeFrom(parseHeaderMatcherFromYaml("{name: b, prefix_match: x}"));
+  match.add_headers()->MergeFrom(parseHeaderMatcherFromYaml("{name: a}"));
+  match.add_headers()->MergeFrom(parseHeaderMatcherFromYaml("{name: b, suffix_match: z}"));
+  const std::vector<HeaderUtility::HeaderDataPtr> header_data =
+      HeaderUtility::buildHeaderDataVector(match.headers());
+  ASSERT_EQ(3, header_data.size());
+  EXPECT_EQ("a", header_data[0]->name_.get());
+  EXPECT_EQ(HeaderUtility::HeaderMatchType::Prefix, header_data[1]->header_match_type_);
+  EXPECT_EQ(HeaderUtility::HeaderMatchType::Suffix, header_data[2]->header_match_type_);
+
+  EXPECT_TRUE(
+      HeaderUtility::matchHeaders(TestHeaderMapImpl{{"a", "1"}, {"b", "xyz"}}, header_data));
+  EXPECT_FALSE(
+      HeaderUtility::matchHeaders(TestHeaderMapImpl{{"a", "1"}, {"b", "xy"}}, header_data));
+  EXPECT_FALSE(
+      HeaderUtility::matchHeaders(TestHeaderMapImpl{{"a", "1"}, {"b", "yz"}}, header_data));
+  EXPECT_FALSE(HeaderUtility::matchHeaders(TestHeaderMapImpl{{"b", "xyz"}}, header_data));
+}
+
 TEST(MatchHeadersTest, HeaderPresence) {
   TestHeaderMapImpl matching_headers{{"match-header", "value"}};
   TestHeaderMapImpl unmatching_headers{{"other-header", "value"}};
@@ -0,0 +1,111 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Usage: bazel run -c opt //test/common/http/http1:codec_impl_speed_test
+
+#include <string>
+
+#include "envoy/http/codec.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Minimal decoder and callbacks, so that mock bookkeeping does not end up in the measurements.
+class NoopStreamDecoder : public StreamDecoder {
+public:
+  void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+  void decodeHeaders(HeaderMapPtr&& headers, bool) override {
+    benchmark::DoNotOptimize(headers.get());
+  }
+  void decodeData(Buffer::Instance&, bool) override {}
+  void decodeTrailers(HeaderMapPtr&&) override {}
+  void decodeMetadata(MetadataMapPtr&&) override {}
+};
+
+class NoopServerConnectionCallbacks : public ServerConnectionCallbacks {
+public:
+  void onGoAway() override {}
+  StreamDecoder& newStream(StreamEncoder&, bool) override { return decoder_; }
+
+  NoopStreamDecoder decoder_;
+};
+
+std::string makeRequest(uint64_t num_headers, uint64_t value_size) {
+  std::string request = "GET /some/path/to/a/resource?with=query HTTP/1.1\r\nhost: example.com\r\n";
+  const std::string value(value_size, 'v');
+  for (uint64_t i = 0; i < num_headers; i++) {
+    absl::StrAppend(&request, "x-custom-header-", i, ": ", value, "\r\n");
+  }
+  absl::StrAppend(&request, "\r\n");
+  return request;
+}
+
+// Parse a request with the given number of headers, splitting it in slices of the given size to
+// exercise fragmented header fields and values. A slice size of 0 delivers the request in a
+// single slice. A new codec is used for each request, as a request must be responded to before
+// the next one can be decoded on the same connection.
+void BM_ParseRequestHeaders(benchmark::State& state) {
+  const uint64_t num_headers = state.range(0);
+  const uint64_t value_size = state.range(1);
+  const uint64_t slice_size = state.range(2);
+  const std::string request = makeRequest(num_headers, value_size);
+
+  testing::NiceMock<Network::MockConnection> connection;
+  Stats::IsolatedStoreImpl store;
+  NoopServerConnectionCallbacks callbacks;
+  Http1Settings settings;
+  for (auto _ : state) {
+    ServerConnectionImpl codec(connection, store, callbacks, settings,
+                               DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT);
+    Buffer::OwnedImpl buffer;
+    if (slice_size == 0) {
+      buffer.add(request);
+    } else {
+      for (uint64_t offset = 0; offset < request.size(); offset += slice_size) {
+        buffer.appendSliceForTest(absl::string_view(request).substr(offset, slice_size));
+      }
+    }
+    codec.dispatch(buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK(BM_ParseRequestHeaders)
+    ->Args({0, 0, 0})
+    ->Args({10, 16, 0})
+    ->Args({10, 256, 0})
+    ->Args({50, 16, 0})
+    ->Args({50, 256, 0})
+    ->Args({10, 16, 64})
+    ->Args({50, 256, 64})
+    ->Args({50, 256, 1024});
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
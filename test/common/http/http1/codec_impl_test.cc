@@ -841,6 +841,41 @@ TEST_F(Http1ServerConnectionImplTest, LargeHeaderResponseEncode) {
             output);
 }
 
+// Headers which do not fit in the default reservation are still written in a single slice.
+TEST_F(Http1ServerConnectionImplTest, ManyHeadersResponseEncodeSingleSlice) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamEncoder& encoder, bool) -> Http::StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+
+  std::string output;
+  EXPECT_CALL(connection_, write(_, _))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(1U, data.getRawSlices(nullptr, 0));
+        output.append(data.toString());
+        data.drain(data.length());
+      }));
+
+  TestHeaderMapImpl headers{{":status", "200"}};
+  std::string expected_output = "HTTP/1.1 200 OK\r\n";
+  const std::string header_value(1000, 'a');
+  for (int i = 0; i < 20; i++) {
+    headers.addCopy("header" + std::to_string(i), header_value);
+    expected_output += "header" + std::to_string(i) + ": " + header_value + "\r\n";
+  }
+  response_encoder->encodeHeaders(headers, true);
+  EXPECT_EQ(expected_output + "content-length: 0\r\n\r\n", output);
+}
+
 TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseTrainProperHeaders) {
   codec_settings_.header_key_format_ = Http1Settings::HeaderKeyFormat::ProperCase;
   initialize();
@@ -1319,6 +1354,39 @@ TEST_F(Http1ClientConnectionImplTest, Reset) {
   request_encoder.getStream().resetStream(StreamResetReason::LocalReset);
 }
 
+// Verify that a reset resets all the pipelined requests, and that a request pipelined while the
+// connection is above its high watermark is told so.
+TEST_F(Http1ClientConnectionImplTest, ResetPipelinedRequests) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> response_decoder;
+  Http::StreamEncoder& request_encoder1 = codec_->newStream(response_decoder);
+  Http::MockStreamCallbacks callbacks1;
+  request_encoder1.getStream().addCallbacks(callbacks1);
+  TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  request_encoder1.encodeHeaders(headers, true);
+
+  EXPECT_CALL(callbacks1, onAboveWriteBufferHighWatermark());
+  static_cast<ClientConnection*>(codec_.get())
+      ->onUnderlyingConnectionAboveWriteBufferHighWatermark();
+
+  EXPECT_CALL(connection_, aboveHighWatermark()).WillRepeatedly(Return(true));
+  Http::StreamEncoder& request_encoder2 = codec_->newStream(response_decoder);
+  Http::MockStreamCallbacks callbacks2;
+  EXPECT_CALL(callbacks2, onAboveWriteBufferHighWatermark());
+  request_encoder2.getStream().addCallbacks(callbacks2);
+  request_encoder2.encodeHeaders(headers, true);
+
+  EXPECT_CALL(callbacks1, onBelowWriteBufferLowWatermark());
+  EXPECT_CALL(callbacks2, onBelowWriteBufferLowWatermark());
+  static_cast<ClientConnection*>(codec_.get())
+      ->onUnderlyingConnectionBelowWriteBufferLowWatermark();
+
+  EXPECT_CALL(callbacks1, onResetStream(StreamResetReason::ConnectionTermination, _));
+  EXPECT_CALL(callbacks2, onResetStream(StreamResetReason::ConnectionTermination, _));
+  request_encoder1.getStream().resetStream(StreamResetReason::ConnectionTermination);
+}
+
 // Verify that we correctly enable reads on the connection when the final pipeline response is
 // received.
 TEST_F(Http1ClientConnectionImplTest, FlowControlReadDisabledReenable) {
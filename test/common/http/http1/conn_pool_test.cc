@@ -47,15 +47,17 @@ class ConnPoolImplForTest : public ConnPoolImpl {
 public:
   ConnPoolImplForTest(Event::MockDispatcher& dispatcher,
                       Upstream::ClusterInfoConstSharedPtr cluster,
-                      NiceMock<Event::MockTimer>* upstream_ready_timer)
+                      NiceMock<Event::MockTimer>* upstream_ready_timer,
+                      const Http1Settings& settings = Http1Settings())
       : ConnPoolImpl(dispatcher, Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000"),
-                     Upstream::ResourcePriority::Default, nullptr, Http1Settings(), nullptr),
+                     Upstream::ResourcePriority::Default, nullptr, settings, nullptr),
         api_(Api::createApiForTest()), mock_dispatcher_(dispatcher),
         mock_upstream_ready_timer_(upstream_ready_timer) {}
 
   ~ConnPoolImplForTest() override {
     EXPECT_EQ(0U, ready_clients_.size());
     EXPECT_EQ(0U, busy_clients_.size());
+    EXPECT_EQ(0U, pipelining_clients_.size());
     EXPECT_EQ(0U, pending_requests_.size());
   }
 
@@ -127,9 +129,9 @@ public:
  */
 class Http1ConnPoolImplTest : public testing::Test {
 public:
-  Http1ConnPoolImplTest()
+  explicit Http1ConnPoolImplTest(const Http1Settings& settings = Http1Settings())
       : upstream_ready_timer_(new NiceMock<Event::MockTimer>(&dispatcher_)),
-        conn_pool_(dispatcher_, cluster_, upstream_ready_timer_) {}
+        conn_pool_(dispatcher_, cluster_, upstream_ready_timer_, settings) {}
 
   ~Http1ConnPoolImplTest() override {
     EXPECT_TRUE(TestUtility::gaugesZeroed(cluster_->stats_store_.gauges()));
@@ -949,6 +951,224 @@ TEST_F(Http1ConnPoolImplTest, PendingRequestIsConsideredActive) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_destroy_remote_.value());
 }
 
+Http1Settings prefetchSettings() {
+  Http1Settings settings;
+  settings.prefetch_ratio_ = 1.5;
+  return settings;
+}
+
+class Http1ConnPoolImplPrefetchTest : public Http1ConnPoolImplTest {
+public:
+  Http1ConnPoolImplPrefetchTest() : Http1ConnPoolImplTest(prefetchSettings()) {}
+};
+
+/**
+ * Verify that idle connections are established ahead of demand and used by later requests.
+ */
+TEST_F(Http1ConnPoolImplPrefetchTest, PrefetchConnections) {
+  // The first request has to wait for its connection, and one more connection is prefetched.
+  {
+    InSequence s;
+    conn_pool_.expectClientCreate();
+    conn_pool_.expectClientCreate();
+  }
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  EXPECT_CALL(*conn_pool_.test_clients_[0].connect_timer_, disableTimer());
+  r1.expectNewStream();
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  r1.startRequest();
+  EXPECT_CALL(*conn_pool_.test_clients_[1].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second request is served by the prefetched connection right away, and another connection
+  // is prefetched to keep up with the two requests in flight.
+  conn_pool_.expectClientCreate();
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Immediate);
+  r2.startRequest();
+
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prefetch_hit_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prefetch_miss_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  // Tear down the connecting prefetched connection and the two idle ones.
+  conn_pool_.test_clients_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.drainConnections();
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(3);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that prefetching respects the connection circuit breaker.
+ */
+TEST_F(Http1ConnPoolImplPrefetchTest, PrefetchRespectsConnectionLimit) {
+  cluster_->resetResourceManager(1, 1024, 1024, 1, 1);
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  r1.completeResponse(false);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+Http1Settings pipelineSettings() {
+  Http1Settings settings;
+  settings.max_pipelined_requests_ = 2;
+  return settings;
+}
+
+class Http1ConnPoolImplPipelineTest : public Http1ConnPoolImplTest {
+public:
+  explicit Http1ConnPoolImplPipelineTest(const Http1Settings& settings = pipelineSettings())
+      : Http1ConnPoolImplTest(settings) {}
+
+  void startRequest(ActiveTestRequest& request, const std::string& method) {
+    request.callbacks_.outer_encoder_->encodeHeaders(TestHeaderMapImpl{{":method", method}}, true);
+  }
+};
+
+/**
+ * Verify that requests are pipelined behind idempotent requests, up to the configured depth, and
+ * that pending requests are pipelined once a response completes.
+ */
+TEST_F(Http1ConnPoolImplPipelineTest, PipelinesBehindIdempotentRequests) {
+  cluster_->resetResourceManager(1, 1024, 1024, 1, 1);
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  startRequest(r1, "GET");
+
+  // The second request is pipelined on the connection rather than wait for another one.
+  ActiveTestRequest r2(*this, 0, ActiveTestRequest::Type::Immediate);
+  startRequest(r2, "PUT");
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_pipelined_.value());
+
+  // The third request exceeds the pipelining depth and has to wait.
+  ActiveTestRequest r3(*this, 0, ActiveTestRequest::Type::Pending);
+
+  // Once the first response completes, the third request is pipelined behind the second one.
+  conn_pool_.expectEnableUpstreamReady();
+  r1.completeResponse(false);
+  r3.expectNewStream();
+  conn_pool_.expectAndRunUpstreamReady();
+  startRequest(r3, "GET");
+  EXPECT_EQ(2U, cluster_->stats_.upstream_rq_pipelined_.value());
+
+  r2.completeResponse(false);
+  r3.completeResponse(true);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that no request is pipelined behind a non-idempotent request.
+ */
+TEST_F(Http1ConnPoolImplPipelineTest, NoPipeliningBehindNonIdempotentRequest) {
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  startRequest(r1, "POST");
+
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::CreateConnection);
+  startRequest(r2, "GET");
+  EXPECT_EQ(0U, cluster_->stats_.upstream_rq_pipelined_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that a request is sent on a new connection rather than pipelined while the connection
+ * circuit breaker allows it.
+ */
+TEST_F(Http1ConnPoolImplPipelineTest, NoPipeliningWhileConnectionsCanBeCreated) {
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  startRequest(r1, "GET");
+
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::CreateConnection);
+  startRequest(r2, "GET");
+  EXPECT_EQ(0U, cluster_->stats_.upstream_rq_pipelined_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that all the requests pipelined on a connection are reset when it closes.
+ */
+TEST_F(Http1ConnPoolImplPipelineTest, ResetsPipelinedRequestsOnClose) {
+  cluster_->resetResourceManager(1, 1024, 1024, 1, 1);
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  startRequest(r1, "GET");
+  ActiveTestRequest r2(*this, 0, ActiveTestRequest::Type::Immediate);
+  startRequest(r2, "GET");
+
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_destroy_with_active_rq_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_rq_active_.value());
+}
+
+Http1Settings prefetchPipelineSettings() {
+  Http1Settings settings;
+  settings.prefetch_ratio_ = 1.5;
+  settings.max_pipelined_requests_ = 4;
+  return settings;
+}
+
+class Http1ConnPoolImplPrefetchPipelineTest : public Http1ConnPoolImplPipelineTest {
+public:
+  Http1ConnPoolImplPrefetchPipelineTest()
+      : Http1ConnPoolImplPipelineTest(prefetchPipelineSettings()) {}
+};
+
+/**
+ * Verify that the requests which can be pipelined on a connection count towards the capacity
+ * prefetching keeps.
+ */
+TEST_F(Http1ConnPoolImplPrefetchPipelineTest, PipeliningCapacityCounted) {
+  {
+    InSequence s;
+    conn_pool_.expectClientCreate();
+    conn_pool_.expectClientCreate();
+  }
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  EXPECT_CALL(*conn_pool_.test_clients_[0].connect_timer_, disableTimer());
+  r1.expectNewStream();
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  startRequest(r1, "GET");
+  EXPECT_CALL(*conn_pool_.test_clients_[1].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The first connection can carry three more requests, so no connection is prefetched for the
+  // second request.
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Immediate);
+  startRequest(r2, "GET");
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+}
+
 } // namespace
 } // namespace Http1
 } // namespace Http
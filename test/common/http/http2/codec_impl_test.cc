@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -111,6 +112,7 @@ public:
     setting.max_inbound_priority_frames_per_stream_ = max_inbound_priority_frames_per_stream_;
     setting.max_inbound_window_update_frames_per_data_frame_sent_ =
         max_inbound_window_update_frames_per_data_frame_sent_;
+    setting.max_auto_tuned_window_size_ = max_auto_tuned_window_size_;
   }
 
   // corruptMetadataFramePayload assumes data contains at least 10 bytes of the beginning of a
@@ -166,6 +168,7 @@ public:
       Http2Settings::DEFAULT_MAX_INBOUND_PRIORITY_FRAMES_PER_STREAM;
   uint32_t max_inbound_window_update_frames_per_data_frame_sent_ =
       Http2Settings::DEFAULT_MAX_INBOUND_WINDOW_UPDATE_FRAMES_PER_DATA_FRAME_SENT;
+  uint32_t max_auto_tuned_window_size_ = Http2Settings::DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE;
 };
 
 class Http2CodecImplTest : public ::testing::TestWithParam<Http2SettingsTestParam>,
@@ -257,6 +260,35 @@ TEST_P(Http2CodecImplTest, ShutdownNotice) {
   response_encoder_->encodeHeaders(response_headers, true);
 }
 
+// Headers decoded from the HPACK static table reference its storage rather than being copied.
+TEST_P(Http2CodecImplTest, StaticTableHeadersReferenced) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("x-custom", "custom value");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true))
+      .WillOnce(Invoke([](HeaderMapPtr& headers, bool) -> void {
+        EXPECT_EQ(HeaderString::Type::Reference, headers->Method()->key().type());
+        EXPECT_EQ(HeaderString::Type::Reference, headers->Method()->value().type());
+        EXPECT_EQ("GET", headers->Method()->value().getStringView());
+        const HeaderEntry* custom = headers->get(LowerCaseString("x-custom"));
+        ASSERT_NE(nullptr, custom);
+        EXPECT_NE(HeaderString::Type::Reference, custom->key().type());
+        EXPECT_NE(HeaderString::Type::Reference, custom->value().type());
+        EXPECT_EQ("custom value", custom->value().getStringView());
+      }));
+  request_encoder_->encodeHeaders(request_headers, true);
+
+  TestHeaderMapImpl response_headers{{":status", "200"}};
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, true))
+      .WillOnce(Invoke([](HeaderMapPtr& headers, bool) -> void {
+        EXPECT_EQ(HeaderString::Type::Reference, headers->Status()->value().type());
+        EXPECT_EQ("200", headers->Status()->value().getStringView());
+      }));
+  response_encoder_->encodeHeaders(response_headers, true);
+}
+
 TEST_P(Http2CodecImplTest, ContinueHeaders) {
   initialize();
 
@@ -897,6 +929,87 @@ TEST_P(Http2CodecImplFlowControlTest, FlowControlPendingRecvData) {
   request_encoder_->encodeData(data, false);
 }
 
+// The windows grow once the DATA frames received over the round trip of a PING frame fill them.
+TEST_P(Http2CodecImplFlowControlTest, AutoTunedWindows) {
+  max_auto_tuned_window_size_ = 1024 * 1024;
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  // Hold the frames sent by the server, so that the PING frame it sends on receiving the first DATA
+  // frame is only acknowledged once the client has filled the windows.
+  Buffer::OwnedImpl server_frames;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(
+          Invoke([&](Buffer::Instance& data, bool) -> void { server_frames.move(data); }));
+  const uint32_t initial_window =
+      nghttp2_session_get_stream_effective_local_window_size(client_->session(), 1);
+  ASSERT_EQ(65535, initial_window);
+  // The DATA frames are sent one at a time, of the default maximum frame size.
+  const uint32_t frame_size = 16384;
+  EXPECT_CALL(request_decoder_, decodeData(_, false)).Times(AnyNumber());
+  for (uint32_t sent = 0; sent < initial_window; sent += frame_size) {
+    Buffer::OwnedImpl data(std::string(std::min(frame_size, initial_window - sent), 'a'));
+    request_encoder_->encodeData(data, false);
+  }
+  EXPECT_EQ(0, nghttp2_session_get_stream_remote_window_size(client_->session(), 1));
+  EXPECT_EQ(0, stats_store_.counter("http2.window_auto_tunes").value());
+
+  // All the DATA frames but the first are received over the round trip, and the windows grow to
+  // twice those bytes.
+  setupDefaultConnectionMocks();
+  client_wrapper_.dispatch(server_frames, *client_);
+  const uint32_t auto_tuned_window = 2 * (initial_window - frame_size);
+  EXPECT_EQ(1, stats_store_.counter("http2.window_auto_tunes").value());
+  EXPECT_EQ(auto_tuned_window, nghttp2_session_get_effective_local_window_size(server_->session()));
+  EXPECT_EQ(auto_tuned_window, nghttp2_session_get_remote_settings(
+                                   client_->session(), NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE));
+  EXPECT_EQ(auto_tuned_window, server_->getStream(1)->bufferLimit());
+
+  // The client can send more than the initial window on the stream.
+  Buffer::OwnedImpl more_data(std::string(initial_window + 1, 'a'));
+  request_encoder_->encodeData(more_data, false);
+  EXPECT_EQ(0, client_->getStream(1)->pending_send_data_.length());
+}
+
+// The frames sent at once, including small DATA payloads, are written as a single slice.
+TEST_P(Http2CodecImplTest, BatchesFramesSentAtOnce) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  uint32_t writes = 0;
+  uint64_t slices = 0;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        writes++;
+        slices += data.getRawSlices(nullptr, 0);
+        client_wrapper_.dispatch(data, *client_);
+      }));
+  EXPECT_CALL(request_decoder_, decodeData(_, true)).WillOnce(InvokeWithoutArgs([&]() -> void {
+    TestHeaderMapImpl response_headers{{":status", "200"}};
+    response_encoder_->encodeHeaders(response_headers, false);
+    Buffer::OwnedImpl response_data("hello");
+    response_encoder_->encodeData(response_data, false);
+    TestHeaderMapImpl response_trailers{{"grpc-status", "0"}};
+    response_encoder_->encodeTrailers(response_trailers);
+  }));
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(response_decoder_, decodeData(_, false));
+  EXPECT_CALL(response_decoder_, decodeTrailers_(_));
+  Buffer::OwnedImpl request_data("a");
+  request_encoder_->encodeData(request_data, true);
+
+  EXPECT_EQ(1, writes);
+  EXPECT_EQ(1, slices);
+}
+
 TEST_P(Http2CodecImplTest, WatermarkUnderEndStream) {
   initialize();
   MockStreamCallbacks callbacks;
@@ -1277,6 +1390,10 @@ TEST_P(Http2CodecImplTestAll, TestCodecHeaderCompression) {
 }
 
 // Verify that codec detects PING flood
+// The frames sent at once are batched into writes, so the flood tests count the PING ACK frames
+// written by their size: a frame header and 8 bytes of opaque data.
+constexpr uint64_t PingAckSize = 9 + 8;
+
 TEST_P(Http2CodecImplTest, PingFlood) {
   initialize();
 
@@ -1290,16 +1407,12 @@ TEST_P(Http2CodecImplTest, PingFlood) {
     EXPECT_EQ(0, nghttp2_submit_ping(client_->session(), NGHTTP2_FLAG_NONE, nullptr));
   }
 
-  int ack_count = 0;
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
-      .WillByDefault(Invoke([&buffer, &ack_count](Buffer::Instance& frame, bool) {
-        ++ack_count;
-        buffer.move(frame);
-      }));
+      .WillByDefault(Invoke([&buffer](Buffer::Instance& frame, bool) { buffer.move(frame); }));
 
   EXPECT_THROW(client_->sendPendingFrames(), FrameFloodException);
-  EXPECT_EQ(ack_count, Http2Settings::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES);
+  EXPECT_EQ(Http2Settings::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES * PingAckSize, buffer.length());
   EXPECT_EQ(1, stats_store_.counter("http2.outbound_control_flood").value());
 }
 
@@ -1340,17 +1453,13 @@ TEST_P(Http2CodecImplTest, PingFloodCounterReset) {
     EXPECT_EQ(0, nghttp2_submit_ping(client_->session(), NGHTTP2_FLAG_NONE, nullptr));
   }
 
-  int ack_count = 0;
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
-      .WillByDefault(Invoke([&buffer, &ack_count](Buffer::Instance& frame, bool) {
-        ++ack_count;
-        buffer.move(frame);
-      }));
+      .WillByDefault(Invoke([&buffer](Buffer::Instance& frame, bool) { buffer.move(frame); }));
 
   // We should be 1 frame under the control frame flood mitigation threshold.
   EXPECT_NO_THROW(client_->sendPendingFrames());
-  EXPECT_EQ(ack_count, kMaxOutboundControlFrames);
+  EXPECT_EQ(kMaxOutboundControlFrames * PingAckSize, buffer.length());
 
   // Drain kMaxOutboundFrames / 2 slices from the send buffer
   buffer.drain(buffer.length() / 2);
@@ -93,8 +93,9 @@ public:
       EXPECT_CALL(*test_clients_.back().connection_, setBufferLimits(*buffer_limits));
     }
     EXPECT_CALL(pool_, createCodecClient_(_))
-        .WillOnce(Invoke([this](Upstream::Host::CreateConnectionData&) -> CodecClient* {
-          return test_clients_.back().codec_client_;
+        .WillOnce(Invoke([this, index = test_clients_.size() - 1](
+                             Upstream::Host::CreateConnectionData&) -> CodecClient* {
+          return test_clients_[index].codec_client_;
         }));
   }
 
@@ -451,6 +452,44 @@ TEST_F(Http2ConnPoolImplTest, RequestAndResponse) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_destroy_remote_.value());
 }
 
+/**
+ * Verify that with several connections per host, all of them are established up front and new
+ * streams go to the connected connection with the fewest active streams.
+ */
+TEST_F(Http2ConnPoolImplTest, MultipleConnectionsPerHost) {
+  InSequence s;
+  cluster_->http2_settings_.connections_per_host_ = 2;
+
+  expectClientCreate();
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+
+  // The second connection is not connected yet, so the stream goes to the first one.
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  ActiveTestRequest r3(*this, 1, true);
+  ActiveTestRequest r4(*this, 1, true);
+  // On a tie, the oldest connection wins.
+  ActiveTestRequest r5(*this, 0, true);
+
+  completeRequest(r1);
+  completeRequest(r2);
+  ActiveTestRequest r6(*this, 0, true);
+
+  completeRequest(r3);
+  completeRequest(r4);
+  completeRequest(r5);
+  completeRequest(r6);
+  closeClient(0);
+  closeClient(1);
+
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(6U, cluster_->stats_.upstream_rq_total_.value());
+}
+
 TEST_F(Http2ConnPoolImplTest, LocalReset) {
   InSequence s;
 
@@ -0,0 +1,87 @@
+#include "common/http/header_map_impl.h"
+#include "common/http/request_coalescer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class TestCoalescedRequest : public CoalescedRequest {
+public:
+  // Http::CoalescedRequest
+  void onLeaderComplete(CoalescedResponseConstSharedPtr response) override {
+    completed_ = true;
+    response_ = std::move(response);
+  }
+
+  bool completed_{};
+  CoalescedResponseConstSharedPtr response_;
+};
+
+class RequestCoalescerTest : public testing::TestWithParam<bool> {
+public:
+  RequestCoalescerTest()
+      : coalescer_(GetParam() ? std::make_unique<RequestCoalescer>(tls_)
+                              : std::make_unique<RequestCoalescer>()) {}
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  RequestCoalescerPtr coalescer_;
+};
+
+INSTANTIATE_TEST_SUITE_P(PerWorker, RequestCoalescerTest, testing::Bool());
+
+// The first request is the leader, the others are notified with its response once it completes.
+TEST_P(RequestCoalescerTest, ShareResponse) {
+  auto leader = std::make_shared<TestCoalescedRequest>();
+  auto follower = std::make_shared<TestCoalescedRequest>();
+  EXPECT_TRUE(coalescer_->join("key", leader, dispatcher_));
+  EXPECT_FALSE(coalescer_->join("key", follower, dispatcher_));
+
+  auto response = std::make_shared<CoalescedResponse>();
+  response->headers_ = std::make_unique<HeaderMapImpl>();
+  coalescer_->complete("key", response);
+  EXPECT_FALSE(leader->completed_);
+  EXPECT_TRUE(follower->completed_);
+  EXPECT_EQ(response, follower->response_);
+
+  // The next request is the leader of a new in-flight request.
+  EXPECT_TRUE(coalescer_->join("key", follower, dispatcher_));
+  coalescer_->complete("key", nullptr);
+}
+
+// Requests with different keys are not coalesced.
+TEST_P(RequestCoalescerTest, DifferentKeys) {
+  auto request = std::make_shared<TestCoalescedRequest>();
+  auto other_request = std::make_shared<TestCoalescedRequest>();
+  EXPECT_TRUE(coalescer_->join("key", request, dispatcher_));
+  EXPECT_TRUE(coalescer_->join("other_key", other_request, dispatcher_));
+  coalescer_->complete("key", nullptr);
+  coalescer_->complete("other_key", nullptr);
+}
+
+// A request which left, or has been destroyed, is not notified.
+TEST_P(RequestCoalescerTest, Leave) {
+  auto leader = std::make_shared<TestCoalescedRequest>();
+  auto follower = std::make_shared<TestCoalescedRequest>();
+  auto destroyed = std::make_shared<TestCoalescedRequest>();
+  EXPECT_TRUE(coalescer_->join("key", leader, dispatcher_));
+  EXPECT_FALSE(coalescer_->join("key", follower, dispatcher_));
+  EXPECT_FALSE(coalescer_->join("key", destroyed, dispatcher_));
+
+  coalescer_->leave("key", *follower);
+  destroyed.reset();
+  coalescer_->complete("key", nullptr);
+  EXPECT_FALSE(follower->completed_);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "common/http/stream_memory_tracker.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class TestStream : public StreamMemoryTracker::Stream {
+public:
+  TestStream(uint64_t bytes, std::vector<TestStream*>& resets) : bytes_(bytes), resets_(resets) {
+    StreamMemoryTracker::threadTracker().add(*this);
+  }
+  ~TestStream() override { StreamMemoryTracker::threadTracker().remove(*this); }
+
+  // Http::StreamMemoryTracker::Stream
+  uint64_t bufferedBytes() override { return bytes_; }
+  void resetForMemory() override {
+    resets_.push_back(this);
+    StreamMemoryTracker::threadTracker().remove(*this);
+    if (on_reset_) {
+      on_reset_();
+    }
+  }
+
+  uint64_t bytes_;
+  std::vector<TestStream*>& resets_;
+  std::function<void()> on_reset_;
+};
+
+// The largest streams are reset first, the oldest first among those holding as much memory.
+TEST(StreamMemoryTrackerTest, ResetsLargestFirst) {
+  std::vector<TestStream*> resets;
+  TestStream small(100, resets);
+  TestStream large(1000, resets);
+  TestStream old_medium(500, resets);
+  TestStream medium(500, resets);
+  TestStream empty(0, resets);
+  EXPECT_EQ(5, StreamMemoryTracker::threadTracker().size());
+
+  EXPECT_EQ(0, StreamMemoryTracker::threadTracker().resetLargest(0));
+  EXPECT_TRUE(resets.empty());
+
+  // Half the 2100 bytes are held by the largest stream and the oldest of the next ones.
+  EXPECT_EQ(2, StreamMemoryTracker::threadTracker().resetLargest(0.5));
+  EXPECT_THAT(resets, testing::ElementsAre(&large, &old_medium));
+
+  // The streams holding no memory are never reset.
+  resets.clear();
+  EXPECT_EQ(2, StreamMemoryTracker::threadTracker().resetLargest(1));
+  EXPECT_THAT(resets, testing::ElementsAre(&medium, &small));
+  EXPECT_EQ(1, StreamMemoryTracker::threadTracker().size());
+}
+
+// A stream removed by the reset of another one, as when they share a connection, isn't reset.
+TEST(StreamMemoryTrackerTest, SkipsStreamsRemovedByReset) {
+  std::vector<TestStream*> resets;
+  TestStream large(1000, resets);
+  TestStream small(100, resets);
+  large.on_reset_ = [&small]() { StreamMemoryTracker::threadTracker().remove(small); };
+
+  EXPECT_EQ(1, StreamMemoryTracker::threadTracker().resetLargest(1));
+  EXPECT_THAT(resets, testing::ElementsAre(&large));
+  EXPECT_EQ(0, StreamMemoryTracker::threadTracker().size());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
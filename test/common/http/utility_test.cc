@@ -275,6 +275,7 @@ TEST(HttpUtility, parseHttp2Settings) {
               http2_settings.max_inbound_priority_frames_per_stream_);
     EXPECT_EQ(Http2Settings::DEFAULT_MAX_INBOUND_WINDOW_UPDATE_FRAMES_PER_DATA_FRAME_SENT,
               http2_settings.max_inbound_window_update_frames_per_data_frame_sent_);
+    EXPECT_EQ(Http2Settings::DEFAULT_CONNECTIONS_PER_HOST, http2_settings.connections_per_host_);
   }
 
   {
@@ -283,12 +284,14 @@ hpack_table_size: 1
 max_concurrent_streams: 2
 initial_stream_window_size: 65535
 initial_connection_window_size: 65535
+connections_per_host: 4
     )EOF";
     auto http2_settings = parseHttp2SettingsFromV2Yaml(yaml);
     EXPECT_EQ(1U, http2_settings.hpack_table_size_);
     EXPECT_EQ(2U, http2_settings.max_concurrent_streams_);
     EXPECT_EQ(65535U, http2_settings.initial_stream_window_size_);
     EXPECT_EQ(65535U, http2_settings.initial_connection_window_size_);
+    EXPECT_EQ(4U, http2_settings.connections_per_host_);
   }
 }
 
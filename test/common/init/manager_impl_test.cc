@@ -1,6 +1,8 @@
 #include "common/init/manager_impl.h"
 
 #include "test/mocks/init/mocks.h"
+#include "test/test_common/logging.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gtest/gtest.h"
 
@@ -188,6 +190,41 @@ TEST(InitManagerImplTest, UnavailableWatcher) {
   t.ready();
 }
 
+// A manager given a time source logs how long it and its slowest targets took to initialize.
+TEST(InitManagerImplTest, LogsTargetDurations) {
+  InSequence s;
+
+  Event::SimulatedTimeSystem time_system;
+  ManagerImpl m("test", time_system);
+
+  ExpectableTargetImpl t1("t1");
+  m.add(t1);
+
+  ExpectableTargetImpl t2("t2");
+  m.add(t2);
+
+  ExpectableWatcherImpl w;
+
+  t1.expectInitialize();
+  t2.expectInitialize();
+  m.initialize(w);
+  time_system.sleep(std::chrono::milliseconds(10));
+  t1.ready();
+  time_system.sleep(std::chrono::milliseconds(20));
+
+  // a target added while initializing is timed from when it's added
+  ExpectableTargetImpl t3("t3");
+  t3.expectInitializeWillCallReady();
+  m.add(t3);
+
+  w.expectReady();
+  EXPECT_LOG_CONTAINS("info",
+                      "init manager test initialized 3 targets in 30ms, slowest: target t2 "
+                      "(30ms), target t1 (10ms), target t3 (0ms)",
+                      t2.ready());
+  expectInitialized(m);
+}
+
 } // namespace
 } // namespace Init
 } // namespace Envoy
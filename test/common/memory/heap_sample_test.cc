@@ -0,0 +1,68 @@
+#include "common/memory/heap_sample.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Memory {
+namespace {
+
+std::string symbolize(uint64_t address) {
+  switch (address + 1) {
+  case 0x10:
+    return "tc_new";
+  case 0x20:
+    return "Envoy::Http::HeaderMapImpl::addCopy(Envoy::Http::LowerCaseString const&)";
+  case 0x30:
+    return "Envoy::Extensions::TransportSockets::Tls::ContextImpl::ContextImpl()";
+  case 0x40:
+    return "Envoy::Extensions::FooFilter()";
+  case 0x50:
+    return "Envoy::main()";
+  default:
+    return "";
+  }
+}
+
+// The allocations are attributed to the innermost Envoy function of their stacks.
+TEST(HeapSampleTest, BytesBySubsystem) {
+  const std::string heap_sample = R"EOF(heap profile:      4:     1600 [     4:     1600] @ heap_v2/0
+     2:     1000 [     2:     1000] @ 0x10 0x20 0x30
+     1:      200 [     1:      200] @ 0x10 0x30 0x20
+     1:      400 [     1:      400] @ 0x10 0x40
+     1:      100 [     1:      100] @ 0x10 0x50 0x60
+     1:       50 [     1:       50] @ 0x10 0x60
+
+MAPPED_LIBRARIES:
+00400000-00500000 r-xp 00000000 00:00 0 /envoy
+)EOF";
+
+  const std::vector<std::pair<std::string, uint64_t>> expected{
+      {"Envoy::Http", 1000},
+      {"Envoy::Extensions", 400},
+      {"Envoy::Extensions::TransportSockets", 200},
+      {"other", 150},
+  };
+  EXPECT_EQ(expected, HeapSample::bytesBySubsystem(heap_sample, symbolize));
+}
+
+// Sampled allocations stand for the allocations they were chosen among.
+TEST(HeapSampleTest, EstimatesSampledBytes) {
+  const std::string heap_sample = R"EOF(heap profile:      1:      512 [     1:      512] @ heap_v2/512
+     1:      512 [     1:      512] @ 0x10 0x20
+)EOF";
+
+  // 512 / (1 - exp(-1))
+  const std::vector<std::pair<std::string, uint64_t>> expected{{"Envoy::Http", 810}};
+  EXPECT_EQ(expected, HeapSample::bytesBySubsystem(heap_sample, symbolize));
+}
+
+TEST(HeapSampleTest, EmptySample) {
+  EXPECT_TRUE(HeapSample::bytesBySubsystem("", symbolize).empty());
+  EXPECT_TRUE(HeapSample::bytesBySubsystem(
+                  "This malloc implementation does not support sampling.\n", symbolize)
+                  .empty());
+}
+
+} // namespace
+} // namespace Memory
+} // namespace Envoy
@@ -4,6 +4,7 @@
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/server/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
@@ -23,7 +24,7 @@ protected:
       : api_(Api::createApiForTest(stats_, time_system_)), dispatcher_(*api_, time_system_) {}
 
   void step() {
-    time_system_.sleep(std::chrono::milliseconds(10000));
+    time_system_.sleep(std::chrono::milliseconds(1000));
     dispatcher_.run(Event::Dispatcher::RunType::NonBlock);
   }
 
@@ -32,6 +33,7 @@ protected:
   Api::ApiPtr api_;
   Event::DispatcherImpl dispatcher_;
   NiceMock<Server::MockOverloadManager> overload_manager_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   Event::TimerCb timer_cb_;
 };
 
@@ -39,7 +41,8 @@ TEST_F(HeapShrinkerTest, DoNotShrinkWhenNotConfigured) {
   NiceMock<Event::MockDispatcher> dispatcher;
   EXPECT_CALL(overload_manager_, registerForAction(_, _, _)).WillOnce(Return(false));
   EXPECT_CALL(dispatcher, createTimer_(_)).Times(0);
-  HeapShrinker h(dispatcher, overload_manager_, stats_);
+  EXPECT_CALL(tls_, allocateSlot()).Times(0);
+  HeapShrinker h(dispatcher, overload_manager_, tls_, stats_);
 }
 
 TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
@@ -50,7 +53,7 @@ TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
         return true;
       }));
 
-  HeapShrinker h(dispatcher_, overload_manager_, stats_);
+  HeapShrinker h(dispatcher_, overload_manager_, tls_, stats_);
 
   auto data = std::make_unique<char[]>(5000000);
   const uint64_t physical_mem_before_shrink =
@@ -59,7 +62,9 @@ TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
 
   Envoy::Stats::Counter& shrink_count =
       stats_.counter("overload.envoy.overload_actions.shrink_heap.shrink_count");
-  action_cb(Server::OverloadActionState::Active);
+  action_cb(Server::OverloadActionState::saturated());
+  // The thread caches are flushed on every attempt.
+  EXPECT_CALL(tls_, runOnAllThreads(_));
   step();
   EXPECT_EQ(1, shrink_count.value());
 
@@ -72,10 +77,12 @@ TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
 #endif
   Stats::dumpStatsToLog();
 
+  EXPECT_CALL(tls_, runOnAllThreads(_));
   step();
   EXPECT_EQ(2, shrink_count.value());
 
-  action_cb(Server::OverloadActionState::Inactive);
+  action_cb(Server::OverloadActionState::inactive());
+  EXPECT_CALL(tls_, runOnAllThreads(_)).Times(0);
   step();
   step();
   EXPECT_EQ(2, shrink_count.value());
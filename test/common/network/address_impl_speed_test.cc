@@ -20,6 +20,20 @@ static void Ipv4InstanceCreate(benchmark::State& state) {
 }
 BENCHMARK(Ipv4InstanceCreate);
 
+// Addresses are formatted on first use, which this adds to the cost of creating them.
+static void Ipv4InstanceCreateAndFormat(benchmark::State& state) {
+  sockaddr_in addr;
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(443);
+  static constexpr uint32_t Addr = 0xc00002ff; // From the RFC 5737 example range.
+  addr.sin_addr.s_addr = htonl(Addr);
+  for (auto _ : state) {
+    Ipv4Instance address(&addr);
+    benchmark::DoNotOptimize(address.asString());
+  }
+}
+BENCHMARK(Ipv4InstanceCreateAndFormat);
+
 static void Ipv6InstanceCreate(benchmark::State& state) {
   sockaddr_in6 addr;
   addr.sin6_family = AF_INET6;
@@ -33,6 +47,19 @@ static void Ipv6InstanceCreate(benchmark::State& state) {
 }
 BENCHMARK(Ipv6InstanceCreate);
 
+static void Ipv6InstanceCreateAndFormat(benchmark::State& state) {
+  sockaddr_in6 addr;
+  addr.sin6_family = AF_INET6;
+  addr.sin6_port = htons(443);
+  static const char* Addr = "2001:DB8::1234"; // From the RFC 3849 example range.
+  inet_pton(AF_INET6, Addr, &addr.sin6_addr);
+  for (auto _ : state) {
+    Ipv6Instance address(addr);
+    benchmark::DoNotOptimize(address.asString());
+  }
+}
+BENCHMARK(Ipv6InstanceCreateAndFormat);
+
 } // namespace Address
 } // namespace Network
 } // namespace Envoy
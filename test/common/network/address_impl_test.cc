@@ -156,6 +156,19 @@ TEST(Ipv4InstanceTest, SocketAddress) {
   EXPECT_TRUE(address.ip()->isUnicastAddress());
 }
 
+// The address is formatted on first use, whichever of its forms is used first.
+TEST(Ipv4InstanceTest, SocketAddressFormattedOnFirstUse) {
+  sockaddr_in addr4;
+  addr4.sin_family = AF_INET;
+  EXPECT_EQ(1, inet_pton(AF_INET, "10.0.0.1", &addr4.sin_addr));
+  addr4.sin_port = htons(443);
+
+  Ipv4Instance address(&addr4);
+  EXPECT_EQ("10.0.0.1", address.ip()->addressAsString());
+  EXPECT_EQ("10.0.0.1:443", address.asString());
+  EXPECT_EQ(&address.asString(), &address.logicalName());
+}
+
 TEST(Ipv4InstanceTest, AddressOnly) {
   Ipv4Instance address("3.4.5.6");
   EXPECT_EQ("3.4.5.6:0", address.asString());
@@ -243,6 +256,18 @@ TEST(Ipv6InstanceTest, SocketAddress) {
   EXPECT_TRUE(address.ip()->isUnicastAddress());
 }
 
+TEST(Ipv6InstanceTest, SocketAddressFormattedOnFirstUse) {
+  sockaddr_in6 addr6;
+  addr6.sin6_family = AF_INET6;
+  EXPECT_EQ(1, inet_pton(AF_INET6, "2001:db8::1", &addr6.sin6_addr));
+  addr6.sin6_port = htons(443);
+
+  Ipv6Instance address(addr6);
+  EXPECT_EQ("2001:db8::1", address.ip()->addressAsString());
+  EXPECT_EQ("[2001:db8::1]:443", address.asStringView());
+  EXPECT_EQ("[2001:db8::1]:443", address.asString());
+}
+
 TEST(Ipv6InstanceTest, AddressOnly) {
   Ipv6Instance address("2001:0db8:85a3:0000:0000:8a2e:0370:7334");
   EXPECT_EQ("[2001:db8:85a3::8a2e:370:7334]:0", address.asString());
@@ -0,0 +1,90 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include "test/mocks/runtime/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  explicit TestBalancedConnectionHandler(uint64_t num_connections)
+      : num_connections_(num_connections) {}
+
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { num_connections_++; }
+  void post(Network::ConnectionSocketPtr&&) override {}
+
+  uint64_t num_connections_;
+};
+
+class PowerOfTwoChoicesConnectionBalancerImplTest : public testing::Test {
+public:
+  NiceMock<Runtime::MockRandomGenerator> random_;
+};
+
+// The accepting handler keeps the connection unless the other choice has fewer connections.
+TEST_F(PowerOfTwoChoicesConnectionBalancerImplTest, PicksLessLoadedChoice) {
+  PowerOfTwoChoicesConnectionBalancerImpl balancer(random_, 3);
+  TestBalancedConnectionHandler handler0(5);
+  TestBalancedConnectionHandler handler1(2);
+  TestBalancedConnectionHandler handler2(7);
+  balancer.registerHandler(handler0);
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler0));
+  EXPECT_EQ(5U, handler0.num_connections_);
+  EXPECT_EQ(3U, handler1.num_connections_);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(2));
+  EXPECT_EQ(&handler0, &balancer.pickTargetHandler(handler0));
+  EXPECT_EQ(6U, handler0.num_connections_);
+  EXPECT_EQ(7U, handler2.num_connections_);
+}
+
+// When the random choice is the accepting handler, the next handler is used instead.
+TEST_F(PowerOfTwoChoicesConnectionBalancerImplTest, SkipsAcceptingHandler) {
+  PowerOfTwoChoicesConnectionBalancerImpl balancer(random_, 2);
+  TestBalancedConnectionHandler handler0(1);
+  TestBalancedConnectionHandler handler1(0);
+  balancer.registerHandler(handler0);
+  balancer.registerHandler(handler1);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0));
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler0));
+  EXPECT_EQ(1U, handler1.num_connections_);
+}
+
+// Free slots left by unregistered handlers keep the connection on the accepting handler, and are
+// reused by handlers registered later.
+TEST_F(PowerOfTwoChoicesConnectionBalancerImplTest, UnregisteredHandler) {
+  PowerOfTwoChoicesConnectionBalancerImpl balancer(random_, 2);
+  TestBalancedConnectionHandler handler0(3);
+  TestBalancedConnectionHandler handler1(0);
+  balancer.registerHandler(handler0);
+  balancer.registerHandler(handler1);
+  balancer.unregisterHandler(handler1);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_EQ(&handler0, &balancer.pickTargetHandler(handler0));
+  EXPECT_EQ(4U, handler0.num_connections_);
+
+  TestBalancedConnectionHandler handler2(0);
+  balancer.registerHandler(handler2);
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler0));
+  EXPECT_EQ(1U, handler2.num_connections_);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
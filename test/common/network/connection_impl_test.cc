@@ -391,8 +391,8 @@ TEST_P(ConnectionImplTest, SocketOptionsFailureTest) {
 
 struct MockConnectionStats {
   Connection::ConnectionStats toBufferStats() {
-    return {rx_total_,   rx_current_,   tx_total_,
-            tx_current_, &bind_errors_, &delayed_close_timeouts_};
+    return {rx_total_, rx_current_, tx_total_, tx_current_, &bind_errors_,
+            &delayed_close_timeouts_, nullptr};
   }
 
   StrictMock<Stats::MockCounter> rx_total_;
@@ -405,8 +405,8 @@ struct MockConnectionStats {
 
 struct NiceMockConnectionStats {
   Connection::ConnectionStats toBufferStats() {
-    return {rx_total_,   rx_current_,   tx_total_,
-            tx_current_, &bind_errors_, &delayed_close_timeouts_};
+    return {rx_total_, rx_current_, tx_total_, tx_current_, &bind_errors_,
+            &delayed_close_timeouts_, &reads_per_event_};
   }
 
   NiceMock<Stats::MockCounter> rx_total_;
@@ -415,6 +415,7 @@ struct NiceMockConnectionStats {
   NiceMock<Stats::MockGauge> tx_current_;
   NiceMock<Stats::MockCounter> bind_errors_;
   NiceMock<Stats::MockCounter> delayed_close_timeouts_;
+  NiceMock<Stats::MockHistogram> reads_per_event_;
 };
 
 TEST_P(ConnectionImplTest, ConnectionStats) {
@@ -1503,6 +1504,20 @@ TEST_F(MockTransportConnectionImplTest, ObjectDestructOrder) {
   file_ready_cb_(Event::FileReadyType::Read);
 }
 
+// Test that the reads per event reported by the transport socket are recorded in the optional
+// connection stats histogram.
+TEST_F(MockTransportConnectionImplTest, RecordReadsPerEvent) {
+  // Without the histogram, nothing is recorded.
+  transport_socket_callbacks_->recordReadsPerEvent(1);
+
+  NiceMockConnectionStats stats;
+  connection_->setConnectionStats(stats.toBufferStats());
+  EXPECT_CALL(stats.reads_per_event_, recordValue(3));
+  transport_socket_callbacks_->recordReadsPerEvent(3);
+  // Close while the stats are still in scope.
+  connection_->close(ConnectionCloseType::NoFlush);
+}
+
 // Test that BytesSentCb is invoked at the correct times
 TEST_F(MockTransportConnectionImplTest, BytesSentCallback) {
   uint64_t bytes_sent = 0;
@@ -299,22 +299,35 @@ class DnsResolverImplPeer {
 public:
   DnsResolverImplPeer(DnsResolverImpl* resolver) : resolver_(resolver) {}
 
-  ares_channel channel() const { return resolver_->channel_; }
-  const std::unordered_map<int, Event::FileEventPtr>& events() { return resolver_->events_; }
+  ares_channel channel() const { return resolver_->channels_[0]->channel_; }
+  std::vector<ares_channel> channels() const {
+    std::vector<ares_channel> channels;
+    for (const auto& channel : resolver_->channels_) {
+      channels.push_back(channel->channel_);
+    }
+    return channels;
+  }
+  const std::unordered_map<int, Event::FileEventPtr>& events() {
+    return resolver_->channels_[0]->events_;
+  }
+  size_t pendingResolutions() const { return resolver_->pending_resolutions_.size(); }
+  size_t negativeCacheSize() const { return resolver_->negative_cache_.size(); }
   // Reset the channel state for a DnsResolverImpl such that it will only use
   // TCP and optionally has a zero timeout (for validating timeout behavior).
   void resetChannelTcpOnly(bool zero_timeout) {
-    ares_destroy(resolver_->channel_);
-    ares_options options;
-    // TCP-only connections to TestDnsServer, since even loopback UDP can be
-    // lossy with a server under load.
-    options.flags = ARES_FLAG_USEVC;
-    // Avoid host-specific domain search behavior when testing to improve
-    // determinism.
-    options.ndomains = 0;
-    options.timeout = 0;
-    resolver_->initializeChannel(&options, ARES_OPT_FLAGS | ARES_OPT_DOMAINS |
-                                               (zero_timeout ? ARES_OPT_TIMEOUTMS : 0));
+    for (auto& channel : resolver_->channels_) {
+      ares_destroy(channel->channel_);
+      ares_options options;
+      // TCP-only connections to TestDnsServer, since even loopback UDP can be
+      // lossy with a server under load.
+      options.flags = ARES_FLAG_USEVC;
+      // Avoid host-specific domain search behavior when testing to improve
+      // determinism.
+      options.ndomains = 0;
+      options.timeout = 0;
+      channel->initialize(&options, ARES_OPT_FLAGS | ARES_OPT_DOMAINS |
+                                        (zero_timeout ? ARES_OPT_TIMEOUTMS : 0));
+    }
   }
 
 private:
@@ -336,7 +349,7 @@ TEST_F(DnsImplConstructor, SupportsCustomResolvers) {
   auto addr4 = Network::Utility::parseInternetAddressAndPort("127.0.0.1:54");
   char addr6str[INET6_ADDRSTRLEN];
   auto addr6 = Network::Utility::parseInternetAddressAndPort("[::1]:54");
-  auto resolver = dispatcher_->createDnsResolver({addr4, addr6}, false);
+  auto resolver = dispatcher_->createDnsResolver({addr4, addr6}, {});
   auto peer = std::make_unique<DnsResolverImplPeer>(dynamic_cast<DnsResolverImpl*>(resolver.get()));
   ares_addr_port_node* resolvers;
   int result = ares_get_servers_ports(peer->channel(), &resolvers);
@@ -381,7 +394,7 @@ private:
 TEST_F(DnsImplConstructor, SupportCustomAddressInstances) {
   auto test_instance(std::make_shared<CustomInstance>("127.0.0.1", 45));
   EXPECT_EQ(test_instance->asString(), "127.0.0.1:borked_port_45");
-  auto resolver = dispatcher_->createDnsResolver({test_instance}, false);
+  auto resolver = dispatcher_->createDnsResolver({test_instance}, {});
   auto peer = std::make_unique<DnsResolverImplPeer>(dynamic_cast<DnsResolverImpl*>(resolver.get()));
   ares_addr_port_node* resolvers;
   int result = ares_get_servers_ports(peer->channel(), &resolvers);
@@ -397,7 +410,7 @@ TEST_F(DnsImplConstructor, BadCustomResolvers) {
   envoy::config::core::v3alpha::Address pipe_address;
   pipe_address.mutable_pipe()->set_path("foo");
   auto pipe_instance = Network::Utility::protobufAddressToAddress(pipe_address);
-  EXPECT_THROW_WITH_MESSAGE(dispatcher_->createDnsResolver({pipe_instance}, false), EnvoyException,
+  EXPECT_THROW_WITH_MESSAGE(dispatcher_->createDnsResolver({pipe_instance}, {}), EnvoyException,
                             "DNS resolver 'foo' is not an IP address");
 }
 
@@ -406,7 +419,11 @@ public:
   DnsImplTest() : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()) {}
 
   void SetUp() override {
-    resolver_ = dispatcher_->createDnsResolver({}, use_tcp_for_dns_lookups());
+    DnsResolverOptions options;
+    options.use_tcp_for_dns_lookups_ = use_tcp_for_dns_lookups();
+    options.negative_cache_ttl_ = negative_cache_ttl();
+    options.channels_ = channels();
+    resolver_ = dispatcher_->createDnsResolver({}, options);
 
     // Instantiate TestDnsServer and listen on a random port on the loopback address.
     server_ = std::make_unique<TestDnsServer>(*dispatcher_);
@@ -419,7 +436,9 @@ public:
     if (tcp_only()) {
       peer_->resetChannelTcpOnly(zero_timeout());
     }
-    ares_set_servers_ports_csv(peer_->channel(), socket_->localAddress()->asString().c_str());
+    for (ares_channel channel : peer_->channels()) {
+      ares_set_servers_ports_csv(channel, socket_->localAddress()->asString().c_str());
+    }
   }
 
   void TearDown() override {
@@ -442,6 +461,10 @@ protected:
   virtual bool zero_timeout() const { return false; }
   virtual bool tcp_only() const { return true; }
   virtual bool use_tcp_for_dns_lookups() const { return false; }
+  virtual std::chrono::milliseconds negative_cache_ttl() const {
+    return std::chrono::milliseconds(0);
+  }
+  virtual uint32_t channels() const { return 1; }
   std::unique_ptr<TestDnsServer> server_;
   std::unique_ptr<DnsResolverImplPeer> peer_;
   Network::MockConnectionHandler connection_handler_;
@@ -740,6 +763,164 @@ TEST_P(DnsImplTest, Cancel) {
   EXPECT_TRUE(hasAddress(address_list, "201.134.56.7"));
 }
 
+// Validate that identical concurrent lookups share a single query, whose result is delivered to
+// each of the callers that did not cancel.
+TEST_P(DnsImplTest, CoalescedLookups) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+
+  std::list<Address::InstanceConstSharedPtr> address_list1;
+  std::list<Address::InstanceConstSharedPtr> address_list2;
+  uint32_t completed = 0;
+  ActiveDnsQuery* query1 =
+      resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only,
+                         [&](std::list<DnsResponse>&& results) -> void {
+                           address_list1 = getAddressList(results);
+                           if (++completed == 2) {
+                             dispatcher_->exit();
+                           }
+                         });
+  ActiveDnsQuery* query2 = resolver_->resolve(
+      "some.good.domain", DnsLookupFamily::V4Only,
+      [](std::list<DnsResponse> &&) -> void { FAIL(); });
+  ActiveDnsQuery* query3 =
+      resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only,
+                         [&](std::list<DnsResponse>&& results) -> void {
+                           address_list2 = getAddressList(results);
+                           if (++completed == 2) {
+                             dispatcher_->exit();
+                           }
+                         });
+  ASSERT_NE(nullptr, query1);
+  ASSERT_NE(nullptr, query2);
+  ASSERT_NE(nullptr, query3);
+  EXPECT_NE(query1, query3);
+  EXPECT_EQ(1U, peer_->pendingResolutions());
+  query2->cancel();
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(hasAddress(address_list1, "201.134.56.7"));
+  EXPECT_TRUE(hasAddress(address_list2, "201.134.56.7"));
+  EXPECT_EQ(0U, peer_->pendingResolutions());
+}
+
+class DnsImplNegativeCacheTest : public DnsImplTest {
+protected:
+  std::chrono::milliseconds negative_cache_ttl() const override {
+    return std::chrono::hours(1);
+  }
+};
+
+// Parameterize the DNS test server socket address.
+INSTANTIATE_TEST_SUITE_P(IpVersions, DnsImplNegativeCacheTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// Validate that a failed lookup fails immediately while it is cached.
+TEST_P(DnsImplNegativeCacheTest, FailureCached) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+
+  bool failed = false;
+  EXPECT_NE(nullptr, resolver_->resolve("some.bad.domain", DnsLookupFamily::V4Only,
+                                        [&](std::list<DnsResponse>&& results) -> void {
+                                          failed = results.empty();
+                                          dispatcher_->exit();
+                                        }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(failed);
+
+  failed = false;
+  EXPECT_EQ(nullptr, resolver_->resolve("some.bad.domain", DnsLookupFamily::V4Only,
+                                        [&](std::list<DnsResponse>&& results) -> void {
+                                          failed = results.empty();
+                                        }));
+  EXPECT_TRUE(failed);
+
+  // The other names and lookup families are still queried.
+  std::list<Address::InstanceConstSharedPtr> address_list;
+  EXPECT_NE(nullptr, resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only,
+                                        [&](std::list<DnsResponse>&& results) -> void {
+                                          address_list = getAddressList(results);
+                                          dispatcher_->exit();
+                                        }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(hasAddress(address_list, "201.134.56.7"));
+  EXPECT_NE(nullptr, resolver_->resolve("some.bad.domain", DnsLookupFamily::Auto,
+                                        [&](std::list<DnsResponse> &&) -> void {
+                                          dispatcher_->exit();
+                                        }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+class DnsImplNegativeCacheExpiryTest : public DnsImplTest {
+protected:
+  std::chrono::milliseconds negative_cache_ttl() const override {
+    return std::chrono::milliseconds(1);
+  }
+
+  void resolveFailure(const std::string& dns_name) {
+    EXPECT_NE(nullptr, resolver_->resolve(dns_name, DnsLookupFamily::V4Only,
+                                          [&](std::list<DnsResponse>&& results) -> void {
+                                            EXPECT_TRUE(results.empty());
+                                            dispatcher_->exit();
+                                          }));
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+};
+
+// Parameterize the DNS test server socket address.
+INSTANTIATE_TEST_SUITE_P(IpVersions, DnsImplNegativeCacheExpiryTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// Validate that the expired failures are dropped from the cache rather than kept forever.
+TEST_P(DnsImplNegativeCacheExpiryTest, ExpiredFailuresDropped) {
+  resolveFailure("some.bad.domain");
+  EXPECT_EQ(1U, peer_->negativeCacheSize());
+
+  Event::TimerPtr timer = dispatcher_->createTimer([&]() -> void { dispatcher_->exit(); });
+  timer->enableTimer(std::chrono::milliseconds(2));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  resolveFailure("some.other.bad.domain");
+  EXPECT_EQ(1U, peer_->negativeCacheSize());
+  resolveFailure("some.bad.domain");
+}
+
+class DnsImplChannelsTest : public DnsImplTest {
+protected:
+  uint32_t channels() const override { return 3; }
+};
+
+// Parameterize the DNS test server socket address.
+INSTANTIATE_TEST_SUITE_P(IpVersions, DnsImplChannelsTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// Validate that the lookups spread over several channels all complete.
+TEST_P(DnsImplChannelsTest, Lookups) {
+  EXPECT_EQ(3U, peer_->channels().size());
+  const std::vector<std::string> names{"a.domain", "b.domain", "c.domain", "d.domain"};
+  for (const std::string& name : names) {
+    server_->addHosts(name, {"201.134.56.7"}, RecordType::A);
+  }
+
+  uint32_t resolved = 0;
+  for (const std::string& name : names) {
+    EXPECT_NE(nullptr, resolver_->resolve(name, DnsLookupFamily::V4Only,
+                                          [&](std::list<DnsResponse>&& results) -> void {
+                                            if (hasAddress(getAddressList(results),
+                                                           "201.134.56.7")) {
+                                              resolved++;
+                                            }
+                                            if (resolved == names.size()) {
+                                              dispatcher_->exit();
+                                            }
+                                          }));
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(names.size(), resolved);
+}
+
 // Validate working of querying ttl of resource record.
 TEST_P(DnsImplTest, RecordTtlLookup) {
   if (GetParam() == Address::IpVersion::v4) {
@@ -854,7 +1035,7 @@ TEST(DnsImplUnitTest, PendingTimerEnable) {
   Event::MockDispatcher dispatcher;
   Event::MockTimer* timer = new NiceMock<Event::MockTimer>();
   EXPECT_CALL(dispatcher, createTimer_(_)).WillOnce(Return(timer));
-  DnsResolverImpl resolver(dispatcher, {}, false);
+  DnsResolverImpl resolver(dispatcher, {}, {});
   Event::FileEvent* file_event = new NiceMock<Event::MockFileEvent>();
   EXPECT_CALL(dispatcher, createFileEvent_(_, _, _, _)).WillOnce(Return(file_event));
   EXPECT_CALL(*timer, enableTimer(_, _));
@@ -1,3 +1,6 @@
+#include <random>
+
+#include "common/memory/stats.h"
 #include "common/network/lc_trie.h"
 #include "common/network/utility.h"
 
@@ -21,6 +24,56 @@ std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_nested_pref
 
 std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_minimal;
 
+// Tables shaped like GeoIP or ASN ones: many prefixes, sharing few tags, within a few wider
+// prefixes. The addresses looked up are random, so that most lookups miss the caches.
+std::vector<Envoy::Network::Address::InstanceConstSharedPtr> large_ipv4_addresses;
+std::vector<Envoy::Network::Address::InstanceConstSharedPtr> large_ipv6_addresses;
+
+std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+    tag_data_large_ipv4;
+
+std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+    tag_data_large_ipv6;
+
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_large_ipv4;
+
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_large_ipv6;
+
+constexpr size_t NumLargePrefixes = 100000;
+constexpr size_t NumLargeTags = 250;
+
+void buildLargeTagData(std::mt19937_64& random) {
+  std::vector<std::vector<Envoy::Network::Address::CidrRange>> ipv4_ranges(NumLargeTags);
+  std::vector<std::vector<Envoy::Network::Address::CidrRange>> ipv6_ranges(NumLargeTags);
+  for (size_t i = 0; i < NumLargePrefixes; i++) {
+    const uint64_t bits = random();
+    ipv4_ranges[i % NumLargeTags].push_back(Envoy::Network::Address::CidrRange::create(
+        fmt::format("{}.{}.{}.0/24", (bits >> 16) & 0xff, (bits >> 8) & 0xff, bits & 0xff)));
+    ipv6_ranges[i % NumLargeTags].push_back(Envoy::Network::Address::CidrRange::create(
+        fmt::format("2001:{:x}:{:x}::/48", (bits >> 32) & 0xffff, (bits >> 16) & 0xffff)));
+  }
+  for (size_t i = 0; i < 16; i++) {
+    ipv4_ranges[i].push_back(
+        Envoy::Network::Address::CidrRange::create(fmt::format("{}.0.0.0/8", i * 16)));
+    ipv6_ranges[i].push_back(
+        Envoy::Network::Address::CidrRange::create(fmt::format("2001:{:x}::/32", i * 4096)));
+  }
+  for (size_t i = 0; i < NumLargeTags; i++) {
+    const std::string tag = fmt::format("tag_{}", i);
+    tag_data_large_ipv4.emplace_back(tag, std::move(ipv4_ranges[i]));
+    tag_data_large_ipv6.emplace_back(tag, std::move(ipv6_ranges[i]));
+  }
+  for (size_t i = 0; i < 1024; i++) {
+    const uint64_t bits = random();
+    large_ipv4_addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+        fmt::format("{}.{}.{}.{}", (bits >> 24) & 0xff, (bits >> 16) & 0xff, (bits >> 8) & 0xff,
+                    bits & 0xff)));
+    large_ipv6_addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+        fmt::format("2001:{:x}:{:x}::{:x}", (bits >> 32) & 0xffff, (bits >> 16) & 0xffff,
+                    bits & 0xffff)));
+  }
+}
+
 } // namespace
 
 namespace Envoy {
@@ -56,6 +109,36 @@ static void BM_LcTrieConstructMinimal(benchmark::State& state) {
 
 BENCHMARK(BM_LcTrieConstructMinimal);
 
+// The memory counters are only reported when built with tcmalloc.
+static void constructLarge(
+    benchmark::State& state,
+    const std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>&
+        tag_data) {
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> trie;
+  size_t memory = 0;
+  for (auto _ : state) {
+    trie.reset();
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    trie = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data);
+    memory = Memory::Stats::totalCurrentlyAllocated() - start_mem;
+  }
+  benchmark::DoNotOptimize(trie);
+  state.counters["memory"] = memory;
+  state.counters["memory_per_prefix"] = memory / NumLargePrefixes;
+}
+
+static void BM_LcTrieConstructLargeIpv4(benchmark::State& state) {
+  constructLarge(state, tag_data_large_ipv4);
+}
+
+BENCHMARK(BM_LcTrieConstructLargeIpv4)->Unit(benchmark::kMillisecond);
+
+static void BM_LcTrieConstructLargeIpv6(benchmark::State& state) {
+  constructLarge(state, tag_data_large_ipv6);
+}
+
+BENCHMARK(BM_LcTrieConstructLargeIpv6)->Unit(benchmark::kMillisecond);
+
 static void BM_LcTrieLookup(benchmark::State& state) {
   static size_t i = 0;
   size_t output_tags = 0;
@@ -95,6 +178,32 @@ static void BM_LcTrieLookupMinimal(benchmark::State& state) {
 
 BENCHMARK(BM_LcTrieLookupMinimal);
 
+static void BM_LcTrieLookupLargeIpv4(benchmark::State& state) {
+  static size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    i++;
+    i %= large_ipv4_addresses.size();
+    output_tags += lc_trie_large_ipv4->getData(large_ipv4_addresses[i]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK(BM_LcTrieLookupLargeIpv4);
+
+static void BM_LcTrieLookupLargeIpv6(benchmark::State& state) {
+  static size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    i++;
+    i %= large_ipv6_addresses.size();
+    output_tags += lc_trie_large_ipv6->getData(large_ipv6_addresses[i]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK(BM_LcTrieLookupLargeIpv6);
+
 } // namespace Envoy
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
@@ -132,6 +241,13 @@ int main(int argc, char** argv) {
       std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_nested_prefixes);
   lc_trie_minimal = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_minimal);
 
+  std::mt19937_64 random(1234567);
+  buildLargeTagData(random);
+  lc_trie_large_ipv4 =
+      std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_large_ipv4);
+  lc_trie_large_ipv6 =
+      std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_large_ipv6);
+
   benchmark::Initialize(&argc, argv);
   if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
     return 1;
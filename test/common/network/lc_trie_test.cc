@@ -370,6 +370,29 @@ TEST_F(LcTrieTest, MaximumEntriesExceptionOverride) {
                             "the specified fill factor.");
 }
 
+// Prefixes with the same data share a single copy of it, whether the data is their own or
+// inherited from a wider prefix.
+TEST_F(LcTrieTest, SharedData) {
+  std::vector<std::vector<std::string>> cidr_range_strings = {
+      {"10.0.0.0/8", "2001:db8::/32"}, // tag_0
+      {"10.1.0.0/16", "10.3.0.0/16"},  // tag_1
+  };
+  setup(cidr_range_strings);
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> test_case = {
+      {"10.0.0.1", {"tag_0"}},    {"10.1.0.1", {"tag_0", "tag_1"}},
+      {"10.2.0.1", {"tag_0"}},    {"10.3.0.1", {"tag_0", "tag_1"}},
+      {"2001:db8::1", {"tag_0"}}, {"11.0.0.1", {}},
+  };
+  expectIPAndTags(test_case);
+
+  const auto& tag_0 = trie_->getData(Utility::parseInternetAddress("10.0.0.1"));
+  EXPECT_EQ(&tag_0, &trie_->getData(Utility::parseInternetAddress("10.2.0.1")));
+  EXPECT_EQ(&tag_0, &trie_->getData(Utility::parseInternetAddress("2001:db8::1")));
+  EXPECT_EQ(&trie_->getData(Utility::parseInternetAddress("10.1.0.1")),
+            &trie_->getData(Utility::parseInternetAddress("10.3.0.1")));
+}
+
 } // namespace LcTrie
 } // namespace Network
 } // namespace Envoy
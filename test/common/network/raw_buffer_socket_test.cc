@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_error_impl.h"
+#include "common/network/raw_buffer_socket.h"
+
+#include "test/mocks/network/io_handle.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+Api::IoCallUint64Result writeResult(uint64_t rc) {
+  return Api::IoCallUint64Result(rc, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+Api::IoCallUint64Result eagainResult() {
+  return Api::IoCallUint64Result(
+      0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(), IoSocketError::deleteIoError));
+}
+
+class RawBufferSocketTest : public testing::Test {
+public:
+  void initialize() {
+    socket_ = std::make_unique<RawBufferSocket>();
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(io_handle_));
+    ON_CALL(callbacks_, connection()).WillByDefault(ReturnRef(callbacks_.connection_));
+    socket_->setTransportSocketCallbacks(callbacks_);
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  NiceMock<MockTransportSocketCallbacks> callbacks_;
+  NiceMock<MockIoHandle> io_handle_;
+  std::unique_ptr<RawBufferSocket> socket_;
+};
+
+// A partial write means the socket send buffer is full, so no further write is attempted.
+TEST_F(RawBufferSocketTest, StopOnPartialWrite) {
+  initialize();
+  Buffer::OwnedImpl buffer(std::string(100, 'a'));
+  EXPECT_CALL(io_handle_, writev(_, 1)).WillOnce(Return(testing::ByMove(writeResult(40))));
+
+  IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(40U, result.bytes_processed_);
+  EXPECT_EQ(60U, buffer.length());
+}
+
+// A write that hands over all the slices it was given continues with the rest of the buffer.
+TEST_F(RawBufferSocketTest, ContinueAfterFullWriteOfSlices) {
+  initialize();
+  Buffer::OwnedImpl buffer;
+  for (uint64_t i = 0; i < Buffer::OwnedImpl::MaxSlicesPerWrite + 1; i++) {
+    buffer.appendSliceForTest("aaaaaaaaaa");
+  }
+  EXPECT_CALL(io_handle_, writev(_, Buffer::OwnedImpl::MaxSlicesPerWrite))
+      .WillOnce(Return(testing::ByMove(writeResult(Buffer::OwnedImpl::MaxSlicesPerWrite * 10))));
+  EXPECT_CALL(io_handle_, writev(_, 1)).WillOnce(Return(testing::ByMove(writeResult(10))));
+
+  IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ((Buffer::OwnedImpl::MaxSlicesPerWrite + 1) * 10, result.bytes_processed_);
+  EXPECT_EQ(0U, buffer.length());
+}
+
+// With the runtime feature disabled, writes continue until they fail with EAGAIN.
+TEST_F(RawBufferSocketTest, PartialWriteRuntimeDisabled) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.stop_on_partial_write", "false"}});
+  initialize();
+  Buffer::OwnedImpl buffer(std::string(100, 'a'));
+  EXPECT_CALL(io_handle_, writev(_, 1))
+      .WillOnce(Return(testing::ByMove(writeResult(40))))
+      .WillOnce(Invoke([](const Buffer::RawSlice*, uint64_t) { return eagainResult(); }));
+
+  IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(40U, result.bytes_processed_);
+  EXPECT_EQ(60U, buffer.length());
+}
+
+class RawBufferSocketReadTest : public RawBufferSocketTest {
+public:
+  // Run a read event in which every read returns the given number of bytes, followed by EAGAIN.
+  // Returns the read sizes requested from the socket.
+  std::vector<uint64_t> readEvent(const std::vector<uint64_t>& reads) {
+    std::vector<uint64_t> read_sizes;
+    size_t next = 0;
+    EXPECT_CALL(io_handle_, readv(_, _, _))
+        .Times(reads.size() + 1)
+        .WillRepeatedly(Invoke([&](uint64_t max_length, Buffer::RawSlice*, uint64_t) {
+          read_sizes.push_back(max_length);
+          if (next == reads.size()) {
+            return eagainResult();
+          }
+          return writeResult(std::min(reads[next++], max_length));
+        }));
+    EXPECT_CALL(callbacks_, recordReadsPerEvent(reads.size() + 1));
+    Buffer::OwnedImpl buffer;
+    IoResult result = socket_->doRead(buffer);
+    EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+    return read_sizes;
+  }
+};
+
+// Reads that fill the whole reservation grow the read size up to the maximum.
+TEST_F(RawBufferSocketReadTest, GrowOnFullReads) {
+  initialize();
+  EXPECT_EQ((std::vector<uint64_t>{16384, 32768, 65536, 65536, 65536}),
+            readEvent({16384, 32768, 65536, 65536}));
+  // The read size is kept across read events.
+  EXPECT_EQ((std::vector<uint64_t>{65536}), readEvent({}));
+}
+
+// The read size only shrinks after consecutive small reads and never below the minimum.
+TEST_F(RawBufferSocketReadTest, ShrinkOnConsecutiveSmallReads) {
+  initialize();
+  EXPECT_EQ((std::vector<uint64_t>{16384, 16384}), readEvent({100}));
+  EXPECT_EQ((std::vector<uint64_t>{16384, 8192}), readEvent({100}));
+  EXPECT_EQ((std::vector<uint64_t>{8192, 8192, 4096, 4096}), readEvent({100, 100, 100}));
+  // A read larger than half the read size resets the count of small reads.
+  EXPECT_EQ((std::vector<uint64_t>{4096, 4096, 4096, 4096}), readEvent({100, 3000, 100}));
+  // Growing back after a burst.
+  EXPECT_EQ((std::vector<uint64_t>{4096, 8192, 16384}), readEvent({4096, 8192}));
+}
+
+// The read size does not grow when the read buffer is over its limit.
+TEST_F(RawBufferSocketReadTest, NoGrowthOverReadBufferLimit) {
+  initialize();
+  EXPECT_CALL(callbacks_, shouldDrainReadBuffer()).WillOnce(Return(true));
+  EXPECT_CALL(callbacks_, setReadBufferReady());
+  EXPECT_CALL(io_handle_, readv(16384, _, _)).WillOnce(Return(testing::ByMove(writeResult(16384))));
+  EXPECT_CALL(callbacks_, recordReadsPerEvent(1));
+  Buffer::OwnedImpl buffer;
+  IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(16384U, result.bytes_processed_);
+
+  EXPECT_EQ((std::vector<uint64_t>{16384}), readEvent({}));
+}
+
+// With the runtime feature disabled, the read size is fixed.
+TEST_F(RawBufferSocketReadTest, AdaptiveReadSizeRuntimeDisabled) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.adaptive_read_size", "false"}});
+  initialize();
+  EXPECT_EQ((std::vector<uint64_t>{16384, 16384, 16384}), readEvent({16384, 16384}));
+  EXPECT_EQ((std::vector<uint64_t>{16384, 16384, 16384}), readEvent({100, 100}));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
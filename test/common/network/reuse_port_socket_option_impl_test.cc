@@ -0,0 +1,178 @@
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3alpha/base.pb.h"
+
+#include "common/network/reuse_port_socket_option_impl.h"
+
+#include "test/common/network/socket_option_test.h"
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+#include <linux/bpf.h>
+#endif
+
+using testing::DoAll;
+using testing::Return;
+using testing::SetArgPointee;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_EBPF)
+
+constexpr int MapFd = 10;
+constexpr int ProgFd = 11;
+
+MATCHER_P(SlotIs, slot, "") { return *reinterpret_cast<const uint32_t*>(arg->key) == slot; }
+
+class ReusePortCpuSteeringSocketOptionImplTest : public SocketOptionTest {
+protected:
+  ReusePortCpuSteeringSocketOptionImplTest() {
+    ON_CALL(linux_os_sys_calls_, sched_getaffinity(_, _, _))
+        .WillByDefault(Return(Api::SysCallIntResult{-1, ENOSYS}));
+  }
+
+  // Expects the map and program to be loaded and the program to be attached to the socket.
+  void expectLoadAndAttach(uint32_t num_sockets) {
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+        .WillOnce(Invoke([num_sockets](int, union bpf_attr* attr, unsigned int) {
+          EXPECT_EQ(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, attr->map_type);
+          EXPECT_EQ(num_sockets, attr->max_entries);
+          return Api::SysCallIntResult{MapFd, 0};
+        }));
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_PROG_LOAD, _, _))
+        .WillOnce(Invoke([num_sockets](int, union bpf_attr* attr, unsigned int) {
+          EXPECT_EQ(BPF_PROG_TYPE_SK_REUSEPORT, attr->prog_type);
+          const auto* insns = reinterpret_cast<const struct bpf_insn*>(attr->insns);
+          EXPECT_EQ(13, attr->insn_cnt);
+          EXPECT_EQ(BPF_FUNC_get_smp_processor_id, insns[1].imm);
+          EXPECT_EQ(BPF_ALU | BPF_MOD | BPF_K, insns[2].code);
+          EXPECT_EQ(num_sockets, static_cast<uint32_t>(insns[2].imm));
+          EXPECT_EQ(BPF_PSEUDO_MAP_FD, insns[5].src_reg);
+          EXPECT_EQ(MapFd, insns[5].imm);
+          EXPECT_EQ(BPF_FUNC_sk_select_reuseport, insns[10].imm);
+          return Api::SysCallIntResult{ProgFd, 0};
+        }));
+    const SocketOptionName option = ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF;
+    EXPECT_CALL(os_sys_calls_, setsockopt_(_, option.level(), option.option(), _, sizeof(int)))
+        .WillOnce(Invoke([](int, int, int, const void* optval, socklen_t) -> int {
+          EXPECT_EQ(ProgFd, *static_cast<const int*>(optval));
+          return 0;
+        }));
+    EXPECT_CALL(os_sys_calls_, close(ProgFd));
+    EXPECT_CALL(os_sys_calls_, close(MapFd));
+  }
+
+  void expectAddToSlot(uint32_t slot) {
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, SlotIs(slot), _))
+        .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  }
+
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+};
+
+// The program is attached once the socket is bound, and TCP sockets take their slots in turn once
+// they listen.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, StreamSocketsTakeSlotsWhenListening) {
+  ReusePortCpuSteeringSocketOptionImpl option(4);
+  NiceMock<MockListenSocket> other_socket;
+  expectLoadAndAttach(4);
+
+  EXPECT_TRUE(option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_PREBIND));
+  EXPECT_TRUE(option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).WillOnce(Return(0));
+  EXPECT_TRUE(
+      option.setOption(other_socket, envoy::config::core::v3alpha::SocketOption::STATE_BOUND));
+
+  expectAddToSlot(0);
+  EXPECT_TRUE(
+      option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_LISTENING));
+  expectAddToSlot(1);
+  EXPECT_TRUE(option.setOption(other_socket,
+                               envoy::config::core::v3alpha::SocketOption::STATE_LISTENING));
+}
+
+// A socket set up on a thread pinned to a CPU takes the slot of that CPU.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, PinnedSocketTakesSlotOfItsCpu) {
+  ReusePortCpuSteeringSocketOptionImpl option(4);
+  expectLoadAndAttach(4);
+  EXPECT_TRUE(option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND));
+
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  CPU_SET(6, &affinity);
+  EXPECT_CALL(linux_os_sys_calls_, sched_getaffinity(0, _, _))
+      .WillOnce(DoAll(SetArgPointee<2>(affinity), Return(Api::SysCallIntResult{0, 0})));
+  expectAddToSlot(2);
+  EXPECT_TRUE(
+      option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_LISTENING));
+}
+
+// UDP sockets receive as soon as they are bound, so they take their slot then.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, DatagramSocketTakesSlotWhenBound) {
+  ReusePortCpuSteeringSocketOptionImpl option(4);
+  ON_CALL(socket_, socketType()).WillByDefault(Return(Address::SocketType::Datagram));
+  expectLoadAndAttach(4);
+  expectAddToSlot(0);
+  EXPECT_TRUE(option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND));
+  EXPECT_TRUE(
+      option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_LISTENING));
+}
+
+// Stopping empties every slot, so the kernel falls back to its hash.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, StopEmptiesSlots) {
+  ReusePortCpuSteeringSocketOptionImpl option(2);
+  // Nothing to empty before the map is loaded.
+  option.stop();
+
+  expectLoadAndAttach(2);
+  EXPECT_TRUE(option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND));
+  expectAddToSlot(0);
+  EXPECT_TRUE(
+      option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_LISTENING));
+
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_DELETE_ELEM, SlotIs(0), _))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_DELETE_ELEM, SlotIs(1), _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOENT}));
+  option.stop();
+}
+
+// Without the privileges to load the program the option fails.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, LoadFailure) {
+  ReusePortCpuSteeringSocketOptionImpl option(4);
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EPERM}));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+  EXPECT_LOG_CONTAINS(
+      "warning", "Creating SO_REUSEPORT steering map failed",
+      EXPECT_FALSE(
+          option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND)));
+}
+
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, GetOptionDetails) {
+  ReusePortCpuSteeringSocketOptionImpl option(4);
+  EXPECT_EQ(absl::nullopt,
+            option.getOptionDetails(
+                socket_, envoy::config::core::v3alpha::SocketOption::STATE_PREBIND));
+  const auto details = option.getOptionDetails(
+      socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND);
+  ASSERT_TRUE(details.has_value());
+  EXPECT_EQ(makeDetails(ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF, 4), details.value());
+}
+
+#else
+
+class ReusePortCpuSteeringSocketOptionImplTest : public SocketOptionTest {};
+
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, Unsupported) {
+  ReusePortCpuSteeringSocketOptionImpl option(4);
+  EXPECT_FALSE(option.isSupported());
+  EXPECT_FALSE(option.setOption(socket_, envoy::config::core::v3alpha::SocketOption::STATE_BOUND));
+}
+
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
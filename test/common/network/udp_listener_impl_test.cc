@@ -16,6 +16,7 @@
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
@@ -357,6 +358,110 @@ TEST_P(UdpListenerImplTest, UdpListenerRecvMsgError) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+/**
+ * Tests that datagrams queued on the socket are read in a single batch.
+ */
+TEST_P(UdpListenerImplTest, UdpListenerBatchedRead) {
+  client_socket_ = createClientSocket(false);
+
+  const std::vector<std::string> payloads{"first", "second", "third"};
+  for (const std::string& payload : payloads) {
+    Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.length()};
+    auto send_rc = Network::Utility::writeToSocket(client_socket_->ioHandle(), &slice, 1, nullptr,
+                                                   *send_to_addr_);
+    ASSERT_EQ(send_rc.rc_, payload.length());
+  }
+
+  if (Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    EXPECT_CALL(listener_callbacks_, onPacketsRead(3));
+  } else {
+    EXPECT_CALL(listener_callbacks_, onPacketsRead(1)).Times(3);
+  }
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  size_t received = 0;
+  EXPECT_CALL(listener_callbacks_, onData(_))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+        validateRecvCallbackParams(data);
+        EXPECT_EQ(data.buffer_->toString(), payloads[received]);
+        if (++received == payloads.size()) {
+          dispatcher_->exit();
+        }
+      }));
+  EXPECT_CALL(listener_callbacks_, onWriteReady(_)).Times(testing::AnyNumber());
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+/**
+ * Tests that datagrams are read one at a time when batching is disabled through runtime.
+ */
+TEST_P(UdpListenerImplTest, UdpListenerBatchingRuntimeDisabled) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"udp_listener.max_packets_per_recv", "1"}});
+  listener_.reset();
+  listener_ = std::make_unique<UdpListenerImpl>(dispatcherImpl(), server_socket_,
+                                                listener_callbacks_, dispatcherImpl().timeSource());
+  client_socket_ = createClientSocket(false);
+
+  const std::vector<std::string> payloads{"first", "second"};
+  for (const std::string& payload : payloads) {
+    Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.length()};
+    auto send_rc = Network::Utility::writeToSocket(client_socket_->ioHandle(), &slice, 1, nullptr,
+                                                   *send_to_addr_);
+    ASSERT_EQ(send_rc.rc_, payload.length());
+  }
+
+  EXPECT_CALL(listener_callbacks_, onPacketsRead(1)).Times(2);
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  size_t received = 0;
+  EXPECT_CALL(listener_callbacks_, onData(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+        validateRecvCallbackParams(data);
+        EXPECT_EQ(data.buffer_->toString(), payloads[received]);
+        if (++received == payloads.size()) {
+          dispatcher_->exit();
+        }
+      }));
+  EXPECT_CALL(listener_callbacks_, onWriteReady(_)).Times(testing::AnyNumber());
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+/**
+ * Tests UDP listener's error callback when reading a batch of datagrams fails.
+ */
+TEST_P(UdpListenerImplTest, UdpListenerRecvMmsgError) {
+  client_socket_ = createClientSocket(false);
+
+  const std::string first("first");
+  Buffer::RawSlice first_slice{const_cast<char*>(first.data()), first.length()};
+  auto send_rc = Network::Utility::writeToSocket(client_socket_->ioHandle(), &first_slice, 1,
+                                                 nullptr, *send_to_addr_);
+  ASSERT_EQ(send_rc.rc_, first.length());
+
+  EXPECT_CALL(listener_callbacks_, onData(_)).Times(0);
+  EXPECT_CALL(listener_callbacks_, onPacketsRead(_)).Times(0);
+  EXPECT_CALL(listener_callbacks_, onWriteReady(_)).Times(testing::AnyNumber());
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  EXPECT_CALL(listener_callbacks_, onReceiveError(_))
+      .WillOnce(Invoke([&](Api::IoError::IoErrorCode err) -> void {
+        ASSERT_EQ(Api::IoError::IoErrorCode::NoSupport, err);
+
+        dispatcher_->exit();
+      }));
+  // Inject mocked OsSysCalls implementation to mock a batched read failure.
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillRepeatedly(Return(true));
+  EXPECT_CALL(os_sys_calls, recvmmsg(_, _, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOTSUP}));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
 /**
  * Tests UDP listener for sending datagrams to destination.
  *  1. Setup a udp listener and client socket
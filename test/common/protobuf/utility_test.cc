@@ -768,6 +768,21 @@ TEST_P(DeprecatedFieldsTest, DEPRECATED_FEATURE_TEST(IndividualFieldDeprecated))
   EXPECT_EQ(1, runtime_deprecated_feature_use_.value());
 }
 
+// The deprecation info of a message type is cached on its first check, and the later checks of
+// messages of that type must warn just as the first one.
+TEST_P(DeprecatedFieldsTest, DEPRECATED_FEATURE_TEST(IndividualFieldDeprecatedCheckedTwice)) {
+  envoy::test::deprecation_test::Base base;
+  base.set_is_deprecated("foo");
+  EXPECT_LOG_CONTAINS("warning",
+                      "Using deprecated option 'envoy.test.deprecation_test.Base.is_deprecated'",
+                      checkForDeprecation(base));
+  base.set_not_deprecated("bar");
+  EXPECT_LOG_CONTAINS("warning",
+                      "Using deprecated option 'envoy.test.deprecation_test.Base.is_deprecated'",
+                      checkForDeprecation(base));
+  EXPECT_EQ(2, runtime_deprecated_feature_use_.value());
+}
+
 // Use of a deprecated and disallowed field should result in an exception.
 TEST_P(DeprecatedFieldsTest, DEPRECATED_FEATURE_TEST(IndividualFieldDisallowed)) {
   envoy::test::deprecation_test::Base base;
@@ -0,0 +1,208 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/route/v3alpha/route.pb.h"
+
+#include "common/http/header_map_impl.h"
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+/**
+ * Builds a route configuration with a single virtual host holding num_routes routes. Even routes
+ * are prefix routes and odd routes are exact path routes.
+ */
+envoy::config::route::v3alpha::RouteConfiguration makeRouteConfig(uint64_t num_routes) {
+  envoy::config::route::v3alpha::RouteConfiguration config;
+  auto* virtual_host = config.add_virtual_hosts();
+  virtual_host->set_name("service");
+  virtual_host->add_domains("*");
+  for (uint64_t i = 0; i < num_routes; i++) {
+    auto* route = virtual_host->add_routes();
+    if (i % 2 == 0) {
+      route->mutable_match()->set_prefix(absl::StrCat("/prefix/", i, "/"));
+    } else {
+      route->mutable_match()->set_path(absl::StrCat("/path/", i));
+    }
+    route->mutable_route()->set_cluster("cluster");
+  }
+  return config;
+}
+
+/**
+ * Measure the time to find the last route of a virtual host. The first Arg is the number of routes
+ * and the second Arg is whether indexed route matching is enabled.
+ */
+void routeMatch(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.indexed_route_matching", state.range(1) ? "true" : "false"}});
+
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const uint64_t num_routes = state.range(0);
+  ConfigImpl config(makeRouteConfig(num_routes), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+
+  const uint64_t last = num_routes - 1;
+  const std::string path = last % 2 == 0 ? absl::StrCat("/prefix/", last, "/foo?bar=baz")
+                                         : absl::StrCat("/path/", last);
+  Http::TestHeaderMapImpl headers{
+      {":authority", "www.example.com"}, {":path", path}, {"x-forwarded-proto", "http"}};
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, 0);
+    ASSERT(route != nullptr);
+    benchmark::DoNotOptimize(route);
+  }
+}
+BENCHMARK(routeMatch)
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({5000, 0})
+    ->Args({5000, 1});
+
+/**
+ * Builds a route configuration with num_domains virtual hosts, each with a single suffix wildcard
+ * domain of the form *.tenant<i>.example.com, and a default virtual host.
+ */
+envoy::config::route::v3alpha::RouteConfiguration makeWildcardRouteConfig(uint64_t num_domains) {
+  envoy::config::route::v3alpha::RouteConfiguration config;
+  for (uint64_t i = 0; i < num_domains; i++) {
+    auto* virtual_host = config.add_virtual_hosts();
+    virtual_host->set_name(absl::StrCat("tenant", i));
+    virtual_host->add_domains(absl::StrCat("*.tenant", i, ".example.com"));
+    auto* route = virtual_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_route()->set_cluster("cluster");
+  }
+  auto* default_host = config.add_virtual_hosts();
+  default_host->set_name("default");
+  default_host->add_domains("*");
+  return config;
+}
+
+/**
+ * Measure the time to find a suffix wildcard virtual host. Arg is the number of wildcard domains.
+ */
+void wildcardVirtualHostMatch(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const uint64_t num_domains = state.range(0);
+  ConfigImpl config(makeWildcardRouteConfig(num_domains), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+
+  Http::TestHeaderMapImpl headers{
+      {":authority", absl::StrCat("api.eu-west.tenant", num_domains / 2, ".example.com")},
+      {":path", "/"},
+      {"x-forwarded-proto", "http"}};
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, 0);
+    ASSERT(route != nullptr);
+    benchmark::DoNotOptimize(route);
+  }
+}
+BENCHMARK(wildcardVirtualHostMatch)->Arg(10)->Arg(1000)->Arg(50000);
+
+/**
+ * Measure the time to build a route configuration with many suffix wildcard domains, as done on
+ * every RDS update. Arg is the number of wildcard domains.
+ */
+void wildcardVirtualHostConstruction(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const auto route_config = makeWildcardRouteConfig(state.range(0));
+
+  for (auto _ : state) {
+    ConfigImpl config(route_config, factory_context, ProtobufMessage::getNullValidationVisitor(),
+                      false);
+    benchmark::DoNotOptimize(config);
+  }
+}
+BENCHMARK(wildcardVirtualHostConstruction)->Arg(1000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Builds a route configuration with a single route to num_clusters weighted clusters of equal
+ * weight, whose weights can be overridden in the runtime.
+ */
+envoy::config::route::v3alpha::RouteConfiguration
+makeWeightedClustersRouteConfig(uint64_t num_clusters) {
+  envoy::config::route::v3alpha::RouteConfiguration config;
+  auto* virtual_host = config.add_virtual_hosts();
+  virtual_host->set_name("service");
+  virtual_host->add_domains("*");
+  auto* route = virtual_host->add_routes();
+  route->mutable_match()->set_prefix("/");
+  auto* weighted_clusters = route->mutable_route()->mutable_weighted_clusters();
+  weighted_clusters->set_runtime_key_prefix("weights");
+  weighted_clusters->mutable_total_weight()->set_value(num_clusters * 10);
+  for (uint64_t i = 0; i < num_clusters; i++) {
+    auto* cluster = weighted_clusters->add_clusters();
+    cluster->set_name(absl::StrCat("cluster", i));
+    cluster->mutable_weight()->set_value(10);
+  }
+  return config;
+}
+
+/**
+ * Measure the time to pick one of the weighted clusters of a route, with a real runtime. Arg is the
+ * number of weighted clusters.
+ */
+void weightedClusterPick(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ON_CALL(factory_context, runtime())
+      .WillByDefault(ReturnRef(*Runtime::LoaderSingleton::getExisting()));
+  ConfigImpl config(makeWeightedClustersRouteConfig(state.range(0)), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+
+  Http::TestHeaderMapImpl headers{
+      {":authority", "www.example.com"}, {":path", "/"}, {"x-forwarded-proto", "http"}};
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  uint64_t random_value = 0;
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, random_value++);
+    ASSERT(route != nullptr);
+    benchmark::DoNotOptimize(route->routeEntry()->clusterName());
+  }
+}
+BENCHMARK(weightedClusterPick)->Arg(2)->Arg(10)->Arg(100);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -38,6 +38,7 @@ using testing::Matcher;
 using testing::MockFunction;
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnPointee;
 using testing::ReturnRef;
 
 namespace Envoy {
@@ -952,6 +953,53 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// Verify that first match wins across prefix, path and regex matchers with and without the route
+// index.
+TEST_F(RouteMatcherTest, MixedMatchersFirstMatchWins) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: local_service
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/api"
+          headers:
+            - name: x-version
+              exact_match: "2"
+        route: { cluster: "api_v2" }
+      - match: { safe_regex: { google_re2: {}, regex: "/api/v[2-9]/users" } }
+        route: { cluster: "regex" }
+      - match: { path: "/api/v1/users" }
+        route: { cluster: "path" }
+      - match: { prefix: "/API/v1", case_sensitive: false }
+        route: { cluster: "ignore_case" }
+      - match: { prefix: "/api" }
+        route: { cluster: "api" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  const auto proto_config = parseRouteConfigurationFromV2Yaml(yaml);
+  for (const std::string indexed : {"true", "false"}) {
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.indexed_route_matching", indexed}});
+    TestConfigImpl config(proto_config, factory_context_, true);
+
+    auto cluster = [&config](Http::TestHeaderMapImpl headers) {
+      return config.route(headers, 0)->routeEntry()->clusterName();
+    };
+    Http::TestHeaderMapImpl v2_headers = genHeaders("www.lyft.com", "/api/v1/users", "GET");
+    v2_headers.addCopy("x-version", "2");
+    EXPECT_EQ("api_v2", cluster(v2_headers));
+    EXPECT_EQ("regex", cluster(genHeaders("www.lyft.com", "/api/v2/users", "GET")));
+    EXPECT_EQ("path", cluster(genHeaders("www.lyft.com", "/api/v1/users?foo=bar", "GET")));
+    EXPECT_EQ("ignore_case", cluster(genHeaders("www.lyft.com", "/api/V1/groups", "GET")));
+    EXPECT_EQ("api", cluster(genHeaders("www.lyft.com", "/api/v2/groups", "GET")));
+    EXPECT_EQ("default", cluster(genHeaders("www.lyft.com", "/foo", "GET")));
+  }
+}
+
 // When deprecating regex: this test can be removed.
 TEST_F(RouteMatcherTest, DEPRECATED_FEATURE_TEST(TestRoutesWithInvalidRegexLegacy)) {
   std::string invalid_route = R"EOF(
@@ -3245,6 +3293,88 @@ virtual_hosts:
   EXPECT_EQ(100, ProtobufPercentHelper::fractionalPercentDenominatorToInt(percent.denominator()));
 }
 
+TEST_F(RouteMatcherTest, LatencyHedging) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- domains: [www.lyft.com]
+  name: www
+  routes:
+  - match: {prefix: /foo}
+    route:
+      cluster: www
+      hedge_policy:
+        latency_hedging:
+          percentile: {value: 50}
+          min_samples: 1
+  - match: {prefix: /}
+    route: {cluster: www}
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  const LatencyHedgePolicy* policy = config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+                                         ->routeEntry()
+                                         ->hedgePolicy()
+                                         .latencyHedgePolicy();
+  ASSERT_NE(nullptr, policy);
+  EXPECT_FALSE(policy->hedgeDelay().has_value());
+  policy->recordLatency(std::chrono::milliseconds(5));
+  EXPECT_EQ(std::chrono::milliseconds(5), policy->hedgeDelay());
+
+  EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
+                         ->routeEntry()
+                         ->hedgePolicy()
+                         .latencyHedgePolicy());
+}
+
+TEST_F(RouteMatcherTest, RequestCollapsing) {
+  const std::string yaml = R"EOF(
+name: RequestCollapsing
+virtual_hosts:
+- domains: [www.lyft.com]
+  name: www
+  routes:
+  - match: {prefix: /foo}
+    route:
+      cluster: www
+      request_collapsing:
+        headers: [accept, accept-encoding]
+        scope: PROCESS
+        max_response_bytes: 4096
+  - match: {prefix: /bar}
+    route:
+      cluster: www
+      request_collapsing: {}
+  - match: {prefix: /}
+    route: {cluster: www}
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  const RequestCollapsingPolicy* policy =
+      config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+          ->routeEntry()
+          ->requestCollapsingPolicy();
+  ASSERT_NE(nullptr, policy);
+  EXPECT_EQ(std::vector<Http::LowerCaseString>(
+                {Http::LowerCaseString("accept"), Http::LowerCaseString("accept-encoding")}),
+            policy->headers());
+  EXPECT_TRUE(policy->perProcess());
+  EXPECT_EQ(4096, policy->maxResponseBytes());
+
+  policy = config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
+               ->routeEntry()
+               ->requestCollapsingPolicy();
+  ASSERT_NE(nullptr, policy);
+  EXPECT_TRUE(policy->headers().empty());
+  EXPECT_FALSE(policy->perProcess());
+  EXPECT_EQ(1024 * 1024, policy->maxResponseBytes());
+
+  EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
+                         ->routeEntry()
+                         ->requestCollapsingPolicy());
+}
+
 TEST_F(RouteMatcherTest, HedgeVirtualHostLevel) {
   const std::string yaml = R"EOF(
 name: HedgeVirtualHostLevel
@@ -4272,6 +4402,57 @@ virtual_hosts:
   }
 }
 
+// The runtime weights of weighted clusters are only looked up when the runtime snapshot changes.
+TEST_F(RouteMatcherTest, WeightedClustersRuntimeWeightsCachedPerSnapshot) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: www
+    domains: ["www.lyft.com"]
+    routes:
+      - match: { prefix: "/" }
+        route:
+          weighted_clusters:
+            runtime_key_prefix: www_weights
+            clusters:
+              - name: cluster1
+                weight: 30
+              - name: cluster2
+                weight: 30
+              - name: cluster3
+                weight: 40
+  )EOF";
+
+  auto& runtime = factory_context_.runtime_loader_;
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+  Http::TestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo", "GET");
+  uint64_t generation = 1;
+  ON_CALL(runtime.snapshot_, generation()).WillByDefault(ReturnPointee(&generation));
+
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster1", 30)).WillOnce(Return(80));
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster2", 30)).WillOnce(Return(10));
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster3", 40)).WillOnce(Return(10));
+  EXPECT_EQ("cluster1", config.route(headers, 45)->routeEntry()->clusterName());
+  EXPECT_EQ("cluster2", config.route(headers, 82)->routeEntry()->clusterName());
+  EXPECT_EQ("cluster3", config.route(headers, 92)->routeEntry()->clusterName());
+
+  generation = 3;
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster1", 30)).WillOnce(Return(10));
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster2", 30)).WillOnce(Return(10));
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster3", 40)).WillOnce(Return(80));
+  EXPECT_EQ("cluster1", config.route(headers, 5)->routeEntry()->clusterName());
+  EXPECT_EQ("cluster2", config.route(headers, 15)->routeEntry()->clusterName());
+  EXPECT_EQ("cluster3", config.route(headers, 45)->routeEntry()->clusterName());
+
+  // An older snapshot, still seen by another worker, doesn't replace the weights of the newer one.
+  generation = 2;
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster1", 30)).WillOnce(Return(80));
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster2", 30)).WillOnce(Return(10));
+  EXPECT_CALL(runtime.snapshot_, getInteger("www_weights.cluster3", 40)).WillOnce(Return(10));
+  EXPECT_EQ("cluster1", config.route(headers, 45)->routeEntry()->clusterName());
+  generation = 3;
+  EXPECT_EQ("cluster3", config.route(headers, 45)->routeEntry()->clusterName());
+}
+
 TEST_F(RouteMatcherTest, ExclusiveWeightedClustersOrClusterConfig) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -4826,6 +5007,10 @@ virtual_hosts:
   EXPECT_EQ(cors_policy->enabled(), false);
   EXPECT_EQ(cors_policy->shadowEnabled(), true);
   EXPECT_EQ(3, cors_policy->allowOrigins().size());
+  EXPECT_TRUE(cors_policy->allowsOrigin("test-origin"));
+  EXPECT_TRUE(cors_policy->allowsOrigin("www.envoyproxy.io"));
+  EXPECT_FALSE(cors_policy->allowsOrigin("envoyproxy.io"));
+  EXPECT_FALSE(cors_policy->allowsOrigin("*"));
   EXPECT_EQ(cors_policy->allowMethods(), "test-methods");
   EXPECT_EQ(cors_policy->allowHeaders(), "test-headers");
   EXPECT_EQ(cors_policy->exposeHeaders(), "test-expose-headers");
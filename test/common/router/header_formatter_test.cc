@@ -930,6 +930,46 @@ request_headers_to_add:
   EXPECT_EQ("static-value", header_map.get_("static-header"));
 }
 
+// Static values are referenced by the headers rather than copied into them, whether they are
+// appended or set.
+TEST(HeaderParserTest, EvaluateStaticHeadersByReference) {
+  const std::string yaml = R"EOF(
+match: { prefix: "/new_endpoint" }
+route:
+  cluster: "www2"
+request_headers_to_add:
+  - header:
+      key: "static-header"
+      value: "static-value"
+    append: true
+  - header:
+      key: "set-header"
+      value: "set-value"
+    append: false
+  - header:
+      key: "dynamic-header"
+      value: "%PROTOCOL%"
+)EOF";
+
+  HeaderParserPtr req_header_parser =
+      HeaderParser::configure(parseRouteFromV2Yaml(yaml).request_headers_to_add());
+  Http::TestHeaderMapImpl header_map{{":method", "POST"}, {"set-header", "old-value"}};
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  absl::optional<Envoy::Http::Protocol> protocol = Envoy::Http::Protocol::Http11;
+  ON_CALL(stream_info, protocol()).WillByDefault(ReturnPointee(&protocol));
+  req_header_parser->evaluateHeaders(header_map, stream_info);
+
+  EXPECT_EQ("static-value", header_map.get_("static-header"));
+  EXPECT_EQ(Http::HeaderString::Type::Reference,
+            header_map.get(Http::LowerCaseString("static-header"))->value().type());
+  EXPECT_EQ("set-value", header_map.get_("set-header"));
+  EXPECT_EQ(Http::HeaderString::Type::Reference,
+            header_map.get(Http::LowerCaseString("set-header"))->value().type());
+  EXPECT_EQ("HTTP/1.1", header_map.get_("dynamic-header"));
+  EXPECT_NE(Http::HeaderString::Type::Reference,
+            header_map.get(Http::LowerCaseString("dynamic-header"))->value().type());
+}
+
 TEST(HeaderParserTest, EvaluateCompoundHeaders) {
   const std::string yaml = R"EOF(
 match: { prefix: "/new_endpoint" }
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <limits>
+
+#include "common/router/latency_hedge_policy.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+TEST(LatencyPercentileEstimatorTest, Buckets) {
+  for (uint64_t latency = 0; latency < 8; latency++) {
+    EXPECT_EQ(latency, LatencyPercentileEstimator::bucketIndex(latency));
+    EXPECT_EQ(latency, LatencyPercentileEstimator::bucketUpperBound(latency));
+  }
+
+  // Every latency falls in a bucket whose upper bound is at least the latency, within 25%.
+  uint64_t previous_index = 0;
+  for (uint64_t latency = 8; latency < 100000; latency++) {
+    const uint64_t index = LatencyPercentileEstimator::bucketIndex(latency);
+    ASSERT_LT(index, LatencyPercentileEstimator::kNumBuckets);
+    ASSERT_GE(index, previous_index);
+    const uint64_t upper_bound = LatencyPercentileEstimator::bucketUpperBound(index);
+    ASSERT_GE(upper_bound, latency);
+    ASSERT_LE(upper_bound, latency + latency / 4);
+    previous_index = index;
+  }
+
+  EXPECT_EQ(LatencyPercentileEstimator::kNumBuckets - 1,
+            LatencyPercentileEstimator::bucketIndex(std::numeric_limits<uint64_t>::max()));
+  EXPECT_EQ(
+      LatencyPercentileEstimator::kMaxLatencyMs,
+      LatencyPercentileEstimator::bucketUpperBound(LatencyPercentileEstimator::kNumBuckets - 1));
+}
+
+TEST(LatencyPercentileEstimatorTest, MinSamples) {
+  LatencyPercentileEstimator estimator(0.95, 100);
+  for (uint64_t i = 0; i < 99; i++) {
+    estimator.record(std::chrono::milliseconds(10));
+  }
+  EXPECT_FALSE(estimator.percentile().has_value());
+
+  // The percentile is refreshed every few latencies once enough have been recorded.
+  for (uint64_t i = 0; i < 16; i++) {
+    estimator.record(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(11), estimator.percentile());
+}
+
+TEST(LatencyPercentileEstimatorTest, Percentile) {
+  LatencyPercentileEstimator estimator(0.95, 1);
+  for (uint64_t i = 1; i <= 100; i++) {
+    estimator.record(std::chrono::milliseconds(i));
+  }
+  // 95 falls in the [80, 95] bucket.
+  EXPECT_EQ(std::chrono::milliseconds(95), estimator.percentile());
+}
+
+TEST(LatencyPercentileEstimatorTest, FollowsRecentLatencies) {
+  LatencyPercentileEstimator estimator(0.5, 1);
+  for (uint64_t i = 0; i < 2000; i++) {
+    estimator.record(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(111), estimator.percentile());
+
+  // The old latencies are decayed away.
+  for (uint64_t i = 0; i < 4000; i++) {
+    estimator.record(std::chrono::milliseconds(4));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(4), estimator.percentile());
+}
+
+// Takes a hedge from the budget if it allows one, as the router does once the hedge is sent.
+bool tryHedge(HedgeBudget& budget) {
+  if (!budget.canHedge()) {
+    return false;
+  }
+  budget.onHedge();
+  return true;
+}
+
+TEST(HedgeBudgetTest, Budget) {
+  HedgeBudget budget(10, 1000);
+  EXPECT_FALSE(tryHedge(budget));
+
+  for (uint64_t i = 0; i < 20; i++) {
+    budget.onRequest();
+  }
+  EXPECT_TRUE(tryHedge(budget));
+  EXPECT_TRUE(tryHedge(budget));
+  EXPECT_FALSE(tryHedge(budget));
+
+  for (uint64_t i = 0; i < 10; i++) {
+    budget.onRequest();
+  }
+  EXPECT_TRUE(tryHedge(budget));
+  EXPECT_FALSE(tryHedge(budget));
+}
+
+TEST(HedgeBudgetTest, Decay) {
+  HedgeBudget budget(50, 10);
+  for (uint64_t i = 0; i < 19; i++) {
+    budget.onRequest();
+  }
+  for (uint64_t i = 0; i < 9; i++) {
+    EXPECT_TRUE(tryHedge(budget));
+  }
+  EXPECT_FALSE(tryHedge(budget));
+
+  // Both the requests and the hedges are halved, to 10 and 5.
+  budget.onRequest();
+  EXPECT_FALSE(tryHedge(budget));
+  budget.onRequest();
+  budget.onRequest();
+  EXPECT_TRUE(tryHedge(budget));
+  EXPECT_FALSE(tryHedge(budget));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
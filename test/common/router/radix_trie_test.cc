@@ -0,0 +1,119 @@
+#include <string>
+#include <vector>
+
+#include "common/router/radix_trie.h"
+
+#include "absl/strings/ascii.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+class RadixTrieTest : public testing::Test {
+public:
+  bool insertSuffix(const std::string& suffix, int value) {
+    return suffixes_.insert(suffix.rbegin(), suffix.rend(), value);
+  }
+  bool insertPrefix(const std::string& prefix, int value) {
+    return prefixes_.insert(prefix.begin(), prefix.end(), value);
+  }
+  int findSuffix(const std::string& host) const {
+    const int* value = suffixes_.findLongestPrefix(host.rbegin(), host.rend());
+    return value == nullptr ? -1 : *value;
+  }
+  int findPrefix(const std::string& host) const {
+    const int* value = prefixes_.findLongestPrefix(host.begin(), host.end());
+    return value == nullptr ? -1 : *value;
+  }
+
+  RadixTrie<int> suffixes_;
+  RadixTrie<int> prefixes_;
+};
+
+TEST_F(RadixTrieTest, Empty) {
+  EXPECT_TRUE(suffixes_.empty());
+  EXPECT_EQ(-1, findSuffix("foo.com"));
+  EXPECT_EQ(-1, findSuffix(""));
+}
+
+TEST_F(RadixTrieTest, LongestSuffixWins) {
+  EXPECT_TRUE(insertSuffix(".baz.com", 0));
+  EXPECT_TRUE(insertSuffix("-bar.baz.com", 1));
+  EXPECT_TRUE(insertSuffix(".com", 2));
+  EXPECT_TRUE(insertSuffix("z.com", 3));
+  EXPECT_EQ(4U, suffixes_.size());
+
+  EXPECT_EQ(1, findSuffix("foo-bar.baz.com"));
+  EXPECT_EQ(0, findSuffix("foo.baz.com"));
+  EXPECT_EQ(3, findSuffix("foo.biz.com"));
+  EXPECT_EQ(2, findSuffix("foo.bar.com"));
+  EXPECT_EQ(-1, findSuffix("foo.org"));
+}
+
+TEST_F(RadixTrieTest, WildcardMustMatchAtLeastOneCharacter) {
+  EXPECT_TRUE(insertSuffix(".foo.com", 0));
+  EXPECT_TRUE(insertSuffix(".com", 1));
+  EXPECT_EQ(1, findSuffix(".foo.com"));
+  EXPECT_EQ(0, findSuffix("a.foo.com"));
+  EXPECT_EQ(-1, findSuffix(".com"));
+  EXPECT_EQ(-1, findSuffix("com"));
+}
+
+TEST_F(RadixTrieTest, Duplicates) {
+  EXPECT_TRUE(insertSuffix(".foo.com", 0));
+  EXPECT_TRUE(insertSuffix(".bar.com", 1));
+  // Inserting a fragment that is an inner node of the trie.
+  EXPECT_TRUE(insertSuffix(".com", 2));
+  EXPECT_FALSE(insertSuffix(".foo.com", 3));
+  EXPECT_FALSE(insertSuffix(".com", 4));
+  EXPECT_EQ(3U, suffixes_.size());
+  EXPECT_EQ(0, findSuffix("www.foo.com"));
+  EXPECT_EQ(2, findSuffix("www.baz.com"));
+}
+
+TEST_F(RadixTrieTest, Prefixes) {
+  EXPECT_TRUE(insertPrefix("foo.", 0));
+  EXPECT_TRUE(insertPrefix("foo.bar.", 1));
+  EXPECT_TRUE(insertPrefix("api-", 2));
+
+  EXPECT_EQ(1, findPrefix("foo.bar.com"));
+  EXPECT_EQ(0, findPrefix("foo.baz.com"));
+  EXPECT_EQ(0, findPrefix("foo.bar."));
+  EXPECT_EQ(2, findPrefix("api-v1.com"));
+  EXPECT_EQ(-1, findPrefix("api"));
+  EXPECT_EQ(-1, findPrefix("foo."));
+}
+
+// Every key that is a prefix of the string is visited, including the whole string, from the
+// shortest to the longest.
+TEST_F(RadixTrieTest, ForEachPrefix) {
+  RadixTrie<std::vector<int>> trie;
+  const std::string keys[] = {"/", "/foo", "/foo/bar", "/bar"};
+  for (int i = 0; i < 4; i++) {
+    trie.findOrInsert(keys[i].begin(), keys[i].end()).first->push_back(i);
+  }
+  EXPECT_FALSE(trie.findOrInsert(keys[1].begin(), keys[1].end()).second);
+
+  const auto prefixes = [&trie](const std::string& path, bool ignore_case) {
+    std::vector<int> found;
+    const auto cb = [&found](const std::vector<int>& values, std::string::const_iterator) {
+      found.insert(found.end(), values.begin(), values.end());
+    };
+    if (ignore_case) {
+      trie.forEachPrefix(path.begin(), path.end(), absl::ascii_tolower, cb);
+    } else {
+      trie.forEachPrefix(path.begin(), path.end(), [](char c) { return c; }, cb);
+    }
+    return found;
+  };
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), prefixes("/foo/bar", false));
+  EXPECT_EQ((std::vector<int>{0, 1}), prefixes("/foo/baz", false));
+  EXPECT_EQ((std::vector<int>{0}), prefixes("/FOO/bar", false));
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), prefixes("/FOO/Bar", true));
+  EXPECT_EQ((std::vector<int>{}), prefixes("foo", false));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,124 @@
+#include <vector>
+
+#include "common/router/route_index.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+std::vector<uint32_t> candidates(const RouteIndex& index, absl::string_view path) {
+  std::vector<uint32_t> result;
+  index.forEachCandidate(path, [&result](uint32_t route) {
+    result.push_back(route);
+    return true;
+  });
+  return result;
+}
+
+TEST(RouteIndexTest, Empty) {
+  RouteIndex index;
+  EXPECT_TRUE(candidates(index, "/foo").empty());
+}
+
+TEST(RouteIndexTest, Prefixes) {
+  RouteIndex index;
+  index.addPrefix("/foo/bar", true, 0);
+  index.addPrefix("/foo", true, 1);
+  index.addPrefix("/fob", true, 2);
+  index.addPrefix("/", true, 3);
+  index.addPrefix("", true, 4);
+  index.addPrefix("/foo", true, 5);
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 3, 4, 5}), candidates(index, "/foo/bar/baz"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 3, 4, 5}), candidates(index, "/foo/ba"));
+  EXPECT_EQ((std::vector<uint32_t>{2, 3, 4}), candidates(index, "/fob"));
+  EXPECT_EQ((std::vector<uint32_t>{3, 4}), candidates(index, "/fo"));
+  EXPECT_EQ((std::vector<uint32_t>{4}), candidates(index, "foo"));
+  EXPECT_EQ((std::vector<uint32_t>{4}), candidates(index, ""));
+  EXPECT_EQ((std::vector<uint32_t>{3, 4}), candidates(index, "/FOO"));
+}
+
+TEST(RouteIndexTest, PrefixesIgnoreCase) {
+  RouteIndex index;
+  index.addPrefix("/Foo", false, 0);
+  index.addPrefix("/foo/BAR", false, 1);
+  index.addPrefix("/foo", true, 2);
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2}), candidates(index, "/foo/bar"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), candidates(index, "/FOO/Bar?x=y"));
+  EXPECT_EQ((std::vector<uint32_t>{0}), candidates(index, "/fOo"));
+  EXPECT_TRUE(candidates(index, "/bar").empty());
+}
+
+TEST(RouteIndexTest, Paths) {
+  RouteIndex index;
+  index.addPath("/foo", true, 0);
+  index.addPath("/Foo", false, 1);
+  index.addPath("/foo", true, 2);
+  index.addPath("/bar", true, 3);
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2}), candidates(index, "/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2}), candidates(index, "/foo?a=b"));
+  EXPECT_EQ((std::vector<uint32_t>{1}), candidates(index, "/FOO"));
+  EXPECT_TRUE(candidates(index, "/foo/").empty());
+}
+
+TEST(RouteIndexTest, Regexes) {
+  RouteIndex index;
+  index.addRegex("/foo/[0-9]+", 0);
+  index.addPrefix("/foo", true, 1);
+  index.addRegex("/foo/.*", 2);
+  index.addRegex("/bar", 3);
+  index.compile();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2}), candidates(index, "/foo/123"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 2}), candidates(index, "/foo/abc?x=1"));
+  // Regexes must match the whole path.
+  EXPECT_EQ((std::vector<uint32_t>{1}), candidates(index, "/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{3}), candidates(index, "/bar?x=/foo/1"));
+  EXPECT_TRUE(candidates(index, "/bar/baz").empty());
+}
+
+TEST(RouteIndexTest, InvalidRegexIsAlwaysCandidate) {
+  RouteIndex index;
+  index.addRegex("/foo", 0);
+  index.addRegex("/(", 1);
+  index.compile();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), candidates(index, "/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{1}), candidates(index, "/bar"));
+}
+
+TEST(RouteIndexTest, MixedKeepsRouteOrder) {
+  RouteIndex index;
+  index.addAlwaysCandidate(0);
+  index.addPath("/foo", true, 1);
+  index.addPrefix("/f", true, 2);
+  index.addAlwaysCandidate(3);
+  index.addPrefix("/bar", true, 4);
+  index.addAlwaysCandidate(5);
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 3, 5}), candidates(index, "/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 3, 4, 5}), candidates(index, "/bar"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 3, 5}), candidates(index, "/baz"));
+}
+
+TEST(RouteIndexTest, StopIteration) {
+  RouteIndex index;
+  index.addPrefix("/", true, 0);
+  index.addAlwaysCandidate(1);
+  index.addPrefix("/", true, 2);
+
+  std::vector<uint32_t> seen;
+  index.forEachCandidate("/", [&seen](uint32_t route) {
+    seen.push_back(route);
+    return route != 1;
+  });
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), seen);
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
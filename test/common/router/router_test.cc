@@ -29,6 +29,7 @@
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/ssl/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
@@ -93,7 +94,8 @@ public:
       : http_context_(stats_store_.symbolTable()), shadow_writer_(new MockShadowWriter()),
         config_("test.", local_info_, stats_store_, cm_, runtime_, random_,
                 ShadowWriterPtr{shadow_writer_}, true, start_child_span, suppress_envoy_headers,
-                false, std::move(strict_headers_to_check), test_time_.timeSystem(), http_context_),
+                false, std::move(strict_headers_to_check), test_time_.timeSystem(), http_context_,
+                &tls_),
         router_(config_) {
     router_.setDecoderFilterCallbacks(callbacks_);
     upstream_locality_.set_zone("to_az");
@@ -266,6 +268,7 @@ public:
   NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
   MockShadowWriter* shadow_writer_;
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   FilterConfig config_;
   TestFilter router_;
   Event::MockTimer* response_timeout_{};
@@ -2020,6 +2023,145 @@ TEST_F(RouterTest, HedgedPerTryTimeoutFirstRequestSucceeds) {
   // TODO: Verify hedge stats here once they are implemented.
 }
 
+// Sequence:
+// 1) first upstream request is slower than the latency hedge delay
+// 2) second upstream request sent
+// 3) first upstream request gets 2xx, the second one is reset
+TEST_F(RouterTest, LatencyHedgeFirstRequestSucceeds) {
+  NiceMock<MockLatencyHedgePolicy> latency_hedge_policy;
+  callbacks_.route_->route_entry_.hedge_policy_.latency_hedge_policy_ = &latency_hedge_policy;
+  EXPECT_CALL(latency_hedge_policy, onRequest());
+  ON_CALL(latency_hedge_policy, hedgeDelay())
+      .WillByDefault(Return(absl::optional<std::chrono::milliseconds>(10)));
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder1 = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder1 = &decoder;
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+  Event::MockTimer* hedge_timeout1 = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timeout1, enableTimer(std::chrono::milliseconds(10), _));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(encoder1.stream_, resetStream(_)).Times(0);
+  EXPECT_CALL(latency_hedge_policy, canHedge()).WillOnce(Return(true));
+  EXPECT_CALL(latency_hedge_policy, onHedge());
+  router_.retry_state_->expectHedgedPerTryTimeoutRetry();
+  hedge_timeout1->invokeCallback();
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_latency_hedge")
+                    .value());
+
+  NiceMock<Http::MockStreamEncoder> encoder2;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder2, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+  Event::MockTimer* hedge_timeout2 = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timeout2, enableTimer(std::chrono::milliseconds(10), _));
+  router_.retry_state_->callback_();
+
+  // The first request responds, its latency is recorded and the hedge is reset.
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(latency_hedge_policy, recordLatency(_));
+  EXPECT_CALL(encoder1.stream_, resetStream(_)).Times(0);
+  EXPECT_CALL(encoder2.stream_, resetStream(_));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder1->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
+// A request slower than the latency hedge delay is not hedged once the hedge budget is exhausted.
+TEST_F(RouterTest, LatencyHedgeBudgetExceeded) {
+  NiceMock<MockLatencyHedgePolicy> latency_hedge_policy;
+  callbacks_.route_->route_entry_.hedge_policy_.latency_hedge_policy_ = &latency_hedge_policy;
+  ON_CALL(latency_hedge_policy, hedgeDelay())
+      .WillByDefault(Return(absl::optional<std::chrono::milliseconds>(10)));
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+  Event::MockTimer* hedge_timeout = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timeout, enableTimer(std::chrono::milliseconds(10), _));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(latency_hedge_policy, canHedge()).WillOnce(Return(false));
+  EXPECT_CALL(latency_hedge_policy, onHedge()).Times(0);
+  EXPECT_CALL(*router_.retry_state_, shouldHedgeRetryPerTryTimeout(_)).Times(0);
+  hedge_timeout->invokeCallback();
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_latency_hedge_budget_exceeded")
+                    .value());
+
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
+// A hedge which the retry policy does not allow is not charged to the hedge budget.
+TEST_F(RouterTest, LatencyHedgeNotSentNotCharged) {
+  NiceMock<MockLatencyHedgePolicy> latency_hedge_policy;
+  callbacks_.route_->route_entry_.hedge_policy_.latency_hedge_policy_ = &latency_hedge_policy;
+  ON_CALL(latency_hedge_policy, hedgeDelay())
+      .WillByDefault(Return(absl::optional<std::chrono::milliseconds>(10)));
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+  Event::MockTimer* hedge_timeout = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timeout, enableTimer(std::chrono::milliseconds(10), _));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(latency_hedge_policy, canHedge()).WillOnce(Return(true));
+  EXPECT_CALL(*router_.retry_state_, shouldHedgeRetryPerTryTimeout(_))
+      .WillOnce(Return(RetryStatus::NoRetryLimitExceeded));
+  EXPECT_CALL(latency_hedge_policy, onHedge()).Times(0);
+  hedge_timeout->invokeCallback();
+  EXPECT_EQ(0U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_latency_hedge")
+                    .value());
+
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
 // Tests that an upstream request is reset even if it can't be retried as long as there is
 // another in-flight request we're waiting on.
 // Sequence:
@@ -3635,6 +3777,110 @@ TEST_F(RouterTest, Shadow) {
   EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
 }
 
+// With streamed shadows, the body and trailers are sent to the shadows as they are received
+// rather than buffered.
+TEST_F(RouterTest, ShadowStreamed) {
+  config_.stream_shadows_ = true;
+  ShadowPolicyPtr policy = std::make_unique<TestShadowPolicy>("foo", "bar");
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(std::move(policy));
+  policy = std::make_unique<TestShadowPolicy>("fizz", "buzz");
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(std::move(policy));
+  ON_CALL(callbacks_, streamId()).WillByDefault(Return(43));
+
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("bar", 0, 43, 10000)).WillOnce(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("buzz", 0, 43, 10000)).WillOnce(Return(true));
+
+  NiceMock<MockShadowStream> shadow_stream;
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("foo", _, std::chrono::milliseconds(10)))
+      .WillOnce(Return(&shadow_stream));
+  // A shadow which cannot be started is skipped.
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("fizz", _, std::chrono::milliseconds(10)))
+      .WillOnce(Return(nullptr));
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  // The shadow shares the slices of the body sent upstream.
+  Buffer::OwnedImpl body_data("hello");
+  EXPECT_CALL(shadow_stream, sendData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> bool {
+        Buffer::RawSlice slice;
+        Buffer::RawSlice body_slice;
+        data.getRawSlices(&slice, 1);
+        body_data.getRawSlices(&body_slice, 1);
+        EXPECT_EQ(body_slice.mem_, slice.mem_);
+        EXPECT_EQ("hello", data.toString());
+        return true;
+      }));
+  EXPECT_CALL(callbacks_, addDecodedData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, router_.decodeData(body_data, false));
+
+  Http::TestHeaderMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(shadow_stream, sendTrailers(_));
+  EXPECT_CALL(shadow_stream, release());
+  EXPECT_CALL(*shadow_writer_, shadow_(_, _, _)).Times(0);
+  router_.decodeTrailers(trailers);
+
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
+// A streamed shadow abandoned on the way is released, and one still going on when the request is
+// destroyed is released too.
+TEST_F(RouterTest, ShadowStreamedAbandoned) {
+  config_.stream_shadows_ = true;
+  ShadowPolicyPtr policy = std::make_unique<TestShadowPolicy>("foo", "bar");
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(std::move(policy));
+  policy = std::make_unique<TestShadowPolicy>("fizz", "buzz");
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(std::move(policy));
+  ON_CALL(callbacks_, streamId()).WillByDefault(Return(43));
+
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("bar", 0, 43, 10000)).WillOnce(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("buzz", 0, 43, 10000)).WillOnce(Return(true));
+
+  NiceMock<MockShadowStream> abandoned_stream;
+  NiceMock<MockShadowStream> shadow_stream;
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("foo", _, _)).WillOnce(Return(&abandoned_stream));
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("fizz", _, _)).WillOnce(Return(&shadow_stream));
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  Buffer::OwnedImpl body_data("hello");
+  EXPECT_CALL(abandoned_stream, sendData(_, false)).WillOnce(Return(false));
+  EXPECT_CALL(abandoned_stream, release());
+  router_.decodeData(body_data, false);
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("retry_or_shadow_abandoned")
+                    .value());
+
+  EXPECT_CALL(shadow_stream, release());
+  EXPECT_CALL(encoder.stream_, resetStream(Http::StreamResetReason::LocalReset));
+  router_.onDestroy();
+}
+
 TEST_F(RouterTest, AltStatName) {
   // Also test no upstream timeout here.
   EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
@@ -3896,6 +4142,30 @@ TEST_F(RouterTest, UpstreamTimingSingleRequest) {
             std::chrono::milliseconds(32));
 }
 
+// Verify that the latency of the upstream host is recorded for peak EWMA load balancing.
+TEST_F(RouterTest, PeakEwmaRecordsHostLatency) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_, upstream_stream_info_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers{};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(cm_.conn_pool_.host_->latency_, recordLatency(_, _));
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
 // Verify that upstream timing information is set into the StreamInfo when a
 // retry occurs (and not before).
 TEST_F(RouterTest, UpstreamTimingRetry) {
@@ -5232,5 +5502,279 @@ TEST(RouterFilterUtilityTest, StrictCheckValidHeaders) {
   }
 }
 
+class RouterRequestCollapsingTest : public RouterTest {
+public:
+  RouterRequestCollapsingTest() : collapsed_router_(config_) {
+    collapsed_router_.setDecoderFilterCallbacks(collapsed_callbacks_);
+    EXPECT_CALL(collapsed_callbacks_.dispatcher_, setTrackedObject(_)).Times(AnyNumber());
+    ON_CALL(callbacks_.route_->route_entry_, requestCollapsingPolicy())
+        .WillByDefault(Return(&policy_));
+    ON_CALL(collapsed_callbacks_.route_->route_entry_, requestCollapsingPolicy())
+        .WillByDefault(Return(&policy_));
+    HttpTestUtility::addDefaultHeaders(collapsed_request_headers_);
+  }
+
+  // Send a request identical to the one of the leader, which is thus collapsed into it.
+  void sendCollapsedRequest() {
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              collapsed_router_.decodeHeaders(collapsed_request_headers_, true));
+  }
+
+  TestRequestCollapsingPolicy policy_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> collapsed_callbacks_;
+  TestFilter collapsed_router_;
+  Http::TestHeaderMapImpl collapsed_request_headers_;
+};
+
+// The response of the leader is sent to the requests collapsed into it.
+TEST_F(RouterRequestCollapsingTest, ShareResponse) {
+  sendRequest();
+  sendCollapsedRequest();
+
+  EXPECT_CALL(collapsed_callbacks_, encodeHeaders_(HeaderHasValueRef(":status", "200"), false));
+  EXPECT_CALL(collapsed_callbacks_, encodeData(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) { EXPECT_EQ("hello", data.toString()); }));
+  EXPECT_CALL(collapsed_callbacks_, encodeTrailers_(HeaderHasValueRef("grpc-status", "0")));
+  response_decoder_->decodeHeaders(
+      Http::HeaderMapPtr{
+          new Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=60"}}},
+      false);
+  Buffer::OwnedImpl data("hello");
+  response_decoder_->decodeData(data, false);
+  response_decoder_->decodeTrailers(
+      Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{"grpc-status", "0"}}});
+  EXPECT_EQ(1U, config_.stats_.rq_collapsed_.value());
+
+  router_.onDestroy();
+  collapsed_router_.onDestroy();
+}
+
+// A request following a complete one is not collapsed into it.
+TEST_F(RouterRequestCollapsingTest, CompletedLeader) {
+  sendRequest();
+  response_decoder_->decodeHeaders(
+      Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", "200"}}}, true);
+  router_.onDestroy();
+
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            collapsed_router_.decodeHeaders(collapsed_request_headers_, true));
+
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+  EXPECT_EQ(0U, config_.stats_.rq_collapsed_.value());
+}
+
+// The collapsed requests are forwarded upstream themselves when the response of the leader is too
+// large to be shared.
+TEST_F(RouterRequestCollapsingTest, ResponseTooLarge) {
+  policy_.max_response_bytes_ = 128;
+  sendRequest();
+  sendCollapsedRequest();
+
+  EXPECT_CALL(collapsed_callbacks_, encodeHeaders_(_, _)).Times(0);
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  response_decoder_->decodeHeaders(
+      Http::HeaderMapPtr{
+          new Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "public"}}},
+      false);
+  Buffer::OwnedImpl data(std::string(128, 'a'));
+  response_decoder_->decodeData(data, true);
+  EXPECT_EQ(0U, config_.stats_.rq_collapsed_.value());
+
+  router_.onDestroy();
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+// The collapsed requests are forwarded upstream themselves when the response of the leader is not
+// cacheable, as soon as its headers are received.
+TEST_F(RouterRequestCollapsingTest, ResponseNotCacheable) {
+  sendRequest();
+  sendCollapsedRequest();
+
+  EXPECT_CALL(collapsed_callbacks_, encodeHeaders_(_, _)).Times(0);
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  response_decoder_->decodeHeaders(
+      Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", "200"},
+                                                     {"cache-control", "private, max-age=60"}}},
+      false);
+  EXPECT_EQ(0U, config_.stats_.rq_collapsed_.value());
+
+  router_.onDestroy();
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+// The collapsed requests are forwarded upstream themselves when the leader goes away before its
+// response is complete.
+TEST_F(RouterRequestCollapsingTest, LeaderDestroyed) {
+  sendRequest();
+  sendCollapsedRequest();
+
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  router_.onDestroy();
+
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+// The response timeout of a collapsed request covers the wait for the leader.
+TEST_F(RouterRequestCollapsingTest, CollapsedRequestTimeout) {
+  sendRequest();
+  Event::MockTimer* collapsed_response_timeout =
+      new Event::MockTimer(&collapsed_callbacks_.dispatcher_);
+  EXPECT_CALL(*collapsed_response_timeout, enableTimer(_, _));
+  sendCollapsedRequest();
+
+  EXPECT_CALL(*collapsed_response_timeout, disableTimer());
+  EXPECT_CALL(collapsed_callbacks_, encodeHeaders_(HeaderHasValueRef(":status", "504"), false));
+  collapsed_response_timeout->invokeCallback();
+
+  EXPECT_CALL(collapsed_callbacks_, encodeHeaders_(_, _)).Times(0);
+  response_decoder_->decodeHeaders(
+      Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", "200"}}}, true);
+
+  router_.onDestroy();
+  collapsed_router_.onDestroy();
+}
+
+// Requests collapsed per worker thread are collapsed with the requests of the same worker, which
+// the test runs on.
+TEST_F(RouterRequestCollapsingTest, PerWorker) {
+  policy_.per_process_ = false;
+  sendRequest();
+  sendCollapsedRequest();
+
+  EXPECT_CALL(collapsed_callbacks_, encodeHeaders_(HeaderHasValueRef(":status", "200"), true));
+  response_decoder_->decodeHeaders(
+      Http::HeaderMapPtr{
+          new Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=60"}}},
+      true);
+  EXPECT_EQ(1U, config_.stats_.rq_collapsed_.value());
+
+  router_.onDestroy();
+  collapsed_router_.onDestroy();
+}
+
+// Requests collapsed per worker thread are not collapsed with the requests collapsed across worker
+// threads.
+TEST_F(RouterRequestCollapsingTest, PerWorkerAndPerProcess) {
+  policy_.per_process_ = false;
+  sendRequest();
+
+  TestRequestCollapsingPolicy per_process_policy;
+  ON_CALL(collapsed_callbacks_.route_->route_entry_, requestCollapsingPolicy())
+      .WillByDefault(Return(&per_process_policy));
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  collapsed_router_.decodeHeaders(collapsed_request_headers_, true);
+
+  router_.onDestroy();
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+// Only GET requests are collapsed.
+TEST_F(RouterRequestCollapsingTest, PostNotCollapsed) {
+  default_request_headers_.setMethod("POST");
+  sendRequest();
+
+  collapsed_request_headers_.setMethod("POST");
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  collapsed_router_.decodeHeaders(collapsed_request_headers_, true);
+
+  router_.onDestroy();
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+// Requests carrying credentials are not collapsed, as their responses may be specific to the user.
+TEST_F(RouterRequestCollapsingTest, AuthorizationNotCollapsed) {
+  default_request_headers_.addCopy("authorization", "Bearer token");
+  sendRequest();
+
+  collapsed_request_headers_.addCopy("authorization", "Bearer token");
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  collapsed_router_.decodeHeaders(collapsed_request_headers_, true);
+
+  router_.onDestroy();
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+TEST_F(RouterRequestCollapsingTest, CookieNotCollapsed) {
+  default_request_headers_.addCopy("cookie", "session=1");
+  sendRequest();
+
+  collapsed_request_headers_.addCopy("cookie", "session=1");
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  collapsed_router_.decodeHeaders(collapsed_request_headers_, true);
+
+  router_.onDestroy();
+  EXPECT_CALL(cancellable_, cancel());
+  collapsed_router_.onDestroy();
+}
+
+TEST(RouterFilterUtilityTest, CollapsingKey) {
+  TestRequestCollapsingPolicy policy;
+  policy.headers_.emplace_back("accept");
+  Http::TestHeaderMapImpl headers{{":method", "GET"}, {":authority", "foo"}, {":path", "/bar"}};
+  const std::string key = FilterUtility::collapsingKey(policy, headers);
+
+  Http::TestHeaderMapImpl other_path{{":method", "GET"}, {":authority", "foo"}, {":path", "/baz"}};
+  EXPECT_NE(key, FilterUtility::collapsingKey(policy, other_path));
+
+  // The scheme is taken from x-forwarded-proto when :scheme is missing.
+  Http::TestHeaderMapImpl https{
+      {":method", "GET"}, {":scheme", "https"}, {":authority", "foo"}, {":path", "/bar"}};
+  Http::TestHeaderMapImpl forwarded_https{
+      {":method", "GET"}, {"x-forwarded-proto", "https"}, {":authority", "foo"}, {":path", "/bar"}};
+  EXPECT_NE(key, FilterUtility::collapsingKey(policy, https));
+  EXPECT_EQ(FilterUtility::collapsingKey(policy, https),
+            FilterUtility::collapsingKey(policy, forwarded_https));
+
+  // A missing header does not match an empty one.
+  Http::TestHeaderMapImpl empty_accept{
+      {":method", "GET"}, {":authority", "foo"}, {":path", "/bar"}, {"accept", ""}};
+  EXPECT_NE(key, FilterUtility::collapsingKey(policy, empty_accept));
+}
+
+TEST(RouterFilterUtilityTest, ShareableCollapsedResponse) {
+  EXPECT_TRUE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "public"}}));
+  EXPECT_TRUE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "404"}, {"cache-control", "no-transform, Max-Age=60"}}));
+  EXPECT_TRUE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "s-maxage = 10"}}));
+
+  // Not explicitly cacheable.
+  EXPECT_FALSE(
+      FilterUtility::shareableCollapsedResponse(Http::TestHeaderMapImpl{{":status", "200"}}));
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "no-transform"}}));
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=0"}}));
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=foo"}}));
+
+  // Not cacheable by a shared cache.
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=60, private"}}));
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "public, no-store"}}));
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "public, NO-CACHE"}}));
+
+  // Specific to the request which received it.
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(Http::TestHeaderMapImpl{
+      {":status", "200"}, {"cache-control", "public"}, {"vary", "accept-encoding"}}));
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(Http::TestHeaderMapImpl{
+      {":status", "200"}, {"cache-control", "public"}, {"set-cookie", "a=b"}}));
+
+  // Server errors.
+  EXPECT_FALSE(FilterUtility::shareableCollapsedResponse(
+      Http::TestHeaderMapImpl{{":status", "503"}, {"cache-control", "public"}}));
+}
+
 } // namespace Router
 } // namespace Envoy
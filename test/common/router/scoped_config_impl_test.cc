@@ -348,6 +348,67 @@ TEST(ScopeKeyBuilderImplTest, Parse) {
   EXPECT_EQ(key, nullptr);
 }
 
+// The hash of the key is computed without building it, and matches the hash of the key built.
+TEST(ScopeKeyBuilderImplTest, ComputeScopeKeyHash) {
+  std::string yaml_plain = R"EOF(
+  fragments:
+  - header_value_extractor:
+      name: 'foo_header'
+      element_separator: ','
+      element:
+        key: 'bar'
+        separator: '='
+  - header_value_extractor:
+      name: 'bar_header'
+      element_separator: ';'
+      index: 2
+  - header_value_extractor:
+      name: 'baz_header'
+      index: 0
+)EOF";
+
+  ScopedRoutes::ScopeKeyBuilder config;
+  TestUtility::loadFromYaml(yaml_plain, config);
+  ScopeKeyBuilderImpl key_builder(std::move(config));
+
+  const TestHeaderMapImpl headers{
+      {"foo_header", "a=b,bar=bar_value,e=f"},
+      {"bar_header", "a=b;bar=bar_value;index2"},
+      {"baz_header", "a=b;c"},
+  };
+  const absl::optional<uint64_t> hash = key_builder.computeScopeKeyHash(headers);
+  ASSERT_TRUE(hash.has_value());
+  EXPECT_EQ(key_builder.computeScopeKey(headers)->hash(), hash.value());
+  EXPECT_EQ(makeKey({"bar_value", "index2", "a=b;c"}).hash(), hash.value());
+
+  // Empty string fragments.
+  EXPECT_EQ(makeKey({"", "", ""}).hash(), key_builder.computeScopeKeyHash(TestHeaderMapImpl{
+                                              {"foo_header", "a=b,bar,e=f"},
+                                              {"bar_header", "a=b;bar=bar_value;"},
+                                              {"baz_header", ""},
+                                          }));
+
+  // Key not found.
+  EXPECT_EQ(absl::nullopt, key_builder.computeScopeKeyHash(TestHeaderMapImpl{
+                               {"foo_header", "a=b,meh,e=f"},
+                               {"bar_header", "a=b;bar=bar_value;index2"},
+                               {"baz_header", "a=b;c"},
+                           }));
+
+  // Index out of bound.
+  EXPECT_EQ(absl::nullopt, key_builder.computeScopeKeyHash(TestHeaderMapImpl{
+                               {"foo_header", "a=b,bar=bar_value,e=f"},
+                               {"bar_header", "a=b;bar=bar_value"},
+                               {"baz_header", "a=b;c"},
+                           }));
+
+  // Header missing.
+  EXPECT_EQ(absl::nullopt, key_builder.computeScopeKeyHash(TestHeaderMapImpl{
+                               {"foo_header", "a=b,bar=bar_value,e=f"},
+                               {"bar_header", "a=b;bar=bar_value;index2"},
+                           }));
+}
+
 class ScopedRouteInfoTest : public testing::Test {
 public:
   void SetUp() override {
@@ -325,6 +325,11 @@ key:
                 ->getRouteConfig(TestHeaderMapImpl{{"Addr", "x-foo-key;x-bar-key"}})
                 ->name(),
             "foo_routes");
+  // Both scopes share the route config built by the RDS provider of foo_routes.
+  EXPECT_EQ(getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(
+                TestHeaderMapImpl{{"Addr", "x-foo-key;x-foo-key"}}),
+            getScopedRdsProvider()->config<ScopedConfigImpl>()->getRouteConfig(
+                TestHeaderMapImpl{{"Addr", "x-foo-key;x-bar-key"}}));
 
   // Delete foo_scope2.
   resources.RemoveLast();
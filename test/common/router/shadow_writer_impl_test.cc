@@ -1,11 +1,14 @@
 #include <chrono>
 #include <string>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
 #include "common/router/shadow_writer_impl.h"
 
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -71,6 +74,124 @@ TEST_F(ShadowWriterImplTest, NoCluster) {
   writer_.shadow("foo", std::move(message), std::chrono::milliseconds(5));
 }
 
+class ShadowStreamTest : public testing::Test {
+public:
+  ShadowStream* startStream(ShadowWriterImpl& writer) {
+    Http::HeaderMapPtr headers(new Http::TestHeaderMapImpl{{":authority", "cluster1"}});
+    EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).WillOnce(ReturnRef(cm_.async_client_));
+    EXPECT_CALL(cm_.async_client_, start(_, _))
+        .WillOnce(Invoke([&](Http::AsyncClient::StreamCallbacks& callbacks,
+                             const Http::AsyncClient::StreamOptions&) {
+          callbacks_ = &callbacks;
+          return &stream_;
+        }));
+    EXPECT_CALL(stream_, sendHeaders(_, false)).WillOnce(Invoke([](Http::HeaderMap& headers, bool) {
+      EXPECT_EQ("cluster1-shadow", headers.Host()->value().getStringView());
+    }));
+    return writer.streamingShadow("foo", std::move(headers), std::chrono::milliseconds(5));
+  }
+
+  testing::NiceMock<Upstream::MockClusterManager> cm_;
+  testing::NiceMock<Http::MockAsyncClientStream> stream_;
+  Http::AsyncClient::StreamCallbacks* callbacks_{};
+};
+
+// The body bytes of a streamed shadow are charged to the budget until its response is received.
+TEST_F(ShadowStreamTest, Budget) {
+  ShadowWriterImpl writer(cm_, 10);
+  ShadowStream* shadow = startStream(writer);
+  ASSERT_NE(nullptr, shadow);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(_, false));
+  EXPECT_TRUE(shadow->sendData(data, false));
+
+  // The second shadow does not fit in what remains of the budget, and is reset.
+  testing::NiceMock<Http::MockAsyncClientStream> other_stream;
+  Http::AsyncClient::StreamCallbacks* other_callbacks = nullptr;
+  EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).WillOnce(ReturnRef(cm_.async_client_));
+  EXPECT_CALL(cm_.async_client_, start(_, _))
+      .WillOnce(Invoke([&](Http::AsyncClient::StreamCallbacks& callbacks,
+                           const Http::AsyncClient::StreamOptions&) {
+        other_callbacks = &callbacks;
+        return &other_stream;
+      }));
+  Http::HeaderMapPtr headers(new Http::TestHeaderMapImpl{{":authority", "cluster1"}});
+  ShadowStream* other_shadow =
+      writer.streamingShadow("foo", std::move(headers), std::chrono::milliseconds(5));
+  ASSERT_NE(nullptr, other_shadow);
+  Buffer::OwnedImpl other_data("hello world");
+  EXPECT_CALL(other_stream, sendData(_, _)).Times(0);
+  EXPECT_CALL(other_stream, reset()).WillOnce(Invoke([&]() { other_callbacks->onReset(); }));
+  EXPECT_FALSE(other_shadow->sendData(other_data, false));
+  other_shadow->release();
+
+  // Once the first shadow completes, its bytes are returned to the budget.
+  EXPECT_CALL(stream_, sendData(_, true));
+  EXPECT_TRUE(shadow->sendData(data, true));
+  shadow->release();
+  callbacks_->onComplete();
+
+  EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).WillOnce(ReturnRef(cm_.async_client_));
+  EXPECT_CALL(cm_.async_client_, start(_, _))
+      .WillOnce(Invoke([&](Http::AsyncClient::StreamCallbacks& callbacks,
+                           const Http::AsyncClient::StreamOptions&) {
+        other_callbacks = &callbacks;
+        return &other_stream;
+      }));
+  headers.reset(new Http::TestHeaderMapImpl{{":authority", "cluster1"}});
+  other_shadow = writer.streamingShadow("foo", std::move(headers), std::chrono::milliseconds(5));
+  Buffer::OwnedImpl last_data("0123456789");
+  EXPECT_CALL(other_stream, sendData(_, true));
+  EXPECT_TRUE(other_shadow->sendData(last_data, true));
+  other_shadow->release();
+  other_callbacks->onComplete();
+}
+
+// A shadow whose upstream connection is backed up is reset rather than buffering the body.
+TEST_F(ShadowStreamTest, AboveHighWatermark) {
+  ShadowWriterImpl writer(cm_, 1024);
+  ShadowStream* shadow = startStream(writer);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([&]() { callbacks_->onReset(); }));
+  EXPECT_FALSE(shadow->sendData(data, false));
+  shadow->release();
+}
+
+// Releasing a shadow before the end of the request resets its stream.
+TEST_F(ShadowStreamTest, ReleaseIncomplete) {
+  ShadowWriterImpl writer(cm_, 1024);
+  ShadowStream* shadow = startStream(writer);
+
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([&]() { callbacks_->onReset(); }));
+  shadow->release();
+}
+
+// Trailers complete the shadow request, which then outlives its release.
+TEST_F(ShadowStreamTest, Trailers) {
+  ShadowWriterImpl writer(cm_, 1024);
+  ShadowStream* shadow = startStream(writer);
+
+  Http::TestHeaderMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(stream_, sendTrailers(_));
+  EXPECT_TRUE(shadow->sendTrailers(trailers));
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow->release();
+  callbacks_->onComplete();
+}
+
+TEST_F(ShadowStreamTest, NoCluster) {
+  ShadowWriterImpl writer(cm_, 1024);
+  Http::HeaderMapPtr headers(new Http::TestHeaderMapImpl{{":authority", "cluster1"}});
+  EXPECT_CALL(cm_, get(Eq("foo"))).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).Times(0);
+  EXPECT_EQ(nullptr,
+            writer.streamingShadow("foo", std::move(headers), std::chrono::milliseconds(5)));
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
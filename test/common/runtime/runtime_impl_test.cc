@@ -333,6 +333,44 @@ TEST_F(DiskLoaderImplTest, GetLayers) {
   EXPECT_EQ(2, store_.counter("runtime.load_success").value());
 }
 
+// Only the layers which changed are loaded again, the others being shared with the previous
+// snapshots.
+TEST_F(DiskLoaderImplTest, SharedLayers) {
+  base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
+    foo: whatevs
+  )EOF");
+  setup();
+  run("test/common/runtime/test_data/current", "envoy_override");
+  const auto snapshot = loader_->threadsafeSnapshot();
+  const auto& layers = snapshot->getLayers();
+  ASSERT_EQ(4, layers.size());
+
+  loader_->mergeValues({{"foo", "bar"}});
+  const auto merged_snapshot = loader_->threadsafeSnapshot();
+  const auto& merged_layers = merged_snapshot->getLayers();
+  ASSERT_EQ(4, merged_layers.size());
+  EXPECT_EQ(layers[0], merged_layers[0]);
+  EXPECT_EQ(layers[1], merged_layers[1]);
+  EXPECT_EQ(layers[2], merged_layers[2]);
+  EXPECT_NE(layers[3], merged_layers[3]);
+  EXPECT_EQ("bar", merged_snapshot->get("foo"));
+
+  write("test/common/runtime/test_data/current/envoy/file14", "Sad cake");
+  updateDiskLayer(0);
+  const auto updated_snapshot = loader_->threadsafeSnapshot();
+  const auto& updated_layers = updated_snapshot->getLayers();
+  ASSERT_EQ(4, updated_layers.size());
+  EXPECT_EQ(merged_layers[0], updated_layers[0]);
+  EXPECT_NE(merged_layers[1], updated_layers[1]);
+  EXPECT_NE(merged_layers[2], updated_layers[2]);
+  EXPECT_EQ(merged_layers[3], updated_layers[3]);
+  EXPECT_EQ("Sad cake", updated_snapshot->get("file14"));
+  // The values which did not change are unaffected.
+  EXPECT_EQ("hello override", updated_snapshot->get("file1"));
+  EXPECT_EQ(2UL, updated_snapshot->getInteger("file3", 1));
+  EXPECT_EQ("bar", updated_snapshot->get("foo"));
+}
+
 TEST_F(DiskLoaderImplTest, BadDirectory) {
   setup();
   run("/baddir", "/baddir");
@@ -582,6 +620,42 @@ TEST_F(StaticLoaderImplTest, All) {
   testNewOverrides(*loader_, store_);
 }
 
+// Registered keys are looked up by index when the snapshot was built after they were registered,
+// and by name otherwise.
+TEST_F(StaticLoaderImplTest, RegisteredKeys) {
+  base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
+    foo: 2
+    bar: 60
+  )EOF");
+  const Key foo("foo");
+  const Key bar("bar");
+  const Key baz("baz");
+  setup();
+  EXPECT_EQ(foo.index(), Key("foo").index());
+  EXPECT_NE(foo.index(), bar.index());
+  EXPECT_EQ(2UL, loader_->snapshot().getInteger(foo, 1));
+  EXPECT_EQ(1UL, loader_->snapshot().getInteger(baz, 1));
+  EXPECT_CALL(generator_, random()).WillOnce(Return(59));
+  EXPECT_TRUE(loader_->snapshot().featureEnabled(bar, 0));
+  EXPECT_FALSE(loader_->snapshot().featureEnabled(baz, 0));
+
+  loader_->mergeValues({{"foo", "3"}, {"late", "4"}});
+  EXPECT_EQ(3UL, loader_->snapshot().getInteger(foo, 1));
+  const Key late("late");
+  EXPECT_EQ(4UL, loader_->snapshot().getInteger(late, 1));
+}
+
+// Each snapshot has its own generation, increasing as the values are updated.
+TEST_F(StaticLoaderImplTest, Generation) {
+  setup();
+  const uint64_t generation = loader_->snapshot().generation();
+  EXPECT_NE(0UL, generation);
+  EXPECT_EQ(generation, loader_->snapshot().generation());
+
+  loader_->mergeValues({{"foo", "3"}});
+  EXPECT_LT(generation, loader_->snapshot().generation());
+}
+
 // Validate proto parsing sanity.
 TEST_F(StaticLoaderImplTest, ProtoParsing) {
   base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
@@ -0,0 +1,80 @@
+#include "envoy/stats/stats_macros.h"
+
+#include "common/stats/isolated_store_impl.h"
+#include "common/stats/lazy_stats_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+#define ALL_TEST_STATS(COUNTER, GAUGE, HISTOGRAM)                                                  \
+  COUNTER(test_counter)                                                                            \
+  GAUGE(test_gauge, Accumulate)                                                                    \
+  HISTOGRAM(test_histogram, Milliseconds)
+
+struct TestStats {
+  ALL_TEST_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+class LazyStatsImplTest : public testing::Test {
+protected:
+  LazyStatsImplTest()
+      : scope_(store_.createScope("prefix.")), pool_(*scope_),
+        stats_({ALL_TEST_STATS(LAZY_POOL_COUNTER(pool_), LAZY_POOL_GAUGE(pool_),
+                               LAZY_POOL_HISTOGRAM(pool_))}) {}
+
+  IsolatedStoreImpl store_;
+  ScopePtr scope_;
+  LazyStatPool pool_;
+  TestStats stats_;
+};
+
+// Stats are not created until they are written to, and read as zero until then.
+TEST_F(LazyStatsImplTest, NotCreatedUntilWritten) {
+  EXPECT_EQ(0U, store_.counters().size());
+  EXPECT_EQ(0U, store_.gauges().size());
+  EXPECT_EQ(0U, store_.histograms().size());
+
+  EXPECT_EQ(0U, stats_.test_counter_.value());
+  EXPECT_EQ(0U, stats_.test_counter_.latch());
+  stats_.test_counter_.reset();
+  EXPECT_FALSE(stats_.test_counter_.used());
+  EXPECT_EQ(0U, stats_.test_gauge_.value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, stats_.test_gauge_.importMode());
+  EXPECT_EQ(Histogram::Unit::Milliseconds, stats_.test_histogram_.unit());
+  EXPECT_EQ(0U, store_.counters().size());
+  EXPECT_EQ(0U, store_.gauges().size());
+
+  // Setting a gauge to zero does not create it either.
+  stats_.test_gauge_.set(0);
+  EXPECT_EQ(0U, store_.gauges().size());
+}
+
+// Writes go to the stats in the scope.
+TEST_F(LazyStatsImplTest, Written) {
+  stats_.test_counter_.inc();
+  stats_.test_counter_.add(2);
+  EXPECT_EQ(3U, stats_.test_counter_.value());
+  EXPECT_TRUE(stats_.test_counter_.used());
+  EXPECT_EQ(3U, store_.counter("prefix.test_counter").value());
+  EXPECT_EQ("prefix.test_counter", stats_.test_counter_.name());
+  EXPECT_EQ(1U, store_.counters().size());
+
+  stats_.test_gauge_.set(5);
+  stats_.test_gauge_.dec();
+  EXPECT_EQ(4U, stats_.test_gauge_.value());
+  EXPECT_EQ(4U, store_.gauge("prefix.test_gauge", Gauge::ImportMode::Accumulate).value());
+  stats_.test_gauge_.set(0);
+  EXPECT_EQ(0U, stats_.test_gauge_.value());
+  EXPECT_EQ(1U, store_.gauges().size());
+
+  stats_.test_histogram_.recordValue(10);
+  EXPECT_EQ("prefix.test_histogram", stats_.test_histogram_.name());
+  EXPECT_EQ(Histogram::Unit::Milliseconds, stats_.test_histogram_.unit());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
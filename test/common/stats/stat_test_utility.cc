@@ -84,8 +84,10 @@ void forEachSampleStat(int num_clusters, std::function<void(absl::string_view)>
   // These are the other stats that appear in the admin /stats request when made
   // prior to any requests.
   static const char* other_stats[] = {"http.admin.downstream_cx_length_ms",
+                                      "http.admin.downstream_cx_reads_per_event",
                                       "http.admin.downstream_rq_time",
                                       "http.ingress_http.downstream_cx_length_ms",
+                                      "http.ingress_http.downstream_cx_reads_per_event",
                                       "http.ingress_http.downstream_rq_time",
                                       "listener.0.0.0.0_40000.downstream_cx_length_ms",
                                       "listener.admin.downstream_cx_length_ms"};
@@ -1,7 +1,9 @@
 #include "envoy/config/metrics/v3alpha/stats.pb.h"
 #include "envoy/type/matcher/v3alpha/string.pb.h"
 
+#include "common/stats/fake_symbol_table_impl.h"
 #include "common/stats/stats_matcher_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "test/test_common/utility.h"
 
@@ -21,19 +23,43 @@ protected:
   void rejectAll(const bool should_reject) {
     stats_config_.mutable_stats_matcher()->set_reject_all(should_reject);
   }
-  void initMatcher() { stats_matcher_impl_ = std::make_unique<StatsMatcherImpl>(stats_config_); }
+  void initMatcher() {
+    stats_matcher_impl_ = std::make_unique<StatsMatcherImpl>(stats_config_, symbol_table_);
+    fake_stats_matcher_impl_ =
+        std::make_unique<StatsMatcherImpl>(stats_config_, fake_symbol_table_);
+  }
+  // Checks the outcome for the name as a string, and as a StatName encoded with
+  // either symbol table implementation. Names that the encoding doesn't keep
+  // as-is, such as those ending with a '.', can't be stat names.
+  void expectRejects(const std::string& stat_name, bool rejects) {
+    EXPECT_EQ(rejects, stats_matcher_impl_->rejects(stat_name)) << stat_name;
+    StatNameManagedStorage storage(stat_name, symbol_table_);
+    if (symbol_table_.toString(storage.statName()) == stat_name) {
+      EXPECT_EQ(rejects, stats_matcher_impl_->rejects(storage.statName(), symbol_table_))
+          << stat_name;
+    }
+    StatNameManagedStorage fake_storage(stat_name, fake_symbol_table_);
+    if (fake_symbol_table_.toString(fake_storage.statName()) == stat_name) {
+      EXPECT_EQ(rejects,
+                fake_stats_matcher_impl_->rejects(fake_storage.statName(), fake_symbol_table_))
+          << stat_name;
+    }
+  }
   void expectAccepted(std::vector<std::string> expected_to_pass) {
     for (const auto& stat_name : expected_to_pass) {
-      EXPECT_FALSE(stats_matcher_impl_->rejects(stat_name)) << "Accepted: " << stat_name;
+      expectRejects(stat_name, false);
     }
   }
   void expectDenied(std::vector<std::string> expected_to_fail) {
     for (const auto& stat_name : expected_to_fail) {
-      EXPECT_TRUE(stats_matcher_impl_->rejects(stat_name)) << "Rejected: " << stat_name;
+      expectRejects(stat_name, true);
     }
   }
 
+  SymbolTableImpl symbol_table_;
+  FakeSymbolTableImpl fake_symbol_table_;
   std::unique_ptr<StatsMatcherImpl> stats_matcher_impl_;
+  std::unique_ptr<StatsMatcherImpl> fake_stats_matcher_impl_;
 
 private:
   envoy::config::metrics::v3alpha::StatsConfig stats_config_;
@@ -126,6 +152,30 @@ TEST_F(StatsMatcherTest, CheckExcludePrefix) {
   EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
 }
 
+// Exact and prefix matchers spanning several tokens, which are tested against
+// the tokens of StatNames.
+
+TEST_F(StatsMatcherTest, CheckIncludeTokenExact) {
+  inclusionList()->set_exact("cluster.foo.upstream_rq");
+  initMatcher();
+  expectAccepted({"cluster.foo.upstream_rq"});
+  expectDenied({"cluster.foo", "cluster.foo.upstream_rq.x", "cluster.foo.upstream_rqx",
+                "x.cluster.foo.upstream_rq", "cluster.foo..upstream_rq"});
+}
+
+TEST_F(StatsMatcherTest, CheckExcludeTokenPrefix) {
+  exclusionList()->set_prefix("cluster.outbound.");
+  exclusionList()->set_prefix("http.ingress.down");
+  initMatcher();
+  expectAccepted({"cluster", "cluster.outbound", "cluster.outboundx.foo", "clusterx.outbound.foo",
+                  "x.cluster.outbound.foo", "http.ingress", "http.ingress.up",
+                  "http.ingressx.down", "http.ingress.up.down"});
+  expectDenied({"cluster.outbound.foo", "cluster.outbound.foo.bar", "cluster.outbound..foo",
+                "http.ingress.down", "http.ingress.downstream_rq", "http.ingress.down.x"});
+  EXPECT_FALSE(stats_matcher_impl_->acceptsAll());
+  EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
+}
+
 // Single suffix matchers.
 
 TEST_F(StatsMatcherTest, CheckIncludeSuffix) {
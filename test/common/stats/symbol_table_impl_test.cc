@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 
 #include "common/common/macros.h"
@@ -11,6 +12,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/hash/hash_testing.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "gtest/gtest.h"
@@ -405,6 +407,35 @@ TEST_P(StatNameTest, Sort) {
   EXPECT_EQ(names, sorted_names);
 }
 
+// Symbols of 128 and above take several bytes, and may share their first byte, e.g. 128 and
+// 256. Sorting must still order them by their strings.
+TEST_P(StatNameTest, SortMultiByteSymbols) {
+  StatNameVec names;
+  for (int i = 0; i < 300; ++i) {
+    names.push_back(makeStat(absl::StrCat("prefix.token", i)));
+  }
+  std::reverse(names.begin(), names.end());
+  std::sort(names.begin(), names.end(), StatNameLessThan(*table_));
+
+  std::vector<std::string> sorted_strings;
+  for (StatName name : names) {
+    sorted_strings.push_back(table_->toString(name));
+  }
+  EXPECT_TRUE(std::is_sorted(sorted_strings.begin(), sorted_strings.end()));
+}
+
+TEST_P(StatNameTest, StartsWith) {
+  const StatName name = makeStat("a.bc.d");
+  EXPECT_TRUE(table_->startsWith(name, StatName()));
+  EXPECT_TRUE(table_->startsWith(name, makeStat("a")));
+  EXPECT_TRUE(table_->startsWith(name, makeStat("a.bc")));
+  EXPECT_TRUE(table_->startsWith(name, makeStat("a.bc.d")));
+  EXPECT_FALSE(table_->startsWith(name, makeStat("a.b")));
+  EXPECT_FALSE(table_->startsWith(name, makeStat("bc")));
+  EXPECT_FALSE(table_->startsWith(name, makeStat("a.bc.d.e")));
+  EXPECT_FALSE(table_->startsWith(makeStat("a"), makeStat("a.bc")));
+}
+
 TEST_P(StatNameTest, Concat2) {
   SymbolTable::StoragePtr joined = table_->join({makeStat("a.b"), makeStat("c.d")});
   EXPECT_EQ("a.b.c.d", table_->toString(StatName(joined.get())));
@@ -495,20 +526,13 @@ TEST_P(StatNameTest, RacingSymbolCreation) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
+  // SymbolTableImpl only takes its lock shared to encode names made of
+  // existing symbols, and to release references that aren't the last ones, so
+  // the symbol table adds no contention after latching 'create_contentions'
+  // above. This can't be asserted with:
   //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // as the tracer also counts the contentions on the mutexes of the
+  // ConditionalInitializers the threads are woken up with.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -563,20 +587,13 @@ TEST_P(StatNameTest, MutexContentionOnExistingSymbols) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
+  // SymbolTableImpl only takes its lock shared to encode names made of
+  // existing symbols, and to release references that aren't the last ones, so
+  // the symbol table adds no contention after latching 'create_contentions'
+  // above. This can't be asserted with:
   //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // as the tracer also counts the contentions on the mutexes of the
+  // ConditionalInitializers the threads are woken up with.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -683,6 +700,36 @@ TEST_P(StatNameTest, RecentLookups) {
   EXPECT_EQ(0, num_calls);
 }
 
+// Names made of existing symbols are encoded and freed with the symbol table's
+// lock held shared, which must keep the ref-counts and the lookup total right.
+TEST_P(StatNameTest, EncodeExistingSymbols) {
+  makeStat("a.b");
+  EXPECT_EQ(2, table_->numSymbols());
+
+  // Repeated symbols take, and release, one reference per occurrence.
+  StatNameStorage repeated("b.a.b", *table_);
+  EXPECT_EQ(2, table_->numSymbols());
+  StatNameStorage copy(repeated.statName(), *table_);
+  repeated.free(*table_);
+  EXPECT_EQ("b.a.b", table_->toString(copy.statName()));
+  copy.free(*table_);
+  EXPECT_EQ(2, table_->numSymbols());
+
+  // A name with one new symbol adds just that one.
+  StatNameStorage partial("a.c", *table_);
+  EXPECT_EQ(3, table_->numSymbols());
+  partial.free(*table_);
+  EXPECT_EQ(2, table_->numSymbols());
+
+  if (GetParam() == SymbolTableType::Real) {
+    // All the names encoded above are counted, though the recent lookups
+    // aren't remembered.
+    EXPECT_EQ(3, table_->getRecentLookups([](absl::string_view, uint64_t) {}));
+    table_->clearRecentLookups();
+    EXPECT_EQ(0, table_->getRecentLookups([](absl::string_view, uint64_t) {}));
+  }
+}
+
 TEST_P(StatNameTest, StatNameEmptyEquivalent) {
   StatName empty1;
   StatName empty2 = makeStat("");
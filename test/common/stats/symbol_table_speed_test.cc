@@ -3,12 +3,16 @@
 //
 // NOLINT(namespace-envoy)
 
+#include <algorithm>
+#include <vector>
+
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 #include "common/stats/symbol_table_impl.h"
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -54,6 +58,144 @@ static void BM_CreateRace(benchmark::State& state) {
 }
 BENCHMARK(BM_CreateRace);
 
+// Builds names sharing a long common prefix, as cluster stats do, so that
+// comparisons have to look past the prefix.
+static std::vector<Envoy::Stats::StatNameStorage>
+makeClusterStatNames(Envoy::Stats::SymbolTable& table, int num_names) {
+  std::vector<Envoy::Stats::StatNameStorage> names;
+  names.reserve(num_names);
+  for (int i = 0; i < num_names; ++i) {
+    names.emplace_back(absl::StrCat("cluster.service_", i % 100, ".upstream_rq_", i), table);
+  }
+  return names;
+}
+
+static void BM_SortByName(benchmark::State& state) {
+  Envoy::Stats::SymbolTableImpl table;
+  std::vector<Envoy::Stats::StatNameStorage> storage = makeClusterStatNames(table, 10000);
+  std::vector<Envoy::Stats::StatName> names;
+  for (const Envoy::Stats::StatNameStorage& name : storage) {
+    names.push_back(name.statName());
+  }
+  const Envoy::Stats::StatNameLessThan less_than(table);
+
+  for (auto _ : state) {
+    std::vector<Envoy::Stats::StatName> sorted = names;
+    std::sort(sorted.begin(), sorted.end(), less_than);
+  }
+
+  for (Envoy::Stats::StatNameStorage& name : storage) {
+    name.free(table);
+  }
+}
+BENCHMARK(BM_SortByName);
+
+static void BM_HashSetLookup(benchmark::State& state) {
+  Envoy::Stats::SymbolTableImpl table;
+  std::vector<Envoy::Stats::StatNameStorage> storage = makeClusterStatNames(table, 10000);
+  Envoy::Stats::StatNameHashSet set;
+  for (const Envoy::Stats::StatNameStorage& name : storage) {
+    set.insert(name.statName());
+  }
+
+  for (auto _ : state) {
+    for (const Envoy::Stats::StatNameStorage& name : storage) {
+      benchmark::DoNotOptimize(set.find(name.statName()));
+    }
+  }
+
+  for (Envoy::Stats::StatNameStorage& name : storage) {
+    name.free(table);
+  }
+}
+BENCHMARK(BM_HashSetLookup);
+
+static void BM_JoinPrefix(benchmark::State& state) {
+  Envoy::Stats::SymbolTableImpl table;
+  Envoy::Stats::StatNameStorage prefix("cluster.service_0", table);
+  Envoy::Stats::StatNameStorage name("upstream_rq_total", table);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(table.join({prefix.statName(), name.statName()}));
+  }
+
+  prefix.free(table);
+  name.free(table);
+}
+BENCHMARK(BM_JoinPrefix);
+
+// Shared by the threads of the multithreaded benchmarks below, which is set up
+// and torn down by their first thread.
+static Envoy::Stats::SymbolTableImpl* shared_table = nullptr;
+static std::vector<Envoy::Stats::StatNameStorage>* shared_names = nullptr;
+
+static void setUpSharedNames() {
+  shared_table = new Envoy::Stats::SymbolTableImpl;
+  shared_names = new std::vector<Envoy::Stats::StatNameStorage>(
+      makeClusterStatNames(*shared_table, 1000));
+}
+
+static void tearDownSharedNames() {
+  for (Envoy::Stats::StatNameStorage& name : *shared_names) {
+    name.free(*shared_table);
+  }
+  delete shared_names;
+  delete shared_table;
+}
+
+// Encodes and frees names whose tokens are all in the table, as filters do with
+// the dynamic names of tables or commands they have already seen, concurrently
+// from each thread.
+static void BM_EncodeExistingNamesMultiThreaded(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    setUpSharedNames();
+  }
+  std::vector<std::string> strings;
+  // Each thread encodes its own 100 of the names, matching those of setUpSharedNames().
+  for (int i = state.thread_index % 10; i < 1000; i += 10) {
+    strings.push_back(absl::StrCat("cluster.service_", i % 100, ".upstream_rq_", i));
+  }
+
+  for (auto _ : state) {
+    for (const std::string& string : strings) {
+      Envoy::Stats::StatNameStorage name(string, *shared_table);
+      name.free(*shared_table);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+
+  if (state.thread_index == 0) {
+    tearDownSharedNames();
+  }
+}
+BENCHMARK(BM_EncodeExistingNamesMultiThreaded)->ThreadRange(1, 64)->UseRealTime();
+
+// Looks up the dynamic names of a StatNameSet concurrently from each thread.
+static void BM_GetDynamicMultiThreaded(benchmark::State& state) {
+  static Envoy::Stats::StatNameSetPtr stat_name_set;
+  if (state.thread_index == 0) {
+    setUpSharedNames();
+    stat_name_set = shared_table->makeSet("benchmark");
+  }
+  std::vector<std::string> tokens;
+  for (int i = 0; i < 100; ++i) {
+    tokens.push_back(absl::StrCat("table_", i));
+  }
+
+  for (auto _ : state) {
+    for (const std::string& token : tokens) {
+      benchmark::DoNotOptimize(stat_name_set->getDynamic(token));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tokens.size());
+
+  if (state.thread_index == 0) {
+    stat_name_set.reset();
+    tearDownSharedNames();
+  }
+}
+BENCHMARK(BM_GetDynamicMultiThreaded)->ThreadRange(1, 64)->UseRealTime();
+
 int main(int argc, char** argv) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logger_context(spdlog::level::warn,
@@ -365,6 +365,81 @@ TEST(TagExtractorTest, ExtractRegexPrefix) {
   EXPECT_EQ("", extractRegexPrefix("prefix(foo)"));
 }
 
+TEST(TagExtractorTokensTest, Match) {
+  TagExtractorTokensImpl tag_extractor("cluster_name", "cluster.$.**");
+  EXPECT_EQ("cluster_name", tag_extractor.name());
+  EXPECT_EQ("cluster", tag_extractor.prefixToken());
+  const std::string name = "cluster.test_cluster.upstream_cx_total";
+  std::vector<Tag> tags;
+  IntervalSetImpl<size_t> remove_characters;
+  ASSERT_TRUE(tag_extractor.extractTag(name, tags, remove_characters));
+  EXPECT_EQ("cluster.upstream_cx_total", StringUtil::removeCharacters(name, remove_characters));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("test_cluster", tags.at(0).value_);
+  EXPECT_EQ("cluster_name", tags.at(0).name_);
+}
+
+TEST(TagExtractorTokensTest, Wildcards) {
+  TagExtractorTokensImpl tag_extractor("name", "*.foo.$.bar");
+  EXPECT_EQ("", tag_extractor.prefixToken());
+  std::vector<Tag> tags;
+  IntervalSetImpl<size_t> remove_characters;
+  EXPECT_TRUE(tag_extractor.extractTag("a.foo.value.bar", tags, remove_characters));
+  EXPECT_EQ("a.foo.bar", StringUtil::removeCharacters("a.foo.value.bar", remove_characters));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("value", tags.at(0).value_);
+
+  // The name must have exactly as many tokens as the pattern when it does not end in "**".
+  EXPECT_FALSE(tag_extractor.extractTag("a.foo.value.bar.baz", tags, remove_characters));
+  EXPECT_FALSE(tag_extractor.extractTag("a.foo.value", tags, remove_characters));
+  EXPECT_FALSE(tag_extractor.extractTag("a.baz.value.bar", tags, remove_characters));
+  EXPECT_EQ(1, tags.size());
+}
+
+// The tokenized builtin extractors extract the same tags as the regexes they replaced.
+TEST(TagExtractorTokensTest, SameAsRegex) {
+  const std::vector<std::pair<std::string, std::string>> patterns = {
+      {"cluster.$.**", "^cluster\\.((.*?)\\.)"},
+      {"http.$.**", "^http\\.((.*?)\\.)"},
+      {"vhost.$.**", "^vhost\\.((.*?)\\.)"},
+      {"mongo.$.**", "^mongo\\.((.*?)\\.)"},
+  };
+  const std::vector<std::string> names = {"cluster.foo.bar",
+                                           "cluster.foo.bar.baz",
+                                           "cluster.foo",
+                                           "cluster.foo.",
+                                           "cluster..bar",
+                                           "cluster.",
+                                           "cluster",
+                                           "clusterx.foo.bar",
+                                           "x.cluster.foo.bar",
+                                           "http.foo.rq_total",
+                                           "vhost.a.vcluster.b.c",
+                                           "mongo.a.cmd.b.c",
+                                           ""};
+  for (const auto& pattern : patterns) {
+    TagExtractorTokensImpl tokens_extractor("name", pattern.first);
+    TagExtractorImpl regex_extractor("name", pattern.second);
+    EXPECT_EQ(regex_extractor.prefixToken(), tokens_extractor.prefixToken());
+    for (const std::string& name : names) {
+      std::vector<Tag> tokens_tags;
+      IntervalSetImpl<size_t> tokens_remove_characters;
+      std::vector<Tag> regex_tags;
+      IntervalSetImpl<size_t> regex_remove_characters;
+      EXPECT_EQ(regex_extractor.extractTag(name, regex_tags, regex_remove_characters),
+                tokens_extractor.extractTag(name, tokens_tags, tokens_remove_characters))
+          << pattern.first << " " << name;
+      EXPECT_EQ(StringUtil::removeCharacters(name, regex_remove_characters),
+                StringUtil::removeCharacters(name, tokens_remove_characters))
+          << pattern.first << " " << name;
+      ASSERT_EQ(regex_tags.size(), tokens_tags.size()) << pattern.first << " " << name;
+      if (!regex_tags.empty()) {
+        EXPECT_EQ(regex_tags[0].value_, tokens_tags[0].value_) << pattern.first << " " << name;
+      }
+    }
+  }
+}
+
 TEST(TagExtractorTest, CreateTagExtractorNoRegex) {
   EXPECT_THROW_WITH_REGEX(TagExtractorImpl::createTagExtractor("no such default tag", ""),
                           EnvoyException, "^No regex specified for tag specifier and no default");
@@ -55,5 +55,19 @@ TEST(TagProducerTest, CheckConstructor) {
       "No regex specified for tag specifier and no default regex for name: 'test_extractor'");
 }
 
+// Default tags that are extracted without a regex can also be enabled individually by name.
+TEST(TagProducerTest, DefaultTokenizedTagByName) {
+  envoy::config::metrics::v3alpha::StatsConfig stats_config;
+  stats_config.mutable_use_all_default_tags()->set_value(false);
+  stats_config.mutable_stats_tags()->Add()->set_tag_name(Config::TagNames::get().CLUSTER_NAME);
+  TagProducerImpl producer{stats_config};
+
+  std::vector<Tag> tags;
+  EXPECT_EQ("cluster.upstream_rq_200", producer.produceTags("cluster.foo.upstream_rq_200", tags));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ(Config::TagNames::get().CLUSTER_NAME, tags[0].name_);
+  EXPECT_EQ("foo", tags[0].value_);
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -17,6 +17,8 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -67,6 +69,80 @@ private:
   std::vector<std::unique_ptr<Stats::StatNameStorage>> stat_names_;
 };
 
+// Records histograms on a number of worker threads, each with its own event loop as in the server,
+// so that merges go through the same cross-thread posts as flushes do.
+class ThreadLocalStoreHistogramMergePerf {
+public:
+  ThreadLocalStoreHistogramMergePerf(uint32_t num_histograms, uint32_t num_workers)
+      : symbol_table_(Stats::SymbolTableCreator::makeSymbolTable()), heap_alloc_(*symbol_table_),
+        store_(heap_alloc_), api_(Api::createApiForTest(store_)) {
+    main_dispatcher_ = api_->allocateDispatcher();
+    worker_dispatchers_.resize(num_workers);
+    absl::BlockingCounter workers_started(num_workers);
+    for (uint32_t i = 0; i < num_workers; ++i) {
+      workers_.emplace_back(api_->threadFactory().createThread([this, i, &workers_started]() {
+        worker_dispatchers_[i] = api_->allocateDispatcher();
+        workers_started.DecrementCount();
+        worker_dispatchers_[i]->run(Event::Dispatcher::RunType::RunUntilExit);
+      }));
+    }
+    workers_started.Wait();
+
+    tls_.registerThread(*main_dispatcher_, true);
+    for (Event::DispatcherPtr& dispatcher : worker_dispatchers_) {
+      tls_.registerThread(*dispatcher, false);
+    }
+    store_.initializeThreading(*main_dispatcher_, tls_);
+
+    for (uint32_t i = 0; i < num_histograms; ++i) {
+      histograms_.push_back(&store_.histogram(absl::StrCat("histogram.", i),
+                                              Stats::Histogram::Unit::Unspecified));
+    }
+  }
+
+  ~ThreadLocalStoreHistogramMergePerf() {
+    store_.shutdownThreading();
+    tls_.shutdownGlobalThreading();
+    tls_.shutdownThread();
+    for (Event::DispatcherPtr& dispatcher : worker_dispatchers_) {
+      dispatcher->post([&dispatcher]() { dispatcher->exit(); });
+    }
+    for (Thread::ThreadPtr& worker : workers_) {
+      worker->join();
+    }
+  }
+
+  // Records one value into every histogram on every worker.
+  void recordValues() {
+    absl::BlockingCounter recorded(worker_dispatchers_.size());
+    for (Event::DispatcherPtr& dispatcher : worker_dispatchers_) {
+      dispatcher->post([this, &recorded]() {
+        for (Stats::Histogram* histogram : histograms_) {
+          histogram->recordValue(1);
+        }
+        recorded.DecrementCount();
+      });
+    }
+    recorded.Wait();
+  }
+
+  void mergeHistograms() {
+    store_.mergeHistograms([this]() { main_dispatcher_->exit(); });
+    main_dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
+private:
+  Stats::SymbolTablePtr symbol_table_;
+  Stats::AllocatorImpl heap_alloc_;
+  Stats::ThreadLocalStoreImpl store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr main_dispatcher_;
+  std::vector<Event::DispatcherPtr> worker_dispatchers_;
+  std::vector<Thread::ThreadPtr> workers_;
+  ThreadLocal::InstanceImpl tls_;
+  std::vector<Stats::Histogram*> histograms_;
+};
+
 } // namespace Envoy
 
 // Tests the single-threaded performance of the thread-local-store stats caches
@@ -93,6 +169,26 @@ static void BM_StatsWithTls(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTls);
 
+// Tests the time to merge histograms recorded on all workers, which is what each stats flush waits
+// for. The arguments are the number of histograms and the number of workers. Every worker records
+// into every histogram, so the largest configuration holds 640k TLS histograms and needs a few GB
+// of memory.
+static void BM_HistogramMerge(benchmark::State& state) {
+  Envoy::ThreadLocalStoreHistogramMergePerf context(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    context.recordValues();
+    state.ResumeTiming();
+    context.mergeHistograms();
+  }
+}
+BENCHMARK(BM_HistogramMerge)
+    ->Args({1000, 8})
+    ->Args({10000, 64})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
 
@@ -539,7 +539,7 @@ TEST_F(StatsMatcherTLSTest, TestNoOpStatImpls) {
 
   stats_config_.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns()->set_prefix(
       "noop");
-  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config_));
+  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config_, store_->symbolTable()));
 
   // Testing No-op counters, gauges, histograms which match the prefix "noop".
 
@@ -604,7 +604,7 @@ TEST_F(StatsMatcherTLSTest, TestExclusionRegex) {
       ->mutable_exclusion_list()
       ->add_patterns()
       ->set_hidden_envoy_deprecated_regex(".*[A-Z].*");
-  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config_));
+  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config_, store_->symbolTable()));
 
   // The creation of counters/gauges/histograms which have no uppercase letters should succeed.
   Counter& lowercase_counter = store_->counter("lowercase_counter");
@@ -640,7 +640,7 @@ TEST_F(StatsMatcherTLSTest, TestExclusionRegex) {
   // the string "invalid".
   stats_config_.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns()->set_prefix(
       "invalid");
-  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config_));
+  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config_, store_->symbolTable()));
 
   Counter& valid_counter = store_->counter("valid_counter");
   valid_counter.inc();
@@ -843,7 +843,7 @@ TEST_F(StatsThreadLocalStoreTest, RemoveRejectedStats) {
   envoy::config::metrics::v3alpha::StatsConfig stats_config;
   stats_config.mutable_stats_matcher()->mutable_inclusion_list()->add_patterns()->set_exact(
       "no-such-stat");
-  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config));
+  store_->setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config, store_->symbolTable()));
 
   // They can no longer be found.
   EXPECT_EQ(0, store_->counters().size());
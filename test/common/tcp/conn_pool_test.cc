@@ -93,15 +93,18 @@ public:
 
   void expectConnCreate() {
     test_conns_.emplace_back();
+    const size_t index = test_conns_.size() - 1;
     TestConnection& test_conn = test_conns_.back();
     test_conn.connection_ = new NiceMock<Network::MockClientConnection>();
     test_conn.connect_timer_ = new NiceMock<Event::MockTimer>(&mock_dispatcher_);
 
     EXPECT_CALL(mock_dispatcher_, createClientConnection_(_, _, _, _))
         .WillOnce(Return(test_conn.connection_));
+    // Several connections may be expected at once, so the test connection is looked up by index.
     EXPECT_CALL(*test_conn.connection_, addReadFilter(_))
-        .WillOnce(Invoke(
-            [&](Network::ReadFilterSharedPtr filter) -> void { test_conn.filter_ = filter; }));
+        .WillOnce(Invoke([this, index](Network::ReadFilterSharedPtr filter) -> void {
+          test_conns_[index].filter_ = filter;
+        }));
     EXPECT_CALL(*test_conn.connection_, connect());
     EXPECT_CALL(*test_conn.connect_timer_, enableTimer(_, _));
   }
@@ -413,6 +416,61 @@ TEST_F(TcpConnPoolImplTest, NoUpstreamCallbacks) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that connections are established ahead of demand when prefetching is enabled, and that the
+ * data an upstream sends first on a prefetched connection is held until the connection is assigned.
+ */
+TEST_F(TcpConnPoolImplTest, PrefetchConnections) {
+  cluster_->tcp_prefetch_connections_ = 1;
+  InSequence s;
+
+  // The first request waits for its connection, and another connection is prefetched.
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  ConnPoolCallbacks callbacks1;
+  EXPECT_NE(nullptr, conn_pool_.newConnection(callbacks1));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prefetch_miss_.value());
+
+  Network::MockClientConnection* connection1 = conn_pool_.test_conns_[0].connection_;
+  EXPECT_CALL(*conn_pool_.test_conns_[0].connect_timer_, disableTimer());
+  EXPECT_CALL(callbacks1.pool_ready_, ready());
+  connection1->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The prefetched connection is ready, and stops reading to hold the data sent by the upstream.
+  Network::MockClientConnection* connection2 = conn_pool_.test_conns_[1].connection_;
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  connection2->raiseEvent(Network::ConnectionEvent::Connected);
+  Buffer::OwnedImpl greeting("greeting");
+  EXPECT_CALL(*connection2, readDisable(true));
+  EXPECT_EQ(Network::FilterStatus::StopIteration,
+            conn_pool_.test_conns_[1].filter_->onData(greeting, false));
+  EXPECT_EQ("greeting", greeting.toString());
+
+  // The second request is assigned the prefetched connection, which resumes reading, and another
+  // connection is prefetched.
+  ConnPoolCallbacks callbacks2;
+  EXPECT_CALL(*connection2, readDisable(false));
+  EXPECT_CALL(callbacks2.pool_ready_, ready());
+  conn_pool_.expectConnCreate();
+  EXPECT_EQ(nullptr, conn_pool_.newConnection(callbacks2));
+  EXPECT_EQ(connection2, &callbacks2.conn_data_->connection());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prefetch_hit_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  Network::MockClientConnection* connection3 = conn_pool_.test_conns_[2].connection_;
+
+  // Shutdown normally.
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  callbacks1.conn_data_.reset();
+  callbacks2.conn_data_.reset();
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(3);
+  connection1->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  connection2->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  connection3->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 /**
  * Tests a request that generates a new connection, completes, and then a second request that uses
  * the same connection.
@@ -31,6 +31,7 @@
 #include "test/mocks/tcp/mocks.h"
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -942,6 +943,7 @@ public:
 
   Event::TestTimeSystem& timeSystem() { return factory_context_.timeSystem(); }
 
+  TestScopedRuntime scoped_runtime_;
   NiceMock<Server::Configuration::MockFactoryContext> factory_context_;
   ConfigSharedPtr config_;
   std::unique_ptr<Filter> filter_;
@@ -1369,8 +1371,10 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamConnectionLimit)) {
 }
 
 // Tests that the idle timer closes both connections, and gets updated when either
-// connection has activity.
+// connection has activity, with the idle timer re-armed on every read and write.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(IdleTimeout)) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.tcp_proxy_lazy_idle_timer", "false"}});
   envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
   config.mutable_idle_timeout()->set_seconds(1);
   setup(1, config);
@@ -1399,6 +1403,81 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(IdleTimeout)) {
   idle_timer->invokeCallback();
 }
 
+// Tests that with the lazy idle timer activity only records the time, and that the timer re-arms
+// itself with the remaining time when it fires after activity.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(LazyIdleTimeout)) {
+  envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
+  config.mutable_idle_timeout()->set_seconds(1);
+  setup(1, config);
+
+  MonotonicTime now{std::chrono::seconds(10)};
+  ON_CALL(filter_callbacks_.connection_.dispatcher_, approximateMonotonicTime())
+      .WillByDefault(ReturnPointee(&now));
+
+  Event::MockTimer* idle_timer = new Event::MockTimer(&filter_callbacks_.connection_.dispatcher_);
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  raiseEventUpstreamConnected(0);
+
+  // None of these re-arm the timer.
+  now += std::chrono::milliseconds(100);
+  Buffer::OwnedImpl buffer("hello");
+  filter_->onData(buffer, false);
+  buffer.add("hello2");
+  upstream_callbacks_->onUpstreamData(buffer, false);
+  filter_callbacks_.connection_.raiseBytesSentCallbacks(1);
+  now += std::chrono::milliseconds(300);
+  upstream_connections_.at(0)->raiseBytesSentCallbacks(2);
+
+  now += std::chrono::milliseconds(600);
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(400), _));
+  idle_timer->invokeCallback();
+  EXPECT_EQ(0U, config_->stats().idle_timeout_.value());
+
+  now += std::chrono::milliseconds(400);
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*idle_timer, disableTimer());
+  idle_timer->invokeCallback();
+  EXPECT_EQ(1U, config_->stats().idle_timeout_.value());
+}
+
+// Tests that the lazy idle timer is handed to the upstream flush with the remaining time.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(LazyIdleTimerUpstreamFlush)) {
+  envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
+  config.mutable_idle_timeout()->set_seconds(1);
+  setup(1, config);
+
+  MonotonicTime now{std::chrono::seconds(10)};
+  ON_CALL(filter_callbacks_.connection_.dispatcher_, approximateMonotonicTime())
+      .WillByDefault(ReturnPointee(&now));
+
+  Event::MockTimer* idle_timer = new Event::MockTimer(&filter_callbacks_.connection_.dispatcher_);
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  raiseEventUpstreamConnected(0);
+
+  now += std::chrono::milliseconds(300);
+  Buffer::OwnedImpl buffer("hello");
+  filter_->onData(buffer, false);
+
+  now += std::chrono::milliseconds(500);
+  EXPECT_CALL(*upstream_connections_.at(0),
+              close(Network::ConnectionCloseType::FlushWrite))
+      .WillOnce(Return()); // Cancel default action of raising LocalClose
+  EXPECT_CALL(*upstream_connections_.at(0), state())
+      .WillOnce(Return(Network::Connection::State::Closing));
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(500), _));
+  filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+
+  filter_.reset();
+  EXPECT_EQ(1U, config_->stats().upstream_flush_active_.value());
+
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  idle_timer->invokeCallback();
+  EXPECT_EQ(1U, config_->stats().upstream_flush_total_.value());
+  EXPECT_EQ(0U, config_->stats().upstream_flush_active_.value());
+  EXPECT_EQ(1U, config_->stats().idle_timeout_.value());
+}
+
 // Tests that the idle timer is disabled when the downstream connection is closed.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(IdleTimerDisabledDownstreamClose)) {
   envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
@@ -1429,6 +1508,8 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(IdleTimerDisabledUpstreamClose)) {
 
 // Tests that flushing data during an idle timeout doesn't cause problems.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(IdleTimeoutWithOutstandingDataFlushed)) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.tcp_proxy_lazy_idle_timer", "false"}});
   envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
   config.mutable_idle_timeout()->set_seconds(1);
   setup(1, config);
@@ -1614,6 +1695,8 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamFlushNoTimeout)) {
 // Tests that upstream flush works with an idle timeout configured, but the connection
 // finishes draining before the timer expires.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamFlushTimeoutConfigured)) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.tcp_proxy_lazy_idle_timer", "false"}});
   envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
   config.mutable_idle_timeout()->set_seconds(1);
   setup(1, config);
@@ -1646,6 +1729,8 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamFlushTimeoutConfigured)) {
 
 // Tests that upstream flush closes the connection when the idle timeout fires.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamFlushTimeoutExpired)) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.tcp_proxy_lazy_idle_timer", "false"}});
   envoy::extensions::filters::network::tcp_proxy::v3alpha::TcpProxy config = defaultConfig();
   config.mutable_idle_timeout()->set_seconds(1);
   setup(1, config);
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/thread_local/rcu_slot.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace ThreadLocal {
+namespace {
+
+using testing::NiceMock;
+
+class TestData {
+public:
+  TestData(uint64_t value, std::atomic<uint64_t>& destroyed)
+      : value_(value), destroyed_(destroyed) {}
+  ~TestData() { destroyed_++; }
+
+  const uint64_t value_;
+  std::atomic<uint64_t>& destroyed_;
+};
+
+// An update is seen at once and the previous version is destroyed if nothing reads it.
+TEST(RcuSlotTest, SetAndGet) {
+  std::atomic<uint64_t> destroyed{0};
+  NiceMock<Event::MockDispatcher> dispatcher;
+  RcuSlot<TestData> slot(dispatcher, std::make_shared<TestData>(1, destroyed));
+  EXPECT_EQ(1, slot.get()->value_);
+
+  slot.set(std::make_shared<TestData>(2, destroyed));
+  EXPECT_EQ(2, slot.get()->value_);
+  EXPECT_EQ(1, destroyed);
+
+  uint64_t value = 0;
+  slot.read([&value](const std::shared_ptr<const TestData>& data) { value = data->value_; });
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(slot.reclaim());
+}
+
+// A version is not destroyed while another thread may still read it, and is destroyed by the
+// reclaim timer once the read is over.
+TEST(RcuSlotTest, RetiredWhileRead) {
+  std::atomic<uint64_t> destroyed{0};
+  NiceMock<Event::MockDispatcher> dispatcher;
+  Event::MockTimer* reclaim_timer = new NiceMock<Event::MockTimer>(&dispatcher);
+  RcuSlot<TestData> slot(dispatcher, std::make_shared<TestData>(1, destroyed));
+
+  Thread::MutexBasicLockable mutex;
+  Thread::CondVar cv;
+  bool reading = false;
+  bool updated = false;
+  uint64_t value = 0;
+  Thread::ThreadPtr reader = Thread::threadFactoryForTest().createThread([&]() {
+    slot.read([&](const std::shared_ptr<const TestData>& data) {
+      Thread::LockGuard lock(mutex);
+      reading = true;
+      cv.notifyAll();
+      while (!updated) {
+        cv.wait(mutex);
+      }
+      value = data->value_;
+    });
+  });
+
+  {
+    Thread::LockGuard lock(mutex);
+    while (!reading) {
+      cv.wait(mutex);
+    }
+  }
+  slot.set(std::make_shared<TestData>(2, destroyed));
+  EXPECT_EQ(0, destroyed);
+  EXPECT_TRUE(reclaim_timer->enabled_);
+  {
+    Thread::LockGuard lock(mutex);
+    updated = true;
+    cv.notifyAll();
+  }
+  reader->join();
+
+  EXPECT_EQ(1, value);
+  reclaim_timer->invokeCallback();
+  EXPECT_EQ(1, destroyed);
+  EXPECT_FALSE(reclaim_timer->enabled_);
+}
+
+// Readers on many threads always see a live version while the slot is updated.
+TEST(RcuSlotTest, ConcurrentReaders) {
+  constexpr uint32_t NumThreads = 4;
+  constexpr uint64_t NumUpdates = 1000;
+  std::atomic<uint64_t> destroyed{0};
+  NiceMock<Event::MockDispatcher> dispatcher;
+  RcuSlot<TestData> slot(dispatcher, std::make_shared<TestData>(0, destroyed));
+  std::atomic<bool> done{false};
+
+  std::vector<Thread::ThreadPtr> readers;
+  for (uint32_t i = 0; i < NumThreads; i++) {
+    readers.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      uint64_t last = 0;
+      while (!done) {
+        slot.read([&](const std::shared_ptr<const TestData>& data) {
+          // Versions are only seen in order of publication, and never once destroyed.
+          EXPECT_LE(last, data->value_);
+          last = data->value_;
+        });
+      }
+    }));
+  }
+
+  for (uint64_t i = 1; i <= NumUpdates; i++) {
+    slot.set(std::make_shared<TestData>(i, destroyed));
+  }
+  done = true;
+  for (Thread::ThreadPtr& reader : readers) {
+    reader->join();
+  }
+
+  EXPECT_FALSE(slot.reclaim());
+  EXPECT_EQ(NumUpdates, destroyed);
+}
+
+} // namespace
+} // namespace ThreadLocal
+} // namespace Envoy
@@ -620,6 +620,25 @@ TEST_F(HttpConnManFinalizerImplTest, GrpcTrailersOnly) {
                                             &response_trailers, stream_info, config);
 }
 
+// Spans that are not recorded are finished without building any tag.
+TEST_F(HttpConnManFinalizerImplTest, SpanNotRecording) {
+  Http::TestHeaderMapImpl request_headers{
+      {"x-request-id", "id"}, {":path", "/test"}, {":method", "GET"}};
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}};
+  Http::TestHeaderMapImpl response_trailers;
+
+  EXPECT_CALL(span, isRecording()).WillRepeatedly(Return(false));
+  EXPECT_CALL(span, setTag(_, _)).Times(0);
+  EXPECT_CALL(span, log(_, _)).Times(0);
+  EXPECT_CALL(stream_info, bytesReceived()).Times(0);
+  EXPECT_CALL(span, finishSpan()).Times(2);
+
+  HttpTracerUtility::finalizeDownstreamSpan(span, &request_headers, &response_headers,
+                                            &response_trailers, stream_info, config);
+  HttpTracerUtility::finalizeUpstreamSpan(span, &response_headers, &response_trailers, stream_info,
+                                          config);
+}
+
 TEST(HttpTracerUtilityTest, operationTypeToString) {
   EXPECT_EQ("ingress", HttpTracerUtility::toString(OperationName::Ingress));
   EXPECT_EQ("egress", HttpTracerUtility::toString(OperationName::Egress));
@@ -640,6 +659,7 @@ TEST(HttpNullTracerTest, BasicFunctionality) {
   span_ptr->setOperation("foo");
   span_ptr->setTag("foo", "bar");
   span_ptr->injectContext(request_headers);
+  EXPECT_FALSE(span_ptr->isRecording());
 
   EXPECT_NE(nullptr, span_ptr->spawnChild(config, "foo", SystemTime()));
 }
@@ -687,6 +707,19 @@ TEST_F(HttpTracerImplTest, BasicFunctionalityNodeSet) {
   tracer_->startSpan(config_, request_headers_, stream_info_, {Reason::Sampling, true});
 }
 
+TEST_F(HttpTracerImplTest, NodeNotSetWhenNotRecording) {
+  EXPECT_CALL(stream_info_, startTime());
+  EXPECT_CALL(config_, operationName()).Times(2);
+
+  NiceMock<MockSpan>* span = new NiceMock<MockSpan>();
+  EXPECT_CALL(*driver_, startSpan_(_, _, "ingress", stream_info_.start_time_, _))
+      .WillOnce(Return(span));
+  EXPECT_CALL(*span, isRecording()).WillOnce(Return(false));
+  EXPECT_CALL(*span, setTag(_, _)).Times(0);
+
+  tracer_->startSpan(config_, request_headers_, stream_info_, {Reason::Sampling, false});
+}
+
 } // namespace
 } // namespace Tracing
 } // namespace Envoy
@@ -0,0 +1,63 @@
+#include <vector>
+
+#include "common/upstream/alias_table.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Counts the picks of each entry over every random number of a whole number of table rounds, which
+// are exactly proportional to the weights.
+std::vector<uint64_t> countPicks(const std::vector<uint64_t>& weights) {
+  AliasTable table(weights);
+  uint64_t total_weight = 0;
+  uint64_t num_columns = 0;
+  for (uint64_t weight : weights) {
+    total_weight += weight;
+    num_columns += weight > 0 ? 1 : 0;
+  }
+  std::vector<uint64_t> picks(weights.size());
+  for (uint64_t random = 0; random < total_weight * num_columns; ++random) {
+    picks[table.pick(random)]++;
+  }
+  return picks;
+}
+
+TEST(AliasTableTest, Empty) {
+  EXPECT_TRUE(AliasTable().empty());
+  EXPECT_TRUE(AliasTable(std::vector<uint64_t>()).empty());
+  EXPECT_TRUE(AliasTable({0, 0}).empty());
+  EXPECT_FALSE(AliasTable({0, 1}).empty());
+}
+
+TEST(AliasTableTest, Single) {
+  AliasTable table({0, 5, 0});
+  for (uint64_t random = 0; random < 100; ++random) {
+    EXPECT_EQ(1, table.pick(random));
+  }
+}
+
+TEST(AliasTableTest, Equal) {
+  EXPECT_EQ(std::vector<uint64_t>({7 * 3, 7 * 3, 7 * 3}), countPicks({7, 7, 7}));
+}
+
+// The picks are exactly proportional to the weights, and the entries of weight 0 are never picked.
+TEST(AliasTableTest, Weighted) {
+  EXPECT_EQ(std::vector<uint64_t>({0, 10000 * 2, 5000 * 2}), countPicks({0, 10000, 5000}));
+  EXPECT_EQ(std::vector<uint64_t>({1 * 4, 2 * 4, 0, 3 * 4, 94 * 4}),
+            countPicks({1, 2, 0, 3, 94}));
+  EXPECT_EQ(std::vector<uint64_t>({667 * 3, 1 * 3, 1332 * 3}), countPicks({667, 1, 1332}));
+}
+
+// Small random numbers pick the first entry of positive weight.
+TEST(AliasTableTest, SmallRandomPicksFirst) {
+  AliasTable table({0, 667, 667});
+  EXPECT_EQ(1, table.pick(0));
+  EXPECT_EQ(1, table.pick(2));
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -13,15 +13,19 @@
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::Eq;
 using testing::InSequence;
+using testing::Property;
 using testing::Return;
 using testing::StrEq;
 using testing::Throw;
@@ -36,7 +40,7 @@ class CdsApiImplTest : public testing::Test {
 protected:
   void setup() {
     envoy::config::core::v3alpha::ConfigSource cds_config;
-    cds_ = CdsApiImpl::create(cds_config, cm_, store_, validation_visitor_);
+    cds_ = CdsApiImpl::create(cds_config, cm_, store_, validation_visitor_, time_system_);
     cds_->setInitializedCb([this]() -> void { initialized_.ready(); });
 
     EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
@@ -64,7 +68,8 @@ protected:
   NiceMock<MockClusterManager> cm_;
   Upstream::ClusterManager::ClusterInfoMap cluster_map_;
   Upstream::MockClusterMockPrioritySet mock_cluster_;
-  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
   CdsApiPtr cds_;
   Config::SubscriptionCallbacks* cds_callbacks_{};
   ReadyWatcher initialized_;
@@ -126,6 +131,26 @@ resources:
   EXPECT_EQ("1", cds_->versionInfo());
 }
 
+// A cluster whose update fails validation is not removed, and keeps its last good config.
+TEST_F(CdsApiImplTest, ValidateFailDoesNotRemoveCluster) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> clusters;
+  envoy::config::cluster::v3alpha::Cluster cluster;
+  cluster.set_name("cluster1");
+  cluster.mutable_connect_timeout()->set_seconds(-1);
+  clusters.Add()->PackFrom(cluster);
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterMap({"cluster1"})));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _)).Times(0);
+  EXPECT_CALL(cm_, removeCluster(_)).Times(0);
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_THROW(cds_callbacks_->onConfigUpdate(clusters, "1"), EnvoyException);
+}
+
 // Validate onConfigUpdate throws EnvoyException with duplicate clusters.
 TEST_F(CdsApiImplTest, ValidateDuplicateClusters) {
   InSequence s;
@@ -229,6 +254,46 @@ TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   }
 }
 
+// Validate that the clusters with the same per-resource version or contents as the applied ones
+// are skipped, unless they are no longer active.
+TEST_F(CdsApiImplTest, DeltaConfigUpdateUnchanged) {
+  {
+    InSequence s;
+    setup();
+  }
+  EXPECT_CALL(initialized_, ready());
+
+  auto make_resources = [](const std::string& version, uint32_t connect_timeout) {
+    Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> resources;
+    for (const std::string name : {"cluster_1", "cluster_2"}) {
+      envoy::config::cluster::v3alpha::Cluster cluster;
+      cluster.set_name(name);
+      cluster.mutable_connect_timeout()->set_seconds(connect_timeout);
+      auto* resource = resources.Add();
+      resource->mutable_resource()->PackFrom(cluster);
+      resource->set_name(name);
+      resource->set_version(version);
+    }
+    return resources;
+  };
+
+  expectAdd("cluster_1", "v1");
+  expectAdd("cluster_2", "v1");
+  cds_callbacks_->onConfigUpdate(make_resources("v1", 1), {}, "v1");
+
+  // Same versions, the contents are not looked at.
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _)).Times(0);
+  cds_callbacks_->onConfigUpdate(make_resources("v1", 2), {}, "v2");
+
+  // New versions, same contents.
+  cds_callbacks_->onConfigUpdate(make_resources("v2", 1), {}, "v3");
+
+  // cluster_2 is no longer active, e.g. it is still warming.
+  EXPECT_CALL(cm_, get(Eq("cluster_2"))).WillOnce(Return(nullptr));
+  expectAdd("cluster_2", "v2");
+  cds_callbacks_->onConfigUpdate(make_resources("v2", 1), {}, "v4");
+}
+
 TEST_F(CdsApiImplTest, ConfigUpdateAddsSecondClusterEvenIfFirstThrows) {
   {
     InSequence s;
@@ -260,6 +325,38 @@ TEST_F(CdsApiImplTest, ConfigUpdateAddsSecondClusterEvenIfFirstThrows) {
       "Error adding/updating cluster(s) cluster_1: An exception, cluster_3: Another exception");
 }
 
+// The time spent decoding and applying an update is recorded, including for failed updates.
+TEST_F(CdsApiImplTest, UpdateTimesRecorded) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  EXPECT_CALL(cm_, clusters()).WillRepeatedly(Return(ClusterManager::ClusterInfoMap{}));
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "cluster_manager.cds.update_decode_time"),
+                          _))
+      .Times(2);
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "cluster_manager.cds.update_apply_time"),
+                          _))
+      .Times(2);
+
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> clusters;
+  envoy::config::cluster::v3alpha::Cluster cluster_1;
+  cluster_1.set_name("cluster_1");
+  clusters.Add()->PackFrom(cluster_1);
+  expectAdd("cluster_1");
+  cds_callbacks_->onConfigUpdate(clusters, "");
+
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> resources;
+  auto* resource = resources.Add();
+  resource->set_name("cluster_2");
+  resource->mutable_resource()->PackFrom(envoy::config::cluster::v3alpha::Cluster());
+  EXPECT_THROW(cds_callbacks_->onConfigUpdate(resources, {}, "v2"), EnvoyException);
+}
+
 TEST_F(CdsApiImplTest, Basic) {
   InSequence s;
 
@@ -312,7 +409,7 @@ resources:
       TestUtility::parseYaml<envoy::service::discovery::v3alpha::DiscoveryResponse>(response2_yaml);
 
   EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterMap({"cluster1", "cluster2"})));
-  expectAdd("cluster1", "1");
+  // cluster1 is unchanged, so it is not handed to the cluster manager again.
   expectAdd("cluster3", "1");
   EXPECT_CALL(cm_, removeCluster("cluster2"));
   cds_callbacks_->onConfigUpdate(response2.resources(), response2.version_info());
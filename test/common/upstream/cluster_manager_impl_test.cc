@@ -8,6 +8,7 @@
 
 using testing::_;
 using testing::Eq;
+using testing::Field;
 using testing::InSequence;
 using testing::Invoke;
 using testing::Mock;
@@ -525,6 +526,25 @@ TEST_F(ClusterManagerImplTest, SubsetLoadBalancerClusterProvidedLbRestriction) {
       "cluster: LB policy CLUSTER_PROVIDED cannot be combined with lb_subset_config");
 }
 
+TEST_F(ClusterManagerImplTest, SubsetLoadBalancerPeakEwmaLbRestriction) {
+  const std::string yaml = R"EOF(
+ static_resources:
+  clusters:
+  - name: cluster_1
+    connect_timeout: 0.250s
+    type: static
+    lb_policy: peak_ewma
+    lb_subset_config:
+      fallback_policy: ANY_ENDPOINT
+      subset_selectors:
+        - keys: [ "x" ]
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(
+      create(parseBootstrapFromV2Yaml(yaml)), EnvoyException,
+      "cluster: LB policy PEAK_EWMA cannot be combined with lb_subset_config");
+}
+
 TEST_F(ClusterManagerImplTest, SubsetLoadBalancerLocalityAware) {
   const std::string yaml = R"EOF(
  static_resources:
@@ -1329,6 +1349,40 @@ TEST_F(ClusterManagerImplTest, DynamicAddRemove) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
 }
 
+// The clusters looked up again by the same name are those added, updated or removed since.
+TEST_F(ClusterManagerImplTest, LookupByCachedNameFollowsUpdates) {
+  create(defaultConfig());
+  const std::string name = "fake_cluster";
+  const std::string other_name = "fake_cluster";
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_)).WillOnce(Invoke([](std::function<void()> callback) {
+    callback();
+  }));
+  EXPECT_EQ(nullptr, cluster_manager_->get(name));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster(name), ""));
+  EXPECT_EQ(cluster1->info_, cluster_manager_->get(name)->info());
+  EXPECT_EQ(cluster_manager_->get(name), cluster_manager_->get(other_name));
+
+  auto update_cluster = defaultStaticCluster(name);
+  update_cluster.mutable_per_connection_buffer_limit_bytes()->set_value(12345);
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster2, nullptr)));
+  EXPECT_CALL(*cluster2, initialize(_)).WillOnce(Invoke([](std::function<void()> callback) {
+    callback();
+  }));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(update_cluster, ""));
+  EXPECT_EQ(cluster2->info_, cluster_manager_->get(name)->info());
+  EXPECT_EQ(cluster2->info_, cluster_manager_->get(other_name)->info());
+
+  EXPECT_TRUE(cluster_manager_->removeCluster(name));
+  EXPECT_EQ(nullptr, cluster_manager_->get(name));
+  EXPECT_EQ(nullptr, cluster_manager_->get(other_name));
+}
+
 TEST_F(ClusterManagerImplTest, addOrUpdateClusterStaticExists) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
                                         clustersJson({defaultStaticClusterJson("fake_cluster")}));
@@ -2062,7 +2116,10 @@ TEST_F(ClusterManagerImplTest, UseUdpWithCustomDnsResolver) {
 
   std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
   // `false` here stands for using udp
-  EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_, false)).WillOnce(Return(dns_resolver));
+  EXPECT_CALL(factory_.dispatcher_,
+              createDnsResolver(
+                  _, Field(&Network::DnsResolverOptions::use_tcp_for_dns_lookups_, false)))
+      .WillOnce(Return(dns_resolver));
 
   Network::DnsResolver::ResolveCb dns_callback;
   Network::MockActiveDnsQuery active_dns_query;
@@ -2090,7 +2147,10 @@ TEST_F(ClusterManagerImplTest, UseTcpWithCustomDnsResolver) {
 
   std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
   // `true` here stands for using tcp
-  EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_, true)).WillOnce(Return(dns_resolver));
+  EXPECT_CALL(factory_.dispatcher_,
+              createDnsResolver(
+                  _, Field(&Network::DnsResolverOptions::use_tcp_for_dns_lookups_, true)))
+      .WillOnce(Return(dns_resolver));
 
   Network::DnsResolver::ResolveCb dns_callback;
   Network::MockActiveDnsQuery active_dns_query;
@@ -2860,6 +2920,34 @@ TEST_F(ClusterManagerInitHelperTest, UpdateAlreadyInitialized) {
   cluster2.initialize_callback_();
 }
 
+// A cluster removed before it initialized is no longer waited for, wherever it is in the list.
+TEST_F(ClusterManagerInitHelperTest, RemoveUninitializedCluster) {
+  InSequence s;
+
+  ReadyWatcher cm_initialized;
+  init_helper_.setInitializedCb([&]() -> void { cm_initialized.ready(); });
+
+  std::vector<std::unique_ptr<NiceMock<MockClusterMockPrioritySet>>> clusters;
+  for (int i = 0; i < 3; i++) {
+    clusters.push_back(std::make_unique<NiceMock<MockClusterMockPrioritySet>>());
+    ON_CALL(*clusters.back(), initializePhase())
+        .WillByDefault(Return(Cluster::InitializePhase::Primary));
+    EXPECT_CALL(*clusters.back(), initialize(_));
+    init_helper_.addCluster(*clusters.back());
+  }
+  init_helper_.onStaticLoadComplete();
+
+  init_helper_.removeCluster(*clusters[1]);
+  init_helper_.removeCluster(*clusters[1]);
+
+  EXPECT_CALL(*this, onClusterInit(Ref(*clusters[0])));
+  clusters[0]->initialize_callback_();
+
+  EXPECT_CALL(*this, onClusterInit(Ref(*clusters[2])));
+  EXPECT_CALL(cm_initialized, ready());
+  clusters[2]->initialize_callback_();
+}
+
 // If secondary clusters initialization triggered outside of CdsApiImpl::onConfigUpdate()'s
 // callback flows, sending ClusterLoadAssignment should not be paused before calling
 // ClusterManagerInitHelper::maybeFinishInitialize(). This case tests that
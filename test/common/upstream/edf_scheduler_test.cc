@@ -55,6 +55,47 @@ TEST(EdfSchedulerTest, Weighted) {
   }
 }
 
+// Validate that pickAndAdd() picks the same sequence as pick() followed by add().
+TEST(EdfSchedulerTest, PickAndAdd) {
+  EdfScheduler<uint32_t> sched;
+  EdfScheduler<uint32_t> pick_and_add_sched;
+  constexpr uint32_t num_entries = 128;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(i % 7 + 1, entries[i]);
+    pick_and_add_sched.add(i % 7 + 1, entries[i]);
+  }
+
+  // The weight changes on every pick, as it does for the least request load balancer.
+  for (uint32_t i = 0; i < 16 * num_entries; ++i) {
+    auto p = sched.pick();
+    const double weight = (*p + i) % 5 + 1;
+    sched.add(weight, p);
+    auto q = pick_and_add_sched.pickAndAdd([weight](const uint32_t&) { return weight; });
+    EXPECT_EQ(*p, *q);
+  }
+}
+
+// Validate that pickAndAdd() skips and drops expired entries.
+TEST(EdfSchedulerTest, PickAndAddExpired) {
+  EdfScheduler<uint32_t> sched;
+  auto first_entry = std::make_shared<uint32_t>(37);
+  auto second_entry = std::make_shared<uint32_t>(41);
+
+  sched.add(2, first_entry);
+  sched.add(1, second_entry);
+  first_entry.reset();
+
+  const auto weight = [](const uint32_t&) { return 1; };
+  EXPECT_EQ(41, *sched.pickAndAdd(weight));
+  EXPECT_EQ(41, *sched.pickAndAdd(weight));
+  second_entry.reset();
+  EXPECT_EQ(nullptr, sched.pickAndAdd(weight));
+  EXPECT_TRUE(sched.empty());
+}
+
 // Validate that expired entries are ignored.
 TEST(EdfSchedulerTest, Expired) {
   EdfScheduler<uint32_t> sched;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 
 #include "envoy/config/cluster/v3alpha/cluster.pb.h"
@@ -281,6 +282,38 @@ TEST_F(EdsTest, OnConfigUpdateSuccess) {
   EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
 }
 
+// Validate that an unchanged assignment is not applied again.
+TEST_F(EdsTest, OnConfigUpdateUnchanged) {
+  envoy::config::endpoint::v3alpha::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto* socket_address = cluster_load_assignment.add_endpoints()
+                             ->add_lb_endpoints()
+                             ->mutable_endpoint()
+                             ->mutable_address()
+                             ->mutable_socket_address();
+  socket_address->set_address("1.2.3.4");
+  socket_address->set_port_value(80);
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(0UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  const HostSharedPtr host = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0];
+
+  // The resource name is read without unpacking the assignment.
+  ProtobufWkt::Any resource;
+  resource.PackFrom(cluster_load_assignment);
+  EXPECT_EQ("fare", eds_callbacks_->resourceName(resource));
+
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(host, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+
+  socket_address->set_port_value(81);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(81,
+            cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]->address()->ip()->port());
+}
+
 // Validate that delta-style onConfigUpdate() with the expected cluster accepts config.
 TEST_F(EdsTest, DeltaOnConfigUpdateSuccess) {
   envoy::config::endpoint::v3alpha::ClusterLoadAssignment cluster_load_assignment;
@@ -297,6 +330,198 @@ TEST_F(EdsTest, DeltaOnConfigUpdateSuccess) {
   EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
 }
 
+// Validate that incremental endpoints require a delta config source.
+TEST_F(EdsTest, IncrementalEndpointsRequireDelta) {
+  EXPECT_THROW_WITH_MESSAGE(
+      resetCluster(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: EDS
+      lb_policy: ROUND_ROBIN
+      eds_cluster_config:
+        service_name: fare
+        incremental_endpoints: true
+        eds_config:
+          api_config_source:
+            api_type: REST
+            cluster_names:
+            - eds
+            refresh_delay: 1s
+    )EOF",
+                   Cluster::InitializePhase::Secondary),
+      EnvoyException,
+      "cluster: incremental endpoints of cluster name require a DELTA_GRPC EDS config source");
+}
+
+// Validate that the resources of an incremental cluster are applied individually, only updating
+// the priorities they have hosts at.
+TEST_F(EdsTest, IncrementalEndpoints) {
+  resetCluster(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: EDS
+      lb_policy: ROUND_ROBIN
+      eds_cluster_config:
+        service_name: fare
+        incremental_endpoints: true
+        eds_config:
+          api_config_source:
+            api_type: DELTA_GRPC
+            grpc_services:
+              envoy_grpc:
+                cluster_name: eds
+    )EOF",
+               Cluster::InitializePhase::Secondary);
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(std::set<std::string>{"fare/*"}));
+  cluster_->initialize([this] { initialized_ = true; });
+
+  const auto endpoint_resource = [](const std::string& name, const std::string& address,
+                                    uint32_t priority, uint32_t weight) {
+    envoy::config::endpoint::v3alpha::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->set_priority(priority);
+    auto* lb_endpoint = endpoints->add_lb_endpoints();
+    lb_endpoint->mutable_load_balancing_weight()->set_value(weight);
+    auto* socket_address =
+        lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address(address);
+    socket_address->set_port_value(80);
+    envoy::service::discovery::v3alpha::Resource resource;
+    resource.set_name(name);
+    resource.mutable_resource()->PackFrom(cluster_load_assignment);
+    return resource;
+  };
+  const auto hosts = [this](uint32_t priority) {
+    std::vector<std::string> addresses;
+    for (const auto& host : cluster_->prioritySet().hostSetsPerPriority()[priority]->hosts()) {
+      addresses.push_back(host->address()->asString());
+    }
+    std::sort(addresses.begin(), addresses.end());
+    return addresses;
+  };
+  std::vector<uint32_t> updated_priorities;
+  cluster_->prioritySet().addPriorityUpdateCb(
+      [&updated_priorities](uint32_t priority, const HostVector&, const HostVector&) -> void {
+        updated_priorities.push_back(priority);
+      });
+
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> resources;
+  *resources.Add() = endpoint_resource("fare/a", "1.2.3.4", 0, 1);
+  *resources.Add() = endpoint_resource("fare/b", "1.2.3.5", 0, 1);
+  *resources.Add() = endpoint_resource("fare/c", "1.2.3.6", 1, 1);
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate(resources, {}, "v1"));
+  EXPECT_TRUE(initialized_);
+  EXPECT_EQ((std::vector<std::string>{"1.2.3.4:80", "1.2.3.5:80"}), hosts(0));
+  EXPECT_EQ((std::vector<std::string>{"1.2.3.6:80"}), hosts(1));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), updated_priorities);
+  const HostSharedPtr host_c = cluster_->prioritySet().hostSetsPerPriority()[1]->hosts()[0];
+
+  // Removing a resource only updates the priority of its host.
+  updated_priorities.clear();
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "fare/b";
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate({}, removed_resources, "v2"));
+  EXPECT_EQ((std::vector<std::string>{"1.2.3.4:80"}), hosts(0));
+  EXPECT_EQ((std::vector<uint32_t>{0}), updated_priorities);
+
+  // A changed weight is updated in place.
+  updated_priorities.clear();
+  resources.Clear();
+  *resources.Add() = endpoint_resource("fare/c", "1.2.3.6", 1, 5);
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate(resources, {}, "v3"));
+  EXPECT_EQ(host_c, cluster_->prioritySet().hostSetsPerPriority()[1]->hosts()[0]);
+  EXPECT_EQ(5, host_c->weight());
+  EXPECT_TRUE(updated_priorities.empty());
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
+
+  // A resource whose endpoint changes replaces its host.
+  resources.Clear();
+  *resources.Add() = endpoint_resource("fare/a", "1.2.3.7", 0, 1);
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate(resources, {}, "v4"));
+  EXPECT_EQ((std::vector<std::string>{"1.2.3.7:80"}), hosts(0));
+  EXPECT_EQ((std::vector<std::string>{"1.2.3.6:80"}), hosts(1));
+
+  // A resource of another cluster rejects the whole update.
+  resources.Clear();
+  *resources.Add() = endpoint_resource("fare/d", "1.2.3.8", 0, 1);
+  envoy::config::endpoint::v3alpha::ClusterLoadAssignment other_cluster_load_assignment;
+  other_cluster_load_assignment.set_cluster_name("other");
+  auto* other_resource = resources.Add();
+  other_resource->set_name("fare/e");
+  other_resource->mutable_resource()->PackFrom(other_cluster_load_assignment);
+  EXPECT_THROW_WITH_MESSAGE(eds_callbacks_->onConfigUpdate(resources, {}, "v5"), EnvoyException,
+                            "Unexpected EDS cluster (expecting fare): other");
+  EXPECT_EQ((std::vector<std::string>{"1.2.3.7:80"}), hosts(0));
+}
+
+// Validate that the locality weights of an incremental cluster are those of its current resources,
+// dropping the localities of removed resources and the localities a resource no longer has.
+TEST_F(EdsTest, IncrementalEndpointsLocalityWeights) {
+  resetCluster(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: EDS
+      lb_policy: ROUND_ROBIN
+      common_lb_config:
+        locality_weighted_lb_config: {}
+      eds_cluster_config:
+        service_name: fare
+        incremental_endpoints: true
+        eds_config:
+          api_config_source:
+            api_type: DELTA_GRPC
+            grpc_services:
+              envoy_grpc:
+                cluster_name: eds
+    )EOF",
+               Cluster::InitializePhase::Secondary);
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(std::set<std::string>{"fare/*"}));
+  cluster_->initialize([this] { initialized_ = true; });
+
+  const auto endpoint_resource = [](const std::string& name, const std::string& address,
+                                    const std::string& zone, uint32_t locality_weight) {
+    envoy::config::endpoint::v3alpha::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->mutable_locality()->set_zone(zone);
+    endpoints->mutable_load_balancing_weight()->set_value(locality_weight);
+    auto* socket_address = endpoints->add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address(address);
+    socket_address->set_port_value(80);
+    envoy::service::discovery::v3alpha::Resource resource;
+    resource.set_name(name);
+    resource.mutable_resource()->PackFrom(cluster_load_assignment);
+    return resource;
+  };
+  const auto locality_weights = [this]() {
+    const auto& weights = *cluster_->prioritySet().hostSetsPerPriority()[0]->localityWeights();
+    std::vector<uint32_t> sorted_weights(weights.begin(), weights.end());
+    std::sort(sorted_weights.begin(), sorted_weights.end());
+    return sorted_weights;
+  };
+
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> resources;
+  *resources.Add() = endpoint_resource("fare/a", "1.2.3.4", "a", 2);
+  *resources.Add() = endpoint_resource("fare/b", "1.2.3.5", "b", 3);
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate(resources, {}, "v1"));
+  EXPECT_TRUE(initialized_);
+  EXPECT_EQ((std::vector<uint32_t>{2, 3}), locality_weights());
+
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "fare/b";
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate({}, removed_resources, "v2"));
+  EXPECT_EQ((std::vector<uint32_t>{2}), locality_weights());
+
+  resources.Clear();
+  *resources.Add() = endpoint_resource("fare/a", "1.2.3.6", "c", 4);
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate(resources, {}, "v3"));
+  EXPECT_EQ((std::vector<uint32_t>{4}), locality_weights());
+}
+
 // Validate that onConfigUpdate() with no service name accepts config.
 TEST_F(EdsTest, NoServiceNameOnSuccessConfigUpdate) {
   resetCluster(R"EOF(
@@ -3352,6 +3352,184 @@ TEST_F(TcpHealthCheckerImplTest, ConnectionLocalFailure) {
   EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.passive_failure").value());
 }
 
+// Tests that a host of two clusters sharing their health checks is checked by the first one only,
+// and that the other takes over when the host is removed from the first.
+TEST_F(TcpHealthCheckerImplTest, SharedAcrossClusters) {
+  InSequence s;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 1
+    healthy_threshold: 2
+    share_across_clusters: true
+    tcp_health_check:
+      send:
+        text: "01"
+      receive:
+      - text: "02"
+    )EOF";
+
+  health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromV2Yaml(yaml),
+                                                 dispatcher_, runtime_, random_,
+                                                 HealthCheckEventLoggerPtr(event_logger_)));
+  auto other_cluster = std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  auto other_health_checker = std::make_shared<TcpHealthCheckerImpl>(
+      *other_cluster, parseHealthCheckFromV2Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  other_cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(other_cluster->info_, "tcp://127.0.0.1:80")};
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  // The host is already checked for the first cluster.
+  auto* other_interval_timer = new Event::MockTimer(&dispatcher_);
+  auto* other_timeout_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_, _)).Times(0);
+  other_health_checker->start();
+
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  EXPECT_CALL(*event_logger_, logEjectUnhealthy(_, _, _));
+  EXPECT_CALL(*event_logger_, logUnhealthy(_, _, _, true));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(Host::Health::Unhealthy,
+            cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->health());
+  EXPECT_EQ(Host::Health::Unhealthy,
+            other_cluster->prioritySet().getMockHostSet(0)->hosts_[0]->health());
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.failure").value());
+
+  // The second cluster checks the host once it is removed from the first.
+  HostVector removed{cluster_->prioritySet().getMockHostSet(0)->hosts_.back()};
+  cluster_->prioritySet().getMockHostSet(0)->hosts_.clear();
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_, _));
+  cluster_->prioritySet().getMockHostSet(0)->runCallbacks({}, removed);
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+
+  EXPECT_CALL(*other_timeout_timer, disableTimer());
+  EXPECT_CALL(*other_interval_timer, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  Buffer::OwnedImpl response;
+  add_uint8(response, 2);
+  read_filter_->onData(response, false);
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.success").value());
+}
+
+// Tests that the interval timers of the sessions are batched by a single timer.
+TEST_F(TcpHealthCheckerImplTest, IntervalBatching) {
+  Event::SimulatedTimeSystem time_system;
+  InSequence s;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    interval_batching_tick: 0.1s
+    tcp_health_check: {}
+    )EOF";
+
+  auto* wheel_timer = new Event::MockTimer(&dispatcher_);
+  health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromV2Yaml(yaml),
+                                                 dispatcher_, runtime_, random_,
+                                                 HealthCheckEventLoggerPtr(event_logger_)));
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80"),
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:81")};
+  cluster_->info_->stats().upstream_cx_total_.inc();
+
+  // Only the timeout timers are created by the sessions.
+  auto* timeout_timer1 = new Event::MockTimer(&dispatcher_);
+  expectClientCreate();
+  Network::MockClientConnection* connection1 = connection_;
+  EXPECT_CALL(*timeout_timer1, enableTimer(_, _));
+  auto* timeout_timer2 = new Event::MockTimer(&dispatcher_);
+  expectClientCreate();
+  Network::MockClientConnection* connection2 = connection_;
+  EXPECT_CALL(*timeout_timer2, enableTimer(_, _));
+  health_checker_->start();
+
+  // Both intervals end in the same tick, so the wheel timer is only enabled once.
+  EXPECT_CALL(*timeout_timer1, disableTimer());
+  EXPECT_CALL(*wheel_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  connection1->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*timeout_timer2, disableTimer());
+  connection2->raiseEvent(Network::ConnectionEvent::Connected);
+
+  time_system.setMonotonicTime(std::chrono::milliseconds(1000));
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer1, enableTimer(_, _));
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer2, enableTimer(_, _));
+  wheel_timer->invokeCallback();
+  EXPECT_EQ(4UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+}
+
+// With a main thread dispatcher, the host check callbacks are posted to it, and the results
+// reported until it runs them are applied in one batch.
+TEST_F(TcpHealthCheckerImplTest, OffMainThread) {
+  InSequence s;
+
+  setupNoData();
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher;
+  health_checker_->setMainThreadDispatcher(main_thread_dispatcher);
+  std::vector<std::string> checked;
+  health_checker_->addHostCheckCompleteCb(
+      [&checked](HostSharedPtr host, HealthTransition) -> void {
+        checked.push_back(host->address()->asString());
+      });
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80"),
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:81")};
+
+  expectSessionCreate();
+  Event::MockTimer* interval_timer1 = interval_timer_;
+  Event::MockTimer* timeout_timer1 = timeout_timer_;
+  expectClientCreate();
+  Network::MockClientConnection* connection1 = connection_;
+  EXPECT_CALL(*timeout_timer1, enableTimer(_, _));
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  Event::PostCb post_cb;
+  EXPECT_CALL(main_thread_dispatcher, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  EXPECT_CALL(*timeout_timer1, disableTimer());
+  EXPECT_CALL(*interval_timer1, enableTimer(_, _));
+  connection1->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_TRUE(checked.empty());
+
+  post_cb();
+  EXPECT_EQ((std::vector<std::string>{"127.0.0.1:80", "127.0.0.1:81"}), checked);
+
+  // The callbacks are not run once the health checker is gone.
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer1, enableTimer(_, _));
+  interval_timer1->invokeCallback();
+  EXPECT_CALL(main_thread_dispatcher, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  EXPECT_CALL(*timeout_timer1, disableTimer());
+  EXPECT_CALL(*interval_timer1, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  health_checker_.reset();
+  post_cb();
+  EXPECT_EQ(2UL, checked.size());
+}
+
 class TestGrpcHealthCheckerImpl : public GrpcHealthCheckerImpl {
 public:
   using GrpcHealthCheckerImpl::GrpcHealthCheckerImpl;
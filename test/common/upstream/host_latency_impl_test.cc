@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cmath>
+
+#include "common/upstream/host_latency_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class HostLatencyImplTest : public testing::Test {
+public:
+  void record(std::chrono::microseconds latency) {
+    latency_.recordLatency(latency, time_system_.monotonicTime());
+  }
+  double peakEwma() { return latency_.peakEwma(time_system_.monotonicTime()); }
+
+  Event::SimulatedTimeSystem time_system_;
+  HostLatencyImpl latency_{std::chrono::seconds(1)};
+};
+
+TEST_F(HostLatencyImplTest, NoLatency) {
+  EXPECT_EQ(0, peakEwma());
+  time_system_.sleep(std::chrono::seconds(10));
+  EXPECT_EQ(0, peakEwma());
+}
+
+TEST_F(HostLatencyImplTest, PeakReplacesAverage) {
+  record(std::chrono::microseconds(100));
+  EXPECT_EQ(100, peakEwma());
+  record(std::chrono::microseconds(1000));
+  EXPECT_EQ(1000, peakEwma());
+}
+
+TEST_F(HostLatencyImplTest, LowerLatenciesAreAveraged) {
+  record(std::chrono::microseconds(1000));
+
+  // Without elapsed time the previous average keeps all its weight.
+  record(std::chrono::microseconds(100));
+  EXPECT_EQ(1000, peakEwma());
+
+  // After the decay time the previous average keeps a weight of 1/e.
+  time_system_.sleep(std::chrono::seconds(1));
+  record(std::chrono::microseconds(100));
+  EXPECT_NEAR(1000 / M_E + 100 * (1 - 1 / M_E), peakEwma(), 0.001);
+}
+
+TEST_F(HostLatencyImplTest, DecaysWithoutLatencies) {
+  record(std::chrono::microseconds(1000));
+  time_system_.sleep(std::chrono::seconds(2));
+  EXPECT_NEAR(1000 / (M_E * M_E), peakEwma(), 0.001);
+
+  // Reading does not change the average.
+  EXPECT_NEAR(1000 / (M_E * M_E), peakEwma(), 0.001);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
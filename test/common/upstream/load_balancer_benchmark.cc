@@ -40,6 +40,29 @@ public:
                                     {}, hosts, {}, absl::nullopt);
   }
 
+  // Replace the first churn_percent of the hosts of priority 0 with new hosts. With a churn of 0,
+  // an update with unchanged hosts is delivered, as happens e.g. for metadata only changes.
+  void churnHosts(uint32_t churn_percent) {
+    HostVector hosts = priority_set_.hostSetsPerPriority()[0]->hosts();
+    HostVector hosts_added;
+    HostVector hosts_removed;
+    const uint64_t num_churned = hosts.size() * (churn_percent / 100.0);
+    for (uint64_t i = 0; i < num_churned; i++) {
+      hosts_removed.push_back(hosts[i]);
+      hosts[i] = makeTestHost(
+          info_, fmt::format("tcp://10.{}.{}.{}:6379", 1 + churn_rounds_ % 254, i / 256, i % 256));
+      hosts_added.push_back(hosts[i]);
+    }
+    churn_rounds_++;
+
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    priority_set_.updateHosts(0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {},
+                              hosts_added, hosts_removed, absl::nullopt);
+  }
+
+  uint64_t churn_rounds_{};
+
   PrioritySetImpl priority_set_;
   PrioritySetImpl local_priority_set_;
   Stats::IsolatedStoreImpl stats_store_;
@@ -199,6 +222,45 @@ BENCHMARK(BM_MaglevLoadBalancerBuildTable)
     ->Arg(500)
     ->Unit(benchmark::kMillisecond);
 
+void BM_RingHashLoadBalancerChurn(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const uint64_t churn_percent = state.range(2);
+  RingHashTester tester(num_hosts, min_ring_size);
+  tester.ring_hash_lb_->initialize();
+  for (auto _ : state) {
+    // Each update rebuilds the ring as needed, which is what is timed.
+    tester.churnHosts(churn_percent);
+  }
+}
+BENCHMARK(BM_RingHashLoadBalancerChurn)
+    ->Args({100, 65536, 0})
+    ->Args({100, 65536, 1})
+    ->Args({100, 65536, 10})
+    ->Args({500, 256000, 0})
+    ->Args({500, 256000, 1})
+    ->Args({500, 256000, 10})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MaglevLoadBalancerChurn(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t churn_percent = state.range(1);
+  MaglevTester tester(num_hosts);
+  tester.maglev_lb_->initialize();
+  for (auto _ : state) {
+    // Each update rebuilds the table as needed, which is what is timed.
+    tester.churnHosts(churn_percent);
+  }
+}
+BENCHMARK(BM_MaglevLoadBalancerChurn)
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({100, 10})
+    ->Args({500, 0})
+    ->Args({500, 1})
+    ->Args({500, 10})
+    ->Unit(benchmark::kMillisecond);
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   // Upstream::LoadBalancerContext
@@ -227,6 +289,30 @@ void computeHitStats(benchmark::State& state,
   state.counters["relative_stddev_hits"] = (stddev / mean);
 }
 
+void BM_RoundRobinLoadBalancerChooseHost(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t weighted_subset_percent = state.range(1);
+    const uint64_t weight = state.range(2);
+    const uint64_t keys_to_simulate = state.range(3);
+    RoundRobinTester tester(num_hosts, weighted_subset_percent, weight);
+    tester.initialize();
+    TestLoadBalancerContext context;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; ++i) {
+      benchmark::DoNotOptimize(tester.lb_->chooseHost(&context));
+    }
+  }
+}
+BENCHMARK(BM_RoundRobinLoadBalancerChooseHost)
+    ->Args({500, 0, 1, 1000000})
+    ->Args({500, 50, 50, 1000000})
+    ->Args({500, 100, 50, 1000000})
+    ->Args({10000, 50, 50, 1000000})
+    ->Unit(benchmark::kMillisecond);
+
 void BM_LeastRequestLoadBalancerChooseHost(benchmark::State& state) {
   for (auto _ : state) {
     state.PauseTiming();
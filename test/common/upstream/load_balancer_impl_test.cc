@@ -13,6 +13,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -1482,6 +1483,100 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, LeastRequestLoadBalancerTest,
                          ::testing::Values(true, false));
 
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void recordLatency(const HostSharedPtr& host, std::chrono::milliseconds latency) {
+    host->latency().recordLatency(latency, time_system_.monotonicTime());
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  PeakEwmaLoadBalancer lb_{priority_set_, nullptr,      stats_,         runtime_,
+                           random_,       time_system_, common_config_, absl::nullopt};
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) { EXPECT_EQ(nullptr, lb_.chooseHost(nullptr)); }
+
+TEST_P(PeakEwmaLoadBalancerTest, Normal) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                              makeTestHost(info_, "tcp://127.0.0.1:81")};
+  stats_.max_host_weight_.set(1UL);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // The host with the lower latency is chosen, even with more active requests.
+  recordLatency(hostSet().healthy_hosts_[0], std::chrono::milliseconds(10));
+  recordLatency(hostSet().healthy_hosts_[1], std::chrono::milliseconds(100));
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(2);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+
+  // Unless the active requests outweigh the latency.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(20);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, HostWithoutLatency) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                              makeTestHost(info_, "tcp://127.0.0.1:81")};
+  stats_.max_host_weight_.set(1UL);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // A new host is tried first.
+  recordLatency(hostSet().healthy_hosts_[0], std::chrono::milliseconds(10));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // But is avoided until it responds.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, HostCost) {
+  HostSharedPtr host = makeTestHost(info_, "tcp://127.0.0.1:80");
+  EXPECT_EQ(0, PeakEwmaLoadBalancer::hostCost(*host, time_system_.monotonicTime()));
+  host->stats().rq_active_.set(2);
+  EXPECT_EQ(2 * PeakEwmaLoadBalancer::kPenalty,
+            PeakEwmaLoadBalancer::hostCost(*host, time_system_.monotonicTime()));
+
+  recordLatency(host, std::chrono::milliseconds(10));
+  EXPECT_EQ(30000, PeakEwmaLoadBalancer::hostCost(*host, time_system_.monotonicTime()));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, WeightImbalance) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 2)};
+  stats_.max_host_weight_.set(2UL);
+
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+
+  // Without latencies we should see 2:1 ratio for hosts[1] to hosts[0].
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // A latency twice as high on hosts[1] should yield a 1:1 ratio.
+  recordLatency(hostSet().healthy_hosts_[0], std::chrono::milliseconds(10));
+  recordLatency(hostSet().healthy_hosts_[1], std::chrono::milliseconds(20));
+  uint32_t host_1_picks = 0;
+  for (uint32_t i = 0; i < 100; ++i) {
+    if (lb_.chooseHost(nullptr) == hostSet().healthy_hosts_[1]) {
+      host_1_picks++;
+    }
+  }
+  EXPECT_GE(host_1_picks, 45);
+  EXPECT_LE(host_1_picks, 55);
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(true, false));
+
 class RandomLoadBalancerTest : public LoadBalancerTestBase {
 public:
   void init() {
@@ -8,6 +8,7 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
+#include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
@@ -20,6 +21,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 
 // The tests in this file provide just coverage over some corner cases in error handling. The test
 // for the happy path for LoadStatsReporter is provided in //test/integration:load_stats_reporter.
@@ -217,6 +219,63 @@ TEST_F(LoadStatsReporterTest, ExistingClusters) {
   response_timer_cb_();
 }
 
+// Validate that the hosts of a cluster are only reported on when the cluster had requests.
+TEST_F(LoadStatsReporterTest, HostStats) {
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage({});
+  createLoadStatsReporter();
+  time_system_.setMonotonicTime(std::chrono::microseconds(3));
+  NiceMock<MockClusterMockPrioritySet> foo_cluster;
+  envoy::config::core::v3alpha::Locality locality;
+  locality.set_zone("zone");
+  auto host = std::make_shared<NiceMock<MockHost>>();
+  ON_CALL(*host, locality()).WillByDefault(ReturnRef(locality));
+  auto* host_set = foo_cluster.prioritySet().getMockHostSet(0);
+  host_set->hosts_ = {host};
+  host_set->hosts_per_locality_ = makeHostsPerLocality({{host}});
+  MockClusterManager::ClusterInfoMap cluster_info{{"foo", foo_cluster}};
+  ON_CALL(cm_, clusters()).WillByDefault(Return(cluster_info));
+  // Traffic before reporting on foo starts is not reported.
+  host->stats_.rq_success_.inc();
+  foo_cluster.info_->stats_.upstream_rq_total_.inc();
+  deliverLoadStatsResponse({"foo"});
+
+  const auto expect_foo_stats = [this, &locality](uint64_t microseconds, uint64_t rq_success,
+                                                  uint64_t rq_error, uint64_t rq_issued) {
+    envoy::config::endpoint::v3alpha::ClusterStats foo_cluster_stats;
+    foo_cluster_stats.set_cluster_name("foo");
+    if (rq_success + rq_error != 0) {
+      auto* locality_stats = foo_cluster_stats.add_upstream_locality_stats();
+      locality_stats->mutable_locality()->MergeFrom(locality);
+      locality_stats->set_total_successful_requests(rq_success);
+      locality_stats->set_total_error_requests(rq_error);
+      locality_stats->set_total_issued_requests(rq_issued);
+    }
+    foo_cluster_stats.mutable_load_report_interval()->MergeFrom(
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(microseconds));
+    expectSendMessage({foo_cluster_stats});
+    EXPECT_CALL(*response_timer_, enableTimer(std::chrono::milliseconds(42000), _));
+    response_timer_cb_();
+  };
+
+  host->stats_.rq_total_.add(2);
+  host->stats_.rq_success_.add(2);
+  foo_cluster.info_->stats_.upstream_rq_total_.add(2);
+  time_system_.setMonotonicTime(std::chrono::microseconds(4));
+  expect_foo_stats(1, 2, 0, 2);
+
+  // Without any request on the cluster, its hosts are not looked at.
+  host->stats_.rq_error_.inc();
+  time_system_.setMonotonicTime(std::chrono::microseconds(6));
+  expect_foo_stats(2, 0, 0, 0);
+
+  // Nothing is lost, the host stats being reported with the next request on the cluster.
+  host->stats_.rq_total_.inc();
+  foo_cluster.info_->stats_.upstream_rq_total_.inc();
+  time_system_.setMonotonicTime(std::chrono::microseconds(10));
+  expect_foo_stats(4, 0, 1, 1);
+}
+
 // Validate that the client can recover from a remote stream closure via retry.
 TEST_F(LoadStatsReporterTest, RemoteStreamClose) {
   EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
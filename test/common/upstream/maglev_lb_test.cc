@@ -81,6 +81,40 @@ TEST_F(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// The table of a priority is only rebuilt when its hosts or weights change.
+TEST_F(MaglevLoadBalancerTest, RebuildOnlyOnChange) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90"),
+                      makeTestHost(info_, "tcp://127.0.0.1:91")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init(7);
+  EXPECT_EQ(3, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(4, lb_->stats().max_entries_per_host_.value());
+
+  // Building a table sets the gauges, so a sentinel value shows whether the table was rebuilt.
+  stats_store_.gauge("maglev_lb.min_entries_per_host", Stats::Gauge::ImportMode::Accumulate)
+      .set(100);
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(100, lb_->stats().min_entries_per_host_.value());
+
+  // An update of another priority does not rebuild this one either.
+  MockHostSet& host_set_1 = *priority_set_.getMockHostSet(1);
+  host_set_1.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:92")};
+  host_set_1.healthy_hosts_ = host_set_1.hosts_;
+  host_set_1.runCallbacks(host_set_1.hosts_, {});
+  EXPECT_EQ(7, lb_->stats().min_entries_per_host_.value());
+  stats_store_.gauge("maglev_lb.min_entries_per_host", Stats::Gauge::ImportMode::Accumulate)
+      .set(100);
+  host_set_1.runCallbacks({}, {});
+  EXPECT_EQ(100, lb_->stats().min_entries_per_host_.value());
+
+  host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:93"));
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({host_set_.hosts_.back()}, {});
+  EXPECT_EQ(2, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(3, lb_->stats().max_entries_per_host_.value());
+}
+
 // Weighted sanity test.
 TEST_F(MaglevLoadBalancerTest, Weighted) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", 1),
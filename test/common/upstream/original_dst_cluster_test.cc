@@ -410,6 +410,51 @@ TEST_F(OriginalDstClusterTest, Membership2) {
   EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
 }
 
+// Hosts created before the main thread gets to add them are added at once, and a load balancer
+// reuses the hosts it created until then.
+TEST_F(OriginalDstClusterTest, QueuedHosts) {
+  std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 1.250s
+    type: ORIGINAL_DST
+    lb_policy: ORIGINAL_DST_LB
+  )EOF";
+
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_, _));
+  setupFromYaml(yaml);
+
+  NiceMock<Network::MockConnection> connection1;
+  TestLoadBalancerContext lb_context1(&connection1);
+  connection1.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.10.11.11");
+  EXPECT_CALL(connection1, localAddressRestored()).WillRepeatedly(Return(true));
+
+  NiceMock<Network::MockConnection> connection2;
+  TestLoadBalancerContext lb_context2(&connection2);
+  connection2.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.10.11.12");
+  EXPECT_CALL(connection2, localAddressRestored()).WillRepeatedly(Return(true));
+
+  OriginalDstCluster::LoadBalancer lb1(cluster_);
+  OriginalDstCluster::LoadBalancer lb2(cluster_);
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  HostConstSharedPtr host1 = lb1.chooseHost(&lb_context1);
+  ASSERT_NE(host1, nullptr);
+  EXPECT_EQ(host1, lb1.chooseHost(&lb_context1));
+  HostConstSharedPtr host2 = lb1.chooseHost(&lb_context2);
+  ASSERT_NE(host2, nullptr);
+  // Another load balancer creates its own host for the same destination, which is not added.
+  HostConstSharedPtr host3 = lb2.chooseHost(&lb_context1);
+  ASSERT_NE(host3, nullptr);
+  EXPECT_NE(host1, host3);
+
+  EXPECT_CALL(membership_updated_, ready());
+  post_cb();
+  ASSERT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(host1, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+  EXPECT_EQ(host2, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[1]);
+}
+
 TEST_F(OriginalDstClusterTest, Connection) {
   std::string yaml = R"EOF(
     name: name
@@ -1442,7 +1442,9 @@ TEST_F(OutlierDetectorImplTest, Consecutive_5xxAlreadyEjected) {
   loadRq(hosts_[0], 1, 500);
   EXPECT_TRUE(hosts_[0]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
 
-  // Cause another consecutive 5xx error.
+  // Cause another consecutive 5xx error. The host is already ejected so nothing is posted to the
+  // main thread.
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
   loadRq(hosts_[0], 1, 200);
   loadRq(hosts_[0], 5, 500);
 }
@@ -1563,6 +1565,25 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
   Json::Factory::loadFromString(log6);
 }
 
+TEST(SuccessRateMonitorTest, SuccessRateAndVolume) {
+  SuccessRateMonitor monitor(envoy::data::cluster::v2alpha::SUCCESS_RATE);
+  for (int i = 0; i < 3; i++) {
+    monitor.incSuccessReqCounter();
+  }
+  monitor.incFailedReqCounter();
+
+  // The requests are only reported once the bucket is swapped.
+  EXPECT_FALSE(monitor.successRateAccumulator().getSuccessRateAndVolume().has_value());
+  monitor.updateCurrentSuccessRateBucket();
+  auto success_rate_and_volume = monitor.successRateAccumulator().getSuccessRateAndVolume();
+  ASSERT_TRUE(success_rate_and_volume.has_value());
+  EXPECT_EQ(75.0, success_rate_and_volume.value().first);
+  EXPECT_EQ(4UL, success_rate_and_volume.value().second);
+
+  monitor.updateCurrentSuccessRateBucket();
+  EXPECT_FALSE(monitor.successRateAccumulator().getSuccessRateAndVolume().has_value());
+}
+
 TEST(OutlierUtility, SRThreshold) {
   std::vector<HostSuccessRatePair> data = {
       HostSuccessRatePair(nullptr, 50),  HostSuccessRatePair(nullptr, 100),
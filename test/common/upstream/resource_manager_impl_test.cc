@@ -5,6 +5,7 @@
 
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -28,7 +29,7 @@ TEST(ResourceManagerImplTest, RuntimeResourceManager) {
       runtime, "circuit_breakers.runtime_resource_manager_test.default.", 0, 0, 0, 1, 0,
       ClusterCircuitBreakersStats{
           ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))},
-      absl::nullopt, absl::nullopt);
+      absl::nullopt, absl::nullopt, false);
 
   EXPECT_CALL(
       runtime.snapshot_,
@@ -86,7 +87,7 @@ TEST(ResourceManagerImplTest, RemainingResourceGauges) {
       ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))};
   ResourceManagerImpl resource_manager(runtime,
                                        "circuit_breakers.runtime_resource_manager_test.default.", 1,
-                                       2, 1, 0, 3, stats, absl::nullopt, absl::nullopt);
+                                       2, 1, 0, 3, stats, absl::nullopt, absl::nullopt, false);
 
   // Test remaining_cx_ gauge
   EXPECT_EQ(1U, resource_manager.connections().max());
@@ -153,7 +154,7 @@ TEST(ResourceManagerImplTest, RetryBudgetOverrideGauge) {
 
   // Test retry budgets disable remaining_retries gauge (it should always be 0).
   ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 1, 2,
-                         1, 0, 3, stats, 20.0, 5);
+                         1, 0, 3, stats, 20.0, 5, false);
 
   EXPECT_EQ(5U, rm.retries().max());
   EXPECT_EQ(0U, stats.remaining_retries_.value());
@@ -163,6 +164,125 @@ TEST(ResourceManagerImplTest, RetryBudgetOverrideGauge) {
   EXPECT_EQ(0U, stats.remaining_retries_.value());
   rm.retries().dec();
 }
+
+TEST(ResourceManagerImplTest, TryInc) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = ClusterCircuitBreakersStats{
+      ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))};
+  ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 2, 2,
+                         2, 1, 2, stats, absl::nullopt, absl::nullopt, false);
+
+  EXPECT_TRUE(rm.connections().tryInc());
+  EXPECT_EQ(1U, rm.connections().count());
+  EXPECT_EQ(1U, stats.remaining_cx_.value());
+  EXPECT_EQ(0U, stats.cx_open_.value());
+  EXPECT_TRUE(rm.connections().tryInc());
+  EXPECT_EQ(1U, stats.cx_open_.value());
+  EXPECT_FALSE(rm.connections().tryInc());
+  EXPECT_EQ(2U, rm.connections().count());
+  rm.connections().decBy(2);
+
+  EXPECT_TRUE(rm.retries().tryInc());
+  EXPECT_FALSE(rm.retries().tryInc());
+  EXPECT_EQ(1U, rm.retries().count());
+  rm.retries().dec();
+}
+
+TEST(ResourceManagerImplTest, RetryBudgetTryInc) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = ClusterCircuitBreakersStats{
+      ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))};
+  ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 100,
+                         100, 100, 0, 100, stats, 20.0, 2, false);
+
+  // Without active requests, the budget is the min retry concurrency.
+  EXPECT_TRUE(rm.retries().tryInc());
+  EXPECT_TRUE(rm.retries().tryInc());
+  EXPECT_FALSE(rm.retries().tryInc());
+
+  // 20% of the 20 active requests.
+  for (uint64_t i = 0; i < 20; i++) {
+    rm.requests().inc();
+  }
+  EXPECT_TRUE(rm.retries().tryInc());
+  EXPECT_TRUE(rm.retries().tryInc());
+  EXPECT_FALSE(rm.retries().tryInc());
+  EXPECT_EQ(4U, rm.retries().count());
+  EXPECT_EQ(0U, stats.remaining_retries_.value());
+
+  rm.retries().decBy(4);
+  rm.requests().decBy(20);
+}
+
+// With striped counters, the counts of a stripe are only added to the cluster wide count, and the
+// gauges, once they have changed by a batch.
+TEST(ResourceManagerImplTest, StripedCounters) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = ClusterCircuitBreakersStats{
+      ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))};
+  // The batch is 1024 / 16 / 16 = 4.
+  ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 1024,
+                         2, 1024, 1, 1, stats, absl::nullopt, absl::nullopt, true);
+
+  for (uint64_t i = 0; i < 3; i++) {
+    rm.requests().inc();
+  }
+  EXPECT_EQ(3U, rm.requests().count());
+  EXPECT_EQ(1024U, stats.remaining_rq_.value());
+  rm.requests().inc();
+  EXPECT_EQ(4U, rm.requests().count());
+  EXPECT_EQ(1020U, stats.remaining_rq_.value());
+  rm.requests().decBy(4);
+  EXPECT_EQ(0U, rm.requests().count());
+  EXPECT_EQ(1024U, stats.remaining_rq_.value());
+
+  // A batch of 1 is as exact as without stripes.
+  EXPECT_TRUE(rm.pendingRequests().tryInc());
+  EXPECT_EQ(0U, stats.rq_pending_open_.value());
+  EXPECT_TRUE(rm.pendingRequests().tryInc());
+  EXPECT_EQ(1U, stats.rq_pending_open_.value());
+  EXPECT_FALSE(rm.pendingRequests().tryInc());
+  EXPECT_FALSE(rm.pendingRequests().canCreate());
+  EXPECT_EQ(2U, rm.pendingRequests().count());
+  rm.pendingRequests().decBy(2);
+  EXPECT_EQ(0U, stats.rq_pending_open_.value());
+
+  // The connection pools and retries are never striped.
+  EXPECT_TRUE(rm.connectionPools().tryInc());
+  EXPECT_FALSE(rm.connectionPools().tryInc());
+  rm.connectionPools().dec();
+}
+
+// A resource counted by a thread may be released by another, whose stripe is then transiently
+// negative.
+TEST(ResourceManagerImplTest, StripedCountersAcrossThreads) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = ClusterCircuitBreakersStats{
+      ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))};
+  ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 1024,
+                         1024, 1024, 1, 1, stats, absl::nullopt, absl::nullopt, true);
+
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&rm]() {
+    for (uint64_t i = 0; i < 3; i++) {
+      rm.connections().inc();
+    }
+  });
+  thread->join();
+  EXPECT_EQ(3U, rm.connections().count());
+
+  rm.connections().decBy(3);
+  EXPECT_EQ(0U, rm.connections().count());
+  EXPECT_TRUE(rm.connections().canCreate());
+  EXPECT_EQ(1024U, stats.remaining_cx_.value());
+}
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
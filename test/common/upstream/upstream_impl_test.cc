@@ -32,6 +32,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -1033,6 +1034,41 @@ TEST(HostImplTest, HostnameCanaryAndLocality) {
   EXPECT_EQ(1, host.priority());
 }
 
+// The hosts with the same metadata and locality share them.
+TEST(HostImplTest, SharedMetadataAndLocality) {
+  MockClusterMockPrioritySet cluster;
+  envoy::config::core::v3alpha::Metadata metadata;
+  Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                         "version")
+      .set_string_value("1.0");
+  envoy::config::core::v3alpha::Locality locality;
+  locality.set_zone("hello");
+  HostImpl host1(cluster.info_, "", Network::Utility::resolveUrl("tcp://10.0.0.1:1234"), metadata,
+                 1, locality,
+                 envoy::config::endpoint::v3alpha::Endpoint::HealthCheckConfig::default_instance(),
+                 0, envoy::config::core::v3alpha::UNKNOWN);
+  HostImpl host2(cluster.info_, "", Network::Utility::resolveUrl("tcp://10.0.0.2:1234"), metadata,
+                 1, locality,
+                 envoy::config::endpoint::v3alpha::Endpoint::HealthCheckConfig::default_instance(),
+                 0, envoy::config::core::v3alpha::UNKNOWN);
+  EXPECT_EQ(host1.metadata(), host2.metadata());
+  EXPECT_EQ(&host1.locality(), &host2.locality());
+  EXPECT_EQ("hello", host2.locality().zone());
+
+  envoy::config::core::v3alpha::Metadata new_metadata = metadata;
+  Config::Metadata::mutableMetadataValue(new_metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                         "version")
+      .set_string_value("1.1");
+  host2.metadata(new_metadata);
+  EXPECT_NE(host1.metadata(), host2.metadata());
+  EXPECT_TRUE(TestUtility::protoEqual(new_metadata, *host2.metadata()));
+  EXPECT_TRUE(TestUtility::protoEqual(metadata, *host1.metadata()));
+
+  // The metadata updated back is shared again.
+  host2.metadata(metadata);
+  EXPECT_EQ(host1.metadata(), host2.metadata());
+}
+
 TEST(HostImplTest, HealthFlags) {
   MockClusterMockPrioritySet cluster;
   HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", 1);
@@ -1908,6 +1944,24 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+TEST_F(ClusterInfoImplTest, PeakEwmaLbConfig) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: PEAK_EWMA
+    peak_ewma_lb_config:
+      decay_time: 5s
+      choice_count: 3
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(LoadBalancerType::PeakEwma, cluster->info()->lbType());
+  EXPECT_EQ(5, cluster->info()->lbPeakEwmaConfig()->decay_time().seconds());
+  EXPECT_EQ(3, cluster->info()->lbPeakEwmaConfig()->choice_count().value());
+}
+
 // Eds service_name is populated.
 TEST_F(ClusterInfoImplTest, EdsServiceNamePopulation) {
   const std::string yaml = R"EOF(
@@ -2127,6 +2181,30 @@ TEST_F(ClusterInfoImplTest, TestTrackTimeoutBudgets) {
             cluster->info()->timeoutBudgetStats()->upstream_rq_timeout_budget_percent_used_.unit());
 }
 
+// With the runtime feature enabled, cluster stats are only created when first written to.
+TEST_F(ClusterInfoImplTest, LazyClusterStats) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.lazy_cluster_stats", "true"}});
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    track_timeout_budgets: true
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(nullptr, TestUtility::findCounter(stats_, "cluster.name.upstream_cx_total"));
+  EXPECT_EQ(0U, cluster->info()->stats().upstream_cx_total_.value());
+  EXPECT_EQ(Stats::Histogram::Unit::Unspecified,
+            cluster->info()->timeoutBudgetStats()->upstream_rq_timeout_budget_percent_used_.unit());
+
+  cluster->info()->stats().upstream_cx_total_.inc();
+  EXPECT_EQ(1U, cluster->info()->stats().upstream_cx_total_.value());
+  EXPECT_EQ(1U, TestUtility::findCounter(stats_, "cluster.name.upstream_cx_total")->value());
+}
+
 class TestFilterConfigFactoryBase {
 public:
   TestFilterConfigFactoryBase(
@@ -137,6 +137,27 @@ TEST(FileAccessLogConfigTest, FileAccessLogTypedJsonTest) {
   EXPECT_NE(nullptr, dynamic_cast<FileAccessLog*>(log.get()));
 }
 
+TEST(FileAccessLogConfigTest, FileAccessLogDelimitedProtoTest) {
+  envoy::config::accesslog::v3alpha::AccessLog config;
+
+  envoy::extensions::access_loggers::file::v3alpha::FileAccessLog fal_config;
+  fal_config.set_path("/dev/null");
+  fal_config.mutable_delimited_proto_format()->add_additional_request_headers_to_log("x-foo");
+
+  EXPECT_EQ(fal_config.access_log_format_case(),
+            envoy::extensions::access_loggers::file::v3alpha::FileAccessLog::AccessLogFormatCase::
+                kDelimitedProtoFormat);
+  config.mutable_typed_config()->PackFrom(fal_config);
+
+  config.set_name(AccessLogNames::get().File);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  AccessLog::InstanceSharedPtr log = AccessLog::AccessLogFactory::fromProto(config, context);
+
+  EXPECT_NE(nullptr, log);
+  EXPECT_NE(nullptr, dynamic_cast<FileAccessLog*>(log.get()));
+}
+
 TEST(FileAccessLogConfigTest, FileAccessLogJsonWithBoolValueTest) {
   {
     // Make sure we fail if you set a bool value in the format dictionary
@@ -0,0 +1,229 @@
+#include "envoy/data/accesslog/v3alpha/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/file/v3alpha/file.pb.h"
+
+#include "common/network/address_impl.h"
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/file/delimited_proto_formatter.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+namespace {
+
+using envoy::data::accesslog::v3alpha::HTTPAccessLogEntry;
+
+class DelimitedProtoFormatterTest : public testing::Test {
+public:
+  DelimitedProtoFormatterTest() { stream_info_.start_time_ = SystemTime(1h); }
+
+  // Parses the entries written to the output, each preceded by its size.
+  std::vector<HTTPAccessLogEntry> parseEntries(const std::string& output) {
+    std::vector<HTTPAccessLogEntry> entries;
+    Protobuf::io::ArrayInputStream input(output.data(), output.size());
+    Protobuf::io::CodedInputStream coded_input(&input);
+    uint32_t size;
+    while (coded_input.ReadVarint32(&size)) {
+      const auto limit = coded_input.PushLimit(size);
+      entries.emplace_back();
+      EXPECT_TRUE(entries.back().ParseFromCodedStream(&coded_input));
+      EXPECT_TRUE(coded_input.ConsumedEntireMessage());
+      coded_input.PopLimit(limit);
+    }
+    EXPECT_EQ(static_cast<int>(output.size()), coded_input.CurrentPosition());
+    return entries;
+  }
+
+  void expectEntry(const std::string& output, const std::string& expected_entry_yaml) {
+    HTTPAccessLogEntry expected_entry;
+    TestUtility::loadFromYaml(expected_entry_yaml, expected_entry);
+    const std::vector<HTTPAccessLogEntry> entries = parseEntries(output);
+    ASSERT_EQ(1UL, entries.size());
+    EXPECT_EQ(expected_entry.DebugString(), entries[0].DebugString());
+  }
+
+  envoy::extensions::access_loggers::file::v3alpha::FileAccessLog::DelimitedProtoFormat config_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  Http::TestHeaderMapImpl request_headers_;
+  Http::TestHeaderMapImpl response_headers_;
+  Http::TestHeaderMapImpl response_trailers_;
+};
+
+// Only the fields that are set are written.
+TEST_F(DelimitedProtoFormatterTest, Minimal) {
+  stream_info_.host_ = nullptr;
+  stream_info_.setDownstreamLocalAddress(std::make_shared<Network::Address::PipeInstance>("/foo"));
+  DelimitedProtoFormatter formatter(config_);
+
+  expectEntry(
+      formatter.format(request_headers_, response_headers_, response_trailers_, stream_info_),
+      R"EOF(
+common_properties:
+  downstream_remote_address:
+    socket_address:
+      address: "127.0.0.1"
+  downstream_direct_remote_address:
+    socket_address:
+      address: "127.0.0.1"
+  downstream_local_address:
+    pipe:
+      path: "/foo"
+  start_time:
+    seconds: 3600
+request: {}
+response: {}
+)EOF");
+}
+
+// All the supported fields are written, with the configured headers.
+TEST_F(DelimitedProtoFormatterTest, AllFields) {
+  config_.add_additional_request_headers_to_log("x-custom-request");
+  config_.add_additional_request_headers_to_log("x-absent");
+  config_.add_additional_response_headers_to_log("x-custom-response");
+  config_.add_additional_response_trailers_to_log("x-custom-trailer");
+  DelimitedProtoFormatter formatter(config_);
+
+  stream_info_.last_downstream_rx_byte_received_ = 2ms;
+  stream_info_.first_upstream_tx_byte_sent_ = 4ms;
+  stream_info_.last_upstream_tx_byte_sent_ = 6ms;
+  stream_info_.first_upstream_rx_byte_received_ = 8ms;
+  stream_info_.last_upstream_rx_byte_received_ = 10ms;
+  stream_info_.first_downstream_tx_byte_sent_ = 12ms;
+  stream_info_.last_downstream_tx_byte_sent_ = 2s + 14ms;
+  stream_info_.setUpstreamLocalAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("10.0.0.2", 1234));
+  stream_info_.protocol_ = Http::Protocol::Http2;
+  stream_info_.addBytesReceived(10);
+  stream_info_.addBytesSent(20);
+  stream_info_.response_code_ = 200;
+  stream_info_.response_code_details_ = "via_upstream";
+  stream_info_.upstream_transport_failure_reason_ = "TLS error";
+  stream_info_.setRouteName("route-name-test");
+  ON_CALL(stream_info_, hasAnyResponseFlag()).WillByDefault(Return(true));
+  ON_CALL(stream_info_, hasResponseFlag(StreamInfo::ResponseFlag::FaultInjected))
+      .WillByDefault(Return(true));
+  ON_CALL(stream_info_, hasResponseFlag(StreamInfo::ResponseFlag::UnauthorizedExternalService))
+      .WillByDefault(Return(true));
+
+  request_headers_ = Http::TestHeaderMapImpl{
+      {":scheme", "scheme_value"},
+      {":authority", "authority_value"},
+      {":path", "path_value"},
+      {":method", "POST"},
+      {"user-agent", "user-agent_value"},
+      {"referer", "referer_value"},
+      {"x-forwarded-for", "x-forwarded-for_value"},
+      {"x-request-id", "x-request-id_value"},
+      {"x-envoy-original-path", "x-envoy-original-path_value"},
+      {"x-custom-request", "custom_value"},
+  };
+  response_headers_ =
+      Http::TestHeaderMapImpl{{":status", "200"}, {"x-custom-response", "custom_value"}};
+  response_trailers_ = Http::TestHeaderMapImpl{{"x-custom-trailer", "custom_value"}};
+
+  expectEntry(
+      formatter.format(request_headers_, response_headers_, response_trailers_, stream_info_),
+      R"EOF(
+common_properties:
+  downstream_remote_address:
+    socket_address:
+      address: "127.0.0.1"
+  downstream_direct_remote_address:
+    socket_address:
+      address: "127.0.0.1"
+  downstream_local_address:
+    socket_address:
+      address: "127.0.0.2"
+  start_time:
+    seconds: 3600
+  time_to_last_rx_byte:
+    nanos: 2000000
+  time_to_first_upstream_tx_byte:
+    nanos: 4000000
+  time_to_last_upstream_tx_byte:
+    nanos: 6000000
+  time_to_first_upstream_rx_byte:
+    nanos: 8000000
+  time_to_last_upstream_rx_byte:
+    nanos: 10000000
+  time_to_first_downstream_tx_byte:
+    nanos: 12000000
+  time_to_last_downstream_tx_byte:
+    seconds: 2
+    nanos: 14000000
+  upstream_remote_address:
+    socket_address:
+      address: "10.0.0.1"
+      port_value: 443
+  upstream_local_address:
+    socket_address:
+      address: "10.0.0.2"
+      port_value: 1234
+  upstream_cluster: "fake_cluster"
+  response_flags:
+    fault_injected: true
+    unauthorized_details:
+      reason: EXTERNAL_SERVICE
+  upstream_transport_failure_reason: "TLS error"
+  route_name: "route-name-test"
+protocol_version: HTTP2
+request:
+  request_method: "POST"
+  scheme: "scheme_value"
+  authority: "authority_value"
+  path: "path_value"
+  user_agent: "user-agent_value"
+  referer: "referer_value"
+  forwarded_for: "x-forwarded-for_value"
+  request_id: "x-request-id_value"
+  original_path: "x-envoy-original-path_value"
+  request_headers_bytes: 258
+  request_body_bytes: 10
+  request_headers:
+    "x-custom-request": "custom_value"
+response:
+  response_code:
+    value: 200
+  response_headers_bytes: 39
+  response_body_bytes: 20
+  response_headers:
+    "x-custom-response": "custom_value"
+  response_trailers:
+    "x-custom-trailer": "custom_value"
+  response_code_details: "via_upstream"
+)EOF");
+}
+
+// Entries are appended to the output, so that a file of entries can be read back one at a time.
+TEST_F(DelimitedProtoFormatterTest, AppendsEntries) {
+  DelimitedProtoFormatter formatter(config_);
+
+  // A path long enough for the size of the entry to take several bytes.
+  request_headers_ = Http::TestHeaderMapImpl{{":path", std::string(200, 'a')}};
+  std::string output;
+  formatter.formatTo(request_headers_, response_headers_, response_trailers_, stream_info_, output);
+  request_headers_ = Http::TestHeaderMapImpl{{":path", "/b"}};
+  formatter.formatTo(request_headers_, response_headers_, response_trailers_, stream_info_, output);
+
+  const std::vector<HTTPAccessLogEntry> entries = parseEntries(output);
+  ASSERT_EQ(2UL, entries.size());
+  EXPECT_EQ(std::string(200, 'a'), entries[0].request().path());
+  EXPECT_EQ("/b", entries[1].request().path());
+}
+
+} // namespace
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
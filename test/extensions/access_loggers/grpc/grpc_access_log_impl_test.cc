@@ -7,6 +7,7 @@
 
 #include "common/buffer/zero_copy_input_stream_impl.h"
 #include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "extensions/access_loggers/grpc/http_grpc_access_log_impl.h"
 
@@ -21,6 +22,7 @@ using testing::_;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -36,12 +38,13 @@ public:
   using AccessLogCallbacks =
       Grpc::AsyncStreamCallbacks<envoy::service::accesslog::v3alpha::StreamAccessLogsResponse>;
 
-  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes) {
+  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes,
+                  size_t max_buffer_size_bytes = 1024 * 1024) {
     timer_ = new Event::MockTimer(&dispatcher_);
     EXPECT_CALL(*timer_, enableTimer(buffer_flush_interval_msec, _));
-    logger_ = std::make_unique<GrpcAccessLoggerImpl>(Grpc::RawAsyncClientPtr{async_client_},
-                                                     log_name_, buffer_flush_interval_msec,
-                                                     buffer_size_bytes, dispatcher_, local_info_);
+    logger_ = std::make_unique<GrpcAccessLoggerImpl>(
+        Grpc::RawAsyncClientPtr{async_client_}, log_name_, buffer_flush_interval_msec,
+        buffer_size_bytes, max_buffer_size_bytes, dispatcher_, local_info_, stats_store_);
   }
 
   void expectStreamStart(MockAccessLogStream& stream, AccessLogCallbacks** callbacks_to_set) {
@@ -71,6 +74,7 @@ public:
   Event::MockTimer* timer_ = nullptr;
   Event::MockDispatcher dispatcher_;
   Grpc::MockAsyncClient* async_client_{new Grpc::MockAsyncClient};
+  Stats::IsolatedStoreImpl stats_store_;
   std::unique_ptr<GrpcAccessLoggerImpl> logger_;
 };
 
@@ -241,6 +245,57 @@ TEST_F(GrpcAccessLoggerImplTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Test that log entries are kept while the stream is backed up, and dropped past the limit.
+TEST_F(GrpcAccessLoggerImplTest, BackedUpStream) {
+  InSequence s;
+  initLogger(FlushInterval, 0, 100);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  envoy::data::accesslog::v3alpha::HTTPAccessLogEntry entry;
+  const std::string path1(60, '1');
+  entry.mutable_request()->set_path(path1);
+  logger_->log(envoy::data::accesslog::v3alpha::HTTPAccessLogEntry(entry));
+
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  const std::string path2(60, '2');
+  entry.mutable_request()->set_path(path2);
+  logger_->log(envoy::data::accesslog::v3alpha::HTTPAccessLogEntry(entry));
+
+  // The buffer is full and the stream is still backed up.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  entry.mutable_request()->set_path("/dropped");
+  logger_->log(envoy::data::accesslog::v3alpha::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(1UL, stats_store_.counter("access_logs.grpc_access_log.logs_dropped").value());
+  EXPECT_EQ(0UL, stats_store_.counter("access_logs.grpc_access_log.logs_written").value());
+
+  // The stream drained, the buffered entries are sent on the next flush.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  expectStreamMessage(stream, fmt::format(R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+http_logs:
+  log_entry:
+  - request:
+      path: "{}"
+  - request:
+      path: "{}"
+)EOF",
+                                          path1, path2));
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(1UL, stats_store_.counter("access_logs.grpc_access_log.logs_dropped").value());
+  EXPECT_EQ(2UL, stats_store_.counter("access_logs.grpc_access_log.logs_written").value());
+}
+
 class GrpcAccessLoggerCacheImplTest : public testing::Test {
 public:
   GrpcAccessLoggerCacheImplTest() {
@@ -23,6 +23,7 @@ public:
 
   MOCK_METHOD2(onClusterSlotUpdate, bool(ClusterSlotsPtr&&, Upstream::HostMap));
   MOCK_METHOD0(onHostHealthUpdate, void());
+  MOCK_METHOD1(onSlotsMoved, bool(const Common::Redis::MovedSlots&));
 };
 
 } // namespace Redis
@@ -17,9 +17,13 @@ namespace Redis {
 class TestLoadBalancerContext : public RedisLoadBalancerContext,
                                 public Upstream::LoadBalancerContextBase {
 public:
-  TestLoadBalancerContext(uint64_t hash_key, bool is_read,
-                          NetworkFilters::Common::Redis::Client::ReadPolicy read_policy)
-      : hash_key_(hash_key), is_read_(is_read), read_policy_(read_policy) {}
+  TestLoadBalancerContext(
+      uint64_t hash_key, bool is_read,
+      NetworkFilters::Common::Redis::Client::ReadPolicy read_policy,
+      NetworkFilters::Common::Redis::Client::ReplicaSelection replica_selection =
+          NetworkFilters::Common::Redis::Client::ReplicaSelection::Random)
+      : hash_key_(hash_key), is_read_(is_read), read_policy_(read_policy),
+        replica_selection_(replica_selection) {}
 
   TestLoadBalancerContext(absl::optional<uint64_t> hash) : hash_key_(hash) {}
 
@@ -30,10 +34,15 @@ public:
   NetworkFilters::Common::Redis::Client::ReadPolicy readPolicy() const override {
     return read_policy_;
   };
+  NetworkFilters::Common::Redis::Client::ReplicaSelection replicaSelection() const override {
+    return replica_selection_;
+  };
 
   absl::optional<uint64_t> hash_key_;
   bool is_read_;
   NetworkFilters::Common::Redis::Client::ReadPolicy read_policy_;
+  NetworkFilters::Common::Redis::Client::ReplicaSelection replica_selection_{
+      NetworkFilters::Common::Redis::Client::ReplicaSelection::Random};
 };
 
 class RedisClusterLoadBalancerTest : public testing::Test {
@@ -188,6 +197,48 @@ TEST_F(RedisClusterLoadBalancerTest, ReadStrategiesHealthy) {
                      NetworkFilters::Common::Redis::Client::ReadPolicy::Any);
 }
 
+// With the least request replica selection, the replica with the fewest requests in flight among
+// two random ones is selected.
+TEST_F(RedisClusterLoadBalancerTest, LeastRequestReplicaSelection) {
+  Upstream::HostVector hosts{
+      Upstream::makeTestHost(info_, "tcp://127.0.0.1:90"),
+      Upstream::makeTestHost(info_, "tcp://127.0.0.2:90"),
+      Upstream::makeTestHost(info_, "tcp://127.0.0.3:90"),
+  };
+
+  ClusterSlotsPtr slots = std::make_unique<std::vector<ClusterSlot>>(
+      std::vector<ClusterSlot>{ClusterSlot(0, 16383, hosts[0]->address())});
+  slots->at(0).addReplica(hosts[1]->address());
+  slots->at(0).addReplica(hosts[2]->address());
+  Upstream::HostMap all_hosts;
+  std::transform(hosts.begin(), hosts.end(), std::inserter(all_hosts, all_hosts.end()), makePair);
+  init();
+  factory_->onClusterSlotUpdate(std::move(slots), all_hosts);
+  Upstream::LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(
+      0, true, NetworkFilters::Common::Redis::Client::ReadPolicy::Replica,
+      NetworkFilters::Common::Redis::Client::ReplicaSelection::LeastRequest);
+
+  hosts[1]->stats().rq_active_.set(5);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hosts[2], lb->chooseHost(&context));
+
+  hosts[1]->stats().rq_active_.set(0);
+  hosts[2]->stats().rq_active_.set(5);
+  EXPECT_CALL(random_, random()).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hosts[1], lb->chooseHost(&context));
+
+  // The master is sampled with the replicas by the read policies including it.
+  context.read_policy_ = NetworkFilters::Common::Redis::Client::ReadPolicy::Any;
+  hosts[0]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hosts[0], lb->chooseHost(&context));
+
+  hosts[0]->stats().rq_active_.set(10);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_NE(hosts[0], lb->chooseHost(&context));
+}
+
 TEST_F(RedisClusterLoadBalancerTest, ReadStrategiesUnhealthyMaster) {
   Upstream::HostVector hosts{
       Upstream::makeTestHost(info_, "tcp://127.0.0.1:90"),
@@ -380,6 +431,38 @@ TEST_F(RedisClusterLoadBalancerTest, ClusterSlotNoUpdate) {
   validateAssignment(hosts, expected_assignments);
 }
 
+// The slots moved to a known master are repointed to its shard, while the load balancers created
+// before keep the topology they were created with.
+TEST_F(RedisClusterLoadBalancerTest, ClusterSlotsMoved) {
+  Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90"),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:91")};
+  std::vector<ClusterSlot> slots{ClusterSlot(0, 1000, hosts[0]->address()),
+                                 ClusterSlot(1001, 16383, hosts[1]->address())};
+  Upstream::HostMap all_hosts{{hosts[0]->address()->asString(), hosts[0]},
+                              {hosts[1]->address()->asString(), hosts[1]}};
+  init();
+  EXPECT_FALSE(factory_->onSlotsMoved({{100, "127.0.0.1:91"}}));
+  EXPECT_TRUE(
+      factory_->onClusterSlotUpdate(std::make_unique<std::vector<ClusterSlot>>(slots), all_hosts));
+  Upstream::LoadBalancerPtr original_lb = lb_->factory()->create();
+
+  // Moves to unknown masters, out of range slots and moves to the current shard are ignored.
+  EXPECT_FALSE(factory_->onSlotsMoved(
+      {{100, "127.0.0.1:92"}, {MaxSlot, "127.0.0.1:91"}, {1100, "127.0.0.1:91"}}));
+  EXPECT_TRUE(factory_->onSlotsMoved({{100, "127.0.0.1:91"}, {1100, "127.0.0.1:90"}}));
+  validateAssignment(hosts, {{99, 0}, {100, 1}, {101, 0}, {1100, 0}, {1101, 1}});
+
+  TestLoadBalancerContext context(100, false,
+                                  NetworkFilters::Common::Redis::Client::ReadPolicy::Master);
+  EXPECT_EQ(hosts[0], original_lb->chooseHost(&context));
+
+  // The next discovery restores the discovered slots, even if they did not change since the last
+  // one.
+  EXPECT_TRUE(
+      factory_->onClusterSlotUpdate(std::make_unique<std::vector<ClusterSlot>>(slots), all_hosts));
+  validateAssignment(hosts, {{100, 0}, {1100, 1}});
+}
+
 TEST_F(RedisLoadBalancerContextImplTest, Basic) {
   // Simple read command
   std::vector<NetworkFilters::Common::Redis::RespValue> get_foo(2);
@@ -1,17 +1,29 @@
 #include "envoy/config/cluster/v3alpha/cluster.pb.h"
 #include "envoy/extensions/common/dynamic_forward_proxy/v3alpha/dns_cache.pb.h"
 
+#include "common/filesystem/file_shared_impl.h"
+
 #include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 #include "extensions/common/dynamic_forward_proxy/dns_cache_manager_impl.h"
 
 #include "test/extensions/common/dynamic_forward_proxy/mocks.h"
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+
+using testing::_;
+using testing::ByMove;
 using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 using testing::SaveArg;
 
 namespace Envoy {
@@ -27,7 +39,8 @@ public:
     config_.set_dns_lookup_family(envoy::config::cluster::v3alpha::Cluster::V4_ONLY);
 
     EXPECT_CALL(dispatcher_, createDnsResolver(_, _)).WillOnce(Return(resolver_));
-    dns_cache_ = std::make_unique<DnsCacheImpl>(dispatcher_, tls_, store_, config_);
+    dns_cache_ = std::make_unique<DnsCacheImpl>(dispatcher_, tls_, *api_, snapshot_writer_, store_,
+                                                config_);
     update_callbacks_handle_ = dns_cache_->addUpdateCallbacks(update_callbacks_);
   }
 
@@ -55,6 +68,8 @@ public:
   NiceMock<Event::MockDispatcher> dispatcher_;
   std::shared_ptr<Network::MockDnsResolver> resolver_{std::make_shared<Network::MockDnsResolver>()};
   NiceMock<ThreadLocal::MockInstance> tls_;
+  Api::ApiPtr api_{Api::createApiForTest()};
+  DnsCacheSnapshotWriterSharedPtr snapshot_writer_{std::make_shared<DnsCacheSnapshotWriter>(*api_)};
   Stats::IsolatedStoreImpl store_;
   std::unique_ptr<DnsCache> dns_cache_;
   MockUpdateCallbacks update_callbacks_;
@@ -526,12 +541,157 @@ TEST_F(DnsCacheImplTest, MaxHostOverflow) {
   EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
 }
 
+// A new host evicts the least recently used host when the cache is full.
+TEST_F(DnsCacheImplTest, EvictLeastRecentlyUsed) {
+  config_.mutable_max_hosts()->set_value(2);
+  config_.set_evict_least_recently_used(true);
+  initialize();
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  for (const std::string host : {"foo.com", "bar.com"}) {
+    new Event::MockTimer(&dispatcher_);
+    EXPECT_CALL(*resolver_, resolve(host, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    auto result = dns_cache_->loadDnsCacheEntry(host, 80, callbacks);
+    EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+
+    EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate(host, _));
+    EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+    resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}));
+  }
+
+  // foo.com is used after both hosts were added, so bar.com is the one evicted.
+  simTime().sleep(std::chrono::milliseconds(1000));
+  dns_cache_->hosts()["foo.com"]->touch();
+
+  new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(update_callbacks_, onDnsHostRemove("bar.com"));
+  EXPECT_CALL(*resolver_, resolve("baz.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("baz.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("baz.com", _));
+  EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.2"}));
+
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+  EXPECT_EQ(0, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
+  checkStats(3 /* attempt */, 3 /* success */, 0 /* failure */, 3 /* address changed */,
+             3 /* added */, 1 /* removed */, 2 /* num hosts */);
+
+  result = dns_cache_->loadDnsCacheEntry("foo.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache, result.status_);
+  EXPECT_EQ(0, dns_cache_->hosts().count("bar.com"));
+}
+
+// The hosts still being resolved for the first time are not evicted, as requests wait on them.
+TEST_F(DnsCacheImplTest, EvictLeastRecentlyUsedSkipsPendingHosts) {
+  config_.mutable_max_hosts()->set_value(1);
+  config_.set_evict_least_recently_used(true);
+  initialize();
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  for (const std::string host : {"foo.com", "bar.com"}) {
+    new Event::MockTimer(&dispatcher_);
+    EXPECT_CALL(*resolver_, resolve(host, _, _)).WillOnce(Return(&resolver_->active_query_));
+    auto result = dns_cache_->loadDnsCacheEntry(host, 80, callbacks);
+    EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+  }
+
+  EXPECT_EQ(0, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+  checkStats(2 /* attempt */, 0 /* success */, 0 /* failure */, 0 /* address changed */,
+             2 /* added */, 0 /* removed */, 2 /* num hosts */);
+
+  EXPECT_CALL(resolver_->active_query_, cancel()).Times(2);
+  dns_cache_.reset();
+}
+
+// The cache is warmed from its snapshot, which is written back when the hosts change.
+TEST_F(DnsCacheImplTest, Snapshot) {
+  // Entries whose default port is not a port are skipped.
+  const std::string snapshot_path = TestEnvironment::writeStringToFileForTest(
+      "dns_cache_snapshot",
+      R"EOF(
+fields { key: "foo.com" value { number_value: 80 } }
+fields { key: "bar.com:8080" value { number_value: 443 } }
+fields { key: "baz.com" value { string_value: "80" } }
+fields { key: "qux.com" value { number_value: 65536 } }
+)EOF");
+  config_.set_snapshot_path(snapshot_path);
+
+  // The expectations of the timers are matched newest first: the resolve timers of the hosts
+  // are created before the snapshot timer.
+  Event::MockTimer* snapshot_timer = new Event::MockTimer(&dispatcher_);
+  new Event::MockTimer(&dispatcher_);
+  new Event::MockTimer(&dispatcher_);
+  Network::DnsResolver::ResolveCb foo_resolve_cb;
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&foo_resolve_cb), Return(&resolver_->active_query_)));
+  EXPECT_CALL(*resolver_, resolve("bar.com", _, _)).WillOnce(Return(&resolver_->active_query_));
+  EXPECT_CALL(*snapshot_timer, enableTimer(std::chrono::milliseconds(60000), _));
+  initialize();
+  checkStats(2 /* attempt */, 0 /* success */, 0 /* failure */, 0 /* address changed */,
+             2 /* added */, 0 /* removed */, 2 /* num hosts */);
+
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("foo.com", _));
+  foo_resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}));
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  auto result = dns_cache_->loadDnsCacheEntry("foo.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache, result.status_);
+
+  EXPECT_CALL(*snapshot_timer, enableTimer(std::chrono::milliseconds(60000), _));
+  snapshot_timer->invokeCallback();
+
+  // The snapshot is written by the thread of the writer, which is done once the writer is
+  // destroyed.
+  EXPECT_CALL(resolver_->active_query_, cancel());
+  dns_cache_.reset();
+  snapshot_writer_.reset();
+  ProtobufWkt::Struct snapshot;
+  ASSERT_TRUE(Protobuf::TextFormat::ParseFromString(
+      TestEnvironment::readFileToStringForTest(snapshot_path), &snapshot));
+  EXPECT_EQ(2, snapshot.fields().size());
+  EXPECT_EQ(80, snapshot.fields().at("foo.com").number_value());
+  EXPECT_EQ(8080, snapshot.fields().at("bar.com:8080").number_value());
+}
+
+// The snapshots are written through the file system of the Api, to a temporary file which then
+// replaces the previous snapshot.
+TEST(DnsCacheSnapshotWriterTest, WritesThroughFileSystem) {
+  NiceMock<Api::MockApi> api;
+  NiceMock<Filesystem::MockInstance> file_system;
+  ON_CALL(api, fileSystem()).WillByDefault(ReturnRef(file_system));
+  ON_CALL(api, threadFactory()).WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+
+  auto* file = new NiceMock<Filesystem::MockFile>();
+  EXPECT_CALL(file_system, createFile("/snapshot.tmp"))
+      .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file))));
+  EXPECT_CALL(*file, open_(_))
+      .WillOnce(Invoke([](const Filesystem::FlagSet& flags) -> Api::IoCallBoolResult {
+        EXPECT_TRUE(flags[Filesystem::File::Operation::Write]);
+        EXPECT_TRUE(flags[Filesystem::File::Operation::Create]);
+        EXPECT_TRUE(flags[Filesystem::File::Operation::Truncate]);
+        return Filesystem::resultSuccess<bool>(true);
+      }));
+  EXPECT_CALL(*file, write_("snapshot"))
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<ssize_t>(8))));
+  EXPECT_CALL(*file, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(file_system, renameFile("/snapshot.tmp", "/snapshot")).WillOnce(Return(true));
+
+  // The writer writes the snapshots still queued before it is destroyed.
+  DnsCacheSnapshotWriter writer(api);
+  writer.queue("/snapshot", "snapshot");
+}
+
 // DNS cache manager config tests.
 TEST(DnsCacheManagerImplTest, LoadViaConfig) {
   NiceMock<Event::MockDispatcher> dispatcher;
   NiceMock<ThreadLocal::MockInstance> tls;
+  Api::ApiPtr api = Api::createApiForTest();
   Stats::IsolatedStoreImpl store;
-  DnsCacheManagerImpl cache_manager(dispatcher, tls, store);
+  DnsCacheManagerImpl cache_manager(dispatcher, tls, *api, store);
 
   envoy::extensions::common::dynamic_forward_proxy::v3alpha::DnsCacheConfig config1;
   config1.set_name("foo");
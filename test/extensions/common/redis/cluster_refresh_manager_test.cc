@@ -18,7 +18,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Extensions {
@@ -121,7 +123,7 @@ public:
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, Basic) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
-                                              1, [&]() { callback_count_++; });
+                                              1, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   Thread::ThreadPtr thread_1 = platform_.threadFactory().createThread([&]() {
@@ -163,7 +165,7 @@ TEST_F(ClusterRefreshManagerTest, Basic) {
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, BasicFailureEvents) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
-                                              1, [&]() { callback_count_++; });
+                                              1, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   Thread::ThreadPtr thread_1 = platform_.threadFactory().createThread([&]() {
@@ -205,7 +207,7 @@ TEST_F(ClusterRefreshManagerTest, BasicFailureEvents) {
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, BasicDegradedEvents) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
-                                              1, [&]() { callback_count_++; });
+                                              1, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   Thread::ThreadPtr thread_1 = platform_.threadFactory().createThread([&]() {
@@ -247,7 +249,7 @@ TEST_F(ClusterRefreshManagerTest, BasicDegradedEvents) {
 // to simulate possible thread timing issues.
 TEST_F(ClusterRefreshManagerTest, HighVolume) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::seconds(2), 1000, 1000,
-                                              1000, [&]() { callback_count_++; });
+                                              1000, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
   uint32_t thread1_callback_count = 0;
   uint32_t thread2_callback_count = 0;
@@ -292,7 +294,7 @@ TEST_F(ClusterRefreshManagerTest, HighVolume) {
 // degraded events are disabled by setting the threshold to 0
 TEST_F(ClusterRefreshManagerTest, FeatureDisabled) {
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 0, 0,
-                                              0, [&]() { callback_count_++; });
+                                              0, [&]() { callback_count_++; }, nullptr);
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
 
   EXPECT_FALSE(refresh_manager_->onRedirection(cluster_name_));
@@ -310,6 +312,44 @@ TEST_F(ClusterRefreshManagerTest, FeatureDisabled) {
   EXPECT_EQ(cluster_info->host_degraded_threshold_, 0);
 }
 
+// The MOVED redirections received while a call to the slots moved callback is pending are batched
+// into that call.
+TEST_F(ClusterRefreshManagerTest, SlotMoved) {
+  std::vector<MovedSlots> moved_calls;
+  handle_ = refresh_manager_->registerCluster(
+      cluster_name_, std::chrono::milliseconds(1000), 1, 1, 1, [&]() { callback_count_++; },
+      [&](const MovedSlots& moved_slots) { moved_calls.push_back(moved_slots); });
+
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  EXPECT_TRUE(refresh_manager_->onSlotMoved(cluster_name_, 1, "10.0.0.1:6379"));
+  EXPECT_FALSE(refresh_manager_->onSlotMoved(cluster_name_, 2, "10.0.0.2:6379"));
+  EXPECT_FALSE(refresh_manager_->onSlotMoved(cluster_name_, 1, "10.0.0.3:6379"));
+  post_cb();
+
+  ASSERT_EQ(1U, moved_calls.size());
+  EXPECT_EQ((MovedSlots{{1, "10.0.0.3:6379"}, {2, "10.0.0.2:6379"}}), moved_calls[0]);
+  // The moves are not counted as redirections.
+  EXPECT_EQ(0, callback_count_);
+
+  // Once the callback is called, the next move schedules another call.
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  EXPECT_TRUE(refresh_manager_->onSlotMoved(cluster_name_, 3, "10.0.0.1:6379"));
+  post_cb();
+  ASSERT_EQ(2U, moved_calls.size());
+  EXPECT_EQ((MovedSlots{{3, "10.0.0.1:6379"}}), moved_calls[1]);
+
+  EXPECT_FALSE(refresh_manager_->onSlotMoved("unregistered_cluster_name", 1, "10.0.0.1:6379"));
+}
+
+// Clusters registered without a slots moved callback ignore the moves.
+TEST_F(ClusterRefreshManagerTest, SlotMovedWithoutCallback) {
+  handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
+                                              1, [&]() { callback_count_++; }, nullptr);
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
+  EXPECT_FALSE(refresh_manager_->onSlotMoved(cluster_name_, 1, "10.0.0.1:6379"));
+}
+
 } // namespace Redis
 } // namespace Common
 } // namespace Extensions
@@ -17,11 +17,14 @@ public:
   MOCK_METHOD1(onRedirection, bool(const std::string& cluster_name));
   MOCK_METHOD1(onFailure, bool(const std::string& cluster_name));
   MOCK_METHOD1(onHostDegraded, bool(const std::string& cluster_name));
-  MOCK_METHOD6(registerCluster,
+  MOCK_METHOD3(onSlotMoved, bool(const std::string& cluster_name, uint64_t slot,
+                                 const std::string& address));
+  MOCK_METHOD7(registerCluster,
                HandlePtr(const std::string& cluster_name,
                          std::chrono::milliseconds min_time_between_triggering,
                          const uint32_t redirects_threshold, const uint32_t failure_threshold,
-                         const uint32_t host_degraded_threshold, const RefreshCB& cb));
+                         const uint32_t host_degraded_threshold, const RefreshCB& cb,
+                         const SlotsMovedCB& moved_cb));
 };
 
 } // namespace Redis
@@ -7,8 +7,10 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::Invoke;
 using testing::Return;
 using testing::SaveArg;
+using testing::Throw;
 
 namespace Envoy {
 namespace Extensions {
@@ -96,6 +98,44 @@ TEST_F(AdminHandlerTest, RequestTapWhileAttached) {
   EXPECT_EQ("An attached /tap admin stream already exists. Detach it.", response_.toString());
 }
 
+// Request with a tap configuration that the extension rejects.
+TEST_F(AdminHandlerTest, RejectedTapConfig) {
+  MockExtensionConfig extension_config;
+  handler_->registerConfig(extension_config, "test_config_id");
+
+  Buffer::OwnedImpl body(admin_request_yaml_);
+  EXPECT_CALL(admin_stream_, getRequestBody()).WillRepeatedly(Return(&body));
+  EXPECT_CALL(extension_config, newTapConfig(_, handler_.get()))
+      .WillOnce(Throw(EnvoyException("unsupported tap output")));
+  EXPECT_CALL(admin_stream_, setEndStreamOnComplete(_)).Times(0);
+  EXPECT_EQ(Http::Code::BadRequest, cb_("/tap", response_headers_, response_, admin_stream_));
+  EXPECT_EQ("unsupported tap output", response_.toString());
+}
+
+// Traces are dropped while too many of them are waiting for the main thread.
+TEST_F(AdminHandlerTest, MaxPendingTraces) {
+  const uint32_t max_pending_traces = AdminHandler::MaxPendingTraces;
+  std::vector<Event::PostCb> posted;
+  EXPECT_CALL(main_thread_dispatcher_, post(_))
+      .Times(max_pending_traces + 1)
+      .WillRepeatedly(Invoke([&posted](Event::PostCb cb) { posted.push_back(std::move(cb)); }));
+
+  PerTapSinkHandlePtr sink_handle = handler_->createPerTapSinkHandle(0);
+  for (uint32_t i = 0; i < max_pending_traces + 1; i++) {
+    sink_handle->submitTrace(makeTraceWrapper(),
+                             envoy::config::tap::v3alpha::OutputSink::JSON_BODY_AS_BYTES);
+  }
+  EXPECT_EQ(max_pending_traces, posted.size());
+
+  // Once the main thread runs the pending traces, new traces are submitted again.
+  for (auto& cb : posted) {
+    cb();
+  }
+  sink_handle->submitTrace(makeTraceWrapper(),
+                           envoy::config::tap::v3alpha::OutputSink::JSON_BODY_AS_BYTES);
+  EXPECT_EQ(max_pending_traces + 1, posted.size());
+}
+
 } // namespace
 } // namespace Tap
 } // namespace Common
@@ -0,0 +1,126 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Usage: bazel run -c opt //test/extensions/common/wasm:wasm_speed_test
+
+#include <memory>
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/common/logger.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/common/wasm/wasm_vm.h"
+
+#include "test/test_common/environment.h"
+
+#include "benchmark/benchmark.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+namespace {
+
+uint32_t pong_value_;
+
+void pong(void*, Word value) { pong_value_ = convertWordToUint32(value); }
+
+Word random(void*) { return Word(42); }
+
+const std::string& testModule() {
+  CONSTRUCT_ON_FIRST_USE(std::string,
+                         TestEnvironment::readFileToStringForTest(TestEnvironment::runfilesPath(
+                             "test/extensions/common/wasm/test_data/test_rust.wasm")));
+}
+
+void link(WasmVm& vm) {
+  vm.registerCallback("env", "pong", &pong, CONVERT_FUNCTION_WORD_TO_UINT32(pong));
+  vm.registerCallback("env", "random", &random, CONVERT_FUNCTION_WORD_TO_UINT32(random));
+  vm.link("benchmark");
+}
+
+// Start a VM from scratch, compiling the module.
+void BM_V8LoadAndLink(benchmark::State& state) {
+  Stats::IsolatedStoreImpl store;
+  Stats::ScopeSharedPtr scope(store.createScope("wasm."));
+  for (auto _ : state) {
+    auto vm = createWasmVm("envoy.wasm.runtime.v8", scope);
+    RELEASE_ASSERT(vm->load(testModule(), false), "");
+    link(*vm);
+  }
+}
+BENCHMARK(BM_V8LoadAndLink)->Unit(benchmark::kMicrosecond);
+
+// Start a VM on a worker, from the module compiled once on the main thread.
+void BM_V8CloneAndLink(benchmark::State& state) {
+  Stats::IsolatedStoreImpl store;
+  Stats::ScopeSharedPtr scope(store.createScope("wasm."));
+  auto base_vm = createWasmVm("envoy.wasm.runtime.v8", scope);
+  RELEASE_ASSERT(base_vm->load(testModule(), false), "");
+  for (auto _ : state) {
+    auto vm = base_vm->clone();
+    link(*vm);
+  }
+}
+BENCHMARK(BM_V8CloneAndLink)->Unit(benchmark::kMicrosecond);
+
+// A call into the VM which does not call out of it.
+void BM_V8Call(benchmark::State& state) {
+  Stats::IsolatedStoreImpl store;
+  Stats::ScopeSharedPtr scope(store.createScope("wasm."));
+  auto vm = createWasmVm("envoy.wasm.runtime.v8", scope);
+  RELEASE_ASSERT(vm->load(testModule(), false), "");
+  link(*vm);
+  WasmCallWord<3> sum;
+  vm->getFunction("sum", &sum);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sum(nullptr, 13, 14, 15).u64_);
+  }
+}
+BENCHMARK(BM_V8Call);
+
+// A call into the VM which calls a host function, the difference with BM_V8Call being the
+// overhead of a host function call.
+void BM_V8HostFunctionCall(benchmark::State& state) {
+  Stats::IsolatedStoreImpl store;
+  Stats::ScopeSharedPtr scope(store.createScope("wasm."));
+  auto vm = createWasmVm("envoy.wasm.runtime.v8", scope);
+  RELEASE_ASSERT(vm->load(testModule(), false), "");
+  link(*vm);
+  WasmCallVoid<1> ping;
+  vm->getFunction("ping", &ping);
+  for (auto _ : state) {
+    ping(nullptr, 42);
+  }
+  RELEASE_ASSERT(pong_value_ == 42, "");
+}
+BENCHMARK(BM_V8HostFunctionCall);
+
+} // namespace
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create(argv[0], &error));
+  RELEASE_ASSERT(runfiles != nullptr, error);
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
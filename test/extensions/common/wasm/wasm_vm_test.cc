@@ -248,6 +248,34 @@ TEST_F(WasmVmTest, V8FunctionCalls) {
                             "Function: abort failed: Uncaught RuntimeError: unreachable");
 }
 
+// A clone shares the compiled module and the custom sections of its source VM, and is linked to
+// its own host functions.
+TEST_F(WasmVmTest, V8Clone) {
+  auto wasm_vm = createWasmVm("envoy.wasm.runtime.v8", scope_);
+  ASSERT_TRUE(wasm_vm != nullptr);
+
+  auto code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_rust.wasm"));
+  EXPECT_TRUE(wasm_vm->load(code, false));
+
+  auto clone = wasm_vm->clone();
+  ASSERT_TRUE(clone != nullptr);
+  EXPECT_THAT(clone->getCustomSection("producers"), HasSubstr("rustc"));
+
+  clone->registerCallback("env", "pong", &pong, CONVERT_FUNCTION_WORD_TO_UINT32(pong));
+  clone->registerCallback("env", "random", &random, CONVERT_FUNCTION_WORD_TO_UINT32(random));
+  clone->link("clone");
+
+  WasmCallVoid<1> ping;
+  clone->getFunction("ping", &ping);
+  EXPECT_CALL(*g_host_functions, pong(42));
+  ping(nullptr /* no context */, 42);
+
+  WasmCallWord<3> sum;
+  clone->getFunction("sum", &sum);
+  EXPECT_EQ(42, sum(nullptr /* no context */, 13, 14, 15).u64_);
+}
+
 TEST_F(WasmVmTest, V8Memory) {
   auto wasm_vm = createWasmVm("envoy.wasm.runtime.v8", scope_);
   ASSERT_TRUE(wasm_vm != nullptr);
@@ -0,0 +1,112 @@
+#include "extensions/filters/common/expr/evaluator.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace Expr {
+namespace {
+
+// request.headers[':path'] == '/allowed'
+const std::string PathCondition = R"EOF(
+call_expr:
+  function: _==_
+  args:
+  - call_expr:
+      function: _[_]
+      args:
+      - select_expr:
+          operand:
+            ident_expr:
+              name: request
+          field: headers
+      - const_expr:
+          string_value: ":path"
+  - const_expr:
+      string_value: /allowed
+)EOF";
+
+TEST(Evaluator, ReferencedAttributes) {
+  const auto path_condition =
+      TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(PathCondition);
+  const ReferencedAttributes path_attributes = referencedAttributes(path_condition);
+  EXPECT_TRUE(path_attributes.request_);
+  EXPECT_FALSE(path_attributes.response_);
+  EXPECT_FALSE(path_attributes.connection_);
+  EXPECT_FALSE(path_attributes.upstream_);
+  EXPECT_FALSE(path_attributes.source_);
+  EXPECT_FALSE(path_attributes.destination_);
+  EXPECT_FALSE(path_attributes.metadata_);
+
+  const ReferencedAttributes nested_attributes =
+      referencedAttributes(TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(R"EOF(
+call_expr:
+  function: _||_
+  args:
+  - select_expr:
+      operand:
+        ident_expr:
+          name: connection
+      field: mtls
+  - call_expr:
+      function: _==_
+      args:
+      - list_expr:
+          elements:
+          - select_expr:
+              operand:
+                ident_expr:
+                  name: source
+              field: port
+      - list_expr:
+          elements:
+          - select_expr:
+              operand:
+                ident_expr:
+                  name: destination
+              field: port
+)EOF"));
+  EXPECT_FALSE(nested_attributes.request_);
+  EXPECT_TRUE(nested_attributes.connection_);
+  EXPECT_TRUE(nested_attributes.source_);
+  EXPECT_TRUE(nested_attributes.destination_);
+  EXPECT_FALSE(nested_attributes.metadata_);
+
+  const ReferencedAttributes constant_attributes =
+      referencedAttributes(TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(R"EOF(
+const_expr:
+  bool_value: true
+)EOF"));
+  EXPECT_FALSE(constant_attributes.request_);
+  EXPECT_FALSE(constant_attributes.metadata_);
+}
+
+TEST(Evaluator, MatchesWithReferencedAttributes) {
+  Protobuf::Arena constant_arena;
+  BuilderPtr builder = createBuilder(&constant_arena);
+  const auto condition = TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(PathCondition);
+  ExpressionPtr expr = createExpression(*builder, condition);
+  const ReferencedAttributes attributes = referencedAttributes(condition);
+
+  testing::NiceMock<StreamInfo::MockStreamInfo> info;
+  EXPECT_TRUE(matches(*expr, attributes, info, Http::TestHeaderMapImpl{{":path", "/allowed"}}));
+  EXPECT_FALSE(matches(*expr, attributes, info, Http::TestHeaderMapImpl{{":path", "/denied"}}));
+  EXPECT_TRUE(matches(*expr, info, Http::TestHeaderMapImpl{{":path", "/allowed"}}));
+
+  // The request attributes are not provided, so the evaluation fails.
+  EXPECT_FALSE(
+      matches(*expr, ReferencedAttributes(), info, Http::TestHeaderMapImpl{{":path", "/allowed"}}));
+}
+
+} // namespace
+} // namespace Expr
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -157,6 +157,69 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// Released coroutines which finished are reused, the others are not.
+TEST_F(LuaTest, CoroutinePooling) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+    end
+
+    function yieldMe()
+      coroutine.yield()
+    end
+
+    function failMe()
+      error("failed")
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  const int call_me = state_->getGlobalRef(state_->registerGlobal("callMe"));
+  const int yield_me = state_->getGlobalRef(state_->registerGlobal("yieldMe"));
+  const int fail_me = state_->getGlobalRef(state_->registerGlobal("failMe"));
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  lua_State* finished_state = cr1->luaState();
+  LuaRef<TestObject> ref1(TestObject::create(cr1->luaState()), true);
+  EXPECT_CALL(*ref1.get(), doTestCall(_));
+  cr1->start(call_me, 1, yield_callback_);
+  EXPECT_EQ(cr1->state(), Coroutine::State::Finished);
+  EXPECT_TRUE(cr1->reusable());
+  state_->releaseCoroutine(std::move(cr1));
+
+  // The Lua thread of the finished coroutine runs the next function.
+  CoroutinePtr cr2(state_->createCoroutine());
+  EXPECT_EQ(finished_state, cr2->luaState());
+  EXPECT_EQ(cr2->state(), Coroutine::State::NotStarted);
+  EXPECT_EQ(0, lua_gettop(cr2->luaState()));
+  LuaRef<TestObject> ref2(TestObject::create(cr2->luaState()), true);
+  EXPECT_CALL(*ref2.get(), doTestCall(_));
+  cr2->start(call_me, 1, yield_callback_);
+  EXPECT_EQ(cr2->state(), Coroutine::State::Finished);
+
+  CoroutinePtr yielded(state_->createCoroutine());
+  EXPECT_CALL(on_yield_, ready());
+  yielded->start(yield_me, 0, yield_callback_);
+  EXPECT_FALSE(yielded->reusable());
+
+  CoroutinePtr failed(state_->createCoroutine());
+  EXPECT_THROW(failed->start(fail_me, 0, yield_callback_), LuaException);
+  EXPECT_FALSE(failed->reusable());
+
+  // The pool hands back the last released coroutine first, so only the finished one was kept.
+  state_->releaseCoroutine(std::move(cr2));
+  state_->releaseCoroutine(std::move(yielded));
+  state_->releaseCoroutine(std::move(failed));
+  CoroutinePtr cr3(state_->createCoroutine());
+  EXPECT_EQ(finished_state, cr3->luaState());
+
+  EXPECT_CALL(*ref1.get(), onDestroy());
+  ref1.reset();
+  EXPECT_CALL(*ref2.get(), onDestroy());
+  ref2.reset();
+  lua_gc(cr3->luaState(), LUA_GCCOLLECT, 0);
+}
+
 } // namespace
 } // namespace Lua
 } // namespace Common
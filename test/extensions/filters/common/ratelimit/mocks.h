@@ -25,6 +25,9 @@ public:
   MOCK_METHOD4(limit, void(RequestCallbacks& callbacks, const std::string& domain,
                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                            Tracing::Span& parent_span));
+  MOCK_METHOD5(limit, void(RequestCallbacks& callbacks, const std::string& domain,
+                           const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                           Tracing::Span& parent_span, uint32_t hits_addend));
 };
 
 } // namespace RateLimit
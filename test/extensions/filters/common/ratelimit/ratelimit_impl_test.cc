@@ -125,6 +125,23 @@ TEST_F(RateLimitGrpcClientTest, Basic) {
   }
 }
 
+TEST_F(RateLimitGrpcClientTest, HitsAddend) {
+  envoy::service::ratelimit::v3alpha::RateLimitRequest request;
+  GrpcClientImpl::createRequest(request, "foo", {{{{"foo", "bar"}}}}, 100);
+  EXPECT_EQ(100, request.hits_addend());
+  EXPECT_CALL(*async_client_, sendRaw(_, _, Grpc::ProtoBufferEq(request), _, _, _))
+      .WillOnce(Return(&async_request_));
+
+  client_.limit(request_callbacks_, "foo", {{{{"foo", "bar"}}}}, Tracing::NullSpan::instance(),
+                100);
+
+  auto response = std::make_unique<envoy::service::ratelimit::v3alpha::RateLimitResponse>();
+  response->set_overall_code(envoy::service::ratelimit::v3alpha::RateLimitResponse::OK);
+  EXPECT_CALL(span_, setTag(Eq("ratelimit_status"), Eq("ok")));
+  EXPECT_CALL(request_callbacks_, complete_(LimitStatus::OK, _, _));
+  client_.onSuccess(std::move(response), span_);
+}
+
 TEST_F(RateLimitGrpcClientTest, Cancel) {
   std::unique_ptr<envoy::service::ratelimit::v3alpha::RateLimitResponse> response;
 
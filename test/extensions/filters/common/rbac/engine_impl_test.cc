@@ -15,6 +15,8 @@
 #include "gtest/gtest.h"
 
 using testing::Const;
+using testing::NiceMock;
+using testing::Return;
 using testing::ReturnRef;
 
 namespace Envoy {
@@ -353,6 +355,170 @@ TEST(RoleBasedAccessControlEngineImpl, ConjunctiveCondition) {
   checkEngine(engine, false, conn);
 }
 
+// The policies indexed by exact header matches are evaluated in the same order as the others.
+TEST(RoleBasedAccessControlEngineImpl, IndexedHeaderPolicies) {
+  envoy::config::rbac::v3alpha::RBAC rbac;
+  TestUtility::loadFromYaml(R"EOF(
+action: ALLOW
+policies:
+  a:
+    permissions:
+    - destination_port: 123
+    principals:
+    - any: true
+  b:
+    permissions:
+    - header: { name: ":path", exact_match: "/b" }
+    - header: { name: ":path", exact_match: "/other" }
+    principals:
+    - any: true
+  c:
+    permissions:
+    - and_rules:
+        rules:
+        - destination_port: 456
+        - header: { name: ":path", exact_match: "/c" }
+    principals:
+    - any: true
+  d:
+    permissions:
+    - header: { name: ":path", exact_match: "/d", invert_match: true }
+    principals:
+    - header: { name: "x-d", exact_match: "d" }
+)EOF",
+                            rbac);
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac);
+
+  NiceMock<Envoy::Network::MockConnection> conn;
+  Envoy::Network::Address::InstanceConstSharedPtr addr =
+      Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 123, false);
+  ON_CALL(conn, localAddress()).WillByDefault(ReturnRef(addr));
+
+  std::string policy_id;
+  checkEngine(engine, true, conn, Http::TestHeaderMapImpl{{":path", "/b"}}, {}, &policy_id);
+  EXPECT_EQ("a", policy_id);
+
+  addr = Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 80, false);
+  checkEngine(engine, true, conn, Http::TestHeaderMapImpl{{":path", "/other"}}, {}, &policy_id);
+  EXPECT_EQ("b", policy_id);
+  checkEngine(engine, false, conn, Http::TestHeaderMapImpl{{":path", "/c"}});
+  checkEngine(engine, false, conn, Http::TestHeaderMapImpl{{":path", "/d"}, {"x-d", "d"}});
+  checkEngine(engine, true, conn, Http::TestHeaderMapImpl{{":path", "/e"}, {"x-d", "d"}}, {},
+              &policy_id);
+  EXPECT_EQ("d", policy_id);
+  checkEngine(engine, false, conn, Http::TestHeaderMapImpl{{":path", "/e"}});
+
+  addr = Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 456, false);
+  checkEngine(engine, true, conn, Http::TestHeaderMapImpl{{":path", "/c"}}, {}, &policy_id);
+  EXPECT_EQ("c", policy_id);
+}
+
+// The policies indexed by principal names, source ranges and requested server names.
+TEST(RoleBasedAccessControlEngineImpl, IndexedConnectionPolicies) {
+  envoy::config::rbac::v3alpha::RBAC rbac;
+  TestUtility::loadFromYaml(R"EOF(
+action: DENY
+policies:
+  principal:
+    permissions:
+    - any: true
+    principals:
+    - authenticated: { principal_name: { exact: "spiffe://a" } }
+    - authenticated: { principal_name: { exact: "subject" } }
+  source_ip:
+    permissions:
+    - any: true
+    principals:
+    - source_ip: { address_prefix: "10.0.0.0", prefix_len: 8 }
+  sni:
+    permissions:
+    - requested_server_name: { exact: "sni.example.com" }
+    principals:
+    - any: true
+)EOF",
+                            rbac);
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac);
+
+  NiceMock<Envoy::Network::MockConnection> conn;
+  Envoy::Network::Address::InstanceConstSharedPtr addr =
+      Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 123, false);
+  ON_CALL(conn, remoteAddress()).WillByDefault(ReturnRef(addr));
+  checkEngine(engine, true, conn);
+
+  std::string policy_id;
+  addr = Envoy::Network::Utility::parseInternetAddress("10.1.2.3", 123, false);
+  checkEngine(engine, false, conn, Http::HeaderMapImpl(), {}, &policy_id);
+  EXPECT_EQ("source_ip", policy_id);
+
+  addr = Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 123, false);
+  ON_CALL(conn, requestedServerName()).WillByDefault(Return("sni.example.com"));
+  checkEngine(engine, false, conn, Http::HeaderMapImpl(), {}, &policy_id);
+  EXPECT_EQ("sni", policy_id);
+  ON_CALL(conn, requestedServerName()).WillByDefault(Return(""));
+
+  auto ssl = std::make_shared<NiceMock<Ssl::MockConnectionInfo>>();
+  const std::vector<std::string> uri_sans{"spiffe://b"};
+  const std::string subject = "subject";
+  ON_CALL(*ssl, uriSanPeerCertificate()).WillByDefault(Return(uri_sans));
+  ON_CALL(*ssl, subjectPeerCertificate()).WillByDefault(ReturnRef(subject));
+  ON_CALL(Const(conn), ssl()).WillByDefault(Return(ssl));
+  checkEngine(engine, false, conn, Http::HeaderMapImpl(), {}, &policy_id);
+  EXPECT_EQ("principal", policy_id);
+
+  const std::string other_subject = "other";
+  ON_CALL(*ssl, subjectPeerCertificate()).WillByDefault(ReturnRef(other_subject));
+  checkEngine(engine, true, conn);
+}
+
+TEST(RoleBasedAccessControlEngineImpl, ConnectionOnly) {
+  envoy::config::rbac::v3alpha::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v3alpha::RBAC::ALLOW);
+  EXPECT_TRUE(RBAC::RoleBasedAccessControlEngineImpl(rbac).connectionOnly());
+
+  envoy::config::rbac::v3alpha::Policy connection_policy;
+  auto* rules = connection_policy.add_permissions()->mutable_or_rules();
+  rules->add_rules()->set_destination_port(123);
+  rules->add_rules()->mutable_not_rule()->mutable_requested_server_name()->set_exact("sni");
+  auto* source_ip = connection_policy.add_principals()->mutable_and_ids()->add_ids();
+  source_ip->mutable_source_ip()->set_address_prefix("10.0.0.0");
+  connection_policy.add_principals()->mutable_authenticated();
+  (*rbac.mutable_policies())["connection"] = connection_policy;
+  EXPECT_TRUE(RBAC::RoleBasedAccessControlEngineImpl(rbac).connectionOnly());
+
+  {
+    envoy::config::rbac::v3alpha::RBAC header_rbac = rbac;
+    envoy::config::rbac::v3alpha::Policy policy;
+    policy.add_permissions()->set_any(true);
+    policy.add_principals()->mutable_not_id()->mutable_header()->set_name("x-id");
+    (*header_rbac.mutable_policies())["header"] = policy;
+    EXPECT_FALSE(RBAC::RoleBasedAccessControlEngineImpl(header_rbac).connectionOnly());
+  }
+
+  {
+    envoy::config::rbac::v3alpha::RBAC metadata_rbac = rbac;
+    envoy::config::rbac::v3alpha::Policy policy;
+    policy.add_permissions()->mutable_and_rules()->add_rules()->mutable_metadata()->set_filter(
+        "filter");
+    policy.add_principals()->set_any(true);
+    (*metadata_rbac.mutable_policies())["metadata"] = policy;
+    EXPECT_FALSE(RBAC::RoleBasedAccessControlEngineImpl(metadata_rbac).connectionOnly());
+  }
+
+  {
+    envoy::config::rbac::v3alpha::RBAC condition_rbac = rbac;
+    envoy::config::rbac::v3alpha::Policy policy = connection_policy;
+    policy.mutable_condition()->mutable_const_expr()->set_bool_value(true);
+    (*condition_rbac.mutable_policies())["condition"] = policy;
+    EXPECT_FALSE(RBAC::RoleBasedAccessControlEngineImpl(condition_rbac).connectionOnly());
+  }
+}
+
+TEST(RoleBasedAccessControlEngineImpl, UniqueIds) {
+  envoy::config::rbac::v3alpha::RBAC rbac;
+  EXPECT_NE(RBAC::RoleBasedAccessControlEngineImpl(rbac).id(),
+            RBAC::RoleBasedAccessControlEngineImpl(rbac).id());
+}
+
 } // namespace
 } // namespace RBAC
 } // namespace Common
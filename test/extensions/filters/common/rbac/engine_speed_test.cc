@@ -0,0 +1,110 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Usage: bazel run -c opt //test/extensions/filters/common/rbac:engine_speed_test
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/rbac/v3alpha/rbac.pb.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/network/utility.h"
+
+#include "extensions/filters/common/rbac/engine_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/ssl/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+// Policies allowing one path to one principal each, and as many allowing one source range to any
+// path, like the configs of large meshes.
+envoy::config::rbac::v3alpha::RBAC makeRules(uint64_t num_policies) {
+  envoy::config::rbac::v3alpha::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v3alpha::RBAC::ALLOW);
+  for (uint64_t i = 0; i < num_policies / 2; i++) {
+    envoy::config::rbac::v3alpha::Policy& path_policy =
+        (*rbac.mutable_policies())[absl::StrCat("path-", i)];
+    auto* header = path_policy.add_permissions()->mutable_header();
+    header->set_name(":path");
+    header->set_exact_match(absl::StrCat("/service/", i, "/method"));
+    path_policy.add_principals()->mutable_authenticated()->mutable_principal_name()->set_exact(
+        absl::StrCat("spiffe://cluster.local/ns/default/sa/service-", i));
+
+    envoy::config::rbac::v3alpha::Policy& ip_policy =
+        (*rbac.mutable_policies())[absl::StrCat("ip-", i)];
+    ip_policy.add_permissions()->set_any(true);
+    auto* range = ip_policy.add_principals()->mutable_source_ip();
+    range->set_address_prefix(absl::StrCat("10.", i / 256 % 256, ".", i % 256, ".0"));
+    range->mutable_prefix_len()->set_value(24);
+  }
+  return rbac;
+}
+
+// Evaluate a request which matches the policies of the last path, or none of them.
+void BM_EngineAllowed(benchmark::State& state) {
+  const uint64_t num_policies = state.range(0);
+  const bool matching = state.range(1) != 0;
+  RoleBasedAccessControlEngineImpl engine(makeRules(num_policies));
+
+  const uint64_t target = num_policies / 2 - 1;
+  testing::NiceMock<Network::MockConnection> connection;
+  Network::Address::InstanceConstSharedPtr remote_address =
+      Network::Utility::parseInternetAddress("192.168.0.1", 5000, false);
+  ON_CALL(connection, remoteAddress()).WillByDefault(testing::ReturnRef(remote_address));
+  auto ssl = std::make_shared<testing::NiceMock<Ssl::MockConnectionInfo>>();
+  const std::vector<std::string> uri_sans{
+      absl::StrCat("spiffe://cluster.local/ns/default/sa/service-", target)};
+  const std::string subject = "subject";
+  ON_CALL(*ssl, uriSanPeerCertificate()).WillByDefault(testing::Return(uri_sans));
+  ON_CALL(*ssl, subjectPeerCertificate()).WillByDefault(testing::ReturnRef(subject));
+  ON_CALL(testing::Const(connection), ssl()).WillByDefault(testing::Return(ssl));
+  Http::TestHeaderMapImpl headers{{":path", matching ? absl::StrCat("/service/", target, "/method")
+                                                     : std::string("/unknown")}};
+  testing::NiceMock<StreamInfo::MockStreamInfo> info;
+
+  for (auto _ : state) {
+    const bool allowed = engine.allowed(connection, headers, info, nullptr);
+    benchmark::DoNotOptimize(allowed);
+  }
+}
+BENCHMARK(BM_EngineAllowed)
+    ->Args({10, 1})
+    ->Args({10, 0})
+    ->Args({300, 1})
+    ->Args({300, 0})
+    ->Args({3000, 1})
+    ->Args({3000, 0});
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -10,6 +10,7 @@
 
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/ssl/mocks.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -123,6 +124,37 @@ TEST(OrMatcher, Principal_Set) {
   checkMatcher(RBAC::OrMatcher(set), true, conn);
 }
 
+// The values of a header in an OR are matched together, with the other rules still applying.
+TEST(OrMatcher, HeaderValues) {
+  envoy::config::rbac::v3alpha::Principal::Set set;
+  for (const std::string value : {"alice", "bob"}) {
+    auto* header = set.add_ids()->mutable_header();
+    header->set_name("X-User");
+    header->set_exact_match(value);
+  }
+  auto* header = set.add_ids()->mutable_header();
+  header->set_name("x-user");
+  header->set_prefix_match("admin-");
+  header = set.add_ids()->mutable_header();
+  header->set_name("x-user");
+  header->set_suffix_match("@example.com");
+  header = set.add_ids()->mutable_header();
+  header->set_name("x-user");
+  header->set_exact_match("carol");
+  header->set_invert_match(true);
+  RBAC::OrMatcher matcher(set);
+
+  Envoy::Http::TestHeaderMapImpl headers{{"x-user", "carol"}};
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(), headers);
+  for (const std::string value : {"alice", "bob", "admin-dan", "erin@example.com", "frank"}) {
+    headers.remove(Envoy::Http::LowerCaseString("x-user"));
+    headers.addCopy("x-user", value);
+    checkMatcher(matcher, true, Envoy::Network::MockConnection(), headers);
+  }
+  // The inverted rule matches a missing header.
+  checkMatcher(matcher, true);
+}
+
 TEST(NotMatcher, Permission) {
   envoy::config::rbac::v3alpha::Permission perm;
   perm.set_any(true);
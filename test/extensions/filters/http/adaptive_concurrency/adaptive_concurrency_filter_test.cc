@@ -5,6 +5,7 @@
 
 #include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
 #include "extensions/filters/http/adaptive_concurrency/concurrency_controller/concurrency_controller.h"
+#include "extensions/filters/http/well_known_names.h"
 
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/stream_info/mocks.h"
@@ -175,6 +176,24 @@ TEST_F(AdaptiveConcurrencyFilterTest, DecodeHeadersTestForwarding) {
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_trailers));
 }
 
+TEST_F(AdaptiveConcurrencyFilterTest, RouteController) {
+  auto route_controller = std::make_shared<MockConcurrencyController>();
+  AdaptiveConcurrencyRouteConfig route_config(route_controller);
+  ON_CALL(*decoder_callbacks_.route_, perFilterConfig(HttpFilterNames::get().AdaptiveConcurrency))
+      .WillByDefault(Return(&route_config));
+  Http::TestHeaderMapImpl request_headers;
+
+  // The controller of the route is used instead of the filter's.
+  EXPECT_CALL(*controller_, forwardingDecision()).Times(0);
+  EXPECT_CALL(*route_controller, forwardingDecision())
+      .WillOnce(Return(RequestForwardingAction::Forward));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+
+  EXPECT_CALL(*controller_, recordLatencySample(_)).Times(0);
+  EXPECT_CALL(*route_controller, recordLatencySample(_));
+  filter_->encodeComplete();
+}
+
 TEST_F(AdaptiveConcurrencyFilterTest, DecodeHeadersTestBlock) {
   Http::TestHeaderMapImpl request_headers;
 
@@ -12,6 +12,7 @@
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -53,7 +54,7 @@ public:
 
   GradientControllerSharedPtr makeController(const std::string& yaml_config) {
     return std::make_shared<GradientController>(makeConfig(yaml_config, runtime_), *dispatcher_,
-                                                runtime_, "test_prefix.", stats_, random_);
+                                                runtime_, "test_prefix.", stats_, random_, tls_);
   }
 
 protected:
@@ -82,6 +83,7 @@ protected:
   Api::ApiPtr api_;
   Event::DispatcherPtr dispatcher_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
 };
 
 TEST_F(GradientControllerConfigTest, BasicTest) {
@@ -205,6 +207,26 @@ min_rtt_calc_params:
   EXPECT_EQ(config.jitterPercent(), .15);
   EXPECT_EQ(config.minConcurrency(), 3);
   EXPECT_EQ(config.minRTTBufferPercent(), 0.25);
+  EXPECT_EQ(config.sampleRate(), 1.0);
+}
+
+TEST_F(GradientControllerConfigTest, SampleRate) {
+  const std::string yaml = R"EOF(
+concurrency_limit_params:
+  concurrency_update_interval: 0.123s
+min_rtt_calc_params:
+  interval: 31s
+sample_rate:
+  value: 10
+)EOF";
+
+  auto config = makeConfig(yaml, runtime_);
+  EXPECT_EQ(config.sampleRate(), 0.1);
+
+  EXPECT_CALL(runtime_.snapshot_,
+              getDouble("adaptive_concurrency.gradient_controller.sample_rate", 10.0))
+      .WillOnce(Return(150.0));
+  EXPECT_EQ(config.sampleRate(), 1.0);
 }
 
 TEST_F(GradientControllerTest, MinRTTLogicTest) {
@@ -564,7 +586,7 @@ min_rtt_calc_params:
       .WillOnce(Return(sample_timer));
   EXPECT_CALL(*sample_timer, enableTimer(std::chrono::milliseconds(123), _));
   auto controller = std::make_shared<GradientController>(
-      makeConfig(yaml, runtime_), fake_dispatcher, runtime_, "test_prefix.", stats_, random_);
+      makeConfig(yaml, runtime_), fake_dispatcher, runtime_, "test_prefix.", stats_, random_, tls_);
 
   // Set the minRTT- this will trigger the timer for the next minRTT calculation.
 
@@ -606,7 +628,7 @@ min_rtt_calc_params:
       .WillOnce(Return(sample_timer));
   EXPECT_CALL(*sample_timer, enableTimer(std::chrono::milliseconds(123), _));
   auto controller = std::make_shared<GradientController>(
-      makeConfig(yaml, runtime_), fake_dispatcher, runtime_, "test_prefix.", stats_, random_);
+      makeConfig(yaml, runtime_), fake_dispatcher, runtime_, "test_prefix.", stats_, random_, tls_);
 
   // Set the minRTT- this will trigger the timer for the next minRTT calculation.
   EXPECT_CALL(*rtt_timer, enableTimer(std::chrono::milliseconds(45000), _));
@@ -618,6 +640,121 @@ min_rtt_calc_params:
   }
 }
 
+TEST_F(GradientControllerTest, SampleRate) {
+  const std::string yaml = R"EOF(
+sample_aggregate_percentile:
+  value: 50
+concurrency_limit_params:
+  max_concurrency_limit:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  jitter:
+    value: 0.0
+  interval: 30s
+  request_count: 5
+sample_rate:
+  value: 50
+)EOF";
+
+  auto controller = makeController(yaml);
+
+  // All the minRTT samples are taken regardless of the sample rate.
+  for (int i = 0; i < 5; ++i) {
+    tryForward(controller, true);
+    controller->recordLatencySample(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(
+      5, stats_.gauge("test_prefix.min_rtt_msecs", Stats::Gauge::ImportMode::NeverImport).value());
+
+  // Only the sampled requests are used to calculate the concurrency limit. Unsampled requests have
+  // no effect, even with latencies that would shrink the limit.
+  const auto last_concurrency = controller->concurrencyLimit();
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(5000));
+  for (int i = 0; i < 5; ++i) {
+    tryForward(controller, true);
+    controller->recordLatencySample(std::chrono::milliseconds(50));
+  }
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(4999));
+  for (int i = 0; i < 5; ++i) {
+    tryForward(controller, true);
+    controller->recordLatencySample(std::chrono::milliseconds(4));
+  }
+  time_system_.sleep(std::chrono::milliseconds(101));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_GT(controller->concurrencyLimit(), last_concurrency);
+  EXPECT_EQ(4, stats_.gauge("test_prefix.sample_rtt_msecs", Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+}
+
+TEST_F(GradientControllerTest, WorkerSamplesMerged) {
+  const std::string yaml = R"EOF(
+sample_aggregate_percentile:
+  value: 50
+concurrency_limit_params:
+  max_concurrency_limit:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  jitter:
+    value: 0.0
+  interval: 30s
+  request_count: 5
+)EOF";
+
+  auto controller = makeController(yaml);
+  advancePastMinRTTStage(controller, yaml, std::chrono::milliseconds(5));
+
+  // The samples are merged on all the workers, then the limit is calculated on the main thread.
+  EXPECT_CALL(tls_, runOnAllThreads(_, _));
+  for (int i = 0; i < 5; ++i) {
+    tryForward(controller, true);
+    controller->recordLatencySample(std::chrono::milliseconds(4));
+  }
+  const auto last_concurrency = controller->concurrencyLimit();
+  time_system_.sleep(std::chrono::milliseconds(101));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_GT(controller->concurrencyLimit(), last_concurrency);
+}
+
+TEST_F(GradientControllerTest, SampleWindowDroppedByMinRTTWindow) {
+  const std::string yaml = R"EOF(
+sample_aggregate_percentile:
+  value: 50
+concurrency_limit_params:
+  max_concurrency_limit:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  jitter:
+    value: 0.0
+  interval: 30s
+  request_count: 5
+)EOF";
+
+  auto controller = makeController(yaml);
+  advancePastMinRTTStage(controller, yaml, std::chrono::milliseconds(5));
+  time_system_.sleep(std::chrono::milliseconds(29950));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // Let the minRTT recalculation start while samples are recorded for the sampleRTT window.
+  for (int i = 0; i < 5; ++i) {
+    tryForward(controller, true);
+    controller->recordLatencySample(std::chrono::milliseconds(50));
+  }
+  time_system_.sleep(std::chrono::milliseconds(60));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(controller->concurrencyLimit(), 3);
+  for (int i = 0; i < 5; ++i) {
+    tryForward(controller, true);
+    controller->recordLatencySample(std::chrono::milliseconds(5));
+  }
+  const auto limit_val = controller->concurrencyLimit();
+
+  // The samples recorded before the minRTT window were dropped, so the limit is unchanged in the
+  // absence of new samples.
+  time_system_.sleep(std::chrono::milliseconds(101));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(limit_val, controller->concurrencyLimit());
+}
+
 } // namespace
 } // namespace ConcurrencyController
 } // namespace AdaptiveConcurrency
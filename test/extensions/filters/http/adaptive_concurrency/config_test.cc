@@ -0,0 +1,72 @@
+#include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.h"
+#include "envoy/extensions/filters/http/adaptive_concurrency/v3alpha/adaptive_concurrency.pb.validate.h"
+
+#include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
+#include "extensions/filters/http/adaptive_concurrency/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace {
+
+class AdaptiveConcurrencyFilterFactoryTest : public testing::Test {
+public:
+  const ConcurrencyControllerSharedPtr& createRouteController(const std::string& yaml) {
+    envoy::extensions::filters::http::adaptive_concurrency::v3alpha::AdaptiveConcurrencyPerRoute
+        proto_config;
+    TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+    route_configs_.push_back(factory_.createRouteSpecificFilterConfig(
+        proto_config, context_, ProtobufMessage::getNullValidationVisitor()));
+    return dynamic_cast<const AdaptiveConcurrencyRouteConfig&>(*route_configs_.back())
+        .controller();
+  }
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  AdaptiveConcurrencyFilterFactory factory_;
+  std::vector<Router::RouteSpecificFilterConfigConstSharedPtr> route_configs_;
+};
+
+const std::string RouteConfigYaml = R"EOF(
+stat_prefix: foo
+gradient_controller_config:
+  sample_aggregate_percentile:
+    value: 50
+  concurrency_limit_params:
+    concurrency_update_interval: 0.1s
+  min_rtt_calc_params:
+    interval: 30s
+    request_count: 50
+)EOF";
+
+// The route configurations with the same per-route configuration share its controller, so that it
+// is kept across route configuration updates.
+TEST_F(AdaptiveConcurrencyFilterFactoryTest, RouteControllerKeptAcrossRouteConfigs) {
+  const ConcurrencyController::ConcurrencyController* controller =
+      createRouteController(RouteConfigYaml).get();
+  EXPECT_EQ(controller, createRouteController(RouteConfigYaml).get());
+
+  // A changed per-route configuration gets a new controller.
+  EXPECT_NE(controller,
+            createRouteController(RouteConfigYaml + "  sample_rate:\n    value: 50\n").get());
+
+  // Once the route configurations using them are gone, the controllers are deleted on the main
+  // thread.
+  EXPECT_CALL(context_.dispatcher_, post(_)).Times(2);
+  route_configs_.clear();
+}
+
+} // namespace
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,336 @@
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+// A stream going through its own cache filter.
+struct TestStream {
+  explicit TestStream(const CacheFilterConfigSharedPtr& config)
+      : filter_(std::make_shared<CacheFilter>(config)) {
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  }
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  std::shared_ptr<CacheFilter> filter_;
+};
+
+class CacheFilterTest : public testing::Test {
+public:
+  CacheFilterTest() {
+    time_system_.setSystemTime(std::chrono::hours(400000));
+    initialize("");
+  }
+
+  void initialize(const std::string& yaml) {
+    envoy::extensions::filters::http::cache::v3alpha::CacheConfig proto_config;
+    TestUtility::loadFromYaml(yaml, proto_config);
+    config_ = std::make_shared<CacheFilterConfig>(proto_config, "test.", store_, time_system_);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("test.cache." + name).value();
+  }
+
+  // Forward a request upstream and encode its cacheable response.
+  void fill(TestStream& stream, const std::string& body = "body") {
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              stream.filter_->decodeHeaders(request_headers_, true));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              stream.filter_->encodeHeaders(response_headers_, false));
+    Buffer::OwnedImpl data(body);
+    EXPECT_EQ(Http::FilterDataStatus::Continue, stream.filter_->encodeData(data, true));
+    stream.filter_->onDestroy();
+  }
+
+  // Expect a response to be served from the cache.
+  void expectCachedResponse(TestStream& stream, const std::string& age,
+                            const std::string& body = "body") {
+    EXPECT_CALL(stream.decoder_callbacks_, encodeHeaders_(_, false))
+        .WillOnce(Invoke([age](Http::HeaderMap& headers, bool) {
+          EXPECT_EQ("200", headers.Status()->value().getStringView());
+          EXPECT_EQ(age, headers.get(Http::LowerCaseString("age"))->value().getStringView());
+        }));
+    EXPECT_CALL(stream.decoder_callbacks_, encodeData(_, true))
+        .WillOnce(Invoke([body](Buffer::Instance& data, bool) {
+          EXPECT_EQ(body, data.toString());
+        }));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  CacheFilterConfigSharedPtr config_;
+  Http::TestHeaderMapImpl request_headers_{
+      {":method", "GET"}, {":path", "/resource"}, {":authority", "example.com"}};
+  Http::TestHeaderMapImpl response_headers_{{":status", "200"},
+                                            {"cache-control", "public, max-age=60"}};
+};
+
+TEST_F(CacheFilterTest, MissThenHit) {
+  TestStream filler(config_);
+  fill(filler);
+  EXPECT_EQ(1U, counter("miss"));
+  EXPECT_EQ(1U, counter("insert"));
+
+  time_system_.sleep(std::chrono::seconds(10));
+  TestStream stream(config_);
+  expectCachedResponse(stream, "10");
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            stream.filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(1U, counter("hit"));
+}
+
+TEST_F(CacheFilterTest, HeadersOnlyResponse) {
+  TestStream filler(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filler.filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filler.filter_->encodeHeaders(response_headers_, true));
+  filler.filter_->onDestroy();
+
+  TestStream stream(config_);
+  EXPECT_CALL(stream.decoder_callbacks_, encodeHeaders_(_, true));
+  EXPECT_CALL(stream.decoder_callbacks_, encodeData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            stream.filter_->decodeHeaders(request_headers_, true));
+}
+
+TEST_F(CacheFilterTest, StaleResponseIsFetchedAgain) {
+  TestStream filler(config_);
+  fill(filler);
+
+  time_system_.sleep(std::chrono::seconds(60));
+  TestStream stream(config_);
+  EXPECT_CALL(stream.decoder_callbacks_, encodeHeaders_(_, _)).Times(0);
+  fill(stream, "new body");
+  EXPECT_EQ(2U, counter("miss"));
+
+  TestStream cached(config_);
+  expectCachedResponse(cached, "0", "new body");
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            cached.filter_->decodeHeaders(request_headers_, true));
+}
+
+TEST_F(CacheFilterTest, InitialAgeShortensFreshness) {
+  response_headers_.addCopy("age", "50");
+  TestStream filler(config_);
+  fill(filler);
+
+  time_system_.sleep(std::chrono::seconds(5));
+  TestStream stream(config_);
+  expectCachedResponse(stream, "55");
+  stream.filter_->decodeHeaders(request_headers_, true);
+
+  time_system_.sleep(std::chrono::seconds(5));
+  TestStream stale(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            stale.filter_->decodeHeaders(request_headers_, true));
+}
+
+TEST_F(CacheFilterTest, NotCacheableResponse) {
+  response_headers_.removeCacheControl();
+  TestStream filler(config_);
+  fill(filler);
+  EXPECT_EQ(1U, counter("not_cacheable"));
+  EXPECT_EQ(0U, counter("insert"));
+
+  TestStream stream(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            stream.filter_->decodeHeaders(request_headers_, true));
+}
+
+TEST_F(CacheFilterTest, NotCacheableRequest) {
+  request_headers_.setMethod("POST");
+  TestStream stream(config_);
+  fill(stream);
+  EXPECT_EQ(0U, counter("miss"));
+  EXPECT_EQ(0U, counter("insert"));
+  EXPECT_EQ(0U, counter("not_cacheable"));
+}
+
+TEST_F(CacheFilterTest, RequestNoCacheRefreshesResponse) {
+  TestStream filler(config_);
+  fill(filler);
+
+  request_headers_.setCacheControl("no-cache");
+  TestStream stream(config_);
+  fill(stream, "new body");
+  EXPECT_EQ(2U, counter("insert"));
+
+  request_headers_.removeCacheControl();
+  TestStream cached(config_);
+  expectCachedResponse(cached, "0", "new body");
+  cached.filter_->decodeHeaders(request_headers_, true);
+}
+
+TEST_F(CacheFilterTest, RequestNoStore) {
+  request_headers_.setCacheControl("no-store");
+  TestStream stream(config_);
+  fill(stream);
+  EXPECT_EQ(0U, counter("insert"));
+}
+
+TEST_F(CacheFilterTest, TooLargeResponse) {
+  initialize(R"EOF(
+in_memory:
+  max_entry_bytes: 100
+)EOF");
+  TestStream filler(config_);
+  fill(filler, std::string(100, 'a'));
+  EXPECT_EQ(1U, counter("not_cacheable"));
+  EXPECT_EQ(0U, counter("insert"));
+}
+
+TEST_F(CacheFilterTest, ResponseWithTrailers) {
+  TestStream filler(config_);
+  filler.filter_->decodeHeaders(request_headers_, true);
+  filler.filter_->encodeHeaders(response_headers_, false);
+  Buffer::OwnedImpl data("body");
+  filler.filter_->encodeData(data, false);
+  Http::TestHeaderMapImpl trailers{{"grpc-status", "0"}};
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filler.filter_->encodeTrailers(trailers));
+  filler.filter_->onDestroy();
+  EXPECT_EQ(1U, counter("not_cacheable"));
+  EXPECT_EQ(0U, counter("insert"));
+}
+
+// The body of a cached response is served without being copied, and stays valid once the response
+// is evicted.
+TEST_F(CacheFilterTest, BodyIsNotCopied) {
+  TestStream filler(config_);
+  fill(filler);
+
+  TestStream stream(config_);
+  Buffer::OwnedImpl served;
+  const void* first_read = nullptr;
+  EXPECT_CALL(stream.decoder_callbacks_, encodeData(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        Buffer::RawSlice slice;
+        data.getRawSlices(&slice, 1);
+        first_read = slice.mem_;
+        served.move(data);
+      }));
+  stream.filter_->decodeHeaders(request_headers_, true);
+
+  TestStream again(config_);
+  EXPECT_CALL(again.decoder_callbacks_, encodeData(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        Buffer::RawSlice slice;
+        data.getRawSlices(&slice, 1);
+        EXPECT_EQ(first_read, slice.mem_);
+      }));
+  again.filter_->decodeHeaders(request_headers_, true);
+
+  // Replace the cached response, the served body still refers to the previous one.
+  time_system_.sleep(std::chrono::seconds(60));
+  TestStream refill(config_);
+  fill(refill, "new body");
+  EXPECT_EQ("body", served.toString());
+}
+
+TEST_F(CacheFilterTest, CoalescedMisses) {
+  TestStream filler(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filler.filter_->decodeHeaders(request_headers_, true));
+
+  TestStream waiter(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiter.filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(1U, counter("coalesced"));
+
+  // The waiter is woken up on its own dispatcher once the response is cached.
+  std::function<void()> wakeup;
+  EXPECT_CALL(waiter.decoder_callbacks_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&wakeup));
+  filler.filter_->encodeHeaders(response_headers_, false);
+  Buffer::OwnedImpl data("body");
+  filler.filter_->encodeData(data, true);
+  ASSERT_TRUE(wakeup != nullptr);
+
+  expectCachedResponse(waiter, "0");
+  EXPECT_CALL(waiter.decoder_callbacks_, continueDecoding()).Times(0);
+  wakeup();
+  EXPECT_EQ(1U, counter("miss"));
+  EXPECT_EQ(1U, counter("hit"));
+}
+
+TEST_F(CacheFilterTest, CoalescedMissOfNotCacheableResponse) {
+  response_headers_.setCacheControl("private");
+  TestStream filler(config_);
+  filler.filter_->decodeHeaders(request_headers_, true);
+  TestStream waiter(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiter.filter_->decodeHeaders(request_headers_, true));
+
+  // The waiter does not wait for the body of a response which is not going to be cached.
+  EXPECT_CALL(waiter.decoder_callbacks_, continueDecoding());
+  filler.filter_->encodeHeaders(response_headers_, false);
+}
+
+TEST_F(CacheFilterTest, CoalescedMissOfResetFiller) {
+  TestStream filler(config_);
+  filler.filter_->decodeHeaders(request_headers_, true);
+  TestStream waiter(config_);
+  waiter.filter_->decodeHeaders(request_headers_, true);
+
+  EXPECT_CALL(waiter.decoder_callbacks_, continueDecoding());
+  filler.filter_->onDestroy();
+
+  // The waiter has been forwarded, so it can insert the response itself.
+  waiter.filter_->encodeHeaders(response_headers_, true);
+  EXPECT_EQ(1U, counter("insert"));
+}
+
+TEST_F(CacheFilterTest, DestroyedWaiter) {
+  TestStream filler(config_);
+  filler.filter_->decodeHeaders(request_headers_, true);
+  TestStream waiter(config_);
+  waiter.filter_->decodeHeaders(request_headers_, true);
+  waiter.filter_->onDestroy();
+
+  EXPECT_CALL(waiter.decoder_callbacks_.dispatcher_, post(_)).Times(0);
+  filler.filter_->encodeHeaders(response_headers_, true);
+}
+
+TEST_F(CacheFilterTest, CoalescingDisabled) {
+  initialize("coalesce_requests: false");
+  TestStream first(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            first.filter_->decodeHeaders(request_headers_, true));
+  TestStream second(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            second.filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(0U, counter("coalesced"));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
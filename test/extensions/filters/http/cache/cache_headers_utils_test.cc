@@ -0,0 +1,173 @@
+#include <chrono>
+
+#include "common/http/header_map_impl.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+TEST(CacheHeadersUtilsTest, ParseCacheControl) {
+  const CacheControl empty = CacheHeadersUtils::parseCacheControl("");
+  EXPECT_FALSE(empty.no_store_ || empty.no_cache_ || empty.private_);
+  EXPECT_FALSE(empty.max_age_.has_value());
+  EXPECT_FALSE(empty.s_maxage_.has_value());
+
+  const CacheControl cache_control =
+      CacheHeadersUtils::parseCacheControl("Public,  MAX-AGE=60 , s-maxage=\"120\", unknown=1");
+  EXPECT_FALSE(cache_control.no_store_ || cache_control.no_cache_ || cache_control.private_);
+  EXPECT_EQ(std::chrono::seconds(60), cache_control.max_age_);
+  EXPECT_EQ(std::chrono::seconds(120), cache_control.s_maxage_);
+
+  const CacheControl no_cache =
+      CacheHeadersUtils::parseCacheControl("no-store, no-cache=\"set-cookie\", private");
+  EXPECT_TRUE(no_cache.no_store_);
+  EXPECT_TRUE(no_cache.no_cache_);
+  EXPECT_TRUE(no_cache.private_);
+
+  EXPECT_EQ(std::chrono::seconds(0), CacheHeadersUtils::parseCacheControl("max-age=-1").max_age_);
+  EXPECT_EQ(std::chrono::seconds(0), CacheHeadersUtils::parseCacheControl("max-age").max_age_);
+  EXPECT_EQ(std::chrono::seconds(1U << 31),
+            CacheHeadersUtils::parseCacheControl("max-age=99999999999").max_age_);
+}
+
+TEST(CacheHeadersUtilsTest, ParseHttpTime) {
+  EXPECT_EQ(SystemTime(std::chrono::seconds(784111777)),
+            CacheHeadersUtils::parseHttpTime("Sun, 06 Nov 1994 08:49:37 GMT"));
+  EXPECT_FALSE(CacheHeadersUtils::parseHttpTime("0").has_value());
+  EXPECT_FALSE(CacheHeadersUtils::parseHttpTime("Sunday, 06-Nov-94 08:49:37 GMT").has_value());
+}
+
+TEST(CacheHeadersUtilsTest, RequestCacheability) {
+  Http::TestHeaderMapImpl headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "example.com"}};
+  RequestCacheability cacheability = CacheHeadersUtils::requestCacheability(headers, true);
+  EXPECT_TRUE(cacheability.lookup_);
+  EXPECT_TRUE(cacheability.insert_);
+
+  // A request with a body.
+  cacheability = CacheHeadersUtils::requestCacheability(headers, false);
+  EXPECT_FALSE(cacheability.lookup_ || cacheability.insert_);
+
+  {
+    Http::TestHeaderMapImpl post(headers);
+    post.setMethod("POST");
+    cacheability = CacheHeadersUtils::requestCacheability(post, true);
+    EXPECT_FALSE(cacheability.lookup_ || cacheability.insert_);
+  }
+  {
+    Http::TestHeaderMapImpl authorization(headers);
+    authorization.setAuthorization("Basic");
+    cacheability = CacheHeadersUtils::requestCacheability(authorization, true);
+    EXPECT_FALSE(cacheability.lookup_ || cacheability.insert_);
+  }
+  {
+    Http::TestHeaderMapImpl range(headers);
+    range.addCopy("range", "bytes=0-10");
+    cacheability = CacheHeadersUtils::requestCacheability(range, true);
+    EXPECT_FALSE(cacheability.lookup_ || cacheability.insert_);
+  }
+  {
+    Http::TestHeaderMapImpl no_cache(headers);
+    no_cache.setCacheControl("max-age=0");
+    cacheability = CacheHeadersUtils::requestCacheability(no_cache, true);
+    EXPECT_FALSE(cacheability.lookup_);
+    EXPECT_TRUE(cacheability.insert_);
+  }
+  {
+    Http::TestHeaderMapImpl pragma(headers);
+    pragma.addCopy("pragma", "no-cache");
+    cacheability = CacheHeadersUtils::requestCacheability(pragma, true);
+    EXPECT_FALSE(cacheability.lookup_);
+    EXPECT_TRUE(cacheability.insert_);
+
+    // Pragma is ignored in the presence of Cache-Control.
+    pragma.setCacheControl("max-age=10");
+    cacheability = CacheHeadersUtils::requestCacheability(pragma, true);
+    EXPECT_TRUE(cacheability.lookup_);
+  }
+  {
+    Http::TestHeaderMapImpl no_store(headers);
+    no_store.setCacheControl("no-store");
+    cacheability = CacheHeadersUtils::requestCacheability(no_store, true);
+    EXPECT_FALSE(cacheability.lookup_ || cacheability.insert_);
+  }
+}
+
+TEST(CacheHeadersUtilsTest, FreshnessLifetime) {
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"cache-control", "max-age=60"}};
+  EXPECT_EQ(std::chrono::seconds(60), CacheHeadersUtils::freshnessLifetime(headers));
+
+  // s-maxage takes precedence for a shared cache.
+  headers.setCacheControl("max-age=60, s-maxage=10");
+  EXPECT_EQ(std::chrono::seconds(10), CacheHeadersUtils::freshnessLifetime(headers));
+
+  // Max-age takes precedence over Expires.
+  headers.setCacheControl("max-age=60");
+  headers.setDate("Sun, 06 Nov 1994 08:49:37 GMT");
+  headers.addCopy("expires", "Sun, 06 Nov 1994 08:50:37 GMT");
+  EXPECT_EQ(std::chrono::seconds(60), CacheHeadersUtils::freshnessLifetime(headers));
+  headers.removeCacheControl();
+  EXPECT_EQ(std::chrono::seconds(60), CacheHeadersUtils::freshnessLifetime(headers));
+
+  // An invalid Expires means that the response is already stale.
+  headers.remove(Http::LowerCaseString("expires"));
+  headers.addCopy("expires", "0");
+  EXPECT_EQ(std::chrono::seconds(0), CacheHeadersUtils::freshnessLifetime(headers));
+
+  // Heuristic freshness is not supported.
+  headers.remove(Http::LowerCaseString("expires"));
+  EXPECT_FALSE(CacheHeadersUtils::freshnessLifetime(headers).has_value());
+
+  for (const std::string cache_control : {"no-store", "no-cache", "private, max-age=60"}) {
+    headers.setCacheControl(cache_control);
+    EXPECT_FALSE(CacheHeadersUtils::freshnessLifetime(headers).has_value()) << cache_control;
+  }
+
+  headers.setCacheControl("max-age=60");
+  headers.setVary("accept-encoding");
+  EXPECT_FALSE(CacheHeadersUtils::freshnessLifetime(headers).has_value());
+  headers.removeVary();
+
+  headers.setStatus(206);
+  EXPECT_FALSE(CacheHeadersUtils::freshnessLifetime(headers).has_value());
+  headers.setStatus(404);
+  EXPECT_EQ(std::chrono::seconds(60), CacheHeadersUtils::freshnessLifetime(headers));
+}
+
+TEST(CacheHeadersUtilsTest, InitialAge) {
+  const SystemTime response_time = SystemTime(std::chrono::seconds(784111777));
+  Http::TestHeaderMapImpl headers{{":status", "200"}};
+  EXPECT_EQ(std::chrono::seconds(0), CacheHeadersUtils::initialAge(headers, response_time));
+
+  headers.setDate("Sun, 06 Nov 1994 08:49:27 GMT");
+  EXPECT_EQ(std::chrono::seconds(10), CacheHeadersUtils::initialAge(headers, response_time));
+
+  headers.addCopy("age", "30");
+  EXPECT_EQ(std::chrono::seconds(30), CacheHeadersUtils::initialAge(headers, response_time));
+
+  // A date in the future does not make the response younger than its Age.
+  headers.setDate("Sun, 06 Nov 1994 09:49:27 GMT");
+  EXPECT_EQ(std::chrono::seconds(30), CacheHeadersUtils::initialAge(headers, response_time));
+}
+
+TEST(CacheHeadersUtilsTest, CacheKey) {
+  Http::TestHeaderMapImpl headers{
+      {":method", "GET"}, {":path", "/path?query"}, {":authority", "Example.com"}};
+  EXPECT_EQ("http://example.com/path?query", CacheHeadersUtils::cacheKey(headers));
+  headers.setForwardedProto("https");
+  EXPECT_EQ("https://example.com/path?query", CacheHeadersUtils::cacheKey(headers));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
+#include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.validate.h"
+
+#include "extensions/filters/http/cache/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+TEST(CacheFilterFactoryTest, CacheFilter) {
+  const std::string yaml_string = R"EOF(
+  in_memory:
+    max_size_bytes: 1048576
+    shard_count: 4
+  coalesce_requests: true
+  )EOF";
+
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml_string, proto_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CacheFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CacheFilterFactoryTest, EmptyConfig) {
+  CacheFilterFactory factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Http::FilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(*factory.createEmptyConfigProto(), "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CacheFilterFactoryTest, InvalidShardCount) {
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig proto_config;
+  proto_config.mutable_in_memory()->mutable_shard_count()->set_value(0);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CacheFilterFactory factory;
+  EXPECT_THROW(factory.createFilterFactoryFromProto(proto_config, "stats", context),
+               ProtoValidationException);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
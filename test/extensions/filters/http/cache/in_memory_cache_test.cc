@@ -0,0 +1,101 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/http/header_map_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/cache/in_memory_cache.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class InMemoryCacheTest : public testing::Test {
+public:
+  InMemoryCacheTest() : cache_(1000, 500, 1, "cache.", store_) {}
+
+  // Make a response of the given size once stored under a single character key.
+  CachedResponseConstSharedPtr makeResponse(uint64_t size, std::chrono::seconds lifetime) {
+    Http::HeaderMapPtr headers{new Http::TestHeaderMapImpl{{":status", "200"}}};
+    const uint64_t body_size = size - 1 - headers->byteSize();
+    return std::make_shared<const CachedResponse>(std::move(headers), std::string(body_size, 'a'),
+                                                  now_, std::chrono::seconds(0), lifetime);
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return store_.gauge("cache." + name, Stats::Gauge::ImportMode::Accumulate).value();
+  }
+
+  const SystemTime now_{std::chrono::hours(400000)};
+  Stats::IsolatedStoreImpl store_;
+  InMemoryCache cache_;
+};
+
+TEST_F(InMemoryCacheTest, InsertAndLookup) {
+  EXPECT_EQ(nullptr, cache_.lookup("a", now_));
+  CachedResponseConstSharedPtr response = makeResponse(100, std::chrono::seconds(60));
+  cache_.insert("a", CachedResponseConstSharedPtr(response));
+  EXPECT_EQ(response, cache_.lookup("a", now_));
+  EXPECT_EQ(nullptr, cache_.lookup("b", now_));
+  EXPECT_EQ(1U, gauge("entries"));
+  EXPECT_EQ(100U, gauge("size_bytes"));
+
+  // A new response replaces the previous one.
+  CachedResponseConstSharedPtr replacement = makeResponse(200, std::chrono::seconds(60));
+  cache_.insert("a", CachedResponseConstSharedPtr(replacement));
+  EXPECT_EQ(replacement, cache_.lookup("a", now_));
+  EXPECT_EQ(1U, gauge("entries"));
+  EXPECT_EQ(200U, gauge("size_bytes"));
+}
+
+TEST_F(InMemoryCacheTest, StaleResponseIsRemoved) {
+  cache_.insert("a", makeResponse(100, std::chrono::seconds(60)));
+  EXPECT_NE(nullptr, cache_.lookup("a", now_ + std::chrono::seconds(59)));
+  EXPECT_EQ(nullptr, cache_.lookup("a", now_ + std::chrono::seconds(60)));
+  EXPECT_EQ(0U, gauge("entries"));
+  EXPECT_EQ(0U, gauge("size_bytes"));
+}
+
+TEST_F(InMemoryCacheTest, EvictLeastRecentlyUsed) {
+  cache_.insert("a", makeResponse(400, std::chrono::seconds(60)));
+  cache_.insert("b", makeResponse(400, std::chrono::seconds(60)));
+  // Make b the least recently used response.
+  EXPECT_NE(nullptr, cache_.lookup("a", now_));
+  cache_.insert("c", makeResponse(400, std::chrono::seconds(60)));
+
+  EXPECT_NE(nullptr, cache_.lookup("a", now_));
+  EXPECT_EQ(nullptr, cache_.lookup("b", now_));
+  EXPECT_NE(nullptr, cache_.lookup("c", now_));
+  EXPECT_EQ(1U, store_.counter("cache.eviction").value());
+  EXPECT_EQ(800U, gauge("size_bytes"));
+}
+
+TEST_F(InMemoryCacheTest, TooLargeResponse) {
+  cache_.insert("a", makeResponse(501, std::chrono::seconds(60)));
+  EXPECT_EQ(nullptr, cache_.lookup("a", now_));
+  EXPECT_EQ(0U, gauge("entries"));
+}
+
+TEST(InMemoryCacheShardingTest, ShardsShareTheBudget) {
+  Stats::IsolatedStoreImpl store;
+  InMemoryCache cache(1000, 1000, 4, "cache.", store);
+  Http::HeaderMapPtr headers{new Http::TestHeaderMapImpl{{":status", "200"}}};
+  // A response larger than the share of a shard is not stored.
+  cache.insert("a", std::make_shared<const CachedResponse>(
+                        std::move(headers), std::string(300, 'a'), SystemTime(),
+                        std::chrono::seconds(0), std::chrono::seconds(60)));
+  EXPECT_EQ(nullptr, cache.lookup("a", SystemTime()));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,61 @@
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.h"
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.validate.h"
+
+#include "extensions/filters/http/decompressor/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Decompressor {
+namespace {
+
+TEST(DecompressorFilterFactoryTest, DecompressorFilter) {
+  const std::string yaml_string = R"EOF(
+  decompress_requests: false
+  chunk_size: 8192
+  max_ratio: 20
+  )EOF";
+
+  envoy::extensions::filters::http::decompressor::v3alpha::Decompressor proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml_string, proto_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  DecompressorFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(DecompressorFilterFactoryTest, EmptyConfig) {
+  DecompressorFilterFactory factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Http::FilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(*factory.createEmptyConfigProto(), "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(DecompressorFilterFactoryTest, InvalidChunkSize) {
+  envoy::extensions::filters::http::decompressor::v3alpha::Decompressor proto_config;
+  proto_config.mutable_chunk_size()->set_value(1024);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  DecompressorFilterFactory factory;
+  EXPECT_THROW(factory.createFilterFactoryFromProto(proto_config, "stats", context),
+               ProtoValidationException);
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,172 @@
+#include "envoy/extensions/filters/http/decompressor/v3alpha/decompressor.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/compressor/zlib_compressor_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/decompressor/decompressor_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Decompressor {
+namespace {
+
+class DecompressorFilterTest : public testing::Test {
+protected:
+  DecompressorFilterTest() { setUpFilter("{}"); }
+
+  void setUpFilter(const std::string& yaml) {
+    envoy::extensions::filters::http::decompressor::v3alpha::Decompressor proto_config;
+    TestUtility::loadFromYaml(yaml, proto_config);
+    config_ = std::make_shared<DecompressorFilterConfig>(proto_config, "test.", stats_);
+    filter_ = std::make_unique<DecompressorFilter>(config_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  }
+
+  // Compress the supplied data, with a gzip header and trailer unless window_bits says otherwise.
+  static std::string compress(const std::string& data, int64_t window_bits = 31) {
+    Compressor::ZlibCompressorImpl compressor;
+    compressor.init(Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                    Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, window_bits, 8);
+    Buffer::OwnedImpl buffer(data);
+    compressor.compress(buffer, Compressor::State::Finish);
+    return buffer.toString();
+  }
+
+  // A body which compresses well below the default maximum ratio.
+  static std::string makeBody() {
+    std::string body;
+    for (uint32_t i = 0; i < 2000; i++) {
+      absl::StrAppend(&body, i * 7919, ",");
+    }
+    return body;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_.counter("test.decompressor." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  DecompressorFilterConfigSharedPtr config_;
+  std::unique_ptr<DecompressorFilter> filter_;
+};
+
+TEST_F(DecompressorFilterTest, DecompressGzipRequest) {
+  const std::string body = makeBody();
+  Http::TestHeaderMapImpl headers{{":method", "POST"},
+                                  {"content-encoding", "gzip"},
+                                  {"content-length", "100"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has("content-encoding"));
+  EXPECT_FALSE(headers.has("content-length"));
+
+  // Split the compressed body, so that the stream state carries over between the calls.
+  const std::string compressed = compress(body);
+  Buffer::OwnedImpl first(compressed.substr(0, 10));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(first, false));
+  Buffer::OwnedImpl second(compressed.substr(10));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(second, true));
+  EXPECT_EQ(body, first.toString() + second.toString());
+
+  EXPECT_EQ(1, counter("request_decompressed"));
+  EXPECT_EQ(compressed.size(), counter("total_compressed_bytes"));
+  EXPECT_EQ(body.size(), counter("total_uncompressed_bytes"));
+}
+
+TEST_F(DecompressorFilterTest, DecompressDeflateResponse) {
+  const std::string body = makeBody();
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-encoding", " Deflate "}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has("content-encoding"));
+
+  Buffer::OwnedImpl data(compress(body, 15));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+  EXPECT_EQ(body, data.toString());
+  EXPECT_EQ(1, counter("response_decompressed"));
+}
+
+TEST_F(DecompressorFilterTest, PassThroughUnknownEncoding) {
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-encoding", "gzip, br"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ("gzip, br", headers.get_("content-encoding"));
+
+  Buffer::OwnedImpl data("not compressed");
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+  EXPECT_EQ("not compressed", data.toString());
+  EXPECT_EQ(0, counter("response_decompressed"));
+}
+
+TEST_F(DecompressorFilterTest, HeadersOnly) {
+  Http::TestHeaderMapImpl headers{{":status", "204"}, {"content-encoding", "gzip"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, true));
+  EXPECT_EQ("gzip", headers.get_("content-encoding"));
+}
+
+TEST_F(DecompressorFilterTest, RequestsDisabled) {
+  setUpFilter("decompress_requests: false");
+  Http::TestHeaderMapImpl headers{{":method", "POST"}, {"content-encoding", "gzip"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ("gzip", headers.get_("content-encoding"));
+  EXPECT_EQ(0, counter("request_decompressed"));
+}
+
+TEST_F(DecompressorFilterTest, InvalidRequestBody) {
+  Http::TestHeaderMapImpl headers{{":method", "POST"}, {"content-encoding", "gzip"}};
+  filter_->decodeHeaders(headers, false);
+
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::BadRequest, _, _, _,
+                                                 "decompressor_invalid_request_body"));
+  Buffer::OwnedImpl data("not compressed");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(data, true));
+  EXPECT_EQ(1, counter("decompression_error"));
+}
+
+TEST_F(DecompressorFilterTest, MaxRatioExceeded) {
+  setUpFilter("max_ratio: 10");
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-encoding", "gzip"}};
+  filter_->encodeHeaders(headers, false);
+
+  EXPECT_CALL(encoder_callbacks_, resetStream());
+  Buffer::OwnedImpl data(compress(std::string(1024 * 1024, 'a')));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(data, true));
+  EXPECT_EQ(1, counter("max_ratio_exceeded"));
+  // The bomb is caught long before a whole chunk of it is inflated.
+  EXPECT_LE(counter("total_uncompressed_bytes"), counter("total_compressed_bytes") * 10 + 1032);
+}
+
+// The ratio applies to the whole body rather than to each slice of it.
+TEST_F(DecompressorFilterTest, MaxRatioExceededAcrossSlices) {
+  setUpFilter("max_ratio: 10");
+  Http::TestHeaderMapImpl headers{{":method", "POST"}, {"content-encoding", "gzip"}};
+  filter_->decodeHeaders(headers, false);
+
+  // The first slice is a plain body, which decompresses well within the ratio.
+  const std::string compressed = compress(makeBody() + std::string(1024 * 1024, 'a'));
+  Buffer::OwnedImpl first(compressed.substr(0, 4000));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(first, false));
+
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::BadRequest, _, _, _, _));
+  Buffer::OwnedImpl second(compressed.substr(4000));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(second, true));
+  EXPECT_EQ(1, counter("max_ratio_exceeded"));
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
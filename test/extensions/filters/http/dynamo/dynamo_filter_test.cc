@@ -56,8 +56,7 @@ TEST_F(DynamoFilterTest, operatorPresent) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.Get"}, {"random", "random"}};
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
   Http::MetadataMap metadata_map{{"metadata", "metadata"}};
   EXPECT_EQ(Http::FilterMetadataStatus::Continue, filter_->decodeMetadata(metadata_map));
   EXPECT_EQ(Http::FilterMetadataStatus::Continue, filter_->encodeMetadata(metadata_map));
@@ -101,8 +100,7 @@ TEST_F(DynamoFilterTest, jsonBodyNotWellFormed) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::OwnedImpl buffer;
   buffer.add("test", 4);
@@ -116,8 +114,7 @@ TEST_F(DynamoFilterTest, bothOperationAndTableIncorrect) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version"}, {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation_missing"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.table_missing"));
@@ -130,15 +127,13 @@ TEST_F(DynamoFilterTest, handleErrorTypeTableMissing) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version"}, {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation_missing"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.table_missing"));
 
   Http::TestHeaderMapImpl response_headers{{":status", "400"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
   Buffer::InstancePtr error_data(new Buffer::OwnedImpl());
   std::string internal_error =
@@ -147,10 +142,10 @@ TEST_F(DynamoFilterTest, handleErrorTypeTableMissing) {
   EXPECT_CALL(stats_, counter("prefix.dynamodb.error.no_table.ValidationException"));
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*error_data, true));
 
+  // A second response, ending with trailers.
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
   error_data->add("}", 1);
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer,
-            filter_->encodeData(*error_data, false));
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillRepeatedly(Return(error_data.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*error_data, false));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.invalid_resp_body"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation_missing"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.table_missing"));
@@ -162,8 +157,7 @@ TEST_F(DynamoFilterTest, HandleErrorTypeTablePresent) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::OwnedImpl buffer;
   std::string buffer_content = "{\"TableName\":\"locations\"}";
@@ -171,8 +165,7 @@ TEST_F(DynamoFilterTest, HandleErrorTypeTablePresent) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(buffer, true));
 
   Http::TestHeaderMapImpl response_headers{{":status", "400"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
   Buffer::OwnedImpl error_data;
   std::string internal_error =
@@ -234,8 +227,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTables) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -248,8 +240,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTables) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -286,8 +277,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -300,8 +290,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -330,10 +319,8 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
                                    "prefix.dynamodb.operation.BatchGetItem.upstream_rq_time"),
                           _));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
 {
@@ -347,8 +334,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.error.table_1.BatchFailureUnprocessedKeys"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.error.table_2.BatchFailureUnprocessedKeys"));
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillRepeatedly(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
@@ -356,8 +342,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -370,8 +355,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -400,10 +384,8 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
                                    "prefix.dynamodb.operation.BatchGetItem.upstream_rq_time"),
                           _));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
 {
@@ -413,8 +395,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
 )EOF";
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
@@ -422,8 +403,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -436,8 +416,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -466,10 +445,8 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
                                    "prefix.dynamodb.operation.BatchGetItem.upstream_rq_time"),
                           _));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
 {
@@ -483,24 +460,22 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
   response_data->add("}", 1);
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.invalid_resp_body"));
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, bothOperationAndTableCorrect) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"}};
+  // The table name is split across data frames, which are not buffered by the filter.
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
-  std::string buffer_content = "{\"TableName\":\"locations\"";
+  std::string buffer_content = "{\"TableName\":\"loca";
   buffer->add(buffer_content);
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
   Buffer::OwnedImpl data;
-  data.add("}", 1);
+  data.add("tions\"}");
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(data, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation.GetItem.upstream_rq_total_2xx"));
@@ -575,13 +550,11 @@ TEST_F(DynamoFilterTest, PartitionIdStats) {
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = "{\"TableName\":\"locations\"";
   buffer->add(buffer_content);
-  ON_CALL(decoder_callbacks_, decodingBuffer()).WillByDefault(Return(buffer.get()));
   Buffer::OwnedImpl data;
   data.add("}", 1);
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(data, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation.GetItem.upstream_rq_total_2xx"));
@@ -638,10 +611,8 @@ TEST_F(DynamoFilterTest, PartitionIdStats) {
       .Times(1);
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
     {
@@ -656,8 +627,7 @@ TEST_F(DynamoFilterTest, PartitionIdStats) {
 
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
@@ -674,11 +644,9 @@ TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
 }
 )EOF";
   buffer->add(buffer_content);
-  ON_CALL(decoder_callbacks_, decodingBuffer()).WillByDefault(Return(buffer.get()));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.multiple_tables"));
@@ -716,10 +684,8 @@ TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
       .Times(0);
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
     {
@@ -734,8 +700,7 @@ TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
 
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
@@ -751,11 +716,9 @@ TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
 }
 )EOF";
   buffer->add(buffer_content);
-  ON_CALL(decoder_callbacks_, decodingBuffer()).WillByDefault(Return(buffer.get()));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.multiple_tables")).Times(0);
@@ -816,10 +779,8 @@ TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
       .Times(1);
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
     {
@@ -834,8 +795,7 @@ TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
 
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 } // namespace
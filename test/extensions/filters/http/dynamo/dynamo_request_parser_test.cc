@@ -1,8 +1,8 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/http/header_map_impl.h"
-#include "common/json/json_loader.h"
 
 #include "extensions/filters/http/dynamo/dynamo_request_parser.h"
 
@@ -17,6 +17,56 @@ namespace HttpFilters {
 namespace Dynamo {
 namespace {
 
+// Parses the body at once, and one byte at a time for the tokens to be split across pieces.
+RequestParser::TableDescriptor parseTable(const std::string& operation, const std::string& body) {
+  RequestParser::TableParser split_parser(operation);
+  for (const char c : body) {
+    Buffer::OwnedImpl data(&c, 1);
+    split_parser.parse(data);
+  }
+  EXPECT_TRUE(split_parser.finish());
+
+  RequestParser::TableParser parser(operation);
+  Buffer::OwnedImpl data(body);
+  parser.parse(data);
+  EXPECT_TRUE(parser.finish());
+  EXPECT_EQ(parser.table().table_name, split_parser.table().table_name);
+  EXPECT_EQ(parser.table().is_single_table, split_parser.table().is_single_table);
+  return parser.table();
+}
+
+bool isValidRequest(const std::string& operation, const std::string& body) {
+  RequestParser::TableParser parser(operation);
+  Buffer::OwnedImpl data(body);
+  parser.parse(data);
+  return parser.finish();
+}
+
+std::unique_ptr<RequestParser::ResponseParser> parseResponse(const std::string& body) {
+  auto split_parser = std::make_unique<RequestParser::ResponseParser>(true, true);
+  for (const char c : body) {
+    Buffer::OwnedImpl data(&c, 1);
+    split_parser->parse(data);
+  }
+  EXPECT_TRUE(split_parser->finish());
+
+  auto parser = std::make_unique<RequestParser::ResponseParser>(true, true);
+  Buffer::OwnedImpl data(body);
+  parser->parse(data);
+  EXPECT_TRUE(parser->finish());
+  EXPECT_EQ(parser->errorType(), split_parser->errorType());
+  EXPECT_EQ(parser->unprocessedTables(), split_parser->unprocessedTables());
+  EXPECT_EQ(parser->partitions().size(), split_parser->partitions().size());
+  return parser;
+}
+
+bool isValidResponse(const std::string& body) {
+  RequestParser::ResponseParser parser(true, true);
+  Buffer::OwnedImpl data(body);
+  parser.parse(data);
+  return parser.finish();
+}
+
 TEST(DynamoRequestParser, parseOperation) {
   // Well formed x-amz-target header, in a format, Version.Operation
   {
@@ -57,21 +107,19 @@ TEST(DynamoRequestParser, parseTableNameSingleOperation) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
     // Supported operation
     for (const std::string& operation : supported_single_operations) {
-      EXPECT_EQ("Pets", RequestParser::parseTable(operation, *json_data).table_name);
+      EXPECT_EQ("Pets", parseTable(operation, json_string).table_name);
     }
 
     // Not supported operation
-    EXPECT_EQ("", RequestParser::parseTable("NotSupportedOperation", *json_data).table_name);
+    EXPECT_EQ("", parseTable("NotSupportedOperation", json_string).table_name);
   }
 
-  {
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(R"({"TableName":"Pets"})");
-    EXPECT_EQ("Pets", RequestParser::parseTable("GetItem", *json_data).table_name);
-  }
+  EXPECT_EQ("Pets", parseTable("GetItem", R"({"TableName":"Pets"})").table_name);
+  EXPECT_EQ("Pets", parseTable("GetItem", R"({"Key":{"TableName":"Strays"},"TableName":"Pets"})")
+                        .table_name);
+  EXPECT_EQ("P\"ets\u00e9", parseTable("GetItem", R"({"TableName":"P\"ets\u00e9"})").table_name);
 }
 
 TEST(DynamoRequestParser, parseTableNameTransactOperation) {
@@ -88,10 +136,8 @@ TEST(DynamoRequestParser, parseTableNameTransactOperation) {
       ]
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
     for (const std::string& operation : supported_transact_operations) {
-      RequestParser::TableDescriptor table = RequestParser::parseTable(operation, *json_data);
+      RequestParser::TableDescriptor table = parseTable(operation, json_string);
       EXPECT_EQ("Pets", table.table_name);
       EXPECT_TRUE(table.is_single_table);
     }
@@ -109,10 +155,8 @@ TEST(DynamoRequestParser, parseTableNameTransactOperation) {
       ]
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
     for (const std::string& operation : supported_transact_operations) {
-      RequestParser::TableDescriptor table = RequestParser::parseTable(operation, *json_data);
+      RequestParser::TableDescriptor table = parseTable(operation, json_string);
       EXPECT_EQ("", table.table_name);
       EXPECT_FALSE(table.is_single_table);
     }
@@ -130,10 +174,8 @@ TEST(DynamoRequestParser, parseTableNameTransactOperation) {
       ]
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
     for (const std::string& operation : supported_transact_operations) {
-      RequestParser::TableDescriptor table = RequestParser::parseTable(operation, *json_data);
+      RequestParser::TableDescriptor table = parseTable(operation, json_string);
       EXPECT_EQ("", table.table_name);
       EXPECT_TRUE(table.is_single_table);
     }
@@ -141,23 +183,32 @@ TEST(DynamoRequestParser, parseTableNameTransactOperation) {
 }
 
 TEST(DynamoRequestParser, parseErrorType) {
-  {
-    EXPECT_EQ("ResourceNotFoundException",
-              RequestParser::parseErrorType(*Json::Factory::loadFromString(
-                  "{\"__type\":\"com.amazonaws.dynamodb.v20120810#ResourceNotFoundException\"}")));
-  }
-
-  {
-    EXPECT_EQ("ResourceNotFoundException",
-              RequestParser::parseErrorType(*Json::Factory::loadFromString(
-                  "{\"__type\":\"com.amazonaws.dynamodb.v20120810#ResourceNotFoundException\","
-                  "\"message\":\"Requested resource not found: Table: tablename not found\"}")));
-  }
+  EXPECT_EQ("ResourceNotFoundException",
+            RequestParser::parseErrorType(
+                "com.amazonaws.dynamodb.v20120810#ResourceNotFoundException"));
+  EXPECT_EQ("", RequestParser::parseErrorType("UnKnownError"));
+  EXPECT_EQ("", RequestParser::parseErrorType(""));
+}
 
-  {
-    EXPECT_EQ("", RequestParser::parseErrorType(
-                      *Json::Factory::loadFromString("{\"__type\":\"UnKnownError\"}")));
-  }
+TEST(DynamoRequestParser, parseErrorTypeFromResponse) {
+  EXPECT_EQ("ResourceNotFoundException",
+            parseResponse(
+                "{\"__type\":\"com.amazonaws.dynamodb.v20120810#ResourceNotFoundException\"}")
+                ->errorType());
+  EXPECT_EQ("ResourceNotFoundException",
+            parseResponse(
+                "{\"__type\":\"com.amazonaws.dynamodb.v20120810#ResourceNotFoundException\","
+                "\"message\":\"Requested resource not found: Table: tablename not found\"}")
+                ->errorType());
+  EXPECT_EQ("", parseResponse("{\"__type\":\"UnKnownError\"}")->errorType());
+  EXPECT_EQ("", parseResponse("{\"error\":{\"__type\":\"ThrottlingException\"}}")->errorType());
+
+  // The error type is only extracted when asked for.
+  RequestParser::ResponseParser parser(false, false);
+  Buffer::OwnedImpl data("{\"__type\":\"ThrottlingException\"}");
+  parser.parse(data);
+  EXPECT_TRUE(parser.finish());
+  EXPECT_EQ("", parser.errorType());
 }
 
 TEST(DynamoRequestParser, parseTableNameBatchOperation) {
@@ -170,9 +221,7 @@ TEST(DynamoRequestParser, parseTableNameBatchOperation) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
-    RequestParser::TableDescriptor table = RequestParser::parseTable("BatchGetItem", *json_data);
+    RequestParser::TableDescriptor table = parseTable("BatchGetItem", json_string);
     EXPECT_EQ("", table.table_name);
     EXPECT_FALSE(table.is_single_table);
   }
@@ -186,9 +235,7 @@ TEST(DynamoRequestParser, parseTableNameBatchOperation) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
-    RequestParser::TableDescriptor table = RequestParser::parseTable("BatchGetItem", *json_data);
+    RequestParser::TableDescriptor table = parseTable("BatchGetItem", json_string);
     EXPECT_EQ("table_2", table.table_name);
     EXPECT_TRUE(table.is_single_table);
   }
@@ -203,9 +250,7 @@ TEST(DynamoRequestParser, parseTableNameBatchOperation) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
-    RequestParser::TableDescriptor table = RequestParser::parseTable("BatchGetItem", *json_data);
+    RequestParser::TableDescriptor table = parseTable("BatchGetItem", json_string);
     EXPECT_EQ("", table.table_name);
     EXPECT_FALSE(table.is_single_table);
   }
@@ -219,54 +264,63 @@ TEST(DynamoRequestParser, parseTableNameBatchOperation) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
-    RequestParser::TableDescriptor table = RequestParser::parseTable("BatchWriteItem", *json_data);
+    RequestParser::TableDescriptor table = parseTable("BatchWriteItem", json_string);
     EXPECT_EQ("table_2", table.table_name);
     EXPECT_TRUE(table.is_single_table);
   }
 
   {
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString("{}");
-    RequestParser::TableDescriptor table =
-        RequestParser::parseTable("BatchWriteItem", *Json::Factory::loadFromString("{}"));
+    RequestParser::TableDescriptor table = parseTable("BatchWriteItem", "{}");
     EXPECT_EQ("", table.table_name);
     EXPECT_TRUE(table.is_single_table);
   }
 
   {
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString("{\"RequestItems\":{}}");
-    RequestParser::TableDescriptor table = RequestParser::parseTable("BatchWriteItem", *json_data);
+    RequestParser::TableDescriptor table = parseTable("BatchWriteItem", "{\"RequestItems\":{}}");
     EXPECT_EQ("", table.table_name);
     EXPECT_TRUE(table.is_single_table);
   }
 
   {
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString("{}");
-    RequestParser::TableDescriptor table = RequestParser::parseTable("BatchGetItem", *json_data);
+    RequestParser::TableDescriptor table = parseTable("BatchGetItem", "{}");
     EXPECT_EQ("", table.table_name);
     EXPECT_TRUE(table.is_single_table);
   }
 }
-TEST(DynamoRequestParser, parseBatchUnProcessedKeys) {
-  {
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString("{}");
-    std::vector<std::string> unprocessed_tables =
-        RequestParser::parseBatchUnProcessedKeys(*json_data);
-    EXPECT_EQ(0u, unprocessed_tables.size());
-  }
-  {
-    std::vector<std::string> unprocessed_tables = RequestParser::parseBatchUnProcessedKeys(
-        *Json::Factory::loadFromString("{\"UnprocessedKeys\":{}}"));
-    EXPECT_EQ(0u, unprocessed_tables.size());
-  }
 
-  {
-    std::vector<std::string> unprocessed_tables = RequestParser::parseBatchUnProcessedKeys(
-        *Json::Factory::loadFromString(R"({"UnprocessedKeys":{"table_1" :{}}})"));
-    EXPECT_EQ("table_1", unprocessed_tables[0]);
-    EXPECT_EQ(1u, unprocessed_tables.size());
-  }
+TEST(DynamoRequestParser, parseTableInvalidBody) {
+  // Not JSON, or not a single JSON value.
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"TableName\":\"Pets\""));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"TableName\":\"Pets\"}}"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"TableName\":\"Pets\",}"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"TableName\":\"Pets\"} {}"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"TableName\":\"Pe\\xts\"}"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"Limit\":01}"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"Limit\":1.}"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"Consistent\":tru}"));
+  EXPECT_FALSE(isValidRequest("NotSupportedOperation", "[1,]"));
+
+  // Fields of interest of the wrong type.
+  EXPECT_FALSE(isValidRequest("GetItem", "[]"));
+  EXPECT_FALSE(isValidRequest("GetItem", "{\"TableName\":1}"));
+  EXPECT_FALSE(isValidRequest("BatchGetItem", "{\"RequestItems\":[]}"));
+  EXPECT_FALSE(isValidRequest("TransactGetItems", "{\"TransactItems\":{}}"));
+  EXPECT_FALSE(isValidRequest("TransactGetItems", "{\"TransactItems\":[1]}"));
+  EXPECT_FALSE(isValidRequest("TransactGetItems", "{\"TransactItems\":[{\"Get\":[]}]}"));
+  EXPECT_FALSE(
+      isValidRequest("TransactGetItems", "{\"TransactItems\":[{\"Get\":{\"TableName\":null}}]}"));
+
+  // Any JSON is valid for the operations no table is extracted for.
+  EXPECT_TRUE(isValidRequest("NotSupportedOperation", "[1, -2.5e+3, true, false, null]"));
+  EXPECT_TRUE(isValidRequest("NotSupportedOperation", "{\"TableName\":1}"));
+  EXPECT_TRUE(isValidRequest("GetItem", "{\"Key\":{\"TableName\":[]}}"));
+}
+
+TEST(DynamoRequestParser, parseBatchUnProcessedKeys) {
+  EXPECT_EQ(0u, parseResponse("{}")->unprocessedTables().size());
+  EXPECT_EQ(0u, parseResponse("{\"UnprocessedKeys\":{}}")->unprocessedTables().size());
+  EXPECT_EQ(std::vector<std::string>{"table_1"},
+            parseResponse(R"({"UnprocessedKeys":{"table_1" :{}}})")->unprocessedTables());
 
   {
     std::string json_string = R"EOF(
@@ -277,34 +331,18 @@ TEST(DynamoRequestParser, parseBatchUnProcessedKeys) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
-    std::vector<std::string> unprocessed_tables =
-        RequestParser::parseBatchUnProcessedKeys(*json_data);
-    EXPECT_TRUE(find(unprocessed_tables.begin(), unprocessed_tables.end(), "table_1") !=
-                unprocessed_tables.end());
-    EXPECT_TRUE(find(unprocessed_tables.begin(), unprocessed_tables.end(), "table_2") !=
-                unprocessed_tables.end());
-    EXPECT_EQ(2u, unprocessed_tables.size());
+    EXPECT_EQ((std::vector<std::string>{"table_1", "table_2"}),
+              parseResponse(json_string)->unprocessedTables());
   }
+
+  EXPECT_FALSE(isValidResponse("{\"UnprocessedKeys\":[]}"));
 }
 
 TEST(DynamoRequestParser, parsePartitionIds) {
-  {
-    std::vector<RequestParser::PartitionDescriptor> partitions =
-        RequestParser::parsePartitions(*Json::Factory::loadFromString("{}"));
-    EXPECT_EQ(0u, partitions.size());
-  }
-  {
-    std::vector<RequestParser::PartitionDescriptor> partitions =
-        RequestParser::parsePartitions(*Json::Factory::loadFromString("{\"ConsumedCapacity\":{}}"));
-    EXPECT_EQ(0u, partitions.size());
-  }
-  {
-    std::vector<RequestParser::PartitionDescriptor> partitions = RequestParser::parsePartitions(
-        *Json::Factory::loadFromString(R"({"ConsumedCapacity":{ "Partitions":{}}})"));
-    EXPECT_EQ(0u, partitions.size());
-  }
+  EXPECT_EQ(0u, parseResponse("{}")->partitions().size());
+  EXPECT_EQ(0u, parseResponse("{\"ConsumedCapacity\":{}}")->partitions().size());
+  EXPECT_EQ(0u, parseResponse(R"({"ConsumedCapacity":{ "Partitions":{}}})")->partitions().size());
+
   {
     std::string json_string = R"EOF(
     {
@@ -316,19 +354,17 @@ TEST(DynamoRequestParser, parsePartitionIds) {
       }
     }
     )EOF";
-    Json::ObjectSharedPtr json_data = Json::Factory::loadFromString(json_string);
-
-    std::vector<RequestParser::PartitionDescriptor> partitions =
-        RequestParser::parsePartitions(*json_data);
-    for (const RequestParser::PartitionDescriptor& partition : partitions) {
-      if (partition.partition_id_ == "partition_1") {
-        EXPECT_EQ(1u, partition.capacity_);
-      } else {
-        EXPECT_EQ(3u, partition.capacity_);
-      }
-    }
-    EXPECT_EQ(2u, partitions.size());
+    std::unique_ptr<RequestParser::ResponseParser> parser = parseResponse(json_string);
+    const std::vector<RequestParser::PartitionDescriptor>& partitions = parser->partitions();
+    ASSERT_EQ(2u, partitions.size());
+    EXPECT_EQ("partition_1", partitions[0].partition_id_);
+    EXPECT_EQ(1u, partitions[0].capacity_);
+    EXPECT_EQ("partition_2", partitions[1].partition_id_);
+    EXPECT_EQ(3u, partitions[1].capacity_);
   }
+
+  EXPECT_FALSE(isValidResponse(R"({"ConsumedCapacity":{"Partitions":{"partition_1":"1"}}})"));
+  EXPECT_FALSE(isValidResponse(R"({"ConsumedCapacity":{"Partitions":[]}})"));
 }
 
 } // namespace
@@ -0,0 +1,127 @@
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/dynamo/json_stream_parser.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Dynamo {
+namespace {
+
+class TokenRecorder : public JsonStreamParser::Callbacks {
+public:
+  void onStartObject() override { tokens_.push_back("{"); }
+  void onEndObject() override { tokens_.push_back("}"); }
+  void onStartArray() override { tokens_.push_back("["); }
+  void onEndArray() override { tokens_.push_back("]"); }
+  void onKey(const std::string& key) override { tokens_.push_back("key:" + key); }
+  void onString(const std::string& value) override { tokens_.push_back("string:" + value); }
+  void onNumber(const std::string& value) override { tokens_.push_back("number:" + value); }
+  void onLiteral() override { tokens_.push_back("literal"); }
+
+  std::vector<std::string> tokens_;
+};
+
+// Parses the document at once, and one byte at a time, which must report the same tokens.
+std::vector<std::string> parse(const std::string& json, bool valid = true) {
+  TokenRecorder recorder;
+  JsonStreamParser parser(recorder);
+  Buffer::OwnedImpl data(json);
+  parser.parse(data);
+  EXPECT_EQ(valid, parser.finish()) << json;
+
+  TokenRecorder split_recorder;
+  JsonStreamParser split_parser(split_recorder);
+  for (const char c : json) {
+    split_parser.parse(absl::string_view(&c, 1));
+  }
+  EXPECT_EQ(valid, split_parser.finish()) << json;
+  EXPECT_EQ(recorder.tokens_, split_recorder.tokens_) << json;
+  return recorder.tokens_;
+}
+
+TEST(JsonStreamParserTest, Empty) {
+  TokenRecorder recorder;
+  JsonStreamParser parser(recorder);
+  EXPECT_TRUE(parser.empty());
+  parser.parse("");
+  EXPECT_TRUE(parser.empty());
+  EXPECT_FALSE(parser.finish());
+
+  parse(" \n", false);
+}
+
+TEST(JsonStreamParserTest, Values) {
+  EXPECT_EQ((std::vector<std::string>{"{", "key:a", "[", "number:1", "number:-2.5e+10", "literal",
+                                      "literal", "literal", "]", "key:b", "{", "}", "key:c", "[",
+                                      "]", "key:d", "string:", "}"}),
+            parse(R"( { "a" : [1, -2.5e+10, true, false, null], "b": {}, "c": [], "d": "" } )"));
+  EXPECT_EQ(std::vector<std::string>{"number:0"}, parse("0"));
+  EXPECT_EQ(std::vector<std::string>{"number:12"}, parse(" 12 "));
+  EXPECT_EQ(std::vector<std::string>{"string:a"}, parse("\"a\""));
+  EXPECT_EQ((std::vector<std::string>{"[", "[", "]", "[", "literal", "]", "]"}),
+            parse("[[],[null]]"));
+}
+
+TEST(JsonStreamParserTest, Strings) {
+  EXPECT_EQ(std::vector<std::string>{"string:\"\\/\b\f\n\r\t"},
+            parse(R"("\"\\\/\b\f\n\r\t")"));
+  EXPECT_EQ(std::vector<std::string>{"string:A\u00e9\u20ac\U0001F600"},
+            parse(R"("\u0041\u00e9\u20AC\ud83d\ude00")"));
+  // UTF-8 is passed through.
+  EXPECT_EQ(std::vector<std::string>{"string:é"}, parse("\"é\""));
+  EXPECT_EQ((std::vector<std::string>{"{", "key:k\"ey", "string:value", "}"}),
+            parse(R"({"k\"ey":"value"})"));
+}
+
+TEST(JsonStreamParserTest, Invalid) {
+  parse("{", false);
+  parse("{}}", false);
+  parse("{} {}", false);
+  parse("[1,]", false);
+  parse("[1 2]", false);
+  parse("{\"a\"}", false);
+  parse("{\"a\":1,}", false);
+  parse("{1:1}", false);
+  parse("{\"a\":1]", false);
+  parse("[1}", false);
+  parse("tru", false);
+  parse("nul1", false);
+  parse("01", false);
+  parse("-", false);
+  parse("1.", false);
+  parse(".5", false);
+  parse("1e", false);
+  parse("1e+", false);
+  parse("1.5.5", false);
+  parse("+1", false);
+  parse("\"abc", false);
+  parse("\"a\nb\"", false);
+  parse(R"("\x")", false);
+  parse(R"("\u12")", false);
+  parse(R"("\u12g4")", false);
+  // Lone and reversed surrogates.
+  parse(R"("\ud83d")", false);
+  parse(R"("\ud83da")", false);
+  parse(R"("\ud83d\n")", false);
+  parse(R"("\ude00\ud83d")", false);
+}
+
+TEST(JsonStreamParserTest, NothingReportedAfterError) {
+  TokenRecorder recorder;
+  JsonStreamParser parser(recorder);
+  parser.parse("[1,,\"a\"]");
+  EXPECT_FALSE(parser.finish());
+  EXPECT_EQ((std::vector<std::string>{"[", "number:1"}), recorder.tokens_);
+}
+
+} // namespace
+} // namespace Dynamo
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
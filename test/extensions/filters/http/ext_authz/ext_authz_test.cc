@@ -26,9 +26,11 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -60,7 +62,7 @@ public:
       TestUtility::loadFromYaml(yaml, proto_config);
     }
     config_.reset(new FilterConfig(proto_config, local_info_, stats_store_, runtime_, http_context_,
-                                   "ext_authz_prefix"));
+                                   "ext_authz_prefix", tls_, time_system_));
     client_ = new Filters::Common::ExtAuthz::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
@@ -81,6 +83,8 @@ public:
   Network::Address::InstanceConstSharedPtr addr_;
   NiceMock<Envoy::Network::MockConnection> connection_;
   Http::ContextImpl http_context_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
 
   void prepareCheck() {
     ON_CALL(filter_callbacks_, connection()).WillByDefault(Return(&connection_));
@@ -900,6 +904,253 @@ TEST_F(HttpFilterTest, FilterEnabled) {
             filter_->decodeHeaders(request_headers_, false));
 }
 
+// Test that the decision cache cannot be used along with the request body.
+TEST_F(HttpFilterTest, DecisionCacheWithRequestBody) {
+  EXPECT_THROW_WITH_MESSAGE(initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  with_request_body:
+    max_request_bytes: 10
+  decision_cache:
+    default_ttl: 10s
+  )EOF"),
+                            EnvoyException,
+                            "ext_authz decision_cache cannot be used along with with_request_body");
+}
+
+class DecisionCacheTest : public HttpFilterTest {
+public:
+  void initializeCache(const std::string& cache_yaml) {
+    initialize(R"EOF(
+    grpc_service:
+      envoy_grpc:
+        cluster_name: "ext_authz_server"
+    decision_cache:
+    )EOF" + cache_yaml);
+    ON_CALL(filter_callbacks_, connection()).WillByDefault(Return(&connection_));
+    ON_CALL(other_callbacks_, connection()).WillByDefault(Return(&connection_));
+    ON_CALL(connection_, remoteAddress()).WillByDefault(ReturnRef(addr_));
+    ON_CALL(connection_, localAddress()).WillByDefault(ReturnRef(addr_));
+    request_headers_ = Http::TestHeaderMapImpl{
+        {":method", "GET"}, {":path", "/books/1?page=2"}, {"x-user", "alice"}};
+  }
+
+  // Create another filter sharing the configuration, as for a concurrent stream.
+  void createOtherFilter() {
+    other_client_ = new Filters::Common::ExtAuthz::MockClient();
+    other_filter_ =
+        std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{other_client_});
+    other_filter_->setDecoderFilterCallbacks(other_callbacks_);
+  }
+
+  // Expect a check from the main filter, and complete it with the supplied response.
+  void expectCheckAndRespond(const Filters::Common::ExtAuthz::Response& response) {
+    EXPECT_CALL(*client_, check(_, _, _))
+        .WillOnce(
+            WithArgs<0>(Invoke([response](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) {
+              callbacks.onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+            })));
+  }
+
+  static Filters::Common::ExtAuthz::Response okResponse() {
+    Filters::Common::ExtAuthz::Response response{};
+    response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+    return response;
+  }
+
+  Filters::Common::ExtAuthz::MockClient* other_client_{};
+  std::unique_ptr<Filter> other_filter_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> other_callbacks_;
+};
+
+// Test that a cached decision is used until it expires.
+TEST_F(DecisionCacheTest, CachedDecision) {
+  initializeCache(R"EOF(
+      principal_headers: ["x-user"]
+      path_prefix_segments: 1
+      default_ttl: 10s
+  )EOF");
+  expectCheckAndRespond(okResponse());
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+
+  // The same principal on another path under the prefix uses the cached decision.
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _)).Times(0);
+  Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/books/2"}, {"x-user", "alice"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, other_filter_->decodeHeaders(headers, true));
+  EXPECT_EQ(1U, config_->stats().cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+
+  // Another principal is checked.
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _));
+  Http::TestHeaderMapImpl other_user{{":method", "GET"}, {":path", "/books/1"}, {"x-user", "bob"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(other_user, true));
+  other_filter_->onDestroy();
+
+  // The decision expires.
+  time_system_.sleep(std::chrono::seconds(11));
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(headers, true));
+  EXPECT_EQ(1U, config_->stats().cache_hit_.value());
+}
+
+// Test that a denied decision is cached along with its local reply.
+TEST_F(DecisionCacheTest, CachedDeniedDecision) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+  )EOF");
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Denied;
+  response.status_code = Http::Code::Unauthorized;
+  expectCheckAndRespond(response);
+  EXPECT_CALL(filter_callbacks_, sendLocalReply(Http::Code::Unauthorized, _, _, _, _));
+  filter_->decodeHeaders(request_headers_, true);
+
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _)).Times(0);
+  EXPECT_CALL(other_callbacks_, sendLocalReply(Http::Code::Unauthorized, _, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(2U, config_->stats().denied_.value());
+}
+
+// Test that errors are not cached.
+TEST_F(DecisionCacheTest, ErrorNotCached) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+  )EOF");
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Error;
+  expectCheckAndRespond(response);
+  filter_->decodeHeaders(request_headers_, true);
+
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _));
+  other_filter_->decodeHeaders(request_headers_, true);
+  other_filter_->onDestroy();
+}
+
+// Test the TTL set by the authorization server through a header.
+TEST_F(DecisionCacheTest, TtlHeader) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+      ttl_header: x-authz-ttl
+  )EOF");
+  Filters::Common::ExtAuthz::Response response = okResponse();
+  response.headers_to_add = Http::HeaderVector{{Http::LowerCaseString{"x-authz-ttl"}, "60"}};
+  expectCheckAndRespond(response);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_FALSE(request_headers_.has("x-authz-ttl"));
+
+  // The decision outlives the default TTL.
+  time_system_.sleep(std::chrono::seconds(30));
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            other_filter_->decodeHeaders(request_headers_, true));
+}
+
+// Test that a TTL of zero prevents the decision from being cached.
+TEST_F(DecisionCacheTest, ZeroTtlHeader) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+      ttl_header: x-authz-ttl
+  )EOF");
+  Filters::Common::ExtAuthz::Response response = okResponse();
+  response.headers_to_append = Http::HeaderVector{{Http::LowerCaseString{"x-authz-ttl"}, "0"}};
+  expectCheckAndRespond(response);
+  filter_->decodeHeaders(request_headers_, true);
+
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _));
+  other_filter_->decodeHeaders(request_headers_, true);
+  other_filter_->onDestroy();
+}
+
+// Test that an identical check waits for the one in flight.
+TEST_F(DecisionCacheTest, CoalescedChecks) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+      coalesce_checks: true
+  )EOF");
+  EXPECT_CALL(*client_, check(_, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+
+  createOtherFilter();
+  EXPECT_CALL(*other_client_, check(_, _, _)).Times(0);
+  Http::TestHeaderMapImpl headers{request_headers_};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(headers, true));
+  EXPECT_EQ(1U, config_->stats().coalesced_.value());
+
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  EXPECT_CALL(other_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(
+      std::make_unique<Filters::Common::ExtAuthz::Response>(okResponse()));
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+}
+
+// Test that a waiting check is sent when the check in flight goes away.
+TEST_F(DecisionCacheTest, CoalescedCheckSentOnDestroy) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+      coalesce_checks: true
+  )EOF");
+  EXPECT_CALL(*client_, check(_, _, _));
+  filter_->decodeHeaders(request_headers_, true);
+
+  createOtherFilter();
+  Http::TestHeaderMapImpl headers{request_headers_};
+  other_filter_->decodeHeaders(headers, true);
+
+  EXPECT_CALL(*client_, cancel());
+  EXPECT_CALL(*other_client_, check(_, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  filter_->onDestroy();
+
+  EXPECT_CALL(other_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(
+      std::make_unique<Filters::Common::ExtAuthz::Response>(okResponse()));
+}
+
+// Test that a waiting check which goes away is not handed the decision.
+TEST_F(DecisionCacheTest, WaitingCheckDestroyed) {
+  initializeCache(R"EOF(
+      default_ttl: 10s
+      coalesce_checks: true
+  )EOF");
+  EXPECT_CALL(*client_, check(_, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  filter_->decodeHeaders(request_headers_, true);
+
+  createOtherFilter();
+  Http::TestHeaderMapImpl headers{request_headers_};
+  other_filter_->decodeHeaders(headers, true);
+  EXPECT_CALL(*other_client_, cancel()).Times(0);
+  other_filter_->onDestroy();
+
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  EXPECT_CALL(other_callbacks_, continueDecoding()).Times(0);
+  request_callbacks_->onComplete(
+      std::make_unique<Filters::Common::ExtAuthz::Response>(okResponse()));
+}
+
 // -------------------
 // Parameterized Tests
 // -------------------
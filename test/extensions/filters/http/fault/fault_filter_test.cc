@@ -425,6 +425,48 @@ TEST_F(FaultFilterTest, DelayForDownstreamCluster) {
   EXPECT_EQ(0UL, stats_.counter("prefix.fault.cluster.aborts_injected").value());
 }
 
+TEST_F(FaultFilterTest, AbortForDownstreamCluster) {
+  SetUpTest(abort_only_yaml);
+
+  EXPECT_CALL(runtime_.snapshot_,
+              getInteger("fault.http.max_active_faults", std::numeric_limits<uint64_t>::max()))
+      .WillOnce(Return(std::numeric_limits<uint64_t>::max()));
+
+  request_headers_.addCopy("x-envoy-downstream-service-cluster", "cluster");
+
+  // No delay is configured, so its runtime keys are not looked up.
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled("fault.http.cluster.delay.fixed_delay_percent",
+                             Matcher<const envoy::type::v3alpha::FractionalPercent&>(_)))
+      .Times(0);
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.cluster.delay.fixed_duration_ms", _))
+      .Times(0);
+
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled("fault.http.cluster.abort.abort_percent",
+                             Matcher<const envoy::type::v3alpha::FractionalPercent&>(Percent(100))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.abort.http_status", 429))
+      .WillOnce(Return(429));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.cluster.abort.http_status", 429))
+      .WillOnce(Return(503));
+
+  Http::TestHeaderMapImpl response_headers{
+      {":status", "503"}, {"content-length", "18"}, {"content-type", "text/plain"}};
+  EXPECT_CALL(decoder_filter_callbacks_,
+              encodeHeaders_(HeaderMapEqualRef(&response_headers), false));
+  EXPECT_CALL(decoder_filter_callbacks_, encodeData(_, true));
+  EXPECT_CALL(decoder_filter_callbacks_.stream_info_,
+              setResponseFlag(StreamInfo::ResponseFlag::FaultInjected));
+
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  filter_->onDestroy();
+
+  EXPECT_EQ(1UL, config_->stats().aborts_injected_.value());
+  EXPECT_EQ(1UL, stats_.counter("prefix.fault.cluster.aborts_injected").value());
+}
+
 TEST_F(FaultFilterTest, FixedDelayAndAbortDownstream) {
   SetUpTest(fixed_delay_and_abort_yaml);
 
@@ -598,9 +640,8 @@ TEST_F(FaultFilterTest, FixedDelayAndAbortDownstreamNodes) {
 TEST_F(FaultFilterTest, NoDownstreamMatch) {
   SetUpTest(fixed_delay_and_abort_nodes_yaml);
 
-  EXPECT_CALL(runtime_.snapshot_,
-              getInteger("fault.http.max_active_faults", std::numeric_limits<uint64_t>::max()))
-      .WillOnce(Return(std::numeric_limits<uint64_t>::max()));
+  // The runtime is not looked up for requests the fault does not target.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.max_active_faults", _)).Times(0);
 
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
 }
@@ -665,9 +706,8 @@ TEST_F(FaultFilterTest, FixedDelayAndAbortHeaderMatchFail) {
   request_headers_.addCopy("x-foo1", "Bar");
   request_headers_.addCopy("x-foo3", "Baz");
 
-  EXPECT_CALL(runtime_.snapshot_,
-              getInteger("fault.http.max_active_faults", std::numeric_limits<uint64_t>::max()))
-      .WillOnce(Return(std::numeric_limits<uint64_t>::max()));
+  // The runtime is not looked up for requests the fault does not target.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.max_active_faults", _)).Times(0);
 
   EXPECT_CALL(runtime_.snapshot_,
               featureEnabled("fault.http.delay.fixed_delay_percent",
@@ -798,9 +838,8 @@ TEST_F(FaultFilterTest, FaultWithTargetClusterMatchFail) {
 
   EXPECT_CALL(decoder_filter_callbacks_.route_->route_entry_, clusterName())
       .WillOnce(ReturnRef(upstream_cluster));
-  EXPECT_CALL(runtime_.snapshot_,
-              getInteger("fault.http.max_active_faults", std::numeric_limits<uint64_t>::max()))
-      .WillOnce(Return(std::numeric_limits<uint64_t>::max()));
+  // The runtime is not looked up for requests the fault does not target.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.max_active_faults", _)).Times(0);
   EXPECT_CALL(runtime_.snapshot_,
               featureEnabled("fault.http.delay.fixed_delay_percent",
                              Matcher<const envoy::type::v3alpha::FractionalPercent&>(_)))
@@ -828,9 +867,8 @@ TEST_F(FaultFilterTest, FaultWithTargetClusterNullRoute) {
   const std::string upstream_cluster("www1");
 
   EXPECT_CALL(*decoder_filter_callbacks_.route_, routeEntry()).WillRepeatedly(Return(nullptr));
-  EXPECT_CALL(runtime_.snapshot_,
-              getInteger("fault.http.max_active_faults", std::numeric_limits<uint64_t>::max()))
-      .WillOnce(Return(std::numeric_limits<uint64_t>::max()));
+  // The runtime is not looked up for requests the fault does not target.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.max_active_faults", _)).Times(0);
   EXPECT_CALL(runtime_.snapshot_,
               featureEnabled("fault.http.delay.fixed_delay_percent",
                              Matcher<const envoy::type::v3alpha::FractionalPercent&>(_)))
@@ -256,40 +256,46 @@ TEST_F(ReverseBridgeTest, GrpcRequest) {
     EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(trailers));
   }
 
-  Http::TestHeaderMapImpl headers(
-      {{":status", "200"}, {"content-length", "30"}, {"content-type", "application/x-protobuf"}});
+  Http::TestHeaderMapImpl headers({{":status", "200"},
+                                   {"content-length", "12"},
+                                   {"content-type", "application/x-protobuf"}});
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
   EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentType, "application/grpc"));
-  EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentLength, "35"));
+  EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentLength, "17"));
 
+  // As the length of the response is known, the response streams behind the frame header.
+  Envoy::Buffer::OwnedImpl response;
   {
-    // First few calls should drain the buffer
+    // The first call should prefix the buffer with the frame header.
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("abc", 4);
-    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->encodeData(buffer, false));
-    EXPECT_EQ(0, buffer.length());
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, false));
+    EXPECT_EQ(9, buffer.length());
+    response.move(buffer);
   }
   {
-    // First few calls should drain the buffer
+    // Subsequent calls should pass the data through.
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("def", 4);
-    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->encodeData(buffer, false));
-    EXPECT_EQ(0, buffer.length());
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, false));
+    EXPECT_EQ(4, buffer.length());
+    response.move(buffer);
   }
   {
-    // Last call should prefix the buffer with the size and insert the gRPC status into trailers.
+    // Last call should pass the data through and insert the gRPC status into trailers.
     Http::TestHeaderMapImpl trailers;
     EXPECT_CALL(encoder_callbacks_, addEncodedTrailers()).WillOnce(ReturnRef(trailers));
 
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("ghj", 4);
     EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, true));
-    EXPECT_EQ(17, buffer.length());
+    EXPECT_EQ(4, buffer.length());
     EXPECT_THAT(trailers, HeaderValueOf(Http::Headers::get().GrpcStatus, "0"));
+    response.move(buffer);
 
     Grpc::Decoder decoder;
     std::vector<Grpc::Frame> frames;
-    decoder.decode(buffer, frames);
+    decoder.decode(response, frames);
 
     EXPECT_EQ(1, frames.size());
     EXPECT_EQ(12, frames[0].length_);
@@ -627,40 +633,46 @@ TEST_F(ReverseBridgeTest, FilterConfigPerRouteEnabled) {
     EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(trailers));
   }
 
-  Http::TestHeaderMapImpl headers(
-      {{":status", "200"}, {"content-length", "30"}, {"content-type", "application/x-protobuf"}});
+  Http::TestHeaderMapImpl headers({{":status", "200"},
+                                   {"content-length", "12"},
+                                   {"content-type", "application/x-protobuf"}});
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
   EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentType, "application/grpc"));
-  EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentLength, "35"));
+  EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentLength, "17"));
 
+  // As the length of the response is known, the response streams behind the frame header.
+  Envoy::Buffer::OwnedImpl response;
   {
-    // First few calls should drain the buffer
+    // The first call should prefix the buffer with the frame header.
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("abc", 4);
-    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->encodeData(buffer, false));
-    EXPECT_EQ(0, buffer.length());
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, false));
+    EXPECT_EQ(9, buffer.length());
+    response.move(buffer);
   }
   {
-    // First few calls should drain the buffer
+    // Subsequent calls should pass the data through.
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("def", 4);
-    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->encodeData(buffer, false));
-    EXPECT_EQ(0, buffer.length());
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, false));
+    EXPECT_EQ(4, buffer.length());
+    response.move(buffer);
   }
   {
-    // Last call should prefix the buffer with the size and insert the gRPC status into trailers.
+    // Last call should pass the data through and insert the gRPC status into trailers.
     Http::TestHeaderMapImpl trailers;
     EXPECT_CALL(encoder_callbacks_, addEncodedTrailers()).WillOnce(ReturnRef(trailers));
 
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("ghj", 4);
     EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, true));
-    EXPECT_EQ(17, buffer.length());
+    EXPECT_EQ(4, buffer.length());
     EXPECT_THAT(trailers, HeaderValueOf(Http::Headers::get().GrpcStatus, "0"));
+    response.move(buffer);
 
     Grpc::Decoder decoder;
     std::vector<Grpc::Frame> frames;
-    decoder.decode(buffer, frames);
+    decoder.decode(response, frames);
 
     EXPECT_EQ(1, frames.size());
     EXPECT_EQ(12, frames[0].length_);
@@ -705,39 +717,42 @@ TEST_F(ReverseBridgeTest, RouteWithTrailers) {
     EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(trailers));
   }
 
-  Http::TestHeaderMapImpl headers(
-      {{":status", "200"}, {"content-length", "30"}, {"content-type", "application/x-protobuf"}});
+  Http::TestHeaderMapImpl headers({{":status", "200"},
+                                   {"content-length", "8"},
+                                   {"content-type", "application/x-protobuf"}});
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
   EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentType, "application/grpc"));
-  EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentLength, "35"));
+  EXPECT_THAT(headers, HeaderValueOf(Http::Headers::get().ContentLength, "13"));
 
+  // As the length of the response is known, the response streams behind the frame header.
+  Envoy::Buffer::OwnedImpl response;
   {
-    // First few calls should drain the buffer
+    // The first call should prefix the buffer with the frame header.
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("abc", 4);
-    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->encodeData(buffer, false));
-    EXPECT_EQ(0, buffer.length());
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, false));
+    EXPECT_EQ(9, buffer.length());
+    response.move(buffer);
   }
   {
-    // First few calls should drain the buffer
+    // Subsequent calls should pass the data through.
     Envoy::Buffer::OwnedImpl buffer;
     buffer.add("def", 4);
-    EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->encodeData(buffer, false));
-    EXPECT_EQ(0, buffer.length());
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(buffer, false));
+    EXPECT_EQ(4, buffer.length());
+    response.move(buffer);
   }
 
   {
-    // Last call should prefix the buffer with the size and insert the gRPC status into trailers.
-    Envoy::Buffer::OwnedImpl buffer;
-    EXPECT_CALL(encoder_callbacks_, addEncodedData(_, false))
-        .WillOnce(Invoke([&](Envoy::Buffer::Instance& buf, bool) -> void { buffer.move(buf); }));
+    // The trailers should only get the gRPC status, the response was already sent.
+    EXPECT_CALL(encoder_callbacks_, addEncodedData(_, _)).Times(0);
     Http::TestHeaderMapImpl trailers({{"foo", "bar"}, {"one", "two"}, {"three", "four"}});
     EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->encodeTrailers(trailers));
     EXPECT_THAT(trailers, HeaderValueOf(Http::Headers::get().GrpcStatus, "0"));
 
     Grpc::Decoder decoder;
     std::vector<Grpc::Frame> frames;
-    decoder.decode(buffer, frames);
+    decoder.decode(response, frames);
 
     EXPECT_EQ(4, trailers.size());
     EXPECT_EQ(1, frames.size());
@@ -12,6 +12,7 @@
 #include "extensions/filters/http/grpc_json_transcoder/json_transcoder_filter.h"
 
 #include "test/mocks/http/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/proto/bookstore.pb.h"
 #include "test/test_common/environment.h"
@@ -45,6 +46,7 @@ protected:
   GrpcJsonTranscoderFilterTestBase() : api_(Api::createApiForTest()) {}
 
   Api::ApiPtr api_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
 };
 
 class GrpcJsonTranscoderConfigTest : public testing::Test, public GrpcJsonTranscoderFilterTestBase {
@@ -118,14 +120,14 @@ TEST_F(GrpcJsonTranscoderConfigTest, ParseConfig) {
   EXPECT_NO_THROW(JsonTranscoderConfig config(
       getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
                      "bookstore.Bookstore"),
-      *api_));
+      *api_, tls_));
 }
 
 TEST_F(GrpcJsonTranscoderConfigTest, ParseConfigSkipRecalculating) {
   EXPECT_NO_THROW(JsonTranscoderConfig config(
       getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
                      "bookstore.Bookstore", true),
-      *api_));
+      *api_, tls_));
 }
 
 TEST_F(GrpcJsonTranscoderConfigTest, ParseBinaryConfig) {
@@ -133,7 +135,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, ParseBinaryConfig) {
   proto_config.set_proto_descriptor_bin(api_->fileSystem().fileReadToEnd(
       TestEnvironment::runfilesPath("test/proto/bookstore.descriptor")));
   proto_config.add_services("bookstore.Bookstore");
-  EXPECT_NO_THROW(JsonTranscoderConfig config(proto_config, *api_));
+  EXPECT_NO_THROW(JsonTranscoderConfig config(proto_config, *api_, tls_));
 }
 
 TEST_F(GrpcJsonTranscoderConfigTest, UnknownService) {
@@ -141,7 +143,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, UnknownService) {
       JsonTranscoderConfig config(
           getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
                          "grpc.service.UnknownService"),
-          *api_),
+          *api_, tls_),
       EnvoyException,
       "transcoding_filter: Could not find 'grpc.service.UnknownService' in the proto descriptor");
 }
@@ -152,7 +154,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, IncompleteProto) {
                                                    stripImports(pb, "test/proto/bookstore.proto");
                                                  }),
                                                  "bookstore.Bookstore"),
-                                  *api_),
+                                  *api_, tls_),
       EnvoyException, "transcoding_filter: Unable to build proto descriptor pool");
 }
 
@@ -161,7 +163,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, NonProto) {
       JsonTranscoderConfig config(
           getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.proto"),
                          "grpc.service.UnknownService"),
-          *api_),
+          *api_, tls_),
       EnvoyException, "transcoding_filter: Unable to parse proto descriptor");
 }
 
@@ -169,7 +171,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, NonBinaryProto) {
   envoy::extensions::filters::http::grpc_json_transcoder::v3alpha::GrpcJsonTranscoder proto_config;
   proto_config.set_proto_descriptor_bin("This is invalid proto");
   proto_config.add_services("bookstore.Bookstore");
-  EXPECT_THROW_WITH_MESSAGE(JsonTranscoderConfig config(proto_config, *api_), EnvoyException,
+  EXPECT_THROW_WITH_MESSAGE(JsonTranscoderConfig config(proto_config, *api_, tls_), EnvoyException,
                             "transcoding_filter: Unable to parse proto descriptor");
 }
 
@@ -181,7 +183,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, InvalidHttpTemplate) {
                                                    setGetBookHttpRule(pb, http_rule);
                                                  }),
                                                  "bookstore.Bookstore"),
-                                  *api_),
+                                  *api_, tls_),
       EnvoyException,
       "transcoding_filter: Cannot register 'bookstore.Bookstore.GetBook' to path matcher");
 }
@@ -190,7 +192,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, CreateTranscoder) {
   JsonTranscoderConfig config(
       getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
                      "bookstore.Bookstore"),
-      *api_);
+      *api_, tls_);
 
   Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves"}};
 
@@ -210,7 +212,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, CreateTranscoderAutoMap) {
       TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"), "bookstore.Bookstore");
   proto_config.set_auto_mapping(true);
 
-  JsonTranscoderConfig config(proto_config, *api_);
+  JsonTranscoderConfig config(proto_config, *api_, tls_);
 
   Http::TestHeaderMapImpl headers{{":method", "POST"},
                                   {":path", "/bookstore.Bookstore/DeleteShelf"}};
@@ -230,7 +232,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, InvalidQueryParameter) {
   JsonTranscoderConfig config(
       getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
                      "bookstore.Bookstore"),
-      *api_);
+      *api_, tls_);
 
   Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves?foo=bar"}};
 
@@ -250,7 +252,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, UnknownQueryParameterIsIgnored) {
   auto proto_config = getProtoConfig(
       TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"), "bookstore.Bookstore");
   proto_config.set_ignore_unknown_query_parameters(true);
-  JsonTranscoderConfig config(proto_config, *api_);
+  JsonTranscoderConfig config(proto_config, *api_, tls_);
 
   Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves?foo=bar"}};
 
@@ -269,7 +271,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, IgnoredQueryParameter) {
   JsonTranscoderConfig config(
       getProtoConfig(TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"),
                      "bookstore.Bookstore", false, ignored_query_parameters),
-      *api_);
+      *api_, tls_);
 
   Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves?key=API_KEY"}};
 
@@ -291,7 +293,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, InvalidVariableBinding) {
                                                setGetBookHttpRule(pb, http_rule);
                                              }),
                                              "bookstore.Bookstore"),
-                              *api_);
+                              *api_, tls_);
 
   Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/book/1"}};
 
@@ -312,7 +314,7 @@ protected:
   GrpcJsonTranscoderFilterTest(
       envoy::extensions::filters::http::grpc_json_transcoder::v3alpha::GrpcJsonTranscoder
           proto_config = bookstoreProtoConfig())
-      : config_(proto_config, *api_), filter_(config_) {
+      : config_(proto_config, *api_, tls_), filter_(config_) {
     filter_.setDecoderFilterCallbacks(decoder_callbacks_);
     filter_.setEncoderFilterCallbacks(encoder_callbacks_);
   }
@@ -745,6 +747,47 @@ TEST_F(GrpcJsonTranscoderFilterTest, TranscodingUnaryWithHttpBodyAsOutputAndSpli
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.decodeTrailers(response_trailers));
 }
 
+TEST_F(GrpcJsonTranscoderFilterTest, TranscodingStreamingWithHttpBodyAsOutput) {
+  Http::TestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/indexStream"}};
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, true));
+  EXPECT_EQ("/bookstore.Bookstore/GetIndexStream", request_headers.get_(":path"));
+
+  Http::TestHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                           {":status", "200"}};
+
+  // The headers are held until the first message gives the content type of the body.
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  google::api::HttpBody response;
+  response.set_content_type("text/plain");
+  response.set_data("first chunk, ");
+  auto response_data = Grpc::Common::serializeToGrpcFrame(response);
+
+  Buffer::OwnedImpl response_data_first_part;
+  response_data_first_part.move(*response_data, response_data->length() / 2);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_.encodeData(response_data_first_part, false));
+  EXPECT_EQ(0, response_data_first_part.length());
+
+  // Each message is written out as soon as it is complete, rather than buffered.
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(*response_data, false));
+  EXPECT_EQ("text/plain", response_headers.get_("content-type"));
+  EXPECT_EQ("first chunk, ", response_data->toString());
+
+  response.clear_content_type();
+  response.set_data("second chunk");
+  response_data = Grpc::Common::serializeToGrpcFrame(response);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(*response_data, false));
+  EXPECT_EQ("second chunk", response_data->toString());
+  EXPECT_EQ("text/plain", response_headers.get_("content-type"));
+
+  Http::TestHeaderMapImpl response_trailers{{"grpc-status", "0"}, {"grpc-message", ""}};
+  EXPECT_CALL(encoder_callbacks_, addEncodedData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.encodeTrailers(response_trailers));
+}
+
 class GrpcJsonTranscoderFilterGrpcStatusTest : public GrpcJsonTranscoderFilterTest {
 public:
   GrpcJsonTranscoderFilterGrpcStatusTest(
@@ -933,7 +976,7 @@ protected:
     envoy::extensions::filters::http::grpc_json_transcoder::v3alpha::GrpcJsonTranscoder
         proto_config;
     TestUtility::loadFromJson(TestEnvironment::substitute(GetParam().config_json_), proto_config);
-    config_ = new JsonTranscoderConfig(proto_config, *api_);
+    config_ = new JsonTranscoderConfig(proto_config, *api_, tls_);
     filter_ = new JsonTranscoderFilter(*config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
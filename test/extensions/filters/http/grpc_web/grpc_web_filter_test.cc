@@ -187,6 +187,55 @@ TEST_F(GrpcWebFilterTest, Base64NoPadding) {
   EXPECT_EQ(decoder_callbacks_.details_, "grpc_base_64_decode_failed_bad_size");
 }
 
+// The frames of a text response are encoded as they stream, each frame being padded.
+TEST_F(GrpcWebFilterTest, StreamingTextResponse) {
+  Http::TestHeaderMapImpl request_headers;
+  request_headers.addCopy(Http::Headers::get().ContentType,
+                          Http::Headers::get().ContentTypeValues.GrpcWebText);
+  request_headers.addCopy(Http::Headers::get().Accept,
+                          Http::Headers::get().ContentTypeValues.GrpcWebText);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+  Http::TestHeaderMapImpl response_headers;
+  response_headers.addCopy(Http::Headers::get().Status, "200");
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.encodeHeaders(response_headers, false));
+
+  // Two frames split across data callbacks, the first one in the middle of the second frame.
+  const std::string frames = std::string(TEXT_MESSAGE, TEXT_MESSAGE_SIZE) +
+                             std::string(MESSAGE, MESSAGE_SIZE);
+  const size_t split = TEXT_MESSAGE_SIZE + 7;
+  Buffer::OwnedImpl encoded_buffer;
+  Buffer::OwnedImpl response_buffer(frames.substr(0, split));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(response_buffer, false));
+  encoded_buffer.move(response_buffer);
+  // The first frame is encoded in full, as soon as it is received.
+  EXPECT_EQ(std::string(B64_MESSAGE, B64_MESSAGE_SIZE),
+            encoded_buffer.toString().substr(0, B64_MESSAGE_SIZE));
+
+  response_buffer.add(frames.substr(split));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(response_buffer, true));
+  encoded_buffer.move(response_buffer);
+  EXPECT_EQ(std::string(B64_MESSAGE, B64_MESSAGE_SIZE) + Base64::encode(MESSAGE, MESSAGE_SIZE),
+            encoded_buffer.toString());
+}
+
+// A text request may be made of several padded encodings, decoded as they stream.
+TEST_F(GrpcWebFilterTest, StreamingTextRequest) {
+  Http::TestHeaderMapImpl request_headers;
+  request_headers.addCopy(Http::Headers::get().ContentType,
+                          Http::Headers::get().ContentTypeValues.GrpcWebText);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  const std::string text = std::string(B64_MESSAGE, B64_MESSAGE_SIZE) + Base64::encode("ab", 2);
+  Buffer::OwnedImpl decoded_buffer;
+  Buffer::OwnedImpl request_buffer(text.substr(0, 6));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_buffer, false));
+  decoded_buffer.move(request_buffer);
+  request_buffer.add(text.substr(6));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_buffer, true));
+  decoded_buffer.move(request_buffer);
+  EXPECT_EQ(std::string(TEXT_MESSAGE, TEXT_MESSAGE_SIZE) + "ab", decoded_buffer.toString());
+}
+
 TEST_P(GrpcWebFilterTest, StatsNoCluster) {
   Http::TestHeaderMapImpl request_headers{{"content-type", request_content_type()},
                                           {":path", "/lyft.users.BadCompanions/GetBadCompanions"}};
@@ -325,11 +374,12 @@ TEST_P(GrpcWebFilterTest, Unary) {
     Buffer::OwnedImpl encoded_buffer;
     for (size_t i = 0; i < TEXT_MESSAGE_SIZE; i++) {
       response_buffer.add(&TEXT_MESSAGE[i], 1);
-      if (i < TEXT_MESSAGE_SIZE - 1) {
+      // The frame is encoded in groups of 3 bytes as they come, the last group being padded.
+      if (i % 3 == 2 || i == TEXT_MESSAGE_SIZE - 1) {
+        EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(response_buffer, false));
+      } else {
         EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
                   filter_.encodeData(response_buffer, false));
-      } else {
-        EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(response_buffer, false));
       }
       encoded_buffer.move(response_buffer);
     }
@@ -13,6 +13,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -63,12 +64,14 @@ protected:
     return filter_->isTransferEncodingAllowed(headers);
   }
 
+  const Compressor::ZlibCompressorImpl* compressor() { return filter_->compressor_.get(); }
+
   // GzipFilterTest Helpers
   void setUpFilter(std::string&& json) {
     Json::ObjectSharedPtr config = Json::Factory::loadFromString(json);
     envoy::extensions::filters::http::gzip::v3alpha::Gzip gzip;
     TestUtility::loadFromJson(json, gzip);
-    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_));
+    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_, tls_));
     filter_ = std::make_unique<GzipFilter>(config_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
   }
@@ -177,6 +180,7 @@ protected:
     EXPECT_EQ(1, stats_.counter("test.gzip.not_compressed").value());
   }
 
+  NiceMock<ThreadLocal::MockInstance> tls_;
   GzipFilterConfigSharedPtr config_;
   std::unique_ptr<GzipFilter> filter_;
   Buffer::OwnedImpl data_;
@@ -196,6 +200,34 @@ TEST_F(GzipFilterTest, RuntimeDisabled) {
   doResponseNoCompression({{":method", "get"}, {"content-length", "256"}});
 }
 
+// The compressor of a stream is reset and reused by the next stream of the worker thread, even if
+// its stream has not been finished.
+TEST_F(GzipFilterTest, CompressorReused) {
+  doRequest({{":method", "get"}, {"accept-encoding", "deflate, gzip"}}, false);
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  feedBuffer(256);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, false));
+  const Compressor::ZlibCompressorImpl* previous_compressor = compressor();
+  filter_->onDestroy();
+
+  filter_ = std::make_unique<GzipFilter>(config_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  doRequest({{":method", "get"}, {"accept-encoding", "deflate, gzip"}}, false);
+  Http::TestHeaderMapImpl other_headers{{":method", "get"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(other_headers, false));
+  EXPECT_EQ(previous_compressor, compressor());
+
+  Buffer::OwnedImpl data;
+  TestUtility::feedBufferWithRandomCharacters(data, 256, 1);
+  const std::string original = data.toString();
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+  Buffer::OwnedImpl decompressed;
+  decompressor_.decompress(data, decompressed);
+  EXPECT_EQ(original, decompressed.toString());
+  filter_->onDestroy();
+}
+
 // Default config values.
 TEST_F(GzipFilterTest, DefaultConfigValues) {
   EXPECT_EQ(5, config_->memoryLevel());
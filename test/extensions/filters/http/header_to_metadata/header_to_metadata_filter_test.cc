@@ -321,6 +321,62 @@ request_rules:
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(incoming_headers, false));
 }
 
+/**
+ * Enough headers for them to be found in a single pass over the headers.
+ */
+TEST_F(HeaderToMetadataTest, ManyHeadersMatch) {
+  const std::string yaml = R"EOF(
+request_rules:
+  - header: x-a
+    on_header_present:
+      key: a
+      metadata_namespace: envoy.lb
+      type: STRING
+  - header: x-b
+    on_header_present:
+      key: b
+      metadata_namespace: envoy.lb
+      type: STRING
+    remove: true
+  - header: x-b
+    on_header_missing:
+      key: b_removed
+      value: 'true'
+      metadata_namespace: envoy.lb
+      type: STRING
+  - header: X-C
+    on_header_present:
+      key: c
+      type: STRING
+  - header: x-d
+    on_header_present:
+      key: d
+      metadata_namespace: envoy.lb
+      type: STRING
+    on_header_missing:
+      key: d_missing
+      value: 'true'
+      metadata_namespace: envoy.lb
+      type: STRING
+)EOF";
+  initializeFilter(yaml);
+  Http::TestHeaderMapImpl incoming_headers{
+      {"x-ignore", "nothing"}, {"x-a", "first"}, {"x-b", "1"},
+      {"x-a", "second"},       {"x-c", "3"},     {"x-b", "2"},
+  };
+  std::map<std::string, std::string> expected = {
+      {"a", "first"}, {"b", "1"}, {"b_removed", "true"}, {"d_missing", "true"}};
+  std::map<std::string, std::string> expected_default = {{"c", "3"}};
+
+  EXPECT_CALL(decoder_callbacks_, streamInfo()).WillRepeatedly(ReturnRef(req_info_));
+  EXPECT_CALL(req_info_, setDynamicMetadata("envoy.lb", MapEq(expected)));
+  EXPECT_CALL(req_info_,
+              setDynamicMetadata("envoy.filters.http.header_to_metadata", MapEq(expected_default)));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(incoming_headers, false));
+  EXPECT_EQ(nullptr, incoming_headers.get(Http::LowerCaseString("x-b")));
+  EXPECT_EQ(MIN_HEADERS_FOR_SINGLE_PASS, config_->requestRules().headers_.size());
+}
+
 /**
  * No header value.
  */
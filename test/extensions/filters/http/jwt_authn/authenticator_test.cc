@@ -109,6 +109,27 @@ TEST_F(AuthenticatorTest, TestOkJWTandCache) {
   }
 }
 
+// This test verifies that a JWT found in the cache of verified JWTs is still forwarded as
+// configured.
+TEST_F(AuthenticatorTest, TestVerifiedJwtCache) {
+  (*proto_config_.mutable_providers())[std::string(ProviderName)].set_jwt_cache_size(10);
+  CreateAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3alpha::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }));
+
+  for (int i = 0; i < 3; i++) {
+    auto headers = Http::TestHeaderMapImpl{{"Authorization", "Bearer " + std::string(GoodToken)}};
+    expectVerifyStatus(Status::Ok, headers);
+    EXPECT_EQ(headers.get_("sec-istio-auth-userinfo"), ExpectedPayloadValue);
+    EXPECT_FALSE(headers.Authorization());
+  }
+  auto* jwks_data = filter_config_->getCache().getJwksCache().findByProvider(ProviderName);
+  EXPECT_TRUE(jwks_data->isJwtVerified(GoodToken));
+}
+
 // This test verifies the Jwt is forwarded if "forward" flag is set.
 TEST_F(AuthenticatorTest, TestForwardJwt) {
   // Config forward_jwt flag
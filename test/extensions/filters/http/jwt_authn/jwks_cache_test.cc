@@ -8,12 +8,18 @@
 
 #include "extensions/filters/http/jwt_authn/jwks_cache.h"
 
+#include "test/extensions/filters/http/common/mock.h"
 #include "test/extensions/filters/http/jwt_authn/test_common.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 using envoy::extensions::filters::http::jwt_authn::v3alpha::JwtAuthentication;
+using Envoy::Extensions::HttpFilters::Common::JwksFetcher;
+using Envoy::Extensions::HttpFilters::Common::MockJwksFetcher;
+using ::google::jwt_verify::Jwks;
 using ::google::jwt_verify::Status;
+using ::testing::_;
+using ::testing::Invoke;
 
 namespace Envoy {
 namespace Extensions {
@@ -138,6 +144,105 @@ TEST_F(JwksCacheTest, TestAudiences) {
   EXPECT_FALSE(jwks->areAudiencesAllowed({"wrong-audience1", "wrong-audience2"}));
 }
 
+// Test the cache of verified JWTs
+TEST_F(JwksCacheTest, TestVerifiedJwtCache) {
+  auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
+  provider0.set_jwt_cache_size(2);
+  cache_ = JwksCache::create(config_, time_system_, *api_);
+
+  auto jwks = cache_->findByIssuer("https://example.com");
+  jwks->setRemoteJwks(std::move(jwks_));
+  EXPECT_FALSE(jwks->isJwtVerified("token1"));
+
+  jwks->addVerifiedJwt("token1");
+  jwks->addVerifiedJwt("token2");
+  EXPECT_TRUE(jwks->isJwtVerified("token1"));
+
+  // token2 is now the least recently used one, and is evicted first.
+  jwks->addVerifiedJwt("token3");
+  EXPECT_TRUE(jwks->isJwtVerified("token1"));
+  EXPECT_FALSE(jwks->isJwtVerified("token2"));
+  EXPECT_TRUE(jwks->isJwtVerified("token3"));
+
+  // New keys drop the tokens verified with the old ones.
+  jwks->setRemoteJwks(Jwks::createFrom(PublicKey, Jwks::JWKS));
+  EXPECT_FALSE(jwks->isJwtVerified("token1"));
+  EXPECT_FALSE(jwks->isJwtVerified("token3"));
+}
+
+// Test that verified JWTs are not cached by default
+TEST_F(JwksCacheTest, TestVerifiedJwtCacheDisabled) {
+  auto jwks = cache_->findByIssuer("https://example.com");
+  jwks->setRemoteJwks(std::move(jwks_));
+  jwks->addVerifiedJwt("token1");
+  EXPECT_FALSE(jwks->isJwtVerified("token1"));
+}
+
+// Test the background refresh of an expired remote Jwks
+TEST_F(JwksCacheTest, TestRefreshInBackground) {
+  auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
+  provider0.mutable_remote_jwks()->mutable_cache_duration()->set_seconds(10);
+  provider0.mutable_remote_jwks()->set_async_refresh(true);
+  cache_ = JwksCache::create(config_, time_system_, *api_);
+
+  auto jwks = cache_->findByIssuer("https://example.com");
+  // There are no keys to use until the first fetch completes.
+  EXPECT_FALSE(jwks->canRefreshInBackground());
+  jwks->setRemoteJwks(std::move(jwks_));
+  const auto* old_jwks = jwks->getJwksObj();
+
+  time_system_.sleep(std::chrono::seconds(15));
+  EXPECT_TRUE(jwks->isExpired());
+  EXPECT_TRUE(jwks->canRefreshInBackground());
+
+  auto* fetcher = new MockJwksFetcher;
+  JwksFetcher::JwksReceiver* receiver{};
+  EXPECT_CALL(*fetcher, fetch(_, _, _))
+      .WillOnce(Invoke([&receiver](const envoy::config::core::v3alpha::HttpUri&, Tracing::Span&,
+                                   JwksFetcher::JwksReceiver& jwks_receiver) {
+        receiver = &jwks_receiver;
+      }));
+  int created = 0;
+  auto create_fetcher = [fetcher, &created]() {
+    created++;
+    return Common::JwksFetcherPtr(fetcher);
+  };
+  jwks->refreshInBackground(create_fetcher);
+  // A refresh in flight is not started again.
+  jwks->refreshInBackground(create_fetcher);
+  EXPECT_EQ(1, created);
+  EXPECT_EQ(old_jwks, jwks->getJwksObj());
+
+  // A failed refresh keeps the old keys.
+  receiver->onJwksError(JwksFetcher::JwksReceiver::Failure::Network);
+  EXPECT_EQ(old_jwks, jwks->getJwksObj());
+  EXPECT_TRUE(jwks->isExpired());
+
+  // The fetcher is reused by the next refresh.
+  EXPECT_CALL(*fetcher, fetch(_, _, _))
+      .WillOnce(Invoke([](const envoy::config::core::v3alpha::HttpUri&, Tracing::Span&,
+                          JwksFetcher::JwksReceiver& jwks_receiver) {
+        jwks_receiver.onJwksSuccess(Jwks::createFrom(PublicKey, Jwks::JWKS));
+      }));
+  jwks->refreshInBackground(create_fetcher);
+  EXPECT_EQ(1, created);
+  EXPECT_NE(old_jwks, jwks->getJwksObj());
+  EXPECT_FALSE(jwks->isExpired());
+
+  // Expired keys are not used past one more cache duration.
+  time_system_.sleep(std::chrono::seconds(25));
+  EXPECT_FALSE(jwks->canRefreshInBackground());
+}
+
+// Test that expired keys are not used without async_refresh
+TEST_F(JwksCacheTest, TestNoRefreshInBackground) {
+  auto jwks = cache_->findByIssuer("https://example.com");
+  jwks->setRemoteJwks(std::move(jwks_));
+  time_system_.sleep(std::chrono::seconds(700));
+  EXPECT_TRUE(jwks->isExpired());
+  EXPECT_FALSE(jwks->canRefreshInBackground());
+}
+
 // Test findByProvider
 TEST_F(JwksCacheTest, TestFindByProvider) {
   EXPECT_TRUE(cache_->findByProvider(ProviderName) != nullptr);
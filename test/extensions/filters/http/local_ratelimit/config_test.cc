@@ -0,0 +1,66 @@
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.h"
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.validate.h"
+
+#include "extensions/filters/http/local_ratelimit/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+namespace {
+
+TEST(LocalRateLimitFilterConfigTest, LocalRateLimitFilter) {
+  const std::string yaml_string = R"EOF(
+stat_prefix: test
+token_bucket:
+  max_tokens: 10
+  fill_interval: 1s
+descriptors:
+- descriptor:
+    entries:
+    - key: generic_key
+      value: value
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 1s
+  )EOF";
+
+  envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml_string, proto_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  LocalRateLimitFilterConfig factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamDecoderFilter(_));
+  cb(filter_callback);
+}
+
+TEST(LocalRateLimitFilterConfigTest, MissingDescriptorTokenBucket) {
+  const std::string yaml_string = R"EOF(
+stat_prefix: test
+descriptors:
+- descriptor:
+    entries:
+    - key: generic_key
+      value: value
+  )EOF";
+
+  envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit proto_config;
+  EXPECT_THROW(TestUtility::loadFromYamlAndValidate(yaml_string, proto_config),
+               ProtoValidationException);
+}
+
+} // namespace
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,264 @@
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.h"
+#include "envoy/extensions/filters/http/local_ratelimit/v3alpha/local_rate_limit.pb.validate.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/local_ratelimit/local_ratelimit.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/router/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::SetArgReferee;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+namespace {
+
+class LocalRateLimitFilterTest : public testing::Test {
+public:
+  // The buckets of the descriptors are created after the default bucket, and the mock timers are
+  // handed out to the timer creations in the reverse order of their construction. The bucket of
+  // the descriptor at index i is filled by descriptor_fill_timers_[i].
+  void initialize(const std::string& yaml, uint32_t descriptor_timers = 0) {
+    envoy::extensions::filters::http::local_ratelimit::v3alpha::LocalRateLimit proto_config;
+    TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+    for (uint32_t i = 0; i < descriptor_timers; i++) {
+      descriptor_fill_timers_.insert(descriptor_fill_timers_.begin(),
+                                     new NiceMock<Event::MockTimer>(&dispatcher_));
+    }
+    if (proto_config.has_token_bucket()) {
+      fill_timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+    }
+    config_ = std::make_shared<FilterConfig>(proto_config, dispatcher_, local_info_, stats_store_,
+                                             runtime_);
+    filter_ = std::make_unique<Filter>(config_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+
+    auto& route_entry = decoder_callbacks_.route_->route_entry_;
+    route_entry.rate_limit_policy_.rate_limit_policy_entry_.clear();
+    route_entry.rate_limit_policy_.rate_limit_policy_entry_.emplace_back(route_rate_limit_);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_store_.counter("http_local_rate_limit.test." + name).value();
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Router::MockRateLimitPolicyEntry> route_rate_limit_;
+  Event::MockTimer* fill_timer_{};
+  std::vector<Event::MockTimer*> descriptor_fill_timers_;
+  FilterConfigSharedPtr config_;
+  std::unique_ptr<Filter> filter_;
+  Http::TestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/"}};
+};
+
+const std::string default_bucket_config = R"EOF(
+stat_prefix: test
+token_bucket:
+  max_tokens: 2
+  tokens_per_fill: 1
+  fill_interval: 1s
+)EOF";
+
+const std::string descriptors_config = R"EOF(
+stat_prefix: test
+token_bucket:
+  max_tokens: 1
+  fill_interval: 1s
+descriptors:
+- descriptor:
+    entries:
+    - key: generic_key
+      value: one
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 1s
+- descriptor:
+    entries:
+    - key: generic_key
+      value: two
+  token_bucket:
+    max_tokens: 2
+    fill_interval: 1s
+)EOF";
+
+TEST_F(LocalRateLimitFilterTest, TooFastFillRate) {
+  EXPECT_THROW_WITH_MESSAGE(initialize(R"EOF(
+stat_prefix: test
+token_bucket:
+  max_tokens: 1
+  fill_interval: 0.049s
+)EOF"),
+                            EnvoyException,
+                            "local rate limit token bucket fill timer must be >= 50ms");
+}
+
+TEST_F(LocalRateLimitFilterTest, DuplicateDescriptors) {
+  EXPECT_THROW_WITH_MESSAGE(initialize(R"EOF(
+stat_prefix: test
+descriptors:
+- descriptor:
+    entries:
+    - key: generic_key
+      value: one
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 1s
+- descriptor:
+    entries:
+    - key: generic_key
+      value: one
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 1s
+)EOF",
+                                       1),
+                            EnvoyException, "local rate limit descriptors must be unique");
+}
+
+TEST_F(LocalRateLimitFilterTest, DefaultBucket) {
+  initialize(default_bucket_config);
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  EXPECT_CALL(decoder_callbacks_.stream_info_,
+              setResponseFlag(StreamInfo::ResponseFlag::RateLimited));
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::TooManyRequests, _, _, _,
+                                                 "local_rate_limited"));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(2, counter("ok"));
+  EXPECT_EQ(1, counter("rate_limited"));
+
+  // A single token is put back by each fill.
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(1000), nullptr));
+  fill_timer_->invokeCallback();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(3, counter("ok"));
+  EXPECT_EQ(2, counter("rate_limited"));
+}
+
+TEST_F(LocalRateLimitFilterTest, FillDoesNotExceedMaxTokens) {
+  initialize(default_bucket_config);
+
+  filter_->decodeHeaders(request_headers_, false);
+  fill_timer_->invokeCallback();
+  fill_timer_->invokeCallback();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+}
+
+TEST_F(LocalRateLimitFilterTest, SharedByFilters) {
+  initialize(default_bucket_config);
+
+  // The streams of all the workers take their tokens from the same bucket.
+  Filter other_filter(config_);
+  other_filter.setDecoderFilterCallbacks(decoder_callbacks_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            other_filter.decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            other_filter.decodeHeaders(request_headers_, false));
+}
+
+TEST_F(LocalRateLimitFilterTest, RuntimeDisabled) {
+  initialize(R"EOF(
+stat_prefix: test
+token_bucket:
+  max_tokens: 1
+  fill_interval: 1s
+runtime_enabled:
+  default_value: true
+  runtime_key: foo_key
+)EOF");
+
+  EXPECT_CALL(runtime_.snapshot_, getBoolean("foo_key", true)).WillRepeatedly(Return(false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(0, counter("ok"));
+  EXPECT_EQ(0, counter("rate_limited"));
+}
+
+TEST_F(LocalRateLimitFilterTest, NoBucket) {
+  initialize("stat_prefix: test");
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(1, counter("ok"));
+}
+
+TEST_F(LocalRateLimitFilterTest, DescriptorBucket) {
+  initialize(descriptors_config, 2);
+
+  std::vector<RateLimit::Descriptor> descriptors{{{{"generic_key", "two"}}}};
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _))
+      .WillRepeatedly(SetArgReferee<1>(descriptors));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+
+  // Only the bucket of the descriptor is filled.
+  descriptor_fill_timers_[1]->invokeCallback();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+}
+
+TEST_F(LocalRateLimitFilterTest, UnknownDescriptorUsesDefaultBucket) {
+  initialize(descriptors_config, 2);
+
+  std::vector<RateLimit::Descriptor> descriptors{{{{"generic_key", "three"}}}};
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _))
+      .WillRepeatedly(SetArgReferee<1>(descriptors));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+}
+
+TEST_F(LocalRateLimitFilterTest, AllMatchingDescriptorsConsumed) {
+  initialize(descriptors_config, 2);
+
+  std::vector<RateLimit::Descriptor> descriptors{{{{"generic_key", "two"}}},
+                                                 {{{"generic_key", "one"}}}};
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _))
+      .WillRepeatedly(SetArgReferee<1>(descriptors));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  // The bucket of the second descriptor is empty.
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+}
+
+TEST_F(LocalRateLimitFilterTest, NoRouteUsesDefaultBucket) {
+  initialize(descriptors_config, 2);
+
+  EXPECT_CALL(*decoder_callbacks_.route_, routeEntry()).WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+}
+
+} // namespace
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
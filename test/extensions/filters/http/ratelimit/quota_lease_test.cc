@@ -0,0 +1,229 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/http/ratelimit/v3alpha/rate_limit.pb.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/ratelimit/quota_lease.h"
+
+#include "test/extensions/filters/common/ratelimit/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::WithArgs;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+namespace {
+
+using Filters::Common::RateLimit::LimitStatus;
+using Filters::Common::RateLimit::MockClient;
+using Filters::Common::RateLimit::RequestCallbacks;
+
+class QuotaLeaseTest : public testing::Test {
+public:
+  // Each lease client saves the callbacks and the size of its lease requests.
+  void initialize(const std::string& yaml) {
+    envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit::QuotaLease proto_config;
+    TestUtility::loadFromYaml(yaml, proto_config);
+    leases_ = std::make_unique<QuotaLeases>(
+        proto_config, "foo", tls_, time_system_, "test.", stats_store_, [this]() {
+          auto client = std::make_unique<NiceMock<MockClient>>();
+          EXPECT_CALL(*client, limit(_, "foo", _, _, _))
+              .WillRepeatedly(WithArgs<0, 4>(
+                  Invoke([this](RequestCallbacks& callbacks, uint32_t hits_addend) -> void {
+                    EXPECT_EQ(nullptr, lease_callbacks_);
+                    lease_callbacks_ = &callbacks;
+                    lease_sizes_.push_back(hits_addend);
+                  })));
+          clients_.push_back(client.get());
+          return client;
+        });
+  }
+
+  void completeLease(LimitStatus status) {
+    ASSERT_NE(nullptr, lease_callbacks_);
+    RequestCallbacks* callbacks = lease_callbacks_;
+    lease_callbacks_ = nullptr;
+    callbacks->complete(status, nullptr, nullptr);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_store_.counter("test.ratelimit.quota_lease." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
+  std::vector<MockClient*> clients_;
+  RequestCallbacks* lease_callbacks_{};
+  std::vector<uint32_t> lease_sizes_;
+  std::unique_ptr<QuotaLeases> leases_;
+  const std::vector<Envoy::RateLimit::Descriptor> descriptors_{{{{"key", "value"}}}};
+};
+
+TEST_F(QuotaLeaseTest, LeasedHits) {
+  initialize("lease_size: 4");
+
+  // The first requests call the rate limit service, while a single lease is requested.
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_EQ(std::vector<uint32_t>{4}, lease_sizes_);
+  completeLease(LimitStatus::OK);
+  EXPECT_EQ(1, counter("lease_ok"));
+
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_EQ(2, counter("hit"));
+  EXPECT_EQ(2, counter("miss"));
+}
+
+TEST_F(QuotaLeaseTest, RefillNearDepletion) {
+  initialize("lease_size: 4");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OK);
+
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_EQ(1, lease_sizes_.size());
+  // A single hit is left, a new lease is requested in the background while the hits are used.
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_EQ(2, lease_sizes_.size());
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_EQ(2, lease_sizes_.size());
+  completeLease(LimitStatus::OK);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    EXPECT_TRUE(leases_->consume(descriptors_));
+  }
+  // The lease client is reused.
+  EXPECT_EQ(1, clients_.size());
+}
+
+TEST_F(QuotaLeaseTest, RefillThreshold) {
+  initialize(R"EOF(
+  lease_size: 4
+  refill_threshold: 0
+  )EOF");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OK);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    EXPECT_TRUE(leases_->consume(descriptors_));
+  }
+  EXPECT_EQ(1, lease_sizes_.size());
+  EXPECT_TRUE(leases_->consume(descriptors_));
+  EXPECT_EQ(2, lease_sizes_.size());
+}
+
+TEST_F(QuotaLeaseTest, LeaseExpires) {
+  initialize(R"EOF(
+  lease_size: 10
+  lease_duration: 2s
+  )EOF");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OK);
+  EXPECT_TRUE(leases_->consume(descriptors_));
+
+  time_system_.sleep(std::chrono::seconds(2));
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_EQ(2, lease_sizes_.size());
+  completeLease(LimitStatus::OK);
+  EXPECT_TRUE(leases_->consume(descriptors_));
+}
+
+TEST_F(QuotaLeaseTest, RefusedLease) {
+  initialize(R"EOF(
+  lease_size: 10
+  lease_duration: 2s
+  )EOF");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OverLimit);
+  EXPECT_EQ(1, counter("lease_failed"));
+
+  // No lease is requested until the lease duration elapsed.
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_EQ(1, lease_sizes_.size());
+
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_EQ(2, lease_sizes_.size());
+  completeLease(LimitStatus::OK);
+  EXPECT_TRUE(leases_->consume(descriptors_));
+}
+
+TEST_F(QuotaLeaseTest, DistinctDescriptors) {
+  initialize("lease_size: 10");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OK);
+  EXPECT_FALSE(leases_->consume({{{{"key", "other_value"}}}}));
+  completeLease(LimitStatus::OK);
+  EXPECT_FALSE(leases_->consume({{{{"key", "value"}}}, {{{"key", "value"}}}}));
+  completeLease(LimitStatus::OK);
+  EXPECT_EQ(3, clients_.size());
+}
+
+TEST_F(QuotaLeaseTest, MaxLeases) {
+  initialize(R"EOF(
+  lease_size: 10
+  max_leases: 1
+  )EOF");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OK);
+  // No lease is made for the other descriptor set.
+  EXPECT_FALSE(leases_->consume({{{{"key", "other_value"}}}}));
+  EXPECT_EQ(1, clients_.size());
+  EXPECT_EQ(2, counter("miss"));
+  EXPECT_TRUE(leases_->consume(descriptors_));
+}
+
+TEST_F(QuotaLeaseTest, EvictIdleLease) {
+  initialize(R"EOF(
+  lease_size: 10
+  lease_duration: 2s
+  max_leases: 1
+  )EOF");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  completeLease(LimitStatus::OK);
+
+  // Once its hits expired, the lease makes room for the other descriptor set.
+  time_system_.sleep(std::chrono::seconds(2));
+  EXPECT_FALSE(leases_->consume({{{{"key", "other_value"}}}}));
+  EXPECT_EQ(1, counter("lease_evicted"));
+  EXPECT_EQ(2, clients_.size());
+  completeLease(LimitStatus::OK);
+  EXPECT_TRUE(leases_->consume({{{{"key", "other_value"}}}}));
+
+  // The lease holding unexpired hits is kept.
+  EXPECT_FALSE(leases_->consume(descriptors_));
+  EXPECT_EQ(1, counter("lease_evicted"));
+  EXPECT_EQ(2, clients_.size());
+}
+
+TEST_F(QuotaLeaseTest, CancelOnDestroy) {
+  initialize("lease_size: 10");
+  EXPECT_FALSE(leases_->consume(descriptors_));
+
+  EXPECT_CALL(*clients_[0], cancel());
+  leases_.reset();
+}
+
+} // namespace
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
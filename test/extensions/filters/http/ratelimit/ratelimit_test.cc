@@ -16,9 +16,11 @@
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/ratelimit/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -51,11 +53,10 @@ public:
   }
 
   void SetUpTest(const std::string& yaml) {
-    envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit proto_config{};
-    TestUtility::loadFromYaml(yaml, proto_config);
+    TestUtility::loadFromYaml(yaml, config_proto_);
 
     config_.reset(
-        new FilterConfig(proto_config, local_info_, stats_store_, runtime_, http_context_));
+        new FilterConfig(config_proto_, local_info_, stats_store_, runtime_, http_context_));
 
     client_ = new Filters::Common::RateLimit::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client_});
@@ -94,6 +95,9 @@ public:
   std::vector<RateLimit::Descriptor> descriptor_{{{{"descriptor_key", "descriptor_value"}}}};
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
   Http::ContextImpl http_context_;
+  envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit config_proto_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
 };
 
 TEST_F(HttpRateLimitFilterTest, NoRoute) {
@@ -760,6 +764,53 @@ TEST_F(HttpRateLimitFilterTest, ConfigValueTest) {
   EXPECT_EQ(FilterRequestType::Internal, config_->requestType());
 }
 
+TEST_F(HttpRateLimitFilterTest, QuotaLease) {
+  SetUpTest(filter_config_);
+  envoy::extensions::filters::http::ratelimit::v3alpha::RateLimit::QuotaLease lease_config;
+  lease_config.set_lease_size(10);
+  Filters::Common::RateLimit::RequestCallbacks* lease_callbacks{};
+  auto client_factory = [&lease_callbacks]() {
+    auto client = std::make_unique<Filters::Common::RateLimit::MockClient>();
+    EXPECT_CALL(*client, limit(_, "foo", _, _, 10))
+        .WillOnce(WithArgs<0>(
+            Invoke([&lease_callbacks](Filters::Common::RateLimit::RequestCallbacks& callbacks)
+                       -> void { lease_callbacks = &callbacks; })));
+    return client;
+  };
+  config_.reset(new FilterConfig(config_proto_, local_info_, stats_store_, runtime_, http_context_,
+                                 std::make_unique<QuotaLeases>(lease_config, "foo", tls_,
+                                                               time_system_, "", stats_store_,
+                                                               client_factory)));
+  client_ = new Filters::Common::RateLimit::MockClient();
+  filter_ = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client_});
+  filter_->setDecoderFilterCallbacks(filter_callbacks_);
+
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _))
+      .WillRepeatedly(SetArgReferee<1>(descriptor_));
+
+  // The first request calls the rate limit service, while hits are leased in the background.
+  EXPECT_CALL(*client_, limit(_, "foo", _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  ASSERT_NE(nullptr, lease_callbacks);
+  lease_callbacks->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr);
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr);
+
+  // The next request uses a leased hit.
+  auto* leased_client = new Filters::Common::RateLimit::MockClient();
+  Filter leased_filter(config_, Filters::Common::RateLimit::ClientPtr{leased_client});
+  leased_filter.setDecoderFilterCallbacks(filter_callbacks_);
+  EXPECT_CALL(*leased_client, limit(_, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            leased_filter.decodeHeaders(request_headers_, false));
+  EXPECT_EQ(1U, stats_store_.counter("ratelimit.quota_lease.hit").value());
+}
+
 TEST_F(HttpRateLimitFilterTest, DefaultConfigValueTest) {
   std::string stage_filter_config = R"EOF(
   {
@@ -157,6 +157,50 @@ TEST_F(RoleBasedAccessControlFilterTest, RouteLocalOverride) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(headers_, true));
 }
 
+// The policies only depend on the connection, so their decisions are reused by the next streams.
+TEST_F(RoleBasedAccessControlFilterTest, ConnectionDecisionReused) {
+  setDestinationPort(123);
+  setMetadata();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(headers_, false));
+
+  // The connection attributes do not change in practice, this only shows that the policies are
+  // not evaluated again for a new stream of the connection.
+  setDestinationPort(456);
+  RoleBasedAccessControlFilter next_filter(config_);
+  next_filter.setDecoderFilterCallbacks(callbacks_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, next_filter.decodeHeaders(headers_, false));
+  EXPECT_EQ(2U, config_->stats().allowed_.value());
+  EXPECT_EQ(0U, config_->stats().denied_.value());
+  EXPECT_EQ(2U, config_->stats().shadow_denied_.value());
+}
+
+// Policies matching headers are evaluated for each stream.
+TEST_F(RoleBasedAccessControlFilterTest, HeaderPoliciesNotReused) {
+  envoy::extensions::filters::http::rbac::v3alpha::RBAC config;
+  envoy::config::rbac::v3alpha::Policy policy;
+  auto* header = policy.add_permissions()->mutable_header();
+  header->set_name(":path");
+  header->set_exact_match("/allowed");
+  policy.add_principals()->set_any(true);
+  config.mutable_rules()->set_action(envoy::config::rbac::v3alpha::RBAC::ALLOW);
+  (*config.mutable_rules()->mutable_policies())["foo"] = policy;
+  auto header_config = std::make_shared<RoleBasedAccessControlFilterConfig>(config, "test", store_);
+
+  RoleBasedAccessControlFilter allowed_filter(header_config);
+  allowed_filter.setDecoderFilterCallbacks(callbacks_);
+  Http::TestHeaderMapImpl allowed_headers{{":path", "/allowed"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            allowed_filter.decodeHeaders(allowed_headers, true));
+
+  RoleBasedAccessControlFilter denied_filter(header_config);
+  denied_filter.setDecoderFilterCallbacks(callbacks_);
+  Http::TestHeaderMapImpl denied_headers{{":path", "/denied"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            denied_filter.decodeHeaders(denied_headers, true));
+  EXPECT_EQ(1U, header_config->stats().allowed_.value());
+  EXPECT_EQ(1U, header_config->stats().denied_.value());
+}
+
 } // namespace
 } // namespace RBACFilter
 } // namespace HttpFilters
@@ -3,11 +3,13 @@
 #include "test/extensions/common/tap/common.h"
 #include "test/extensions/filters/http/tap/common.h"
 #include "test/mocks/common.h"
+#include "test/mocks/runtime/mocks.h"
 #include "test/test_common/utility.h"
 
 using testing::_;
 using testing::Assign;
 using testing::InSequence;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -249,6 +251,56 @@ http_streamed_trace_segment:
   EXPECT_TRUE(tapper_->onDestroyLog());
 }
 
+// Only the requests sampled by tap_enabled are tapped.
+TEST(HttpTapConfigImplTest, TapEnabledSampling) {
+  envoy::config::tap::v3alpha::TapConfig proto_config;
+  TestUtility::loadFromYaml(R"EOF(
+match_config:
+  any_match: true
+output_config:
+  sinks:
+    - file_per_tap:
+        path_prefix: foo
+tap_enabled:
+  default_value:
+    numerator: 10
+  runtime_key: tap.enabled
+)EOF",
+                            proto_config);
+  NiceMock<Runtime::MockLoader> runtime;
+  auto config = std::make_shared<HttpTapConfigImpl>(std::move(proto_config), nullptr, runtime);
+
+  EXPECT_CALL(runtime.snapshot_,
+              featureEnabled("tap.enabled",
+                             testing::Matcher<const envoy::type::v3alpha::FractionalPercent&>(_)))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+  EXPECT_EQ(nullptr, config->createPerRequestTapper(1));
+  EXPECT_NE(nullptr, config->createPerRequestTapper(2));
+}
+
+// Without tap_enabled, all the requests are tapped.
+TEST(HttpTapConfigImplTest, NoTapEnabled) {
+  envoy::config::tap::v3alpha::TapConfig proto_config;
+  TestUtility::loadFromYaml(R"EOF(
+match_config:
+  any_match: true
+output_config:
+  sinks:
+    - file_per_tap:
+        path_prefix: foo
+)EOF",
+                            proto_config);
+  NiceMock<Runtime::MockLoader> runtime;
+  auto config = std::make_shared<HttpTapConfigImpl>(std::move(proto_config), nullptr, runtime);
+
+  EXPECT_CALL(
+      runtime.snapshot_,
+      featureEnabled(_, testing::Matcher<const envoy::type::v3alpha::FractionalPercent&>(_)))
+      .Times(0);
+  EXPECT_NE(nullptr, config->createPerRequestTapper(1));
+}
+
 } // namespace
 } // namespace TapFilter
 } // namespace HttpFilters
@@ -1,6 +1,7 @@
 #include "common/common/hex.h"
 #include "common/network/io_socket_handle_impl.h"
 
+#include "extensions/filters/listener/common/peek_buffer.h"
 #include "extensions/filters/listener/http_inspector/http_inspector.h"
 
 #include "test/mocks/api/mocks.h"
@@ -90,6 +91,29 @@ TEST_F(HttpInspectorTest, InlineReadIoError) {
   EXPECT_EQ(0, cfg_->stats().http_not_found_.value());
 }
 
+// Test that the data peeked by a listener filter run before is inspected without peeking again.
+TEST_F(HttpInspectorTest, InspectPeekedData) {
+  init(/*include_inline_recv=*/false);
+  const absl::string_view header = "GET /anything HTTP/1.1\r\nhost: google.com\r\n\r\n";
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke([&header](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+        ASSERT(length >= header.size());
+        memcpy(buffer, header.data(), header.size());
+        return Api::SysCallSizeResult{ssize_t(header.size()), 0};
+      }));
+  PeekBuffer::get().peek(socket_, Config::MAX_INSPECT_SIZE);
+
+  const std::vector<absl::string_view> alpn_protos{absl::string_view("http/1.1")};
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(alpn_protos));
+  EXPECT_EQ(filter_->onAccept(cb_), Network::FilterStatus::Continue);
+  EXPECT_EQ(1, cfg_->stats().http11_found_.value());
+
+  // The peeked data is forgotten once the filter is destroyed.
+  filter_.reset();
+  EXPECT_TRUE(PeekBuffer::get().peeked(socket_, Config::MAX_INSPECT_SIZE).empty());
+}
+
 TEST_F(HttpInspectorTest, InlineReadInspectHttp10) {
   init(/*include_inline_recv=*/false);
   const absl::string_view header =
@@ -513,6 +513,73 @@ TEST_P(ProxyProtocolTest, v2ParseExtensions) {
   disconnect();
 }
 
+TEST_P(ProxyProtocolTest, v2ParseExtensionsWholeHeader) {
+  // A well-formed ipv4/tcp with a pair of TLV extensions received along with the header is read
+  // from a single peek, without asking for the bytes available.
+  constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49, 0x54,
+                                0x0a, 0x21, 0x11, 0x00, 0x14, 0x01, 0x02, 0x03, 0x04, 0x00, 0x01,
+                                0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 0x00, 0x00, 0x01, 0xff, 0x00,
+                                0x00, 0x01, 0xff, 'D',  'A',  'T',  'A'};
+
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  EXPECT_CALL(os_sys_calls, ioctl(_, FIONREAD, _)).Times(0);
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
+      .WillOnce(Invoke([](int fd, void* buf, size_t len, int flags) {
+        const ssize_t rc = ::recv(fd, buf, len, flags);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, recv(_, _, sizeof(buffer) - 4, 0))
+      .WillOnce(Invoke([](int fd, void* buf, size_t len, int flags) {
+        const ssize_t rc = ::recv(fd, buf, len, flags);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, writev(_, _, _))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
+        const ssize_t rc = ::writev(fd, iov, iovcnt);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, readv(_, _, _))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
+        const ssize_t rc = ::readv(fd, iov, iovcnt);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, close(_)).Times(AnyNumber()).WillRepeatedly(Invoke([](int fd) {
+    const int rc = ::close(fd);
+    return Api::SysCallIntResult{rc, errno};
+  }));
+  connect();
+  write(buffer, sizeof(buffer));
+  expectData("DATA");
+
+  EXPECT_EQ(server_connection_->remoteAddress()->ip()->addressAsString(), "1.2.3.4");
+  EXPECT_TRUE(server_connection_->localAddressRestored());
+
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2ParseLargeExtensions) {
+  // A well-formed ipv4/tcp with a TLV extension too large to be peeked at once is accepted
+  constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
+                                0x54, 0x0a, 0x21, 0x11, 0x04, 0x0f, 0x01, 0x02, 0x03, 0x04,
+                                0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02};
+  constexpr uint8_t tlv[] = {0x0, 0x4, 0x0};
+
+  connect();
+  write(buffer, sizeof(buffer));
+  write(tlv, sizeof(tlv));
+  write(std::string(1024, 'x'));
+  write("DATA");
+  expectData("DATA");
+
+  EXPECT_EQ(server_connection_->remoteAddress()->ip()->addressAsString(), "1.2.3.4");
+
+  disconnect();
+}
+
 TEST_P(ProxyProtocolTest, v2ParseExtensionsIoctlError) {
   // A well-formed ipv4/tcp with a TLV extension. An error is created in the ioctl(...FIONREAD...)
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
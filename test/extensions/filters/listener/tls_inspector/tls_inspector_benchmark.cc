@@ -3,6 +3,7 @@
 #include "common/network/io_socket_handle_impl.h"
 #include "common/network/listen_socket_impl.h"
 
+#include "extensions/filters/listener/http_inspector/http_inspector.h"
 #include "extensions/filters/listener/tls_inspector/tls_inspector.h"
 
 #include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
@@ -54,15 +55,17 @@ public:
 
 class FastMockOsSysCalls : public Api::MockOsSysCalls {
 public:
-  FastMockOsSysCalls(const std::vector<uint8_t>& client_hello) : client_hello_(client_hello) {}
+  FastMockOsSysCalls(const std::vector<uint8_t>& data) : data_(data) {}
 
   Api::SysCallSizeResult recv(int, void* buffer, size_t length, int) override {
-    RELEASE_ASSERT(length >= client_hello_.size(), "");
-    memcpy(buffer, client_hello_.data(), client_hello_.size());
-    return Api::SysCallSizeResult{ssize_t(client_hello_.size()), 0};
+    RELEASE_ASSERT(length >= data_.size(), "");
+    memcpy(buffer, data_.data(), data_.size());
+    recv_calls_++;
+    return Api::SysCallSizeResult{ssize_t(data_.size()), 0};
   }
 
-  const std::vector<uint8_t> client_hello_;
+  const std::vector<uint8_t> data_;
+  uint64_t recv_calls_{};
 };
 
 static void BM_TlsInspector(benchmark::State& state) {
@@ -78,8 +81,8 @@ static void BM_TlsInspector(benchmark::State& state) {
 
   for (auto _ : state) {
     Filter filter(cfg);
-    filter.onAccept(cb);
-    dispatcher.file_event_callback_(Event::FileReadyType::Read);
+    // The ClientHello is parsed from the data peeked inline, without waiting for a file event.
+    RELEASE_ASSERT(filter.onAccept(cb) == Network::FilterStatus::Continue, "");
     RELEASE_ASSERT(socket.detectedTransportProtocol() == "tls", "");
     RELEASE_ASSERT(socket.requestedServerName() == "example.com", "");
     RELEASE_ASSERT(socket.requestedApplicationProtocols().size() == 2 &&
@@ -93,6 +96,35 @@ static void BM_TlsInspector(benchmark::State& state) {
 
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// A plaintext HTTP/1.1 connection accepted by a listener with both the TLS and HTTP inspectors,
+// which classify it from a single peek of its data.
+static void BM_TlsInspectorThenHttpInspector(benchmark::State& state) {
+  const absl::string_view request = "GET / HTTP/1.1\r\nhost: example.com\r\n\r\n";
+  NiceMock<FastMockOsSysCalls> os_sys_calls(std::vector<uint8_t>(request.begin(), request.end()));
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
+  NiceMock<Stats::MockStore> store;
+  ConfigSharedPtr tls_cfg(std::make_shared<Config>(store));
+  HttpInspector::ConfigSharedPtr http_cfg(std::make_shared<HttpInspector::Config>(store));
+  Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>();
+  Network::ConnectionSocketImpl socket(std::move(io_handle), nullptr, nullptr);
+  NiceMock<FastMockDispatcher> dispatcher;
+  FastMockListenerFilterCallbacks cb(socket, dispatcher);
+
+  for (auto _ : state) {
+    Filter tls_filter(tls_cfg);
+    HttpInspector::Filter http_filter(http_cfg);
+    RELEASE_ASSERT(tls_filter.onAccept(cb) == Network::FilterStatus::Continue, "");
+    RELEASE_ASSERT(http_filter.onAccept(cb) == Network::FilterStatus::Continue, "");
+    RELEASE_ASSERT(socket.requestedApplicationProtocols().size() == 1 &&
+                       socket.requestedApplicationProtocols().front() == "http/1.1",
+                   "");
+    socket.setRequestedApplicationProtocols({});
+  }
+  RELEASE_ASSERT(os_sys_calls.recv_calls_ == static_cast<uint64_t>(state.iterations()), "");
+}
+
+BENCHMARK(BM_TlsInspectorThenHttpInspector)->Unit(benchmark::kMicrosecond);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
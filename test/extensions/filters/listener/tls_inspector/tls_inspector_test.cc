@@ -40,6 +40,7 @@ public:
     EXPECT_CALL(cb_, socket()).WillRepeatedly(ReturnRef(socket_));
     EXPECT_CALL(cb_, dispatcher()).WillRepeatedly(ReturnRef(dispatcher_));
     EXPECT_CALL(socket_, ioHandle()).WillRepeatedly(ReturnRef(*io_handle_));
+    EXPECT_CALL(testing::Const(socket_), ioHandle()).WillRepeatedly(ReturnRef(*io_handle_));
 
     // Prepare the first recv attempt during
     EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
@@ -176,6 +177,35 @@ TEST_F(TlsInspectorTest, MultipleReads) {
   EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
 }
 
+// Test that a ClientHello fragmented over several handshake records is reassembled.
+TEST_F(TlsInspectorTest, ClientHelloSpanningRecords) {
+  init();
+  const std::string servername("example.com");
+  const std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(servername, "");
+  // Split the handshake message of the single record generated into records of 16 bytes.
+  constexpr size_t record_header_size = 5;
+  constexpr size_t fragment_size = 16;
+  std::vector<uint8_t> records;
+  for (size_t i = record_header_size; i < client_hello.size(); i += fragment_size) {
+    const size_t len = std::min(fragment_size, client_hello.size() - i);
+    records.insert(records.end(), {client_hello[0], client_hello[1], client_hello[2], 0,
+                                   static_cast<uint8_t>(len)});
+    records.insert(records.end(), client_hello.begin() + i, client_hello.begin() + i + len);
+  }
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke([&records](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+        ASSERT(length >= records.size());
+        memcpy(buffer, records.data(), records.size());
+        return Api::SysCallSizeResult{ssize_t(records.size()), 0};
+      }));
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+}
+
 // Test that the filter correctly handles a ClientHello with no extensions present.
 TEST_F(TlsInspectorTest, NoExtensions) {
   init();
@@ -242,6 +272,7 @@ TEST_F(TlsInspectorTest, InlineReadSucceed) {
   EXPECT_CALL(cb_, socket()).WillRepeatedly(ReturnRef(socket_));
   EXPECT_CALL(cb_, dispatcher()).WillRepeatedly(ReturnRef(dispatcher_));
   EXPECT_CALL(socket_, ioHandle()).WillRepeatedly(ReturnRef(*io_handle_));
+  EXPECT_CALL(testing::Const(socket_), ioHandle()).WillRepeatedly(ReturnRef(*io_handle_));
   const std::vector<absl::string_view> alpn_protos = {absl::string_view("h2")};
   const std::string servername("example.com");
   std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(servername, "\x02h2");
@@ -190,6 +190,8 @@ class ConfigBufferSizeGTSingleRequest : public Config {
   uint32_t maxUpstreamUnknownConnections() const override { return 0; }
   bool enableCommandStats() const override { return false; }
   ReadPolicy readPolicy() const override { return ReadPolicy::Master; }
+  bool enableAdaptiveBatching() const override { return false; }
+  ReplicaSelection replicaSelection() const override { return ReplicaSelection::Random; }
 };
 
 TEST_F(RedisClientImplTest, BatchWithTimerFiring) {
@@ -337,6 +339,93 @@ TEST_F(RedisClientImplTest, Basic) {
   client_->close();
 }
 
+class ConfigAdaptiveBatching : public Config {
+  bool disableOutlierEvents() const override { return false; }
+  std::chrono::milliseconds opTimeout() const override { return std::chrono::milliseconds(25); }
+  bool enableHashtagging() const override { return false; }
+  bool enableRedirection() const override { return false; }
+  unsigned int maxBufferSizeBeforeFlush() const override { return 0; }
+  std::chrono::milliseconds bufferFlushTimeoutInMs() const override {
+    return std::chrono::milliseconds(3);
+  }
+  ReadPolicy readPolicy() const override { return ReadPolicy::Master; }
+  uint32_t maxUpstreamUnknownConnections() const override { return 0; }
+  bool enableCommandStats() const override { return false; }
+  bool enableAdaptiveBatching() const override { return true; }
+  ReplicaSelection replicaSelection() const override { return ReplicaSelection::Random; }
+};
+
+TEST_F(RedisClientImplTest, AdaptiveBatching) {
+  InSequence s;
+
+  setup(std::make_unique<ConfigAdaptiveBatching>());
+  onConnected();
+
+  // The first request is written right away.
+  Common::Redis::RespValue request1;
+  MockClientCallbacks callbacks1;
+  EXPECT_CALL(*encoder_, encode(Ref(request1), _));
+  EXPECT_CALL(*flush_timer_, enabled()).WillOnce(Return(false));
+  EXPECT_CALL(*upstream_connection_, write(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) { data.drain(data.length()); }));
+  EXPECT_CALL(*connect_or_op_timer_, enableTimer(_, _));
+  PoolRequest* handle1 = client_->makeRequest(request1, callbacks1);
+  EXPECT_NE(nullptr, handle1);
+
+  // The requests made while the first one is in flight are written together at the end of the
+  // event loop iteration.
+  Common::Redis::RespValue request2;
+  MockClientCallbacks callbacks2;
+  EXPECT_CALL(*encoder_, encode(Ref(request2), _));
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  PoolRequest* handle2 = client_->makeRequest(request2, callbacks2);
+  EXPECT_NE(nullptr, handle2);
+
+  Common::Redis::RespValue request3;
+  MockClientCallbacks callbacks3;
+  EXPECT_CALL(*encoder_, encode(Ref(request3), _));
+  PoolRequest* handle3 = client_->makeRequest(request3, callbacks3);
+  EXPECT_NE(nullptr, handle3);
+
+  EXPECT_CALL(*flush_timer_, enabled()).WillOnce(Return(false));
+  EXPECT_CALL(*upstream_connection_, write(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) {
+        EXPECT_EQ("$-1\r\n$-1\r\n", data.toString());
+        data.drain(data.length());
+      }));
+  flush_timer_->invokeCallback();
+
+  Buffer::OwnedImpl fake_data;
+  EXPECT_CALL(*decoder_, decode(Ref(fake_data))).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    InSequence s;
+    Common::Redis::RespValuePtr response1(new Common::Redis::RespValue());
+    EXPECT_CALL(callbacks1, onResponse_(Ref(response1)));
+    EXPECT_CALL(*connect_or_op_timer_, enableTimer(_, _));
+    EXPECT_CALL(host_->outlier_detector_,
+                putResult(Upstream::Outlier::Result::ExtOriginRequestSuccess, _));
+    callbacks_->onRespValue(std::move(response1));
+
+    Common::Redis::RespValuePtr response2(new Common::Redis::RespValue());
+    EXPECT_CALL(callbacks2, onResponse_(Ref(response2)));
+    EXPECT_CALL(*connect_or_op_timer_, enableTimer(_, _));
+    EXPECT_CALL(host_->outlier_detector_,
+                putResult(Upstream::Outlier::Result::ExtOriginRequestSuccess, _));
+    callbacks_->onRespValue(std::move(response2));
+
+    Common::Redis::RespValuePtr response3(new Common::Redis::RespValue());
+    EXPECT_CALL(callbacks3, onResponse_(Ref(response3)));
+    EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+    EXPECT_CALL(host_->outlier_detector_,
+                putResult(Upstream::Outlier::Result::ExtOriginRequestSuccess, _));
+    callbacks_->onRespValue(std::move(response3));
+  }));
+  upstream_read_filter_->onData(fake_data, false);
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  client_->close();
+}
+
 class ConfigEnableCommandStats : public Config {
   bool disableOutlierEvents() const override { return false; }
   std::chrono::milliseconds opTimeout() const override { return std::chrono::milliseconds(25); }
@@ -349,6 +438,8 @@ class ConfigEnableCommandStats : public Config {
   ReadPolicy readPolicy() const override { return ReadPolicy::Master; }
   uint32_t maxUpstreamUnknownConnections() const override { return 0; }
   bool enableCommandStats() const override { return true; }
+  bool enableAdaptiveBatching() const override { return false; }
+  ReplicaSelection replicaSelection() const override { return ReplicaSelection::Random; }
 };
 
 void initializeRedisSimpleCommand(Common::Redis::RespValue* request, std::string command_name,
@@ -712,6 +803,8 @@ class ConfigOutlierDisabled : public Config {
   ReadPolicy readPolicy() const override { return ReadPolicy::Master; }
   uint32_t maxUpstreamUnknownConnections() const override { return 0; }
   bool enableCommandStats() const override { return false; }
+  bool enableAdaptiveBatching() const override { return false; }
+  ReplicaSelection replicaSelection() const override { return ReplicaSelection::Random; }
 };
 
 TEST_F(RedisClientImplTest, OutlierDisabled) {
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <vector>
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
+#include "common/common/fmt.h"
 
 #include "extensions/filters/network/common/redis/codec_impl.h"
 
@@ -276,6 +278,58 @@ TEST_F(RedisEncoderDecoderImplTest, BulkString) {
   EXPECT_EQ(0UL, buffer_.length());
 }
 
+// The body of a large bulk string is moved from the decoded data, rather than copied, and its
+// slices are added to the encoded output.
+TEST_F(RedisEncoderDecoderImplTest, LargeBulkString) {
+  const uint64_t min_size = DecoderImpl::MinBufferedBulkStringSize;
+  const std::string body(min_size * 3, 'v');
+  const std::string encoded =
+      fmt::format("*2\r\n$3\r\nset\r\n${}\r\n{}\r\n", body.size(), body);
+  const auto has_slice = [](const Buffer::Instance& buffer, const void* mem) {
+    const uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+    std::vector<Buffer::RawSlice> slices(num_slices);
+    buffer.getRawSlices(slices.data(), num_slices);
+    return std::any_of(slices.begin(), slices.end(),
+                       [mem](const Buffer::RawSlice& slice) { return slice.mem_ == mem; });
+  };
+
+  // The data is received in slices of min_size bytes, and decoded in two parts.
+  Buffer::OwnedImpl received;
+  for (uint64_t offset = 0; offset < encoded.size(); offset += min_size) {
+    Buffer::OwnedImpl slice(encoded.substr(offset, min_size));
+    received.move(slice);
+  }
+  Buffer::RawSlice received_slices[2];
+  ASSERT_LE(2, received.getRawSlices(received_slices, 2));
+  const void* body_slice = received_slices[1].mem_;
+  buffer_.move(received, min_size * 2 + min_size / 2);
+  decoder_.decode(buffer_);
+  EXPECT_TRUE(decoded_values_.empty());
+  decoder_.decode(received);
+  ASSERT_EQ(1, decoded_values_.size());
+  EXPECT_EQ(0UL, buffer_.length());
+  EXPECT_EQ(0UL, received.length());
+
+  const RespValue& value = decoded_values_[0]->asArray()[1];
+  ASSERT_NE(nullptr, value.bulkStringBuffer());
+  EXPECT_EQ(body.size(), value.bulkStringBuffer()->length());
+  EXPECT_TRUE(has_slice(*value.bulkStringBuffer(), body_slice));
+  EXPECT_EQ(nullptr, decoded_values_[0]->asArray()[0].bulkStringBuffer());
+
+  RespValue copy = *decoded_values_[0];
+  EXPECT_EQ(value.bulkStringBuffer(), copy.asArray()[1].bulkStringBuffer());
+  encoder_.encode(copy, buffer_);
+  EXPECT_EQ(encoded, buffer_.toString());
+  EXPECT_TRUE(has_slice(buffer_, body_slice));
+
+  // The string is filled from the buffer, which is dropped once the string can be modified.
+  EXPECT_EQ(body, value.asString());
+  EXPECT_NE(nullptr, value.bulkStringBuffer());
+  copy.asArray()[1].asString() = "modified";
+  EXPECT_EQ(nullptr, copy.asArray()[1].bulkStringBuffer());
+  EXPECT_EQ(body, decoded_values_[0]->asArray()[1].asString());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, Integer) {
   RespValue value;
   value.type(RespType::Integer);
@@ -0,0 +1,192 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/dubbo_proxy/router/connection_multiplexer.h"
+
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+namespace {
+
+class MockMultiplexedRequestCallbacks : public MultiplexedRequestCallbacks {
+public:
+  MOCK_METHOD1(onRequestSent, void(Upstream::HostDescriptionConstSharedPtr host));
+  MOCK_METHOD2(onRequestFailure, void(Tcp::ConnectionPool::PoolFailureReason reason,
+                                      Upstream::HostDescriptionConstSharedPtr host));
+  MOCK_METHOD1(onResponse, void(Buffer::Instance& data));
+};
+
+// Builds a Dubbo message with the given request id and body.
+std::string message(uint64_t request_id, const std::string& body) {
+  Buffer::OwnedImpl buffer;
+  buffer.writeBEInt<uint16_t>(0xdabb);
+  buffer.writeBEInt<uint8_t>(0xc2);
+  buffer.writeBEInt<uint8_t>(0x14);
+  buffer.writeBEInt<uint64_t>(request_id);
+  buffer.writeBEInt<uint32_t>(body.size());
+  buffer.add(body);
+  return buffer.toString();
+}
+
+class DubboConnectionMultiplexerTest : public testing::Test {
+public:
+  DubboConnectionMultiplexerTest() : multiplexer_(dispatcher_) {
+    ON_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillByDefault(Invoke([this](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+  }
+
+  MultiplexedRequest* newRequest(uint64_t request_id, const std::string& body, bool two_way,
+                                 MultiplexedRequestCallbacks& callbacks) {
+    Buffer::OwnedImpl request(message(request_id, body));
+    MultiplexedRequest* handle = multiplexer_.newRequest(pool_, request, two_way, callbacks);
+    EXPECT_EQ(0, request.length());
+    return handle;
+  }
+
+  void upstreamData(const std::string& data) {
+    Buffer::OwnedImpl buffer(data);
+    upstream_callbacks_->onUpstreamData(buffer, false);
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  ConnectionMultiplexer multiplexer_;
+  NiceMock<Tcp::ConnectionPool::MockInstance> pool_;
+  NiceMock<Network::MockClientConnection> connection_;
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+  MockMultiplexedRequestCallbacks callbacks1_;
+  MockMultiplexedRequestCallbacks callbacks2_;
+};
+
+// The requests with the same id of two downstream connections are sent on a single upstream
+// connection with unique ids, and their responses are matched back to them with their ids.
+TEST_F(DubboConnectionMultiplexerTest, SharedConnection) {
+  EXPECT_CALL(pool_, newConnection(_));
+  MultiplexedRequest* handle1 = newRequest(1, "first", true, callbacks1_);
+  MultiplexedRequest* handle2 = newRequest(1, "second", true, callbacks2_);
+  EXPECT_NE(nullptr, handle1);
+  EXPECT_NE(nullptr, handle2);
+  EXPECT_EQ(1, multiplexer_.activeConnections());
+
+  EXPECT_CALL(connection_, write(BufferStringEqual(message(0, "first")), false));
+  EXPECT_CALL(connection_, write(BufferStringEqual(message(1, "second")), false));
+  EXPECT_CALL(callbacks1_, onRequestSent(_));
+  EXPECT_CALL(callbacks2_, onRequestSent(_));
+  pool_.poolReady(connection_);
+
+  // The responses may be received in any order, and split over several reads.
+  EXPECT_CALL(callbacks2_, onResponse(BufferStringEqual(message(1, "second reply"))));
+  const std::string responses = message(1, "second reply") + message(0, "first reply");
+  upstreamData(responses.substr(0, 20));
+  upstreamData(responses.substr(20, 20));
+
+  EXPECT_CALL(callbacks1_, onResponse(BufferStringEqual(message(1, "first reply"))));
+  EXPECT_CALL(pool_, released(_));
+  EXPECT_CALL(connection_, close(_)).Times(0);
+  upstreamData(responses.substr(40));
+  EXPECT_EQ(0, multiplexer_.activeConnections());
+}
+
+// A one way request is done once sent, and a request sent on a ready connection is sent right
+// away.
+TEST_F(DubboConnectionMultiplexerTest, OnewayRequest) {
+  newRequest(1, "two way", true, callbacks1_);
+  EXPECT_CALL(callbacks1_, onRequestSent(_));
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(connection_, write(BufferStringEqual(message(1, "one way")), false));
+  EXPECT_CALL(callbacks2_, onRequestSent(_));
+  EXPECT_EQ(nullptr, newRequest(7, "one way", false, callbacks2_));
+  EXPECT_EQ(1, multiplexer_.activeConnections());
+
+  EXPECT_CALL(callbacks1_, onResponse(_));
+  EXPECT_CALL(pool_, released(_));
+  upstreamData(message(0, ""));
+  EXPECT_EQ(0, multiplexer_.activeConnections());
+}
+
+// The requests waiting for a connection are failed when the pool fails.
+TEST_F(DubboConnectionMultiplexerTest, PoolFailure) {
+  newRequest(1, "first", true, callbacks1_);
+  newRequest(2, "second", false, callbacks2_);
+
+  EXPECT_CALL(callbacks1_,
+              onRequestFailure(Tcp::ConnectionPool::PoolFailureReason::RemoteConnectionFailure, _));
+  EXPECT_CALL(callbacks2_,
+              onRequestFailure(Tcp::ConnectionPool::PoolFailureReason::RemoteConnectionFailure, _));
+  pool_.poolFailure(Tcp::ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+  EXPECT_EQ(0, multiplexer_.activeConnections());
+}
+
+// The requests waiting for their response are failed when the connection is closed.
+TEST_F(DubboConnectionMultiplexerTest, ConnectionClosed) {
+  newRequest(1, "first", true, callbacks1_);
+  EXPECT_CALL(callbacks1_, onRequestSent(_));
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(callbacks1_,
+              onRequestFailure(Tcp::ConnectionPool::PoolFailureReason::RemoteConnectionFailure, _));
+  EXPECT_CALL(pool_, released(_));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(0, multiplexer_.activeConnections());
+}
+
+// A response to a cancelled request is dropped, and the connection is closed when released as
+// it may still receive one.
+TEST_F(DubboConnectionMultiplexerTest, CancelledRequest) {
+  MultiplexedRequest* handle1 = newRequest(1, "first", true, callbacks1_);
+  newRequest(2, "second", true, callbacks2_);
+  EXPECT_CALL(callbacks1_, onRequestSent(_));
+  EXPECT_CALL(callbacks2_, onRequestSent(_));
+  pool_.poolReady(connection_);
+
+  handle1->cancel();
+  EXPECT_CALL(callbacks1_, onResponse(_)).Times(0);
+  upstreamData(message(0, "first reply"));
+
+  EXPECT_CALL(callbacks1_, onRequestSent(_));
+  newRequest(3, "third", true, callbacks1_)->cancel();
+
+  EXPECT_CALL(callbacks2_, onResponse(_));
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(pool_, released(_));
+  upstreamData(message(1, "second reply"));
+  EXPECT_EQ(0, multiplexer_.activeConnections());
+}
+
+// The connection is closed when a response is not a Dubbo message.
+TEST_F(DubboConnectionMultiplexerTest, InvalidResponse) {
+  newRequest(1, "first", true, callbacks1_);
+  EXPECT_CALL(callbacks1_, onRequestSent(_));
+  pool_.poolReady(connection_);
+
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush))
+      .WillOnce(Invoke([this](Network::ConnectionCloseType) -> void {
+        upstream_callbacks_->onEvent(Network::ConnectionEvent::LocalClose);
+      }));
+  EXPECT_CALL(callbacks1_,
+              onRequestFailure(Tcp::ConnectionPool::PoolFailureReason::LocalConnectionFailure, _));
+  upstreamData(std::string(16, 'x'));
+  EXPECT_EQ(0, multiplexer_.activeConnections());
+}
+
+} // namespace
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -130,6 +130,57 @@ TEST(HessianUtilsTest, peekString) {
   }
 }
 
+TEST(HessianUtilsTest, peekStringSize) {
+  // Insufficient data
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x02, 't'}));
+    EXPECT_THROW_WITH_MESSAGE(HessianUtils::peekStringSize(buffer), EnvoyException,
+                              "buffer underflow");
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x52, 0x00, 0x01, 't'}));
+    EXPECT_THROW_WITH_MESSAGE(HessianUtils::peekStringSize(buffer), EnvoyException,
+                              "buffer underflow");
+  }
+
+  // Incorrect type
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x20, 't'}));
+    EXPECT_THROW_WITH_MESSAGE(HessianUtils::peekStringSize(buffer), EnvoyException,
+                              "hessian type is not string 32");
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x01, 0x00}));
+    EXPECT_EQ(1, HessianUtils::peekStringSize(buffer, 1));
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x53, 0x00, 0x05, 'h', 'e', 'l', 'l', 'o'}));
+    EXPECT_EQ(8, HessianUtils::peekStringSize(buffer));
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string(
+        {0x52, 0x00, 0x07, 'h', 'e', 'l', 'l', 'o', ',', ' ', 0x05, 'w', 'o', 'r', 'l', 'd'}));
+    EXPECT_EQ(16, HessianUtils::peekStringSize(buffer));
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x31, 0x01}) + std::string(256 + 0x01, 't'));
+    EXPECT_EQ(256 + 0x01 + 2, HessianUtils::peekStringSize(buffer));
+    EXPECT_EQ(256 + 0x01 + 2, buffer.length());
+  }
+}
+
 TEST(HessianUtilsTest, peekLong) {
   // Insufficient data
   {
@@ -39,6 +39,19 @@ TEST(DubboProxyRouterFilterConfigTest, RouterFilterWithEmptyProtoConfig) {
   cb(filter_callback);
 }
 
+TEST(DubboProxyRouterFilterConfigTest, RouterFilterWithMultiplexing) {
+  envoy::extensions::filters::network::dubbo_proxy::router::v3alpha::Router router_config;
+  router_config.set_multiplex_upstream_connections(true);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  RouterFilterConfig factory;
+  DubboFilters::FilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(router_config, "stats", context);
+  DubboFilters::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addDecoderFilter(_)).Times(2);
+  cb(filter_callback);
+  cb(filter_callback);
+}
+
 TEST(DubboProxyRouterFilterConfigTest, DoubleRegistrationTest) {
   EXPECT_THROW_WITH_MESSAGE(
       (Registry::RegisterFactory<RouterFilterConfig,
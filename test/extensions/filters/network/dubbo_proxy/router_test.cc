@@ -6,6 +6,7 @@
 #include "extensions/filters/network/dubbo_proxy/serializer_impl.h"
 
 #include "test/extensions/filters/network/dubbo_proxy/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/printers.h"
@@ -337,6 +338,60 @@ TEST_F(DubboRouterTest, PoolConnectionFailureWithOnewayMessage) {
   destroyRouter();
 }
 
+// The requests are sent through the connection multiplexer when configured, and their responses
+// are handed to the filter chain with their original request id.
+TEST_F(DubboRouterTest, MultiplexedRequest) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  ConnectionMultiplexer multiplexer(dispatcher);
+  route_ = new NiceMock<MockRoute>();
+  route_ptr_.reset(route_);
+  router_ = std::make_unique<Router>(context_.clusterManager(), &multiplexer);
+  router_->setDecoderFilterCallbacks(callbacks_);
+
+  initializeMetadata(MessageType::Request);
+  auto context = std::make_shared<ContextImpl>();
+  context->message_origin_data().writeBEInt<uint16_t>(0xdabb);
+  context->message_origin_data().writeBEInt<uint16_t>(0xc200);
+  context->message_origin_data().writeBEInt<uint64_t>(1);
+  context->message_origin_data().writeBEInt<uint32_t>(0);
+  context->set_header_size(16);
+  message_context_ = context;
+
+  EXPECT_CALL(callbacks_, route()).WillOnce(Return(route_ptr_));
+  EXPECT_CALL(*route_, routeEntry()).WillOnce(Return(&route_entry_));
+  EXPECT_CALL(route_entry_, clusterName()).WillRepeatedly(ReturnRef(cluster_name_));
+  EXPECT_CALL(callbacks_, serializationType()).WillOnce(Return(SerializationType::Hessian2));
+  EXPECT_CALL(callbacks_, protocolType()).WillOnce(Return(ProtocolType::Dubbo));
+  EXPECT_EQ(FilterStatus::StopIteration, router_->onMessageDecoded(metadata_, message_context_));
+
+  EXPECT_CALL(*context_.cluster_manager_.tcp_conn_pool_.connection_data_, addUpstreamCallbacks(_))
+      .WillOnce(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& cb) -> void {
+        upstream_callbacks_ = &cb;
+      }));
+  EXPECT_CALL(upstream_connection_, write(_, false));
+  EXPECT_CALL(callbacks_, continueDecoding());
+  context_.cluster_manager_.tcp_conn_pool_.poolReady(upstream_connection_);
+
+  // The response carries the first request id of the multiplexer.
+  Buffer::OwnedImpl response;
+  response.writeBEInt<uint16_t>(0xdabb);
+  response.writeBEInt<uint16_t>(0x0214);
+  response.writeBEInt<uint64_t>(0);
+  response.writeBEInt<uint32_t>(0);
+
+  EXPECT_CALL(callbacks_, startUpstreamResponse());
+  EXPECT_CALL(callbacks_, upstreamData(_))
+      .WillOnce(Invoke([](Buffer::Instance& data) -> DubboFilters::UpstreamResponseStatus {
+        EXPECT_EQ(1, data.peekBEInt<uint64_t>(4));
+        return DubboFilters::UpstreamResponseStatus::Complete;
+      }));
+  EXPECT_CALL(context_.cluster_manager_.tcp_conn_pool_, released(Ref(upstream_connection_)));
+  upstream_callbacks_->onUpstreamData(response, false);
+  EXPECT_EQ(0, multiplexer.activeConnections());
+
+  destroyRouter();
+}
+
 TEST_F(DubboRouterTest, NoRoute) {
   initializeRouter();
   initializeMetadata(MessageType::Request);
@@ -761,6 +761,57 @@ TEST_F(HttpConnectionManagerConfigTest, MergeSlashesFalse) {
   EXPECT_FALSE(config.shouldMergeSlashes());
 }
 
+// Validated that the stream arena is disabled by default.
+TEST_F(HttpConnectionManagerConfigTest, StreamArenaDefault) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  http_filters:
+  - name: envoy.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_);
+  EXPECT_EQ(0, config.streamArenaBlockSize());
+}
+
+TEST_F(HttpConnectionManagerConfigTest, StreamArenaConfigured) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  stream_arena_block_size: 2048
+  http_filters:
+  - name: envoy.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_);
+  EXPECT_EQ(2048, config.streamArenaBlockSize());
+}
+
+TEST_F(HttpConnectionManagerConfigTest, RequestBodySpillConfigured) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  request_body_spill:
+    directory: /tmp
+  http_filters:
+  - name: envoy.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_);
+  ASSERT_TRUE(config.requestBodySpill().has_value());
+  EXPECT_EQ("/tmp", config.requestBodySpill()->directory_);
+  EXPECT_EQ(1024U * 1024, config.requestBodySpill()->memory_threshold_bytes_);
+}
+
 TEST_F(HttpConnectionManagerConfigTest, ConfiguredRequestTimeout) {
   const std::string yaml_string = R"EOF(
   stat_prefix: ingress_http
@@ -990,6 +1041,27 @@ TEST_F(FilterChainTest, createFilterChain) {
   config.createFilterChain(callbacks);
 }
 
+// With filter timing, the filters are named before they are added to the chain.
+TEST_F(FilterChainTest, createFilterChainWithFilterTiming) {
+  auto hcm_config = parseHttpConnectionManagerFromV2Yaml(basic_config_);
+  hcm_config.mutable_filter_timing_sampling()->set_value(50);
+
+  HttpConnectionManagerConfig config(hcm_config, context_, date_provider_,
+                                     route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_);
+  ASSERT_TRUE(config.filterTiming().has_value());
+  EXPECT_EQ(5000U, config.filterTiming()->sampling_);
+  EXPECT_EQ(2U, config.filterTiming()->stats_.size());
+
+  testing::InSequence s;
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  EXPECT_CALL(callbacks, setFilterName(absl::string_view("envoy.http_dynamo_filter")));
+  EXPECT_CALL(callbacks, addStreamFilter(_));
+  EXPECT_CALL(callbacks, setFilterName(absl::string_view("envoy.router")));
+  EXPECT_CALL(callbacks, addStreamDecoderFilter(_));
+  config.createFilterChain(callbacks);
+}
+
 // Tests where upgrades are configured on via the HCM.
 TEST_F(FilterChainTest, createUpgradeFilterChain) {
   auto hcm_config = parseHttpConnectionManagerFromV2Yaml(basic_config_);
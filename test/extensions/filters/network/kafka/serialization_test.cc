@@ -29,6 +29,8 @@ TEST_EmptyDeserializerShouldNotBeReady(StringDeserializer);
 TEST_EmptyDeserializerShouldNotBeReady(NullableStringDeserializer);
 TEST_EmptyDeserializerShouldNotBeReady(BytesDeserializer);
 TEST_EmptyDeserializerShouldNotBeReady(NullableBytesDeserializer);
+TEST_EmptyDeserializerShouldNotBeReady(RecordsDeserializer);
+TEST_EmptyDeserializerShouldNotBeReady(NullableRecordsDeserializer);
 
 TEST(ArrayDeserializer, EmptyBufferShouldNotBeReady) {
   // given
@@ -174,6 +176,56 @@ TEST(NullableBytesDeserializer, ShouldThrowOnInvalidLength) {
   EXPECT_THROW(testee.feed(data), EnvoyException);
 }
 
+TEST(RecordsDeserializer, ShouldDeserialize) {
+  const Records value{4};
+  serializeThenDeserializeAndCheckEquality<RecordsDeserializer>(value);
+}
+
+TEST(RecordsDeserializer, ShouldDeserializeEmptyRecords) {
+  const Records value{0};
+  serializeThenDeserializeAndCheckEquality<RecordsDeserializer>(value);
+}
+
+TEST(RecordsDeserializer, ShouldThrowOnInvalidLength) {
+  // given
+  RecordsDeserializer testee;
+  Buffer::OwnedImpl buffer;
+
+  const int32_t records_length = -1; // Non-nullable records accept length >= 0.
+  encoder.encode(records_length, buffer);
+
+  absl::string_view data = {getRawData(buffer), 1024};
+
+  // when
+  // then
+  EXPECT_THROW(testee.feed(data), EnvoyException);
+}
+
+TEST(NullableRecordsDeserializer, ShouldDeserialize) {
+  const NullableRecords value{Records{4}};
+  serializeThenDeserializeAndCheckEquality<NullableRecordsDeserializer>(value);
+}
+
+TEST(NullableRecordsDeserializer, ShouldDeserializeNullRecords) {
+  const NullableRecords value = absl::nullopt;
+  serializeThenDeserializeAndCheckEquality<NullableRecordsDeserializer>(value);
+}
+
+TEST(NullableRecordsDeserializer, ShouldThrowOnInvalidLength) {
+  // given
+  NullableRecordsDeserializer testee;
+  Buffer::OwnedImpl buffer;
+
+  const int32_t records_length = -2; // -1 is OK for nullable records.
+  encoder.encode(records_length, buffer);
+
+  absl::string_view data = {getRawData(buffer), 1024};
+
+  // when
+  // then
+  EXPECT_THROW(testee.feed(data), EnvoyException);
+}
+
 TEST(ArrayDeserializer, ShouldConsumeCorrectAmountOfData) {
   const std::vector<std::string> value{{"aaa", "bbbbb", "cc", "d", "e", "ffffffff"}};
   serializeThenDeserializeAndCheckEquality<ArrayDeserializer<std::string, StringDeserializer>>(
@@ -52,6 +52,72 @@ TEST(BsonImplTest, InvalodDocumentTermination) {
   EXPECT_THROW(DocumentImpl::create(buffer), EnvoyException);
 }
 
+TEST(LazyDocumentListTest, DecodeOnFirstUse) {
+  DocumentSharedPtr doc1 = DocumentImpl::create()->addString("hello", "world");
+  DocumentSharedPtr doc2 = DocumentImpl::create()->addInt32("int32", 1);
+  Buffer::OwnedImpl buffer;
+  doc1->encode(buffer);
+  doc2->encode(buffer);
+  const uint64_t length = buffer.length();
+  buffer.add("next");
+
+  LazyDocumentList list;
+  list.fromBuffer(buffer, length);
+  EXPECT_EQ("next", buffer.toString());
+  EXPECT_EQ(2, list.size());
+  EXPECT_EQ(length, list.byteSize());
+
+  const LazyDocumentList& const_list = list;
+  ASSERT_EQ(2, const_list.documents().size());
+  EXPECT_TRUE(*doc1 == *const_list.documents().front());
+  EXPECT_TRUE(*doc2 == *const_list.documents().back());
+  EXPECT_EQ(2, list.size());
+  EXPECT_EQ(length, list.byteSize());
+
+  list.documents().push_back(DocumentImpl::create());
+  EXPECT_EQ(3, list.size());
+  EXPECT_EQ(length + 5, list.byteSize());
+}
+
+TEST(LazyDocumentListTest, InvalidLength) {
+  {
+    Buffer::OwnedImpl buffer;
+    LazyDocumentList list;
+    EXPECT_THROW(list.fromBuffer(buffer, 5), EnvoyException);
+  }
+
+  {
+    // A document longer than the list.
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 100);
+    buffer.add(std::string(100, 0));
+    LazyDocumentList list;
+    EXPECT_THROW(list.fromBuffer(buffer, 10), EnvoyException);
+  }
+
+  {
+    // A document shorter than its length prefix and terminating byte.
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 4);
+    LazyDocumentList list;
+    EXPECT_THROW(list.fromBuffer(buffer, 4), EnvoyException);
+  }
+}
+
+TEST(LazyDocumentListTest, InvalidDocument) {
+  Buffer::OwnedImpl buffer;
+  BufferHelper::writeInt32(buffer, 5);
+  uint8_t invalid_document_end = 0x1;
+  buffer.add(&invalid_document_end, sizeof(invalid_document_end));
+
+  LazyDocumentList list;
+  list.fromBuffer(buffer, 5);
+  EXPECT_EQ(1, list.size());
+  EXPECT_THROW(list.documents(), EnvoyException);
+  EXPECT_EQ(0, list.size());
+  EXPECT_EQ(0, list.byteSize());
+}
+
 TEST(BufferHelperTest, InvalidSize) {
   {
     Buffer::OwnedImpl buffer;
@@ -11,7 +11,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::Eq;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Pointee;
 
@@ -166,6 +168,67 @@ TEST_F(MongoCodecImplTest, Reply) {
   decoder_.onData(output_);
 }
 
+// The documents of a decoded reply are counted and sized without decoding them.
+TEST_F(MongoCodecImplTest, ReplyDocumentsCount) {
+  ReplyMessageImpl reply(2, 2);
+  reply.numberReturned(2);
+  reply.documents().push_back(Bson::DocumentImpl::create()->addString("hello", "world"));
+  reply.documents().push_back(Bson::DocumentImpl::create());
+  const uint64_t documents_byte_size = reply.documentsByteSize();
+  EXPECT_EQ(2, reply.documentsCount());
+
+  encoder_.encodeReply(reply);
+  EXPECT_CALL(callbacks_, decodeReply_(_)).WillOnce(Invoke([&](ReplyMessagePtr& message) -> void {
+    EXPECT_EQ(2, message->documentsCount());
+    EXPECT_EQ(documents_byte_size, message->documentsByteSize());
+    EXPECT_TRUE(*message == reply);
+  }));
+  decoder_.onData(output_);
+}
+
+// The documents of the replies are drained as they are received when skipped, and the following
+// messages are decoded.
+TEST_F(MongoCodecImplTest, SkipReplyDocuments) {
+  DecoderImpl decoder(callbacks_, true);
+
+  ReplyMessageImpl reply(2, 2);
+  reply.cursorId(20000);
+  reply.numberReturned(2);
+  reply.documents().push_back(Bson::DocumentImpl::create()->addString("hello", "world"));
+  reply.documents().push_back(Bson::DocumentImpl::create());
+  const uint64_t documents_byte_size = reply.documentsByteSize();
+  encoder_.encodeReply(reply);
+
+  GetMoreMessageImpl get_more(3, 3);
+  get_more.fullCollectionName("test");
+  get_more.cursorId(20000);
+  Buffer::OwnedImpl get_more_data;
+  EncoderImpl(get_more_data).encodeGetMore(get_more);
+
+  // Only the header and fields of the reply are needed to decode it.
+  Buffer::OwnedImpl data;
+  data.move(output_, Message::MessageHeaderSize + 19);
+  decoder.onData(data);
+  EXPECT_EQ(Message::MessageHeaderSize + 19, data.length());
+
+  data.move(output_, 10);
+  EXPECT_CALL(callbacks_, decodeReply_(_)).WillOnce(Invoke([&](ReplyMessagePtr& message) -> void {
+    EXPECT_EQ(20000, message->cursorId());
+    EXPECT_EQ(2, message->documentsCount());
+    EXPECT_EQ(documents_byte_size, message->documentsByteSize());
+    EXPECT_TRUE(message->documents().empty());
+    EXPECT_NO_THROW(Json::Factory::loadFromString(message->toString(true)));
+  }));
+  decoder.onData(data);
+  EXPECT_EQ(0, data.length());
+
+  // The rest of the documents are drained, and the next message is decoded.
+  output_.move(get_more_data);
+  EXPECT_CALL(callbacks_, decodeGetMore_(Pointee(Eq(get_more))));
+  decoder.onData(output_);
+  EXPECT_EQ(0, output_.length());
+}
+
 TEST_F(MongoCodecImplTest, GetMoreEqual) {
   {
     GetMoreMessageImpl g1(0, 0);
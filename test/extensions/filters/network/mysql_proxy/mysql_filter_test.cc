@@ -937,6 +937,56 @@ TEST_F(MySQLFilterTest, MySqlLoginAndQueryTest) {
   EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
 }
 
+/*
+ * Test Mysql query response split over several buffers, after handshake completes
+ * SM: greeting(p=10) -> challenge-req(v41) -> serv-resp-ok ->
+ * -> Query-request -> Query-response (split) -> Query-request
+ * validate that the response is handled as soon as its header is received and that its
+ * payload is skipped
+ */
+TEST_F(MySQLFilterTest, MySqlQueryResponseSplitTest) {
+  initialize();
+
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onNewConnection());
+
+  std::string greeting_data = encodeServerGreeting(MYSQL_PROTOCOL_10);
+  Buffer::InstancePtr greet_data(new Buffer::OwnedImpl(greeting_data));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(*greet_data, false));
+
+  std::string clogin_data =
+      encodeClientLogin(MYSQL_CLIENT_CAPAB_41VS320, "user1", CHALLENGE_SEQ_NUM);
+  Buffer::InstancePtr client_login_data(new Buffer::OwnedImpl(clogin_data));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(*client_login_data, false));
+
+  std::string srv_resp_data = encodeClientLoginResp(MYSQL_RESP_OK);
+  Buffer::InstancePtr server_resp_data(new Buffer::OwnedImpl(srv_resp_data));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(*server_resp_data, false));
+  EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
+
+  Command mysql_cmd_encode{};
+  mysql_cmd_encode.setCmd(Command::Cmd::Query);
+  std::string query = "CREATE DATABASE mysqldb";
+  mysql_cmd_encode.setData(query);
+  std::string query_data = mysql_cmd_encode.encode();
+  std::string mysql_msg = BufferHelper::encodeHdr(query_data, 0);
+  Buffer::InstancePtr client_query_data(new Buffer::OwnedImpl(mysql_msg));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(*client_query_data, false));
+  EXPECT_EQ(MySQLSession::State::ReqResp, filter_->getSession().getState());
+
+  std::string resp_msg = BufferHelper::encodeHdr(std::string(64 * 1024, 'x'), 1);
+  Buffer::InstancePtr resp_head(new Buffer::OwnedImpl(resp_msg.substr(0, 1024)));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(*resp_head, false));
+  EXPECT_EQ(MySQLSession::State::Req, filter_->getSession().getState());
+
+  mysql_msg = BufferHelper::encodeHdr(query_data, 0);
+  Buffer::InstancePtr resp_tail_and_query(new Buffer::OwnedImpl(resp_msg.substr(1024) + mysql_msg));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue,
+            filter_->onData(*resp_tail_and_query, false));
+  EXPECT_EQ(MySQLSession::State::ReqResp, filter_->getSession().getState());
+  EXPECT_EQ(2UL, config_->stats().queries_parsed_.value());
+  EXPECT_EQ(0UL, config_->stats().protocol_errors_.value());
+}
+
 } // namespace MySQLProxy
 } // namespace NetworkFilters
 } // namespace Extensions
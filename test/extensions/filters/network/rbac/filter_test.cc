@@ -124,6 +124,28 @@ TEST_F(RoleBasedAccessControlNetworkFilterTest, AllowedWithContinuousEnforcement
   EXPECT_EQ(2U, config_->stats().shadow_denied_.value());
 }
 
+// With continuous enforcement, the decision of policies which only depend on the connection is
+// not evaluated again, but it is still enforced and counted on each onData().
+TEST_F(RoleBasedAccessControlNetworkFilterTest, ContinuousEnforcementReusesConnectionDecision) {
+  config_ = setupConfig(true, true /* continuous enforcement */);
+  filter_ = std::make_unique<RoleBasedAccessControlFilter>(config_);
+  filter_->initializeReadFilterCallbacks(callbacks_);
+  setDestinationPort(456);
+  setMetadata();
+
+  EXPECT_CALL(callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush)).Times(2);
+  EXPECT_EQ(Network::FilterStatus::StopIteration, filter_->onData(data_, false));
+  setDestinationPort(123);
+  EXPECT_EQ(Network::FilterStatus::StopIteration, filter_->onData(data_, false));
+  EXPECT_EQ(0U, config_->stats().allowed_.value());
+  EXPECT_EQ(2U, config_->stats().denied_.value());
+  EXPECT_EQ(2U, config_->stats().shadow_allowed_.value());
+
+  auto filter_meta =
+      stream_info_.dynamicMetadata().filter_metadata().at(NetworkFilterNames::get().Rbac);
+  EXPECT_EQ("bar", filter_meta.fields().at("shadow_effective_policy_id").string_value());
+}
+
 TEST_F(RoleBasedAccessControlNetworkFilterTest, RequestedServerName) {
   setDestinationPort(999);
   setRequestedServerName("www.cncf.io");
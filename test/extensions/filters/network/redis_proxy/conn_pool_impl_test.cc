@@ -1015,6 +1015,8 @@ TEST_F(RedisConnPoolImplTest, MovedRedirectionSuccess) {
 
   EXPECT_CALL(*this, create_(_)).WillOnce(DoAll(SaveArg<0>(&host1), Return(client2)));
   EXPECT_CALL(*client2, makeRequest_(Ref(*request_value), _)).WillOnce(Return(&active_request2));
+  // The slot of the request is reported moved to the redirection host.
+  EXPECT_CALL(*cluster_refresh_manager_, onSlotMoved(_, 1111, "10.1.2.3:4000"));
   EXPECT_TRUE(client->client_callbacks_.back()->onRedirection(std::move(moved_response),
                                                               "10.1.2.3:4000", false));
   EXPECT_EQ(host1->address()->asString(), "10.1.2.3:4000");
@@ -1097,6 +1099,7 @@ TEST_F(RedisConnPoolImplTest, AskRedirectionSuccess) {
   EXPECT_CALL(*client2, makeRequest_(Ref(Common::Redis::Utility::AskingRequest::instance()), _))
       .WillOnce(Return(&ask_request));
   EXPECT_CALL(*client2, makeRequest_(Ref(*request_value), _)).WillOnce(Return(&active_request2));
+  EXPECT_CALL(*cluster_refresh_manager_, onSlotMoved(_, _, _)).Times(0);
   EXPECT_TRUE(client->client_callbacks_.back()->onRedirection(std::move(ask_response),
                                                               "10.1.2.3:4000", true));
   EXPECT_EQ(host1->address()->asString(), "10.1.2.3:4000");
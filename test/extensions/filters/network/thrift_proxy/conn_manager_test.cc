@@ -787,6 +787,108 @@ TEST_F(ThriftConnectionManagerTest, RequestAndErrorResponse) {
   EXPECT_EQ(1U, store_.counter("test.response_error").value());
 }
 
+// With payload passthrough, only the message begin is decoded and the bodies are moved as is.
+TEST_F(ThriftConnectionManagerTest, PayloadPassthroughRequestAndResponse) {
+  const std::string yaml = R"EOF(
+stat_prefix: test
+payload_passthrough: true
+)EOF";
+  initializeFilter(yaml);
+  writeComplexFramedBinaryMessage(buffer_, MessageType::Call, 0x0F);
+  // The frame size and the strict binary message begin of method "name".
+  const uint64_t body_size = buffer_.length() - 4 - 16;
+
+  ThriftFilters::DecoderFilterCallbacks* callbacks{};
+  EXPECT_CALL(*decoder_filter_, setDecoderFilterCallbacks(_))
+      .WillOnce(
+          Invoke([&](ThriftFilters::DecoderFilterCallbacks& cb) -> void { callbacks = &cb; }));
+  EXPECT_CALL(*decoder_filter_, passthroughSupported()).WillOnce(Return(true));
+  EXPECT_CALL(*decoder_filter_, structBegin(_)).Times(0);
+  EXPECT_CALL(*decoder_filter_, passthroughData(_))
+      .WillOnce(Invoke([&](Buffer::Instance& data) -> FilterStatus {
+        EXPECT_EQ(body_size, data.length());
+        return FilterStatus::Continue;
+      }));
+
+  EXPECT_EQ(filter_->onData(buffer_, false), Network::FilterStatus::StopIteration);
+  EXPECT_EQ(0U, buffer_.length());
+  EXPECT_EQ(1U, store_.counter("test.request_call").value());
+
+  writeComplexFramedBinaryMessage(write_buffer_, MessageType::Reply, 0x0F);
+  Buffer::OwnedImpl response_buffer;
+  writeComplexFramedBinaryMessage(response_buffer, MessageType::Reply, 0x0F);
+
+  FramedTransportImpl transport;
+  BinaryProtocolImpl proto;
+  callbacks->startUpstreamResponse(transport, proto);
+
+  EXPECT_CALL(filter_callbacks_.connection_, write(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& buffer, bool) -> void {
+        EXPECT_EQ(response_buffer.toString(), buffer.toString());
+      }));
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, deferredDelete_(_)).Times(1);
+  EXPECT_EQ(ThriftFilters::ResponseStatus::Complete, callbacks->upstreamData(write_buffer_));
+
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, store_.counter("test.request").value());
+  EXPECT_EQ(0U, stats_.request_active_.value());
+  EXPECT_EQ(1U, store_.counter("test.response").value());
+  EXPECT_EQ(1U, store_.counter("test.response_reply").value());
+  EXPECT_EQ(1U, store_.counter("test.response_success").value());
+  EXPECT_EQ(0U, store_.counter("test.response_error").value());
+}
+
+// The replies passed through are still told apart by their first field.
+TEST_F(ThriftConnectionManagerTest, PayloadPassthroughErrorResponse) {
+  const std::string yaml = R"EOF(
+stat_prefix: test
+payload_passthrough: true
+)EOF";
+  initializeFilter(yaml);
+  writeFramedBinaryMessage(buffer_, MessageType::Call, 0x0F);
+
+  ThriftFilters::DecoderFilterCallbacks* callbacks{};
+  EXPECT_CALL(*decoder_filter_, setDecoderFilterCallbacks(_))
+      .WillOnce(
+          Invoke([&](ThriftFilters::DecoderFilterCallbacks& cb) -> void { callbacks = &cb; }));
+  EXPECT_CALL(*decoder_filter_, passthroughSupported()).WillOnce(Return(true));
+
+  EXPECT_EQ(filter_->onData(buffer_, false), Network::FilterStatus::StopIteration);
+
+  writeFramedBinaryIDLException(write_buffer_, 0x0F);
+
+  FramedTransportImpl transport;
+  BinaryProtocolImpl proto;
+  callbacks->startUpstreamResponse(transport, proto);
+
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, deferredDelete_(_)).Times(1);
+  EXPECT_EQ(ThriftFilters::ResponseStatus::Complete, callbacks->upstreamData(write_buffer_));
+
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, store_.counter("test.response_reply").value());
+  EXPECT_EQ(0U, store_.counter("test.response_success").value());
+  EXPECT_EQ(1U, store_.counter("test.response_error").value());
+}
+
+// Requests are decoded when a filter needs their fields.
+TEST_F(ThriftConnectionManagerTest, PayloadPassthroughUnsupportedByFilter) {
+  const std::string yaml = R"EOF(
+stat_prefix: test
+payload_passthrough: true
+)EOF";
+  initializeFilter(yaml);
+  writeFramedBinaryMessage(buffer_, MessageType::Call, 0x0F);
+
+  EXPECT_CALL(*decoder_filter_, passthroughSupported()).WillOnce(Return(false));
+  EXPECT_CALL(*decoder_filter_, structBegin(_)).WillOnce(Return(FilterStatus::Continue));
+  EXPECT_CALL(*decoder_filter_, passthroughData(_)).Times(0);
+
+  EXPECT_EQ(filter_->onData(buffer_, false), Network::FilterStatus::StopIteration);
+  EXPECT_EQ(1U, store_.counter("test.request_call").value());
+}
+
 TEST_F(ThriftConnectionManagerTest, RequestAndInvalidResponse) {
   initializeFilter();
   writeFramedBinaryMessage(buffer_, MessageType::Call, 0x0F);
@@ -185,6 +185,7 @@ public:
   NiceMock<MockProtocol> proto_;
   MessageMetadataSharedPtr metadata_;
   NiceMock<MockDecoderEventHandler> handler_;
+  NiceMock<MockDecoderCallbacks> callbacks_;
 };
 
 class DecoderStateMachineNonValueTest : public DecoderStateMachineTestBase,
@@ -236,7 +237,7 @@ TEST_P(DecoderStateMachineNonValueTest, NoData) {
   ProtocolState state = GetParam();
   Buffer::OwnedImpl buffer;
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
   dsm.setCurrentState(state);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
   EXPECT_EQ(dsm.currentState(), state);
@@ -256,7 +257,7 @@ TEST_P(DecoderStateMachineValueTest, NoFieldValueData) {
   EXPECT_CALL(proto_, readFieldEnd(Ref(buffer))).WillOnce(Return(true));
   EXPECT_CALL(proto_, readFieldBegin(Ref(buffer), _, _, _)).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::FieldBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -280,7 +281,7 @@ TEST_P(DecoderStateMachineValueTest, FieldValue) {
   EXPECT_CALL(proto_, readFieldEnd(Ref(buffer))).WillOnce(Return(true));
   EXPECT_CALL(proto_, readFieldBegin(Ref(buffer), _, _, _)).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::FieldBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -295,7 +296,7 @@ TEST_F(DecoderStateMachineTest, NoListValueData) {
       .WillOnce(DoAll(SetArgReferee<1>(FieldType::I32), SetArgReferee<2>(1), Return(true)));
   EXPECT_CALL(proto_, readInt32(Ref(buffer), _)).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::ListBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -310,7 +311,7 @@ TEST_F(DecoderStateMachineTest, EmptyList) {
       .WillOnce(DoAll(SetArgReferee<1>(FieldType::I32), SetArgReferee<2>(0), Return(true)));
   EXPECT_CALL(proto_, readListEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::ListBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -329,7 +330,7 @@ TEST_P(DecoderStateMachineValueTest, ListValue) {
 
   EXPECT_CALL(proto_, readListEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::ListBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -350,7 +351,7 @@ TEST_P(DecoderStateMachineValueTest, MultipleListValues) {
 
   EXPECT_CALL(proto_, readListEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::ListBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -366,7 +367,7 @@ TEST_F(DecoderStateMachineTest, NoMapKeyData) {
                       SetArgReferee<3>(1), Return(true)));
   EXPECT_CALL(proto_, readInt32(Ref(buffer), _)).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::MapBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -383,7 +384,7 @@ TEST_F(DecoderStateMachineTest, NoMapValueData) {
   EXPECT_CALL(proto_, readInt32(Ref(buffer), _)).WillOnce(Return(true));
   EXPECT_CALL(proto_, readString(Ref(buffer), _)).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::MapBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -399,7 +400,7 @@ TEST_F(DecoderStateMachineTest, EmptyMap) {
                       SetArgReferee<3>(0), Return(true)));
   EXPECT_CALL(proto_, readMapEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::MapBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -420,7 +421,7 @@ TEST_P(DecoderStateMachineValueTest, MapKeyValue) {
 
   EXPECT_CALL(proto_, readMapEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::MapBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -441,7 +442,7 @@ TEST_P(DecoderStateMachineValueTest, MapValueValue) {
 
   EXPECT_CALL(proto_, readMapEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::MapBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -464,7 +465,7 @@ TEST_P(DecoderStateMachineValueTest, MultipleMapKeyValues) {
 
   EXPECT_CALL(proto_, readMapEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::MapBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -479,7 +480,7 @@ TEST_F(DecoderStateMachineTest, NoSetValueData) {
       .WillOnce(DoAll(SetArgReferee<1>(FieldType::I32), SetArgReferee<2>(1), Return(true)));
   EXPECT_CALL(proto_, readInt32(Ref(buffer), _)).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::SetBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -494,7 +495,7 @@ TEST_F(DecoderStateMachineTest, EmptySet) {
       .WillOnce(DoAll(SetArgReferee<1>(FieldType::I32), SetArgReferee<2>(0), Return(true)));
   EXPECT_CALL(proto_, readSetEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::SetBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -513,7 +514,7 @@ TEST_P(DecoderStateMachineValueTest, SetValue) {
 
   EXPECT_CALL(proto_, readSetEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::SetBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -534,7 +535,7 @@ TEST_P(DecoderStateMachineValueTest, MultipleSetValues) {
 
   EXPECT_CALL(proto_, readSetEnd(Ref(buffer))).WillOnce(Return(false));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   dsm.setCurrentState(ProtocolState::SetBegin);
   EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
@@ -558,7 +559,7 @@ TEST_F(DecoderStateMachineTest, EmptyStruct) {
   EXPECT_CALL(proto_, readStructEnd(Ref(buffer))).WillOnce(Return(true));
   EXPECT_CALL(proto_, readMessageEnd(Ref(buffer))).WillOnce(Return(true));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   EXPECT_EQ(dsm.run(buffer), ProtocolState::Done);
   EXPECT_EQ(dsm.currentState(), ProtocolState::Done);
@@ -614,7 +615,7 @@ TEST_P(DecoderStateMachineValueTest, SingleFieldStruct) {
   EXPECT_CALL(proto_, readMessageEnd(Ref(buffer))).WillOnce(Return(true));
   EXPECT_CALL(handler_, messageEnd()).WillOnce(Return(FilterStatus::Continue));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   EXPECT_EQ(dsm.run(buffer), ProtocolState::Done);
   EXPECT_EQ(dsm.currentState(), ProtocolState::Done);
@@ -675,12 +676,76 @@ TEST_F(DecoderStateMachineTest, MultiFieldStruct) {
   EXPECT_CALL(proto_, readMessageEnd(Ref(buffer))).WillOnce(Return(true));
   EXPECT_CALL(handler_, messageEnd()).WillOnce(Return(FilterStatus::Continue));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   EXPECT_EQ(dsm.run(buffer), ProtocolState::Done);
   EXPECT_EQ(dsm.currentState(), ProtocolState::Done);
 }
 
+// The body following the message begin is passed through once it is fully available.
+TEST_F(DecoderStateMachineTest, PassthroughData) {
+  Buffer::OwnedImpl buffer("headerbody");
+  metadata_->setFrameSize(14);
+  InSequence dummy;
+
+  EXPECT_CALL(proto_, readMessageBegin(Ref(buffer), _))
+      .WillOnce(Invoke([&](Buffer::Instance& data, MessageMetadata&) -> bool {
+        data.drain(6);
+        return true;
+      }));
+  EXPECT_CALL(handler_, messageBegin(_)).WillOnce(Return(FilterStatus::Continue));
+  EXPECT_CALL(callbacks_, passthroughEnabled()).WillOnce(Return(true));
+
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
+  EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
+  EXPECT_EQ(dsm.currentState(), ProtocolState::PassthroughData);
+
+  buffer.add("trailing");
+  EXPECT_CALL(proto_, readStructBegin(_, _)).Times(0);
+  EXPECT_CALL(handler_, passthroughData(_))
+      .WillOnce(Invoke([&](Buffer::Instance& data) -> FilterStatus {
+        EXPECT_EQ("bodytrai", data.toString());
+        return FilterStatus::Continue;
+      }));
+  EXPECT_CALL(proto_, readMessageEnd(Ref(buffer))).WillOnce(Return(true));
+  EXPECT_CALL(handler_, messageEnd()).WillOnce(Return(FilterStatus::Continue));
+
+  EXPECT_EQ(dsm.run(buffer), ProtocolState::Done);
+  EXPECT_EQ("ling", buffer.toString());
+}
+
+// Messages without a frame size are decoded, even when the body may be passed through.
+TEST_F(DecoderStateMachineTest, PassthroughDataWithoutFrameSize) {
+  Buffer::OwnedImpl buffer;
+  InSequence dummy;
+
+  EXPECT_CALL(proto_, readMessageBegin(Ref(buffer), _)).WillOnce(Return(true));
+  EXPECT_CALL(handler_, messageBegin(_)).WillOnce(Return(FilterStatus::Continue));
+  EXPECT_CALL(callbacks_, passthroughEnabled()).Times(0);
+  EXPECT_CALL(proto_, readStructBegin(Ref(buffer), _)).WillOnce(Return(false));
+
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
+  EXPECT_EQ(dsm.run(buffer), ProtocolState::WaitForData);
+  EXPECT_EQ(dsm.currentState(), ProtocolState::StructBegin);
+}
+
+// A message begin larger than the frame is a protocol error.
+TEST_F(DecoderStateMachineTest, PassthroughDataInvalidFrameSize) {
+  Buffer::OwnedImpl buffer("header");
+  metadata_->setFrameSize(4);
+
+  EXPECT_CALL(proto_, readMessageBegin(Ref(buffer), _))
+      .WillOnce(Invoke([&](Buffer::Instance& data, MessageMetadata&) -> bool {
+        data.drain(6);
+        return true;
+      }));
+  EXPECT_CALL(callbacks_, passthroughEnabled()).WillOnce(Return(true));
+
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
+  EXPECT_THROW_WITH_MESSAGE(dsm.run(buffer), EnvoyException,
+                            "message begin of 6 bytes exceeds the frame size of 4");
+}
+
 TEST_P(DecoderStateMachineNestingTest, NestedTypes) {
   FieldType outer_field_type, inner_type, value_type;
   std::tie(outer_field_type, inner_type, value_type) = GetParam();
@@ -731,7 +796,7 @@ TEST_P(DecoderStateMachineNestingTest, NestedTypes) {
   EXPECT_CALL(proto_, readMessageEnd(Ref(buffer))).WillOnce(Return(true));
   EXPECT_CALL(handler_, messageEnd()).WillOnce(Return(FilterStatus::Continue));
 
-  DecoderStateMachine dsm(proto_, metadata_, handler_);
+  DecoderStateMachine dsm(proto_, metadata_, handler_, callbacks_);
 
   EXPECT_EQ(dsm.run(buffer), ProtocolState::Done);
   EXPECT_EQ(dsm.currentState(), ProtocolState::Done);
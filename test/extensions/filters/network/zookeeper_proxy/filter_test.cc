@@ -953,6 +953,66 @@ TEST_F(ZooKeeperFilterTest, WatchEvent) {
   EXPECT_EQ(0UL, config_->stats().decoder_error_.value());
 }
 
+TEST_F(ZooKeeperFilterTest, RequestSplitAcrossBuffers) {
+  initialize();
+
+  const std::string request =
+      encodeCreateRequest("/foo", "bar", CreateFlags::Persistent).toString() +
+      encodePing().toString();
+
+  // The request is only decoded once whole, as its flags follow its data.
+  Buffer::OwnedImpl data(request.substr(0, 2));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+  data = Buffer::OwnedImpl(request.substr(2, 20));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+  EXPECT_EQ(0UL, config_->stats().create_rq_.value());
+
+  data = Buffer::OwnedImpl(request.substr(22));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+  EXPECT_EQ(1UL, config_->stats().create_rq_.value());
+  EXPECT_EQ(1UL, config_->stats().ping_rq_.value());
+  EXPECT_EQ(47UL, config_->stats().request_bytes_.value());
+  EXPECT_EQ(0UL, config_->stats().decoder_error_.value());
+}
+
+TEST_F(ZooKeeperFilterTest, ResponsePayloadSplitAcrossBuffers) {
+  initialize();
+
+  Buffer::OwnedImpl data = encodePathWatch("/foo", false);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+  data = encodePing();
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+
+  // A getdata response carrying 1KiB of znode data, followed by a ping response.
+  const std::string payload(1024, 'x');
+  Buffer::OwnedImpl response;
+  response.writeBEInt<int32_t>(16 + payload.size());
+  response.writeBEInt<int32_t>(1000);
+  response.writeBEInt<int64_t>(2000);
+  response.writeBEInt<int32_t>(0);
+  response.add(payload);
+  response.add(encodeResponseHeader(enumToSignedInt(XidCodes::PingXid), 2000, 0));
+  const std::string responses = response.toString();
+
+  // The response is decoded as soon as its header is received, and its payload is skipped.
+  data = Buffer::OwnedImpl(responses.substr(0, 10));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(0UL, config_->stats().getdata_resp_.value());
+  data = Buffer::OwnedImpl(responses.substr(10, 100));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(1UL, config_->stats().getdata_resp_.value());
+  EXPECT_EQ(1044UL, config_->stats().response_bytes_.value());
+
+  data = Buffer::OwnedImpl(responses.substr(110, 940));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(0UL, config_->stats().ping_resp_.value());
+  data = Buffer::OwnedImpl(responses.substr(1050));
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(1UL, config_->stats().ping_resp_.value());
+  EXPECT_EQ(1064UL, config_->stats().response_bytes_.value());
+  EXPECT_EQ(0UL, config_->stats().decoder_error_.value());
+}
+
 } // namespace ZooKeeperProxy
 } // namespace NetworkFilters
 } // namespace Extensions
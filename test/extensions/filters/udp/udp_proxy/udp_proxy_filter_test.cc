@@ -50,16 +50,14 @@ public:
 
     void expectUpstreamWrite(const std::string& data, int sys_errno = 0) {
       EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
-      EXPECT_CALL(*io_handle_, sendmsg(_, 1, 0, nullptr, _))
-          .WillOnce(Invoke(
-              [this, data, sys_errno](
-                  const Buffer::RawSlice* slices, uint64_t, int, const Network::Address::Ip*,
-                  const Network::Address::Instance& peer_address) -> Api::IoCallUint64Result {
-                EXPECT_EQ(data, absl::string_view(static_cast<const char*>(slices[0].mem_),
-                                                  slices[0].len_));
-                EXPECT_EQ(peer_address, *upstream_address_);
-                return sys_errno == 0 ? makeNoError(data.size()) : makeError(sys_errno);
-              }));
+      // The IO handle is connected to the upstream host, so no peer address is given.
+      EXPECT_CALL(*io_handle_, writev(_, 1))
+          .WillOnce(Invoke([data, sys_errno](const Buffer::RawSlice* slices,
+                                             uint64_t) -> Api::IoCallUint64Result {
+            EXPECT_EQ(data,
+                      absl::string_view(static_cast<const char*>(slices[0].mem_), slices[0].len_));
+            return sys_errno == 0 ? makeNoError(data.size()) : makeError(sys_errno);
+          }));
     }
 
     void recvDataFromUpstream(const std::string& data, int recv_sys_errno = 0,
@@ -214,6 +212,46 @@ cluster: fake_cluster
   checkTransferStats(17 /*rx_bytes*/, 3 /*rx_datagrams*/, 17 /*tx_bytes*/, 3 /*tx_datagrams*/);
 }
 
+// The upstream datagrams are read in batches when the IO handle supports it.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamReads) {
+  InSequence s;
+
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+  )EOF");
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectUpstreamWrite("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  TestSession& session = test_sessions_[0];
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  EXPECT_CALL(*session.io_handle_, supportsMmsg()).WillOnce(Return(true));
+  // Two datagrams are returned, fewer than requested, so the socket isn't read again.
+  EXPECT_CALL(*session.io_handle_, recvmmsg(_, 16, _, _))
+      .WillOnce(Invoke([this](Buffer::RawSlice* slices, uint64_t, uint32_t,
+                              Network::IoHandle::RecvMmsgOutput& output) {
+        const std::string datagrams[] = {"world", "world2"};
+        for (size_t i = 0; i < 2; i++) {
+          memcpy(slices[i].mem_, datagrams[i].data(), datagrams[i].size());
+          output.msg_[i].peer_address_ = upstream_address_;
+          output.msg_[i].msg_len_ = datagrams[i].size();
+        }
+        return makeNoError(2);
+      }));
+  EXPECT_CALL(callbacks_.udp_listener_, send(_))
+      .Times(2)
+      .WillRepeatedly(
+          Invoke([](const Network::UdpSendData& send_data) -> Api::IoCallUint64Result {
+            const uint64_t length = send_data.buffer_.length();
+            send_data.buffer_.drain(length);
+            return makeNoError(length);
+          }));
+  session.file_event_cb_(Event::FileReadyType::Read);
+  checkTransferStats(5 /*rx_bytes*/, 1 /*rx_datagrams*/, 11 /*tx_bytes*/, 2 /*tx_datagrams*/);
+}
+
 // Idle timeout flow.
 TEST_F(UdpProxyFilterTest, IdleTimeout) {
   InSequence s;
@@ -0,0 +1,185 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+
+using testing::Invoke;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD0(onPrivateKeyMethodComplete, void());
+};
+
+class ThreadPoolPrivateKeyMethodProviderTest : public testing::Test {
+public:
+  ThreadPoolPrivateKeyMethodProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
+        ssl_ctx_(SSL_CTX_new(TLS_method())), ssl_(SSL_new(ssl_ctx_.get())) {}
+
+  ~ThreadPoolPrivateKeyMethodProviderTest() override {
+    if (provider_ != nullptr) {
+      provider_->unregisterPrivateKeyMethod(ssl_.get());
+    }
+  }
+
+  void initialize(const std::string& key_file) {
+    const std::string yaml = TestEnvironment::substitute(
+        "private_key: { filename: \"{{ test_rundir }}/test/extensions/transport_sockets/tls/"
+        "test_data/" +
+        key_file + "\" }\nthread_count: 2");
+    envoy::config::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig
+        config;
+    TestUtility::loadFromYaml(yaml, config);
+    provider_ = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, *api_);
+    provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+    method_ = provider_->getBoringSslPrivateKeyMethod();
+  }
+
+  // Wait for the crypto thread to hand back the result and complete the operation.
+  ssl_private_key_result_t complete(std::vector<uint8_t>& out) {
+    EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+      dispatcher_->exit();
+    }));
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    out.resize(1024);
+    size_t out_len;
+    const ssl_private_key_result_t result =
+        method_->complete(ssl_.get(), out.data(), &out_len, out.size());
+    if (result == ssl_private_key_success) {
+      out.resize(out_len);
+    }
+    return result;
+  }
+
+  void signAndVerify(uint16_t signature_algorithm) {
+    const std::vector<uint8_t> in(100, 'a');
+    uint8_t unused[1];
+    size_t unused_len;
+    EXPECT_EQ(ssl_private_key_retry, method_->sign(ssl_.get(), unused, &unused_len, 0,
+                                                   signature_algorithm, in.data(), in.size()));
+    std::vector<uint8_t> signature;
+    ASSERT_EQ(ssl_private_key_success, complete(signature));
+
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pctx;
+    ASSERT_EQ(1, EVP_DigestVerifyInit(ctx.get(), &pctx,
+                                      SSL_get_signature_algorithm_digest(signature_algorithm),
+                                      nullptr, provider_->privateKey()));
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm)) {
+      ASSERT_EQ(1, EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING));
+      ASSERT_EQ(1, EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1));
+    }
+    EXPECT_EQ(1, EVP_DigestVerify(ctx.get(), signature.data(), signature.size(), in.data(),
+                                  in.size()));
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  bssl::UniquePtr<SSL> ssl_;
+  MockPrivateKeyConnectionCallbacks callbacks_;
+  std::unique_ptr<ThreadPoolPrivateKeyMethodProvider> provider_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+};
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, RsaSign) {
+  initialize("selfsigned_key.pem");
+  signAndVerify(SSL_SIGN_RSA_PKCS1_SHA256);
+  signAndVerify(SSL_SIGN_RSA_PSS_RSAE_SHA256);
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, EcdsaSign) {
+  initialize("selfsigned_ecdsa_p256_key.pem");
+  signAndVerify(SSL_SIGN_ECDSA_SECP256R1_SHA256);
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, RsaDecrypt) {
+  initialize("selfsigned_key.pem");
+  RSA* rsa = EVP_PKEY_get0_RSA(provider_->privateKey());
+  std::vector<uint8_t> plaintext(RSA_size(rsa), 'a');
+  std::vector<uint8_t> ciphertext(RSA_size(rsa));
+  size_t ciphertext_len;
+  ASSERT_EQ(1, RSA_encrypt(rsa, &ciphertext_len, ciphertext.data(), ciphertext.size(),
+                           plaintext.data(), plaintext.size(), RSA_NO_PADDING));
+
+  uint8_t unused[1];
+  size_t unused_len;
+  EXPECT_EQ(ssl_private_key_retry, method_->decrypt(ssl_.get(), unused, &unused_len, 0,
+                                                    ciphertext.data(), ciphertext_len));
+  std::vector<uint8_t> out;
+  ASSERT_EQ(ssl_private_key_success, complete(out));
+  EXPECT_EQ(plaintext, out);
+}
+
+// A signature algorithm which does not match the key type fails right away.
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, SignatureAlgorithmMismatch) {
+  initialize("selfsigned_key.pem");
+  const std::vector<uint8_t> in(100, 'a');
+  uint8_t unused[1];
+  size_t unused_len;
+  EXPECT_EQ(ssl_private_key_failure,
+            method_->sign(ssl_.get(), unused, &unused_len, 0, SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                          in.data(), in.size()));
+}
+
+// The result of an operation is not handed back once the connection is gone.
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, UnregisterCancelsOperation) {
+  initialize("selfsigned_key.pem");
+  const std::vector<uint8_t> in(100, 'a');
+  uint8_t unused[1];
+  size_t unused_len;
+  EXPECT_EQ(ssl_private_key_retry, method_->sign(ssl_.get(), unused, &unused_len, 0,
+                                                 SSL_SIGN_RSA_PKCS1_SHA256, in.data(), in.size()));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  // Destroying the provider waits for the crypto threads, so that any result has been posted.
+  provider_.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, DuplicateRegistration) {
+  initialize("selfsigned_key.pem");
+  EXPECT_THROW_WITH_MESSAGE(
+      provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_), EnvoyException,
+      "Only one certificate of a TLS context can use the thread pool private key provider.");
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, InvalidPrivateKey) {
+  envoy::config::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig
+      config;
+  config.mutable_private_key()->set_inline_string("not a key");
+  EXPECT_THROW_WITH_MESSAGE(
+      std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, *api_), EnvoyException,
+      "Failed to load the private key of the thread pool private key provider.");
+}
+
+TEST(ThreadPoolPrivateKeyMethodFactoryTest, Registered) {
+  EXPECT_NE(nullptr, Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::
+                         getFactory("envoy.tls.key_providers.thread_pool"));
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
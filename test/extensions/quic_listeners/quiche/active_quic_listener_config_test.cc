@@ -43,5 +43,19 @@ TEST(ActiveQuicListenerConfigTest, CreateActiveQuicListenerFactory) {
   EXPECT_EQ(20000u, quic_config.max_time_before_crypto_handshake().ToMilliseconds());
 }
 
+TEST(ActiveQuicListenerConfigTest, ReusePortSteeringOptions) {
+  envoy::config::listener::v3alpha::QuicProtocolOptions config;
+  ActiveQuicListenerFactory listener_factory(config);
+  // A single worker needs no steering.
+  EXPECT_EQ(nullptr, listener_factory.reusePortSteeringOptions(1));
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+  Network::Socket::OptionsSharedPtr options = listener_factory.reusePortSteeringOptions(4);
+  ASSERT_NE(nullptr, options);
+  EXPECT_EQ(1, options->size());
+#else
+  EXPECT_EQ(nullptr, listener_factory.reusePortSteeringOptions(4));
+#endif
+}
+
 } // namespace Quic
 } // namespace Envoy
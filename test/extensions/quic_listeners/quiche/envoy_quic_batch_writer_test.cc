@@ -0,0 +1,271 @@
+#include <netinet/udp.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+#include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/quic_listeners/quiche/envoy_quic_batch_packet_writer.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Return;
+
+namespace Envoy {
+namespace Quic {
+
+class EnvoyQuicBatchWriterTest : public ::testing::Test {
+public:
+  EnvoyQuicBatchWriterTest() {
+    self_address_.FromString("::");
+    quic::QuicIpAddress peer_ip;
+    peer_ip.FromString("::1");
+    peer_address_ = quic::QuicSocketAddress(peer_ip, /*port=*/123);
+    other_peer_address_ = quic::QuicSocketAddress(peer_ip, /*port=*/456);
+    ON_CALL(os_sys_calls_, socket(_, _, _)).WillByDefault(Return(Api::SysCallIntResult{3, 0}));
+    ON_CALL(os_sys_calls_, close(3)).WillByDefault(Return(Api::SysCallIntResult{0, 0}));
+    ON_CALL(os_sys_calls_, supportsMmsg()).WillByDefault(Return(true));
+  }
+
+  void initialize() {
+    writer_ = std::make_unique<EnvoyQuicBatchPacketWriter>(socket_, store_);
+    EXPECT_TRUE(writer_->IsBatchMode());
+  }
+
+  void write(const std::string& packet, const quic::QuicSocketAddress& peer_address) {
+    const quic::WriteResult result =
+        writer_->WritePacket(packet.data(), packet.length(), self_address_, peer_address, nullptr);
+    EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+    EXPECT_EQ(0, result.bytes_written);
+  }
+
+  // Verifies a message sent to the given peer, and returns its segment size if it's segmented.
+  uint16_t verifyMessage(const msghdr& message, const std::string& content,
+                         const quic::QuicSocketAddress& peer_address) {
+    EXPECT_EQ(peer_address.ToString(), Network::Address::addressFromSockAddr(
+                                           *reinterpret_cast<sockaddr_storage*>(message.msg_name),
+                                           message.msg_namelen, /*v6only=*/false)
+                                           ->asString());
+    EXPECT_EQ(1, message.msg_iovlen);
+    EXPECT_EQ(content, std::string(reinterpret_cast<char*>(message.msg_iov[0].iov_base),
+                                   message.msg_iov[0].iov_len));
+    uint16_t segment_size = 0;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&message), cmsg)) {
+      if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+        auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+        EXPECT_EQ(0, memcmp(self_address_.GetIPv6().s6_addr, pktinfo->ipi6_addr.s6_addr,
+                            sizeof(pktinfo->ipi6_addr.s6_addr)));
+      }
+#ifdef UDP_SEGMENT
+      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+        memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+      }
+#endif
+    }
+    return segment_size;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("quic_writer." + name).value();
+  }
+
+protected:
+  testing::NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  testing::NiceMock<Network::MockListenSocket> socket_;
+  Stats::IsolatedStoreImpl store_;
+  quic::QuicIpAddress self_address_;
+  quic::QuicSocketAddress peer_address_;
+  quic::QuicSocketAddress other_peer_address_;
+  std::unique_ptr<EnvoyQuicBatchPacketWriter> writer_;
+};
+
+#ifdef UDP_SEGMENT
+// Packets of the same size to the same peer are sent as the segments of a single message.
+TEST_F(EnvoyQuicBatchWriterTest, SegmentsPacketsToTheSamePeer) {
+  initialize();
+  const std::string packet(100, 'a');
+  const std::string last_packet(50, 'b');
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  write(packet, peer_address_);
+  write(packet, peer_address_);
+  write(last_packet, peer_address_);
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, _))
+      .WillOnce(testing::Invoke([&](int, struct mmsghdr* messages, unsigned int, int) {
+        EXPECT_EQ(100, verifyMessage(messages[0].msg_hdr, packet + packet + last_packet,
+                                     peer_address_));
+        return Api::SysCallIntResult{1, 0};
+      }));
+  const quic::WriteResult result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(250, result.bytes_written);
+  EXPECT_EQ(1, counter("send_calls"));
+  EXPECT_EQ(3, counter("packets_sent"));
+
+  // Nothing is left to send.
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+}
+
+// A segmented message failing with EIO disables segmentation, and its packets are sent again one
+// per message.
+TEST_F(EnvoyQuicBatchWriterTest, DisablesSegmentationOnEio) {
+  initialize();
+  const std::string packet(100, 'a');
+  write(packet, peer_address_);
+  write(packet, peer_address_);
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, _))
+        .WillOnce(Return(Api::SysCallIntResult{-1, EIO}));
+    EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, _))
+        .WillOnce(testing::Invoke([&](int, struct mmsghdr* messages, unsigned int, int) {
+          EXPECT_EQ(0, verifyMessage(messages[0].msg_hdr, packet, peer_address_));
+          EXPECT_EQ(0, verifyMessage(messages[1].msg_hdr, packet, peer_address_));
+          return Api::SysCallIntResult{2, 0};
+        }));
+  }
+  const quic::WriteResult result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(200, result.bytes_written);
+  EXPECT_EQ(1, counter("gso_disabled"));
+
+  // The later packets aren't segmented either.
+  write(packet, peer_address_);
+  write(packet, peer_address_);
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, _)).WillOnce(Return(Api::SysCallIntResult{2, 0}));
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+}
+#endif
+
+// Packets to different peers are sent as different messages of a single sendmmsg() call.
+TEST_F(EnvoyQuicBatchWriterTest, SendsMessagesToDifferentPeersTogether) {
+  initialize();
+  const std::string packet(100, 'a');
+  const std::string other_packet(100, 'b');
+  write(packet, peer_address_);
+  write(other_packet, other_peer_address_);
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, _))
+      .WillOnce(testing::Invoke([&](int, struct mmsghdr* messages, unsigned int, int) {
+        EXPECT_EQ(0, verifyMessage(messages[0].msg_hdr, packet, peer_address_));
+        EXPECT_EQ(0, verifyMessage(messages[1].msg_hdr, other_packet, other_peer_address_));
+        return Api::SysCallIntResult{2, 0};
+      }));
+  const quic::WriteResult result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(200, result.bytes_written);
+  EXPECT_EQ(1, counter("send_calls"));
+  EXPECT_EQ(2, counter("packets_sent"));
+}
+
+// The packets not sent when the socket gets blocked are sent once it is writable again.
+TEST_F(EnvoyQuicBatchWriterTest, KeepsPacketsWhenBlocked) {
+  initialize();
+  const std::string packet(100, 'a');
+  const std::string other_packet(80, 'b');
+  write(packet, peer_address_);
+  write(other_packet, other_peer_address_);
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{1, 0}))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EAGAIN}));
+  quic::WriteResult result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED, result.status);
+  EXPECT_EQ(static_cast<int>(Api::IoError::IoErrorCode::Again), result.error_code);
+  EXPECT_TRUE(writer_->IsWriteBlocked());
+
+  // Nothing is sent while blocked.
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED, writer_->Flush().status);
+
+  writer_->SetWritable();
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, _))
+      .WillOnce(testing::Invoke([&](int, struct mmsghdr* messages, unsigned int, int) {
+        verifyMessage(messages[0].msg_hdr, other_packet, other_peer_address_);
+        return Api::SysCallIntResult{1, 0};
+      }));
+  result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(80, result.bytes_written);
+  EXPECT_EQ(2, counter("send_calls"));
+  EXPECT_EQ(2, counter("packets_sent"));
+}
+
+// A full batch is sent before buffering the next packet.
+TEST_F(EnvoyQuicBatchWriterTest, SendsFullBatch) {
+  initialize();
+  const unsigned int max_packets = EnvoyQuicBatchPacketWriter::kMaxBatchPackets;
+  const std::string packet(100, 'a');
+  for (size_t i = 0; i < max_packets; i++) {
+    write(packet, i % 2 == 0 ? peer_address_ : other_peer_address_);
+  }
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, max_packets, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EAGAIN}));
+  quic::WriteResult result =
+      writer_->WritePacket(packet.data(), packet.length(), self_address_, peer_address_, nullptr);
+  // The packet isn't buffered.
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, result.status);
+  EXPECT_TRUE(writer_->IsWriteBlocked());
+
+  writer_->SetWritable();
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, max_packets, _))
+      .WillOnce(Return(Api::SysCallIntResult{static_cast<int>(max_packets), 0}));
+  write(packet, peer_address_);
+  EXPECT_EQ(1, counter("send_calls"));
+  EXPECT_EQ(max_packets, counter("packets_sent"));
+}
+
+// The buffered packets are dropped on a send error.
+TEST_F(EnvoyQuicBatchWriterTest, SendFailure) {
+  initialize();
+  write(std::string(100, 'a'), peer_address_);
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EMSGSIZE}));
+  const quic::WriteResult result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_ERROR, result.status);
+  EXPECT_EQ(static_cast<int>(Api::IoError::IoErrorCode::MessageTooBig), result.error_code);
+  EXPECT_FALSE(writer_->IsWriteBlocked());
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+}
+
+// Without sendmmsg(), each message is sent by its own sendmsg() call.
+TEST_F(EnvoyQuicBatchWriterTest, SendsMessagesWithoutMmsg) {
+  EXPECT_CALL(os_sys_calls_, supportsMmsg()).WillRepeatedly(Return(false));
+  EXPECT_CALL(os_sys_calls_, getsockopt_(_, _, _, _, _)).WillRepeatedly(Return(-1));
+  EXPECT_FALSE(EnvoyQuicBatchPacketWriter::isSupported(socket_));
+  initialize();
+  const std::string packet(100, 'a');
+  write(packet, peer_address_);
+  write(packet, peer_address_);
+
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _))
+      .Times(2)
+      .WillRepeatedly(testing::Invoke([&](int, const msghdr* message, int) {
+        // Without UDP_SEGMENT, the packets aren't segmented.
+        EXPECT_EQ(0, verifyMessage(*message, packet, peer_address_));
+        return Api::SysCallSizeResult{100, 0};
+      }));
+  const quic::WriteResult result = writer_->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(200, result.bytes_written);
+  EXPECT_EQ(2, counter("send_calls"));
+  EXPECT_EQ(2, counter("packets_sent"));
+}
+
+} // namespace Quic
+} // namespace Envoy
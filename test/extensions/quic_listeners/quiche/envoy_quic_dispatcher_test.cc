@@ -148,6 +148,25 @@ INSTANTIATE_TEST_SUITE_P(IpVersions, EnvoyQuicDispatcherTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
                          TestUtility::ipTestParamsToString);
 
+TEST_P(EnvoyQuicDispatcherTest, NewServerConnectionIdKeepsSteeringPrefix) {
+  const quic::QuicConnectionId client_connection_id =
+      quic::test::TestConnectionId(0x0102030405060708);
+  const quic::QuicConnectionId server_connection_id =
+      envoy_quic_dispatcher_.GenerateNewServerConnectionId(quic::CurrentSupportedVersions()[0],
+                                                           client_connection_id);
+  EXPECT_EQ(quic::kQuicDefaultConnectionIdLength, server_connection_id.length());
+  EXPECT_EQ(0, memcmp(client_connection_id.data(), server_connection_id.data(), 4));
+
+  // A connection ID shorter than the prefix is kept whole.
+  const quic::QuicConnectionId short_connection_id("\x01\x02", 2);
+  EXPECT_EQ(0, memcmp(short_connection_id.data(),
+                      envoy_quic_dispatcher_
+                          .GenerateNewServerConnectionId(quic::CurrentSupportedVersions()[0],
+                                                         short_connection_id)
+                          .data(),
+                      2));
+}
+
 TEST_P(EnvoyQuicDispatcherTest, CreateNewConnectionUponCHLO) {
   quic::QuicSocketAddress peer_addr(version_ == Network::Address::IpVersion::v4
                                         ? quic::QuicIpAddress::Loopback4()
@@ -176,7 +195,7 @@ TEST_P(EnvoyQuicDispatcherTest, CreateNewConnectionUponCHLO) {
         filter_manager.addReadFilter(read_filter);
         read_filter->callbacks_->connection().addConnectionCallbacks(network_connection_callbacks);
         read_filter->callbacks_->connection().setConnectionStats(
-            {read_total, read_current, write_total, write_current, nullptr, nullptr});
+            {read_total, read_current, write_total, write_current, nullptr, nullptr, nullptr});
       }});
   EXPECT_CALL(filter_chain, networkFilterFactories()).WillOnce(ReturnRef(filter_factory));
   EXPECT_CALL(listener_config_, filterChainFactory());
@@ -252,7 +271,7 @@ TEST_P(EnvoyQuicDispatcherTest, CreateNewConnectionUponBufferedCHLO) {
         filter_manager.addReadFilter(read_filter);
         read_filter->callbacks_->connection().addConnectionCallbacks(network_connection_callbacks);
         read_filter->callbacks_->connection().setConnectionStats(
-            {read_total, read_current, write_total, write_current, nullptr, nullptr});
+            {read_total, read_current, write_total, write_current, nullptr, nullptr, nullptr});
       }});
   EXPECT_CALL(filter_chain, networkFilterFactories()).WillOnce(ReturnRef(filter_factory));
   EXPECT_CALL(listener_config_, filterChainFactory());
@@ -177,6 +177,15 @@ TEST_P(EnvoyQuicServerStreamTest, PostRequestAndResponse) {
   quic_stream_->encodeHeaders(response_headers_, /*end_stream=*/true);
 }
 
+// Tests that a body spanning several blocks of the stream sequencer is decoded at once.
+TEST_P(EnvoyQuicServerStreamTest, PostRequestSpanningSequencerBlocks) {
+  const std::string large_request(10 * 1024, 'a');
+  const size_t payload_length = sendRequest(large_request, true, large_request.size() * 2);
+  EXPECT_FALSE(quic_stream_->HasBytesToRead());
+  EXPECT_EQ(payload_length, quic_stream_->flow_controller()->bytes_consumed());
+  quic_stream_->encodeHeaders(response_headers_, /*end_stream=*/true);
+}
+
 TEST_P(EnvoyQuicServerStreamTest, DecodeHeadersBodyAndTrailers) {
   sendRequest(request_body_, false, request_body_.size() * 2);
   EXPECT_CALL(stream_decoder_, decodeTrailers_(_))
@@ -7,6 +7,7 @@
 #include "extensions/resource_monitors/fixed_heap/config.h"
 
 #include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 
 #include "gtest/gtest.h"
 
@@ -26,8 +27,9 @@ TEST(FixedHeapMonitorFactoryTest, CreateMonitor) {
   config.set_max_heap_size_bytes(std::numeric_limits<uint64_t>::max());
   Event::MockDispatcher dispatcher;
   Api::ApiPtr api = Api::createApiForTest();
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      dispatcher, *api, ProtobufMessage::getStrictValidationVisitor());
+      dispatcher, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   auto monitor = factory->createResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
@@ -0,0 +1,98 @@
+// Allocation throughput of a worker while the fixed heap monitor samples the heap stats on another
+// thread, as the overload manager does on the main thread. Reading the heap stats takes the
+// allocator's page heap lock, which the worker contends for whenever its thread cache needs pages.
+//
+// Usage: bazel run //test/extensions/resource_monitors/fixed_heap:fixed_heap_monitor_benchmark
+// with -c opt.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "envoy/config/resource_monitor/fixed_heap/v2alpha/fixed_heap.pb.h"
+
+#include "common/common/thread.h"
+
+#include "extensions/resource_monitors/fixed_heap/fixed_heap_monitor.h"
+
+#include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace FixedHeapMonitor {
+namespace {
+
+class NullCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage&) override {}
+  void onFailure(const EnvoyException&) override {}
+};
+
+// Allocates and frees batches of blocks of sizes spread over the size classes, large enough for
+// the thread cache to go back to the page heap regularly.
+void allocateBatch(std::vector<std::unique_ptr<char[]>>& blocks) {
+  for (size_t i = 0; i < blocks.size(); i++) {
+    blocks[i].reset(new char[64 + (i * 997) % (64 * 1024)]);
+    benchmark::DoNotOptimize(blocks[i].get());
+  }
+  for (auto& block : blocks) {
+    block.reset();
+  }
+}
+
+// Args: the stats refresh interval of the monitor in milliseconds, 0 to read the stats on every
+// update, or -1 for no monitor. The monitor is updated every millisecond, to stand for many
+// monitors or a short overload manager refresh interval.
+void BM_AllocateWhileMonitoring(benchmark::State& state) {
+  envoy::config::resource_monitor::fixed_heap::v2alpha::FixedHeapConfig config;
+  config.set_max_heap_size_bytes(1024 * 1024 * 1024);
+  if (state.range(0) > 0) {
+    config.mutable_stats_refresh_interval()->set_nanos(state.range(0) * 1000 * 1000);
+  }
+  Event::TestRealTimeSystem time_system;
+  FixedHeapMonitor monitor(config, time_system);
+
+  std::atomic<bool> done{false};
+  Thread::ThreadPtr monitor_thread;
+  if (state.range(0) >= 0) {
+    monitor_thread = Thread::threadFactoryForTest().createThread([&monitor, &time_system, &done]() {
+      NullCallbacks callbacks;
+      while (!done) {
+        monitor.updateResourceUsage(callbacks);
+        time_system.sleep(std::chrono::milliseconds(1));
+      }
+    });
+  }
+
+  std::vector<std::unique_ptr<char[]>> blocks(1000);
+  for (auto _ : state) {
+    allocateBatch(blocks);
+  }
+  state.SetItemsProcessed(state.iterations() * blocks.size());
+
+  done = true;
+  if (monitor_thread != nullptr) {
+    monitor_thread->join();
+  }
+}
+BENCHMARK(BM_AllocateWhileMonitoring)->Arg(-1)->Arg(0)->Arg(100)->Arg(500)->UseRealTime();
+
+} // namespace
+} // namespace FixedHeapMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
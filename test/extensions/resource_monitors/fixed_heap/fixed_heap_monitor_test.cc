@@ -2,6 +2,8 @@
 
 #include "extensions/resource_monitors/fixed_heap/fixed_heap_monitor.h"
 
+#include "test/test_common/simulated_time_system.h"
+
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -44,7 +46,9 @@ TEST(FixedHeapMonitorTest, ComputesCorrectUsage) {
   auto stats_reader = std::make_unique<MockMemoryStatsReader>();
   EXPECT_CALL(*stats_reader, reservedHeapBytes()).WillOnce(testing::Return(800));
   EXPECT_CALL(*stats_reader, unmappedHeapBytes()).WillOnce(testing::Return(100));
-  std::unique_ptr<FixedHeapMonitor> monitor(new FixedHeapMonitor(config, std::move(stats_reader)));
+  Event::SimulatedTimeSystem time_system;
+  std::unique_ptr<FixedHeapMonitor> monitor(
+      new FixedHeapMonitor(config, time_system, std::move(stats_reader)));
 
   ResourcePressure resource;
   monitor->updateResourceUsage(resource);
@@ -53,6 +57,34 @@ TEST(FixedHeapMonitorTest, ComputesCorrectUsage) {
   EXPECT_EQ(resource.pressure(), 0.7);
 }
 
+// With a stats refresh interval, the heap stats are read once per interval.
+TEST(FixedHeapMonitorTest, RefreshesStatsOncePerInterval) {
+  envoy::config::resource_monitor::fixed_heap::v2alpha::FixedHeapConfig config;
+  config.set_max_heap_size_bytes(1000);
+  config.mutable_stats_refresh_interval()->set_seconds(1);
+  auto stats_reader = std::make_unique<MockMemoryStatsReader>();
+  MockMemoryStatsReader& stats = *stats_reader;
+  Event::SimulatedTimeSystem time_system;
+  FixedHeapMonitor monitor(config, time_system, std::move(stats_reader));
+
+  EXPECT_CALL(stats, reservedHeapBytes()).WillOnce(testing::Return(800));
+  EXPECT_CALL(stats, unmappedHeapBytes()).WillOnce(testing::Return(100));
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_EQ(resource.pressure(), 0.7);
+
+  // The last reading is reported within the interval.
+  time_system.sleep(std::chrono::milliseconds(500));
+  monitor.updateResourceUsage(resource);
+  EXPECT_EQ(resource.pressure(), 0.7);
+
+  time_system.sleep(std::chrono::milliseconds(500));
+  EXPECT_CALL(stats, reservedHeapBytes()).WillOnce(testing::Return(600));
+  EXPECT_CALL(stats, unmappedHeapBytes()).WillOnce(testing::Return(100));
+  monitor.updateResourceUsage(resource);
+  EXPECT_EQ(resource.pressure(), 0.5);
+}
+
 } // namespace
 } // namespace FixedHeapMonitor
 } // namespace ResourceMonitors
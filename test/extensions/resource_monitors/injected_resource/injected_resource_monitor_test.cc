@@ -7,6 +7,7 @@
 
 #include "extensions/resource_monitors/injected_resource/injected_resource_monitor.h"
 
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
@@ -64,7 +65,7 @@ protected:
     envoy::config::resource_monitor::injected_resource::v2alpha::InjectedResourceConfig config;
     config.set_filename(resource_filename_);
     Server::Configuration::ResourceMonitorFactoryContextImpl context(
-        *dispatcher_, *api_, ProtobufMessage::getStrictValidationVisitor());
+        *dispatcher_, *api_, tls_, ProtobufMessage::getStrictValidationVisitor());
     return std::make_unique<TestableInjectedResourceMonitor>(config, context);
   }
 
@@ -73,6 +74,7 @@ protected:
   const std::string resource_filename_;
   AtomicFileUpdater file_updater_;
   MockedCallbacks cb_;
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
   std::unique_ptr<InjectedResourceMonitor> monitor_;
 };
 
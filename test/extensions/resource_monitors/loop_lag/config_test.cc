@@ -0,0 +1,41 @@
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.h"
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/loop_lag/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace LoopLagMonitor {
+namespace {
+
+TEST(LoopLagMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.loop_lag");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig config;
+  config.mutable_max_lag()->set_seconds(1);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, *api, tls, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace LoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
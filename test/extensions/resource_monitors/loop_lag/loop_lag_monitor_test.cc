@@ -0,0 +1,93 @@
+#include <chrono>
+
+#include "envoy/config/resource_monitor/loop_lag/v2alpha/loop_lag.pb.h"
+
+#include "extensions/resource_monitors/loop_lag/loop_lag_monitor.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace LoopLagMonitor {
+namespace {
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class LoopLagMonitorTest : public testing::Test {
+public:
+  LoopLagMonitorTest() {
+    config_.mutable_max_lag()->set_seconds(1);
+    // Each thread runs the probe 100ms after the previous one, the main thread completing last.
+    ON_CALL(tls_, runOnAllThreads(_, _))
+        .WillByDefault(Invoke([this](Event::PostCb cb, Event::PostCb main_callback) {
+          for (uint32_t i = 0; i < 3; i++) {
+            time_system_.sleep(std::chrono::milliseconds(100));
+            cb();
+          }
+          completions_.push_back(main_callback);
+        }));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  envoy::config::resource_monitor::loop_lag::v2alpha::LoopLagConfig config_;
+  std::vector<Event::PostCb> completions_;
+};
+
+// The pressure is the longest lag of the threads relative to the configured maximum.
+TEST_F(LoopLagMonitorTest, ComputesCorrectUsage) {
+  LoopLagMonitor monitor(config_, time_system_, tls_);
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_FALSE(resource.hasPressure());
+  ASSERT_EQ(1, completions_.size());
+  completions_[0]();
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_FALSE(resource.hasError());
+  EXPECT_DOUBLE_EQ(0.3, resource.pressure());
+}
+
+// A probe completing after the monitor is destroyed does not report.
+TEST_F(LoopLagMonitorTest, CompletesAfterDestruction) {
+  ResourcePressure resource;
+  {
+    LoopLagMonitor monitor(config_, time_system_, tls_);
+    monitor.updateResourceUsage(resource);
+  }
+  ASSERT_EQ(1, completions_.size());
+  completions_[0]();
+  EXPECT_FALSE(resource.hasPressure());
+}
+
+} // namespace
+} // namespace LoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -5,17 +5,22 @@
 
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::_;
+using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -27,6 +32,7 @@ namespace {
 class MockWriter : public Writer {
 public:
   MOCK_METHOD1(write, void(const std::string& message));
+  MOCK_METHOD1(writeBatch, void(const std::vector<std::string>& messages));
 };
 
 class UdpStatsdSinkTest : public testing::TestWithParam<Network::Address::IpVersion> {};
@@ -73,6 +79,26 @@ TEST_P(UdpStatsdSinkTest, InitWithIpAddress) {
   tls_.shutdownThread();
 }
 
+// Each message of a batch is received as its own datagram.
+TEST_P(UdpStatsdSinkTest, WriteBatch) {
+  auto server =
+      Network::Test::bindFreeLoopbackPort(GetParam(), Network::Address::SocketType::Datagram);
+  Writer writer(server.first);
+
+  std::vector<std::string> messages;
+  for (int i = 0; i < 100; i++) {
+    messages.push_back(fmt::format("envoy.counter_{}:1|c", i));
+  }
+  writer.writeBatch(messages);
+
+  char buffer[64];
+  for (const std::string& message : messages) {
+    const ssize_t rc = ::recv(server.second->fd(), buffer, sizeof(buffer), 0);
+    ASSERT_EQ(static_cast<ssize_t>(message.size()), rc);
+    EXPECT_EQ(message, std::string(buffer, rc));
+  }
+}
+
 class UdpStatsdSinkWithTagsTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, UdpStatsdSinkWithTagsTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -158,6 +184,42 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+// Metrics are packed into datagrams of up to the maximum size, and counters that did not change
+// are not sent.
+TEST(UdpStatsdSinkTest, PackDatagrams) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false, "", 40);
+
+  std::vector<std::shared_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (const char* name : {"a", "b", "unchanged", "c"}) {
+    auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+    counter->name_ = name;
+    counter->used_ = true;
+    counters.push_back(counter);
+  }
+  snapshot.counters_.push_back({1, *counters[0]});
+  snapshot.counters_.push_back({2, *counters[1]});
+  snapshot.counters_.push_back({0, *counters[2]});
+  snapshot.counters_.push_back({3, *counters[3]});
+
+  // Too large to share a datagram with the counters.
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "gauge_with_a_rather_long_name";
+  gauge->value_ = 1;
+  gauge->used_ = true;
+  snapshot.gauges_.push_back(*gauge);
+
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  EXPECT_CALL(*writer_ptr,
+              writeBatch(std::vector<std::string>{"envoy.a:1|c\nenvoy.b:2|c\nenvoy.c:3|c",
+                                                  "envoy.gauge_with_a_rather_long_name:1|g"}));
+  sink.flush(snapshot);
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, CheckActualStatsWithCustomPrefix) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -306,6 +368,36 @@ TEST(UdpStatsdSinkWithTagsTest, SiSuffix) {
   tls_.shutdownThread();
 }
 
+// A batch is sent again from the first message sendmmsg() did not send. A message which fails is
+// dropped, and so is the rest of the batch once the socket would block.
+TEST(WriterTest, WriteBatchResendsUnsentMessages) {
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  ON_CALL(os_sys_calls, supportsMmsg()).WillByDefault(Return(true));
+
+  // Each attempt is recorded as its first message followed by the number of messages.
+  std::vector<std::string> attempts;
+  const auto send = [&attempts](int rc, int error) {
+    return [&attempts, rc, error](int, struct mmsghdr* msgvec, unsigned int vlen,
+                                  int) -> Api::SysCallIntResult {
+      const struct iovec* iov = msgvec[0].msg_hdr.msg_iov;
+      attempts.push_back(
+          absl::StrCat(absl::string_view(static_cast<const char*>(iov->iov_base), iov->iov_len),
+                       vlen));
+      return {rc, error};
+    };
+  };
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, MSG_DONTWAIT))
+      .WillOnce(Invoke(send(2, 0)))
+      .WillOnce(Invoke(send(-1, EMSGSIZE)))
+      .WillOnce(Invoke(send(1, 0)))
+      .WillOnce(Invoke(send(-1, EAGAIN)));
+
+  Writer writer;
+  writer.writeBatch({"a", "b", "c", "d", "e", "f"});
+  EXPECT_EQ((std::vector<std::string>{"a6", "c4", "d3", "e2"}), attempts);
+}
+
 } // namespace
 } // namespace Statsd
 } // namespace Common
@@ -106,7 +106,7 @@ TEST(MetricsServiceSinkTest, CheckSendCall) {
   Event::SimulatedTimeSystem time_system;
   std::shared_ptr<MockGrpcMetricsStreamer> streamer_{new MockGrpcMetricsStreamer()};
 
-  MetricsServiceSink sink(streamer_, time_system);
+  MetricsServiceSink sink(streamer_, time_system, false);
 
   auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
   counter->name_ = "test_counter";
@@ -134,7 +134,7 @@ TEST(MetricsServiceSinkTest, CheckStatsCount) {
   Event::SimulatedTimeSystem time_system;
   std::shared_ptr<TestGrpcMetricsStreamer> streamer_{new TestGrpcMetricsStreamer()};
 
-  MetricsServiceSink sink(streamer_, time_system);
+  MetricsServiceSink sink(streamer_, time_system, false);
 
   auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
   counter->name_ = "test_counter";
@@ -157,6 +157,54 @@ TEST(MetricsServiceSinkTest, CheckStatsCount) {
   EXPECT_EQ(1, (*streamer_).metric_count);
 }
 
+// Only the metrics that changed since the last flush are sent when configured.
+TEST(MetricsServiceSinkTest, ReportChangedMetricsOnly) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  Event::SimulatedTimeSystem time_system;
+  std::shared_ptr<TestGrpcMetricsStreamer> streamer_{new TestGrpcMetricsStreamer()};
+
+  MetricsServiceSink sink(streamer_, time_system, true);
+
+  auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  counter->name_ = "test_counter";
+  counter->latch_ = 1;
+  counter->used_ = true;
+  snapshot.counters_.push_back({1, *counter});
+
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "test_gauge";
+  gauge->value_ = 1;
+  gauge->used_ = true;
+  snapshot.gauges_.push_back(*gauge);
+
+  // A histogram without samples in the interval is not sent.
+  auto histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  histogram->name_ = "test_histogram";
+  histogram->used_ = true;
+  snapshot.histograms_.push_back(*histogram);
+
+  sink.flush(snapshot);
+  EXPECT_EQ(2, (*streamer_).metric_count);
+
+  // Neither the counter nor the gauge changed.
+  snapshot.counters_.clear();
+  snapshot.counters_.push_back({0, *counter});
+  sink.flush(snapshot);
+  EXPECT_EQ(0, (*streamer_).metric_count);
+
+  gauge->value_ = 2;
+  sink.flush(snapshot);
+  EXPECT_EQ(1, (*streamer_).metric_count);
+
+  // A gauge removed from the snapshot is sent again when it comes back.
+  snapshot.gauges_.clear();
+  sink.flush(snapshot);
+  EXPECT_EQ(0, (*streamer_).metric_count);
+  snapshot.gauges_.push_back(*gauge);
+  sink.flush(snapshot);
+  EXPECT_EQ(1, (*streamer_).metric_count);
+}
+
 } // namespace
 } // namespace MetricsService
 } // namespace StatSinks
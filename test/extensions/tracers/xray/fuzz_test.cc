@@ -1,3 +1,5 @@
+#include "common/common/assert.h"
+
 #include "extensions/tracers/xray/util.h"
 
 #include "test/fuzz/fuzz_runner.h"
@@ -14,7 +16,8 @@ DEFINE_FUZZER(const uint8_t* buf, size_t len) {
   if (len > 1) {
     pattern = absl::string_view(reinterpret_cast<const char*>(buf), len / 2);
     input = absl::string_view(reinterpret_cast<const char*>(buf + len / 2), len - len / 2);
-    wildcardMatch(pattern, input);
+    // The compiled pattern must match the same inputs.
+    RELEASE_ASSERT(WildcardMatcher(pattern).matches(input) == wildcardMatch(pattern, input), "");
   } else { // buf is a single byte, use it for both pattern and input
     absl::string_view sv(reinterpret_cast<const char*>(buf), len);
     wildcardMatch(sv, "hello");
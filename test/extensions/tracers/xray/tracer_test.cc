@@ -12,8 +12,10 @@
 
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/tracing/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -155,6 +157,35 @@ TEST_F(XRayTracerTest, SpanInjectContextHasXRayHeaderNonSampled) {
   ASSERT_NE(header->value().getStringView().find("sampled=0"), absl::string_view::npos);
 }
 
+// The segments are sent in order by the thread of the broker, and the segments sent while
+// |max_queued_segments| segments are waiting are dropped.
+TEST_F(XRayTracerTest, AsyncDaemonBroker) {
+  absl::Notification sending;
+  absl::Notification send;
+  std::vector<std::string> segments;
+  EXPECT_CALL(*broker_, send(_)).WillRepeatedly(Invoke([&](const std::string& data) {
+    segments.push_back(data);
+    if (!sending.HasBeenNotified()) {
+      sending.Notify();
+      send.WaitForNotification();
+    }
+  }));
+
+  {
+    AsyncDaemonBroker broker{std::move(broker_), Thread::threadFactoryForTest(),
+                             2 /*max_queued_segments*/};
+    broker.send("1");
+    sending.WaitForNotification();
+    broker.send("2");
+    broker.send("3");
+    broker.send("4");
+    EXPECT_EQ(1, broker.droppedSegments());
+    send.Notify();
+    // The queued segments are sent before the broker is destroyed.
+  }
+  EXPECT_EQ((std::vector<std::string>{"1", "2", "3"}), segments);
+}
+
 TEST_F(XRayTracerTest, TraceIDFormatTest) {
   constexpr auto span_name = "my span";
   Tracer tracer{span_name, std::move(broker_), server_.timeSource()};
@@ -1,3 +1,6 @@
+#include <string>
+#include <vector>
+
 #include "extensions/tracers/xray/util.h"
 
 #include "gtest/gtest.h"
@@ -67,6 +70,26 @@ TEST(XRayWildcardTest, LengthAtLeastTwo) {
   EXPECT_TRUE(wildcardMatch("??*", "aa"));
   EXPECT_TRUE(wildcardMatch("??*", "aaa"));
 }
+
+// The compiled patterns match the same inputs as wildcardMatch().
+TEST(XRayWildcardTest, WildcardMatcher) {
+  const std::vector<std::string> patterns{
+      "", "*", "**", "?", "foo", "FOO", "foo*", "foo**", "*foo", "**foo", "*foo*", "f?o", "f*o",
+      "fo?*", "*?o", "/api/*", "*.amazon.com"};
+  const std::vector<std::string> inputs{"", "f", "foo", "Foo", "foob", "xfoo", "xfoox", "fo",
+                                        "fooo", "/ap", "/API/", "/api/move", "a.b.com",
+                                        "amazon.com", "s3.Amazon.COM"};
+  for (const std::string& pattern : patterns) {
+    const WildcardMatcher matcher(pattern);
+    for (const std::string& input : inputs) {
+      EXPECT_EQ(wildcardMatch(pattern, input), matcher.matches(input))
+          << "pattern: " << pattern << " input: " << input;
+    }
+  }
+  EXPECT_TRUE(WildcardMatcher("*.amazon.com").matches("s3.Amazon.COM"));
+  EXPECT_FALSE(WildcardMatcher("/api/*").matches("/ap"));
+  EXPECT_TRUE(WildcardMatcher("").matches(""));
+}
 } // namespace XRay
 } // namespace Tracers
 } // namespace Extensions
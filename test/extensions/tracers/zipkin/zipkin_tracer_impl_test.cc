@@ -6,6 +6,7 @@
 
 #include "envoy/config/trace/v3alpha/trace.pb.h"
 
+#include "common/decompressor/zlib_decompressor_impl.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
@@ -58,15 +59,16 @@ public:
                                        random_, time_source_);
   }
 
-  void setupValidDriver(const std::string& version) {
+  void setupValidDriver(const std::string& version, bool gzip_compression = false) {
     EXPECT_CALL(cm_, get(Eq("fake_cluster"))).WillRepeatedly(Return(&cm_.thread_local_cluster_));
 
     const std::string yaml_string = fmt::format(R"EOF(
     collector_cluster: fake_cluster
     collector_endpoint: /api/v1/spans
     collector_endpoint_version: {}
+    gzip_compression: {}
     )EOF",
-                                                version);
+                                                version, gzip_compression);
     envoy::config::trace::v3alpha::ZipkinConfig zipkin_config;
     TestUtility::loadFromYaml(yaml_string, zipkin_config);
 
@@ -194,6 +196,43 @@ TEST_F(ZipkinDriverTest, FlushSeveralSpansHttpJsonV1) {
   expectValidFlushSeveralSpans("HTTP_JSON_V1", "application/json");
 }
 
+TEST_F(ZipkinDriverTest, FlushSpansGzipCompressed) {
+  setupValidDriver("HTTP_JSON", true);
+
+  Http::MockAsyncClientRequest request(&cm_.async_client_);
+  std::vector<std::string> bodies;
+  EXPECT_CALL(cm_.async_client_, send_(_, _, _))
+      .Times(2)
+      .WillRepeatedly(
+          Invoke([&](Http::MessagePtr& message, Http::AsyncClient::Callbacks&,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            EXPECT_EQ("gzip", message->headers().ContentEncoding()->value().getStringView());
+            Decompressor::ZlibDecompressorImpl decompressor;
+            decompressor.init(31);
+            Buffer::OwnedImpl decompressed;
+            decompressor.decompress(*message->body(), decompressed);
+            bodies.push_back(decompressed.toString());
+            return &request;
+          }));
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillRepeatedly(Return(1));
+
+  // The compressor is reused by the second report.
+  for (int i = 0; i < 2; i++) {
+    Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                               start_time_, {Tracing::Reason::Sampling, true});
+    span->finishSpan();
+  }
+
+  ASSERT_EQ(2UL, bodies.size());
+  for (const std::string& body : bodies) {
+    EXPECT_EQ('[', body.front());
+    EXPECT_EQ(']', body.back());
+    EXPECT_NE(std::string::npos, body.find("\"kind\":\"SERVER\""));
+  }
+}
+
 TEST_F(ZipkinDriverTest, FlushSeveralSpansHttpJson) {
   expectValidFlushSeveralSpans("HTTP_JSON", "application/json");
 }
@@ -613,6 +652,7 @@ TEST_F(ZipkinDriverTest, ExplicitlySetSampledFalse) {
                                              start_time_, {Tracing::Reason::Sampling, true});
 
   span->setSampled(false);
+  EXPECT_FALSE(span->isRecording());
 
   request_headers_.remove(ZipkinCoreConstants::get().X_B3_SAMPLED);
 
@@ -630,6 +670,7 @@ TEST_F(ZipkinDriverTest, ExplicitlySetSampledTrue) {
                                              start_time_, {Tracing::Reason::Sampling, false});
 
   span->setSampled(true);
+  EXPECT_TRUE(span->isRecording());
 
   request_headers_.remove(ZipkinCoreConstants::get().X_B3_SAMPLED);
 
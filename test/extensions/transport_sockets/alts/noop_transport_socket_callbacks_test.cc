@@ -26,13 +26,16 @@ public:
   bool shouldDrainReadBuffer() override { return false; }
   void setReadBufferReady() override { set_read_buffer_ready_ = true; }
   void raiseEvent(Network::ConnectionEvent) override { event_raised_ = true; }
+  void recordReadsPerEvent(uint32_t num_reads) override { reads_per_event_ = num_reads; }
 
   bool event_raised() const { return event_raised_; }
   bool set_read_buffer_ready() const { return set_read_buffer_ready_; }
+  uint32_t reads_per_event() const { return reads_per_event_; }
 
 private:
   bool event_raised_{false};
   bool set_read_buffer_ready_{false};
+  uint32_t reads_per_event_{0};
   Network::IoHandlePtr io_handle_;
   Network::Connection& connection_;
 };
@@ -56,6 +59,9 @@ TEST_F(NoOpTransportSocketCallbacksTest, TestAllCallbacks) {
   EXPECT_FALSE(wrapper_callbacks_.set_read_buffer_ready());
   wrapped_callbacks_.raiseEvent(Network::ConnectionEvent::Connected);
   EXPECT_FALSE(wrapper_callbacks_.event_raised());
+  // Read counts are those of the underlying socket, so they are passed through.
+  wrapped_callbacks_.recordReadsPerEvent(3);
+  EXPECT_EQ(3U, wrapper_callbacks_.reads_per_event());
 }
 
 } // namespace
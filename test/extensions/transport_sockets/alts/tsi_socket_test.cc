@@ -47,13 +47,13 @@ protected:
     server_.raw_socket_ = new NiceMock<Network::MockTransportSocket>();
 
     server_.tsi_socket_ =
-        std::make_unique<TsiSocket>(server_.handshaker_factory_, server_validator,
+        std::make_unique<TsiSocket>(server_.handshaker_factory_, server_validator, absl::nullopt,
                                     Network::TransportSocketPtr{server_.raw_socket_});
 
     client_.raw_socket_ = new NiceMock<Network::MockTransportSocket>();
 
     client_.tsi_socket_ =
-        std::make_unique<TsiSocket>(client_.handshaker_factory_, client_validator,
+        std::make_unique<TsiSocket>(client_.handshaker_factory_, client_validator, absl::nullopt,
                                     Network::TransportSocketPtr{client_.raw_socket_});
 
     ON_CALL(client_.callbacks_.connection_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
@@ -393,7 +393,8 @@ protected:
       return std::make_unique<TsiHandshaker>(std::move(handshaker), dispatcher);
     };
 
-    socket_factory_ = std::make_unique<TsiSocketFactory>(handshaker_factory, nullptr);
+    socket_factory_ =
+        std::make_unique<TsiSocketFactory>(handshaker_factory, nullptr, absl::nullopt);
   }
   Network::TransportSocketFactoryPtr socket_factory_;
 };
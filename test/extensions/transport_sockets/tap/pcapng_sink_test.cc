@@ -0,0 +1,252 @@
+#include <arpa/inet.h>
+
+#include "envoy/config/tap/v3alpha/common.pb.h"
+#include "envoy/data/tap/v3alpha/wrapper.pb.h"
+
+#include "extensions/transport_sockets/tap/pcapng_sink.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tap {
+namespace {
+
+struct Block {
+  uint32_t type_;
+  std::string body_;
+};
+
+// Splits pcap-ng output written in the host byte order into its blocks.
+std::vector<Block> parseBlocks(const std::string& output) {
+  std::vector<Block> blocks;
+  size_t offset = 0;
+  while (offset < output.size()) {
+    uint32_t type;
+    uint32_t size;
+    memcpy(&type, output.data() + offset, 4);
+    memcpy(&size, output.data() + offset + 4, 4);
+    EXPECT_EQ(0U, size % 4);
+    EXPECT_LE(offset + size, output.size());
+    uint32_t trailing_size;
+    memcpy(&trailing_size, output.data() + offset + size - 4, 4);
+    EXPECT_EQ(size, trailing_size);
+    blocks.push_back({type, output.substr(offset + 8, size - 12)});
+    offset += size;
+  }
+  return blocks;
+}
+
+uint32_t hostOrder32(const std::string& data, size_t offset) {
+  uint32_t value;
+  memcpy(&value, data.data() + offset, 4);
+  return value;
+}
+
+uint16_t networkOrder16(const std::string& data, size_t offset) {
+  uint16_t value;
+  memcpy(&value, data.data() + offset, 2);
+  return ntohs(value);
+}
+
+uint32_t networkOrder32(const std::string& data, size_t offset) {
+  return ntohl(hostOrder32(data, offset));
+}
+
+struct Packet {
+  uint64_t timestamp_us_;
+  uint32_t original_size_;
+  std::string data_;
+};
+
+Packet parsePacket(const Block& block) {
+  EXPECT_EQ(6U, block.type_);
+  Packet packet;
+  packet.timestamp_us_ = (static_cast<uint64_t>(hostOrder32(block.body_, 4)) << 32) |
+                         hostOrder32(block.body_, 8);
+  const uint32_t captured_size = hostOrder32(block.body_, 12);
+  packet.original_size_ = hostOrder32(block.body_, 16);
+  packet.data_ = block.body_.substr(20, captured_size);
+  return packet;
+}
+
+envoy::data::tap::v3alpha::TraceWrapper traceFromYaml(const std::string& yaml) {
+  envoy::data::tap::v3alpha::TraceWrapper trace;
+  TestUtility::loadFromYaml(yaml, trace);
+  return trace;
+}
+
+const std::string ConnectionYaml = R"EOF(
+socket_streamed_trace_segment:
+  trace_id: 1
+  connection:
+    local_address:
+      socket_address:
+        address: 10.0.0.1
+        port_value: 80
+    remote_address:
+      socket_address:
+        address: 10.0.0.2
+        port_value: 1234
+)EOF";
+
+const std::string ReadYaml = R"EOF(
+socket_streamed_trace_segment:
+  trace_id: 1
+  event:
+    timestamp: 1970-01-01T00:00:01.000002Z
+    read:
+      data:
+        as_bytes: aGVsbG8=
+)EOF";
+
+const std::string WriteYaml = R"EOF(
+socket_streamed_trace_segment:
+  trace_id: 1
+  event:
+    timestamp: 1970-01-01T00:00:03Z
+    write:
+      data:
+        as_string: world!
+      end_stream: true
+)EOF";
+
+// The file starts with a section header and a raw IP interface with the snaplen.
+TEST(PcapngWriterTest, Header) {
+  PcapngWriter writer(1000);
+  std::string output;
+  writer.writeHeader(output);
+
+  const std::vector<Block> blocks = parseBlocks(output);
+  ASSERT_EQ(2U, blocks.size());
+  EXPECT_EQ(0x0A0D0D0AU, blocks[0].type_);
+  EXPECT_EQ(0x1A2B3C4DU, hostOrder32(blocks[0].body_, 0));
+  EXPECT_EQ(1U, blocks[1].type_);
+  EXPECT_EQ(101U, hostOrder32(blocks[1].body_, 0) & 0xffff);
+  EXPECT_EQ(1000U, hostOrder32(blocks[1].body_, 4));
+}
+
+// The reads and writes of a streamed trace are written as IPv4 TCP packets, with the sequence
+// numbers following the bytes sent in each direction.
+TEST(PcapngWriterTest, StreamedIpv4) {
+  PcapngWriter writer(65535);
+  std::string output;
+  writer.writeTrace(traceFromYaml(ConnectionYaml), output);
+  EXPECT_TRUE(output.empty());
+  writer.writeTrace(traceFromYaml(ReadYaml), output);
+  writer.writeTrace(traceFromYaml(WriteYaml), output);
+
+  const std::vector<Block> blocks = parseBlocks(output);
+  ASSERT_EQ(2U, blocks.size());
+
+  const Packet read = parsePacket(blocks[0]);
+  EXPECT_EQ(1000002U, read.timestamp_us_);
+  EXPECT_EQ(45U, read.original_size_);
+  ASSERT_EQ(45U, read.data_.size());
+  EXPECT_EQ(0x45, read.data_[0]);
+  EXPECT_EQ(45U, networkOrder16(read.data_, 2));
+  EXPECT_EQ(6, read.data_[9]);
+  EXPECT_EQ(0x0a000002U, networkOrder32(read.data_, 12));
+  EXPECT_EQ(0x0a000001U, networkOrder32(read.data_, 16));
+  EXPECT_EQ(1234U, networkOrder16(read.data_, 20));
+  EXPECT_EQ(80U, networkOrder16(read.data_, 22));
+  EXPECT_EQ(1U, networkOrder32(read.data_, 24));
+  EXPECT_EQ(1U, networkOrder32(read.data_, 28));
+  EXPECT_EQ(0x18, read.data_[33]);
+  EXPECT_EQ("hello", read.data_.substr(40));
+
+  // The IPv4 header checksum sums to 0xffff over the whole header.
+  uint32_t sum = 0;
+  for (size_t i = 0; i < 20; i += 2) {
+    sum += networkOrder16(read.data_, i);
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  EXPECT_EQ(0xffffU, sum);
+
+  const Packet write = parsePacket(blocks[1]);
+  EXPECT_EQ(3000000U, write.timestamp_us_);
+  EXPECT_EQ(46U, write.original_size_);
+  EXPECT_EQ(0x0a000001U, networkOrder32(write.data_, 12));
+  EXPECT_EQ(0x0a000002U, networkOrder32(write.data_, 16));
+  EXPECT_EQ(80U, networkOrder16(write.data_, 20));
+  EXPECT_EQ(1234U, networkOrder16(write.data_, 22));
+  EXPECT_EQ(1U, networkOrder32(write.data_, 24));
+  EXPECT_EQ(6U, networkOrder32(write.data_, 28));
+  // FIN, as the write ends the stream.
+  EXPECT_EQ(0x19, write.data_[33]);
+  EXPECT_EQ("world!", write.data_.substr(40));
+}
+
+// A buffered trace carries its connection and events together. Connections mixing IPv4 and IPv6
+// are written as IPv6, and the packets are truncated to the snaplen.
+TEST(PcapngWriterTest, BufferedIpv6Snaplen) {
+  PcapngWriter writer(64);
+  std::string output;
+  writer.writeTrace(traceFromYaml(R"EOF(
+socket_buffered_trace:
+  trace_id: 1
+  connection:
+    local_address:
+      socket_address:
+        address: "::1"
+        port_value: 80
+    remote_address:
+      socket_address:
+        address: 10.0.0.2
+        port_value: 1234
+  events:
+    - timestamp: 1970-01-01T00:00:01Z
+      write:
+        data:
+          as_string: "0123456789"
+)EOF"),
+                    output);
+
+  const std::vector<Block> blocks = parseBlocks(output);
+  ASSERT_EQ(1U, blocks.size());
+  const Packet write = parsePacket(blocks[0]);
+  EXPECT_EQ(70U, write.original_size_);
+  ASSERT_EQ(64U, write.data_.size());
+  EXPECT_EQ(0x60, write.data_[0] & 0xf0);
+  EXPECT_EQ(30U, networkOrder16(write.data_, 4));
+  // The remote IPv4 address is mapped to IPv6.
+  EXPECT_EQ(std::string("\0\0\0\0\0\0\0\0\0\0\xff\xff\x0a\0\0\x02", 16),
+            write.data_.substr(24, 16));
+  EXPECT_EQ("0123", write.data_.substr(60));
+}
+
+// The traces queued by the workers are written to the file by the background thread.
+TEST(PcapngSinkTest, WritesFile) {
+  const std::string path = TestEnvironment::temporaryPath("pcapng_sink_test.pcapng");
+  envoy::config::tap::v3alpha::PcapngSink config;
+  config.set_path(path);
+  {
+    PcapngSink sink(config, Thread::threadFactoryForTest());
+    Extensions::Common::Tap::PerTapSinkHandlePtr handle = sink.createPerTapSinkHandle(1);
+    for (const std::string& yaml : {ConnectionYaml, ReadYaml, WriteYaml}) {
+      auto trace = Extensions::Common::Tap::makeTraceWrapper();
+      TestUtility::loadFromYaml(yaml, *trace);
+      handle->submitTrace(std::move(trace),
+                          envoy::config::tap::v3alpha::OutputSink::PROTO_BINARY);
+    }
+  }
+
+  const std::vector<Block> blocks =
+      parseBlocks(TestEnvironment::readFileToStringForTest(path));
+  ASSERT_EQ(4U, blocks.size());
+  EXPECT_EQ("hello", parsePacket(blocks[2]).data_.substr(40));
+  EXPECT_EQ("world!", parsePacket(blocks[3]).data_.substr(40));
+}
+
+} // namespace
+} // namespace Tap
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -327,6 +327,38 @@ TEST_F(SslContextImplTest, TestNoCert) {
   EXPECT_TRUE(context->getCertChainInformation().empty());
 }
 
+// The contexts trusting the same CA certificates share a single trust store.
+TEST_F(SslContextImplTest, TrustedCaStoreShared) {
+  auto create_context = [&](const std::string& ca_file) {
+    envoy::extensions::transport_sockets::tls::v3alpha::UpstreamTlsContext tls_context;
+    tls_context.mutable_common_tls_context()
+        ->mutable_validation_context()
+        ->mutable_trusted_ca()
+        ->set_filename(TestEnvironment::substitute(
+            "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + ca_file));
+    ClientContextConfigImpl cfg(tls_context, factory_context_);
+    return std::dynamic_pointer_cast<ClientContextImpl>(
+        manager_.createSslClientContext(store_, cfg));
+  };
+  auto cert_store = [](ClientContextImpl& context) {
+    bssl::UniquePtr<SSL> ssl = context.newSsl(nullptr);
+    return SSL_CTX_get_cert_store(SSL_get_SSL_CTX(ssl.get()));
+  };
+
+  std::shared_ptr<ClientContextImpl> context = create_context("ca_cert.pem");
+  std::shared_ptr<ClientContextImpl> same_ca_context = create_context("ca_cert.pem");
+  std::shared_ptr<ClientContextImpl> other_ca_context = create_context("fake_ca_cert.pem");
+  EXPECT_EQ(cert_store(*context), cert_store(*same_ca_context));
+  EXPECT_NE(cert_store(*context), cert_store(*other_ca_context));
+  EXPECT_EQ(2, manager_.trustedCaStoreCache().size());
+
+  // A store is released along with the last context using it.
+  context.reset();
+  EXPECT_EQ(2, manager_.trustedCaStoreCache().size());
+  same_ca_context.reset();
+  EXPECT_EQ(1, manager_.trustedCaStoreCache().size());
+}
+
 // Multiple RSA certificates are rejected.
 TEST_F(SslContextImplTest, AtMostOneRsaCert) {
   envoy::extensions::transport_sockets::tls::v3alpha::DownstreamTlsContext tls_context;
@@ -1286,6 +1318,29 @@ TEST_F(ServerContextConfigImplTest, InvalidIgnoreCertsNoCA) {
   EXPECT_NO_THROW(ServerContextConfigImpl server_context_config(tls_context, factory_context_));
 }
 
+// Certificate verifications are only cached with a trusted CA.
+TEST_F(ServerContextConfigImplTest, InvalidVerificationCacheNoCA) {
+  envoy::extensions::transport_sockets::tls::v3alpha::DownstreamTlsContext tls_context;
+  envoy::extensions::transport_sockets::tls::v3alpha::TlsCertificate* server_cert =
+      tls_context.mutable_common_tls_context()->add_tls_certificates();
+  server_cert->mutable_certificate_chain()->set_filename(
+      TestEnvironment::substitute("{{ test_tmpdir }}/unittestcert.pem"));
+  server_cert->mutable_private_key()->set_filename(
+      TestEnvironment::substitute("{{ test_tmpdir }}/unittestkey.pem"));
+  envoy::extensions::transport_sockets::tls::v3alpha::CertificateValidationContext*
+      server_validation_ctx =
+          tls_context.mutable_common_tls_context()->mutable_validation_context();
+  server_validation_ctx->mutable_verification_cache_ttl()->set_seconds(60);
+
+  EXPECT_THROW_WITH_MESSAGE(
+      ServerContextConfigImpl server_context_config(tls_context, factory_context_), EnvoyException,
+      "Certificate verifications are only cached with a trusted CA");
+
+  server_validation_ctx->mutable_trusted_ca()->set_filename(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"));
+  EXPECT_NO_THROW(ServerContextConfigImpl server_context_config(tls_context, factory_context_));
+}
+
 TEST_F(ServerContextConfigImplTest, PrivateKeyMethodLoadFailureNoProvider) {
   envoy::extensions::transport_sockets::tls::v3alpha::DownstreamTlsContext tls_context;
   NiceMock<Ssl::MockContextManager> context_manager;
@@ -755,7 +755,9 @@ protected:
 
   void testClientSessionResumption(const std::string& server_ctx_yaml,
                                    const std::string& client_ctx_yaml, bool expect_reuse,
-                                   const Network::Address::IpVersion version);
+                                   const Network::Address::IpVersion version,
+                                   const std::string& second_server_name = "",
+                                   uint64_t expected_verify_cache_hits = 0);
 
   Event::DispatcherPtr dispatcher_;
 };
@@ -2978,7 +2980,9 @@ TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
 void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_yaml,
                                                 const std::string& client_ctx_yaml,
                                                 bool expect_reuse,
-                                                const Network::Address::IpVersion version) {
+                                                const Network::Address::IpVersion version,
+                                                const std::string& second_server_name,
+                                                uint64_t expected_verify_cache_hits) {
   InSequence s;
 
   ContextManagerImpl manager(time_system_);
@@ -3081,9 +3085,15 @@ void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_ya
   connect_count = 0;
   close_count = 0;
 
+  // The second connection may go to another server name than the first one.
+  Network::TransportSocketOptionsSharedPtr transport_socket_options;
+  if (!second_server_name.empty()) {
+    transport_socket_options =
+        std::make_shared<Network::TransportSocketOptionsImpl>(second_server_name);
+  }
   client_connection = dispatcher->createClientConnection(
       socket->localAddress(), Network::Address::InstanceConstSharedPtr(),
-      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+      client_ssl_socket_factory.createTransportSocket(transport_socket_options), nullptr);
   client_connection->addConnectionCallbacks(client_connection_callbacks);
   client_connection->connect();
 
@@ -3117,6 +3127,11 @@ void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_ya
 
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, server_stats_store.counter("ssl.session_reused").value());
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, client_stats_store.counter("ssl.session_reused").value());
+  if (expect_reuse) {
+    EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_cache_hit").value());
+  }
+  EXPECT_EQ(expected_verify_cache_hits,
+            client_stats_store.counter("ssl.verify_cache_hit").value());
 }
 
 // Test client session resumption using default settings (should be enabled).
@@ -3159,6 +3174,30 @@ TEST_P(SslSocketTest, ClientSessionResumptionDisabledTls12) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, false, GetParam());
 }
 
+// Without session resumption, the chain verified on the first connection is found in the
+// verification cache on the second one.
+TEST_P(SslSocketTest, ClientVerificationCache) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+      verification_cache_ttl: 60s
+  max_session_keys: 0
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, false, GetParam(), "", 1);
+}
+
 // Test client session resumption with TLS 1.0-1.2.
 TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls12) {
   const std::string server_ctx_yaml = R"EOF(
@@ -3184,6 +3223,34 @@ TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls12) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// Make sure sessions are not offered to a server name other than the one they were established
+// with.
+TEST_P(SslSocketTest, ClientSessionResumptionOtherServerName) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  sni: "server1.example.com"
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 2
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, false, GetParam(),
+                              "server2.example.com");
+}
+
 // Make sure client session resumption is not happening with TLS 1.3 when it's disabled.
 TEST_P(SslSocketTest, ClientSessionResumptionDisabledTls13) {
   const std::string server_ctx_yaml = R"EOF(
@@ -4297,6 +4364,32 @@ TEST_P(SslReadBufferLimitTest, SmallReadsIntoSameSlice) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Tests that a large enough front slice is written as its own record instead of being
+// linearized together with the following slices.
+TEST(SslSocketWriteLengthTest, UnlinearizedFrontSlice) {
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(std::string(SslSocket::MinUnlinearizedWriteSize, 'a'));
+  buffer.appendSliceForTest(std::string(SslSocket::MaxWriteSize, 'b'));
+  EXPECT_EQ(SslSocket::MinUnlinearizedWriteSize, SslSocket::nextWriteLength(buffer, true));
+  EXPECT_EQ(SslSocket::MaxWriteSize, SslSocket::nextWriteLength(buffer, false));
+
+  // A small front slice is still linearized to avoid tiny records.
+  Buffer::OwnedImpl small_front;
+  small_front.appendSliceForTest(std::string(SslSocket::MinUnlinearizedWriteSize - 1, 'a'));
+  small_front.appendSliceForTest(std::string(SslSocket::MaxWriteSize, 'b'));
+  EXPECT_EQ(SslSocket::MaxWriteSize, SslSocket::nextWriteLength(small_front, true));
+
+  // Writes are capped at the maximum record size.
+  Buffer::OwnedImpl large_front;
+  large_front.appendSliceForTest(std::string(2 * SslSocket::MaxWriteSize, 'a'));
+  EXPECT_EQ(SslSocket::MaxWriteSize, SslSocket::nextWriteLength(large_front, true));
+
+  Buffer::OwnedImpl short_buffer("hello");
+  EXPECT_EQ(5U, SslSocket::nextWriteLength(short_buffer, true));
+  Buffer::OwnedImpl empty;
+  EXPECT_EQ(0U, SslSocket::nextWriteLength(empty, true));
+}
+
 // Test asynchronous signing (ECDHE) using a private key provider.
 TEST_P(SslSocketTest, RsaPrivateKeyProviderAsyncSignSuccess) {
   const std::string server_ctx_yaml = R"EOF(
@@ -0,0 +1,135 @@
+// Usage: bazel run -c opt //test/integration:http_proxy_benchmark
+//
+// Measures the whole request path of the HTTP proxy: requests are sent over loopback connections to
+// a server with a real listener, HTTP connection manager, router and codecs, and proxied to an
+// upstream answering each of them. The server runs a single worker, and the CPU time is that of the
+// whole process, so items_per_second is the number of requests proxied per second of CPU, including
+// the CPU used by the client and the upstream. The allocations are also those of the whole process,
+// and are only counted when built with tcmalloc.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/http/utility.h"
+
+#include "exe/process_wide.h"
+
+#include "test/integration/autonomous_upstream.h"
+#include "test/integration/http_integration.h"
+#include "test/test_common/environment.h"
+
+#include "benchmark/benchmark.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+#ifdef TCMALLOC
+void countAllocation(const void*, size_t) { allocations.fetch_add(1, std::memory_order_relaxed); }
+#endif
+
+class HttpProxyBenchmark : public HttpIntegrationTest {
+public:
+  HttpProxyBenchmark(Http::CodecClient::Type downstream_protocol,
+                     FakeHttpConnection::Type upstream_protocol)
+      : HttpIntegrationTest(downstream_protocol, TestEnvironment::getIpVersionsForTest()[0]) {
+    autonomous_upstream_ = true;
+    setUpstreamProtocol(upstream_protocol);
+  }
+
+  // Proxies one request at a time on a single connection. The request and response bodies are
+  // state.range(0) bytes long, the request having no body if 0.
+  void run(benchmark::State& state, Http::TestHeaderMapImpl request_headers) {
+    const uint64_t body_size = state.range(0);
+    request_headers.addCopy(AutonomousStream::RESPONSE_SIZE_BYTES, body_size);
+    initialize();
+    codec_client_ = makeHttpConnection(lookupPort("http"));
+
+    std::vector<std::chrono::nanoseconds> latencies;
+    latencies.reserve(state.max_iterations);
+    const uint64_t allocations_at_start = allocations.load();
+    for (auto _ : state) {
+      const MonotonicTime start = timeSystem().monotonicTime();
+      IntegrationStreamDecoderPtr response =
+          body_size == 0 ? codec_client_->makeHeaderOnlyRequest(request_headers)
+                         : codec_client_->makeRequestWithBody(request_headers, body_size);
+      response->waitForEndStream();
+      latencies.push_back(timeSystem().monotonicTime() - start);
+      RELEASE_ASSERT(Http::Utility::getResponseStatus(response->headers()) == 200, "");
+    }
+    const uint64_t requests = state.iterations();
+    state.SetItemsProcessed(requests);
+    state.counters["allocs_per_request"] =
+        static_cast<double>(allocations.load() - allocations_at_start) / requests;
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double fraction) {
+      const auto latency = latencies[static_cast<size_t>(fraction * (latencies.size() - 1))];
+      return static_cast<double>(
+          std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    };
+    state.counters["p50_us"] = percentile(0.5);
+    state.counters["p90_us"] = percentile(0.9);
+    state.counters["p99_us"] = percentile(0.99);
+  }
+};
+
+Http::TestHeaderMapImpl httpRequestHeaders(const benchmark::State& state) {
+  return Http::TestHeaderMapImpl{{":method", state.range(0) == 0 ? "GET" : "POST"},
+                                 {":path", "/"},
+                                 {":scheme", "http"},
+                                 {":authority", "host"}};
+}
+
+void BM_Http1Proxy(benchmark::State& state) {
+  HttpProxyBenchmark proxy(Http::CodecClient::Type::HTTP1, FakeHttpConnection::Type::HTTP1);
+  proxy.run(state, httpRequestHeaders(state));
+}
+BENCHMARK(BM_Http1Proxy)->Arg(0)->Arg(4096)->MeasureProcessCPUTime();
+
+void BM_Http2Proxy(benchmark::State& state) {
+  HttpProxyBenchmark proxy(Http::CodecClient::Type::HTTP2, FakeHttpConnection::Type::HTTP2);
+  proxy.run(state, httpRequestHeaders(state));
+}
+BENCHMARK(BM_Http2Proxy)->Arg(0)->Arg(4096)->MeasureProcessCPUTime();
+
+// Unary gRPC calls, which only differ from HTTP/2 requests in their headers as far as the proxy is
+// concerned, and go through the gRPC specific paths of the router and connection manager.
+void BM_GrpcProxy(benchmark::State& state) {
+  HttpProxyBenchmark proxy(Http::CodecClient::Type::HTTP2, FakeHttpConnection::Type::HTTP2);
+  proxy.run(state, Http::TestHeaderMapImpl{{":method", "POST"},
+                                           {":path", "/envoy.benchmark.Service/Call"},
+                                           {":scheme", "http"},
+                                           {":authority", "host"},
+                                           {"content-type", "application/grpc"},
+                                           {"te", "trailers"}});
+}
+BENCHMARK(BM_GrpcProxy)->Arg(64)->Arg(4096)->MeasureProcessCPUTime();
+
+} // namespace
+} // namespace Envoy
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  Envoy::ProcessWide process_wide;
+  Envoy::TestEnvironment::initializeOptions(argc, argv);
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+#ifdef TCMALLOC
+  MallocHook::AddNewHook(&Envoy::countAllocation);
+#endif
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,336 @@
+// Usage: bazel run -c opt //test/integration:xds_benchmark
+//
+// Measures how long the server takes to apply large xDS updates: CDS updates of many clusters, EDS
+// updates of a cluster of many endpoints, RDS updates of a route configuration of many routes and
+// LDS updates of many listeners. The updates are sent over ADS by a fake management server to a
+// server with a real cluster manager and listener manager, and each update changes all of its
+// resources. update_ms is the time from an update being sent to its subscription reporting it
+// applied on the main thread, which includes its transfer and decoding, and propagation_ms is the
+// further time until the workers have run what the main thread posted to them for it. memory is the
+// growth of the memory allocated by the whole process over the updates, which includes what is kept
+// of the replaced listeners while they drain, and is only reported when built with tcmalloc.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/config/bootstrap/v3alpha/bootstrap.pb.h"
+#include "envoy/config/cluster/v3alpha/cluster.pb.h"
+#include "envoy/config/core/v3alpha/address.pb.h"
+#include "envoy/config/endpoint/v3alpha/endpoint.pb.h"
+#include "envoy/config/listener/v3alpha/listener.pb.h"
+#include "envoy/config/route/v3alpha/route.pb.h"
+#include "envoy/extensions/filters/network/http_connection_manager/v3alpha/http_connection_manager.pb.h"
+
+#include "common/common/thread.h"
+#include "common/config/resources.h"
+#include "common/memory/stats.h"
+
+#include "exe/process_wide.h"
+
+#include "test/integration/ads_integration.h"
+#include "test/integration/http_integration.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/network_utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+class XdsBenchmark : public HttpIntegrationTest {
+public:
+  XdsBenchmark()
+      : HttpIntegrationTest(Http::CodecClient::Type::HTTP2,
+                            TestEnvironment::getIpVersionsForTest()[0],
+                            AdsIntegrationConfig("GRPC")) {
+    use_lds_ = false;
+    create_xds_upstream_ = true;
+    // More than a single worker, for the propagation to the workers to be that of a real server.
+    concurrency_ = 2;
+  }
+
+  ~XdsBenchmark() override {
+    cleanUpXdsConnection();
+    test_server_.reset();
+    fake_upstreams_.clear();
+  }
+
+  void initialize() override {
+    config_helper_.addConfigModifier([](envoy::config::bootstrap::v3alpha::Bootstrap& bootstrap) {
+      auto* ads_cluster = bootstrap.mutable_static_resources()->add_clusters();
+      ads_cluster->MergeFrom(bootstrap.static_resources().clusters()[0]);
+      ads_cluster->set_name("ads_cluster");
+      bootstrap.mutable_dynamic_resources()
+          ->mutable_ads_config()
+          ->add_grpc_services()
+          ->mutable_envoy_grpc()
+          ->set_cluster_name("ads_cluster");
+    });
+    setUpstreamProtocol(FakeHttpConnection::Type::HTTP2);
+    HttpIntegrationTest::initialize();
+    createXdsConnection();
+    AssertionResult result = xds_connection_->waitForNewStream(*dispatcher_, xds_stream_);
+    RELEASE_ASSERT(result, result.message());
+    xds_stream_->startGrpcStream();
+
+    // The server subscribes to the listeners once it has its initial clusters, and only starts its
+    // workers once it also has its initial listeners.
+    waitForRequest(Config::TypeUrl::get().Cluster);
+    sendSotwDiscoveryResponse<envoy::config::cluster::v3alpha::Cluster>(
+        Config::TypeUrl::get().Cluster, {}, nextVersion());
+    waitForRequest(Config::TypeUrl::get().Listener);
+    sendSotwDiscoveryResponse<envoy::config::listener::v3alpha::Listener>(
+        Config::TypeUrl::get().Listener, {}, nextVersion());
+    waitForUpdates("listener_manager.lds.update_success", 1);
+    waitForWorkers();
+  }
+
+  // Sends an update and waits for its subscription to have applied it, with no timing, to set up
+  // the resources the benchmarked updates depend on.
+  template <class T>
+  void update(const std::string& type_url, const std::vector<T>& resources,
+              const std::string& update_success) {
+    const uint64_t updates = updateCount(update_success);
+    sendSotwDiscoveryResponse<T>(type_url, resources, nextVersion());
+    waitForUpdates(update_success, updates + 1);
+  }
+
+  // Sends the updates, alternating between two versions of the resources so that each update
+  // changes all of them. update_success is the counter of the updates applied by the subscription.
+  template <class T>
+  void run(benchmark::State& state, const std::string& type_url,
+           const std::array<std::vector<T>, 2>& versions, const std::string& update_success) {
+    // The counter is looked up once, as looking it up goes through all the counters of the server.
+    Stats::CounterSharedPtr counter = test_server_->counter(update_success);
+    RELEASE_ASSERT(counter != nullptr, "");
+    uint64_t updates = counter->value();
+    std::chrono::nanoseconds update_time{0};
+    std::chrono::nanoseconds propagation_time{0};
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    for (auto _ : state) {
+      // Packing the resources into the response isn't part of the update.
+      state.PauseTiming();
+      sendSotwDiscoveryResponse<T>(type_url, versions[state.iterations() % 2], nextVersion());
+      state.ResumeTiming();
+      const MonotonicTime start = timeSystem().monotonicTime();
+      waitForUpdates(*counter, ++updates);
+      const MonotonicTime applied = timeSystem().monotonicTime();
+      waitForWorkers();
+      update_time += applied - start;
+      propagation_time += timeSystem().monotonicTime() - applied;
+    }
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    const auto per_update_ms = [&state](std::chrono::nanoseconds time) {
+      return std::chrono::duration<double, std::milli>(time).count() / state.iterations();
+    };
+    state.counters["update_ms"] = per_update_ms(update_time);
+    state.counters["propagation_ms"] = per_update_ms(propagation_time);
+    state.counters["memory"] = static_cast<double>(end_mem) - start_mem;
+    state.counters["memory_per_resource"] =
+        (static_cast<double>(end_mem) - start_mem) / state.range(0);
+  }
+
+  std::string loopbackAddress() const { return Network::Test::getLoopbackAddressString(version_); }
+
+private:
+  std::string nextVersion() { return std::to_string(next_version_++); }
+
+  void waitForRequest(const std::string& type_url) {
+    API_NO_BOOST(envoy::api::v2::DiscoveryRequest) request;
+    do {
+      AssertionResult result = xds_stream_->waitForGrpcMessage(*dispatcher_, request);
+      RELEASE_ASSERT(result, result.message());
+    } while (request.type_url() != type_url);
+  }
+
+  uint64_t updateCount(const std::string& update_success) {
+    Stats::CounterSharedPtr counter = test_server_->counter(update_success);
+    return counter == nullptr ? 0 : counter->value();
+  }
+
+  void waitForUpdates(const std::string& update_success, uint64_t value) {
+    Stats::CounterSharedPtr counter = test_server_->counter(update_success);
+    while (counter == nullptr) {
+      timeSystem().sleep(std::chrono::milliseconds(1));
+      counter = test_server_->counter(update_success);
+    }
+    waitForUpdates(*counter, value);
+  }
+
+  // Polls the counter rather than using waitForCounterGe(), which looks it up on each poll and only
+  // polls every 10ms.
+  void waitForUpdates(Stats::Counter& update_success, uint64_t value) {
+    while (update_success.value() < value) {
+      timeSystem().sleep(std::chrono::microseconds(100));
+    }
+  }
+
+  // Waits for the workers to have run everything the main thread posted to them so far.
+  void waitForWorkers() {
+    Server::Instance& server = test_server_->server();
+    absl::Notification done;
+    server.dispatcher().post([&server, &done] {
+      server.threadLocal().runOnAllThreads([] {}, [&done] { done.Notify(); });
+    });
+    done.WaitForNotification();
+  }
+
+  uint64_t next_version_{0};
+};
+
+// A distinct address for each of 2^24 endpoints, none of which is connected to.
+void setEndpointAddress(envoy::config::core::v3alpha::Address& address, uint32_t index,
+                        uint32_t port) {
+  auto* socket_address = address.mutable_socket_address();
+  socket_address->set_address(
+      fmt::format("10.{}.{}.{}", (index >> 16) & 0xff, (index >> 8) & 0xff, index & 0xff));
+  socket_address->set_port_value(port);
+}
+
+void BM_CdsUpdate(benchmark::State& state) {
+  XdsBenchmark benchmark;
+  benchmark.initialize();
+  std::array<std::vector<envoy::config::cluster::v3alpha::Cluster>, 2> versions;
+  for (uint32_t version = 0; version < versions.size(); ++version) {
+    for (uint32_t i = 0; i < state.range(0); ++i) {
+      envoy::config::cluster::v3alpha::Cluster cluster;
+      cluster.set_name(fmt::format("cluster_{}", i));
+      cluster.set_type(envoy::config::cluster::v3alpha::Cluster::STATIC);
+      cluster.mutable_connect_timeout()->set_seconds(version + 1);
+      auto* load_assignment = cluster.mutable_load_assignment();
+      load_assignment->set_cluster_name(cluster.name());
+      setEndpointAddress(*load_assignment->add_endpoints()
+                              ->add_lb_endpoints()
+                              ->mutable_endpoint()
+                              ->mutable_address(),
+                         i, 80);
+      versions[version].push_back(cluster);
+    }
+  }
+  benchmark.run(state, Config::TypeUrl::get().Cluster, versions,
+                "cluster_manager.cds.update_success");
+}
+BENCHMARK(BM_CdsUpdate)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void BM_EdsUpdate(benchmark::State& state) {
+  XdsBenchmark benchmark;
+  benchmark.initialize();
+  envoy::config::cluster::v3alpha::Cluster cluster;
+  cluster.set_name("eds_cluster");
+  cluster.set_type(envoy::config::cluster::v3alpha::Cluster::EDS);
+  cluster.mutable_connect_timeout()->set_seconds(1);
+  cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_ads();
+  benchmark.update<envoy::config::cluster::v3alpha::Cluster>(
+      Config::TypeUrl::get().Cluster, {cluster}, "cluster_manager.cds.update_success");
+
+  std::array<std::vector<envoy::config::endpoint::v3alpha::ClusterLoadAssignment>, 2> versions;
+  for (uint32_t version = 0; version < versions.size(); ++version) {
+    envoy::config::endpoint::v3alpha::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(cluster.name());
+    auto* endpoints = load_assignment.add_endpoints();
+    for (uint32_t i = 0; i < state.range(0); ++i) {
+      // Each version has other ports, for all the hosts to be replaced.
+      setEndpointAddress(*endpoints->add_lb_endpoints()->mutable_endpoint()->mutable_address(), i,
+                         80 + version);
+    }
+    versions[version].push_back(load_assignment);
+  }
+  benchmark.run(state, Config::TypeUrl::get().ClusterLoadAssignment, versions,
+                "cluster.eds_cluster.update_success");
+}
+BENCHMARK(BM_EdsUpdate)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+envoy::config::listener::v3alpha::Listener
+makeListener(const std::string& name, const std::string& address,
+             const envoy::extensions::filters::network::http_connection_manager::v3alpha::
+                 HttpConnectionManager& hcm) {
+  envoy::config::listener::v3alpha::Listener listener;
+  listener.set_name(name);
+  auto* socket_address = listener.mutable_address()->mutable_socket_address();
+  socket_address->set_address(address);
+  socket_address->set_port_value(0);
+  auto* filter = listener.add_filter_chains()->add_filters();
+  filter->set_name("envoy.http_connection_manager");
+  filter->mutable_typed_config()->PackFrom(hcm);
+  return listener;
+}
+
+void BM_RdsUpdate(benchmark::State& state) {
+  XdsBenchmark benchmark;
+  benchmark.initialize();
+  envoy::extensions::filters::network::http_connection_manager::v3alpha::HttpConnectionManager hcm;
+  hcm.set_stat_prefix("benchmark");
+  auto* rds = hcm.mutable_rds();
+  rds->set_route_config_name("route_config");
+  rds->mutable_config_source()->mutable_ads();
+  hcm.add_http_filters()->set_name("envoy.router");
+  benchmark.update<envoy::config::listener::v3alpha::Listener>(
+      Config::TypeUrl::get().Listener,
+      {makeListener("listener_0", benchmark.loopbackAddress(), hcm)},
+      "listener_manager.lds.update_success");
+
+  std::array<std::vector<envoy::config::route::v3alpha::RouteConfiguration>, 2> versions;
+  for (uint32_t version = 0; version < versions.size(); ++version) {
+    envoy::config::route::v3alpha::RouteConfiguration route_config;
+    route_config.set_name("route_config");
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name("benchmark");
+    virtual_host->add_domains("*");
+    for (uint32_t i = 0; i < state.range(0); ++i) {
+      auto* route = virtual_host->add_routes();
+      route->mutable_match()->set_prefix(fmt::format("/v{}/route_{}", version, i));
+      route->mutable_route()->set_cluster("cluster_0");
+    }
+    versions[version].push_back(route_config);
+  }
+  benchmark.run(state, Config::TypeUrl::get().RouteConfiguration, versions,
+                "http.benchmark.rds.route_config.update_success");
+}
+BENCHMARK(BM_RdsUpdate)->Arg(5000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+void BM_LdsUpdate(benchmark::State& state) {
+  XdsBenchmark benchmark;
+  benchmark.initialize();
+  std::array<std::vector<envoy::config::listener::v3alpha::Listener>, 2> versions;
+  for (uint32_t version = 0; version < versions.size(); ++version) {
+    envoy::extensions::filters::network::http_connection_manager::v3alpha::HttpConnectionManager
+        hcm;
+    // Each version has another stat prefix, for all the listeners to be replaced.
+    hcm.set_stat_prefix(fmt::format("benchmark_{}", version));
+    auto* virtual_host = hcm.mutable_route_config()->add_virtual_hosts();
+    virtual_host->set_name("benchmark");
+    virtual_host->add_domains("*");
+    auto* route = virtual_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_route()->set_cluster("cluster_0");
+    hcm.add_http_filters()->set_name("envoy.router");
+    for (uint32_t i = 0; i < state.range(0); ++i) {
+      versions[version].push_back(
+          makeListener(fmt::format("listener_{}", i), benchmark.loopbackAddress(), hcm));
+    }
+  }
+  benchmark.run(state, Config::TypeUrl::get().Listener, versions,
+                "listener_manager.lds.update_success");
+}
+BENCHMARK(BM_LdsUpdate)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Envoy
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  Envoy::ProcessWide process_wide;
+  Envoy::TestEnvironment::initializeOptions(argc, argv);
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -96,6 +96,10 @@ public:
                              std::function<void()> above_high) override {
     return Buffer::InstancePtr{create_(below_low, above_high)};
   }
+  Buffer::InstancePtr create(std::function<void()> below_low, std::function<void()> above_high,
+                             Buffer::MemoryClass) override {
+    return Buffer::InstancePtr{create_(below_low, above_high)};
+  }
 
   MOCK_METHOD2(create_, Buffer::Instance*(std::function<void()> below_low,
                                           std::function<void()> above_high));
@@ -75,6 +75,11 @@ public:
     return Event::TimerPtr{createTimer_(cb)};
   }
 
+  // Coarse timers are mocked as regular timers, so that the MockTimer expectations cover both.
+  Event::TimerPtr createCoarseTimer(Event::TimerCb cb) override {
+    return Event::TimerPtr{createTimer_(cb)};
+  }
+
   void deferredDelete(DeferredDeletablePtr&& to_delete) override {
     deferredDelete_(to_delete.get());
     if (to_delete) {
@@ -99,7 +104,7 @@ public:
   MOCK_METHOD2(createDnsResolver,
                Network::DnsResolverSharedPtr(
                    const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers,
-                   const bool use_tcp_for_dns_lookups));
+                   const Network::DnsResolverOptions& options));
   MOCK_METHOD4(createFileEvent_,
                FileEvent*(int fd, FileReadyCb cb, FileTriggerType trigger, uint32_t events));
   MOCK_METHOD0(createFilesystemWatcher_, Filesystem::Watcher*());
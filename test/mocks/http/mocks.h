@@ -375,6 +375,7 @@ public:
   MOCK_METHOD2(sendData, void(Buffer::Instance& data, bool end_stream));
   MOCK_METHOD1(sendTrailers, void(HeaderMap& trailers));
   MOCK_METHOD0(reset, void());
+  MOCK_CONST_METHOD0(isAboveWriteBufferHighWatermark, bool());
 };
 
 class MockFilterChainFactoryCallbacks : public Http::FilterChainFactoryCallbacks {
@@ -386,6 +387,7 @@ public:
   MOCK_METHOD1(addStreamEncoderFilter, void(Http::StreamEncoderFilterSharedPtr filter));
   MOCK_METHOD1(addStreamFilter, void(Http::StreamFilterSharedPtr filter));
   MOCK_METHOD1(addAccessLogHandler, void(AccessLog::InstanceSharedPtr handler));
+  MOCK_METHOD1(setFilterName, void(absl::string_view name));
 };
 
 class MockDownstreamWatermarkCallbacks : public DownstreamWatermarkCallbacks {
@@ -23,6 +23,9 @@ public:
                                                 const Address::Instance& peer_address));
   MOCK_METHOD4(recvmsg, Api::IoCallUint64Result(Buffer::RawSlice* slices, const uint64_t num_slice,
                                                 uint32_t self_port, RecvMsgOutput& output));
+  MOCK_METHOD4(recvmmsg, Api::IoCallUint64Result(Buffer::RawSlice* slices, uint64_t num_packets,
+                                                 uint32_t self_port, RecvMmsgOutput& output));
+  MOCK_CONST_METHOD0(supportsMmsg, bool());
 };
 
 } // namespace Network
@@ -139,6 +139,7 @@ public:
 
   MOCK_METHOD1(onData, void(UdpRecvData& data));
   MOCK_METHOD0(onReadReady, void());
+  MOCK_METHOD1(onPacketsRead, void(uint64_t num_packets));
   MOCK_METHOD1(onWriteReady, void(const Socket& socket));
   MOCK_METHOD1(onReceiveError, void(Api::IoError::IoErrorCode err));
 };
@@ -348,6 +349,9 @@ public:
   MOCK_METHOD0(decNumConnections, void());
   MOCK_METHOD1(addListener, void(ListenerConfig& config));
   MOCK_METHOD1(removeListeners, void(uint64_t listener_tag));
+  MOCK_METHOD3(removeFilterChains,
+               void(uint64_t listener_tag, const std::list<const FilterChain*>& filter_chains,
+                    std::function<void()> completion));
   MOCK_METHOD1(stopListeners, void(uint64_t listener_tag));
   MOCK_METHOD0(stopListeners, void());
   MOCK_METHOD0(disableListeners, void());
@@ -406,6 +410,7 @@ public:
   MOCK_METHOD0(shouldDrainReadBuffer, bool());
   MOCK_METHOD0(setReadBufferReady, void());
   MOCK_METHOD1(raiseEvent, void(ConnectionEvent));
+  MOCK_METHOD1(recordReadsPerEvent, void(uint32_t));
 
   testing::NiceMock<MockConnection> connection_;
 };
@@ -22,6 +22,12 @@ TestRetryPolicy::TestRetryPolicy() { num_retries_ = 1; }
 
 TestRetryPolicy::~TestRetryPolicy() = default;
 
+MockLatencyHedgePolicy::MockLatencyHedgePolicy() {
+  ON_CALL(*this, tryHedge()).WillByDefault(Return(true));
+}
+
+MockLatencyHedgePolicy::~MockLatencyHedgePolicy() = default;
+
 MockRetryState::MockRetryState() = default;
 
 void MockRetryState::expectHeadersRetry() {
@@ -57,6 +63,13 @@ MockRateLimitPolicy::~MockRateLimitPolicy() = default;
 MockShadowWriter::MockShadowWriter() = default;
 MockShadowWriter::~MockShadowWriter() = default;
 
+MockShadowStream::MockShadowStream() {
+  ON_CALL(*this, sendData(_, _)).WillByDefault(Return(true));
+  ON_CALL(*this, sendTrailers(_)).WillByDefault(Return(true));
+}
+
+MockShadowStream::~MockShadowStream() = default;
+
 MockVirtualHost::MockVirtualHost() {
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
   ON_CALL(*this, rateLimitPolicy()).WillByDefault(ReturnRef(rate_limit_policy_));
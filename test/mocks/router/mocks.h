@@ -61,6 +61,14 @@ public:
   const std::vector<Matchers::StringMatcherPtr>& allowOrigins() const override {
     return allow_origins_;
   };
+  bool allowsOrigin(absl::string_view origin) const override {
+    for (const auto& allow_origin : allow_origins_) {
+      if (allow_origin->match("*") || allow_origin->match(origin)) {
+        return true;
+      }
+    }
+    return false;
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -87,10 +95,37 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  const LatencyHedgePolicy* latencyHedgePolicy() const override { return latency_hedge_policy_; }
 
   uint32_t initial_requests_{};
   envoy::type::v3alpha::FractionalPercent additional_request_chance_{};
   bool hedge_on_per_try_timeout_{};
+  const LatencyHedgePolicy* latency_hedge_policy_{};
+};
+
+class MockLatencyHedgePolicy : public LatencyHedgePolicy {
+public:
+  MockLatencyHedgePolicy();
+  ~MockLatencyHedgePolicy() override;
+
+  // Router::LatencyHedgePolicy
+  MOCK_CONST_METHOD0(hedgeDelay, absl::optional<std::chrono::milliseconds>());
+  MOCK_CONST_METHOD1(recordLatency, void(std::chrono::milliseconds latency));
+  MOCK_CONST_METHOD0(onRequest, void());
+  MOCK_CONST_METHOD0(canHedge, bool());
+  MOCK_CONST_METHOD0(onHedge, void());
+};
+
+class TestRequestCollapsingPolicy : public RequestCollapsingPolicy {
+public:
+  // Router::RequestCollapsingPolicy
+  const std::vector<Http::LowerCaseString>& headers() const override { return headers_; }
+  bool perProcess() const override { return per_process_; }
+  uint64_t maxResponseBytes() const override { return max_response_bytes_; }
+
+  std::vector<Http::LowerCaseString> headers_;
+  bool per_process_{true};
+  uint64_t max_response_bytes_{1024 * 1024};
 };
 
 class TestRetryPolicy : public RetryPolicy {
@@ -214,9 +249,27 @@ public:
               std::chrono::milliseconds timeout) override {
     shadow_(cluster, request, timeout);
   }
+  ShadowStream* streamingShadow(const std::string& cluster, Http::HeaderMapPtr&& headers,
+                                std::chrono::milliseconds timeout) override {
+    return streamingShadow_(cluster, headers, timeout);
+  }
 
   MOCK_METHOD3(shadow_, void(const std::string& cluster, Http::MessagePtr& request,
                              std::chrono::milliseconds timeout));
+  MOCK_METHOD3(streamingShadow_,
+               ShadowStream*(const std::string& cluster, Http::HeaderMapPtr& headers,
+                             std::chrono::milliseconds timeout));
+};
+
+class MockShadowStream : public ShadowStream {
+public:
+  MockShadowStream();
+  ~MockShadowStream() override;
+
+  // Router::ShadowStream
+  MOCK_METHOD2(sendData, bool(Buffer::Instance& data, bool end_stream));
+  MOCK_METHOD1(sendTrailers, bool(const Http::HeaderMap& trailers));
+  MOCK_METHOD0(release, void());
 };
 
 class TestVirtualCluster : public VirtualCluster {
@@ -320,6 +373,7 @@ public:
   MOCK_CONST_METHOD0(hedgePolicy, const HedgePolicy&());
   MOCK_CONST_METHOD0(metadataMatchCriteria, const Router::MetadataMatchCriteria*());
   MOCK_CONST_METHOD0(tlsContextMatchCriteria, const Router::TlsContextMatchCriteria*());
+  MOCK_CONST_METHOD0(requestCollapsingPolicy, const RequestCollapsingPolicy*());
   MOCK_CONST_METHOD0(priority, Upstream::ResourcePriority());
   MOCK_CONST_METHOD0(rateLimitPolicy, const RateLimitPolicy&());
   MOCK_CONST_METHOD0(retryPolicy, const RetryPolicy&());
@@ -41,6 +41,10 @@ public:
     }
   }
 
+  // The registered key variants look up the mocked methods by name.
+  using Snapshot::featureEnabled;
+  using Snapshot::getInteger;
+
   MOCK_CONST_METHOD2(deprecatedFeatureEnabled, bool(const std::string& key, bool default_value));
   MOCK_CONST_METHOD1(runtimeFeatureEnabled, bool(absl::string_view key));
   MOCK_CONST_METHOD2(featureEnabled, bool(const std::string& key, uint64_t default_value));
@@ -60,7 +64,8 @@ public:
   MOCK_CONST_METHOD2(getInteger, uint64_t(const std::string& key, uint64_t default_value));
   MOCK_CONST_METHOD2(getDouble, double(const std::string& key, double default_value));
   MOCK_CONST_METHOD2(getBoolean, bool(absl::string_view key, bool default_value));
-  MOCK_CONST_METHOD0(getLayers, const std::vector<OverrideLayerConstPtr>&());
+  MOCK_CONST_METHOD0(getLayers, const std::vector<OverrideLayerConstSharedPtr>&());
+  MOCK_CONST_METHOD0(generation, uint64_t());
 };
 
 class MockLoader : public Loader {
@@ -39,9 +39,13 @@ MockOptions::MockOptions(const std::string& config_path) : config_path_(config_p
   ON_CALL(*this, logPath()).WillByDefault(ReturnRef(log_path_));
   ON_CALL(*this, restartEpoch()).WillByDefault(ReturnPointee(&hot_restart_epoch_));
   ON_CALL(*this, hotRestartDisabled()).WillByDefault(ReturnPointee(&hot_restart_disabled_));
+  ON_CALL(*this, hotRestartSharedStats())
+      .WillByDefault(ReturnPointee(&hot_restart_shared_stats_));
   ON_CALL(*this, signalHandlingEnabled()).WillByDefault(ReturnPointee(&signal_handling_enabled_));
   ON_CALL(*this, mutexTracingEnabled()).WillByDefault(ReturnPointee(&mutex_tracing_enabled_));
   ON_CALL(*this, cpusetThreadsEnabled()).WillByDefault(ReturnPointee(&cpuset_threads_enabled_));
+  ON_CALL(*this, workerCpuAffinityEnabled())
+      .WillByDefault(ReturnPointee(&worker_cpu_affinity_enabled_));
   ON_CALL(*this, disabledExtensions()).WillByDefault(ReturnRef(disabled_extensions_));
   ON_CALL(*this, toCommandLineOptions()).WillByDefault(Invoke([] {
     return std::make_unique<envoy::admin::v3alpha::CommandLineOptions>();
@@ -139,6 +143,13 @@ MockWorker::MockWorker() {
           completion();
         }
       }));
+
+  ON_CALL(*this, removeFilterChains(_, _, _))
+      .WillByDefault(Invoke([this](uint64_t, const std::list<const Network::FilterChain*>&,
+                                   std::function<void()> completion) -> void {
+        EXPECT_EQ(nullptr, remove_filter_chains_completion_);
+        remove_filter_chains_completion_ = completion;
+      }));
 }
 MockWorker::~MockWorker() = default;
 
@@ -91,10 +91,12 @@ public:
   MOCK_CONST_METHOD0(serviceNodeName, const std::string&());
   MOCK_CONST_METHOD0(serviceZone, const std::string&());
   MOCK_CONST_METHOD0(hotRestartDisabled, bool());
+  MOCK_CONST_METHOD0(hotRestartSharedStats, bool());
   MOCK_CONST_METHOD0(signalHandlingEnabled, bool());
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
   MOCK_CONST_METHOD0(fakeSymbolTableEnabled, bool());
   MOCK_CONST_METHOD0(cpusetThreadsEnabled, bool());
+  MOCK_CONST_METHOD0(workerCpuAffinityEnabled, bool());
   MOCK_CONST_METHOD0(disabledExtensions, const std::vector<std::string>&());
   MOCK_CONST_METHOD0(toCommandLineOptions, Server::CommandLineOptionsPtr());
 
@@ -112,9 +114,11 @@ public:
   uint32_t concurrency_{1};
   uint64_t hot_restart_epoch_{};
   bool hot_restart_disabled_{};
+  bool hot_restart_shared_stats_{};
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
   bool cpuset_threads_enabled_{};
+  bool worker_cpu_affinity_enabled_{};
   std::vector<std::string> disabled_extensions_;
 };
 
@@ -336,6 +340,12 @@ public:
     remove_listener_completion_ = nullptr;
   }
 
+  void callDrainFilterChainsComplete() {
+    EXPECT_NE(nullptr, remove_filter_chains_completion_);
+    remove_filter_chains_completion_();
+    remove_filter_chains_completion_ = nullptr;
+  }
+
   // Server::Worker
   MOCK_METHOD2(addListener,
                void(Network::ListenerConfig& listener, AddListenerCompletion completion));
@@ -347,9 +357,14 @@ public:
   MOCK_METHOD0(stop, void());
   MOCK_METHOD2(stopListener,
                void(Network::ListenerConfig& listener, std::function<void()> completion));
+  MOCK_METHOD3(removeFilterChains,
+               void(uint64_t listener_tag,
+                    const std::list<const Network::FilterChain*>& filter_chains,
+                    std::function<void()> completion));
 
   AddListenerCompletion add_listener_completion_;
   std::function<void()> remove_listener_completion_;
+  std::function<void()> remove_filter_chains_completion_;
 };
 
 class MockOverloadManager : public OverloadManager {
@@ -325,6 +325,9 @@ public:
   MockStatsMatcher();
   ~MockStatsMatcher() override;
   MOCK_CONST_METHOD1(rejects, bool(const std::string& name));
+  bool rejects(StatName name, const SymbolTable& symbol_table) const override {
+    return rejects(symbol_table.toString(name));
+  }
   bool acceptsAll() const override { return accepts_all_; }
   bool rejectsAll() const override { return rejects_all_; }
 
@@ -9,7 +9,7 @@ using testing::ReturnRef;
 namespace Envoy {
 namespace Tracing {
 
-MockSpan::MockSpan() = default;
+MockSpan::MockSpan() { ON_CALL(*this, isRecording()).WillByDefault(Return(true)); }
 MockSpan::~MockSpan() = default;
 
 MockConfig::MockConfig() {
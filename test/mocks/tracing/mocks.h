@@ -36,6 +36,7 @@ public:
   MOCK_METHOD0(finishSpan, void());
   MOCK_METHOD1(injectContext, void(Http::HeaderMap& request_headers));
   MOCK_METHOD1(setSampled, void(const bool sampled));
+  MOCK_CONST_METHOD0(isRecording, bool());
 
   SpanPtr spawnChild(const Config& config, const std::string& name,
                      SystemTime start_time) override {
@@ -72,7 +72,7 @@ public:
                             uint64_t conn_pool) {
     resource_manager_ = std::make_unique<ResourceManagerImpl>(
         runtime_, name_, cx, rq_pending, rq, rq_retry, conn_pool, circuit_breakers_stats_,
-        absl::nullopt, absl::nullopt);
+        absl::nullopt, absl::nullopt, false);
   }
 
   void resetResourceManagerWithRetryBudget(uint64_t cx, uint64_t rq_pending, uint64_t rq,
@@ -80,7 +80,7 @@ public:
                                            double budget_percent, uint32_t min_retry_concurrency) {
     resource_manager_ = std::make_unique<ResourceManagerImpl>(
         runtime_, name_, cx, rq_pending, rq, rq_retry, conn_pool, circuit_breakers_stats_,
-        budget_percent, min_retry_concurrency);
+        budget_percent, min_retry_concurrency, false);
   }
 
   // Upstream::ClusterInfo
@@ -105,12 +105,16 @@ public:
   MOCK_CONST_METHOD0(
       lbLeastRequestConfig,
       const absl::optional<envoy::config::cluster::v3alpha::Cluster::LeastRequestLbConfig>&());
+  MOCK_CONST_METHOD0(
+      lbPeakEwmaConfig,
+      const absl::optional<envoy::config::cluster::v3alpha::Cluster::PeakEwmaLbConfig>&());
   MOCK_CONST_METHOD0(
       lbOriginalDstConfig,
       const absl::optional<envoy::config::cluster::v3alpha::Cluster::OriginalDstLbConfig>&());
   MOCK_CONST_METHOD0(maintenanceMode, bool());
   MOCK_CONST_METHOD0(maxResponseHeadersCount, uint32_t());
   MOCK_CONST_METHOD0(maxRequestsPerConnection, uint64_t());
+  MOCK_CONST_METHOD0(tcpPrefetchConnections, uint32_t());
   MOCK_CONST_METHOD0(name, const std::string&());
   MOCK_CONST_METHOD1(resourceManager, ResourceManager&(ResourcePriority priority));
   MOCK_CONST_METHOD0(transportSocketMatcher, TransportSocketMatcher&());
@@ -138,6 +142,7 @@ public:
   Http::Http2Settings http2_settings_;
   ProtocolOptionsConfigConstSharedPtr extension_protocol_options_;
   uint64_t max_requests_per_connection_{};
+  uint32_t tcp_prefetch_connections_{};
   uint32_t max_response_headers_count_{Http::DEFAULT_MAX_HEADERS_COUNT};
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   ClusterStats stats_;
@@ -158,6 +163,7 @@ public:
   absl::optional<envoy::config::core::v3alpha::UpstreamHttpProtocolOptions>
       upstream_http_protocol_options_;
   absl::optional<envoy::config::cluster::v3alpha::Cluster::RingHashLbConfig> lb_ring_hash_config_;
+  absl::optional<envoy::config::cluster::v3alpha::Cluster::PeakEwmaLbConfig> lb_peak_ewma_config_;
   absl::optional<envoy::config::cluster::v3alpha::Cluster::OriginalDstLbConfig>
       lb_original_dst_config_;
   Network::ConnectionSocket::OptionsSharedPtr cluster_socket_options_;
@@ -77,6 +77,15 @@ public:
   MOCK_METHOD0(setUnhealthy, void());
 };
 
+class MockHostLatency : public HostLatency {
+public:
+  MockHostLatency();
+  ~MockHostLatency() override;
+
+  MOCK_METHOD2(recordLatency, void(std::chrono::microseconds latency, MonotonicTime now));
+  MOCK_CONST_METHOD1(peakEwma, double(MonotonicTime now));
+};
+
 class MockHostDescription : public HostDescription {
 public:
   MockHostDescription();
@@ -86,7 +95,8 @@ public:
   MOCK_CONST_METHOD0(healthCheckAddress, Network::Address::InstanceConstSharedPtr());
   MOCK_CONST_METHOD0(canary, bool());
   MOCK_METHOD1(canary, void(bool new_canary));
-  MOCK_CONST_METHOD0(metadata, const std::shared_ptr<envoy::config::core::v3alpha::Metadata>());
+  MOCK_CONST_METHOD0(metadata,
+                     const std::shared_ptr<const envoy::config::core::v3alpha::Metadata>());
   MOCK_METHOD1(metadata, void(const envoy::config::core::v3alpha::Metadata&));
   MOCK_CONST_METHOD0(cluster, const ClusterInfo&());
   MOCK_CONST_METHOD0(outlierDetector, Outlier::DetectorHostMonitor&());
@@ -94,6 +104,7 @@ public:
   MOCK_CONST_METHOD0(hostname, const std::string&());
   MOCK_CONST_METHOD0(transportSocketFactory, Network::TransportSocketFactory&());
   MOCK_CONST_METHOD0(stats, HostStats&());
+  MOCK_CONST_METHOD0(latency, HostLatency&());
   MOCK_CONST_METHOD0(locality, const envoy::config::core::v3alpha::Locality&());
   MOCK_CONST_METHOD0(priority, uint32_t());
   MOCK_METHOD1(priority, void(uint32_t));
@@ -111,6 +122,7 @@ public:
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<MockClusterInfo> cluster_;
   HostStats stats_;
+  testing::NiceMock<MockHostLatency> latency_;
   mutable Stats::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
 };
@@ -157,7 +169,8 @@ public:
   MOCK_CONST_METHOD0(healthCheckAddress, Network::Address::InstanceConstSharedPtr());
   MOCK_CONST_METHOD0(canary, bool());
   MOCK_METHOD1(canary, void(bool new_canary));
-  MOCK_CONST_METHOD0(metadata, const std::shared_ptr<envoy::config::core::v3alpha::Metadata>());
+  MOCK_CONST_METHOD0(metadata,
+                     const std::shared_ptr<const envoy::config::core::v3alpha::Metadata>());
   MOCK_METHOD1(metadata, void(const envoy::config::core::v3alpha::Metadata&));
   MOCK_CONST_METHOD0(cluster, const ClusterInfo&());
   MOCK_CONST_METHOD0(counters,
@@ -181,6 +194,7 @@ public:
   MOCK_METHOD1(setHealthChecker_, void(HealthCheckHostMonitorPtr& health_checker));
   MOCK_METHOD1(setOutlierDetector_, void(Outlier::DetectorHostMonitorPtr& outlier_detector));
   MOCK_CONST_METHOD0(stats, HostStats&());
+  MOCK_CONST_METHOD0(latency, HostLatency&());
   MOCK_CONST_METHOD0(weight, uint32_t());
   MOCK_METHOD1(weight, void(uint32_t new_weight));
   MOCK_CONST_METHOD0(used, bool());
@@ -194,6 +208,7 @@ public:
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
   HostStats stats_;
+  testing::NiceMock<MockHostLatency> latency_;
   mutable Stats::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
 };
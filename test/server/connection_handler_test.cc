@@ -56,7 +56,8 @@ public:
           hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
           name_(name), listener_filters_timeout_(listener_filters_timeout),
           continue_on_listener_filters_timeout_(continue_on_listener_filters_timeout),
-          connection_balancer_(std::make_unique<Network::NopConnectionBalancerImpl>()) {
+          filter_chain_manager_(&parent.manager_),
+          connection_balancer_(std::make_shared<Network::NopConnectionBalancerImpl>()) {
       envoy::config::listener::v3alpha::UdpListenerConfig dummy;
       std::string listener_name("raw_udp_listener");
       dummy.set_udp_listener_name(listener_name);
@@ -67,7 +68,7 @@ public:
     }
 
     // Network::ListenerConfig
-    Network::FilterChainManager& filterChainManager() override { return parent_.manager_; }
+    Network::FilterChainManager& filterChainManager() override { return *filter_chain_manager_; }
     Network::FilterChainFactory& filterChainFactory() override { return parent_.factory_; }
     Network::ListenSocketFactory& listenSocketFactory() override { return *socket_factory_; }
     bool bindToPort() override { return bind_to_port_; }
@@ -102,7 +103,8 @@ public:
     const std::chrono::milliseconds listener_filters_timeout_;
     const bool continue_on_listener_filters_timeout_;
     std::unique_ptr<Network::ActiveUdpListenerFactory> udp_listener_factory_;
-    Network::ConnectionBalancerPtr connection_balancer_;
+    Network::FilterChainManager* filter_chain_manager_;
+    Network::ConnectionBalancerSharedPtr connection_balancer_;
   };
 
   using TestListenerPtr = std::unique_ptr<TestListener>;
@@ -333,6 +335,92 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+// A listener added with the tag of an existing one replaces the config of that listener, which
+// keeps its socket and its connections.
+TEST_F(ConnectionHandlerTest, UpdateListenerInPlace) {
+  InSequence s;
+
+  Network::ListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
+  handler_->addListener(*test_listener);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_()).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  NiceMock<Network::MockFilterChainManager> updated_manager;
+  listeners_.emplace_back(std::make_unique<TestListener>(
+      *this, 1, true, false, "test_listener", Network::Address::SocketType::Stream,
+      std::chrono::milliseconds(15000), false, socket_factory_));
+  TestListener* updated_listener = listeners_.back().get();
+  updated_listener->filter_chain_manager_ = &updated_manager;
+  updated_listener->connection_balancer_ = test_listener->connection_balancer_;
+  EXPECT_CALL(*socket_factory_, socketType())
+      .WillOnce(Return(Network::Address::SocketType::Stream));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _)).Times(0);
+  handler_->addListener(*updated_listener);
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  // New connections use the updated config.
+  EXPECT_CALL(updated_manager, findFilterChain(_)).WillOnce(Return(nullptr));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+// Only the connections of the removed filter chains are closed.
+TEST_F(ConnectionHandlerTest, RemoveFilterChains) {
+  Network::ListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
+  handler_->addListener(*test_listener);
+
+  const Network::FilterChainSharedPtr removed_filter_chain =
+      Network::Test::createEmptyFilterChainWithRawBufferSockets();
+  EXPECT_CALL(manager_, findFilterChain(_))
+      .WillOnce(Return(removed_filter_chain.get()))
+      .WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* removed_connection = new NiceMock<Network::MockConnection>();
+  Network::MockConnection* kept_connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_())
+      .WillOnce(Return(removed_connection))
+      .WillOnce(Return(kept_connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  // A listener which does not exist anymore has no connection left to close.
+  bool completed = false;
+  handler_->removeFilterChains(0, {removed_filter_chain.get()},
+                               [&completed]() { completed = true; });
+  EXPECT_TRUE(completed);
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  completed = false;
+  EXPECT_CALL(*removed_connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  handler_->removeFilterChains(1, {removed_filter_chain.get()},
+                               [&completed]() { completed = true; });
+  EXPECT_TRUE(completed);
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, NormalRedirect) {
   Network::ListenerCallbacks* listener_callbacks1;
   auto listener1 = new NiceMock<Network::MockListener>();
@@ -346,7 +434,7 @@ TEST_F(ConnectionHandlerTest, NormalRedirect) {
   Network::ListenerCallbacks* listener_callbacks2;
   auto listener2 = new NiceMock<Network::MockListener>();
   TestListener* test_listener2 =
-      addListener(1, false, false, "test_listener2", listener2, &listener_callbacks2);
+      addListener(2, false, false, "test_listener2", listener2, &listener_callbacks2);
   Network::Address::InstanceConstSharedPtr alt_address(
       new Network::Address::Ipv4Instance("127.0.0.2", 20002));
   EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(alt_address));
@@ -408,7 +496,7 @@ TEST_F(ConnectionHandlerTest, FallbackToWildcardListener) {
   Network::ListenerCallbacks* listener_callbacks2;
   auto listener2 = new NiceMock<Network::MockListener>();
   TestListener* test_listener2 =
-      addListener(1, false, false, "test_listener2", listener2, &listener_callbacks2);
+      addListener(2, false, false, "test_listener2", listener2, &listener_callbacks2);
   Network::Address::InstanceConstSharedPtr any_address = Network::Utility::getIpv4AnyAddress();
   EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(any_address));
   handler_->addListener(*test_listener2);
@@ -158,6 +158,22 @@ const char YamlSingleDstPortBottom[] = R"EOF(
           session_ticket_keys:
             keys:
             - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ticket_key_a")EOF";
+const char YamlSingleServerNameTop[] = R"EOF(
+    - filter_chain_match:
+        server_names: )EOF";
+const char YamlSingleServerNameBottom[] = R"EOF(
+        transport_protocol: "tls"
+      transport_socket:
+        name: envoy.transport_sockets.tls
+        typed_config:
+          "@type": type.googleapis.com/envoy.api.v2.auth.DownstreamTlsContext
+          common_tls_context:
+            tls_certificates:
+              - certificate_chain: { filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem" }
+                private_key: { filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem" }
+          session_ticket_keys:
+            keys:
+            - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ticket_key_a")EOF";
 } // namespace
 
 class FilterChainBenchmarkFixture : public benchmark::Fixture {
@@ -214,6 +230,67 @@ BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainFindTest)
     }
   }
 }
+// Filter chains of a multi-tenant listener, each matching an exact and a wildcard server name, e.g.
+// "tenant1.example.com" and "*.tenant1.example.com".
+class FilterChainServerNameBenchmarkFixture : public benchmark::Fixture {
+public:
+  using Fixture::SetUp;
+  void SetUp(const ::benchmark::State& state) override {
+    int64_t input_size = state.range(0);
+    std::vector<std::string> server_name_chains;
+    server_name_chains.reserve(input_size);
+    for (int i = 0; i < input_size; i++) {
+      server_name_chains.push_back(absl::StrCat(YamlSingleServerNameTop, "[\"tenant", i,
+                                                ".example.com\", \"*.tenant", i, ".example.com\"]",
+                                                YamlSingleServerNameBottom));
+    }
+    listener_yaml_config_ = TestEnvironment::substitute(
+        absl::StrCat(YamlHeader, absl::StrJoin(server_name_chains, "")),
+        Network::Address::IpVersion::v4);
+    TestUtility::loadFromYaml(listener_yaml_config_, listener_config_);
+    filter_chains_ = listener_config_.filter_chains();
+  }
+  absl::Span<const envoy::config::listener::v3alpha::FilterChain* const> filter_chains_;
+  std::string listener_yaml_config_;
+  envoy::config::listener::v3alpha::Listener listener_config_;
+  MockFilterChainFactoryBuilder dummy_builder_;
+};
+
+BENCHMARK_DEFINE_F(FilterChainServerNameBenchmarkFixture, FilterChainManagerBuildTest)
+(::benchmark::State& state) {
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  for (auto _ : state) {
+    FilterChainManagerImpl filter_chain_manager{
+        std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context};
+    filter_chain_manager.addFilterChain(filter_chains_, dummy_builder_, filter_chain_manager);
+  }
+}
+
+// Alternate between exact and wildcard server name matches, and a server name only matching the
+// catch-all filter chain.
+BENCHMARK_DEFINE_F(FilterChainServerNameBenchmarkFixture, FilterChainFindTest)
+(::benchmark::State& state) {
+  std::vector<MockConnectionSocket> sockets;
+  sockets.reserve(state.range(0));
+  for (int i = 0; i < state.range(0); i++) {
+    const std::string server_name =
+        i % 3 == 0 ? absl::StrCat("tenant", i, ".example.com")
+                   : i % 3 == 1 ? absl::StrCat("www.tenant", i, ".example.com") : "www.example.org";
+    sockets.push_back(std::move(*MockConnectionSocket::createMockConnectionSocket(
+        1234, "127.0.0.1", server_name, "tls", {}, "8.8.8.8", 111)));
+  }
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  FilterChainManagerImpl filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context};
+
+  filter_chain_manager.addFilterChain(filter_chains_, dummy_builder_, filter_chain_manager);
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      filter_chain_manager.findFilterChain(sockets[i]);
+    }
+  }
+}
+
 BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainManagerBuildTest)
     ->Ranges({
         // scale of the chains
@@ -224,6 +301,16 @@ BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainFindTest)
         // scale of the chains
         {1, 4096},
     });
+BENCHMARK_REGISTER_F(FilterChainServerNameBenchmarkFixture, FilterChainManagerBuildTest)
+    ->Ranges({
+        // scale of the chains
+        {1, 16384},
+    });
+BENCHMARK_REGISTER_F(FilterChainServerNameBenchmarkFixture, FilterChainFindTest)
+    ->Ranges({
+        // scale of the chains
+        {1, 16384},
+    });
 
 /*
 clang-format off
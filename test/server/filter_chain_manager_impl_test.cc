@@ -155,5 +155,49 @@ TEST_F(FilterChainManagerImplTest, FilterChainContextsAreUnique) {
   EXPECT_EQ(contexts.size(), 2);
 }
 
+// A filter chain manager created from another one shares the filter chains whose config is
+// unchanged and builds the others.
+TEST_F(FilterChainManagerImplTest, ReuseUnchangedFilterChains) {
+  addSingleFilterChainHelper(filter_chain_template_);
+  envoy::config::listener::v3alpha::FilterChain new_filter_chain = filter_chain_template_;
+  new_filter_chain.mutable_filter_chain_match()->mutable_destination_port()->set_value(10001);
+
+  FilterChainManagerImpl new_filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), parent_context_,
+      parent_context_.initManager(), filter_chain_manager_};
+  new_filter_chain_manager.addFilterChain(
+      std::vector<const envoy::config::listener::v3alpha::FilterChain*>{&filter_chain_template_,
+                                                                         &new_filter_chain},
+      filter_chain_factory_builder_, new_filter_chain_manager);
+
+  // All the filter chains of the original manager are kept.
+  filter_chain_manager_.diffFilterChains(
+      new_filter_chain_manager,
+      [](const Network::FilterChain&, FilterChainFactoryContextImpl*) { FAIL(); });
+
+  // Only the added filter chain is new.
+  auto* filter_chain = findFilterChainHelper(10000, "127.0.0.1", "", "tls", {}, "8.8.8.8", 111);
+  std::vector<const Network::FilterChain*> added_filter_chains;
+  new_filter_chain_manager.diffFilterChains(
+      filter_chain_manager_,
+      [&added_filter_chains](const Network::FilterChain& added, FilterChainFactoryContextImpl*) {
+        added_filter_chains.push_back(&added);
+      });
+  ASSERT_EQ(1U, added_filter_chains.size());
+  EXPECT_NE(filter_chain, added_filter_chains.front());
+}
+
+// A filter chain context drains once told to, independently of its listener.
+TEST_F(FilterChainManagerImplTest, FilterChainContextDrainsOnItsOwn) {
+  auto& context = dynamic_cast<FilterChainFactoryContextImpl&>(
+      filter_chain_manager_.createFilterChainFactoryContext(&filter_chain_template_));
+  EXPECT_CALL(parent_context_.drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_FALSE(context.drainDecision().drainClose());
+
+  context.startDraining();
+  EXPECT_CALL(parent_context_.drain_manager_, drainClose()).Times(0);
+  EXPECT_TRUE(context.drainDecision().drainClose());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,13 +1,25 @@
+#include <unistd.h>
+
 #include <memory>
 
+#include "common/common/fmt.h"
+#include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/stats/stat_merger.h"
+
 #include "server/hot_restarting_parent.h"
+#include "server/shared_stats_region.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -110,11 +122,102 @@ TEST_F(HotRestartingParentTest, exportStatsToChild) {
   }
 }
 
+// The stats laid out in a shared memory region are merged by the child as from the reply maps.
+TEST_F(HotRestartingParentTest, exportStatsToSharedMemory) {
+  Stats::IsolatedStoreImpl store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+  const std::string region_name = fmt::format("/envoy_shared_stats_test_{}", getpid());
+
+  Stats::IsolatedStoreImpl child_store;
+  Stats::StatMerger merger(child_store);
+  store.counter("c1").inc();
+  store.counter("a.much.longer.counter.name").add(2);
+  store.counter("unused_counter");
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  store.gauge("unused_gauge", Stats::Gauge::ImportMode::Accumulate);
+  {
+    HotRestartMessage::Reply::Stats stats;
+    hot_restarting_parent_.exportStatsToSharedMemory(region_name, &stats);
+    EXPECT_LT(0, stats.shared_memory_size());
+    EXPECT_TRUE(stats.counter_deltas().empty());
+    EXPECT_TRUE(stats.gauges().empty());
+    EXPECT_EQ(3, stats.num_connections());
+    SharedStatsRegion::merge(region_name, stats.shared_memory_size(), merger);
+  }
+  EXPECT_EQ(1, child_store.counter("c1").value());
+  EXPECT_EQ(2, child_store.counter("a.much.longer.counter.name").value());
+  EXPECT_EQ(123, child_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).value());
+  EXPECT_FALSE(child_store.findCounter(
+      Stats::StatNameManagedStorage("unused_counter", child_store.symbolTable()).statName()));
+
+  // Only the counter deltas are exported again, and the gauges replace their previous values.
+  store.counter("c1").add(2);
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).sub(3);
+  {
+    HotRestartMessage::Reply::Stats stats;
+    hot_restarting_parent_.exportStatsToSharedMemory(region_name, &stats);
+    SharedStatsRegion::merge(region_name, stats.shared_memory_size(), merger);
+  }
+  EXPECT_EQ(3, child_store.counter("c1").value());
+  EXPECT_EQ(2, child_store.counter("a.much.longer.counter.name").value());
+  EXPECT_EQ(120, child_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).value());
+}
+
 TEST_F(HotRestartingParentTest, drainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
 }
 
+class MockUdpForwardingListener : public HotRestartUdpForwarding::Listener {
+public:
+  MOCK_METHOD1(onForwardedPacket, void(Network::UdpRecvData& data));
+};
+
+// A forwarded packet is delivered to every listener of its listen address, through their
+// dispatchers, until they are removed.
+TEST(HotRestartingParentUdpListenersTest, deliver) {
+  HotRestartingParent::UdpListeners udp_listeners;
+  NiceMock<Event::MockDispatcher> dispatcher1;
+  NiceMock<Event::MockDispatcher> dispatcher2;
+  MockUdpForwardingListener listener1;
+  MockUdpForwardingListener listener2;
+  MockUdpForwardingListener other_listener;
+  const uint64_t id1 = udp_listeners.add(Network::Address::Ipv4Instance("0.0.0.0", 443),
+                                         dispatcher1, listener1);
+  udp_listeners.add(Network::Address::Ipv4Instance("0.0.0.0", 443), dispatcher2, listener2);
+  udp_listeners.add(Network::Address::Ipv4Instance("0.0.0.0", 444), dispatcher1, other_listener);
+
+  HotRestartMessage::Request::ForwardedUdpPacket packet;
+  packet.set_listen_address("0.0.0.0:443");
+  packet.set_local_address("10.0.0.1:443");
+  packet.set_peer_address("10.0.0.2:12345");
+  packet.set_payload("hello");
+  auto check_packet = [](Network::UdpRecvData& data) -> void {
+    EXPECT_EQ("10.0.0.1:443", data.addresses_.local_->asString());
+    EXPECT_EQ("10.0.0.2:12345", data.addresses_.peer_->asString());
+    EXPECT_EQ("hello", data.buffer_->toString());
+  };
+  EXPECT_CALL(dispatcher1, post(_));
+  EXPECT_CALL(dispatcher2, post(_));
+  EXPECT_CALL(listener1, onForwardedPacket(_)).WillOnce(Invoke(check_packet));
+  EXPECT_CALL(listener2, onForwardedPacket(_)).WillOnce(Invoke(check_packet));
+  EXPECT_CALL(other_listener, onForwardedPacket(_)).Times(0);
+  udp_listeners.deliver(packet);
+
+  udp_listeners.remove(id1);
+  EXPECT_CALL(listener1, onForwardedPacket(_)).Times(0);
+  EXPECT_CALL(listener2, onForwardedPacket(_));
+  udp_listeners.deliver(packet);
+
+  // Packets with malformed addresses are dropped.
+  packet.set_peer_address("not an address");
+  EXPECT_CALL(listener2, onForwardedPacket(_)).Times(0);
+  udp_listeners.deliver(packet);
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
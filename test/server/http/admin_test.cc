@@ -7,6 +7,7 @@
 #include "envoy/admin/v3alpha/config_dump.pb.h"
 #include "envoy/admin/v3alpha/memory.pb.h"
 #include "envoy/admin/v3alpha/server_info.pb.h"
+#include "envoy/config/cluster/v3alpha/cluster.pb.h"
 #include "envoy/config/core/v3alpha/base.pb.h"
 #include "envoy/extensions/filters/network/http_connection_manager/v3alpha/http_connection_manager.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3alpha/cert.pb.h"
@@ -16,6 +17,7 @@
 
 #include "common/http/message_impl.h"
 #include "common/json/json_loader.h"
+#include "common/profiler/cpu_sampler.h"
 #include "common/profiler/profiler.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
@@ -36,6 +38,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -43,6 +46,7 @@ using testing::_;
 using testing::AllOf;
 using testing::EndsWith;
 using testing::Ge;
+using testing::Gt;
 using testing::HasSubstr;
 using testing::InSequence;
 using testing::Invoke;
@@ -66,7 +70,7 @@ public:
   }
 
   static std::string
-  statsAsJsonHandler(std::map<std::string, uint64_t>& all_stats,
+  statsAsJsonHandler(std::vector<std::pair<std::string, uint64_t>>& all_stats,
                      const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
                      const bool used_only, const absl::optional<std::regex> regex = absl::nullopt) {
     return AdminImpl::statsAsJson(all_stats, all_histograms, used_only, regex,
@@ -138,7 +142,7 @@ TEST_P(AdminStatsTest, StatsAsJson) {
   std::sort(histograms.begin(), histograms.end(),
             [](const Stats::ParentHistogramSharedPtr& a,
                const Stats::ParentHistogramSharedPtr& b) -> bool { return a->name() < b->name(); });
-  std::map<std::string, uint64_t> all_stats;
+  std::vector<std::pair<std::string, uint64_t>> all_stats;
   std::string actual_json = statsAsJsonHandler(all_stats, histograms, false);
 
   const std::string expected_json = R"EOF({
@@ -280,7 +284,7 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJson) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::map<std::string, uint64_t> all_stats;
+  std::vector<std::pair<std::string, uint64_t>> all_stats;
   std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), true);
 
   // Expected JSON should not have h2 values as it is not used.
@@ -378,7 +382,7 @@ TEST_P(AdminStatsTest, StatsAsJsonFilterString) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::map<std::string, uint64_t> all_stats;
+  std::vector<std::pair<std::string, uint64_t>> all_stats;
   std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), false,
                                                absl::optional<std::regex>{std::regex("[a-z]1")});
 
@@ -487,7 +491,7 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJsonFilterString) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::map<std::string, uint64_t> all_stats;
+  std::vector<std::pair<std::string, uint64_t>> all_stats;
   std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), true,
                                                absl::optional<std::regex>{std::regex("h[12]")});
 
@@ -678,6 +682,74 @@ TEST_P(AdminInstanceTest, AdminCpuProfiler) {
   EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
 }
 
+TEST_P(AdminInstanceTest, AdminCpuSampleBadParams) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+  if (!Profiler::CpuSampler::samplerSupported()) {
+    EXPECT_EQ(Http::Code::NotImplemented,
+              postCallback("/cpuprofiler/sample?seconds=1", header_map, data));
+    return;
+  }
+
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler/sample", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sample?seconds=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sample?seconds=601", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sample?seconds=1&frequency=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sample?seconds=1&frequency=abc", header_map, data));
+  EXPECT_FALSE(Profiler::CpuSampler::isSampling());
+  EXPECT_EQ(Http::Code::NotFound, getCallback("/cpuprofiler/profile", header_map, data));
+}
+
+TEST_P(AdminInstanceTest, AdminCpuSample) {
+  if (!Profiler::CpuSampler::samplerSupported()) {
+    return;
+  }
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+
+  Event::MockTimer* timer = new Event::MockTimer(&server_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(2000), _));
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler/sample?seconds=2&frequency=500", header_map, data));
+  EXPECT_TRUE(Profiler::CpuSampler::isSampling());
+
+  // Only one sampling at a time, and it excludes the gperftools CPU profiler.
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sample?seconds=1", header_map, data));
+  EXPECT_EQ(Http::Code::InternalServerError,
+            postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_EQ(Http::Code::ServiceUnavailable, getCallback("/cpuprofiler/profile", header_map, data));
+
+  timer->invokeCallback();
+  EXPECT_FALSE(Profiler::CpuSampler::isSampling());
+  Http::HeaderMapImpl profile_headers;
+  Buffer::OwnedImpl profile;
+  EXPECT_EQ(Http::Code::OK, getCallback("/cpuprofiler/profile", profile_headers, profile));
+  EXPECT_EQ("application/octet-stream", profile_headers.ContentType()->value().getStringView());
+  EXPECT_NE(0, profile.length());
+}
+
+// A frequency of one sample per second gives a timer period of a whole second.
+TEST_P(AdminInstanceTest, AdminCpuSampleOncePerSecond) {
+  if (!Profiler::CpuSampler::samplerSupported()) {
+    return;
+  }
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+
+  Event::MockTimer* timer = new Event::MockTimer(&server_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000), _));
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler/sample?seconds=1&frequency=1", header_map, data));
+  EXPECT_TRUE(Profiler::CpuSampler::isSampling());
+  timer->invokeCallback();
+  EXPECT_FALSE(Profiler::CpuSampler::isSampling());
+}
+
 TEST_P(AdminInstanceTest, AdminHeapProfilerOnRepeatedRequest) {
   Buffer::OwnedImpl data;
   Http::HeaderMapImpl header_map;
@@ -713,6 +785,21 @@ TEST_P(AdminInstanceTest, AdminHeapProfiler) {
   EXPECT_FALSE(Profiler::Heap::isProfilerStarted());
 }
 
+TEST_P(AdminInstanceTest, AdminHeapSample) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+
+#ifdef PROFILER_AVAILABLE
+  EXPECT_EQ(Http::Code::OK, getCallback("/heapprofiler/sample", header_map, data));
+  EXPECT_THAT(data.toString(), HasSubstr("MAPPED_LIBRARIES:"));
+  Buffer::OwnedImpl subsystems;
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/heapprofiler/sample?subsystems", header_map, subsystems));
+#else
+  EXPECT_EQ(Http::Code::NotImplemented, getCallback("/heapprofiler/sample", header_map, data));
+#endif
+}
+
 TEST_P(AdminInstanceTest, MutatesErrorWithGet) {
   Buffer::OwnedImpl data;
   Http::HeaderMapImpl header_map;
@@ -769,6 +856,19 @@ TEST_P(AdminInstanceTest, PrometheusStatsInvalidRegex) {
   EXPECT_THAT(data.toString(), EndsWith("\"\n"));
 }
 
+// The filter is an ECMAScript regex, so lookaheads are allowed, and a counter and a gauge with the
+// same name are shown once.
+TEST_P(AdminInstanceTest, StatsFilter) {
+  server_.stats_store_.counter("filter.dup").inc();
+  server_.stats_store_.gauge("filter.dup", Stats::Gauge::ImportMode::Accumulate).set(5);
+  server_.stats_store_.counter("filter.dupe").inc();
+
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl data;
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats?filter=^filter\\.dup(?!e)", header_map, data));
+  EXPECT_EQ("filter.dup: 1\n", data.toString());
+}
+
 TEST_P(AdminInstanceTest, WriteAddressToFile) {
   std::ifstream address_file(address_out_path_);
   std::string address_from_file;
@@ -1097,6 +1197,120 @@ TEST_P(AdminInstanceTest, ConfigDumpResourceNotRepeated) {
             getCallback("/config_dump?resource=version_info", header_map, response));
 }
 
+// Test that using the name_regex query parameter filters the resources of the config dump by name,
+// the name of the dynamic clusters being that of the cluster they wrap.
+TEST_P(AdminInstanceTest, ConfigDumpFiltersByNameRegex) {
+  const auto make_clusters = [] {
+    auto msg = std::make_unique<envoy::admin::v3alpha::ClustersConfigDump>();
+    msg->set_version_info("v1");
+    for (const std::string name : {"backend_a", "frontend", "backend_b"}) {
+      envoy::config::cluster::v3alpha::Cluster cluster;
+      cluster.set_name(name);
+      msg->add_dynamic_active_clusters()->mutable_cluster()->PackFrom(cluster);
+    }
+    return msg;
+  };
+  auto clusters = admin_.getConfigTracker().add("clusters", make_clusters);
+
+  envoy::admin::v3alpha::ClustersConfigDump expected_clusters = *make_clusters();
+  expected_clusters.mutable_dynamic_active_clusters()->DeleteSubrange(1, 1);
+  envoy::admin::v3alpha::ConfigDump expected_dump;
+  expected_dump.add_configs()->PackFrom(expected_clusters);
+  {
+    Buffer::OwnedImpl response;
+    Http::HeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?name_regex=^back", header_map, response));
+    EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expected_dump, true), response.toString());
+  }
+
+  expected_dump.clear_configs();
+  expected_dump.add_configs()->PackFrom(expected_clusters.dynamic_active_clusters(1));
+  {
+    Buffer::OwnedImpl response;
+    Http::HeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK,
+              getCallback("/config_dump?resource=dynamic_active_clusters&name_regex=end_b",
+                          header_map, response));
+    EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expected_dump, true), response.toString());
+  }
+
+  Buffer::OwnedImpl response;
+  Http::HeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/config_dump?name_regex=[", header_map, response));
+}
+
+// Test that a large config dump is streamed in chunks as the downstream connection drains them,
+// its JSON being the same as that of the whole ConfigDump.
+TEST_P(AdminInstanceTest, ConfigDumpStreamed) {
+  const auto make_listeners = [] {
+    auto msg = std::make_unique<envoy::admin::v3alpha::ListenersConfigDump>();
+    msg->set_version_info("v1");
+    for (uint32_t i = 0; i < 50000; ++i) {
+      msg->add_dynamic_listeners()->set_name(absl::StrCat("listener_", i));
+    }
+    return msg;
+  };
+  auto listeners = admin_.getConfigTracker().add("listeners", make_listeners);
+  auto bootstrap = admin_.getConfigTracker().add("bootstrap", [] {
+    auto msg = std::make_unique<ProtobufWkt::StringValue>();
+    msg->set_value("bootstrap_config");
+    return msg;
+  });
+  std::string routes_version = "v1";
+  auto routes = admin_.getConfigTracker().add("routes", [&routes_version] {
+    auto msg = std::make_unique<ProtobufWkt::StringValue>();
+    msg->set_value(routes_version);
+    return msg;
+  });
+  envoy::admin::v3alpha::ConfigDump expected_dump;
+  ProtobufWkt::StringValue bootstrap_config;
+  bootstrap_config.set_value("bootstrap_config");
+  expected_dump.add_configs()->PackFrom(bootstrap_config);
+  expected_dump.add_configs()->PackFrom(*make_listeners());
+  ProtobufWkt::StringValue routes_config;
+  routes_config.set_value("v1");
+  expected_dump.add_configs()->PackFrom(routes_config);
+
+  Event::MockTimer* timer = new Event::MockTimer(&server_.dispatcher_);
+  Http::DownstreamWatermarkCallbacks* watermark_callbacks = nullptr;
+  EXPECT_CALL(callbacks_, addDownstreamWatermarkCallbacks(_))
+      .WillOnce(Invoke([&watermark_callbacks](Http::DownstreamWatermarkCallbacks& callbacks) {
+        watermark_callbacks = &callbacks;
+      }));
+  Buffer::OwnedImpl response;
+  Http::HeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump", header_map, response));
+  ASSERT_NE(nullptr, watermark_callbacks);
+  EXPECT_TRUE(timer->enabled_);
+  // The chunks written later come from the snapshot taken at the start of the dump.
+  routes_version = "v2";
+
+  std::string output = response.toString();
+  bool end_stream = false;
+  EXPECT_CALL(callbacks_, encodeData(_, _))
+      .WillRepeatedly(Invoke([&output, &end_stream](Buffer::Instance& data, bool end) {
+        output += data.toString();
+        end_stream = end;
+      }));
+
+  // Nothing is written while the downstream connection is above its high watermark.
+  watermark_callbacks->onAboveWriteBufferHighWatermark();
+  const size_t output_size = output.size();
+  timer->invokeCallback();
+  EXPECT_EQ(output_size, output.size());
+  EXPECT_FALSE(timer->enabled_);
+  watermark_callbacks->onBelowWriteBufferLowWatermark();
+  EXPECT_TRUE(timer->enabled_);
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(_));
+  while (!end_stream) {
+    ASSERT_TRUE(timer->enabled_);
+    timer->invokeCallback();
+  }
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expected_dump, true), output);
+}
+
 TEST_P(AdminInstanceTest, Memory) {
   Http::HeaderMapImpl header_map;
   Buffer::OwnedImpl response;
@@ -1109,7 +1323,9 @@ TEST_P(AdminInstanceTest, Memory) {
                     Property(&envoy::admin::v3alpha::Memory::heap_size, Ge(0)),
                     Property(&envoy::admin::v3alpha::Memory::pageheap_unmapped, Ge(0)),
                     Property(&envoy::admin::v3alpha::Memory::pageheap_free, Ge(0)),
-                    Property(&envoy::admin::v3alpha::Memory::total_thread_cache, Ge(0))));
+                    Property(&envoy::admin::v3alpha::Memory::total_thread_cache, Ge(0)),
+                    Property(&envoy::admin::v3alpha::Memory::upstream_hosts, Ge(0)),
+                    Property(&envoy::admin::v3alpha::Memory::upstream_host_size, Gt(0))));
 }
 
 TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
@@ -1160,7 +1376,7 @@ TEST_P(AdminInstanceTest, Runtime) {
   ON_CALL(*layer2, name()).WillByDefault(testing::ReturnRefOfCopy(std::string{"layer2"}));
   ON_CALL(*layer2, values()).WillByDefault(testing::ReturnRef(entries2));
 
-  std::vector<Runtime::Snapshot::OverrideLayerConstPtr> layers;
+  std::vector<Runtime::Snapshot::OverrideLayerConstSharedPtr> layers;
   layers.push_back(std::move(layer1));
   layers.push_back(std::move(layer2));
   EXPECT_CALL(snapshot, getLayers()).WillRepeatedly(testing::ReturnRef(layers));
@@ -2000,5 +2216,57 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+// Test that the scrapes sharing a cache write the current values of the stats, and that the cache
+// forgets the stats that are no longer scraped.
+TEST_F(PrometheusStatsFormatterTest, OutputWithCache) {
+  addCounter("cluster.test_1.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
+  addCounter("cluster.test_2.upstream_cx_total", {{"another_tag_name", "another_tag-value"}});
+  addGauge("cluster.test_3.upstream_cx_active", {{"another_tag_name_3", "another_tag_3-value"}});
+
+  PrometheusStatsCache cache;
+  {
+    Buffer::OwnedImpl response;
+    EXPECT_EQ(3UL, PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                               response, false, absl::nullopt,
+                                                               cache));
+  }
+
+  counters_[0]->add(5);
+  gauges_[0]->set(7);
+  {
+    Buffer::OwnedImpl response;
+    EXPECT_EQ(3UL, PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                               response, false, absl::nullopt,
+                                                               cache));
+    const std::string expected_output =
+        R"EOF(# TYPE envoy_cluster_test_1_upstream_cx_total counter
+envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 5
+# TYPE envoy_cluster_test_2_upstream_cx_total counter
+envoy_cluster_test_2_upstream_cx_total{another_tag_name="another_tag-value"} 0
+# TYPE envoy_cluster_test_3_upstream_cx_active gauge
+envoy_cluster_test_3_upstream_cx_active{another_tag_name_3="another_tag_3-value"} 7
+)EOF";
+    EXPECT_EQ(expected_output, response.toString());
+  }
+
+  Stats::CounterSharedPtr removed_counter = counters_.back();
+  counters_.pop_back();
+  EXPECT_EQ(2, removed_counter->use_count());
+  {
+    Buffer::OwnedImpl response;
+    EXPECT_EQ(2UL, PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                               response, false, absl::nullopt,
+                                                               cache));
+    const std::string expected_output =
+        R"EOF(# TYPE envoy_cluster_test_1_upstream_cx_total counter
+envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 5
+# TYPE envoy_cluster_test_3_upstream_cx_active gauge
+envoy_cluster_test_3_upstream_cx_active{another_tag_name_3="another_tag_3-value"} 7
+)EOF";
+    EXPECT_EQ(expected_output, response.toString());
+  }
+  EXPECT_EQ(1, removed_counter->use_count());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -292,13 +292,53 @@ TEST_F(LdsApiTest, Basic) {
 
   makeListenersAndExpectCall({"listener1", "listener2"});
   EXPECT_CALL(listener_manager_, removeListener("listener2")).WillOnce(Return(true));
-  expectAdd("listener1", "1", false);
+  // listener1 is unchanged, so it is not handed to the listener manager again.
   expectAdd("listener3", "1", true);
   EXPECT_CALL(listener_manager_, endListenerUpdate(_));
   lds_callbacks_->onConfigUpdate(response2.resources(), response2.version_info());
   EXPECT_EQ("1", lds_->versionInfo());
 }
 
+// Validate that the listeners of a delta update with the same per-resource version as the applied
+// ones are skipped, unless they are no longer active.
+TEST_F(LdsApiTest, DeltaUpdateUnchangedVersion) {
+  InSequence s;
+
+  setup();
+
+  auto make_resources = [](const std::string& version, const std::string& address) {
+    envoy::config::listener::v3alpha::Listener listener;
+    listener.set_name("listener1");
+    auto* socket_address = listener.mutable_address()->mutable_socket_address();
+    socket_address->set_address(address);
+    socket_address->set_port_value(1);
+    listener.add_filter_chains();
+    Protobuf::RepeatedPtrField<envoy::service::discovery::v3alpha::Resource> resources;
+    auto* resource = resources.Add();
+    resource->mutable_resource()->PackFrom(listener);
+    resource->set_name("listener1");
+    resource->set_version(version);
+    return resources;
+  };
+
+  makeListenersAndExpectCall({});
+  expectAdd("listener1", "v1", true);
+  EXPECT_CALL(listener_manager_, endListenerUpdate(_));
+  EXPECT_CALL(init_watcher_, ready());
+  lds_callbacks_->onConfigUpdate(make_resources("v1", "0.0.0.1"), {}, "1");
+
+  // Same version, the contents are not looked at.
+  makeListenersAndExpectCall({"listener1"});
+  EXPECT_CALL(listener_manager_, endListenerUpdate(_));
+  lds_callbacks_->onConfigUpdate(make_resources("v1", "0.0.0.2"), {}, "2");
+
+  // The listener is no longer active, e.g. it failed to be added to the workers.
+  makeListenersAndExpectCall({});
+  expectAdd("listener1", "v1", true);
+  EXPECT_CALL(listener_manager_, endListenerUpdate(_));
+  lds_callbacks_->onConfigUpdate(make_resources("v1", "0.0.0.1"), {}, "3");
+}
+
 // Regression test against only updating versionInfo() if at least one listener
 // is added/updated even if one or more are removed.
 TEST_F(LdsApiTest, UpdateVersionOnListenerRemove) {
@@ -515,7 +555,7 @@ TEST_F(LdsApiTest, ReplacingListenerWithSameAddress) {
 
   makeListenersAndExpectCall({"listener1", "listener2"});
   EXPECT_CALL(listener_manager_, removeListener("listener2")).WillOnce(Return(true));
-  expectAdd("listener1", "1", false);
+  // listener1 is unchanged, so it is not handed to the listener manager again.
   expectAdd("listener3", "1", true);
   EXPECT_CALL(listener_manager_, endListenerUpdate(_));
   lds_callbacks_->onConfigUpdate(response2.resources(), response2.version_info());
@@ -19,6 +19,7 @@
 #include "common/config/metadata.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/reuse_port_socket_option_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/protobuf.h"
 
@@ -28,11 +29,16 @@
 #include "test/server/utility.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 
+#if defined(__linux__)
+#include <linux/bpf.h>
+#endif
+
 using testing::AtLeast;
 using testing::InSequence;
 using testing::Throw;
@@ -1374,7 +1380,8 @@ filter_chains:
     config: {}
   )EOF";
 
-  ListenerHandle* listener_foo_update1 = expectListenerCreate(true, true);
+  // Only the filter chains change, so foo is updated in place.
+  ListenerHandle* listener_foo_update1 = expectListenerOverridden(true);
   EXPECT_CALL(listener_foo_update1->target_, initialize());
   EXPECT_TRUE(
       manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
@@ -1397,6 +1404,61 @@ filter_chains:
   checkStats(2, 1, 2, 0, 0, 0);
 }
 
+#if defined(__linux__)
+// Validate that a listener stops steering new connections to its sockets by CPU once it drains.
+TEST_F(ListenerManagerImplTest, ReusePortCpuSteeringStoppedOnDrain) {
+  const Network::SocketOptionName steering_option = ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF;
+  if (!steering_option.has_value()) {
+    return;
+  }
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{10, 0}));
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_PROG_LOAD, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{11, 0}));
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  // The socket reserving port 0 is bound right away, which loads the steering program.
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 0
+reuse_port: true
+reuse_port_cpu_steering: true
+filter_chains:
+- filters: []
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(true, true);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, {true, false}));
+  EXPECT_CALL(listener_foo->target_, initialize());
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  listener_foo->target_.ready();
+  worker_->callAddCompletion(true);
+  EXPECT_EQ(1UL, manager_->listeners().size());
+
+  // Removing foo drains it, which empties every steering slot.
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_MAP_DELETE_ELEM, _, _))
+      .Times(server_.options_.concurrency_)
+      .WillRepeatedly(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*worker_, stopListener(_, _));
+  EXPECT_CALL(*listener_foo->drain_manager_, startDrainSequence(_));
+  EXPECT_TRUE(manager_->removeListener("foo"));
+
+  EXPECT_CALL(*worker_, removeListener(_, _));
+  listener_foo->drain_manager_->drain_sequence_completion_();
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callRemovalCompletion();
+  EXPECT_EQ(0UL, manager_->listeners().size());
+}
+#endif
+
 // Validates that StopListener functionality works correctly when only inbound listeners are
 // stopped.
 TEST_F(ListenerManagerImplTest, StopListeners) {
@@ -1585,7 +1647,8 @@ filter_chains:
     config: {}
   )EOF";
 
-  ListenerHandle* listener_foo_update1 = expectListenerCreate(true, true);
+  // Only the filter chains change, so foo is updated in place.
+  ListenerHandle* listener_foo_update1 = expectListenerOverridden(true);
   EXPECT_CALL(listener_foo_update1->target_, initialize());
   EXPECT_TRUE(
       manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
@@ -1600,6 +1663,204 @@ filter_chains:
   EXPECT_EQ(1, server_.stats_store_.counter("listener_manager.listener_stopped").value());
 }
 
+// Validates that a listener whose filter chains change only is updated in place. The workers keep
+// their listener and only the connections of the removed filter chain are drained.
+TEST_F(ListenerManagerImplTest, UpdateFilterChainsInPlace) {
+  InSequence s;
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false, true);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, {true}));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 0, 0, 0, 1, 0);
+  const uint64_t listener_tag = manager_->listeners().front().get().listenerTag();
+
+  const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters:
+  - name: fake
+    config: {}
+  )EOF";
+
+  ListenerHandle* listener_foo_update1 = expectListenerOverridden(false);
+  EXPECT_CALL(*worker_, addListener(_, _));
+  Event::MockTimer* filter_chain_drain_timer = new Event::MockTimer(&server_.dispatcher_);
+  EXPECT_CALL(*filter_chain_drain_timer, enableTimer(_, _));
+  EXPECT_CALL(*worker_, stopListener(_, _)).Times(0);
+  EXPECT_CALL(*listener_foo->drain_manager_, startDrainSequence(_)).Times(0);
+  EXPECT_TRUE(
+      manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 1, 0, 0, 1, 0);
+  EXPECT_EQ(1UL,
+            server_.stats_store_.counter("listener_manager.listener_in_place_updated").value());
+  EXPECT_EQ(1UL, server_.stats_store_
+                     .gauge("listener_manager.total_filter_chains_draining",
+                            Stats::Gauge::ImportMode::NeverImport)
+                     .value());
+  // The workers replace the config of their listener, which keeps its tag.
+  EXPECT_EQ(listener_tag, manager_->listeners().front().get().listenerTag());
+
+  // The removed filter chain drains on its own, while the listener does not.
+  EXPECT_TRUE(listener_foo->context_->drainDecision().drainClose());
+  EXPECT_CALL(*listener_foo->drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_CALL(server_.drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_FALSE(listener_foo_update1->context_->drainDecision().drainClose());
+
+  // Once the drain time is over, the workers close the remaining connections of the removed
+  // filter chain and the replaced listener goes away.
+  EXPECT_CALL(*worker_, removeFilterChains(listener_tag, _, _));
+  filter_chain_drain_timer->invokeCallback();
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callDrainFilterChainsComplete();
+  EXPECT_EQ(0UL, server_.stats_store_
+                     .gauge("listener_manager.total_filter_chains_draining",
+                            Stats::Gauge::ImportMode::NeverImport)
+                     .value());
+
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+}
+
+// Validates that a filter chain whose config is unchanged by an in place update is not built again.
+TEST_F(ListenerManagerImplTest, UpdateFilterChainsInPlaceKeepsUnchangedFilterChain) {
+  ListenerHandle* listener_foo;
+  ListenerHandle* listener_foo_update1;
+  {
+    InSequence s;
+
+    EXPECT_CALL(*worker_, start(_));
+    manager_->startWorkers(guard_dog_);
+
+    const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+  )EOF";
+
+    listener_foo = expectListenerCreate(false, true);
+    EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, {true}));
+    EXPECT_CALL(*worker_, addListener(_, _));
+    EXPECT_TRUE(
+        manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+    worker_->callAddCompletion(true);
+
+    const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+- filter_chain_match:
+    destination_port: 8080
+  filters: []
+  )EOF";
+
+    // Only the added filter chain is built, and no filter chain needs to drain.
+    listener_foo_update1 = expectListenerOverridden(false);
+    EXPECT_CALL(*worker_, addListener(_, _));
+    EXPECT_CALL(*worker_, removeFilterChains(_, _, _));
+    EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml),
+                                              "", true));
+    worker_->callAddCompletion(true);
+    EXPECT_EQ(0UL, server_.stats_store_
+                       .gauge("listener_manager.total_filter_chains_draining",
+                              Stats::Gauge::ImportMode::NeverImport)
+                       .value());
+
+    // The filter chain of the replaced listener is shared with the new one, so it stays around.
+    EXPECT_CALL(*listener_foo, onDestroy()).Times(0);
+    worker_->callDrainFilterChainsComplete();
+  }
+
+  // The remaining filter chains go away in no particular order.
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+  EXPECT_CALL(*listener_foo, onDestroy());
+}
+
+// Validates that the whole listener is replaced and drained when the in place filter chain update
+// is disabled.
+TEST_F(ListenerManagerImplTest, UpdateFilterChainsInPlaceRuntimeDisabled) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.listener_in_place_filterchain_update", "false"}});
+  InSequence s;
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false, true);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, {true}));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  worker_->callAddCompletion(true);
+
+  const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters:
+  - name: fake
+    config: {}
+  )EOF";
+
+  ListenerHandle* listener_foo_update1 = expectListenerCreate(false, true);
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_CALL(*worker_, stopListener(_, _));
+  EXPECT_CALL(*listener_foo->drain_manager_, startDrainSequence(_));
+  EXPECT_TRUE(
+      manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 1, 0, 0, 1, 1);
+  EXPECT_EQ(0UL,
+            server_.stats_store_.counter("listener_manager.listener_in_place_updated").value());
+
+  EXPECT_CALL(*worker_, removeListener(_, _));
+  listener_foo->drain_manager_->drain_sequence_completion_();
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callRemovalCompletion();
+  checkStats(1, 1, 0, 0, 1, 0);
+
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+}
+
 TEST_F(ListenerManagerImplTest, AddListenerFailure) {
   InSequence s;
 
@@ -3403,6 +3664,46 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerEnabledForTcp) {
                    /* expected_creation_params */ {true, false});
 }
 
+// Validate that the SO_REUSEPORT steering option is added along with reuse_port. The steering
+// program is attached once the socket is bound, see socket_option_factory_test.cc.
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortCpuSteeringListenerEnabled) {
+  auto listener = createIPv4Listener("ReusePortCpuSteeringListener");
+  listener.set_reuse_port(true);
+  listener.set_reuse_port_cpu_steering(true);
+  listener.mutable_address()->mutable_socket_address()->set_port_value(0);
+  const Network::SocketOptionName reuse_port_option = ENVOY_SOCKET_SO_REUSEPORT;
+  const Network::SocketOptionName steering_option = ENVOY_SOCKET_SO_ATTACH_REUSEPORT_EBPF;
+  if (!reuse_port_option.has_value() || !steering_option.has_value()) {
+    return;
+  }
+#if defined(__linux__)
+  // The socket reserving the port is bound right away, which loads the steering program.
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{10, 0}));
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_PROG_LOAD, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{11, 0}));
+  expectCreateListenSocket(envoy::config::core::v3alpha::SocketOption::STATE_PREBIND,
+                           /* expected_num_options */ 2,
+                           /* expected_creation_params */ {true, false});
+  expectSetsockopt(os_sys_calls_, reuse_port_option.level(), reuse_port_option.option(),
+                   /* expected_value */ 1);
+  expectSetsockopt(os_sys_calls_, steering_option.level(), steering_option.option(),
+                   /* expected_value */ 11);
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+#endif
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortCpuSteeringRequiresReusePort) {
+  auto listener = createIPv4Listener("ReusePortCpuSteeringListener");
+  listener.set_reuse_port_cpu_steering(true);
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error adding listener '127.0.0.1:1111': reuse_port_cpu_steering "
+                            "requires reuse_port");
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerDisabled) {
 
   auto listener = createIPv4Listener("UdpListener");
@@ -28,13 +28,18 @@ namespace Server {
 
 class ListenerHandle {
 public:
-  ListenerHandle() { EXPECT_CALL(*drain_manager_, startParentShutdownSequence()).Times(0); }
+  ListenerHandle(bool need_local_drain_manager = true) {
+    if (need_local_drain_manager) {
+      drain_manager_ = new MockDrainManager();
+      EXPECT_CALL(*drain_manager_, startParentShutdownSequence()).Times(0);
+    }
+  }
   ~ListenerHandle() { onDestroy(); }
 
   MOCK_METHOD0(onDestroy, void());
 
   Init::ExpectableTargetImpl target_;
-  MockDrainManager* drain_manager_ = new MockDrainManager();
+  MockDrainManager* drain_manager_{};
   Configuration::FactoryContext* context_{};
 };
 
@@ -104,6 +109,22 @@ protected:
     auto raw_listener = new ListenerHandle();
     EXPECT_CALL(listener_factory_, createDrainManager_(drain_type))
         .WillOnce(Return(raw_listener->drain_manager_));
+    expectFilterChainCreate(raw_listener, need_init);
+    return raw_listener;
+  }
+
+  /**
+   * Like expectListenerCreate(), for a listener updated in place. Such a listener shares the drain
+   * manager and the validation visitor of the listener it replaces, and builds only the filter
+   * chain it does not share with it.
+   */
+  ListenerHandle* expectListenerOverridden(bool need_init) {
+    auto raw_listener = new ListenerHandle(false);
+    expectFilterChainCreate(raw_listener, need_init);
+    return raw_listener;
+  }
+
+  void expectFilterChainCreate(ListenerHandle* raw_listener, bool need_init) {
     EXPECT_CALL(listener_factory_, createNetworkFilterFactoryList(_, _))
         .WillOnce(Invoke(
             [raw_listener, need_init](
@@ -117,8 +138,6 @@ protected:
               }
               return {[notifier](Network::FilterManager&) -> void {}};
             }));
-
-    return raw_listener;
   }
 
   const Network::FilterChain*
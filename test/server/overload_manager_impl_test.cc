@@ -154,7 +154,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   int cb_count = 0;
   manager->registerForAction("envoy.overload_actions.dummy_action", dispatcher_,
                              [&](OverloadActionState state) {
-                               is_active = state == OverloadActionState::Active;
+                               is_active = state == OverloadActionState::saturated();
                                cb_count++;
                              });
   manager->registerForAction("envoy.overload_actions.unknown_action", dispatcher_,
@@ -175,7 +175,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory1_.monitor_->setPressure(0.5);
   timer_cb_();
   EXPECT_FALSE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Inactive);
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
   EXPECT_EQ(0, cb_count);
   EXPECT_EQ(0, active_gauge.value());
   EXPECT_EQ(50, pressure_gauge1.value());
@@ -183,7 +183,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory1_.monitor_->setPressure(0.95);
   timer_cb_();
   EXPECT_TRUE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Active);
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
   EXPECT_EQ(1, cb_count);
   EXPECT_EQ(1, active_gauge.value());
   EXPECT_EQ(95, pressure_gauge1.value());
@@ -192,7 +192,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory1_.monitor_->setPressure(0.94);
   timer_cb_();
   EXPECT_TRUE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Active);
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
   EXPECT_EQ(1, cb_count);
   EXPECT_EQ(94, pressure_gauge1.value());
 
@@ -201,7 +201,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory2_.monitor_->setPressure(0.9);
   timer_cb_();
   EXPECT_TRUE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Active);
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
   EXPECT_EQ(1, cb_count);
   EXPECT_EQ(50, pressure_gauge1.value());
   EXPECT_EQ(90, pressure_gauge2.value());
@@ -209,7 +209,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory2_.monitor_->setPressure(0.4);
   timer_cb_();
   EXPECT_FALSE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Inactive);
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
   EXPECT_EQ(2, cb_count);
   EXPECT_EQ(0, active_gauge.value());
   EXPECT_EQ(40, pressure_gauge2.value());
@@ -217,6 +217,106 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   manager->stop();
 }
 
+TEST_F(OverloadManagerImplTest, ScaledTrigger) {
+  setDispatcherExpectation();
+
+  auto manager(createOverloadManager(R"EOF(
+      refresh_interval {
+        seconds: 1
+      }
+      resource_monitors {
+        name: "envoy.resource_monitors.fake_resource1"
+      }
+      actions {
+        name: "envoy.overload_actions.dummy_action"
+        triggers {
+          name: "envoy.resource_monitors.fake_resource1"
+          scaled {
+            scaling_threshold: 0.5
+            saturation_threshold: 0.9
+          }
+        }
+      }
+    )EOF"));
+  OverloadActionState last_state = OverloadActionState::inactive();
+  int cb_count = 0;
+  manager->registerForAction("envoy.overload_actions.dummy_action", dispatcher_,
+                             [&](OverloadActionState state) {
+                               last_state = state;
+                               cb_count++;
+                             });
+  manager->start();
+
+  Stats::Gauge& active_gauge = stats_.gauge("overload.envoy.overload_actions.dummy_action.active",
+                                            Stats::Gauge::ImportMode::Accumulate);
+  Stats::Gauge& scale_percent_gauge =
+      stats_.gauge("overload.envoy.overload_actions.dummy_action.scale_percent",
+                   Stats::Gauge::ImportMode::Accumulate);
+  const OverloadActionState& action_state =
+      manager->getThreadLocalOverloadState().getState("envoy.overload_actions.dummy_action");
+
+  factory1_.monitor_->setPressure(0.4);
+  timer_cb_();
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
+  EXPECT_EQ(0, cb_count);
+  EXPECT_EQ(0, scale_percent_gauge.value());
+
+  // Between the thresholds, the action is scaled but not active.
+  factory1_.monitor_->setPressure(0.7);
+  timer_cb_();
+  EXPECT_DOUBLE_EQ(0.5, action_state.value());
+  EXPECT_FALSE(action_state.isSaturated());
+  EXPECT_EQ(1, cb_count);
+  EXPECT_EQ(action_state, last_state);
+  EXPECT_EQ(0, active_gauge.value());
+  EXPECT_EQ(50, scale_percent_gauge.value());
+
+  // Every change of the scale is delivered.
+  factory1_.monitor_->setPressure(0.8);
+  timer_cb_();
+  EXPECT_DOUBLE_EQ(0.75, action_state.value());
+  EXPECT_EQ(2, cb_count);
+  EXPECT_EQ(75, scale_percent_gauge.value());
+
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
+  EXPECT_EQ(3, cb_count);
+  EXPECT_EQ(1, active_gauge.value());
+  EXPECT_EQ(100, scale_percent_gauge.value());
+
+  factory1_.monitor_->setPressure(0.3);
+  timer_cb_();
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
+  EXPECT_EQ(last_state, OverloadActionState::inactive());
+  EXPECT_EQ(4, cb_count);
+  EXPECT_EQ(0, active_gauge.value());
+  EXPECT_EQ(0, scale_percent_gauge.value());
+
+  manager->stop();
+}
+
+TEST_F(OverloadManagerImplTest, InvalidScaledTrigger) {
+  const std::string config = R"EOF(
+    resource_monitors {
+      name: "envoy.resource_monitors.fake_resource1"
+    }
+    actions {
+      name: "envoy.overload_actions.dummy_action"
+      triggers {
+        name: "envoy.resource_monitors.fake_resource1"
+        scaled {
+          scaling_threshold: 0.9
+          saturation_threshold: 0.8
+        }
+      }
+    }
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(createOverloadManager(config), EnvoyException,
+                          "scaling_threshold must be less than saturation_threshold");
+}
+
 TEST_F(OverloadManagerImplTest, FailedUpdates) {
   setDispatcherExpectation();
   auto manager(createOverloadManager(getConfig()));
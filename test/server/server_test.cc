@@ -285,6 +285,44 @@ public:
   std::string name() const override { return "envoy.custom_stats_sink"; }
 };
 
+// Custom StatsSink flushed on the stats flush thread, counting the flushes done off the main
+// thread.
+class CustomThreadedStatsSink : public Stats::Sink {
+public:
+  CustomThreadedStatsSink(Server::Instance& server)
+      : server_(server),
+        stats_flushed_off_main_thread_(server.stats().counter("stats.flushed_off_main_thread")) {}
+
+  // Stats::Sink
+  void flush(Stats::MetricSnapshot&) override {
+    if (!server_.dispatcher().isThreadSafe()) {
+      stats_flushed_off_main_thread_.inc();
+    }
+  }
+
+  void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+
+  bool flushOffMainThread() const override { return true; }
+
+private:
+  Server::Instance& server_;
+  Stats::Counter& stats_flushed_off_main_thread_;
+};
+
+class CustomThreadedStatsSinkFactory : public Server::Configuration::StatsSinkFactory {
+public:
+  // StatsSinkFactory
+  Stats::SinkPtr createStatsSink(const Protobuf::Message&, Server::Instance& server) override {
+    return std::make_unique<CustomThreadedStatsSink>(server);
+  }
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return ProtobufTypes::MessagePtr{new Envoy::ProtobufWkt::Struct()};
+  }
+
+  std::string name() const override { return "envoy.custom_threaded_stats_sink"; }
+};
+
 INSTANTIATE_TEST_SUITE_P(IpVersions, ServerInstanceImplTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
                          TestUtility::ipTestParamsToString);
@@ -293,6 +331,7 @@ INSTANTIATE_TEST_SUITE_P(IpVersions, ServerInstanceImplTest,
  * Static registration for the custom sink factory. @see RegisterFactory.
  */
 REGISTER_FACTORY(CustomStatsSinkFactory, Server::Configuration::StatsSinkFactory);
+REGISTER_FACTORY(CustomThreadedStatsSinkFactory, Server::Configuration::StatsSinkFactory);
 
 // Validates that server stats are flushed even when server is stuck with initialization.
 TEST_P(ServerInstanceImplTest, StatsFlushWhenServerIsStillInitializing) {
@@ -307,6 +346,18 @@ TEST_P(ServerInstanceImplTest, StatsFlushWhenServerIsStillInitializing) {
   server_thread->join();
 }
 
+// Validates that the sinks supporting it are flushed on the stats flush thread, and the others on
+// the main thread.
+TEST_P(ServerInstanceImplTest, StatsFlushOnDedicatedThread) {
+  auto server_thread = startTestServer("test/server/stats_flush_thread_bootstrap.yaml", true);
+
+  TestUtility::waitForCounterEq(stats_store_, "stats.flushed", 1, time_system_);
+  TestUtility::waitForCounterEq(stats_store_, "stats.flushed_off_main_thread", 1, time_system_);
+
+  server_->dispatcher().post([&] { server_->shutdown(); });
+  server_thread->join();
+}
+
 // Validates that the "server.version" is updated with stats_server_version_override from bootstrap.
 TEST_P(ServerInstanceImplTest, ProxyVersionOveridesFromBootstrap) {
   auto server_thread = startTestServer("test/server/proxy_version_bootstrap.yaml", true);
@@ -3,20 +3,25 @@
 
 #include "server/worker_impl.h"
 
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Return;
+using testing::SetArgPointee;
 using testing::Throw;
+using testing::Truly;
 
 namespace Envoy {
 namespace Server {
@@ -28,7 +33,7 @@ public:
       : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
         no_exit_timer_(dispatcher_->createTimer([]() -> void {})),
         worker_(tls_, hooks_, std::move(dispatcher_), Network::ConnectionHandlerPtr{handler_},
-                overload_manager_, *api_, "worker_test") {
+                overload_manager_, *api_, "worker_test", absl::nullopt) {
     // In the real worker the watchdog has timers that prevent exit. Here we need to prevent event
     // loop exit since we use mock timers.
     no_exit_timer_->enableTimer(std::chrono::hours(1));
@@ -153,6 +158,44 @@ TEST_F(WorkerImplTest, ListenerException) {
   worker_.stop();
 }
 
+#if defined(__linux__)
+// With CPU affinity, each worker is pinned in turn to a CPU of the process affinity mask.
+TEST(ProdWorkerFactoryTest, PinsWorkersToAffinityCpus) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  CPU_SET(2, &affinity);
+  CPU_SET(5, &affinity);
+  EXPECT_CALL(linux_os_sys_calls, sched_getaffinity(0, _, _))
+      .WillOnce(DoAll(SetArgPointee<2>(affinity), Return(Api::SysCallIntResult{0, 0})));
+  const auto pinned_to = [](int cpu) {
+    return Truly(
+        [cpu](const cpu_set_t* mask) { return CPU_COUNT(mask) == 1 && CPU_ISSET(cpu, mask); });
+  };
+  EXPECT_CALL(linux_os_sys_calls, sched_setaffinity(0, _, pinned_to(2)))
+      .Times(2)
+      .WillRepeatedly(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(linux_os_sys_calls, sched_setaffinity(0, _, pinned_to(5)))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<MockGuardDog> guard_dog;
+  NiceMock<MockOverloadManager> overload_manager;
+  DefaultListenerHooks hooks;
+  Api::ApiPtr api = Api::createApiForTest();
+  ProdWorkerFactory factory(tls, *api, hooks, true);
+  std::vector<WorkerPtr> workers;
+  for (int i = 0; i < 3; i++) {
+    workers.push_back(factory.createWorker(overload_manager, absl::StrCat("worker_", i)));
+    workers.back()->start(guard_dog);
+  }
+  for (WorkerPtr& worker : workers) {
+    worker->stop();
+  }
+}
+#endif
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
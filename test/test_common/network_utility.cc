@@ -202,6 +202,8 @@ struct SyncPacketProcessor : public Network::UdpPacketProcessor {
     data_.receive_time_ = receive_time;
   }
   uint64_t maxPacketSize() const override { return Network::MAX_UDP_PACKET_SIZE; }
+  uint32_t maxPacketsPerRecv() const override { return 1; }
+  void onPacketsRead(uint64_t) override {}
 
   Network::UdpRecvData& data_;
 };